@@ -517,6 +517,15 @@ const AP_Param::Info Tracker::var_info[] = {
     // @Bitmask: 0:Scan for unknown target
     GSCALAR(auto_opts,              "AUTO_OPTIONS",        0),
 
+    // @Param: LINK_LATENCY
+    // @DisplayName: Telemetry link latency
+    // @Description: Fixed delay of the telemetry link from the vehicle. The vehicle's position is predicted forward by this much beyond the time it was sent, with jitter in the link already removed using the vehicle's timestamps
+    // @Units: ms
+    // @Range: 0 2000
+    // @Increment: 10
+    // @User: Advanced
+    GSCALAR(link_latency,           "LINK_LATENCY",        0),
+
     // @Group:
     // @Path: ../libraries/AP_Vehicle/AP_Vehicle.cpp
     PARAM_VEHICLE_INFO,
@@ -130,6 +130,7 @@ public:
         k_param_disarm_pwm,
 
         k_param_auto_opts,
+        k_param_link_latency,
 
         k_param_logger = 253, // 253 - Logging Group
 
@@ -172,6 +173,7 @@ public:
     AP_Int8  initial_mode;
     AP_Int8 disarm_pwm;
     AP_Int8 auto_opts;
+    AP_Int16 link_latency;
 
     // Waypoints
     //
@@ -42,6 +42,7 @@
 #include <AP_Mission/AP_Mission.h>
 #include <AP_Stats/AP_Stats.h>                      // statistics library
 #include <AP_BattMonitor/AP_BattMonitor.h> // Battery monitor library
+#include <AP_RTC/JitterCorrection.h>
 
 // Configuration
 #include "config.h"
@@ -127,8 +128,11 @@ private:
         Location location_estimate; // lat, long in degrees * 10^7; alt in meters * 100
         uint32_t last_update_us;    // last position update in microseconds
         uint32_t last_update_ms;    // last position update in milliseconds
-        Vector3f vel;           // the vehicle's velocity in m/s
+        uint64_t sample_us;         // local time the last position was taken, with link jitter removed
+        JitterCorrection jitter{2000};  // maps the vehicle's position timestamps to local time
+        Vector3f vel;           // the vehicle's velocity in m/s, NED
         int32_t relative_alt;	// the vehicle's relative altitude in meters * 100
+        float climb_estimate;   // predicted climb since the last position in meters
     } vehicle;
 
     // Navigation controller state
@@ -7,16 +7,20 @@
 void Tracker::update_vehicle_pos_estimate()
 {
     // calculate time since last actual position update
-    float dt = (AP_HAL::micros() - vehicle.last_update_us) * 1.0e-6f;
+    const float since_update = (AP_HAL::micros() - vehicle.last_update_us) * 1.0e-6f;
 
     // if less than 5 seconds since last position update estimate the position
-    if (dt < TRACKING_TIMEOUT_SEC) {
-        // project the vehicle position to take account of lost radio packets
+    if (since_update < TRACKING_TIMEOUT_SEC) {
+        // project the vehicle position from when it was taken to now,
+        // to take account of the link latency and lost radio packets
+        const float dt = MAX((AP_HAL::micros64() - vehicle.sample_us) * 1.0e-6f + g.link_latency * 0.001f, 0);
         vehicle.location_estimate = vehicle.location;
         float north_offset = vehicle.vel.x * dt;
         float east_offset = vehicle.vel.y * dt;
         vehicle.location_estimate.offset(north_offset, east_offset);
-    	vehicle.location_estimate.alt += vehicle.vel.z * 100.0f * dt;
+        // velocity is positive down
+        vehicle.climb_estimate = -vehicle.vel.z * dt;
+        vehicle.location_estimate.alt += vehicle.climb_estimate * 100.0f;
         // set valid_location flag
         vehicle.location_valid = true;
     } else {
@@ -65,7 +69,7 @@ void Tracker::update_bearing_and_distance()
         nav_status.alt_difference_gps = (vehicle.location_estimate.alt - current_loc.alt) / 100.0f;
     } else {
         // g.alt_source == ALT_SOURCE_GPS_VEH_ONLY
-        nav_status.alt_difference_gps = vehicle.relative_alt / 100.0f;
+        nav_status.alt_difference_gps = vehicle.relative_alt / 100.0f + vehicle.climb_estimate;
     }
 
     // calculate pitch to vehicle
@@ -138,6 +142,7 @@ void Tracker::tracking_update_position(const mavlink_global_position_int_t &msg)
     vehicle.vel = Vector3f(msg.vx/100.0f, msg.vy/100.0f, msg.vz/100.0f);
     vehicle.last_update_us = AP_HAL::micros();
     vehicle.last_update_ms = AP_HAL::millis();
+    vehicle.sample_us = vehicle.jitter.correct_offboard_timestamp_usec(uint64_t(msg.time_boot_ms)*1000U, AP_HAL::micros64());
     // log vehicle as GPS2
     if (should_log(MASK_LOG_GPS)) {
         Log_Write_Vehicle_Pos(vehicle.location.lat, vehicle.location.lng, vehicle.location.alt, vehicle.vel);
@@ -10,14 +10,108 @@ void Copter::run_rate_controller()
 {
     // set attitude and position controller loop time
     const float last_loop_time_s = AP::scheduler().get_last_loop_time_s();
-    motors->set_dt(last_loop_time_s);
     attitude_control->set_dt(last_loop_time_s);
     pos_control->set_dt(last_loop_time_s);
 
+#if AC_RATE_THREAD_ENABLED == ENABLED
+    if (using_rate_thread) {
+        // run at the gyro rate by rate_controller_thread()
+        return;
+    }
+#endif
+    motors->set_dt(last_loop_time_s);
+
     // run low level rate controllers that only require IMU data
     attitude_control->rate_controller_run(); 
 }
 
+#if AC_RATE_THREAD_ENABLED == ENABLED
+// start the rate controller thread if enabled
+void Copter::start_rate_thread()
+{
+    if (g2.fstrate_enable <= 0) {
+        return;
+    }
+    ins.enable_rate_loop();
+    if (!hal.scheduler->thread_create(FUNCTOR_BIND_MEMBER(&Copter::rate_controller_thread, void),
+                                      "rate", 2048, AP_HAL::Scheduler::PRIORITY_RCOUT, 1)) {
+        gcs().send_text(MAV_SEVERITY_ERROR, "Failed to start rate thread");
+    }
+}
+
+/*
+  run the rate controller and motors output on each new sample of the
+  primary gyro, so that the latency from gyro to motors stays constant
+  when the EKF or flight mode code in the main loop runs long. The
+  main loop takes over again if the gyro samples stop.
+
+  With FSTRATE_ENABLE=2 only the motors are output and pushed from
+  here, the servos, interlock and output devices being left to the
+  main loop. The time from the gyro sample being taken to the outputs
+  being pushed is logged once a second
+ */
+void Copter::rate_controller_thread()
+{
+    if (g2.fstrate_cpu >= 0 && !hal.scheduler->set_thread_cpu_affinity(g2.fstrate_cpu)) {
+        gcs().send_text(MAV_SEVERITY_INFO, "Rate thread not pinned to CPU %d", int(g2.fstrate_cpu.get()));
+    }
+
+    // time without gyro samples before handing back to the main loop
+    const uint32_t timeout_us = 5000;
+    const bool low_latency = g2.fstrate_enable == 2;
+
+    // gyro sample to output latency
+    uint32_t count = 0;
+    uint64_t sum_us = 0;
+    uint32_t min_us = UINT32_MAX;
+    uint32_t max_us = 0;
+    uint32_t last_log_ms = AP_HAL::millis();
+
+    while (true) {
+        Vector3f gyro;
+        float dt;
+        uint64_t sample_us;
+        if (!ins.get_next_gyro_sample(gyro, dt, sample_us, timeout_us)) {
+            using_rate_thread = false;
+            continue;
+        }
+        // correct for the gyro bias as AP_AHRS::get_gyro_latest() does
+        gyro += ahrs.get_gyro_drift();
+
+        motors->set_dt(dt);
+        if (!attitude_control->rate_controller_run_dt(gyro, dt)) {
+            // the controller can't be run from here
+            using_rate_thread = false;
+            return;
+        }
+        if (low_latency) {
+            motors_output_fast();
+        } else {
+            motors_output();
+        }
+        using_rate_thread = true;
+
+        const uint32_t latency_us = AP_HAL::micros64() - sample_us;
+        count++;
+        sum_us += latency_us;
+        min_us = MIN(min_us, latency_us);
+        max_us = MAX(max_us, latency_us);
+
+        const uint32_t now_ms = AP_HAL::millis();
+        if (now_ms - last_log_ms >= 1000) {
+            if (should_log(MASK_LOG_PM)) {
+                Log_Write_Rate_Thread(count * 1000.0f / (now_ms - last_log_ms), min_us, sum_us / count, max_us);
+            }
+            count = 0;
+            sum_us = 0;
+            min_us = UINT32_MAX;
+            max_us = 0;
+            last_log_ms = now_ms;
+        }
+    }
+}
+#endif
+
 /*************************************************************
  *  throttle control
  ****************************************************************/
@@ -701,6 +701,13 @@ private:
     void rotate_body_frame_to_NE(float &x, float &y);
     uint16_t get_pilot_speed_dn() const;
     void run_rate_controller();
+#if AC_RATE_THREAD_ENABLED == ENABLED
+    void rate_controller_thread();
+    void start_rate_thread();
+    // true while the rate thread is receiving gyro samples and has
+    // taken over the rate controller and motors output
+    bool using_rate_thread;
+#endif
 
 #if AC_CUSTOMCONTROL_MULTI_ENABLED == ENABLED
     void run_custom_controller() { custom_control.update(); }
@@ -837,6 +844,9 @@ private:
     void Log_Write_Guided_Attitude_Target(ModeGuided::SubMode target_type, float roll, float pitch, float yaw, const Vector3f &ang_vel, float thrust, float climb_rate);
     void Log_Write_SysID_Setup(uint8_t systemID_axis, float waveform_magnitude, float frequency_start, float frequency_stop, float time_fade_in, float time_const_freq, float time_record, float time_fade_out);
     void Log_Write_SysID_Data(float waveform_time, float waveform_sample, float waveform_freq, float angle_x, float angle_y, float angle_z, float accel_x, float accel_y, float accel_z);
+#if AC_RATE_THREAD_ENABLED == ENABLED
+    void Log_Write_Rate_Thread(float rate_hz, uint32_t latency_min_us, uint32_t latency_avg_us, uint32_t latency_max_us);
+#endif
     void Log_Write_Vehicle_Startup_Messages();
     void log_init(void);
 
@@ -863,7 +873,11 @@ private:
     // motors.cpp
     void arm_motors_check();
     void auto_disarm_check();
-    void motors_output();
+    void motors_output(bool output_motors = true);
+    void motors_output_main();
+#if AC_RATE_THREAD_ENABLED == ENABLED
+    void motors_output_fast();
+#endif
     void lost_vehicle_check();
 
     // navigation.cpp
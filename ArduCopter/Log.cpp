@@ -405,6 +405,32 @@ void Copter::Log_Write_Guided_Attitude_Target(ModeGuided::SubMode target_type, f
     logger.WriteBlock(&pkt, sizeof(pkt));
 }
 
+#if AC_RATE_THREAD_ENABLED == ENABLED
+struct PACKED log_Rate_Thread {
+    LOG_PACKET_HEADER;
+    uint64_t time_us;
+    float rate;
+    uint32_t latency_min;
+    uint32_t latency_avg;
+    uint32_t latency_max;
+};
+
+// Write the rate thread loop rate and the time from the gyro sample to
+// the motors output, called from the rate thread
+void Copter::Log_Write_Rate_Thread(float rate_hz, uint32_t latency_min_us, uint32_t latency_avg_us, uint32_t latency_max_us)
+{
+    const log_Rate_Thread pkt {
+        LOG_PACKET_HEADER_INIT(LOG_RATE_THREAD_MSG),
+        time_us         : AP_HAL::micros64(),
+        rate            : rate_hz,
+        latency_min     : latency_min_us,
+        latency_avg     : latency_avg_us,
+        latency_max     : latency_max_us
+    };
+    logger.WriteBlock(&pkt, sizeof(pkt));
+}
+#endif
+
 // type and unit information can be found in
 // libraries/AP_Logger/Logstructure.h; search for "log_Units" for
 // units and "Format characters" for field type information
@@ -558,6 +584,19 @@ const struct LogStructure Copter::log_structure[] = {
 
     { LOG_GUIDED_ATTITUDE_TARGET_MSG, sizeof(log_Guided_Attitude_Target),
       "GUIA",  "QBffffffff",    "TimeUS,Type,Roll,Pitch,Yaw,RollRt,PitchRt,YawRt,Thrust,ClimbRt", "s-dddkkk-n", "F-000000-0" , true },
+
+#if AC_RATE_THREAD_ENABLED == ENABLED
+// @LoggerMessage: RTHR
+// @Description: Rate controller thread timing
+// @Field: TimeUS: Time since system startup
+// @Field: Rate: Rate at which the rate controller ran
+// @Field: LMin: Minimum time from gyro sample to motors output
+// @Field: LAvg: Average time from gyro sample to motors output
+// @Field: LMax: Maximum time from gyro sample to motors output
+
+    { LOG_RATE_THREAD_MSG, sizeof(log_Rate_Thread),
+      "RTHR",  "QfIII",    "TimeUS,Rate,LMin,LAvg,LMax", "szsss", "F0FFF" , true },
+#endif
 };
 
 void Copter::Log_Write_Vehicle_Startup_Messages()
@@ -591,6 +630,9 @@ void Copter::Log_Write_Guided_Position_Target(ModeGuided::SubMode target_type, c
 void Copter::Log_Write_Guided_Attitude_Target(ModeGuided::SubMode target_type, float roll, float pitch, float yaw, const Vector3f &ang_vel, float thrust, float climb_rate) {}
 void Copter::Log_Write_SysID_Setup(uint8_t systemID_axis, float waveform_magnitude, float frequency_start, float frequency_stop, float time_fade_in, float time_const_freq, float time_record, float time_fade_out) {}
 void Copter::Log_Write_SysID_Data(float waveform_time, float waveform_sample, float waveform_freq, float angle_x, float angle_y, float angle_z, float accel_x, float accel_y, float accel_z) {}
+#if AC_RATE_THREAD_ENABLED == ENABLED
+void Copter::Log_Write_Rate_Thread(float rate_hz, uint32_t latency_min_us, uint32_t latency_avg_us, uint32_t latency_max_us) {}
+#endif
 void Copter::Log_Write_Vehicle_Startup_Messages() {}
 
 #if FRAME_CONFIG == HELI_FRAME
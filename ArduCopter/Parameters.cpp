@@ -1200,6 +1200,24 @@ const AP_Param::GroupInfo ParametersG2::var_info2[] = {
     // @User: Standard
     AP_GROUPINFO("PLDP_SPEED_DN", 4, ParametersG2, pldp_descent_speed_ms, 0.0),
 
+#if AC_RATE_THREAD_ENABLED == ENABLED
+    // @Param: FSTRATE_ENABLE
+    // @DisplayName: Fast rate thread enable
+    // @Description: Runs the rate controller and motors output in a dedicated high priority thread on each sample of the primary gyro, rather than at the main loop rate. This keeps the latency from gyro to motors constant when the EKF or flight mode code runs long. Motor outputs are then sent at the gyro rate, so a fast ESC protocol such as DShot should be used. With low latency output the thread only outputs the motors, pushing them straight to the output hardware, while servos and CAN or serial output devices are updated at the main loop rate. The time from gyro sample to motors output is logged in the RTHR message.
+    // @Values: 0:Disabled,1:Enabled,2:Enabled with low latency output
+    // @User: Advanced
+    // @RebootRequired: True
+    AP_GROUPINFO("FSTRATE_ENABLE", 5, ParametersG2, fstrate_enable, 0),
+
+    // @Param: FSTRATE_CPU
+    // @DisplayName: Fast rate thread CPU
+    // @Description: CPU to pin the fast rate thread to on boards with more than one CPU, or -1 to leave it to the operating system.
+    // @Range: -1 7
+    // @User: Advanced
+    // @RebootRequired: True
+    AP_GROUPINFO("FSTRATE_CPU", 6, ParametersG2, fstrate_cpu, -1),
+#endif
+
     // ID 62 is reserved for the AP_SUBGROUPEXTENSION
 
     AP_GROUPEND
@@ -690,6 +690,12 @@ public:
     AP_Float pldp_range_finder_minimum_m;
     AP_Float pldp_delay_s;
     AP_Float pldp_descent_speed_ms;
+
+#if AC_RATE_THREAD_ENABLED == ENABLED
+    // rate controller thread
+    AP_Int8 fstrate_enable;
+    AP_Int8 fstrate_cpu;
+#endif
 };
 
 extern const AP_Param::Info        var_info[];
@@ -653,3 +653,9 @@
 #ifndef AC_CUSTOMCONTROL_MULTI_ENABLED
 #define AC_CUSTOMCONTROL_MULTI_ENABLED FRAME_CONFIG == MULTICOPTER_FRAME && AP_CUSTOMCONTROL_ENABLED
 #endif
+
+//////////////////////////////////////////////////////////////////////////////
+// Rate controller and motors output in their own thread at the gyro rate
+#ifndef AC_RATE_THREAD_ENABLED
+#define AC_RATE_THREAD_ENABLED AP_INERTIALSENSOR_RATE_LOOP_ENABLED && FRAME_CONFIG != HELI_FRAME
+#endif
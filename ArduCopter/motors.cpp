@@ -132,7 +132,8 @@ void Copter::auto_disarm_check()
 }
 
 // motors_output - send output to motors library which will adjust and send to ESCs and servos
-void Copter::motors_output()
+// with output_motors false the motors are output and pushed by the rate thread
+void Copter::motors_output(bool output_motors)
 {
 #if ADVANCED_FAILSAFE == ENABLED
     // this is to allow the failsafe module to deliberately crash
@@ -156,7 +157,9 @@ void Copter::motors_output()
     SRV_Channels::calc_pwm();
 
     // cork now, so that all channel outputs happen at once
-    SRV_Channels::cork();
+    if (output_motors) {
+        SRV_Channels::cork();
+    }
 
     // update output on any aux channels, for manual passthru
     SRV_Channels::output_ch_all();
@@ -174,14 +177,56 @@ void Copter::motors_output()
     if (ap.motor_test) {
         // check if we are performing the motor test
         motor_test_output();
-    } else {
+    } else if (output_motors) {
         // send output signals to motors
         flightmode->output_to_motors();
     }
 
-    // push all channels
-    SRV_Channels::push();
+    if (output_motors) {
+        // push all channels
+        SRV_Channels::push();
+    } else {
+        SRV_Channels::push_devices();
+    }
+}
+
+// motors output from the main loop, unless the rate thread has taken it over
+void Copter::motors_output_main()
+{
+#if AC_RATE_THREAD_ENABLED == ENABLED
+    if (using_rate_thread) {
+        if (g2.fstrate_enable == 2) {
+            // the rate thread only outputs the motors
+            motors_output(false);
+        }
+        return;
+    }
+#endif
+    motors_output();
+}
+
+#if AC_RATE_THREAD_ENABLED == ENABLED
+/*
+  low latency motors output from the rate thread. The motor outputs
+  go straight to hal.rcout without the servo output passes and output
+  device updates of motors_output(), which the main loop still runs
+ */
+void Copter::motors_output_fast()
+{
+#if ADVANCED_FAILSAFE == ENABLED
+    if (g2.afs.should_crash_vehicle() && !g2.afs.terminating_vehicle_via_landing()) {
+        return;
+    }
+#endif
+    if (ap.motor_test) {
+        // run from the main loop
+        return;
+    }
+    hal.rcout->cork();
+    flightmode->output_to_motors();
+    hal.rcout->push();
 }
+#endif
 
 // check for pilot stick input to trigger lost vehicle alarm
 void Copter::lost_vehicle_check()
@@ -187,6 +187,10 @@ void Copter::init_ardupilot()
     custom_control.init();
 #endif
 
+#if AC_RATE_THREAD_ENABLED == ENABLED
+    start_rate_thread();
+#endif
+
     // set landed flags
     set_land_complete(true);
     set_land_complete_maybe(true);
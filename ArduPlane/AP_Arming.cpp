@@ -401,31 +401,41 @@ bool AP_Arming_Plane::mission_checks(bool report)
 {
     // base checks
     bool ret = AP_Arming::mission_checks(report);
-    if (plane.mission.get_landing_sequence_start() > 0 && plane.g.rtl_autoland == RtlAutoland::RTL_DISABLE) {
+    if (plane.g.rtl_autoland == RtlAutoland::RTL_DISABLE && plane.mission.get_landing_sequence_start() > 0) {
         ret = false;
         check_failed(ARMING_CHECK_MISSION, report, "DO_LAND_START set and RTL_AUTOLAND disabled");
     }
 #if HAL_QUADPLANE_ENABLED
     if (plane.quadplane.available()) {
-        const uint16_t num_commands = plane.mission.num_commands();
-        AP_Mission::Mission_Command prev_cmd {};
-        for (uint16_t i=1; i<num_commands; i++) {
-            AP_Mission::Mission_Command cmd;
-            if (!plane.mission.read_cmd_from_storage(i, cmd)) {
-                break;
-            }
-            if ((cmd.id == MAV_CMD_NAV_VTOL_LAND || cmd.id == MAV_CMD_NAV_LAND) &&
-                prev_cmd.id == MAV_CMD_NAV_WAYPOINT) {
-                const float dist = cmd.content.location.get_distance(prev_cmd.content.location);
-                const float tecs_land_speed = plane.TECS_controller.get_land_airspeed();
-                const float landing_speed = is_positive(tecs_land_speed)?tecs_land_speed:plane.aparm.airspeed_cruise_cm*0.01;
-                const float min_dist = 0.75 * plane.quadplane.stopping_distance(sq(landing_speed));
-                if (dist < min_dist) {
-                    ret = false;
-                    check_failed(ARMING_CHECK_MISSION, report, "VTOL land too short, min %.0fm", min_dist);
+        if (vtol_land_cache.stale(plane.mission)) {
+            vtol_land_min_leg = -1;
+            const uint16_t num_commands = plane.mission.num_commands();
+            AP_Mission::Mission_Command prev_cmd {};
+            for (uint16_t i=1; i<num_commands; i++) {
+                AP_Mission::Mission_Command cmd;
+                if (!plane.mission.read_cmd_from_storage(i, cmd)) {
+                    break;
+                }
+                if ((cmd.id == MAV_CMD_NAV_VTOL_LAND || cmd.id == MAV_CMD_NAV_LAND) &&
+                    prev_cmd.id == MAV_CMD_NAV_WAYPOINT) {
+                    const float dist = cmd.content.location.get_distance(prev_cmd.content.location);
+                    if (vtol_land_min_leg < 0 || dist < vtol_land_min_leg) {
+                        vtol_land_min_leg = dist;
+                    }
                 }
+                prev_cmd = cmd;
+            }
+            vtol_land_cache.update(plane.mission);
+        }
+        // the stopping distance depends on parameters, so is not cached
+        if (vtol_land_min_leg >= 0) {
+            const float tecs_land_speed = plane.TECS_controller.get_land_airspeed();
+            const float landing_speed = is_positive(tecs_land_speed)?tecs_land_speed:plane.aparm.airspeed_cruise_cm*0.01;
+            const float min_dist = 0.75 * plane.quadplane.stopping_distance(sq(landing_speed));
+            if (vtol_land_min_leg < min_dist) {
+                ret = false;
+                check_failed(ARMING_CHECK_MISSION, report, "VTOL land too short, min %.0fm", min_dist);
             }
-            prev_cmd = cmd;
         }
     }
 #endif
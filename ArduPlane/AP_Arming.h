@@ -42,4 +42,8 @@ private:
     // oneshot with duration AP_ARMING_DELAY_MS used by quadplane to delay spoolup after arming:
     // ignored unless OPTION_DELAY_ARMING or OPTION_TILT_DISARMED is set
     bool delay_arming;
+
+    // shortest waypoint to VTOL landing leg in the mission, negative if none
+    MissionCache vtol_land_cache;
+    float vtol_land_min_leg;
 };
@@ -70,6 +70,7 @@ const AP_Scheduler::Task Plane::scheduler_tasks[] = {
     SCHED_TASK(update_compass,         10,    200,  39),
     SCHED_TASK(calc_airspeed_errors,   10,    100,  42),
     SCHED_TASK(update_alt,             10,    200,  45),
+    SCHED_TASK(update_tecs, TECS_UPDATE_RATE_HZ, 200,  46),
     SCHED_TASK(adjust_altitude_target, 10,    200,  48),
 #if ADVANCED_FAILSAFE == ENABLED
     SCHED_TASK(afs_fs_check,           10,    100,  51),
@@ -538,7 +539,13 @@ void Plane::update_alt()
 #endif
 
     update_flight_stage();
+}
 
+/*
+  run the TECS speed and height controller, at TECS_UPDATE_RATE_HZ
+ */
+void Plane::update_tecs()
+{
 #if AP_SCRIPTING_ENABLED
     if (nav_scripting_active()) {
         // don't call TECS while we are in a trick
@@ -25,6 +25,9 @@
  */
 void Plane::adjust_altitude_target()
 {
+    if (fixed_wing_nav_shed()) {
+        return;
+    }
     control_mode->update_target_altitude();
 }
 
@@ -32,6 +32,15 @@
  # define ADVANCED_FAILSAFE ENABLED
 #endif
 
+//////////////////////////////////////////////////////////////////////////////
+// TECS speed and height controller rate. Gliders tracking thermals
+// benefit from a faster rate, which must not be above SCHED_LOOP_RATE
+//
+
+#ifndef TECS_UPDATE_RATE_HZ
+ # define TECS_UPDATE_RATE_HZ 10
+#endif
+
 
 //////////////////////////////////////////////////////////////////////////////
 //////////////////////////////////////////////////////////////////////////////
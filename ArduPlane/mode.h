@@ -735,6 +735,7 @@ protected:
     void restore_mode(const char *reason, ModeReason modereason);
 
     bool _enter() override;
+    void _exit() override;
 };
 
 #endif
@@ -18,6 +18,12 @@ bool ModeThermal::_enter()
     return true;
 }
 
+void ModeThermal::_exit()
+{
+    // remember the thermal so it can be tried again later
+    plane.g2.soaring_controller.end_thermalling();
+}
+
 void ModeThermal::update()
 {
     plane.calc_nav_roll();
@@ -80,11 +80,32 @@ void Plane::loiter_angle_update(void)
     }
 }
 
+/*
+  true in the VTOL modes which only hover, where the fixed wing
+  navigation and altitude targets are not used. The fixed wing tasks
+  are shed in these modes to leave the loop time to the VTOL
+  controllers, which run as fast tasks
+ */
+bool Plane::fixed_wing_nav_shed(void) const
+{
+#if HAL_QUADPLANE_ENABLED
+    return quadplane.available() &&
+        control_mode->is_vtol_mode() &&
+        !control_mode->does_auto_throttle();
+#else
+    return false;
+#endif
+}
+
 //****************************************************************
 // Function that will calculate the desired direction to fly and distance
 //****************************************************************
 void Plane::navigate()
 {
+    if (fixed_wing_nav_shed()) {
+        return;
+    }
+
     // do not navigate with corrupt data
     // ---------------------------------
     if (!have_position) {
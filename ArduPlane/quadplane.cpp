@@ -1425,6 +1425,16 @@ bool QuadPlane::should_assist(float aspeed, bool have_airspeed)
         return false;
     }
 
+#if AP_AIRSPEED_HIGHRATE_ENABLED
+    // react to gusts with every airspeed sensor sample rather than
+    // the 10Hz average
+    float highrate_aspeed;
+    if (have_airspeed && ahrs.airspeed_sensor_enabled() &&
+        plane.airspeed.get_airspeed_highrate(highrate_aspeed)) {
+        aspeed = highrate_aspeed;
+    }
+#endif
+
     // assistance due to Q_ASSIST_SPEED
     // if option bit is enabled only allow assist with real airspeed sensor
     if ((have_airspeed && aspeed < assist_speed) && 
@@ -58,6 +58,8 @@ const AP_Scheduler::Task Sub::scheduler_tasks[] = {
     FAST_TASK(read_inertia),
     // check if ekf has reset target heading
     FAST_TASK(check_ekf_yaw_reset),
+    // pick up joystick input that has arrived since the last loop
+    FAST_TASK(read_pilot_input),
     // run the attitude controllers
     FAST_TASK(update_flight_mode),
     // update home from EKF if necessary
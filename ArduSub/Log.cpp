@@ -197,6 +197,25 @@ void Sub::Log_Write_GuidedTarget(uint8_t target_type, const Vector3f& pos_target
     logger.WriteBlock(&pkt, sizeof(pkt));
 }
 
+struct PACKED log_Pilot_Input {
+    LOG_PACKET_HEADER;
+    uint64_t time_us;
+    uint32_t latency_us;
+    uint32_t gap_ms;
+};
+
+// Write the latency of joystick input to the thrusters
+void Sub::Log_Write_Pilot_Input(uint32_t latency_us, uint32_t gap_ms)
+{
+    struct log_Pilot_Input pkt = {
+        LOG_PACKET_HEADER_INIT(LOG_PILOT_INPUT_MSG),
+        time_us         : AP_HAL::micros64(),
+        latency_us      : latency_us,
+        gap_ms          : gap_ms
+    };
+    logger.WriteBlock(&pkt, sizeof(pkt));
+}
+
 // @LoggerMessage: CTUN
 // @Description: Control Tuning information
 // @Field: TimeUS: Time since system startup
@@ -262,6 +281,12 @@ void Sub::Log_Write_GuidedTarget(uint8_t target_type, const Vector3f& pos_target
 // @Field: vY: Target velocity, Y-Axis
 // @Field: vZ: Target velocity, Z-Axis
 
+// @LoggerMessage: JOYL
+// @Description: Joystick input latency
+// @Field: TimeUS: Time since system startup
+// @Field: Lat: Time from the MANUAL_CONTROL message arriving to the thrusters being set from it
+// @Field: Gap: Time between the last two MANUAL_CONTROL messages
+
 // type and unit information can be found in
 // libraries/AP_Logger/Logstructure.h; search for "log_Units" for
 // units and "Format characters" for field type information
@@ -281,6 +306,8 @@ const struct LogStructure Sub::log_structure[] = {
       "DFLT",  "QBf",         "TimeUS,Id,Value", "s--", "F--" },
     { LOG_GUIDEDTARGET_MSG, sizeof(log_GuidedTarget),
       "GUIP",  "QBffffff",    "TimeUS,Type,pX,pY,pZ,vX,vY,vZ", "s-mmmnnn", "F-000000" },
+    { LOG_PILOT_INPUT_MSG, sizeof(log_Pilot_Input),
+      "JOYL",  "QII",         "TimeUS,Lat,Gap", "sss", "FFC" },
 };
 
 void Sub::Log_Write_Vehicle_Startup_Messages()
@@ -307,6 +334,7 @@ void Sub::Log_Write_Data(LogDataID id, int16_t value) {}
 void Sub::Log_Write_Data(LogDataID id, uint16_t value) {}
 void Sub::Log_Write_Data(LogDataID id, float value) {}
 void Sub::Log_Write_GuidedTarget(uint8_t target_type, const Vector3f& pos_target, const Vector3f& vel_target) {}
+void Sub::Log_Write_Pilot_Input(uint32_t latency_us, uint32_t gap_ms) {}
 void Sub::Log_Write_Vehicle_Startup_Messages() {}
 
 void Sub::log_init(void) {}
@@ -198,6 +198,15 @@ private:
     RCMapper rcmap;
 #endif
 
+    // MANUAL_CONTROL input, timed from arrival to the thrusters
+    struct {
+        GCS_MAVLINK *link;      // link the pilot's input arrives on
+        uint32_t arrival_us;    // when the newest input arrived, zero once it has been output
+        uint32_t last_ms;       // when the previous input arrived
+        uint32_t gap_ms;        // time between the last two inputs
+        bool applied;           // the flight mode has run with the newest input
+    } pilot_input;
+
     // Failsafe
     struct {
         uint32_t last_leak_warn_ms;      // last time a leak warning was sent to gcs
@@ -397,6 +406,7 @@ private:
     void Log_Write_Data(LogDataID id, uint16_t value);
     void Log_Write_Data(LogDataID id, float value);
     void Log_Write_GuidedTarget(uint8_t target_type, const Vector3f& pos_target, const Vector3f& vel_target);
+    void Log_Write_Pilot_Input(uint32_t latency_us, uint32_t gap_ms);
     void Log_Write_Vehicle_Startup_Messages();
     void load_parameters(void) override;
     void userhook_init();
@@ -503,6 +513,8 @@ private:
     void enable_motor_output();
     void init_joystick();
     void transform_manual_control_to_rc_override(int16_t x, int16_t y, int16_t z, int16_t r, uint16_t buttons);
+    void pilot_input_received(GCS_MAVLINK &link);
+    void read_pilot_input();
     void handle_jsbutton_press(uint8_t button,bool shift=false,bool held=false);
     void handle_jsbutton_release(uint8_t button, bool shift);
     JSButton* get_button(uint8_t index);
@@ -62,6 +62,10 @@
 # define THR_SURFACE_TRACKING_VELZ_MAX 150 // max vertical speed change while surface tracking with rangefinder
 #endif
 
+#ifndef PILOT_INPUT_RECEIVE_US
+# define PILOT_INPUT_RECEIVE_US 200         // time the fast loop may spend receiving on the pilot's link
+#endif
+
 #ifndef RANGEFINDER_TIMEOUT_MS
 # define RANGEFINDER_TIMEOUT_MS  1000      // desired rangefinder alt will reset to current rangefinder alt after this many milliseconds without a good rangefinder alt
 #endif
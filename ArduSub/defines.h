@@ -90,7 +90,8 @@ enum LoggingParameters {
     LOG_DATA_INT32_MSG,
     LOG_DATA_UINT32_MSG,
     LOG_DATA_FLOAT_MSG,
-    LOG_GUIDEDTARGET_MSG
+    LOG_GUIDEDTARGET_MSG,
+    LOG_PILOT_INPUT_MSG
 };
 
 #define MASK_LOG_ATTITUDE_FAST          (1<<0)
@@ -153,6 +153,10 @@ void Sub::update_flight_mode()
     default:
         break;
     }
+
+    if (pilot_input.arrival_us != 0) {
+        pilot_input.applied = true;
+    }
 }
 
 // exit_mode - high level call to organise cleanup as a flight mode is exited
@@ -50,6 +50,28 @@ void Sub::init_joystick()
     gain = constrain_float(gain, 0.1, 1.0);
 }
 
+// note the arrival of a MANUAL_CONTROL message, and the link it came on
+void Sub::pilot_input_received(GCS_MAVLINK &link)
+{
+    const uint32_t now_ms = AP_HAL::millis();
+    pilot_input.link = &link;
+    pilot_input.arrival_us = AP_HAL::micros();
+    pilot_input.applied = false;
+    pilot_input.gap_ms = now_ms - pilot_input.last_ms;
+    pilot_input.last_ms = now_ms;
+}
+
+// receive on the pilot's link from the fast loop, ahead of the flight
+// mode update. Input that arrived since the last loop is then used in
+// this loop, rather than waiting for the scheduled GCS receive at the
+// end of it and the flight mode update of the next one
+void Sub::read_pilot_input()
+{
+    if (pilot_input.link != nullptr) {
+        pilot_input.link->update_receive(PILOT_INPUT_RECEIVE_US);
+    }
+}
+
 void Sub::transform_manual_control_to_rc_override(int16_t x, int16_t y, int16_t z, int16_t r, uint16_t buttons)
 {
 
@@ -20,6 +20,15 @@ void Sub::motors_output()
         motors.set_interlock(true);
         motors.output();
     }
+
+    // the thrusters now reflect the newest joystick input
+    if (pilot_input.applied) {
+        if (should_log(MASK_LOG_RCIN)) {
+            Log_Write_Pilot_Input(AP_HAL::micros() - pilot_input.arrival_us, pilot_input.gap_ms);
+        }
+        pilot_input.applied = false;
+        pilot_input.arrival_us = 0;
+    }
 }
 
 // Initialize new style motor test
@@ -301,6 +301,21 @@ const AP_Param::GroupInfo GCS_MAVLINK_Parameters::var_info[] = {
     // @RebootRequired: True
     // @User: Advanced
     AP_GROUPINFO("PARAMS",   8, GCS_MAVLINK_Parameters, streamRates[8],  0),
+
+    // @Param: ADAPTIVE
+    // @DisplayName: Adaptive stream rates
+    // @Description: Scale stream rates on this link to the measured link capacity. Streams are slowed while the link is congested (failed sends, a filling transmit buffer, a filling radio buffer reported by RADIO_STATUS, or streams using more than 60% of the link bandwidth) and sped up again once it has headroom. Critical messages such as ATTITUDE and GLOBAL_POSITION_INT are slowed least.
+    // @Values: 0:Disabled,1:Enabled
+    // @User: Advanced
+    AP_GROUPINFO("ADAPTIVE", 10, GCS_MAVLINK_Parameters, adaptive_rates, 0),
+
+    // @Param: RXTHREAD
+    // @DisplayName: Receive thread
+    // @Description: Parse MAVLink received on this link in a separate thread, leaving only the message handlers to the main loop. Vehicle control messages such as commands and position targets are handled first, and other messages such as obstacle distances, vision and RTCM are handled within the main loop time allowed for receiving. Ignored while another protocol is sharing the link.
+    // @Values: 0:Disabled,1:Enabled
+    // @RebootRequired: True
+    // @User: Advanced
+    AP_GROUPINFO("RXTHREAD", 11, GCS_MAVLINK_Parameters, rx_thread, 0),
     AP_GROUPEND
 };
 
@@ -40,6 +40,7 @@
 const AP_HAL::HAL& hal = AP_HAL::get_HAL();
 
 #define SCHED_TASK(func, _interval_ticks, _max_time_micros, _priority) SCHED_TASK_CLASS(Rover, &rover, func, _interval_ticks, _max_time_micros, _priority)
+#define FAST_TASK(func) FAST_TASK_CLASS(Rover, &rover, func)
 
 /*
   scheduler table - all regular tasks should be listed here.
@@ -69,15 +70,18 @@ SCHED_TASK_CLASS arguments:
   they are expected to take (in microseconds)
  */
 const AP_Scheduler::Task Rover::scheduler_tasks[] = {
+    // run the EKF, then the mode's steering and throttle controllers and
+    // the outputs every loop, ahead of everything else so they are
+    // never delayed by slower tasks such as proximity or navigation
+    FAST_TASK(ahrs_update),
+    FAST_TASK(update_current_mode),
+    FAST_TASK(set_servos),
     //         Function name,          Hz,     us,
     SCHED_TASK(read_radio,             50,    200,   3),
-    SCHED_TASK(ahrs_update,           400,    400,   6),
     SCHED_TASK(read_rangefinders,      50,    200,   9),
 #if AP_OPTICALFLOW_ENABLED
     SCHED_TASK_CLASS(AP_OpticalFlow,      &rover.optflow,          update,         200, 160,  11),
 #endif
-    SCHED_TASK(update_current_mode,   400,    200,  12),
-    SCHED_TASK(set_servos,            400,    200,  15),
     SCHED_TASK_CLASS(AP_GPS,              &rover.gps,              update,         50,  300,  18),
     SCHED_TASK_CLASS(AP_Baro,             &rover.barometer,        update,         10,  200,  21),
     SCHED_TASK_CLASS(AP_Beacon,           &rover.g2.beacon,        update,         50,  200,  24),
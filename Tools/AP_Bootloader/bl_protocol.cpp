@@ -82,6 +82,9 @@
 // GET_CRC		verify CRC of entire flashable area
 // RESET		finalise flash programming, reset chip and starts application
 //
+// If GET_DEVICE/DEVICE_COMPRESSED_BLOCK succeeds, PROG_COMPRESSED may be
+// used in place of PROG_MULTI
+//
 
 #define BL_PROTOCOL_VERSION 		5		// The revision of the bootloader protocol
 // protocol bytes
@@ -117,6 +120,7 @@
 #define PROTO_EXTF_GET_CRC          0x37	// compute & return a CRC of data in external flash
 
 #define PROTO_CHIP_FULL_ERASE   0x40    // erase program area and reset program address, skip any flash wear optimization and force an erase
+#define PROTO_PROG_COMPRESSED   0x41    // add bytes to a compressed block, or with no bytes decompress the block and program it at program address
 
 #define PROTO_PROG_MULTI_MAX    64	// maximum PROG_MULTI size
 #define PROTO_READ_MULTI_MAX    255	// size of the size field
@@ -128,6 +132,7 @@
 #define PROTO_DEVICE_FW_SIZE	4	// size of flashable area
 #define PROTO_DEVICE_VEC_AREA	5	// contents of reserved vectors 7-10
 #define PROTO_DEVICE_EXTF_SIZE  6   // size of available external flash
+#define PROTO_DEVICE_COMPRESSED_BLOCK 7 // largest decompressed block for PROG_COMPRESSED
 // all except PROTO_DEVICE_VEC_AREA and PROTO_DEVICE_BOARD_REV should be done
 #define CHECK_GET_DEVICE_FINISHED(x)   ((x & (0xB)) == 0xB)
 
@@ -160,6 +165,38 @@ extern AP_FlashIface_JEDEC ext_flash;
 #define BOOT_FROM_EXT_FLASH 0
 #endif
 
+// compressed upload needs about 10k of RAM
+#ifndef BOOTLOADER_COMPRESSED_UPLOAD
+#if defined(STM32H7) || defined(STM32F7) || defined(STM32F4)
+#define BOOTLOADER_COMPRESSED_UPLOAD 1
+#else
+#define BOOTLOADER_COMPRESSED_UPLOAD 0
+#endif
+#endif
+
+#if BOOTLOADER_COMPRESSED_UPLOAD
+#include <AP_ROMFS/tinf.h>
+
+// the image is sent as independent raw deflate streams each of up to
+// COMPRESSED_BLOCK_SIZE bytes of image
+#define COMPRESSED_BLOCK_SIZE 4096
+// deflate can make incompressible data slightly larger
+#define COMPRESSED_BLOCK_MAX  (COMPRESSED_BLOCK_SIZE + 64)
+
+static struct {
+    uint8_t in[COMPRESSED_BLOCK_MAX];
+    uint16_t in_len;
+    union {
+        uint8_t c[COMPRESSED_BLOCK_SIZE];
+        uint32_t w[COMPRESSED_BLOCK_SIZE/4];
+    } out;
+    uint16_t out_len;       // decompressed bytes waiting to be programmed
+    uint32_t out_address;   // address to program them at
+    bool failed;            // programming failed, reported on the next PROG_COMPRESSED
+    TINF_DATA tinf;
+} cblock;
+#endif
+
 /*
   1ms timer tick callback
  */
@@ -446,6 +483,63 @@ static void test_flash()
 }
 #endif
 
+/*
+  hold back the words at the front of flash, which are programmed
+  last so an interrupted upload never leaves a bootable image
+ */
+static void defer_first_words(uint32_t *first_words, uint32_t address, uint32_t *words, uint32_t len)
+{
+#if !BOOT_FROM_EXT_FLASH
+    if (address < RESERVE_LEAD_WORDS*4) {
+        uint8_t n = MIN(RESERVE_LEAD_WORDS*4-address, len);
+        memcpy(&first_words[address/4], &words[0], n);
+        // replace first words with 1 bits we can overwrite later
+        memset(&words[0], 0xFF, n);
+    }
+#endif
+}
+
+#if BOOTLOADER_COMPRESSED_UPLOAD
+/*
+  decompress a block received with PROG_COMPRESSED, ready for
+  program_compressed_block()
+ */
+static bool decompress_block(void)
+{
+    TINF_DATA &d = cblock.tinf;
+    uzlib_uncompress_init(&d, NULL, 0);
+    d.source = cblock.in;
+    d.source_limit = &cblock.in[cblock.in_len];
+    d.dest = cblock.out.c;
+    d.destSize = sizeof(cblock.out.c);
+
+    const int res = uzlib_uncompress(&d);
+    cblock.in_len = 0;
+    if ((res != TINF_OK && res != TINF_DONE) || d.eof) {
+        return false;
+    }
+    cblock.out_len = d.dest - cblock.out.c;
+    return cblock.out_len > 0 && (cblock.out_len % 4) == 0;
+}
+
+/*
+  program the last decompressed block
+ */
+static bool program_compressed_block(uint32_t *first_words)
+{
+    const uint16_t nwords = cblock.out_len / 4;
+    cblock.out_len = 0;
+    defer_first_words(first_words, cblock.out_address, cblock.out.w, nwords*4);
+    for (uint16_t i = 0; i < nwords; i += PROTO_PROG_MULTI_MAX) {
+        const uint8_t n = MIN(nwords - i, PROTO_PROG_MULTI_MAX);
+        if (!flash_write_buffer(cblock.out_address + i*4, &cblock.out.w[i], n)) {
+            return false;
+        }
+    }
+    return true;
+}
+#endif
+
 void
 bootloader(unsigned timeout)
 {
@@ -492,6 +586,14 @@ bootloader(unsigned timeout)
             uint32_t	w[64];
         } flash_buffer;
 
+#if BOOTLOADER_COMPRESSED_UPLOAD
+        // program the last decompressed block while the host sends the
+        // next one
+        if (cblock.out_len != 0 && !program_compressed_block(first_words)) {
+            cblock.failed = true;
+        }
+#endif
+
         // Wait for a command byte
         led_off(LED_ACTIVITY);
 
@@ -586,6 +688,12 @@ bootloader(unsigned timeout)
                 cout((uint8_t *)&board_info.extf_size, sizeof(board_info.extf_size));
                 break;
 
+#if BOOTLOADER_COMPRESSED_UPLOAD
+            case PROTO_DEVICE_COMPRESSED_BLOCK:
+                cout_word(COMPRESSED_BLOCK_SIZE);
+                break;
+#endif
+
             default:
                 goto cmd_bad;
             }
@@ -858,14 +966,7 @@ bootloader(unsigned timeout)
             }
 
             // save the first words and don't program it until everything else is done
-#if !BOOT_FROM_EXT_FLASH
-            if (address < sizeof(first_words)) {
-                uint8_t n = MIN(sizeof(first_words)-address, arg);
-                memcpy(&first_words[address/4], &flash_buffer.w[0], n);
-                // replace first words with 1 bits we can overwrite later
-                memset(&flash_buffer.w[0], 0xFF, n);
-            }
-#endif
+            defer_first_words(first_words, address, flash_buffer.w, arg);
             arg /= 4;
             // program the words
             if (!flash_write_buffer(address, flash_buffer.w, arg)) {
@@ -874,6 +975,80 @@ bootloader(unsigned timeout)
             address += arg * 4;
             break;
 
+#if BOOTLOADER_COMPRESSED_UPLOAD
+        // program compressed bytes at current address
+        //
+        // command:		PROG_COMPRESSED/<len:1>/<data:len>/EOC
+        // success reply:	INSYNC/OK
+        // invalid reply:	INSYNC/INVALID
+        // failure reply:	INSYNC/FAILURE
+        //
+        // each block of the image is a raw deflate stream of up to
+        // COMPRESSED_BLOCK_SIZE bytes, a multiple of 4, sent over as
+        // many commands as needed and ended by one with zero length.
+        // The block is decompressed before the reply and programmed
+        // while the host sends the next one, so a programming failure
+        // is reported on the next PROG_COMPRESSED
+        //
+        case PROTO_PROG_COMPRESSED:
+            if (!done_sync || !CHECK_GET_DEVICE_FINISHED(done_get_device_flags)) {
+                // lower chance of random data on a uart triggering erase
+                goto cmd_bad;
+            }
+
+            led_set(LED_OFF);
+
+            arg = cin(50);
+
+            if (arg < 0) {
+                goto cmd_bad;
+            }
+
+            if (cblock.in_len + arg > sizeof(cblock.in)) {
+                cblock.in_len = 0;
+                goto cmd_bad;
+            }
+
+            for (int i = 0; i < arg; i++) {
+                c = cin(1000);
+
+                if (c < 0) {
+                    goto cmd_bad;
+                }
+
+                cblock.in[cblock.in_len + i] = c;
+            }
+
+            if (!wait_for_eoc(200)) {
+                goto cmd_bad;
+            }
+
+            if (cblock.failed) {
+                cblock.failed = false;
+                cblock.in_len = 0;
+                goto cmd_fail;
+            }
+
+            if (arg > 0) {
+                cblock.in_len += arg;
+                break;
+            }
+
+            if (!decompress_block()) {
+                cblock.out_len = 0;
+                goto cmd_fail;
+            }
+
+            if ((address + cblock.out_len) > board_info.fw_size) {
+                cblock.out_len = 0;
+                goto cmd_bad;
+            }
+
+            cblock.out_address = address;
+            address += cblock.out_len;
+            break;
+#endif
+
         // fetch CRC of the entire flash area
         //
         // command:			GET_CRC/EOC
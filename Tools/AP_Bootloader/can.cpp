@@ -76,6 +76,40 @@ static struct {
     uint32_t sector_ofs;
 } fw_update;
 
+// time to wait for a reply to a file read before asking again
+#define FW_READ_RETRY_MS 750
+
+/*
+  multicast update. Nodes updating from the same server with the same
+  file listen to each other's file reads, and take any reply carrying
+  the data they need next rather than each reading the whole file. A
+  node that sees another node's read of the offset it needs doesn't
+  send its own, so a group of identical nodes started together are
+  updated in about the time it takes to update one
+ */
+#ifndef AP_BOOTLOADER_CAN_MULTICAST_ENABLED
+#define AP_BOOTLOADER_CAN_MULTICAST_ENABLED 1
+#endif
+
+#if AP_BOOTLOADER_CAN_MULTICAST_ENABLED
+// how long a node that took another node's reply waits before reading
+// for itself, giving the other node time to ask for the next offset
+#define FW_MULTICAST_HOLDOFF_MS 20
+
+// reads by other nodes we may take the reply to
+static struct {
+    uint64_t ofs;
+    uint32_t seen_ms;
+    uint8_t node_id;
+    uint8_t transfer_id;
+} fw_snoop[4];
+static uint8_t fw_snoop_next;
+
+// destination of the frame being handled, before handle_rx_frame()
+// addressed it to us
+static uint8_t rx_dest_node_id;
+#endif
+
 /*
   get cpu unique ID
  */
@@ -153,12 +187,21 @@ static void handle_get_node_info(CanardInstance* ins,
 static void send_fw_read(void)
 {
     uint32_t now = AP_HAL::millis();
-    if (now - fw_update.last_ms < 750) {
+    if (now - fw_update.last_ms < FW_READ_RETRY_MS) {
         // the server may still be responding
         return;
     }
     fw_update.last_ms = now;
 
+#if AP_BOOTLOADER_CAN_MULTICAST_ENABLED
+    for (const auto &s : fw_snoop) {
+        if (s.node_id != 0 && s.ofs == fw_update.ofs && now - s.seen_ms < FW_READ_RETRY_MS) {
+            // another node has asked for it, take their reply
+            return;
+        }
+    }
+#endif
+
     uint8_t buffer[UAVCAN_PROTOCOL_FILE_READ_REQUEST_MAX_SIZE];
     canardEncodeScalar(buffer, 0, 40, &fw_update.ofs);
     uint32_t offset = 40;
@@ -179,13 +222,66 @@ static void send_fw_read(void)
                            total_size);
 }
 
+#if AP_BOOTLOADER_CAN_MULTICAST_ENABLED
+/*
+  handle another node's file read request, remembering it if it is for
+  the file we are updating from
+ */
+static void handle_file_read_request(CanardInstance* ins, CanardRxTransfer* transfer)
+{
+    const uint8_t path_len = strlen((const char *)fw_update.path);
+    if (fw_update.node_id == 0 ||
+        transfer->source_node_id == canardGetLocalNodeID(ins) ||
+        transfer->payload_len != 5 + path_len) {
+        return;
+    }
+    uint32_t offset = 40;
+    for (uint8_t i=0; i<path_len; i++) {
+        uint8_t c;
+        canardDecodeScalar(transfer, offset, 8, false, (void*)&c);
+        if (c != fw_update.path[i]) {
+            return;
+        }
+        offset += 8;
+    }
+    auto &s = fw_snoop[fw_snoop_next];
+    fw_snoop_next = (fw_snoop_next + 1) % ARRAY_SIZE(fw_snoop);
+    canardDecodeScalar(transfer, 0, 40, false, (void*)&s.ofs);
+    s.seen_ms = AP_HAL::millis();
+    s.node_id = transfer->source_node_id;
+    s.transfer_id = transfer->transfer_id;
+}
+#endif
+
 /*
   handle response to file read for fw update
  */
 static void handle_file_read_response(CanardInstance* ins, CanardRxTransfer* transfer)
 {
-    if ((transfer->transfer_id+1)%256 != fw_update.transfer_id ||
-        transfer->source_node_id != fw_update.node_id) {
+    if (transfer->source_node_id != fw_update.node_id) {
+        return;
+    }
+    // ask for the next offset straight away
+    uint32_t next_read_last_ms = 0;
+#if AP_BOOTLOADER_CAN_MULTICAST_ENABLED
+    if (rx_dest_node_id != canardGetLocalNodeID(ins)) {
+        // a reply to another node, take it if it is the data we need next
+        bool wanted = false;
+        for (auto &s : fw_snoop) {
+            if (s.node_id == rx_dest_node_id && s.transfer_id == transfer->transfer_id) {
+                wanted = s.ofs == fw_update.ofs;
+                s.node_id = 0;
+                break;
+            }
+        }
+        if (!wanted) {
+            return;
+        }
+        // let the other node ask for the next offset
+        next_read_last_ms = AP_HAL::millis() - (FW_READ_RETRY_MS - FW_MULTICAST_HOLDOFF_MS);
+    } else
+#endif
+    if ((transfer->transfer_id+1)%256 != fw_update.transfer_id) {
         return;
     }
     int16_t error = 0;
@@ -230,7 +326,7 @@ static void handle_file_read_response(CanardInstance* ins, CanardRxTransfer* tra
     // show offset number we are flashing in kbyte as crude progress indicator
     node_status.vendor_specific_status_code = 1 + (fw_update.ofs / 1024U);
 
-    fw_update.last_ms = 0;
+    fw_update.last_ms = next_read_last_ms;
 }
 
 /*
@@ -351,6 +447,12 @@ static void onTransferReceived(CanardInstance* ins,
         break;
 
     case UAVCAN_PROTOCOL_FILE_READ_ID:
+#if AP_BOOTLOADER_CAN_MULTICAST_ENABLED
+        if (transfer->transfer_type == CanardTransferTypeRequest) {
+            handle_file_read_request(ins, transfer);
+            break;
+        }
+#endif
         handle_file_read_response(ins, transfer);
         break;
 
@@ -409,6 +511,36 @@ static bool shouldAcceptTransfer(const CanardInstance* ins,
     return false;
 }
 
+/*
+  pass a received frame to libcanard. During a multicast update file
+  reads between other nodes and our server are addressed to us, as
+  libcanard drops transfers for other nodes
+ */
+static void handle_rx_frame(CanardCANFrame &frame, uint64_t timestamp)
+{
+#if AP_BOOTLOADER_CAN_MULTICAST_ENABLED
+    const uint8_t local_node_id = canardGetLocalNodeID(&canard);
+    rx_dest_node_id = local_node_id;
+    // service frame ID: type in bits 16..23, request flag bit 15,
+    // destination in bits 8..14, service flag bit 7, source in bits 0..6
+    const uint32_t id = frame.id & CANARD_CAN_EXT_ID_MASK;
+    if (fw_update.node_id != 0 &&
+        (frame.id & CANARD_CAN_FRAME_EFF) &&
+        (id & (1U<<7)) &&
+        ((id >> 16) & 0xFF) == UAVCAN_PROTOCOL_FILE_READ_ID) {
+        const uint8_t source = id & 0x7F;
+        const uint8_t dest = (id >> 8) & 0x7F;
+        const bool request = (id & (1U<<15)) != 0;
+        if (dest != local_node_id &&
+            ((request && dest == fw_update.node_id) || (!request && source == fw_update.node_id))) {
+            rx_dest_node_id = dest;
+            frame.id = (frame.id & ~(0x7FU<<8)) | (uint32_t(local_node_id)<<8);
+        }
+    }
+#endif
+    canardHandleRxFrame(&canard, &frame, timestamp);
+}
+
 #if HAL_USE_CAN
 static void processTx(void)
 {
@@ -453,7 +585,7 @@ static void processRx(void)
         } else {
             rx_frame.id = rxmsg.SID;
         }
-        canardHandleRxFrame(&canard, &rx_frame, timestamp);
+        handle_rx_frame(rx_frame, timestamp);
     }
 }
 #else
@@ -511,7 +643,7 @@ static void processRx(void)
             memcpy(rx_frame.data, rxmsg.data, 8);
             rx_frame.data_len = rxmsg.dlc;
             rx_frame.id = rxmsg.id;
-            canardHandleRxFrame(&canard, &rx_frame, timestamp);
+            handle_rx_frame(rx_frame, timestamp);
             got_pkt = true;
         }
         if (!got_pkt) {
@@ -151,6 +151,12 @@ void AP_Periph_FW::init()
     baro.init();
 #endif
 
+#ifdef HAL_PERIPH_ENABLE_IMU
+    if (g.imu_sample_rate > 0) {
+        imu.init(g.imu_sample_rate);
+    }
+#endif
+
 #ifdef HAL_PERIPH_ENABLE_BATTERY
     battery.lib.init();
 #endif
@@ -11,6 +11,7 @@
 #include <AP_BattMonitor/AP_BattMonitor.h>
 #include <AP_Airspeed/AP_Airspeed.h>
 #include <AP_RangeFinder/AP_RangeFinder.h>
+#include <AP_InertialSensor/AP_InertialSensor.h>
 #include <AP_Proximity/AP_Proximity.h>
 #include <AP_EFI/AP_EFI.h>
 #include <AP_MSP/AP_MSP.h>
@@ -92,6 +93,7 @@ public:
     void can_rangefinder_update();
     void can_battery_update();
     void can_proximity_update();
+    void can_imu_update();
 
     void load_parameters();
     void prepare_reboot();
@@ -194,6 +196,11 @@ public:
     AP_Proximity proximity;
 #endif
 
+#ifdef HAL_PERIPH_ENABLE_IMU
+    AP_InertialSensor imu;
+    uint32_t last_imu_update_us;
+#endif
+
 #ifdef HAL_PERIPH_ENABLE_PWM_HARDPOINT
     void pwm_irq_handler(uint8_t pin, bool pin_state, uint32_t timestamp);
     void pwm_hardpoint_init();
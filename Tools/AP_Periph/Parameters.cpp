@@ -167,6 +167,15 @@ const AP_Param::Info AP_Periph_FW::var_info[] = {
 #endif
 #endif
 
+    // @Param: PUB_BATCH_MS
+    // @DisplayName: Sensor publish batch period
+    // @Description: When non-zero the magnetometer, barometer, airspeed, rangefinder, proximity and battery messages are published together once every this many milliseconds, so their frames go onto the bus as one burst. Each sensor's own rate limit still applies. Zero publishes each sensor as soon as it has new data.
+    // @Units: ms
+    // @Range: 0 200
+    // @Increment: 1
+    // @User: Advanced
+    GSCALAR(pub_batch_ms, "PUB_BATCH_MS", 0),
+
 #if !defined(HAL_NO_FLASH_SUPPORT) && !defined(HAL_NO_ROMFS_SUPPORT)
     // @Param: FLASH_BOOTLOADER
     // @DisplayName: Trigger bootloader update
@@ -517,6 +526,23 @@ const AP_Param::Info AP_Periph_FW::var_info[] = {
     GOBJECT(proximity, "PRX", AP_Proximity),
 #endif
 
+#ifdef HAL_PERIPH_ENABLE_IMU
+    // @Param: IMU_SAMPLE_RATE
+    // @DisplayName: IMU publish rate
+    // @Description: Rate at which RawIMU messages are sent with the latest and integrated gyro and accelerometer data. Zero disables the IMU
+    // @Units: Hz
+    // @Range: 0 1000
+    // @Increment: 1
+    // @User: Advanced
+    // @RebootRequired: True
+    GSCALAR(imu_sample_rate, "IMU_SAMPLE_RATE", 0),
+
+    // IMU driver
+    // @Group: INS
+    // @Path: ../libraries/AP_InertialSensor/AP_InertialSensor.cpp
+    GOBJECT(imu, "INS", AP_InertialSensor),
+#endif
+
     AP_VAREND
 };
 
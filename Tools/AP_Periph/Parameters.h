@@ -69,10 +69,14 @@ public:
         k_param_proximity_baud,
         k_param_proximity_port,
         k_param_proximity_max_rate,
+        k_param_pub_batch_ms,
+        k_param_imu,
+        k_param_imu_sample_rate,
     };
 
     AP_Int16 format_version;
     AP_Int16 can_node;
+    AP_Int16 pub_batch_ms;
     
     AP_Int32 can_baudrate[HAL_NUM_CAN_IFACES];
 #if HAL_NUM_CAN_IFACES >= 2
@@ -108,6 +112,10 @@ public:
     AP_Int16 proximity_max_rate;
 #endif
 
+#ifdef HAL_PERIPH_ENABLE_IMU
+    AP_Int16 imu_sample_rate;
+#endif
+
 
 #ifdef HAL_PERIPH_ENABLE_ADSB
     AP_Int32 adsb_baudrate;
@@ -1728,13 +1728,33 @@ void AP_Periph_FW::can_update()
     if (!hal.run_in_maintenance_mode())
 #endif
     {
-        can_mag_update();
         can_gps_update();
-        can_battery_update();
-        can_baro_update();
-        can_airspeed_update();
-        can_rangefinder_update();
-        can_proximity_update();
+    #ifdef HAL_PERIPH_ENABLE_IMU
+        can_imu_update();
+    #endif
+
+        // with PUB_BATCH_MS set the lower rate sensors are all
+        // published on a common tick and their frames sent straight
+        // away as one burst
+        bool publish_sensors = true;
+        if (g.pub_batch_ms > 0) {
+            static uint32_t last_batch_ms;
+            publish_sensors = now - last_batch_ms >= uint32_t(g.pub_batch_ms);
+            if (publish_sensors) {
+                last_batch_ms = now;
+            }
+        }
+        if (publish_sensors) {
+            can_mag_update();
+            can_battery_update();
+            can_baro_update();
+            can_airspeed_update();
+            can_rangefinder_update();
+            can_proximity_update();
+            if (g.pub_batch_ms > 0) {
+                processTx();
+            }
+        }
     #if defined(HAL_PERIPH_ENABLE_BUZZER_WITHOUT_NOTIFY) || defined (HAL_PERIPH_ENABLE_NOTIFY)
         can_buzzer_update();
     #endif
@@ -1768,6 +1788,58 @@ void AP_Periph_FW::can_update()
     }
 }
 
+/*
+  update CAN IMU, sending the latest and integrated gyro and
+  accelerometer data at IMU_SAMPLE_RATE
+ */
+void AP_Periph_FW::can_imu_update(void)
+{
+#ifdef HAL_PERIPH_ENABLE_IMU
+    if (g.imu_sample_rate <= 0) {
+        return;
+    }
+    // the IMU is updated no faster than the rate it was initialised
+    // at, so update() finds its sample due and does not wait
+    const uint32_t now_us = AP_HAL::micros();
+    if (now_us - last_imu_update_us < 1000000UL / uint32_t(g.imu_sample_rate.get())) {
+        return;
+    }
+    last_imu_update_us = now_us;
+
+    imu.update();
+    if (!imu.healthy()) {
+        return;
+    }
+
+    uavcan_equipment_ahrs_RawIMU pkt {};
+    pkt.timestamp.usec = AP_HAL::micros64();
+
+    Vector3f delta_angle, delta_velocity;
+    float delta_angle_dt, delta_velocity_dt;
+    imu.get_delta_angle(delta_angle, delta_angle_dt);
+    imu.get_delta_velocity(delta_velocity, delta_velocity_dt);
+    pkt.integration_interval = delta_angle_dt;
+
+    const Vector3f &gyro = imu.get_gyro();
+    const Vector3f &accel = imu.get_accel();
+    for (uint8_t i=0; i<3; i++) {
+        pkt.rate_gyro_latest[i] = gyro[i];
+        pkt.rate_gyro_integral[i] = delta_angle[i];
+        pkt.accelerometer_latest[i] = accel[i];
+        pkt.accelerometer_integral[i] = delta_velocity[i];
+    }
+
+    uint8_t buffer[UAVCAN_EQUIPMENT_AHRS_RAWIMU_MAX_SIZE] {};
+    uint16_t total_size = uavcan_equipment_ahrs_RawIMU_encode(&pkt, buffer, !periph.canfdout());
+
+    canard_broadcast(UAVCAN_EQUIPMENT_AHRS_RAWIMU_SIGNATURE,
+                    UAVCAN_EQUIPMENT_AHRS_RAWIMU_ID,
+                    CANARD_TRANSFER_PRIORITY_HIGH,
+                    &buffer[0],
+                    total_size);
+#endif // HAL_PERIPH_ENABLE_IMU
+}
+
 /*
   update CAN magnetometer
  */
@@ -2377,7 +2449,7 @@ void AP_Periph_FW::can_proximity_update()
 
     ardupilot_equipment_proximity_sensor_Proximity pkt {};
 
-    const uint8_t obstacle_count = proximity.get_obstacle_count();
+    const uint16_t obstacle_count = proximity.get_obstacle_count();
 
     // if no objects return
     if (obstacle_count == 0) {
@@ -2385,7 +2457,7 @@ void AP_Periph_FW::can_proximity_update()
     }
 
     // calculate maximum roll, pitch values from objects
-    for (uint8_t i=0; i<obstacle_count; i++) {
+    for (uint16_t i=0; i<obstacle_count; i++) {
         if (!proximity.get_obstacle_info(i, pkt.yaw, pkt.pitch, pkt.distance)) {
             // not a valid obstacle
             continue;
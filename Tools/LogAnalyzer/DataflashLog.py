@@ -10,6 +10,7 @@ from __future__ import print_function, division
 
 import bisect
 import ctypes
+import struct
 import sys
 
 import numpy
@@ -122,6 +123,7 @@ class BinaryFormat(ctypes.LittleEndianStructure):
         'i': ctypes.c_int32,
         'I': ctypes.c_uint32,
         'f': ctypes.c_float,
+        'g': ctypes.c_uint16,  # float16
         'd': ctypes.c_double,
         'n': ctypes.c_char * 4,
         'N': ctypes.c_char * 16,
@@ -194,6 +196,8 @@ class BinaryFormat(ctypes.LittleEndianStructure):
                     ret = getattr(x, attributename)
                     if str(format) in ['Z', 'n', 'N']:
                         ret = ret.decode(encoding="utf-8")
+                    elif str(format) == 'g':
+                        ret = struct.unpack('<e', struct.pack('<H', ret))[0]
                     return ret
 
                 p = property(get_message_attribute)
@@ -9,6 +9,11 @@
 #include <time.h>
 #include <cinttypes>
 
+#if AP_LOGREADER_MMAP_ENABLED
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
 #ifndef PRIu64
 #define PRIu64 "llu"
 #endif
@@ -19,24 +24,299 @@ AP_LoggerFileReader::AP_LoggerFileReader()
 AP_LoggerFileReader::~AP_LoggerFileReader()
 {
     ::printf("Replay counts: %" PRIu64 " bytes  %u entries\n", bytes_read, message_count);
+#if HAL_LOGGER_COMPRESSION_ENABLED
+    delete[] block_data;
+    delete[] block_raw;
+#endif
+#if AP_LOGREADER_MMAP_ENABLED
+    unmap_log();
+#endif
 }
 
 bool AP_LoggerFileReader::open_log(const char *logfile)
 {
+#if AP_LOGREADER_MMAP_ENABLED
+    unmap_log();
+    if (map_log(logfile)) {
+        return true;
+    }
+#endif
     fd = AP::FS().open(logfile, O_RDONLY);
     if (fd == -1) {
         return false;
     }
+#if HAL_LOGGER_COMPRESSION_ENABLED
+    // a compressed log starts with a block header
+    uint8_t hdr[3];
+    compressed = (AP::FS().read(fd, hdr, sizeof(hdr)) == sizeof(hdr) &&
+                  hdr[0] == HEAD_BYTE1 && hdr[1] == HEAD_BYTE2 &&
+                  hdr[2] == LOG_COMPRESSED_BLOCK_MSG);
+    AP::FS().lseek(fd, 0, SEEK_SET);
+    if (compressed && block_data == nullptr) {
+        block_data = new uint8_t[UINT16_MAX];
+        block_raw = new uint8_t[UINT16_MAX];
+    }
+    block_len = 0;
+    block_ofs = 0;
+#endif
+    return true;
+}
+
+#if AP_LOGREADER_MMAP_ENABLED
+/*
+  map an uncompressed log. The mapping is private and writable so
+  messages can be handed to the handlers without a copy
+ */
+bool AP_LoggerFileReader::map_log(const char *logfile)
+{
+    const int mfd = ::open(logfile, O_RDONLY | O_CLOEXEC);
+    if (mfd == -1) {
+        return false;
+    }
+    struct stat st;
+    if (::fstat(mfd, &st) != 0 || st.st_size < 3) {
+        ::close(mfd);
+        return false;
+    }
+    void *m = ::mmap(nullptr, st.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, mfd, 0);
+    ::close(mfd);
+    if (m == MAP_FAILED) {
+        return false;
+    }
+#if HAL_LOGGER_COMPRESSION_ENABLED
+    // compressed logs are read through the block decompression
+    const uint8_t *hdr = (const uint8_t *)m;
+    if (hdr[0] == HEAD_BYTE1 && hdr[1] == HEAD_BYTE2 && hdr[2] == LOG_COMPRESSED_BLOCK_MSG) {
+        ::munmap(m, st.st_size);
+        return false;
+    }
+#endif
+    ::madvise(m, st.st_size, MADV_SEQUENTIAL);
+    map = (uint8_t *)m;
+    map_len = st.st_size;
+    map_ofs = 0;
+    return true;
+}
+
+void AP_LoggerFileReader::unmap_log()
+{
+    free_index();
+    if (map != nullptr) {
+        ::munmap(map, map_len);
+        map = nullptr;
+    }
+}
+
+void AP_LoggerFileReader::free_index()
+{
+    for (uint16_t i=0; i<ARRAY_SIZE(type_index); i++) {
+        if (type_index[i] != nullptr) {
+            delete[] type_index[i]->offsets;
+            delete type_index[i];
+            type_index[i] = nullptr;
+        }
+    }
+}
+
+bool AP_LoggerFileReader::build_index(const char *names[])
+{
+    if (map == nullptr) {
+        return false;
+    }
+    free_index();
+
+    // message lengths as the formats are found, kept separate from
+    // formats[] so building the index doesn't affect update()
+    uint8_t lengths[256] {};
+
+    uint64_t ofs = 0;
+    while (ofs + 3 <= map_len) {
+        const uint8_t *msg = &map[ofs];
+        if (msg[0] != HEAD_BYTE1 || msg[1] != HEAD_BYTE2) {
+            printf("bad log header at offset %" PRIu64 "\n", ofs);
+            break;
+        }
+        const uint8_t type = msg[2];
+        uint8_t len = lengths[type];
+        if (type == LOG_FORMAT_MSG) {
+            if (ofs + sizeof(struct log_Format) > map_len) {
+                break;
+            }
+            const struct log_Format &f = *(const struct log_Format *)msg;
+            lengths[f.type] = f.length;
+            len = sizeof(struct log_Format);
+            for (uint8_t i=0; names[i] != nullptr; i++) {
+                if (f.type < ARRAY_SIZE(type_index) && type_index[f.type] == nullptr &&
+                    strncmp(f.name, names[i], sizeof(f.name)) == 0) {
+                    type_index[f.type] = new msg_index {};
+                    if (type_index[f.type] == nullptr) {
+                        return false;
+                    }
+                    memcpy(type_index[f.type]->name, f.name, sizeof(f.name));
+                }
+            }
+        }
+        if (len == 0) {
+            // without a format we can't find the next message
+            break;
+        }
+        if (ofs + len > map_len) {
+            break;
+        }
+        struct msg_index *idx = type < ARRAY_SIZE(type_index) ? type_index[type] : nullptr;
+        if (idx != nullptr) {
+            if (idx->count == idx->space) {
+                const uint32_t new_space = MAX(idx->space * 2, 16U);
+                uint64_t *offsets = new uint64_t[new_space];
+                if (offsets == nullptr) {
+                    return false;
+                }
+                if (idx->offsets != nullptr) {
+                    memcpy(offsets, idx->offsets, idx->count * sizeof(offsets[0]));
+                    delete[] idx->offsets;
+                }
+                idx->offsets = offsets;
+                idx->space = new_space;
+            }
+            idx->offsets[idx->count++] = ofs;
+        }
+        ofs += len;
+    }
     return true;
 }
 
+int16_t AP_LoggerFileReader::find_type(const char *name) const
+{
+    for (uint16_t i=0; i<ARRAY_SIZE(type_index); i++) {
+        if (type_index[i] != nullptr && strncmp(type_index[i]->name, name, sizeof(type_index[i]->name)) == 0) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+uint32_t AP_LoggerFileReader::index_count(uint8_t type) const
+{
+    if (type >= ARRAY_SIZE(type_index) || type_index[type] == nullptr) {
+        return 0;
+    }
+    return type_index[type]->count;
+}
+
+const uint8_t *AP_LoggerFileReader::index_msg(uint8_t type, uint32_t n) const
+{
+    if (n >= index_count(type)) {
+        return nullptr;
+    }
+    return &map[type_index[type]->offsets[n]];
+}
+
+/*
+  hand out the next message of a mapped log in place
+ */
+bool AP_LoggerFileReader::update_mapped()
+{
+    if (map_ofs + 3 > map_len) {
+        return false;
+    }
+    uint8_t *msg = &map[map_ofs];
+    if (msg[0] != HEAD_BYTE1 || msg[1] != HEAD_BYTE2) {
+        printf("bad log header\n");
+        return false;
+    }
+    packet_counts[msg[2]]++;
+
+    if (msg[2] == LOG_FORMAT_MSG) {
+        struct log_Format f;
+        if (map_ofs + sizeof(f) > map_len) {
+            return false;
+        }
+        memcpy(&f, msg, sizeof(f));
+        memcpy(&formats[f.type], &f, sizeof(formats[f.type]));
+        map_ofs += sizeof(f);
+        bytes_read += sizeof(f);
+
+        message_count++;
+        return handle_log_format_msg(f);
+    }
+
+    const struct log_Format &f = formats[msg[2]];
+    if (f.length == 0) {
+        // can't just throw these away as the format specifies the
+        // number of bytes in the message
+        ::printf("No format defined for type (%d)\n", msg[2]);
+        exit(1);
+    }
+    if (map_ofs + f.length > map_len) {
+        return false;
+    }
+    map_ofs += f.length;
+    bytes_read += f.length;
+
+    message_count++;
+    return handle_msg(f, msg);
+}
+#endif // AP_LOGREADER_MMAP_ENABLED
+
 ssize_t AP_LoggerFileReader::read_input(void *buffer, const size_t count)
 {
+#if HAL_LOGGER_COMPRESSION_ENABLED
+    if (compressed) {
+        return read_decompressed((uint8_t *)buffer, count);
+    }
+#endif
     uint64_t ret = AP::FS().read(fd, buffer, count);
     bytes_read += ret;
     return ret;
 }
 
+#if HAL_LOGGER_COMPRESSION_ENABLED
+/*
+  read and decompress the next block of a compressed log
+ */
+bool AP_LoggerFileReader::read_block()
+{
+    struct log_CompressedBlockHeader hdr;
+    if (AP::FS().read(fd, &hdr, sizeof(hdr)) != sizeof(hdr)) {
+        return false;
+    }
+    bytes_read += sizeof(hdr);
+    if (hdr.head1 != HEAD_BYTE1 || hdr.head2 != HEAD_BYTE2 ||
+        hdr.msgid != LOG_COMPRESSED_BLOCK_MSG || hdr.data_len > hdr.raw_len) {
+        printf("bad compressed block header\n");
+        return false;
+    }
+    uint8_t *data = hdr.data_len == hdr.raw_len ? block_data : block_raw;
+    if (AP::FS().read(fd, data, hdr.data_len) != hdr.data_len) {
+        return false;
+    }
+    bytes_read += hdr.data_len;
+    if (data == block_raw &&
+        AP_Logger_Compress::decompress(block_raw, hdr.data_len, block_data, hdr.raw_len) != hdr.raw_len) {
+        printf("corrupt compressed block\n");
+        return false;
+    }
+    block_len = hdr.raw_len;
+    block_ofs = 0;
+    return true;
+}
+
+ssize_t AP_LoggerFileReader::read_decompressed(uint8_t *buf, size_t count)
+{
+    size_t ret = 0;
+    while (ret < count) {
+        if (block_ofs == block_len && !read_block()) {
+            break;
+        }
+        const uint32_t n = MIN(count - ret, block_len - block_ofs);
+        memcpy(&buf[ret], &block_data[block_ofs], n);
+        block_ofs += n;
+        ret += n;
+    }
+    return ret;
+}
+#endif // HAL_LOGGER_COMPRESSION_ENABLED
+
 void AP_LoggerFileReader::format_type(uint16_t type, char dest[5])
 {
     const struct log_Format &f = formats[type];
@@ -53,6 +333,11 @@ void AP_LoggerFileReader::get_packet_counts(uint64_t dest[])
 
 bool AP_LoggerFileReader::update()
 {
+#if AP_LOGREADER_MMAP_ENABLED
+    if (map != nullptr) {
+        return update_mapped();
+    }
+#endif
     uint8_t hdr[3];
     if (read_input(hdr, 3) != 3) {
         return false;
@@ -1,9 +1,14 @@
 #pragma once
 
 #include <AP_Logger/AP_Logger.h>
+#include <AP_Logger/LogCompress.h>
 
 #define LOGREADER_MAX_FORMATS 255 // must be >= highest MESSAGE
 
+#ifndef AP_LOGREADER_MMAP_ENABLED
+#define AP_LOGREADER_MMAP_ENABLED (CONFIG_HAL_BOARD == HAL_BOARD_SITL || CONFIG_HAL_BOARD == HAL_BOARD_LINUX)
+#endif
+
 class AP_LoggerFileReader
 {
 public:
@@ -20,6 +25,23 @@ public:
     void format_type(uint16_t type, char dest[5]);
     void get_packet_counts(uint64_t dest[]);
 
+#if AP_LOGREADER_MMAP_ENABLED
+    /*
+      build an index of the offsets of the message types in the null
+      terminated list of names, e.g. "FMT" and "PARM", in one pass over
+      the log. Only available for logs that could be mapped
+     */
+    bool build_index(const char *names[]);
+
+    // the type of a named message, or -1 if the log has no format for it
+    int16_t find_type(const char *name) const;
+
+    // number of indexed messages of a type and the n'th of them, the
+    // message pointing into the mapped log
+    uint32_t index_count(uint8_t type) const;
+    const uint8_t *index_msg(uint8_t type, uint32_t n) const;
+#endif
+
 protected:
     int fd = -1;
 
@@ -28,6 +50,36 @@ protected:
 private:
     ssize_t read_input(void *buf, size_t count);
 
+#if AP_LOGREADER_MMAP_ENABLED
+    // an uncompressed log is mapped and messages are handed out as
+    // pointers into the mapping rather than copies
+    uint8_t *map;
+    uint64_t map_len;
+    uint64_t map_ofs;
+    bool map_log(const char *logfile);
+    void unmap_log();
+    bool update_mapped();
+
+    struct msg_index {
+        char name[4];
+        uint64_t *offsets;
+        uint32_t count;
+        uint32_t space;
+    } *type_index[LOGREADER_MAX_FORMATS];
+    void free_index();
+#endif
+
+#if HAL_LOGGER_COMPRESSION_ENABLED
+    // state for reading a log written as compressed blocks
+    bool compressed;
+    uint8_t *block_data;
+    uint8_t *block_raw;
+    uint32_t block_len;
+    uint32_t block_ofs;
+    bool read_block();
+    ssize_t read_decompressed(uint8_t *buf, size_t count);
+#endif
+
     uint64_t bytes_read = 0;
     uint32_t message_count = 0;
     uint64_t start_micros;
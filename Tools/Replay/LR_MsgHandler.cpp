@@ -20,6 +20,12 @@ void LR_MsgHandler_RFRH::process_message(uint8_t *msgbytes)
     AP::dal().handle_message(msg);
 }
 
+void LR_MsgHandler_RFRD::process_message(uint8_t *msgbytes)
+{
+    MSG_CREATE(RFRD, msgbytes);
+    AP::dal().handle_message(msg);
+}
+
 void LR_MsgHandler_RFRF::process_message(uint8_t *msgbytes)
 {
     MSG_CREATE(RFRF, msgbytes);
@@ -182,6 +188,12 @@ void LR_MsgHandler_RISI::process_message(uint8_t *msgbytes)
     AP::dal().handle_message(msg);
 }
 
+void LR_MsgHandler_RISD::process_message(uint8_t *msgbytes)
+{
+    MSG_CREATE(RISD, msgbytes);
+    AP::dal().handle_message(msg);
+}
+
 void LR_MsgHandler_RASH::process_message(uint8_t *msgbytes)
 {
     MSG_CREATE(RASH, msgbytes);
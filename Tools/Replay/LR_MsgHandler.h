@@ -25,6 +25,13 @@ public:
     void process_message(uint8_t *msg) override;
 };
 
+class LR_MsgHandler_RFRD : public LR_MsgHandler
+{
+public:
+    using LR_MsgHandler::LR_MsgHandler;
+    void process_message(uint8_t *msg) override;
+};
+
 class LR_MsgHandler_EKF : public LR_MsgHandler
 {
 public:
@@ -144,6 +151,14 @@ public:
     using LR_MsgHandler::LR_MsgHandler;
     void process_message(uint8_t *msg) override;
 };
+
+class LR_MsgHandler_RISD : public LR_MsgHandler
+{
+public:
+    using LR_MsgHandler::LR_MsgHandler;
+    void process_message(uint8_t *msg) override;
+};
+
 class LR_MsgHandler_RASH : public LR_MsgHandler
 {
 public:
@@ -64,6 +64,8 @@ bool LogReader::handle_log_format_msg(const struct log_Format &f)
         msgparser[f.type] = new LR_MsgHandler_PARM(formats[f.type]);
     } else if (streq(name, "RFRH")) {
         msgparser[f.type] = new LR_MsgHandler_RFRH(formats[f.type]);
+    } else if (streq(name, "RFRD")) {
+        msgparser[f.type] = new LR_MsgHandler_RFRD(formats[f.type]);
     } else if (streq(name, "RFRF")) {
         msgparser[f.type] = new LR_MsgHandler_RFRF(formats[f.type], ekf2, ekf3);
     } else if (streq(name, "RFRN")) {
@@ -86,6 +88,8 @@ bool LogReader::handle_log_format_msg(const struct log_Format &f)
 	    msgparser[f.type] = new LR_MsgHandler_RISH(formats[f.type]);
 	} else if (streq(name, "RISI")) {
 	    msgparser[f.type] = new LR_MsgHandler_RISI(formats[f.type]);
+	} else if (streq(name, "RISD")) {
+	    msgparser[f.type] = new LR_MsgHandler_RISD(formats[f.type]);
     } else if (streq(name, "RASH")) {
 	    msgparser[f.type] = new LR_MsgHandler_RASH(formats[f.type]);
 	} else if (streq(name, "RASI")) {
@@ -135,6 +135,9 @@ inline void MsgHandler::field_value_for_type_at_offset(uint8_t *msg,
     case 'f':
         ret = (R)(((float*)&msg[offset])[0]);
         break;
+    case 'g':
+        ret = (R)(((Float16_t*)&msg[offset])[0].get());
+        break;
     case 'I':
     case 'E':
         ret = (R)(((uint32_t*)&msg[offset])[0]);
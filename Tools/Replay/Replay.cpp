@@ -33,7 +33,7 @@
 
 #define streq(x, y) (!strcmp(x, y))
 
-static ReplayVehicle replayvehicle;
+ReplayVehicle replayvehicle;
 
 // list of user parameters
 user_parameter *user_parameters;
@@ -322,9 +322,13 @@ void Replay::load_param_file(const char *pfilename)
     fclose(f);
 }
 
-Replay replay(replayvehicle);
 AP_Vehicle& vehicle = replayvehicle;
 
 const AP_HAL::HAL& hal = AP_HAL::get_HAL();
 
+// the EKF3 benchmark provides its own main loop callbacks
+#ifndef REPLAY_BENCHMARK
+Replay replay(replayvehicle);
+
 AP_HAL_MAIN_CALLBACKS(&replay);
+#endif
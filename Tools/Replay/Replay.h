@@ -71,6 +71,8 @@ private:
     static const AP_Param::Info var_info[];
 };
 
+extern ReplayVehicle replayvehicle;
+
 class Replay : public AP_HAL::HAL::Callbacks {
 
 public:
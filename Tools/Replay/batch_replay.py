@@ -0,0 +1,170 @@
+#!/usr/bin/env python
+
+'''
+run Replay over a set of logs and parameter sets in parallel and write
+a summary of the EKF3 innovations and health flags of each run
+
+each run is a separate Replay process started in its own directory, as
+Replay keeps its parameters, storage and output log in the working
+directory. The summary is written as CSV, one line per log and
+parameter set, e.g.
+
+  ./Tools/Replay/batch_replay.py --param-set tune1.parm --param-set tune2.parm logs/*.BIN
+'''
+
+from __future__ import print_function
+
+import csv
+import glob
+import os
+import subprocess
+import sys
+
+# fields summarised from the replayed EKF3 messages
+INNOV_FIELDS = ['IVN', 'IVE', 'IVD', 'IPN', 'IPE', 'IPD']
+TEST_RATIO_FIELDS = ['SV', 'SP', 'SH', 'SM']
+
+
+def run_name(logfile, param_set):
+    '''name of the directory for one run'''
+    name = os.path.splitext(os.path.basename(logfile))[0]
+    if param_set is not None:
+        name += '-' + os.path.splitext(os.path.basename(param_set))[0]
+    return name
+
+
+def summarise_log(logfile):
+    '''summarise the EKF3 output of a replay log'''
+    from pymavlink import mavutil
+    mlog = mavutil.mavlink_connection(logfile)
+
+    summary = {}
+    counts = {}
+    sum_sq = {}
+    for f in INNOV_FIELDS:
+        summary[f + '_max'] = 0
+        sum_sq[f] = 0
+    for f in TEST_RATIO_FIELDS:
+        summary[f + '_max'] = 0
+    summary['FS'] = 0
+    summary['TS'] = 0
+    summary['SS'] = 0
+    counts['XKF3'] = 0
+    counts['XKF4'] = 0
+
+    while True:
+        m = mlog.recv_match(type=['XKF3', 'XKF4'])
+        if m is None:
+            break
+        # only the cores written by Replay, not those copied from the original log
+        if m.C < 100:
+            continue
+        mtype = m.get_type()
+        counts[mtype] += 1
+        if mtype == 'XKF3':
+            for f in INNOV_FIELDS:
+                v = getattr(m, f)
+                summary[f + '_max'] = max(summary[f + '_max'], abs(v))
+                sum_sq[f] += v*v
+        else:
+            for f in TEST_RATIO_FIELDS:
+                summary[f + '_max'] = max(summary[f + '_max'], getattr(m, f))
+            summary['FS'] |= m.FS
+            summary['TS'] |= m.TS
+            # the last solution status of the run
+            summary['SS'] = m.SS
+
+    for f in INNOV_FIELDS:
+        if counts['XKF3'] > 0:
+            summary[f + '_rms'] = (sum_sq[f] / counts['XKF3']) ** 0.5
+        else:
+            summary[f + '_rms'] = 0
+    summary['samples'] = counts['XKF3']
+    return summary
+
+
+def run_replay(args):
+    '''run Replay on one log with one parameter set, returning its summary'''
+    (replay, logfile, param_set, parms, outdir) = args
+    name = run_name(logfile, param_set)
+    rundir = os.path.join(outdir, name)
+    if not os.path.exists(rundir):
+        os.makedirs(rundir)
+
+    cmd = [replay]
+    for p in parms:
+        cmd.extend(['--parm', p])
+    if param_set is not None:
+        cmd.extend(['--param-file', param_set])
+    cmd.append(logfile)
+
+    result = {'name': name, 'log': logfile, 'params': param_set or ''}
+    with open(os.path.join(rundir, 'replay.txt'), 'w') as output:
+        ret = subprocess.call(cmd, cwd=rundir, stdout=output, stderr=subprocess.STDOUT)
+    if ret != 0:
+        result['status'] = 'replay failed (%d)' % ret
+        return result
+
+    logs = glob.glob(os.path.join(rundir, 'logs', '*.BIN'))
+    if len(logs) == 0:
+        result['status'] = 'no output log'
+        return result
+    result.update(summarise_log(max(logs, key=os.path.getmtime)))
+    result['status'] = 'ok'
+    return result
+
+
+def summary_fields():
+    fields = ['name', 'log', 'params', 'status', 'samples']
+    for f in INNOV_FIELDS:
+        fields.extend([f + '_rms', f + '_max'])
+    for f in TEST_RATIO_FIELDS:
+        fields.append(f + '_max')
+    fields.extend(['FS', 'TS', 'SS'])
+    return fields
+
+
+if __name__ == '__main__':
+    import multiprocessing
+    from argparse import ArgumentParser
+    parser = ArgumentParser(description=__doc__)
+    parser.add_argument("--replay", default="build/sitl/tool/Replay", help="Replay binary")
+    parser.add_argument("--jobs", "-j", type=int, default=multiprocessing.cpu_count(), help="number of parallel runs")
+    parser.add_argument("--param-set", action='append', default=[], help="parameter file to replay each log with, may be repeated")
+    parser.add_argument("--no-baseline", action='store_true', help="don't replay with the parameters in the log when parameter sets are given")
+    parser.add_argument("--parm", action='append', default=[], help="NAME=VALUE parameter set on all runs")
+    parser.add_argument("--outdir", default="replay_batch", help="directory for the run output")
+    parser.add_argument("--summary", default=None, help="summary file, default summary.csv in the output directory")
+    parser.add_argument("logs", metavar="LOG", nargs="+")
+    args = parser.parse_args()
+
+    replay = os.path.abspath(args.replay)
+    outdir = os.path.abspath(args.outdir)
+    param_sets = [os.path.abspath(p) for p in args.param_set]
+    if len(param_sets) == 0 or not args.no_baseline:
+        param_sets.insert(0, None)
+
+    runs = []
+    for logfile in args.logs:
+        for param_set in param_sets:
+            runs.append((replay, os.path.abspath(logfile), param_set, args.parm, outdir))
+
+    print("Running %u replays with %u jobs" % (len(runs), args.jobs))
+    pool = multiprocessing.Pool(args.jobs)
+    results = []
+    for result in pool.imap_unordered(run_replay, runs):
+        print("%s: %s" % (result['name'], result['status']))
+        results.append(result)
+    pool.close()
+    pool.join()
+
+    summary = args.summary or os.path.join(outdir, 'summary.csv')
+    with open(summary, 'w') as f:
+        writer = csv.DictWriter(f, fieldnames=summary_fields(), restval='', extrasaction='ignore')
+        writer.writeheader()
+        for result in sorted(results, key=lambda r: r['name']):
+            writer.writerow(result)
+    print("Summary written to %s" % summary)
+
+    if any(r['status'] != 'ok' for r in results):
+        sys.exit(1)
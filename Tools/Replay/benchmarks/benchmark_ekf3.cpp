@@ -0,0 +1,145 @@
+/*
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+  benchmark of the EKF3 filter steps using the DAL frames recorded in
+  a LOG_REPLAY log.
+
+  Usage: benchmark_ekf3 [benchmark options] LOGFILE
+
+  The log is read once, running the EKF exactly as Replay does and
+  keeping the replay messages in memory. Each benchmark iteration then
+  feeds the recorded frame sequence through the EKF again and reports
+  the time spent in one filter kernel, so the numbers exclude log
+  parsing and the cost of the surrounding kernels.
+ */
+
+#include <AP_gbenchmark.h>
+
+#include "../Replay.h"
+
+#include <AP_NavEKF3/AP_NavEKF3_core.h>
+
+#include <vector>
+
+#if !EK3_FEATURE_KERNEL_TIMING
+#error "EKF3 benchmark requires EK3_FEATURE_KERNEL_TIMING"
+#endif
+
+/*
+  a LogReader which keeps a copy of the replay messages it processes
+  so they can be fed through the EKF again
+ */
+class RecordingLogReader : public LogReader
+{
+public:
+    using LogReader::LogReader;
+
+    bool handle_msg(const struct log_Format &f, uint8_t *msg) override {
+        // all DAL replay messages start with R
+        if (f.name[0] == 'R') {
+            frames.push_back(f.type);
+            frames.insert(frames.end(), msg, msg + f.length);
+        }
+        return LogReader::handle_msg(f, msg);
+    }
+
+    // feed the recorded messages through the EKF again
+    void replay_recorded(void) {
+        size_t ofs = 0;
+        while (ofs < frames.size()) {
+            const struct log_Format &f = formats[frames[ofs]];
+            LogReader::handle_msg(f, &frames[ofs+1]);
+            ofs += 1 + f.length;
+        }
+    }
+
+    bool have_frames(void) const { return !frames.empty(); }
+
+private:
+    // message type followed by message body, for each recorded message
+    std::vector<uint8_t> frames;
+};
+
+static RecordingLogReader reader{replayvehicle.log_structure, replayvehicle.ekf2, replayvehicle.ekf3};
+
+static void BM_EKF3Kernel(benchmark::State &state, NavEKF3_core::Kernel kernel)
+{
+    uint64_t kernel_ns = 0;
+    uint32_t kernel_calls = 0;
+    for (auto _ : state) {
+        replayvehicle.ekf3.reset_kernel_timing();
+        reader.replay_recorded();
+        uint64_t total_ns;
+        uint32_t count;
+        replayvehicle.ekf3.get_kernel_timing(uint8_t(kernel), total_ns, count);
+        state.SetIterationTime(total_ns * 1.0e-9);
+        kernel_ns += total_ns;
+        kernel_calls += count;
+    }
+    state.counters["calls"] = benchmark::Counter(kernel_calls, benchmark::Counter::kAvgIterations);
+    state.counters["ns_per_call"] = kernel_calls > 0 ? double(kernel_ns) / kernel_calls : 0;
+}
+
+BENCHMARK_CAPTURE(BM_EKF3Kernel, UpdateFilter, NavEKF3_core::Kernel::UpdateFilter)->UseManualTime()->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(BM_EKF3Kernel, CovariancePrediction, NavEKF3_core::Kernel::CovariancePrediction)->UseManualTime()->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(BM_EKF3Kernel, FuseVelPosNED, NavEKF3_core::Kernel::FuseVelPosNED)->UseManualTime()->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(BM_EKF3Kernel, SelectMagFusion, NavEKF3_core::Kernel::SelectMagFusion)->UseManualTime()->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(BM_EKF3Kernel, FuseAirspeed, NavEKF3_core::Kernel::FuseAirspeed)->UseManualTime()->Unit(benchmark::kMillisecond);
+
+class EKF3Benchmark : public AP_HAL::HAL::Callbacks {
+public:
+    void setup() override;
+    void loop() override {}
+};
+
+void EKF3Benchmark::setup()
+{
+    uint8_t hal_argc;
+    char * const *hal_argv;
+    hal.util->commandline_arguments(hal_argc, hal_argv);
+
+    // google benchmark removes the options it understands
+    std::vector<char*> args(hal_argv, hal_argv + hal_argc);
+    int argc = hal_argc;
+    benchmark::Initialize(&argc, args.data());
+    if (argc < 2) {
+        ::printf("Usage: benchmark_ekf3 [benchmark options] LOGFILE\n");
+        exit(1);
+    }
+    const char *filename = args[argc-1];
+
+    replayvehicle.setup();
+    reader.set_parameter("EK3_ENABLE", 1, true);
+
+    if (!reader.open_log(filename)) {
+        ::printf("open(%s): %m\n", filename);
+        exit(1);
+    }
+    // first pass initialises the EKF and records the frames
+    while (reader.update()) {
+    }
+    if (!reader.have_frames()) {
+        ::printf("%s: no replay frames found; was LOG_REPLAY set?\n", filename);
+        exit(1);
+    }
+
+    benchmark::RunSpecifiedBenchmarks();
+    exit(0);
+}
+
+static EKF3Benchmark ekf3_benchmark;
+
+AP_HAL_MAIN_CALLBACKS(&ekf3_benchmark);
@@ -450,6 +450,9 @@ class Board:
                 if fnmatch.fnmatch(f, "font*bin"):
                     env.ROMFS_FILES += [(f,'libraries/AP_OSD/fonts/'+f)]
 
+        if cfg.options.romfs_luac:
+            env.ROMFS_LUAC = True
+
         if cfg.options.ekf_double:
             env.CXXFLAGS += ['-DHAL_WITH_EKF_DOUBLE=1']
 
@@ -485,8 +488,13 @@ class Board:
     def embed_ROMFS_files(self, ctx):
         '''embed some files using AP_ROMFS'''
         import embed
+        romfs_files = ctx.env.ROMFS_FILES
+        if ctx.env.ROMFS_LUAC:
+            # precompiled scripts load without parsing on the vehicle
+            import luac
+            romfs_files = luac.compile_scripts(ctx, romfs_files)
         header = ctx.bldnode.make_node('ap_romfs_embedded.h').abspath()
-        if not embed.create_embedded_h(header, ctx.env.ROMFS_FILES, ctx.env.ROMFS_UNCOMPRESSED):
+        if not embed.create_embedded_h(header, romfs_files, ctx.env.ROMFS_UNCOMPRESSED):
             ctx.fatal("Failed to created ap_romfs_embedded.h")
 
 Board = BoardMeta('Board', Board.__bases__, dict(Board.__dict__))
@@ -596,6 +596,8 @@ def generate_hwdef_h(env):
     cmd = "{0} '{1}' -D '{2}' --params '{3}' '{4}'".format(python, hwdef_script, hwdef_out, env.DEFAULT_PARAMETERS, env.HWDEF)
     if env.HWDEF_EXTRA:
         cmd += " '{0}'".format(env.HWDEF_EXTRA)
+    if env.RAMFUNC_PROFILE:
+        cmd += " --ramfunc-profile '{0}'".format(env.RAMFUNC_PROFILE)
     if env.BOOTLOADER_OPTION:
         cmd += " " + env.BOOTLOADER_OPTION
     return subprocess.call(cmd, shell=True)
@@ -627,6 +629,8 @@ def build(bld):
             bld.env.HWDEF)
     if bld.env.HWDEF_EXTRA:
         hwdef_rule += " " + bld.env.HWDEF_EXTRA
+    if bld.env.RAMFUNC_PROFILE:
+        hwdef_rule += " --ramfunc-profile '%s'" % bld.env.RAMFUNC_PROFILE
     if bld.env.BOOTLOADER_OPTION:
         hwdef_rule += " " + bld.env.BOOTLOADER_OPTION
     bld(
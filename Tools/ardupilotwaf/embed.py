@@ -7,11 +7,49 @@ Andrew Tridgell
 May 2017
 '''
 
-import os, sys, tempfile, gzip
+import os, sys, tempfile, gzip, struct, zlib
+
+# files larger than this many blocks are compressed in independent
+# blocks, so they can be read without decompressing the whole file
+BLOCK_SIZE = 4096
+BLOCK_MIN_BLOCKS = 2
 
 def write_encode(out, s):
     out.write(s.encode())
 
+def compress_blocks(contents, block_size=BLOCK_SIZE):
+    '''
+    compress in independent raw deflate blocks with an index. All
+    little endian:
+      uint8_t  magic[4]  'A','P','Z','B'
+      uint32_t size      decompressed size
+      uint32_t block_size
+      uint32_t num_blocks
+      uint32_t offset[num_blocks+1]  of each block's data from the start of the file
+      uint32_t crc[num_blocks]       crc32_small() of each decompressed block
+      then the raw deflate data of each block
+    '''
+    blocks = []
+    crcs = []
+    for ofs in range(0, len(contents), block_size):
+        chunk = bytearray(contents[ofs:ofs+block_size])
+        c = zlib.compressobj(9, zlib.DEFLATED, -15)
+        blocks.append(c.compress(bytes(chunk)) + c.flush())
+        crcs.append(crc32(chunk))
+    num_blocks = len(blocks)
+    ofs = 16 + 4*(num_blocks+1) + 4*num_blocks
+    offsets = []
+    for b in blocks:
+        offsets.append(ofs)
+        ofs += len(b)
+    offsets.append(ofs)
+    ret = b'APZB' + struct.pack('<III', len(contents), block_size, num_blocks)
+    ret += struct.pack('<%uI' % (num_blocks+1), *offsets)
+    ret += struct.pack('<%uI' % num_blocks, *crcs)
+    for b in blocks:
+        ret += b
+    return ret
+
 def embed_file(out, f, idx, embedded_name, uncompressed):
     '''embed one file'''
     try:
@@ -46,6 +84,10 @@ def embed_file(out, f, idx, embedded_name, uncompressed):
         if contents[-1] != nul:
             contents += nul
         compressed.write(contents)
+    elif len(contents) > BLOCK_SIZE*BLOCK_MIN_BLOCKS and not embedded_name.endswith(".bin"):
+        # large files are read a block at a time. Firmware images
+        # are always loaded whole, so get the better ratio of gzip
+        compressed.write(compress_blocks(contents))
     else:
         # compress it
         f = open(compressed.name, "wb")
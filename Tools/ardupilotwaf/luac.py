@@ -0,0 +1,73 @@
+#!/usr/bin/env python
+
+'''
+precompile the Lua scripts embedded in ROMFS to bytecode, using a luac
+built for the build host from the same Lua sources as the firmware
+'''
+
+import os
+import subprocess
+
+LUA_SRC = 'libraries/AP_Scripting/lua/src'
+LUAC_HOST_SRC = 'libraries/AP_Scripting/generator/src/luac_host.c'
+
+# the parts of Lua that luac needs
+LUA_CORE = ['lapi', 'lcode', 'lctype', 'ldebug', 'ldo', 'ldump', 'lfunc', 'lgc',
+            'llex', 'lmem', 'lobject', 'lopcodes', 'lparser', 'lstate', 'lstring',
+            'ltable', 'ltm', 'lundump', 'lvm', 'lzio', 'lauxlib', 'luac']
+
+# these are only used to build the host luac, like gen-bindings
+LUAC_CC = 'gcc'
+
+
+def target_size_t(env):
+    '''size_t of the target when cross compiling, None when native'''
+    if env.TOOLCHAIN == 'native':
+        return None
+    if 'aarch64' in env.TOOLCHAIN or 'x86_64' in env.TOOLCHAIN:
+        return 'uint64_t'
+    return 'uint32_t'
+
+
+def build_luac(ctx, outdir):
+    '''build luac for the build host, writing bytecode for the target'''
+    src = ctx.srcnode.make_node(LUA_SRC).abspath()
+
+    # the firmware maps stdio onto AP_Filesystem, luac uses the host stdio
+    stub = os.path.join(outdir, 'stub', 'AP_Filesystem')
+    if not os.path.exists(stub):
+        os.makedirs(stub)
+    open(os.path.join(stub, 'posix_compat.h'), 'w').close()
+
+    luac = os.path.join(outdir, 'luac')
+    # all boards build Lua with LUA_32BITS
+    cmd = [LUAC_CC, '-O2', '-w', '-DLUA_32BITS',
+           '-I' + os.path.join(outdir, 'stub'), '-I' + src]
+    size_t = target_size_t(ctx.env)
+    if size_t is not None:
+        cmd += ['-include', 'stdint.h', '-DLUAC_SIZE_T=%s' % size_t]
+    cmd += [os.path.join(src, f + '.c') for f in LUA_CORE]
+    cmd += [ctx.srcnode.make_node(LUAC_HOST_SRC).abspath(), '-o', luac, '-lm']
+    subprocess.check_call(cmd)
+    return luac
+
+
+def compile_scripts(ctx, files):
+    '''replace the scripts in a list of ROMFS files with their bytecode'''
+    outdir = ctx.bldnode.make_node('luac').abspath()
+    luac = None
+    ret = []
+    for (name, filename) in files:
+        if not (name.startswith('scripts/') and name.endswith('.lua')):
+            ret.append((name, filename))
+            continue
+        if luac is None:
+            luac = build_luac(ctx, outdir)
+        out = os.path.join(outdir, name + 'c')
+        if not os.path.exists(os.path.dirname(out)):
+            os.makedirs(os.path.dirname(out))
+        # keep debug information, so errors still give line numbers
+        subprocess.check_call([luac, '-o', out, filename])
+        print("Compiled script %s" % filename)
+        ret.append((name + 'c', out))
+    return ret
@@ -9242,8 +9242,8 @@ class AutoTestCopter(AutoTest):
 
         lines = content.split("\n")
 
-        if not lines[0].startswith("TasksV2"):
-            raise NotAchievedException("Expected TasksV2 as first line first not (%s)" % lines[0])
+        if not lines[0].startswith("TasksV3"):
+            raise NotAchievedException("Expected TasksV3 as first line first not (%s)" % lines[0])
         # last line is empty, so -2 here
         if not lines[-2].startswith("AP_Vehicle::update_arming"):
             raise NotAchievedException("Expected EFI last not (%s)" % lines[-2])
@@ -0,0 +1,99 @@
+#!/usr/bin/env python
+'''
+Decompress a DataFlash log written with LOG_FILE_COMPR set, giving a
+plain log for tools such as pymavlink and MAVExplorer. Plain logs are
+copied unchanged.
+
+A compressed log is a sequence of blocks, each a 7 byte header
+(0xA3 0x95 0xFF, uint16 uncompressed length, uint16 data length)
+followed by an LZ4 block, or by the data itself if the data length
+equals the uncompressed length.
+'''
+
+import struct
+import sys
+
+from argparse import ArgumentParser
+parser = ArgumentParser(description=__doc__)
+parser.add_argument("infile", metavar="LOG")
+parser.add_argument("outfile", metavar="OUTPUT")
+args = parser.parse_args()
+
+BLOCK_HEADER = struct.Struct('<BBBHH')
+BLOCK_MAGIC = (0xA3, 0x95, 0xFF)
+
+
+def lz4_decompress(src, raw_len):
+    '''decompress an LZ4 block'''
+    dst = bytearray()
+    ip = 0
+    while ip < len(src):
+        token = src[ip]
+        ip += 1
+        lit_len = token >> 4
+        if lit_len == 15:
+            while True:
+                b = src[ip]
+                ip += 1
+                lit_len += b
+                if b != 255:
+                    break
+        dst += src[ip:ip+lit_len]
+        ip += lit_len
+        if ip >= len(src):
+            break
+        offset = src[ip] | (src[ip+1] << 8)
+        ip += 2
+        match_len = token & 0x0F
+        if match_len == 15:
+            while True:
+                b = src[ip]
+                ip += 1
+                match_len += b
+                if b != 255:
+                    break
+        match_len += 4
+        if offset == 0 or offset > len(dst):
+            raise ValueError("bad match offset")
+        start = len(dst) - offset
+        for i in range(match_len):
+            dst.append(dst[start+i])
+    if len(dst) != raw_len:
+        raise ValueError("bad block length %u, expected %u" % (len(dst), raw_len))
+    return dst
+
+
+data = open(args.infile, 'rb').read()
+out = open(args.outfile, 'wb')
+
+if tuple(bytearray(data[:3])) != BLOCK_MAGIC:
+    print("%s is not compressed" % args.infile)
+    out.write(data)
+    sys.exit(0)
+
+ofs = 0
+nblocks = 0
+total = 0
+while ofs + BLOCK_HEADER.size <= len(data):
+    (h1, h2, msgid, raw_len, data_len) = BLOCK_HEADER.unpack_from(data, ofs)
+    if (h1, h2, msgid) != BLOCK_MAGIC:
+        print("bad block header at offset %u" % ofs)
+        break
+    ofs += BLOCK_HEADER.size
+    block = bytearray(data[ofs:ofs+data_len])
+    ofs += data_len
+    if len(block) < data_len:
+        print("truncated block at offset %u" % ofs)
+        break
+    if data_len != raw_len:
+        try:
+            block = lz4_decompress(block, raw_len)
+        except (ValueError, IndexError) as ex:
+            print("corrupt block at offset %u: %s" % (ofs, ex))
+            break
+    out.write(block)
+    total += len(block)
+    nblocks += 1
+
+out.close()
+print("Decompressed %u blocks, %u bytes to %u bytes" % (nblocks, len(data), total))
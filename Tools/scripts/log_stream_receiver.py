@@ -0,0 +1,188 @@
+#!/usr/bin/env python
+'''
+Companion computer end of the AP_Logger stream backend, see
+libraries/AP_Logger/AP_Logger_Stream.h for the protocol.
+
+Set LOG_BACKEND_TYPE bit 3 and SERIALn_PROTOCOL 45 on the vehicle,
+then run this on the companion to write each log it streams to a
+numbered .BIN file, for example with SITL:
+
+  sim_vehicle.py -A --serial5=udpclient:127.0.0.1:14600
+  log_stream_receiver.py --udp 14600
+
+or over a high speed UART:
+
+  log_stream_receiver.py --serial /dev/ttyAMA0 --baud 2000000
+'''
+
+import os
+import socket
+import struct
+import time
+import zlib
+
+MAGIC = b'\xad\x4c'
+HEADER = struct.Struct('<2sBBIH')
+CRC = struct.Struct('<I')
+
+TYPE_DATA = 0x01
+TYPE_END = 0x02
+TYPE_START = 0x81
+TYPE_ACK = 0x82
+
+ACK_INTERVAL = 0.02
+START_INTERVAL = 1.0
+
+
+def frame(ftype, session, seq, payload=b''):
+    hdr = HEADER.pack(MAGIC, ftype, session, seq, len(payload))
+    return hdr + payload + CRC.pack(zlib.crc32(hdr + payload) & 0xFFFFFFFF)
+
+
+class UDPLink(object):
+    def __init__(self, port):
+        self.sock = socket.socket(socket.AF_INET, socket.SOCK_DGRAM)
+        self.sock.bind(('0.0.0.0', port))
+        self.sock.settimeout(0.01)
+        self.peer = None
+
+    def read(self):
+        try:
+            (data, self.peer) = self.sock.recvfrom(65536)
+            return data
+        except socket.timeout:
+            return b''
+
+    def write(self, buf):
+        if self.peer is not None:
+            self.sock.sendto(buf, self.peer)
+
+
+class SerialLink(object):
+    def __init__(self, device, baud):
+        import serial
+        self.port = serial.Serial(device, baud, timeout=0.01)
+
+    def read(self):
+        return self.port.read(max(1, self.port.in_waiting))
+
+    def write(self, buf):
+        self.port.write(buf)
+
+
+class Receiver(object):
+    def __init__(self, link, directory):
+        self.link = link
+        self.directory = directory
+        self.buf = b''
+        self.session = None
+        self.log = None
+        self.next_seq = 0
+        self.held = {}
+        self.last_ack = 0
+        self.last_start = 0
+        self.received = 0
+        self.duplicates = 0
+
+    def start_log(self, session):
+        n = 1
+        while os.path.exists(os.path.join(self.directory, "%08u.BIN" % n)):
+            n += 1
+        path = os.path.join(self.directory, "%08u.BIN" % n)
+        print("Session %u: logging to %s" % (session, path))
+        self.log = open(path, 'wb')
+        self.session = session
+        self.next_seq = 0
+        self.held = {}
+        self.received = 0
+        self.duplicates = 0
+
+    def end_log(self):
+        if self.log is not None:
+            print("Session %u: ended at block %u, %u blocks received, %u duplicates, %u held" %
+                  (self.session, self.next_seq, self.received, self.duplicates, len(self.held)))
+            self.log.close()
+            self.log = None
+        self.session = None
+
+    def send_ack(self):
+        mask = 0
+        for i in range(32):
+            if self.next_seq + 1 + i in self.held:
+                mask |= 1 << i
+        self.link.write(frame(TYPE_ACK, self.session, self.next_seq, struct.pack('<I', mask)))
+        self.last_ack = time.time()
+
+    def handle_data(self, session, seq, payload):
+        if session != self.session:
+            if seq != 0:
+                # joined part way through a session, wait for a
+                # START of our own to take effect
+                return
+            self.end_log()
+            self.start_log(session)
+        if seq < self.next_seq or seq in self.held:
+            self.duplicates += 1
+            return
+        self.received += 1
+        self.held[seq] = payload
+        while self.next_seq in self.held:
+            self.log.write(self.held.pop(self.next_seq))
+            self.next_seq += 1
+
+    def parse(self):
+        while True:
+            i = self.buf.find(MAGIC)
+            if i < 0:
+                self.buf = self.buf[-1:]
+                return
+            self.buf = self.buf[i:]
+            if len(self.buf) < HEADER.size:
+                return
+            (_, ftype, session, seq, length) = HEADER.unpack_from(self.buf)
+            total = HEADER.size + length + CRC.size
+            if len(self.buf) < total:
+                return
+            body = self.buf[:HEADER.size + length]
+            (crc,) = CRC.unpack_from(self.buf, HEADER.size + length)
+            if crc != zlib.crc32(body) & 0xFFFFFFFF:
+                self.buf = self.buf[1:]
+                continue
+            self.buf = self.buf[total:]
+            if ftype == TYPE_DATA:
+                self.handle_data(session, seq, body[HEADER.size:])
+            elif ftype == TYPE_END and session == self.session:
+                self.end_log()
+
+    def run(self):
+        while True:
+            data = self.link.read()
+            if data:
+                self.buf += data
+                self.parse()
+            now = time.time()
+            if self.session is None:
+                if now - self.last_start > START_INTERVAL:
+                    self.link.write(frame(TYPE_START, 0, 0))
+                    self.last_start = now
+            elif now - self.last_ack > ACK_INTERVAL:
+                self.send_ack()
+
+
+if __name__ == '__main__':
+    from argparse import ArgumentParser
+    parser = ArgumentParser(description=__doc__)
+    parser.add_argument("--udp", type=int, default=None, help="UDP port to listen on")
+    parser.add_argument("--serial", default=None, help="serial device to use")
+    parser.add_argument("--baud", type=int, default=921600, help="serial baud rate")
+    parser.add_argument("--directory", default='.', help="directory to write logs to")
+    args = parser.parse_args()
+
+    if args.serial is not None:
+        link = SerialLink(args.serial, args.baud)
+    elif args.udp is not None:
+        link = UDPLink(args.udp)
+    else:
+        parser.error("one of --udp or --serial is needed")
+
+    Receiver(link, args.directory).run()
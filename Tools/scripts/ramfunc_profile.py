@@ -0,0 +1,89 @@
+#!/usr/bin/env python
+'''
+build a profile of the hottest functions in a ChibiOS firmware from
+sampled program counters, for use with the RAMFUNC_PROFILE hwdef
+option, which places the hottest functions in ITCM or RAM
+
+The samples are hex addresses, one per line, optionally followed by
+a count. They can come from a debugger, for example by repeatedly
+running "p/x $pc" in gdb while the vehicle is flying, or from a SWO
+PC sampler
+
+usage: ramfunc_profile.py ELF SAMPLES > hwdef/BOARD/ramfunc.profile
+'''
+
+import argparse
+import bisect
+import subprocess
+import sys
+
+parser = argparse.ArgumentParser(description='build a RAMFUNC_PROFILE from sampled program counters')
+parser.add_argument('elf', help='firmware ELF file the samples were taken from')
+parser.add_argument('samples', help='file of sampled program counters')
+parser.add_argument('--nm', default='arm-none-eabi-nm', help='nm program')
+parser.add_argument('--min-samples', type=int, default=2, help='ignore functions with fewer samples')
+args = parser.parse_args()
+
+# functions in RAM are already placed and not counted
+FLASH_RANGES = [(0x08000000, 0x08200000), (0x90000000, 0xA0000000)]
+
+
+def in_flash(address):
+    for (start, end) in FLASH_RANGES:
+        if address >= start and address < end:
+            return True
+    return False
+
+
+def load_functions(elf):
+    '''return sorted lists of start addresses and (start, size, symbol) for functions in flash'''
+    out = subprocess.check_output([args.nm, '--print-size', '--numeric-sort', '--defined-only', elf])
+    starts = []
+    functions = []
+    for line in out.decode('utf-8').splitlines():
+        fields = line.split()
+        if len(fields) != 4 or fields[2] not in 'tTwW':
+            continue
+        # thumb function addresses have the low bit set
+        start = int(fields[0], 16) & ~1
+        size = int(fields[1], 16)
+        if size == 0 or not in_flash(start):
+            continue
+        starts.append(start)
+        functions.append((start, size, fields[3]))
+    return starts, functions
+
+
+def main():
+    starts, functions = load_functions(args.elf)
+    counts = {}
+    total = 0
+    for line in open(args.samples):
+        fields = line.split()
+        if len(fields) == 0 or fields[0].startswith('#'):
+            continue
+        try:
+            address = int(fields[0], 16)
+            count = int(fields[1]) if len(fields) > 1 else 1
+        except ValueError:
+            continue
+        total += count
+        i = bisect.bisect_right(starts, address) - 1
+        if i < 0:
+            continue
+        (start, size, symbol) = functions[i]
+        if address < start + size:
+            counts[symbol] = counts.get(symbol, 0) + count
+
+    sizes = dict((symbol, size) for (start, size, symbol) in functions)
+    print("# RAMFUNC_PROFILE from %s, %u samples" % (args.elf, total))
+    print("# samples size symbol")
+    for symbol in sorted(counts, key=lambda s: counts[s], reverse=True):
+        if counts[symbol] >= args.min_samples:
+            print("%u %u %s" % (counts[symbol], sizes[symbol], symbol))
+
+
+if __name__ == '__main__':
+    if args.samples == '-':
+        args.samples = '/dev/stdin'
+    sys.exit(main())
@@ -0,0 +1,250 @@
+#!/usr/bin/env python3
+
+'''
+benchmark the main loop of SITL vehicles by replaying recorded IMU data
+
+Each vehicle is run in lockstep with its accel and gyro samples read
+from files (SIM_ACC_FILE_RW and SIM_GYR_FILE_RW), stopping at the end
+of the data, so every run does the same work. The scheduler times each
+task and loop with the host CPU clock (SCHED_OPTIONS bit 5) and the
+results are read back from the TSKP and PM messages of the run's log
+and written as JSON.
+
+The IMU files are first recorded from a normal run of each vehicle:
+
+  ./Tools/scripts/sitl_perf_benchmark.py --record 120 --sensors bench_imu
+
+and then replayed on each build to be measured:
+
+  ./waf configure --board sitl && ./waf copter plane rover
+  ./Tools/scripts/sitl_perf_benchmark.py --sensors bench_imu --output new.json --compare old.json
+
+SITL reads and writes the files as /tmp/gyroN.dat and /tmp/accelN.dat,
+so only one benchmark can run on a machine at a time. The other sensors
+still come from the simulation of a vehicle sitting at home.
+
+AP_FLAKE8_CLEAN
+'''
+
+import glob
+import json
+import os
+import shutil
+import subprocess
+import sys
+import tempfile
+import time
+
+from argparse import ArgumentParser
+
+VEHICLES = {
+    'copter': {
+        'binary': 'build/sitl/bin/arducopter',
+        'model': '+',
+        'defaults': ['Tools/autotest/default_params/copter.parm'],
+    },
+    'plane': {
+        'binary': 'build/sitl/bin/arduplane',
+        'model': 'plane',
+        'defaults': ['Tools/autotest/models/plane.parm'],
+    },
+    'rover': {
+        'binary': 'build/sitl/bin/ardurover',
+        'model': 'rover',
+        'defaults': ['Tools/autotest/default_params/rover.parm'],
+    },
+}
+
+# SCHED_OPTIONS bits for per-task perf info and host CPU timing
+SCHED_OPTIONS_BENCH = (1 << 0) | (1 << 5)
+
+
+def imu_files():
+    '''the IMU data files SITL reads and writes'''
+    return glob.glob('/tmp/gyro*.dat') + glob.glob('/tmp/accel*.dat')
+
+
+def run_sitl(vehicle, rundir, params, speedup, timeout):
+    '''run one vehicle in rundir, returning its exit code or None if it was stopped at the timeout'''
+    info = VEHICLES[vehicle]
+    parm_file = os.path.join(rundir, 'bench.parm')
+    with open(parm_file, 'w') as f:
+        for (name, value) in params.items():
+            f.write('%s %s\n' % (name, value))
+    defaults = [os.path.abspath(d) for d in info['defaults']] + [parm_file]
+    cmd = [os.path.abspath(info['binary']),
+           '--model', info['model'],
+           '--speedup', str(speedup),
+           '--defaults', ','.join(defaults),
+           '--serial0', 'tcp:0']
+    with open(os.path.join(rundir, 'sitl.txt'), 'w') as output:
+        p = subprocess.Popen(cmd, cwd=rundir, stdout=output, stderr=subprocess.STDOUT)
+        try:
+            return p.wait(timeout=timeout)
+        except subprocess.TimeoutExpired:
+            p.terminate()
+            p.wait()
+            return None
+
+
+def record(vehicle, sensors, seconds, speedup):
+    '''record the IMU data of a run of a vehicle into sensors/vehicle'''
+    for f in imu_files():
+        os.unlink(f)
+    rundir = tempfile.mkdtemp(prefix='bench-%s-' % vehicle)
+    params = {
+        'SIM_GYR_FILE_RW': 2,
+        'SIM_ACC_FILE_RW': 2,
+    }
+    run_sitl(vehicle, rundir, params, speedup, seconds)
+    outdir = os.path.join(sensors, vehicle)
+    if not os.path.exists(outdir):
+        os.makedirs(outdir)
+    for f in imu_files():
+        shutil.move(f, os.path.join(outdir, os.path.basename(f)))
+    shutil.rmtree(rundir)
+
+
+def summarise_log(logfile, skip_s):
+    '''per-task and per-loop timing from the TSKP and PM messages of a log'''
+    from pymavlink import mavutil
+    mlog = mavutil.mavlink_connection(logfile)
+
+    tasks = {}
+    loop = {'loops': 0, 'long_loops': 0, 'max_us': 0}
+    while True:
+        m = mlog.recv_match(type=['TSKP', 'PM'])
+        if m is None:
+            break
+        # skip the startup of the vehicle
+        if m.TimeUS < skip_s * 1.0e6:
+            continue
+        if m.get_type() == 'PM':
+            loop['loops'] += m.NL
+            loop['long_loops'] += m.NLon
+            loop['max_us'] = max(loop['max_us'], m.MaxT)
+            continue
+        t = tasks.setdefault(m.Name, {'runs': 0, 'total_us': 0, 'max_us': 0, 'P50': 0, 'P95': 0, 'P99': 0})
+        t['runs'] += m.N
+        t['total_us'] += m.Tot
+        t['max_us'] = max(t['max_us'], m.Max)
+        # percentiles are averaged over the periods, weighted by runs
+        for p in ['P50', 'P95', 'P99']:
+            t[p] += getattr(m, p) * m.N
+
+    task_total_us = 0
+    for t in tasks.values():
+        task_total_us += t['total_us']
+        if t['runs'] > 0:
+            t['mean_us'] = t['total_us'] / float(t['runs'])
+            for p in ['P50', 'P95', 'P99']:
+                t[p] /= float(t['runs'])
+    if loop['loops'] > 0:
+        loop['task_us_per_loop'] = task_total_us / float(loop['loops'])
+    return {'loop': loop, 'tasks': tasks}
+
+
+def replay(vehicle, sensors, speedup, timeout, skip_s):
+    '''replay the recorded IMU data through a vehicle and summarise its timing'''
+    indir = os.path.join(sensors, vehicle)
+    files = glob.glob(os.path.join(indir, '*.dat'))
+    if len(files) == 0:
+        return {'status': 'no IMU data in %s' % indir}
+    for f in imu_files():
+        os.unlink(f)
+    for f in files:
+        shutil.copy(f, '/tmp')
+
+    rundir = tempfile.mkdtemp(prefix='bench-%s-' % vehicle)
+    params = {
+        'SIM_GYR_FILE_RW': 3,
+        'SIM_ACC_FILE_RW': 3,
+        'SCHED_OPTIONS': SCHED_OPTIONS_BENCH,
+        'LOG_DISARMED': 1,
+    }
+    start = time.time()
+    ret = run_sitl(vehicle, rundir, params, speedup, timeout)
+    wall_s = time.time() - start
+    if ret is None:
+        return {'status': 'timed out, rundir %s' % rundir}
+    logs = glob.glob(os.path.join(rundir, 'logs', '*.BIN'))
+    if len(logs) == 0:
+        return {'status': 'no log, rundir %s' % rundir}
+    result = summarise_log(max(logs, key=os.path.getmtime), skip_s)
+    result['status'] = 'ok'
+    result['wall_s'] = wall_s
+    shutil.rmtree(rundir)
+    return result
+
+
+def compare(old, new, threshold_pct):
+    '''print the changes in mean task and loop times, returning the number of regressions'''
+    regressions = 0
+
+    def change(name, a, b):
+        if a <= 0:
+            return 0
+        pct = 100.0 * (b - a) / a
+        if abs(pct) >= threshold_pct:
+            print('  %-24s %9.2f -> %9.2f us  %+6.1f%%' % (name, a, b, pct))
+        return 1 if pct >= threshold_pct else 0
+
+    for (vehicle, n) in new['vehicles'].items():
+        o = old['vehicles'].get(vehicle)
+        if o is None or o.get('status') != 'ok' or n.get('status') != 'ok':
+            continue
+        print('%s:' % vehicle)
+        regressions += change('task time per loop',
+                              o['loop'].get('task_us_per_loop', 0),
+                              n['loop'].get('task_us_per_loop', 0))
+        for (name, t) in sorted(n['tasks'].items()):
+            ot = o['tasks'].get(name)
+            if ot is None or 'mean_us' not in ot or 'mean_us' not in t:
+                continue
+            regressions += change(name, ot['mean_us'], t['mean_us'])
+    return regressions
+
+
+if __name__ == '__main__':
+    parser = ArgumentParser(description=__doc__)
+    parser.add_argument("--vehicle", action='append', default=[], choices=sorted(VEHICLES.keys()),
+                        help="vehicle to benchmark, may be repeated, default all")
+    parser.add_argument("--sensors", default="sitl_bench_imu", help="directory of recorded IMU data")
+    parser.add_argument("--record", type=float, default=None, metavar="SECONDS",
+                        help="record IMU data for this many wall clock seconds instead of benchmarking")
+    parser.add_argument("--speedup", type=int, default=10, help="SITL speedup")
+    parser.add_argument("--timeout", type=float, default=600, help="maximum wall clock seconds for a replay")
+    parser.add_argument("--skip", type=float, default=20, help="seconds of startup to leave out of the results")
+    parser.add_argument("--output", default=None, help="JSON results file, default stdout")
+    parser.add_argument("--compare", default=None, help="JSON results of an earlier run to compare with")
+    parser.add_argument("--threshold", type=float, default=10, help="percentage change reported by --compare")
+    args = parser.parse_args()
+
+    vehicles = args.vehicle or sorted(VEHICLES.keys())
+
+    if args.record is not None:
+        for v in vehicles:
+            print("Recording %s" % v)
+            record(v, args.sensors, args.record, args.speedup)
+        sys.exit(0)
+
+    try:
+        commit = subprocess.check_output(['git', 'rev-parse', 'HEAD']).decode().strip()
+    except (OSError, subprocess.CalledProcessError):
+        commit = ''
+    results = {'commit': commit, 'vehicles': {}}
+    for v in vehicles:
+        results['vehicles'][v] = replay(v, args.sensors, args.speedup, args.timeout, args.skip)
+
+    text = json.dumps(results, indent=2, sort_keys=True)
+    if args.output is None:
+        print(text)
+    else:
+        with open(args.output, 'w') as f:
+            f.write(text + '\n')
+
+    if args.compare is not None:
+        with open(args.compare) as f:
+            old = json.load(f)
+        if compare(old, results, args.threshold) > 0:
+            sys.exit(1)
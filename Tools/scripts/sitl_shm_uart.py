@@ -0,0 +1,140 @@
+#!/usr/bin/env python
+'''
+Client for SITL serial ports opened as shm:<name>, see
+libraries/AP_HAL_SITL/UART_SHM_Protocol.h for the layout.
+
+Used as a module the SHMUART class gives non-blocking read() and
+write() on the port, for tools that talk to SITL directly. Run as a
+script it bridges the port to a TCP listening socket for tools that
+only speak TCP, for example:
+
+  sitl_shm_uart.py ap_uart_0_0 --tcp 5770
+  mavproxy.py --master=tcp:127.0.0.1:5770
+
+The ring indexes are read and written with plain loads and stores,
+which is only safe on hosts with ordered stores such as x86. SITL and
+the client must run on the same host.
+'''
+
+import mmap
+import os
+import select
+import socket
+import struct
+import time
+
+MAGIC = 0x54524155
+VERSION = 1
+
+HEADER = struct.Struct('<IHHII')
+HEADER_SIZE = 64
+RING_HEAD = 0
+RING_TAIL = 64
+RING_DATA = 128
+
+
+class SHMUART(object):
+    '''one end of a SITL shared memory serial port'''
+
+    def __init__(self, name, timeout=10):
+        path = os.path.join('/dev/shm', name)
+        deadline = time.time() + timeout
+        while True:
+            try:
+                fd = os.open(path, os.O_RDWR)
+                (magic, version, _, ring_size, size) = HEADER.unpack_from(os.pread(fd, HEADER.size, 0))
+                if magic == MAGIC and os.fstat(fd).st_size == size:
+                    break
+                os.close(fd)
+            except OSError:
+                pass
+            if time.time() > deadline:
+                raise RuntimeError("no SITL shared memory port %s" % path)
+            time.sleep(0.1)
+        if version != VERSION:
+            os.close(fd)
+            raise RuntimeError("unsupported version %u in %s" % (version, path))
+        self.mm = mmap.mmap(fd, size)
+        os.close(fd)
+        self.ring_size = ring_size
+        ring_len = RING_DATA + ring_size
+        # SITL writes to_client, we write from_client
+        self.rx_ofs = HEADER_SIZE
+        self.tx_ofs = HEADER_SIZE + ring_len
+
+    def _get(self, ofs):
+        return struct.unpack_from('<I', self.mm, ofs)[0]
+
+    def _set(self, ofs, value):
+        struct.pack_into('<I', self.mm, ofs, value & 0xFFFFFFFF)
+
+    def read(self, n=4096):
+        '''read up to n bytes, returning an empty bytes object if none are waiting'''
+        ring = self.rx_ofs
+        tail = self._get(ring + RING_TAIL)
+        head = self._get(ring + RING_HEAD)
+        n = min(n, (head - tail) & 0xFFFFFFFF)
+        if n == 0:
+            return b''
+        ofs = tail & (self.ring_size - 1)
+        data = ring + RING_DATA
+        n1 = min(n, self.ring_size - ofs)
+        ret = self.mm[data + ofs:data + ofs + n1] + self.mm[data:data + n - n1]
+        self._set(ring + RING_TAIL, tail + n)
+        return ret
+
+    def write(self, buf):
+        '''write as much of buf as fits, returning the number of bytes written'''
+        ring = self.tx_ofs
+        head = self._get(ring + RING_HEAD)
+        tail = self._get(ring + RING_TAIL)
+        n = min(len(buf), self.ring_size - ((head - tail) & 0xFFFFFFFF))
+        if n == 0:
+            return 0
+        ofs = head & (self.ring_size - 1)
+        data = ring + RING_DATA
+        n1 = min(n, self.ring_size - ofs)
+        self.mm[data + ofs:data + ofs + n1] = buf[:n1]
+        self.mm[data:data + n - n1] = buf[n1:n]
+        self._set(ring + RING_HEAD, head + n)
+        return n
+
+    def close(self):
+        self.mm.close()
+
+
+def bridge_tcp(port, tcp_port):
+    '''forward between the port and one TCP client at a time'''
+    listen = socket.socket(socket.AF_INET, socket.SOCK_STREAM)
+    listen.setsockopt(socket.SOL_SOCKET, socket.SO_REUSEADDR, 1)
+    listen.bind(('127.0.0.1', tcp_port))
+    listen.listen(1)
+    while True:
+        print("Waiting for connection on port %u" % tcp_port)
+        (conn, addr) = listen.accept()
+        conn.setsockopt(socket.IPPROTO_TCP, socket.TCP_NODELAY, 1)
+        print("Connection from %s:%u" % addr)
+        pending = b''
+        while True:
+            data = port.read()
+            if data:
+                conn.sendall(data)
+            if not pending:
+                (r, w, x) = select.select([conn], [], [], 0 if data else 0.001)
+                if r:
+                    pending = conn.recv(4096)
+                    if not pending:
+                        break
+            if pending:
+                pending = pending[port.write(pending):]
+        conn.close()
+
+
+if __name__ == '__main__':
+    from argparse import ArgumentParser
+    parser = ArgumentParser(description=__doc__)
+    parser.add_argument("name", help="shared memory name given to SITL, for example ap_uart_0_0")
+    parser.add_argument("--tcp", type=int, default=5770, help="TCP port to listen on")
+    args = parser.parse_args()
+
+    bridge_tcp(SHMUART(args.name), args.tcp)
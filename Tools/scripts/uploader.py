@@ -235,6 +235,7 @@ class uploader(object):
     EXTF_GET_CRC    = b'\x37'	  # compute & return a CRC of data in external flash
 
     CHIP_FULL_ERASE = b'\x40'     # full erase of flash
+    PROG_COMPRESSED = b'\x41'     # add bytes to a compressed block, empty to program it
 
     INFO_BL_REV     = b'\x01'        # bootloader protocol revision
     BL_REV_MIN      = 2              # minimum supported bootloader protocol
@@ -243,8 +244,10 @@ class uploader(object):
     INFO_BOARD_REV  = b'\x03'        # board revision
     INFO_FLASH_SIZE = b'\x04'        # max firmware size in bytes
     INFO_EXTF_SIZE  = b'\x06'        # available external flash size
+    INFO_COMPRESSED_BLOCK = b'\x07'  # largest block for PROG_COMPRESSED
 
     PROG_MULTI_MAX  = 252            # protocol max is 255, must be multiple of 4
+    PROG_COMPRESSED_MAX = 248        # kept below the bootloader's 256 byte uart buffer
     READ_MULTI_MAX  = 252            # protocol max is 255
 
     NSH_INIT        = bytearray(b'\x0d\x0d\x0d')
@@ -261,7 +264,8 @@ class uploader(object):
                  source_system=None,
                  source_component=None,
                  no_extf=False,
-                 force_erase=False):
+                 force_erase=False,
+                 no_compress=False):
         self.MAVLINK_REBOOT_ID1 = bytearray(b'\xfe\x21\x72\xff\x00\x4c\x00\x00\x40\x40\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\xf6\x00\x01\x00\x00\x53\x6b')  # NOQA
         self.MAVLINK_REBOOT_ID0 = bytearray(b'\xfe\x21\x45\xff\x00\x4c\x00\x00\x40\x40\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\xf6\x00\x00\x00\x00\xcc\x37')  # NOQA
         if target_component is None:
@@ -272,6 +276,7 @@ class uploader(object):
             source_component = 1
         self.no_extf = no_extf
         self.force_erase = force_erase
+        self.no_compress = no_compress
 
         # open the port, keep the default timeout short so we can poll quickly
         self.port = serial.Serial(portname, baudrate_bootloader, timeout=2.0)
@@ -490,6 +495,14 @@ class uploader(object):
         self.__send(uploader.EOC)
         self.__getSync()
 
+    # send a PROG_COMPRESSED command, an empty one programs the block
+    def __program_compressed(self, data):
+        self.__send(uploader.PROG_COMPRESSED)
+        self.__send(bytearray([len(data)]))
+        self.__send(data)
+        self.__send(uploader.EOC)
+        self.__getSync()
+
     # send a PROG_EXTF_MULTI command to write a collection of bytes to external flash
     def __program_multi_extf(self, data):
 
@@ -554,8 +567,30 @@ class uploader(object):
     def __split_len(self, seq, length):
         return [seq[i:i+length] for i in range(0, len(seq), length)]
 
+    # upload code as independent raw deflate blocks, which the
+    # bootloader decompresses and programs while we send the next one
+    def __program_compressed_blocks(self, label, fw):
+        print("\n", end='')
+        code = fw.image
+        blocks = self.__split_len(code, self.compressed_block)
+        sent = 0
+        for i in range(len(blocks)):
+            c = zlib.compressobj(9, zlib.DEFLATED, -15)
+            cdata = c.compress(bytes(blocks[i])) + c.flush()
+            sent += len(cdata)
+            for chunk in self.__split_len(cdata, uploader.PROG_COMPRESSED_MAX):
+                self.__program_compressed(chunk)
+            self.__program_compressed(b'')
+            if i % 16 == 0:
+                self.__drawProgressBar(label, i, len(blocks))
+        self.__drawProgressBar(label, 100, 100)
+        print("\nSent %u bytes for %u byte image" % (sent, len(code)))
+
     # upload code
     def __program(self, label, fw):
+        if self.compressed_block > 0:
+            self.__program_compressed_blocks(label, fw)
+            return
         print("\n", end='')
         code = fw.image
         groups = self.__split_len(code, uploader.PROG_MULTI_MAX)
@@ -736,6 +771,14 @@ class uploader(object):
         self.board_rev = self.__getInfo(uploader.INFO_BOARD_REV)
         self.fw_maxsize = self.__getInfo(uploader.INFO_FLASH_SIZE)
 
+        self.compressed_block = 0
+        if not self.no_compress:
+            try:
+                self.compressed_block = self.__getInfo(uploader.INFO_COMPRESSED_BLOCK)
+            except Exception:
+                # older bootloaders don't support compressed upload
+                self.__sync()
+
     def dump_board_info(self):
         # OTP added in v4:
         print("Bootloader Protocol: %u" % self.bl_rev)
@@ -1123,6 +1166,7 @@ def main():
     parser.add_argument('--erase-extflash', type=lambda x: int(x, 0), default=None,
                         help="Erase sectors containing specified amount of bytes from ext flash")
     parser.add_argument('--force-erase', action="store_true", help="Do not check for pre cleared flash, always erase the chip")
+    parser.add_argument('--no-compress', action="store_true", help="Do not use compressed upload even if the bootloader supports it")
     parser.add_argument('firmware', nargs="?", action="store", default=None, help="Firmware file to be uploaded")
     args = parser.parse_args()
 
@@ -1161,7 +1205,8 @@ def main():
                                   args.source_system,
                                   args.source_component,
                                   args.no_extf,
-                                  args.force_erase)
+                                  args.force_erase,
+                                  args.no_compress)
 
                 except Exception as e:
                     if not is_WSL and not is_WSL2 and "win32" not in _platform:
@@ -694,7 +694,7 @@ Quaternion AC_AttitudeControl::attitude_from_thrust_vector(Vector3f thrust_vecto
     Vector3f thrust_vec_cross = thrust_vector_up % thrust_vector;
 
     // the dot product is used to calculate the angle between the target and desired thrust vectors
-    const float thrust_vector_angle = acosf(constrain_float(thrust_vector_up * thrust_vector, -1.0f, 1.0f));
+    const float thrust_vector_angle = fast_acosf(constrain_float(thrust_vector_up * thrust_vector, -1.0f, 1.0f));
 
     // Normalize the thrust rotation vector
     const float thrust_vector_length = thrust_vec_cross.length();
@@ -798,13 +798,13 @@ void AC_AttitudeControl::thrust_vector_rotation_angles(const Quaternion& attitud
     Vector3f att_body_thrust_vec = attitude_body * thrust_vector_up; // current thrust vector
 
     // the dot product is used to calculate the current lean angle for use of external functions
-    thrust_angle = acosf(constrain_float(thrust_vector_up * att_body_thrust_vec,-1.0f,1.0f));
+    thrust_angle = fast_acosf(constrain_float(thrust_vector_up * att_body_thrust_vec,-1.0f,1.0f));
 
     // the cross product of the desired and target thrust vector defines the rotation vector
     Vector3f thrust_vec_cross = att_body_thrust_vec % att_target_thrust_vec;
 
     // the dot product is used to calculate the angle between the target and desired thrust vectors
-    thrust_error_angle = acosf(constrain_float(att_body_thrust_vec * att_target_thrust_vec, -1.0f, 1.0f));
+    thrust_error_angle = fast_acosf(constrain_float(att_body_thrust_vec * att_target_thrust_vec, -1.0f, 1.0f));
 
     // Normalize the thrust rotation vector
     float thrust_vector_length = thrust_vec_cross.length();
@@ -981,10 +981,9 @@ void AC_AttitudeControl::inertial_frame_reset()
 // Convert a 321-intrinsic euler angle derivative to an angular velocity vector
 void AC_AttitudeControl::euler_rate_to_ang_vel(const Vector3f& euler_rad, const Vector3f& euler_rate_rads, Vector3f& ang_vel_rads)
 {
-    float sin_theta = sinf(euler_rad.y);
-    float cos_theta = cosf(euler_rad.y);
-    float sin_phi = sinf(euler_rad.x);
-    float cos_phi = cosf(euler_rad.x);
+    float sin_theta, cos_theta, sin_phi, cos_phi;
+    fast_sincosf(euler_rad.y, sin_theta, cos_theta);
+    fast_sincosf(euler_rad.x, sin_phi, cos_phi);
 
     ang_vel_rads.x = euler_rate_rads.x - sin_theta * euler_rate_rads.z;
     ang_vel_rads.y = cos_phi * euler_rate_rads.y + sin_phi * cos_theta * euler_rate_rads.z;
@@ -995,10 +994,9 @@ void AC_AttitudeControl::euler_rate_to_ang_vel(const Vector3f& euler_rad, const
 // Returns false if the vehicle is pitched 90 degrees up or down
 bool AC_AttitudeControl::ang_vel_to_euler_rate(const Vector3f& euler_rad, const Vector3f& ang_vel_rads, Vector3f& euler_rate_rads)
 {
-    float sin_theta = sinf(euler_rad.y);
-    float cos_theta = cosf(euler_rad.y);
-    float sin_phi = sinf(euler_rad.x);
-    float cos_phi = cosf(euler_rad.x);
+    float sin_theta, cos_theta, sin_phi, cos_phi;
+    fast_sincosf(euler_rad.y, sin_theta, cos_theta);
+    fast_sincosf(euler_rad.x, sin_phi, cos_phi);
 
     // When the vehicle pitches all the way up or all the way down, the euler angles become discontinuous. In this case, we just return false.
     if (is_zero(cos_theta)) {
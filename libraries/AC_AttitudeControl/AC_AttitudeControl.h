@@ -198,6 +198,11 @@ public:
     // Run angular velocity controller and send outputs to the motors
     virtual void rate_controller_run() = 0;
 
+    // Run angular velocity controller on a corrected gyro sample over a
+    // time step given by the caller, for a rate loop running at the gyro
+    // rate outside of the main loop. Returns false if not supported
+    virtual bool rate_controller_run_dt(const Vector3f& gyro_rads, float dt) { return false; }
+
     // Convert a 321-intrinsic euler angle derivative to an angular velocity vector
     void euler_rate_to_ang_vel(const Vector3f& euler_rad, const Vector3f& euler_rate_rads, Vector3f& ang_vel_rads);
 
@@ -313,15 +313,15 @@ float AC_AttitudeControl_Multi::get_throttle_avg_max(float throttle_in)
 }
 
 // update_throttle_rpy_mix - slew set_throttle_rpy_mix to requested value
-void AC_AttitudeControl_Multi::update_throttle_rpy_mix()
+void AC_AttitudeControl_Multi::update_throttle_rpy_mix(float dt)
 {
     // slew _throttle_rpy_mix to _throttle_rpy_mix_desired
     if (_throttle_rpy_mix < _throttle_rpy_mix_desired) {
         // increase quickly (i.e. from 0.1 to 0.9 in 0.4 seconds)
-        _throttle_rpy_mix += MIN(2.0f * _dt, _throttle_rpy_mix_desired - _throttle_rpy_mix);
+        _throttle_rpy_mix += MIN(2.0f * dt, _throttle_rpy_mix_desired - _throttle_rpy_mix);
     } else if (_throttle_rpy_mix > _throttle_rpy_mix_desired) {
         // reduce more slowly (from 0.9 to 0.1 in 1.6 seconds)
-        _throttle_rpy_mix -= MIN(0.5f * _dt, _throttle_rpy_mix - _throttle_rpy_mix_desired);
+        _throttle_rpy_mix -= MIN(0.5f * dt, _throttle_rpy_mix - _throttle_rpy_mix_desired);
 
         // if the mix is still higher than that being used, reset immediately
         const float throttle_hover = _motors.get_throttle_hover();
@@ -341,27 +341,34 @@ void AC_AttitudeControl_Multi::update_throttle_rpy_mix()
 }
 
 void AC_AttitudeControl_Multi::rate_controller_run()
+{
+    AC_AttitudeControl_Multi::rate_controller_run_dt(_ahrs.get_gyro_latest(), _dt);
+}
+
+bool AC_AttitudeControl_Multi::rate_controller_run_dt(const Vector3f& gyro_rads, float dt)
 {
     // move throttle vs attitude mixing towards desired (called from here because this is conveniently called on every iteration)
-    update_throttle_rpy_mix();
+    update_throttle_rpy_mix(dt);
 
     _ang_vel_body += _sysid_ang_vel_body;
 
-    Vector3f gyro_latest = _ahrs.get_gyro_latest();
-
     // Boost PD on very rapid throttle changes
     if (_motors.get_throttle_slew_rate() > AC_ATTITUDE_CONTROL_THR_G_BOOST_THRESH) {
         const float pd_boost = constrain_float(_throttle_gain_boost + 1.0f, 1.0, 2.0);
         set_PD_scale_mult(Vector3f(pd_boost, pd_boost, 1.0f));
     }
 
-    _motors.set_roll(get_rate_roll_pid().update_all(_ang_vel_body.x, gyro_latest.x,  _dt, _motors.limit.roll, _pd_scale.x) + _actuator_sysid.x);
+    // run the roll, pitch and yaw rate controllers together
+    const bool limit[3] {_motors.limit.roll, _motors.limit.pitch, _motors.limit.yaw};
+    const Vector3f rate_out = AC_PID::update_all_3axis(get_rate_roll_pid(), get_rate_pitch_pid(), get_rate_yaw_pid(), _ang_vel_body, gyro_rads, dt, limit, _pd_scale);
+
+    _motors.set_roll(rate_out.x + _actuator_sysid.x);
     _motors.set_roll_ff(get_rate_roll_pid().get_ff());
 
-    _motors.set_pitch(get_rate_pitch_pid().update_all(_ang_vel_body.y, gyro_latest.y,  _dt, _motors.limit.pitch, _pd_scale.y) + _actuator_sysid.y);
+    _motors.set_pitch(rate_out.y + _actuator_sysid.y);
     _motors.set_pitch_ff(get_rate_pitch_pid().get_ff());
 
-    _motors.set_yaw(get_rate_yaw_pid().update_all(_ang_vel_body.z, gyro_latest.z,  _dt, _motors.limit.yaw, _pd_scale.z) + _actuator_sysid.z);
+    _motors.set_yaw(rate_out.z + _actuator_sysid.z);
     _motors.set_yaw_ff(get_rate_yaw_pid().get_ff()*_feedforward_scalar);
 
     _sysid_ang_vel_body.zero();
@@ -371,6 +378,8 @@ void AC_AttitudeControl_Multi::rate_controller_run()
     _pd_scale = VECTORF_111;
 
     control_monitor_update();
+
+    return true;
 }
 
 // sanity check parameters.  should be called once before takeoff
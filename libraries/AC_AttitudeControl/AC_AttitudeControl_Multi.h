@@ -74,6 +74,7 @@ public:
 
     // run lowest level body-frame rate controller and send outputs to the motors
     void rate_controller_run() override;
+    bool rate_controller_run_dt(const Vector3f& gyro_rads, float dt) override;
 
     // sanity check parameters.  should be called once before take-off
     void parameter_sanity_check() override;
@@ -84,7 +85,7 @@ public:
 protected:
 
     // update_throttle_rpy_mix - updates thr_low_comp value towards the target
-    void update_throttle_rpy_mix();
+    void update_throttle_rpy_mix(float dt);
 
     // get maximum value throttle can be raised to based on throttle vs attitude prioritisation
     float get_throttle_avg_max(float throttle_in);
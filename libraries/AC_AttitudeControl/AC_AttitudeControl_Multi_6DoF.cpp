@@ -10,6 +10,10 @@
 
 // run lowest level body-frame rate controller and send outputs to the motors
 void AC_AttitudeControl_Multi_6DoF::rate_controller_run() {
+    rate_controller_run_dt(_ahrs.get_gyro_latest(), _dt);
+}
+
+bool AC_AttitudeControl_Multi_6DoF::rate_controller_run_dt(const Vector3f& gyro_rads, float dt) {
 
     // pass current offsets to motors and run baseclass controller
     // motors require the offsets to know which way is up
@@ -25,7 +29,7 @@ void AC_AttitudeControl_Multi_6DoF::rate_controller_run() {
     }
     _motors.set_roll_pitch(roll_deg,pitch_deg);
 
-    AC_AttitudeControl_Multi::rate_controller_run();
+    return AC_AttitudeControl_Multi::rate_controller_run_dt(gyro_rads, dt);
 }
 
 /*
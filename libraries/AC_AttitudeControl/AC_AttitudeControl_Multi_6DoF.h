@@ -61,6 +61,7 @@ public:
 
     // run lowest level body-frame rate controller and send outputs to the motors
     void rate_controller_run() override;
+    bool rate_controller_run_dt(const Vector3f& gyro_rads, float dt) override;
 
     // limiting lean angle based on throttle makes no sense for 6DoF, always allow 90 deg, return in centi-degrees
     float get_althold_lean_angle_max_cd() const override { return 9000.0f; }
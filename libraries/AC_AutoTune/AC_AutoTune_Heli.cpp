@@ -54,6 +54,10 @@
 #define AUTOTUNE_SEQ_BITMASK_RATE_D          2
 #define AUTOTUNE_SEQ_BITMASK_ANGLE_P         4
 #define AUTOTUNE_SEQ_BITMASK_MAX_GAIN        8
+#define AUTOTUNE_SEQ_BITMASK_MULTI_AXIS     16
+
+#define AUTOTUNE_MULTI_SWEEP_SETTLE_S       3.0f    // minimum time in seconds the multi-axis sweep runs before analysis starts
+#define AUTOTUNE_MULTI_SWEEP_PERIODS           3    // number of multi-sine periods analysed by the multi-axis sweep
 
 const AP_Param::GroupInfo AC_AutoTune_Heli::var_info[] = {
 
@@ -66,8 +70,8 @@ const AP_Param::GroupInfo AC_AutoTune_Heli::var_info[] = {
 
     // @Param: SEQ
     // @DisplayName: AutoTune Sequence Bitmask
-    // @Description: 2-byte bitmask to select what tuning should be performed.  Max gain automatically performed if Rate D is selected. Values: 7:All,1:VFF Only,2:Rate D/Rate P Only(incl max gain),4:Angle P Only,8:Max Gain Only,3:VFF and Rate D/Rate P(incl max gain),5:VFF and Angle P,6:Rate D/Rate P(incl max gain) and angle P
-    // @Bitmask: 0:VFF,1:Rate D/Rate P(incl max gain),2:Angle P,3:Max Gain Only
+    // @Description: 2-byte bitmask to select what tuning should be performed.  Max gain automatically performed if Rate D is selected. Multi-axis sweep replaces the rate frequency sweeps of each axis with a single sweep exciting all tuned axes at once. Values: 7:All,1:VFF Only,2:Rate D/Rate P Only(incl max gain),4:Angle P Only,8:Max Gain Only,3:VFF and Rate D/Rate P(incl max gain),5:VFF and Angle P,6:Rate D/Rate P(incl max gain) and angle P,23:All with multi-axis sweep
+    // @Bitmask: 0:VFF,1:Rate D/Rate P(incl max gain),2:Angle P,3:Max Gain Only,4:Multi-axis sweep
     // @User: Standard
     AP_GROUPINFO("SEQ", 2, AC_AutoTune_Heli, seq_bitmask,  3),
 
@@ -112,6 +116,9 @@ AC_AutoTune_Heli::AC_AutoTune_Heli()
 // initialize tests for each tune type
 void AC_AutoTune_Heli::test_init()
 {
+    multi_sweep_active = false;
+    multi_sweep_loaded = false;
+
     switch (tune_type) {
     case RFF_UP:
         rate_ff_test_init();
@@ -156,6 +163,17 @@ void AC_AutoTune_Heli::test_init()
                 }
             }
         }
+        // a single multi-axis sweep provides the rate sweep data for every axis
+        if ((seq_bitmask & AUTOTUNE_SEQ_BITMASK_MULTI_AXIS) && tune_type != RP_UP && !is_equal(start_freq,stop_freq)) {
+            if (!multi_sweep_complete) {
+                multi_sweep_test_init();
+                break;
+            }
+            if (multi_sweep_load(axis)) {
+                multi_sweep_loaded = true;
+                break;
+            }
+        }
         if (!is_equal(start_freq,stop_freq)) {
             // initialize determine_gain function whenever test is initialized
             freqresp.init(AC_AutoTune_FreqResp::InputType::SWEEP, AC_AutoTune_FreqResp::ResponseType::RATE);
@@ -243,6 +261,16 @@ void AC_AutoTune_Heli::test_run(AxisType test_axis, const float dir_sign)
         return;
     }
 
+    if (multi_sweep_active) {
+        multi_sweep_test_run();
+        return;
+    }
+    if (multi_sweep_loaded) {
+        // sweep data was already determined by the multi-axis sweep
+        step = UPDATE_GAINS;
+        return;
+    }
+
     switch (tune_type) {
     case RFF_UP:
         rate_ff_test_run(AUTOTUNE_HELI_TARGET_ANGLE_RLLPIT_CD, AUTOTUNE_HELI_TARGET_RATE_RLLPIT_CDS, dir_sign);
@@ -278,7 +306,9 @@ void AC_AutoTune_Heli::do_gcs_announcements()
     case RP_UP:
     case MAX_GAINS:
     case SP_UP:
-        if (is_equal(start_freq,stop_freq)) {
+        if (multi_sweep_active) {
+            gcs().send_text(MAV_SEVERITY_INFO, "AutoTune: Multi-axis Sweep");
+        } else if (is_equal(start_freq,stop_freq)) {
             gcs().send_text(MAV_SEVERITY_INFO, "AutoTune: Dwell");
         } else {
             gcs().send_text(MAV_SEVERITY_INFO, "AutoTune: Sweep");
@@ -369,6 +399,11 @@ void AC_AutoTune_Heli::backup_gains_and_initialise()
     start_freq = 0.0f;
     stop_freq = 0.0f;
 
+    // multi-axis sweep is run once per autotune
+    multi_sweep_active = false;
+    multi_sweep_complete = false;
+    multi_sweep_loaded = false;
+
     orig_bf_feedforward = attitude_control->get_bf_feedforward();
 
     // backup original pids and initialise tuned pid values
@@ -1151,6 +1186,221 @@ void AC_AutoTune_Heli::dwell_test_run(uint8_t freq_resp_input, float start_frq,
     }
 }
 
+// initialize the multi-axis sweep.  Every tuned axis is excited at once on its own set of frequencies
+void AC_AutoTune_Heli::multi_sweep_test_init()
+{
+    multi_sweep_active = true;
+    dwell_start_time_ms = 0.0f;
+    settle_time = 200;
+
+    // tuned axes are assigned consecutive multi-sine channels
+    uint8_t num_channels = 0;
+    for (uint8_t i = 0; i < 3; i++) {
+        if (axis_bitmask & (1U << i)) {
+            multi_sweep_channel[i] = num_channels++;
+        } else {
+            multi_sweep_channel[i] = MULTISINE_MAX_CHANNELS;
+        }
+        multi_sweep_cmd[i] = {};
+        multi_sweep_tgt[i] = {};
+    }
+
+    multisine_input.init(num_channels, min_sweep_freq, max_sweep_freq, 0.5f * AUTOTUNE_MULTI_SWEEP_SETTLE_S);
+    multi_freqresp.init();
+
+    // channels are only orthogonal over whole periods so analysis starts and ends on a period boundary
+    const float period = multisine_input.get_period();
+    multi_sweep_start_s = period * ceilf(AUTOTUNE_MULTI_SWEEP_SETTLE_S / period);
+    multi_sweep_end_s = multi_sweep_start_s + period * AUTOTUNE_MULTI_SWEEP_PERIODS;
+
+    filt_pit_roll_cd.set_cutoff_frequency(0.2f * min_sweep_freq);
+    filt_heading_error_cd.set_cutoff_frequency(0.2f * min_sweep_freq);
+    filt_att_fdbk_from_velxy_cd.set_cutoff_frequency(0.2f * min_sweep_freq);
+
+    // 4 seconds is added to allow aircraft to achieve start attitude
+    step_time_limit_ms = (uint32_t)(4000 + 1000.0f * multi_sweep_end_s);
+}
+
+// run the multi-axis sweep, holding attitude on all axes while adding the excitation to the rate targets
+void AC_AutoTune_Heli::multi_sweep_test_run()
+{
+    const uint32_t now = AP_HAL::millis();
+    const float att_hold_gain = 4.5f;
+
+    // keep controller from requesting too high of a rate
+    const float tgt_attitude = 2.5f * 0.01745f;
+    const float target_rate_mag_cds = MIN(min_sweep_freq * tgt_attitude * 5730.0f, 5000.0f);
+
+    // body frame calculation of velocity
+    Vector3f velocity_ned, velocity_bf;
+    if (ahrs_view->get_velocity_NED(velocity_ned)) {
+        velocity_bf.x = velocity_ned.x * ahrs_view->cos_yaw() + velocity_ned.y * ahrs_view->sin_yaw();
+        velocity_bf.y = -velocity_ned.x * ahrs_view->sin_yaw() + velocity_ned.y * ahrs_view->cos_yaw();
+    }
+
+    const Vector3f attitude_cd = Vector3f((float)ahrs_view->roll_sensor, (float)ahrs_view->pitch_sensor, (float)ahrs_view->yaw_sensor);
+    float excitation_cds[MULTISINE_MAX_CHANNELS] {};
+    const float test_time = (now - dwell_start_time_ms) * 0.001f;
+    if (settle_time == 0) {
+        multisine_input.update(test_time, target_rate_mag_cds, excitation_cds);
+        filt_pit_roll_cd.apply(Vector2f(attitude_cd.x,attitude_cd.y), AP::scheduler().get_loop_period_s());
+        filt_heading_error_cd.apply(wrap_180_cd(trim_attitude_cd.z - attitude_cd.z), AP::scheduler().get_loop_period_s());
+        const Vector2f att_fdbk {
+            -5730.0f * vel_hold_gain * velocity_bf.y,
+            5730.0f * vel_hold_gain * velocity_bf.x
+        };
+        filt_att_fdbk_from_velxy_cd.apply(att_fdbk, AP::scheduler().get_loop_period_s());
+    } else {
+        trim_attitude_cd = attitude_cd;
+        filt_pit_roll_cd.reset(Vector2f(attitude_cd.x,attitude_cd.y));
+        filt_heading_error_cd.reset(0.0f);
+        filt_att_fdbk_from_velxy_cd.reset(Vector2f(0.0f,0.0f));
+        dwell_start_time_ms = now;
+        settle_time--;
+    }
+
+    // limit rate correction for position hold
+    const Vector3f trim_rate_cds {
+        constrain_float(att_hold_gain * ((trim_attitude_cd.x + filt_att_fdbk_from_velxy_cd.get().x) - filt_pit_roll_cd.get().x), -15000.0f, 15000.0f),
+        constrain_float(att_hold_gain * ((trim_attitude_cd.y + filt_att_fdbk_from_velxy_cd.get().y) - filt_pit_roll_cd.get().y), -15000.0f, 15000.0f),
+        constrain_float(att_hold_gain * filt_heading_error_cd.get(), -15000.0f, 15000.0f)
+    };
+
+    // axes that are not excited hold attitude through the input shaping, excited axes have their rate target set directly
+    Vector3f input_rate_cds;
+    for (uint8_t i = 0; i < 3; i++) {
+        if (multi_sweep_channel[i] >= MULTISINE_MAX_CHANNELS) {
+            input_rate_cds[i] = trim_rate_cds[i];
+        }
+    }
+    attitude_control->input_rate_bf_roll_pitch_yaw(input_rate_cds.x, input_rate_cds.y, input_rate_cds.z);
+    if (multi_sweep_channel[ROLL] < MULTISINE_MAX_CHANNELS) {
+        attitude_control->rate_bf_roll_target(trim_rate_cds.x - excitation_cds[multi_sweep_channel[ROLL]]);
+    }
+    if (multi_sweep_channel[PITCH] < MULTISINE_MAX_CHANNELS) {
+        attitude_control->rate_bf_pitch_target(trim_rate_cds.y - excitation_cds[multi_sweep_channel[PITCH]]);
+    }
+    if (multi_sweep_channel[YAW] < MULTISINE_MAX_CHANNELS) {
+        attitude_control->rate_bf_yaw_target(trim_rate_cds.z - excitation_cds[multi_sweep_channel[YAW]]);
+    }
+
+    // correlate each axis over whole periods of the excitation.  Trim offsets are rejected by the correlation so no filtering is needed
+    if (settle_time == 0 && test_time >= multi_sweep_start_s && test_time < multi_sweep_end_s) {
+        const Vector3f gyro = ahrs_view->get_gyro();
+        const Vector3f tgt_rate = attitude_control->rate_bf_targets();
+        const float motor_cmd[3] {motors->get_roll(), motors->get_pitch(), motors->get_yaw()};
+        float command[MULTISINE_MAX_CHANNELS] {};
+        float tgt_resp[MULTISINE_MAX_CHANNELS] {};
+        float meas_resp[MULTISINE_MAX_CHANNELS] {};
+        for (uint8_t i = 0; i < 3; i++) {
+            const uint8_t ch = multi_sweep_channel[i];
+            if (ch < MULTISINE_MAX_CHANNELS) {
+                command[ch] = motor_cmd[i];
+                tgt_resp[ch] = tgt_rate[i];
+                meas_resp[ch] = gyro[i];
+            }
+        }
+        multi_freqresp.update(multisine_input, command, tgt_resp, meas_resp);
+    }
+
+    if (settle_time == 0 && test_time >= multi_sweep_end_s) {
+        multi_sweep_update_results();
+        multi_sweep_loaded = multi_sweep_load(axis);
+        if (!multi_sweep_loaded) {
+            // treat as a sweep that did not find the 180 deg phase frequency
+            reset_sweep_variables();
+        }
+        multi_sweep_active = false;
+        step = UPDATE_GAINS;
+    } else if (now - step_start_time_ms >= step_time_limit_ms) {
+        // we have passed the maximum stop time, tuning continues with single axis sweeps
+        multi_sweep_active = false;
+        multi_sweep_complete = true;
+        reset_sweep_variables();
+        step = UPDATE_GAINS;
+    }
+}
+
+// determine sweep data for every excited axis once the multi-axis sweep is complete
+void AC_AutoTune_Heli::multi_sweep_update_results()
+{
+    for (uint8_t i = 0; i < 3; i++) {
+        const uint8_t ch = multi_sweep_channel[i];
+        if (ch < MULTISINE_MAX_CHANNELS) {
+            multi_sweep_get_sweep_data(ch, AC_AutoTune_MultiFreqResp::COMMAND, multi_sweep_cmd[i]);
+            multi_sweep_get_sweep_data(ch, AC_AutoTune_MultiFreqResp::TARGET, multi_sweep_tgt[i]);
+        }
+    }
+    multi_sweep_complete = true;
+}
+
+// determine sweep data from one channel's frequency response, matching the data captured during a frequency sweep
+void AC_AutoTune_Heli::multi_sweep_get_sweep_data(uint8_t channel, AC_AutoTune_MultiFreqResp::InputType input, sweep_data &data) const
+{
+    // sweep captures the 180 deg and 270 deg phase data from the first cycle within 150-160 deg and 240-250 deg respectively
+    auto interpolate = [](const sweep_info &low, const sweep_info &high, float phase) {
+        sweep_info ret;
+        ret.freq = linear_interpolate(low.freq, high.freq, phase, low.phase, high.phase);
+        ret.gain = linear_interpolate(low.gain, high.gain, phase, low.phase, high.phase);
+        ret.phase = phase;
+        return ret;
+    };
+
+    data = {};
+    sweep_info prev {};
+    bool have_prev = false;
+    float phase_offset = 0.0f;
+    for (uint8_t j = 0; j < multisine_input.get_num_components(); j++) {
+        sweep_info curr;
+        if (!multi_freqresp.get_response(multisine_input, channel, j, input, curr.freq, curr.gain, curr.phase)) {
+            continue;
+        }
+        // unwrap so phase lag keeps increasing with frequency
+        curr.phase += phase_offset;
+        if (have_prev && curr.phase < prev.phase - 180.0f) {
+            curr.phase += 360.0f;
+            phase_offset += 360.0f;
+        }
+        if (have_prev && data.progress == 0 && prev.phase < 155.0f && curr.phase >= 155.0f) {
+            data.ph180 = interpolate(prev, curr, 155.0f);
+            data.progress = 1;
+        }
+        if (have_prev && data.progress == 1 && prev.phase < 245.0f && curr.phase >= 245.0f) {
+            data.ph270 = interpolate(prev, curr, 245.0f);
+            data.progress = 2;
+        }
+        if (curr.gain > data.maxgain.gain) {
+            data.maxgain = curr;
+        }
+        prev = curr;
+        have_prev = true;
+    }
+}
+
+// load the sweep data for the current tune type from the multi-axis sweep results, returns false if none were found
+bool AC_AutoTune_Heli::multi_sweep_load(AxisType test_axis)
+{
+    // max gains uses the response to the command, rate D up the response to the target rate.
+    // The target rate response was measured with the gains in use during the multi-axis sweep so only
+    // provides the starting frequency for the dwells that follow
+    const bool use_cmd = (tune_type == MAX_GAINS);
+    const sweep_data &data = use_cmd ? multi_sweep_cmd[test_axis] : multi_sweep_tgt[test_axis];
+    if (is_zero(data.ph180.freq)) {
+        return false;
+    }
+    sweep = data;
+
+    // log the frequency response for this axis as the sweep would have
+    const AC_AutoTune_MultiFreqResp::InputType input = use_cmd ? AC_AutoTune_MultiFreqResp::COMMAND : AC_AutoTune_MultiFreqResp::TARGET;
+    for (uint8_t j = 0; j < multisine_input.get_num_components(); j++) {
+        float freq, gain, phase;
+        if (multi_freqresp.get_response(multisine_input, multi_sweep_channel[test_axis], j, input, freq, gain, phase)) {
+            Log_Write_AutoTuneSweep(freq, gain, phase);
+        }
+    }
+    return true;
+}
+
 // update gains for the rate p up tune type
 void AC_AutoTune_Heli::updating_rate_p_up_all(AxisType test_axis)
 {
@@ -20,6 +20,8 @@
 
 #include "AC_AutoTune.h"
 #include <AP_Math/chirp.h>
+#include <AP_Math/multisine.h>
+#include "AC_AutoTune_MultiFreqResp.h"
 #include <GCS_MAVLink/GCS.h>
 
 #include <AP_Scheduler/AP_Scheduler.h>
@@ -279,6 +281,26 @@ private:
     };
     sweep_data sweep;
 
+    // multi-axis sweep excites every tuned axis at once and derives each axis' sweep data from the same window
+    void multi_sweep_test_init();
+    void multi_sweep_test_run();
+
+    // determine sweep data for every excited axis once the multi-axis sweep is complete
+    void multi_sweep_update_results();
+    void multi_sweep_get_sweep_data(uint8_t channel, AC_AutoTune_MultiFreqResp::InputType input, sweep_data &data) const;
+
+    // load the sweep data for the current tune type from the multi-axis sweep results, returns false if none were found
+    bool multi_sweep_load(AxisType test_axis);
+
+    bool     multi_sweep_active;                    // true while the multi-axis sweep is running
+    bool     multi_sweep_complete;                  // true once the multi-axis sweep has been run for this autotune
+    bool     multi_sweep_loaded;                    // true if the current test's sweep was replaced with multi-axis sweep results
+    uint8_t  multi_sweep_channel[3];                // multi-sine channel used for each axis, MULTISINE_MAX_CHANNELS if not excited
+    float    multi_sweep_start_s;                   // time in seconds after start of excitation that analysis starts
+    float    multi_sweep_end_s;                     // time in seconds after start of excitation that analysis ends
+    sweep_data multi_sweep_cmd[3];                  // per axis sweep data of the response to the command, used by max gains
+    sweep_data multi_sweep_tgt[3];                  // per axis sweep data of the response to the target rate, used by rate D up
+
     // fix the frequency sweep time to 23 seconds
     const float sweep_time_ms = 23000;
 
@@ -295,4 +317,8 @@ private:
     AC_AutoTune_FreqResp freqresp;
 
     Chirp chirp_input;
+
+    // multi-sine input and frequency response object for the multi-axis sweep
+    MultiSine multisine_input;
+    AC_AutoTune_MultiFreqResp multi_freqresp;
 };
@@ -0,0 +1,54 @@
+/*
+This library receives time history data from all axes during a simultaneous multi-sine test and determines the gain and phase of each axis' response at each of the frequencies that axis was excited at.  Each axis is excited on its own set of harmonics of a common fundamental, so correlating an axis' signals against its own harmonics over whole periods rejects the excitation of the other axes.  The init function must be used when initializing the test and the data should only be read after a whole number of periods of the excitation have been accumulated.
+*/
+
+#include <AP_HAL/AP_HAL.h>
+#include "AC_AutoTune_MultiFreqResp.h"
+
+// Initialize the object, clearing all accumulated data
+void AC_AutoTune_MultiFreqResp::init()
+{
+    memset(cmd, 0, sizeof(cmd));
+    memset(tgt, 0, sizeof(tgt));
+    memset(meas, 0, sizeof(meas));
+    sample_count = 0;
+}
+
+// Correlate one sample of each channel's signals against the excitation's basis
+void AC_AutoTune_MultiFreqResp::update(const MultiSine &excitation, const float *command, const float *tgt_resp, const float *meas_resp)
+{
+    for (uint8_t c = 0; c < excitation.get_num_channels(); c++) {
+        for (uint8_t j = 0; j < excitation.get_num_components(); j++) {
+            const float s = excitation.get_basis_sin(c, j);
+            const float co = excitation.get_basis_cos(c, j);
+            cmd[c][j].re += command[c] * co;
+            cmd[c][j].im -= command[c] * s;
+            tgt[c][j].re += tgt_resp[c] * co;
+            tgt[c][j].im -= tgt_resp[c] * s;
+            meas[c][j].re += meas_resp[c] * co;
+            meas[c][j].im -= meas_resp[c] * s;
+        }
+    }
+    sample_count++;
+}
+
+// Frequency response of a channel's measured response to the command or target at one of its components
+bool AC_AutoTune_MultiFreqResp::get_response(const MultiSine &excitation, uint8_t channel, uint8_t component, InputType input, float &freq, float &gain, float &phase) const
+{
+    if (channel >= excitation.get_num_channels() || component >= excitation.get_num_components()) {
+        return false;
+    }
+
+    const fourier &in = (input == COMMAND) ? cmd[channel][component] : tgt[channel][component];
+    const fourier &out = meas[channel][component];
+    const float in_mag = norm(in.re, in.im);
+    if (!is_positive(in_mag)) {
+        return false;
+    }
+
+    freq = excitation.get_frequency_rads(channel, component);
+    gain = norm(out.re, out.im) / in_mag;
+    // phase lag of the measured response in degrees
+    phase = wrap_360(degrees(atan2f(in.im, in.re) - atan2f(out.im, out.re)));
+    return true;
+}
@@ -0,0 +1,50 @@
+#pragma once
+
+/*
+ Gain and phase determination for simultaneous multi-axis multi-sine excitation
+*/
+
+#include <AP_Math/AP_Math.h>
+#include <AP_Math/multisine.h>
+
+class AC_AutoTune_MultiFreqResp {
+public:
+    // Constructor
+    AC_AutoTune_MultiFreqResp()
+{
+}
+
+    // Enumeration of the input the response is measured against
+    enum InputType {
+        COMMAND = 0,
+        TARGET = 1,
+    };
+
+    // Initialize the object, clearing all accumulated data.
+    // Must be called before each multi-sine test
+    void init();
+
+    // Correlate one sample of each channel's command, target and measured response against the
+    // excitation's basis.  excitation must have been updated for the time of this sample
+    void update(const MultiSine &excitation, const float *command, const float *tgt_resp, const float *meas_resp);
+
+    // number of samples accumulated since init
+    uint32_t get_sample_count() const { return sample_count; }
+
+    // Frequency response of a channel's measured response to the command or target at one of its components.
+    // returns false if the input had no content at that frequency
+    bool get_response(const MultiSine &excitation, uint8_t channel, uint8_t component, InputType input, float &freq, float &gain, float &phase) const;
+
+private:
+    // running Fourier coefficients at one component frequency
+    struct fourier {
+        float re;
+        float im;
+    };
+
+    fourier cmd[MULTISINE_MAX_CHANNELS][MULTISINE_MAX_COMPONENTS];
+    fourier tgt[MULTISINE_MAX_CHANNELS][MULTISINE_MAX_COMPONENTS];
+    fourier meas[MULTISINE_MAX_CHANNELS][MULTISINE_MAX_COMPONENTS];
+
+    uint32_t sample_count;
+};
@@ -1,6 +1,7 @@
 #include "AC_Avoid.h"
 #include "AP_OADijkstra.h"
 #include "AP_OABendyRuler.h"
+#include "AP_OAPathPlanner.h"
 #include <AP_Logger/AP_Logger.h>
 
 void AP_OABendyRuler::Write_OABendyRuler(const uint8_t type, const bool active, const float target_yaw, const float target_pitch, const bool resist_chg, const float margin, const Location &final_dest, const Location &oa_dest) const
@@ -59,6 +60,18 @@ void AP_OADijkstra::Write_Visgraph_point(const uint8_t version, const uint8_t po
     AP::logger().WriteBlock(&pkt, sizeof(pkt));
 }
 
+void AP_OAPathPlanner::Write_OAPathPlanner(const OAPathPlannerUsed path_planner_used, const OA_RetState ret_state, const uint32_t request_age_ms, const uint32_t compute_us) const
+{
+    const struct log_OAPathPlanner pkt{
+        LOG_PACKET_HEADER_INIT(LOG_OA_PATHPLANNER_MSG),
+        time_us           : AP_HAL::micros64(),
+        path_planner_used : (uint8_t)path_planner_used,
+        ret_state         : (uint8_t)ret_state,
+        request_age_ms    : request_age_ms,
+        compute_us        : compute_us,
+    };
+    AP::logger().WriteBlock(&pkt, sizeof(pkt));
+}
 
 void AC_Avoid::Write_SimpleAvoidance(const uint8_t state, const Vector3f& desired_vel, const Vector3f& modified_vel, const bool back_up) const
 {
@@ -147,25 +147,43 @@ bool AP_OABendyRuler::search_xy_path(const Location& current_loc, const Location
     float best_margin = -FLT_MAX;
     float best_margin_bearing = best_bearing;
 
-    for (uint8_t i = 0; i <= (170 / OA_BENDYRULER_BEARING_INC_XY); i++) {
-        for (uint8_t bdir = 0; bdir <= 1; bdir++) {
-            // skip duplicate check of bearing straight towards destination
-            if ((i==0) && (bdir > 0)) {
-                continue;
-            }
+    // probes are numbered in the order they are checked, alternating left and right of the bearing to the destination
+    const uint8_t num_probes = 1 + 2 * (170 / OA_BENDYRULER_BEARING_INC_XY);
+
+    // the margins of a batch of probes are calculated together.  the first batch is only the bearing straight
+    // towards the destination because the search usually ends there when there are no obstacles in the way
+    uint8_t batch_size = 1;
+    for (uint8_t batch_start = 0; batch_start < num_probes; batch_start += batch_size) {
+        if (batch_start > 0) {
+            batch_size = MIN(OA_BENDYRULER_PROBE_BATCH, num_probes - batch_start);
+        }
+
+        // test locations are projected from current location at each test bearing
+        float bearings[OA_BENDYRULER_PROBE_BATCH];
+        Location test_locs[OA_BENDYRULER_PROBE_BATCH];
+        float margins[OA_BENDYRULER_PROBE_BATCH];
+        for (uint8_t k = 0; k < batch_size; k++) {
             // bearing that we are probing
-            const float bearing_delta = i * OA_BENDYRULER_BEARING_INC_XY * (bdir == 0 ? -1.0f : 1.0f);
-            const float bearing_test = wrap_180(bearing_to_dest + bearing_delta);
+            const uint8_t probe = batch_start + k;
+            const uint8_t i = (probe + 1) / 2;
+            const float bearing_delta = i * OA_BENDYRULER_BEARING_INC_XY * ((probe % 2) == 1 ? -1.0f : 1.0f);
+            bearings[k] = wrap_180(bearing_to_dest + bearing_delta);
 
             // ToDo: add effective groundspeed calculations using airspeed
             // ToDo: add prediction of vehicle's position change as part of turn to desired heading
 
-            // test location is projected from current location at test bearing
-            Location test_loc = current_loc;
-            test_loc.offset_bearing(bearing_test, lookahead_step1_dist);
+            test_locs[k] = current_loc;
+            test_locs[k].offset_bearing(bearings[k], lookahead_step1_dist);
+        }
 
-            // calculate margin from obstacles for this scenario
-            float margin = calc_avoidance_margin(current_loc, test_loc, proximity_only);
+        // calculate margin from obstacles for each scenario
+        calc_avoidance_margins(current_loc, test_locs, batch_size, proximity_only, margins);
+
+        for (uint8_t k = 0; k < batch_size; k++) {
+            const uint8_t i = (batch_start + k + 1) / 2;
+            const float bearing_test = bearings[k];
+            const Location &test_loc = test_locs[k];
+            const float margin = margins[k];
             if (margin > best_margin) {
                 best_margin_bearing = bearing_test;
                 best_margin = margin;
@@ -453,6 +471,25 @@ float AP_OABendyRuler::calc_avoidance_margin(const Location &start, const Locati
     return margin_min;
 }
 
+// calculate minimum distance between each of a batch of paths from a common start and any obstacle
+// the altitude fence is not checked because batches are only used by the horizontal search
+void AP_OABendyRuler::calc_avoidance_margins(const Location &start, const Location *ends, uint8_t num_ends, bool proximity_only, float *margins) const
+{
+    num_ends = MIN(num_ends, OA_BENDYRULER_PROBE_BATCH);
+    for (uint8_t i = 0; i < num_ends; i++) {
+        margins[i] = FLT_MAX;
+    }
+
+    // fences are checked first so their margins can be used to reject distant obstacles
+    if (!proximity_only) {
+        calc_margins_from_circular_fence(start, ends, num_ends, margins);
+        calc_margins_from_inclusion_and_exclusion_polygons(start, ends, num_ends, margins);
+        calc_margins_from_inclusion_and_exclusion_circles(start, ends, num_ends, margins);
+    }
+
+    calc_margins_from_object_database(start, ends, num_ends, margins);
+}
+
 // calculate minimum distance between a path and the circular fence (centered on home)
 // on success returns true and updates margin
 bool AP_OABendyRuler::calc_margin_from_circular_fence(const Location &start, const Location &end, float &margin) const
@@ -669,6 +706,203 @@ bool AP_OABendyRuler::calc_margin_from_inclusion_and_exclusion_circles(const Loc
 #endif // AP_FENCE_ENABLED
 }
 
+// reduce margins to the minimum distance between each path and the circular fence (centered on home)
+void AP_OABendyRuler::calc_margins_from_circular_fence(const Location &start, const Location *ends, uint8_t num_ends, float *margins) const
+{
+#if AP_FENCE_ENABLED
+    const AC_Fence *fence = AC_Fence::get_singleton();
+    if (fence == nullptr) {
+        return;
+    }
+    if ((fence->get_enabled_fences() & AC_FENCE_TYPE_CIRCLE) == 0) {
+        return;
+    }
+
+    // start's distance from home is shared by all paths
+    const Location &ahrs_home = AP::ahrs().get_home();
+    const float start_dist_sq = ahrs_home.get_distance_NE(start).length_squared();
+    const float fence_radius_plus_margin = fence->get_radius() - fence->get_margin();
+
+    for (uint8_t i = 0; i < num_ends; i++) {
+        const float end_dist_sq = ahrs_home.get_distance_NE(ends[i]).length_squared();
+        margins[i] = MIN(margins[i], fence_radius_plus_margin - sqrtf(MAX(start_dist_sq, end_dist_sq)));
+    }
+#endif // AP_FENCE_ENABLED
+}
+
+// reduce margins to the minimum distance between each path and all inclusion and exclusion polygons
+void AP_OABendyRuler::calc_margins_from_inclusion_and_exclusion_polygons(const Location &start, const Location *ends, uint8_t num_ends, float *margins) const
+{
+#if AP_FENCE_ENABLED
+    const AC_Fence *fence = AC_Fence::get_singleton();
+    if (fence == nullptr) {
+        return;
+    }
+
+    // exclusion polygons enabled along with polygon fences
+    if ((fence->get_enabled_fences() & AC_FENCE_TYPE_POLYGON) == 0) {
+        return;
+    }
+
+    // return immediately if no inclusion nor exclusion polygons
+    const uint8_t num_inclusion_polygons = fence->polyfence().get_inclusion_polygon_count();
+    const uint8_t num_exclusion_polygons = fence->polyfence().get_exclusion_polygon_count();
+    if ((num_inclusion_polygons == 0) && (num_exclusion_polygons == 0)) {
+        return;
+    }
+
+    // convert start and ends to offsets from EKF origin
+    Vector2f start_NE;
+    Vector2f ends_NE[OA_BENDYRULER_PROBE_BATCH];
+    if (!start.get_vector_xy_from_origin_NE(start_NE)) {
+        return;
+    }
+    for (uint8_t i = 0; i < num_ends; i++) {
+        if (!ends[i].get_vector_xy_from_origin_NE(ends_NE[i])) {
+            return;
+        }
+    }
+
+    // get fence margin
+    const float fence_margin = fence->get_margin();
+
+    for (uint16_t p = 0; p < num_inclusion_polygons + num_exclusion_polygons; p++) {
+        uint16_t num_points;
+        const bool inclusion = (p < num_inclusion_polygons);
+        const Vector2f* boundary = inclusion ? fence->polyfence().get_inclusion_polygon(p, num_points) : fence->polyfence().get_exclusion_polygon(p - num_inclusion_polygons, num_points);
+        if ((boundary == nullptr) || (num_points == 0)) {
+            continue;
+        }
+
+        // all paths share the same start so whether it is outside the polygon is only calculated once
+        // if outside an inclusion polygon or inside an exclusion polygon the margin's sign is reversed
+        const bool start_outside = Polygon_outside(start_NE, boundary, num_points);
+        const bool reversed = (start_outside == inclusion);
+
+        for (uint8_t i = 0; i < num_ends; i++) {
+            const Vector2f &end_NE = ends_NE[i];
+
+            // paths crossing the boundary have a negative distance from the crossing to the end of the path
+            Vector2f intersection;
+            float dist_cm;
+            if (Polygon_intersects(boundary, num_points, start_NE, end_NE, intersection)) {
+                dist_cm = -sqrtf(sq(intersection.x - end_NE.x) + sq(intersection.y - end_NE.y));
+            } else {
+                // edges whose bounding box is further than this from the path's bounding box cannot reduce the margin
+                // the margin increases as the distance decreases when the sign is reversed so no edge can be rejected
+                const float reject_dist_cm = reversed ? FLT_MAX : (margins[i] + fence_margin) * 100.0f;
+                const Vector2f path_min {MIN(start_NE.x, end_NE.x), MIN(start_NE.y, end_NE.y)};
+                const Vector2f path_max {MAX(start_NE.x, end_NE.x), MAX(start_NE.y, end_NE.y)};
+                float closest_sq = FLT_MAX;
+                for (uint16_t j = 0; j < num_points - 1; j++) {
+                    const Vector2f &v1 = boundary[j];
+                    const Vector2f &v2 = boundary[j+1];
+                    const float gap_x = MAX(MAX(MIN(v1.x, v2.x) - path_max.x, path_min.x - MAX(v1.x, v2.x)), 0.0f);
+                    const float gap_y = MAX(MAX(MIN(v1.y, v2.y) - path_max.y, path_min.y - MAX(v1.y, v2.y)), 0.0f);
+                    if ((gap_x >= reject_dist_cm) || (gap_y >= reject_dist_cm)) {
+                        continue;
+                    }
+                    closest_sq = MIN(closest_sq, Vector2f::closest_distance_between_lines_squared(v1, v2, start_NE, end_NE));
+                }
+                dist_cm = sqrtf(closest_sq);
+            }
+
+            // calculate min distance (in meters) from line to polygon
+            const float sign = reversed ? -1.0f : 1.0f;
+            margins[i] = MIN(margins[i], (sign * dist_cm * 0.01f) - fence_margin);
+        }
+    }
+#endif // AP_FENCE_ENABLED
+}
+
+// reduce margins to the minimum distance between each path and all inclusion and exclusion circles
+void AP_OABendyRuler::calc_margins_from_inclusion_and_exclusion_circles(const Location &start, const Location *ends, uint8_t num_ends, float *margins) const
+{
+#if AP_FENCE_ENABLED
+    const AC_Fence *fence = AC_Fence::get_singleton();
+    if (fence == nullptr) {
+        return;
+    }
+
+    // inclusion/exclusion circles enabled along with polygon fences
+    if ((fence->get_enabled_fences() & AC_FENCE_TYPE_POLYGON) == 0) {
+        return;
+    }
+
+    // return immediately if no inclusion nor exclusion circles
+    const uint8_t num_inclusion_circles = fence->polyfence().get_inclusion_circle_count();
+    const uint8_t num_exclusion_circles = fence->polyfence().get_exclusion_circle_count();
+    if ((num_inclusion_circles == 0) && (num_exclusion_circles == 0)) {
+        return;
+    }
+
+    // convert start and ends to offsets from EKF origin
+    Vector2f start_NE;
+    Vector2f ends_NE[OA_BENDYRULER_PROBE_BATCH];
+    if (!start.get_vector_xy_from_origin_NE(start_NE)) {
+        return;
+    }
+    for (uint8_t i = 0; i < num_ends; i++) {
+        if (!ends[i].get_vector_xy_from_origin_NE(ends_NE[i])) {
+            return;
+        }
+    }
+
+    // get fence margin
+    const float fence_margin = fence->get_margin();
+
+    // inclusion circles: margin is fence radius minus the longer of start or end distance
+    for (uint8_t c = 0; c < num_inclusion_circles; c++) {
+        Vector2f center_pos_cm;
+        float radius;
+        if (fence->polyfence().get_inclusion_circle(c, center_pos_cm, radius)) {
+            const float start_dist_sq = (start_NE - center_pos_cm).length_squared();
+            for (uint8_t i = 0; i < num_ends; i++) {
+                const float end_dist_sq = (ends_NE[i] - center_pos_cm).length_squared();
+                margins[i] = MIN(margins[i], (radius + fence_margin) - (sqrtf(MAX(start_dist_sq, end_dist_sq)) * 0.01f));
+            }
+        }
+    }
+
+    // exclusion circles: margin is distance to the center minus the radius
+    for (uint8_t c = 0; c < num_exclusion_circles; c++) {
+        Vector2f center_pos_cm;
+        float radius;
+        if (fence->polyfence().get_exclusion_circle(c, center_pos_cm, radius)) {
+            for (uint8_t i = 0; i < num_ends; i++) {
+                const float dist_cm = Vector2f::closest_distance_between_line_and_point(start_NE, ends_NE[i], center_pos_cm);
+                margins[i] = MIN(margins[i], (dist_cm * 0.01f) - (radius + fence_margin));
+            }
+        }
+    }
+#endif // AP_FENCE_ENABLED
+}
+
+// reduce margins to the minimum distance between each path and proximity sensor obstacles
+void AP_OABendyRuler::calc_margins_from_object_database(const Location &start, const Location *ends, uint8_t num_ends, float *margins) const
+{
+    AP_OADatabase *oaDb = AP::oadatabase();
+    if (oaDb == nullptr || !oaDb->healthy()) {
+        return;
+    }
+
+    // convert start and ends to offsets (in meters) from EKF origin
+    Vector3f start_NEU;
+    Vector3f ends_NEU[OA_BENDYRULER_PROBE_BATCH];
+    if (!start.get_vector_from_origin_NEU(start_NEU)) {
+        return;
+    }
+    for (uint8_t i = 0; i < num_ends; i++) {
+        if (!ends[i].get_vector_from_origin_NEU(ends_NEU[i])) {
+            return;
+        }
+        ends_NEU[i] *= 0.01f;
+    }
+
+    // all paths are checked in a single pass over the database
+    IGNORE_RETURN(oaDb->get_min_margins_to_segments(start_NEU * 0.01f, ends_NEU, num_ends, margins));
+}
+
 // calculate minimum distance between a path and proximity sensor obstacles
 // on success returns true and updates margin
 bool AP_OABendyRuler::calc_margin_from_object_database(const Location &start, const Location &end, float &margin) const
@@ -688,23 +922,7 @@ bool AP_OABendyRuler::calc_margin_from_object_database(const Location &start, co
         return false;
     }
 
-    // check each obstacle's distance from segment
-    float smallest_margin = FLT_MAX;
-    for (uint16_t i=0; i<oaDb->database_count(); i++) {
-        const AP_OADatabase::OA_DbItem& item = oaDb->get_item(i);
-        const Vector3f point_cm = item.pos * 100.0f;
-        // margin is distance between line segment and obstacle minus obstacle's radius
-        const float m = Vector3f::closest_distance_between_line_and_point(start_NEU, end_NEU, point_cm) * 0.01f - item.radius;
-        if (m < smallest_margin) {
-            smallest_margin = m;
-        }
-    }
-
-    // return smallest margin
-    if (smallest_margin < FLT_MAX) {
-        margin = smallest_margin;
-        return true;
-    }
-
-    return false;
+    // margin is distance between line segment and nearest obstacle minus obstacle's radius
+    // the database only searches the obstacles near the segment
+    return oaDb->get_min_margin_to_segment(start_NEU * 0.01f, end_NEU * 0.01f, margin);
 }
@@ -4,6 +4,8 @@
 #include <AP_Common/Location.h>
 #include <AP_Math/AP_Math.h>
 
+#define OA_BENDYRULER_PROBE_BATCH   16      // maximum number of paths whose margins are calculated together
+
 /*
  * BendyRuler avoidance algorithm for avoiding the polygon and circular fence and dynamic objects detected by the proximity sensor
  */
@@ -42,6 +44,10 @@ private:
     // calculate minimum distance between a path and any obstacle
     float calc_avoidance_margin(const Location &start, const Location &end, bool proximity_only) const;
 
+    // calculate minimum distance between each of a batch of paths from a common start and any obstacle
+    // each set of obstacles is checked against all paths in a single pass.  num_ends must be no more than OA_BENDYRULER_PROBE_BATCH
+    void calc_avoidance_margins(const Location &start, const Location *ends, uint8_t num_ends, bool proximity_only, float *margins) const;
+
     // determine if BendyRuler should accept the new bearing or try and resist it. Returns true if bearing is not changed  
     bool resist_bearing_change(const Location &destination, const Location &current_loc, bool active, float bearing_test, float lookahead_step1_dist, float margin, Location &prev_dest, float &prev_bearing, float &final_bearing, float &final_margin, bool proximity_only) const;    
 
@@ -65,6 +71,12 @@ private:
     // on success returns true and updates margin
     bool calc_margin_from_object_database(const Location &start, const Location &end, float &margin) const;
 
+    // batched versions of the above for paths from a common start. margins are reduced to the minimum distance from each path
+    void calc_margins_from_circular_fence(const Location &start, const Location *ends, uint8_t num_ends, float *margins) const;
+    void calc_margins_from_inclusion_and_exclusion_polygons(const Location &start, const Location *ends, uint8_t num_ends, float *margins) const;
+    void calc_margins_from_inclusion_and_exclusion_circles(const Location &start, const Location *ends, uint8_t num_ends, float *margins) const;
+    void calc_margins_from_object_database(const Location &start, const Location *ends, uint8_t num_ends, float *margins) const;
+
     // Logging function
     void Write_OABendyRuler(const uint8_t type, const bool active, const float target_yaw, const float target_pitch, const bool resist_chg, const float margin, const Location &final_dest, const Location &oa_dest) const;
 
@@ -36,6 +36,14 @@ extern const AP_HAL::HAL& hal;
     #define AP_OADATABASE_DISTANCE_FROM_HOME 3
 #endif
 
+#ifndef AP_OADATABASE_GRID_CELL_SIZE
+    #define AP_OADATABASE_GRID_CELL_SIZE 4.0f       // width in meters of the grid cells used to find nearby items
+#endif
+
+#define AP_OADATABASE_GRID_BUCKETS_MAX  4096        // maximum number of grid hash buckets
+#define AP_OADATABASE_GRID_NONE         UINT16_MAX  // marks the end of a bucket's list of items
+#define AP_OADATABASE_MARGIN_TOLERANCE  0.01f       // meters added to margin bounds used to reject items so rounding never rejects the closest item
+
 const AP_Param::GroupInfo AP_OADatabase::var_info[] = {
 
     // @Param: SIZE
@@ -173,10 +181,7 @@ void AP_OADatabase::queue_push(const Vector3f &pos, uint32_t timestamp_ms, float
     }
 
     const OA_DbItem item = {pos, timestamp_ms, MAX(_radius_min, distance * dist_to_radius_scalar), 0, AP_OADatabase::OA_DbItemImportance::Normal};
-    {
-        WITH_SEMAPHORE(_queue.sem);
-        _queue.items->push(item);
-    }
+    _queue.items->push(item);
 }
 
 void AP_OADatabase::init_queue()
@@ -186,7 +191,7 @@ void AP_OADatabase::init_queue()
         return;
     }
 
-    _queue.items = new ObjectBuffer<OA_DbItem>(_queue.size);
+    _queue.items = new ObjectBuffer_MPSC<OA_DbItem>(_queue.size);
     if (_queue.items != nullptr && _queue.items->get_size() == 0) {
         // allocation failed
         delete _queue.items;
@@ -202,6 +207,40 @@ void AP_OADatabase::init_database()
     }
 
     _database.items = new OA_DbItem[_database.size];
+
+    init_grid();
+}
+
+// allocate the spatial hash.  on failure the database falls back to searching every item
+void AP_OADatabase::init_grid()
+{
+    if (_database.items == nullptr) {
+        return;
+    }
+
+    // one bucket for every two items rounded up to a power of two
+    uint16_t num_buckets = 16;
+    while ((num_buckets < _database.size / 2) && (num_buckets < AP_OADATABASE_GRID_BUCKETS_MAX)) {
+        num_buckets *= 2;
+    }
+
+    _grid.bucket_head = new uint16_t[num_buckets];
+    _grid.next = new uint16_t[_database.size];
+    _grid.cell = new GridCell[_database.size];
+    if ((_grid.bucket_head == nullptr) || (_grid.next == nullptr) || (_grid.cell == nullptr)) {
+        delete[] _grid.bucket_head;
+        delete[] _grid.next;
+        delete[] _grid.cell;
+        _grid.bucket_head = nullptr;
+        _grid.next = nullptr;
+        _grid.cell = nullptr;
+        return;
+    }
+
+    for (uint16_t i = 0; i < num_buckets; i++) {
+        _grid.bucket_head[i] = AP_OADATABASE_GRID_NONE;
+    }
+    _grid.num_buckets = num_buckets;
 }
 
 // get bitmask of gcs channels item should be sent to based on its importance
@@ -249,29 +288,17 @@ bool AP_OADatabase::process_queue()
 
     for (uint16_t queue_index=0; queue_index<queue_available; queue_index++) {
         OA_DbItem item;
-
-        bool pop_success;
-        {
-            WITH_SEMAPHORE(_queue.sem);
-            pop_success = _queue.items->pop(item);
-        }
-        if (!pop_success) {
+        if (!_queue.items->pop(item)) {
             return false;
         }
 
         item.send_to_gcs = get_send_to_gcs_flags(item.importance);
 
-        // compare item to all items in database. If found a similar item, update the existing, else add it as a new one
-        bool found = false;
-        for (uint16_t i=0; i<_database.count; i++) {
-            if (is_close_to_item_in_database(i, item)) {
-                database_item_refresh(i, item.timestamp_ms, item.radius);
-                found = true;
-                break;
-            }
-        }
-
-        if (!found) {
+        // compare item to nearby items in database. If found a similar item, update the existing, else add it as a new one
+        uint16_t index;
+        if (find_item_within_radius(item.pos, item.radius, index)) {
+            database_item_refresh(index, item.timestamp_ms, item.radius);
+        } else {
             database_item_add(item);
         }
     }
@@ -285,6 +312,7 @@ void AP_OADatabase::database_item_add(const OA_DbItem &item)
     }
     _database.items[_database.count] = item;
     _database.items[_database.count].send_to_gcs = get_send_to_gcs_flags(_database.items[_database.count].importance);
+    grid_add(_database.count);
     _database.count++;
 }
 
@@ -295,6 +323,8 @@ void AP_OADatabase::database_item_remove(const uint16_t index)
         return;
     }
 
+    grid_remove(index);
+
     // radius of 0 tells the GCS we don't care about it any more (aka it expired)
     _database.items[index].radius = 0;
     _database.items[index].send_to_gcs = get_send_to_gcs_flags(_database.items[index].importance);
@@ -306,8 +336,10 @@ void AP_OADatabase::database_item_remove(const uint16_t index)
 
     if (index != _database.count) {
         // copy last object in array over expired object
+        grid_remove(_database.count);
         _database.items[index] = _database.items[_database.count];
         _database.items[index].send_to_gcs = get_send_to_gcs_flags(_database.items[index].importance);
+        grid_add(index);
     }
 }
 
@@ -328,6 +360,7 @@ void AP_OADatabase::database_item_refresh(const uint16_t index, const uint32_t t
         _database.items[index].timestamp_ms = timestamp_ms;
         _database.items[index].radius = radius;
         _database.items[index].send_to_gcs = get_send_to_gcs_flags(_database.items[index].importance);
+        _grid.radius_max = MAX(_grid.radius_max, radius);
     }
 }
 
@@ -344,13 +377,20 @@ void AP_OADatabase::database_items_remove_all_expired()
     const uint32_t now_ms = AP_HAL::millis();
     const uint32_t expiry_ms = (uint32_t)_database_expiry_seconds * 1000;
     uint16_t index = 0;
+    bool removed = false;
     while (index < _database.count) {
         if (now_ms - _database.items[index].timestamp_ms > expiry_ms) {
             database_item_remove(index);
+            removed = true;
         } else {
             index++;
         }
     }
+
+    // shrink the grid's search area to the remaining items
+    if (removed) {
+        grid_update_bounds();
+    }
 }
 
 // returns true if a similar object already exists in database. When true, the object timer is also reset
@@ -365,6 +405,267 @@ bool AP_OADatabase::is_close_to_item_in_database(const uint16_t index, const OA_
     return ((distance_sq < sq(item.radius)) || (distance_sq < sq(_database.items[index].radius)));
 }
 
+// convert a horizontal position in meters to a grid cell coordinate
+int16_t AP_OADatabase::grid_coord(float pos) const
+{
+    return (int16_t)constrain_float(floorf(pos / AP_OADATABASE_GRID_CELL_SIZE), INT16_MIN + 1, INT16_MAX - 1);
+}
+
+// returns the bucket holding the items in a cell
+uint16_t AP_OADatabase::grid_bucket(int16_t x, int16_t y) const
+{
+    const uint32_t hash = ((uint32_t)(uint16_t)x * 73856093U) ^ ((uint32_t)(uint16_t)y * 19349663U);
+    return hash & (_grid.num_buckets - 1);
+}
+
+// add an item to the grid
+void AP_OADatabase::grid_add(uint16_t index)
+{
+    if (!grid_healthy()) {
+        return;
+    }
+
+    const OA_DbItem &item = _database.items[index];
+    const GridCell cell {grid_coord(item.pos.x), grid_coord(item.pos.y)};
+    const uint16_t bucket = grid_bucket(cell.x, cell.y);
+    _grid.cell[index] = cell;
+    _grid.next[index] = _grid.bucket_head[bucket];
+    _grid.bucket_head[bucket] = index;
+
+    // expand occupied bounds
+    if (_database.count == 0) {
+        _grid.min = cell;
+        _grid.max = cell;
+        _grid.radius_max = item.radius;
+    } else {
+        _grid.min.x = MIN(_grid.min.x, cell.x);
+        _grid.min.y = MIN(_grid.min.y, cell.y);
+        _grid.max.x = MAX(_grid.max.x, cell.x);
+        _grid.max.y = MAX(_grid.max.y, cell.y);
+        _grid.radius_max = MAX(_grid.radius_max, item.radius);
+    }
+}
+
+// remove an item from the grid
+void AP_OADatabase::grid_remove(uint16_t index)
+{
+    if (!grid_healthy()) {
+        return;
+    }
+
+    // unlink item from its bucket's list
+    uint16_t *link = &_grid.bucket_head[grid_bucket(_grid.cell[index].x, _grid.cell[index].y)];
+    while (*link != AP_OADATABASE_GRID_NONE) {
+        if (*link == index) {
+            *link = _grid.next[index];
+            return;
+        }
+        link = &_grid.next[*link];
+    }
+}
+
+// recalculate the occupied bounds and largest radius after items have been removed
+void AP_OADatabase::grid_update_bounds()
+{
+    if (!grid_healthy() || (_database.count == 0)) {
+        return;
+    }
+
+    _grid.min = _grid.cell[0];
+    _grid.max = _grid.cell[0];
+    _grid.radius_max = _database.items[0].radius;
+    for (uint16_t i = 1; i < _database.count; i++) {
+        _grid.min.x = MIN(_grid.min.x, _grid.cell[i].x);
+        _grid.min.y = MIN(_grid.min.y, _grid.cell[i].y);
+        _grid.max.x = MAX(_grid.max.x, _grid.cell[i].x);
+        _grid.max.y = MAX(_grid.max.y, _grid.cell[i].y);
+        _grid.radius_max = MAX(_grid.radius_max, _database.items[i].radius);
+    }
+}
+
+// find the lowest index item within radius (in meters) of pos, or whose own radius covers pos
+// returns true on success and index is updated
+bool AP_OADatabase::find_item_within_radius(const Vector3f &pos, float radius, uint16_t &index) const
+{
+    if (!healthy() || (_database.count == 0)) {
+        return false;
+    }
+
+    const OA_DbItem item {pos, 0, radius, 0, OA_DbItemImportance::Normal};
+
+    // any matching item is within the larger of the search radius and the largest item radius
+    const float search_radius = MAX(radius, _grid.radius_max);
+    const int16_t x_min = MAX(grid_coord(pos.x - search_radius), _grid.min.x);
+    const int16_t x_max = MIN(grid_coord(pos.x + search_radius), _grid.max.x);
+    const int16_t y_min = MAX(grid_coord(pos.y - search_radius), _grid.min.y);
+    const int16_t y_max = MIN(grid_coord(pos.y + search_radius), _grid.max.y);
+
+    // search every item if the grid is unavailable or the search covers more cells than there are items
+    if (!grid_healthy() || ((int32_t)(x_max - x_min + 1) * (y_max - y_min + 1) > _database.count)) {
+        for (uint16_t i = 0; i < _database.count; i++) {
+            if (is_close_to_item_in_database(i, item)) {
+                index = i;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    uint16_t found = AP_OADATABASE_GRID_NONE;
+    for (int16_t x = x_min; x <= x_max; x++) {
+        for (int16_t y = y_min; y <= y_max; y++) {
+            for (uint16_t i = _grid.bucket_head[grid_bucket(x, y)]; i != AP_OADATABASE_GRID_NONE; i = _grid.next[i]) {
+                if ((i < found) && (_grid.cell[i].x == x) && (_grid.cell[i].y == y) && is_close_to_item_in_database(i, item)) {
+                    found = i;
+                }
+            }
+        }
+    }
+    if (found == AP_OADATABASE_GRID_NONE) {
+        return false;
+    }
+    index = found;
+    return true;
+}
+
+// update margin with the smallest margin between a line segment and the items in a cell
+void AP_OADatabase::grid_cell_min_margin(int16_t x, int16_t y, const Vector3f &seg_start, const Vector3f &seg_end, float &margin) const
+{
+    for (uint16_t i = _grid.bucket_head[grid_bucket(x, y)]; i != AP_OADATABASE_GRID_NONE; i = _grid.next[i]) {
+        if ((_grid.cell[i].x == x) && (_grid.cell[i].y == y)) {
+            const OA_DbItem &item = _database.items[i];
+            margin = MIN(margin, Vector3f::closest_distance_between_line_and_point(seg_start, seg_end, item.pos) - item.radius);
+        }
+    }
+}
+
+// calculate the smallest margin between a line segment and all items
+// cells are searched in rings outwards from the segment until no item in a further ring could have a smaller margin
+// returns false if the database is empty
+bool AP_OADatabase::get_min_margin_to_segment(const Vector3f &seg_start, const Vector3f &seg_end, float &margin) const
+{
+    if (!healthy() || (_database.count == 0)) {
+        return false;
+    }
+
+    // cells covering the segment's horizontal extent
+    const int16_t seg_x_min = grid_coord(MIN(seg_start.x, seg_end.x));
+    const int16_t seg_x_max = grid_coord(MAX(seg_start.x, seg_end.x));
+    const int16_t seg_y_min = grid_coord(MIN(seg_start.y, seg_end.y));
+    const int16_t seg_y_max = grid_coord(MAX(seg_start.y, seg_end.y));
+
+    float smallest_margin = FLT_MAX;
+    bool use_grid = grid_healthy();
+    uint32_t cells_searched = 0;
+    for (uint16_t ring = 0; use_grid; ring++) {
+        // items in this ring are at least (ring - 1) cells away from the segment horizontally
+        if ((ring > 0) && (((ring - 1) * AP_OADATABASE_GRID_CELL_SIZE - _grid.radius_max) >= smallest_margin)) {
+            break;
+        }
+
+        // ring is the border of the segment's cells expanded by ring cells, limited to the occupied area
+        const int32_t ring_x_min = (int32_t)seg_x_min - ring;
+        const int32_t ring_x_max = (int32_t)seg_x_max + ring;
+        const int32_t ring_y_min = (int32_t)seg_y_min - ring;
+        const int32_t ring_y_max = (int32_t)seg_y_max + ring;
+        const int32_t x_min = MAX(ring_x_min, (int32_t)_grid.min.x);
+        const int32_t x_max = MIN(ring_x_max, (int32_t)_grid.max.x);
+        const int32_t y_min = MAX(ring_y_min, (int32_t)_grid.min.y);
+        const int32_t y_max = MIN(ring_y_max, (int32_t)_grid.max.y);
+
+        if ((x_min <= x_max) && (y_min <= y_max)) {
+            for (int32_t x = x_min; x <= x_max; x++) {
+                const bool edge_column = (x == ring_x_min) || (x == ring_x_max);
+                for (int32_t y = y_min; y <= y_max; y++) {
+                    // inner cells were searched by previous rings
+                    if ((ring > 0) && !edge_column && (y != ring_y_min) && (y != ring_y_max)) {
+                        y = MAX(y, ring_y_max - 1);
+                        continue;
+                    }
+                    grid_cell_min_margin(x, y, seg_start, seg_end, smallest_margin);
+                    cells_searched++;
+                }
+            }
+        }
+
+        // stop once the ring covers the whole occupied area
+        if ((ring_x_min <= _grid.min.x) && (ring_x_max >= _grid.max.x) && (ring_y_min <= _grid.min.y) && (ring_y_max >= _grid.max.y)) {
+            break;
+        }
+
+        // searching every item is cheaper than searching more cells than there are items
+        if (cells_searched > _database.count) {
+            use_grid = false;
+        }
+    }
+
+    if (!use_grid) {
+        smallest_margin = FLT_MAX;
+        for (uint16_t i = 0; i < _database.count; i++) {
+            const OA_DbItem &item = _database.items[i];
+            smallest_margin = MIN(smallest_margin, Vector3f::closest_distance_between_line_and_point(seg_start, seg_end, item.pos) - item.radius);
+        }
+    }
+
+    margin = smallest_margin;
+    return true;
+}
+
+// update each margin with the smallest margin between a segment from a common start and all items
+// returns false if the database is empty
+bool AP_OADatabase::get_min_margins_to_segments(const Vector3f &seg_start, const Vector3f *seg_ends, uint8_t num_segments, float *margins) const
+{
+    if (!healthy() || (_database.count == 0) || (num_segments == 0)) {
+        return false;
+    }
+
+    // every segment passes through seg_start so no segment's margin can be larger than the smallest margin from seg_start.
+    // this bound is only used to reject items, a small tolerance keeps the item which sets it from being rejected by rounding
+    float start_margin_min = FLT_MAX;
+    for (uint16_t i = 0; i < _database.count; i++) {
+        const OA_DbItem &item = _database.items[i];
+        start_margin_min = MIN(start_margin_min, (item.pos - seg_start).length() - item.radius);
+    }
+    start_margin_min += AP_OADATABASE_MARGIN_TOLERANCE;
+    float length_max = 0.0f;
+    float margin_max = -FLT_MAX;
+    for (uint8_t j = 0; j < num_segments; j++) {
+        length_max = MAX(length_max, (seg_ends[j] - seg_start).length());
+        margin_max = MAX(margin_max, MIN(margins[j], start_margin_min));
+    }
+
+    for (uint16_t i = 0; i < _database.count; i++) {
+        const OA_DbItem &item = _database.items[i];
+
+        // reject items too far from seg_start to reduce any segment's margin
+        const float reach = margin_max + length_max + item.radius;
+        if (!is_positive(reach) || ((item.pos - seg_start).length_squared() >= sq(reach))) {
+            continue;
+        }
+
+        const Vector2f item_ofs = item.pos.xy() - seg_start.xy();
+        for (uint8_t j = 0; j < num_segments; j++) {
+            // reject items outside the segment's bounding box expanded by the segment's margin
+            const Vector3f &seg_end = seg_ends[j];
+            const float expand = MIN(margins[j], start_margin_min) + item.radius;
+            if (!is_positive(expand) ||
+                (item.pos.x < MIN(seg_start.x, seg_end.x) - expand) || (item.pos.x > MAX(seg_start.x, seg_end.x) + expand) ||
+                (item.pos.y < MIN(seg_start.y, seg_end.y) - expand) || (item.pos.y > MAX(seg_start.y, seg_end.y) + expand) ||
+                (item.pos.z < MIN(seg_start.z, seg_end.z) - expand) || (item.pos.z > MAX(seg_start.z, seg_end.z) + expand)) {
+                continue;
+            }
+            // reject items whose horizontal distance from the segment's line is too large, avoiding a square root
+            const Vector2f seg_xy = seg_end.xy() - seg_start.xy();
+            if (sq(seg_xy % item_ofs) > sq(expand) * seg_xy.length_squared()) {
+                continue;
+            }
+            margins[j] = MIN(margins[j], Vector3f::closest_distance_between_line_and_point(seg_start, seg_end, item.pos) - item.radius);
+        }
+    }
+
+    return true;
+}
+
 // send ADSB_VEHICLE mavlink messages
 void AP_OADatabase::send_adsb_vehicle(mavlink_channel_t chan, uint16_t interval_ms)
 {
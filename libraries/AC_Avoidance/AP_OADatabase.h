@@ -44,6 +44,20 @@ public:
     // get number of items in the database
     uint16_t database_count() const { return _database.count; }
 
+    // calculate the smallest margin (distance from the segment to an item's centre minus the item's radius) between a line segment and all items
+    // seg_start and seg_end are offsets in meters from the EKF origin in the same frame as the item positions
+    // only items in grid cells near the segment are checked.  returns false if the database is empty
+    bool get_min_margin_to_segment(const Vector3f &seg_start, const Vector3f &seg_end, float &margin) const;
+
+    // update each margins[i] with the smaller of its value and the smallest margin between the segment from seg_start to seg_ends[i] and all items
+    // margins must be initialised by the caller.  all segments are checked in a single pass over the items and items which
+    // cannot reduce a segment's margin are rejected using bounding boxes.  returns false if the database is empty
+    bool get_min_margins_to_segments(const Vector3f &seg_start, const Vector3f *seg_ends, uint8_t num_segments, float *margins) const;
+
+    // find the lowest index item within radius (in meters) of pos, or whose own radius covers pos
+    // only items in grid cells near pos are checked.  returns true on success and index is updated
+    bool find_item_within_radius(const Vector3f &pos, float radius, uint16_t &index) const;
+
     // empty queue and try and put into database. Return true if there's more work to do
     bool process_queue();
 
@@ -57,6 +71,7 @@ private:
     // initialise
     void init_queue();
     void init_database();
+    void init_grid();
 
     // database item management
     void database_item_add(const OA_DbItem &item);
@@ -71,6 +86,29 @@ private:
     // returns true if database item "index" is close to "item"
     bool is_close_to_item_in_database(const uint16_t index, const OA_DbItem &item) const;
 
+    //
+    // spatial hash of database items by horizontal position
+    //
+
+    // returns true if the grid is allocated
+    bool grid_healthy() const { return _grid.num_buckets > 0; }
+
+    // convert a horizontal position in meters to a grid cell coordinate
+    int16_t grid_coord(float pos) const;
+
+    // returns the bucket holding the items in a cell
+    uint16_t grid_bucket(int16_t x, int16_t y) const;
+
+    // add or remove an item from the grid.  items must be removed from the grid before they are moved or overwritten
+    void grid_add(uint16_t index);
+    void grid_remove(uint16_t index);
+
+    // recalculate the occupied bounds and largest radius after items have been removed
+    void grid_update_bounds();
+
+    // update margin with the smallest margin between a line segment and the items in a cell
+    void grid_cell_min_margin(int16_t x, int16_t y, const Vector3f &seg_start, const Vector3f &seg_end, float &margin) const;
+
     // enum for use with _OUTPUT parameter
     enum class OA_DbOutputLevel {
         OUTPUT_LEVEL_DISABLED = 0,
@@ -90,9 +128,8 @@ private:
     AP_Float        _min_alt;                               // OADatabase minimum vehicle height check (in meters)
 
     struct {
-        ObjectBuffer<OA_DbItem> *items;                     // thread safe incoming queue of points from proximity sensor to be put into database
+        ObjectBuffer_MPSC<OA_DbItem> *items;                // thread safe incoming queue of points from proximity sensor to be put into database
         uint16_t        size;                               // cached value of _queue_size_param.
-        HAL_Semaphore   sem;                                // semaphore for multi-thread use of queue
     } _queue;
     float dist_to_radius_scalar;                            // scalar to convert the distance and beam width to an object radius
 
@@ -102,6 +139,21 @@ private:
         uint16_t        size;                               // cached value of _database_size_param that sticks after initialized
     } _database;
 
+    struct GridCell {
+        int16_t x;
+        int16_t y;
+    };
+
+    struct {
+        uint16_t        *bucket_head;                       // first item in each bucket, AP_OADATABASE_GRID_NONE if empty
+        uint16_t        *next;                              // next item in the same bucket for each database item
+        GridCell        *cell;                              // grid cell of each database item
+        uint16_t        num_buckets;                        // number of buckets, a power of two.  zero if grid allocation failed
+        GridCell        min;                                // lowest occupied cell coordinates
+        GridCell        max;                                // highest occupied cell coordinates
+        float           radius_max;                         // largest radius of any item in the grid
+    } _grid;
+
     uint16_t _next_index_to_send[MAVLINK_COMM_NUM_BUFFERS]; // index of next object in _database to send to GCS
     uint16_t _highest_index_sent[MAVLINK_COMM_NUM_BUFFERS]; // highest index in _database sent to GCS
     uint32_t _last_send_to_gcs_ms[MAVLINK_COMM_NUM_BUFFERS];// system time that send_adsb_vehicle was last called
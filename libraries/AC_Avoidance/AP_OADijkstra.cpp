@@ -27,6 +27,7 @@
 #define OA_DIJKSTRA_EXPANDING_ARRAY_ELEMENTS_PER_CHUNK  32      // expanding arrays for fence points and paths to destination will grow in increments of 20 elements
 #define OA_DIJKSTRA_POLYGON_SHORTPATH_NOTSET_IDX        255     // index use to indicate we do not have a tentative short path for a node
 #define OA_DIJKSTRA_ERROR_REPORTING_INTERVAL_MS         5000    // failure messages sent to GCS every 5 seconds
+#define OA_DIJKSTRA_OPEN_SET_NOTSET_POS                 0xFFFF  // position used to indicate a node is not in the open set
 
 /// Constructor
 AP_OADijkstra::AP_OADijkstra(AP_Int16 &options) :
@@ -34,7 +35,10 @@ AP_OADijkstra::AP_OADijkstra(AP_Int16 &options) :
         _inclusion_polygon_pts(OA_DIJKSTRA_EXPANDING_ARRAY_ELEMENTS_PER_CHUNK),
         _exclusion_polygon_pts(OA_DIJKSTRA_EXPANDING_ARRAY_ELEMENTS_PER_CHUNK),
         _exclusion_circle_pts(OA_DIJKSTRA_EXPANDING_ARRAY_ELEMENTS_PER_CHUNK),
+        _fence_visgraph_index_start(OA_DIJKSTRA_EXPANDING_ARRAY_ELEMENTS_PER_CHUNK),
+        _fence_visgraph_index(OA_DIJKSTRA_EXPANDING_ARRAY_ELEMENTS_PER_CHUNK),
         _short_path_data(OA_DIJKSTRA_EXPANDING_ARRAY_ELEMENTS_PER_CHUNK),
+        _open_set(OA_DIJKSTRA_EXPANDING_ARRAY_ELEMENTS_PER_CHUNK),
         _path(OA_DIJKSTRA_EXPANDING_ARRAY_ELEMENTS_PER_CHUNK)
 {
 }
@@ -111,6 +115,7 @@ AP_OADijkstra::AP_OADijkstra_State AP_OADijkstra::update(const Location &current
 
     // create visgraph for all fence (with margin) points
     if (!_polyfence_visgraph_ok) {
+        _destination_visgraph_ok = false;
         _polyfence_visgraph_ok = create_fence_visgraph(error_id);
         if (!_polyfence_visgraph_ok) {
             _shortest_path_ok = false;
@@ -668,6 +673,49 @@ bool AP_OADijkstra::create_fence_visgraph(AP_OADijkstra_Error &err_id)
         }
     }
 
+    return create_fence_visgraph_index(err_id);
+}
+
+// index the fence visibility graph by fence point so each point's neighbours can be found without searching the whole graph
+// returns true on success.  returns false on failure and err_id is updated
+bool AP_OADijkstra::create_fence_visgraph_index(AP_OADijkstra_Error &err_id)
+{
+    // each item is indexed from both of its points
+    const uint16_t numpoints = total_numpoints();
+    const uint16_t num_items = _fence_visgraph.num_items();
+    if ((num_items > UINT16_MAX / 2) ||
+        !_fence_visgraph_index_start.expand_to_hold(numpoints + 1) ||
+        !_fence_visgraph_index.expand_to_hold(num_items * 2)) {
+        err_id = AP_OADijkstra_Error::DIJKSTRA_ERROR_OUT_OF_MEMORY;
+        return false;
+    }
+
+    // count items touching each point
+    for (uint16_t i = 0; i <= numpoints; i++) {
+        _fence_visgraph_index_start[i] = 0;
+    }
+    for (uint16_t i = 0; i < num_items; i++) {
+        _fence_visgraph_index_start[_fence_visgraph[i].id1.id_num + 1]++;
+        _fence_visgraph_index_start[_fence_visgraph[i].id2.id_num + 1]++;
+    }
+
+    // convert counts to start of each point's items
+    for (uint16_t i = 1; i <= numpoints; i++) {
+        _fence_visgraph_index_start[i] += _fence_visgraph_index_start[i-1];
+    }
+
+    // fill in items using start as a cursor which leaves it holding the end of each point's items
+    for (uint16_t i = 0; i < num_items; i++) {
+        _fence_visgraph_index[_fence_visgraph_index_start[_fence_visgraph[i].id1.id_num]++] = i;
+        _fence_visgraph_index[_fence_visgraph_index_start[_fence_visgraph[i].id2.id_num]++] = i;
+    }
+
+    // shift back so start holds the start of each point's items again
+    for (uint16_t i = numpoints; i > 0; i--) {
+        _fence_visgraph_index_start[i] = _fence_visgraph_index_start[i-1];
+    }
+    _fence_visgraph_index_start[0] = 0;
+
     return true;
 }
 
@@ -707,46 +755,67 @@ bool AP_OADijkstra::update_visgraph(AP_OAVisGraph& visgraph, const AP_OAVisGraph
 
 // update total distance for all nodes visible from current node
 // curr_node_idx is an index into the _short_path_data array
-void AP_OADijkstra::update_visible_node_distances(node_index curr_node_idx)
+// returns false if the open set could not be expanded
+bool AP_OADijkstra::update_visible_node_distances(node_index curr_node_idx)
 {
     // sanity check
     if (curr_node_idx >= _short_path_data_numpoints) {
-        return;
+        return true;
     }
 
     // get current node for convenience
     const ShortPathNode &curr_node = _short_path_data[curr_node_idx];
 
-    // for each visibility graph
-    const AP_OAVisGraph* visgraphs[] = {&_fence_visgraph, &_destination_visgraph};
-    for (uint8_t v=0; v<ARRAY_SIZE(visgraphs); v++) {
-
-        // skip if empty
-        const AP_OAVisGraph &curr_visgraph = *visgraphs[v];
-        if (curr_visgraph.num_items() == 0) {
-            continue;
-        }
-
-        // search visibility graph for items visible from current_node
-        for (uint16_t i = 0; i < curr_visgraph.num_items(); i++) {
-            const AP_OAVisGraph::VisGraphItem &item = curr_visgraph[i];
-            // match if current node's id matches either of the id's in the graph (i.e. either end of the vector)
-            if ((curr_node.id == item.id1) || (curr_node.id == item.id2)) {
-                AP_OAVisGraph::OAItemID matching_id = (curr_node.id == item.id1) ? item.id2 : item.id1;
-                // find item's id in node array
-                node_index item_node_idx;
-                if (find_node_from_id(matching_id, item_node_idx)) {
-                    // if current node's distance + distance to item is less than item's current distance, update item's distance
-                    const float dist_to_item_via_current_node = _short_path_data[curr_node_idx].distance_cm + item.distance_cm;
-                    if (dist_to_item_via_current_node < _short_path_data[item_node_idx].distance_cm) {
-                        // update item's distance and set "distance_from_idx" to current node's index
-                        _short_path_data[item_node_idx].distance_cm = dist_to_item_via_current_node;
-                        _short_path_data[item_node_idx].distance_from_idx = curr_node_idx;
-                    }
-                }
+    // only fence points are expanded, the source is handled by calc_shortest_path and the search stops at the destination
+    if (curr_node.id.id_type != AP_OAVisGraph::OATYPE_INTERMEDIATE_POINT) {
+        return true;
+    }
+
+    // update fence points visible from current node using the fence visgraph index
+    const uint16_t index_end = _fence_visgraph_index_start[curr_node.id.id_num + 1];
+    for (uint16_t i = _fence_visgraph_index_start[curr_node.id.id_num]; i < index_end; i++) {
+        const AP_OAVisGraph::VisGraphItem &item = _fence_visgraph[_fence_visgraph_index[i]];
+        const AP_OAVisGraph::OAItemID &matching_id = (curr_node.id == item.id1) ? item.id2 : item.id1;
+        // find item's id in node array
+        node_index item_node_idx;
+        if (find_node_from_id(matching_id, item_node_idx)) {
+            if (!update_node_distance(curr_node_idx, item_node_idx, item.distance_cm)) {
+                return false;
+            }
+        }
+    }
+
+    // update destination if visible from current node
+    if (curr_node.destination_distance_cm < FLT_MAX) {
+        node_index dest_node_idx;
+        if (find_node_from_id({AP_OAVisGraph::OATYPE_DESTINATION, 0}, dest_node_idx)) {
+            if (!update_node_distance(curr_node_idx, dest_node_idx, curr_node.destination_distance_cm)) {
+                return false;
             }
         }
     }
+
+    return true;
+}
+
+// update a node's distance if reaching it via curr_node_idx is shorter
+// returns false if the open set could not be expanded
+bool AP_OADijkstra::update_node_distance(node_index curr_node_idx, node_index node_idx, float dist_from_curr_node)
+{
+    ShortPathNode &node = _short_path_data[node_idx];
+    if (node.visited) {
+        return true;
+    }
+
+    // if current node's distance + distance to item is less than item's current distance, update item's distance
+    const float dist_via_current_node = _short_path_data[curr_node_idx].distance_cm + dist_from_curr_node;
+    if (dist_via_current_node < node.distance_cm) {
+        // update item's distance and set "distance_from_idx" to current node's index
+        node.distance_cm = dist_via_current_node;
+        node.distance_from_idx = curr_node_idx;
+        return open_set_push(node_idx);
+    }
+    return true;
 }
 
 // find a node's index into _short_path_data array from it's id (i.e. id type and id number)
@@ -781,45 +850,92 @@ bool AP_OADijkstra::find_node_from_id(const AP_OAVisGraph::OAItemID &id, node_in
     return false;
 }
 
-// find index of node with lowest tentative distance (ignore visited nodes)
-// returns true if successful and node_idx argument is updated
-bool AP_OADijkstra::find_closest_node_idx(node_index &node_idx) const
+// cost used to order the open set
+float AP_OADijkstra::open_set_cost(uint16_t pos) const
 {
-    node_index lowest_idx = 0;
-    float lowest_dist = FLT_MAX;
-
-    // scan through all nodes looking for closest
-    for (node_index i=0; i<_short_path_data_numpoints; i++) {
-        const ShortPathNode &node = _short_path_data[i];
-        if (node.visited || is_equal(_short_path_data[i].distance_cm, FLT_MAX)) {
-            // if node is already visited OR cannot be reached yet, we can't use it
-            continue;
-        }
-        // figure out the pos of this node
-        Vector2f node_pos;
-        float dist_with_heuristics = FLT_MAX;
-        if (convert_node_to_point(node.id, node_pos)) {
-            // heuristics is is simple Euclidean distance from the node to the destination
-            // This should be admissible, therefore optimal path is guaranteed
-            const float heuristics = (node_pos-_path_destination).length();
-            dist_with_heuristics = node.distance_cm + heuristics;
-        } else {
-            // shouldn't happen
-            return false;
+    const ShortPathNode &node = _short_path_data[_open_set[pos]];
+    return node.distance_cm + node.heuristic_cm;
+}
+
+// move the item at pos towards the top of the heap until its parent has a lower cost
+void AP_OADijkstra::open_set_sift_up(uint16_t pos)
+{
+    const node_index node_idx = _open_set[pos];
+    const float cost = open_set_cost(pos);
+    while (pos > 0) {
+        const uint16_t parent = (pos - 1) / 2;
+        if (open_set_cost(parent) <= cost) {
+            break;
         }
-        if (dist_with_heuristics < lowest_dist) {
-            // for NOW, this is the closest node
-            lowest_idx = i;
-            lowest_dist = dist_with_heuristics;
+        _open_set[pos] = _open_set[parent];
+        _short_path_data[_open_set[pos]].open_set_pos = pos;
+        pos = parent;
+    }
+    _open_set[pos] = node_idx;
+    _short_path_data[node_idx].open_set_pos = pos;
+}
+
+// move the item at pos towards the bottom of the heap until its children have a higher cost
+void AP_OADijkstra::open_set_sift_down(uint16_t pos)
+{
+    const node_index node_idx = _open_set[pos];
+    const float cost = open_set_cost(pos);
+    while (true) {
+        uint16_t child = 2 * pos + 1;
+        if (child >= _open_set_numitems) {
+            break;
         }
+        float child_cost = open_set_cost(child);
+        if (child + 1 < _open_set_numitems) {
+            const float right_cost = open_set_cost(child + 1);
+            if (right_cost < child_cost) {
+                child++;
+                child_cost = right_cost;
+            }
+        }
+        if (cost <= child_cost) {
+            break;
+        }
+        _open_set[pos] = _open_set[child];
+        _short_path_data[_open_set[pos]].open_set_pos = pos;
+        pos = child;
     }
+    _open_set[pos] = node_idx;
+    _short_path_data[node_idx].open_set_pos = pos;
+}
 
-    if (lowest_dist < FLT_MAX) {
-        // found the closest node
-        node_idx = lowest_idx;
-        return true;
+// add a node to the open set or move it after its distance has decreased
+// returns false if the open set could not be expanded
+bool AP_OADijkstra::open_set_push(node_index node_idx)
+{
+    uint16_t pos = _short_path_data[node_idx].open_set_pos;
+    if (pos == OA_DIJKSTRA_OPEN_SET_NOTSET_POS) {
+        if (!_open_set.expand_to_hold(_open_set_numitems + 1)) {
+            return false;
+        }
+        pos = _open_set_numitems++;
+        _open_set[pos] = node_idx;
     }
-    return false;
+    // distances only ever decrease so the node can only move up
+    open_set_sift_up(pos);
+    return true;
+}
+
+// remove the node with the lowest distance plus heuristic from the open set
+// returns true if successful and node_idx argument is updated
+bool AP_OADijkstra::open_set_pop(node_index &node_idx)
+{
+    if (_open_set_numitems == 0) {
+        return false;
+    }
+    node_idx = _open_set[0];
+    _short_path_data[node_idx].open_set_pos = OA_DIJKSTRA_OPEN_SET_NOTSET_POS;
+    _open_set_numitems--;
+    if (_open_set_numitems > 0) {
+        _open_set[0] = _open_set[_open_set_numitems];
+        open_set_sift_down(0);
+    }
+    return true;
 }
 
 // calculate shortest path from origin to destination
@@ -839,9 +955,14 @@ bool AP_OADijkstra::calc_shortest_path(const Location &origin, const Location &d
         err_id = AP_OADijkstra_Error::DIJKSTRA_ERROR_OUT_OF_MEMORY;
         return false;
     }
-    if (!update_visgraph(_destination_visgraph, {AP_OAVisGraph::OATYPE_DESTINATION, 0}, _path_destination)) {
-        err_id = AP_OADijkstra_Error::DIJKSTRA_ERROR_OUT_OF_MEMORY;
-        return false;
+    // destination visgraph only depends upon the fence so is reused if only the origin has moved
+    if (!_destination_visgraph_ok || (_destination_visgraph_pos != _path_destination)) {
+        _destination_visgraph_ok = update_visgraph(_destination_visgraph, {AP_OAVisGraph::OATYPE_DESTINATION, 0}, _path_destination);
+        if (!_destination_visgraph_ok) {
+            err_id = AP_OADijkstra_Error::DIJKSTRA_ERROR_OUT_OF_MEMORY;
+            return false;
+        }
+        _destination_visgraph_pos = _path_destination;
     }
 
     // expand _short_path_data if necessary
@@ -850,18 +971,33 @@ bool AP_OADijkstra::calc_shortest_path(const Location &origin, const Location &d
         return false;
     }
 
-    // add origin and destination (node_type, id, visited, distance_from_idx, distance_cm) to short_path_data array
-    _short_path_data[0] = {{AP_OAVisGraph::OATYPE_SOURCE, 0}, false, 0, 0};
-    _short_path_data[1] = {{AP_OAVisGraph::OATYPE_DESTINATION, 0}, false, OA_DIJKSTRA_POLYGON_SHORTPATH_NOTSET_IDX, FLT_MAX};
+    // add origin and destination (node_type, id, visited, distance_from_idx, distance_cm, heuristic_cm, destination_distance_cm, open_set_pos) to short_path_data array
+    _short_path_data[0] = {{AP_OAVisGraph::OATYPE_SOURCE, 0}, false, 0, 0, (_path_source - _path_destination).length(), FLT_MAX, OA_DIJKSTRA_OPEN_SET_NOTSET_POS};
+    _short_path_data[1] = {{AP_OAVisGraph::OATYPE_DESTINATION, 0}, false, OA_DIJKSTRA_POLYGON_SHORTPATH_NOTSET_IDX, FLT_MAX, 0, 0, OA_DIJKSTRA_OPEN_SET_NOTSET_POS};
     _short_path_data_numpoints = 2;
 
-    // add all inclusion and exclusion fence points to short_path_data array (node_type, id, visited, distance_from_idx, distance_cm)
+    // add all inclusion and exclusion fence points to short_path_data array
+    // heuristic is simple Euclidean distance from the node to the destination which is admissible, therefore optimal path is guaranteed
     for (uint8_t i=0; i<total_numpoints(); i++) {
-        _short_path_data[_short_path_data_numpoints++] = {{AP_OAVisGraph::OATYPE_INTERMEDIATE_POINT, i}, false, OA_DIJKSTRA_POLYGON_SHORTPATH_NOTSET_IDX, FLT_MAX};
+        Vector2f point;
+        if (!get_point(i, point)) {
+            err_id = AP_OADijkstra_Error::DIJKSTRA_ERROR_COULD_NOT_FIND_PATH;
+            return false;
+        }
+        _short_path_data[_short_path_data_numpoints++] = {{AP_OAVisGraph::OATYPE_INTERMEDIATE_POINT, i}, false, OA_DIJKSTRA_POLYGON_SHORTPATH_NOTSET_IDX, FLT_MAX, (point - _path_destination).length(), FLT_MAX, OA_DIJKSTRA_OPEN_SET_NOTSET_POS};
+    }
+
+    // record distance to destination for fence points visible from the destination
+    for (uint16_t i = 0; i < _destination_visgraph.num_items(); i++) {
+        node_index node_idx;
+        if (find_node_from_id(_destination_visgraph[i].id2, node_idx)) {
+            _short_path_data[node_idx].destination_distance_cm = _destination_visgraph[i].distance_cm;
+        }
     }
 
     // start algorithm from source point
     node_index current_node_idx = 0;
+    _open_set_numitems = 0;
 
     // update nodes visible from source point
     for (uint16_t i = 0; i < _source_visgraph.num_items(); i++) {
@@ -869,6 +1005,10 @@ bool AP_OADijkstra::calc_shortest_path(const Location &origin, const Location &d
         if (find_node_from_id(_source_visgraph[i].id2, node_idx)) {
             _short_path_data[node_idx].distance_cm = _source_visgraph[i].distance_cm;
             _short_path_data[node_idx].distance_from_idx = current_node_idx;
+            if (!open_set_push(node_idx)) {
+                err_id = AP_OADijkstra_Error::DIJKSTRA_ERROR_OUT_OF_MEMORY;
+                return false;
+            }
         } else {
             err_id = AP_OADijkstra_Error::DIJKSTRA_ERROR_COULD_NOT_FIND_PATH;
             return false;
@@ -877,16 +1017,23 @@ bool AP_OADijkstra::calc_shortest_path(const Location &origin, const Location &d
     // mark source node as visited
     _short_path_data[current_node_idx].visited = true;
 
-    // move current_node_idx to node with lowest distance
-    while (find_closest_node_idx(current_node_idx)) {
-        node_index dest_node;
+    // move current_node_idx to node with lowest distance plus heuristic
+    node_index dest_node;
+    if (!find_node_from_id({AP_OAVisGraph::OATYPE_DESTINATION,0}, dest_node)) {
+        err_id = AP_OADijkstra_Error::DIJKSTRA_ERROR_COULD_NOT_FIND_PATH;
+        return false;
+    }
+    while (open_set_pop(current_node_idx)) {
         // See if this next "closest" node is actually the destination
-        if (find_node_from_id({AP_OAVisGraph::OATYPE_DESTINATION,0}, dest_node) && current_node_idx == dest_node) {
+        if (current_node_idx == dest_node) {
             // We have discovered destination.. Don't bother with the rest of the graph
             break;
         }
         // update distances to all neighbours of current node
-        update_visible_node_distances(current_node_idx);
+        if (!update_visible_node_distances(current_node_idx)) {
+            err_id = AP_OADijkstra_Error::DIJKSTRA_ERROR_OUT_OF_MEMORY;
+            return false;
+        }
 
         // mark current node as visited
         _short_path_data[current_node_idx].visited = true;
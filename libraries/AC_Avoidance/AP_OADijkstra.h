@@ -7,6 +7,7 @@
 
 /*
  * Dijkstra's algorithm for path planning around polygon fence
+ * nodes are searched in A* order using the Euclidean distance to the destination as the heuristic
  */
 
 class AP_OADijkstra {
@@ -110,6 +111,10 @@ private:
     // returns true on success.  returns false on failure and err_id is updated
     bool create_fence_visgraph(AP_OADijkstra_Error &err_id);
 
+    // index the fence visibility graph by fence point so each point's neighbours can be found without searching the whole graph
+    // returns true on success.  returns false on failure and err_id is updated
+    bool create_fence_visgraph_index(AP_OADijkstra_Error &err_id);
+
     // calculate shortest path from origin to destination
     // returns true on success.  returns false on failure and err_id is updated
     // requires create_polygon_fence_with_margin and create_polygon_fence_visgraph to have been run
@@ -121,6 +126,7 @@ private:
     bool _exclusion_polygon_with_margin_ok;
     bool _exclusion_circle_with_margin_ok;
     bool _polyfence_visgraph_ok;
+    bool _destination_visgraph_ok;      // true if _destination_visgraph is valid for the current fence and _destination_visgraph_pos
     bool _shortest_path_ok;
 
     Location _destination_prev;     // destination of previous iterations (used to determine if path should be re-calculated)
@@ -146,6 +152,11 @@ private:
     AP_OAVisGraph _fence_visgraph;          // holds distances between all inclusion/exclusion fence points (with margin)
     AP_OAVisGraph _source_visgraph;         // holds distances from source point to all other nodes
     AP_OAVisGraph _destination_visgraph;    // holds distances from the destination to all other nodes
+    Vector2f _destination_visgraph_pos;     // destination position used to create _destination_visgraph (offset in cm from EKF origin)
+
+    // fence visgraph items touching each fence point.  items for point i are _fence_visgraph_index[_fence_visgraph_index_start[i]] up to _fence_visgraph_index[_fence_visgraph_index_start[i+1]]
+    AP_ExpandingArray<uint16_t> _fence_visgraph_index_start;
+    AP_ExpandingArray<uint16_t> _fence_visgraph_index;
 
     // updates visibility graph for a given position which is an offset (in cm) from the ekf origin
     // to add an additional position (i.e. the destination) set add_extra_position = true and provide the position in the extra_position argument
@@ -159,21 +170,44 @@ private:
         bool visited;                   // true if all this node's neighbour's distances have been updated
         node_index distance_from_idx;   // index into _short_path_data from where distance was updated (or 255 if not set)
         float distance_cm;              // distance from source (number is tentative until this node is the current node and/or visited = true)
+        float heuristic_cm;             // straight line distance to destination
+        float destination_distance_cm;  // distance to destination if visible from this node, FLT_MAX if not
+        uint16_t open_set_pos;          // position in _open_set or OA_DIJKSTRA_OPEN_SET_NOTSET_POS if not in open set
     };
     AP_ExpandingArray<ShortPathNode> _short_path_data;
     node_index _short_path_data_numpoints;  // number of elements in _short_path_data array
 
     // update total distance for all nodes visible from current node
     // curr_node_idx is an index into the _short_path_data array
-    void update_visible_node_distances(node_index curr_node_idx);
+    // returns false if the open set could not be expanded
+    bool update_visible_node_distances(node_index curr_node_idx);
+
+    // update a node's distance if reaching it via curr_node_idx is shorter
+    // returns false if the open set could not be expanded
+    bool update_node_distance(node_index curr_node_idx, node_index node_idx, float dist_from_curr_node);
 
     // find a node's index into _short_path_data array from it's id (i.e. id type and id number)
     // returns true if successful and node_idx is updated
     bool find_node_from_id(const AP_OAVisGraph::OAItemID &id, node_index &node_idx) const;
 
-    // find index of node with lowest tentative distance (ignore visited nodes)
+    // open set is a binary min-heap of unvisited but reachable nodes ordered by distance plus heuristic
+    AP_ExpandingArray<node_index> _open_set;
+    uint16_t _open_set_numitems;            // number of nodes in the open set
+
+    // add a node to the open set or move it after its distance has decreased
+    // returns false if the open set could not be expanded
+    bool open_set_push(node_index node_idx);
+
+    // remove the node with the lowest distance plus heuristic from the open set
     // returns true if successful and node_idx argument is updated
-    bool find_closest_node_idx(node_index &node_idx) const;
+    bool open_set_pop(node_index &node_idx);
+
+    // restore heap ordering by moving the item at pos towards the top or bottom of the heap
+    void open_set_sift_up(uint16_t pos);
+    void open_set_sift_down(uint16_t pos);
+
+    // cost used to order the open set
+    float open_set_cost(uint16_t pos) const;
 
     // final path variables and functions
     AP_ExpandingArray<AP_OAVisGraph::OAItemID> _path;   // ids of points on return path in reverse order (i.e. destination is first element)
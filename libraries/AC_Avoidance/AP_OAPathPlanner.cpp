@@ -158,8 +158,8 @@ bool AP_OAPathPlanner::start_thread()
     }
 
     // create the avoidance thread as low priority. It should soak
-    // up spare CPU cycles to fill in the avoidance_result structure based
-    // on requests in avoidance_request
+    // up spare CPU cycles to publish avoidance results based on the
+    // latest request from the navigation code
     if (!hal.scheduler->thread_create(FUNCTOR_BIND_MEMBER(&AP_OAPathPlanner::avoidance_thread, void),
                                       "avoidance",
                                       8192, AP_HAL::Scheduler::PRIORITY_IO, -1)) {
@@ -200,28 +200,33 @@ AP_OAPathPlanner::OA_RetState AP_OAPathPlanner::mission_avoidance(const Location
     }
 
     const uint32_t now = AP_HAL::millis();
-    WITH_SEMAPHORE(_rsem);
 
     // place new request for the thread to work on
-    avoidance_request.current_loc = current_loc;
-    avoidance_request.origin = origin;
-    avoidance_request.destination = destination;
-    avoidance_request.ground_speed_vec = AP::ahrs().groundspeed_vector();
-    avoidance_request.request_time_ms = now;
+    avoidance_info &request = _request.back();
+    request.current_loc = current_loc;
+    request.origin = origin;
+    request.destination = destination;
+    request.ground_speed_vec = AP::ahrs().groundspeed_vector();
+    request.request_time_ms = now;
+    _request.publish();
+
+    // pick up the thread's latest result
+    _result.update();
+    const avoidance_result_info &result = _result.front();
 
     // check result's destination matches our request
-    const bool destination_matches = (destination.lat == avoidance_result.destination.lat) && (destination.lng == avoidance_result.destination.lng);
+    const bool destination_matches = (destination.lat == result.destination.lat) && (destination.lng == result.destination.lng);
 
     // check results have not timed out
-    const bool timed_out = now - avoidance_result.result_time_ms > OA_TIMEOUT_MS;
+    const bool timed_out = now - result.result_time_ms > OA_TIMEOUT_MS;
 
     // return results from background thread's latest checks
     if (destination_matches && !timed_out) {
         // we have a result from the thread
-        result_origin = avoidance_result.origin_new;
-        result_destination = avoidance_result.destination_new;
-        path_planner_used = avoidance_result.path_planner_used;
-        return avoidance_result.ret_state;
+        result_origin = result.origin_new;
+        result_destination = result.destination_new;
+        path_planner_used = result.path_planner_used;
+        return result.ret_state;
     }
 
     // if timeout then path planner is taking too long to respond
@@ -233,7 +238,7 @@ AP_OAPathPlanner::OA_RetState AP_OAPathPlanner::mission_avoidance(const Location
     return OA_PROCESSING;
 }
 
-// avoidance thread that continually updates the avoidance_result structure based on avoidance_request
+// avoidance thread that continually publishes avoidance results based on the latest request
 void AP_OAPathPlanner::avoidance_thread()
 {
     // require ekf origin to have been set
@@ -264,24 +269,21 @@ void AP_OAPathPlanner::avoidance_thread()
 
         _oadatabase.update();
 
-        Location origin_new;
-        Location destination_new;
-        {
-            WITH_SEMAPHORE(_rsem);
-            if (now - avoidance_request.request_time_ms > OA_TIMEOUT_MS) {
-                // this is a very old request, don't process it
-                continue;
-            }
-
-            // copy request to avoid conflict with main thread
-            avoidance_request2 = avoidance_request;
-
-            // store passed in origin and destination so we can return it if object avoidance is not required
-            origin_new = avoidance_request.origin;
-            destination_new = avoidance_request.destination;
+        // take the latest request, which the main thread can't change under us
+        _request.update();
+        const avoidance_info &request = _request.front();
+        const uint32_t request_age_ms = AP_HAL::millis() - request.request_time_ms;
+        if (request_age_ms > OA_TIMEOUT_MS) {
+            // this is a very old request, don't process it
+            continue;
         }
 
+        // store passed in origin and destination so we can return it if object avoidance is not required
+        Location origin_new = request.origin;
+        Location destination_new = request.destination;
+
         // run background task looking for best alternative destination
+        const uint32_t start_us = AP_HAL::micros();
         OA_RetState res = OA_NOT_REQUIRED;
         OAPathPlannerUsed path_planner_used = OAPathPlannerUsed::None;
         switch (_type) {
@@ -294,7 +296,7 @@ void AP_OAPathPlanner::avoidance_thread()
             _oabendyruler->set_config(_margin_max);
 
             AP_OABendyRuler::OABendyType bendy_type;
-            if (_oabendyruler->update(avoidance_request2.current_loc, avoidance_request2.destination, avoidance_request2.ground_speed_vec, origin_new, destination_new, bendy_type, false)) {
+            if (_oabendyruler->update(request.current_loc, request.destination, request.ground_speed_vec, origin_new, destination_new, bendy_type, false)) {
                 res = OA_SUCCESS;
             }
             path_planner_used = map_bendytype_to_pathplannerused(bendy_type);
@@ -307,7 +309,7 @@ void AP_OAPathPlanner::avoidance_thread()
                 continue;
             }
             _oadijkstra->set_fence_margin(_margin_max);
-            const AP_OADijkstra::AP_OADijkstra_State dijkstra_state = _oadijkstra->update(avoidance_request2.current_loc, avoidance_request2.destination, origin_new, destination_new);
+            const AP_OADijkstra::AP_OADijkstra_State dijkstra_state = _oadijkstra->update(request.current_loc, request.destination, origin_new, destination_new);
             switch (dijkstra_state) {
             case AP_OADijkstra::DIJKSTRA_STATE_NOT_REQUIRED:
                 res = OA_NOT_REQUIRED;
@@ -330,7 +332,7 @@ void AP_OAPathPlanner::avoidance_thread()
             } 
             _oabendyruler->set_config(_margin_max);
             AP_OABendyRuler::OABendyType bendy_type;
-            if (_oabendyruler->update(avoidance_request2.current_loc, avoidance_request2.destination, avoidance_request2.ground_speed_vec, origin_new, destination_new, bendy_type, proximity_only)) {
+            if (_oabendyruler->update(request.current_loc, request.destination, request.ground_speed_vec, origin_new, destination_new, bendy_type, proximity_only)) {
                 // detected a obstacle by vehicle's proximity sensor. Switch avoidance to BendyRuler till obstacle is out of the way
                 proximity_only = false;
                 res = OA_SUCCESS;
@@ -348,7 +350,7 @@ void AP_OAPathPlanner::avoidance_thread()
             }
 #if AP_FENCE_ENABLED
             _oadijkstra->set_fence_margin(_margin_max);
-            const AP_OADijkstra::AP_OADijkstra_State dijkstra_state = _oadijkstra->update(avoidance_request2.current_loc, avoidance_request2.destination, origin_new, destination_new);
+            const AP_OADijkstra::AP_OADijkstra_State dijkstra_state = _oadijkstra->update(request.current_loc, request.destination, origin_new, destination_new);
             switch (dijkstra_state) {
             case AP_OADijkstra::DIJKSTRA_STATE_NOT_REQUIRED:
                 res = OA_NOT_REQUIRED;
@@ -367,16 +369,16 @@ void AP_OAPathPlanner::avoidance_thread()
 
         } // switch
 
-        {
-            // give the main thread the avoidance result
-            WITH_SEMAPHORE(_rsem);
-            avoidance_result.destination = avoidance_request2.destination;
-            avoidance_result.origin_new = (res == OA_SUCCESS) ? origin_new : avoidance_result.origin_new;
-            avoidance_result.destination_new = (res == OA_SUCCESS) ? destination_new : avoidance_result.destination;
-            avoidance_result.result_time_ms = AP_HAL::millis();
-            avoidance_result.path_planner_used = path_planner_used;
-            avoidance_result.ret_state = res;
-        }
+        // give the main thread the avoidance result
+        avoidance_result.destination = request.destination;
+        avoidance_result.origin_new = (res == OA_SUCCESS) ? origin_new : avoidance_result.origin_new;
+        avoidance_result.destination_new = (res == OA_SUCCESS) ? destination_new : avoidance_result.destination;
+        avoidance_result.result_time_ms = AP_HAL::millis();
+        avoidance_result.path_planner_used = path_planner_used;
+        avoidance_result.ret_state = res;
+        _result.write(avoidance_result);
+
+        Write_OAPathPlanner(path_planner_used, res, request_age_ms, AP_HAL::micros() - start_us);
     }
 }
 
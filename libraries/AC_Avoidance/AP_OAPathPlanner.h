@@ -4,6 +4,7 @@
 #include <AP_Common/Location.h>
 #include <AP_Param/AP_Param.h>
 #include <AP_HAL/Semaphores.h>
+#include <AP_HAL/utility/TripleBuffer.h>
 
 #include "AP_OABendyRuler.h"
 #include "AP_OADijkstra.h"
@@ -78,13 +79,16 @@ public:
 
 private:
 
-    // avoidance thread that continually updates the avoidance_result structure based on avoidance_request
+    // avoidance thread that continually publishes avoidance results based on the latest request
     void avoidance_thread();
     bool start_thread();
 
     // helper function to map OABendyType to OAPathPlannerUsed
     OAPathPlannerUsed map_bendytype_to_pathplannerused(AP_OABendyRuler::OABendyType bendy_type);
 
+    // log how long a request waited and how long the path planner took on it
+    void Write_OAPathPlanner(const OAPathPlannerUsed path_planner_used, const OA_RetState ret_state, const uint32_t request_age_ms, const uint32_t compute_us) const;
+
     // an avoidance request from the navigation code
     struct avoidance_info {
         Location current_loc;
@@ -92,17 +96,25 @@ private:
         Location destination;
         Vector2f ground_speed_vec;
         uint32_t request_time_ms;
-    } avoidance_request, avoidance_request2;
+    };
 
     // an avoidance result from the avoidance thread
-    struct {
+    struct avoidance_result_info {
         Location destination;       // destination vehicle is trying to get to (also used to verify the result matches a recent request)
         Location origin_new;        // intermediate origin.  The start of line segment that vehicle should follow
         Location destination_new;   // intermediate destination vehicle should move towards
         uint32_t result_time_ms;    // system time the result was calculated (used to verify the result is recent)
         OAPathPlannerUsed path_planner_used;    // path planner that produced the result
         OA_RetState ret_state;      // OA_SUCCESS if the vehicle should move along the path from origin_new to destination_new
-    } avoidance_result;
+    };
+
+    // requests and results are handed between the navigation code and
+    // the avoidance thread without locking, each side taking the latest
+    TripleBuffer<avoidance_info> _request;
+    TripleBuffer<avoidance_result_info> _result;
+
+    // latest result, only used by the avoidance thread
+    avoidance_result_info avoidance_result;
 
     // parameters
     AP_Int8 _type;                  // avoidance algorithm to be used
@@ -110,7 +122,7 @@ private:
     AP_Int16 _options;              // Bitmask for options while recovering from Object Avoidance
     
     // internal variables used by front end
-    HAL_Semaphore _rsem;            // semaphore for multi-thread use of avoidance_request and avoidance_result
+    HAL_Semaphore _rsem;            // semaphore for starting the avoidance thread
     bool _thread_created;           // true once background thread has been created
     AP_OABendyRuler *_oabendyruler; // Bendy Ruler algorithm
     AP_OADijkstra *_oadijkstra;     // Dijkstra's algorithm
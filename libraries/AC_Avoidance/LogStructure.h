@@ -6,7 +6,8 @@
     LOG_OA_BENDYRULER_MSG, \
     LOG_OA_DIJKSTRA_MSG, \
     LOG_SIMPLE_AVOID_MSG, \
-    LOG_OD_VISGRAPH_MSG
+    LOG_OD_VISGRAPH_MSG, \
+    LOG_OA_PATHPLANNER_MSG
 
 // @LoggerMessage: OABR
 // @Description: Object avoidance (Bendy Ruler) diagnostics
@@ -106,6 +107,22 @@ struct PACKED log_OD_Visgraph {
   int32_t Lon;
 };
 
+// @LoggerMessage: OAPP
+// @Description: Object avoidance path planner timing, one per request processed
+// @Field: TimeUS: Time since system startup
+// @Field: Used: Path planner that produced the result
+// @Field: Res: Result of the path planning
+// @Field: Age: Age of the request when the avoidance thread started on it
+// @Field: CTime: Time taken by the path planner
+struct PACKED log_OAPathPlanner {
+  LOG_PACKET_HEADER;
+  uint64_t time_us;
+  uint8_t path_planner_used;
+  uint8_t ret_state;
+  uint32_t request_age_ms;
+  uint32_t compute_us;
+};
+
 #define LOG_STRUCTURE_FROM_AVOIDANCE \
     { LOG_OA_BENDYRULER_MSG, sizeof(log_OABendyRuler), \
       "OABR","QBBHHHBfLLiLLi","TimeUS,Type,Act,DYaw,Yaw,DP,RChg,Mar,DLt,DLg,DAlt,OLt,OLg,OAlt", "s-bddd-mDUmDUm", "F-------GGBGGB" , true }, \
@@ -114,4 +131,6 @@ struct PACKED log_OD_Visgraph {
     { LOG_SIMPLE_AVOID_MSG, sizeof(log_SimpleAvoid), \
       "SA",  "QBffffffB","TimeUS,State,DVelX,DVelY,DVelZ,MVelX,MVelY,MVelZ,Back", "sbnnnnnnb", "F--------", true }, \
      { LOG_OD_VISGRAPH_MSG, sizeof(log_OD_Visgraph), \
-      "OAVG", "QBBLL", "TimeUS,version,point_num,Lat,Lon", "s--DU", "F--GG", true},
+      "OAVG", "QBBLL", "TimeUS,version,point_num,Lat,Lon", "s--DU", "F--GG", true}, \
+    { LOG_OA_PATHPLANNER_MSG, sizeof(log_OAPathPlanner), \
+      "OAPP", "QBBII", "TimeUS,Used,Res,Age,CTime", "s--ss", "F--CF", true },
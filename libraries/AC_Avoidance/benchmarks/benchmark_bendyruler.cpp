@@ -0,0 +1,93 @@
+#include <AP_gbenchmark.h>
+
+#include <AC_Avoidance/AP_OADatabase.h>
+#include <AC_Avoidance/AP_OABendyRuler.h>
+
+const AP_HAL::HAL& hal = AP_HAL::get_HAL();
+
+/*
+  benchmarks of the object database margin checks made by BendyRuler's
+  horizontal search, which probes 69 bearings from the vehicle.  The
+  database is filled from a dense lidar scene of walls around the
+  vehicle
+ */
+static const uint8_t num_probes = 69;
+static const float probe_length = 15.0f;
+
+static AP_OADatabase db;
+
+static void setup_database()
+{
+    static bool done;
+    if (done) {
+        return;
+    }
+    done = true;
+    db.init();
+
+    // a corridor 8m wide with a wall across it 12m ahead, sampled every 2 degrees
+    for (uint16_t deg = 0; deg < 360; deg += 2) {
+        const float angle = radians(deg);
+        const Vector2f dir {cosf(angle), sinf(angle)};
+        float range = 30.0f;
+        if (!is_zero(dir.y)) {
+            range = MIN(range, 4.0f / fabsf(dir.y));
+        }
+        if (is_positive(dir.x)) {
+            range = MIN(range, 12.0f / dir.x);
+        }
+        db.queue_push(Vector3f(dir.x * range, dir.y * range, 0.0f), 0, range);
+        if (deg % 40 == 0) {
+            db.process_queue();
+        }
+    }
+    db.process_queue();
+}
+
+static Vector3f probe_end(uint8_t probe)
+{
+    const float angle = radians(((probe + 1) / 2) * 5.0f * ((probe % 2) == 1 ? -1.0f : 1.0f));
+    return Vector3f(cosf(angle) * probe_length, sinf(angle) * probe_length, 0.0f);
+}
+
+// one database query per probe
+static void BM_OADatabaseMarginPerProbe(benchmark::State& state)
+{
+    setup_database();
+    const Vector3f start;
+    while (state.KeepRunning()) {
+        float margin_min = FLT_MAX;
+        for (uint8_t i = 0; i < num_probes; i++) {
+            float margin;
+            if (db.get_min_margin_to_segment(start, probe_end(i), margin)) {
+                margin_min = MIN(margin_min, margin);
+            }
+        }
+        gbenchmark_escape(&margin_min);
+    }
+}
+
+// probes queried in batches as BendyRuler does
+static void BM_OADatabaseMarginBatched(benchmark::State& state)
+{
+    setup_database();
+    const Vector3f start;
+    while (state.KeepRunning()) {
+        float margins[OA_BENDYRULER_PROBE_BATCH];
+        for (uint8_t batch_start = 0; batch_start < num_probes; batch_start += OA_BENDYRULER_PROBE_BATCH) {
+            const uint8_t batch_size = MIN(OA_BENDYRULER_PROBE_BATCH, num_probes - batch_start);
+            Vector3f ends[OA_BENDYRULER_PROBE_BATCH];
+            for (uint8_t i = 0; i < batch_size; i++) {
+                ends[i] = probe_end(batch_start + i);
+                margins[i] = FLT_MAX;
+            }
+            IGNORE_RETURN(db.get_min_margins_to_segments(start, ends, batch_size, margins));
+        }
+        gbenchmark_escape(margins);
+    }
+}
+
+BENCHMARK(BM_OADatabaseMarginPerProbe);
+BENCHMARK(BM_OADatabaseMarginBatched);
+
+BENCHMARK_MAIN();
@@ -229,7 +229,7 @@ bool AC_PolyFence_loader::breached(const Location& loc) const
     // check we are inside each inclusion zone:
     for (uint8_t i=0; i<_num_loaded_inclusion_boundaries; i++) {
         const InclusionBoundary &boundary = _loaded_inclusion_boundary[i];
-        if (Polygon_outside(pos, boundary.points_lla, boundary.count)) {
+        if (boundary.index_lla.outside(pos)) {
             return true;
         }
     }
@@ -237,7 +237,7 @@ bool AC_PolyFence_loader::breached(const Location& loc) const
     // check we are outside each exclusion zone:
     for (uint8_t i=0; i<_num_loaded_exclusion_boundaries; i++) {
         const ExclusionBoundary &boundary = _loaded_exclusion_boundary[i];
-        if (!Polygon_outside(pos, boundary.points_lla, boundary.count)) {
+        if (!boundary.index_lla.outside(pos)) {
             return true;
         }
     }
@@ -358,30 +358,29 @@ out:
     return ret;
 }
 
-bool AC_PolyFence_loader::scale_latlon_from_origin(const Location &origin, const Vector2l &point, Vector2f &pos_cm)
+bool AC_PolyFence_loader::scale_latlon_from_origin(const LocationProjection &origin, const Vector2l &point, Vector2f &pos_cm)
 {
-    Location tmp_loc;
-    tmp_loc.lat = point.x;
-    tmp_loc.lng = point.y;
-    pos_cm = origin.get_distance_NE(tmp_loc) * 100.0f;
+    pos_cm = origin.to_NE(point.x, point.y) * 100.0f;
     return true;
 }
 
-bool AC_PolyFence_loader::read_polygon_from_storage(const Location &origin, uint16_t &read_offset, const uint8_t vertex_count, Vector2f *&next_storage_point, Vector2l *&next_storage_point_lla)
+bool AC_PolyFence_loader::read_polygon_from_storage(const LocationProjection &origin, uint16_t &read_offset, const uint8_t vertex_count, Vector2f *&next_storage_point, Vector2l *&next_storage_point_lla)
 {
+    // read from storage to lat/lon
     for (uint8_t i=0; i<vertex_count; i++) {
-        // read from storage to lat/lon
-        if (!read_latlon_from_storage(read_offset, *next_storage_point_lla)) {
+        if (!read_latlon_from_storage(read_offset, next_storage_point_lla[i])) {
             return false;
         }
-        // convert lat/lon to position in cm from origin
-        if (!scale_latlon_from_origin(origin, *next_storage_point_lla, *next_storage_point)) {
-            return false;
-        }
-        
-        next_storage_point_lla++;
-        next_storage_point++;
     }
+
+    // convert lat/lon to position in cm from origin
+    origin.to_NE(next_storage_point_lla, next_storage_point, vertex_count);
+    for (uint8_t i=0; i<vertex_count; i++) {
+        next_storage_point[i] *= 100.0f;
+    }
+
+    next_storage_point_lla += vertex_count;
+    next_storage_point += vertex_count;
     return true;
 }
 
@@ -648,11 +647,13 @@ bool AC_PolyFence_loader::load_from_eeprom()
         return _load_time_ms != 0;
     }
 
-    struct Location ekf_origin{};
-    if (!AP::ahrs().get_origin(ekf_origin)) {
+    struct Location ekf_origin_loc{};
+    if (!AP::ahrs().get_origin(ekf_origin_loc)) {
 //        Debug("fence load requires origin");
         return false;
     }
+    // all loaded points are converted to offsets from the origin
+    const LocationProjection ekf_origin{ekf_origin_loc};
 
     // find indexes of each fence:
     if (!get_loaded_fence_semaphore().take_nonblocking()) {
@@ -770,6 +771,9 @@ bool AC_PolyFence_loader::load_from_eeprom()
                 storage_valid = false;
                 break;
             }
+            // queries scan every edge if the index can't be allocated
+            boundary.index.init(boundary.points, boundary.count);
+            boundary.index_lla.init(boundary.points_lla, boundary.count);
             _num_loaded_inclusion_boundaries++;
             break;
         }
@@ -789,6 +793,9 @@ bool AC_PolyFence_loader::load_from_eeprom()
                 storage_valid = false;
                 break;
             }
+            // queries scan every edge if the index can't be allocated
+            boundary.index.init(boundary.points, boundary.count);
+            boundary.index_lla.init(boundary.points_lla, boundary.count);
             _num_loaded_exclusion_boundaries++;
             break;
         }
@@ -902,6 +909,14 @@ Vector2f* AC_PolyFence_loader::get_exclusion_polygon(uint16_t index, uint16_t &n
     return boundary.points;
 }
 
+const Polygon_index<float> *AC_PolyFence_loader::get_exclusion_polygon_index(uint16_t index) const
+{
+    if (index >= _num_loaded_exclusion_boundaries) {
+        return nullptr;
+    }
+    return &_loaded_exclusion_boundary[index].index;
+}
+
 /// returns pointer to array of inclusion polygon points and num_points is filled in with the number of points in the polygon
 /// points are offsets in cm from EKF origin in NE frame
 Vector2f* AC_PolyFence_loader::get_inclusion_polygon(uint16_t index, uint16_t &num_points) const
@@ -916,6 +931,14 @@ Vector2f* AC_PolyFence_loader::get_inclusion_polygon(uint16_t index, uint16_t &n
     return boundary.points;
 }
 
+const Polygon_index<float> *AC_PolyFence_loader::get_inclusion_polygon_index(uint16_t index) const
+{
+    if (index >= _num_loaded_inclusion_boundaries) {
+        return nullptr;
+    }
+    return &_loaded_inclusion_boundary[index].index;
+}
+
 /// returns the specified exclusion circle
 /// circle center offsets in cm from EKF origin in NE frame, radius is in meters
 bool AC_PolyFence_loader::get_exclusion_circle(uint8_t index, Vector2f &center_pos_cm, float &radius) const
@@ -1684,7 +1707,9 @@ void AC_PolyFence_loader::init() {};
 bool AC_PolyFence_loader::get_item(const uint16_t seq, AC_PolyFenceItem &item) { return false; }
 
 Vector2f* AC_PolyFence_loader::get_exclusion_polygon(uint16_t index, uint16_t &num_points) const { return nullptr; }
+const Polygon_index<float> *AC_PolyFence_loader::get_exclusion_polygon_index(uint16_t index) const { return nullptr; }
 Vector2f* AC_PolyFence_loader::get_inclusion_polygon(uint16_t index, uint16_t &num_points) const { return nullptr; }
+const Polygon_index<float> *AC_PolyFence_loader::get_inclusion_polygon_index(uint16_t index) const { return nullptr; }
 
 bool AC_PolyFence_loader::get_exclusion_circle(uint8_t index, Vector2f &center_pos_cm, float &radius) const { return false; }
 bool AC_PolyFence_loader::get_inclusion_circle(uint8_t index, Vector2f &center_pos_cm, float &radius) const { return false; }
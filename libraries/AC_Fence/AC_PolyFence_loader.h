@@ -71,6 +71,10 @@ public:
     /// points are offsets in cm from EKF origin in NE frame
     Vector2f* get_exclusion_polygon(uint16_t index, uint16_t &num_points) const;
 
+    /// returns the index of the exclusion polygon points for fast
+    /// containment queries, or nullptr if the polygon does not exist
+    const Polygon_index<float> *get_exclusion_polygon_index(uint16_t index) const;
+
     /// return system time of last update to the exclusion polygon points
     uint32_t get_exclusion_polygon_update_ms() const {
         return _load_time_ms;
@@ -88,6 +92,10 @@ public:
     /// points are offsets in cm from EKF origin in NE frame
     Vector2f* get_inclusion_polygon(uint16_t index, uint16_t &num_points) const;
 
+    /// returns the index of the inclusion polygon points for fast
+    /// containment queries, or nullptr if the polygon does not exist
+    const Polygon_index<float> *get_inclusion_polygon_index(uint16_t index) const;
+
     /// return system time of last update to the inclusion polygon points
     uint32_t get_inclusion_polygon_update_ms() const {
         return _load_time_ms;
@@ -285,6 +293,8 @@ private:
         Vector2f *points; // pointer into the _loaded_offsets_from_origin array
         Vector2l *points_lla; // pointer into the _loaded_points_lla array
         uint8_t count; // count of points in the boundary
+        Polygon_index<float> index; // index of points
+        Polygon_index<int32_t> index_lla; // index of points_lla
     };
     InclusionBoundary *_loaded_inclusion_boundary;
 
@@ -295,6 +305,8 @@ private:
         Vector2f *points; // pointer into the _loaded_offsets_from_origin array
         Vector2l *points_lla; // pointer into the _loaded_points_lla_lla array
         uint8_t count; // count of points in the boundary
+        Polygon_index<float> index; // index of points
+        Polygon_index<int32_t> index_lla; // index of points_lla
     };
     ExclusionBoundary *_loaded_exclusion_boundary;
 
@@ -339,7 +351,7 @@ private:
     // scale_latlon_from_origin - given a latitude/longitude
     // transforms the point to an offset-from-origin and deposits
     // the result into pos_cm.
-    bool scale_latlon_from_origin(const Location &origin,
+    bool scale_latlon_from_origin(const LocationProjection &origin,
                                   const Vector2l &point,
                                   Vector2f &pos_cm) WARN_IF_UNUSED;
    
@@ -347,7 +359,7 @@ private:
     // latitude/longitude points from offset in permanent storage,
     // transforms them into an offset-from-origin and deposits the
     // results into next_storage_point.
-    bool read_polygon_from_storage(const Location &origin,
+    bool read_polygon_from_storage(const LocationProjection &origin,
                                    uint16_t &read_offset,
                                    const uint8_t vertex_count,
                                    Vector2f *&next_storage_point,
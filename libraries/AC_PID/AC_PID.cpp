@@ -90,6 +90,11 @@ AC_PID::AC_PID(float initial_p, float initial_i, float initial_d, float initial_
 
     memset(&_pid_info, 0, sizeof(_pid_info));
 
+    // force the filter time constants to be calculated on the first update
+    _filt_rc.T_hz = -1.0f;
+    _filt_rc.E_hz = -1.0f;
+    _filt_rc.D_hz = -1.0f;
+
     // slew limit scaler allows for plane to use degrees/sec slew
     // limit
     _slew_limit_scale = 1;
@@ -124,6 +129,24 @@ void AC_PID::slew_limit(float smax)
 //  the derivative is then calculated and filtered
 //  the integral is then updated based on the setting of the limit flag
 float AC_PID::update_all(float target, float measurement, float dt, bool limit, float boost)
+{
+    return update_all(target, measurement, dt, is_positive(dt) ? 1.0f / dt : 0.0f, limit, boost);
+}
+
+//  update_all_3axis - update_all for three controllers at once, e.g. the roll, pitch and yaw rate controllers
+//  each controller keeps its own gains, filters and slew limiter, the dt dependent calculations are shared
+//  limit is an array of three flags, one per axis, with the same meaning as update_all's limit argument
+//  returns the output of each controller in x, y and z
+Vector3f AC_PID::update_all_3axis(AC_PID &pid_x, AC_PID &pid_y, AC_PID &pid_z, const Vector3f &target, const Vector3f &measurement, float dt, const bool limit[3], const Vector3f &boost)
+{
+    const float dt_inv = is_positive(dt) ? 1.0f / dt : 0.0f;
+    return Vector3f{pid_x.update_all(target.x, measurement.x, dt, dt_inv, limit[0], boost.x),
+                    pid_y.update_all(target.y, measurement.y, dt, dt_inv, limit[1], boost.y),
+                    pid_z.update_all(target.z, measurement.z, dt, dt_inv, limit[2], boost.z)};
+}
+
+// update_all with the inverse of dt pre-calculated by the caller
+float AC_PID::update_all(float target, float measurement, float dt, float dt_inv, bool limit, float boost)
 {
     // don't process inf or NaN
     if (!isfinite(target) || !isfinite(measurement)) {
@@ -137,14 +160,15 @@ float AC_PID::update_all(float target, float measurement, float dt, bool limit,
         _error = _target - measurement;
         _derivative = 0.0f;
     } else {
+        update_filt_rc();
         float error_last = _error;
-        _target += get_filt_T_alpha(dt) * (target - _target);
-        _error += get_filt_E_alpha(dt) * ((_target - measurement) - _error);
+        _target += get_filt_alpha(dt, _filt_T_hz, _filt_rc.T) * (target - _target);
+        _error += get_filt_alpha(dt, _filt_E_hz, _filt_rc.E) * ((_target - measurement) - _error);
 
         // calculate and filter derivative
         if (is_positive(dt)) {
-            float derivative = (_error - error_last) / dt;
-            _derivative += get_filt_D_alpha(dt) * (derivative - _derivative);
+            float derivative = (_error - error_last) * dt_inv;
+            _derivative += get_filt_alpha(dt, _filt_D_hz, _filt_rc.D) * (derivative - _derivative);
         }
     }
 
@@ -195,13 +219,14 @@ float AC_PID::update_error(float error, float dt, bool limit)
         _error = error;
         _derivative = 0.0f;
     } else {
+        update_filt_rc();
         float error_last = _error;
-        _error += get_filt_E_alpha(dt) * (error - _error);
+        _error += get_filt_alpha(dt, _filt_E_hz, _filt_rc.E) * (error - _error);
 
         // calculate and filter derivative
         if (is_positive(dt)) {
             float derivative = (_error - error_last) / dt;
-            _derivative += get_filt_D_alpha(dt) * (derivative - _derivative);
+            _derivative += get_filt_alpha(dt, _filt_D_hz, _filt_rc.D) * (derivative - _derivative);
         }
     }
 
@@ -327,6 +352,34 @@ float AC_PID::get_filt_D_alpha(float dt) const
     return calc_lowpass_alpha_dt(dt, _filt_D_hz);
 }
 
+// update_filt_rc - update the cached filter time constants if the filter frequencies have changed
+// dt varies with the measured loop time so only the dt independent part of the filter alphas is cached
+void AC_PID::update_filt_rc()
+{
+    if (!is_equal(_filt_rc.T_hz, _filt_T_hz.get())) {
+        _filt_rc.T_hz = _filt_T_hz;
+        _filt_rc.T = is_positive(_filt_T_hz.get()) ? 1.0f / (M_2PI * _filt_T_hz) : 0.0f;
+    }
+    if (!is_equal(_filt_rc.E_hz, _filt_E_hz.get())) {
+        _filt_rc.E_hz = _filt_E_hz;
+        _filt_rc.E = is_positive(_filt_E_hz.get()) ? 1.0f / (M_2PI * _filt_E_hz) : 0.0f;
+    }
+    if (!is_equal(_filt_rc.D_hz, _filt_D_hz.get())) {
+        _filt_rc.D_hz = _filt_D_hz;
+        _filt_rc.D = is_positive(_filt_D_hz.get()) ? 1.0f / (M_2PI * _filt_D_hz) : 0.0f;
+    }
+}
+
+// get_filt_alpha - calculate a filter alpha using a cached filter time constant
+// falls back to calc_lowpass_alpha_dt for the zero and invalid dt or frequency cases
+float AC_PID::get_filt_alpha(float dt, float filt_hz, float rc) const
+{
+    if (!is_positive(dt) || !is_positive(filt_hz)) {
+        return calc_lowpass_alpha_dt(dt, filt_hz);
+    }
+    return dt / (dt + rc);
+}
+
 void AC_PID::set_integrator(float target, float measurement, float integrator)
 {
     set_integrator(target - measurement, integrator);
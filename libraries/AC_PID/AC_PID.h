@@ -33,6 +33,12 @@ public:
     //  the integral is then updated based on the setting of the limit flag
     float update_all(float target, float measurement, float dt, bool limit = false, float boost = 1.0f);
 
+    //  update_all_3axis - update_all for three controllers at once, e.g. the roll, pitch and yaw rate controllers
+    //  each controller keeps its own gains, filters and slew limiter, the dt dependent calculations are shared
+    //  limit is an array of three flags, one per axis, with the same meaning as update_all's limit argument
+    //  returns the output of each controller in x, y and z
+    static Vector3f update_all_3axis(AC_PID &pid_x, AC_PID &pid_y, AC_PID &pid_z, const Vector3f &target, const Vector3f &measurement, float dt, const bool limit[3], const Vector3f &boost);
+
     //  update_error - set error input to PID controller and calculate outputs
     //  target is set to zero and error is set and filtered
     //  the derivative then is calculated and filtered
@@ -126,6 +132,15 @@ public:
     
 protected:
 
+    // update_all with the inverse of dt pre-calculated by the caller
+    float update_all(float target, float measurement, float dt, float dt_inv, bool limit, float boost);
+
+    // update the cached filter time constants if the filter frequencies have changed
+    void update_filt_rc();
+
+    // calculate a filter alpha using a cached filter time constant
+    float get_filt_alpha(float dt, float filt_hz, float rc) const;
+
     // parameters
     AP_Float _kp;
     AP_Float _ki;
@@ -151,5 +166,15 @@ protected:
     float _derivative;        // derivative value to enable filtering
     int8_t _slew_limit_scale;
 
+    // filter time constants cached for the filter frequencies they were calculated for
+    struct {
+        float T_hz;
+        float E_hz;
+        float D_hz;
+        float T;
+        float E;
+        float D;
+    } _filt_rc;
+
     AP_PIDInfo _pid_info;
 };
@@ -115,7 +115,7 @@ const AP_Param::GroupInfo AC_PrecLand::var_info[] = {
 
     // @Param: LAG
     // @DisplayName: Precision Landing sensor lag
-    // @Description: Precision Landing sensor lag, to cope with variable landing_target latency
+    // @Description: Precision Landing sensor lag, to cope with variable landing_target latency. This is the starting value when the lag is estimated, see PLND_OPTIONS
     // @Range: 0.02 0.250
     // @Increment: 1
     // @Units: s
@@ -173,7 +173,7 @@ const AP_Param::GroupInfo AC_PrecLand::var_info[] = {
     // @Param: OPTIONS
     // @DisplayName: Precision Landing Extra Options
     // @Description: Precision Landing Extra Options
-    // @Bitmask: 0: Moving Landing Target
+    // @Bitmask: 0: Moving Landing Target, 1: Estimate sensor lag
     // @User: Advanced
     AP_GROUPINFO("OPTIONS", 17, AC_PrecLand, _options, 0),
 
@@ -221,7 +221,11 @@ void AC_PrecLand::init(uint16_t update_rate_hz)
     _lag.set(constrain_float(_lag, 0.02f, 0.25f));
 
     // calculate inertial buffer size from lag and minimum of main loop rate and update_rate_hz argument
-    const uint16_t inertial_buffer_size = MAX((uint16_t)roundf(_lag * MIN(update_rate_hz, AP::scheduler().get_loop_rate_hz())), 1);
+    // when the lag is estimated the buffer covers the longest lag allowed
+    _inertial_rate_hz = MAX(MIN(update_rate_hz, AP::scheduler().get_loop_rate_hz()), 1);
+    const float buffer_lag = (_options & PLND_OPTION_ESTIMATE_LAG) ? 0.25f : _lag.get();
+    const uint16_t inertial_buffer_size = MAX((uint16_t)roundf(buffer_lag * _inertial_rate_hz), 1);
+    _lag_frames = MAX((uint16_t)roundf(_lag * _inertial_rate_hz), 1) - 1;
 
     // instantiate ring buffer to hold inertial history, return on failure so no backends are created
     _inertial_history = new ObjectArray<inertial_data_frame_s>(inertial_buffer_size);
@@ -476,9 +480,16 @@ void AC_PrecLand::handle_msg(const mavlink_landing_target_t &packet, uint32_t ti
 // Private methods
 //
 
+// the inertial frame from _lag_frames ago, or the oldest we have
+const AC_PrecLand::inertial_data_frame_s *AC_PrecLand::get_inertial_data_delayed() const
+{
+    const uint16_t available = _inertial_history->available();
+    return (*_inertial_history)[available > _lag_frames ? available - 1 - _lag_frames : 0];
+}
+
 void AC_PrecLand::run_estimator(float rangefinder_alt_m, bool rangefinder_alt_valid)
 {
-    const struct inertial_data_frame_s *inertial_data_delayed = (*_inertial_history)[0];
+    const struct inertial_data_frame_s *inertial_data_delayed = get_inertial_data_delayed();
 
     switch ((EstimatorType)_estimator_type.get()) {
         case EstimatorType::RAW_SENSOR: {
@@ -500,7 +511,7 @@ void AC_PrecLand::run_estimator(float rangefinder_alt_m, bool rangefinder_alt_va
             }
 
             // Update if a new Line-Of-Sight measurement is available
-            if (construct_pos_meas_using_rangefinder(rangefinder_alt_m, rangefinder_alt_valid)) {
+            if (construct_pos_meas_using_rangefinder(rangefinder_alt_m, rangefinder_alt_valid) > 0) {
                 if (!_estimator_initialized) {
                     gcs().send_text(MAV_SEVERITY_INFO, "PrecLand: Target Found");
                     _estimator_initialized = true;
@@ -531,8 +542,9 @@ void AC_PrecLand::run_estimator(float rangefinder_alt_m, bool rangefinder_alt_va
             }
 
             // Update if a new Line-Of-Sight measurement is available
-            if (construct_pos_meas_using_rangefinder(rangefinder_alt_m, rangefinder_alt_valid)) {
-                float xy_pos_var = sq(_target_pos_rel_meas_NED.z*(0.01f + 0.01f*AP::ahrs().get_gyro().length()) + 0.02f);
+            const uint8_t num_meas = construct_pos_meas_using_rangefinder(rangefinder_alt_m, rangefinder_alt_valid);
+            if (num_meas > 0) {
+                const float xy_pos_var = sq(_target_pos_rel_meas_NED.z*(0.01f + 0.01f*AP::ahrs().get_gyro().length()) + 0.02f);
                 if (!_estimator_initialized) {
                     // Inform the user landing target has been found
                     gcs().send_text(MAV_SEVERITY_INFO, "PrecLand: Target Found");
@@ -550,15 +562,22 @@ void AC_PrecLand::run_estimator(float rangefinder_alt_m, bool rangefinder_alt_va
                     // we have initialized the estimator but will not use the values for sometime so that EKF settles down
                     _estimator_initialized = true;
                 } else {
-                    float NIS_x = _ekf_x.getPosNIS(_target_pos_rel_meas_NED.x, xy_pos_var);
-                    float NIS_y = _ekf_y.getPosNIS(_target_pos_rel_meas_NED.y, xy_pos_var);
-                    if (MAX(NIS_x, NIS_y) < 3.0f || _outlier_reject_count >= 3) {
-                        _outlier_reject_count = 0;
-                        _ekf_x.fusePos(_target_pos_rel_meas_NED.x, xy_pos_var);
-                        _ekf_y.fusePos(_target_pos_rel_meas_NED.y, xy_pos_var);
-                        _last_update_ms = AP_HAL::millis();
-                    } else {
-                        _outlier_reject_count++;
+                    // detections from one frame share the attitude and timing errors they were measured with, so each is
+                    // fused with its variance scaled by their number, as if their mean were fused once, but outliers amongst
+                    // them are still rejected on their own
+                    const float meas_var = xy_pos_var * num_meas;
+                    for (uint8_t i=0; i<num_meas; i++) {
+                        const Vector3f &pos_meas = _pos_meas_NED[i];
+                        float NIS_x = _ekf_x.getPosNIS(pos_meas.x, meas_var);
+                        float NIS_y = _ekf_y.getPosNIS(pos_meas.y, meas_var);
+                        if (MAX(NIS_x, NIS_y) < 3.0f || _outlier_reject_count >= 3) {
+                            _outlier_reject_count = 0;
+                            _ekf_x.fusePos(pos_meas.x, meas_var);
+                            _ekf_y.fusePos(pos_meas.y, meas_var);
+                            _last_update_ms = AP_HAL::millis();
+                        } else {
+                            _outlier_reject_count++;
+                        }
                     }
                 }
             }
@@ -600,17 +619,28 @@ void AC_PrecLand::check_ekf_init_timeout()
     }
 }
 
-bool AC_PrecLand::retrieve_los_meas(Vector3f& target_vec_unit_body)
+uint8_t AC_PrecLand::retrieve_los_meas(los_meas_s meas[AC_PRECLAND_MEAS_MAX])
 {
-    if (_backend->have_los_meas() && _backend->los_meas_time_ms() != _last_backend_los_meas_ms) {
-        _last_backend_los_meas_ms = _backend->los_meas_time_ms();
-        _backend->get_los_body(target_vec_unit_body);
+    // backends which queue their measurements give all of those since the last call,
+    // others only the latest
+    uint8_t count = _backend->get_los_meas_queued(meas, AC_PRECLAND_MEAS_MAX);
+    if (count == 0 && _backend->have_los_meas() && _backend->los_meas_time_ms() != _last_backend_los_meas_ms) {
+        _backend->get_los_body(meas[0].dir_body);
+        meas[0].distance = _backend->distance_to_target();
+        count = 1;
+    }
+    if (count == 0) {
+        return 0;
+    }
+    _last_backend_los_meas_ms = _backend->los_meas_time_ms();
+
+    for (uint8_t i=0; i<count; i++) {
+        Vector3f &target_vec_unit_body = meas[i].dir_body;
         if (!is_zero(_yaw_align)) {
             // Apply sensor yaw alignment rotation
             target_vec_unit_body.rotate_xy(radians(_yaw_align*0.01f));
         }
 
-
         // rotate vector based on sensor oriention to get correct body frame vector
         if (_orient != ROTATION_PITCH_270) {
             // by default, the vector is constructed downwards in body frame
@@ -623,61 +653,155 @@ bool AC_PrecLand::retrieve_los_meas(Vector3f& target_vec_unit_body)
             target_vec_unit_body.rotate(ROTATION_PITCH_90); // bring vector to front
             target_vec_unit_body.rotate(_orient);           // rotate it to desired orientation
         }
-
-        return true;
-    } else {
-        return false;
     }
+
+    return count;
 }
 
-bool AC_PrecLand::construct_pos_meas_using_rangefinder(float rangefinder_alt_m, bool rangefinder_alt_valid)
+uint8_t AC_PrecLand::construct_pos_meas_using_rangefinder(float rangefinder_alt_m, bool rangefinder_alt_valid)
 {
-    Vector3f target_vec_unit_body;
-    if (retrieve_los_meas(target_vec_unit_body)) {
-        const struct inertial_data_frame_s *inertial_data_delayed = (*_inertial_history)[0];
+    los_meas_s meas[AC_PRECLAND_MEAS_MAX];
+    const uint8_t count = retrieve_los_meas(meas);
+    if (count == 0) {
+        return 0;
+    }
+
+    const struct inertial_data_frame_s *inertial_data_delayed = get_inertial_data_delayed();
+    const Vector3f approach_vector_NED = inertial_data_delayed->Tbn * _approach_vector_body;
+
+    // figure out ned camera orientation w.r.t its offset
+    Vector3f cam_pos_ned;
+    if (!_cam_offset.get().is_zero()) {
+        // user has specifed offset for camera
+        // take its height into account while calculating distance
+        cam_pos_ned = inertial_data_delayed->Tbn * _cam_offset;
+    }
+
+    // Compute camera position relative to IMU
+    const Vector3f accel_pos_ned = inertial_data_delayed->Tbn * AP::ins().get_imu_pos_offset(AP::ahrs().get_primary_accel_index());
+    const Vector3f cam_pos_ned_rel_imu = cam_pos_ned - accel_pos_ned;
 
+    uint8_t num_valid = 0;
+    Vector3f pos_sum;
+    for (uint8_t i=0; i<count; i++) {
+        const Vector3f &target_vec_unit_body = meas[i].dir_body;
         const bool target_vec_valid = target_vec_unit_body.projected(_approach_vector_body).dot(_approach_vector_body) > 0.0f;
         const Vector3f target_vec_unit_ned = inertial_data_delayed->Tbn * target_vec_unit_body;
-        const Vector3f approach_vector_NED = inertial_data_delayed->Tbn * _approach_vector_body;
-        const bool alt_valid = (rangefinder_alt_valid && rangefinder_alt_m > 0.0f) || (_backend->distance_to_target() > 0.0f);
-        if (target_vec_valid && alt_valid) {
-            // distance to target and distance to target along approach vector
-            float dist_to_target, dist_to_target_along_av;
-            // figure out ned camera orientation w.r.t its offset
-            Vector3f cam_pos_ned;
-            if (!_cam_offset.get().is_zero()) {
-                // user has specifed offset for camera
-                // take its height into account while calculating distance
-                cam_pos_ned = inertial_data_delayed->Tbn * _cam_offset;
-            }
-            if (_backend->distance_to_target() > 0.0f) {
-                // sensor has provided distance to landing target
-                dist_to_target = _backend->distance_to_target();
-            } else {
-                // sensor only knows the horizontal location of the landing target
-                // rely on rangefinder for the vertical target
-                dist_to_target_along_av = MAX(rangefinder_alt_m - cam_pos_ned.projected(approach_vector_NED).length(), 0.0f);
-                dist_to_target = dist_to_target_along_av / target_vec_unit_ned.projected(approach_vector_NED).length();
-            }
+        const bool alt_valid = (rangefinder_alt_valid && rangefinder_alt_m > 0.0f) || (meas[i].distance > 0.0f);
+        if (!target_vec_valid || !alt_valid) {
+            continue;
+        }
+        if (num_valid == 0) {
+            update_lag_estimate(target_vec_unit_body);
+        }
+
+        // distance to target and distance to target along approach vector
+        float dist_to_target, dist_to_target_along_av;
+        if (meas[i].distance > 0.0f) {
+            // sensor has provided distance to landing target
+            dist_to_target = meas[i].distance;
+        } else {
+            // sensor only knows the horizontal location of the landing target
+            // rely on rangefinder for the vertical target
+            dist_to_target_along_av = MAX(rangefinder_alt_m - cam_pos_ned.projected(approach_vector_NED).length(), 0.0f);
+            dist_to_target = dist_to_target_along_av / target_vec_unit_ned.projected(approach_vector_NED).length();
+        }
+
+        // Compute target position relative to IMU
+        _pos_meas_NED[num_valid] = (target_vec_unit_ned * dist_to_target) + cam_pos_ned_rel_imu;
+        pos_sum += _pos_meas_NED[num_valid];
+        num_valid++;
+    }
+    if (num_valid == 0) {
+        return 0;
+    }
+    _target_pos_rel_meas_NED = pos_sum / num_valid;
 
-            // Compute camera position relative to IMU
-            const Vector3f accel_pos_ned = inertial_data_delayed->Tbn * AP::ins().get_imu_pos_offset(AP::ahrs().get_primary_accel_index());
-            const Vector3f cam_pos_ned_rel_imu = cam_pos_ned - accel_pos_ned;
+    // store the current relative down position so that if we need to retry landing, we know at this height landing target can be found
+    const AP_AHRS &_ahrs = AP::ahrs();
+    Vector3f pos_NED;
+    if (_ahrs.get_relative_position_NED_origin(pos_NED)) {
+        _last_target_pos_rel_origin_NED.z = pos_NED.z;
+        _last_vehicle_pos_NED = pos_NED;
+    }
+    return num_valid;
+}
 
-            // Compute target position relative to IMU
-            _target_pos_rel_meas_NED = (target_vec_unit_ned * dist_to_target) + cam_pos_ned_rel_imu;
+/*
+  estimate the sensor lag. Between two measurements a stationary target
+  appears to move in body frame by the vehicle's rotation (and by a
+  little from its translation). Rotating each measurement into NED with
+  the attitude from the right lag takes the rotation out, so we keep
+  the filtered change in the NED direction for a set of candidate lags
+  and use the one with the least
+ */
+void AC_PrecLand::update_lag_estimate(const Vector3f &target_vec_unit_body)
+{
+    if (!(_options & PLND_OPTION_ESTIMATE_LAG)) {
+        return;
+    }
+    const uint16_t available = _inertial_history->available();
+    if (available < _inertial_history->size()) {
+        // not enough history yet
+        return;
+    }
 
-            // store the current relative down position so that if we need to retry landing, we know at this height landing target can be found
-            const AP_AHRS &_ahrs = AP::ahrs();
-            Vector3f pos_NED;
-            if (_ahrs.get_relative_position_NED_origin(pos_NED)) {
-                _last_target_pos_rel_origin_NED.z = pos_NED.z;
-                _last_vehicle_pos_NED = pos_NED;
+    // only compare measurements close together, and while the vehicle
+    // is rotating, otherwise every lag fits as well as any other
+    const uint32_t now_ms = AP_HAL::millis();
+    const bool compare = (now_ms - _lag_est.last_meas_ms < 200) && (AP::ahrs().get_gyro().length() > radians(10));
+    _lag_est.last_meas_ms = now_ms;
+
+    // candidates are spread evenly over the history
+    const float frames_per_candidate = (available - 1) / float(AC_PRECLAND_LAG_CANDIDATES - 1);
+    for (uint8_t i=0; i<AC_PRECLAND_LAG_CANDIDATES; i++) {
+        const uint16_t frames = roundf(i * frames_per_candidate);
+        const Vector3f los_NED = (*_inertial_history)[available - 1 - frames]->Tbn * target_vec_unit_body;
+        if (compare) {
+            const float err = (los_NED - _lag_est.last_los_NED[i]).length_squared();
+            if (_lag_est.samples == 0) {
+                _lag_est.cost[i] = err;
+            } else {
+                _lag_est.cost[i] += 0.02f * (err - _lag_est.cost[i]);
             }
-            return true;
         }
+        _lag_est.last_los_NED[i] = los_NED;
+    }
+    if (!compare) {
+        return;
+    }
+    if (_lag_est.samples < 50) {
+        // keep PLND_LAG until we have seen enough rotation
+        _lag_est.samples++;
+        return;
+    }
+
+    uint8_t best = 0;
+    for (uint8_t i=1; i<AC_PRECLAND_LAG_CANDIDATES; i++) {
+        if (_lag_est.cost[i] < _lag_est.cost[best]) {
+            best = i;
+        }
+    }
+    float best_frames = best * frames_per_candidate;
+    if (best > 0 && best < AC_PRECLAND_LAG_CANDIDATES-1) {
+        // fit a parabola through the neighbours to find the lag between candidates
+        const float c0 = _lag_est.cost[best-1];
+        const float c1 = _lag_est.cost[best];
+        const float c2 = _lag_est.cost[best+1];
+        const float denom = c0 - 2.0f * c1 + c2;
+        if (is_positive(denom)) {
+            best_frames += 0.5f * (c0 - c2) / denom * frames_per_candidate;
+        }
+    }
+
+    // move a frame at a time, so the estimator neither skips nor repeats
+    // more than one frame of the history when the lag changes
+    const uint16_t target_frames = constrain_float(roundf(best_frames), 0, available - 1);
+    if (target_frames > _lag_frames) {
+        _lag_frames++;
+    } else if (target_frames < _lag_frames) {
+        _lag_frames--;
     }
-    return false;
 }
 
 void AC_PrecLand::run_output_prediction()
@@ -686,7 +810,8 @@ void AC_PrecLand::run_output_prediction()
     _target_vel_rel_out_NE = _target_vel_rel_est_NE;
 
     // Predict forward from delayed time horizon
-    for (uint8_t i=1; i<_inertial_history->available(); i++) {
+    const uint16_t available = _inertial_history->available();
+    for (uint16_t i=(available > _lag_frames ? available - _lag_frames : 1); i<available; i++) {
         const struct inertial_data_frame_s *inertial_data = (*_inertial_history)[i];
         _target_vel_rel_out_NE.x -= inertial_data->correctedVehicleDeltaVelocityNED.x;
         _target_vel_rel_out_NE.y -= inertial_data->correctedVehicleDeltaVelocityNED.y;
@@ -696,7 +821,7 @@ void AC_PrecLand::run_output_prediction()
 
     const AP_AHRS &_ahrs = AP::ahrs();
 
-    const Matrix3f& Tbn = (*_inertial_history)[_inertial_history->available()-1]->Tbn;
+    const Matrix3f& Tbn = (*_inertial_history)[available-1]->Tbn;
     Vector3f accel_body_offset = AP::ins().get_imu_pos_offset(_ahrs.get_primary_accel_index());
 
     // Apply position correction for CG offset from IMU
@@ -758,7 +883,8 @@ void AC_PrecLand::Write_Precland()
         meas_z          : target_pos_meas.z,
         last_meas       : last_backend_los_meas_ms(),
         ekf_outcount    : ekf_outlier_count(),
-        estimator       : (uint8_t)_estimator_type
+        estimator       : (uint8_t)_estimator_type,
+        lag             : get_lag(),
     };
     AP::logger().WriteBlock(&pkt, sizeof(pkt));
 }
@@ -7,6 +7,16 @@
 #include <AP_HAL/utility/RingBuffer.h>
 #include <AC_PrecLand/AC_PrecLand_StateMachine.h>
 
+// maximum number of target detections fused in one update
+#ifndef AC_PRECLAND_MEAS_MAX
+#define AC_PRECLAND_MEAS_MAX 4
+#endif
+
+// number of sensor lags tried when PLND_OPTIONS has the lag estimate bit set
+#ifndef AC_PRECLAND_LAG_CANDIDATES
+#define AC_PRECLAND_LAG_CANDIDATES 16
+#endif
+
 // declare backend classes
 class AC_PrecLand_Backend;
 class AC_PrecLand_Companion;
@@ -59,6 +69,9 @@ public:
     // returns ekf outlier count
     uint32_t ekf_outlier_count() const { return _outlier_reject_count; }
 
+    // returns the sensor lag in seconds, estimated or from PLND_LAG
+    float get_lag() const { return _lag_frames / (float)_inertial_rate_hz; }
+
     // give chance to driver to get updates from sensor, should be called at 400hz
     void update(float rangefinder_alt_cm, bool rangefinder_alt_valid);
 
@@ -130,6 +143,7 @@ private:
     enum PLndOptions {
         PLND_OPTION_DISABLED = 0,
         PLND_OPTION_MOVING_TARGET = (1 << 0),
+        PLND_OPTION_ESTIMATE_LAG = (1 << 1),
     };
 
     // check the status of the target
@@ -147,11 +161,21 @@ private:
     // run target position estimator
     void run_estimator(float rangefinder_alt_m, bool rangefinder_alt_valid);
 
-    // If a new measurement was retrieved, sets _target_pos_rel_meas_NED and returns true
-    bool construct_pos_meas_using_rangefinder(float rangefinder_alt_m, bool rangefinder_alt_valid);
+    // a line-of-sight measurement from the sensor
+    struct los_meas_s {
+        Vector3f dir_body;      // unit vector towards the target in body frame
+        float distance;         // distance to the target in meters, 0 if not known
+    };
+
+    // converts the new measurements to positions in _pos_meas_NED, with their mean in _target_pos_rel_meas_NED
+    // returns the number of measurements
+    uint8_t construct_pos_meas_using_rangefinder(float rangefinder_alt_m, bool rangefinder_alt_valid);
 
-    // get vehicle body frame 3D vector from vehicle to target.  returns true on success, false on failure
-    bool retrieve_los_meas(Vector3f& target_vec_unit_body);
+    // get the new vehicle body frame 3D vectors from vehicle to target, returns the number retrieved
+    uint8_t retrieve_los_meas(los_meas_s meas[AC_PRECLAND_MEAS_MAX]);
+
+    // compare the rotation of a measurement into NED at each candidate lag with the last one, and pick the lag which best takes out the vehicle's rotation
+    void update_lag_estimate(const Vector3f &target_vec_unit_body);
 
     // calculate target's position and velocity relative to the vehicle (used as input to position controller)
     // results are stored in_target_pos_rel_out_NE, _target_vel_rel_out_NE
@@ -189,6 +213,7 @@ private:
     uint32_t                    _outlier_reject_count;  // mini-EKF's outlier counter (3 consecutive outliers lead to EKF accepting updates)
 
     Vector3f                    _target_pos_rel_meas_NED; // target's relative position as 3D vector
+    Vector3f                    _pos_meas_NED[AC_PRECLAND_MEAS_MAX]; // target's relative position from each of the latest detections
     Vector3f                    _approach_vector_body;   // unit vector in landing approach direction (in body frame)
 
     Vector3f                    _last_target_pos_rel_origin_NED;  // stores the last known location of the target horizontally, and the height of the vehicle where it detected this target in meters NED
@@ -212,6 +237,20 @@ private:
     };
     ObjectArray<inertial_data_frame_s> *_inertial_history;
 
+    // the inertial frame from the time of the latest measurement
+    const inertial_data_frame_s *get_inertial_data_delayed() const;
+
+    uint16_t _inertial_rate_hz = 1;     // rate frames are added to the history
+    uint16_t _lag_frames;               // age of the frame measurements are matched with, in frames
+
+    // sensor lag estimate, see update_lag_estimate()
+    struct {
+        Vector3f last_los_NED[AC_PRECLAND_LAG_CANDIDATES];  // last measurement rotated into NED at each candidate lag
+        float cost[AC_PRECLAND_LAG_CANDIDATES];             // filtered change in the NED direction between measurements
+        uint32_t last_meas_ms;
+        uint16_t samples;
+    } _lag_est;
+
     // backend state
     struct precland_state {
         bool    healthy;
@@ -31,6 +31,10 @@ public:
     // return true if there is a valid los measurement available
     virtual bool have_los_meas() = 0;
 
+    // copies up to max_count measurements received since the last call into meas, oldest first, returning the number copied
+    // backends which keep only the latest measurement leave this returning zero and are read with get_los_body()
+    virtual uint8_t get_los_meas_queued(AC_PrecLand::los_meas_s *meas, uint8_t max_count) { return 0; }
+
     // returns distance to target in meters (0 means distance is not known)
     virtual float distance_to_target() { return 0.0f; };
 
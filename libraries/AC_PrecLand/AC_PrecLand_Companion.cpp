@@ -14,6 +14,9 @@ void AC_PrecLand_Companion::init()
 void AC_PrecLand_Companion::update()
 {
     _have_los_meas = _have_los_meas && AP_HAL::millis()-_los_meas_time_ms <= 1000;
+    if (!_have_los_meas) {
+        _los_meas_queue_count = 0;
+    }
 }
 
 // provides a unit vector towards the target in body frame
@@ -37,6 +40,14 @@ bool AC_PrecLand_Companion::have_los_meas()
     return _have_los_meas;
 }
 
+uint8_t AC_PrecLand_Companion::get_los_meas_queued(AC_PrecLand::los_meas_s *meas, uint8_t max_count)
+{
+    const uint8_t count = MIN(_los_meas_queue_count, max_count);
+    memcpy(meas, _los_meas_queue, count * sizeof(meas[0]));
+    _los_meas_queue_count = 0;
+    return count;
+}
+
 // return distance to target
 float AC_PrecLand_Companion::distance_to_target()
 {
@@ -72,4 +83,12 @@ void AC_PrecLand_Companion::handle_msg(const mavlink_landing_target_t &packet, u
 
     _los_meas_time_ms = timestamp_ms;
     _have_los_meas = true;
+
+    // a camera may report several detections of the target in one frame,
+    // queue them all for the frontend, dropping the oldest if it is full
+    if (_los_meas_queue_count == ARRAY_SIZE(_los_meas_queue)) {
+        memmove(&_los_meas_queue[0], &_los_meas_queue[1], (_los_meas_queue_count-1) * sizeof(_los_meas_queue[0]));
+        _los_meas_queue_count--;
+    }
+    _los_meas_queue[_los_meas_queue_count++] = { _los_meas_body, _distance_to_target };
 }
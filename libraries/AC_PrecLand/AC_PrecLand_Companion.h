@@ -32,6 +32,9 @@ public:
     // return true if there is a valid los measurement available
     bool have_los_meas() override;
 
+    // copies the measurements received since the last call, so several detections in a frame are all used
+    uint8_t get_los_meas_queued(AC_PrecLand::los_meas_s *meas, uint8_t max_count) override;
+
     // returns distance to target in meters (0 means distance is not known)
     float distance_to_target() override;
 
@@ -45,4 +48,7 @@ private:
     bool                _have_los_meas;         // true if there is a valid measurement from the camera
     uint32_t            _los_meas_time_ms;      // system time in milliseconds when los was measured
     bool                _wrong_frame_msg_sent;
+
+    AC_PrecLand::los_meas_s _los_meas_queue[AC_PRECLAND_MEAS_MAX];   // measurements not yet taken by the frontend, oldest first
+    uint8_t             _los_meas_queue_count;
 };
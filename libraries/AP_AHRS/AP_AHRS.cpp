@@ -371,6 +371,9 @@ void AP_AHRS::update(bool skip_ins_update)
 #endif
     }
 
+    // snapshot the estimates of the active backend for this loop
+    update_state();
+
 #if AP_MODULE_SUPPORTED
     // call AHRS_update hook if any
     AP_Module::call_hook_AHRS_update(*this);
@@ -680,8 +683,26 @@ void AP_AHRS::reset()
 #endif
 }
 
+/*
+  fill the per-loop snapshot of the derived estimates. This is called
+  once per update(), after the backends have run, so that the many
+  readers of position and velocity in a loop don't each switch on the
+  active EKF type and query the backend, and so that they all see the
+  same estimate
+ */
+void AP_AHRS::update_state(void)
+{
+    state.location_ok = _get_location(state.location);
+    state.velocity_NED_ok = _get_velocity_NED(state.velocity_NED);
+    state.relpos_NED_origin_ok = _get_relative_position_NED_origin(state.relpos_NED_origin);
+    state.relpos_NE_origin_ok = _get_relative_position_NE_origin(state.relpos_NE_origin);
+    state.relpos_D_origin_ok = _get_relative_position_D_origin(state.relpos_D_origin);
+    state.ground_speed_vec = _groundspeed_vector();
+    state.ground_speed = _groundspeed();
+}
+
 // dead-reckoning support
-bool AP_AHRS::get_location(struct Location &loc) const
+bool AP_AHRS::_get_location(struct Location &loc) const
 {
     switch (active_EKF_type()) {
     case EKFType::NONE:
@@ -1204,7 +1225,7 @@ bool AP_AHRS::get_secondary_position(struct Location &loc) const
 }
 
 // EKF has a better ground speed vector estimate
-Vector2f AP_AHRS::groundspeed_vector(void)
+Vector2f AP_AHRS::_groundspeed_vector(void)
 {
     Vector3f vec;
 
@@ -1237,7 +1258,7 @@ Vector2f AP_AHRS::groundspeed_vector(void)
     return dcm.groundspeed_vector();
 }
 
-float AP_AHRS::groundspeed(void)
+float AP_AHRS::_groundspeed(void)
 {
     switch (active_EKF_type()) {
     case EKFType::NONE:
@@ -1259,7 +1280,7 @@ float AP_AHRS::groundspeed(void)
 #endif
         break;
     }
-    return groundspeed_vector().length();
+    return _groundspeed_vector().length();
 }
 
 // set the EKF's origin location in 10e7 degrees.  This should only
@@ -1314,7 +1335,7 @@ bool AP_AHRS::have_inertial_nav(void) const
 
 // return a ground velocity in meters/second, North/East/Down
 // order. Must only be called if have_inertial_nav() is true
-bool AP_AHRS::get_velocity_NED(Vector3f &vec) const
+bool AP_AHRS::_get_velocity_NED(Vector3f &vec) const
 {
     switch (active_EKF_type()) {
     case EKFType::NONE:
@@ -1473,7 +1494,7 @@ bool AP_AHRS::get_hagl(float &height) const
 
 // return a relative ground position to the origin in meters
 // North/East/Down order.
-bool AP_AHRS::get_relative_position_NED_origin(Vector3f &vec) const
+bool AP_AHRS::_get_relative_position_NED_origin(Vector3f &vec) const
 {
     switch (active_EKF_type()) {
     case EKFType::NONE:
@@ -1553,7 +1574,7 @@ bool AP_AHRS::get_relative_position_NED_home(Vector3f &vec) const
 
 // write a relative ground position estimate to the origin in meters, North/East order
 // return true if estimate is valid
-bool AP_AHRS::get_relative_position_NE_origin(Vector2f &posNE) const
+bool AP_AHRS::_get_relative_position_NE_origin(Vector2f &posNE) const
 {
     switch (active_EKF_type()) {
     case EKFType::NONE:
@@ -1581,7 +1602,7 @@ bool AP_AHRS::get_relative_position_NE_origin(Vector2f &posNE) const
 #if HAL_EXTERNAL_AHRS_ENABLED
     case EKFType::EXTERNAL: {
         Location loc, orgn;
-        if (!get_location(loc) ||
+        if (!_get_location(loc) ||
             !get_origin(orgn)) {
             return false;
         }
@@ -1617,7 +1638,7 @@ bool AP_AHRS::get_relative_position_NE_home(Vector2f &posNE) const
 
 // write a relative ground position to the origin in meters, Down
 // return true if the estimate is valid
-bool AP_AHRS::get_relative_position_D_origin(float &posD) const
+bool AP_AHRS::_get_relative_position_D_origin(float &posD) const
 {
     switch (active_EKF_type()) {
     case EKFType::NONE:
@@ -1645,7 +1666,7 @@ bool AP_AHRS::get_relative_position_D_origin(float &posD) const
     case EKFType::EXTERNAL: {
         Location orgn, loc;
         if (!get_origin(orgn) ||
-            !get_location(loc)) {
+            !_get_location(loc)) {
             return false;
         }
         posD = -(loc.alt - orgn.alt)*0.01;
@@ -89,7 +89,10 @@ public:
     void            reset();
 
     // dead-reckoning support
-    bool get_location(struct Location &loc) const;
+    bool get_location(struct Location &loc) const {
+        loc = state.location;
+        return state.location_ok;
+    }
 
     // get latest altitude estimate above ground level in meters and validity flag
     bool get_hagl(float &hagl) const WARN_IF_UNUSED;
@@ -177,10 +180,10 @@ public:
     bool get_secondary_position(struct Location &loc) const;
 
     // EKF has a better ground speed vector estimate
-    Vector2f groundspeed_vector();
+    Vector2f groundspeed_vector() const { return state.ground_speed_vec; }
 
     // return ground speed estimate in meters/second. Used by ground vehicles.
-    float groundspeed(void);
+    float groundspeed(void) const { return state.ground_speed; }
 
     const Vector3f &get_accel_ef() const {
         return _accel_ef;
@@ -199,22 +202,34 @@ public:
 
     bool have_inertial_nav() const;
 
-    bool get_velocity_NED(Vector3f &vec) const WARN_IF_UNUSED;
+    bool get_velocity_NED(Vector3f &vec) const WARN_IF_UNUSED {
+        vec = state.velocity_NED;
+        return state.velocity_NED_ok;
+    }
 
     // return the relative position NED to either home or origin
     // return true if the estimate is valid
     bool get_relative_position_NED_home(Vector3f &vec) const WARN_IF_UNUSED;
-    bool get_relative_position_NED_origin(Vector3f &vec) const WARN_IF_UNUSED;
+    bool get_relative_position_NED_origin(Vector3f &vec) const WARN_IF_UNUSED {
+        vec = state.relpos_NED_origin;
+        return state.relpos_NED_origin_ok;
+    }
 
     // return the relative position NE to either home or origin
     // return true if the estimate is valid
     bool get_relative_position_NE_home(Vector2f &posNE) const WARN_IF_UNUSED;
-    bool get_relative_position_NE_origin(Vector2f &posNE) const WARN_IF_UNUSED;
+    bool get_relative_position_NE_origin(Vector2f &posNE) const WARN_IF_UNUSED {
+        posNE = state.relpos_NE_origin;
+        return state.relpos_NE_origin_ok;
+    }
 
     // return the relative position down to either home or origin
     // baro will be used for the _home relative one if the EKF isn't
     void get_relative_position_D_home(float &posD) const;
-    bool get_relative_position_D_origin(float &posD) const WARN_IF_UNUSED;
+    bool get_relative_position_D_origin(float &posD) const WARN_IF_UNUSED {
+        posD = state.relpos_D_origin;
+        return state.relpos_D_origin_ok;
+    }
 
     // Get a derivative of the vertical position in m/s which is kinematically consistent with the vertical position is required by some control loops.
     // This is different to the vertical velocity from the EKF which is not always consistent with the vertical position due to the various errors that are being corrected for.
@@ -710,6 +725,36 @@ private:
     EKFType ekf_type(void) const;
     void update_DCM();
 
+    /*
+     * estimates of the active backend, filled once per update() by
+     * update_state() and returned by the public accessors
+     */
+    struct {
+        Location location;
+        bool location_ok;
+        Vector3f velocity_NED;
+        bool velocity_NED_ok;
+        Vector3f relpos_NED_origin;
+        bool relpos_NED_origin_ok;
+        Vector2f relpos_NE_origin;
+        bool relpos_NE_origin_ok;
+        float relpos_D_origin;
+        bool relpos_D_origin_ok;
+        Vector2f ground_speed_vec;
+        float ground_speed;
+    } state;
+
+    void update_state(void);
+
+    // backend queries used to fill state
+    bool _get_location(struct Location &loc) const;
+    bool _get_velocity_NED(Vector3f &vec) const;
+    bool _get_relative_position_NED_origin(Vector3f &vec) const;
+    bool _get_relative_position_NE_origin(Vector2f &posNE) const;
+    bool _get_relative_position_D_origin(float &posD) const;
+    Vector2f _groundspeed_vector(void);
+    float _groundspeed(void);
+
     // get the index of the current primary IMU
     uint8_t get_primary_IMU_index(void) const;
 
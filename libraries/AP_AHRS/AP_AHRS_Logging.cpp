@@ -163,7 +163,28 @@ void AP_AHRS_View::Write_Rate(const AP_Motors &motors, const AC_AttitudeControl
         accel_out       : motors.get_throttle(),
         throttle_slew   : motors.get_throttle_slew_rate()
     };
-    AP::logger().WriteBlock(&pkt_rate, sizeof(pkt_rate));
+    if (AP::logger().compact(AP_Logger::Compact::RATE)) {
+        struct log_RateH pkt_rath {
+            LOG_PACKET_HEADER_INIT(LOG_RATH_MSG),
+            time_us         : timeus,
+        };
+        pkt_rath.control_roll.set(pkt_rate.control_roll);
+        pkt_rath.roll.set(pkt_rate.roll);
+        pkt_rath.roll_out.set(pkt_rate.roll_out);
+        pkt_rath.control_pitch.set(pkt_rate.control_pitch);
+        pkt_rath.pitch.set(pkt_rate.pitch);
+        pkt_rath.pitch_out.set(pkt_rate.pitch_out);
+        pkt_rath.control_yaw.set(pkt_rate.control_yaw);
+        pkt_rath.yaw.set(pkt_rate.yaw);
+        pkt_rath.yaw_out.set(pkt_rate.yaw_out);
+        pkt_rath.control_accel.set(pkt_rate.control_accel);
+        pkt_rath.accel.set(pkt_rate.accel);
+        pkt_rath.accel_out.set(pkt_rate.accel_out);
+        pkt_rath.throttle_slew.set(pkt_rate.throttle_slew);
+        AP::logger().WriteBlock(&pkt_rath, sizeof(pkt_rath));
+    } else {
+        AP::logger().WriteBlock(&pkt_rate, sizeof(pkt_rate));
+    }
 
     /*
       log P/PD gain scale if not == 1.0
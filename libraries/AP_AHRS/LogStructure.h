@@ -9,6 +9,7 @@
     LOG_ORGN_MSG, \
     LOG_POS_MSG, \
     LOG_RATE_MSG, \
+    LOG_RATH_MSG, \
     LOG_ATSC_MSG
 
 // @LoggerMessage: AHR2
@@ -142,6 +143,40 @@ struct PACKED log_Rate {
     float   throttle_slew;
 };
 
+// @LoggerMessage: RATH
+// @Description: Compact version of RATE with half precision fields, logged instead of RATE when enabled with LOG_COMPACT
+// @Field: TimeUS: Time since system startup
+// @Field: RDes: vehicle desired roll rate
+// @Field: R: achieved vehicle roll rate
+// @Field: ROut: normalized output for Roll
+// @Field: PDes: vehicle desired pitch rate
+// @Field: P: vehicle pitch rate
+// @Field: POut: normalized output for Pitch
+// @Field: Y: achieved vehicle yaw rate
+// @Field: YOut: normalized output for Yaw
+// @Field: YDes: vehicle desired yaw rate
+// @Field: ADes: desired vehicle vertical acceleration
+// @Field: A: achieved vehicle vertical acceleration
+// @Field: AOut: percentage of vertical thrust output current being used
+// @Field: AOutSlew: vertical thrust output slew rate
+struct PACKED log_RateH {
+    LOG_PACKET_HEADER;
+    uint64_t time_us;
+    Float16_t control_roll;
+    Float16_t roll;
+    Float16_t roll_out;
+    Float16_t control_pitch;
+    Float16_t pitch;
+    Float16_t pitch_out;
+    Float16_t control_yaw;
+    Float16_t yaw;
+    Float16_t yaw_out;
+    Float16_t control_accel;
+    Float16_t accel;
+    Float16_t accel_out;
+    Float16_t throttle_slew;
+};
+
 // @LoggerMessage: VSTB
 // @Description: Log message for video stabilisation software such as Gyroflow
 // @Field: TimeUS: Time since system startup
@@ -205,6 +240,8 @@ struct PACKED log_ATSC {
         "POS","QLLfff","TimeUS,Lat,Lng,Alt,RelHomeAlt,RelOriginAlt", "sDUmmm", "FGG000" , true }, \
     { LOG_RATE_MSG, sizeof(log_Rate), \
         "RATE", "Qfffffffffffff",  "TimeUS,RDes,R,ROut,PDes,P,POut,YDes,Y,YOut,ADes,A,AOut,AOutSlew", "skk-kk-kk-oo--", "F?????????BB--" , true }, \
+    { LOG_RATH_MSG, sizeof(log_RateH), \
+        "RATH", "Qggggggggggggg",  "TimeUS,RDes,R,ROut,PDes,P,POut,YDes,Y,YOut,ADes,A,AOut,AOutSlew", "skk-kk-kk-oo--", "F?????????BB--" , true }, \
     { LOG_ATSC_MSG, sizeof(log_ATSC), \
         "ATSC", "Qffffff",  "TimeUS,AngPScX,AngPScY,AngPScZ,PDScX,PDScY,PDScZ", "s------", "F000000" , true }, \
     { LOG_VIDEO_STABILISATION_MSG, sizeof(log_Video_Stabilisation), \
@@ -120,9 +120,9 @@ const AP_Param::GroupInfo AP_Airspeed::var_info[] = {
 #ifndef HAL_BUILD_AP_PERIPH
     // @Param: _OPTIONS
     // @DisplayName: Airspeed options bitmask
-    // @Description: Bitmask of options to use with airspeed. 0:Disable use based on airspeed/groundspeed mismatch (see ARSPD_WIND_MAX), 1:Automatically reenable use based on airspeed/groundspeed mismatch recovery (see ARSPD_WIND_MAX) 2:Disable voltage correction, 3:Check that the airspeed is statistically consistent with the navigation EKF vehicle and wind velocity estimates using EKF3 (requires AHRS_EKF_TYPE = 3)
+    // @Description: Bitmask of options to use with airspeed. 0:Disable use based on airspeed/groundspeed mismatch (see ARSPD_WIND_MAX), 1:Automatically reenable use based on airspeed/groundspeed mismatch recovery (see ARSPD_WIND_MAX) 2:Disable voltage correction, 3:Check that the airspeed is statistically consistent with the navigation EKF vehicle and wind velocity estimates using EKF3 (requires AHRS_EKF_TYPE = 3), 4:Log every sensor sample in the ARSH message
     // @Description{Copter, Blimp, Rover, Sub}: This parameter and function is not used by this vehicle. Always set to 0.
-    // @Bitmask: 0:SpeedMismatchDisable, 1:AllowSpeedMismatchRecovery, 2:DisableVoltageCorrection, 3:UseEkf3Consistency
+    // @Bitmask: 0:SpeedMismatchDisable, 1:AllowSpeedMismatchRecovery, 2:DisableVoltageCorrection, 3:UseEkf3Consistency, 4:LogHighRate
     // @User: Advanced
     AP_GROUPINFO("_OPTIONS", 21, AP_Airspeed, _options, OPTIONS_DEFAULT),
 
@@ -158,6 +158,16 @@ const AP_Param::GroupInfo AP_Airspeed::var_info[] = {
     // @User: Advanced
     AP_GROUPINFO_FRAME("_OFF_PCNT", 27, AP_Airspeed, max_speed_pcnt, 0, AP_PARAM_FRAME_PLANE),    
 
+#if AP_AIRSPEED_HIGHRATE_ENABLED
+    // @Param: _HR_FLTR
+    // @DisplayName: High rate airspeed filter
+    // @Description: Cutoff frequency of the low pass filter applied to every sensor sample for the high rate airspeed used by quadplane assistance. Lower values are smoother but add delay, the delay in seconds is about 0.16 divided by this frequency. 0 disables the filter.
+    // @Range: 0 20
+    // @Units: Hz
+    // @User: Advanced
+    AP_GROUPINFO_FRAME("_HR_FLTR", 31, AP_Airspeed, _highrate_filter_hz, 5, AP_PARAM_FRAME_PLANE),
+#endif
+
 #endif
 
     // @Group: _
@@ -632,6 +642,90 @@ void AP_Airspeed::read(uint8_t i)
 #endif // HAL_BUILD_AP_PERIPH
 }
 
+#if AP_AIRSPEED_HIGHRATE_ENABLED
+/*
+  filter the samples a sensor has recorded since the last call, using
+  the time between samples so the filter is the same whatever the
+  sensor and call rates
+ */
+void AP_Airspeed::update_highrate(uint8_t i)
+{
+    if (!enabled(i) || sensor[i] == nullptr || sensor[i]->has_airspeed()) {
+        return;
+    }
+    AP_Airspeed_Backend::HighRateSample samples[16];
+    const uint8_t n = sensor[i]->get_highrate_samples(samples, ARRAY_SIZE(samples));
+    if (n == 0) {
+        return;
+    }
+
+    auto &hr = state[i].highrate;
+#if HAL_LOGGING_ENABLED
+    const bool log_samples = (_options & OptionsMask::LOG_HIGHRATE) != 0 &&
+        _log_bit != (uint32_t)-1 && AP::logger().should_log(_log_bit);
+    const uint64_t now_us = AP_HAL::micros64();
+#endif
+    for (uint8_t s=0; s<n; s++) {
+        float press = samples[s].pressure - get_offset(i);
+        switch ((enum pitot_tube_order)param[i].tube_order.get()) {
+        case PITOT_TUBE_ORDER_NEGATIVE:
+            press = -press;
+            break;
+        case PITOT_TUBE_ORDER_POSITIVE:
+            break;
+        case PITOT_TUBE_ORDER_AUTO:
+        default:
+            press = fabsf(press);
+            break;
+        }
+        const float dt = (samples[s].sample_us - hr.last_sample_us) * 1.0e-6f;
+        if (hr.last_sample_us == 0 || dt > 0.1f || !is_positive(_highrate_filter_hz)) {
+            // start again after a gap rather than filter across it
+            hr.filtered_pressure = press;
+        } else {
+            hr.filtered_pressure += calc_lowpass_alpha_dt(dt, _highrate_filter_hz) * (press - hr.filtered_pressure);
+        }
+        hr.last_sample_us = samples[s].sample_us;
+        hr.airspeed = sqrtf(MAX(hr.filtered_pressure, 0) * param[i].ratio);
+
+#if HAL_LOGGING_ENABLED
+// @LoggerMessage: ARSH
+// @Description: High rate airspeed sensor samples
+// @Field: TimeUS: Time the sample was read
+// @Field: I: Airspeed sensor instance number
+// @Field: DiffPress: Pressure difference less offset
+// @Field: Airspeed: High rate filtered airspeed
+        if (log_samples) {
+            AP::logger().WriteStreaming("ARSH",
+                                        "TimeUS,I,DiffPress,Airspeed",
+                                        "s#Pn",
+                                        "F-00",
+                                        "QBff",
+                                        now_us - (AP_HAL::micros() - samples[s].sample_us),
+                                        i,
+                                        press,
+                                        hr.airspeed);
+        }
+#endif
+    }
+}
+
+bool AP_Airspeed::get_airspeed_highrate(uint8_t i, float &airspeed, uint32_t &sample_us)
+{
+    if (i >= AIRSPEED_MAX_SENSORS || !healthy(i)) {
+        return false;
+    }
+    update_highrate(i);
+    const auto &hr = state[i].highrate;
+    if (hr.last_sample_us == 0 || AP_HAL::micros() - hr.last_sample_us > 100000) {
+        return false;
+    }
+    airspeed = hr.airspeed;
+    sample_us = hr.last_sample_us;
+    return true;
+}
+#endif // AP_AIRSPEED_HIGHRATE_ENABLED
+
 // read all airspeed sensors
 void AP_Airspeed::update()
 {
@@ -641,6 +735,11 @@ void AP_Airspeed::update()
 
     for (uint8_t i=0; i<AIRSPEED_MAX_SENSORS; i++) {
         read(i);
+#if AP_AIRSPEED_HIGHRATE_ENABLED
+        // keep the high rate airspeed and its log current when
+        // nothing else is asking for it
+        update_highrate(i);
+#endif
     }
 
 #if HAL_GCS_ENABLED
@@ -878,6 +977,9 @@ bool AP_Airspeed::enabled(uint8_t i) const { return false; }
 bool AP_Airspeed::healthy(uint8_t i) const { return false; }
 float AP_Airspeed::get_airspeed(uint8_t i) const { return 0.0; }
 float AP_Airspeed::get_differential_pressure(uint8_t i) const { return 0.0; }
+#if AP_AIRSPEED_HIGHRATE_ENABLED
+bool AP_Airspeed::get_airspeed_highrate(uint8_t i, float &airspeed, uint32_t &sample_us) { return false; }
+#endif
 
 #if AP_AIRSPEED_MSP_ENABLED
 void AP_Airspeed::handle_msp(const MSP::msp_airspeed_data_message_t &pkt) {}
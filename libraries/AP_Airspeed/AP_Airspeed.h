@@ -90,6 +90,18 @@ public:
     float get_airspeed(uint8_t i) const;
     float get_airspeed(void) const { return get_airspeed(primary); }
 
+#if AP_AIRSPEED_HIGHRATE_ENABLED
+    // airspeed in m/s from every sensor sample, filtered at
+    // ARSPD_HR_FLTR, and the time of the newest sample it includes.
+    // This can be called at any rate, and is false if the sensor
+    // isn't healthy or has no recent samples
+    bool get_airspeed_highrate(uint8_t i, float &airspeed, uint32_t &sample_us);
+    bool get_airspeed_highrate(float &airspeed) {
+        uint32_t sample_us;
+        return get_airspeed_highrate(primary, airspeed, sample_us);
+    }
+#endif
+
     // return the unfiltered airspeed in m/s
     float get_raw_airspeed(uint8_t i) const;
     float get_raw_airspeed(void) const { return get_raw_airspeed(primary); }
@@ -162,6 +174,7 @@ public:
         ON_FAILURE_AHRS_WIND_MAX_RECOVERY_DO_REENABLE         = (1<<1),   // If set then automatically enable the airspeed sensor use when healthy again.
         DISABLE_VOLTAGE_CORRECTION                            = (1<<2),
         USE_EKF_CONSISTENCY                                   = (1<<3),
+        LOG_HIGHRATE                                          = (1<<4),   // log every sample in ARSH
     };
 
     enum airspeed_type {
@@ -214,6 +227,9 @@ private:
     AP_Float _wind_max;
     AP_Float _wind_warn;
     AP_Float _wind_gate;
+#if AP_AIRSPEED_HIGHRATE_ENABLED
+    AP_Float _highrate_filter_hz;
+#endif
 
     AP_Airspeed_Params param[AIRSPEED_MAX_SENSORS];
 
@@ -252,6 +268,14 @@ private:
 #if AP_AIRSPEED_HYGROMETER_ENABLE
         uint32_t last_hygrometer_log_ms;
 #endif
+
+#if AP_AIRSPEED_HIGHRATE_ENABLED
+        struct {
+            float filtered_pressure;
+            float airspeed;
+            uint32_t last_sample_us;
+        } highrate;
+#endif
     } state[AIRSPEED_MAX_SENSORS];
 
     bool calibration_enabled;
@@ -266,6 +290,9 @@ private:
     uint32_t _log_bit = -1;     // stores which bit in LOG_BITMASK is used to indicate we should log airspeed readings
 
     void read(uint8_t i);
+#if AP_AIRSPEED_HIGHRATE_ENABLED
+    void update_highrate(uint8_t i);
+#endif
     // return the differential pressure in Pascal for the last airspeed reading for the requested instance
     // returns 0 if the sensor is not enabled
     float get_pressure(uint8_t i);
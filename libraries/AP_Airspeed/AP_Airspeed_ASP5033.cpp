@@ -128,6 +128,7 @@ void AP_Airspeed_ASP5033::timer()
 
     WITH_SEMAPHORE(sem);
     press_sum += press * press_scale;
+    record_highrate_sample(press * press_scale);
     temp_sum += temp * temp_scale;
     press_count++;
     temp_count++;
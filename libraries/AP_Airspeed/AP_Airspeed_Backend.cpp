@@ -63,3 +63,32 @@ void AP_Airspeed_Backend::set_bus_id(uint32_t id)
 {
     frontend.param[instance].bus_id.set_and_save(int32_t(id));
 }
+
+void AP_Airspeed_Backend::record_highrate_sample(float pressure)
+{
+#if AP_AIRSPEED_HIGHRATE_ENABLED
+    // overwrite the oldest sample if nobody is reading them
+    const uint8_t idx = (highrate_head + highrate_count) % HIGHRATE_SAMPLES;
+    highrate[idx].sample_us = AP_HAL::micros();
+    highrate[idx].pressure = pressure;
+    if (highrate_count < HIGHRATE_SAMPLES) {
+        highrate_count++;
+    } else {
+        highrate_head = (highrate_head + 1) % HIGHRATE_SAMPLES;
+    }
+#endif
+}
+
+#if AP_AIRSPEED_HIGHRATE_ENABLED
+uint8_t AP_Airspeed_Backend::get_highrate_samples(HighRateSample *samples, uint8_t max_samples)
+{
+    WITH_SEMAPHORE(sem);
+    const uint8_t n = MIN(highrate_count, max_samples);
+    for (uint8_t i=0; i<n; i++) {
+        samples[i] = highrate[highrate_head];
+        highrate_head = (highrate_head + 1) % HIGHRATE_SAMPLES;
+    }
+    highrate_count -= n;
+    return n;
+}
+#endif
@@ -45,6 +45,16 @@ public:
 
     virtual void handle_msp(const MSP::msp_airspeed_data_message_t &pkt) {}
 
+#if AP_AIRSPEED_HIGHRATE_ENABLED
+    struct HighRateSample {
+        uint32_t sample_us;
+        float pressure;     // differential pressure in Pascal
+    };
+
+    // take the samples recorded since the last call, oldest first
+    uint8_t get_highrate_samples(HighRateSample *samples, uint8_t max_samples);
+#endif
+
 #if AP_AIRSPEED_HYGROMETER_ENABLE
     // optional hygrometer support
     virtual bool get_hygrometer(uint32_t &last_sample_ms, float &temperature, float &humidity) { return false; }
@@ -108,6 +118,10 @@ protected:
     // set bus ID of this instance, for ARSPD_DEVID parameters
     void set_bus_id(uint32_t id);
 
+    // record a pressure sample as it is read, for the high rate
+    // airspeed. Must be called with sem held
+    void record_highrate_sample(float pressure);
+
     enum class DevType {
         SITL     = 0x01,
         MS4525   = 0x02,
@@ -124,4 +138,12 @@ protected:
 private:
     AP_Airspeed &frontend;
     uint8_t instance;
+
+#if AP_AIRSPEED_HIGHRATE_ENABLED
+    // enough for 100ms of samples at 160Hz
+    static const uint8_t HIGHRATE_SAMPLES = 16;
+    HighRateSample highrate[HIGHRATE_SAMPLES];
+    uint8_t highrate_head;
+    uint8_t highrate_count;
+#endif
 };
@@ -136,6 +136,7 @@ void AP_Airspeed_DLVR::timer()
 #pragma GCC diagnostic pop
 
     pressure_sum += INCH_OF_H2O_TO_PASCAL * press_h2o;
+    record_highrate_sample(INCH_OF_H2O_TO_PASCAL * press_h2o);
     temperature_sum += temp;
     press_count++;
     temp_count++;
@@ -203,6 +203,7 @@ void AP_Airspeed_MS4525::_collect()
     WITH_SEMAPHORE(sem);
 
     _press_sum += press + press2;
+    record_highrate_sample(0.5f * (press + press2));
     _temp_sum += temp + temp2;
     _press_count += 2;
     _temp_count += 2;
@@ -204,6 +204,7 @@ void AP_Airspeed_MS5525::calculate(void)
     WITH_SEMAPHORE(sem);
 
     pressure_sum += P_Pa;
+    record_highrate_sample(P_Pa);
     temperature_sum += Temp_C;
     press_count++;
     temp_count++;
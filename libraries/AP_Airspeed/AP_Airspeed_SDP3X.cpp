@@ -187,6 +187,7 @@ void AP_Airspeed_SDP3X::_timer()
     WITH_SEMAPHORE(sem);
 
     _press_sum += diff_press_pa;
+    record_highrate_sample(diff_press_pa);
     _temp_sum += temperature;
     _press_count++;
     _temp_count++;
@@ -143,6 +143,10 @@ void AP_Airspeed_UAVCAN::handle_airspeed(AP_UAVCAN* ap_uavcan, uint8_t node_id,
             driver->_have_temperature = true;
         }
         driver->_last_sample_time_ms = AP_HAL::millis();
+        {
+            WITH_SEMAPHORE(driver->sem);
+            driver->record_highrate_sample(driver->_pressure);
+        }
     }
 }
 
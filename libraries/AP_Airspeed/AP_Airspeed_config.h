@@ -20,6 +20,14 @@
 #define AP_AIRSPEED_AUTOCAL_ENABLE AP_AIRSPEED_ENABLED
 #endif
 
+#ifndef AP_AIRSPEED_HIGHRATE_ENABLED
+#ifdef HAL_BUILD_AP_PERIPH
+#define AP_AIRSPEED_HIGHRATE_ENABLED 0
+#else
+#define AP_AIRSPEED_HIGHRATE_ENABLED AP_AIRSPEED_ENABLED
+#endif
+#endif
+
 #ifndef AP_AIRSPEED_HYGROMETER_ENABLE
 #define AP_AIRSPEED_HYGROMETER_ENABLE (AP_AIRSPEED_ENABLED && BOARD_FLASH_SIZE > 1024)
 #endif
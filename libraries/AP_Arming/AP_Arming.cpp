@@ -781,6 +781,22 @@ bool AP_Arming::manual_transmitter_checks(bool report)
     return rc_in_calibration_check(report);
 }
 
+/*
+  true if the mission may have changed since the cache was updated. A
+  change in the same millisecond as the update may not have been seen
+ */
+bool AP_Arming::MissionCache::stale(const AP_Mission &mission) const
+{
+    return !valid || mission.last_change_time_ms() != change_ms || change_ms == update_ms;
+}
+
+void AP_Arming::MissionCache::update(const AP_Mission &mission)
+{
+    change_ms = mission.last_change_time_ms();
+    update_ms = AP_HAL::millis();
+    valid = true;
+}
+
 bool AP_Arming::mission_checks(bool report)
 {
     if (((checks_to_perform & ARMING_CHECK_ALL) || (checks_to_perform & ARMING_CHECK_MISSION)) &&
@@ -803,9 +819,25 @@ bool AP_Arming::mission_checks(bool report)
           {MIS_ITEM_CHECK_VTOL_TAKEOFF,  MAV_CMD_NAV_VTOL_TAKEOFF,   "vtol takeoff"},
           {MIS_ITEM_CHECK_RETURN_TO_LAUNCH,  MAV_CMD_NAV_RETURN_TO_LAUNCH,   "RTL"},
         };
+        if (mission_items_cache.stale(*mission)) {
+            // find all the item types in one pass over the mission
+            mission_items_found = 0;
+            for (uint16_t i = 1; i < mission->num_commands(); i++) {
+                AP_Mission::Mission_Command cmd;
+                if (!mission->read_cmd_from_storage(i, cmd)) {
+                    continue;
+                }
+                for (uint8_t j = 0; j < ARRAY_SIZE(misChecks); j++) {
+                    if (cmd.id == misChecks[j].mis_item_type) {
+                        mission_items_found |= misChecks[j].check;
+                    }
+                }
+            }
+            mission_items_cache.update(*mission);
+        }
         for (uint8_t i = 0; i < ARRAY_SIZE(misChecks); i++) {
             if (_required_mission_items & misChecks[i].check) {
-                if (!mission->contains_item(misChecks[i].mis_item_type)) {
+                if (!(mission_items_found & misChecks[i].check)) {
                     check_failed(ARMING_CHECK_MISSION, report, "Missing mission item: %s", misChecks[i].type);
                     return false;
                 }
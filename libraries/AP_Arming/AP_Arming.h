@@ -229,6 +229,17 @@ protected:
     void Log_Write_Arm(bool forced, AP_Arming::Method method);
     void Log_Write_Disarm(bool forced, AP_Arming::Method method);
 
+    // results of checks which depend only on the mission contents are
+    // kept until the mission changes, as reading the whole mission
+    // each time the checks run at 1Hz is expensive
+    struct MissionCache {
+        uint32_t change_ms;     // mission change time when updated
+        uint32_t update_ms;     // when updated
+        bool valid;
+        bool stale(const class AP_Mission &mission) const;
+        void update(const class AP_Mission &mission);
+    };
+
 private:
 
     static AP_Arming *_singleton;
@@ -250,6 +261,10 @@ private:
         MIS_ITEM_CHECK_MAX
     };
 
+    // MIS_ITEM_CHECK bits of the item types in the mission
+    MissionCache mission_items_cache;
+    uint8_t mission_items_found;
+
     // auxiliary authorisation
     static const uint8_t aux_auth_count_max = 3;    // maximum number of auxiliary authorisers
     static const uint8_t aux_auth_str_len = 42;     // maximum length of failure message (50-8 for "PreArm: ")
@@ -167,6 +167,7 @@ void AP_Avoidance::init(void)
  */
 void AP_Avoidance::deinit(void)
 {
+    WITH_SEMAPHORE(_rsem);
     if (_obstacles != nullptr) {
         delete [] _obstacles;
         _obstacles = nullptr;
@@ -239,6 +240,8 @@ void AP_Avoidance::add_obstacle(const uint32_t obstacle_timestamp_ms,
     _obstacles[index]._location = loc;
     _obstacles[index]._velocity = vel_ned;
     _obstacles[index].timestamp_ms = obstacle_timestamp_ms;
+    // check the new position on the next update
+    _obstacles[index].next_check_ms = 0;
 }
 
 void AP_Avoidance::add_obstacle(const uint32_t obstacle_timestamp_ms,
@@ -279,15 +282,15 @@ void AP_Avoidance::get_adsb_samples()
     }
 }
 
-float closest_approach_xy(const Location &my_loc,
+// returns the closest these objects will get in the horizontal plane
+// (in metres), given the N/E offset (in metres) from the obstacle to us
+float closest_approach_xy(const Vector2f &delta_pos_ne,
                           const Vector3f &my_vel,
-                          const Location &obstacle_loc,
                           const Vector3f &obstacle_vel,
                           const uint8_t time_horizon)
 {
 
     Vector2f delta_vel_ne = Vector2f(obstacle_vel[0] - my_vel[0], obstacle_vel[1] - my_vel[1]);
-    const Vector2f delta_pos_ne = obstacle_loc.get_distance_NE(my_loc);
 
     Vector2f line_segment_ne = delta_vel_ne * time_horizon;
 
@@ -332,22 +335,26 @@ float closest_approach_z(const Location &my_loc,
     return ret/100.0f;
 }
 
-void AP_Avoidance::update_threat_level(const Location &my_loc,
+void AP_Avoidance::update_threat_level(const LocationProjection &my_proj,
                                        const Vector3f &my_vel,
                                        AP_Avoidance::Obstacle &obstacle)
 {
 
+    const Location &my_loc = my_proj.get_reference();
     Location &obstacle_loc = obstacle._location;
     Vector3f &obstacle_vel = obstacle._velocity;
 
     obstacle.threat_level = MAV_COLLISION_THREAT_LEVEL_NONE;
 
+    // offset from the obstacle to us
+    const Vector2f delta_pos_ne = -my_proj.to_NE(obstacle_loc);
+
     const uint32_t obstacle_age = AP_HAL::millis() - obstacle.timestamp_ms;
-    float closest_xy = closest_approach_xy(my_loc, my_vel, obstacle_loc, obstacle_vel, _fail_time_horizon + obstacle_age/1000);
+    float closest_xy = closest_approach_xy(delta_pos_ne, my_vel, obstacle_vel, _fail_time_horizon + obstacle_age/1000);
     if (closest_xy < _fail_distance_xy) {
         obstacle.threat_level = MAV_COLLISION_THREAT_LEVEL_HIGH;
     } else {
-        closest_xy = closest_approach_xy(my_loc, my_vel, obstacle_loc, obstacle_vel, _warn_time_horizon + obstacle_age/1000);
+        closest_xy = closest_approach_xy(delta_pos_ne, my_vel, obstacle_vel, _warn_time_horizon + obstacle_age/1000);
         if (closest_xy < _warn_distance_xy) {
             obstacle.threat_level = MAV_COLLISION_THREAT_LEVEL_LOW;
         }
@@ -376,7 +383,7 @@ void AP_Avoidance::update_threat_level(const Location &my_loc,
     // level is none - but only *once the GCS has been informed*!
     obstacle.closest_approach_xy = closest_xy;
     obstacle.closest_approach_z = closest_z;
-    float current_distance = my_loc.get_distance(obstacle_loc);
+    float current_distance = delta_pos_ne.length();
     obstacle.distance_to_closest_approach = current_distance - closest_xy;
     Vector2f net_velocity_ne = Vector2f(my_vel[0] - obstacle_vel[0], my_vel[1] - obstacle_vel[1]);
     obstacle.time_to_closest_approach = 0.0f;
@@ -386,6 +393,51 @@ void AP_Avoidance::update_threat_level(const Location &my_loc,
     }
 }
 
+/*
+  an obstacle is out of reach if, even heading straight for each other
+  at the current speeds, we can't come within the warn or fail
+  distances inside the time horizons. The closest approach calculations
+  are skipped for these, which with a lot of traffic around is most of
+  the obstacles.
+  The obstacle is not checked again until the slack could have been
+  used up, allowing for our speed increasing by
+  AP_AVOIDANCE_REACH_SPEED_MARGIN
+ */
+bool AP_Avoidance::out_of_reach(const Vector2f &delta_pos_ne,
+                                const Vector3f &my_vel,
+                                const int32_t my_pos_alt_cm,
+                                AP_Avoidance::Obstacle &obstacle,
+                                const uint32_t now_ms) const
+{
+    const uint32_t obstacle_age = now_ms - obstacle.timestamp_ms;
+    const float time_horizon = MAX(_warn_time_horizon.get(), _fail_time_horizon.get()) + obstacle_age/1000;
+    const Vector3f &obstacle_vel = obstacle._velocity;
+
+    const float closing_xy = my_vel.xy().length() + obstacle_vel.xy().length();
+    const float reach_xy = MAX(_warn_distance_xy.get(), float(_fail_distance_xy.get())) + closing_xy * time_horizon;
+    const float slack_xy = delta_pos_ne.length() - reach_xy;
+
+    const float closing_z = fabsf(my_vel.z) + fabsf(obstacle_vel.z);
+    const float reach_z = MAX(_warn_distance_z.get(), float(_fail_distance_z.get())) + closing_z * time_horizon;
+    const float slack_z = fabsf(float(obstacle._location.alt - my_pos_alt_cm)) * 0.01f - reach_z;
+
+    if (!is_positive(slack_xy) && !is_positive(slack_z)) {
+        return false;
+    }
+
+    // the time horizon grows by up to a second as the data ages
+    float skip_s = 0;
+    if (is_positive(slack_xy)) {
+        skip_s = MAX(skip_s, (slack_xy - closing_xy) / (2 * closing_xy + AP_AVOIDANCE_REACH_SPEED_MARGIN));
+    }
+    if (is_positive(slack_z)) {
+        skip_s = MAX(skip_s, (slack_z - closing_z) / (2 * closing_z + AP_AVOIDANCE_REACH_SPEED_MARGIN));
+    }
+    const uint32_t skip_ms = MIN(skip_s * 1000, float(AP_AVOIDANCE_REACH_SKIP_MAX_MS));
+    obstacle.next_check_ms = (skip_ms > 0) ? now_ms + skip_ms : 0;
+    return true;
+}
+
 MAV_COLLISION_THREAT_LEVEL AP_Avoidance::current_threat_level() const {
     if (_obstacles == nullptr) {
         return MAV_COLLISION_THREAT_LEVEL_NONE;
@@ -453,39 +505,55 @@ bool AP_Avoidance::obstacle_is_more_serious_threat(const AP_Avoidance::Obstacle
     return false;
 }
 
-void AP_Avoidance::check_for_threats()
+/*
+  take our own position and velocity for check_for_threats()
+ */
+void AP_Avoidance::update_own_state()
 {
     const AP_AHRS &_ahrs = AP::ahrs();
 
+    // if we don't know our own location we can't determine any threat
+    // level. Assuming our own velocity to be zero may cause us to fly
+    // into something, so better not to attempt to avoid without it
     Location my_loc;
-    if (!_ahrs.get_location(my_loc)) {
-        // if we don't know our own location we can't determine any threat level
-        return;
+    Vector3f my_vel;
+    const bool valid = _ahrs.get_location(my_loc) && _ahrs.get_velocity_NED(my_vel);
+
+    WITH_SEMAPHORE(_rsem);
+    _own_state.valid = valid;
+    if (valid) {
+        _own_state.loc = my_loc;
+        _own_state.vel = my_vel;
     }
+}
 
-    Vector3f my_vel;
-    if (!_ahrs.get_velocity_NED(my_vel)) {
-        // assuming our own velocity to be zero here may cause us to
-        // fly into something.  Better not to attempt to avoid in this
-        // case.
+void AP_Avoidance::check_for_threats()
+{
+    WITH_SEMAPHORE(_rsem);
+
+    if (_obstacles == nullptr || !_own_state.valid) {
         return;
     }
+    const Location &my_loc = _own_state.loc;
+    const Vector3f &my_vel = _own_state.vel;
+
+    // the obstacles are all converted to offsets from our location
+    const LocationProjection my_proj{my_loc};
 
     // we always check all obstacles to see if they are threats since it
     // is most likely our own position and/or velocity have changed
     // determine the current most-serious-threat
+    const uint32_t now_ms = AP_HAL::millis();
     _current_most_serious_threat = -1;
     for (uint8_t i=0; i<_obstacle_count; i++) {
 
         AP_Avoidance::Obstacle &obstacle = _obstacles[i];
-        const uint32_t obstacle_age = AP_HAL::millis() - obstacle.timestamp_ms;
+        const uint32_t obstacle_age = now_ms - obstacle.timestamp_ms;
         debug("i=%d src_id=%d timestamp=%u age=%d", i, obstacle.src_id, obstacle.timestamp_ms, obstacle_age);
 
-        update_threat_level(my_loc, my_vel, obstacle);
-        debug("   threat-level=%d", obstacle.threat_level);
-
         // ignore any really old data:
         if (obstacle_age > MAX_OBSTACLE_AGE_MS) {
+            obstacle.threat_level = MAV_COLLISION_THREAT_LEVEL_NONE;
             // shrink list if this is the last entry:
             if (i == _obstacle_count-1) {
                 _obstacle_count -= 1;
@@ -493,6 +561,20 @@ void AP_Avoidance::check_for_threats()
             continue;
         }
 
+        // obstacles that were out of reach stay at threat level none
+        // until they are checked again
+        if (obstacle.next_check_ms == 0 || int32_t(now_ms - obstacle.next_check_ms) >= 0) {
+            // offset from the obstacle to us
+            const Vector2f delta_pos_ne = -my_proj.to_NE(obstacle._location);
+            if (out_of_reach(delta_pos_ne, my_vel, my_loc.alt, obstacle, now_ms)) {
+                obstacle.threat_level = MAV_COLLISION_THREAT_LEVEL_NONE;
+            } else {
+                obstacle.next_check_ms = 0;
+                update_threat_level(my_proj, my_vel, obstacle);
+            }
+        }
+        debug("   threat-level=%d", obstacle.threat_level);
+
         if (obstacle_is_more_serious_threat(obstacle)) {
             _current_most_serious_threat = i;
         }
@@ -523,7 +605,19 @@ void AP_Avoidance::update()
         get_adsb_samples();
     }
 
-    check_for_threats();
+    update_own_state();
+
+#if AP_AVOIDANCE_THREAD_ENABLED
+    // threats are checked in the avoidance thread once it is running
+    const bool checked_in_thread = start_thread();
+#else
+    const bool checked_in_thread = false;
+#endif
+    if (!checked_in_thread) {
+        check_for_threats();
+    }
+
+    WITH_SEMAPHORE(_rsem);
 
     // avoid object (if necessary)
     handle_avoidance_local(most_serious_threat());
@@ -532,6 +626,36 @@ void AP_Avoidance::update()
     handle_threat_gcs_notify(most_serious_threat());
 }
 
+#if AP_AVOIDANCE_THREAD_ENABLED
+/*
+  start the thread that checks for threats. Returns true if it is running
+ */
+bool AP_Avoidance::start_thread()
+{
+    if (_thread_created) {
+        return true;
+    }
+    if (!hal.scheduler->thread_create(FUNCTOR_BIND_MEMBER(&AP_Avoidance::avoidance_thread, void),
+                                      "adsb_avoid",
+                                      4096, AP_HAL::Scheduler::PRIORITY_IO, -1)) {
+        return false;
+    }
+    _thread_created = true;
+    return true;
+}
+
+/*
+  check for threats at 10Hz using the position and velocity from update()
+ */
+void AP_Avoidance::avoidance_thread()
+{
+    while (true) {
+        hal.scheduler->delay(100);
+        check_for_threats();
+    }
+}
+#endif // AP_AVOIDANCE_THREAD_ENABLED
+
 void AP_Avoidance::handle_avoidance_local(AP_Avoidance::Obstacle *threat)
 {
     MAV_COLLISION_THREAT_LEVEL new_threat_level = MAV_COLLISION_THREAT_LEVEL_NONE;
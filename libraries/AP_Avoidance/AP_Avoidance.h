@@ -33,6 +33,16 @@
 
 #define AP_AVOIDANCE_ESCAPE_TIME_SEC                        2       // vehicle runs from thread for 2 seconds
 
+// obstacles that can't come within range are not checked again for up to this long, or until they are updated
+#define AP_AVOIDANCE_REACH_SKIP_MAX_MS                      1000
+// allowance for our own speed changing while an obstacle is not being checked
+#define AP_AVOIDANCE_REACH_SPEED_MARGIN                     10      // m/s
+
+// check for threats in a thread rather than in update()
+#ifndef AP_AVOIDANCE_THREAD_ENABLED
+#define AP_AVOIDANCE_THREAD_ENABLED (HAL_MEM_CLASS >= HAL_MEM_CLASS_500)
+#endif
+
 class AP_Avoidance {
 public:
 
@@ -72,6 +82,7 @@ public:
         float time_to_closest_approach; // seconds, 3D approach
         float distance_to_closest_approach; // metres, 3D
         uint32_t last_gcs_report_time; // millis
+        uint32_t next_check_ms; // out of reach and not checked again until this time, zero if it must be checked
     };
 
 
@@ -171,7 +182,14 @@ private:
     uint32_t src_id_for_adsb_vehicle(const AP_ADSB::adsb_vehicle_t &vehicle) const;
 
     void check_for_threats();
-    void update_threat_level(const Location &my_loc,
+    // returns true if the obstacle can't come within the warn or fail
+    // distances, setting next_check_ms for when it could
+    bool out_of_reach(const Vector2f &delta_pos_ne,
+                      const Vector3f &my_vel,
+                      int32_t my_pos_alt_cm,
+                      AP_Avoidance::Obstacle &obstacle,
+                      uint32_t now_ms) const;
+    void update_threat_level(const LocationProjection &my_proj,
                              const Vector3f &my_vel,
                              AP_Avoidance::Obstacle &obstacle);
 
@@ -208,15 +226,30 @@ private:
     AP_Float    _warn_distance_xy;
     AP_Float    _warn_distance_z;
 
+    // our own position and velocity, taken in update() so threats can
+    // be checked in the avoidance thread
+    struct {
+        Location loc;
+        Vector3f vel;
+        bool valid;
+    } _own_state;
+    void update_own_state();
+
+#if AP_AVOIDANCE_THREAD_ENABLED
+    // threat checking thread
+    bool start_thread();
+    void avoidance_thread();
+    bool _thread_created;
+#endif
+
     // multi-thread support for avoidance
     HAL_Semaphore _rsem;
 
     static AP_Avoidance *_singleton;
 };
 
-float closest_approach_xy(const Location &my_loc,
+float closest_approach_xy(const Vector2f &delta_pos_ne,
                           const Vector3f &my_vel,
-                          const Location &obstacle_loc,
                           const Vector3f &obstacle_vel,
                           uint8_t time_horizon);
 
@@ -247,8 +247,8 @@ const AP_Param::GroupInfo AP_Baro::var_info[] = {
 
     // @Param: _OPTIONS
     // @DisplayName: Barometer options
-    // @Description: Barometer options
-    // @Bitmask: 0:Treat MS5611 as MS5607
+    // @Description: Barometer options. Blend sensors replaces the altitude of the primary barometer with the average of all healthy barometers of the same type, each corrected by its slowly estimated offset from the primary, which lowers the noise without adding the sensors' drift
+    // @Bitmask: 0:Treat MS5611 as MS5607, 1:Blend sensors
     // @User: Advanced
     AP_GROUPINFO("_OPTIONS", 24, AP_Baro, _options, 0),
 #endif
@@ -274,6 +274,7 @@ AP_Baro::AP_Baro()
 
     AP_Param::setup_object_defaults(this, var_info);
     _field_elevation_active = _field_elevation;
+    _rsem.set_name("Baro");
 }
 
 // calibrate the barometer. This must be called at least once before
@@ -354,6 +355,7 @@ void AP_Baro::calibrate(bool save)
                 float p0_sealevel = get_sealevel_pressure(sum_pressure[i] / count[i]);
                 sensors[i].ground_pressure.set_and_save(p0_sealevel);
             }
+            sensors[i].drift = 0;
         }
     }
 
@@ -390,6 +392,7 @@ void AP_Baro::update_calibration()
             float corrected_pressure = get_sealevel_pressure(get_pressure(i) + sensors[i].p_correction);
             sensors[i].ground_pressure.set(corrected_pressure);
         }
+        sensors[i].drift = 0;
 
         // don't notify the GCS too rapidly or we flood the link
         if (do_notify) {
@@ -943,11 +946,6 @@ void AP_Baro::update(void)
         }
     }
 
-    // ensure the climb rate filter is updated
-    if (healthy()) {
-        _climb_rate_filter.update(get_altitude(), get_last_update());
-    }
-
     // choose primary sensor
     if (_primary_baro >= 0 && _primary_baro < _num_sensors && healthy(_primary_baro)) {
         _primary = _primary_baro;
@@ -960,6 +958,13 @@ void AP_Baro::update(void)
             }
         }
     }
+
+    update_blend();
+
+    // ensure the climb rate filter is updated
+    if (healthy()) {
+        _climb_rate_filter.update(get_altitude(), get_last_update());
+    }
 #ifndef HAL_BUILD_AP_PERIPH
     update_field_elevation();
 #endif
@@ -982,6 +987,58 @@ void AP_Baro::update(void)
 #endif
 }
 
+/*
+  average the altitudes of the healthy sensors of the primary's type.
+  Each sensor's offset from the primary is tracked with a slow low
+  pass filter and removed first, so the average has the primary's
+  long term behaviour and the noise of the sensors averaged
+ */
+void AP_Baro::update_blend(void)
+{
+    _blend_ok = false;
+    if (!option_enabled(Options::BlendSensors) || !healthy(_primary)) {
+        _blend_last_ms = 0;
+        return;
+    }
+
+    const uint32_t now_ms = AP_HAL::millis();
+    const float dt = _blend_last_ms == 0 ? 0 : MIN((now_ms - _blend_last_ms) * 0.001f, 1.0f);
+    _blend_last_ms = now_ms;
+
+    if (_primary != _blend_primary) {
+        // make the offsets relative to the new primary
+        const float primary_drift = sensors[_primary].drift;
+        for (uint8_t i=0; i<_num_sensors; i++) {
+            sensors[i].drift -= primary_drift;
+        }
+        _blend_primary = _primary;
+    }
+
+    // offsets change with temperature over minutes
+    const float tau = 30.0f;
+    const float alpha = dt / (tau + dt);
+    const float primary_alt = sensors[_primary].altitude;
+    float sum = 0;
+    uint8_t count = 0;
+    for (uint8_t i=0; i<_num_sensors; i++) {
+        if (!healthy(i) || sensors[i].type != sensors[_primary].type) {
+            continue;
+        }
+        if (i != _primary) {
+            sensors[i].drift += alpha * ((sensors[i].altitude - primary_alt) - sensors[i].drift);
+        }
+        const float alt = sensors[i].altitude - sensors[i].drift;
+        if (fabsf(alt - primary_alt) > 2.0f) {
+            // glitching or still settling, leave it out
+            continue;
+        }
+        sum += alt;
+        count++;
+    }
+    _blend_altitude = sum / count;
+    _blend_ok = true;
+}
+
 /*
   update field elevation value
  */
@@ -101,7 +101,9 @@ public:
 
     // get current altitude in meters relative to altitude at the time
     // of the last calibrate() call
-    float get_altitude(void) const { return get_altitude(_primary); }
+    // this is the blended altitude of all sensors if enabled in
+    // BARO_OPTIONS
+    float get_altitude(void) const { return _blend_ok ? _blend_altitude : get_altitude(_primary); }
     float get_altitude(uint8_t instance) const { return sensors[instance].altitude; }
 
     // returns which i2c bus is considered "the" external bus
@@ -200,6 +202,7 @@ public:
 
     enum Options : uint16_t {
         TreatMS5611AsMS5607     = (1U << 0U),
+        BlendSensors            = (1U << 1U),
     };
 
     // check if an option is set
@@ -272,6 +275,7 @@ private:
         bool healthy;                   // true if sensor is healthy
         bool alt_ok;                    // true if calculated altitude is ok
         bool calibrated;                // true if calculated calibrated successfully
+        float drift;                    // estimated altitude offset from the primary in meters
         AP_Int32 bus_id;
 #if HAL_BARO_WIND_COMP_ENABLED
         WindCoeff wind_coeff;
@@ -314,6 +318,13 @@ private:
     // semaphore for API access from threads
     HAL_Semaphore                      _rsem;
 
+    // drift corrected average of the sensors' altitudes
+    float                              _blend_altitude;
+    bool                               _blend_ok;
+    uint32_t                           _blend_last_ms;
+    uint8_t                            _blend_primary;
+    void update_blend(void);
+
 #if HAL_BARO_WIND_COMP_ENABLED
     /*
       return pressure correction for wind based on GND_WCOEF parameters
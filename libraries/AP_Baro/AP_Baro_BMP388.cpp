@@ -53,6 +53,29 @@ extern const AP_HAL::HAL &hal;
 #define BMP388_REG_CAL_P     0x36
 #define BMP388_REG_CAL_T     0x31
 
+#define BMP388_CMD_FIFO_FLUSH 0xB0
+
+// pressure oversampled x8 and temperature x1 take 19.2ms, which fits
+// in the 20ms period of 50Hz output
+#define BMP388_OSR_P8_T1     0x03
+#define BMP388_ODR_50HZ      0x02
+
+// FIFO enabled with pressure and temperature, no sensor time
+#define BMP388_FIFO_CNF1     0x19
+// every sample, unfiltered
+#define BMP388_FIFO_CNF2     0x00
+
+// FIFO frame headers and the lengths of their payloads
+#define BMP388_FH_PRESS_TEMP 0x94
+#define BMP388_FH_TEMP       0x90
+#define BMP388_FH_PRESS      0x84
+#define BMP388_FH_CONFIG_CHG 0x48
+#define BMP388_FH_CONFIG_ERR 0x44
+#define BMP388_FH_EMPTY      0x80
+
+// most FIFO bytes read at once, a whole number of 7 byte frames
+#define BMP388_FIFO_READ_MAX 63
+
 AP_Baro_BMP388::AP_Baro_BMP388(AP_Baro &baro, AP_HAL::OwnPtr<AP_HAL::Device> _dev)
     : AP_Baro_Backend(baro)
     , dev(std::move(_dev))
@@ -113,7 +136,15 @@ bool AP_Baro_BMP388::init()
 
     scale_calibration_data();
 
-    dev->setup_checked_registers(4);
+    dev->setup_checked_registers(5);
+
+    // oversampled conversions at 50Hz, collected in the FIFO so none
+    // are missed between reads
+    dev->write_register(BMP388_REG_OSR, BMP388_OSR_P8_T1, true);
+    dev->write_register(BMP388_REG_ODR, BMP388_ODR_50HZ, true);
+    dev->write_register(BMP388_REG_FIFO_CNF2, BMP388_FIFO_CNF2, true);
+    dev->write_register(BMP388_REG_CMD, BMP388_CMD_FIFO_FLUSH);
+    dev->write_register(BMP388_REG_FIFO_CNF1, BMP388_FIFO_CNF1, true);
 
     // normal mode, temp and pressure
     dev->write_register(BMP388_REG_PWR_CTRL, 0x33, true);
@@ -122,35 +153,78 @@ bool AP_Baro_BMP388::init()
 
     set_bus_id(instance, dev->get_bus_id());
 
-    // request 50Hz update
-    dev->register_periodic_callback(20 * AP_USEC_PER_MSEC, FUNCTOR_BIND_MEMBER(&AP_Baro_BMP388::timer, void));
+    // empty the FIFO at 25Hz, two samples at a time
+    dev->register_periodic_callback(40 * AP_USEC_PER_MSEC, FUNCTOR_BIND_MEMBER(&AP_Baro_BMP388::timer, void));
 
     return true;
 }
 
 
 
-//  acumulate a new sensor reading
+//  acumulate the sensor readings waiting in the FIFO
 void AP_Baro_BMP388::timer(void)
 {
-    uint8_t buf[7];
+    uint8_t buf[BMP388_FIFO_READ_MAX];
 
-    if (!read_registers(BMP388_REG_STATUS, buf, sizeof(buf))) {
+    if (!read_registers(BMP388_REG_FIFO_LEN, buf, 2)) {
         return;
     }
-    const uint8_t status = buf[0];
-    if ((status & 0x20) != 0) {
-        // we have pressure data
-        update_pressure((buf[3] << 16) | (buf[2] << 8) | buf[1]);
-    }
-    if ((status & 0x40) != 0) {
-        // we have temperature data
-        update_temperature((buf[6] << 16) | (buf[5] << 8) | buf[4]);
+    const uint16_t fifo_len = ((buf[1] & 0x01) << 8) | buf[0];
+    const uint8_t n = MIN(fifo_len, sizeof(buf));
+    if (n > 0 && read_registers(BMP388_REG_FIFO_DATA, buf, n)) {
+        parse_fifo(buf, n);
     }
 
     dev->check_next_register();
 }
 
+/*
+  parse a block of FIFO frames. Temperature comes before pressure in
+  a frame with both, so each pressure is compensated with the
+  temperature measured with it
+ */
+void AP_Baro_BMP388::parse_fifo(const uint8_t *buf, uint8_t len)
+{
+    uint8_t i = 0;
+    while (i < len) {
+        const uint8_t *d = &buf[i+1];
+        switch (buf[i]) {
+        case BMP388_FH_PRESS_TEMP:
+            if (i + 7 > len) {
+                return;
+            }
+            update_temperature((d[2] << 16) | (d[1] << 8) | d[0]);
+            update_pressure((d[5] << 16) | (d[4] << 8) | d[3]);
+            i += 7;
+            break;
+        case BMP388_FH_TEMP:
+            if (i + 4 > len) {
+                return;
+            }
+            update_temperature((d[2] << 16) | (d[1] << 8) | d[0]);
+            i += 4;
+            break;
+        case BMP388_FH_PRESS:
+            if (i + 4 > len) {
+                return;
+            }
+            update_pressure((d[2] << 16) | (d[1] << 8) | d[0]);
+            i += 4;
+            break;
+        case BMP388_FH_CONFIG_CHG:
+        case BMP388_FH_CONFIG_ERR:
+            i += 2;
+            break;
+        case BMP388_FH_EMPTY:
+            return;
+        default:
+            // lost frame alignment, start again with an empty FIFO
+            dev->write_register(BMP388_REG_CMD, BMP388_CMD_FIFO_FLUSH);
+            return;
+        }
+    }
+}
+
 // transfer data to the frontend
 void AP_Baro_BMP388::update(void)
 {
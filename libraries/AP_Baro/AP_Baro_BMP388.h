@@ -29,6 +29,7 @@ private:
 
     bool init(void);
     void timer(void);
+    void parse_fifo(const uint8_t *buf, uint8_t len);
     void update_temperature(uint32_t);
     void update_pressure(uint32_t);
 
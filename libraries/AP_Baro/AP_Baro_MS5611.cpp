@@ -188,15 +188,6 @@ uint16_t AP_Baro_MS56XX::_read_prom_word(uint8_t word)
     return (val[0] << 8) | val[1];
 }
 
-uint32_t AP_Baro_MS56XX::_read_adc()
-{
-    uint8_t val[3];
-    if (!_dev->transfer(&CMD_MS56XX_READ_ADC, 1, val, sizeof(val))) {
-        return 0;
-    }
-    return (val[0] << 16) | (val[1] << 8) | val[2];
-}
-
 bool AP_Baro_MS56XX::_read_prom_5611(uint16_t prom[8])
 {
     /*
@@ -270,25 +261,24 @@ bool AP_Baro_MS56XX::_read_prom_5637(uint16_t prom[8])
 */
 void AP_Baro_MS56XX::_timer(void)
 {
-    uint8_t next_cmd;
-    uint8_t next_state;
-    uint32_t adc_val = _read_adc();
-
     /*
-     * If read fails, re-initiate a read command for current state or we are
-     * stuck
+     * read the conversion started on the last call and start the next
+     * one in a single bus operation
      */
-    if (adc_val == 0) {
-        next_state = _state;
-    } else {
-        next_state = (_state + 1) % 5;
-    }
-
-    next_cmd = next_state == 0 ? ADDR_CMD_CONVERT_TEMPERATURE
-                               : ADDR_CMD_CONVERT_PRESSURE;
-    if (!_dev->transfer(&next_cmd, 1, nullptr, 0)) {
+    const uint8_t next_state = (_state + 1) % 5;
+    const uint8_t next_cmd = next_state == 0 ? ADDR_CMD_CONVERT_TEMPERATURE
+                                             : ADDR_CMD_CONVERT_PRESSURE;
+    uint8_t val[3];
+    AP_HAL::Device::TransferBatch<2> batch(*_dev);
+    batch.transfer(&CMD_MS56XX_READ_ADC, 1, val, sizeof(val));
+    batch.transfer(&next_cmd, 1, nullptr, 0);
+    if (!batch.submit()) {
+        // the next conversion may not have been started, so discard
+        // the value read on the next call
+        _discard_next = true;
         return;
     }
+    const uint32_t adc_val = (val[0] << 16) | (val[1] << 8) | val[2];
 
     /* if we had a failed read we are all done */
     if (adc_val == 0 || adc_val == 0xFFFFFF) {
@@ -296,6 +286,7 @@ void AP_Baro_MS56XX::_timer(void)
         // corrupt, we must discard it. This copes with MISO being
         // pulled either high or low
         _discard_next = true;
+        _state = next_state;
         return;
     }
 
@@ -74,6 +74,13 @@ const AP_Param::GroupInfo AP_Beacon::var_info[] = {
     // @User: Advanced
     AP_GROUPINFO("_ORIENT_YAW", 4, AP_Beacon, orient_yaw, 0),
 
+    // @Param: _OPTIONS
+    // @DisplayName: Beacon options
+    // @Description: Beacon options. The vehicle position is always solved from each set of ranges the beacons report together, and is used when the beacon system does not give its own. With bit 0 set the solved position is used instead of the beacon system's
+    // @Bitmask: 0:Solve position from ranges
+    // @User: Advanced
+    AP_GROUPINFO("_OPTIONS", 5, AP_Beacon, _options, 0),
+
     AP_GROUPEND
 };
 
@@ -134,6 +141,9 @@ void AP_Beacon::update(void)
     }
     _driver->update();
 
+    // solve for the position from the ranges received
+    process_range_queue();
+
     // update boundary for fence
     update_boundary_points();
 }
@@ -391,6 +401,133 @@ bool AP_Beacon::device_ready(void) const
     return ((_driver != nullptr) && (_type != AP_BeaconType_None));
 }
 
+// add a range from the backend to the queue, dropping the oldest if it is full
+void AP_Beacon::queue_range(uint8_t beacon_instance, float distance, uint32_t time_ms)
+{
+    range_queue.push_force(RangeSample{time_ms, distance, beacon_instance});
+}
+
+/*
+  group the queued ranges into epochs, the ranges the beacons report
+  together. An epoch ends when a beacon reports a second time, when
+  every beacon has reported, or after AP_BEACON_EPOCH_MS
+ */
+void AP_Beacon::process_range_queue()
+{
+    static_assert(AP_BEACON_MAX_BEACONS <= 8, "epoch.mask must hold AP_BEACON_MAX_BEACONS bits");
+
+    RangeSample sample;
+    while (range_queue.pop(sample)) {
+        const uint8_t bit = 1U << sample.instance;
+        if (epoch.mask != 0 && ((epoch.mask & bit) || sample.time_ms - epoch.start_ms > AP_BEACON_EPOCH_MS)) {
+            end_epoch();
+        }
+        if (epoch.mask == 0) {
+            epoch.start_ms = sample.time_ms;
+        }
+        epoch.mask |= bit;
+        epoch.distance[sample.instance] = sample.distance;
+        epoch.end_ms = sample.time_ms;
+        if (__builtin_popcount(epoch.mask) >= num_beacons) {
+            end_epoch();
+        }
+    }
+
+    if (epoch.mask != 0 && AP_HAL::millis() - epoch.start_ms > AP_BEACON_EPOCH_MS) {
+        end_epoch();
+    }
+}
+
+void AP_Beacon::end_epoch()
+{
+    // the solution is only used if the backend isn't giving a position,
+    // or it is set to be ignored
+    const bool use_solution = (_options & uint8_t(Option::SOLVE_POSITION)) ||
+                              AP_HAL::millis() - backend_pos_update_ms > AP_BEACON_TIMEOUT_MS;
+    Vector3f pos;
+    float accuracy;
+    if (use_solution && solve_position(pos, accuracy)) {
+        veh_pos_ned = pos;
+        veh_pos_accuracy = accuracy;
+        veh_pos_update_ms = epoch.end_ms;
+    }
+    epoch.mask = 0;
+}
+
+/*
+  solve for the vehicle position from all of the ranges of the epoch
+  by Gauss-Newton least squares. Solving from the ranges together,
+  rather than one at a time, gives a position fix from the first epoch
+ */
+bool AP_Beacon::solve_position(Vector3f &pos, float &accuracy) const
+{
+    const uint8_t mask = epoch.mask & beacon_pos_mask;
+    const uint8_t n = __builtin_popcount(mask);
+    if (n < 3) {
+        // not enough ranges for a 3D fix
+        return false;
+    }
+
+    // start from the last position if we have one, otherwise below the
+    // middle of the beacons, so that if they are all at one height we
+    // find the solution underneath them rather than its mirror image
+    Vector3f p;
+    if (AP_HAL::millis() - veh_pos_update_ms < AP_BEACON_TIMEOUT_MS) {
+        p = veh_pos_ned;
+    } else {
+        for (uint8_t i=0; i<AP_BEACON_MAX_BEACONS; i++) {
+            if (mask & (1U<<i)) {
+                p += beacon_state[i].position;
+            }
+        }
+        p /= n;
+        p.z += 1.0f;
+    }
+
+    Matrix3f JtJ_inv;
+    float sum_sq_err = 0;
+    for (uint8_t iter=0; iter<10; iter++) {
+        Matrix3f JtJ;
+        Vector3f Jte;
+        sum_sq_err = 0;
+        for (uint8_t i=0; i<AP_BEACON_MAX_BEACONS; i++) {
+            if (!(mask & (1U<<i))) {
+                continue;
+            }
+            const Vector3f ofs = p - beacon_state[i].position;
+            const float dist = ofs.length();
+            if (dist < 0.01f) {
+                // on top of a beacon, the direction is undefined
+                return false;
+            }
+            const Vector3f J = ofs / dist;
+            const float err = epoch.distance[i] - dist;
+            JtJ += Matrix3f(J * J.x, J * J.y, J * J.z);
+            Jte += J * err;
+            sum_sq_err += sq(err);
+        }
+        if (!JtJ.inverse(JtJ_inv)) {
+            // beacons in a line, or the position is in their plane
+            return false;
+        }
+        const Vector3f step = JtJ_inv * Jte;
+        p += step;
+        if (step.length() < 0.001f) {
+            break;
+        }
+    }
+
+    // the variance of a range comes from the residuals when there are
+    // more ranges than unknowns
+    const float range_var = n > 3 ? MAX(sum_sq_err / (n - 3), sq(0.05f)) : sq(0.1f);
+    accuracy = sqrtf(range_var * (JtJ_inv.a.x + JtJ_inv.b.y + JtJ_inv.c.z));
+    if (p.is_nan() || p.is_inf() || !isfinite(accuracy)) {
+        return false;
+    }
+    pos = p;
+    return true;
+}
+
 // Write beacon sensor (position) data
 void AP_Beacon::log()
 {
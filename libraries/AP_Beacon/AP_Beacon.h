@@ -22,12 +22,15 @@
 #include <AP_Param/AP_Param.h>
 #include <AP_Math/AP_Math.h>
 #include <AP_Common/Location.h>
+#include <AP_HAL/utility/RingBuffer.h>
 
 class AP_Beacon_Backend;
 
 #define AP_BEACON_MAX_BEACONS 4
 #define AP_BEACON_TIMEOUT_MS 300
 #define AP_BEACON_MINIMUM_FENCE_BEACONS 3
+#define AP_BEACON_RANGE_QUEUE_LEN 16    // ranges held between updates
+#define AP_BEACON_EPOCH_MS 50           // ranges closer together than this are from one measurement epoch
 
 class AP_Beacon
 {
@@ -116,6 +119,17 @@ private:
     // check if device is ready
     bool device_ready(void) const;
 
+    // add a range from the backend to the queue, dropping the oldest if it is full
+    void queue_range(uint8_t beacon_instance, float distance, uint32_t time_ms);
+
+    // group the queued ranges into epochs, solving for the vehicle position from each
+    void process_range_queue();
+    void end_epoch();
+
+    // solve for the vehicle position from all of the ranges of the epoch
+    // returns true on success, with the position and its accuracy in meters
+    bool solve_position(Vector3f &pos, float &accuracy) const;
+
     // find next boundary point from an array of boundary points given the current index into that array
     // returns true if a next point can be found
     //   current_index should be an index into the boundary_pts array
@@ -130,6 +144,11 @@ private:
     AP_Float origin_lon;
     AP_Float origin_alt;
     AP_Int16 orient_yaw;
+    AP_Int8 _options;
+
+    enum class Option : uint8_t {
+        SOLVE_POSITION = (1U<<0),   // use the position solved from the ranges instead of the backend's
+    };
 
     // external references
     AP_Beacon_Backend *_driver;
@@ -138,10 +157,28 @@ private:
     Vector3f veh_pos_ned;
     float veh_pos_accuracy;
     uint32_t veh_pos_update_ms;
+    uint32_t backend_pos_update_ms;     // last time the backend gave a position
+
+    // ranges from the backend with the time they were received
+    struct RangeSample {
+        uint32_t time_ms;
+        float distance;
+        uint8_t instance;
+    };
+    ObjectArray<RangeSample> range_queue{AP_BEACON_RANGE_QUEUE_LEN};
+
+    // ranges of the epoch being collected
+    struct {
+        float distance[AP_BEACON_MAX_BEACONS];
+        uint8_t mask;           // beacons with a range in this epoch
+        uint32_t start_ms;
+        uint32_t end_ms;
+    } epoch;
 
     // individual beacon data
     uint8_t num_beacons = 0;
     BeaconState beacon_state[AP_BEACON_MAX_BEACONS];
+    uint8_t beacon_pos_mask;    // beacons whose position is known
 
     // fence boundary
     Vector2f boundary[AP_BEACON_MAX_BEACONS+1]; // array of boundary points (used for fence)
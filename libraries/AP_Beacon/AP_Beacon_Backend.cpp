@@ -42,7 +42,12 @@ AP_Beacon_Backend::AP_Beacon_Backend(AP_Beacon &frontend) :
 // accuracy_estimate is also in meters
 void AP_Beacon_Backend::set_vehicle_position(const Vector3f& pos, float accuracy_estimate)
 {
-    _frontend.veh_pos_update_ms = AP_HAL::millis();
+    _frontend.backend_pos_update_ms = AP_HAL::millis();
+    if (_frontend._options & uint8_t(AP_Beacon::Option::SOLVE_POSITION)) {
+        // the position is solved from the ranges instead
+        return;
+    }
+    _frontend.veh_pos_update_ms = _frontend.backend_pos_update_ms;
     _frontend.veh_pos_accuracy = accuracy_estimate;
     _frontend.veh_pos_ned = correct_for_orient_yaw(pos);
 }
@@ -60,9 +65,11 @@ void AP_Beacon_Backend::set_beacon_distance(uint8_t beacon_instance, float dista
         _frontend.num_beacons = beacon_instance+1;
     }
 
-    _frontend.beacon_state[beacon_instance].distance_update_ms = AP_HAL::millis();
+    const uint32_t now_ms = AP_HAL::millis();
+    _frontend.beacon_state[beacon_instance].distance_update_ms = now_ms;
     _frontend.beacon_state[beacon_instance].distance = distance;
     _frontend.beacon_state[beacon_instance].healthy = true;
+    _frontend.queue_range(beacon_instance, distance, now_ms);
 }
 
 // set beacon's position
@@ -81,6 +88,7 @@ void AP_Beacon_Backend::set_beacon_position(uint8_t beacon_instance, const Vecto
 
     // set position after correcting yaw
     _frontend.beacon_state[beacon_instance].position = correct_for_orient_yaw(pos);
+    _frontend.beacon_pos_mask |= 1U << beacon_instance;
 }
 
 // rotate vector (meters) to correct for beacon system yaw orientation
@@ -49,11 +49,30 @@ bool ExpandingString::expand(uint32_t min_extra_space_needed)
 
     buflen = newsize;
     buf = (char *)newbuf;
-    memset(&buf[used], 0, newsize-used);
+    memset(&buf[used], 0, newsize+1-used);
 
     return true;
 }
 
+bool ExpandingString::reserve(uint32_t len)
+{
+    if (external_buffer || allocation_failed) {
+        return false;
+    }
+    if (buflen - used >= len) {
+        return true;
+    }
+    const uint32_t newsize = used + len;
+    void *newbuf = hal.util->std_realloc(buf, newsize+1);
+    if (newbuf == nullptr) {
+        return false;
+    }
+    buflen = newsize;
+    buf = (char *)newbuf;
+    memset(&buf[used], 0, newsize+1-used);
+    return true;
+}
+
 /*
   print into the buffer, expanding if needed
  */
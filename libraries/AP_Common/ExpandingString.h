@@ -41,6 +41,11 @@ public:
     // append data to the string. s can be null for zero fill
     bool append(const char *s, uint32_t len);
 
+    // make room for len more bytes in one allocation, for callers
+    // that know roughly how much they will print. A failure here
+    // leaves the string usable, to expand as it is printed into
+    bool reserve(uint32_t len);
+
     // set address to custom external buffer
     void set_buffer(char *s, uint32_t total_len, uint32_t used_len);
     // zero out the string
@@ -480,3 +480,92 @@ void Location::linearly_interpolate_alt(const Location &point1, const Location &
     // new target's distance along the original track and then linear interpolate between the original origin and destination altitudes
     set_alt_cm(point1.alt + (point2.alt - point1.alt) * constrain_float(line_path_proportion(point1, point2), 0.0f, 1.0f), point2.get_alt_frame());
 }
+
+void LocationProjection::set_reference(const Location &ref)
+{
+    _ref = ref;
+    const ftype lat_rad = ref.lat * (1.0e-7 * DEG_TO_RAD);
+    _lng_scale = cosF(lat_rad);
+    _lng_scale_per_dlat = sinF(lat_rad) * (0.5e-7 * DEG_TO_RAD);
+}
+
+/*
+  first order expansion of Location::longitude_scale() about the
+  reference latitude. The error is about 3e-7 of the scale at 10km
+  north or south of the reference.
+ */
+ftype LocationProjection::mid_longitude_scale(int32_t dlat) const
+{
+    const ftype scale = _lng_scale - _lng_scale_per_dlat * dlat;
+    return MAX(scale, 0.01);
+}
+
+Vector2f LocationProjection::to_NE(int32_t lat, int32_t lng) const
+{
+    const int32_t dlat = lat - _ref.lat;
+    return Vector2f(dlat * LATLON_TO_M,
+                    Location::diff_longitude(lng, _ref.lng) * LATLON_TO_M * mid_longitude_scale(dlat));
+}
+
+void LocationProjection::to_NE(const Location *locs, Vector2f *ne, uint16_t count) const
+{
+    for (uint16_t i=0; i<count; i++) {
+        ne[i] = to_NE(locs[i].lat, locs[i].lng);
+    }
+}
+
+void LocationProjection::to_NE(const Vector2l *latlng, Vector2f *ne, uint16_t count) const
+{
+    for (uint16_t i=0; i<count; i++) {
+        ne[i] = to_NE(latlng[i].x, latlng[i].y);
+    }
+}
+
+ftype LocationProjection::get_distance(const Location &loc) const
+{
+    return to_NE(loc).length();
+}
+
+ftype LocationProjection::get_bearing(const Location &loc) const
+{
+    const Vector2f ne = to_NE(loc);
+    return wrap_2PI(atan2F(ne.y, ne.x));
+}
+
+Location LocationProjection::from_NE(ftype ofs_north, ftype ofs_east) const
+{
+    Location ret = _ref;
+    const int32_t dlat = ofs_north * LATLON_TO_M_INV;
+    const int64_t dlng = (ofs_east * LATLON_TO_M_INV) / mid_longitude_scale(dlat);
+    ret.lat = Location::limit_lattitude(_ref.lat + dlat);
+    ret.lng = Location::wrap_longitude(dlng + _ref.lng);
+    return ret;
+}
+
+
+bool LocationLeg::set(const Location &origin, const Location &destination)
+{
+    const bool changed = !_valid ||
+        !origin.same_latlon_as(_origin) ||
+        !destination.same_latlon_as(_destination);
+
+    // altitudes and frames are always updated
+    _origin = origin;
+    _destination = destination;
+    if (!changed) {
+        return false;
+    }
+
+    _proj.set_reference(origin);
+    _vector_NE = _proj.to_NE(destination);
+    _length = _vector_NE.length();
+    if (is_zero_length()) {
+        _unit_NE.zero();
+        _bearing = 0;
+    } else {
+        _unit_NE = _vector_NE / _length;
+        _bearing = atan2F(_unit_NE.y, _unit_NE.x);
+    }
+    _valid = true;
+    return true;
+}
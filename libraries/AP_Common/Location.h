@@ -154,3 +154,102 @@ private:
     // inverse of LOCATION_SCALING_FACTOR
     static constexpr float LOCATION_SCALING_FACTOR_INV = LATLON_TO_M_INV;
 };
+
+/*
+  projection of locations onto a north-east plane around a reference
+  location. The longitude scale for the neighbourhood of the reference
+  is calculated once, so code converting many locations near the same
+  point (fence vertices, obstacles) avoids a cosine per conversion.
+  Results match the Location methods to within a few millimetres for
+  points within 10km of the reference.
+ */
+class LocationProjection
+{
+public:
+    LocationProjection() {}
+    LocationProjection(const Location &ref) { set_reference(ref); }
+
+    // set the reference location, recalculating the cached scale
+    void set_reference(const Location &ref);
+    const Location &get_reference() const { return _ref; }
+
+    // return the distance in meters in North/East plane from the reference to loc
+    Vector2f to_NE(const Location &loc) const { return to_NE(loc.lat, loc.lng); }
+    Vector2f to_NE(int32_t lat, int32_t lng) const;
+
+    // convert count locations, or latitude/longitude pairs, to North/East offsets in meters
+    void to_NE(const Location *locs, Vector2f *ne, uint16_t count) const;
+    void to_NE(const Vector2l *latlng, Vector2f *ne, uint16_t count) const;
+
+    // return horizontal distance in meters from the reference to loc
+    ftype get_distance(const Location &loc) const;
+
+    // return the bearing in radians from the reference to loc, from 0 to 2*Pi
+    ftype get_bearing(const Location &loc) const;
+
+    // return the reference offset by distances (in meters) north and
+    // east, keeping the reference altitude and frame
+    Location from_NE(ftype ofs_north, ftype ofs_east) const;
+
+private:
+    Location _ref;
+
+    // cosine of the reference latitude
+    ftype _lng_scale = 1;
+
+    // change in longitude scale per 1e-7 degrees of latitude difference,
+    // halved as the scale is taken at the mid latitude
+    ftype _lng_scale_per_dlat = 0;
+
+    // longitude scale at the latitude half way between the reference and lat
+    ftype mid_longitude_scale(int32_t dlat) const;
+};
+
+/*
+  geometry of a straight leg from an origin to a destination. The leg
+  vector, length and direction are calculated when the end points move
+  horizontally, and positions are projected about the origin, so a
+  navigation controller tracking the same leg needs no trigonometry
+  on each update.
+ */
+class LocationLeg
+{
+public:
+    // set the end points, returns true if the leg geometry was recalculated
+    bool set(const Location &origin, const Location &destination);
+
+    const Location &get_origin() const { return _origin; }
+    const Location &get_destination() const { return _destination; }
+
+    // North/East vector in meters from the origin to the destination
+    const Vector2f &get_vector_NE() const { return _vector_NE; }
+
+    // unit vector along the leg, zero if the leg has no length
+    const Vector2f &get_unit_NE() const { return _unit_NE; }
+
+    // length of the leg in meters
+    ftype get_length() const { return _length; }
+    bool is_zero_length() const { return _length < 1.0e-6f; }
+
+    // bearing of the leg in radians, from -Pi to Pi
+    ftype get_bearing() const { return _bearing; }
+
+    // return the distance in meters in North/East plane from the origin, or from the destination, to loc
+    Vector2f from_origin_NE(const Location &loc) const { return _proj.to_NE(loc); }
+    Vector2f from_destination_NE(const Location &loc) const { return from_origin_NE(loc) - _vector_NE; }
+
+    // distance in meters to the right of the leg, and along the leg,
+    // of a position given as an offset from the origin
+    ftype crosstrack(const Vector2f &ofs_from_origin) const { return ofs_from_origin % _unit_NE; }
+    ftype alongtrack(const Vector2f &ofs_from_origin) const { return ofs_from_origin * _unit_NE; }
+
+private:
+    Location _origin;
+    Location _destination;
+    LocationProjection _proj;
+    Vector2f _vector_NE;
+    Vector2f _unit_NE;
+    ftype _length = 0;
+    ftype _bearing = 0;
+    bool _valid = false;
+};
@@ -21,4 +21,24 @@ TEST(ExpandingString, Tests)
     test_string->printf("%s", long_string);
 }
 
+TEST(ExpandingString, Reserve)
+{
+    ExpandingString *s = new ExpandingString();
+    EXPECT_TRUE(s->reserve(100));
+    const char *buf = s->get_string();
+    for (uint8_t i=0; i<10; i++) {
+        s->printf("%u123456789", unsigned(i));
+    }
+    // fits without another allocation, and is terminated
+    EXPECT_EQ(buf, s->get_string());
+    EXPECT_EQ(100u, s->get_length());
+    EXPECT_EQ('\0', s->get_string()[100]);
+    EXPECT_TRUE(s->reserve(10));
+    EXPECT_EQ(100u, s->get_length());
+    s->printf("x");
+    EXPECT_EQ(101u, s->get_length());
+    EXPECT_FALSE(s->has_failed_allocation());
+    delete s;
+}
+
 AP_GTEST_MAIN()
@@ -374,4 +374,67 @@ TEST(Location, OffsetError)
     }
 }
 
+TEST(Location, Projection)
+{
+    const Location ref{-35362938, 149165085, 100, Location::AltFrame::ABSOLUTE};
+    const LocationProjection proj{ref};
+    EXPECT_VECTOR2F_EQ(Vector2f(0, 0), proj.to_NE(ref));
+
+    // matches the Location methods to a few millimetres within 10km
+    Location locs[4];
+    Vector2f ne[4];
+    const int32_t ofs[4][2] {{900000, 0}, {0, -1100000}, {-900000, 1100000}, {12345, 67890}};
+    for (uint8_t i=0; i<4; i++) {
+        locs[i] = Location(ref.lat + ofs[i][0], ref.lng + ofs[i][1], 0, Location::AltFrame::ABSOLUTE);
+    }
+    proj.to_NE(locs, ne, 4);
+    for (uint8_t i=0; i<4; i++) {
+        EXPECT_VECTOR2F_NEAR(ref.get_distance_NE(locs[i]), ne[i], 0.005);
+        EXPECT_VECTOR2F_EQ(ne[i], proj.to_NE(locs[i]));
+        EXPECT_NEAR(ref.get_distance(locs[i]), proj.get_distance(locs[i]), 0.005);
+        EXPECT_NEAR(ref.get_bearing(locs[i]), proj.get_bearing(locs[i]), 1.0e-4);
+
+        // and back again
+        const Location loc = proj.from_NE(ne[i].x, ne[i].y);
+        EXPECT_NEAR(locs[i].lat, loc.lat, 1);
+        EXPECT_NEAR(locs[i].lng, loc.lng, 1);
+        EXPECT_EQ(ref.alt, loc.alt);
+    }
+}
+
+TEST(Location, Leg)
+{
+    const Location origin{-35362938, 149165085, 100, Location::AltFrame::ABSOLUTE};
+    const Location dest{-35362938 + 450000, 149165085 + 550000, 200, Location::AltFrame::ABSOLUTE};
+    LocationLeg leg;
+    EXPECT_TRUE(leg.set(origin, dest));
+    EXPECT_VECTOR2F_NEAR(origin.get_distance_NE(dest), leg.get_vector_NE(), 0.005);
+    EXPECT_NEAR(origin.get_distance(dest), leg.get_length(), 0.005);
+    EXPECT_NEAR(wrap_PI(origin.get_bearing(dest)), leg.get_bearing(), 1.0e-4);
+    EXPECT_FLOAT_EQ(1, leg.get_unit_NE().length());
+
+    // only recalculated when the end points move horizontally
+    Location dest2 = dest;
+    dest2.alt = 300;
+    EXPECT_FALSE(leg.set(origin, dest2));
+    EXPECT_EQ(300, leg.get_destination().alt);
+    dest2.lat += 1000;
+    EXPECT_TRUE(leg.set(origin, dest2));
+    EXPECT_TRUE(leg.set(origin, dest));
+
+    // crosstrack and alongtrack match the Location methods
+    const Location veh{-35362938 + 200000, 149165085 + 300000, 0, Location::AltFrame::ABSOLUTE};
+    const Vector2f ofs = leg.from_origin_NE(veh);
+    Vector2f unit = origin.get_distance_NE(dest);
+    unit.normalize();
+    EXPECT_NEAR(origin.get_distance_NE(veh) % unit, leg.crosstrack(ofs), 0.005);
+    EXPECT_NEAR(origin.get_distance_NE(veh) * unit, leg.alongtrack(ofs), 0.005);
+    EXPECT_VECTOR2F_NEAR(dest.get_distance_NE(veh), leg.from_destination_NE(veh), 0.05);
+
+    // a leg with no length has no direction
+    EXPECT_TRUE(leg.set(origin, origin));
+    EXPECT_TRUE(leg.is_zero_length());
+    EXPECT_VECTOR2F_EQ(Vector2f(0, 0), leg.get_unit_NE());
+}
+
 AP_GTEST_MAIN()
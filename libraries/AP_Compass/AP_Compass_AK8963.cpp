@@ -258,12 +258,13 @@ bool AP_Compass_AK8963::_reset()
 
 bool AP_Compass_AK8963::_calibrate()
 {
-    /* Enable FUSE-mode in order to be able to read calibration data */
-    _bus->register_write(AK8963_CNTL1, AK8963_FUSE_MODE | AK8963_16BIT_ADC);
-
     uint8_t response[3];
 
-    _bus->block_read(AK8963_ASAX, response, 3);
+    /* Enable FUSE-mode in order to be able to read calibration data */
+    if (!_bus->register_write_block_read(AK8963_CNTL1, AK8963_FUSE_MODE | AK8963_16BIT_ADC,
+                                         AK8963_ASAX, response, 3)) {
+        return false;
+    }
 
     for (int i = 0; i < 3; i++) {
         float data = response[i];
@@ -294,6 +295,14 @@ bool AP_AK8963_BusDriver_HALDevice::register_write(uint8_t reg, uint8_t val)
     return _dev->write_register(reg, val);
 }
 
+bool AP_AK8963_BusDriver_HALDevice::register_write_block_read(uint8_t wreg, uint8_t val, uint8_t rreg, uint8_t *buf, uint32_t size)
+{
+    AP_HAL::Device::TransferBatch<2> batch(*_dev);
+    batch.write_register(wreg, val);
+    batch.read_registers(rreg, buf, size);
+    return batch.submit();
+}
+
 AP_HAL::Semaphore *AP_AK8963_BusDriver_HALDevice::get_semaphore()
 {
     return _dev->get_semaphore();
@@ -68,6 +68,11 @@ public:
     virtual bool register_read(uint8_t reg, uint8_t *val) = 0;
     virtual bool register_write(uint8_t reg, uint8_t val) = 0;
 
+    // write a register and then read a block of registers, in one bus operation where possible
+    virtual bool register_write_block_read(uint8_t wreg, uint8_t val, uint8_t rreg, uint8_t *buf, uint32_t size) {
+        return register_write(wreg, val) && block_read(rreg, buf, size);
+    }
+
     virtual AP_HAL::Semaphore  *get_semaphore() = 0;
 
     virtual bool configure() { return true; }
@@ -89,6 +94,7 @@ public:
     virtual bool block_read(uint8_t reg, uint8_t *buf, uint32_t size) override;
     virtual bool register_read(uint8_t reg, uint8_t *val) override;
     virtual bool register_write(uint8_t reg, uint8_t val) override;
+    bool register_write_block_read(uint8_t wreg, uint8_t val, uint8_t rreg, uint8_t *buf, uint32_t size) override;
 
     virtual AP_HAL::Semaphore  *get_semaphore() override;
     AP_HAL::Device::PeriodicHandle register_periodic_callback(uint32_t period_usec, AP_HAL::Device::PeriodicCb) override;
@@ -194,11 +194,12 @@ void CompassCalibrator::update()
                 set_status(Status::RUNNING_STEP_TWO);
             }
         } else {
-            if (_fit_step == 0) {
+            if (_fit_step == 0 && _fit.phase == FitPhase::NONE) {
                 calc_initial_offset();
             }
-            run_sphere_fit();
-            _fit_step++;
+            if (run_fit(false, COMPASS_CAL_SAMPLES_PER_UPDATE)) {
+                _fit_step++;
+            }
         }
     } else if (_status == Status::RUNNING_STEP_TWO) {
         if (_fit_step >= 35) {
@@ -208,11 +209,13 @@ void CompassCalibrator::update()
                 set_status(Status::FAILED);
             }
         } else if (_fit_step < 15) {
-            run_sphere_fit();
-            _fit_step++;
+            if (run_fit(false, COMPASS_CAL_SAMPLES_PER_UPDATE)) {
+                _fit_step++;
+            }
         } else {
-            run_ellipsoid_fit();
-            _fit_step++;
+            if (run_fit(true, COMPASS_CAL_SAMPLES_PER_UPDATE)) {
+                _fit_step++;
+            }
         }
     }
 }
@@ -351,6 +354,7 @@ void CompassCalibrator::initialize_fit()
     _sphere_lambda = 1.0f;
     _ellipsoid_lambda = 1.0f;
     _fit_step = 0;
+    _fit.phase = FitPhase::NONE;
 }
 
 void CompassCalibrator::reset_state()
@@ -614,90 +618,10 @@ void CompassCalibrator::calc_sphere_jacob(const Vector3f& sample, const param_t&
     ret[3] = -1.0f * (((offdiag.y * A) + (offdiag.z * B) + (diag.z    * C))/length);
 }
 
-// run sphere fit to calculate diagonals and offdiagonals
+// run a complete sphere fit to calculate radius and offsets
 void CompassCalibrator::run_sphere_fit()
 {
-    if (_sample_buffer == nullptr) {
-        return;
-    }
-
-    const float lma_damping = 10.0f;
-
-    // take backup of fitness and parameters so we can determine later if this fit has improved the calibration
-    float fitness = _fitness;
-    float fit1, fit2;
-    param_t fit1_params, fit2_params;
-    fit1_params = fit2_params = _params;
-
-    float JTJ[COMPASS_CAL_NUM_SPHERE_PARAMS*COMPASS_CAL_NUM_SPHERE_PARAMS] = { };
-    float JTJ2[COMPASS_CAL_NUM_SPHERE_PARAMS*COMPASS_CAL_NUM_SPHERE_PARAMS] = { };
-    float JTFI[COMPASS_CAL_NUM_SPHERE_PARAMS] = { };
-
-    // Gauss Newton Part common for all kind of extensions including LM
-    for (uint16_t k = 0; k<_samples_collected; k++) {
-        Vector3f sample = _sample_buffer[k].get();
-
-        float sphere_jacob[COMPASS_CAL_NUM_SPHERE_PARAMS];
-
-        calc_sphere_jacob(sample, fit1_params, sphere_jacob);
-
-        for (uint8_t i = 0;i < COMPASS_CAL_NUM_SPHERE_PARAMS; i++) {
-            // compute JTJ
-            for (uint8_t j = 0; j < COMPASS_CAL_NUM_SPHERE_PARAMS; j++) {
-                JTJ[i*COMPASS_CAL_NUM_SPHERE_PARAMS+j] += sphere_jacob[i] * sphere_jacob[j];
-                JTJ2[i*COMPASS_CAL_NUM_SPHERE_PARAMS+j] += sphere_jacob[i] * sphere_jacob[j];   //a backup JTJ for LM
-            }
-            // compute JTFI
-            JTFI[i] += sphere_jacob[i] * calc_residual(sample, fit1_params);
-        }
-    }
-
-    //------------------------Levenberg-Marquardt-part-starts-here---------------------------------//
-    // refer: http://en.wikipedia.org/wiki/Levenberg%E2%80%93Marquardt_algorithm#Choice_of_damping_parameter
-    for (uint8_t i = 0; i < COMPASS_CAL_NUM_SPHERE_PARAMS; i++) {
-        JTJ[i*COMPASS_CAL_NUM_SPHERE_PARAMS+i] += _sphere_lambda;
-        JTJ2[i*COMPASS_CAL_NUM_SPHERE_PARAMS+i] += _sphere_lambda/lma_damping;
-    }
-
-    if (!mat_inverse(JTJ, JTJ, 4)) {
-        return;
-    }
-
-    if (!mat_inverse(JTJ2, JTJ2, 4)) {
-        return;
-    }
-
-    // extract radius, offset, diagonals and offdiagonal parameters
-    for (uint8_t row=0; row < COMPASS_CAL_NUM_SPHERE_PARAMS; row++) {
-        for (uint8_t col=0; col < COMPASS_CAL_NUM_SPHERE_PARAMS; col++) {
-            fit1_params.get_sphere_params()[row] -= JTFI[col] * JTJ[row*COMPASS_CAL_NUM_SPHERE_PARAMS+col];
-            fit2_params.get_sphere_params()[row] -= JTFI[col] * JTJ2[row*COMPASS_CAL_NUM_SPHERE_PARAMS+col];
-        }
-    }
-
-    // calculate fitness of two possible sets of parameters
-    fit1 = calc_mean_squared_residuals(fit1_params);
-    fit2 = calc_mean_squared_residuals(fit2_params);
-
-    // decide which of the two sets of parameters is best and store in fit1_params
-    if (fit1 > _fitness && fit2 > _fitness) {
-        // if neither set of parameters provided better results, increase lambda
-        _sphere_lambda *= lma_damping;
-    } else if (fit2 < _fitness && fit2 < fit1) {
-        // if fit2 was better we will use it. decrease lambda
-        _sphere_lambda /= lma_damping;
-        fit1_params = fit2_params;
-        fitness = fit2;
-    } else if (fit1 < _fitness) {
-        fitness = fit1;
-    }
-    //--------------------Levenberg-Marquardt-part-ends-here--------------------------------//
-
-    // store new parameters and update fitness
-    if (!isnan(fitness) && fitness < _fitness) {
-        _fitness = fitness;
-        _params = fit1_params;
-        update_completion_mask();
+    while (!run_fit(false, COMPASS_CAL_NUM_SAMPLES)) {
     }
 }
 
@@ -731,88 +655,167 @@ void CompassCalibrator::calc_ellipsoid_jacob(const Vector3f& sample, const param
     ret[8] = -1.0f * (((sample.z + offset.z) * B) + ((sample.y + offset.y) * C))/length;
 }
 
+// run a complete ellipsoid fit to calculate offsets, diagonals and offdiagonals
 void CompassCalibrator::run_ellipsoid_fit()
 {
-    if (_sample_buffer == nullptr) {
-        return;
+    while (!run_fit(true, COMPASS_CAL_NUM_SAMPLES)) {
     }
+}
 
-    const float lma_damping = 10.0f;
-
-    // take backup of fitness and parameters so we can determine later if this fit has improved the calibration
-    float fitness = _fitness;
-    float fit1, fit2;
-    param_t fit1_params, fit2_params;
-    fit1_params = fit2_params = _params;
+/*
+  run part of a Levenberg-Marquardt sphere or ellipsoid fit. A fit
+  makes two passes over the sample buffer, the first summing the
+  jacobians and the second the residuals of the two candidate
+  parameter sets. Each call looks at no more than max_samples samples,
+  so that the time taken by update() stays bounded whatever the number
+  of compasses being calibrated. Returns true when the fit is complete
+ */
+bool CompassCalibrator::run_fit(bool ellipsoid, uint16_t max_samples)
+{
+    if (_sample_buffer == nullptr || _samples_collected == 0) {
+        _fit.phase = FitPhase::NONE;
+        return true;
+    }
 
-    float JTJ[COMPASS_CAL_NUM_ELLIPSOID_PARAMS*COMPASS_CAL_NUM_ELLIPSOID_PARAMS] = { };
-    float JTJ2[COMPASS_CAL_NUM_ELLIPSOID_PARAMS*COMPASS_CAL_NUM_ELLIPSOID_PARAMS] = { };
-    float JTFI[COMPASS_CAL_NUM_ELLIPSOID_PARAMS] = { };
+    if (_fit.phase == FitPhase::NONE || _fit.ellipsoid != ellipsoid) {
+        // take backup of parameters so we can determine later if this fit has improved the calibration
+        memset(_fit.JTJ, 0, sizeof(_fit.JTJ));
+        memset(_fit.JTFI, 0, sizeof(_fit.JTFI));
+        _fit.fit1_params = _fit.fit2_params = _params;
+        _fit.ellipsoid = ellipsoid;
+        _fit.next_sample = 0;
+        _fit.phase = FitPhase::ACCUMULATE;
+    }
 
-    // Gauss Newton Part common for all kind of extensions including LM
-    for (uint16_t k = 0; k<_samples_collected; k++) {
-        Vector3f sample = _sample_buffer[k].get();
+    const uint16_t end = MIN(uint32_t(_fit.next_sample) + max_samples, _samples_collected);
 
-        float ellipsoid_jacob[COMPASS_CAL_NUM_ELLIPSOID_PARAMS];
+    if (_fit.phase == FitPhase::ACCUMULATE) {
+        const uint8_t num_params = ellipsoid ? COMPASS_CAL_NUM_ELLIPSOID_PARAMS : COMPASS_CAL_NUM_SPHERE_PARAMS;
 
-        calc_ellipsoid_jacob(sample, fit1_params, ellipsoid_jacob);
+        // Gauss Newton Part common for all kind of extensions including LM
+        for (uint16_t k = _fit.next_sample; k < end; k++) {
+            const Vector3f sample = _sample_buffer[k].get();
 
-        for (uint8_t i = 0;i < COMPASS_CAL_NUM_ELLIPSOID_PARAMS; i++) {
-            // compute JTJ
-            for (uint8_t j = 0; j < COMPASS_CAL_NUM_ELLIPSOID_PARAMS; j++) {
-                JTJ [i*COMPASS_CAL_NUM_ELLIPSOID_PARAMS+j] += ellipsoid_jacob[i] * ellipsoid_jacob[j];
-                JTJ2[i*COMPASS_CAL_NUM_ELLIPSOID_PARAMS+j] += ellipsoid_jacob[i] * ellipsoid_jacob[j];
+            float jacob[COMPASS_CAL_NUM_ELLIPSOID_PARAMS];
+            if (ellipsoid) {
+                calc_ellipsoid_jacob(sample, _fit.fit1_params, jacob);
+            } else {
+                calc_sphere_jacob(sample, _fit.fit1_params, jacob);
+            }
+            const float residual = calc_residual(sample, _fit.fit1_params);
+
+            for (uint8_t i = 0; i < num_params; i++) {
+                // compute JTJ
+                for (uint8_t j = 0; j < num_params; j++) {
+                    _fit.JTJ[i*num_params+j] += jacob[i] * jacob[j];
+                }
+                // compute JTFI
+                _fit.JTFI[i] += jacob[i] * residual;
             }
-            // compute JTFI
-            JTFI[i] += ellipsoid_jacob[i] * calc_residual(sample, fit1_params);
         }
+        _fit.next_sample = end;
+        if (end < _samples_collected) {
+            return false;
+        }
+
+        if (!solve_fit()) {
+            _fit.phase = FitPhase::NONE;
+            return true;
+        }
+        _fit.fit1_sum = 0;
+        _fit.fit2_sum = 0;
+        _fit.next_sample = 0;
+        _fit.phase = FitPhase::EVALUATE;
+        return false;
     }
 
-    //------------------------Levenberg-Marquardt-part-starts-here---------------------------------//
-    //refer: http://en.wikipedia.org/wiki/Levenberg%E2%80%93Marquardt_algorithm#Choice_of_damping_parameter
-    for (uint8_t i = 0; i < COMPASS_CAL_NUM_ELLIPSOID_PARAMS; i++) {
-        JTJ[i*COMPASS_CAL_NUM_ELLIPSOID_PARAMS+i] += _ellipsoid_lambda;
-        JTJ2[i*COMPASS_CAL_NUM_ELLIPSOID_PARAMS+i] += _ellipsoid_lambda/lma_damping;
+    // calculate fitness of two possible sets of parameters
+    for (uint16_t k = _fit.next_sample; k < end; k++) {
+        const Vector3f sample = _sample_buffer[k].get();
+        _fit.fit1_sum += sq(calc_residual(sample, _fit.fit1_params));
+        _fit.fit2_sum += sq(calc_residual(sample, _fit.fit2_params));
+    }
+    _fit.next_sample = end;
+    if (end < _samples_collected) {
+        return false;
     }
 
-    if (!mat_inverse(JTJ, JTJ, 9)) {
-        return;
+    finish_fit();
+    _fit.phase = FitPhase::NONE;
+    return true;
+}
+
+// Levenberg-Marquardt step giving the two candidate parameter sets
+bool CompassCalibrator::solve_fit()
+{
+    const float lma_damping = 10.0f;
+
+    //------------------------Levenberg-Marquardt-part-starts-here---------------------------------//
+    // refer: http://en.wikipedia.org/wiki/Levenberg%E2%80%93Marquardt_algorithm#Choice_of_damping_parameter
+    const uint8_t num_params = _fit.ellipsoid ? COMPASS_CAL_NUM_ELLIPSOID_PARAMS : COMPASS_CAL_NUM_SPHERE_PARAMS;
+    const float lambda = _fit.ellipsoid ? _ellipsoid_lambda : _sphere_lambda;
+    float *JTJ = _fit.JTJ;
+    float JTJ2[COMPASS_CAL_NUM_ELLIPSOID_PARAMS*COMPASS_CAL_NUM_ELLIPSOID_PARAMS];  //a backup JTJ for LM
+    memcpy(JTJ2, JTJ, sizeof(JTJ2));
+
+    for (uint8_t i = 0; i < num_params; i++) {
+        JTJ[i*num_params+i] += lambda;
+        JTJ2[i*num_params+i] += lambda/lma_damping;
     }
 
-    if (!mat_inverse(JTJ2, JTJ2, 9)) {
-        return;
+    if (_fit.ellipsoid) {
+        if (!mat_inverse<float, COMPASS_CAL_NUM_ELLIPSOID_PARAMS>(JTJ, JTJ) ||
+            !mat_inverse<float, COMPASS_CAL_NUM_ELLIPSOID_PARAMS>(JTJ2, JTJ2)) {
+            return false;
+        }
+    } else {
+        if (!mat_inverse<float, COMPASS_CAL_NUM_SPHERE_PARAMS>(JTJ, JTJ) ||
+            !mat_inverse<float, COMPASS_CAL_NUM_SPHERE_PARAMS>(JTJ2, JTJ2)) {
+            return false;
+        }
     }
 
     // extract radius, offset, diagonals and offdiagonal parameters
-    for (uint8_t row=0; row < COMPASS_CAL_NUM_ELLIPSOID_PARAMS; row++) {
-        for (uint8_t col=0; col < COMPASS_CAL_NUM_ELLIPSOID_PARAMS; col++) {
-            fit1_params.get_ellipsoid_params()[row] -= JTFI[col] * JTJ[row*COMPASS_CAL_NUM_ELLIPSOID_PARAMS+col];
-            fit2_params.get_ellipsoid_params()[row] -= JTFI[col] * JTJ2[row*COMPASS_CAL_NUM_ELLIPSOID_PARAMS+col];
+    float *fit1 = _fit.ellipsoid ? _fit.fit1_params.get_ellipsoid_params() : _fit.fit1_params.get_sphere_params();
+    float *fit2 = _fit.ellipsoid ? _fit.fit2_params.get_ellipsoid_params() : _fit.fit2_params.get_sphere_params();
+    for (uint8_t row=0; row < num_params; row++) {
+        for (uint8_t col=0; col < num_params; col++) {
+            fit1[row] -= _fit.JTFI[col] * JTJ[row*num_params+col];
+            fit2[row] -= _fit.JTFI[col] * JTJ2[row*num_params+col];
         }
     }
+    return true;
+}
 
-    // calculate fitness of two possible sets of parameters
-    fit1 = calc_mean_squared_residuals(fit1_params);
-    fit2 = calc_mean_squared_residuals(fit2_params);
+// pick the better candidate parameter set and adjust lambda
+void CompassCalibrator::finish_fit()
+{
+    const float lma_damping = 10.0f;
+    float &lambda = _fit.ellipsoid ? _ellipsoid_lambda : _sphere_lambda;
+
+    // take backup of fitness so we can determine later if this fit has improved the calibration
+    float fitness = _fitness;
+    const float fit1 = _fit.fit1_sum / _samples_collected;
+    const float fit2 = _fit.fit2_sum / _samples_collected;
 
     // decide which of the two sets of parameters is best and store in fit1_params
     if (fit1 > _fitness && fit2 > _fitness) {
         // if neither set of parameters provided better results, increase lambda
-        _ellipsoid_lambda *= lma_damping;
+        lambda *= lma_damping;
     } else if (fit2 < _fitness && fit2 < fit1) {
         // if fit2 was better we will use it. decrease lambda
-        _ellipsoid_lambda /= lma_damping;
-        fit1_params = fit2_params;
+        lambda /= lma_damping;
+        _fit.fit1_params = _fit.fit2_params;
         fitness = fit2;
     } else if (fit1 < _fitness) {
         fitness = fit1;
     }
-    //--------------------Levenberg-part-ends-here--------------------------------//
+    //--------------------Levenberg-Marquardt-part-ends-here--------------------------------//
 
     // store new parameters and update fitness
-    if (fitness < _fitness) {
+    if (!isnan(fitness) && fitness < _fitness) {
         _fitness = fitness;
-        _params = fit1_params;
+        _params = _fit.fit1_params;
         update_completion_mask();
     }
 }
@@ -6,6 +6,12 @@
 #define COMPASS_CAL_NUM_ELLIPSOID_PARAMS    9
 #define COMPASS_CAL_NUM_SAMPLES             300     // number of samples required before fitting begins
 
+// number of samples a fit looks at in each call to update(), bounding
+// the time each call takes
+#ifndef COMPASS_CAL_SAMPLES_PER_UPDATE
+#define COMPASS_CAL_SAMPLES_PER_UPDATE      100
+#endif
+
 #define COMPASS_MAX_SCALE_FACTOR 1.5
 #define COMPASS_MIN_SCALE_FACTOR (1.0/COMPASS_MAX_SCALE_FACTOR)
 
@@ -187,6 +193,12 @@ private:
     void calc_ellipsoid_jacob(const Vector3f& sample, const param_t& params, float* ret) const;
     void run_ellipsoid_fit();
 
+    // run part of a sphere or ellipsoid fit, looking at no more than
+    // max_samples samples. Returns true when the fit is complete
+    bool run_fit(bool ellipsoid, uint16_t max_samples);
+    bool solve_fit();
+    void finish_fit();
+
     // update the completion mask based on a single sample
     void update_completion_mask(const Vector3f& sample);
 
@@ -233,6 +245,24 @@ private:
     float _sphere_lambda;                   // sphere fit's lambda
     float _ellipsoid_lambda;                // ellipsoid fit's lambda
 
+    // fit in progress, spread over several calls to update()
+    enum class FitPhase : uint8_t {
+        NONE,
+        ACCUMULATE,                         // summing the jacobians over the samples
+        EVALUATE,                           // summing the residuals of the two candidate fits
+    };
+    struct {
+        FitPhase phase;
+        bool ellipsoid;
+        uint16_t next_sample;
+        float JTJ[COMPASS_CAL_NUM_ELLIPSOID_PARAMS*COMPASS_CAL_NUM_ELLIPSOID_PARAMS];
+        float JTFI[COMPASS_CAL_NUM_ELLIPSOID_PARAMS];
+        param_t fit1_params;                // candidate with the full lambda
+        param_t fit2_params;                // candidate with the reduced lambda
+        float fit1_sum;                     // sums of squared residuals of the candidates
+        float fit2_sum;
+    } _fit;
+
     // variables for orientation checking
     enum Rotation _orientation;             // latest detected orientation
     enum Rotation _orig_orientation;        // original orientation provided by caller
@@ -14,6 +14,9 @@
 
 extern const AP_HAL::HAL& hal;
 
+// interval between frames where all messages are written in full
+#define DAL_KEYFRAME_INTERVAL_US 1000000U
+
 AP_DAL *AP_DAL::_singleton = nullptr;
 
 bool AP_DAL::force_write;
@@ -43,13 +46,33 @@ void AP_DAL::start_frame(AP_DAL::FrameType frametype)
     }
     logging_started = logging;
 
+    // write a keyframe regularly so a replay can recover from a
+    // message lost between keyframes
+    const uint64_t now_us = AP_HAL::micros64();
+    if (now_us - _last_keyframe_us >= DAL_KEYFRAME_INTERVAL_US) {
+        force_write = true;
+    }
+    if (force_write) {
+        _last_keyframe_us = now_us;
+    }
+
     end_frame();
 
     _RFRF.frame_types = uint8_t(frametype);
     
+    const log_RFRH old_RFRH = _RFRH;
     _RFRH.time_flying_ms = AP::vehicle()->get_time_flying_ms();
-    _RFRH.time_us = AP_HAL::micros64();
-    WRITE_REPLAY_BLOCK(RFRH, _RFRH);
+    _RFRH.time_us = now_us;
+    const uint64_t dt_us = _RFRH.time_us - old_RFRH.time_us;
+    const uint32_t dt_flying_ms = _RFRH.time_flying_ms - old_RFRH.time_flying_ms;
+    if (!force_write && old_RFRH._end == 0 && dt_us <= UINT16_MAX && dt_flying_ms <= UINT16_MAX) {
+        // write the frame header as the change from the last one
+        struct log_RFRD RFRD { uint16_t(dt_us), uint16_t(dt_flying_ms), 0 };
+        WRITE_REPLAY_BLOCK(RFRD, RFRD);
+        _RFRH._end = RFRD._end;
+    } else {
+        WRITE_REPLAY_BLOCK(RFRH, _RFRH);
+    }
 
     // update RFRN data
     const log_RFRN old = _RFRN;
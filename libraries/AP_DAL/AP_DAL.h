@@ -223,6 +223,12 @@ public:
         _micros = _RFRH.time_us;
         _millis = _RFRH.time_us / 1000UL;
     }
+    void handle_message(const log_RFRD &msg) {
+        _RFRH.time_us += msg.dt_us;
+        _RFRH.time_flying_ms += msg.dt_flying_ms;
+        _micros = _RFRH.time_us;
+        _millis = _RFRH.time_us / 1000UL;
+    }
     void handle_message(const log_RFRN &msg) {
         _RFRN = msg;
         _home.lat = msg.lat;
@@ -237,6 +243,9 @@ public:
     void handle_message(const log_RISI &msg) {
         _ins.handle_message(msg);
     }
+    void handle_message(const log_RISD &msg) {
+        _ins.handle_message(msg);
+    }
 
     void handle_message(const log_RASH &msg) {
         if (_airspeed == nullptr) {
@@ -325,6 +334,11 @@ public:
     // only write if the content has changed
     static void WriteLogMessage(enum LogMessages msg_type, void *msg, const void *old_msg, uint8_t msg_size);
 
+    // true when all messages are being written in full, when logging
+    // starts and on keyframes. Between keyframes messages may be
+    // written as the change from the last message
+    static bool force_writing(void) { return force_write; }
+
 private:
 
     static AP_DAL *_singleton;
@@ -348,6 +362,7 @@ private:
     Matrix3f _rotation_vehicle_body_to_autopilot_body;
     Location _home;
     uint32_t _last_imu_time_us;
+    uint64_t _last_keyframe_us;
 
     AP_DAL_InertialSensor _ins;
     AP_DAL_Baro _baro;
@@ -24,7 +24,8 @@ void AP_DAL_Baro::start_frame()
         log_RBRI old = RBRI;
         RBRI.last_update_ms = baro.get_last_update(i);
         RBRI.healthy = baro.healthy(i);
-        RBRI.altitude = baro.get_altitude(i);
+        // the primary's altitude is the blended one if enabled
+        RBRI.altitude = i == _RBRH.primary ? baro.get_altitude() : baro.get_altitude(i);
         WRITE_REPLAY_BLOCK_IFCHANGED(RBRI, _RBRI[i], old);
     }
 }
@@ -43,7 +43,19 @@ void AP_DAL_InertialSensor::start_frame()
 
         update_filtered(i);
 
-        WRITE_REPLAY_BLOCK_IFCHANGED(RISI, RISI, old_RISI);
+        const uint8_t deltas_len = offsetof(log_RISI, delta_velocity_dt);
+        if (!AP_DAL::force_writing() && old_RISI._end == 0 &&
+            memcmp(((const uint8_t *)&RISI) + deltas_len, ((const uint8_t *)&old_RISI) + deltas_len,
+                   offsetof(log_RISI, _end) - deltas_len) == 0) {
+            // only the deltas can have changed, write just those
+            if (memcmp(&RISI, &old_RISI, deltas_len) != 0) {
+                struct log_RISD RISD { RISI.delta_velocity, RISI.delta_angle, RISI.instance, 0 };
+                WRITE_REPLAY_BLOCK(RISD, RISD);
+                RISI._end = RISD._end;
+            }
+        } else {
+            WRITE_REPLAY_BLOCK_IFCHANGED(RISI, RISI, old_RISI);
+        }
 
         // update sensor position
         pos[i] = ins.get_imu_pos_offset(i);
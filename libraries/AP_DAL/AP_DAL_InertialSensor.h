@@ -57,6 +57,13 @@ public:
         pos[msg.instance] = AP::ins().get_imu_pos_offset(msg.instance);
         update_filtered(msg.instance);
     }
+    void handle_message(const log_RISD &msg) {
+        log_RISI &RISI = _RISI[msg.instance];
+        RISI.delta_velocity = msg.delta_velocity;
+        RISI.delta_angle = msg.delta_angle;
+        pos[msg.instance] = AP::ins().get_imu_pos_offset(msg.instance);
+        update_filtered(msg.instance);
+    }
 
 private:
     struct log_RISH _RISH;
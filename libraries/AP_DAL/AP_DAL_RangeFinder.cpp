@@ -81,7 +81,7 @@ void AP_DAL_RangeFinder::start_frame()
         if (backend == nullptr) {
             continue;
         }
-        _backend[i]->start_frame(backend);
+        _backend[i]->start_frame(backend, rangefinder->is_fused_source(i));
     }
 }
 
@@ -93,10 +93,11 @@ AP_DAL_RangeFinder_Backend::AP_DAL_RangeFinder_Backend(struct log_RRNI &RRNI) :
 {
 }
 
-void AP_DAL_RangeFinder_Backend::start_frame(AP_RangeFinder_Backend *backend) {
+void AP_DAL_RangeFinder_Backend::start_frame(AP_RangeFinder_Backend *backend, bool fused_source) {
     const log_RRNI old = _RRNI;
     _RRNI.orientation = backend->orientation();
-    _RRNI.status = (uint8_t)backend->status();
+    // a sensor combined into a fused instance is only seen through it
+    _RRNI.status = fused_source ? (uint8_t)RangeFinder::Status::NotConnected : (uint8_t)backend->status();
     _RRNI.pos_offset = backend->get_pos_offset();
     _RRNI.distance_cm = backend->distance_cm();
     WRITE_REPLAY_BLOCK_IFCHANGED(RRNI, _RRNI, old);
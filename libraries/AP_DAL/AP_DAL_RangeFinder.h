@@ -62,7 +62,7 @@ public:
     const Vector3f &get_pos_offset() const { return _RRNI.pos_offset; }
 
     // DAL methods:
-    void start_frame(AP_RangeFinder_Backend *backend);
+    void start_frame(AP_RangeFinder_Backend *backend, bool fused_source);
 
 private:
 
@@ -17,8 +17,10 @@
     LOG_RWA3_MSG, \
     LOG_REY3_MSG, \
     LOG_RFRN_MSG, \
+    LOG_RFRD_MSG, \
     LOG_RISH_MSG, \
     LOG_RISI_MSG, \
+    LOG_RISD_MSG, \
     LOG_RBRH_MSG, \
     LOG_RBRI_MSG, \
     LOG_RRNH_MSG, \
@@ -46,6 +48,14 @@ struct log_RFRH {
     uint8_t _end;
 };
 
+// Replay Data Structure - frame header as the change from the last
+// frame header, written in place of RFRH between keyframes
+struct log_RFRD {
+    uint16_t dt_us;
+    uint16_t dt_flying_ms;
+    uint8_t _end;
+};
+
 struct log_RFRF {
     uint8_t frame_types;
     uint8_t core_slow;
@@ -97,6 +107,15 @@ struct log_RISI {
     uint8_t _end;
 };
 
+// Replay Data Structure - Inertial Sensor instance deltas, written in
+// place of RISI between keyframes when only the deltas have changed
+struct log_RISD {
+    Vector3f delta_velocity;
+    Vector3f delta_angle;
+    uint8_t instance;
+    uint8_t _end;
+};
+
 // @LoggerMessage: REV2
 // @Description: Replay Event
 struct log_REV2 {
@@ -367,6 +386,8 @@ struct log_RBOH {
       "RFRF", "BB", "FTypes,Slow", "--", "--" }, \
     { LOG_RFRN_MSG, RLOG_SIZE(RFRN),                            \
       "RFRN", "IIIfIfffBBB", "HLat,HLon,HAlt,E2T,AM,TX,TY,TZ,VC,EKT,Flags", "DUm????????", "GGB--------" }, \
+    { LOG_RFRD_MSG, RLOG_SIZE(RFRD),                          \
+      "RFRD", "HH", "DT,DTF", "s-", "F-" }, \
     { LOG_REV2_MSG, RLOG_SIZE(REV2),                                   \
       "REV2", "B", "Event", "-", "-" }, \
     { LOG_RSO2_MSG, RLOG_SIZE(RSO2),                         \
@@ -385,6 +406,8 @@ struct log_RBOH {
       "RISH", "HBBfBB", "LR,PG,PA,LD,AC,GC", "------", "------" }, \
     { LOG_RISI_MSG, RLOG_SIZE(RISI),                                   \
       "RISI", "ffffffffBB", "DVX,DVY,DVZ,DAX,DAY,DAZ,DVDT,DADT,Flags,I", "---------#", "----------" }, \
+    { LOG_RISD_MSG, RLOG_SIZE(RISD),                                   \
+      "RISD", "ffffffB", "DVX,DVY,DVZ,DAX,DAY,DAZ,I", "------#", "-------" }, \
     { LOG_RASH_MSG, RLOG_SIZE(RASH),                                   \
       "RASH", "BB", "Primary,NumInst", "--", "--" },  \
     { LOG_RASI_MSG, RLOG_SIZE(RASI),                                   \
@@ -95,6 +95,39 @@ uint8_t AP_ESC_Telem::get_motor_frequencies_hz(uint8_t nfreqs, float* freqs) con
     return MIN(valid_escs, nfreqs);
 }
 
+// return all the motor frequencies in Hz estimated at the current time. The slewed rpm from get_rpm()
+// lags by up to an update interval, here each ESC's rpm is instead extrapolated from its measurement
+// time by its last change, for at most one update interval
+uint8_t AP_ESC_Telem::get_time_aligned_motor_frequencies_hz(uint8_t nfreqs, float* freqs) const
+{
+    uint8_t valid_escs = 0;
+    const uint32_t now = AP_HAL::micros();
+
+    for (uint8_t i = 0; i < ESC_TELEM_MAX_ESCS && valid_escs < nfreqs; i++) {
+        AP_ESC_Telem_Backend::RpmData rpmdata;
+        read_rpm_data(i, rpmdata);
+        if (rpmdata.last_update_us == 0) {
+            continue;
+        }
+        if (is_zero(rpmdata.update_rate_hz) || now < rpmdata.last_update_us
+            || now - rpmdata.last_update_us >= ESC_RPM_DATA_TIMEOUT_US) {
+            // mark it as valid but with no data, as for get_motor_frequencies_hz()
+            freqs[valid_escs++] = 0.0f;
+            continue;
+        }
+        const float lead = MIN(1.0f, (now - rpmdata.sample_us) * rpmdata.update_rate_hz * (1.0f / 1e6f));
+        float rpm = MAX(0.0f, rpmdata.rpm + (rpmdata.rpm - rpmdata.prev_rpm) * lead);
+#if AP_SCRIPTING_ENABLED
+        if ((1U<<i) & rpm_scale_mask) {
+            rpm *= rpm_scale_factor[i];
+        }
+#endif
+        freqs[valid_escs++] = rpm * (1.0f / 60.0f);
+    }
+
+    return valid_escs;
+}
+
 // get mask of ESCs that sent valid telemetry and/or rpm data in the last
 // ESC_TELEM_DATA_TIMEOUT_MS/ESC_RPM_DATA_TIMEOUT_US
 uint32_t AP_ESC_Telem::get_active_esc_mask() const {
@@ -128,7 +161,8 @@ bool AP_ESC_Telem::are_motors_running(uint32_t servo_channel_mask, float min_rpm
 
     for (uint8_t i = 0; i < ESC_TELEM_MAX_ESCS; i++) {
         if (BIT_IS_SET(servo_channel_mask, i)) {
-            const volatile AP_ESC_Telem_Backend::RpmData& rpmdata = _rpm_data[i];
+            AP_ESC_Telem_Backend::RpmData rpmdata;
+            read_rpm_data(i, rpmdata);
             // we choose a relatively strict measure of health so that failsafe actions can rely on the results
             if (now < rpmdata.last_update_us || now - rpmdata.last_update_us > ESC_RPM_CHECK_TIMEOUT_US) {
                 return false;
@@ -162,7 +196,8 @@ bool AP_ESC_Telem::get_rpm(uint8_t esc_index, float& rpm) const
         return false;
     }
 
-    const volatile AP_ESC_Telem_Backend::RpmData& rpmdata = _rpm_data[esc_index];
+    AP_ESC_Telem_Backend::RpmData rpmdata;
+    read_rpm_data(esc_index, rpmdata);
 
     if (is_zero(rpmdata.update_rate_hz)) {
         return false;
@@ -192,7 +227,8 @@ bool AP_ESC_Telem::get_raw_rpm(uint8_t esc_index, float& rpm) const
         return false;
     }
 
-    const volatile AP_ESC_Telem_Backend::RpmData& rpmdata = _rpm_data[esc_index];
+    AP_ESC_Telem_Backend::RpmData rpmdata;
+    read_rpm_data(esc_index, rpmdata);
 
     const uint32_t now = AP_HAL::micros();
 
@@ -204,6 +240,29 @@ bool AP_ESC_Telem::get_raw_rpm(uint8_t esc_index, float& rpm) const
     return true;
 }
 
+// take a copy of an ESC's rpm data that is consistent with a single update. The drivers update from
+// their own threads, so rather than taking a lock retry if an update happened during the copy. If a
+// writer has been preempted mid-update the last copy is used, which is no worse than an unprotected read
+void AP_ESC_Telem::read_rpm_data(uint8_t esc_index, AP_ESC_Telem_Backend::RpmData& rpmdata) const
+{
+    const volatile AP_ESC_Telem_Backend::RpmData& data = _rpm_data[esc_index];
+    for (uint8_t tries = 0; tries < 4; tries++) {
+        const uint32_t seq = data.seq;
+        __sync_synchronize();
+        rpmdata.rpm = data.rpm;
+        rpmdata.prev_rpm = data.prev_rpm;
+        rpmdata.error_rate = data.error_rate;
+        rpmdata.last_update_us = data.last_update_us;
+        rpmdata.update_rate_hz = data.update_rate_hz;
+        rpmdata.sample_us = data.sample_us;
+        __sync_synchronize();
+        if ((seq & 1U) == 0 && data.seq == seq) {
+            break;
+        }
+    }
+    rpmdata.seq = 0;
+}
+
 // get an individual ESC's temperature in centi-degrees if available, returns true on success
 bool AP_ESC_Telem::get_temperature(uint8_t esc_index, int16_t& temp) const
 {
@@ -462,7 +521,7 @@ void AP_ESC_Telem::update_telem_data(const uint8_t esc_index, const AP_ESC_Telem
 
 // record an update to the RPM together with timestamp, this allows the notch values to be slewed
 // this should be called by backends when new telemetry values are available
-void AP_ESC_Telem::update_rpm(const uint8_t esc_index, const float new_rpm, const float error_rate)
+void AP_ESC_Telem::update_rpm(const uint8_t esc_index, const float new_rpm, const float error_rate, const uint32_t sample_us)
 {
     if (esc_index >= ESC_TELEM_MAX_ESCS) {
         return;
@@ -474,14 +533,22 @@ void AP_ESC_Telem::update_rpm(const uint8_t esc_index, const float new_rpm, cons
     volatile AP_ESC_Telem_Backend::RpmData& rpmdata = _rpm_data[esc_index];
     const auto last_update_us = rpmdata.last_update_us;
 
+    // readers retry while the sequence count is odd or has changed
+    rpmdata.seq++;
+    __sync_synchronize();
+
     rpmdata.prev_rpm = rpmdata.rpm;
     rpmdata.rpm = new_rpm;
     if (now > last_update_us) { // cope with wrapping
         rpmdata.update_rate_hz = 1.0e6f / (now - last_update_us);
     }
     rpmdata.last_update_us = now;
+    rpmdata.sample_us = sample_us != 0 ? sample_us : now;
     rpmdata.error_rate = error_rate;
 
+    __sync_synchronize();
+    rpmdata.seq++;
+
 #ifdef ESC_TELEM_DEBUG
     hal.console->printf("RPM: rate=%.1fhz, rpm=%f)\n", rpmdata.update_rate_hz, new_rpm);
 #endif
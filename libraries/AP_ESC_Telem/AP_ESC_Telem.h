@@ -72,6 +72,10 @@ public:
     // return all of the motor frequencies in Hz for dynamic filtering
     uint8_t get_motor_frequencies_hz(uint8_t nfreqs, float* freqs) const;
 
+    // return all of the motor frequencies in Hz estimated at the current time for low latency dynamic filtering,
+    // each ESC's latest rpm is extrapolated from when it was measured rather than slewed towards
+    uint8_t get_time_aligned_motor_frequencies_hz(uint8_t nfreqs, float* freqs) const;
+
     // get the number of ESCs that sent valid telemetry data in the last ESC_TELEM_DATA_TIMEOUT_MS
     uint8_t get_num_active_escs() const;
 
@@ -96,7 +100,7 @@ public:
 
     // callback to update the rpm in the frontend, should be called by the driver when new data is available
     // can also be called from scripting
-    void update_rpm(const uint8_t esc_index, const float new_rpm, const float error_rate);
+    void update_rpm(const uint8_t esc_index, const float new_rpm, const float error_rate, const uint32_t sample_us = 0);
 
 #if AP_SCRIPTING_ENABLED
     /*
@@ -107,10 +111,13 @@ public:
 
 private:
 
+    // take a consistent copy of an ESC's rpm data without locking
+    void read_rpm_data(uint8_t esc_index, AP_ESC_Telem_Backend::RpmData& rpmdata) const;
+
     // callback to update the data in the frontend, should be called by the driver when new data is available
     void update_telem_data(const uint8_t esc_index, const AP_ESC_Telem_Backend::TelemetryData& new_data, const uint16_t data_mask);
 
-    // rpm data
+    // rpm data, written by the drivers from their own threads and protected by a sequence lock
     volatile AP_ESC_Telem_Backend::RpmData _rpm_data[ESC_TELEM_MAX_ESCS];
     // telemetry data
     volatile AP_ESC_Telem_Backend::TelemetryData _telem_data[ESC_TELEM_MAX_ESCS];
@@ -31,8 +31,8 @@ AP_ESC_Telem_Backend::AP_ESC_Telem_Backend() {
 }
 
 // callback to update the rpm in the frontend, should be called by the driver when new data is available
-void AP_ESC_Telem_Backend::update_rpm(const uint8_t esc_index, const float new_rpm, const float error_rate) {
-    _frontend->update_rpm(esc_index, new_rpm, error_rate);
+void AP_ESC_Telem_Backend::update_rpm(const uint8_t esc_index, const float new_rpm, const float error_rate, const uint32_t sample_us) {
+    _frontend->update_rpm(esc_index, new_rpm, error_rate, sample_us);
 }
 
 // callback to update the data in the frontend, should be called by the driver when new data is available
@@ -34,6 +34,8 @@ public:
         float    error_rate;        // error rate in percent
         uint32_t last_update_us;    // last update time, determines whether active
         float    update_rate_hz;
+        uint32_t sample_us;         // time the rpm was measured
+        uint32_t seq;               // sequence count, odd while an update is being written
     };
 
     enum TelemetryType {
@@ -55,7 +57,8 @@ public:
 
 protected:
     // callback to update the rpm in the frontend, should be called by the driver when new data is available
-    void update_rpm(const uint8_t esc_index, const float new_rpm, const float error_rate = 0.0f);
+    // sample_us is the time the rpm was measured if the driver knows it, otherwise the time of the call is used
+    void update_rpm(const uint8_t esc_index, const float new_rpm, const float error_rate = 0.0f, const uint32_t sample_us = 0);
 
     // callback to update the data in the frontend, should be called by the driver when new data is available
     void update_telem_data(const uint8_t esc_index, const TelemetryData& new_data, const uint16_t data_present_mask);
@@ -132,6 +132,7 @@ public:
         Vector3f accel;
         Vector3f gyro;
         float temperature;
+        uint64_t sample_us;     // when the sample arrived, zero if not known
     } ins_data_message_t;
 
 protected:
@@ -105,96 +105,91 @@ void AP_ExternalAHRS_LORD::update_thread(void)
     }
 }
 
-// Builds packets by looking at each individual byte, once a full packet has been read in it checks the checksum then handles the packet.
+// Reads what the UART has in blocks and handles each complete packet
+// where it sits in the buffer, checking the checksum in place.
 void AP_ExternalAHRS_LORD::build_packet()
 {
     WITH_SEMAPHORE(sem);
-    uint32_t nbytes = MIN(uart->available(), 2048u);
-    while (nbytes--> 0) {
-        const int16_t b = uart->read();
-
-        if (b < 0) {
-            break;
+    const uint32_t n = MIN(uart->available(), uint32_t(sizeof(rx_buf) - rx_len));
+    if (n > 0) {
+        const ssize_t nread = uart->read(&rx_buf[rx_len], n);
+        if (nread <= 0) {
+            return;
         }
+        rx_len += nread;
+    }
 
-        switch (message_in.state) {
-        case ParseState::WaitingFor_SyncOne:
-            if (b == SYNC_ONE) {
-                message_in.packet.header[0] = b;
-                message_in.state = ParseState::WaitingFor_SyncTwo;
-            }
-            break;
-        case ParseState::WaitingFor_SyncTwo:
-            if (b == SYNC_TWO) {
-                message_in.packet.header[1] = b;
-                message_in.state = ParseState::WaitingFor_Descriptor;
-            } else {
-                message_in.state = ParseState::WaitingFor_SyncOne;
-            }
-            break;
-        case ParseState::WaitingFor_Descriptor:
-            message_in.packet.header[2] = b;
-            message_in.state = ParseState::WaitingFor_PayloadLength;
+    uint16_t ofs = 0;
+    while (ofs < rx_len) {
+        const uint8_t *p = (const uint8_t *)memchr(&rx_buf[ofs], SYNC_ONE, rx_len - ofs);
+        if (p == nullptr) {
+            ofs = rx_len;
             break;
-        case ParseState::WaitingFor_PayloadLength:
-            message_in.packet.header[3] = b;
-            message_in.state = ParseState::WaitingFor_Data;
-            message_in.index = 0;
+        }
+        ofs = p - rx_buf;
+        const uint16_t avail = rx_len - ofs;
+        if (avail < 2) {
             break;
-        case ParseState::WaitingFor_Data:
-            message_in.packet.payload[message_in.index++] = b;
-            if (message_in.index >= message_in.packet.header[3]) {
-                message_in.state = ParseState::WaitingFor_Checksum;
-                message_in.index = 0;
-            }
+        }
+        if (p[1] != SYNC_TWO) {
+            ofs++;
+            continue;
+        }
+        if (avail < LORD_HEADER_LEN) {
             break;
-        case ParseState::WaitingFor_Checksum:
-            message_in.packet.checksum[message_in.index++] = b;
-            if (message_in.index >= 2) {
-                message_in.state = ParseState::WaitingFor_SyncOne;
-                message_in.index = 0;
-
-                if (valid_packet(message_in.packet)) {
-                    handle_packet(message_in.packet);
-                }
-            }
+        }
+        const uint16_t len = LORD_HEADER_LEN + p[3] + 2;
+        if (avail < len) {
+            // wait for the rest of the packet
             break;
         }
+        if (!valid_packet(p)) {
+            ofs++;
+            continue;
+        }
+        // estimate when the first byte of the packet arrived, to
+        // remove the serial transfer time from the sample time
+        handle_packet(p, uart->receive_time_constraint_us(avail));
+        ofs += len;
+    }
+
+    if (ofs > 0) {
+        memmove(&rx_buf[0], &rx_buf[ofs], rx_len - ofs);
+        rx_len -= ofs;
     }
 }
 
 // returns true if the fletcher checksum for the packet is valid, else false.
-bool AP_ExternalAHRS_LORD::valid_packet(const LORD_Packet & packet) const
+bool AP_ExternalAHRS_LORD::valid_packet(const uint8_t *packet) const
 {
     uint8_t checksum_one = 0;
     uint8_t checksum_two = 0;
 
-    for (int i = 0; i < 4; i++) {
-        checksum_one += packet.header[i];
-        checksum_two += checksum_one;
-    }
-
-    for (int i = 0; i < packet.header[3]; i++) {
-        checksum_one += packet.payload[i];
+    const uint16_t len = LORD_HEADER_LEN + packet[3];
+    for (uint16_t i = 0; i < len; i++) {
+        checksum_one += packet[i];
         checksum_two += checksum_one;
     }
 
-    return packet.checksum[0] == checksum_one && packet.checksum[1] == checksum_two;
+    return packet[len] == checksum_one && packet[len+1] == checksum_two;
 }
 
 // Calls the correct functions based on the packet descriptor of the packet
-void AP_ExternalAHRS_LORD::handle_packet(const LORD_Packet& packet)
+void AP_ExternalAHRS_LORD::handle_packet(const uint8_t *packet, uint64_t sample_us)
 {
-    switch ((DescriptorSet) packet.header[2]) {
+    const uint8_t *payload = &packet[LORD_HEADER_LEN];
+    const uint8_t length = packet[3];
+    switch ((DescriptorSet) packet[2]) {
     case DescriptorSet::IMUData:
-        handle_imu(packet);
+        imu_sample_us = sample_us;
+        handle_imu(payload, length);
         post_imu();
         break;
     case DescriptorSet::GNSSData:
-        handle_gnss(packet);
+        handle_gnss(payload, length);
         break;
     case DescriptorSet::EstimationData:
-        handle_filter(packet);
+        handle_filter(payload, length);
         post_filter();
         break;
     case DescriptorSet::BaseCommand:
@@ -205,36 +200,36 @@ void AP_ExternalAHRS_LORD::handle_packet(const LORD_Packet& packet)
 }
 
 // Collects data from an imu packet into `imu_data`
-void AP_ExternalAHRS_LORD::handle_imu(const LORD_Packet& packet)
+void AP_ExternalAHRS_LORD::handle_imu(const uint8_t *payload, uint8_t length)
 {
     last_ins_pkt = AP_HAL::millis();
 
     // Iterate through fields of varying lengths in INS packet
-    for (uint8_t i = 0; i < packet.header[3]; i +=  packet.payload[i]) {
-        switch ((INSPacketField) packet.payload[i+1]) {
+    for (uint8_t i = 0; i < length; i += payload[i]) {
+        switch ((INSPacketField) payload[i+1]) {
         // Scaled Ambient Pressure
         case INSPacketField::PRESSURE: {
-            imu_data.pressure = extract_float(packet.payload, i+2) * 100; // Convert millibar to pascals
+            imu_data.pressure = extract_float(payload, i+2) * 100; // Convert millibar to pascals
             break;
         }
         // Scaled Magnetometer Vector
         case INSPacketField::MAG: {
-            imu_data.mag = populate_vector3f(packet.payload, i+2) * 1000; // Convert gauss to milligauss
+            imu_data.mag = populate_vector3f(payload, i+2) * 1000; // Convert gauss to milligauss
             break;
         }
         // Scaled Accelerometer Vector
         case INSPacketField::ACCEL: {
-            imu_data.accel = populate_vector3f(packet.payload, i+2) * GRAVITY_MSS; // Convert g's to m/s^2
+            imu_data.accel = populate_vector3f(payload, i+2) * GRAVITY_MSS; // Convert g's to m/s^2
             break;
         }
         // Scaled Gyro Vector
         case INSPacketField::GYRO: {
-            imu_data.gyro = populate_vector3f(packet.payload, i+2);
+            imu_data.gyro = populate_vector3f(payload, i+2);
             break;
         }
         // Quaternion
         case INSPacketField::QUAT: {
-            imu_data.quat = populate_quaternion(packet.payload, i+2);
+            imu_data.quat = populate_quaternion(payload, i+2);
             break;
         }
         }
@@ -257,7 +252,8 @@ void AP_ExternalAHRS_LORD::post_imu() const
         AP_ExternalAHRS::ins_data_message_t ins {
             accel: imu_data.accel,
             gyro: imu_data.gyro,
-            temperature: -300
+            temperature: -300,
+            sample_us: imu_sample_us
         };
         AP::ins().handle_external(ins);
     }
@@ -283,22 +279,22 @@ void AP_ExternalAHRS_LORD::post_imu() const
 }
 
 // Collects data from a gnss packet into `gnss_data`
-void AP_ExternalAHRS_LORD::handle_gnss(const LORD_Packet &packet)
+void AP_ExternalAHRS_LORD::handle_gnss(const uint8_t *payload, uint8_t length)
 {
     last_gps_pkt = AP_HAL::millis();
 
     // Iterate through fields of varying lengths in GNSS packet
-    for (uint8_t i = 0; i < packet.header[3]; i += packet.payload[i]) {
-        switch ((GNSSPacketField) packet.payload[i+1]) {
+    for (uint8_t i = 0; i < length; i += payload[i]) {
+        switch ((GNSSPacketField) payload[i+1]) {
         // GPS Time
         case GNSSPacketField::GPS_TIME: {
-            gnss_data.tow_ms = double_to_uint32(extract_double(packet.payload, i+2) * 1000); // Convert seconds to ms
-            gnss_data.week = be16toh_ptr(&packet.payload[i+10]);
+            gnss_data.tow_ms = double_to_uint32(extract_double(payload, i+2) * 1000); // Convert seconds to ms
+            gnss_data.week = be16toh_ptr(&payload[i+10]);
             break;
         }
         // GNSS Fix Information
         case GNSSPacketField::FIX_INFO: {
-            switch ((GNSSFixType) packet.payload[i+2]) {
+            switch ((GNSSFixType) payload[i+2]) {
             case (GNSSFixType::FIX_3D): {
                 gnss_data.fix_type = GPS_FIX_TYPE_3D_FIX;
                 break;
@@ -319,68 +315,68 @@ void AP_ExternalAHRS_LORD::handle_gnss(const LORD_Packet &packet)
             }
             }
 
-            gnss_data.satellites = packet.payload[i+3];
+            gnss_data.satellites = payload[i+3];
             break;
         }
         // LLH Position
         case GNSSPacketField::LLH_POSITION: {
-            gnss_data.lat = extract_double(packet.payload, i+2) * 1.0e7; // Decimal degrees to degrees
-            gnss_data.lon = extract_double(packet.payload, i+10) * 1.0e7;
-            gnss_data.msl_altitude = extract_double(packet.payload, i+26) * 1.0e2; // Meters to cm
-            gnss_data.horizontal_position_accuracy = extract_float(packet.payload, i+34);
-            gnss_data.vertical_position_accuracy = extract_float(packet.payload, i+38);
+            gnss_data.lat = extract_double(payload, i+2) * 1.0e7; // Decimal degrees to degrees
+            gnss_data.lon = extract_double(payload, i+10) * 1.0e7;
+            gnss_data.msl_altitude = extract_double(payload, i+26) * 1.0e2; // Meters to cm
+            gnss_data.horizontal_position_accuracy = extract_float(payload, i+34);
+            gnss_data.vertical_position_accuracy = extract_float(payload, i+38);
             break;
         }
         // DOP Data
         case GNSSPacketField::DOP_DATA: {
-            gnss_data.hdop = extract_float(packet.payload, i+10);
-            gnss_data.vdop = extract_float(packet.payload, i+14);
+            gnss_data.hdop = extract_float(payload, i+10);
+            gnss_data.vdop = extract_float(payload, i+14);
             break;
         }
         // NED Velocity
         case GNSSPacketField::NED_VELOCITY: {
-            gnss_data.ned_velocity_north = extract_float(packet.payload, i+2);
-            gnss_data.ned_velocity_east = extract_float(packet.payload, i+6);
-            gnss_data.ned_velocity_down = extract_float(packet.payload, i+10);
-            gnss_data.speed_accuracy = extract_float(packet.payload, i+26);
+            gnss_data.ned_velocity_north = extract_float(payload, i+2);
+            gnss_data.ned_velocity_east = extract_float(payload, i+6);
+            gnss_data.ned_velocity_down = extract_float(payload, i+10);
+            gnss_data.speed_accuracy = extract_float(payload, i+26);
             break;
         }
         }
     }
 }
 
-void AP_ExternalAHRS_LORD::handle_filter(const LORD_Packet &packet)
+void AP_ExternalAHRS_LORD::handle_filter(const uint8_t *payload, uint8_t length)
 {
     last_filter_pkt = AP_HAL::millis();
 
     // Iterate through fields of varying lengths in filter packet
-    for (uint8_t i = 0; i < packet.header[3]; i += packet.payload[i]) {
-        switch ((FilterPacketField) packet.payload[i+1]) {
+    for (uint8_t i = 0; i < length; i += payload[i]) {
+        switch ((FilterPacketField) payload[i+1]) {
         // GPS Timestamp
         case FilterPacketField::GPS_TIME: {
-            filter_data.tow_ms = extract_double(packet.payload, i+2) * 1000; // Convert seconds to ms
-            filter_data.week = be16toh_ptr(&packet.payload[i+10]);
+            filter_data.tow_ms = extract_double(payload, i+2) * 1000; // Convert seconds to ms
+            filter_data.week = be16toh_ptr(&payload[i+10]);
             break;
         }
         // LLH Position
         case FilterPacketField::LLH_POSITION: {
-            filter_data.lat = extract_double(packet.payload, i+2) * 1.0e7; // Decimal degrees to degrees
-            filter_data.lon = extract_double(packet.payload, i+10) * 1.0e7;
-            filter_data.hae_altitude = extract_double(packet.payload, i+26) * 1.0e2; // Meters to cm
+            filter_data.lat = extract_double(payload, i+2) * 1.0e7; // Decimal degrees to degrees
+            filter_data.lon = extract_double(payload, i+10) * 1.0e7;
+            filter_data.hae_altitude = extract_double(payload, i+26) * 1.0e2; // Meters to cm
             break;
         }
         // NED Velocity
         case FilterPacketField::NED_VELOCITY: {
-            filter_data.ned_velocity_north = extract_float(packet.payload, i+2);
-            filter_data.ned_velocity_east = extract_float(packet.payload, i+6);
-            filter_data.ned_velocity_down = extract_float(packet.payload, i+10);
+            filter_data.ned_velocity_north = extract_float(payload, i+2);
+            filter_data.ned_velocity_east = extract_float(payload, i+6);
+            filter_data.ned_velocity_down = extract_float(payload, i+10);
             break;
         }
         // Filter Status
         case FilterPacketField::FILTER_STATUS: {
-            filter_status.state = be16toh_ptr(&packet.payload[i+2]);
-            filter_status.mode = be16toh_ptr(&packet.payload[i+4]);
-            filter_status.flags = be16toh_ptr(&packet.payload[i+6]);
+            filter_status.state = be16toh_ptr(&payload[i+2]);
+            filter_status.mode = be16toh_ptr(&payload[i+4]);
+            filter_status.flags = be16toh_ptr(&payload[i+6]);
             break;
         }
         }
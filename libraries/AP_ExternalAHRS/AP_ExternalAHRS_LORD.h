@@ -52,15 +52,6 @@ public:
 
 private:
 
-    enum class ParseState {
-        WaitingFor_SyncOne,
-        WaitingFor_SyncTwo,
-        WaitingFor_Descriptor,
-        WaitingFor_PayloadLength,
-        WaitingFor_Data,
-        WaitingFor_Checksum
-    };
-
     void update_thread();
 
     AP_HAL::UARTDriver *uart;
@@ -77,18 +68,17 @@ private:
     uint32_t last_gps_pkt;
     uint32_t last_filter_pkt;
 
-    // A LORD packet can be a maximum of 261 bytes
-    struct LORD_Packet {
-        uint8_t header[4];
-        uint8_t payload[255];
-        uint8_t checksum[2];
-    };
+    // A LORD packet is a 4 byte header, up to 255 bytes of payload
+    // and a 2 byte checksum
+    static const uint16_t LORD_HEADER_LEN = 4;
+    static const uint16_t LORD_MAX_PACKET_LEN = LORD_HEADER_LEN + 255 + 2;
 
-    struct {
-        LORD_Packet packet;
-        ParseState state;
-        uint8_t index;
-    } message_in;
+    // bytes read from the UART, parsed in place
+    uint8_t rx_buf[2*LORD_MAX_PACKET_LEN];
+    uint16_t rx_len;
+
+    // arrival time of the IMU packet being handled
+    uint64_t imu_sample_us;
 
     struct {
         Vector3f accel;
@@ -137,11 +127,11 @@ private:
     } filter_data;
 
     void build_packet();
-    bool valid_packet(const LORD_Packet &packet) const;
-    void handle_packet(const LORD_Packet &packet);
-    void handle_imu(const LORD_Packet &packet);
-    void handle_gnss(const LORD_Packet &packet);
-    void handle_filter(const LORD_Packet &packet);
+    bool valid_packet(const uint8_t *packet) const;
+    void handle_packet(const uint8_t *packet, uint64_t sample_us);
+    void handle_imu(const uint8_t *payload, uint8_t length);
+    void handle_gnss(const uint8_t *payload, uint8_t length);
+    void handle_filter(const uint8_t *payload, uint8_t length);
     void post_imu() const;
     void post_gnss() const;
     void post_filter() const;
@@ -194,6 +194,20 @@ AP_ExternalAHRS_VectorNav::AP_ExternalAHRS_VectorNav(AP_ExternalAHRS *_frontend,
     GCS_SEND_TEXT(MAV_SEVERITY_INFO, "ExternalAHRS initialised");
 }
 
+/*
+  match the start of a buffer against a packet header, returning the
+  packet length if it matches, zero if it doesn't and -1 if more bytes
+  are needed to tell
+ */
+static int16_t match_header(const uint8_t *b, uint16_t len, const uint8_t *header, uint8_t header_len, uint16_t pkt_length)
+{
+    const uint16_t n = MIN(uint16_t(header_len), uint16_t(len-1));
+    if (memcmp(&b[1], header, n) != 0) {
+        return 0;
+    }
+    return n == header_len ? pkt_length : -1;
+}
+
 /*
   check the UART for more data
   returns true if the function should be called again straight away
@@ -217,65 +231,63 @@ bool AP_ExternalAHRS_VectorNav::check_uart()
         pktoffset += nread;
     }
 
-    bool match_header1 = false;
-    bool match_header2 = false;
-    bool match_header3 = false;
-
-    if (pktbuf[0] != SYNC_BYTE) {
-        goto reset;
-    }
-
-    if (type == TYPE::VN_300) {
-        match_header1 = (0 == memcmp(&pktbuf[1], vn_pkt1_header, MIN(sizeof(vn_pkt1_header), unsigned(pktoffset-1))));
-        match_header2 = (0 == memcmp(&pktbuf[1], vn_pkt2_header, MIN(sizeof(vn_pkt2_header), unsigned(pktoffset-1))));
-    } else {
-        match_header3 = (0 == memcmp(&pktbuf[1], vn_100_pkt1_header, MIN(sizeof(vn_100_pkt1_header), unsigned(pktoffset-1))));
-    }
-    if (!match_header1 && !match_header2 && !match_header3) {
-        goto reset;
-    }
+    /*
+      parse all complete packets in place, checking the CRC over the
+      packet as it sits in the buffer, then move any partial packet
+      left over to the start of the buffer once
+     */
+    uint16_t ofs = 0;
+    while (ofs < pktoffset) {
+        const uint8_t *p = (const uint8_t *)memchr(&pktbuf[ofs], SYNC_BYTE, pktoffset-ofs);
+        if (p == nullptr) {
+            ofs = pktoffset;
+            break;
+        }
+        ofs = p - pktbuf;
+        const uint16_t avail = pktoffset - ofs;
+        if (avail < 2) {
+            break;
+        }
 
-    if (match_header1 && pktoffset >= VN_PKT1_LENGTH) {
-        uint16_t crc = crc16_ccitt(&pktbuf[1], VN_PKT1_LENGTH-1, 0);
-        if (crc == 0) {
-            // got pkt1
-            process_packet1(&pktbuf[sizeof(vn_pkt1_header)+1]);
-            memmove(&pktbuf[0], &pktbuf[VN_PKT1_LENGTH], pktoffset-VN_PKT1_LENGTH);
-            pktoffset -= VN_PKT1_LENGTH;
+        int16_t len1 = 0, len2 = 0, len3 = 0;
+        if (type == TYPE::VN_300) {
+            len1 = match_header(p, avail, vn_pkt1_header, sizeof(vn_pkt1_header), VN_PKT1_LENGTH);
+            len2 = match_header(p, avail, vn_pkt2_header, sizeof(vn_pkt2_header), VN_PKT2_LENGTH);
         } else {
-            goto reset;
+            len3 = match_header(p, avail, vn_100_pkt1_header, sizeof(vn_100_pkt1_header), VN_100_PKT1_LENGTH);
         }
-    } else if (match_header2 && pktoffset >= VN_PKT2_LENGTH) {
-        uint16_t crc = crc16_ccitt(&pktbuf[1], VN_PKT2_LENGTH-1, 0);
-        if (crc == 0) {
-            // got pkt2
-            process_packet2(&pktbuf[sizeof(vn_pkt2_header)+1]);
-            memmove(&pktbuf[0], &pktbuf[VN_PKT2_LENGTH], pktoffset-VN_PKT2_LENGTH);
-            pktoffset -= VN_PKT2_LENGTH;
-        } else {
-            goto reset;
+        if (len1 == 0 && len2 == 0 && len3 == 0) {
+            // not a packet we know, look for the next sync byte
+            ofs++;
+            continue;
+        }
+        const int16_t len = len1 != 0 ? len1 : (len2 != 0 ? len2 : len3);
+        if (len < 0 || avail < uint16_t(len)) {
+            // wait for the rest of the packet
+            break;
+        }
+        if (crc16_ccitt(&p[1], len-1, 0) != 0) {
+            ofs++;
+            continue;
         }
-    } else if (match_header3 && pktoffset >= VN_100_PKT1_LENGTH) {
-        uint16_t crc = crc16_ccitt(&pktbuf[1], VN_100_PKT1_LENGTH-1, 0);
-        if (crc == 0) {
-            // got VN-100 pkt1
-            process_packet_VN_100(&pktbuf[sizeof(vn_100_pkt1_header)+1]);
-            memmove(&pktbuf[0], &pktbuf[VN_100_PKT1_LENGTH], pktoffset-VN_100_PKT1_LENGTH);
-            pktoffset -= VN_100_PKT1_LENGTH;
+
+        // estimate when the first byte of the packet arrived, to
+        // remove the serial transfer time from the sample time
+        const uint64_t sample_us = uart->receive_time_constraint_us(avail);
+
+        if (len1 > 0) {
+            process_packet1(&p[sizeof(vn_pkt1_header)+1], sample_us);
+        } else if (len2 > 0) {
+            process_packet2(&p[sizeof(vn_pkt2_header)+1]);
         } else {
-            goto reset;
+            process_packet_VN_100(&p[sizeof(vn_100_pkt1_header)+1], sample_us);
         }
+        ofs += len;
     }
-    return true;
 
-reset:
-    uint8_t *p = (uint8_t *)memchr(&pktbuf[1], SYNC_BYTE, pktoffset-1);
-    if (p) {
-        uint8_t newlen = pktoffset - (p - pktbuf);
-        memmove(&pktbuf[0], p, newlen);
-        pktoffset = newlen;
-    } else {
-        pktoffset = 0;
+    if (ofs > 0) {
+        memmove(&pktbuf[0], &pktbuf[ofs], pktoffset-ofs);
+        pktoffset -= ofs;
     }
     return true;
 }
@@ -442,7 +454,7 @@ const char* AP_ExternalAHRS_VectorNav::get_name() const
 /*
   process packet type 1
  */
-void AP_ExternalAHRS_VectorNav::process_packet1(const uint8_t *b)
+void AP_ExternalAHRS_VectorNav::process_packet1(const uint8_t *b, uint64_t sample_us)
 {
     const struct VN_packet1 &pkt1 = *(struct VN_packet1 *)b;
     const struct VN_packet2 &pkt2 = *last_pkt2;
@@ -500,6 +512,7 @@ void AP_ExternalAHRS_VectorNav::process_packet1(const uint8_t *b)
         ins.accel = state.accel;
         ins.gyro = state.gyro;
         ins.temperature = pkt2.temp;
+        ins.sample_us = sample_us;
 
         AP::ins().handle_external(ins);
     }
@@ -584,7 +597,7 @@ void AP_ExternalAHRS_VectorNav::process_packet2(const uint8_t *b)
 /*
   process VN-100 packet type 1
  */
-void AP_ExternalAHRS_VectorNav::process_packet_VN_100(const uint8_t *b)
+void AP_ExternalAHRS_VectorNav::process_packet_VN_100(const uint8_t *b, uint64_t sample_us)
 {
     const struct VN_100_packet1 &pkt = *(struct VN_100_packet1 *)b;
 
@@ -635,6 +648,7 @@ void AP_ExternalAHRS_VectorNav::process_packet_VN_100(const uint8_t *b)
         ins.accel = state.accel;
         ins.gyro = state.gyro;
         ins.temperature = pkt.temp;
+        ins.sample_us = sample_us;
 
         AP::ins().handle_external(ins);
     }
@@ -54,9 +54,9 @@ private:
     void update_thread();
     bool check_uart();
 
-    void process_packet1(const uint8_t *b);
+    void process_packet1(const uint8_t *b, uint64_t sample_us);
     void process_packet2(const uint8_t *b);
-    void process_packet_VN_100(const uint8_t *b);
+    void process_packet_VN_100(const uint8_t *b, uint64_t sample_us);
     void wait_register_responce(const uint8_t register_num);
 
     uint8_t *pktbuf;
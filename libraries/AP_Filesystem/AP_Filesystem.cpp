@@ -152,12 +152,24 @@ int32_t AP_Filesystem::write(int fd, const void *buf, uint32_t count)
     return backend.fs.write(fd, buf, count);
 }
 
+int32_t AP_Filesystem::writev(int fd, const ByteBuffer::IoVec *iov, uint8_t iovcnt)
+{
+    const Backend &backend = backend_by_fd(fd);
+    return backend.fs.writev(fd, iov, iovcnt);
+}
+
 int AP_Filesystem::fsync(int fd)
 {
     const Backend &backend = backend_by_fd(fd);
     return backend.fs.fsync(fd);
 }
 
+bool AP_Filesystem::preallocate(int fd, uint32_t size)
+{
+    const Backend &backend = backend_by_fd(fd);
+    return backend.fs.preallocate(fd, size);
+}
+
 int32_t AP_Filesystem::lseek(int fd, int32_t offset, int seek_from)
 {
     const Backend &backend = backend_by_fd(fd);
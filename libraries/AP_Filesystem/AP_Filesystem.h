@@ -88,7 +88,11 @@ public:
     int close(int fd);
     int32_t read(int fd, void *buf, uint32_t count);
     int32_t write(int fd, const void *buf, uint32_t count);
+    int32_t writev(int fd, const ByteBuffer::IoVec *iov, uint8_t iovcnt);
     int fsync(int fd);
+    // place a new, empty file in a contiguous free area of at least
+    // size bytes, so it grows without searching for free space
+    bool preallocate(int fd, uint32_t size);
     int32_t lseek(int fd, int32_t offset, int whence);
     int stat(const char *pathname, struct stat *stbuf);
     int unlink(const char *pathname);
@@ -36,14 +36,52 @@ static bool remount_needed;
 // mkdir() inside sdcard_retry()
 static HAL_Semaphore sem;
 
+// protects changes to file_table and the read cache. It is never held
+// across a FATFS call, so reads served from the cache and seeks don't
+// wait for IO on other files, such as a log write. When both are
+// needed sem is taken first
+static HAL_Semaphore stream_sem;
+
 typedef struct {
     FIL *fh;
     char *name;
+    // file position. This can differ from fh->fptr, which is moved
+    // to it before FATFS reads and writes
+    FSIZE_t pos;
+    // end of the last read, to spot sequential reads
+    FSIZE_t read_end;
 } FAT_FILE;
 
 #define MAX_FILES 16
 static FAT_FILE *file_table[MAX_FILES];
 
+#if AP_FILESYSTEM_FATFS_CACHE_BLOCKS > 0
+/*
+  the read cache holds blocks of file data, shared between the open
+  files and replaced least recently used first. Blocks are filled
+  with sem held, and looked up with only stream_sem held
+ */
+struct cache_block {
+    FAT_FILE *stream;       // file the data is from, nullptr if unused
+    FSIZE_t offset;         // file offset of the data
+    uint16_t len;           // bytes of data, short at end of file
+    uint32_t last_use;
+    uint8_t *data;
+};
+static struct cache_block cache_blocks[AP_FILESYSTEM_FATFS_CACHE_BLOCKS];
+static uint8_t *cache_mem;
+static uint32_t cache_use_count;
+
+// read ahead requests, serviced by the IO thread
+#define PREFETCH_QUEUE_LEN 4
+struct prefetch_request {
+    FAT_FILE *stream;
+    FSIZE_t offset;
+};
+static struct prefetch_request prefetch_queue[PREFETCH_QUEUE_LEN];
+static uint8_t prefetch_count;
+#endif
+
 static int isatty_(int fileno)
 {
     if (fileno >= 0 && fileno <= 2) {
@@ -86,9 +124,10 @@ static int new_file_descriptor(const char *pathname)
             }
             strcpy(fname, pathname);
             stream->name = fname;
+            stream->fh = fh;
 
+            WITH_SEMAPHORE(stream_sem);
             file_table[i]  = stream;
-            stream->fh = fh;
             return i;
         }
     }
@@ -112,6 +151,181 @@ static FAT_FILE *fileno_to_stream(int fileno)
     return stream;
 }
 
+static int fatfs_to_errno(FRESULT Result);
+
+#if AP_FILESYSTEM_FATFS_CACHE_BLOCKS > 0
+/*
+  find the cache block holding a file offset. Called with stream_sem held
+ */
+static struct cache_block *cache_find(const FAT_FILE *stream, FSIZE_t offset)
+{
+    for (uint8_t i=0; i<AP_FILESYSTEM_FATFS_CACHE_BLOCKS; i++) {
+        struct cache_block &b = cache_blocks[i];
+        if (b.stream == stream && offset >= b.offset && offset < b.offset + b.len) {
+            b.last_use = ++cache_use_count;
+            return &b;
+        }
+    }
+    return nullptr;
+}
+
+/*
+  copy as much of a read as the cache holds, advancing the file
+  position. Called with stream_sem held
+ */
+static UINT cache_read(FAT_FILE *stream, uint8_t *buf, UINT count)
+{
+    UINT total = 0;
+    while (count > 0) {
+        const struct cache_block *b = cache_find(stream, stream->pos);
+        if (b == nullptr) {
+            break;
+        }
+        const UINT ofs = stream->pos - b->offset;
+        const UINT n = MIN(count, b->len - ofs);
+        memcpy(buf, &b->data[ofs], n);
+        buf += n;
+        count -= n;
+        total += n;
+        stream->pos += n;
+    }
+    return total;
+}
+
+/*
+  queue a read ahead of a sequential reader that is past the middle of
+  its last cached block. Called with stream_sem held
+ */
+static void cache_read_ahead(FAT_FILE *stream, FSIZE_t read_start)
+{
+    const bool sequential = read_start == stream->read_end;
+    stream->read_end = stream->pos;
+    if (!sequential) {
+        return;
+    }
+    FSIZE_t next = stream->pos;
+    const struct cache_block *b = cache_find(stream, next);
+    if (b != nullptr) {
+        if (b->len < AP_FILESYSTEM_FATFS_CACHE_BLOCK_SIZE ||
+            next - b->offset < AP_FILESYSTEM_FATFS_CACHE_BLOCK_SIZE/2) {
+            // at end of file, or not far enough into the block yet
+            return;
+        }
+        next = b->offset + b->len;
+        if (cache_find(stream, next) != nullptr) {
+            return;
+        }
+    } else if (next >= f_size(stream->fh)) {
+        return;
+    }
+    for (uint8_t i=0; i<prefetch_count; i++) {
+        if (prefetch_queue[i].stream == stream && prefetch_queue[i].offset == next) {
+            return;
+        }
+    }
+    if (prefetch_count < PREFETCH_QUEUE_LEN) {
+        prefetch_queue[prefetch_count++] = { stream, next };
+    }
+}
+
+/*
+  fill a cache block with file data from offset. Called with sem
+  held, taking stream_sem only around cache updates so that cache
+  hits carry on during the read. Returns false on a read error, with
+  errno set
+ */
+static bool cache_fill(FAT_FILE *stream, FSIZE_t offset)
+{
+    struct cache_block *b;
+    {
+        WITH_SEMAPHORE(stream_sem);
+        if (cache_mem == nullptr) {
+            cache_mem = (uint8_t *)malloc(AP_FILESYSTEM_FATFS_CACHE_BLOCKS*AP_FILESYSTEM_FATFS_CACHE_BLOCK_SIZE);
+            if (cache_mem == nullptr) {
+                errno = ENOMEM;
+                return false;
+            }
+            for (uint8_t i=0; i<AP_FILESYSTEM_FATFS_CACHE_BLOCKS; i++) {
+                cache_blocks[i].data = &cache_mem[i*AP_FILESYSTEM_FATFS_CACHE_BLOCK_SIZE];
+            }
+        }
+        b = &cache_blocks[0];
+        for (uint8_t i=1; i<AP_FILESYSTEM_FATFS_CACHE_BLOCKS; i++) {
+            if (cache_blocks[i].last_use < b->last_use) {
+                b = &cache_blocks[i];
+            }
+        }
+        // unused while we fill it
+        b->stream = nullptr;
+    }
+
+    FIL *fh = stream->fh;
+    UINT size = 0;
+    FRESULT res = FR_OK;
+    if (fh->fptr != offset) {
+        res = f_lseek(fh, offset);
+    }
+    if (res == FR_OK) {
+        res = f_read(fh, b->data, AP_FILESYSTEM_FATFS_CACHE_BLOCK_SIZE, &size);
+    }
+    if (res != FR_OK) {
+        errno = fatfs_to_errno(res);
+        return false;
+    }
+    if (size == 0 || size > AP_FILESYSTEM_FATFS_CACHE_BLOCK_SIZE) {
+        // end of file
+        return true;
+    }
+
+    WITH_SEMAPHORE(stream_sem);
+    b->stream = stream;
+    b->offset = offset;
+    b->len = size;
+    b->last_use = ++cache_use_count;
+    return true;
+}
+#endif // AP_FILESYSTEM_FATFS_CACHE_BLOCKS
+
+/*
+  forget cached data of a file, or of all files if stream is
+  nullptr. Called with stream_sem held
+ */
+static void cache_invalidate(const FAT_FILE *stream)
+{
+#if AP_FILESYSTEM_FATFS_CACHE_BLOCKS > 0
+    for (uint8_t i=0; i<AP_FILESYSTEM_FATFS_CACHE_BLOCKS; i++) {
+        if (stream == nullptr || cache_blocks[i].stream == stream) {
+            cache_blocks[i].stream = nullptr;
+        }
+    }
+    uint8_t n = 0;
+    for (uint8_t i=0; i<prefetch_count; i++) {
+        if (stream != nullptr && prefetch_queue[i].stream != stream) {
+            prefetch_queue[n++] = prefetch_queue[i];
+        }
+    }
+    prefetch_count = n;
+#endif
+}
+
+/*
+  forget cached data overlapping a write, in any open file of the same
+  name. Called with stream_sem held
+ */
+static void cache_invalidate_range(const FAT_FILE *stream, FSIZE_t offset, UINT len)
+{
+#if AP_FILESYSTEM_FATFS_CACHE_BLOCKS > 0
+    for (uint8_t i=0; i<AP_FILESYSTEM_FATFS_CACHE_BLOCKS; i++) {
+        struct cache_block &b = cache_blocks[i];
+        if (b.stream != nullptr &&
+            (b.stream == stream || strcmp(b.stream->name, stream->name) == 0) &&
+            offset < b.offset + b.len && b.offset < offset + len) {
+            b.stream = nullptr;
+        }
+    }
+#endif
+}
+
 static int free_file_descriptor(int fileno)
 {
     FAT_FILE *stream;
@@ -128,6 +342,12 @@ static int free_file_descriptor(int fileno)
         return -1;
     }
 
+    {
+        WITH_SEMAPHORE(stream_sem);
+        cache_invalidate(stream);
+        file_table[fileno]  = NULL;
+    }
+
     fh = stream->fh;
 
     if (fh != NULL) {
@@ -137,7 +357,6 @@ static int free_file_descriptor(int fileno)
     free(stream->name);
     stream->name = NULL;
 
-    file_table[fileno]  = NULL;
     free(stream);
     return fileno;
 }
@@ -255,6 +474,10 @@ static bool remount_file_system(void)
         return false;
     }
     remount_needed = false;
+    {
+        WITH_SEMAPHORE(stream_sem);
+        cache_invalidate(nullptr);
+    }
     for (uint16_t i=0; i<MAX_FILES; i++) {
         FAT_FILE *f = file_table[i];
         if (!f) {
@@ -349,7 +572,15 @@ int AP_Filesystem_FATFS::open(const char *pathname, int flags, bool allow_absolu
             free_file_descriptor(fileno);
             return -1;
         }
+        stream->pos = fh->fptr;
+    }
+
+#if AP_FILESYSTEM_FATFS_CACHE_BLOCKS > 0
+    if (!prefetch_registered) {
+        hal.scheduler->register_io_process(FUNCTOR_BIND_MEMBER(&AP_Filesystem_FATFS::prefetch_handler, void));
+        prefetch_registered = true;
     }
+#endif
 
     debug("Open %s -> %d", pathname, fileno);
 
@@ -392,16 +623,37 @@ int32_t AP_Filesystem_FATFS::read(int fd, void *buf, uint32_t count)
     UINT bytes = count;
     int res;
     FIL *fh;
+    UINT total = 0;
 
     FS_CHECK_ALLOWED(-1);
-    WITH_SEMAPHORE(sem);
-
-    CHECK_REMOUNT();
 
     if (count > 0) {
         *(char *) buf = 0;
     }
 
+#if AP_FILESYSTEM_FATFS_CACHE_BLOCKS > 0
+    {
+        // take what we can from the cache without waiting for IO on
+        // other files
+        WITH_SEMAPHORE(stream_sem);
+        FAT_FILE *stream = fileno_to_stream(fd);
+        if (stream != nullptr && !isatty_(fd)) {
+            const FSIZE_t start = stream->pos;
+            total = cache_read(stream, (uint8_t *)buf, bytes);
+            if (total == count) {
+                cache_read_ahead(stream, start);
+                return (ssize_t)total;
+            }
+            buf = (void *)(((uint8_t *)buf)+total);
+            bytes -= total;
+        }
+    }
+#endif
+
+    WITH_SEMAPHORE(sem);
+
+    CHECK_REMOUNT();
+
     errno = 0;
 
     // fileno_to_fatfs checks for fd out of bounds
@@ -410,12 +662,36 @@ int32_t AP_Filesystem_FATFS::read(int fd, void *buf, uint32_t count)
         errno = EBADF;
         return -1;
     }
+    FAT_FILE *stream = file_table[fd];
+
+#if AP_FILESYSTEM_FATFS_CACHE_BLOCKS > 0
+    if (bytes <= AP_FILESYSTEM_FATFS_CACHE_BLOCK_SIZE) {
+        // small reads go through the cache, so the following reads
+        // of the block are hits
+        const FSIZE_t start = stream->pos - total;
+        if (!cache_fill(stream, stream->pos)) {
+            return -1;
+        }
+        WITH_SEMAPHORE(stream_sem);
+        total += cache_read(stream, (uint8_t *)buf, bytes);
+        cache_read_ahead(stream, start);
+        return (ssize_t)total;
+    }
+#endif
+
+    if (fh->fptr != stream->pos) {
+        res = f_lseek(fh, stream->pos);
+        if (res != FR_OK) {
+            errno = fatfs_to_errno((FRESULT)res);
+            return -1;
+        }
+    }
 
-    UINT total = 0;
     do {
         UINT size = 0;
         UINT n = MIN(bytes, MAX_IO_SIZE);
         res = f_read(fh, (void *)buf, n, &size);
+        stream->pos = fh->fptr;
         if (res != FR_OK) {
             errno = fatfs_to_errno((FRESULT)res);
             return -1;
@@ -434,6 +710,7 @@ int32_t AP_Filesystem_FATFS::read(int fd, void *buf, uint32_t count)
             break;
         }
     } while (bytes > 0);
+    stream->read_end = stream->pos;
     return (ssize_t)total;
 }
 
@@ -455,6 +732,19 @@ int32_t AP_Filesystem_FATFS::write(int fd, const void *buf, uint32_t count)
         errno = EBADF;
         return -1;
     }
+    FAT_FILE *stream = file_table[fd];
+
+    if (fh->fptr != stream->pos) {
+        res = f_lseek(fh, stream->pos);
+        if (res != FR_OK) {
+            errno = fatfs_to_errno(res);
+            return -1;
+        }
+    }
+    {
+        WITH_SEMAPHORE(stream_sem);
+        cache_invalidate_range(stream, stream->pos, count);
+    }
 
     UINT total = 0;
     do {
@@ -468,6 +758,7 @@ int32_t AP_Filesystem_FATFS::write(int fd, const void *buf, uint32_t count)
                 res = f_write(fh, buf, n, &size);
             }
         }
+        stream->pos = fh->fptr;
         if (size > n || size == 0) {
             errno = EIO;
             return -1;
@@ -516,14 +807,51 @@ int AP_Filesystem_FATFS::fsync(int fileno)
     return 0;
 }
 
+/*
+  find a contiguous free area for a new file and make it the start of
+  the file's cluster allocation. The clusters are allocated as the file
+  is written rather than up front, so after a power loss the file
+  holds no stale data from the area past what was written
+ */
+bool AP_Filesystem_FATFS::preallocate(int fileno, uint32_t size)
+{
+#if FF_USE_EXPAND
+    FS_CHECK_ALLOWED(false);
+    WITH_SEMAPHORE(sem);
+
+    if (remount_needed) {
+        return false;
+    }
+
+    // fileno_to_fatfs checks for fileno out of bounds
+    FIL *fh = fileno_to_fatfs(fileno);
+    if (fh == nullptr) {
+        return false;
+    }
+    const FRESULT res = f_expand(fh, size, 0);
+    if (res != FR_OK) {
+        // not enough contiguous space, the file is allocated as usual
+        errno = fatfs_to_errno(res);
+        return false;
+    }
+    return true;
+#else
+    return false;
+#endif
+}
+
+/*
+  the new position is applied by the next read or write, so a seek
+  doesn't wait for IO on other files. Seeking past the end of a file
+  opened for writing extends it at the next write
+ */
 off_t AP_Filesystem_FATFS::lseek(int fileno, off_t position, int whence)
 {
-    FRESULT res;
     FIL *fh;
     errno = 0;
 
     FS_CHECK_ALLOWED(-1);
-    WITH_SEMAPHORE(sem);
+    WITH_SEMAPHORE(stream_sem);
 
     // fileno_to_fatfs checks for fd out of bounds
     fh = fileno_to_fatfs(fileno);
@@ -534,19 +862,24 @@ off_t AP_Filesystem_FATFS::lseek(int fileno, off_t position, int whence)
     if (isatty_(fileno)) {
         return -1;
     }
+    FAT_FILE *stream = file_table[fileno];
 
     if (whence == SEEK_END) {
         position += f_size(fh);
     } else if (whence==SEEK_CUR) {
-        position += fh->fptr;
+        position += stream->pos;
     }
 
-    res = f_lseek(fh, position);
-    if (res) {
-        errno = fatfs_to_errno(res);
+    if (position < 0) {
+        errno = EINVAL;
         return -1;
     }
-    return fh->fptr;
+    if (!(fh->flag & FA_WRITE) && FSIZE_t(position) > f_size(fh)) {
+        // as f_lseek(), a read only file can't be extended
+        position = f_size(fh);
+    }
+    stream->pos = position;
+    return position;
 }
 
 static time_t fat_time_to_unix(uint16_t date, uint16_t time)
@@ -894,11 +1227,59 @@ void AP_Filesystem_FATFS::format_handler(void)
     } else {
         GCS_SEND_TEXT(MAV_SEVERITY_NOTICE, "Format: Failed (%d)", int(ret));
     }
+    {
+        WITH_SEMAPHORE(stream_sem);
+        cache_invalidate(nullptr);
+    }
     sdcard_stop();
     sdcard_retry();
 #endif
 }
 
+/*
+  read ahead for sequential readers, so their next read is a cache hit
+*/
+void AP_Filesystem_FATFS::prefetch_handler(void)
+{
+#if AP_FILESYSTEM_FATFS_CACHE_BLOCKS > 0
+    FAT_FILE *stream;
+    FSIZE_t offset;
+    {
+        WITH_SEMAPHORE(stream_sem);
+        if (prefetch_count == 0) {
+            return;
+        }
+        stream = prefetch_queue[0].stream;
+        offset = prefetch_queue[0].offset;
+        prefetch_count--;
+        memmove(&prefetch_queue[0], &prefetch_queue[1], prefetch_count*sizeof(prefetch_queue[0]));
+    }
+
+    WITH_SEMAPHORE(sem);
+    if (remount_needed) {
+        return;
+    }
+    // the file may have been closed since the request
+    bool is_open = false;
+    for (uint8_t i=0; i<MAX_FILES; i++) {
+        if (file_table[i] == stream) {
+            is_open = true;
+            break;
+        }
+    }
+    if (!is_open) {
+        return;
+    }
+    {
+        WITH_SEMAPHORE(stream_sem);
+        if (cache_find(stream, offset) != nullptr) {
+            return;
+        }
+    }
+    cache_fill(stream, offset);
+#endif
+}
+
 /*
   convert POSIX errno to text with user message.
 */
@@ -25,6 +25,7 @@ public:
     int32_t read(int fd, void *buf, uint32_t count) override;
     int32_t write(int fd, const void *buf, uint32_t count) override;
     int fsync(int fd) override;
+    bool preallocate(int fd, uint32_t size) override;
     int32_t lseek(int fd, int32_t offset, int whence) override;
     int stat(const char *pathname, struct stat *stbuf) override;
     int unlink(const char *pathname) override;
@@ -54,4 +55,8 @@ public:
 private:
     void format_handler(void);
     bool format_pending;
+
+    // fill the read cache ahead of sequential readers, in the IO thread
+    void prefetch_handler(void);
+    bool prefetch_registered;
 };
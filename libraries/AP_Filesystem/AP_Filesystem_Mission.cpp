@@ -49,8 +49,10 @@ int AP_Filesystem_Mission::open(const char *fname, int flags, bool allow_absolut
             file[idx].open = false;
             delete file[idx].writebuf;
             file[idx].writebuf = nullptr;
+            delete file[idx].stream;
+            file[idx].stream = nullptr;
         }
-        if (!readonly && file[idx].writebuf != nullptr) {
+        if (!readonly && (file[idx].writebuf != nullptr || file[idx].stream != nullptr)) {
             // only one upload at a time
             return -1;
         }
@@ -67,11 +69,22 @@ int AP_Filesystem_Mission::open(const char *fname, int flags, bool allow_absolut
     r.open = true;
     r.mtype = mtype;
     r.num_items = get_num_items(r.mtype);
+    r.writebuf = nullptr;
+    r.stream = nullptr;
     if (!readonly) {
-        // setup for upload
-        r.writebuf = new ExpandingString();
-    } else {
-        r.writebuf = nullptr;
+        // setup for upload. A mission stored on the SD card can be
+        // larger than we can buffer, so it is streamed
+        const auto *mission = AP::mission();
+        if (mtype == MAV_MISSION_TYPE_MISSION && mission != nullptr && mission->uses_file_storage()) {
+            r.stream = new upload_stream();
+        } else {
+            r.writebuf = new ExpandingString();
+        }
+        if (r.stream == nullptr && r.writebuf == nullptr) {
+            r.open = false;
+            errno = ENOMEM;
+            return -1;
+        }
     }
     r.last_op_ms = now;
 
@@ -95,6 +108,16 @@ int AP_Filesystem_Mission::close(int fd)
             return -1;
         }
     }
+    if (r.stream != nullptr) {
+        const upload_stream &st = *r.stream;
+        const bool ok = st.have_header && !st.failed && st.buf_len == 0 && st.num_items == st.hdr.num_items;
+        delete r.stream;
+        r.stream = nullptr;
+        if (!ok) {
+            errno = EINVAL;
+            return -1;
+        }
+    }
     return 0;
 }
 
@@ -120,7 +143,7 @@ int32_t AP_Filesystem_Mission::read(int fd, void *buf, uint32_t count)
 
     struct rfile &r = file[fd];
 
-    if (r.writebuf != nullptr) {
+    if (r.writebuf != nullptr || r.stream != nullptr) {
         errno = EBADF;
         return -1;
     }
@@ -307,11 +330,14 @@ int32_t AP_Filesystem_Mission::write(int fd, const void *buf, uint32_t count)
         return -1;
     }
     struct rfile &r = file[fd];
+    r.last_op_ms = AP_HAL::millis();
+    if (r.stream != nullptr) {
+        return write_stream(r, buf, count);
+    }
     if (r.writebuf == nullptr) {
         errno = EBADF;
         return -1;
     }
-    r.last_op_ms = AP_HAL::millis();
     struct header hdr;
     if (r.file_ofs == 0 && count >= sizeof(hdr)) {
         // pre-expand the buffer to the full size when we get the header
@@ -390,29 +416,105 @@ bool AP_Filesystem_Mission::finish_upload(const rfile &r)
         mission->clear();
     }
     for (uint32_t i=0; i<nitems; i++) {
-        mavlink_mission_item_int_t m {};
-        AP_Mission::Mission_Command cmd;
-        memcpy(&m, &b[sizeof(hdr)+i*item_size], item_size);
-        const MAV_MISSION_RESULT res = AP_Mission::mavlink_int_to_mission_cmd(m, cmd);
-        if (res != MAV_MISSION_ACCEPTED) {
+        if (!add_item(hdr, i, &b[sizeof(hdr)+i*item_size])) {
             return false;
         }
-        if (cmd.id == MAV_CMD_DO_JUMP &&
-            (cmd.content.jump.target >= nitems || cmd.content.jump.target == 0)) {
-            return false;
+    }
+    return true;
+}
+
+/*
+  add item i of an upload to the mission
+ */
+bool AP_Filesystem_Mission::add_item(const struct header &hdr, uint32_t i, const uint8_t *b) const
+{
+    auto *mission = AP::mission();
+    if (mission == nullptr) {
+        return false;
+    }
+    mavlink_mission_item_int_t m {};
+    AP_Mission::Mission_Command cmd;
+    memcpy(&m, b, MAVLINK_MSG_ID_MISSION_ITEM_INT_LEN);
+    const MAV_MISSION_RESULT res = AP_Mission::mavlink_int_to_mission_cmd(m, cmd);
+    if (res != MAV_MISSION_ACCEPTED) {
+        return false;
+    }
+    if (cmd.id == MAV_CMD_DO_JUMP &&
+        (cmd.content.jump.target >= hdr.num_items || cmd.content.jump.target == 0)) {
+        return false;
+    }
+    WITH_SEMAPHORE(mission->get_semaphore());
+    uint16_t idx = i + hdr.start;
+    if (idx == mission->num_commands()) {
+        return mission->add_cmd(cmd);
+    }
+    return mission->replace_cmd(idx, cmd);
+}
+
+/*
+  upload straight to a mission stored on the SD card. Each item is
+  added to the mission as soon as it is complete, so only one item is
+  held in memory. Writes must be sequential. As with the MISSION_ITEM
+  protocol, an upload that fails part way leaves a partial mission
+ */
+int32_t AP_Filesystem_Mission::write_stream(rfile &r, const void *buf, uint32_t count)
+{
+    upload_stream &st = *r.stream;
+    const uint8_t item_size = MAVLINK_MSG_ID_MISSION_ITEM_INT_LEN;
+    const uint32_t stream_ofs = (st.have_header ? sizeof(st.hdr) + st.num_items * item_size : 0) + st.buf_len;
+    if (st.failed || r.file_ofs != stream_ofs) {
+        errno = EINVAL;
+        return -1;
+    }
+
+    const uint8_t *b = (const uint8_t *)buf;
+    uint32_t remaining = count;
+    while (remaining > 0) {
+        const uint8_t need = st.have_header ? item_size : sizeof(st.hdr);
+        const uint8_t n = MIN(uint32_t(need - st.buf_len), remaining);
+        memcpy(&st.buf[st.buf_len], b, n);
+        st.buf_len += n;
+        b += n;
+        remaining -= n;
+        if (st.buf_len < need) {
+            break;
         }
-        uint16_t idx = i + hdr.start;
-        if (idx == mission->num_commands()) {
-            if (!mission->add_cmd(cmd)) {
-                return false;
+        st.buf_len = 0;
+
+        if (!st.have_header) {
+            memcpy(&st.hdr, st.buf, sizeof(st.hdr));
+            if (st.hdr.magic != mission_magic) {
+                st.failed = true;
+                break;
             }
-        } else {
-            if (!mission->replace_cmd(idx, cmd)) {
-                return false;
+            st.have_header = true;
+            if ((st.hdr.options & unsigned(Options::NO_CLEAR)) == 0) {
+                auto *mission = AP::mission();
+                if (mission != nullptr) {
+                    WITH_SEMAPHORE(mission->get_semaphore());
+                    mission->clear();
+                }
             }
+            continue;
+        }
+
+        // if any item is all zeros then reject, it means client didn't
+        // fill in the whole file
+        if (st.num_items >= st.hdr.num_items ||
+            all_zero(st.buf, item_size) ||
+            !add_item(st.hdr, st.num_items, st.buf)) {
+            st.failed = true;
+            break;
         }
+        st.num_items++;
     }
-    return true;
+
+    if (st.failed) {
+        errno = EINVAL;
+        return -1;
+    }
+    r.file_ofs += count;
+    return count;
 }
 
 #endif  // AP_FILESYSTEM_MISSION_ENABLED
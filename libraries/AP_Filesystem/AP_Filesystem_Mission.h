@@ -53,6 +53,17 @@ private:
         uint16_t num_items;
     };
 
+    // state of an upload that is added to the mission as it arrives,
+    // rather than buffered, see write_stream()
+    struct upload_stream {
+        struct header hdr;
+        uint8_t buf[MAVLINK_MSG_ID_MISSION_ITEM_INT_LEN];
+        uint8_t buf_len;        // bytes in buf
+        bool have_header;       // true once hdr has been received
+        bool failed;            // true if an item was rejected
+        uint32_t num_items;     // number of items added to the mission
+    };
+
     struct rfile {
         bool open;
         ExpandingString *writebuf;
@@ -60,6 +71,7 @@ private:
         uint32_t num_items;
         enum MAV_MISSION_TYPE mtype;
         uint32_t last_op_ms;
+        upload_stream *stream;
     } file[max_open_file];
 
     bool check_file_name(const char *fname, enum MAV_MISSION_TYPE &mtype);
@@ -73,6 +85,12 @@ private:
     // finish loading items
     bool finish_upload(const rfile &r);
 
+    // add one uploaded item to the mission
+    bool add_item(const struct header &hdr, uint32_t i, const uint8_t *b) const;
+
+    // upload directly to the mission
+    int32_t write_stream(rfile &r, const void *buf, uint32_t count);
+
     // see if a block of memory is all zero
     bool all_zero(const uint8_t *b, uint8_t size) const;
 };
@@ -23,6 +23,7 @@
 #include "AP_Filesystem.h"
 #include "AP_Filesystem_Param.h"
 #include <AP_Param/AP_Param.h>
+#include <StorageManager/StorageManager.h>
 #include <AP_Math/AP_Math.h>
 #include <ctype.h>
 
@@ -63,7 +64,17 @@ int AP_Filesystem_Param::open(const char *fname, int flags, bool allow_absolute_
     r.count = 0;
     r.read_size = 0;
     r.file_size = 0;
+    r.checkpoints = nullptr;
+    r.num_checkpoints = 0;
     r.writebuf = nullptr;
+#if AP_PARAM_CHANGE_HISTORY > 0
+    r.since = false;
+    r.delta = false;
+    r.num_changes = 0;
+    r.num_delta_params = 0;
+    r.changes = nullptr;
+    uint32_t since = 0;
+#endif
     if (!read_only) {
         // setup for upload
         r.writebuf = new ExpandingString();
@@ -111,13 +122,49 @@ int AP_Filesystem_Param::open(const char *fname, int flags, bool allow_absolute_
             c = strchr(c, '&');
             continue;
         }
+#endif
+#if AP_PARAM_CHANGE_HISTORY > 0
+        if (strncmp(c, "since=", 6) == 0) {
+            if (!read_only) {
+                goto failed;
+            }
+            since = strtoul(c+6, nullptr, 10);
+            r.since = true;
+            c += 6;
+            c = strchr(c, '&');
+            continue;
+        }
 #endif
     }
 
+#if AP_PARAM_CHANGE_HISTORY > 0
+    if (r.since) {
+        // a delta is a subset already, so can't be paged
+        if (r.start != 0 || r.count != 0) {
+            goto failed;
+        }
+        r.changes = new AP_Param::ParamChange[AP_PARAM_CHANGE_HISTORY];
+        if (r.changes == nullptr) {
+            delete [] r.cursors;
+            r.open = false;
+            errno = ENOMEM;
+            return -1;
+        }
+        r.delta = AP_Param::changed_since(since, r.changes, r.num_changes, r.generation, r.hash);
+        if (r.delta) {
+            r.num_delta_params = count_delta_params(r);
+        }
+    }
+#endif
+
     return idx;
 
 failed:
     delete [] r.cursors;
+#if AP_PARAM_CHANGE_HISTORY > 0
+    delete [] r.changes;
+    r.changes = nullptr;
+#endif
     r.open = false;
     errno = EINVAL;
     return -1;
@@ -138,8 +185,14 @@ int AP_Filesystem_Param::close(int fd)
     r.open = false;
     delete [] r.cursors;
     r.cursors = nullptr;
+    delete [] r.checkpoints;
+    r.checkpoints = nullptr;
     delete r.writebuf;
     r.writebuf = nullptr;
+#if AP_PARAM_CHANGE_HISTORY > 0
+    delete [] r.changes;
+    r.changes = nullptr;
+#endif
     return ret;
 }
 
@@ -162,7 +215,82 @@ int AP_Filesystem_Param::close(int fd)
     Any leading zero bytes after the header should be discarded as pad
     bytes. Pad bytes are used to ensure that a parameter data[] field
     does not cross a read packet boundary
+
+    a file opened with since=G has magic 0x671d and the header is
+    followed by:
+      uint16_t flags // bit 0: delta, bit 1: includes default values
+      uint32_t generation
+      uint32_t hash
+ */
+
+/*
+  size of the header for a file
+ */
+uint8_t AP_Filesystem_Param::header_size(const struct rfile &r) const
+{
+#if AP_PARAM_CHANGE_HISTORY > 0
+    if (r.since) {
+        return sizeof(struct since_header);
+    }
+#endif
+    return sizeof(struct header);
+}
+
+#if AP_PARAM_CHANGE_HISTORY > 0
+/*
+  see if a parameter is in the changes snapshot of a delta file
+ */
+bool AP_Filesystem_Param::in_delta(const struct rfile &r, const AP_Param *ap) const
+{
+    for (uint8_t i=0; i<r.num_changes; i++) {
+        const AP_Param::ParamChange &pc = r.changes[i];
+        // a saved vector covers each of its elements
+        if ((const uint8_t *)ap >= (const uint8_t *)pc.param &&
+            (const uint8_t *)ap < pc.size + (const uint8_t *)pc.param) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/*
+  count the parameters that will be sent in a delta file. Saved
+  parameters that are not sent as scalars (eg. hidden ones) are not
+  counted
+ */
+uint16_t AP_Filesystem_Param::count_delta_params(const struct rfile &r)
+{
+    if (r.num_changes == 0) {
+        return 0;
+    }
+    struct cursor c {};
+    enum ap_var_type ptype;
+    float default_val;
+    uint16_t count = 0;
+    for (AP_Param *ap = next_param(r, c, true, &ptype, &default_val);
+         ap != nullptr;
+         ap = next_param(r, c, false, &ptype, &default_val)) {
+        count++;
+    }
+    return count;
+}
+#endif
+
+/*
+  get the next parameter to include in the file
  */
+AP_Param *AP_Filesystem_Param::next_param(const struct rfile &r, struct cursor &c, bool first, enum ap_var_type *ptype, float *default_val)
+{
+    AP_Param *ap = first ? AP_Param::first(&c.token, ptype, default_val) : AP_Param::next_scalar(&c.token, ptype, default_val);
+#if AP_PARAM_CHANGE_HISTORY > 0
+    if (r.delta) {
+        while (ap != nullptr && !in_delta(r, ap)) {
+            ap = AP_Param::next_scalar(&c.token, ptype, default_val);
+        }
+    }
+#endif
+    return ap;
+}
 
 /*
   pack a single parameter. The buffer must be at least of size max_pack_len
@@ -177,18 +305,36 @@ uint8_t AP_Filesystem_Param::pack_param(const struct rfile &r, struct cursor &c,
 
     if (c.token_ofs == 0) {
         c.idx = 0;
-        ap = AP_Param::first(&c.token, &ptype, &default_val);
-        uint16_t idx = 0;
-        while (idx < r.start && ap) {
-            ap = AP_Param::next_scalar(&c.token, &ptype, &default_val);
-            idx++;
+#if AP_PARAM_CHANGE_HISTORY > 0
+        const bool delta = r.delta;
+#else
+        const bool delta = false;
+#endif
+        if (r.start > 0 && !delta &&
+            AP_Param::find_by_index(r.start-1, &ptype, &c.token) != nullptr) {
+            // seek to the parameter before the start, which is a
+            // table lookup when the scalar table is current, then step
+            // onto the start so we get its default
+            ap = next_param(r, c, false, &ptype, &default_val);
+        } else {
+            ap = next_param(r, c, true, &ptype, &default_val);
+            uint16_t idx = 0;
+            while (idx < r.start && ap) {
+                ap = next_param(r, c, false, &ptype, &default_val);
+                idx++;
+            }
         }
     } else {
         c.idx++;
-        ap = AP_Param::next_scalar(&c.token, &ptype, &default_val);
+        ap = next_param(r, c, false, &ptype, &default_val);
     }
     if (ap == nullptr || (r.count && c.idx >= r.count)) {
-        if (r.count == 0 && c.idx != AP_Param::count_parameters()) {
+#if AP_PARAM_CHANGE_HISTORY > 0
+        const bool delta = r.delta;
+#else
+        const bool delta = false;
+#endif
+        if (r.count == 0 && !delta && c.idx != AP_Param::count_parameters()) {
             // the parameter count is incorrect, invalidate so a
             // repeated param download avoids an error
             AP_Param::invalidate_count();
@@ -226,7 +372,7 @@ uint8_t AP_Filesystem_Param::pack_param(const struct rfile &r, struct cursor &c,
       won't get a corrupt value for a parameter
      */
     if (type_len > 1) {
-        const uint32_t ofs = c.token_ofs + sizeof(struct header) + packed_len;
+        const uint32_t ofs = c.token_ofs + header_size(r) + packed_len;
         const uint32_t ofs_mod = ofs % r.read_size;
         if (ofs_mod > 0 && ofs_mod < type_len) {
             const uint8_t pad = type_len - ofs_mod;
@@ -276,16 +422,80 @@ uint8_t AP_Filesystem_Param::pack_param(const struct rfile &r, struct cursor &c,
     return packed_len;
 }
 
+/*
+  save a checkpoint if the cursor has just packed the last parameter
+  of a checkpoint interval
+ */
+void AP_Filesystem_Param::checkpoint_save(struct rfile &r, const struct cursor &c)
+{
+    if (c.trailer_len != 0 ||
+        c.token_ofs == 0 ||
+        (c.idx+1U) % checkpoint_interval != 0) {
+        return;
+    }
+    if (r.num_checkpoints > 0 && r.checkpoint_hash != AP_Param::storage_hash()) {
+        // a save may have changed the parameter list or, with
+        // defaults, the length of a parameter
+        r.num_checkpoints = 0;
+    }
+    if (r.num_checkpoints == max_checkpoints ||
+        (r.num_checkpoints > 0 && r.checkpoints[r.num_checkpoints-1].token_ofs >= c.token_ofs)) {
+        return;
+    }
+    if (r.checkpoints == nullptr) {
+        r.checkpoints = new checkpoint[max_checkpoints];
+        if (r.checkpoints == nullptr) {
+            return;
+        }
+    }
+    if (r.num_checkpoints == 0) {
+        r.checkpoint_hash = AP_Param::storage_hash();
+    }
+    struct checkpoint &cp = r.checkpoints[r.num_checkpoints++];
+    cp.token = c.token;
+    cp.token_ofs = c.token_ofs;
+    cp.idx = c.idx;
+    memcpy(cp.last_name, c.last_name, sizeof(cp.last_name));
+}
+
+/*
+  move a cursor to the last checkpoint at or before data_ofs, if that
+  is closer than where the cursor can get to by itself
+ */
+bool AP_Filesystem_Param::checkpoint_restore(struct rfile &r, const uint32_t data_ofs, struct cursor &c)
+{
+    if (r.num_checkpoints > 0 && r.checkpoint_hash != AP_Param::storage_hash()) {
+        r.num_checkpoints = 0;
+    }
+    const uint32_t cursor_ofs = c.token_ofs <= data_ofs ? c.token_ofs : 0;
+    for (int16_t i=r.num_checkpoints-1; i>=0; i--) {
+        const struct checkpoint &cp = r.checkpoints[i];
+        if (cp.token_ofs > data_ofs) {
+            continue;
+        }
+        if (cp.token_ofs <= cursor_ofs) {
+            return false;
+        }
+        c.token = cp.token;
+        c.token_ofs = cp.token_ofs;
+        c.idx = cp.idx;
+        memcpy(c.last_name, cp.last_name, sizeof(c.last_name));
+        c.trailer_len = 0;
+        return true;
+    }
+    return false;
+}
+
 /*
   seek the token to match file offset
  */
-bool AP_Filesystem_Param::token_seek(const struct rfile &r, const uint32_t data_ofs, struct cursor &c)
+bool AP_Filesystem_Param::token_seek(struct rfile &r, const uint32_t data_ofs, struct cursor &c)
 {
     if (data_ofs == 0) {
         memset(&c, 0, sizeof(c));
         return true;
     }
-    if (c.token_ofs > data_ofs) {
+    if (!checkpoint_restore(r, data_ofs, c) && c.token_ofs > data_ofs) {
         memset(&c, 0, sizeof(c));
     }
 
@@ -312,6 +522,7 @@ bool AP_Filesystem_Param::token_seek(const struct rfile &r, const uint32_t data_
             memcpy(c.trailer, &tbuf[n], c.trailer_len);
         }
         c.token_ofs += n;
+        checkpoint_save(r, c);
     }
     return data_ofs == c.token_ofs;
 }
@@ -353,7 +564,8 @@ int32_t AP_Filesystem_Param::read(int fd, void *buf, uint32_t count)
         }
     }
 
-    if (r.file_ofs < sizeof(struct header)) {
+    const uint8_t hsize = header_size(r);
+    if (r.file_ofs < hsize) {
         struct header hdr;
         hdr.total_params = AP_Param::count_parameters();
         if (hdr.total_params <= r.start) {
@@ -364,11 +576,24 @@ int32_t AP_Filesystem_Param::read(int fd, void *buf, uint32_t count)
         if (r.count > 0 && hdr.num_params > r.count) {
             hdr.num_params = r.count;
         }
-        uint8_t n = MIN(sizeof(hdr) - r.file_ofs, count);
         if (r.with_defaults) {
             hdr.magic = pmagic_with_default;
         }
+#if AP_PARAM_CHANGE_HISTORY > 0
+        struct since_header shdr;
+        if (r.since) {
+            shdr.magic = pmagic_since;
+            shdr.num_params = r.delta ? r.num_delta_params : hdr.num_params;
+            shdr.total_params = hdr.total_params;
+            shdr.flags = (r.delta ? since_flag_delta : 0) | (r.with_defaults ? since_flag_defaults : 0);
+            shdr.generation = r.generation;
+            shdr.hash = r.hash;
+        }
+        const uint8_t *b = r.since ? (const uint8_t *)&shdr : (const uint8_t *)&hdr;
+#else
         const uint8_t *b = (const uint8_t *)&hdr;
+#endif
+        uint8_t n = MIN(hsize - r.file_ofs, count);
         memcpy(buf, &b[r.file_ofs], n);
         count -= n;
         header_total += n;
@@ -379,7 +604,7 @@ int32_t AP_Filesystem_Param::read(int fd, void *buf, uint32_t count)
         }
     }
 
-    uint32_t data_ofs = r.file_ofs - sizeof(struct header);
+    uint32_t data_ofs = r.file_ofs - hsize;
     uint8_t best_i = 0;
     uint32_t best_ofs = r.cursors[0].token_ofs;
     size_t total = 0;
@@ -441,6 +666,7 @@ int32_t AP_Filesystem_Param::read(int fd, void *buf, uint32_t count)
         ubuf += n;
         total += n;
         c.token_ofs += n;
+        checkpoint_save(r, c);
     }
     r.file_ofs += total;
     return total + header_total;
@@ -644,17 +870,23 @@ bool AP_Filesystem_Param::param_upload_parse(const rfile &r, bool &need_retry)
  */
 bool AP_Filesystem_Param::finish_upload(const rfile &r)
 {
+    // flush the whole upload to storage together, rather than a line
+    // at a time as each parameter is saved
+    StorageManager::begin_batch();
+    bool ret = true;
     uint8_t loops = 0;
     while (loops++ < 4) {
         bool need_retry;
         if (!param_upload_parse(r, need_retry)) {
-            return false;
+            ret = false;
+            break;
         }
         if (!need_retry) {
             break;
         }
     }
-    return true;
+    StorageManager::commit();
+    return ret;
 }
 
 #endif  // AP_FILESYSTEM_PARAM_ENABLED
@@ -57,6 +57,22 @@ private:
         uint16_t total_params; // for upload this is total file length
     };
 
+#if AP_PARAM_CHANGE_HISTORY > 0
+    // files opened with a since= query carry the save generation
+    static constexpr uint16_t pmagic_since = 0x671d;
+    static constexpr uint16_t since_flag_delta = (1U<<0);
+    static constexpr uint16_t since_flag_defaults = (1U<<1);
+
+    struct PACKED since_header {
+        uint16_t magic;
+        uint16_t num_params;
+        uint16_t total_params;
+        uint16_t flags;
+        uint32_t generation;
+        uint32_t hash;
+    };
+#endif
+
     struct cursor {
         AP_Param::ParamToken token;
         uint32_t token_ofs;
@@ -66,6 +82,20 @@ private:
         uint16_t idx;
     };
 
+    /*
+      a cursor saved at a parameter boundary every checkpoint_interval
+      parameters, so a read behind both cursors restarts packing from
+      the nearest checkpoint rather than from the start of the file
+     */
+    static constexpr uint8_t checkpoint_interval = 32;
+    static constexpr uint8_t max_checkpoints = 64;
+    struct checkpoint {
+        AP_Param::ParamToken token;
+        uint32_t token_ofs;
+        uint16_t idx;
+        char last_name[AP_MAX_NAME_SIZE+1];
+    };
+
     struct rfile {
         bool open;
         bool with_defaults;
@@ -75,10 +105,32 @@ private:
         uint32_t file_ofs;
         uint32_t file_size;
         struct cursor *cursors;
+        struct checkpoint *checkpoints;
+        uint8_t num_checkpoints;
+        // storage hash the checkpoints were taken against
+        uint32_t checkpoint_hash;
         ExpandingString *writebuf; // for upload
+#if AP_PARAM_CHANGE_HISTORY > 0
+        // snapshot taken at open so re-reads see the same file
+        bool since;
+        bool delta;
+        uint8_t num_changes;
+        uint16_t num_delta_params;
+        uint32_t generation;
+        uint32_t hash;
+        AP_Param::ParamChange *changes;
+#endif
     } file[max_open_file];
 
-    bool token_seek(const struct rfile &r, const uint32_t data_ofs, struct cursor &c);
+    bool token_seek(struct rfile &r, const uint32_t data_ofs, struct cursor &c);
+    void checkpoint_save(struct rfile &r, const struct cursor &c);
+    bool checkpoint_restore(struct rfile &r, const uint32_t data_ofs, struct cursor &c);
+    AP_Param *next_param(const struct rfile &r, struct cursor &c, bool first, enum ap_var_type *ptype, float *default_val);
+    uint8_t header_size(const struct rfile &r) const;
+#if AP_PARAM_CHANGE_HISTORY > 0
+    bool in_delta(const struct rfile &r, const AP_Param *ap) const;
+    uint16_t count_delta_params(const struct rfile &r);
+#endif
     uint8_t pack_param(const struct rfile &r, struct cursor &c, uint8_t *buf);
     bool check_file_name(const char *fname);
 
@@ -34,7 +34,7 @@ int AP_Filesystem_ROMFS::open(const char *fname, int flags, bool allow_absolute_
     }
     uint8_t idx;
     for (idx=0; idx<max_open_file; idx++) {
-        if (file[idx].data == nullptr) {
+        if (!fd_valid(idx)) {
             break;
         }
     }
@@ -42,43 +42,83 @@ int AP_Filesystem_ROMFS::open(const char *fname, int flags, bool allow_absolute_
         errno = ENFILE;
         return -1;
     }
-    if (file[idx].data != nullptr) {
-        errno = EBUSY;
-        return -1;
+    file[idx].ofs = 0;
+
+    // block compressed files are decompressed a block at a time as
+    // they are read
+    if (AP_ROMFS::find_blocks(fname, file[idx].bf)) {
+        file[idx].block = (uint8_t *)malloc(file[idx].bf.block_size);
+        if (file[idx].block == nullptr) {
+            errno = ENOMEM;
+            return -1;
+        }
+        file[idx].block_num = UINT32_MAX;
+        file[idx].size = file[idx].bf.size;
+        return idx;
     }
+
     file[idx].data = AP_ROMFS::find_decompress(fname, file[idx].size);
     if (file[idx].data == nullptr) {
         errno = ENOENT;
         return -1;
     }
-    file[idx].ofs = 0;
     return idx;
 }
 
 int AP_Filesystem_ROMFS::close(int fd)
 {
-    if (fd < 0 || fd >= max_open_file || file[fd].data == nullptr) {
+    if (!fd_valid(fd)) {
         errno = EBADF;
         return -1;
     }
-    AP_ROMFS::free(file[fd].data);
-    file[fd].data = nullptr;
+    if (file[fd].block != nullptr) {
+        free(file[fd].block);
+        file[fd].block = nullptr;
+    } else {
+        AP_ROMFS::free(file[fd].data);
+        file[fd].data = nullptr;
+    }
     return 0;
 }
 
 int32_t AP_Filesystem_ROMFS::read(int fd, void *buf, uint32_t count)
 {
-    if (fd < 0 || fd >= max_open_file || file[fd].data == nullptr) {
+    if (!fd_valid(fd)) {
         errno = EBADF;
         return -1;
     }
-    count = MIN(file[fd].size - file[fd].ofs, count);
+    rfile &f = file[fd];
+    count = MIN(f.size - f.ofs, count);
     if (count == 0) {
         return 0;
     }
-    memcpy(buf, &file[fd].data[file[fd].ofs], count);
-    file[fd].ofs += count;
-    return count;
+    if (f.block == nullptr) {
+        memcpy(buf, &f.data[f.ofs], count);
+        f.ofs += count;
+        return count;
+    }
+
+    // copy from the blocks covering the read, decompressing each
+    // one not already held
+    uint8_t *dest = (uint8_t *)buf;
+    uint32_t done = 0;
+    while (done < count) {
+        const uint32_t block_num = f.ofs / f.bf.block_size;
+        if (block_num != f.block_num) {
+            f.block_num = UINT32_MAX;
+            if (AP_ROMFS::decompress_block(f.bf, block_num, f.block) < 0) {
+                errno = EIO;
+                return -1;
+            }
+            f.block_num = block_num;
+        }
+        const uint32_t block_ofs = f.ofs - block_num * f.bf.block_size;
+        const uint32_t n = MIN(count - done, f.bf.block_size - block_ofs);
+        memcpy(&dest[done], &f.block[block_ofs], n);
+        done += n;
+        f.ofs += n;
+    }
+    return done;
 }
 
 int32_t AP_Filesystem_ROMFS::write(int fd, const void *buf, uint32_t count)
@@ -94,7 +134,7 @@ int AP_Filesystem_ROMFS::fsync(int fd)
 
 int32_t AP_Filesystem_ROMFS::lseek(int fd, int32_t offset, int seek_from)
 {
-    if (fd < 0 || fd >= max_open_file || file[fd].data == nullptr) {
+    if (!fd_valid(fd)) {
         errno = EBADF;
         return -1;
     }
@@ -119,12 +159,10 @@ int32_t AP_Filesystem_ROMFS::lseek(int fd, int32_t offset, int seek_from)
 int AP_Filesystem_ROMFS::stat(const char *name, struct stat *stbuf)
 {
     uint32_t size;
-    const uint8_t *data = AP_ROMFS::find_decompress(name, size);
-    if (data == nullptr) {
+    if (!AP_ROMFS::find_size(name, size)) {
         errno = ENOENT;
         return -1;
     }
-    AP_ROMFS::free(data);
     memset(stbuf, 0, sizeof(*stbuf));
     stbuf->st_size = size;
     return 0;
@@ -20,6 +20,7 @@
 #if AP_FILESYSTEM_ROMFS_ENABLED
 
 #include "AP_Filesystem_backend.h"
+#include <AP_ROMFS/AP_ROMFS.h>
 
 class AP_Filesystem_ROMFS : public AP_Filesystem_Backend
 {
@@ -60,11 +61,18 @@ private:
     static constexpr uint8_t max_open_file = 4;
     static constexpr uint8_t max_open_dir = 4;
     struct rfile {
-        const uint8_t *data;
+        const uint8_t *data;        // whole file, if not block compressed
+        AP_ROMFS::block_file bf;    // block compressed file
+        uint8_t *block;             // one decompressed block of bf
+        uint32_t block_num;         // block held in block, UINT32_MAX if none
         uint32_t size;
         uint32_t ofs;
     } file[max_open_file];
 
+    bool fd_valid(int fd) const {
+        return fd >= 0 && fd < max_open_file && (file[fd].data != nullptr || file[fd].block != nullptr);
+    }
+
     // allow up to 4 directory opens
     struct rdir {
         char *path;
@@ -26,6 +26,10 @@
 #include <AP_CANManager/AP_CANManager.h>
 #include <AP_Scheduler/AP_Scheduler.h>
 #include <AP_Common/ExpandingString.h>
+#include <AP_Scripting/AP_Scripting.h>
+#if HAL_ENABLE_LIBUAVCAN_DRIVERS
+#include <AP_UAVCAN/AP_UAVCAN.h>
+#endif
 
 extern const AP_HAL::HAL& hal;
 
@@ -36,7 +40,13 @@ struct SysFileList {
 static const SysFileList sysfs_file_list[] = {
     {"threads.txt"},
     {"tasks.txt"},
+#if HAL_SCHEDULER_ENABLED && AP_SCHEDULER_LOOP_TRACE_ENABLED
+    {"trace.bin"},
+#endif
     {"dma.txt"},
+#if AP_HAL_SEMAPHORE_STATS_ENABLED
+    {"locks.txt"},
+#endif
     {"memory.txt"},
     {"uarts.txt"},
     {"timers.txt"},
@@ -52,8 +62,15 @@ static const SysFileList sysfs_file_list[] = {
 #endif
     {"crash_dump.bin"},
     {"storage.bin"},
+#if AP_SCRIPTING_ENABLED
+    {"scripting_profile.txt"},
+#endif
 };
 
+// length of each report the last time it was generated, used to size
+// the next one in a single allocation
+static uint32_t sysfs_report_length[ARRAY_SIZE(sysfs_file_list)];
+
 int8_t AP_Filesystem_Sys::file_in_sysfs(const char *fname) {
     for (uint8_t i = 0; i <  ARRAY_SIZE(sysfs_file_list); i++) {
         if (strcmp(fname, sysfs_file_list[i].name) == 0) {
@@ -95,17 +112,35 @@ int AP_Filesystem_Sys::open(const char *fname, int flags, bool allow_absolute_pa
         return -1;
     }
 
+    // these are read in place rather than generated
+    const bool in_place = strcmp(fname, "crash_dump.bin") == 0 || strcmp(fname, "storage.bin") == 0;
+    if (!in_place && sysfs_report_length[pos] != 0) {
+        // allow for the report having grown a little since last time
+        r.str->reserve(sysfs_report_length[pos] + sysfs_report_length[pos]/8);
+    }
+
     if (strcmp(fname, "threads.txt") == 0) {
         hal.util->thread_info(*r.str);
     }
 #if HAL_SCHEDULER_ENABLED
     if (strcmp(fname, "tasks.txt") == 0) {
         AP::scheduler().task_info(*r.str);
+        hal.util->cpu_load_info(*r.str);
     }
+#if AP_SCHEDULER_LOOP_TRACE_ENABLED
+    if (strcmp(fname, "trace.bin") == 0) {
+        AP::scheduler().loop_trace.dump(*r.str, AP::scheduler().get_loop_rate_hz());
+    }
+#endif
 #endif
     if (strcmp(fname, "dma.txt") == 0) {
         hal.util->dma_info(*r.str);
     }
+#if AP_HAL_SEMAPHORE_STATS_ENABLED
+    if (strcmp(fname, "locks.txt") == 0) {
+        AP_HAL::Semaphore::stats_info(*r.str);
+    }
+#endif
     if (strcmp(fname, "memory.txt") == 0) {
         hal.util->mem_info(*r.str);
     }
@@ -133,6 +168,12 @@ int AP_Filesystem_Sys::open(const char *fname, int flags, bool allow_absolute_pa
         if (hal.can[can_stats_num] != nullptr) {
             hal.can[can_stats_num]->get_stats(*r.str);
         }
+#if HAL_ENABLE_LIBUAVCAN_DRIVERS
+        const AP_UAVCAN *ap_uavcan = AP_UAVCAN::get_uavcan(can_stats_num);
+        if (ap_uavcan != nullptr) {
+            ap_uavcan->get_pool_stats(*r.str);
+        }
+#endif
     }
 #endif
     if (strcmp(fname, "persistent.parm") == 0) {
@@ -142,6 +183,14 @@ int AP_Filesystem_Sys::open(const char *fname, int flags, bool allow_absolute_pa
     if (strcmp(fname, "crash_dump.bin") == 0) {
         r.str->set_buffer((char*)hal.util->last_crash_dump_ptr(), hal.util->last_crash_dump_size(), hal.util->last_crash_dump_size());
     }
+#endif
+#if AP_SCRIPTING_ENABLED
+    if (strcmp(fname, "scripting_profile.txt") == 0) {
+        AP_Scripting *scripting = AP::scripting();
+        if (scripting != nullptr) {
+            scripting->profile_info(*r.str);
+        }
+    }
 #endif
     if (strcmp(fname, "storage.bin") == 0) {
         // we don't want to store the contents of storage.bin
@@ -153,6 +202,10 @@ int AP_Filesystem_Sys::open(const char *fname, int flags, bool allow_absolute_pa
         }
     }
     
+    if (!in_place) {
+        sysfs_report_length[pos] = r.str->get_length();
+    }
+
     if (r.str->get_length() == 0) {
         errno = r.str->has_failed_allocation()?ENOMEM:ENOENT;
         delete r.str;
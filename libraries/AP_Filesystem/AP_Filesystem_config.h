@@ -22,6 +22,17 @@
 #define AP_FILESYSTEM_SYS_ENABLED 1
 #endif
 
+// the FATFS backend keeps a read cache of blocks of file data shared
+// between the open files, and reads ahead of sequential readers from
+// the IO thread. Zero blocks disables the cache
+#ifndef AP_FILESYSTEM_FATFS_CACHE_BLOCKS
+#define AP_FILESYSTEM_FATFS_CACHE_BLOCKS (HAL_MEM_CLASS >= HAL_MEM_CLASS_300 ? 4 : 0)
+#endif
+
+#ifndef AP_FILESYSTEM_FATFS_CACHE_BLOCK_SIZE
+#define AP_FILESYSTEM_FATFS_CACHE_BLOCK_SIZE 1024
+#endif
+
 #ifndef AP_FILESYSTEM_ROMFS_ENABLED
 #define AP_FILESYSTEM_ROMFS_ENABLED defined(HAL_HAVE_AP_ROMFS_EMBEDDED_H)
 #endif
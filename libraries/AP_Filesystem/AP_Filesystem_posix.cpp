@@ -27,6 +27,7 @@
 #include <sys/vfs.h>
 #endif
 #include <utime.h>
+#include <sys/uio.h>
 
 extern const AP_HAL::HAL& hal;
 
@@ -77,6 +78,20 @@ int32_t AP_Filesystem_Posix::write(int fd, const void *buf, uint32_t count)
     return ::write(fd, buf, count);
 }
 
+int32_t AP_Filesystem_Posix::writev(int fd, const ByteBuffer::IoVec *iov, uint8_t iovcnt)
+{
+    FS_CHECK_ALLOWED(-1);
+    struct iovec v[4];
+    if (iovcnt > ARRAY_SIZE(v)) {
+        return AP_Filesystem_Backend::writev(fd, iov, iovcnt);
+    }
+    for (uint8_t i=0; i<iovcnt; i++) {
+        v[i].iov_base = iov[i].data;
+        v[i].iov_len = iov[i].len;
+    }
+    return ::writev(fd, v, iovcnt);
+}
+
 int AP_Filesystem_Posix::fsync(int fd)
 {
     FS_CHECK_ALLOWED(-1);
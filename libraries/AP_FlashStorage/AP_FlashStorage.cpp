@@ -55,26 +55,41 @@ bool AP_FlashStorage::init(void)
     struct sector_header header[2];
 
     // read headers and possibly initialise if bad signature
+    bool bad_header[2];
     for (uint8_t i=0; i<2; i++) {
         if (!flash_read(i, 0, (uint8_t *)&header[i], sizeof(header[i]))) {
             return false;
         }
-        bool bad_header = !header[i].signature_ok();
+        bad_header[i] = !header[i].signature_ok();
         enum SectorState state = header[i].get_state();
         if (state != SECTOR_STATE_AVAILABLE &&
             state != SECTOR_STATE_IN_USE &&
             state != SECTOR_STATE_FULL) {
-            bad_header = true;
-        }
-
-        // initialise if bad header
-        if (bad_header) {
-            return erase_all();
+            bad_header[i] = true;
         }
     }
 
     // work out the first sector to read from using sector states
     enum SectorState states[2] {header[0].get_state(), header[1].get_state()};
+
+    for (uint8_t i=0; i<2; i++) {
+        if (!bad_header[i]) {
+            continue;
+        }
+        if (bad_header[i^1] || states[i^1] != SECTOR_STATE_IN_USE) {
+            // initialise if bad header
+            return erase_all();
+        }
+        /*
+          a sector is only erased while the other sector is in use
+          and holds all of the data, so this was an interrupted
+          erase. Finish it and keep the data
+         */
+        if (!erase_sector(i, true)) {
+            return false;
+        }
+        states[i] = SECTOR_STATE_AVAILABLE;
+    }
     uint8_t first_sector;
 
     if (states[0] == states[1]) {
@@ -95,12 +110,14 @@ bool AP_FlashStorage::init(void)
         first_sector = 0;
     }
 
-    // load data from any current sectors
+    // load data from any current sectors, noting the blocks in the
+    // second sector, which is the one kept if the first is full
+    Bitmask<num_blocks> present;
     for (uint8_t i=0; i<2; i++) {
         uint8_t sector = (first_sector + i) & 1;
         if (states[sector] == SECTOR_STATE_IN_USE ||
             states[sector] == SECTOR_STATE_FULL) {
-            if (!load_sector(sector)) {
+            if (!load_sector(sector, i==1?&present:nullptr)) {
                 return erase_all();
             }
         }
@@ -110,10 +127,32 @@ bool AP_FlashStorage::init(void)
     write_error = false;
     reserved_space = 0;
     
-    // if the first sector is full then write out all data so we can erase it
+    // write to the in-use sector, which follows a full one
+    current_sector = first_sector;
     if (states[first_sector] == SECTOR_STATE_FULL) {
         current_sector = first_sector ^ 1;
-        if (!write_all()) {
+    }
+    if (states[current_sector] == SECTOR_STATE_AVAILABLE) {
+        // nothing was in use, or we were interrupted between marking
+        // the sectors in switch_sectors(). Mark this one in use
+        // before writing to it, so the data is found if we are
+        // interrupted again
+        struct sector_header &h = header[current_sector];
+        h.set_state(SECTOR_STATE_IN_USE);
+        if (!flash_write(current_sector, 0, (const uint8_t *)&h, sizeof(h))) {
+            return false;
+        }
+        write_offset = sizeof(struct sector_header);
+    }
+
+    // if the first sector is full then write out all data so we can erase it
+    if (states[first_sector] == SECTOR_STATE_FULL) {
+        /*
+          the reserve in the current sector only covers the data not
+          yet carried forward by compact_step(), so we write just the
+          data that isn't already there
+         */
+        if (!write_missing(present)) {
             return erase_all();
         }
     }
@@ -128,6 +167,8 @@ bool AP_FlashStorage::init(void)
     }
 
     reserved_space = 0;
+    other_sector_full = false;
+    compact_offset = storage_size;
     
     // ready to use
     return true;
@@ -160,19 +201,85 @@ bool AP_FlashStorage::protected_switch_full_sector(void)
 {
     // clear any write error
     write_error = false;
-    reserved_space = 0;
-    
-    if (!write_all()) {
-        return false;
+
+    // carry forward whatever compact_step() hasn't yet
+    while (compact_offset < storage_size) {
+        if (!compact_chunk()) {
+            return false;
+        }
     }
 
     if (!erase_sector(current_sector ^ 1, true)) {
         return false;
     }
+    other_sector_full = false;
 
     return switch_sectors();
 }
 
+/*
+  space needed to carry forward the data from compact_offset onwards,
+  with one block header per chunk
+ */
+uint32_t AP_FlashStorage::compact_reserve(void) const
+{
+    if (compact_offset >= storage_size) {
+        return 0;
+    }
+    return ((storage_size - compact_offset) / max_write) * (sizeof(block_header) + max_write) + max_write;
+}
+
+/*
+  carry forward one chunk of data into the current sector. Chunks
+  that are all zero are skipped as in write_all(). The chunk is
+  written from the reserved space, which shrinks as we go
+ */
+bool AP_FlashStorage::compact_chunk(void)
+{
+    // local variable needed to overcome problem with MIN() macro and -O0
+    const uint8_t max_write_local = max_write;
+    const uint8_t n = MIN(max_write_local, storage_size-compact_offset);
+    if (!all_zero(compact_offset, n)) {
+        in_compact = true;
+        const bool ok = write(compact_offset, n);
+        in_compact = false;
+        if (!ok) {
+            return false;
+        }
+    }
+    compact_offset += n;
+    reserved_space = compact_reserve();
+    return true;
+}
+
+/*
+  carry forward the next few chunks of data from the full sector
+ */
+void AP_FlashStorage::compact_step(void)
+{
+    for (uint8_t i=0; i<AP_FLASHSTORAGE_COMPACT_CHUNKS && compact_offset < storage_size; i++) {
+        if (!compact_chunk()) {
+            break;
+        }
+    }
+}
+
+/*
+  erase the full sector once all its data is in the current
+  sector. This stalls the CPU, so is only done when erase is allowed
+ */
+bool AP_FlashStorage::erase_full_sector(void)
+{
+    if (!erase_due() || !flash_erase_ok()) {
+        return false;
+    }
+    if (!erase_sector(current_sector ^ 1, true)) {
+        return false;
+    }
+    other_sector_full = false;
+    return true;
+}
+
 // write some data to virtual EEPROM
 bool AP_FlashStorage::write(uint16_t offset, uint16_t length)
 {
@@ -190,8 +297,14 @@ bool AP_FlashStorage::write(uint16_t offset, uint16_t length)
 #endif
 
         const uint32_t space_available = flash_sector_size - write_offset;
-        const uint32_t space_required = sizeof(struct block_header) + max_write + reserved_space;
+        // data being carried forward is written into the reserved space
+        const uint32_t space_required = in_compact ? reserved_space : sizeof(struct block_header) + max_write + reserved_space;
         if (space_available < space_required) {
+            if (in_compact) {
+                // the reserve should always allow for this
+                write_error = true;
+                return false;
+            }
             if (!switch_sectors()) {
                 if (!flash_erase_ok()) {
                     return false;
@@ -261,7 +374,7 @@ bool AP_FlashStorage::write(uint16_t offset, uint16_t length)
 /*
   load all data from a flash sector into mem_buffer
  */
-bool AP_FlashStorage::load_sector(uint8_t sector)
+bool AP_FlashStorage::load_sector(uint8_t sector, Bitmask<num_blocks> *loaded)
 {
     uint32_t ofs = sizeof(sector_header);
     while (ofs < flash_sector_size - sizeof(struct block_header)) {
@@ -302,6 +415,11 @@ bool AP_FlashStorage::load_sector(uint8_t sector)
             if (!flash_read(sector, ofs+sizeof(header), &mem_buffer[block_ofs], block_nbytes)) {
                 return false;
             }
+            if (loaded != nullptr) {
+                for (uint8_t b=0; b<=header.num_blocks_minus_one; b++) {
+                    loaded->set(header.block_num + b);
+                }
+            }
             //debug("read at %u for %u\n", block_ofs, block_nbytes);
             ofs += block_nbytes + sizeof(header);
             break;
@@ -344,19 +462,30 @@ bool AP_FlashStorage::erase_sector(uint8_t sector, bool mark_available)
 bool AP_FlashStorage::erase_all(void)
 {
     write_error = false;
+    reserved_space = 0;
+    other_sector_full = false;
+    compact_offset = storage_size;
 
+    // erase an in-use sector first and keep it as the current
+    // sector. An interrupted erase then never leaves a bad sector
+    // beside an in-use one, which init() takes to hold all the data
+    struct sector_header header;
     current_sector = 0;
+    if (flash_read(1, 0, (uint8_t *)&header, sizeof(header)) &&
+        header.signature_ok() &&
+        header.get_state() == SECTOR_STATE_IN_USE) {
+        current_sector = 1;
+    }
     write_offset = sizeof(struct sector_header);
     
-    if (!erase_sector(0, current_sector!=0)) {
+    if (!erase_sector(current_sector, false)) {
         return false;
     }
-    if (!erase_sector(1, current_sector!=1)) {
+    if (!erase_sector(current_sector^1, true)) {
         return false;
     }
     
     // mark current sector as in-use
-    struct sector_header header;
     header.set_state(SECTOR_STATE_IN_USE);
     return flash_write(current_sector, 0, (const uint8_t *)&header, sizeof(header));    
 }
@@ -381,6 +510,32 @@ bool AP_FlashStorage::write_all()
     return true;
 }
 
+/*
+  write the chunks of mem_buffer that have blocks not present in the
+  current sector. Chunks that are all zero are skipped as in write_all()
+ */
+bool AP_FlashStorage::write_missing(const Bitmask<num_blocks> &present)
+{
+    for (uint16_t ofs=0; ofs<storage_size; ofs += max_write) {
+        // local variable needed to overcome problem with MIN() macro and -O0
+        const uint8_t max_write_local = max_write;
+        uint8_t n = MIN(max_write_local, storage_size-ofs);
+        bool missing = false;
+        for (uint16_t b=ofs/block_size; b<=(ofs+n-1)/block_size; b++) {
+            if (!present.get(b)) {
+                missing = true;
+                break;
+            }
+        }
+        if (missing && !all_zero(ofs, n)) {
+            if (!write(ofs, n)) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
 // return true if all bytes are zero
 bool AP_FlashStorage::all_zero(uint16_t ofs, uint16_t size)
 {
@@ -395,7 +550,7 @@ bool AP_FlashStorage::all_zero(uint16_t ofs, uint16_t size)
 // switch to next sector for writing
 bool AP_FlashStorage::switch_sectors(void)
 {
-    if (reserved_space != 0) {
+    if (other_sector_full) {
         // other sector is already full
         debug("both sectors are full\n");
         return false;
@@ -438,9 +593,12 @@ bool AP_FlashStorage::switch_sectors(void)
     // switch sectors
     current_sector = new_sector;
         
-    // we need to reserve some space in next sector to ensure we can successfully do a
-    // full write out on init()
-    reserved_space = reserve_size;
+    // we need to reserve some space in next sector to ensure we can
+    // carry forward all of the data from the full sector. That is
+    // done a little at a time by compact_step()
+    other_sector_full = true;
+    compact_offset = 0;
+    reserved_space = compact_reserve();
     
     write_offset = sizeof(header);
     return true;    
@@ -34,10 +34,21 @@
     128k flash sectors with 16k storage size.
 
   - assumes two flash sectors are available
+
+  - after a sector switch the data left in the full sector is carried
+    forward into the new sector a few blocks at a time by
+    compact_step(), so the full sector can later be erased without a
+    long write of all the data
  */
 #pragma once
 
 #include <AP_HAL/AP_HAL.h>
+#include <AP_Common/Bitmask.h>
+
+// number of max_write chunks carried forward by each compact_step()
+#ifndef AP_FLASHSTORAGE_COMPACT_CHUNKS
+#define AP_FLASHSTORAGE_COMPACT_CHUNKS 2
+#endif
 
 /*
   we support 3 different types of flash which have different restrictions
@@ -127,6 +138,23 @@ public:
     // offline for considerable periods as an erase will be needed
     bool switch_full_sector(void) WARN_IF_UNUSED;
 
+    // carry forward the next few blocks of data from the full sector
+    // into the current sector. Call regularly, it does nothing once
+    // all data is in the current sector. A failed write is retried
+    // on the next call
+    void compact_step(void);
+
+    // return true if the full sector holds no data that isn't also
+    // in the current sector, so it can be erased with
+    // erase_full_sector() at a safe time
+    bool erase_due(void) const {
+        return other_sector_full && compact_offset >= storage_size;
+    }
+
+    // erase the full sector once erase_due() is true, so the next
+    // sector switch needs no erase
+    bool erase_full_sector(void) WARN_IF_UNUSED;
+
     // write some data to storage from mem_buffer
     bool write(uint16_t offset, uint16_t length) WARN_IF_UNUSED;
 
@@ -146,6 +174,12 @@ private:
     uint32_t reserved_space;
     bool write_error;
 
+    // true if the other sector is full, and the storage offset of the
+    // next data to carry forward from it
+    bool other_sector_full;
+    uint16_t compact_offset = storage_size;
+    bool in_compact;
+
     // 24 bit signature
 #if AP_FLASHSTORAGE_TYPE == AP_FLASHSTORAGE_TYPE_F4
     static const uint32_t signature = 0x51685B;
@@ -214,11 +248,8 @@ private:
         uint16_t num_blocks_minus_one:3;
     };
 
-    // amount of space needed to write full storage
-    static const uint32_t reserve_size = (storage_size / max_write) * (sizeof(block_header) + max_write) + max_write;
-        
-    // load data from a sector
-    bool load_sector(uint8_t sector) WARN_IF_UNUSED;
+    // load data from a sector, optionally noting the blocks it holds
+    bool load_sector(uint8_t sector, Bitmask<num_blocks> *loaded=nullptr) WARN_IF_UNUSED;
 
     // erase a sector and write header
     bool erase_sector(uint8_t sector, bool mark_available) WARN_IF_UNUSED;
@@ -229,12 +260,21 @@ private:
     // write all of mem_buffer to current sector
     bool write_all() WARN_IF_UNUSED;
 
+    // write the parts of mem_buffer not held in the current sector
+    bool write_missing(const Bitmask<num_blocks> &present) WARN_IF_UNUSED;
+
     // return true if all bytes are zero
     bool all_zero(uint16_t ofs, uint16_t size) WARN_IF_UNUSED;
 
     // switch to next sector for writing
     bool switch_sectors(void) WARN_IF_UNUSED;
 
+    // carry forward one chunk of data into the current sector
+    bool compact_chunk(void) WARN_IF_UNUSED;
+
+    // space to reserve for carrying forward the rest of the data
+    uint32_t compact_reserve(void) const;
+
     // _switch_full_sector is protected by switch_full_sector to avoid
     // an infinite recursion problem; switch_full_sectory calls
     // write() which can call switch_full_sector.  This has been seen
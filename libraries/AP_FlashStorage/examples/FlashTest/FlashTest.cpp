@@ -159,6 +159,15 @@ void FlashTest::loop(void)
         erase_ok = (i % 1000 == 0);
         write(ofs, data, length);
 
+        // carry data forward a little at a time, and erase the full
+        // sector early when allowed
+        storage.compact_step();
+        if (erase_ok && storage.erase_due()) {
+            if (!storage.erase_full_sector()) {
+                AP_HAL::panic("Failed erase_full_sector()");
+            }
+        }
+
         if (erase_ok) {
             if (memcmp(mem_buffer, mem_mirror, sizeof(mem_buffer)) != 0) {
                 AP_HAL::panic("FATAL: data mis-match at i=%u", (unsigned)i);
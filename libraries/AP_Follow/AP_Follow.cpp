@@ -35,6 +35,12 @@ extern const AP_HAL::HAL& hal;
 
 #define AP_FOLLOW_POS_P_DEFAULT 0.1f    // position error gain default
 
+#define AP_FOLLOW_ACCEL_HORIZON_S   1.0f    // acceleration is only projected forward this far
+#define AP_FOLLOW_ACCEL_MAX         20.0f   // estimated acceleration limit in m/s/s
+#define AP_FOLLOW_ACCEL_FILT        0.3f    // weight of each new acceleration estimate
+#define AP_FOLLOW_ACCEL_DT_MIN_MS   20      // reports closer than this don't give an acceleration estimate
+#define AP_FOLLOW_ACCEL_DT_MAX_MS   2000    // reports further apart than this don't either
+
 #if APM_BUILD_TYPE(APM_BUILD_ArduPlane)
 #define AP_FOLLOW_ALT_TYPE_DEFAULT 0
 #else
@@ -170,18 +176,8 @@ bool AP_Follow::get_target_location_and_velocity(Location &loc, Vector3f &vel_ne
     // calculate time since last actual position update
     const float dt = (AP_HAL::millis() - _last_location_update_ms) * 0.001f;
 
-    // get velocity estimate
-    if (!get_velocity_ned(vel_ned, dt)) {
-        return false;
-    }
-
     // project the vehicle position
-    Location last_loc = _target_location;
-    last_loc.offset(vel_ned.x * dt, vel_ned.y * dt);
-    last_loc.alt -= vel_ned.z * 100.0f * dt; // convert m/s to cm/s, multiply by dt.  minus because NED
-
-    // return latest position estimate
-    loc = last_loc;
+    predict(_target_location, _target_velocity_ned, _target_accel_ned, dt, loc, vel_ned);
     return true;
 }
 
@@ -261,7 +257,7 @@ bool AP_Follow::get_target_heading_deg(float &heading) const
     return true;
 }
 
-// handle mavlink DISTANCE_SENSOR messages
+// handle mavlink messages which may hold a vehicle's position
 void AP_Follow::handle_msg(const mavlink_message_t &msg)
 {
     // exit immediately if not enabled
@@ -274,19 +270,92 @@ void AP_Follow::handle_msg(const mavlink_message_t &msg)
         return;
     }
 
-    // skip message if not from our target
-    if (_sysid != 0 && msg.sysid != _sysid) {
-        if (_automatic_sysid) {
-            // maybe timeout who we were following...
-            if ((_last_location_update_ms == 0) || (AP_HAL::millis() - _last_location_update_ms > AP_FOLLOW_SYSID_TIMEOUT_MS)) {
-                _sysid.set(0);
-            }
+    const bool from_target = (_sysid == 0 || msg.sysid == _sysid);
+    if (!from_target && _automatic_sysid) {
+        // maybe timeout who we were following...
+        if ((_last_location_update_ms == 0) || (AP_HAL::millis() - _last_location_update_ms > AP_FOLLOW_SYSID_TIMEOUT_MS)) {
+            _sysid.set(0);
         }
+    }
+
+    Report report;
+    if (!decode_report(msg, report)) {
         return;
     }
 
-    // decode global-position-int message
-    bool updated = false;
+    // every vehicle's position goes in the neighbour table
+    const Neighbour *n = update_neighbour(msg.sysid, report);
+
+    // skip message if not from our target
+    if (!from_target) {
+        return;
+    }
+
+    _target_location = report.loc;
+    _target_velocity_ned = report.vel_ned;
+    if (n != nullptr) {
+        _target_accel_ned = n->accel_ned;
+    } else {
+        _target_accel_ned.zero();
+    }
+
+    // get a local timestamp with correction for transport jitter
+    _last_location_update_ms = _jitter.correct_offboard_timestamp_msec(report.timestamp_ms, AP_HAL::millis());
+    if (report.have_heading) {
+        _target_heading = report.heading_deg;
+        _last_heading_update_ms = _last_location_update_ms;
+    }
+
+    // initialise _sysid if zero to sender's id
+    if (_sysid == 0) {
+        _sysid.set(msg.sysid);
+        _automatic_sysid = true;
+    }
+
+    // get estimated location and velocity
+    Location loc_estimate{};
+    Vector3f vel_estimate;
+    UNUSED_RESULT(get_target_location_and_velocity(loc_estimate, vel_estimate));
+
+    // log lead's estimated vs reported position
+// @LoggerMessage: FOLL
+// @Description: Follow library diagnostic data
+// @Field: TimeUS: Time since system startup
+// @Field: Lat: Target latitude
+// @Field: Lon: Target longitude
+// @Field: Alt: Target absolute altitude
+// @Field: VelN: Target earth-frame velocity, North
+// @Field: VelE: Target earth-frame velocity, East
+// @Field: VelD: Target earth-frame velocity, Down
+// @Field: LatE: Vehicle latitude
+// @Field: LonE: Vehicle longitude
+// @Field: AltE: Vehicle absolute altitude
+    AP::logger().WriteStreaming("FOLL",
+                                           "TimeUS,Lat,Lon,Alt,VelN,VelE,VelD,LatE,LonE,AltE",  // labels
+                                           "sDUmnnnDUm",    // units
+                                           "F--B000--B",    // mults
+                                           "QLLifffLLi",    // fmt
+                                           AP_HAL::micros64(),
+                                           _target_location.lat,
+                                           _target_location.lng,
+                                           _target_location.alt,
+                                           (double)_target_velocity_ned.x,
+                                           (double)_target_velocity_ned.y,
+                                           (double)_target_velocity_ned.z,
+                                           loc_estimate.lat,
+                                           loc_estimate.lng,
+                                           loc_estimate.alt
+                                           );
+}
+
+/*
+  decode a GLOBAL_POSITION_INT or FOLLOW_TARGET message, returning
+  false if it doesn't hold a position
+ */
+bool AP_Follow::decode_report(const mavlink_message_t &msg, Report &report) const
+{
+    report.have_accel = false;
+    report.have_heading = false;
 
     switch (msg.msgid) {
     case MAVLINK_MSG_ID_GLOBAL_POSITION_INT: {
@@ -296,38 +365,31 @@ void AP_Follow::handle_msg(const mavlink_message_t &msg)
 
         // ignore message if lat and lon are (exactly) zero
         if ((packet.lat == 0 && packet.lon == 0)) {
-            return;
+            return false;
         }
 
-        _target_location.lat = packet.lat;
-        _target_location.lng = packet.lon;
+        report.loc.lat = packet.lat;
+        report.loc.lng = packet.lon;
 
         // select altitude source based on FOLL_ALT_TYPE param 
         if (_alt_type == AP_FOLLOW_ALTITUDE_TYPE_RELATIVE) {
             // above home alt
-            _target_location.set_alt_cm(packet.relative_alt / 10, Location::AltFrame::ABOVE_HOME);
+            report.loc.set_alt_cm(packet.relative_alt / 10, Location::AltFrame::ABOVE_HOME);
         } else {
             // absolute altitude
-            _target_location.set_alt_cm(packet.alt / 10, Location::AltFrame::ABSOLUTE);
+            report.loc.set_alt_cm(packet.alt / 10, Location::AltFrame::ABSOLUTE);
         }
 
-        _target_velocity_ned.x = packet.vx * 0.01f; // velocity north
-        _target_velocity_ned.y = packet.vy * 0.01f; // velocity east
-        _target_velocity_ned.z = packet.vz * 0.01f; // velocity down
+        report.vel_ned.x = packet.vx * 0.01f; // velocity north
+        report.vel_ned.y = packet.vy * 0.01f; // velocity east
+        report.vel_ned.z = packet.vz * 0.01f; // velocity down
 
-        // get a local timestamp with correction for transport jitter
-        _last_location_update_ms = _jitter.correct_offboard_timestamp_msec(packet.time_boot_ms, AP_HAL::millis());
+        report.timestamp_ms = packet.time_boot_ms;
         if (packet.hdg <= 36000) {                  // heading (UINT16_MAX if unknown)
-            _target_heading = packet.hdg * 0.01f;   // convert centi-degrees to degrees
-            _last_heading_update_ms = _last_location_update_ms;
-        }
-        // initialise _sysid if zero to sender's id
-        if (_sysid == 0) {
-            _sysid.set(msg.sysid);
-            _automatic_sysid = true;
+            report.heading_deg = packet.hdg * 0.01f;   // convert centi-degrees to degrees
+            report.have_heading = true;
         }
-        updated = true;
-        break;
+        return true;
     }
     case MAVLINK_MSG_ID_FOLLOW_TARGET: {
         // decode message
@@ -336,100 +398,220 @@ void AP_Follow::handle_msg(const mavlink_message_t &msg)
 
         // ignore message if lat and lon are (exactly) zero
         if ((packet.lat == 0 && packet.lon == 0)) {
-            return;
+            return false;
         }
         // require at least position
         if ((packet.est_capabilities & (1<<0)) == 0) {
-            return;
+            return false;
         }
 
-        Location new_loc = _target_location;
-        new_loc.lat = packet.lat;
-        new_loc.lng = packet.lon;
-        new_loc.set_alt_cm(packet.alt*100, Location::AltFrame::ABSOLUTE);
+        report.loc.lat = packet.lat;
+        report.loc.lng = packet.lon;
+        report.loc.set_alt_cm(packet.alt*100, Location::AltFrame::ABSOLUTE);
 
         // FOLLOW_TARGET is always AMSL, change the provided alt to
         // above home if we are configured for relative alt
         if (_alt_type == AP_FOLLOW_ALTITUDE_TYPE_RELATIVE &&
-            !new_loc.change_alt_frame(Location::AltFrame::ABOVE_HOME)) {
-            return;
+            !report.loc.change_alt_frame(Location::AltFrame::ABOVE_HOME)) {
+            return false;
         }
-        _target_location = new_loc;
 
         if (packet.est_capabilities & (1<<1)) {
-            _target_velocity_ned.x = packet.vel[0]; // velocity north
-            _target_velocity_ned.y = packet.vel[1]; // velocity east
-            _target_velocity_ned.z = packet.vel[2]; // velocity down
+            report.vel_ned.x = packet.vel[0]; // velocity north
+            report.vel_ned.y = packet.vel[1]; // velocity east
+            report.vel_ned.z = packet.vel[2]; // velocity down
         } else {
-            _target_velocity_ned.zero();
+            report.vel_ned.zero();
+        }
+
+        if (packet.est_capabilities & (1<<2)) {
+            report.accel_ned = Vector3f{packet.acc[0], packet.acc[1], packet.acc[2]};
+            report.have_accel = true;
         }
 
-        // get a local timestamp with correction for transport jitter
-        _last_location_update_ms = _jitter.correct_offboard_timestamp_msec(packet.timestamp, AP_HAL::millis());
+        // the sender's time since boot
+        report.timestamp_ms = packet.timestamp;
 
         if (packet.est_capabilities & (1<<3)) {
             Quaternion q{packet.attitude_q[0], packet.attitude_q[1], packet.attitude_q[2], packet.attitude_q[3]};
             float r, p, y;
             q.to_euler(r,p,y);
-            _target_heading = degrees(y);
-            _last_heading_update_ms = _last_location_update_ms;
+            report.heading_deg = degrees(y);
+            report.have_heading = true;
         }
+        return true;
+    }
+    }
+    return false;
+}
 
-        // initialise _sysid if zero to sender's id
-        if (_sysid == 0) {
-            _sysid.set(msg.sysid);
-            _automatic_sysid = true;
+/*
+  update a vehicle's entry in the neighbour table from its report,
+  returning nullptr if the report is older than the one we have
+ */
+const AP_Follow::Neighbour *AP_Follow::update_neighbour(uint8_t sysid, const Report &report)
+{
+    Neighbour *n;
+    if (_neighbour_index[sysid] != 0) {
+        n = &_neighbours[_neighbour_index[sysid]-1];
+    } else {
+        // take an unused entry, or the one heard from least recently
+        const uint32_t now_ms = AP_HAL::millis();
+        uint8_t idx = 0;
+        for (uint8_t i=0; i<ARRAY_SIZE(_neighbours); i++) {
+            if (_neighbours[i].update_ms == 0) {
+                idx = i;
+                break;
+            }
+            if (now_ms - _neighbours[i].update_ms > now_ms - _neighbours[idx].update_ms) {
+                idx = i;
+            }
+        }
+        n = &_neighbours[idx];
+        if (_neighbour_index[n->sysid] == idx+1) {
+            _neighbour_index[n->sysid] = 0;
         }
-        updated = true;
-        break;
+        n->sysid = sysid;
+        n->update_ms = 0;
+        n->accel_ned.zero();
+        n->jitter.reset();
+        _neighbour_index[sysid] = idx+1;
     }
+
+    // the time the report was made, which includes the transport lag
+    const uint32_t update_ms = MAX(n->jitter.correct_offboard_timestamp_msec(report.timestamp_ms, AP_HAL::millis()), 1U);
+    const uint32_t dt_ms = update_ms - n->update_ms;
+    if (n->update_ms != 0 && int32_t(dt_ms) <= 0) {
+        // out of order
+        return nullptr;
     }
-    
-    if (updated) {
-        // get estimated location and velocity
-        Location loc_estimate{};
-        Vector3f vel_estimate;
-        UNUSED_RESULT(get_target_location_and_velocity(loc_estimate, vel_estimate));
 
-        // log lead's estimated vs reported position
-// @LoggerMessage: FOLL
-// @Description: Follow library diagnostic data
-// @Field: TimeUS: Time since system startup
-// @Field: Lat: Target latitude
-// @Field: Lon: Target longitude
-// @Field: Alt: Target absolute altitude
-// @Field: VelN: Target earth-frame velocity, North
-// @Field: VelE: Target earth-frame velocity, East
-// @Field: VelD: Target earth-frame velocity, Down
-// @Field: LatE: Vehicle latitude
-// @Field: LonE: Vehicle longitude
-// @Field: AltE: Vehicle absolute altitude
-        AP::logger().WriteStreaming("FOLL",
-                                               "TimeUS,Lat,Lon,Alt,VelN,VelE,VelD,LatE,LonE,AltE",  // labels
-                                               "sDUmnnnDUm",    // units
-                                               "F--B000--B",    // mults
-                                               "QLLifffLLi",    // fmt
-                                               AP_HAL::micros64(),
-                                               _target_location.lat,
-                                               _target_location.lng,
-                                               _target_location.alt,
-                                               (double)_target_velocity_ned.x,
-                                               (double)_target_velocity_ned.y,
-                                               (double)_target_velocity_ned.z,
-                                               loc_estimate.lat,
-                                               loc_estimate.lng,
-                                               loc_estimate.alt
-                                               );
+    if (report.have_accel) {
+        n->accel_ned = report.accel_ned;
+    } else if (n->update_ms != 0 &&
+               dt_ms >= AP_FOLLOW_ACCEL_DT_MIN_MS &&
+               dt_ms <= AP_FOLLOW_ACCEL_DT_MAX_MS) {
+        // filter the noise from velocity resolution and report timing
+        const Vector3f accel = (report.vel_ned - n->vel_ned) / (dt_ms * 0.001f);
+        n->accel_ned += (accel - n->accel_ned) * AP_FOLLOW_ACCEL_FILT;
+        const float accel_len = n->accel_ned.length();
+        if (accel_len > AP_FOLLOW_ACCEL_MAX) {
+            n->accel_ned *= AP_FOLLOW_ACCEL_MAX / accel_len;
+        }
+    } else {
+        n->accel_ned.zero();
+    }
+
+    n->update_ms = update_ms;
+    n->loc = report.loc;
+    n->vel_ned = report.vel_ned;
+    return n;
+}
+
+// find a vehicle in the neighbour table
+const AP_Follow::Neighbour *AP_Follow::find_neighbour(uint8_t sysid) const
+{
+    if (_neighbour_index[sysid] == 0) {
+        return nullptr;
+    }
+    return &_neighbours[_neighbour_index[sysid]-1];
+}
+
+/*
+  project a location and velocity forward by dt seconds, with the
+  acceleration held for at most AP_FOLLOW_ACCEL_HORIZON_S
+ */
+void AP_Follow::predict(const Location &loc, const Vector3f &vel_ned, const Vector3f &accel_ned, float dt,
+                        Location &pred_loc, Vector3f &pred_vel_ned) const
+{
+    const float dt_accel = MIN(dt, AP_FOLLOW_ACCEL_HORIZON_S);
+    pred_vel_ned = vel_ned + accel_ned * dt_accel;
+    const Vector3f dist = vel_ned * dt + accel_ned * (dt_accel * (dt - 0.5f * dt_accel));
+
+    pred_loc = loc;
+    pred_loc.offset(dist.x, dist.y);
+    pred_loc.alt -= dist.z * 100.0f; // convert m to cm.  minus because NED
+}
+
+// predict a neighbour's location and velocity at the current time
+bool AP_Follow::predict_neighbour(const Neighbour &n, Location &loc, Vector3f &vel_ned) const
+{
+    const uint32_t age_ms = AP_HAL::millis() - n.update_ms;
+    if (n.update_ms == 0 || age_ms > AP_FOLLOW_TIMEOUT_MS) {
+        return false;
     }
+    predict(n.loc, n.vel_ned, n.accel_ned, age_ms * 0.001f, loc, vel_ned);
+    return true;
+}
+
+// get a neighbour's predicted location and velocity (in NED) now
+bool AP_Follow::get_neighbour_location_and_velocity(uint8_t sysid, Location &loc, Vector3f &vel_ned) const
+{
+    if (!_enabled) {
+        return false;
+    }
+    const Neighbour *n = find_neighbour(sysid);
+    return n != nullptr && predict_neighbour(*n, loc, vel_ned);
 }
 
-// get velocity estimate in m/s in NED frame using dt since last update
-bool AP_Follow::get_velocity_ned(Vector3f &vel_ned, float dt) const
+/*
+  get the mean predicted location and velocity (in NED) of the
+  neighbours heard from recently, with offsets added. This is the
+  formation's reference point when there is no single lead vehicle
+ */
+bool AP_Follow::get_neighbours_centroid_ofs(Location &loc, Vector3f &vel_ned) const
 {
-    vel_ned = _target_velocity_ned + (_target_accel_ned * dt);
+    if (!_enabled) {
+        return false;
+    }
+
+    Location origin;
+    Vector3f dist_sum;
+    Vector3f vel_sum;
+    uint8_t count = 0;
+    for (const auto &n : _neighbours) {
+        Location n_loc;
+        Vector3f n_vel;
+        if (!predict_neighbour(n, n_loc, n_vel)) {
+            continue;
+        }
+        if (count == 0) {
+            origin = n_loc;
+        } else {
+            dist_sum += origin.get_distance_NED(n_loc);
+        }
+        vel_sum += n_vel;
+        count++;
+    }
+    if (count == 0) {
+        return false;
+    }
+
+    Vector3f ofs;
+    if (!get_offsets_ned(ofs)) {
+        return false;
+    }
+    const Vector3f dist = dist_sum / count + ofs;
+    loc = origin;
+    loc.offset(dist.x, dist.y);
+    loc.alt -= dist.z * 100;
+    vel_ned = vel_sum / count;
     return true;
 }
 
+// number of neighbours heard from recently
+uint8_t AP_Follow::get_neighbour_count() const
+{
+    const uint32_t now_ms = AP_HAL::millis();
+    uint8_t count = 0;
+    for (const auto &n : _neighbours) {
+        if (n.update_ms != 0 && now_ms - n.update_ms <= AP_FOLLOW_TIMEOUT_MS) {
+            count++;
+        }
+    }
+    return count;
+}
+
 // initialise offsets to provided distance vector to other vehicle (in meters in NED frame) if required
 void AP_Follow::init_offsets_if_required(const Vector3f &dist_vec_ned)
 {
@@ -23,6 +23,15 @@
 #include <AC_PID/AC_P.h>
 #include <AP_RTC/JitterCorrection.h>
 
+// number of other vehicles whose positions are tracked
+#ifndef AP_FOLLOW_NEIGHBOURS_MAX
+#if HAL_MEM_CLASS >= HAL_MEM_CLASS_500
+#define AP_FOLLOW_NEIGHBOURS_MAX 32
+#else
+#define AP_FOLLOW_NEIGHBOURS_MAX 8
+#endif
+#endif
+
 class AP_Follow
 {
 
@@ -98,14 +107,29 @@ public:
     // get system time of last position update
     uint32_t get_last_update_ms() const { return _last_location_update_ms; }
 
+    //
+    // neighbour (other vehicle) tracking methods
+    //
+
+    // get a neighbour's predicted location and velocity (in NED) now
+    bool get_neighbour_location_and_velocity(uint8_t sysid, Location &loc, Vector3f &vel_ned) const;
+
+    // get the mean predicted location and velocity (in NED) of the
+    // neighbours heard from recently, with offsets added
+    bool get_neighbours_centroid_ofs(Location &loc, Vector3f &vel_ned) const;
+
+    // number of neighbours heard from recently
+    uint8_t get_neighbour_count() const;
+
     // parameter list
     static const struct AP_Param::GroupInfo var_info[];
 
 private:
     static AP_Follow *_singleton;
 
-    // get velocity estimate in m/s in NED frame using dt since last update
-    bool get_velocity_ned(Vector3f &vel_ned, float dt) const;
+    // project a location and velocity (in NED) forward by dt seconds
+    void predict(const Location &loc, const Vector3f &vel_ned, const Vector3f &accel_ned, float dt,
+                 Location &pred_loc, Vector3f &pred_vel_ned) const;
 
     // initialise offsets to provided distance vector to other vehicle (in meters in NED frame) if required
     void init_offsets_if_required(const Vector3f &dist_vec_ned);
@@ -119,6 +143,38 @@ private:
     // set recorded distance and bearing to target to zero
     void clear_dist_and_bearing_to_target();
 
+    // a vehicle's position report, in the time of the sender
+    struct Report {
+        Location loc;
+        Vector3f vel_ned;
+        Vector3f accel_ned;
+        bool have_accel;
+        float heading_deg;
+        bool have_heading;
+        uint32_t timestamp_ms;
+    };
+    bool decode_report(const mavlink_message_t &msg, Report &report) const;
+
+    // the latest report from another vehicle, with its time corrected
+    // to local time. Entries are found by sysid through
+    // _neighbour_index
+    struct Neighbour {
+        uint8_t sysid;
+        uint32_t update_ms;         // local time the report was made, 0 if unused
+        Location loc;
+        Vector3f vel_ned;
+        Vector3f accel_ned;         // reported, or estimated from successive velocities
+        JitterCorrection jitter{3000};
+    } _neighbours[AP_FOLLOW_NEIGHBOURS_MAX];
+    uint8_t _neighbour_index[256];  // one more than the entry for each sysid, 0 if none
+
+    // update the neighbour table from a report, returning the entry
+    const Neighbour *update_neighbour(uint8_t sysid, const Report &report);
+    const Neighbour *find_neighbour(uint8_t sysid) const;
+
+    // predict a neighbour's location and velocity at the current time
+    bool predict_neighbour(const Neighbour &n, Location &loc, Vector3f &vel_ned) const;
+
     // parameters
     AP_Int8     _enabled;           // 1 if this subsystem is enabled
     AP_Int16    _sysid;             // target's mavlink system id (0 to use first sysid seen)
@@ -61,6 +61,8 @@
 #define BLEND_MASK_USE_HPOS_ACC     1
 #define BLEND_MASK_USE_VPOS_ACC     2
 #define BLEND_MASK_USE_SPD_ACC      4
+#define BLEND_MASK_TIME_ALIGN       8
+#define BLEND_ALIGN_MAX_SEC         0.5f // don't extrapolate solutions further apart than this
 #define BLEND_COUNTER_FAILURE_INCREMENT 10
 
 #ifndef HAL_GPS_COM_PORT_DEFAULT
@@ -297,8 +299,8 @@ const AP_Param::GroupInfo AP_GPS::var_info[] = {
 #if defined(GPS_BLENDED_INSTANCE)
     // @Param: _BLEND_MASK
     // @DisplayName: Multi GPS Blending Mask
-    // @Description: Determines which of the accuracy measures Horizontal position, Vertical Position and Speed are used to calculate the weighting on each GPS receiver when soft switching has been selected by setting GPS_AUTO_SWITCH to 2(Blend)
-    // @Bitmask: 0:Horiz Pos,1:Vert Pos,2:Speed
+    // @Description: Determines which of the accuracy measures Horizontal position, Vertical Position and Speed are used to calculate the weighting on each GPS receiver when soft switching has been selected by setting GPS_AUTO_SWITCH to 2(Blend). Time Align moves each receiver's position forward along its velocity to the measurement epoch of the highest weighted receiver before blending, which reduces jitter when blending receivers with different lags or update rates
+    // @Bitmask: 0:Horiz Pos,1:Vert Pos,2:Speed,3:Time Align
     // @User: Advanced
     AP_GROUPINFO("_BLEND_MASK", 20, AP_GPS, _blend_mask, 5),
 
@@ -410,6 +412,7 @@ AP_GPS::AP_GPS()
         AP_HAL::panic("AP_GPS must be singleton");
     }
     _singleton = this;
+    rsem.set_name("GPS");
 }
 
 // return true if a specific type of GPS uses a UART
@@ -1509,7 +1512,7 @@ void AP_GPS::handle_gps_rtcm_fragment(uint8_t flags, const uint8_t *data, uint8_
 {
     if ((flags & 1) == 0) {
         // it is not fragmented, pass direct
-        inject_data(data, len);
+        inject_rtcm_data(data, len);
         return;
     }
 
@@ -1573,12 +1576,85 @@ void AP_GPS::handle_gps_rtcm_fragment(uint8_t flags, const uint8_t *data, uint8_
     if (rtcm_buffer->fragment_count != 0 &&
         rtcm_buffer->fragments_received == (1U << rtcm_buffer->fragment_count) - 1) {
         // we have them all, inject
-        inject_data(rtcm_buffer->buffer, rtcm_buffer->total_length);
+        inject_rtcm_data(rtcm_buffer->buffer, rtcm_buffer->total_length);
         rtcm_buffer->fragment_count = 0;
         rtcm_buffer->fragments_received = 0;
     }
 }
 
+/*
+  return the length of the whole RTCMv3 frame at the start of data,
+  or 0 if it isn't one, is cut short or fails its CRC
+ */
+static uint16_t rtcm3_frame_length(const uint8_t *data, uint16_t len)
+{
+    if (len < 6 || data[0] != 0xD3 || (data[1] & 0xFC) != 0) {
+        return 0;
+    }
+    const uint16_t payload_len = ((data[1] & 0x03) << 8) | data[2];
+    if (payload_len + 6U > len) {
+        return 0;
+    }
+    const uint8_t *crc = &data[payload_len + 3];
+    if (crc_crc24(data, payload_len + 3) != ((uint32_t(crc[0]) << 16) | (uint32_t(crc[1]) << 8) | crc[2])) {
+        return 0;
+    }
+    return payload_len + 6;
+}
+
+/*
+  check if a RTCMv3 frame has been injected recently, and remember it
+  if not. Entries are not refreshed on a match, so static messages
+  such as 1005 that repeat unchanged are still injected once per
+  window
+ */
+bool AP_GPS::rtcm_seen_recently(const uint8_t *frame, uint16_t len, uint32_t now_ms)
+{
+    const uint8_t *c = &frame[len - 3];
+    const uint32_t crc = (uint32_t(c[0]) << 16) | (uint32_t(c[1]) << 8) | c[2];
+    for (const auto &seen : rtcm_seen) {
+        if (seen.crc == crc && seen.len == len &&
+            now_ms - seen.time_ms < GPS_RTCM_DEDUP_WINDOW_MS) {
+            return true;
+        }
+    }
+    auto &slot = rtcm_seen[rtcm_seen_next];
+    slot.crc = crc;
+    slot.len = len;
+    slot.time_ms = now_ms;
+    rtcm_seen_next = (rtcm_seen_next + 1) % ARRAY_SIZE(rtcm_seen);
+    return false;
+}
+
+/*
+  inject a block of correction data from a GCS, dropping RTCMv3 frames
+  that were already injected from another telemetry link. Runs of new
+  frames are injected straight from the block. Anything that isn't a
+  sequence of whole RTCMv3 frames is passed through untouched
+ */
+void AP_GPS::inject_rtcm_data(const uint8_t *data, uint16_t len)
+{
+    const uint32_t now_ms = AP_HAL::millis();
+    uint16_t ofs = 0;
+    uint16_t run_start = 0;
+    while (ofs < len) {
+        const uint16_t frame_len = rtcm3_frame_length(&data[ofs], len - ofs);
+        if (frame_len == 0) {
+            break;
+        }
+        if (rtcm_seen_recently(&data[ofs], frame_len, now_ms)) {
+            if (ofs > run_start) {
+                inject_data(&data[run_start], ofs - run_start);
+            }
+            run_start = ofs + frame_len;
+        }
+        ofs += frame_len;
+    }
+    if (len > run_start) {
+        inject_data(&data[run_start], len - run_start);
+    }
+}
+
 /*
    re-assemble GPS_RTCM_DATA message
  */
@@ -1857,6 +1933,38 @@ bool AP_GPS::calc_blend_weights(void)
 /*
  calculate a blended GPS state
 */
+/*
+  calculate the time in seconds each receiver's latest solution must
+  be moved forward to line up with the measurement epoch of the
+  reference receiver. GPS time of week is used when both receivers
+  report it for the same week, as it is the measurement time itself,
+  otherwise the fix arrival time less the receiver lag is used
+ */
+void AP_GPS::calc_blend_alignment(uint8_t ref, float align_dt[GPS_MAX_RECEIVERS]) const
+{
+    float ref_lag_sec = 0;
+    get_lag(ref, ref_lag_sec);
+    for (uint8_t i=0; i<GPS_MAX_RECEIVERS; i++) {
+        align_dt[i] = 0;
+        if (i == ref || _blend_weights[i] <= 0.0f) {
+            continue;
+        }
+        float dt;
+        if (state[i].time_week != 0 && state[i].time_week == state[ref].time_week &&
+            state[i].time_week_ms != 0 && state[ref].time_week_ms != 0) {
+            dt = (int32_t)(state[ref].time_week_ms - state[i].time_week_ms) * 0.001f;
+        } else {
+            float lag_sec = 0;
+            get_lag(i, lag_sec);
+            dt = (int32_t)(timing[ref].last_fix_time_ms - timing[i].last_fix_time_ms) * 0.001f - (ref_lag_sec - lag_sec);
+        }
+        // don't extrapolate stale solutions
+        if (fabsf(dt) <= BLEND_ALIGN_MAX_SEC) {
+            align_dt[i] = dt;
+        }
+    }
+}
+
 void AP_GPS::calc_blended_state(void)
 {
     // initialise the blended states so we can accumulate the results using the weightings for each GPS receiver
@@ -1971,14 +2079,26 @@ void AP_GPS::calc_blended_state(void)
         }
     }
 
+    // optionally line up the other receivers with the measurement epoch of the reference
+    const bool time_aligned = (_blend_mask & BLEND_MASK_TIME_ALIGN) != 0;
+    float align_dt[GPS_MAX_RECEIVERS] {};
+    if (time_aligned) {
+        calc_blend_alignment(best_index, align_dt);
+    }
+
     // Calculate the weighted sum of horizontal and vertical position offsets relative to the reference position
     Vector2f blended_NE_offset_m;
     float blended_alt_offset_cm = 0.0f;
     blended_NE_offset_m.zero();
     for (uint8_t i=0; i<GPS_MAX_RECEIVERS; i++) {
         if (_blend_weights[i] > 0.0f && i != best_index) {
-            blended_NE_offset_m += state[GPS_BLENDED_INSTANCE].location.get_distance_NE(state[i].location) * _blend_weights[i];
-            blended_alt_offset_cm += (float)(state[i].location.alt - state[GPS_BLENDED_INSTANCE].location.alt) * _blend_weights[i];
+            Location loc = state[i].location;
+            if (!is_zero(align_dt[i])) {
+                loc.offset(state[i].velocity.x * align_dt[i], state[i].velocity.y * align_dt[i]);
+                loc.alt -= (int32_t)(state[i].velocity.z * align_dt[i] * 100.0f);
+            }
+            blended_NE_offset_m += state[GPS_BLENDED_INSTANCE].location.get_distance_NE(loc) * _blend_weights[i];
+            blended_alt_offset_cm += (float)(loc.alt - state[GPS_BLENDED_INSTANCE].location.alt) * _blend_weights[i];
         }
     }
 
@@ -2037,6 +2157,14 @@ void AP_GPS::calc_blended_state(void)
     timing[GPS_BLENDED_INSTANCE].last_fix_time_ms = (uint32_t)temp_time_1;
     timing[GPS_BLENDED_INSTANCE].last_message_time_ms = (uint32_t)temp_time_2;
 
+    if (time_aligned) {
+        // the blended position is valid at the epoch of the reference receiver
+        state[GPS_BLENDED_INSTANCE].time_week = state[best_index].time_week;
+        state[GPS_BLENDED_INSTANCE].time_week_ms = state[best_index].time_week_ms;
+        timing[GPS_BLENDED_INSTANCE].last_fix_time_ms = timing[best_index].last_fix_time_ms;
+        get_lag(best_index, _blended_lag_sec);
+    }
+
 #if HAL_LOGGING_ENABLED
     if (timing[GPS_BLENDED_INSTANCE].last_message_time_ms > last_blended_message_time_ms &&
         should_log()) {
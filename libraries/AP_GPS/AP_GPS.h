@@ -58,6 +58,11 @@
 #define GPS_MOVING_BASELINE !HAL_MINIMIZE_FEATURES && GPS_MAX_RECEIVERS>1
 #endif
 
+// RTCMv3 frames seen again within this time are not re-injected
+#ifndef GPS_RTCM_DEDUP_WINDOW_MS
+#define GPS_RTCM_DEDUP_WINDOW_MS 1000
+#endif
+
 #ifndef HAL_MSP_GPS_ENABLED
 #define HAL_MSP_GPS_ENABLED HAL_MSP_SENSORS_ENABLED
 #endif
@@ -713,6 +718,22 @@ private:
     void inject_data(const uint8_t *data, uint16_t len);
     void inject_data(uint8_t instance, const uint8_t *data, uint16_t len);
 
+    /*
+      recently injected RTCMv3 frames, identified by CRC and length,
+      so that corrections arriving over several redundant telemetry
+      links only go to the GPS once. 16 entries covers a full epoch
+      of MSM messages from each of a few links
+     */
+    struct {
+        uint32_t crc;
+        uint16_t len;
+        uint32_t time_ms;
+    } rtcm_seen[16];
+    uint8_t rtcm_seen_next;
+
+    void inject_rtcm_data(const uint8_t *data, uint16_t len);
+    bool rtcm_seen_recently(const uint8_t *frame, uint16_t len, uint32_t now_ms);
+
     // GPS blending and switching
     Vector3f _blended_antenna_offset; // blended antenna offset
     float _blended_lag_sec; // blended receiver lag in seconds
@@ -724,6 +745,9 @@ private:
     // calculate the blend weight.  Returns true if blend could be calculated, false if not
     bool calc_blend_weights(void);
 
+    // calculate the time to move each receiver forward to the epoch of the reference receiver
+    void calc_blend_alignment(uint8_t ref, float align_dt[GPS_MAX_RECEIVERS]) const;
+
     // calculate the blended state
     void calc_blended_state(void);
 
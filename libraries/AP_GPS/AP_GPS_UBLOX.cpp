@@ -588,15 +588,69 @@ AP_GPS_UBLOX::read(void)
         }
     }
 
-    const uint16_t numc = MIN(port->available(), 8192U);
-    for (uint16_t i = 0; i < numc; i++) {        // Process bytes received
-
-        // read the next byte
-        const int16_t rdata = port->read();
-        if (rdata < 0) {
+    uint32_t numc = MIN(port->available(), 8192U);
+    while (numc > 0) {
+        bool stop = false;
+        ByteBuffer::IoVec vec[2];
+        if (port->rx_peek(vec) > 0) {
+            // parse the receive buffer in place, a span at a time
+            const uint32_t used = _parse_bytes(vec[0].data, MIN(vec[0].len, numc), parsed, stop);
+            port->rx_consume(used);
+            numc -= used;
+        } else {
+            // port can't be read in place, fall back to a byte at a time
+            const int16_t rdata = port->read();
+            if (rdata < 0) {
+                break;
+            }
+            const uint8_t data = rdata;
+            _parse_bytes(&data, 1, parsed, stop);
+            numc--;
+        }
+        if (stop) {
             break;
         }
-        const uint8_t data = rdata;
+    }
+    return parsed;
+}
+
+/*
+  run the UBX parser over len received bytes, returning the number
+  consumed. Payload bytes are copied and checksummed as a block rather
+  than through the state machine one at a time. stop is set when
+  parsing must pause to let an RTCMv3 packet be forwarded
+ */
+uint32_t AP_GPS_UBLOX::_parse_bytes(const uint8_t *bytes, uint32_t len, bool &parsed, bool &stop)
+{
+    uint32_t i = 0;
+    while (i < len) {
+        bool rtcm_active = false;
+#if GPS_MOVING_BASELINE
+        rtcm_active = rtcm3_parser != nullptr;
+#endif
+        if (_step == 6 && !rtcm_active) {
+            // payload of a length validated against _buffer in step 5
+            const uint16_t n = MIN(len - i, uint32_t(_payload_length - _payload_counter));
+            uint8_t ck_a = _ck_a;
+            uint8_t ck_b = _ck_b;
+            for (uint16_t j = 0; j < n; j++) {
+                ck_b += (ck_a += bytes[i+j]);
+            }
+            _ck_a = ck_a;
+            _ck_b = ck_b;
+            memcpy(&_buffer[_payload_counter], &bytes[i], n);
+            _payload_counter += n;
+            if (_payload_counter == _payload_length) {
+                _step++;
+            }
+#if AP_GPS_DEBUG_LOGGING_ENABLED
+            log_data(&bytes[i], n);
+#endif
+            i += n;
+            continue;
+        }
+
+        const uint8_t data = bytes[i++];
 #if AP_GPS_DEBUG_LOGGING_ENABLED
         log_data(&data, 1);
 #endif
@@ -610,7 +664,8 @@ AP_GPS_UBLOX::read(void)
                 // chance to send the RTCMv3 packet to another (rover)
                 // GPS
                 _step = 0;
-                break;
+                stop = true;
+                return i;
             }
         }
 #endif
@@ -723,7 +778,7 @@ AP_GPS_UBLOX::read(void)
             break;
         }
     }
-    return parsed;
+    return i;
 }
 
 // Private Methods /////////////////////////////////////////////////////////////
@@ -770,6 +770,7 @@ private:
 
     // Buffer parse & GPS state update
     bool        _parse_gps();
+    uint32_t    _parse_bytes(const uint8_t *bytes, uint32_t len, bool &parsed, bool &stop);
 
     // used to update fix between status and position packets
     AP_GPS::GPS_Status next_fix;
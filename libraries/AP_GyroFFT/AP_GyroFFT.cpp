@@ -57,6 +57,7 @@ extern const AP_HAL::HAL& hal;
 #define FFT_HARMONIC_FIT_MULT       50.0f
 #define FFT_HARMONIC_FIT_TRACK_ROLL    4
 #define FFT_HARMONIC_FIT_TRACK_PITCH   5
+#define FFT_TRACKING_FULL_FFT_FRAMES   8    // frames tracked with Goertzel filters before a full FFT
 
 // table of user settable parameters
 const AP_Param::GroupInfo AP_GyroFFT::var_info[] = {
@@ -169,8 +170,8 @@ const AP_Param::GroupInfo AP_GyroFFT::var_info[] = {
 
     // @Param: OPTIONS
     // @DisplayName: FFT options
-    // @Description: FFT configuration options. Values: 1:Apply the FFT *after* the filter bank,2:Check noise at the motor frequencies using ESC data as a reference
-    // @Bitmask: 0:Enable post-filter FFT,1:Check motor noise
+    // @Description: FFT configuration options. Values: 1:Apply the FFT *after* the filter bank,2:Check noise at the motor frequencies using ESC data as a reference,4:Also analyse the non-primary IMUs in turn, so that notches running on all IMUs can track each IMU's own noise frequency,8:Once peaks have been found track them with Goertzel filters, which is much cheaper and more precise than a full FFT. A full FFT is still run every 8 frames and whenever the signal is lost in order to find new peaks. Not used with frame averaging.
+    // @Bitmask: 0:Enable post-filter FFT,1:Check motor noise,2:Analyse all IMUs,3:Track peaks between FFTs
     // @User: Advanced
     // @RebootRequired: True
     AP_GROUPINFO("OPTIONS", 15, AP_GyroFFT, _options, 0),
@@ -345,6 +346,12 @@ void AP_GyroFFT::init(uint16_t loop_rate_hz)
         _center_bandwidth_filter[peak].set_cutoff_frequency(output_rate, output_rate * 0.25f * scale_factor);
     }
 
+    // each non-primary IMU axis is analysed once every three primary frames per other IMU
+    const float secondary_rate = output_rate / (XYZ_AXIS_COUNT * XYZ_AXIS_COUNT * MAX(_ins->get_gyro_count() - 1, 1));
+    for (uint8_t i = 0; i < INS_MAX_INSTANCES; i++) {
+        _imu_freq_filter[i].set_cutoff_frequency(secondary_rate, secondary_rate * 0.25f * scale_factor);
+    }
+
     // turn down the SNR threshold if examining post-filter
     if (using_post_filter_samples()) {
         _snr_threshold_db.set_default(FFT_SNR_PFILT_DEFAULT);
@@ -463,7 +470,23 @@ uint16_t AP_GyroFFT::run_cycle()
     hal.dsp->fft_start(_state, gyro_buffer, _samples_per_frame);
 
     // calculate FFT and update filters outside the semaphore
-    uint16_t bin_max = hal.dsp->fft_analyse(_state, config._fft_start_bin, config._fft_end_bin, config._attenuation_cutoff);
+    uint16_t bin_max;
+    if (can_track_peaks(_update_axis)) {
+        // only follow the peaks that are currently detected
+        float peak_freqs[FrequencyPeak::MAX_TRACKED_PEAKS] {};
+        float peak_widths[FrequencyPeak::MAX_TRACKED_PEAKS] {};
+        for (uint8_t peak = 0; peak < _tracked_peaks; peak++) {
+            if (_missed_cycles[_update_axis][peak] == 0) {
+                peak_freqs[peak] = get_tl_noise_center_freq_hz(FrequencyPeak(peak), _update_axis);
+                peak_widths[peak] = get_tl_noise_center_bandwidth_hz(FrequencyPeak(peak), _update_axis);
+            }
+        }
+        bin_max = hal.dsp->fft_track(_state, peak_freqs, peak_widths, config._fft_start_bin, config._fft_end_bin);
+        _tracked_frames[_update_axis]++;
+    } else {
+        bin_max = hal.dsp->fft_analyse(_state, config._fft_start_bin, config._fft_end_bin, config._attenuation_cutoff);
+        _tracked_frames[_update_axis] = 0;
+    }
 
     // something has been detected, update the peak frequency and associated metrics
     update_ref_energy(bin_max);
@@ -497,6 +520,11 @@ uint16_t AP_GyroFFT::run_cycle()
     // move onto the next axis
     _update_axis = (_update_axis + 1) % XYZ_AXIS_COUNT;
 
+    // after each set of primary axes look at one axis of another IMU
+    if (_update_axis == 0 && analyse_all_imus()) {
+        run_secondary_cycle(config);
+    }
+
     // ready to receive another frame, because lock contention is so expensive we don't lock
     // around this flag but rather rely on the semaphore at the beginning of the loop to
     // ensure eventual visibility to the main loop
@@ -506,6 +534,62 @@ uint16_t AP_GyroFFT::run_cycle()
     return get_available_samples(_update_axis);
 }
 
+// whether the peaks on an axis can be followed with Goertzel filters rather than a full FFT. This
+// requires a calibrated noise reference and a signal on the last frame, and a full FFT is still
+// run regularly to pick up new peaks
+// called from FFT thread
+bool AP_GyroFFT::can_track_peaks(uint8_t axis) const
+{
+    if (!track_peaks() || _thread_state._noise_needs_calibration
+        || _state->_sliding_window != nullptr || _state->_averaging) {
+        return false;
+    }
+    return _thread_state._health[axis] > 0 && _tracked_frames[axis] < FFT_TRACKING_FULL_FFT_FRAMES;
+}
+
+// analyse one axis of one of the non-primary IMUs, round-robin, sharing the
+// primary's FFT state. Only the peak is found, the result feeds the per-IMU notches
+// called from FFT thread
+void AP_GyroFFT::run_secondary_cycle(const EngineConfig& config)
+{
+    // only raw gyro windows are kept for every IMU, and the frame averaging
+    // state belongs to the primary
+    if (_sample_mode != 0 || _state->_sliding_window != nullptr || _state->_averaging) {
+        return;
+    }
+
+    const uint8_t count = _ins->get_gyro_count();
+    const uint8_t primary = _ins->get_primary_gyro();
+    uint8_t imu = _secondary_imu % MAX(count, 1);
+    for (uint8_t n = 0; n < count && (imu == primary || !_ins->use_gyro(imu)); n++) {
+        imu = (imu + 1) % count;
+        _secondary_axis = 0;
+    }
+    if (imu == primary || !_ins->use_gyro(imu)) {
+        return;
+    }
+    _secondary_imu = imu;
+
+    FloatBuffer& gyro_buffer = _ins->get_raw_gyro_window(imu, _secondary_axis);
+    if (gyro_buffer.available() < _state->_window_size) {
+        return;
+    }
+    // only the latest window matters
+    gyro_buffer.advance(gyro_buffer.available() - _state->_window_size);
+
+    hal.dsp->fft_start(_state, gyro_buffer, _samples_per_frame);
+    const uint16_t bin = hal.dsp->fft_analyse(_state, config._fft_start_bin, config._fft_end_bin, config._attenuation_cutoff);
+
+    _thread_state._imu_freq_hz[imu][_secondary_axis] = _imu_freq_filter[imu].apply(_secondary_axis, _state->_peak_data[FrequencyPeak::CENTER]._freq_hz);
+    _thread_state._imu_energy[imu][_secondary_axis] = _state->get_freq_bin(bin);
+    _thread_state._imu_update_ms[imu] = AP_HAL::millis();
+
+    _secondary_axis = (_secondary_axis + 1) % XYZ_AXIS_COUNT;
+    if (_secondary_axis == 0) {
+        _secondary_imu = (imu + 1) % count;
+    }
+}
+
 // whether analysis can be run again or not
 // called from FFT thread with the semaphore held
 bool AP_GyroFFT::start_analysis() {
@@ -973,6 +1057,18 @@ void AP_GyroFFT::write_log_messages()
         log_noise_peak(2, FrequencyPeak::UPPER_SHOULDER);
     }
 
+    if (analyse_all_imus()) {
+        const uint32_t now = AP_HAL::millis();
+        for (uint8_t i = 0; i < _ins->get_gyro_count(); i++) {
+            if (i == _ins->get_primary_gyro() || now - _global_state._imu_update_ms[i] > 2000) {
+                continue;
+            }
+            const Vector3f &freq = _global_state._imu_freq_hz[i];
+            AP::logger().WriteStreaming("FTNI", "TimeUS,I,PkAvg,PkX,PkY,PkZ", "s#zzzz", "F-----", "QBffff",
+                                        AP_HAL::micros64(), i, get_imu_weighted_freq_hz(i), freq.x, freq.y, freq.z);
+        }
+    }
+
 #if DEBUG_FFT
     const uint32_t now = AP_HAL::millis();
     // output at 1hz
@@ -1005,6 +1101,15 @@ void AP_GyroFFT::write_log_messages()
 // @Field: EnY: power spectral density bin energy of the peak on roll
 // @Field: EnZ: power spectral density bin energy of the peak on roll
 
+// @LoggerMessage: FTNI
+// @Description: FFT Noise Frequency Peak of a non-primary IMU
+// @Field: TimeUS: microseconds since system startup
+// @Field: I: IMU instance
+// @Field: PkAvg: peak noise frequency as an energy-weighted average of roll and pitch peak frequencies
+// @Field: PkX: noise frequency of the peak on roll
+// @Field: PkY: noise frequency of the peak on pitch
+// @Field: PkZ: noise frequency of the peak on yaw
+
 // write a single log message
 void AP_GyroFFT::log_noise_peak(uint8_t id, FrequencyPeak peak) const
 {
@@ -1025,6 +1130,36 @@ void AP_GyroFFT::log_noise_peak(uint8_t id, FrequencyPeak peak) const
         get_center_freq_energy(peak).z);
 }
 
+// return the weighted noise frequency of an IMU, the primary is reported
+// with its raw center frequency so that it compares with the others
+// called from main thread
+float AP_GyroFFT::get_imu_weighted_freq_hz(uint8_t instance) const
+{
+    if (!analysis_enabled() || instance >= INS_MAX_INSTANCES) {
+        return 0.0f;
+    }
+    if (instance == _ins->get_primary_gyro()) {
+        return calculate_weighted_freq_hz(get_center_freq_energy(), get_raw_noise_center_freq_hz());
+    }
+    if (!analyse_all_imus() || AP_HAL::millis() - _global_state._imu_update_ms[instance] > 2000) {
+        return 0.0f;
+    }
+    return calculate_weighted_freq_hz(_global_state._imu_energy[instance], _global_state._imu_freq_hz[instance]);
+}
+
+// return the ratio of the noise frequency of an IMU to that of the primary
+// called from main thread
+float AP_GyroFFT::get_imu_frequency_scale(uint8_t instance) const
+{
+    const float freq = get_imu_weighted_freq_hz(instance);
+    const float primary_freq = get_imu_weighted_freq_hz(_ins->get_primary_gyro());
+    if (!is_positive(freq) || !is_positive(primary_freq)) {
+        return 1.0f;
+    }
+    // large differences are more likely to be a bad estimate than a real difference
+    return constrain_float(freq / primary_freq, 0.5f, 2.0f);
+}
+
 // return an average noise bandwidth weighted by bin energy
 // called from main thread
 float AP_GyroFFT::get_weighted_noise_center_bandwidth_hz() const
@@ -40,7 +40,9 @@ public:
 
     enum class Options : uint32_t {
         FFTPostFilter = 1 << 0,
-        ESCNoiseCheck = 1 << 1
+        ESCNoiseCheck = 1 << 1,
+        AnalyseAllIMUs = 1 << 2,
+        PeakTracking = 1 << 3
     };
 
     AP_GyroFFT();
@@ -113,6 +115,14 @@ public:
     bool check_esc_noise() const { return (_options & uint32_t(Options::ESCNoiseCheck)) != 0; }
     // look for a frequency in the detected noise
     float has_noise_at_frequency_hz(float freq) const;
+    // analyse the other IMUs in turn as well as the primary
+    bool analyse_all_imus() const { return (_options & uint32_t(Options::AnalyseAllIMUs)) != 0; }
+    // track detected peaks with Goertzel filters between full FFTs
+    bool track_peaks() const { return (_options & uint32_t(Options::PeakTracking)) != 0; }
+    // weighted noise frequency of an IMU, zero if it is not being analysed
+    float get_imu_weighted_freq_hz(uint8_t instance) const;
+    // ratio of an IMU's noise frequency to the primary's, 1 if not known
+    float get_imu_frequency_scale(uint8_t instance) const;
 
     static const struct AP_Param::GroupInfo var_info[];
     static AP_GyroFFT *get_singleton() { return _singleton; }
@@ -215,6 +225,10 @@ private:
     bool analysis_enabled() const { return _initialized && _analysis_enabled && _thread_created; };
     // whether analysis can be run again or not
     bool start_analysis();
+    // analyse one axis of one of the non-primary IMUs
+    void run_secondary_cycle(const EngineConfig& config);
+    // whether the peaks on an axis can be tracked rather than running a full FFT
+    bool can_track_peaks(uint8_t axis) const;
     // return samples available in the gyro window
     uint16_t get_available_samples(uint8_t axis) {
         return _sample_mode == 0 ?_ins->get_raw_gyro_window(axis).available() : _downsampled_gyro_data[axis].available();
@@ -252,6 +266,10 @@ private:
         Vector3f _center_freq_energy_filtered[FrequencyPeak::MAX_TRACKED_PEAKS];
         // filtered detected peak width
         Vector3f _center_bandwidth_hz_filtered[FrequencyPeak::MAX_TRACKED_PEAKS];
+        // center frequency and energy of each IMU from run_secondary_cycle()
+        Vector3f _imu_freq_hz[INS_MAX_INSTANCES];
+        Vector3f _imu_energy[INS_MAX_INSTANCES];
+        uint32_t _imu_update_ms[INS_MAX_INSTANCES];
         // axes that still require noise calibration
         uint8_t _noise_needs_calibration : 3;
         // whether the analyzer is mid-cycle
@@ -307,6 +325,13 @@ private:
     MedianLowPassFilter3dFloat _center_bandwidth_filter[FrequencyPeak::MAX_TRACKED_PEAKS];
     // smoothing filter on the frequency fit
     LowPassFilterFloat _harmonic_fit_filter[XYZ_AXIS_COUNT];
+    // smoothing of the frequencies of the other IMUs
+    MedianLowPassFilter3dFloat _imu_freq_filter[INS_MAX_INSTANCES];
+    // next IMU and axis for run_secondary_cycle()
+    uint8_t _secondary_imu;
+    uint8_t _secondary_axis;
+    // number of frames tracked since the last full FFT on each axis
+    uint8_t _tracked_frames[XYZ_AXIS_COUNT];
 
     // configured sampling rate
     uint16_t _fft_sampling_rate_hz;
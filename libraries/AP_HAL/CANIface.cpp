@@ -17,6 +17,7 @@
 
 #include "CANIface.h"
 #include "system.h"
+#include <AP_Common/ExpandingString.h>
 
 bool AP_HAL::CANFrame::priorityHigherThan(const CANFrame& rhs) const
 {
@@ -173,3 +174,39 @@ uint8_t AP_HAL::CANFrame::dlcToDataLength(uint8_t dlc)
     }
     return 64;
 }
+
+#if !defined(HAL_BOOTLOADER_BUILD)
+uint8_t AP_HAL::CANIface::tx_priority_class(const CANFrame &frame)
+{
+    if (frame.isExtended()) {
+        return (frame.id & CANFrame::MaskExtID) >> 27;
+    }
+    return (frame.id & CANFrame::MaskStdID) >> 9;
+}
+
+/*
+  record the latency of a completed transmit, called from the TX interrupt
+ */
+void AP_HAL::CANIface::update_tx_latency(const CANFrame &frame, uint32_t latency_us)
+{
+    auto &lat = tx_latency[tx_priority_class(frame)];
+    lat.count++;
+    lat.total_us += latency_us;
+    if (latency_us > lat.max_us) {
+        lat.max_us = latency_us;
+    }
+}
+
+void AP_HAL::CANIface::print_tx_latency(ExpandingString &str) const
+{
+    str.printf("------- TX Latency -------\n");
+    for (uint8_t i = 0; i < NumTxPriorityClasses; i++) {
+        const auto &lat = tx_latency[i];
+        str.printf("prio%u: count=%lu avg=%luus max=%luus\n",
+                   unsigned(i),
+                   (unsigned long)lat.count,
+                   (unsigned long)(lat.count > 0 ? lat.total_us / lat.count : 0),
+                   (unsigned long)lat.max_us);
+    }
+}
+#endif
@@ -139,6 +139,7 @@ public:
         uint64_t deadline = 0;
         CANFrame frame;
         uint32_t index = 0;
+        uint32_t send_us = 0;   // time send() queued the frame, for latency stats
         bool loopback:1;
         bool abort_on_error:1;
         bool aborted:1;
@@ -267,6 +268,25 @@ protected:
     virtual int8_t get_iface_num() const = 0;
     virtual bool add_to_rx_queue(const CanRxItem &rx_item) = 0;
 
+#if !defined(HAL_BOOTLOADER_BUILD)
+    /*
+      TX latency from send() to transmit complete, by priority
+      class. The class is the top two bits of the identifier, which
+      for DroneCAN separates ESC and actuator commands from status
+      and bulk traffic
+     */
+    enum { NumTxPriorityClasses = 4 };
+    struct {
+        uint32_t count;
+        uint32_t max_us;
+        uint64_t total_us;
+    } tx_latency[NumTxPriorityClasses];
+
+    static uint8_t tx_priority_class(const CANFrame &frame);
+    void update_tx_latency(const CANFrame &frame, uint32_t latency_us);
+    void print_tx_latency(ExpandingString &str) const;
+#endif
+
     FrameCb frame_callback;
     uint32_t bitrate_;
     OperatingMode mode_;
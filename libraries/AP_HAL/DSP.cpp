@@ -34,7 +34,7 @@ extern const AP_HAL::HAL &hal;
 #define SQRT_2_3 0.816496580927726f
 #define SQRT_6   2.449489742783178f
 
-DSP::FFTWindowState::FFTWindowState(uint16_t window_size, uint16_t sample_rate, uint8_t sliding_window_size)
+DSP::FFTWindowState::FFTWindowState(uint16_t window_size, uint16_t sample_rate, uint8_t sliding_window_size, bool float_data)
     : _window_size(window_size),
     _bin_count(window_size / 2),
     _num_stored_freqs(window_size / 2 + 1),
@@ -45,9 +45,11 @@ DSP::FFTWindowState::FFTWindowState(uint16_t window_size, uint16_t sample_rate,
     // includes DC ad Nyquist components and needs to be large enough for intermediate steps
     _freq_bins = (float*)hal.util->malloc_type(sizeof(float) * _window_size, DSP_MEM_REGION);
     _derivative_freq_bins = (float*)hal.util->malloc_type(sizeof(float) * _num_stored_freqs, DSP_MEM_REGION);
-    _hanning_window = (float*)hal.util->malloc_type(sizeof(float) * _window_size, DSP_MEM_REGION);
-    // allocate workspace, including Nyquist component
-    _rfft_data = (float*)hal.util->malloc_type(sizeof(float) * (_window_size + 2), DSP_MEM_REGION);
+    if (float_data) {
+        _hanning_window = (float*)hal.util->malloc_type(sizeof(float) * _window_size, DSP_MEM_REGION);
+        // allocate workspace, including Nyquist component
+        _rfft_data = (float*)hal.util->malloc_type(sizeof(float) * (_window_size + 2), DSP_MEM_REGION);
+    }
     // sliding window of frequency bin frames
     if (_sliding_window_size > 0) {
         _sliding_window = (float*)hal.util->malloc_type(sizeof(float) * _num_stored_freqs * _sliding_window_size, DSP_MEM_REGION);
@@ -59,7 +61,7 @@ DSP::FFTWindowState::FFTWindowState(uint16_t window_size, uint16_t sample_rate,
         }
     }
 
-    if (_freq_bins == nullptr || _hanning_window == nullptr || _rfft_data == nullptr || _derivative_freq_bins == nullptr) {
+    if (_freq_bins == nullptr || (float_data && (_hanning_window == nullptr || _rfft_data == nullptr)) || _derivative_freq_bins == nullptr) {
         free_data_structures();
         return;
     }
@@ -67,8 +69,11 @@ DSP::FFTWindowState::FFTWindowState(uint16_t window_size, uint16_t sample_rate,
     // create the Hanning window
     // https://holometer.fnal.gov/GH_FFT.pdf - equation 19
     for (uint16_t i = 0; i < window_size; i++) {
-        _hanning_window[i] = (0.5f - 0.5f * cosf(2.0f * M_PI * i / ((float)window_size - 1)));
-        _window_scale += _hanning_window[i];
+        const float w = (0.5f - 0.5f * cosf(2.0f * M_PI * i / ((float)window_size - 1)));
+        if (_hanning_window != nullptr) {
+            _hanning_window[i] = w;
+        }
+        _window_scale += w;
     }
     // Calculate the inverse of the Effective Noise Bandwidth - equation 24
     _window_scale = 2.0f / sq(_window_scale);
@@ -227,8 +232,11 @@ uint16_t DSP::calc_frequency(FFTWindowState* fft, uint16_t start_bin, uint16_t p
     // It turns out that Jain is pretty good and works with only magnitudes, but Candan is significantly better
     // if you have access to the complex values and Quinn is a little better still. Quinn is computationally
     // more expensive, but compared to the overall FFT cost seems worth it.
+    // fixed point implementations do not keep the complex data
     if (fft->_sliding_window != nullptr) {
         return (peak_bin + calculate_jains_estimator(fft, fft->_avg_freq_bins, peak_bin)) * fft->_bin_resolution;
+    } else if (fft->_rfft_data == nullptr) {
+        return (peak_bin + calculate_jains_estimator(fft, fft->_freq_bins, peak_bin)) * fft->_bin_resolution;
     } else {
         return (peak_bin + calculate_quinns_second_estimator(fft, fft->_rfft_data, peak_bin)) * fft->_bin_resolution;
     }
@@ -369,6 +377,89 @@ uint16_t DSP::fft_stop_average(FFTWindowState* fft, uint16_t start_bin, uint16_t
     return numpeaks;
 }
 
+// track previously detected peaks using Goertzel filters on the windowed samples left by fft_start(). Each peak
+// is evaluated at points half a bin apart, following it by up to a bin either way, and the frequency and power
+// interpolated from the highest three points. For a small number of peaks this is much cheaper than the full FFT
+// and gives better than bin resolution. Peaks with a zero frequency are not tracked, the noise widths are supplied
+// by the caller and a sliding window is not supported. Returns the bin of the center peak
+uint16_t DSP::fft_track(FFTWindowState* fft, const float* peak_freqs_hz, const float* peak_widths_hz, uint16_t start_bin, uint16_t end_bin)
+{
+    const float step_hz = fft->_bin_resolution * 0.5f;
+    const float min_hz = start_bin * fft->_bin_resolution;
+    const float max_hz = end_bin * fft->_bin_resolution;
+    float freqs[MAX_TRACKED_PEAKS] {};
+    float powers[MAX_TRACKED_PEAKS] {};
+
+    for (uint8_t i = 0; i < MAX_TRACKED_PEAKS; i++) {
+        if (!is_positive(peak_freqs_hz[i])) {
+            continue;
+        }
+        float center_hz = constrain_float(peak_freqs_hz[i], min_hz, max_hz);
+        float p0 = goertzel_power(fft, center_hz);
+        float pl = goertzel_power(fft, center_hz - step_hz);
+        float pu = goertzel_power(fft, center_hz + step_hz);
+        // follow the peak if it has moved
+        for (uint8_t n = 0; n < 2; n++) {
+            if (pu > p0 && pu >= pl && center_hz + step_hz <= max_hz) {
+                center_hz += step_hz;
+                pl = p0;
+                p0 = pu;
+                pu = goertzel_power(fft, center_hz + step_hz);
+            } else if (pl > p0 && center_hz - step_hz >= min_hz) {
+                center_hz -= step_hz;
+                pu = p0;
+                p0 = pl;
+                pl = goertzel_power(fft, center_hz - step_hz);
+            } else {
+                break;
+            }
+        }
+        // parabolic interpolation of the peak
+        float delta = 0.0f;
+        const float curvature = pl - 2.0f * p0 + pu;
+        if (curvature < 0.0f) {
+            delta = constrain_float(0.5f * (pl - pu) / curvature, -0.5f, 0.5f);
+        }
+        freqs[i] = constrain_float(center_hz + delta * step_hz, min_hz, max_hz);
+        powers[i] = (p0 - 0.25f * (pl - pu) * delta) * fft->_window_scale;
+    }
+
+    // the samples are no longer needed so the bins can be reused for the peak powers, bin 0
+    // is outside the detection range and so is used for peaks that are not being tracked
+    fft->_freq_bins[0] = 0.0f;
+    // on a collision the center peak is written last
+    for (int8_t i = MAX_TRACKED_PEAKS - 1; i >= 0; i--) {
+        FrequencyPeakData& peak = fft->_peak_data[i];
+        if (is_positive(freqs[i])) {
+            peak._bin = constrain_int16(lrintf(freqs[i] / fft->_bin_resolution), start_bin, end_bin);
+            peak._freq_hz = freqs[i];
+            peak._noise_width_hz = peak_widths_hz[i];
+            fft->_freq_bins[peak._bin] = powers[i];
+        } else {
+            peak._bin = 0;
+            peak._freq_hz = 0.0f;
+            peak._noise_width_hz = 0.0f;
+        }
+    }
+
+    return fft->_peak_data[CENTER]._bin;
+}
+
+// power of the windowed samples left by fft_start() at an arbitrary frequency using the Goertzel algorithm, this is
+// identical to the squared magnitude of the FFT at the bin frequencies
+float DSP::goertzel_power(const FFTWindowState* fft, float freq_hz) const
+{
+    const float coeff = 2.0f * cosf(M_2PI * freq_hz / (fft->_bin_resolution * fft->_window_size));
+    float s1 = 0.0f;
+    float s2 = 0.0f;
+    for (uint16_t i = 0; i < fft->_window_size; i++) {
+        const float s = fft->_freq_bins[i] + coeff * s1 - s2;
+        s2 = s1;
+        s1 = s;
+    }
+    return sq(s1) + sq(s2) - coeff * s1 * s2;
+}
+
 // find all the peaks in the fft window using https://terpconnect.umd.edu/~toh/spectrum/PeakFindingandMeasurement.htm
 // in general peakgrup > 2 is only good for very broad noisy peaks, <= 2 better for spikey peaks, although 1 will miss
 // a true spike 50% of the time
@@ -88,7 +88,8 @@ public:
 
         void free_data_structures();
         virtual ~FFTWindowState();
-        FFTWindowState(uint16_t window_size, uint16_t sample_rate, uint8_t sliding_window_size);
+        // fixed point implementations allocate their own Hanning window and complex FFT data
+        FFTWindowState(uint16_t window_size, uint16_t sample_rate, uint8_t sliding_window_size, bool float_data = true);
     };
     // initialise an FFT instance
     virtual FFTWindowState* fft_init(uint16_t window_size, uint16_t sample_rate, uint8_t sliding_window_size = 0) = 0;
@@ -100,6 +101,8 @@ public:
     bool fft_start_average(FFTWindowState* fft);
     // finish the averaging process
     uint16_t fft_stop_average(FFTWindowState* fft, uint16_t start_bin, uint16_t end_bin, float* peaks);
+    // track known peaks with Goertzel filters instead of performing the remaining steps of an FFT analysis
+    virtual uint16_t fft_track(FFTWindowState* fft, const float* peak_freqs_hz, const float* peak_widths_hz, uint16_t start_bin, uint16_t end_bin);
 
 protected:
     // step 3: find the magnitudes of the complex data
@@ -135,6 +138,8 @@ protected:
     float calculate_jains_estimator(const FFTWindowState* fft, const float* real_fft, uint16_t k_max);
     // init averaging FFT data
     bool fft_init_average(FFTWindowState* fft);
+    // power of the windowed samples at a single frequency
+    float goertzel_power(const FFTWindowState* fft, float freq_hz) const;
 
 #endif // HAL_WITH_DSP
 };
@@ -190,6 +190,20 @@ bool AP_HAL::Device::read_registers(uint8_t first_reg, uint8_t *recv, uint32_t r
     return result;
 }
 
+/*
+  default batch implementation, one transfer() call per transfer
+ */
+bool AP_HAL::Device::transfer_batch(const BatchTransfer *transfers, uint8_t count)
+{
+    for (uint8_t i = 0; i < count; i++) {
+        const BatchTransfer &t = transfers[i];
+        if (!transfer(t.send, t.send_len, t.recv, t.recv_len)) {
+            return false;
+        }
+    }
+    return true;
+}
+
 bool AP_HAL::Device::transfer_bank(uint8_t bank, const uint8_t *send, uint32_t send_len,
                         uint8_t *recv, uint32_t recv_len)
 {
@@ -118,6 +118,123 @@ public:
     virtual bool transfer(const uint8_t *send, uint32_t send_len,
                           uint8_t *recv, uint32_t recv_len) = 0;
 
+    /*
+     * One transfer of a batch, with the same meaning as the arguments
+     * of transfer()
+     */
+    struct BatchTransfer {
+        const uint8_t *send;
+        uint32_t send_len;
+        uint8_t *recv;
+        uint32_t recv_len;
+    };
+
+    /*
+     * Do count transfers in order, each a separate bus transaction as if
+     * done with transfer(). HALs that can submit several transfers to
+     * the bus at once override this to save the per transfer overhead.
+     * The transfers stop at the first failure.
+     *
+     * Return: true if all transfers succeeded, false on failure.
+     */
+    virtual bool transfer_batch(const BatchTransfer *transfers, uint8_t count);
+
+    /*
+     * A queue of up to N register reads and writes for a device, done
+     * together with transfer_batch() by submit(). Buffers passed in
+     * must stay valid until submit() returns.
+     */
+    template <uint8_t N>
+    class TransferBatch {
+    public:
+        TransferBatch(Device &dev) : _dev(dev) {}
+
+        /* queue a read of recv_len registers starting at first_reg, as read_registers() */
+        bool read_registers(uint8_t first_reg, uint8_t *recv, uint32_t recv_len) {
+            if (_count >= N) {
+                return false;
+            }
+            _reg[_count] = first_reg;
+            _send[_count][0] = first_reg | _dev._read_flag;
+            _transfers[_count] = { _send[_count], 1, recv, recv_len };
+            _count++;
+            return true;
+        }
+
+        /* queue a write of val to the register reg, as write_register() */
+        bool write_register(uint8_t reg, uint8_t val) {
+            if (_count >= N) {
+                return false;
+            }
+            _reg[_count] = reg;
+            _send[_count][0] = reg;
+            _send[_count][1] = val;
+            _transfers[_count] = { _send[_count], 2, nullptr, 0 };
+            _count++;
+            return true;
+        }
+
+        /* queue a transfer, as transfer() */
+        bool transfer(const uint8_t *send, uint32_t send_len, uint8_t *recv, uint32_t recv_len) {
+            if (_count >= N) {
+                return false;
+            }
+            _transfers[_count] = { send, send_len, recv, recv_len };
+            _count++;
+            return true;
+        }
+
+        /* do the queued transfers, emptying the queue */
+        bool submit() {
+            if (_count == 0) {
+                return false;
+            }
+            const bool result = _dev.transfer_batch(_transfers, _count);
+            if (result && _dev._register_rw_callback) {
+                for (uint8_t i = 0; i < _count; i++) {
+                    const BatchTransfer &t = _transfers[i];
+                    if (t.send != _send[i]) {
+                        // not a register access
+                        continue;
+                    }
+                    if (t.recv != nullptr) {
+                        _dev._register_rw_callback(_reg[i], t.recv, t.recv_len, false);
+                    } else {
+                        _dev._register_rw_callback(_reg[i], &_send[i][1], 1, true);
+                    }
+                }
+            }
+            _count = 0;
+            return result;
+        }
+
+    private:
+        Device &_dev;
+        BatchTransfer _transfers[N];
+        uint8_t _send[N][2];
+        uint8_t _reg[N];
+        uint8_t _count = 0;
+    };
+
+    /*
+     * Start an asynchronous full duplex transfer of len bytes and
+     * return without waiting for it to complete, so the caller can do
+     * other work while the transfer runs. The bus semaphore must be
+     * held and both buffers kept valid until transfer_finish() is
+     * called. DMA safe buffers avoid a bounce buffer copy.
+     *
+     * Return: true if the transfer was started, false if not supported or
+     * it could not be started, in which case use transfer() instead.
+     */
+    virtual bool transfer_start(const uint8_t *send, uint8_t *recv, uint32_t len) { return false; }
+
+    /*
+     * Wait for a transfer started with transfer_start() to complete.
+     *
+     * Return: true on a successful transfer, false on failure.
+     */
+    virtual bool transfer_finish() { return false; }
+
 
     /*
      * Sets the required flags before transaction starts
@@ -117,10 +117,21 @@ public:
     };
     
     /*
-      create a new thread
+      create a new thread. cpu is a hint for the CPU the thread should
+      run on, or -1 to leave the choice to the HAL. HALs that can't
+      pin threads ignore it
      */
     virtual bool thread_create(AP_HAL::MemberProc proc, const char *name,
-                               uint32_t stack_size, priority_base base, int8_t priority) {
+                               uint32_t stack_size, priority_base base, int8_t priority,
+                               int8_t cpu = -1) {
+        return false;
+    }
+
+    /*
+      pin the calling thread to a single CPU. Returns false if the HAL
+      does not support it or the CPU does not exist
+     */
+    virtual bool set_thread_cpu_affinity(uint8_t cpu) {
         return false;
     }
 
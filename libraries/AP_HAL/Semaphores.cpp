@@ -1,5 +1,9 @@
 #include "AP_HAL.h"
 
+#if AP_HAL_SEMAPHORE_STATS_ENABLED
+#include <AP_Common/ExpandingString.h>
+#endif
+
 extern const AP_HAL::HAL &hal;
 
 /*
@@ -26,3 +30,76 @@ WithSemaphore::~WithSemaphore()
 {
     _mtx.give();
 }
+
+#if AP_HAL_SEMAPHORE_STATS_ENABLED
+AP_HAL::Semaphore *AP_HAL::Semaphore::_first_named;
+
+void AP_HAL::Semaphore::set_name(const char *name)
+{
+    if (_name[0] != 0) {
+        // already named
+        return;
+    }
+    strncpy_noterm(_name, name, sizeof(_name)-1);
+    _next_named = _first_named;
+    _first_named = this;
+}
+
+void AP_HAL::Semaphore::stats_taken(bool contended, uint32_t wait_start_us)
+{
+    if (_depth++ != 0) {
+        // recursive take
+        return;
+    }
+    const uint32_t now = AP_HAL::micros();
+    _hold_start_us = now;
+    _stats.acquisitions++;
+    if (contended) {
+        const uint32_t wait_us = now - wait_start_us;
+        _stats.contended++;
+        if (wait_us > _stats.max_wait_us) {
+            _stats.max_wait_us = wait_us;
+        }
+        if (wait_us > _stats.period_max_wait_us) {
+            _stats.period_max_wait_us = wait_us;
+        }
+    }
+}
+
+void AP_HAL::Semaphore::stats_give()
+{
+    if (_depth == 0 || --_depth != 0) {
+        return;
+    }
+    const uint32_t hold_us = AP_HAL::micros() - _hold_start_us;
+    if (hold_us > _stats.max_hold_us) {
+        _stats.max_hold_us = hold_us;
+    }
+    if (hold_us > _stats.period_max_hold_us) {
+        _stats.period_max_hold_us = hold_us;
+    }
+}
+
+void AP_HAL::Semaphore::get_stats(Stats &stats, bool reset_period)
+{
+    stats = _stats;
+    if (reset_period) {
+        _stats.period_max_wait_us = 0;
+        _stats.period_max_hold_us = 0;
+    }
+}
+
+void AP_HAL::Semaphore::stats_info(ExpandingString &str)
+{
+    str.printf("%-16s %10s %10s %8s %8s\n", "Name", "Acquired", "Contended", "MaxWait", "MaxHold");
+    for (Semaphore *sem = _first_named; sem != nullptr; sem = sem->_next_named) {
+        const Stats &s = sem->_stats;
+        str.printf("%-16s %10u %10u %8u %8u\n",
+                   sem->_name,
+                   unsigned(s.acquisitions),
+                   unsigned(s.contended),
+                   unsigned(s.max_wait_us),
+                   unsigned(s.max_hold_us));
+    }
+}
+#endif // AP_HAL_SEMAPHORE_STATS_ENABLED
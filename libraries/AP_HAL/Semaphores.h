@@ -2,10 +2,24 @@
 
 #include "AP_HAL_Namespace.h"
 
+#include "AP_HAL_Boards.h"
+
 #include <AP_Common/AP_Common.h>
 
 #define HAL_SEMAPHORE_BLOCK_FOREVER 0
 
+/*
+  semaphore contention statistics. When enabled the ChibiOS, Linux
+  and SITL semaphores count acquisitions, contended acquisitions and
+  the longest wait and hold times. Semaphores given a name with
+  set_name() are reported in @SYS/locks.txt and the LOCK log message
+ */
+#ifndef AP_HAL_SEMAPHORE_STATS_ENABLED
+#define AP_HAL_SEMAPHORE_STATS_ENABLED 0
+#endif
+
+class ExpandingString;
+
 class AP_HAL::Semaphore {
 public:
 
@@ -25,6 +39,73 @@ public:
     
     virtual bool give() = 0;
     virtual ~Semaphore(void) {}
+
+#if AP_HAL_SEMAPHORE_STATS_ENABLED
+    // name the semaphore so its statistics are reported. This
+    // should be called once, at startup
+    void set_name(const char *name);
+
+    struct Stats {
+        uint32_t acquisitions;
+        uint32_t contended;
+        uint32_t max_wait_us;
+        uint32_t max_hold_us;
+        // maximums since the last call to get_stats(..., true)
+        uint32_t period_max_wait_us;
+        uint32_t period_max_hold_us;
+    };
+
+    // iterate over the named semaphores
+    static Semaphore *first_named() { return _first_named; }
+    Semaphore *next_named() const { return _next_named; }
+    const char *get_name() const { return _name; }
+
+    // get the statistics, optionally resetting the period maximums
+    void get_stats(Stats &stats, bool reset_period);
+
+    // print the statistics of all named semaphores for @SYS/locks.txt
+    static void stats_info(ExpandingString &str);
+
+protected:
+    // called by the HAL implementations after the semaphore is
+    // taken. wait_start_us is the time a contended take started
+    // waiting
+    void stats_taken(bool contended, uint32_t wait_start_us);
+    // called by the HAL implementations before the semaphore is given
+    void stats_give();
+
+private:
+    Stats _stats;
+    uint32_t _hold_start_us;
+    // recursion depth, hold time is measured for the outermost take
+    uint8_t _depth;
+    char _name[16];
+    Semaphore *_next_named;
+    static Semaphore *_first_named;
+#else
+    void set_name(const char *name) {}
+#endif
+};
+
+/*
+  a binary semaphore, used to signal an event from one thread to
+  another. Unlike a Semaphore it is not owned by a thread, so signal()
+  can be called from a different thread to the one calling wait()
+ */
+class AP_HAL::BinarySemaphore {
+public:
+    BinarySemaphore() {}
+
+    // do not allow copying
+    CLASS_NO_COPY(BinarySemaphore);
+
+    // wait for up to timeout_us for the semaphore to be signalled,
+    // returning true if it was
+    virtual bool wait(uint32_t timeout_us) WARN_IF_UNUSED = 0;
+    virtual void wait_blocking() = 0;
+
+    virtual void signal() = 0;
+    virtual ~BinarySemaphore(void) {}
 };
 
 /*
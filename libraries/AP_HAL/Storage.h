@@ -12,4 +12,11 @@ public:
     virtual void _timer_tick(void) {};
     virtual bool healthy(void) { return true; }
     virtual bool get_storage_ptr(void *&ptr, size_t &size) { return false; }
+
+    // hold back writing changed lines to the backing store until the
+    // matching end_batch(), so a burst of writes is flushed together
+    // rather than line by line as it arrives. Batches may nest and
+    // may be begun and ended from any thread
+    virtual void begin_batch(void) {}
+    virtual void end_batch(void) {}
 };
@@ -4,6 +4,7 @@
 
 #include "AP_HAL_Namespace.h"
 #include "utility/BetterStream.h"
+#include "utility/RingBuffer.h"
 
 #ifndef HAL_UART_STATS_ENABLED
 #define HAL_UART_STATS_ENABLED !defined(HAL_NO_UARTDRIVER)
@@ -67,6 +68,28 @@ public:
 
     // read from a locked port. If port is locked and key is not correct then 0 is returned
     virtual int16_t read_locked(uint32_t key) { return -1; }
+
+    /*
+      reserve len bytes of the transmit buffer so a caller can fill it
+      in directly rather than with several write() calls. Returns the
+      number of vec elements filled in, or 0 if len bytes are not
+      available or the port does not support it. Other writers are
+      blocked until tx_commit() is called with the number of bytes
+      filled in. A 0 return needs no tx_commit()
+     */
+    virtual uint8_t tx_reserve(ByteBuffer::IoVec vec[2], uint32_t len) { return 0; }
+    virtual bool tx_commit(uint32_t len) { return false; }
+
+    /*
+      return up to two spans covering the received data, in order, so
+      a parser can work on it in place rather than with one read() per
+      byte. Returns the number of vec elements filled in, or 0 if
+      nothing is available or the port does not support it. The data
+      stays in the receive buffer until rx_consume() is called with
+      the number of bytes used
+     */
+    virtual uint8_t rx_peek(ByteBuffer::IoVec vec[2]) { return 0; }
+    virtual bool rx_consume(uint32_t len) { return false; }
     
     // control optional features
     virtual bool set_options(uint16_t options) { _last_options = options; return options==0; }
@@ -1,6 +1,7 @@
 #include "AP_HAL.h"
 #include "Util.h"
 #include "utility/print_vprintf.h"
+#include <string.h>
 #if defined(__APPLE__) && defined(__MACH__)
 #include <sys/time.h>
 #elif CONFIG_HAL_BOARD == HAL_BOARD_CHIBIOS
@@ -24,11 +25,12 @@ public:
         return 1;
     }
     size_t write(const uint8_t *buffer, size_t size) override {
-        size_t n = 0;
-        while (size--) {
-            n += write(*buffer++);
+        if (_offs < _size) {
+            const size_t n = size < _size - _offs ? size : _size - _offs;
+            memcpy(&_str[_offs], buffer, n);
         }
-        return n;
+        _offs += size;
+        return size;
     }
 
     size_t _offs;
@@ -173,6 +173,9 @@ public:
     // request information on running threads
     virtual void thread_info(ExpandingString &str) {}
 
+    // request information on the load of each cpu core
+    virtual void cpu_load_info(ExpandingString &str) {}
+
     // request information on dma contention
     virtual void dma_info(ExpandingString &str) {}
 
@@ -0,0 +1,56 @@
+#include <AP_gbenchmark.h>
+
+#include <AP_HAL/HAL.h>
+#include <AP_HAL/Util.h>
+
+const AP_HAL::HAL& hal = AP_HAL::get_HAL();
+
+static void BM_snprintf_FixedFloat(benchmark::State& state)
+{
+    char buf[64];
+    float v = 0;
+    while (state.KeepRunning()) {
+        hal.util->snprintf(buf, sizeof(buf), "Alt %.2f Spd %5.1f V %4.2f", v, v * 0.1f, 12.6f - v * 1e-3f);
+        gbenchmark_escape(buf);
+        v += 0.37f;
+    }
+}
+
+static void BM_snprintf_Float(benchmark::State& state)
+{
+    char buf[64];
+    float v = 0;
+    while (state.KeepRunning()) {
+        hal.util->snprintf(buf, sizeof(buf), "%f %g %e", v, v * 1e-3f, v * 1e3f);
+        gbenchmark_escape(buf);
+        v += 0.37f;
+    }
+}
+
+static void BM_snprintf_Integer(benchmark::State& state)
+{
+    char buf[64];
+    uint32_t v = 0;
+    while (state.KeepRunning()) {
+        hal.util->snprintf(buf, sizeof(buf), "%u %d %lx %llu", unsigned(v), -int(v), (unsigned long)v,
+                           (unsigned long long)v * 1000003ULL);
+        gbenchmark_escape(buf);
+        v += 7919;
+    }
+}
+
+static void BM_snprintf_String(benchmark::State& state)
+{
+    char buf[64];
+    while (state.KeepRunning()) {
+        hal.util->snprintf(buf, sizeof(buf), "PreArm: %s %s", "Compass not calibrated", "(mag 1)");
+        gbenchmark_escape(buf);
+    }
+}
+
+BENCHMARK(BM_snprintf_FixedFloat);
+BENCHMARK(BM_snprintf_Float);
+BENCHMARK(BM_snprintf_Integer);
+BENCHMARK(BM_snprintf_String);
+
+BENCHMARK_MAIN();
@@ -54,6 +54,18 @@ TEST(vsnprintf_Test, Basic)
         EXPECT_EQ(bytes_required, 28);
         EXPECT_TRUE(streq(output, "                   0.3333333"));
     }
+    { // fixed point floats, rounded to nearest
+        const int bytes_required = hal.util->snprintf(output, ARRAY_SIZE(output), "%5.2f|%-7.1f|%07.2f|%+.0f|%.4f",
+                                                      3.14159, -2.26, -1.5, 3.0, 0.23225041);
+        EXPECT_EQ(bytes_required, 31);
+        EXPECT_TRUE(streq(output, " 3.14|-2.3   |-001.50|+3|0.2323"));
+    }
+    { // integers
+        const int bytes_required = hal.util->snprintf(output, ARRAY_SIZE(output), "%d %5u %x %o %llu",
+                                                      -1234567, 42U, 0xbeefU, 8U, 18446744073709551615ULL);
+        EXPECT_EQ(bytes_required, 43);
+        EXPECT_TRUE(streq(output, "-1234567    42 BEEF 10 18446744073709551615"));
+    }
 
     { // simple string
         const int bytes_required = hal.util->snprintf(output, ARRAY_SIZE(output), "%s %s %c", "ABC", "DEF", 'x');
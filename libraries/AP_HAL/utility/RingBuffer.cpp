@@ -45,17 +45,22 @@ uint32_t ByteBuffer::available(void) const
 {
     /* use a copy on stack to avoid race conditions of @tail being updated by
      * the writer thread */
-    uint32_t _tail = tail;
+    const uint32_t _head = head.load(std::memory_order_relaxed);
+    const uint32_t _tail = tail.load(std::memory_order_acquire);
 
-    if (head > _tail) {
-        return size - head + _tail;
+    if (_head > _tail) {
+        return size - _head + _tail;
     }
-    return _tail - head;
+    return _tail - _head;
 }
 
+/*
+  discard everything written so far. Only the read position moves, so
+  this is safe against a concurrent writer
+ */
 void ByteBuffer::clear(void)
 {
-    head = tail = 0;
+    head.store(tail.load(std::memory_order_acquire), std::memory_order_release);
 }
 
 uint32_t ByteBuffer::space(void) const
@@ -66,21 +71,22 @@ uint32_t ByteBuffer::space(void) const
 
     /* use a copy on stack to avoid race conditions of @head being updated by
      * the reader thread */
-    uint32_t _head = head;
+    const uint32_t _head = head.load(std::memory_order_acquire);
+    const uint32_t _tail = tail.load(std::memory_order_relaxed);
     uint32_t ret = 0;
 
-    if (_head <= tail) {
+    if (_head <= _tail) {
         ret = size;
     }
 
-    ret += _head - tail - 1;
+    ret += _head - _tail - 1;
 
     return ret;
 }
 
 bool ByteBuffer::is_empty(void) const
 {
-    return head == tail;
+    return head.load(std::memory_order_relaxed) == tail.load(std::memory_order_acquire);
 }
 
 uint32_t ByteBuffer::write(const uint8_t *data, uint32_t len)
@@ -108,11 +114,12 @@ bool ByteBuffer::update(const uint8_t *data, uint32_t len)
         return false;
     }
     // perform as two memcpy calls
-    uint32_t n = size - head;
+    const uint32_t _head = head.load(std::memory_order_relaxed);
+    uint32_t n = size - _head;
     if (n > len) {
         n = len;
     }
-    memcpy(&buf[head], data, n);
+    memcpy(&buf[_head], data, n);
     data += n;
     if (len > n) {
         memcpy(&buf[0], data, len-n);
@@ -125,7 +132,7 @@ bool ByteBuffer::advance(uint32_t n)
     if (n > available()) {
         return false;
     }
-    head = (head + n) % size;
+    head.store((head.load(std::memory_order_relaxed) + n) % size, std::memory_order_release);
     return true;
 }
 
@@ -194,9 +201,10 @@ uint8_t ByteBuffer::reserve(ByteBuffer::IoVec iovec[2], uint32_t len)
         return 0;
     }
 
-    iovec[0].data = &buf[tail];
+    const uint32_t _tail = tail.load(std::memory_order_relaxed);
+    iovec[0].data = &buf[_tail];
 
-    n = size - tail;
+    n = size - _tail;
     if (len <= n) {
         iovec[0].len = len;
         return 1;
@@ -219,7 +227,7 @@ bool ByteBuffer::commit(uint32_t len)
         return false; //Someone broke the agreement
     }
 
-    tail = (tail + len) % size;
+    tail.store((tail.load(std::memory_order_relaxed) + len) % size, std::memory_order_release);
     return true;
 }
 
@@ -251,10 +259,11 @@ bool ByteBuffer::read_byte(uint8_t *data)
  */
 const uint8_t *ByteBuffer::readptr(uint32_t &available_bytes)
 {
-    uint32_t _tail = tail;
-    available_bytes = (head > _tail) ? size - head : _tail - head;
+    const uint32_t _head = head.load(std::memory_order_relaxed);
+    const uint32_t _tail = tail.load(std::memory_order_acquire);
+    available_bytes = (_head > _tail) ? size - _head : _tail - _head;
 
-    return available_bytes ? &buf[head] : nullptr;
+    return available_bytes ? &buf[_head] : nullptr;
 }
 
 int16_t ByteBuffer::peek(uint32_t ofs) const
@@ -262,5 +271,5 @@ int16_t ByteBuffer::peek(uint32_t ofs) const
     if (ofs >= available()) {
         return -1;
     }
-    return buf[(head+ofs)%size];
+    return buf[(head.load(std::memory_order_relaxed)+ofs)%size];
 }
@@ -6,8 +6,28 @@
 #include <AP_HAL/AP_HAL_Macros.h>
 #include <AP_HAL/Semaphores.h>
 
+/*
+  size of a cache line, used to keep the read and write positions of
+  a ring buffer apart on processors where the reader and writer can
+  run on different cores. Zero for no separation
+ */
+#ifndef HAL_CACHE_LINE_SIZE
+#if CONFIG_HAL_BOARD == HAL_BOARD_SITL || CONFIG_HAL_BOARD == HAL_BOARD_LINUX
+#define HAL_CACHE_LINE_SIZE 64
+#else
+#define HAL_CACHE_LINE_SIZE 0
+#endif
+#endif
+
 /*
  * Circular buffer of bytes.
+ *
+ * This is lock free for a single producer and a single consumer: one
+ * thread may write (write(), reserve() and commit()) at the same time
+ * as another reads (read(), peek*(), readptr(), advance(), update()
+ * and clear()), with no locking. Several writers or several readers
+ * must be serialised by the caller, see ByteBuffer_MPSC. set_size()
+ * needs both sides to be stopped.
  */
 class ByteBuffer {
 public:
@@ -22,7 +42,8 @@ public:
     // number of bytes available to be read
     uint32_t available(void) const;
 
-    // Discards the buffer content, emptying it.
+    // Discards the buffer content, emptying it. This is a read side
+    // operation
     void clear(void);
 
     // number of bytes space available to write
@@ -95,14 +116,89 @@ private:
     uint8_t *buf;
     uint32_t size;
 
+    bool external_buf;
+
+    /*
+      head is only written by the reader and tail only by the
+      writer. Each side loads the other's position with acquire and
+      publishes its own with release, so the bytes are in place
+      before the position that covers them is seen
+     */
+#if HAL_CACHE_LINE_SIZE > 0
+    uint8_t _pad0[HAL_CACHE_LINE_SIZE];
+#endif
     std::atomic<uint32_t> head{0}; // where to read data
+#if HAL_CACHE_LINE_SIZE > 0
+    uint8_t _pad1[HAL_CACHE_LINE_SIZE - sizeof(std::atomic<uint32_t>)];
+#endif
     std::atomic<uint32_t> tail{0}; // where to write data
+};
 
-    bool external_buf;
+/*
+  ByteBuffer for several writer threads and a single reader. Writers
+  are serialised by a semaphore which the reader never takes, so
+  reading is lock free and a writer never waits for the reader
+ */
+class ByteBuffer_MPSC : private ByteBuffer {
+public:
+    ByteBuffer_MPSC(uint32_t _size) : ByteBuffer(_size) {}
+
+    using ByteBuffer::IoVec;
+    using ByteBuffer::available;
+    using ByteBuffer::clear;
+    using ByteBuffer::space;
+    using ByteBuffer::is_empty;
+    using ByteBuffer::read;
+    using ByteBuffer::read_byte;
+    using ByteBuffer::update;
+    using ByteBuffer::get_size;
+    using ByteBuffer::set_size;
+    using ByteBuffer::advance;
+    using ByteBuffer::readptr;
+    using ByteBuffer::peek;
+    using ByteBuffer::peekbytes;
+    using ByteBuffer::peekiovec;
+
+    // write bytes to ringbuffer. Returns number of bytes written
+    uint32_t write(const uint8_t *data, uint32_t len) {
+        WITH_SEMAPHORE(write_sem);
+        return ByteBuffer::write(data, len);
+    }
+
+    // write all of len bytes or nothing
+    bool write_all(const uint8_t *data, uint32_t len) {
+        WITH_SEMAPHORE(write_sem);
+        if (ByteBuffer::space() < len) {
+            return false;
+        }
+        return ByteBuffer::write(data, len) == len;
+    }
+
+    // reserve len bytes as ByteBuffer::reserve(). The write semaphore
+    // is held until commit() when this returns non-zero
+    uint8_t reserve(IoVec vec[2], uint32_t len) {
+        write_sem.take_blocking();
+        const uint8_t n = ByteBuffer::reserve(vec, len);
+        if (n == 0) {
+            write_sem.give();
+        }
+        return n;
+    }
+
+    bool commit(uint32_t len) {
+        const bool ret = ByteBuffer::commit(len);
+        write_sem.give();
+        return ret;
+    }
+
+private:
+    HAL_Semaphore write_sem;
 };
 
 /*
-  ring buffer class for objects of fixed size
+  ring buffer class for objects of fixed size. Like ByteBuffer this is
+  lock free for one thread pushing and one popping, other than
+  push_force() which pops from the pushing thread
   !!! Note ObjectBuffer_TS is a duplicate of this update, in both places !!!
  */
 template <class T>
@@ -458,6 +554,45 @@ private:
     HAL_Semaphore sem;
 };
 
+/*
+  ring buffer class for objects of fixed size with several writer
+  threads and a single reader. Pushes are serialised by a semaphore
+  which the reader never takes, so popping is lock free. There is no
+  push_force() as discarding objects is for the reader to do
+ */
+template <class T>
+class ObjectBuffer_MPSC : private ObjectBuffer<T> {
+public:
+    ObjectBuffer_MPSC(uint32_t _size = 0) : ObjectBuffer<T>(_size) {}
+
+    using ObjectBuffer<T>::get_size;
+    using ObjectBuffer<T>::set_size;
+    using ObjectBuffer<T>::clear;
+    using ObjectBuffer<T>::available;
+    using ObjectBuffer<T>::space;
+    using ObjectBuffer<T>::is_empty;
+    using ObjectBuffer<T>::pop;
+    using ObjectBuffer<T>::peek;
+    using ObjectBuffer<T>::readptr;
+    using ObjectBuffer<T>::advance;
+    using ObjectBuffer<T>::update;
+
+    // push one object onto the back of the queue
+    bool push(const T &object) {
+        WITH_SEMAPHORE(sem);
+        return ObjectBuffer<T>::push(object);
+    }
+
+    // push N objects onto the back of the queue
+    bool push(const T *object, uint32_t n) {
+        WITH_SEMAPHORE(sem);
+        return ObjectBuffer<T>::push(object, n);
+    }
+
+private:
+    HAL_Semaphore sem;
+};
+
 /*
   ring buffer class for objects of fixed size with pointer
   access. Note that this is not thread safe, buf offers efficient
@@ -150,6 +150,36 @@ ssize_t SocketAPM::recv(void *buf, size_t size, uint32_t timeout_ms)
     return ::recvfrom(fd, buf, size, MSG_DONTWAIT, (sockaddr *)&in_addr, &len);
 }
 
+/*
+  send a packet gathered from several buffers
+ */
+ssize_t SocketAPM::sendv(const struct iovec *iov, int iovcnt, const char *address, uint16_t port)
+{
+    struct sockaddr_in sockaddr;
+    struct msghdr msg {};
+    msg.msg_iov = const_cast<struct iovec *>(iov);
+    msg.msg_iovlen = iovcnt;
+    if (address != nullptr) {
+        make_sockaddr(address, port, sockaddr);
+        msg.msg_name = &sockaddr;
+        msg.msg_namelen = sizeof(sockaddr);
+    }
+    return ::sendmsg(fd, &msg, MSG_DONTWAIT);
+}
+
+/*
+  receive data into several buffers
+ */
+ssize_t SocketAPM::recvv(const struct iovec *iov, int iovcnt)
+{
+    struct msghdr msg {};
+    msg.msg_iov = const_cast<struct iovec *>(iov);
+    msg.msg_iovlen = iovcnt;
+    msg.msg_name = &in_addr;
+    msg.msg_namelen = sizeof(in_addr);
+    return ::recvmsg(fd, &msg, MSG_DONTWAIT);
+}
+
 /*
   return the IP address and port of the last received packet
  */
@@ -28,6 +28,7 @@
 #include <netinet/tcp.h>
 #include <arpa/inet.h>
 #include <sys/select.h>
+#include <sys/uio.h>
 
 class SocketAPM {
 public:
@@ -46,6 +47,14 @@ public:
     ssize_t sendto(const void *buf, size_t size, const char *address, uint16_t port);
     ssize_t recv(void *pkt, size_t size, uint32_t timeout_ms);
 
+    // send or receive without waiting, gathering from or scattering
+    // to several buffers. For datagram sockets each call is one packet
+    ssize_t sendv(const struct iovec *iov, int iovcnt, const char *address=nullptr, uint16_t port=0);
+    ssize_t recvv(const struct iovec *iov, int iovcnt);
+
+    // file descriptor for use with poll() or epoll
+    int get_fd() const { return fd; }
+
     // return the IP address and port of the last received packet
     void last_recv_address(const char *&ip_addr, uint16_t &port) const;
 
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <atomic>
+#include <stdint.h>
+
+/*
+  hand the latest value of an object from one writer thread to one
+  reader thread without locking. There are three copies: the writer
+  fills its own back copy and publishes it by swapping it with the
+  middle copy, and the reader takes the middle copy in exchange for
+  its front copy when something new has been published. Neither side
+  ever waits for the other, and the reader sees whole objects only,
+  though it may miss values if the writer publishes faster than it
+  reads
+ */
+template <class T>
+class TripleBuffer {
+public:
+    // the copy the writer fills before calling publish()
+    T &back(void) { return _buf[_back]; }
+
+    // make the back copy the latest value
+    void publish(void) {
+        _back = _middle.exchange(_back | NEW_VALUE, std::memory_order_acq_rel) & INDEX_MASK;
+    }
+
+    void write(const T &value) {
+        back() = value;
+        publish();
+    }
+
+    // take the latest value if there is a new one, returning true if
+    // front() has changed
+    bool update(void) {
+        if ((_middle.load(std::memory_order_relaxed) & NEW_VALUE) == 0) {
+            return false;
+        }
+        _front = _middle.exchange(_front, std::memory_order_acq_rel) & INDEX_MASK;
+        return true;
+    }
+
+    // the latest value taken by update(), initially a default T
+    const T &front(void) const { return _buf[_front]; }
+
+private:
+    static constexpr uint8_t INDEX_MASK = 0x03;
+    static constexpr uint8_t NEW_VALUE = 0x04;
+
+    T _buf[3] {};
+    uint8_t _back = 0;                // only used by the writer
+    std::atomic<uint8_t> _middle{1};  // index, and whether it is new
+    uint8_t _front = 2;               // only used by the reader
+};
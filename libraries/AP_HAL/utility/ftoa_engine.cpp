@@ -85,6 +85,17 @@ static const uint32_t factorTable[32] = {
     1038459372UL
 };
 
+/*
+  powers of ten for the digit extraction, so that stepping to the next
+  digit is a table lookup rather than a 64 bit division
+ */
+static const int64_t pow10Table[15] = {
+    1LL, 10LL, 100LL, 1000LL, 10000LL, 100000LL, 1000000LL,
+    10000000LL, 100000000LL, 1000000000LL, 10000000000LL,
+    100000000000LL, 1000000000000LL, 10000000000000LL,
+    100000000000000LL
+};
+
 int16_t ftoa_engine(float val, char *buf, uint8_t precision, uint8_t maxDecimals) 
 {
     uint8_t flags;
@@ -141,7 +152,8 @@ int16_t ftoa_engine(float val, char *buf, uint8_t precision, uint8_t maxDecimals
     // Now convert to decimal.
     uint8_t hadNonzeroDigit = 0; // a flag
     uint8_t outputIdx = 0;
-    int64_t decimal = 100000000000000ull;
+    int8_t decimalIdx = ARRAY_SIZE(pow10Table) - 1;
+    int64_t decimal = pow10Table[decimalIdx];
 
     do {
         char digit = '0';
@@ -153,7 +165,7 @@ int16_t ftoa_engine(float val, char *buf, uint8_t precision, uint8_t maxDecimals
             // to save and restore last nonnegative value - but in fact
             // they take as long time and more space.
             prod += decimal;
-            decimal /= 10;
+            decimal = decimalIdx > 0 ? pow10Table[--decimalIdx] : 0;
 
             // If already found a leading nonzero digit, accept zeros.
             if (hadNonzeroDigit) break;
@@ -203,7 +215,9 @@ int16_t ftoa_engine(float val, char *buf, uint8_t precision, uint8_t maxDecimals
     } while (outputIdx<precision);
 
     // Rounding:
-    decimal *= 10;
+    if (decimal != 0) {
+        decimal = pow10Table[decimalIdx+1];
+    }
 
     if (prod - (decimal >> 1) >= 0) {
 
@@ -227,3 +241,60 @@ int16_t ftoa_engine(float val, char *buf, uint8_t precision, uint8_t maxDecimals
     return exp10;
 }
 
+
+/*
+  fixed point conversion for the common "%.Nf" case, exact and without
+  64 bit divisions. |val| is rounded to prec (at most 7) digits after
+  the decimal point and written to buf as digits with the point in
+  place. Returns the length, or zero if the result would have more
+  than 7 significant digits and needs ftoa_engine()
+ */
+uint8_t ftoa_fixed(float val, uint8_t prec, char *buf)
+{
+    union {
+        float v;
+        uint32_t u;
+    } x;
+    x.v = val;
+    const uint8_t exp = (x.u >> 23) & 0xff;
+    if (exp == 0xff || prec > 7) {
+        return 0;
+    }
+    uint32_t mant = x.u & 0x007fffffUL;
+    if (exp != 0) {
+        mant |= (1UL<<23);
+    }
+
+    // |val| * 10^prec = mant * 10^prec * 2^-shift, rounded half up
+    const int16_t shift = 150 - (exp != 0 ? exp : 1);
+    if (shift <= 0) {
+        // at least 2^23, too many digits
+        return 0;
+    }
+    uint64_t digits64 = 0;
+    if (shift < 64) {
+        const uint64_t scaled = (uint64_t)mant * (uint32_t)pow10Table[prec];
+        digits64 = (scaled + (1ULL << (shift-1))) >> shift;
+    }
+    if (digits64 >= 10000000ULL) {
+        return 0;
+    }
+    uint32_t digits = digits64;
+
+    // digits least significant first, with at least one before the point
+    char tmp[9];
+    uint8_t n = 0;
+    do {
+        tmp[n++] = '0' + digits % 10;
+        digits /= 10;
+    } while (digits != 0 || n <= prec);
+
+    uint8_t len = 0;
+    while (n > 0) {
+        if (n == prec) {
+            buf[len++] = '.';
+        }
+        buf[len++] = tmp[--n];
+    }
+    return len;
+}
@@ -35,6 +35,8 @@
 int16_t ftoa_engine(float val, char *buf,
 		    uint8_t precision, uint8_t maxDecimals);
 
+uint8_t ftoa_fixed(float val, uint8_t prec, char *buf);
+
 /* '__ftoa_engine' return next flags (in buf[0]):	*/
 #define	FTOA_MINUS	1
 #define	FTOA_ZERO	2
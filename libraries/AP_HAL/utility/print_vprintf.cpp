@@ -71,6 +71,37 @@
 #include <hal.h>
 #endif
 
+#if CONFIG_HAL_BOARD != HAL_BOARD_CHIBIOS || __FPU_PRESENT
+/*
+  write the padding and sign before the digits of a float of n
+  characters, leaving in width the padding to write after them
+ */
+static void print_float_lead(AP_HAL::BetterStream *s, uint16_t flags, unsigned char &width,
+                             unsigned char sign, int n)
+{
+    if (sign) {
+        n += 1;
+    }
+    width = width > n ? width - n : 0;
+
+    if (!(flags & (FL_LPAD | FL_ZFILL))) {
+        while (width) {
+            s->write(' ');
+            width--;
+        }
+    }
+    if (sign) {
+        s->write(sign);
+    }
+    if (!(flags & FL_LPAD)) {
+        while (width) {
+            s->write('0');
+            width--;
+        }
+    }
+}
+#endif
+
 void print_vprintf(AP_HAL::BetterStream *s, const char *fmt, va_list ap)
 {
         unsigned char c;        /* holds a char from the format string */
@@ -81,18 +112,23 @@ void print_vprintf(AP_HAL::BetterStream *s, const char *fmt, va_list ap)
 
         for (;;) {
             /*
-             * Process non-format characters
+             * Process non-format characters, written as runs
              */
             for (;;) {
-                c = *fmt++;
+                const char *run = fmt;
+                while ((c = *fmt) != 0 && c != '%') {
+                    fmt++;
+                }
+                if (fmt != run) {
+                    s->write((const uint8_t *)run, fmt - run);
+                }
                 if (!c) {
                     return;
                 }
-                if (c == '%') {
-                    c = *fmt++;
-                    if (c != '%') {
-                        break;
-                    }
+                fmt++;
+                c = *fmt++;
+                if (c != '%') {
+                    break;
                 }
                 s->write(c);
             }
@@ -190,6 +226,24 @@ flt_oper:
                     prec -= 1;
                 }
 
+                if (flags & FL_FLTFIX) {
+                    // most fixed formats are converted exactly without
+                    // ftoa_engine()
+                    const uint8_t len = ftoa_fixed(value, prec, (char *)buf);
+                    if (len != 0) {
+                        sign = 0;
+                        if (std::signbit(value))
+                            sign = '-';
+                        else if (flags & FL_PLUS)
+                            sign = '+';
+                        else if (flags & FL_SPACE)
+                            sign = ' ';
+                        print_float_lead(s, flags, width, sign, len);
+                        s->write(buf, len);
+                        goto tail;
+                    }
+                }
+
                 if ((flags & FL_FLTFIX) && fabsf(value) > 9999999) {
                     flags = (flags & ~FL_FLTFIX) | FL_FLTEXP;
                 }
@@ -274,30 +328,12 @@ flt_oper:
                 } else {
                     n = 5;          /* 1e+00 */
                 }
-                if (sign) {
-                    n += 1;
-                }
                 if (prec) {
                     n += prec + 1;
                 }
-                width = width > n ? width - n : 0;
 
                 /* Output before first digit    */
-                if (!(flags & (FL_LPAD | FL_ZFILL))) {
-                    while (width) {
-                        s->write(' ');
-                        width--;
-                    }
-                }
-                if (sign) {
-                    s->write(sign);
-                }
-                if (!(flags & FL_LPAD)) {
-                    while (width) {
-                        s->write('0');
-                        width--;
-                    }
-                }
+                print_float_lead(s, flags, width, sign, n);
 
                 if (flags & FL_FLTFIX) {                /* 'f' format           */
 
@@ -525,9 +561,13 @@ ultoa:
                     prec--;
                 }
 
-                do {
-                    s->write(buf[--c]);
-                } while (c);
+                // the digits are least significant first
+                for (uint8_t i = 0, j = c - 1; i < j; i++, j--) {
+                    const unsigned char t = buf[i];
+                    buf[i] = buf[j];
+                    buf[j] = t;
+                }
+                s->write(buf, c);
             }
 
 tail:
@@ -16,6 +16,7 @@
  */
 #include <AP_gtest.h>
 
+#include <string.h>
 #include <utility>
 #include <AP_HAL/utility/RingBuffer.h>
 
@@ -122,4 +123,82 @@ TEST(ObjectBufferTest, PeekTest)
     }
 }
 
+TEST(ByteBufferTest, ClearKeepsPosition)
+{
+    ByteBuffer x{16};
+    uint8_t buf[16] {};
+    // move the positions away from the start, then discard
+    EXPECT_EQ(x.write(buf, 10), 10U);
+    EXPECT_EQ(x.read(buf, 6), 6U);
+    x.clear();
+    EXPECT_TRUE(x.is_empty());
+    EXPECT_EQ(x.space(), 15U);
+
+    // a write after clear() wraps around as usual
+    static const uint8_t data[12] {1,2,3,4,5,6,7,8,9,10,11,12};
+    EXPECT_EQ(x.write(data, sizeof(data)), sizeof(data));
+    EXPECT_EQ(x.available(), sizeof(data));
+    EXPECT_EQ(x.read(buf, sizeof(buf)), sizeof(data));
+    EXPECT_EQ(memcmp(buf, data, sizeof(data)), 0);
+}
+
+TEST(ByteBufferTest, MPSC)
+{
+    ByteBuffer_MPSC x{16};
+    static const uint8_t data[8] {1,2,3,4,5,6,7,8};
+    uint8_t buf[16] {};
+
+    EXPECT_EQ(x.write(data, 4), 4U);
+    EXPECT_TRUE(x.write_all(data, 8));
+    // only three bytes of space left
+    EXPECT_FALSE(x.write_all(data, 4));
+    EXPECT_EQ(x.available(), 12U);
+
+    EXPECT_EQ(x.read(buf, 4), 4U);
+    EXPECT_EQ(memcmp(buf, data, 4), 0);
+
+    // reserve and commit around the end of the buffer
+    ByteBuffer_MPSC::IoVec vec[2];
+    const uint8_t n_vec = x.reserve(vec, 6);
+    EXPECT_EQ(n_vec, 2);
+    uint32_t len = 0;
+    for (uint8_t i=0; i<n_vec; i++) {
+        memcpy(vec[i].data, &data[len], vec[i].len);
+        len += vec[i].len;
+    }
+    EXPECT_EQ(len, 6U);
+    EXPECT_TRUE(x.commit(len));
+    // the write semaphore was given back by commit()
+    EXPECT_EQ(x.write(data, 1), 1U);
+
+    EXPECT_EQ(x.read(buf, sizeof(buf)), 15U);
+    EXPECT_EQ(memcmp(buf, data, 8), 0);
+    EXPECT_EQ(memcmp(&buf[8], data, 6), 0);
+    EXPECT_EQ(buf[14], 1);
+}
+
+TEST(ObjectBufferTest, MPSC)
+{
+    ObjectBuffer_MPSC<uint32_t> x{4};
+    EXPECT_EQ(x.get_size(), 4U);
+    for (uint32_t i=0; i<4; i++) {
+        EXPECT_TRUE(x.push(i));
+    }
+    EXPECT_FALSE(x.push(4U));
+    EXPECT_EQ(x.available(), 4U);
+
+    uint32_t v;
+    EXPECT_TRUE(x.pop(v));
+    EXPECT_EQ(v, 0U);
+    const uint32_t more[] {5, 6};
+    EXPECT_FALSE(x.push(more, 2));
+    EXPECT_TRUE(x.pop());
+    EXPECT_TRUE(x.push(more, 2));
+    for (uint32_t expected : {2U, 3U, 5U, 6U}) {
+        EXPECT_TRUE(x.pop(v));
+        EXPECT_EQ(v, expected);
+    }
+    EXPECT_TRUE(x.is_empty());
+}
+
 AP_GTEST_MAIN()
@@ -0,0 +1,46 @@
+#include <AP_gtest.h>
+
+#include <AP_HAL/utility/TripleBuffer.h>
+
+struct TestValue {
+    uint32_t a;
+    uint32_t b;
+};
+
+TEST(TripleBufferTest, Basic)
+{
+    TripleBuffer<TestValue> x;
+    EXPECT_FALSE(x.update());
+    EXPECT_EQ(x.front().a, 0U);
+
+    x.write(TestValue{1, 2});
+    EXPECT_TRUE(x.update());
+    EXPECT_EQ(x.front().a, 1U);
+    EXPECT_EQ(x.front().b, 2U);
+
+    // nothing new, front stays put
+    EXPECT_FALSE(x.update());
+    EXPECT_EQ(x.front().a, 1U);
+}
+
+TEST(TripleBufferTest, LatestWins)
+{
+    TripleBuffer<TestValue> x;
+    for (uint32_t i=1; i<=10; i++) {
+        x.back().a = i;
+        x.back().b = i*2;
+        x.publish();
+    }
+    EXPECT_TRUE(x.update());
+    EXPECT_EQ(x.front().a, 10U);
+    EXPECT_EQ(x.front().b, 20U);
+
+    // writing while the reader holds a value leaves that value alone
+    x.write(TestValue{11, 22});
+    EXPECT_EQ(x.front().a, 10U);
+    EXPECT_TRUE(x.update());
+    EXPECT_EQ(x.front().a, 11U);
+    EXPECT_EQ(x.front().b, 22U);
+}
+
+AP_GTEST_MAIN()
@@ -31,10 +31,24 @@
 #include <stdint.h>
 #include "xtoa_fast.h"
 
+/*
+  the conversions write the digits least significant first. Decimal
+  digits are produced two at a time from a table of pairs, which needs
+  one 32 bit division by a constant per pair
+ */
+static const char decimal_pairs[] =
+    "0001020304050607080910111213141516171819"
+    "2021222324252627282930313233343536373839"
+    "4041424344454647484950515253545556575859"
+    "6061626364656667686970717273747576777879"
+    "8081828384858687888990919293949596979899";
+
+static const char hex_digits[] = "0123456789ABCDEF";
+
 char * ultoa_invert (uint32_t val, char *s, uint8_t base) {
 	if (base == 8) {
 		do {
-			*s = '0' + (val & 0x7);
+			*s++ = '0' + (val & 0x7);
 			val >>= 3;
 		} while(val);
 		return s;
@@ -42,36 +56,26 @@ char * ultoa_invert (uint32_t val, char *s, uint8_t base) {
 
 	if (base == 16) {
 		do {
-			uint8_t digit = '0' + (val & 0xf);
-#if XTOA_UPPER == 0
-			if (digit > '0' + 9)
-				digit += ('a' - '0' - 10);
-#else
-			if (digit > '0' + 9)
-				digit += ('A' - '0' - 10);
-#endif
-			*s++ = digit;
+			*s++ = hex_digits[val & 0xf];
 			val >>= 4;
 		} while(val);
 		return s;
 	}
 
 	// Every base which in not hex and not oct is considered decimal.
-
-	// 33 bits would have been enough.
-	uint64_t xval = val;
-	do {
-		uint8_t saved = xval;
-		xval &= ~1;
-		xval += 2;
-		xval += xval >> 1;		// *1.5
-		xval += xval >> 4;		// *1.0625
-		xval += xval >> 8;		// *1.00390625
-		xval += xval >> 16;		// *1.000015259
-		xval += xval >> 32;		// it all amounts to *1.6
-		xval >>= 4;				// /16 ... so *1.6/16 is /10, fraction truncated.
-		*s++ = '0' + saved - 10 * (uint8_t)xval;
-	} while (xval);
+	while (val >= 100) {
+		const uint32_t q = val / 100;
+		const uint8_t r = val - q * 100;
+		*s++ = decimal_pairs[2*r+1];
+		*s++ = decimal_pairs[2*r];
+		val = q;
+	}
+	if (val >= 10) {
+		*s++ = decimal_pairs[2*val+1];
+		*s++ = decimal_pairs[2*val];
+	} else {
+		*s++ = '0' + val;
+	}
 	return s;
 }
 
@@ -79,7 +83,7 @@ char * ultoa_invert (uint32_t val, char *s, uint8_t base) {
 char * ulltoa_invert (uint64_t val, char *s, uint8_t base) {
 	if (base == 8) {
 		do {
-			*s = '0' + (val & 0x7);
+			*s++ = '0' + (val & 0x7);
 			val >>= 3;
 		} while(val);
 		return s;
@@ -87,15 +91,7 @@ char * ulltoa_invert (uint64_t val, char *s, uint8_t base) {
 
 	if (base == 16) {
 		do {
-			uint8_t digit = '0' + (val & 0xf);
-#if XTOA_UPPER == 0
-			if (digit > '0' + 9)
-				digit += ('a' - '0' - 10);
-#else
-			if (digit > '0' + 9)
-				digit += ('A' - '0' - 10);
-#endif
-			*s++ = digit;
+			*s++ = hex_digits[val & 0xf];
 			val >>= 4;
 		} while(val);
 		return s;
@@ -103,21 +99,16 @@ char * ulltoa_invert (uint64_t val, char *s, uint8_t base) {
 
 	// Every base which in not hex and not oct is considered decimal.
 
-	// 64 bits is not actually enough, we need 65, but it should
-	// be good enough for the log dumping we're using this for
-	uint64_t xval = val;
-	do {
-		uint8_t saved = xval;
-		xval &= ~1;
-		xval += 2;
-		xval += xval >> 1;		// *1.5
-		xval += xval >> 4;		// *1.0625
-		xval += xval >> 8;		// *1.00390625
-		xval += xval >> 16;		// *1.000015259
-		xval += xval >> 32;		// it all amounts to *1.6
-		xval >>= 4;				// /16 ... so *1.6/16 is /10, fraction truncated.
-		*s++ = '0' + saved - 10 * (uint8_t)xval;
-	} while (xval);
-	return s;
+	// take nine digits at a time with a 64 bit division, the rest
+	// is done in 32 bits
+	while (val > UINT32_MAX) {
+		const uint64_t q = val / 1000000000U;
+		char *end = ultoa_invert(uint32_t(val - q * 1000000000U), s, 10);
+		while (end < s + 9) {
+			*end++ = '0';
+		}
+		s = end;
+		val = q;
+	}
+	return ultoa_invert(uint32_t(val), s, 10);
 }
-
@@ -391,6 +391,7 @@ int16_t CANIface::send(const AP_HAL::CANFrame& frame, uint64_t tx_deadline,
         pending_tx_[index].loopback       = (flags & AP_HAL::CANIface::Loopback) != 0;
         pending_tx_[index].abort_on_error = (flags & AP_HAL::CANIface::AbortOnError) != 0;
         pending_tx_[index].index          = index;
+        pending_tx_[index].send_us        = AP_HAL::micros();
         // setup frame initial state
         pending_tx_[index].aborted        = false;
         pending_tx_[index].setup          = true;
@@ -754,7 +755,9 @@ void CANIface::setupMessageRam()
     MessageRam_.RxFIFO1SA = base + FDCAN_RXFIFO1_OFFSET;
     MessageRam_.TxFIFOQSA = base + FDCAN_TXFIFO_OFFSET;
 
-    can_->TXBC = 0; // fifo mode
+    // queue mode, so the hardware sends the highest priority pending
+    // frame first rather than in the order they were added
+    can_->TXBC = FDCAN_TXBC_TFQM;
 #else
     uint32_t num_elements = 0;
 
@@ -771,7 +774,10 @@ void CANIface::setupMessageRam()
     // Tx FIFO/queue start address and element count
     num_elements = MIN((FDCAN_TX_FIFO_BUFFER_SIZE/FDCAN_FRAME_BUFFER_SIZE), 32U);
     if (num_elements) {
-        can_->TXBC = (FDCANMessageRAMOffset_ << 2) | (num_elements << 24);
+        // queue mode, so the hardware sends the highest priority
+        // pending frame first. In FIFO mode a burst of low priority
+        // frames delays ESC commands queued behind it
+        can_->TXBC = (FDCANMessageRAMOffset_ << 2) | (num_elements << 24) | FDCAN_TXBC_TFQM;
         MessageRam_.TxFIFOQSA = SRAMCAN_BASE + (FDCANMessageRAMOffset_ * 4U);
         FDCANMessageRAMOffset_ += num_elements*FDCAN_FRAME_BUFFER_SIZE;
     }
@@ -795,6 +801,9 @@ void CANIface::handleTxCompleteInterrupt(const uint64_t timestamp_us)
                     stats.fdf_tx_success++;
                 }
                 pending_tx_[i].pushed = true;
+#if !defined(HAL_BOOTLOADER_BUILD)
+                update_tx_latency(pending_tx_[i].frame, uint32_t(timestamp_us) - pending_tx_[i].send_us);
+#endif
             } else {
                 continue;
             }
@@ -1130,6 +1139,7 @@ void CANIface::get_stats(ExpandingString &str)
                stats.fdf_rx_received,
                stats.fdf_tx_requests,
                stats.fdf_tx_success);
+    print_tx_latency(str);
 }
 #endif
 
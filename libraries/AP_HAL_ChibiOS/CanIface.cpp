@@ -356,6 +356,7 @@ int16_t CANIface::send(const AP_HAL::CANFrame& frame, uint64_t tx_deadline,
         txi.frame          = frame;
         txi.loopback       = (flags & Loopback) != 0;
         txi.abort_on_error = (flags & AbortOnError) != 0;
+        txi.send_us        = AP_HAL::micros();
         // setup frame initial state
         txi.pushed         = false;
     }
@@ -493,6 +494,9 @@ void CANIface::handleTxMailboxInterrupt(uint8_t mailbox_index, bool txok, const
     if (txok && !txi.pushed) {
         txi.pushed = true;
         PERF_STATS(stats.tx_success);
+#if !defined(HAL_BUILD_AP_PERIPH) && !defined(HAL_BOOTLOADER_BUILD)
+        update_tx_latency(txi.frame, uint32_t(timestamp_us) - txi.send_us);
+#endif
     }
 }
 
@@ -981,6 +985,7 @@ void CANIface::get_stats(ExpandingString &str)
                stats.num_busoff_err,
                stats.num_events,
                stats.esr);
+    print_tx_latency(str);
 }
 #endif
 
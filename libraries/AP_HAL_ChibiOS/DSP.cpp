@@ -49,6 +49,42 @@ extern const AP_HAL::HAL& hal;
 // for understanding the underlying theory although we do not use spectral density here since time resolution is equally
 // important as frequency resolution. Referred to as [Heinz] throughout the code.
 
+#if HAL_DSP_FIXED_POINT
+// initialize the FFT state machine
+AP_HAL::DSP::FFTWindowState* DSP::fft_init(uint16_t window_size, uint16_t sample_rate, uint8_t sliding_window_size)
+{
+    DSP::FFTWindowStateARMQ15* fft = new DSP::FFTWindowStateARMQ15(window_size, sample_rate, sliding_window_size);
+    if (fft == nullptr || fft->_hanning_window_q15 == nullptr || fft->_freq_bins == nullptr || fft->_derivative_freq_bins == nullptr) {
+        delete fft;
+        return nullptr;
+    }
+    return fft;
+}
+
+// start an FFT analysis
+void DSP::fft_start(FFTWindowState* state, FloatBuffer& samples, uint16_t advance)
+{
+    step_hanning_q15((FFTWindowStateARMQ15*)state, samples, advance);
+}
+
+// perform remaining steps of an FFT analysis
+uint16_t DSP::fft_analyse(AP_HAL::DSP::FFTWindowState* state, uint16_t start_bin, uint16_t end_bin, float noise_att_cutoff)
+{
+    FFTWindowStateARMQ15* fft = (FFTWindowStateARMQ15*)state;
+    step_arm_rfft_q15(fft);
+    step_cmplx_mag(fft, start_bin, end_bin, noise_att_cutoff);
+    return step_calc_frequencies(fft, start_bin, end_bin);
+}
+
+// track known peaks with Goertzel filters, which run on float samples
+uint16_t DSP::fft_track(AP_HAL::DSP::FFTWindowState* state, const float* peak_freqs_hz, const float* peak_widths_hz, uint16_t start_bin, uint16_t end_bin)
+{
+    FFTWindowStateARMQ15* fft = (FFTWindowStateARMQ15*)state;
+    arm_q15_to_float(fft->_samples_q15, fft->_freq_bins, fft->_window_size);
+    arm_scale_f32(fft->_freq_bins, fft->_sample_scale, fft->_freq_bins, fft->_window_size);
+    return AP_HAL::DSP::fft_track(fft, peak_freqs_hz, peak_widths_hz, start_bin, end_bin);
+}
+#else
 // initialize the FFT state machine
 AP_HAL::DSP::FFTWindowState* DSP::fft_init(uint16_t window_size, uint16_t sample_rate, uint8_t sliding_window_size)
 {
@@ -76,6 +112,7 @@ uint16_t DSP::fft_analyse(AP_HAL::DSP::FFTWindowState* state, uint16_t start_bin
     step_arm_cmplx_mag_f32(fft, start_bin, end_bin, noise_att_cutoff);
     return step_calc_frequencies_f32(fft, start_bin, end_bin);
 }
+#endif
 
 // create an instance of the FFT state machine
 DSP::FFTWindowStateARM::FFTWindowStateARM(uint16_t window_size, uint16_t sample_rate, uint8_t sliding_window_size)
@@ -118,6 +155,39 @@ DSP::FFTWindowStateARM::FFTWindowStateARM(uint16_t window_size, uint16_t sample_
 
 DSP::FFTWindowStateARM::~FFTWindowStateARM() {}
 
+// create an instance of the fixed point FFT state machine
+DSP::FFTWindowStateARMQ15::FFTWindowStateARMQ15(uint16_t window_size, uint16_t sample_rate, uint8_t sliding_window_size)
+    : AP_HAL::DSP::FFTWindowState::FFTWindowState(window_size, sample_rate, sliding_window_size, false)
+{
+    if (_freq_bins != nullptr && _derivative_freq_bins != nullptr) {
+        _hanning_window_q15 = (q15_t*)hal.util->malloc_type(sizeof(q15_t) * window_size, DSP_MEM_REGION);
+    }
+    if (_hanning_window_q15 == nullptr) {
+        GCS_SEND_TEXT(MAV_SEVERITY_WARNING, "Failed to allocate %u bytes for window %u for DSP",
+            unsigned(sizeof(float) * (window_size * 2 + 2)), unsigned(window_size));
+        return;
+    }
+    // the q15 FFT supports all of the window sizes, but links all of its twiddle tables
+    if (arm_rfft_init_q15(&_fft_instance, window_size, 0, 1) != ARM_MATH_SUCCESS) {
+        hal.util->free_type(_hanning_window_q15, sizeof(q15_t) * window_size, DSP_MEM_REGION);
+        _hanning_window_q15 = nullptr;
+        return;
+    }
+
+    // the derivative scratch space is only needed after the FFT
+    _samples_q15 = (q15_t*)_derivative_freq_bins;
+
+    for (uint16_t i = 0; i < window_size; i++) {
+        const float w = (0.5f - 0.5f * cosf(2.0f * M_PI * i / ((float)window_size - 1)));
+        arm_float_to_q15(&w, &_hanning_window_q15[i], 1);
+    }
+}
+
+DSP::FFTWindowStateARMQ15::~FFTWindowStateARMQ15()
+{
+    hal.util->free_type(_hanning_window_q15, sizeof(q15_t) * _window_size, DSP_MEM_REGION);
+}
+
 extern "C" {
     void stage_rfft_f32(arm_rfft_fast_instance_f32 *S, float32_t *p, float32_t *pOut);
     void arm_cfft_radix8by2_f32(arm_cfft_instance_f32 *S, float32_t *p1);
@@ -141,6 +211,55 @@ void DSP::step_hanning(FFTWindowStateARM* fft, FloatBuffer& samples, uint16_t ad
     TIMER_END(_hanning_timer);
 }
 
+// step 1: scale the incoming samples to the q15 range and filter them through a Hanning window
+void DSP::step_hanning_q15(FFTWindowStateARMQ15* fft, FloatBuffer& samples, uint16_t advance)
+{
+    TIMER_START(_hanning_timer);
+
+    // _freq_bins is free until the FFT so use it for the float samples
+    samples.peek(&fft->_freq_bins[0], fft->_window_size); // the caller ensures we get a full buffer of samples
+    samples.advance(advance);
+
+    // scale by the largest sample so that small vibrations keep their precision
+    float max_value, min_value;
+    uint32_t index;
+    arm_max_f32(&fft->_freq_bins[0], fft->_window_size, &max_value, &index);
+    arm_min_f32(&fft->_freq_bins[0], fft->_window_size, &min_value, &index);
+    fft->_sample_scale = MAX(max_value, -min_value);
+    if (!is_positive(fft->_sample_scale)) {
+        fft->_sample_scale = 1.0f;
+    }
+    arm_scale_f32(&fft->_freq_bins[0], 1.0f / fft->_sample_scale, &fft->_freq_bins[0], fft->_window_size);
+    arm_float_to_q15(&fft->_freq_bins[0], fft->_samples_q15, fft->_window_size);
+    arm_mult_q15(fft->_samples_q15, fft->_hanning_window_q15, fft->_samples_q15, fft->_window_size);
+
+    TIMER_END(_hanning_timer);
+}
+
+// steps 2-5: fixed point real FFT and magnitudes
+void DSP::step_arm_rfft_q15(FFTWindowStateARMQ15* fft)
+{
+    TIMER_START(_arm_cfft_f32_timer);
+
+    // the output is fft->_window_size complex values, which exactly fills _freq_bins
+    q15_t* rfft_data = (q15_t*)fft->_freq_bins;
+    arm_rfft_q15(&fft->_fft_instance, fft->_samples_q15, rfft_data);
+
+    // squared magnitudes of the bins up to and including the Nyquist, each output
+    // is written behind its input so this can be done in place
+    arm_cmplx_mag_squared_q15(rfft_data, rfft_data, fft->_num_stored_freqs);
+
+    // the FFT output is scaled down by window / 2 and the squared magnitude, as 3.13, by a further 4.
+    // Widen to float bin powers with the same scale as the float FFT, working backwards so that
+    // each float does not overwrite a q15 value that is still to be read
+    const float scale = sq(fft->_window_size * fft->_sample_scale) / 32768.0f;
+    for (int16_t i = fft->_num_stored_freqs - 1; i >= 0; i--) {
+        fft->_freq_bins[i] = rfft_data[i] * scale;
+    }
+
+    TIMER_END(_arm_cfft_f32_timer);
+}
+
 // step 2: guts of complex fft processing
 void DSP::step_arm_cfft_f32(FFTWindowStateARM* fft)
 {
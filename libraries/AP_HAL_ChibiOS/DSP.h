@@ -25,6 +25,11 @@
 
 #define DEBUG_FFT   0
 
+// boards with a slow FPU or little RAM can use a q15 FFT, which needs a little over half the memory
+#ifndef HAL_DSP_FIXED_POINT
+#define HAL_DSP_FIXED_POINT 0
+#endif
+
 // ChibiOS implementation of FFT analysis to run on STM32 processors
 class ChibiOS::DSP : public AP_HAL::DSP {
 public:
@@ -34,6 +39,10 @@ public:
     virtual void fft_start(FFTWindowState* state, FloatBuffer& samples, uint16_t advance) override;
     // perform remaining steps of an FFT analysis
     virtual uint16_t fft_analyse(FFTWindowState* state, uint16_t start_bin, uint16_t end_bin, float noise_att_cutoff) override;
+#if HAL_DSP_FIXED_POINT
+    // track known peaks with Goertzel filters
+    virtual uint16_t fft_track(FFTWindowState* state, const float* peak_freqs_hz, const float* peak_widths_hz, uint16_t start_bin, uint16_t end_bin) override;
+#endif
 
     // STM32-based FFT state
     class FFTWindowStateARM : public AP_HAL::DSP::FFTWindowState {
@@ -47,6 +56,26 @@ public:
         arm_rfft_fast_instance_f32 _fft_instance;
     };
 
+    // STM32-based fixed point FFT state. The Hanning window and windowed samples are held as q15, the windowed
+    // samples sharing the derivative scratch space, and the q15 FFT output is written to _freq_bins and then
+    // widened in place to float bin powers so that the float peak detection is unchanged
+    class FFTWindowStateARMQ15 : public AP_HAL::DSP::FFTWindowState {
+        friend class ChibiOS::DSP;
+    public:
+        FFTWindowStateARMQ15(uint16_t window_size, uint16_t sample_rate, uint8_t sliding_window_size);
+        virtual ~FFTWindowStateARMQ15();
+
+    private:
+        // underlying CMSIS data structure for FFT analysis
+        arm_rfft_instance_q15 _fft_instance;
+        // Hanning window for incoming samples
+        q15_t* _hanning_window_q15;
+        // windowed samples
+        q15_t* _samples_q15;
+        // scale of the windowed samples, chosen to use the full q15 range
+        float _sample_scale;
+    };
+
 protected:
     void vector_max_float(const float* vin, uint16_t len, float* maxValue, uint16_t* maxIndex) const override {
         uint32_t mindex;
@@ -73,6 +102,9 @@ private:
     void step_stage_rfft_f32(FFTWindowStateARM* fft);
     void step_arm_cmplx_mag_f32(FFTWindowStateARM* fft, uint16_t start_bin, uint16_t end_bin, float noise_att_cutoff);
     uint16_t step_calc_frequencies_f32(FFTWindowStateARM* fft, uint16_t start_bin, uint16_t end_bin);
+    // fixed point equivalents of the above
+    void step_hanning_q15(FFTWindowStateARMQ15* fft, FloatBuffer& samples, uint16_t advance);
+    void step_arm_rfft_q15(FFTWindowStateARMQ15* fft);
     // candan's frequency interpolator
     float calculate_candans_estimator(const FFTWindowStateARM* fft, uint16_t k) const;
 
@@ -52,6 +52,9 @@ extern AP_IOMCU iomcu;
 
 #define TELEM_IC_SAMPLE 16
 
+// resend unchanged serial LED frames this often
+#define SERIAL_LED_REFRESH_MS 1000
+
 struct RCOutput::pwm_group RCOutput::pwm_group_list[] = { HAL_PWM_GROUPS };
 struct RCOutput::irq_state RCOutput::irq;
 const uint8_t RCOutput::NUM_GROUPS = ARRAY_SIZE(RCOutput::pwm_group_list);
@@ -837,6 +840,8 @@ bool RCOutput::setup_group_DMA(pwm_group &group, uint32_t bitrate, uint32_t bit_
 
     // hold the lock during setup, to ensure there isn't a DMA operation ongoing
     group.dma_handle->lock();
+    // any serial LED data in the buffer is about to be lost
+    group.serial_led_encoded = false;
     if (!group.dma_buffer || buffer_length != group.dma_buffer_len) {
         if (group.dma_buffer) {
             hal.util->free_type(group.dma_buffer, group.dma_buffer_len, AP_HAL::Util::MEM_DMA_SAFE);
@@ -1459,12 +1464,15 @@ void RCOutput::dshot_send(pwm_group &group, uint32_t time_out_us)
             // retrieve the last erpm values
             const uint16_t erpm = group.bdshot.erpm[i];
 #if HAL_WITH_ESC_TELEM
-            // update the ESC telemetry data
-            if (erpm < 0xFFFF && group.bdshot.enabled) {
-                update_rpm(chan, erpm * 200 / _bdshot.motor_poles, get_erpm_error_rate(chan));
+            // update the ESC telemetry data, only channels decoded since the last
+            // send are published so stale values do not look like new samples
+            if ((group.bdshot.erpm_fresh_mask & (1U<<i)) && group.bdshot.enabled) {
+                update_rpm(chan, erpm * 200 / _bdshot.motor_poles, get_erpm_error_rate(chan),
+                           group.bdshot.erpm_sample_us[i]);
             }
 #endif
             _bdshot.erpm[chan] = erpm;
+            group.bdshot.erpm_fresh_mask &= ~(1U<<i);
 #endif
             if (safety_on && !(safety_mask & (1U<<(chan+chan_offset)))) {
                 // safety is on, don't output anything
@@ -1543,6 +1551,7 @@ bool RCOutput::serial_led_send(pwm_group &group)
 
         group.serial_led_pending = false;
         group.prepared_send = false;
+        group.serial_led_last_send_ms = AP_HAL::millis();
 
         // fill the DMA buffer while we have the lock
         fill_DMA_buffer_serial_led(group);
@@ -2203,26 +2212,38 @@ bool RCOutput::set_serial_led_num_LEDs(const uint16_t chan, uint8_t num_leds, ou
 
 #pragma GCC push_options
 #pragma GCC optimize("O2")
-// Fill the group DMA buffer with data to be output
+// Fill the group DMA buffer with data to be output. The buffer keeps
+// its contents between sends, so only LEDs that have changed since
+// the last fill are encoded again
 void RCOutput::fill_DMA_buffer_serial_led(pwm_group& group)
 {
-    memset(group.dma_buffer, 0, group.dma_buffer_len);
+    const bool full = !group.serial_led_encoded;
+    if (full) {
+        memset(group.dma_buffer, 0, group.dma_buffer_len);
+    }
     for (uint8_t j = 0; j < 4; j++) {
-        if (group.serial_led_data[j] == nullptr) {
+        if (group.serial_led_data[j] == nullptr || group.serial_led_encoded_data[j] == nullptr) {
             // something very bad has happended
             continue;
         }
 
         if (group.current_mode == MODE_PROFILED && (group.clock_mask & 1U<<j) != 0) {
             // output clock channel
-            for (uint8_t i = 0; i < group.serial_nleds; i++) {
-                _set_profiled_clock(&group, j, i);
+            if (full) {
+                for (uint8_t i = 0; i < group.serial_nleds; i++) {
+                    _set_profiled_clock(&group, j, i);
+                }
             }
             continue;
         }
 
         for (uint8_t i = 0; i < group.serial_nleds; i++) {
             const SerialLed& led = group.serial_led_data[j][i];
+            SerialLed& encoded = group.serial_led_encoded_data[j][i];
+            if (!full && memcmp(&led, &encoded, sizeof(led)) == 0) {
+                continue;
+            }
+            encoded = led;
             switch (group.current_mode) {
                 case MODE_NEOPIXEL:
                     _set_neopixel_rgb_data(&group, j, i, led.red, led.green, led.blue);
@@ -2240,6 +2261,7 @@ void RCOutput::fill_DMA_buffer_serial_led(pwm_group& group)
             }
         }
     }
+    group.serial_led_encoded = true;
 }
 
 /*
@@ -2346,11 +2368,16 @@ void RCOutput::set_serial_led_rgb_data(const uint16_t chan, int8_t led, uint8_t
             delete[] grp->serial_led_data[j];
             grp->serial_led_data[j] = nullptr;
             grp->serial_led_data[j] = new SerialLed[grp->serial_nleds];
-            if (grp->serial_led_data[j] == nullptr) {
+            delete[] grp->serial_led_encoded_data[j];
+            grp->serial_led_encoded_data[j] = nullptr;
+            grp->serial_led_encoded_data[j] = new SerialLed[grp->serial_nleds];
+            if (grp->serial_led_data[j] == nullptr || grp->serial_led_encoded_data[j] == nullptr) {
                 // if allocation failed clear all memory
                  for (uint8_t k = 0; k < 4; k++) {
                     delete[] grp->serial_led_data[k];
                     grp->serial_led_data[k] = nullptr;
+                    delete[] grp->serial_led_encoded_data[k];
+                    grp->serial_led_encoded_data[k] = nullptr;
                 }
                 grp->led_mode = MODE_PWM_NONE;
                 grp->serial_nleds = 0;
@@ -2408,6 +2435,25 @@ void RCOutput::serial_led_set_single_rgb_data(pwm_group& group, uint8_t idx, uin
     }
 }
 
+/*
+  true if the LED data differs from what is in the DMA buffer
+*/
+bool RCOutput::serial_led_changed(const pwm_group& group) const
+{
+    if (!group.serial_led_encoded) {
+        return true;
+    }
+    for (uint8_t j = 0; j < 4; j++) {
+        if (group.serial_led_data[j] == nullptr || group.serial_led_encoded_data[j] == nullptr) {
+            continue;
+        }
+        if (memcmp(group.serial_led_data[j], group.serial_led_encoded_data[j], group.serial_nleds * sizeof(SerialLed)) != 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
 /*
   trigger send of serial led data for one group
 */
@@ -2429,6 +2475,15 @@ void RCOutput::serial_led_send(const uint16_t chan)
         return;
     }
 
+    // unchanged frames are only sent occasionally, to recover LEDs
+    // that have lost power or missed a frame
+    if (grp->prepared_send && !serial_led_changed(*grp) &&
+        AP_HAL::millis() - grp->serial_led_last_send_ms < SERIAL_LED_REFRESH_MS) {
+        // as though it had been sent
+        grp->prepared_send = false;
+        return;
+    }
+
     if (grp->prepared_send) {
         chEvtSignal(rcout_thread_ctx, EVT_LED_SEND);
         grp->serial_led_pending = true;
@@ -336,6 +336,11 @@ private:
         // structure to hold serial LED data until it can be transferred
         // to the DMA buffer
         SerialLed* serial_led_data[4];
+        // the LED data last encoded into the DMA buffer, so only
+        // changed LEDs are encoded and unchanged frames aren't sent
+        SerialLed* serial_led_encoded_data[4];
+        bool serial_led_encoded;
+        uint32_t serial_led_last_send_ms;
 
         eventmask_t dshot_event_mask;
         thread_t* dshot_waiter;
@@ -367,6 +372,10 @@ private:
             uint8_t prev_telem_chan;
             uint16_t telempsc;
             uint32_t dma_buffer_copy[GCR_TELEMETRY_BUFFER_LEN];
+            // channels decoded since the last publish to ESC telemetry
+            uint8_t erpm_fresh_mask;
+            // estimated time the ESC sent the last decoded frame
+            uint32_t erpm_sample_us[4];
 #if RCOU_DSHOT_TIMING_DEBUG
             uint16_t telem_rate[4];
             uint16_t telem_err_rate[4];
@@ -593,6 +602,7 @@ private:
     bool serial_led_send(pwm_group &group);
     void serial_led_set_single_rgb_data(pwm_group& group, uint8_t idx, uint8_t led, uint8_t red, uint8_t green, uint8_t blue);
     void fill_DMA_buffer_serial_led(pwm_group& group);
+    bool serial_led_changed(const pwm_group& group) const;
     volatile bool serial_led_pending;
 
     void dma_allocate(Shared_DMA *ctx);
@@ -427,6 +427,12 @@ bool RCOutput::bdshot_decode_dshot_telemetry(pwm_group& group, uint8_t chan)
 
     group.dshot_state = DshotState::IDLE;
 
+    if (group.bdshot.erpm[chan] != 0xFFFF) {
+        // the ESC replies 30us after the end of the last pulse train, which has not been replaced yet
+        group.bdshot.erpm_sample_us[chan] = group.last_dmar_send_us + group.dshot_pulse_send_time_us + 30U;
+        group.bdshot.erpm_fresh_mask |= 1U<<chan;
+    }
+
 #if RCOU_DSHOT_TIMING_DEBUG
     // Record Stats
     if (group.bdshot.erpm[chan] != 0xFFFF) {
@@ -564,6 +570,10 @@ uint32_t RCOutput::bdshot_decode_telemetry_packet(uint32_t* buffer, uint32_t cou
                 break;
             }
             len = (diff + TELEM_IC_SAMPLE/2) / TELEM_IC_SAMPLE;
+            // GCR never has more than three zeros in a row, anything else is noise
+            if (len == 0 || len > 4) {
+                return 0xffff;
+            }
         } else {
             len = 21 - bits;
         }
@@ -577,14 +587,25 @@ uint32_t RCOutput::bdshot_decode_telemetry_packet(uint32_t* buffer, uint32_t cou
         return 0xffff;
     }
 
-    static const uint32_t decode[32] = {
-        0, 0, 0, 0, 0, 0, 0, 0, 0, 9, 10, 11, 0, 13, 14, 15,
-        0, 0, 2, 3, 0, 5, 6, 7, 0, 0, 8, 1, 0, 4, 12, 0 };
+    // GCR quintet to nibble, codes that are not valid GCR map to GCR_INVALID
+#define GCR_INVALID 0x10
+    static const uint8_t decode[32] = {
+        GCR_INVALID, GCR_INVALID, GCR_INVALID, GCR_INVALID, GCR_INVALID, GCR_INVALID, GCR_INVALID, GCR_INVALID,
+        GCR_INVALID, 9, 10, 11, GCR_INVALID, 13, 14, 15,
+        GCR_INVALID, GCR_INVALID, 2, 3, GCR_INVALID, 5, 6, 7,
+        GCR_INVALID, 0, 8, 1, GCR_INVALID, 4, 12, GCR_INVALID };
+
+    const uint8_t n0 = decode[value & 0x1f];
+    const uint8_t n1 = decode[(value >> 5) & 0x1f];
+    const uint8_t n2 = decode[(value >> 10) & 0x1f];
+    const uint8_t n3 = decode[(value >> 15) & 0x1f];
+    // reject corrupt frames before they reach the checksum, which only catches some of them
+    if ((n0 | n1 | n2 | n3) & GCR_INVALID) {
+        return 0xffff;
+    }
+#undef GCR_INVALID
 
-    uint32_t decodedValue = decode[value & 0x1f];
-    decodedValue |= decode[(value >> 5) & 0x1f] << 4;
-    decodedValue |= decode[(value >> 10) & 0x1f] << 8;
-    decodedValue |= decode[(value >> 15) & 0x1f] << 12;
+    uint32_t decodedValue = n0 | (n1 << 4) | (n2 << 8) | (n3 << 12);
 
     uint32_t csum = decodedValue;
     csum = csum ^ (csum >> 8); // xor bytes
@@ -80,6 +80,12 @@ SPIBus::SPIBus(uint8_t _bus) :
 {
     chMtxObjectInit(&dma_lock);
 
+#if AP_HAL_SEMAPHORE_STATS_ENABLED
+    char name[8];
+    snprintf(name, sizeof(name), "SPI%u", unsigned(bus));
+    semaphore.set_name(name);
+#endif
+
     // allow for sharing of DMA channels with other peripherals
     dma_handle = new Shared_DMA(spi_devices[bus].dma_channel_rx,
                                 spi_devices[bus].dma_channel_tx,
@@ -220,6 +226,84 @@ bool SPIDevice::do_transfer(const uint8_t *send, uint8_t *recv, uint32_t len)
     return ret;
 }
 
+/*
+  start an asynchronous transfer. Chip select and the DMA channel stay
+  held until transfer_finish()
+ */
+bool SPIDevice::transfer_start(const uint8_t *send, uint8_t *recv, uint32_t len)
+{
+#if defined(HAL_SPI_USE_POLLED)
+    return false;
+#else
+    if (!bus.semaphore.check_owner() || async.active || len == 0) {
+        return false;
+    }
+    const bool old_cs_forced = cs_forced;
+    if (!set_chip_select(true)) {
+        return false;
+    }
+    const uint8_t *dma_send = send;
+    uint8_t *dma_recv = recv;
+    if (!bus.bouncebuffer_setup(dma_send, len, dma_recv, len)) {
+        set_chip_select(old_cs_forced);
+        return false;
+    }
+    async.send = send;
+    async.recv = recv;
+    async.len = len;
+    async.old_cs_forced = old_cs_forced;
+    async.active = true;
+
+    osalSysLock();
+    hal.util->persistent_data.spi_count++;
+    if (dma_send == nullptr) {
+        spiStartReceiveI(spi_devices[device_desc.bus].driver, len, dma_recv);
+    } else if (dma_recv == nullptr) {
+        spiStartSendI(spi_devices[device_desc.bus].driver, len, dma_send);
+    } else {
+        spiStartExchangeI(spi_devices[device_desc.bus].driver, len, dma_send, dma_recv);
+    }
+    osalSysUnlock();
+    return true;
+#endif
+}
+
+/*
+  wait for a transfer started with transfer_start()
+ */
+bool SPIDevice::transfer_finish()
+{
+#if defined(HAL_SPI_USE_POLLED)
+    return false;
+#else
+    if (!async.active) {
+        return false;
+    }
+    async.active = false;
+
+    SPIDriver *spip = spi_devices[device_desc.bus].driver;
+    const uint32_t timeout_us = 20000U + async.len * 32U;
+    msg_t msg = MSG_OK;
+    osalSysLock();
+    if (spip->state == SPI_ACTIVE) {
+        // if the transfer has already completed there is no wakeup to wait for
+        msg = osalThreadSuspendTimeoutS(&spip->thread, TIME_US2I(timeout_us));
+    }
+    osalSysUnlock();
+    bool ret = true;
+    if (msg == MSG_TIMEOUT) {
+        ret = false;
+        if (!hal.scheduler->in_expected_delay()) {
+            INTERNAL_ERROR(AP_InternalError::error_t::spi_fail);
+        }
+        spiAbort(spip);
+    }
+    bus.bouncebuffer_finish(async.send, async.recv, async.len);
+    set_chip_select(async.old_cs_forced);
+    return ret;
+#endif
+}
+
 /*
   this pulses the clock for n bytes. The data is ignored.
  */
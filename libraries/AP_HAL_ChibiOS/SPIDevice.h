@@ -85,6 +85,12 @@ public:
     bool transfer_fullduplex(const uint8_t *send, uint8_t *recv,
                              uint32_t len) override;
 
+    /* See AP_HAL::Device::transfer_start() */
+    bool transfer_start(const uint8_t *send, uint8_t *recv, uint32_t len) override;
+
+    /* See AP_HAL::Device::transfer_finish() */
+    bool transfer_finish() override;
+
     /*
         Links the bank select callback to the spi bus, so that even when
         used outside of the driver bank selection can be done.
@@ -148,6 +154,15 @@ private:
     uint32_t derive_freq_flag(uint32_t _frequency);
     // low level transfer function
     bool do_transfer(const uint8_t *send, uint8_t *recv, uint32_t len) WARN_IF_UNUSED;
+
+    // transfer started with transfer_start()
+    struct {
+        const uint8_t *send;
+        uint8_t *recv;
+        uint32_t len;
+        bool old_cs_forced;
+        bool active;
+    } async;
 };
 
 class SPIDeviceManager : public AP_HAL::SPIDeviceManager {
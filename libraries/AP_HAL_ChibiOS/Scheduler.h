@@ -134,7 +134,7 @@ public:
     /*
       create a new thread
      */
-    bool thread_create(AP_HAL::MemberProc, const char *name, uint32_t stack_size, priority_base base, int8_t priority) override;
+    bool thread_create(AP_HAL::MemberProc, const char *name, uint32_t stack_size, priority_base base, int8_t priority, int8_t cpu = -1) override;
 
     // pat the watchdog
     void watchdog_pat(void);
@@ -37,6 +37,9 @@ Semaphore::Semaphore()
 bool Semaphore::give()
 {
     mutex_t *mtx = (mutex_t *)_lock;
+#if AP_HAL_SEMAPHORE_STATS_ENABLED
+    stats_give();
+#endif
     chMtxUnlock(mtx);
     return true;
 }
@@ -45,7 +48,17 @@ bool Semaphore::take(uint32_t timeout_ms)
 {
     mutex_t *mtx = (mutex_t *)_lock;
     if (timeout_ms == HAL_SEMAPHORE_BLOCK_FOREVER) {
+#if AP_HAL_SEMAPHORE_STATS_ENABLED
+        if (chMtxTryLock(mtx)) {
+            stats_taken(false, 0);
+            return true;
+        }
+        const uint32_t wait_start_us = AP_HAL::micros();
         chMtxLock(mtx);
+        stats_taken(true, wait_start_us);
+#else
+        chMtxLock(mtx);
+#endif
         return true;
     }
     if (take_nonblocking()) {
@@ -54,7 +67,10 @@ bool Semaphore::take(uint32_t timeout_ms)
     uint64_t start = AP_HAL::micros64();
     do {
         hal.scheduler->delay_microseconds(200);
-        if (take_nonblocking()) {
+        if (try_lock()) {
+#if AP_HAL_SEMAPHORE_STATS_ENABLED
+            stats_taken(true, uint32_t(start));
+#endif
             return true;
         }
     } while ((AP_HAL::micros64() - start) < timeout_ms*1000);
@@ -62,6 +78,17 @@ bool Semaphore::take(uint32_t timeout_ms)
 }
 
 bool Semaphore::take_nonblocking()
+{
+    if (!try_lock()) {
+        return false;
+    }
+#if AP_HAL_SEMAPHORE_STATS_ENABLED
+    stats_taken(false, 0);
+#endif
+    return true;
+}
+
+bool Semaphore::try_lock()
 {
     mutex_t *mtx = (mutex_t *)_lock;
     return chMtxTryLock(mtx);
@@ -33,6 +33,9 @@ public:
     bool check_owner(void);
     void assert_owner(void);
 protected:
+    // take the semaphore if it is free, without updating statistics
+    bool try_lock();
+
     // to avoid polluting the global namespace with the 'ch' variable,
     // we declare the lock as a uint32_t array, and cast inside the cpp file
     uint32_t _lock[5];
@@ -241,6 +241,23 @@ void Storage::write_block(uint16_t loc, const void *src, size_t n)
         WITH_SEMAPHORE(sem);
         memcpy(&_buffer[loc], src, n);
         _mark_dirty(loc, n);
+        _last_dirty_ms = AP_HAL::millis();
+    }
+}
+
+void Storage::begin_batch(void)
+{
+    WITH_SEMAPHORE(sem);
+    if (_batch_depth++ == 0) {
+        _batch_start_ms = AP_HAL::millis();
+    }
+}
+
+void Storage::end_batch(void)
+{
+    WITH_SEMAPHORE(sem);
+    if (_batch_depth > 0 && --_batch_depth == 0) {
+        _batch_ended = true;
     }
 }
 
@@ -249,13 +266,43 @@ void Storage::_timer_tick(void)
     if (_initialisedType == StorageBackend::None) {
         return;
     }
+    const uint32_t now = AP_HAL::millis();
+#ifdef STORAGE_FLASH_PAGE
+    if (_initialisedType == StorageBackend::Flash) {
+        // carry forward a little of the data in the full sector, so
+        // no single tick has to write all of it
+        EXPECT_DELAY_MS(1);
+        _flash.compact_step();
+    }
+#endif
     if (_dirty_mask.empty()) {
-        _last_empty_ms = AP_HAL::millis();
+        _last_empty_ms = now;
+        _batch_ended = false;
+#ifdef STORAGE_FLASH_PAGE
+        if (_initialisedType == StorageBackend::Flash) {
+            _flash_erase_idle(now);
+        }
+#endif
         return;
     }
 
-    // write out the first dirty line. We don't write more
-    // than one to keep the latency of this call to a minimum
+    if (_batch_depth > 0 && now - _batch_start_ms < HAL_STORAGE_BATCH_MAX_MS) {
+        // hold the lines back until the batch ends
+        return;
+    }
+
+#ifdef STORAGE_FLASH_PAGE
+    if (_initialisedType == StorageBackend::Flash && !_batch_ended &&
+        now - _last_dirty_ms < HAL_STORAGE_FLASH_COALESCE_MS &&
+        now - _last_empty_ms < HAL_STORAGE_FLASH_COALESCE_MAX_MS) {
+        // wait for the writes to settle so each line is written once
+        return;
+    }
+#endif
+
+    // write out the first dirty line, or on flash the run of dirty
+    // lines starting there. We don't write more than that to keep the
+    // latency of this call to a minimum
     uint16_t i;
     for (i=0; i<CH_STORAGE_NUM_LINES; i++) {
         if (_dirty_mask.get(i)) {
@@ -267,10 +314,23 @@ void Storage::_timer_tick(void)
         return;
     }
 
+    // on flash a run of dirty lines costs much less as one write, as
+    // block headers and flash word padding are shared
+    uint16_t nlines = 1;
+#ifdef STORAGE_FLASH_PAGE
+    if (_initialisedType == StorageBackend::Flash) {
+        while (nlines < CH_STORAGE_WRITE_LINES &&
+               i+nlines < CH_STORAGE_NUM_LINES &&
+               _dirty_mask.get(i+nlines)) {
+            nlines++;
+        }
+    }
+#endif
+
     {
-        // take a copy of the line we are writing with a semaphore held
+        // take a copy of the lines we are writing with a semaphore held
         WITH_SEMAPHORE(sem);
-        memcpy(tmpline, &_buffer[CH_STORAGE_LINE_SIZE*i], CH_STORAGE_LINE_SIZE);
+        memcpy(tmpline, &_buffer[CH_STORAGE_LINE_SIZE*i], CH_STORAGE_LINE_SIZE*nlines);
     }
 
     bool write_ok = false;
@@ -302,7 +362,7 @@ void Storage::_timer_tick(void)
 #ifdef STORAGE_FLASH_PAGE
     if (_initialisedType == StorageBackend::Flash) {
         // save to storage backend
-        if (_flash_write(i)) {
+        if (_flash_write(i, nlines)) {
             write_ok = true;
         }
     }
@@ -310,14 +370,16 @@ void Storage::_timer_tick(void)
 
     if (write_ok) {
         WITH_SEMAPHORE(sem);
-        // while holding the semaphore we check if the copy of the
+        // while holding the semaphore we check if the copy of each
         // line is different from the original line. If it is
         // different then someone has re-dirtied the line while we
         // were writing it, in which case we should not mark it
         // clean. If it matches then we know we can mark the line as
         // clean
-        if (memcmp(tmpline, &_buffer[CH_STORAGE_LINE_SIZE*i], CH_STORAGE_LINE_SIZE) == 0) {
-            _dirty_mask.clear(i);
+        for (uint16_t n=0; n<nlines; n++) {
+            if (memcmp(&tmpline[CH_STORAGE_LINE_SIZE*n], &_buffer[CH_STORAGE_LINE_SIZE*(i+n)], CH_STORAGE_LINE_SIZE) == 0) {
+                _dirty_mask.clear(i+n);
+            }
         }
     }
 }
@@ -341,18 +403,39 @@ void Storage::_flash_load(void)
 }
 
 /*
-  write one storage line. This also updates _dirty_mask.
+  write nlines contiguous storage lines starting at line
 */
-bool Storage::_flash_write(uint16_t line)
+bool Storage::_flash_write(uint16_t line, uint16_t nlines)
 {
 #ifdef STORAGE_FLASH_PAGE
     EXPECT_DELAY_MS(1);
-    return _flash.write(line*CH_STORAGE_LINE_SIZE, CH_STORAGE_LINE_SIZE);
+    return _flash.write(line*CH_STORAGE_LINE_SIZE, nlines*CH_STORAGE_LINE_SIZE);
 #else
     return false;
 #endif
 }
 
+/*
+  once the full sector holds nothing that isn't in the current sector,
+  erase it while erasing is allowed and storage has been idle for a
+  while, so the next sector switch needs no erase
+*/
+void Storage::_flash_erase_idle(uint32_t now_ms)
+{
+#ifdef STORAGE_FLASH_PAGE
+    if (now_ms - _last_dirty_ms < HAL_STORAGE_FLASH_ERASE_IDLE_MS ||
+        now_ms - _last_erase_ms < HAL_STORAGE_FLASH_ERASE_IDLE_MS ||
+        !_flash.erase_due() ||
+        !_flash_erase_ok()) {
+        return;
+    }
+    _last_erase_ms = now_ms;
+    if (!_flash.erase_full_sector()) {
+        ::printf("Storage: early sector erase failed\n");
+    }
+#endif
+}
+
 /*
   callback to write data to flash
  */
@@ -47,6 +47,41 @@
 static_assert(CH_STORAGE_SIZE % CH_STORAGE_LINE_SIZE == 0,
               "Storage is not multiple of line size");
 
+#ifdef STORAGE_FLASH_PAGE
+// flash writes are held back until storage has been unchanged for
+// HAL_STORAGE_FLASH_COALESCE_MS, but for no longer than
+// HAL_STORAGE_FLASH_COALESCE_MAX_MS, so a burst of parameter saves is
+// written once as runs of up to HAL_STORAGE_FLASH_COALESCE_LINES
+// contiguous dirty lines rather than as many single line writes
+#ifndef HAL_STORAGE_FLASH_COALESCE_MS
+#define HAL_STORAGE_FLASH_COALESCE_MS 100
+#endif
+#ifndef HAL_STORAGE_FLASH_COALESCE_MAX_MS
+#define HAL_STORAGE_FLASH_COALESCE_MAX_MS 1000
+#endif
+#ifndef HAL_STORAGE_FLASH_COALESCE_LINES
+#define HAL_STORAGE_FLASH_COALESCE_LINES 8
+#endif
+
+// once the data in the full sector has been carried forward, the
+// full sector is erased early while disarmed and after storage has
+// been idle for HAL_STORAGE_FLASH_ERASE_IDLE_MS, instead of when a
+// write runs out of space
+#ifndef HAL_STORAGE_FLASH_ERASE_IDLE_MS
+#define HAL_STORAGE_FLASH_ERASE_IDLE_MS 5000
+#endif
+
+#define CH_STORAGE_WRITE_LINES HAL_STORAGE_FLASH_COALESCE_LINES
+#else
+#define CH_STORAGE_WRITE_LINES 1
+#endif
+
+// a batch of writes that is not ended within this time is written
+// anyway, so a missing end_batch() can't stop storage being saved
+#ifndef HAL_STORAGE_BATCH_MAX_MS
+#define HAL_STORAGE_BATCH_MAX_MS 10000
+#endif
+
 class ChibiOS::Storage : public AP_HAL::Storage {
 public:
     void init() override {}
@@ -58,6 +93,9 @@ public:
     bool healthy(void) override;
     bool get_storage_ptr(void *&ptr, size_t &size) override;
 
+    void begin_batch(void) override;
+    void end_batch(void) override;
+
 private:
     enum class StorageBackend: uint8_t {
         None,
@@ -73,7 +111,7 @@ private:
     uint8_t _buffer[CH_STORAGE_SIZE] __attribute__((aligned(4)));
     Bitmask<CH_STORAGE_NUM_LINES> _dirty_mask;
     HAL_Semaphore sem;
-    uint8_t tmpline[CH_STORAGE_LINE_SIZE];
+    uint8_t tmpline[CH_STORAGE_LINE_SIZE*CH_STORAGE_WRITE_LINES];
 
     bool _flash_write_data(uint8_t sector, uint32_t offset, const uint8_t *data, uint16_t length);
     bool _flash_read_data(uint8_t sector, uint32_t offset, uint8_t *data, uint16_t length);
@@ -83,6 +121,11 @@ private:
     bool _flash_failed;
     uint32_t _last_re_init_ms;
     uint32_t _last_empty_ms;
+    uint32_t _last_dirty_ms;
+    uint32_t _last_erase_ms;
+    uint32_t _batch_start_ms;
+    uint8_t _batch_depth;
+    bool _batch_ended;      // a batch has ended, write without waiting for more changes
 
 #ifdef STORAGE_FLASH_PAGE
     AP_FlashStorage _flash{_buffer,
@@ -94,7 +137,8 @@ private:
 #endif
 
     void _flash_load(void);
-    bool _flash_write(uint16_t line);
+    bool _flash_write(uint16_t line, uint16_t nlines);
+    void _flash_erase_idle(uint32_t now_ms);
 
 #if HAL_WITH_RAMTRON
     AP_RAMTRON fram;
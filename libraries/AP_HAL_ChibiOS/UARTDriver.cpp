@@ -306,8 +306,30 @@ void UARTDriver::begin(uint32_t b, uint16_t rxS, uint16_t txS)
             rx_bounce_buf[1] = (uint8_t *)hal.util->malloc_type(RX_BOUNCE_BUFSIZE, AP_HAL::Util::MEM_DMA_SAFE);
         }
     }
-    if (tx_bounce_buf == nullptr && sdef.dma_tx && !(_last_options & OPTION_NODMA_TX)) {
-        tx_bounce_buf = (uint8_t *)hal.util->malloc_type(TX_BOUNCE_BUFSIZE, AP_HAL::Util::MEM_DMA_SAFE);
+    if (sdef.dma_tx && !(_last_options & OPTION_NODMA_TX)) {
+        // size each half for about 1ms of data, so high baudrates
+        // need fewer DMA transfers
+        const uint16_t tx_size = constrain_uint32(((_baudrate / 10000U) + 63U) & ~63U,
+                                                  TX_BOUNCE_BUFSIZE, TX_BOUNCE_BUFSIZE_MAX);
+        if (tx_bounce_buf != nullptr && tx_bounce_size < tx_size) {
+            // grow for a higher baudrate once the TX thread is not using it
+            _tx_initialised = false;
+            while (_in_tx_timer) {
+                hal.scheduler->delay(1);
+            }
+            hal.util->free_type(tx_bounce_buf, 2*tx_bounce_size, AP_HAL::Util::MEM_DMA_SAFE);
+            tx_bounce_buf = nullptr;
+        }
+        if (tx_bounce_buf == nullptr) {
+            tx_bounce_size = tx_size;
+            tx_bounce_buf = (uint8_t *)hal.util->malloc_type(2*tx_bounce_size, AP_HAL::Util::MEM_DMA_SAFE);
+            if (tx_bounce_buf == nullptr && tx_bounce_size > TX_BOUNCE_BUFSIZE) {
+                tx_bounce_size = TX_BOUNCE_BUFSIZE;
+                tx_bounce_buf = (uint8_t *)hal.util->malloc_type(2*tx_bounce_size, AP_HAL::Util::MEM_DMA_SAFE);
+            }
+            tx_bounce_idx = 0;
+            tx_bounce_len = 0;
+        }
     }
     if (half_duplex) {
         rx_dma_enabled = tx_dma_enabled = false;
@@ -350,6 +372,12 @@ void UARTDriver::begin(uint32_t b, uint16_t rxS, uint16_t txS)
     if (clear_buffers) {
         _writebuf.clear();
     }
+#ifndef HAL_UART_NODMA
+    if (clear_buffers || !_tx_initialised) {
+        // drop bytes copied for the next DMA transfer
+        tx_bounce_len = 0;
+    }
+#endif
 
     if (sdef.is_usb) {
 #ifdef HAVE_USB_SERIAL
@@ -625,6 +653,9 @@ void UARTDriver::end()
 
     _readbuf.set_size(0);
     _writebuf.set_size(0);
+#ifndef HAL_UART_NODMA
+    tx_bounce_len = 0;
+#endif
 }
 
 void UARTDriver::flush()
@@ -736,6 +767,33 @@ ssize_t UARTDriver::read(uint8_t *buffer, uint16_t count)
     return ret;
 }
 
+/*
+  access received data in place. Only the reading thread may call
+  these, and the receive path only appends, so no lock is needed
+ */
+uint8_t UARTDriver::rx_peek(ByteBuffer::IoVec vec[2])
+{
+    if (lock_read_key != 0 || _uart_owner_thd != chThdGetSelfX()) {
+        return 0;
+    }
+    if (!_rx_initialised) {
+        return 0;
+    }
+    return _readbuf.peekiovec(vec, _readbuf.available());
+}
+
+bool UARTDriver::rx_consume(uint32_t len)
+{
+    if (lock_read_key != 0 || _uart_owner_thd != chThdGetSelfX()) {
+        return false;
+    }
+    const bool ret = _readbuf.advance(len);
+    if (!_rts_is_active) {
+        update_rts_line();
+    }
+    return ret;
+}
+
 int16_t UARTDriver::read()
 {
     if (_uart_owner_thd != chThdGetSelfX()) {
@@ -822,6 +880,38 @@ size_t UARTDriver::write(const uint8_t *buffer, size_t size)
     return ret;
 }
 
+/*
+  reserve len bytes of the write buffer. The write mutex is held until
+  tx_commit()
+ */
+uint8_t UARTDriver::tx_reserve(ByteBuffer::IoVec vec[2], uint32_t len)
+{
+    if (!_tx_initialised || lock_write_key != 0 ||
+        (_blocking_writes && !unbuffered_writes)) {
+        return 0;
+    }
+    _write_mutex.take_blocking();
+    if (_writebuf.space() < len) {
+        _write_mutex.give();
+        return 0;
+    }
+    const uint8_t n = _writebuf.reserve(vec, len);
+    if (n == 0) {
+        _write_mutex.give();
+    }
+    return n;
+}
+
+bool UARTDriver::tx_commit(uint32_t len)
+{
+    const bool ret = _writebuf.commit(len);
+    if (unbuffered_writes) {
+        chEvtSignal(uart_thread_ctx, EVT_TRANSMIT_DATA_READY);
+    }
+    _write_mutex.give();
+    return ret;
+}
+
 /*
   lock the uart for exclusive use by write_locked() and read_locked() with the right key
  */
@@ -897,7 +987,31 @@ __RAMFUNC__ void UARTDriver::tx_complete(void* self, uint32_t flags)
 }
 
 /*
-  write out pending bytes with DMA
+  copy up to len bytes, starting ofs bytes into the write buffer, into
+  the TX bounce buffer half not being sent
+ */
+uint16_t UARTDriver::tx_bounce_prefetch(uint32_t ofs, uint16_t len)
+{
+    ByteBuffer::IoVec vec[2];
+    const auto n_vec = _writebuf.peekiovec(vec, ofs + len);
+    uint8_t *dest = &tx_bounce_buf[(tx_bounce_idx^1) * tx_bounce_size];
+    uint16_t copied = 0;
+    for (uint8_t i = 0; i < n_vec; i++) {
+        if (ofs >= vec[i].len) {
+            ofs -= vec[i].len;
+            continue;
+        }
+        memcpy(&dest[copied], vec[i].data + ofs, vec[i].len - ofs);
+        copied += vec[i].len - ofs;
+        ofs = 0;
+    }
+    return copied;
+}
+
+/*
+  write out pending bytes with DMA. The next transfer is copied into
+  the other bounce buffer half while the current one runs, and the
+  DMA channel is kept between transfers when no other driver wants it
  */
 void UARTDriver::write_pending_bytes_DMA(uint32_t n)
 {
@@ -906,33 +1020,39 @@ void UARTDriver::write_pending_bytes_DMA(uint32_t n)
         return;
     }
 
+    bool locked = false;
+
     while (n > 0) {
         if (_flow_control != FLOW_CONTROL_DISABLE &&
             acts_line != 0 &&
             palReadLine(acts_line)) {
             // we are using hw flow control and the CTS line is high. We
             // will hold off trying to transmit until the CTS line goes
-            // low to indicate the receiver has space. We do this before
-            // we take the DMA lock to prevent a high CTS line holding a
-            // DMA channel that may be needed by another device
-            return;
+            // low to indicate the receiver has space. We release the
+            // DMA lock to prevent a high CTS line holding a DMA
+            // channel that may be needed by another device
+            break;
         }
 
+        uint8_t *tx_buf = &tx_bounce_buf[tx_bounce_idx * tx_bounce_size];
         uint16_t tx_len = 0;
 
-        {
-            WITH_SEMAPHORE(_write_mutex);
-            // get some more to write
-            tx_len = _writebuf.peekbytes(tx_bounce_buf, MIN(n, TX_BOUNCE_BUFSIZE));
+        // get some more to write, unless copied during the last transfer
+        if (tx_bounce_len == 0) {
+            tx_bounce_len = _writebuf.peekbytes(tx_buf, MIN(n, tx_bounce_size));
+        }
+        tx_len = tx_bounce_len;
 
-            if (tx_len == 0) {
-                return; // all done
-            }
-            // find out how much is still left to write while we still have the lock
-            n = MIN(_writebuf.available(), n);
+        if (tx_len == 0) {
+            break; // all done
         }
+        // find out how much is still left to write
+        n = MIN(_writebuf.available(), n);
 
-        dma_handle->lock(); // we have our own thread so grab the lock
+        if (!locked) {
+            dma_handle->lock(); // we have our own thread so grab the lock
+            locked = true;
+        }
 
         chEvtGetAndClearEvents(EVT_TRANSMIT_DMA_COMPLETE);
 
@@ -947,6 +1067,8 @@ void UARTDriver::write_pending_bytes_DMA(uint32_t n)
                     // transmits on this low baudrate UART
                     tx_dma_enabled = false;
                     dma_handle->unlock(false);
+                    locked = false;
+                    tx_bounce_len = 0;
                     break;
                 }
             }
@@ -964,10 +1086,12 @@ void UARTDriver::write_pending_bytes_DMA(uint32_t n)
             contention_counter--;
         }
 
+        const uint16_t tx_requested = tx_len;
+
         chSysLock();
         dmaStreamDisable(txdma);
-        stm32_cacheBufferFlush(tx_bounce_buf, tx_len);
-        dmaStreamSetMemory0(txdma, tx_bounce_buf);
+        stm32_cacheBufferFlush(tx_buf, tx_len);
+        dmaStreamSetMemory0(txdma, tx_buf);
         dmaStreamSetTransactionSize(txdma, tx_len);
         uint32_t dmamode = STM32_DMA_CR_DMEIE | STM32_DMA_CR_TEIE;
         dmamode |= STM32_DMA_CR_CHSEL(sdef.dma_tx_channel_id);
@@ -980,6 +1104,13 @@ void UARTDriver::write_pending_bytes_DMA(uint32_t n)
         dmaStreamEnable(txdma);
         uint32_t timeout_us = ((1000000UL * (tx_len+2) * 10) / _baudrate) + 500;
         chSysUnlock();
+
+        // copy the next transfer while this one runs
+        uint16_t next_len = 0;
+        if (n > tx_len) {
+            next_len = tx_bounce_prefetch(tx_len, MIN(n - tx_len, tx_bounce_size));
+        }
+
         // wait for the completion or timeout handlers to signal that we are done
         eventmask_t mask = chEvtWaitAnyTimeout(EVT_TRANSMIT_DMA_COMPLETE, chTimeUS2I(timeout_us));
         // handle a TX timeout. This can happen with using hardware flow
@@ -1006,11 +1137,17 @@ void UARTDriver::write_pending_bytes_DMA(uint32_t n)
             chEvtGetAndClearEventsI(EVT_TRANSMIT_DMA_COMPLETE);
             chSysUnlock();
         }
-        // clean up pending locks
-        dma_handle->unlock(mask & EVT_TRANSMIT_DMA_COMPLETE);
+
+        if (tx_len == tx_requested && tx_len == tx_bounce_len) {
+            // the whole half was sent, the copied half is next
+            tx_bounce_idx ^= 1;
+            tx_bounce_len = next_len;
+        } else {
+            // a partial transfer, copy again from the write buffer
+            tx_bounce_len = 0;
+        }
 
         if (tx_len) {
-            WITH_SEMAPHORE(_write_mutex);
             // skip over amount actually written
             _writebuf.advance(tx_len);
 
@@ -1019,13 +1156,26 @@ void UARTDriver::write_pending_bytes_DMA(uint32_t n)
             _tx_stats_bytes += tx_len;
 
             n -= tx_len;
-        } else {
+        }
+
+        // clean up pending locks, keeping the channel for the next
+        // transfer if nobody else is waiting for it
+        if (tx_len == 0 || n == 0 || mask == 0 || dma_handle->has_contention()) {
+            dma_handle->unlock(mask & EVT_TRANSMIT_DMA_COMPLETE);
+            locked = false;
+        }
+
+        if (tx_len == 0) {
             // if we didn't manage to transmit any bytes then stop
             // processing so we can check flow control state in outer
             // loop
             break;
         }
     }
+
+    if (locked) {
+        dma_handle->unlock();
+    }
 }
 #pragma GCC diagnostic pop
 #endif // HAL_UART_NODMA
@@ -1035,8 +1185,6 @@ void UARTDriver::write_pending_bytes_DMA(uint32_t n)
  */
 void UARTDriver::write_pending_bytes_NODMA(uint32_t n)
 {
-    WITH_SEMAPHORE(_write_mutex);
-
     ByteBuffer::IoVec vec[2];
     uint16_t nwritten = 0;
 
@@ -25,6 +25,11 @@
 #define RX_BOUNCE_BUFSIZE 64U
 #define TX_BOUNCE_BUFSIZE 64U
 
+// largest TX bounce buffer half, used at high baudrates
+#ifndef TX_BOUNCE_BUFSIZE_MAX
+#define TX_BOUNCE_BUFSIZE_MAX 256U
+#endif
+
 // enough for uartA to uartJ, plus IOMCU
 #define UART_MAX_DRIVERS 11
 
@@ -63,6 +68,14 @@ public:
     size_t write(uint8_t c) override;
     size_t write(const uint8_t *buffer, size_t size) override;
 
+    // reserve and commit transmit buffer space for direct writes
+    uint8_t tx_reserve(ByteBuffer::IoVec vec[2], uint32_t len) override;
+    bool tx_commit(uint32_t len) override;
+
+    // access received data in place
+    uint8_t rx_peek(ByteBuffer::IoVec vec[2]) override;
+    bool rx_consume(uint32_t len) override;
+
     // lock a port for exclusive use. Use a key of 0 to unlock
     bool lock_port(uint32_t write_key, uint32_t read_key) override;
 
@@ -200,9 +213,18 @@ private:
 #ifndef HAL_UART_NODMA
     volatile uint8_t rx_bounce_idx;
     uint8_t *rx_bounce_buf[2];
+    // two halves of tx_bounce_size bytes, one being sent while the
+    // next transfer is copied into the other
     uint8_t *tx_bounce_buf;
+    uint16_t tx_bounce_size;
+    uint8_t tx_bounce_idx;
+    // bytes already copied into the half at tx_bounce_idx
+    uint16_t tx_bounce_len;
     uint16_t contention_counter;
 #endif
+    // the buffers are lock free between the uart thread and the
+    // callers. _write_mutex serialises the writers only, the uart
+    // thread never takes it
     ByteBuffer _readbuf{0};
     ByteBuffer _writebuf{0};
     HAL_Semaphore _write_mutex;
@@ -277,6 +299,7 @@ private:
     void check_dma_tx_completion(void);
 #ifndef HAL_UART_NODMA
     void write_pending_bytes_DMA(uint32_t n);
+    uint16_t tx_bounce_prefetch(uint32_t ofs, uint16_t len);
 #endif
     void write_pending_bytes_NODMA(uint32_t n);
     void write_pending_bytes(void);
@@ -699,9 +699,63 @@ bool Util::get_true_random_vals(uint8_t* data, size_t size, uint32_t timeout_us)
 #endif
 }
 
+#if HAL_ENABLE_THREAD_STATISTICS && !defined(HAL_BOOTLOADER_BUILD)
 /*
-  log info on stack usage. Called at 1Hz by logging thread, logs next
-  thread on each call
+  accumulate the cycles used by each thread, and by all threads, since
+  each thread was last logged. The statistics are cleared by
+  @SYS/threads.txt, so a reading lower than the last one is taken as
+  a fresh start. Threads are identified by their place in the
+  registry, the ISR takes the last slot
+ */
+void Util::update_thread_load(void)
+{
+    const uint8_t isr = ARRAY_SIZE(thread_load)-1;
+    uint32_t used[ARRAY_SIZE(thread_load)] {};
+    uint32_t total = 0;
+    uint8_t n = 0;
+    for (thread_t *tp = chRegFirstThread(); tp; tp = chRegNextThread(tp), n++) {
+        if (n < isr && tp->stats.best > 0) { // not run
+            used[n] = cycles_since(thread_load[n].last, tp->stats.cumulative);
+            total += used[n];
+        }
+    }
+    used[isr] = cycles_since(thread_load[isr].last, ch.kernel_stats.m_crit_isr.cumulative);
+    total += used[isr];
+    for (uint8_t i=0; i<ARRAY_SIZE(thread_load); i++) {
+        thread_load[i].used += used[i];
+        thread_load[i].total += total;
+    }
+}
+
+uint32_t Util::cycles_since(uint64_t &last, uint64_t cumulative)
+{
+    const uint32_t ret = cumulative >= last ? uint32_t(cumulative - last) : uint32_t(cumulative);
+    last = cumulative;
+    return ret;
+}
+
+/*
+  share of the CPU used by a thread since it was last taken, in
+  hundredths of a percent. Slot 255 is the ISR
+ */
+uint16_t Util::take_thread_load(uint8_t slot)
+{
+    if (slot == 255) {
+        slot = ARRAY_SIZE(thread_load)-1;
+    } else if (slot >= ARRAY_SIZE(thread_load)-1) {
+        return 0;
+    }
+    auto &t = thread_load[slot];
+    const uint16_t load = t.total > 0 ? uint16_t((10000ULL * t.used) / t.total) : 0;
+    t.used = 0;
+    t.total = 0;
+    return load;
+}
+#endif
+
+/*
+  log info on stack usage and, with thread statistics, CPU load. Called
+  at 10Hz by logging thread, logs next thread on each call
 */
 void Util::log_stack_info(void)
 {
@@ -720,6 +774,10 @@ void Util::log_stack_info(void)
         LOG_PACKET_HEADER_INIT(LOG_STAK_MSG),
         time_us         : AP_HAL::micros64(),
     };
+#if HAL_ENABLE_THREAD_STATISTICS
+    update_thread_load();
+    pkt.load = take_thread_load(tp == nullptr ? 255 : thread_id);
+#endif
     if (tp == nullptr) {
         pkt.thread_id = 255;
         pkt.priority = 255;
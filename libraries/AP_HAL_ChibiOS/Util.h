@@ -23,6 +23,11 @@
 
 class ExpandingString;
 
+#ifndef HAL_THREAD_LOAD_MAX
+// number of threads whose CPU load is logged in STAK
+#define HAL_THREAD_LOAD_MAX 32
+#endif
+
 #ifndef HAL_ENABLE_SAVE_PERSISTENT_PARAMS
 // on F7 and H7 we will try to save key persistent parameters at the
 // end of the bootloader sector. This enables temperature calibration
@@ -146,6 +151,18 @@ private:
     // log info on stack usage
     void log_stack_info(void) override;
 
+#if HAL_ENABLE_THREAD_STATISTICS && !defined(HAL_BOOTLOADER_BUILD)
+    // cycles used by each thread for the STAK log, the last slot is the ISR
+    struct {
+        uint64_t last;      // last reading of the thread statistics
+        uint32_t used;      // cycles used since the thread was last logged
+        uint32_t total;     // cycles used by everything in that time
+    } thread_load[HAL_THREAD_LOAD_MAX+1];
+    void update_thread_load(void);
+    static uint32_t cycles_since(uint64_t &last, uint64_t cumulative);
+    uint16_t take_thread_load(uint8_t slot);
+#endif
+
 #if AP_CRASHDUMP_ENABLED
     // get last crash dump
     size_t last_crash_dump_size() const override;
@@ -25,6 +25,8 @@ parser.add_argument(
     'hwdef', type=str, nargs='+', default=None, help='hardware definition file')
 parser.add_argument(
     '--params', type=str, default=None, help='user default params path')
+parser.add_argument(
+    '--ramfunc-profile', type=str, default=None, help='function profile overriding RAMFUNC_PROFILE')
 
 args = parser.parse_args()
 
@@ -1298,6 +1300,44 @@ def copy_common_linkerscript(outdir):
     else:
         shutil.copy(os.path.join(dirpath, "../common/common_extf.ld"),
                     os.path.join(outdir, "common_extf.ld"))
+        write_ramfunc_profile(outdir)
+
+def write_ramfunc_profile(outdir):
+    '''write the linker script fragments included by common_extf.ld,
+    placing the functions with the most samples per byte from a profile
+    made with Tools/scripts/ramfunc_profile.py in ITCM, then in RAM,
+    within the budgets for each'''
+    itcm = []
+    ram = []
+    profile = args.ramfunc_profile
+    if profile is None:
+        profile = get_config('RAMFUNC_PROFILE', required=False)
+        if profile is not None:
+            profile = os.path.join(os.path.dirname(args.hwdef[0]), profile)
+    if profile is not None:
+        itcm_budget = get_config('RAMFUNC_PROFILE_ITCM_KB', default=8, type=int) * 1024
+        ram_budget = get_config('RAMFUNC_PROFILE_RAM_KB', default=32, type=int) * 1024
+        functions = []
+        for line in open(profile, 'r'):
+            fields = line.split()
+            if len(fields) != 3 or fields[0].startswith('#'):
+                continue
+            functions.append((int(fields[0]), int(fields[1]), fields[2]))
+        functions.sort(key=lambda f: f[0] / float(max(f[1], 1)), reverse=True)
+        for (count, size, symbol) in functions:
+            if size <= itcm_budget:
+                itcm.append(symbol)
+                itcm_budget -= size
+            elif size <= ram_budget:
+                ram.append(symbol)
+                ram_budget -= size
+        print("RAMFUNC_PROFILE: %u functions in ITCM, %u in RAM" % (len(itcm), len(ram)))
+    for (fname, symbols) in [("ramfunc_itcm.ld", itcm), ("ramfunc_ram.ld", ram)]:
+        f = open(os.path.join(outdir, fname), 'w')
+        f.write('/* generated from RAMFUNC_PROFILE */\n')
+        for symbol in symbols:
+            f.write('*(.text.%s)\n' % symbol)
+        f.close()
 
 def get_USB_IDs():
     '''return tuple of USB VID/PID'''
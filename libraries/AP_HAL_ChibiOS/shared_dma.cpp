@@ -79,18 +79,55 @@ void Shared_DMA::unregister()
     }
 }
 
-// lock one stream
+/*
+  lock one stream. Waiters are queued by thread priority. If the
+  holder does not have a higher priority than us it is asked to
+  unlock at its next transfer boundary by setting its contention
+  flag, so a high priority driver such as an IMU is not held up by a
+  long run of UART transfers
+ */
 bool Shared_DMA::lock_stream(uint8_t stream_id)
 {
     bool cont = false;
     if (stream_id < SHARED_DMA_MAX_STREAM_ID) {
+        chSysLock();
         const thread_t* curr_owner = locks[stream_id].mutex.owner;
+        Shared_DMA *holder = locks[stream_id].obj;
+        if (curr_owner != nullptr &&
+            holder != nullptr && holder->have_lock &&
+            curr_owner->realprio <= chThdGetPriorityX()) {
+            holder->contention = true;
+        }
+        chSysUnlock();
+        const uint32_t wait_start_us = AP_HAL::micros();
         chMtxLock(&locks[stream_id].mutex);
         cont = curr_owner != nullptr && curr_owner != locks[stream_id].mutex.owner;
+        if (cont) {
+            update_time_stats(stream_id, AP_HAL::micros() - wait_start_us, 0);
+        }
     }
     return cont;
 }
 
+/*
+  add lock wait or hold time to the statistics of a stream
+ */
+void Shared_DMA::update_time_stats(uint8_t stream_id, uint32_t wait_us, uint32_t hold_us)
+{
+    if (_contention_stats == nullptr || stream_id >= SHARED_DMA_MAX_STREAM_ID) {
+        return;
+    }
+    volatile dma_stats &stats = _contention_stats[stream_id];
+    stats.wait_us += wait_us;
+    if (wait_us > stats.wait_max_us) {
+        stats.wait_max_us = wait_us;
+    }
+    stats.hold_us += hold_us;
+    if (hold_us > stats.hold_max_us) {
+        stats.hold_max_us = hold_us;
+    }
+}
+
 // unlock one stream
 void Shared_DMA::unlock_stream(uint8_t stream_id, bool success)
 {
@@ -165,6 +202,7 @@ void Shared_DMA::lock_core(void)
         }
     }
     have_lock = true;
+    lock_us = AP_HAL::micros();
 }
 
 // lock the DMA channels, blocking method
@@ -223,6 +261,11 @@ void Shared_DMA::unlock(bool success)
 {
     osalDbgAssert(have_lock, "must have lock");
     have_lock = false;
+    if (_contention_stats != nullptr) {
+        const uint32_t hold_us = AP_HAL::micros() - lock_us;
+        update_time_stats(stream_id1, 0, hold_us);
+        update_time_stats(stream_id2, 0, hold_us);
+    }
     unlock_stream(stream_id2, success);
     unlock_stream(stream_id1, success);
 }
@@ -249,7 +292,7 @@ void Shared_DMA::dma_info(ExpandingString &str)
     }
 
     // a header to allow for machine parsers to determine format
-    str.printf("DMAV1\n");
+    str.printf("DMAV2\n");
 
     for (uint8_t i = 0; i < SHARED_DMA_MAX_STREAM_ID; i++) {
         // ignore locks not in use
@@ -265,14 +308,24 @@ void Shared_DMA::dma_info(ExpandingString &str)
 #define STREAM_MUX 7
 #define STREAM_OFFSET 1
 #endif
-        const char* fmt = "DMA=%1u:%1u TX=%8u ULCK=%8u CLCK=%8u CONT=%4.1f%%\n";
-        float cond_per = 100.0f * float(_contention_stats[i].contended_locks)
-            / (1 + _contention_stats[i].contended_locks + _contention_stats[i].uncontended_locks);
+        // wait times are per contended lock, hold times per lock, in microseconds
+        const char* fmt = "DMA=%1u:%1u TX=%8u ULCK=%8u CLCK=%8u CONT=%4.1f%% WAIT=%5u/%5u HOLD=%5u/%5u\n";
+        const uint32_t contended = _contention_stats[i].contended_locks;
+        const uint32_t locks_total = contended + _contention_stats[i].uncontended_locks;
+        float cond_per = 100.0f * float(contended) / (1 + locks_total);
         str.printf(fmt, i / STREAM_MUX + 1, i % STREAM_MUX + STREAM_OFFSET,  _contention_stats[i].transactions,
-            _contention_stats[i].uncontended_locks, _contention_stats[i].contended_locks, cond_per);
+            _contention_stats[i].uncontended_locks, contended, cond_per,
+            unsigned(contended > 0 ? _contention_stats[i].wait_us / contended : 0),
+            unsigned(_contention_stats[i].wait_max_us),
+            unsigned(locks_total > 0 ? _contention_stats[i].hold_us / locks_total : 0),
+            unsigned(_contention_stats[i].hold_max_us));
 
         _contention_stats[i].contended_locks = 0;
         _contention_stats[i].uncontended_locks = 0;
+        _contention_stats[i].wait_us = 0;
+        _contention_stats[i].wait_max_us = 0;
+        _contention_stats[i].hold_us = 0;
+        _contention_stats[i].hold_max_us = 0;
     }
 }
 
@@ -55,7 +55,10 @@ public:
     void unregister(void);
 
     // return true if this DMA channel is being actively contended for
-    // by multiple drivers
+    // by multiple drivers. This is also set while the channel is held
+    // if a thread of at least the holder's priority starts waiting
+    // for it, so drivers that keep the lock across several transfers
+    // should check it between transfers and unlock
     bool has_contention(void) const { return contention; }
 
     // is this DMA channel locked?
@@ -77,6 +80,9 @@ private:
     uint8_t stream_id2;
     bool have_lock;
 
+    // time the lock was gained, for hold time statistics
+    uint32_t lock_us;
+
     // we set the contention flag if two drivers are fighting over a DMA channel.
     // the UART driver uses this to change its max transmit size to reduce latency
     bool contention;
@@ -84,9 +90,12 @@ private:
     // core of lock call, after semaphores gained
     void lock_core(void);
 
-    // lock one stream
+    // lock one stream, returning true if it was contended
     static bool lock_stream(uint8_t stream_id);
 
+    // add lock wait or hold time to the statistics of a stream
+    static void update_time_stats(uint8_t stream_id, uint32_t wait_us, uint32_t hold_us);
+
     // unlock one stream
     void unlock_stream(uint8_t stream_id, bool success);
 
@@ -111,6 +120,11 @@ private:
         uint32_t contended_locks;
         uint32_t uncontended_locks;
         uint32_t transactions;
+        // time spent waiting for and holding the lock in microseconds
+        uint32_t wait_us;
+        uint32_t wait_max_us;
+        uint32_t hold_us;
+        uint32_t hold_max_us;
     } *_contention_stats;
 };
 
@@ -105,15 +105,18 @@ AP_HAL::Device::PeriodicHandle DeviceBus::register_periodic_callback(uint32_t pe
         hal_device = _hal_device;
         // setup a name for the thread
         char name[configMAX_TASK_NAME_LEN];
+        int8_t core = -1;
         switch (hal_device->bus_type()) {
         case AP_HAL::Device::BUS_TYPE_I2C:
             snprintf(name, sizeof(name), "APM_I2C:%u",
                      hal_device->bus_num());
+            core = HAL_ESP32_CORE_I2C;
             break;
 
         case AP_HAL::Device::BUS_TYPE_SPI:
             snprintf(name, sizeof(name), "APM_SPI:%u",
                      hal_device->bus_num());
+            core = HAL_ESP32_CORE_SPI;
             break;
         default:
             break;
@@ -121,8 +124,8 @@ AP_HAL::Device::PeriodicHandle DeviceBus::register_periodic_callback(uint32_t pe
 #ifdef BUSDEBUG
         printf("%s:%d Thread Start\n", __PRETTY_FUNCTION__, __LINE__);
 #endif
-        xTaskCreate(DeviceBus::bus_thread, name, Scheduler::DEVICE_SS,
-                    this, thread_priority, &bus_thread_handle);
+        Scheduler::create_task(DeviceBus::bus_thread, name, Scheduler::DEVICE_SS,
+                               this, thread_priority, &bus_thread_handle, core);
     }
     DeviceBus::callback_info *callback = new DeviceBus::callback_info;
     if (callback == nullptr) {
@@ -38,6 +38,10 @@ extern const AP_HAL::HAL& hal;
 
 bool Scheduler::_initialized = true;
 
+#if portNUM_PROCESSORS > 1
+static_assert(HAL_ESP32_CORE_WIFI != HAL_ESP32_CORE_MAIN, "WiFi must not run on the flight control core");
+#endif
+
 Scheduler::Scheduler()
 {
     _initialized = false;
@@ -65,14 +69,13 @@ void Scheduler::init()
     printf("%s:%d \n", __PRETTY_FUNCTION__, __LINE__);
 #endif
 
-    //xTaskCreatePinnedToCore(_main_thread, "APM_MAIN", Scheduler::MAIN_SS, this, Scheduler::MAIN_PRIO, &_main_task_handle, 0);
-    xTaskCreate(_main_thread, "APM_MAIN", Scheduler::MAIN_SS, this, Scheduler::MAIN_PRIO, &_main_task_handle);
-    xTaskCreate(_timer_thread, "APM_TIMER", TIMER_SS, this, TIMER_PRIO, &_timer_task_handle);
-    xTaskCreate(_rcout_thread, "APM_RCOUT", RCOUT_SS, this, RCOUT_PRIO, &_rcout_task_handle);
-    xTaskCreate(_rcin_thread, "APM_RCIN", RCIN_SS, this, RCIN_PRIO, &_rcin_task_handle);
-    xTaskCreate(_uart_thread, "APM_UART", UART_SS, this, UART_PRIO, &_uart_task_handle);
-    xTaskCreate(_io_thread, "APM_IO", IO_SS, this, IO_PRIO, &_io_task_handle);
-    xTaskCreate(_storage_thread, "APM_STORAGE", STORAGE_SS, this, STORAGE_PRIO, &_storage_task_handle); //no actual flash writes without this, storage kinda appears to work, but does an erase on every boot and params don't persist over reset etc.
+    create_task(_main_thread, "APM_MAIN", MAIN_SS, this, MAIN_PRIO, &_main_task_handle, HAL_ESP32_CORE_MAIN);
+    create_task(_timer_thread, "APM_TIMER", TIMER_SS, this, TIMER_PRIO, &_timer_task_handle, HAL_ESP32_CORE_TIMER);
+    create_task(_rcout_thread, "APM_RCOUT", RCOUT_SS, this, RCOUT_PRIO, &_rcout_task_handle, HAL_ESP32_CORE_RCOUT);
+    create_task(_rcin_thread, "APM_RCIN", RCIN_SS, this, RCIN_PRIO, &_rcin_task_handle, HAL_ESP32_CORE_RCIN);
+    create_task(_uart_thread, "APM_UART", UART_SS, this, UART_PRIO, &_uart_task_handle, HAL_ESP32_CORE_UART);
+    create_task(_io_thread, "APM_IO", IO_SS, this, IO_PRIO, &_io_task_handle, HAL_ESP32_CORE_IO);
+    create_task(_storage_thread, "APM_STORAGE", STORAGE_SS, this, STORAGE_PRIO, &_storage_task_handle, HAL_ESP32_CORE_STORAGE); //no actual flash writes without this, storage kinda appears to work, but does an erase on every boot and params don't persist over reset etc.
 
     //   xTaskCreate(_print_profile, "APM_PROFILE", IO_SS, this, IO_PRIO, nullptr);
 
@@ -81,6 +84,18 @@ void Scheduler::init()
 
 }
 
+bool Scheduler::create_task(void (*fn)(void *), const char *name, uint32_t stack_size,
+                            void *arg, uint8_t prio, void **handle, int8_t core)
+{
+#if portNUM_PROCESSORS == 1
+    core = 0;
+#endif
+    if (core < 0 || core >= portNUM_PROCESSORS) {
+        return xTaskCreate(fn, name, stack_size, arg, prio, handle) == pdPASS;
+    }
+    return xTaskCreatePinnedToCore(fn, name, stack_size, arg, prio, handle, core) == pdPASS;
+}
+
 template <typename T>
 void executor(T oui)
 {
@@ -97,7 +112,7 @@ void Scheduler::thread_create_trampoline(void *ctx)
 /*
   create a new thread
 */
-bool Scheduler::thread_create(AP_HAL::MemberProc proc, const char *name, uint32_t stack_size, priority_base base, int8_t priority)
+bool Scheduler::thread_create(AP_HAL::MemberProc proc, const char *name, uint32_t stack_size, priority_base base, int8_t priority, int8_t cpu)
 {
 #ifdef SCHEDDEBUG
     printf("%s:%d \n", __PRETTY_FUNCTION__, __LINE__);
@@ -111,21 +126,23 @@ bool Scheduler::thread_create(AP_HAL::MemberProc proc, const char *name, uint32_
     *tproc = proc;
 
     uint8_t thread_priority = IO_PRIO;
+    int8_t thread_core = HAL_ESP32_CORE_IO;
     static const struct {
         priority_base base;
         uint8_t p;
+        int8_t core;
     } priority_map[] = {
-        { PRIORITY_BOOST, IO_PRIO},
-        { PRIORITY_MAIN, MAIN_PRIO},
-        { PRIORITY_SPI, SPI_PRIORITY},
-        { PRIORITY_I2C, I2C_PRIORITY},
-        { PRIORITY_CAN, IO_PRIO},
-        { PRIORITY_TIMER, TIMER_PRIO},
-        { PRIORITY_RCIN, RCIN_PRIO},
-        { PRIORITY_IO, IO_PRIO},
-        { PRIORITY_UART, UART_PRIO},
-        { PRIORITY_STORAGE, STORAGE_PRIO},
-        { PRIORITY_SCRIPTING, IO_PRIO},
+        { PRIORITY_BOOST, IO_PRIO, HAL_ESP32_CORE_MAIN},
+        { PRIORITY_MAIN, MAIN_PRIO, HAL_ESP32_CORE_MAIN},
+        { PRIORITY_SPI, SPI_PRIORITY, HAL_ESP32_CORE_SPI},
+        { PRIORITY_I2C, I2C_PRIORITY, HAL_ESP32_CORE_I2C},
+        { PRIORITY_CAN, IO_PRIO, HAL_ESP32_CORE_CAN},
+        { PRIORITY_TIMER, TIMER_PRIO, HAL_ESP32_CORE_TIMER},
+        { PRIORITY_RCIN, RCIN_PRIO, HAL_ESP32_CORE_RCIN},
+        { PRIORITY_IO, IO_PRIO, HAL_ESP32_CORE_IO},
+        { PRIORITY_UART, UART_PRIO, HAL_ESP32_CORE_UART},
+        { PRIORITY_STORAGE, STORAGE_PRIO, HAL_ESP32_CORE_STORAGE},
+        { PRIORITY_SCRIPTING, IO_PRIO, HAL_ESP32_CORE_SCRIPTING},
     };
     for (uint8_t i=0; i<ARRAY_SIZE(priority_map); i++) {
         if (priority_map[i].base == base) {
@@ -133,13 +150,17 @@ bool Scheduler::thread_create(AP_HAL::MemberProc proc, const char *name, uint32_
             printf("%s:%d \n", __PRETTY_FUNCTION__, __LINE__);
 #endif
             thread_priority = constrain_int16(priority_map[i].p + priority, 1, 25);
+            thread_core = priority_map[i].core;
             break;
         }
     }
+    if (cpu >= 0) {
+        // explicit request from the caller
+        thread_core = cpu;
+    }
 
     void* xhandle;
-    BaseType_t xReturned = xTaskCreate(thread_create_trampoline, name, stack_size, tproc, thread_priority, &xhandle);
-    if (xReturned != pdPASS) {
+    if (!create_task(thread_create_trampoline, name, stack_size, tproc, thread_priority, &xhandle, thread_core)) {
         free(tproc);
         return false;
     }
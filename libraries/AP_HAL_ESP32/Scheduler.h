@@ -21,6 +21,57 @@
 #define ESP32_SCHEDULER_MAX_TIMER_PROCS 10
 #define ESP32_SCHEDULER_MAX_IO_PROCS 10
 
+/*
+  core affinity of each class of thread. The flight control threads
+  run on the APP core (1), and the communication and slow threads
+  share the PRO core (0) with the ESP-IDF WiFi and lwip tasks, so the
+  network stack never preempts the main loop. Boards may override any
+  of these in their board header
+ */
+#ifndef HAL_ESP32_FLIGHT_CORE
+#define HAL_ESP32_FLIGHT_CORE 1
+#endif
+#ifndef HAL_ESP32_COMMS_CORE
+#define HAL_ESP32_COMMS_CORE 0
+#endif
+
+#ifndef HAL_ESP32_CORE_MAIN
+#define HAL_ESP32_CORE_MAIN HAL_ESP32_FLIGHT_CORE
+#endif
+#ifndef HAL_ESP32_CORE_TIMER
+#define HAL_ESP32_CORE_TIMER HAL_ESP32_FLIGHT_CORE
+#endif
+#ifndef HAL_ESP32_CORE_RCIN
+#define HAL_ESP32_CORE_RCIN HAL_ESP32_FLIGHT_CORE
+#endif
+#ifndef HAL_ESP32_CORE_RCOUT
+#define HAL_ESP32_CORE_RCOUT HAL_ESP32_FLIGHT_CORE
+#endif
+#ifndef HAL_ESP32_CORE_SPI
+#define HAL_ESP32_CORE_SPI HAL_ESP32_FLIGHT_CORE
+#endif
+#ifndef HAL_ESP32_CORE_I2C
+#define HAL_ESP32_CORE_I2C HAL_ESP32_FLIGHT_CORE
+#endif
+#ifndef HAL_ESP32_CORE_UART
+#define HAL_ESP32_CORE_UART HAL_ESP32_COMMS_CORE
+#endif
+#ifndef HAL_ESP32_CORE_IO
+#define HAL_ESP32_CORE_IO HAL_ESP32_COMMS_CORE
+#endif
+#ifndef HAL_ESP32_CORE_STORAGE
+#define HAL_ESP32_CORE_STORAGE HAL_ESP32_COMMS_CORE
+#endif
+#ifndef HAL_ESP32_CORE_SCRIPTING
+#define HAL_ESP32_CORE_SCRIPTING HAL_ESP32_COMMS_CORE
+#endif
+#ifndef HAL_ESP32_CORE_CAN
+#define HAL_ESP32_CORE_CAN HAL_ESP32_COMMS_CORE
+#endif
+#ifndef HAL_ESP32_CORE_WIFI
+#define HAL_ESP32_CORE_WIFI HAL_ESP32_COMMS_CORE
+#endif
+
 
 /* Scheduler implementation: */
 class ESP32::Scheduler : public AP_HAL::Scheduler
@@ -51,7 +102,12 @@ public:
     AP_Int16 _loop_rate_hz;
 
     static void thread_create_trampoline(void *ctx);
-    bool thread_create(AP_HAL::MemberProc, const char *name, uint32_t stack_size, priority_base base, int8_t priority) override;
+    bool thread_create(AP_HAL::MemberProc, const char *name, uint32_t stack_size, priority_base base, int8_t priority, int8_t cpu = -1) override;
+
+    // create a FreeRTOS task on the given core, or on the only core
+    // of a single core build
+    static bool create_task(void (*fn)(void *), const char *name, uint32_t stack_size,
+                            void *arg, uint8_t prio, void **handle, int8_t core);
 
     static const int SPI_PRIORITY = 40; // if your primary imu is spi, this should be above the i2c value, spi is better.
     static const int MAIN_PRIO = 10;
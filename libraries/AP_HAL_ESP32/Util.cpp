@@ -22,6 +22,7 @@
 #include "RCOutput.h"
 
 #include <AP_ROMFS/AP_ROMFS.h>
+#include <AP_Common/ExpandingString.h>
 #include "SdCard.h"
 
 #include <esp_timer.h>
@@ -33,6 +34,8 @@
 #include "esp_log.h"
 #include "esp_system.h"
 #include "esp_heap_caps.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
 
 
 extern const AP_HAL::HAL& hal;
@@ -268,6 +271,41 @@ bool Util::was_watchdog_reset() const
            || reason == ESP_RST_WDT;
 }
 
+/*
+  per core load for @SYS/tasks.txt, from the run time of the idle task
+  of each core since the previous call
+ */
+void Util::cpu_load_info(ExpandingString &str)
+{
+#if configUSE_TRACE_FACILITY && configGENERATE_RUN_TIME_STATS
+    const UBaseType_t max_tasks = uxTaskGetNumberOfTasks() + 4;
+    TaskStatus_t *status = (TaskStatus_t *)calloc(max_tasks, sizeof(TaskStatus_t));
+    if (status == nullptr) {
+        return;
+    }
+    uint32_t total_time = 0;
+    const UBaseType_t num_tasks = uxTaskGetSystemState(status, max_tasks, &total_time);
+    const uint32_t dt = total_time - last_load.total_time;
+
+    for (uint8_t core = 0; core < MIN(portNUM_PROCESSORS, ARRAY_SIZE(last_load.idle_time)); core++) {
+        const TaskHandle_t idle = xTaskGetIdleTaskHandleForCPU(core);
+        uint32_t idle_time = 0;
+        for (UBaseType_t i = 0; i < num_tasks; i++) {
+            if (status[i].xHandle == idle) {
+                idle_time = status[i].ulRunTimeCounter;
+                break;
+            }
+        }
+        const uint32_t didle = MIN(idle_time - last_load.idle_time[core], dt);
+        const float load = dt > 0 ? 100.0f * (dt - didle) / dt : 0.0f;
+        str.printf("CPU%u LOAD=%4.1f%%\n", unsigned(core), load);
+        last_load.idle_time[core] = idle_time;
+    }
+    last_load.total_time = total_time;
+    free(status);
+#endif
+}
+
 #if CH_DBG_ENABLE_STACK_CHECK == TRUE
 /*
   display stack usage as text buffer for @SYS/threads.txt
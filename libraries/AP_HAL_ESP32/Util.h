@@ -67,7 +67,16 @@ public:
     size_t thread_info(char *buf, size_t bufsize) override;
 #endif
 
+    // request information on the load of each cpu core
+    void cpu_load_info(ExpandingString &str) override;
+
 private:
+    // run time counters at the previous cpu_load_info() call
+    struct {
+        uint32_t total_time;
+        uint32_t idle_time[2];
+    } last_load;
+
 #ifdef HAL_PWM_ALARM
     struct ToneAlarmPwmGroup {
         pwmchannel_t chan;
@@ -76,6 +76,31 @@ ssize_t ConsoleDevice::write(const uint8_t *buf, uint16_t n)
     return ::write(_wr_fd, buf, n);
 }
 
+ssize_t ConsoleDevice::writev(const ByteBuffer::IoVec *vec, uint8_t n_vec)
+{
+    if (_closed) {
+        return -EAGAIN;
+    }
+
+    struct iovec iov[n_vec];
+    return ::writev(_wr_fd, iov, to_iovec(vec, n_vec, iov));
+}
+
+ssize_t ConsoleDevice::readv(const ByteBuffer::IoVec *vec, uint8_t n_vec)
+{
+    if (_closed) {
+        return -EAGAIN;
+    }
+
+    struct iovec iov[n_vec];
+    return ::readv(_rd_fd, iov, to_iovec(vec, n_vec, iov));
+}
+
+int ConsoleDevice::get_read_fd() const
+{
+    return _closed ? -1 : _rd_fd;
+}
+
 void ConsoleDevice::set_blocking(bool blocking)
 {
     int rd_flags;
@@ -12,6 +12,9 @@ public:
     virtual bool close() override;
     virtual ssize_t write(const uint8_t *buf, uint16_t n) override;
     virtual ssize_t read(uint8_t *buf, uint16_t n) override;
+    virtual ssize_t writev(const ByteBuffer::IoVec *vec, uint8_t n_vec) override;
+    virtual ssize_t readv(const ByteBuffer::IoVec *vec, uint8_t n_vec) override;
+    virtual int get_read_fd() const override;
     virtual void set_blocking(bool blocking) override;
     virtual void set_speed(uint32_t speed) override;
 
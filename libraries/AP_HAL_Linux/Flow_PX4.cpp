@@ -44,6 +44,10 @@
 #include <stdio.h>
 #include <stdlib.h>
 
+#if defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
 extern const AP_HAL::HAL& hal;
 
 using namespace Linux;
@@ -132,13 +136,27 @@ static inline uint32_t compute_sad(uint8_t *image1, uint8_t *image2,
     /* calculate position in image buffer
      * off1 for image1 and off2 for image2
      */
-    uint16_t off1 = off1y * row_size + off1x;
-    uint16_t off2 = off2y * row_size + off2x;
+    uint32_t off1 = off1y * row_size + off1x;
+    uint32_t off2 = off2y * row_size + off2x;
     unsigned int i,j;
     uint32_t acc = 0;
 
-    for (i = 0; i < window_size; i++) {
-        for (j = 0; j < window_size; j++) {
+#if defined(__ARM_NEON)
+    if (window_size == 8) {
+        /* one row of the window per vector, each lane sums at most
+         * 8 differences so can't overflow */
+        uint16x8_t sum = vdupq_n_u16(0);
+        for (j = 0; j < 8; j++) {
+            sum = vabal_u8(sum, vld1_u8(&image1[off1 + j*row_size]),
+                           vld1_u8(&image2[off2 + j*row_size]));
+        }
+        const uint64x2_t sum2 = vpaddlq_u32(vpaddlq_u16(sum));
+        return uint32_t(vgetq_lane_u64(sum2, 0) + vgetq_lane_u64(sum2, 1));
+    }
+#endif
+
+    for (j = 0; j < window_size; j++) {
+        for (i = 0; i < window_size; i++) {
             acc += abs(image1[off1 + i + j*row_size] -
                        image2[off2 + i + j*row_size]);
         }
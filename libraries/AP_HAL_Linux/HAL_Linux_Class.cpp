@@ -304,6 +304,9 @@ void _usage(void)
     printf("\tcpu affinity:\n");
     printf("\t                   --cpu-affinity 1 (single cpu) or 1,3 (multiple cpus) or 1-3 (range of cpus)\n");
     printf("\t                   -c 1 (single cpu) or 1,3 (multiple cpus) or 1-3 (range of cpus)\n");
+    printf("\tthread cpu affinity by priority class:\n");
+    printf("\t                   --thread-affinity main=3:spi=3:timer=2:io=0-1\n");
+    printf("\t                   -T main=3:spi=3:timer=2:io=0-1\n");
 }
 
 void HAL_Linux::run(int argc, char* const argv[], Callbacks* callbacks) const
@@ -330,13 +333,21 @@ void HAL_Linux::run(int argc, char* const argv[], Callbacks* callbacks) const
         {"module-directory",    true,  0, 'M'},
         {"defaults",            true,  0, 'd'},
         {"cpu-affinity",        true,  0, 'c'},
+        {"thread-affinity",     true,  0, 'T'},
         {"help",                false,  0, 'h'},
         {0, false, 0, 0}
     };
 
-    GetOptLong gopt(argc, argv, "A:B:C:D:E:F:G:H:l:t:s:he:SM:c:",
+    GetOptLong gopt(argc, argv, "A:B:C:D:E:F:G:H:l:t:s:he:SM:c:T:",
                     options);
 
+#ifdef HAL_LINUX_THREAD_AFFINITY
+    // board default, classes can be overridden on the command line
+    if (!Linux::Scheduler::from(scheduler)->set_thread_affinity_map(HAL_LINUX_THREAD_AFFINITY)) {
+        fprintf(stderr, "Could not parse board thread affinity: %s\n", HAL_LINUX_THREAD_AFFINITY);
+    }
+#endif
+
     /*
       parse command line options
      */
@@ -397,6 +408,12 @@ void HAL_Linux::run(int argc, char* const argv[], Callbacks* callbacks) const
             }
             Linux::Scheduler::from(scheduler)->set_cpu_affinity(cpu_affinity);
             break;
+        case 'T':
+            if (!Linux::Scheduler::from(scheduler)->set_thread_affinity_map(gopt.optarg)) {
+                fprintf(stderr, "Could not parse thread affinity: %s\n", gopt.optarg);
+                exit(1);
+            }
+            break;
         case 'h':
             _usage();
             exit(0);
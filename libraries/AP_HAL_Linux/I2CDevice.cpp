@@ -197,6 +197,62 @@ bool I2CDevice::transfer(const uint8_t *send, uint32_t send_len,
     return r != -1;
 }
 
+/*
+  do a batch of transfers with one ioctl, with a repeated start
+  between transfers. Devices that need a stop between transfers do
+  them one at a time
+ */
+bool I2CDevice::transfer_batch(const BatchTransfer *transfers, uint8_t count)
+{
+    if (_split_transfers || count <= 1 || 2U * count > I2C_RDRW_IOCTL_MAX_MSGS) {
+        return AP_HAL::I2CDevice::transfer_batch(transfers, count);
+    }
+
+    struct i2c_msg msgs[2 * count];
+    unsigned nmsgs = 0;
+
+    memset(msgs, 0, sizeof(msgs));
+
+    for (uint8_t i = 0; i < count; i++) {
+        const BatchTransfer &t = transfers[i];
+        const unsigned first = nmsgs;
+
+        if (t.send && t.send_len != 0) {
+            msgs[nmsgs].addr = _address;
+            msgs[nmsgs].flags = 0;
+            msgs[nmsgs].buf = const_cast<uint8_t*>(t.send);
+            msgs[nmsgs].len = t.send_len;
+            nmsgs++;
+        }
+
+        if (t.recv && t.recv_len != 0) {
+            msgs[nmsgs].addr = _address;
+            msgs[nmsgs].flags = I2C_M_RD;
+            msgs[nmsgs].buf = t.recv;
+            msgs[nmsgs].len = t.recv_len;
+            nmsgs++;
+        }
+
+        /* interpret it as an input error if nothing has to be done */
+        if (nmsgs == first) {
+            return false;
+        }
+    }
+
+    struct i2c_rdwr_ioctl_data i2c_data = { };
+
+    i2c_data.msgs = msgs;
+    i2c_data.nmsgs = nmsgs;
+
+    int r;
+    unsigned retries = _retries;
+    do {
+        r = ::ioctl(_bus.fd, I2C_RDWR, &i2c_data);
+    } while (r == -1 && retries-- > 0);
+
+    return r != -1;
+}
+
 bool I2CDevice::read_registers_multiple(uint8_t first_reg, uint8_t *recv,
                                         uint32_t recv_len, uint8_t times)
 {
@@ -261,6 +317,7 @@ AP_HAL::Device::PeriodicHandle I2CDevice::register_periodic_callback(
         snprintf(name, sizeof(name), "ap-i2c-%u", _bus.bus);
 
         _bus.thread.set_stack_size(AP_LINUX_SENSORS_STACK_SIZE);
+        Scheduler::from(hal.scheduler)->set_thread_affinity(_bus.thread, AP_HAL::Scheduler::PRIORITY_I2C);
         _bus.thread.start(name, AP_LINUX_SENSORS_SCHED_POLICY,
                           AP_LINUX_SENSORS_SCHED_PRIO);
     }
@@ -57,6 +57,9 @@ public:
     bool transfer(const uint8_t *send, uint32_t send_len,
                   uint8_t *recv, uint32_t recv_len) override;
 
+    /* See AP_HAL::Device::transfer_batch() */
+    bool transfer_batch(const BatchTransfer *transfers, uint8_t count) override;
+
     bool read_registers_multiple(uint8_t first_reg, uint8_t *recv,
                                  uint32_t recv_len, uint8_t times) override;
 
@@ -132,10 +132,14 @@ void OpticalFlow_Onboard::init()
             _camera_output_height = _height;
 
             /* we set these values here in order to the calculations be correct
-             * (such as PX4 init) even though we crop each frame later on. */
+             * (such as PX4 init) even though we crop each frame later on.
+             * Grey images are used in place, so keep the camera's line
+             * length for them */
             _width = HAL_OPTFLOW_ONBOARD_OUTPUT_WIDTH;
             _height = HAL_OPTFLOW_ONBOARD_OUTPUT_HEIGHT;
-            _bytesperline = HAL_OPTFLOW_ONBOARD_OUTPUT_WIDTH;
+            if (_format == V4L2_PIX_FMT_YUYV) {
+                _bytesperline = HAL_OPTFLOW_ONBOARD_OUTPUT_WIDTH;
+            }
         }
     }
 
@@ -260,15 +264,20 @@ void OpticalFlow_Onboard::_run_optflow()
     uint32_t crop_left = 0, crop_top = 0;
     uint32_t shrink_scale = 0, shrink_width = 0, shrink_height = 0;
     uint32_t shrink_width_offset = 0, shrink_height_offset = 0;
-    uint8_t *convert_buffer = nullptr, *output_buffer = nullptr;
+    uint8_t *convert_buffer = nullptr, *output_buffer[2] {};
+    uint8_t output_index = 0;
+    uint8_t *image, *last_image = nullptr;
     uint8_t qual;
 
-    if (_format == V4L2_PIX_FMT_YUYV) {
-        if (_shrink_by_software || _crop_by_software) {
-            convert_buffer_size = _camera_output_width * _camera_output_height;
-        } else {
-            convert_buffer_size = _width * _height;
-        }
+    /* grey images, and the luma plane of NV12 ones, that only need
+     * cropping are used where the driver put them, otherwise each
+     * frame is converted into one of two output buffers in turn, so
+     * the previous image stays valid and the driver gets the frame
+     * back at once */
+    const bool in_place = _format != V4L2_PIX_FMT_YUYV && !_shrink_by_software;
+
+    if (_format == V4L2_PIX_FMT_YUYV && (_shrink_by_software || _crop_by_software)) {
+        convert_buffer_size = _camera_output_width * _camera_output_height;
 
         convert_buffer = (uint8_t *)calloc(1, convert_buffer_size);
         if (!convert_buffer) {
@@ -276,17 +285,14 @@ void OpticalFlow_Onboard::_run_optflow()
         }
     }
 
-    if (_shrink_by_software || _crop_by_software) {
-        output_buffer_size = HAL_OPTFLOW_ONBOARD_OUTPUT_WIDTH *
-            HAL_OPTFLOW_ONBOARD_OUTPUT_HEIGHT;
+    if (!in_place) {
+        output_buffer_size = _width * _height;
 
-        output_buffer = (uint8_t *)calloc(1, output_buffer_size);
-        if (!output_buffer) {
-            if (convert_buffer) {
-                free(convert_buffer);
+        for (uint8_t i = 0; i < 2; i++) {
+            output_buffer[i] = (uint8_t *)calloc(1, output_buffer_size);
+            if (!output_buffer[i]) {
+                AP_HAL::panic("OpticalFlow_Onboard: couldn't allocate output buffer\n");
             }
-
-            AP_HAL::panic("OpticalFlow_Onboard: couldn't allocate crop buffer\n");
         }
     }
 
@@ -314,49 +320,51 @@ void OpticalFlow_Onboard::_run_optflow()
     while(true) {
         /* wait for next frame to come */
         if (!_videoin->get_frame(video_frame)) {
-            if (convert_buffer) {
-               free(convert_buffer);
-            }
-
-            if (output_buffer) {
-               free(output_buffer);
-            }
-
             AP_HAL::panic("OpticalFlow_Onboard: couldn't get frame\n");
         }
 
-        if (_format == V4L2_PIX_FMT_YUYV) {
-            VideoIn::yuyv_to_grey((uint8_t *)video_frame.data,
-                convert_buffer_size * 2, convert_buffer);
-
-            memset(video_frame.data, 0, convert_buffer_size * 2);
-            memcpy(video_frame.data, convert_buffer, convert_buffer_size);
-        }
+        if (in_place) {
+            image = (uint8_t *)video_frame.data +
+                crop_top * _bytesperline + crop_left;
+        } else {
+            uint8_t *src = (uint8_t *)video_frame.data;
+            image = output_buffer[output_index];
+            output_index ^= 1;
+
+            if (_format == V4L2_PIX_FMT_YUYV) {
+                if (convert_buffer) {
+                    VideoIn::yuyv_to_grey(src, convert_buffer_size * 2,
+                                          convert_buffer);
+                    src = convert_buffer;
+                } else {
+                    VideoIn::yuyv_to_grey(src, output_buffer_size * 2, image);
+                }
+            }
 
-        if (_shrink_by_software) {
-            /* shrink_8bpp() will shrink a selected area using the offsets,
-             * therefore, we don't need the crop. */
-            VideoIn::shrink_8bpp((uint8_t *)video_frame.data, output_buffer,
-                                 _camera_output_width, _camera_output_height,
-                                 shrink_width_offset, shrink_width,
-                                 shrink_height_offset, shrink_height,
-                                 shrink_scale, shrink_scale);
-            memset(video_frame.data, 0, _camera_output_width * _camera_output_height);
-            memcpy(video_frame.data, output_buffer, output_buffer_size);
-        } else if (_crop_by_software) {
-            VideoIn::crop_8bpp((uint8_t *)video_frame.data, output_buffer,
-                               _camera_output_width,
-                               crop_left, HAL_OPTFLOW_ONBOARD_OUTPUT_WIDTH,
-                               crop_top, HAL_OPTFLOW_ONBOARD_OUTPUT_HEIGHT);
-
-            memset(video_frame.data, 0, _camera_output_width * _camera_output_height);
-            memcpy(video_frame.data, output_buffer, output_buffer_size);
+            if (_shrink_by_software) {
+                /* shrink_8bpp() will shrink a selected area using the offsets,
+                 * therefore, we don't need the crop. */
+                VideoIn::shrink_8bpp(src, image,
+                                     _camera_output_width, _camera_output_height,
+                                     shrink_width_offset, shrink_width,
+                                     shrink_height_offset, shrink_height,
+                                     shrink_scale, shrink_scale);
+            } else if (_crop_by_software) {
+                VideoIn::crop_8bpp(src, image,
+                                   _camera_output_width,
+                                   crop_left, HAL_OPTFLOW_ONBOARD_OUTPUT_WIDTH,
+                                   crop_top, HAL_OPTFLOW_ONBOARD_OUTPUT_HEIGHT);
+            }
         }
 
         /* if it is at least the second frame we receive
          * since we have to compare 2 frames */
-        if (_last_video_frame.data == nullptr) {
+        if (last_image == nullptr) {
+            if (!in_place) {
+                _videoin->put_frame(video_frame);
+            }
             _last_video_frame = video_frame;
+            last_image = image;
             continue;
         }
 
@@ -382,11 +390,15 @@ void OpticalFlow_Onboard::_run_optflow()
         }
 #endif
 
+        /* the driver can have the frame back once it has been converted */
+        if (!in_place) {
+            _videoin->put_frame(video_frame);
+        }
+
         /* compute gyro data and video frames
          * get flow rate to send it to the opticalflow driver
          */
-        qual = _flow->compute_flow((uint8_t*)_last_video_frame.data,
-                                   (uint8_t *)video_frame.data,
+        qual = _flow->compute_flow(last_image, image,
                                    video_frame.timestamp -
                                    _last_video_frame.timestamp,
                                    &flow_rate.x, &flow_rate.y);
@@ -410,18 +422,17 @@ void OpticalFlow_Onboard::_run_optflow()
         pthread_mutex_unlock(&_mutex);
 
         /* give the last frame back to the video input driver */
-        _videoin->put_frame(_last_video_frame);
+        if (in_place) {
+            _videoin->put_frame(_last_video_frame);
+        }
         _last_integration_time = gyro_sample.time_us;
         _last_video_frame = video_frame;
+        last_image = image;
         _last_gyro_rate = gyro_sample.gyro;
     }
 
-    if (convert_buffer) {
-        free(convert_buffer);
-    }
-
-    if (output_buffer) {
-        free(output_buffer);
-    }
+    free(convert_buffer);
+    free(output_buffer[0]);
+    free(output_buffer[1]);
 }
 #endif
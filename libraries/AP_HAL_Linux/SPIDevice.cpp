@@ -194,6 +194,12 @@ SPIBus::SPIBus(uint16_t bus_)
     : bus(bus_)
 {
     memset(fd, -1, sizeof(fd));
+
+#if AP_HAL_SEMAPHORE_STATS_ENABLED
+    char name[8];
+    snprintf(name, sizeof(name), "SPI%u", unsigned(bus));
+    sem.set_name(name);
+#endif
 }
 
 SPIBus::~SPIBus()
@@ -305,45 +311,75 @@ bool SPIDevice::transfer(const uint8_t *send, uint32_t send_len,
         return false;
     }
 
-#if DEBUG
-    if (_desc.mode == _bus.last_mode) {
-        /*
-          the mode in the kernel is not tied to the file descriptor,
-          so there is a chance some other process has changed it since
-          we last used the bus. We want to report when this happens so
-          the user has a chance of figuring out when there is
-          conflicted use of the SPI bus. Unfortunately this costs us
-          an extra syscall per transfer.
-         */
-        uint8_t current_mode;
-        if (ioctl(fd, SPI_IOC_RD_MODE, &current_mode) < 0) {
-            hal.console->printf("SPIDevice: error on getting mode fd=%d (%s)\n",
-                                fd, strerror(errno));
-            _bus.last_mode = -1;
-        } else if (current_mode != _bus.last_mode) {
-            hal.console->printf("SPIDevice: bus mode conflict fd=%d mode=%u/%u\n",
-                                fd, (unsigned)_bus.last_mode, (unsigned)current_mode);
-            _bus.last_mode = -1;
-        }
+    if (!_set_mode(fd)) {
+        return false;
     }
-#endif
 
-    int r;
-    if (_desc.mode != _bus.last_mode) {
-        r = ioctl(fd, SPI_IOC_WR_MODE, &_desc.mode);
-        if (r < 0) {
-            hal.console->printf("SPIDevice: error on setting mode fd=%d (%s)\n",
-                                fd, strerror(errno));
+    _cs_assert();
+    int r = ioctl(fd, SPI_IOC_MESSAGE(nmsgs), &msgs);
+    _cs_release();
+
+    if (r == -1) {
+        hal.console->printf("SPIDevice: error transferring data fd=%d (%s)\n",
+                            fd, strerror(errno));
+        return false;
+    }
+
+    return true;
+}
+
+/*
+  do a batch of transfers with one ioctl. The kernel deselects the
+  device between transfers, so this is only possible with kernel
+  controlled chip select
+ */
+bool SPIDevice::transfer_batch(const BatchTransfer *transfers, uint8_t count)
+{
+    if (_desc.cs_pin != SPI_CS_KERNEL || count <= 1) {
+        return AP_HAL::SPIDevice::transfer_batch(transfers, count);
+    }
+
+    struct spi_ioc_transfer msgs[2 * count];
+    unsigned nmsgs = 0;
+    int fd = _bus.fd[_desc.subdev];
+
+    memset(msgs, 0, sizeof(msgs));
+
+    for (uint8_t i = 0; i < count; i++) {
+        const BatchTransfer &t = transfers[i];
+        const unsigned first = nmsgs;
+
+        if (t.send && t.send_len != 0) {
+            msgs[nmsgs].tx_buf = (uint64_t) t.send;
+            msgs[nmsgs].len = t.send_len;
+            msgs[nmsgs].speed_hz = _speed;
+            msgs[nmsgs].bits_per_word = _desc.bits_per_word;
+            nmsgs++;
+        }
+
+        if (t.recv && t.recv_len != 0) {
+            msgs[nmsgs].rx_buf = (uint64_t) t.recv;
+            msgs[nmsgs].len = t.recv_len;
+            msgs[nmsgs].speed_hz = _speed;
+            msgs[nmsgs].bits_per_word = _desc.bits_per_word;
+            nmsgs++;
+        }
+
+        if (nmsgs == first) {
             return false;
         }
-        _bus.last_mode = _desc.mode;
+
+        // deselect the device at the end of each transfer but the last
+        if (i != count - 1) {
+            msgs[nmsgs - 1].cs_change = 1;
+        }
     }
 
-    _cs_assert();
-    r = ioctl(fd, SPI_IOC_MESSAGE(nmsgs), &msgs);
-    _cs_release();
+    if (!_set_mode(fd)) {
+        return false;
+    }
 
-    if (r == -1) {
+    if (ioctl(fd, SPI_IOC_MESSAGE(nmsgs), msgs) == -1) {
         hal.console->printf("SPIDevice: error transferring data fd=%d (%s)\n",
                             fd, strerror(errno));
         return false;
@@ -391,6 +427,47 @@ bool SPIDevice::transfer_fullduplex(const uint8_t *send, uint8_t *recv,
 }
 
 
+/*
+  set the SPI mode of the bus for this device if another device has
+  changed it
+ */
+bool SPIDevice::_set_mode(int fd)
+{
+#if DEBUG
+    if (_desc.mode == _bus.last_mode) {
+        /*
+          the mode in the kernel is not tied to the file descriptor,
+          so there is a chance some other process has changed it since
+          we last used the bus. We want to report when this happens so
+          the user has a chance of figuring out when there is
+          conflicted use of the SPI bus. Unfortunately this costs us
+          an extra syscall per transfer.
+         */
+        uint8_t current_mode;
+        if (ioctl(fd, SPI_IOC_RD_MODE, &current_mode) < 0) {
+            hal.console->printf("SPIDevice: error on getting mode fd=%d (%s)\n",
+                                fd, strerror(errno));
+            _bus.last_mode = -1;
+        } else if (current_mode != _bus.last_mode) {
+            hal.console->printf("SPIDevice: bus mode conflict fd=%d mode=%u/%u\n",
+                                fd, (unsigned)_bus.last_mode, (unsigned)current_mode);
+            _bus.last_mode = -1;
+        }
+    }
+#endif
+
+    if (_desc.mode != _bus.last_mode) {
+        if (ioctl(fd, SPI_IOC_WR_MODE, &_desc.mode) < 0) {
+            hal.console->printf("SPIDevice: error on setting mode fd=%d (%s)\n",
+                                fd, strerror(errno));
+            return false;
+        }
+        _bus.last_mode = _desc.mode;
+    }
+
+    return true;
+}
+
 void SPIDevice::_cs_assert()
 {
     if (_desc.cs_pin == SPI_CS_KERNEL) {
@@ -427,6 +504,7 @@ AP_HAL::Device::PeriodicHandle SPIDevice::register_periodic_callback(
         snprintf(name, sizeof(name), "ap-spi-%u", _bus.bus);
 
         _bus.thread.set_stack_size(AP_LINUX_SENSORS_STACK_SIZE);
+        Scheduler::from(hal.scheduler)->set_thread_affinity(_bus.thread, AP_HAL::Scheduler::PRIORITY_SPI);
         _bus.thread.start(name, AP_LINUX_SENSORS_SCHED_POLICY,
                           AP_LINUX_SENSORS_SCHED_PRIO);
     }
@@ -42,6 +42,9 @@ public:
     bool transfer(const uint8_t *send, uint32_t send_len,
                   uint8_t *recv, uint32_t recv_len) override;
 
+    /* See AP_HAL::Device::transfer_batch() */
+    bool transfer_batch(const BatchTransfer *transfers, uint8_t count) override;
+
     /* See AP_HAL::SPIDevice::transfer_fullduplex() */
     bool transfer_fullduplex(const uint8_t *send, uint8_t *recv,
                              uint32_t len) override;
@@ -63,6 +66,11 @@ protected:
     AP_HAL::DigitalSource *_cs;
     uint32_t _speed;
 
+    /*
+     * Set the bus mode for this device if needed
+     */
+    bool _set_mode(int fd);
+
     /*
      * Select device if using userspace CS
      */
@@ -85,12 +85,19 @@ void SPIUARTDriver::begin(uint32_t b, uint16_t rxS, uint16_t txS)
     _initialised = true;
 }
 
-int SPIUARTDriver::_write_fd(const uint8_t *buf, uint16_t size)
+/*
+  SPI transfers are done one part of the ring buffer at a time, the
+  rest is sent on the next call
+ */
+int SPIUARTDriver::_write_fd(const ByteBuffer::IoVec *vec, uint8_t n_vec)
 {
     if (_external) {
-        return UARTDriver::_write_fd(buf,size);
+        return UARTDriver::_write_fd(vec, n_vec);
     }
 
+    const uint8_t *buf = vec[0].data;
+    const uint16_t size = vec[0].len;
+
     if (!_dev->get_semaphore()->take_nonblocking()) {
         return 0;
     }
@@ -111,14 +118,17 @@ int SPIUARTDriver::_write_fd(const uint8_t *buf, uint16_t size)
     return ret;
 }
 
-int SPIUARTDriver::_read_fd(uint8_t *buf, uint16_t n)
+int SPIUARTDriver::_read_fd(const ByteBuffer::IoVec *vec, uint8_t n_vec)
 {
     static uint8_t ff_stub[100] = {0xff};
 
     if (_external) {
-        return UARTDriver::_read_fd(buf, n);
+        return UARTDriver::_read_fd(vec, n_vec);
     }
 
+    uint8_t *buf = vec[0].data;
+    uint16_t n = vec[0].len;
+
     /* Make SPI transactions shorter. It can save SPI bus from keeping too
      * long. It's essential for NavIO as MPU9250 is on the same bus and
      * doesn't like to be waiting. Making transactions more frequent but shorter
@@ -13,8 +13,8 @@ public:
     void _timer_tick(void) override;
 
 protected:
-    int _write_fd(const uint8_t *buf, uint16_t n) override;
-    int _read_fd(uint8_t *buf, uint16_t n) override;
+    int _write_fd(const ByteBuffer::IoVec *vec, uint8_t n_vec) override;
+    int _read_fd(const ByteBuffer::IoVec *vec, uint8_t n_vec) override;
 
     AP_HAL::OwnPtr<AP_HAL::SPIDevice> _dev;
 
@@ -54,12 +54,17 @@ extern const AP_HAL::HAL& hal;
         .thread = &_##name_##_thread,                           \
         .policy = SCHED_FIFO,                                   \
         .prio = APM_LINUX_##UPPER_NAME_##_PRIORITY,             \
+        .base = PRIORITY_##UPPER_NAME_,                         \
         .rate = APM_LINUX_##UPPER_NAME_##_RATE,                 \
     }
 
 Scheduler::Scheduler()
 {
     CPU_ZERO(&_cpu_affinity);
+    CPU_ZERO(&_default_affinity);
+    for (uint8_t i = 0; i < num_priority_bases; i++) {
+        CPU_ZERO(&_thread_affinity[i]);
+    }
 }
 
 
@@ -105,6 +110,7 @@ void Scheduler::init()
         SchedulerThread *thread;
         int policy;
         int prio;
+        priority_base base;
         uint32_t rate;
     } sched_table[] = {
         SCHED_THREAD(timer, TIMER),
@@ -118,6 +124,10 @@ void Scheduler::init()
     init_realtime();
     init_cpu_affinity();
 
+    if (sched_getaffinity(0, sizeof(_default_affinity), &_default_affinity) != 0) {
+        CPU_ZERO(&_default_affinity);
+    }
+
     /* set barrier to N + 1 threads: worker threads + main */
     unsigned n_threads = ARRAY_SIZE(sched_table) + 1;
     ret = pthread_barrier_init(&_initialized_barrier, nullptr, n_threads);
@@ -131,9 +141,21 @@ void Scheduler::init()
 
         t->thread->set_rate(t->rate);
         t->thread->set_stack_size(1024 * 1024);
+        set_thread_affinity(*t->thread, t->base);
         t->thread->start(t->name, t->policy, t->prio);
     }
 
+    /*
+      pin the main thread once the scheduler threads are started. Threads
+      started with Linux::Thread get their own affinity, anything else
+      created from the main thread inherits this one
+     */
+    const cpu_set_t &main_affinity = _thread_affinity[PRIORITY_MAIN];
+    if (CPU_COUNT(&main_affinity) &&
+        sched_setaffinity(0, sizeof(main_affinity), &main_affinity) != 0) {
+        AP_HAL::panic("Failed to set affinity for main thread: %m");
+    }
+
 #if defined(DEBUG_STACK) && DEBUG_STACK
     register_timer_process(FUNCTOR_BIND_MEMBER(&Scheduler::_debug_stack, void));
 #endif
@@ -271,7 +293,9 @@ void Scheduler::_run_io(void)
  */
 void Scheduler::_run_uarts()
 {
-    // process any pending serial bytes
+    // mark the devices with data waiting, then process any pending
+    // serial bytes
+    _uart_poller.poll(0);
     for (uint8_t i=0;i<hal.num_serial; i++) {
         hal.serial(i)->_timer_tick();
     }
@@ -398,7 +422,7 @@ uint8_t Scheduler::calculate_thread_priority(priority_base base, int8_t priority
 /*
   create a new thread
 */
-bool Scheduler::thread_create(AP_HAL::MemberProc proc, const char *name, uint32_t stack_size, priority_base base, int8_t priority)
+bool Scheduler::thread_create(AP_HAL::MemberProc proc, const char *name, uint32_t stack_size, priority_base base, int8_t priority, int8_t cpu)
 {
     Thread *thread = new Thread{(Thread::task_t)proc};
     if (!thread) {
@@ -416,6 +440,8 @@ bool Scheduler::thread_create(AP_HAL::MemberProc proc, const char *name, uint32_
      */
     thread->set_auto_free(true);
 
+    set_thread_affinity(*thread, base, cpu);
+
     if (!thread->start(name, SCHED_FIFO, thread_priority)) {
         delete thread;
         return false;
@@ -423,3 +449,117 @@ bool Scheduler::thread_create(AP_HAL::MemberProc proc, const char *name, uint32_
 
     return true;
 }
+
+/*
+  pin the calling thread to a single CPU
+*/
+bool Scheduler::set_thread_cpu_affinity(uint8_t cpu)
+{
+    if (cpu >= sysconf(_SC_NPROCESSORS_ONLN)) {
+        return false;
+    }
+    cpu_set_t cpu_set;
+    CPU_ZERO(&cpu_set);
+    CPU_SET(cpu, &cpu_set);
+    return pthread_setaffinity_np(pthread_self(), sizeof(cpu_set), &cpu_set) == 0;
+}
+
+/*
+  set the affinity of a thread for its priority class. Threads of a
+  class without CPUs get the process affinity, so they are not
+  confined to the CPUs of the thread starting them
+*/
+void Scheduler::set_thread_affinity(Thread &thread, priority_base base, int8_t cpu) const
+{
+    if (cpu >= 0 && cpu < sysconf(_SC_NPROCESSORS_CONF)) {
+        cpu_set_t cpu_set;
+        CPU_ZERO(&cpu_set);
+        CPU_SET(cpu, &cpu_set);
+        thread.set_cpu_affinity(cpu_set);
+        return;
+    }
+    if (base < num_priority_bases && CPU_COUNT(&_thread_affinity[base])) {
+        thread.set_cpu_affinity(_thread_affinity[base]);
+        return;
+    }
+    thread.set_cpu_affinity(_default_affinity);
+}
+
+/*
+  parse a map of priority classes to CPUs, such as
+  "main=3:spi=3:timer=2:io=0-1". The CPUs of each class are in the
+  format of the --cpu-affinity option. Isolated CPUs can be used, so
+  CPUs are only checked against the number the system has
+*/
+bool Scheduler::set_thread_affinity_map(const char *map)
+{
+    static const struct {
+        const char *name;
+        priority_base base;
+    } class_names[] = {
+        { "boost", PRIORITY_BOOST },
+        { "main", PRIORITY_MAIN },
+        { "spi", PRIORITY_SPI },
+        { "i2c", PRIORITY_I2C },
+        { "can", PRIORITY_CAN },
+        { "timer", PRIORITY_TIMER },
+        { "rcout", PRIORITY_RCOUT },
+        { "rcin", PRIORITY_RCIN },
+        { "io", PRIORITY_IO },
+        { "uart", PRIORITY_UART },
+        { "storage", PRIORITY_STORAGE },
+        { "scripting", PRIORITY_SCRIPTING },
+    };
+    const long num_cpus = sysconf(_SC_NPROCESSORS_CONF);
+
+    // only apply the map if all of it is valid
+    cpu_set_t affinity[num_priority_bases];
+    memcpy(affinity, _thread_affinity, sizeof(affinity));
+
+    while (*map != '\0') {
+        const char *eq = strchr(map, '=');
+        if (eq == nullptr) {
+            return false;
+        }
+        const char *end = strchr(eq, ':');
+        if (end == nullptr) {
+            end = eq + strlen(eq);
+        }
+
+        const size_t name_len = eq - map;
+        uint8_t i;
+        for (i = 0; i < ARRAY_SIZE(class_names); i++) {
+            if (strlen(class_names[i].name) == name_len &&
+                strncmp(class_names[i].name, map, name_len) == 0) {
+                break;
+            }
+        }
+        if (i == ARRAY_SIZE(class_names)) {
+            return false;
+        }
+
+        char cpus[64];
+        const size_t cpus_len = end - (eq + 1);
+        if (cpus_len == 0 || cpus_len >= sizeof(cpus)) {
+            return false;
+        }
+        memcpy(cpus, eq + 1, cpus_len);
+        cpus[cpus_len] = '\0';
+
+        cpu_set_t cpu_set;
+        if (!Util::from(hal.util)->parse_cpu_set(cpus, &cpu_set)) {
+            return false;
+        }
+        for (long cpu = num_cpus; cpu < CPU_SETSIZE; cpu++) {
+            if (CPU_ISSET(cpu, &cpu_set)) {
+                return false;
+            }
+        }
+        affinity[class_names[i].base] = cpu_set;
+
+        map = (*end == ':') ? end + 1 : end;
+    }
+
+    memcpy(_thread_affinity, affinity, sizeof(affinity));
+    return true;
+}
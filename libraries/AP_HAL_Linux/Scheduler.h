@@ -4,6 +4,7 @@
 
 #include "AP_HAL_Linux.h"
 
+#include "Poller.h"
 #include "Semaphores.h"
 #include "Thread.h"
 
@@ -15,6 +16,13 @@
 #define AP_LINUX_SENSORS_SCHED_POLICY  SCHED_FIFO
 #define AP_LINUX_SENSORS_SCHED_PRIO 12
 
+/*
+  boards can define HAL_LINUX_THREAD_AFFINITY as a default map of
+  priority classes to CPUs in the format of
+  Scheduler::set_thread_affinity_map(), for example "main=3:spi=3"
+  with CPU 3 isolated by the kernel's isolcpus option
+ */
+
 namespace Linux {
 
 class Scheduler : public AP_HAL::Scheduler {
@@ -52,7 +60,12 @@ public:
     /*
       create a new thread
      */
-    bool thread_create(AP_HAL::MemberProc, const char *name, uint32_t stack_size, priority_base base, int8_t priority) override;
+    bool thread_create(AP_HAL::MemberProc, const char *name, uint32_t stack_size, priority_base base, int8_t priority, int8_t cpu = -1) override;
+
+    /*
+      pin the calling thread to a single CPU
+     */
+    bool set_thread_cpu_affinity(uint8_t cpu) override;
     
     /*
       set cpu affinity mask to be applied on initialization - setting it
@@ -60,6 +73,26 @@ public:
      */
     void set_cpu_affinity(const cpu_set_t &cpu_affinity) { _cpu_affinity = cpu_affinity; }
 
+    /*
+      set the CPUs threads of each priority class run on from a map
+      such as "main=3:spi=3:timer=2:io=0-1", to be applied on
+      initialization. Classes not in the map are left unchanged.
+      Returns false if the map can't be parsed
+     */
+    bool set_thread_affinity_map(const char *map);
+
+    /*
+      set the affinity of a thread that has not been started for its
+      priority class, or for cpu if it is not -1
+     */
+    void set_thread_affinity(Thread &thread, priority_base base, int8_t cpu = -1) const;
+
+    /*
+      poller the UARTs register their devices with, so the UART thread
+      finds the devices with data waiting with one epoll_wait() per tick
+     */
+    Poller &get_uart_poller() { return _uart_poller; }
+
 private:
     class SchedulerThread : public PeriodicThread {
     public:
@@ -116,7 +149,16 @@ private:
     pthread_t _main_ctx;
 
     Semaphore _io_semaphore;
+    Poller _uart_poller;
     cpu_set_t _cpu_affinity;
+
+    // CPUs for threads of each priority class, empty if not set
+    static const uint8_t num_priority_bases = PRIORITY_SCRIPTING + 1;
+    cpu_set_t _thread_affinity[num_priority_bases];
+
+    // affinity of the process on initialization, used for threads
+    // without a CPU set so they don't inherit the main thread's
+    cpu_set_t _default_affinity;
 };
 
 }
@@ -2,6 +2,8 @@
 
 #include "Semaphores.h"
 
+#include <time.h>
+
 extern const AP_HAL::HAL& hal;
 
 using namespace Linux;
@@ -17,13 +19,28 @@ Semaphore::Semaphore()
 
 bool Semaphore::give()
 {
+#if AP_HAL_SEMAPHORE_STATS_ENABLED
+    stats_give();
+#endif
     return pthread_mutex_unlock(&_lock) == 0;
 }
 
 bool Semaphore::take(uint32_t timeout_ms)
 {
     if (timeout_ms == HAL_SEMAPHORE_BLOCK_FOREVER) {
+#if AP_HAL_SEMAPHORE_STATS_ENABLED
+        if (take_nonblocking()) {
+            return true;
+        }
+        const uint32_t wait_start_us = AP_HAL::micros();
+        if (pthread_mutex_lock(&_lock) != 0) {
+            return false;
+        }
+        stats_taken(true, wait_start_us);
+        return true;
+#else
         return pthread_mutex_lock(&_lock) == 0;
+#endif
     }
     if (take_nonblocking()) {
         return true;
@@ -31,7 +48,10 @@ bool Semaphore::take(uint32_t timeout_ms)
     uint64_t start = AP_HAL::micros64();
     do {
         hal.scheduler->delay_microseconds(200);
-        if (take_nonblocking()) {
+        if (try_lock()) {
+#if AP_HAL_SEMAPHORE_STATS_ENABLED
+            stats_taken(true, uint32_t(start));
+#endif
             return true;
         }
     } while ((AP_HAL::micros64() - start) < timeout_ms*1000);
@@ -39,7 +59,68 @@ bool Semaphore::take(uint32_t timeout_ms)
 }
 
 bool Semaphore::take_nonblocking()
+{
+    if (!try_lock()) {
+        return false;
+    }
+#if AP_HAL_SEMAPHORE_STATS_ENABLED
+    stats_taken(false, 0);
+#endif
+    return true;
+}
+
+bool Semaphore::try_lock()
 {
     return pthread_mutex_trylock(&_lock) == 0;
 }
 
+// construct a binary semaphore, initially not signalled
+BinarySemaphore::BinarySemaphore()
+    : _pending(false)
+{
+    pthread_mutex_init(&_lock, nullptr);
+
+    // use the monotonic clock for timed waits
+    pthread_condattr_t attr;
+    pthread_condattr_init(&attr);
+    pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+    pthread_cond_init(&_cond, &attr);
+}
+
+bool BinarySemaphore::wait(uint32_t timeout_us)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    const uint64_t nsec = ts.tv_nsec + timeout_us * 1000ULL;
+    ts.tv_sec += nsec / 1000000000ULL;
+    ts.tv_nsec = nsec % 1000000000ULL;
+
+    pthread_mutex_lock(&_lock);
+    while (!_pending) {
+        if (pthread_cond_timedwait(&_cond, &_lock, &ts) != 0) {
+            break;
+        }
+    }
+    const bool ret = _pending;
+    _pending = false;
+    pthread_mutex_unlock(&_lock);
+    return ret;
+}
+
+void BinarySemaphore::wait_blocking()
+{
+    pthread_mutex_lock(&_lock);
+    while (!_pending) {
+        pthread_cond_wait(&_cond, &_lock);
+    }
+    _pending = false;
+    pthread_mutex_unlock(&_lock);
+}
+
+void BinarySemaphore::signal()
+{
+    pthread_mutex_lock(&_lock);
+    _pending = true;
+    pthread_cond_signal(&_cond);
+    pthread_mutex_unlock(&_lock);
+}
@@ -14,8 +14,23 @@ public:
     bool give() override;
     bool take(uint32_t timeout_ms) override;
     bool take_nonblocking() override;
+protected:
+    // take the semaphore if it is free, without updating statistics
+    bool try_lock();
+
+    pthread_mutex_t _lock;
+};
+
+class BinarySemaphore : public AP_HAL::BinarySemaphore {
+public:
+    BinarySemaphore();
+    bool wait(uint32_t timeout_us) override;
+    void wait_blocking() override;
+    void signal() override;
 protected:
     pthread_mutex_t _lock;
+    pthread_cond_t _cond;
+    bool _pending;
 };
 
 }
@@ -0,0 +1,46 @@
+#include "SerialDevice.h"
+
+ssize_t SerialDevice::writev(const ByteBuffer::IoVec *vec, uint8_t n_vec)
+{
+    ssize_t total = 0;
+    for (uint8_t i = 0; i < n_vec; i++) {
+        const ssize_t ret = write(vec[i].data, vec[i].len);
+        if (ret < 0) {
+            return total > 0 ? total : ret;
+        }
+        total += ret;
+        if ((uint32_t)ret != vec[i].len) {
+            break;
+        }
+    }
+    return total;
+}
+
+ssize_t SerialDevice::readv(const ByteBuffer::IoVec *vec, uint8_t n_vec)
+{
+    ssize_t total = 0;
+    for (uint8_t i = 0; i < n_vec; i++) {
+        const ssize_t ret = read(vec[i].data, vec[i].len);
+        if (ret < 0) {
+            return total > 0 ? total : ret;
+        }
+        total += ret;
+        if ((uint32_t)ret != vec[i].len) {
+            break;
+        }
+    }
+    return total;
+}
+
+/*
+  convert ring buffer parts to iovecs for readv(), writev() or the
+  socket equivalents
+ */
+uint8_t SerialDevice::to_iovec(const ByteBuffer::IoVec *vec, uint8_t n_vec, struct iovec *iov)
+{
+    for (uint8_t i = 0; i < n_vec; i++) {
+        iov[i].iov_base = vec[i].data;
+        iov[i].iov_len = vec[i].len;
+    }
+    return n_vec;
+}
@@ -2,6 +2,9 @@
 
 #include <stdint.h>
 #include <stdlib.h>
+#include <sys/uio.h>
+
+#include <AP_HAL/utility/RingBuffer.h>
 
 #include "AP_HAL_Linux.h"
 
@@ -13,6 +16,21 @@ public:
     virtual bool close() = 0;
     virtual ssize_t write(const uint8_t *buf, uint16_t n) = 0;
     virtual ssize_t read(uint8_t *buf, uint16_t n) = 0;
+
+    /*
+      write or read the parts of a ring buffer with one system call.
+      Datagram devices must send the parts as one packet. The defaults
+      use one write() or read() per part
+     */
+    virtual ssize_t writev(const ByteBuffer::IoVec *vec, uint8_t n_vec);
+    virtual ssize_t readv(const ByteBuffer::IoVec *vec, uint8_t n_vec);
+
+    /*
+      file descriptor that becomes readable when data arrives, or -1
+      if the device has to be read to find out
+     */
+    virtual int get_read_fd() const { return -1; }
+
     virtual void set_blocking(bool blocking) = 0;
     virtual void set_speed(uint32_t speed) = 0;
     virtual AP_HAL::UARTDriver::flow_control get_flow_control(void) { return AP_HAL::UARTDriver::FLOW_CONTROL_ENABLE; }
@@ -23,4 +41,7 @@ public:
 
     /* Depends on lower level to implement, most devices are fine with defaults */
     virtual void set_parity(int v) { }
+
+protected:
+    static uint8_t to_iovec(const ByteBuffer::IoVec *vec, uint8_t n_vec, struct iovec *iov);
 };
@@ -57,6 +57,49 @@ ssize_t TCPServerDevice::read(uint8_t *buf, uint16_t n)
     return ret;
 }
 
+ssize_t TCPServerDevice::writev(const ByteBuffer::IoVec *vec, uint8_t n_vec)
+{
+    if (sock == nullptr) {
+        return -1;
+    }
+    struct iovec iov[n_vec];
+    return sock->sendv(iov, to_iovec(vec, n_vec, iov));
+}
+
+/*
+  as read(), accepting new connections until one is established
+ */
+ssize_t TCPServerDevice::readv(const ByteBuffer::IoVec *vec, uint8_t n_vec)
+{
+    if (sock == nullptr) {
+        sock = listener.accept(0);
+        if (sock != nullptr) {
+            sock->set_blocking(_blocking);
+        }
+    }
+    if (sock == nullptr) {
+        return -1;
+    }
+    struct iovec iov[n_vec];
+    ssize_t ret = sock->recvv(iov, to_iovec(vec, n_vec, iov));
+    if (ret == 0) {
+        // EOF, go back to waiting for a new connection
+        delete sock;
+        sock = nullptr;
+        return -1;
+    }
+    return ret;
+}
+
+/*
+  only a connected socket is polled, so a new connection is never
+  given the file descriptor of the one it replaces while registered
+ */
+int TCPServerDevice::get_read_fd() const
+{
+    return sock == nullptr ? -1 : sock->get_fd();
+}
+
 bool TCPServerDevice::open()
 {
     listener.reuseaddress();
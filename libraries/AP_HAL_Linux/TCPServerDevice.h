@@ -14,6 +14,9 @@ public:
     virtual void set_speed(uint32_t speed) override;
     virtual ssize_t write(const uint8_t *buf, uint16_t n) override;
     virtual ssize_t read(uint8_t *buf, uint16_t n) override;
+    virtual ssize_t writev(const ByteBuffer::IoVec *vec, uint8_t n_vec) override;
+    virtual ssize_t readv(const ByteBuffer::IoVec *vec, uint8_t n_vec) override;
+    virtual int get_read_fd() const override;
 
 private:
     SocketAPM listener{false};
@@ -17,6 +17,7 @@
 #pragma once
 
 #include <pthread.h>
+#include <sched.h>
 #include <inttypes.h>
 #include <stdlib.h>
 
@@ -31,7 +32,7 @@ class Thread {
 public:
     FUNCTOR_TYPEDEF(task_t, void);
 
-    Thread(task_t t) : _task(t) { }
+    Thread(task_t t) : _task(t) { CPU_ZERO(&_cpu_affinity); }
 
     virtual ~Thread() { }
 
@@ -45,6 +46,12 @@ public:
 
     bool set_stack_size(size_t stack_size);
 
+    /*
+     * Set the CPUs the thread may run on, applied when it is started. With
+     * an empty set the thread inherits the affinity of the thread starting it.
+     */
+    void set_cpu_affinity(const cpu_set_t &cpu_affinity) { _cpu_affinity = cpu_affinity; }
+
     void set_auto_free(bool auto_free) { _auto_free = auto_free; }
 
     virtual bool stop() { return false; }
@@ -75,6 +82,8 @@ protected:
     } _stack_debug;
 
     size_t _stack_size = 0;
+
+    cpu_set_t _cpu_affinity;
 };
 
 class PeriodicThread : public Thread {
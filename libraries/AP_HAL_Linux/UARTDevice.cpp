@@ -69,6 +69,32 @@ ssize_t UARTDevice::write(const uint8_t *buf, uint16_t n)
     return ret;
 }
 
+ssize_t UARTDevice::writev(const ByteBuffer::IoVec *vec, uint8_t n_vec)
+{
+    struct pollfd fds;
+    fds.fd = _fd;
+    fds.events = POLLOUT;
+    fds.revents = 0;
+
+    if (poll(&fds, 1, 0) != 1) {
+        return 0;
+    }
+
+    struct iovec iov[n_vec];
+    return ::writev(_fd, iov, to_iovec(vec, n_vec, iov));
+}
+
+ssize_t UARTDevice::readv(const ByteBuffer::IoVec *vec, uint8_t n_vec)
+{
+    struct iovec iov[n_vec];
+    return ::readv(_fd, iov, to_iovec(vec, n_vec, iov));
+}
+
+int UARTDevice::get_read_fd() const
+{
+    return _fd;
+}
+
 void UARTDevice::set_blocking(bool blocking)
 {
     int flags = fcntl(_fd, F_GETFL, 0);
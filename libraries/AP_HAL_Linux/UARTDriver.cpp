@@ -10,6 +10,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <sys/epoll.h>
 #include <sys/ioctl.h>
 #include <sys/socket.h>
 #include <sys/stat.h>
@@ -20,6 +21,7 @@
 #include <AP_HAL/AP_HAL.h>
 
 #include "ConsoleDevice.h"
+#include "Scheduler.h"
 #include "TCPServerDevice.h"
 #include "UARTDevice.h"
 #include "UDPDevice.h"
@@ -75,6 +77,7 @@ void UARTDriver::begin(uint32_t b, uint16_t rxS, uint16_t txS)
                 _device = new ConsoleDevice();
             }
         }
+        _unregister_read_fd();
     }
 
     if (!_connected) {
@@ -222,6 +225,7 @@ void UARTDriver::end()
         hal.scheduler->delay(1);
     }
 
+    _unregister_read_fd();
     _device->close();
     _deallocate_buffers();
 }
@@ -295,6 +299,22 @@ int16_t UARTDriver::read()
     return byte;
 }
 
+/*
+  access received data in place
+ */
+uint8_t UARTDriver::rx_peek(ByteBuffer::IoVec vec[2])
+{
+    if (!_initialised) {
+        return 0;
+    }
+    return _readbuf.peekiovec(vec, _readbuf.available());
+}
+
+bool UARTDriver::rx_consume(uint32_t len)
+{
+    return _readbuf.advance(len);
+}
+
 bool UARTDriver::discard_input()
 {
     if (!_initialised) {
@@ -355,10 +375,40 @@ size_t UARTDriver::write(const uint8_t *buffer, size_t size)
     return ret;
 }
 
+/*
+  reserve len bytes of the write buffer. The write mutex is held until
+  tx_commit()
+ */
+uint8_t UARTDriver::tx_reserve(ByteBuffer::IoVec vec[2], uint32_t len)
+{
+    if (!_initialised || !_nonblocking_writes) {
+        return 0;
+    }
+    if (!_write_mutex.take_nonblocking()) {
+        return 0;
+    }
+    if (_writebuf.space() < len) {
+        _write_mutex.give();
+        return 0;
+    }
+    const uint8_t n = _writebuf.reserve(vec, len);
+    if (n == 0) {
+        _write_mutex.give();
+    }
+    return n;
+}
+
+bool UARTDriver::tx_commit(uint32_t len)
+{
+    const bool ret = _writebuf.commit(len);
+    _write_mutex.give();
+    return ret;
+}
+
 /*
   try writing n bytes, handling an unresponsive port
  */
-int UARTDriver::_write_fd(const uint8_t *buf, uint16_t n)
+int UARTDriver::_write_fd(const ByteBuffer::IoVec *vec, uint8_t n_vec)
 {
     /*
       allow for delayed connection. This allows ArduPilot to start
@@ -371,15 +421,54 @@ int UARTDriver::_write_fd(const uint8_t *buf, uint16_t n)
         return 0;
     }
 
-    return _device->write(buf, n);
+    return _device->writev(vec, n_vec);
 }
 
 /*
-  try reading n bytes, handling an unresponsive port
+  try reading, skipping devices the poller has not found data on
  */
-int UARTDriver::_read_fd(uint8_t *buf, uint16_t n)
+int UARTDriver::_read_fd(const ByteBuffer::IoVec *vec, uint8_t n_vec)
 {
-    return _device->read(buf, n);
+    if (!_read_ready()) {
+        return -1;
+    }
+    return _device->readv(vec, n_vec);
+}
+
+/*
+  return true if the device may have data to read. Devices that can't
+  be polled are read on every tick
+ */
+bool UARTDriver::_read_ready()
+{
+    const int fd = _device->get_read_fd();
+    if (fd != _read_pollable.get_fd()) {
+        // new or reconnected device, read it once on registering
+        _unregister_read_fd();
+        if (fd != -1) {
+            _read_pollable.set_fd(fd);
+            if (!Scheduler::from(hal.scheduler)->get_uart_poller().register_pollable(&_read_pollable, EPOLLIN)) {
+                // e.g. a regular file as console input
+                _read_pollable.set_fd(-1);
+            }
+        }
+        return true;
+    }
+    if (fd == -1) {
+        return true;
+    }
+    const bool ret = _read_pollable.readable;
+    _read_pollable.readable = false;
+    return ret;
+}
+
+void UARTDriver::_unregister_read_fd()
+{
+    if (_read_pollable.get_fd() != -1) {
+        Scheduler::from(hal.scheduler)->get_uart_poller().unregister_pollable(&_read_pollable);
+        _read_pollable.set_fd(-1);
+    }
+    _read_pollable.readable = false;
 }
 
 
@@ -401,30 +490,13 @@ bool UARTDriver::_write_pending_bytes(void)
 #endif
 
     if (n > 0) {
-        int ret;
-
-        if (_packetise) {
-            // keep as a single UDP packet
-            uint8_t tmpbuf[n];
-            _writebuf.peekbytes(tmpbuf, n);
-            ret = _write_fd(tmpbuf, n);
-            if (ret > 0)
-                _writebuf.advance(ret);
-        } else {
-            ByteBuffer::IoVec vec[2];
-            const auto n_vec = _writebuf.peekiovec(vec, n);
-            for (int i = 0; i < n_vec; i++) {
-                ret = _write_fd(vec[i].data, (uint16_t)vec[i].len);
-                if (ret < 0) {
-                    break;
-                }
-                _writebuf.advance(ret);
-
-                /* We wrote less than we asked for, stop */
-                if ((unsigned)ret != vec[i].len) {
-                    break;
-                }
-            }
+        // both parts of the ring buffer go in one system call, and
+        // UDP devices keep them as a single packet
+        ByteBuffer::IoVec vec[2];
+        const auto n_vec = _writebuf.peekiovec(vec, n);
+        const int ret = _write_fd(vec, n_vec);
+        if (ret > 0) {
+            _writebuf.advance(ret);
         }
     }
 
@@ -448,24 +520,17 @@ void UARTDriver::_timer_tick(void)
     }
 
     // try to fill the read buffer
-    int ret;
     ByteBuffer::IoVec vec[2];
 
     const auto n_vec = _readbuf.reserve(vec, _readbuf.space());
-    for (int i = 0; i < n_vec; i++) {
-        ret = _read_fd(vec[i].data, vec[i].len);
-        if (ret < 0) {
-            break;
-        }
-        _readbuf.commit((unsigned)ret);
-
-        // update receive timestamp
-        _receive_timestamp[_receive_timestamp_idx^1] = AP_HAL::micros64();
-        _receive_timestamp_idx ^= 1;
-        
-        /* stop reading as we read less than we asked for */
-        if ((unsigned)ret < vec[i].len) {
-            break;
+    if (n_vec > 0) {
+        const int ret = _read_fd(vec, n_vec);
+        if (ret > 0) {
+            _readbuf.commit((unsigned)ret);
+
+            // update receive timestamp
+            _receive_timestamp[_receive_timestamp_idx^1] = AP_HAL::micros64();
+            _receive_timestamp_idx ^= 1;
         }
     }
 
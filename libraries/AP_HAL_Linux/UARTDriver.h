@@ -4,6 +4,7 @@
 #include <AP_HAL/utility/RingBuffer.h>
 
 #include "AP_HAL_Linux.h"
+#include "Poller.h"
 #include "SerialDevice.h"
 #include "Semaphores.h"
 
@@ -37,6 +38,14 @@ public:
     size_t write(uint8_t c) override;
     size_t write(const uint8_t *buffer, size_t size) override;
 
+    // reserve and commit transmit buffer space for direct writes
+    uint8_t tx_reserve(ByteBuffer::IoVec vec[2], uint32_t len) override;
+    bool tx_commit(uint32_t len) override;
+
+    // access received data in place
+    uint8_t rx_peek(ByteBuffer::IoVec vec[2]) override;
+    bool rx_consume(uint32_t len) override;
+
     void set_device_path(const char *path);
 
     bool _write_pending_bytes(void);
@@ -90,6 +99,23 @@ private:
     uint64_t _receive_timestamp[2];
     uint8_t _receive_timestamp_idx;
 
+    /*
+      the device's read file descriptor registered with the UART
+      thread's poller. The descriptor is owned by the device
+     */
+    class ReadPollable : public Pollable {
+    public:
+        ~ReadPollable() { _fd = -1; }
+        void set_fd(int fd) { _fd = fd; }
+        void on_can_read() override { readable = true; }
+        void on_error() override { readable = true; }
+        void on_hang_up() override { readable = true; }
+        bool readable = false;
+    } _read_pollable;
+
+    bool _read_ready();
+    void _unregister_read_fd();
+
 protected:
     const char *device_path;
     volatile bool _initialised;
@@ -99,8 +125,9 @@ protected:
     ByteBuffer _readbuf{0};
     ByteBuffer _writebuf{0};
 
-    virtual int _write_fd(const uint8_t *buf, uint16_t n);
-    virtual int _read_fd(uint8_t *buf, uint16_t n);
+    // write or read the parts of a ring buffer in one go
+    virtual int _write_fd(const ByteBuffer::IoVec *vec, uint8_t n_vec);
+    virtual int _read_fd(const ByteBuffer::IoVec *vec, uint8_t n_vec);
 
     Linux::Semaphore _write_mutex;
 };
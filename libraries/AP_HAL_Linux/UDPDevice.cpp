@@ -45,6 +45,41 @@ ssize_t UDPDevice::read(uint8_t *buf, uint16_t n)
     return ret;
 }
 
+/*
+  send the parts as one packet
+ */
+ssize_t UDPDevice::writev(const ByteBuffer::IoVec *vec, uint8_t n_vec)
+{
+    struct iovec iov[n_vec];
+    to_iovec(vec, n_vec, iov);
+    if (_connected) {
+        return socket.sendv(iov, n_vec);
+    }
+    if (_input) {
+        // can't send yet
+        return -1;
+    }
+    return socket.sendv(iov, n_vec, _ip, _port);
+}
+
+ssize_t UDPDevice::readv(const ByteBuffer::IoVec *vec, uint8_t n_vec)
+{
+    struct iovec iov[n_vec];
+    ssize_t ret = socket.recvv(iov, to_iovec(vec, n_vec, iov));
+    if (!_connected && ret > 0) {
+        const char *ip;
+        uint16_t port;
+        socket.last_recv_address(ip, port);
+        _connected = socket.connect(ip, port);
+    }
+    return ret;
+}
+
+int UDPDevice::get_read_fd() const
+{
+    return socket.get_fd();
+}
+
 bool UDPDevice::open()
 {
     if (_input) {
@@ -1,5 +1,8 @@
+#include <dirent.h>
 #include <errno.h>
 #include <fcntl.h>
+#include <inttypes.h>
+#include <sched.h>
 #include <stdarg.h>
 #include <stdio.h>
 #include <stdlib.h>
@@ -8,6 +11,7 @@
 #include <unistd.h>
 
 #include <AP_HAL/AP_HAL.h>
+#include <AP_Logger/AP_Logger.h>
 
 #include "Heat_Pwm.h"
 #include "ToneAlarm_Disco.h"
@@ -319,6 +323,89 @@ bool Util::get_random_vals(uint8_t* data, size_t size)
     return true;
 }
 
+/*
+  log the CPU load of the next thread of the process on each call, as
+  STAK does on ChibiOS. Stack use isn't known here. The load is the
+  time the thread ran, from the kernel's scheduler statistics, since
+  it was last logged as a share of the time since then
+ */
+void Util::log_stack_info(void)
+{
+#if HAL_LOGGING_ENABLED
+    static uint8_t thread_id;
+    static struct {
+        pid_t tid;
+        uint64_t run_ns;
+        uint64_t wall_ns;
+    } last[32];
+
+    DIR *d = opendir("/proc/self/task");
+    if (d == nullptr) {
+        return;
+    }
+    pid_t first = 0;
+    pid_t tid = 0;
+    uint8_t n = 0;
+    struct dirent *de;
+    while (tid == 0 && (de = readdir(d)) != nullptr) {
+        if (de->d_name[0] == '.') {
+            continue;
+        }
+        const pid_t t = atoi(de->d_name);
+        if (first == 0) {
+            first = t;
+        }
+        if (n++ == thread_id) {
+            tid = t;
+        }
+    }
+    closedir(d);
+    if (tid == 0) {
+        tid = first;
+        thread_id = 0;
+    }
+    if (tid == 0) {
+        return;
+    }
+
+    char path[48];
+    uint64_t run_ns;
+    snprintf(path, sizeof(path), "/proc/self/task/%d/schedstat", int(tid));
+    if (read_file(path, "%" SCNu64, &run_ns) != 1) {
+        return;
+    }
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    const uint64_t wall_ns = ts.tv_sec*1000000000ULL + ts.tv_nsec;
+
+    struct log_STAK pkt = {
+        LOG_PACKET_HEADER_INIT(LOG_STAK_MSG),
+        time_us         : AP_HAL::micros64(),
+        thread_id       : thread_id,
+    };
+    struct sched_param param;
+    if (sched_getparam(tid, &param) == 0) {
+        pkt.priority = uint8_t(param.sched_priority);
+    }
+    char name[16] {};
+    snprintf(path, sizeof(path), "/proc/self/task/%d/comm", int(tid));
+    if (read_file(path, "%15s", name) == 1) {
+        strncpy_noterm(pkt.name, name, sizeof(pkt.name));
+    }
+    if (thread_id < ARRAY_SIZE(last)) {
+        auto &l = last[thread_id];
+        if (l.tid == tid && wall_ns > l.wall_ns) {
+            pkt.load = MIN((10000 * (run_ns - l.run_ns)) / (wall_ns - l.wall_ns), UINT16_MAX);
+        }
+        l.tid = tid;
+        l.run_ns = run_ns;
+        l.wall_ns = wall_ns;
+    }
+    AP::logger().WriteBlock(&pkt, sizeof(pkt));
+    thread_id++;
+#endif
+}
+
 bool Util::parse_cpu_set(const char *str, cpu_set_t *cpu_set) const
 {
     unsigned long cpu1, cpu2;
@@ -3,6 +3,7 @@
 
 #if CONFIG_HAL_BOARD_SUBTYPE == HAL_BOARD_SUBTYPE_LINUX_BEBOP
 
+#include <AP_HAL_Linux/Flow_PX4.h>
 #include <AP_HAL_Linux/VideoIn.h>
 
 static void BM_Crop8bpp(benchmark::State& state)
@@ -63,6 +64,82 @@ static void BM_YuyvToGrey(benchmark::State& state)
 }
 
 BENCHMARK(BM_YuyvToGrey)->Arg(64 * 64)->Arg(320 * 240)->Arg(640 * 480);
+
+static void BM_Shrink8bpp(benchmark::State& state)
+{
+    uint8_t *buffer, *new_buffer;
+    uint32_t width = 320;
+    uint32_t height = 240;
+    uint32_t scale = height / state.range_x();
+    uint32_t left = (width - state.range_x() * scale) / 2;
+    uint32_t top = (height - state.range_x() * scale) / 2;
+
+    buffer = (uint8_t *)malloc(width * height);
+    if (!buffer) {
+        fprintf(stderr, "error: couldn't malloc buffer\n");
+        return;
+    }
+
+    new_buffer = (uint8_t *)malloc(state.range_x() * state.range_x());
+    if (!new_buffer) {
+        fprintf(stderr, "error: couldn't malloc new_buffer\n");
+        free(buffer);
+        return;
+    }
+
+    while (state.KeepRunning()) {
+        Linux::VideoIn::shrink_8bpp(buffer, new_buffer, width, height,
+            left, state.range_x() * scale, top, state.range_x() * scale,
+            scale, scale);
+    }
+
+    free(buffer);
+    free(new_buffer);
+}
+
+BENCHMARK(BM_Shrink8bpp)->Arg(64)->Arg(120);
+
+/*
+  flow between a textured image and the same image shifted by a pixel
+  in each direction, square images of the given size
+ */
+static void BM_ComputeFlow(benchmark::State& state)
+{
+    const uint32_t size = state.range_x();
+    uint8_t *image1, *image2;
+    float flow_x, flow_y;
+
+    image1 = (uint8_t *)malloc(size * size);
+    image2 = (uint8_t *)malloc(size * size);
+    if (!image1 || !image2) {
+        fprintf(stderr, "error: couldn't malloc images\n");
+        free(image1);
+        free(image2);
+        return;
+    }
+
+    for (uint32_t j = 0; j < size; j++) {
+        for (uint32_t i = 0; i < size; i++) {
+            image1[i + j * size] = (i * 37 + j * 91 + (i * j) % 13) & 0xFF;
+        }
+    }
+    for (uint32_t j = 1; j < size; j++) {
+        memcpy(&image2[j * size + 1], &image1[(j - 1) * size], size - 1);
+    }
+
+    Linux::Flow_PX4 flow(size, size, HAL_FLOW_PX4_MAX_FLOW_PIXEL,
+                         HAL_FLOW_PX4_BOTTOM_FLOW_FEATURE_THRESHOLD,
+                         HAL_FLOW_PX4_BOTTOM_FLOW_VALUE_THRESHOLD);
+
+    while (state.KeepRunning()) {
+        flow.compute_flow(image1, image2, 0, &flow_x, &flow_y);
+    }
+
+    free(image1);
+    free(image2);
+}
+
+BENCHMARK(BM_ComputeFlow)->Arg(64)->Arg(120);
 #endif
 
 BENCHMARK_MAIN()
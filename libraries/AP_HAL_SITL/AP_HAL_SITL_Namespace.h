@@ -18,4 +18,6 @@ class GPIO;
 class DigitalSource;
 class DSP;
 class CANIface;
+class SharedClock;
+class MonteCarlo;
 }  // namespace HALSITL
@@ -0,0 +1,271 @@
+#include "MonteCarlo.h"
+
+#if CONFIG_HAL_BOARD == HAL_BOARD_SITL && !defined(HAL_BUILD_AP_PERIPH)
+
+#include <AP_HAL/AP_HAL.h>
+#include <AP_Param/AP_Param.h>
+
+#include "Scheduler.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+
+using namespace HALSITL;
+
+// wall clock allowance on top of the run duration before a run that
+// has stopped stepping is killed
+#define MONTE_CARLO_HANG_TIMEOUT_S 60
+
+#define MONTE_CARLO_SUMMARY_FILE "montecarlo.csv"
+
+// wall clock time, the simulated clock stops while the parent waits
+static uint64_t monotonic_ms(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return uint64_t(ts.tv_sec)*1000ULL + ts.tv_nsec/1000000;
+}
+
+bool MonteCarlo::init(const char *runs_path, float fork_at_s, float duration_s, uint8_t jobs)
+{
+    FILE *f = fopen(runs_path, "r");
+    if (f == nullptr) {
+        ::fprintf(stderr, "MonteCarlo: open %s failed: %s\n", runs_path, strerror(errno));
+        return false;
+    }
+    char line[512];
+    while (fgets(line, sizeof(line), f) != nullptr) {
+        line[strcspn(line, "#\r\n")] = 0;
+        if (strspn(line, " \t") == strlen(line)) {
+            continue;
+        }
+        char **runs = (char **)realloc(_runs, (_num_runs+1) * sizeof(char *));
+        if (runs == nullptr || _num_runs == UINT16_MAX) {
+            break;
+        }
+        _runs = runs;
+        _runs[_num_runs++] = strdup(line);
+    }
+    fclose(f);
+
+    if (_num_runs == 0) {
+        ::fprintf(stderr, "MonteCarlo: no runs in %s\n", runs_path);
+        return false;
+    }
+
+    _fork_at_us = fork_at_s * 1.0e6;
+    _duration_us = duration_s * 1.0e6;
+    _jobs = jobs > 0 ? jobs : constrain_int32(sysconf(_SC_NPROCESSORS_ONLN), 1, UINT8_MAX);
+
+    ::printf("MonteCarlo: %u runs of %.0fs forked at %.0fs, %u at a time\n",
+             unsigned(_num_runs), duration_s, fork_at_s, unsigned(_jobs));
+    return true;
+}
+
+void MonteCarlo::update(uint64_t time_us, bool armed, const Vector3d &pos_relhome, const Vector3f &vel_ned)
+{
+    if (_run < 0) {
+        // warming up, fork once armed
+        if (armed && time_us >= _fork_at_us) {
+            _start_us = time_us;
+            run_all();
+        }
+        return;
+    }
+
+    _max_alt = MAX(_max_alt, -pos_relhome.z);
+    _max_speed = MAX(_max_speed, vel_ned.length());
+
+    if (!armed) {
+        finish("disarmed", time_us, pos_relhome);
+    }
+    if (time_us - _start_us >= _duration_us) {
+        finish("timeout", time_us, pos_relhome);
+    }
+}
+
+/*
+  fork the runs, keeping up to _jobs of them going at once, and wait
+  for them all to finish. Only the children return from start_run()
+ */
+void MonteCarlo::run_all(void)
+{
+    int fd = open(MONTE_CARLO_SUMMARY_FILE, O_WRONLY|O_CREAT|O_TRUNC, 0644);
+    if (fd == -1) {
+        AP_HAL::panic("MonteCarlo: create %s failed: %s", MONTE_CARLO_SUMMARY_FILE, strerror(errno));
+    }
+    close(fd);
+    write_line("run,status,seed,end_time_s,north_m,east_m,down_m,max_alt_m,max_speed_ms,params\n");
+
+    ::printf("MonteCarlo: forking %u runs at %.3fs\n", unsigned(_num_runs), _start_us*1.0e-6);
+    fflush(stdout);
+
+    struct child *children = new struct child[_jobs];
+    uint8_t active = 0;
+    uint16_t next_run = 0;
+    uint16_t failed = 0;
+    const uint64_t hang_ms = _duration_us/1000 + MONTE_CARLO_HANG_TIMEOUT_S*1000;
+
+    while (next_run < _num_runs || active > 0) {
+        while (active < _jobs && next_run < _num_runs) {
+            const pid_t pid = start_run(next_run);
+            if (pid == 0) {
+                // we are the child, carry on with the simulation
+                delete[] children;
+                return;
+            }
+            if (pid == -1) {
+                AP_HAL::panic("MonteCarlo: fork failed: %s", strerror(errno));
+            }
+            children[active++] = { pid, next_run, monotonic_ms() };
+            next_run++;
+        }
+
+        int status;
+        const pid_t pid = waitpid(-1, &status, WNOHANG);
+        const uint64_t now_ms = monotonic_ms();
+        uint8_t i = 0;
+        while (i < active) {
+            struct child &c = children[i];
+            const char *fail = nullptr;
+            if (c.pid == pid) {
+                if (WIFSIGNALED(status)) {
+                    fail = "crashed";
+                } else if (WEXITSTATUS(status) != 0) {
+                    fail = "failed";
+                }
+            } else if (now_ms - c.start_ms > hang_ms) {
+                // a thread that was lost in the fork may have held a
+                // lock, don't wait forever for it
+                kill(c.pid, SIGKILL);
+                waitpid(c.pid, nullptr, 0);
+                fail = "hung";
+            } else {
+                i++;
+                continue;
+            }
+            if (fail != nullptr) {
+                char line[600];
+                snprintf(line, sizeof(line), "%u,%s,,,,,,,,%s\n", unsigned(c.run), fail, _runs[c.run]);
+                write_line(line);
+                failed++;
+            }
+            children[i] = children[--active];
+        }
+        if (pid <= 0) {
+            usleep(10000);
+        }
+    }
+
+    ::printf("MonteCarlo: %u runs done, %u failed, results in %s\n",
+             unsigned(_num_runs), unsigned(failed), MONTE_CARLO_SUMMARY_FILE);
+    exit(failed == 0 ? 0 : 1);
+}
+
+/*
+  fork one run, returning 0 in the child with the run set up
+ */
+pid_t MonteCarlo::start_run(uint16_t run)
+{
+    fflush(stdout);
+    fflush(stderr);
+    const pid_t pid = fork();
+    if (pid != 0) {
+        return pid;
+    }
+
+    _run = run;
+    _seed = run + 1;
+    detach();
+
+    char *s = strdup(_runs[run]);
+    char *saveptr = nullptr;
+    for (char *tok = strtok_r(s, " \t", &saveptr); tok; tok = strtok_r(nullptr, " \t", &saveptr)) {
+        char *eq = strchr(tok, '=');
+        if (eq == nullptr) {
+            ::fprintf(stderr, "MonteCarlo: run %u: expected NAME=VALUE, not %s\n", unsigned(run), tok);
+            _exit(1);
+        }
+        *eq = 0;
+        if (strcmp(tok, "SEED") == 0) {
+            _seed = strtoul(eq+1, nullptr, 0);
+        } else if (!AP_Param::set_and_save_by_name(tok, strtof(eq+1, nullptr))) {
+            ::fprintf(stderr, "MonteCarlo: run %u: unknown parameter %s\n", unsigned(run), tok);
+            _exit(1);
+        }
+    }
+    free(s);
+
+    // the simulated sensor noise comes from random()
+    srandom(_seed);
+    srand(_seed);
+
+    Scheduler::restart_threads_after_fork();
+    return 0;
+}
+
+/*
+  replace the sockets and files shared with the parent and the other
+  runs by /dev/null, so the runs can't interfere with each other
+  through them. Using dup2() rather than close() means a descriptor
+  still held by a driver can't end up referring to a file opened
+  later
+ */
+void MonteCarlo::detach(void)
+{
+    const int devnull = open("/dev/null", O_RDWR);
+    if (devnull == -1) {
+        _exit(1);
+    }
+    const int max_fd = MIN(sysconf(_SC_OPEN_MAX), 4096);
+    for (int fd=3; fd<max_fd; fd++) {
+        struct stat st;
+        if (fd == devnull || fstat(fd, &st) != 0) {
+            continue;
+        }
+        if (S_ISSOCK(st.st_mode) || S_ISREG(st.st_mode)) {
+            dup2(devnull, fd);
+        }
+    }
+    close(devnull);
+}
+
+void MonteCarlo::finish(const char *status, uint64_t time_us, const Vector3d &pos_relhome)
+{
+    char line[600];
+    snprintf(line, sizeof(line), "%u,%s,%u,%.3f,%.2f,%.2f,%.2f,%.2f,%.2f,%s\n",
+             unsigned(_run), status, unsigned(_seed),
+             (time_us - _start_us)*1.0e-6,
+             pos_relhome.x, pos_relhome.y, pos_relhome.z,
+             _max_alt, _max_speed,
+             _runs[_run]);
+    write_line(line);
+    fflush(stdout);
+    fflush(stderr);
+    // skip the exit handlers, they belong to the parent
+    _exit(0);
+}
+
+/*
+  append a line to the summary. A single write to a file opened with
+  O_APPEND keeps lines from concurrent runs whole
+ */
+void MonteCarlo::write_line(const char *line)
+{
+    const int fd = open(MONTE_CARLO_SUMMARY_FILE, O_WRONLY|O_APPEND);
+    if (fd == -1) {
+        return;
+    }
+    UNUSED_RESULT(write(fd, line, strlen(line)));
+    close(fd);
+}
+
+#endif  // CONFIG_HAL_BOARD == HAL_BOARD_SITL && !defined(HAL_BUILD_AP_PERIPH)
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <AP_HAL/AP_HAL_Boards.h>
+
+#if CONFIG_HAL_BOARD == HAL_BOARD_SITL && !defined(HAL_BUILD_AP_PERIPH)
+
+#include "AP_HAL_SITL_Namespace.h"
+
+#include <stdint.h>
+#include <sys/types.h>
+#include <AP_Math/AP_Math.h>
+
+/*
+  Monte-Carlo runs forked from a warmed up vehicle. SITL boots, loads
+  parameters and aligns its EKF once, and at the first physics step
+  after the fork time at which the vehicle is armed the process forks
+  one child per line of the runs file. The children carry on from that
+  snapshot of the vehicle, HAL and physics state with their own random
+  seed and parameter changes, while the parent only schedules them and
+  collects one line of results per run into a summary file.
+
+  Each line of the runs file is a list of NAME=VALUE parameter
+  settings, with SEED=N setting the random seed of the run. A run ends
+  when the vehicle disarms or after the run duration. The variants run
+  detached from all sockets and files, so they have no GCS links and
+  write no logs or parameters, and only the built in physics models
+  can be forked.
+ */
+class HALSITL::MonteCarlo {
+public:
+    // load the runs file, false if it can't be read or has no runs
+    bool init(const char *runs_path, float fork_at_s, float duration_s, uint8_t jobs);
+
+    bool enabled() const { return _num_runs > 0; }
+
+    // called after each physics step. At the fork point this only
+    // returns in the children
+    void update(uint64_t time_us, bool armed, const Vector3d &pos_relhome, const Vector3f &vel_ned);
+
+private:
+    char **_runs;
+    uint16_t _num_runs;
+    uint64_t _fork_at_us;
+    uint64_t _duration_us;
+    uint8_t _jobs;
+
+    // state of the run in a child
+    int16_t _run = -1;
+    uint64_t _start_us;
+    uint32_t _seed;
+    float _max_alt;
+    float _max_speed;
+
+    struct child {
+        pid_t pid;
+        uint16_t run;
+        uint64_t start_ms;
+    };
+
+    // parent side, fork the runs and wait for them. Only returns in
+    // the children
+    void run_all(void);
+    pid_t start_run(uint16_t run);
+    void write_line(const char *line);
+
+    // child side
+    void detach(void);
+    void finish(const char *status, uint64_t time_us, const Vector3d &pos_relhome) NORETURN;
+};
+
+#endif  // CONFIG_HAL_BOARD == HAL_BOARD_SITL && !defined(HAL_BUILD_AP_PERIPH)
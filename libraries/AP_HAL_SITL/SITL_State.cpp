@@ -557,6 +557,9 @@ void SITL_State::_fdm_input_local(void)
     ride_along.receive(input);
 #endif
 
+    // step the physics together with the rest of the swarm
+    shared_clock.step();
+
     // update the model
     sitl_model->update_model(input);
 
@@ -576,6 +579,12 @@ void SITL_State::_fdm_input_local(void)
     ride_along.send(_sitl->state,sitl_model->get_position_relhome());
 #endif
 
+    if (monte_carlo.enabled() && _sitl) {
+        const Vector3f vel_ned(_sitl->state.speedN, _sitl->state.speedE, _sitl->state.speedD);
+        monte_carlo.update(_sitl->state.timestamp_us, hal.util->get_soft_armed(),
+                           sitl_model->get_position_relhome(), vel_ned);
+    }
+
     if (gimbal != nullptr) {
         gimbal->update();
     }
@@ -11,6 +11,8 @@
 #include "AP_HAL_SITL_Namespace.h"
 #include "HAL_SITL_Class.h"
 #include "RCInput.h"
+#include "SharedClock.h"
+#include "MonteCarlo.h"
 
 #include <sys/types.h>
 #include <sys/socket.h>
@@ -279,6 +281,12 @@ private:
     SITL::JSON_Master ride_along;
 #endif
 
+    // physics clock shared with the other vehicles of a swarm
+    SharedClock shared_clock;
+
+    // variant runs forked from a warmed up vehicle
+    MonteCarlo monte_carlo;
+
 #if HAL_SIM_AIS_ENABLED
     // simulated AIS stream
     SITL::AIS *ais;
@@ -118,6 +118,11 @@ void SITL_State::_usage(void)
            "\t--start-time TIMESTR     set simulation start time in UNIX timestamp\n"
            "\t--sysid ID               set SYSID_THISMAV\n"
            "\t--slave number           set the number of JSON slaves\n"
+           "\t--shared-clock N         step physics in lockstep with N SITL instances\n"
+           "\t--fork-runs FILE         fork one run per line of FILE once warmed up and armed\n"
+           "\t--fork-at SECONDS        earliest simulation time to fork the runs at (default 0)\n"
+           "\t--fork-duration SECONDS  maximum length of each forked run (default 600)\n"
+           "\t--fork-jobs N            number of forked runs at once (default number of CPUs)\n"
         );
 }
 
@@ -233,6 +238,11 @@ void SITL_State::_parse_command_line(int argc, char * const argv[])
     static struct timeval first_tv;
     gettimeofday(&first_tv, nullptr);
     time_t start_time_UTC = first_tv.tv_sec;
+    uint8_t shared_clock_vehicles = 0;
+    const char *fork_runs = nullptr;
+    float fork_at_s = 0;
+    float fork_duration_s = 600;
+    uint8_t fork_jobs = 0;
     const bool is_replay = APM_BUILD_TYPE(APM_BUILD_Replay);
 
     enum long_options {
@@ -270,6 +280,11 @@ void SITL_State::_parse_command_line(int argc, char * const argv[])
         CMDLINE_START_TIME,
         CMDLINE_SYSID,
         CMDLINE_SLAVE,
+        CMDLINE_SHARED_CLOCK,
+        CMDLINE_FORK_RUNS,
+        CMDLINE_FORK_AT,
+        CMDLINE_FORK_DURATION,
+        CMDLINE_FORK_JOBS,
 #if STORAGE_USE_FLASH
         CMDLINE_SET_STORAGE_FLASH_ENABLED,
 #endif
@@ -329,6 +344,11 @@ void SITL_State::_parse_command_line(int argc, char * const argv[])
         {"start-time",      true,   0, CMDLINE_START_TIME},
         {"sysid",           true,   0, CMDLINE_SYSID},
         {"slave",           true,   0, CMDLINE_SLAVE},
+        {"shared-clock",    true,   0, CMDLINE_SHARED_CLOCK},
+        {"fork-runs",       true,   0, CMDLINE_FORK_RUNS},
+        {"fork-at",         true,   0, CMDLINE_FORK_AT},
+        {"fork-duration",   true,   0, CMDLINE_FORK_DURATION},
+        {"fork-jobs",       true,   0, CMDLINE_FORK_JOBS},
 #if STORAGE_USE_FLASH
         {"set-storage-flash-enabled", true,   0, CMDLINE_SET_STORAGE_FLASH_ENABLED},
 #endif
@@ -525,12 +545,44 @@ void SITL_State::_parse_command_line(int argc, char * const argv[])
 #endif
             break;
         }
+        case CMDLINE_SHARED_CLOCK:
+            shared_clock_vehicles = atoi(gopt.optarg);
+            break;
+        case CMDLINE_FORK_RUNS:
+            fork_runs = gopt.optarg;
+            break;
+        case CMDLINE_FORK_AT:
+            fork_at_s = atof(gopt.optarg);
+            break;
+        case CMDLINE_FORK_DURATION:
+            fork_duration_s = atof(gopt.optarg);
+            break;
+        case CMDLINE_FORK_JOBS:
+            fork_jobs = atoi(gopt.optarg);
+            break;
         default:
             _usage();
             exit(1);
         }
     }
 
+    // join the clock after the options as it needs the instance number
+    if (shared_clock_vehicles > 0 &&
+        !shared_clock.init(_instance, shared_clock_vehicles)) {
+        printf("Failed to setup shared clock for %u vehicles\n", unsigned(shared_clock_vehicles));
+        exit(1);
+    }
+
+    if (fork_runs != nullptr) {
+        if (shared_clock.enabled()) {
+            printf("Forked runs can't share a clock with other vehicles\n");
+            exit(1);
+        }
+        if (!monte_carlo.init(fork_runs, fork_at_s, fork_duration_s, fork_jobs)) {
+            exit(1);
+        }
+    }
+
     if (!model_str) {
         printf("You must specify a vehicle model.  Options are:\n");
         for (uint8_t i=0; i < ARRAY_SIZE(model_constructors); i++) {
@@ -13,6 +13,7 @@
 #include <malloc.h>
 #endif
 #include <AP_RCProtocol/AP_RCProtocol.h>
+#include <AP_Logger/AP_Logger.h>
 #ifdef UBSAN_ENABLED
 #include <sanitizer/asan_interface.h>
 #endif
@@ -335,7 +336,7 @@ void *Scheduler::thread_create_trampoline(void *ctx)
 /*
   create a new thread
 */
-bool Scheduler::thread_create(AP_HAL::MemberProc proc, const char *name, uint32_t stack_size, priority_base base, int8_t priority)
+bool Scheduler::thread_create(AP_HAL::MemberProc proc, const char *name, uint32_t stack_size, priority_base base, int8_t priority, int8_t cpu)
 {
     WITH_SEMAPHORE(_thread_sem);
 
@@ -367,6 +368,8 @@ bool Scheduler::thread_create(AP_HAL::MemberProc proc, const char *name, uint32_
     a->stack_size = stack_size;
     a->f[0] = proc;
     a->name = name;
+    a->cpu_ns = 0;
+    a->wall_ns = 0;
 
     if (pthread_attr_init(&a->attr) != 0) {
         goto failed;
@@ -394,6 +397,21 @@ failed:
     return false;
 }
 
+/*
+  start each thread again from its entry point in a forked child. The
+  stacks and thread list are copies of the parent's, and the parent's
+  threads no longer exist in this process
+ */
+void Scheduler::restart_threads_after_fork(void)
+{
+    for (struct thread_attr *a=threads; a; a=a->next) {
+        pthread_t thread {};
+        if (pthread_create(&thread, &a->attr, thread_create_trampoline, a) != 0) {
+            AP_HAL::panic("Failed to restart thread %s", a->name);
+        }
+    }
+}
+
 /*
   check for stack overflow
  */
@@ -410,6 +428,78 @@ void Scheduler::check_thread_stacks(void)
     }
 }
 
+/*
+  CPU time used by a thread since it was last logged, as a share of
+  the wall clock time in hundredths of a percent. This is real time,
+  not simulation time, so is the load on the host at any speedup
+ */
+uint16_t Scheduler::take_thread_load(struct thread_attr *a)
+{
+#if defined(__linux__)
+    clockid_t cid;
+    struct timespec cpu_ts, wall_ts;
+    if (pthread_getcpuclockid(a->thread, &cid) != 0 ||
+        clock_gettime(cid, &cpu_ts) != 0 ||
+        clock_gettime(CLOCK_MONOTONIC, &wall_ts) != 0) {
+        return 0;
+    }
+    const uint64_t cpu_ns = cpu_ts.tv_sec*1000000000ULL + cpu_ts.tv_nsec;
+    const uint64_t wall_ns = wall_ts.tv_sec*1000000000ULL + wall_ts.tv_nsec;
+    uint16_t load = 0;
+    if (a->wall_ns != 0 && wall_ns > a->wall_ns) {
+        load = MIN((10000 * (cpu_ns - a->cpu_ns)) / (wall_ns - a->wall_ns), UINT16_MAX);
+    }
+    a->cpu_ns = cpu_ns;
+    a->wall_ns = wall_ns;
+    return load;
+#else
+    return 0;
+#endif
+}
+
+/*
+  log stack use and CPU load of the next thread on each call, as on
+  ChibiOS. Stack use is only known with stack checking enabled
+ */
+void Scheduler::log_stack_info(void)
+{
+#if HAL_LOGGING_ENABLED
+    static uint8_t thread_id;
+    WITH_SEMAPHORE(_thread_sem);
+    struct thread_attr *a = threads;
+    for (uint8_t i=0; a != nullptr && i<thread_id; i++) {
+        a = a->next;
+    }
+    if (a == nullptr) {
+        a = threads;
+        thread_id = 0;
+    }
+    if (a == nullptr) {
+        return;
+    }
+    struct log_STAK pkt = {
+        LOG_PACKET_HEADER_INIT(LOG_STAK_MSG),
+        time_us         : AP_HAL::micros64(),
+        thread_id       : thread_id,
+        priority        : 0,
+        stack_total     : uint16_t(MIN(a->stack_size, UINT16_MAX)),
+        stack_free      : 0,
+        name            : {},
+        load            : take_thread_load(a),
+    };
+#if SITL_STACK_CHECKING_ENABLED
+    const uint8_t *p = a->stack_min;
+    while (p < a->stack_min + a->stack_size && *p == stackfill) {
+        p++;
+    }
+    pkt.stack_free = uint16_t(MIN(uint32_t(p - a->stack_min), UINT16_MAX));
+#endif
+    strncpy_noterm(pkt.name, a->name, sizeof(pkt.name));
+    AP::logger().WriteBlock(&pkt, sizeof(pkt));
+    thread_id++;
+#endif
+}
+
 // get the name of the current thread, or nullptr if not known
 const char *Scheduler::get_current_thread_name(void) const
 {
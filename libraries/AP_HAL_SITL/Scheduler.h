@@ -56,7 +56,8 @@ public:
       create a new thread
      */
     bool thread_create(AP_HAL::MemberProc, const char *name,
-                       uint32_t stack_size, priority_base base, int8_t priority) override;
+                       uint32_t stack_size, priority_base base, int8_t priority,
+                       int8_t cpu = -1) override;
 
     void set_in_semaphore_take_wait(bool value) { _in_semaphore_take_wait = value; }
     /*
@@ -70,6 +71,13 @@ public:
     // get the name of the current thread, or nullptr if not known
     const char *get_current_thread_name(void) const;
 
+    // start the threads again in a forked child, which only has a
+    // copy of the thread that called fork()
+    static void restart_threads_after_fork(void);
+
+    // log the stack and CPU use of the next thread
+    static void log_stack_info(void);
+
 private:
     SITL_State *_sitlState;
     uint8_t _nested_atomic_ctr;
@@ -93,6 +101,7 @@ private:
 
     static void *thread_create_trampoline(void *ctx);
     static void check_thread_stacks(void);
+    static uint16_t take_thread_load(struct thread_attr *a);
     
     bool _initialized;
     uint64_t _stopped_clock_usec;
@@ -109,6 +118,8 @@ private:
         const uint8_t *stack_min;
         const char *name;
         pthread_t thread;
+        uint64_t cpu_ns;    // thread CPU time when last logged
+        uint64_t wall_ns;   // wall clock time when last logged
     };
     static struct thread_attr *threads;
     static const uint8_t stackfill = 0xEB;
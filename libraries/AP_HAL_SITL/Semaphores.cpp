@@ -21,6 +21,9 @@ Semaphore::Semaphore()
 
 bool Semaphore::give()
 {
+#if AP_HAL_SEMAPHORE_STATS_ENABLED
+    stats_give();
+#endif
     take_count--;
     if (pthread_mutex_unlock(&_lock) != 0) {
         AP_HAL::panic("Bad semaphore usage");
@@ -42,15 +45,23 @@ void Semaphore::check_owner() const
 bool Semaphore::take(uint32_t timeout_ms)
 {
     if (timeout_ms == HAL_SEMAPHORE_BLOCK_FOREVER) {
+#if AP_HAL_SEMAPHORE_STATS_ENABLED
+        if (take_nonblocking()) {
+            return true;
+        }
+        const uint32_t wait_start_us = AP_HAL::micros();
+#endif
         if (pthread_mutex_lock(&_lock) == 0) {
             owner = pthread_self();
             take_count++;
+#if AP_HAL_SEMAPHORE_STATS_ENABLED
+            stats_taken(true, wait_start_us);
+#endif
             return true;
         }
         return false;
     }
     if (take_nonblocking()) {
-        owner = pthread_self();
         return true;
     }
     uint64_t start = AP_HAL::micros64();
@@ -58,8 +69,10 @@ bool Semaphore::take(uint32_t timeout_ms)
         Scheduler::from(hal.scheduler)->set_in_semaphore_take_wait(true);
         hal.scheduler->delay_microseconds(200);
         Scheduler::from(hal.scheduler)->set_in_semaphore_take_wait(false);
-        if (take_nonblocking()) {
-            owner = pthread_self();
+        if (try_lock()) {
+#if AP_HAL_SEMAPHORE_STATS_ENABLED
+            stats_taken(true, uint32_t(start));
+#endif
             return true;
         }
     } while ((AP_HAL::micros64() - start) < timeout_ms * 1000);
@@ -67,6 +80,17 @@ bool Semaphore::take(uint32_t timeout_ms)
 }
 
 bool Semaphore::take_nonblocking()
+{
+    if (!try_lock()) {
+        return false;
+    }
+#if AP_HAL_SEMAPHORE_STATS_ENABLED
+    stats_taken(false, 0);
+#endif
+    return true;
+}
+
+bool Semaphore::try_lock()
 {
     if (pthread_mutex_trylock(&_lock) == 0) {
         owner = pthread_self();
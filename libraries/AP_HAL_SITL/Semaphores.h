@@ -17,6 +17,9 @@ public:
     void check_owner() const;  // asserts that current thread owns semaphore
 
 protected:
+    // take the semaphore if it is free, without updating statistics
+    bool try_lock();
+
     pthread_mutex_t _lock;
     pthread_t owner;
 
@@ -0,0 +1,166 @@
+#include "SharedClock.h"
+
+#if CONFIG_HAL_BOARD == HAL_BOARD_SITL && !defined(HAL_BUILD_AP_PERIPH)
+
+#include <AP_HAL/AP_HAL.h>
+
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <time.h>
+#include <unistd.h>
+
+using namespace HALSITL;
+
+// time to wait for the rest of the group before running free
+#define SHARED_CLOCK_TIMEOUT_S 10
+
+// time for instance 0 to create the clock
+#define SHARED_CLOCK_ATTACH_TIMEOUT_S 30
+
+#define SHARED_CLOCK_MAGIC 0x4b4c4353 // "SCLK"
+
+struct SharedClock::shared_state {
+    volatile uint32_t magic;
+    pthread_mutex_t mutex;
+    pthread_cond_t cond;
+    uint8_t num_vehicles;
+    uint8_t waiting;
+    uint32_t generation;
+};
+
+bool SharedClock::init(uint8_t instance, uint8_t num_vehicles)
+{
+    if (num_vehicles < 2) {
+        return false;
+    }
+    _instance = instance;
+
+    char name[32];
+    snprintf(name, sizeof(name), "/ap_sitl_clock_%u", unsigned(getuid()));
+
+    int fd;
+    if (instance == 0) {
+        // remove a clock left over from an earlier run
+        shm_unlink(name);
+        fd = shm_open(name, O_RDWR|O_CREAT|O_EXCL, 0600);
+        if (fd == -1 || ftruncate(fd, sizeof(shared_state)) != 0) {
+            ::fprintf(stderr, "SharedClock: create %s failed: %s\n", name, strerror(errno));
+            if (fd != -1) {
+                close(fd);
+            }
+            return false;
+        }
+    } else {
+        // wait for instance 0 to create the clock
+        const uint64_t start_ms = AP_HAL::millis64();
+        while ((fd = shm_open(name, O_RDWR, 0600)) == -1) {
+            if (AP_HAL::millis64() - start_ms > SHARED_CLOCK_ATTACH_TIMEOUT_S*1000) {
+                ::fprintf(stderr, "SharedClock: open %s failed: %s\n", name, strerror(errno));
+                return false;
+            }
+            usleep(10000);
+        }
+    }
+
+    void *p = mmap(nullptr, sizeof(shared_state), PROT_READ|PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (p == MAP_FAILED) {
+        ::fprintf(stderr, "SharedClock: mmap failed: %s\n", strerror(errno));
+        return false;
+    }
+    shared_state *shm = (shared_state *)p;
+
+    if (instance == 0) {
+        pthread_mutexattr_t mattr;
+        pthread_mutexattr_init(&mattr);
+        pthread_mutexattr_setpshared(&mattr, PTHREAD_PROCESS_SHARED);
+        pthread_mutex_init(&shm->mutex, &mattr);
+        pthread_mutexattr_destroy(&mattr);
+
+        pthread_condattr_t cattr;
+        pthread_condattr_init(&cattr);
+        pthread_condattr_setpshared(&cattr, PTHREAD_PROCESS_SHARED);
+        pthread_condattr_setclock(&cattr, CLOCK_MONOTONIC);
+        pthread_cond_init(&shm->cond, &cattr);
+        pthread_condattr_destroy(&cattr);
+
+        shm->num_vehicles = num_vehicles;
+        shm->waiting = 0;
+        shm->generation = 0;
+        __sync_synchronize();
+        shm->magic = SHARED_CLOCK_MAGIC;
+    } else {
+        // the file exists before instance 0 has initialised it
+        const uint64_t start_ms = AP_HAL::millis64();
+        while (shm->magic != SHARED_CLOCK_MAGIC) {
+            if (AP_HAL::millis64() - start_ms > SHARED_CLOCK_ATTACH_TIMEOUT_S*1000) {
+                ::fprintf(stderr, "SharedClock: %s not initialised\n", name);
+                munmap(p, sizeof(shared_state));
+                return false;
+            }
+            usleep(10000);
+        }
+        if (shm->num_vehicles != num_vehicles) {
+            ::fprintf(stderr, "SharedClock: %u vehicles expected, clock has %u\n",
+                      unsigned(num_vehicles), unsigned(shm->num_vehicles));
+            munmap(p, sizeof(shared_state));
+            return false;
+        }
+    }
+
+    _shm = shm;
+    ::printf("SharedClock: instance %u of %u\n", unsigned(instance), unsigned(num_vehicles));
+    return true;
+}
+
+void SharedClock::step()
+{
+    if (_shm == nullptr || _timed_out) {
+        return;
+    }
+
+    pthread_mutex_lock(&_shm->mutex);
+    const uint32_t generation = _shm->generation;
+    if (++_shm->waiting >= _shm->num_vehicles) {
+        // last one in, release the group
+        _shm->waiting = 0;
+        _shm->generation++;
+        pthread_cond_broadcast(&_shm->cond);
+        pthread_mutex_unlock(&_shm->mutex);
+        return;
+    }
+
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    ts.tv_sec += SHARED_CLOCK_TIMEOUT_S;
+    while (_shm->generation == generation) {
+        if (generation == 0) {
+            // the first step waits for every vehicle to start
+            pthread_cond_wait(&_shm->cond, &_shm->mutex);
+            continue;
+        }
+        if (pthread_cond_timedwait(&_shm->cond, &_shm->mutex, &ts) == ETIMEDOUT &&
+            _shm->generation == generation) {
+            // a vehicle has stopped stepping; leave the group rather
+            // than hanging the rest of the swarm
+            _shm->waiting--;
+            _shm->num_vehicles--;
+            if (_shm->waiting > 0 && _shm->waiting >= _shm->num_vehicles) {
+                // the vehicles still waiting are now the whole group
+                _shm->waiting = 0;
+                _shm->generation++;
+                pthread_cond_broadcast(&_shm->cond);
+            }
+            _timed_out = true;
+            ::fprintf(stderr, "SharedClock: instance %u timed out, running free\n", unsigned(_instance));
+            break;
+        }
+    }
+    pthread_mutex_unlock(&_shm->mutex);
+}
+
+#endif  // CONFIG_HAL_BOARD == HAL_BOARD_SITL && !defined(HAL_BUILD_AP_PERIPH)
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <AP_HAL/AP_HAL_Boards.h>
+
+#if CONFIG_HAL_BOARD == HAL_BOARD_SITL && !defined(HAL_BUILD_AP_PERIPH)
+
+#include "AP_HAL_SITL_Namespace.h"
+
+#include <stdint.h>
+
+/*
+  a physics step barrier shared by a group of SITL processes through
+  POSIX shared memory, so a swarm of vehicles is stepped together
+  without the per-vehicle socket time sync. Instance 0 creates the
+  barrier and the other instances attach to it
+ */
+class HALSITL::SharedClock {
+public:
+    // join the clock shared by num_vehicles instances
+    bool init(uint8_t instance, uint8_t num_vehicles);
+
+    // wait until every vehicle is ready to step its physics. If the
+    // group does not complete within a timeout, for example because a
+    // vehicle has exited, this vehicle leaves the group and runs free
+    // so the swarm does not hang
+    void step();
+
+    bool enabled() const { return _shm != nullptr; }
+
+private:
+    struct shared_state;
+
+    shared_state *_shm;
+    uint8_t _instance;
+    bool _timed_out;
+};
+
+#endif  // CONFIG_HAL_BOARD == HAL_BOARD_SITL && !defined(HAL_BUILD_AP_PERIPH)
@@ -160,6 +160,22 @@ void Storage::write_block(uint16_t loc, const void *src, size_t n)
     }
 }
 
+void Storage::begin_batch(void)
+{
+    WITH_SEMAPHORE(_batch_sem);
+    if (_batch_depth++ == 0) {
+        _batch_start_ms = AP_HAL::millis();
+    }
+}
+
+void Storage::end_batch(void)
+{
+    WITH_SEMAPHORE(_batch_sem);
+    if (_batch_depth > 0) {
+        _batch_depth--;
+    }
+}
+
 void Storage::_timer_tick(void)
 {
     if (_initialisedType == StorageBackend::None) {
@@ -170,6 +186,11 @@ void Storage::_timer_tick(void)
         return;
     }
 
+    if (_batch_depth > 0 && AP_HAL::millis() - _batch_start_ms < HAL_STORAGE_BATCH_MAX_MS) {
+        // hold the lines back until the batch ends
+        return;
+    }
+
     // write out the first dirty line. We don't write more
     // than one to keep the latency of this call to a minimum
     uint16_t i;
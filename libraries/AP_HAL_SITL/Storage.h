@@ -21,6 +21,12 @@
 #define STORAGE_LINE_SHIFT 3
 
 #define STORAGE_LINE_SIZE (1<<STORAGE_LINE_SHIFT)
+
+// a batch of writes that is not ended within this time is written
+// anyway, so a missing end_batch() can't stop storage being saved
+#ifndef HAL_STORAGE_BATCH_MAX_MS
+#define HAL_STORAGE_BATCH_MAX_MS 10000
+#endif
 #define STORAGE_NUM_LINES (HAL_STORAGE_SIZE/STORAGE_LINE_SIZE)
 
 class HALSITL::Storage : public AP_HAL::Storage {
@@ -33,6 +39,9 @@ public:
     void _timer_tick(void) override;
     bool healthy(void) override;
 
+    void begin_batch(void) override;
+    void end_batch(void) override;
+
 private:
     enum class StorageBackend: uint8_t {
         None,
@@ -51,6 +60,10 @@ private:
 
     uint32_t _last_empty_ms;
 
+    HAL_Semaphore _batch_sem;
+    uint32_t _batch_start_ms;
+    uint8_t _batch_depth;
+
 #if STORAGE_USE_FLASH
     bool _flash_write_data(uint8_t sector, uint32_t offset, const uint8_t *data, uint16_t length);
     bool _flash_read_data(uint8_t sector, uint32_t offset, uint8_t *data, uint16_t length);
@@ -36,6 +36,7 @@
 #include <sys/select.h>
 #include <termios.h>
 #include <sys/time.h>
+#include <sys/mman.h>
 
 #include "UARTDriver.h"
 #include "SITL_State.h"
@@ -84,6 +85,8 @@ void UARTDriver::begin(uint32_t baud, uint16_t rxSpace, uint16_t txSpace)
              udpclient:127.0.0.1:14550
              mcast:
              mcast:239.255.145.50:14550
+             shm:
+             shm:my_link
              uart:/dev/ttyUSB0:57600
              sim:ParticleSensor_SDS021:
              file:/tmp/my-device-capture.BIN
@@ -153,6 +156,17 @@ void UARTDriver::begin(uint32_t baud, uint16_t rxSpace, uint16_t txSpace)
                 ::printf("UDP multicast connection %s:%u\n", ip, port);
                 _udp_start_multicast(ip, port);
             }
+        } else if (strcmp(devtype, "shm") == 0) {
+            // shared memory rings, named after the instance and port
+            // by default
+            if (!_connected) {
+                char name[32];
+                if (args1 == nullptr || *args1 == 0) {
+                    snprintf(name, sizeof(name), "ap_uart_%u_%u", unsigned(_sitlState->get_instance()), unsigned(_portNumber));
+                    args1 = name;
+                }
+                _shm_start(args1);
+            }
         } else if (strcmp(devtype,"none") == 0) {
             // skipping port
             ::printf("Skipping port %s\n", args1);
@@ -233,6 +247,16 @@ ssize_t UARTDriver::read(uint8_t *buffer, uint16_t count)
     return _readbuffer.read(buffer, count);
 }
 
+uint8_t UARTDriver::rx_peek(ByteBuffer::IoVec vec[2])
+{
+    return _readbuffer.peekiovec(vec, _readbuffer.available());
+}
+
+bool UARTDriver::rx_consume(uint32_t len)
+{
+    return _readbuffer.advance(len);
+}
+
 bool UARTDriver::discard_input(void)
 {
     _readbuffer.clear();
@@ -315,6 +339,26 @@ size_t UARTDriver::write(const uint8_t *buffer, size_t size)
     return size;
 }
 
+uint8_t UARTDriver::tx_reserve(ByteBuffer::IoVec vec[2], uint32_t len)
+{
+    if (_unbuffered_writes || txspace() <= len) {
+        return 0;
+    }
+#if !defined(HAL_BUILD_AP_PERIPH)
+    // byte loss is simulated in write()
+    SITL::SIM *_sitl = AP::sitl();
+    if (_sitl && _sitl->uart_byte_loss_pct > 0) {
+        return 0;
+    }
+#endif
+    return _writebuffer.reserve(vec, len);
+}
+
+bool UARTDriver::tx_commit(uint32_t len)
+{
+    return _writebuffer.commit(len);
+}
+
     
 /*
   start a TCP connection for the serial port. If wait_for_connection
@@ -593,6 +637,40 @@ void UARTDriver::_udp_start_multicast(const char *address, uint16_t port)
     _udp_start_client(address, port);
 }
 
+/*
+  start a shared memory connection, see UART_SHM_Protocol.h. The port
+  counts as connected straight away, bytes queue in the ring until a
+  client attaches
+ */
+void UARTDriver::_shm_start(const char *name)
+{
+    char path[64];
+    snprintf(path, sizeof(path), "/%s", name);
+
+    // remove a segment left over from an earlier run
+    shm_unlink(path);
+    int fd = shm_open(path, O_RDWR|O_CREAT|O_EXCL, 0600);
+    if (fd == -1 || ftruncate(fd, sizeof(struct ap_uart_shm)) != 0) {
+        AP_HAL::panic("shm create %s failed: %s", path, strerror(errno));
+    }
+    void *p = mmap(nullptr, sizeof(struct ap_uart_shm), PROT_READ|PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (p == MAP_FAILED) {
+        AP_HAL::panic("shm mmap %s failed: %s", path, strerror(errno));
+    }
+
+    struct ap_uart_shm *shm = (struct ap_uart_shm *)p;
+    memset(shm, 0, sizeof(*shm));
+    shm->version = AP_UART_SHM_VERSION;
+    shm->ring_size = AP_UART_SHM_RING_SIZE;
+    shm->size = sizeof(*shm);
+    __atomic_store_n(&shm->magic, AP_UART_SHM_MAGIC, __ATOMIC_RELEASE);
+
+    ::printf("Serial port %u on shared memory %s\n", _portNumber, path);
+    _shm = shm;
+    _connected = true;
+}
+
 
 /*
   start a UART connection for the serial port
@@ -859,7 +937,9 @@ void UARTDriver::_timer_tick(void)
         const uint8_t *readptr = _writebuffer.readptr(navail);
         if (readptr && navail > 0) {
             navail = MIN(navail, max_bytes);
-            if (_sim_serial_device != nullptr) {
+            if (_shm != nullptr) {
+                nwritten = ap_uart_shm_write(&_shm->to_client, readptr, navail);
+            } else if (_sim_serial_device != nullptr) {
                 nwritten = _sim_serial_device->write_to_device((const char*)readptr, navail);
             } else if (!_use_send_recv) {
                 nwritten = ::write(_fd, readptr, navail);
@@ -908,6 +988,8 @@ void UARTDriver::_timer_tick(void)
                 nread = 0;
             }
         }
+    } else if (_shm != nullptr) {
+        nread = ap_uart_shm_read(&_shm->from_client, (uint8_t *)buf, space);
     } else if (_sim_serial_device != nullptr) {
         nread = _sim_serial_device->read_from_device(buf, space);
     } else if (logic_async_csv.active) {
@@ -12,6 +12,8 @@
 
 #include <SITL/SIM_SerialDevice.h>
 
+#include "UART_SHM_Protocol.h"
+
 class HALSITL::UARTDriver : public AP_HAL::UARTDriver {
 public:
     friend class HALSITL::SITL_State;
@@ -59,6 +61,14 @@ public:
     size_t write(uint8_t c) override;
     size_t write(const uint8_t *buffer, size_t size) override;
 
+    // reserve and commit transmit buffer space for direct writes
+    uint8_t tx_reserve(ByteBuffer::IoVec vec[2], uint32_t len) override;
+    bool tx_commit(uint32_t len) override;
+
+    // access received data in place
+    uint8_t rx_peek(ByteBuffer::IoVec vec[2]) override;
+    bool rx_consume(uint32_t len) override;
+
     bool _unbuffered_writes;
 
     enum flow_control get_flow_control(void) override { return FLOW_CONTROL_ENABLE; }
@@ -118,6 +128,7 @@ private:
     void _tcp_start_client(const char *address, uint16_t port);
     void _udp_start_client(const char *address, uint16_t port);
     void _udp_start_multicast(const char *address, uint16_t port);
+    void _shm_start(const char *name);
     void _check_connection(void);
     static bool _select_check(int );
     static void _set_nonblocking(int );
@@ -132,6 +143,9 @@ private:
 
     SITL::SerialDevice *_sim_serial_device;
 
+    // shared memory rings for a shm: port
+    struct ap_uart_shm *_shm;
+
     struct {
         bool active;
         uint8_t term[20];
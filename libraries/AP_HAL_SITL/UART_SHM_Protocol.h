@@ -0,0 +1,95 @@
+/*
+  shared memory serial port between SITL and a local client, an
+  alternative to the tcp: and udpclient: devices for links that must
+  keep up at high speedup. This header only depends on stdint.h so
+  that GCS tools and simulated devices can include it directly, see
+  Tools/scripts/sitl_shm_uart.py for a python client.
+
+  SITL creates the segment with shm_open("/<name>") for a port given
+  as shm:<name> and fills in the header, writing magic last. A client
+  maps the segment, checks magic, version and size, and then the two
+  sides exchange bytes through a single producer single consumer ring
+  in each direction:
+
+  - SITL writes to to_client and reads from from_client
+  - the client writes to from_client and reads from to_client
+
+  head and tail are free running byte counts, written only by the
+  producer and consumer of the ring respectively, so no locks are
+  needed. They are on separate cache lines to avoid false sharing
+  when both sides run at once. A producer stores the data before
+  publishing the new head with release ordering, and a consumer loads
+  head with acquire ordering before reading the data.
+
+  A full ring applies back pressure, as a socket does when its buffer
+  is full. Neither side waits for the other, the ports are polled from
+  the SITL timer thread at the same rate as the socket devices.
+ */
+#pragma once
+
+#include <stdint.h>
+
+#define AP_UART_SHM_MAGIC 0x54524155 // "UART"
+#define AP_UART_SHM_VERSION 1
+#define AP_UART_SHM_RING_SIZE 65536 // must be a power of two
+
+struct ap_uart_shm_ring {
+    volatile uint32_t head;         // bytes written, by the producer
+    uint32_t pad1[15];
+    volatile uint32_t tail;         // bytes read, by the consumer
+    uint32_t pad2[15];
+    uint8_t data[AP_UART_SHM_RING_SIZE];
+};
+
+struct ap_uart_shm {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t reserved;
+    uint32_t ring_size;
+    uint32_t size;                  // sizeof(struct ap_uart_shm)
+    uint32_t pad[12];
+    struct ap_uart_shm_ring to_client;
+    struct ap_uart_shm_ring from_client;
+};
+
+// write up to len bytes to a ring, returning the number written
+static inline uint32_t ap_uart_shm_write(struct ap_uart_shm_ring *r, const uint8_t *buf, uint32_t len)
+{
+    const uint32_t head = __atomic_load_n(&r->head, __ATOMIC_RELAXED);
+    const uint32_t tail = __atomic_load_n(&r->tail, __ATOMIC_ACQUIRE);
+    const uint32_t space = AP_UART_SHM_RING_SIZE - (head - tail);
+    if (len > space) {
+        len = space;
+    }
+    const uint32_t ofs = head & (AP_UART_SHM_RING_SIZE-1);
+    const uint32_t n1 = (len < AP_UART_SHM_RING_SIZE - ofs) ? len : AP_UART_SHM_RING_SIZE - ofs;
+    for (uint32_t i=0; i<n1; i++) {
+        r->data[ofs+i] = buf[i];
+    }
+    for (uint32_t i=n1; i<len; i++) {
+        r->data[i-n1] = buf[i];
+    }
+    __atomic_store_n(&r->head, head+len, __ATOMIC_RELEASE);
+    return len;
+}
+
+// read up to len bytes from a ring, returning the number read
+static inline uint32_t ap_uart_shm_read(struct ap_uart_shm_ring *r, uint8_t *buf, uint32_t len)
+{
+    const uint32_t tail = __atomic_load_n(&r->tail, __ATOMIC_RELAXED);
+    const uint32_t head = __atomic_load_n(&r->head, __ATOMIC_ACQUIRE);
+    const uint32_t avail = head - tail;
+    if (len > avail) {
+        len = avail;
+    }
+    const uint32_t ofs = tail & (AP_UART_SHM_RING_SIZE-1);
+    const uint32_t n1 = (len < AP_UART_SHM_RING_SIZE - ofs) ? len : AP_UART_SHM_RING_SIZE - ofs;
+    for (uint32_t i=0; i<n1; i++) {
+        buf[i] = r->data[ofs+i];
+    }
+    for (uint32_t i=n1; i<len; i++) {
+        buf[i] = r->data[i-n1];
+    }
+    __atomic_store_n(&r->tail, tail+len, __ATOMIC_RELEASE);
+    return len;
+}
@@ -1,4 +1,5 @@
 #include "Util.h"
+#include "Scheduler.h"
 #include <sys/time.h>
 #include <AP_Param/AP_Param.h>
 
@@ -184,3 +185,8 @@ bool HALSITL::Util::get_random_vals(uint8_t* data, size_t size)
     close(dev_random);
     return true;
 }
+
+void HALSITL::Util::log_stack_info(void)
+{
+    Scheduler::log_stack_info();
+}
@@ -86,6 +86,9 @@ public:
     // fills data with random values of requested size
     bool get_random_vals(uint8_t* data, size_t size) override;
 
+    // log info on stack usage and CPU load
+    void log_stack_info(void) override;
+
 private:
     SITL_State *sitlState;
 
@@ -43,6 +43,10 @@ enum ioevents {
 // an error
 #define IOMCU_MAX_REPEATED_FAILURES 20
 
+// minimum interval between servo outputs. An output that comes sooner
+// is held back until this has passed rather than dropped
+#define IOMCU_SERVO_OUT_MIN_US 1000
+
 AP_IOMCU::AP_IOMCU(AP_HAL::UARTDriver &_uart) :
     uart(_uart)
 {
@@ -232,6 +236,8 @@ void AP_IOMCU::thread_main(void)
 
         // check for regular timed events
         uint32_t now = AP_HAL::millis();
+        // RC input and status come back with each servo output
+        // cycle, so these are only read when outputs are not flowing
         if (now - last_rc_read_ms > 20) {
             // read RC input at 50Hz
             read_rc_input();
@@ -242,8 +248,8 @@ void AP_IOMCU::thread_main(void)
             // read status at 20Hz
             read_status();
             last_status_read_ms = AP_HAL::millis();
-            write_log();
         }
+        write_log();
 
         if (now - last_servo_read_ms > 50) {
             // read servo out at 20Hz
@@ -288,13 +294,115 @@ void AP_IOMCU::send_servo_out()
             n = MIN(n, IOMCU_MAX_CHANNELS);
         }
         uint32_t now = AP_HAL::micros();
-        if (now - last_servo_out_us >= 2000) {
-            // don't send data at more than 500Hz
-            if (write_registers(PAGE_DIRECT_PWM, 0, n, pwm_out.pwm)) {
-                last_servo_out_us = now;
-            }
+        const uint32_t since_us = now - last_servo_out_us;
+        if (since_us < IOMCU_SERVO_OUT_MIN_US) {
+            // hold the output back rather than dropping it, so
+            // jitter in the main loop doesn't lose outputs
+            hal.scheduler->delay_microseconds(IOMCU_SERVO_OUT_MIN_US - since_us);
+            now = AP_HAL::micros();
+        }
+        bool ok;
+        if (is_chibios_backend) {
+            ok = write_cycle(n, pwm_out.pwm);
+        } else {
+            ok = write_registers(PAGE_DIRECT_PWM, 0, n, pwm_out.pwm);
         }
+        if (ok) {
+            last_servo_out_us = now;
+            const uint32_t done_us = AP_HAL::micros();
+            const uint32_t latency_us = done_us - pwm_out.push_us;
+            cycle_stats.rtt_sum_us += done_us - now;
+            cycle_stats.latency_sum_us += latency_us;
+            cycle_stats.latency_max_us = MAX(cycle_stats.latency_max_us, latency_us);
+            cycle_stats.count++;
+        }
+    }
+}
+
+/*
+  write PWM outputs to PAGE_CYCLE. The reply carries the RC input and
+  status pages, which saves separate reads of those while outputs
+  are flowing
+ */
+bool AP_IOMCU::write_cycle(uint8_t count, const uint16_t *regs)
+{
+    IOPacket pkt;
+
+    discard_input();
+
+    pkt.code = CODE_WRITE;
+    pkt.count = count;
+    pkt.page = PAGE_CYCLE;
+    pkt.offset = 0;
+    pkt.crc = 0;
+    memcpy(pkt.regs, regs, 2*count);
+    pkt.crc = crc_crc8((const uint8_t *)&pkt, pkt.get_size());
+
+    const uint8_t pkt_size = pkt.get_size();
+    size_t ret = write_wait((uint8_t *)&pkt, pkt_size);
+
+    if (ret != pkt_size) {
+        debug("write failed3 %u %u\n", pkt_size, ret);
+        protocol_fail_count++;
+        return false;
+    }
+
+    // wait for the expected number of reply bytes or timeout
+    const uint8_t reply_size = offsetof(struct IOPacket, regs) + sizeof(struct page_cycle);
+    if (!uart.wait_timeout(reply_size, 10)) {
+        debug("t=%u timeout cycle count=%u\n", AP_HAL::millis(), count);
+        protocol_fail_count++;
+        return false;
+    }
+
+    uint8_t *b = (uint8_t *)&pkt;
+    uint8_t n = uart.available();
+    if (n != reply_size) {
+        debug("t=%u bad cycle len %u\n", AP_HAL::millis(), n);
+        protocol_fail_count++;
+        return false;
     }
+    for (uint8_t i=0; i<n; i++) {
+        b[i] = uart.read();
+    }
+
+    uint8_t got_crc = pkt.crc;
+    pkt.crc = 0;
+    uint8_t expected_crc = crc_crc8((const uint8_t *)&pkt, pkt.get_size());
+    if (got_crc != expected_crc) {
+        debug("t=%u bad cycle crc %02x should be %02x\n",
+              AP_HAL::millis(), got_crc, expected_crc);
+        protocol_fail_count++;
+        return false;
+    }
+
+    if (pkt.code != CODE_SUCCESS || pkt.page != PAGE_CYCLE ||
+        pkt.get_size() != reply_size) {
+        debug("bad cycle reply %02x %u %u\n", pkt.code, pkt.page, pkt.count);
+        protocol_fail_count++;
+        return false;
+    }
+
+    const uint8_t *reply = (const uint8_t *)pkt.regs;
+    memcpy(&rc_input, &reply[offsetof(struct page_cycle, rc_input)], sizeof(rc_input));
+    memcpy(&reg_status, &reply[offsetof(struct page_cycle, status)], sizeof(reg_status));
+
+    if (protocol_fail_count > IOMCU_MAX_REPEATED_FAILURES) {
+        handle_repeated_failures();
+    }
+    total_errors += protocol_fail_count;
+    protocol_fail_count = 0;
+    protocol_count++;
+
+    const uint32_t now_ms = AP_HAL::millis();
+    handle_rc_input();
+    last_rc_read_ms = now_ms;
+    if (now_ms - last_status_read_ms > 50) {
+        // status changes are acted on at 20Hz, as with a status read
+        handle_status();
+        last_status_read_ms = now_ms;
+    }
+    return true;
 }
 
 /*
@@ -306,6 +414,14 @@ void AP_IOMCU::read_rc_input()
     if (!read_registers(PAGE_RAW_RCIN, 0, sizeof(rc_input)/2, r)) {
         return;
     }
+    handle_rc_input();
+}
+
+/*
+  handle a new rc_input page
+ */
+void AP_IOMCU::handle_rc_input()
+{
     if (rc_input.flags_failsafe && rc().ignore_rc_failsafe()) {
         rc_input.flags_failsafe = false;
     }
@@ -324,6 +440,14 @@ void AP_IOMCU::read_status()
         read_status_errors++;
         return;
     }
+    handle_status();
+}
+
+/*
+  handle a new status page
+ */
+void AP_IOMCU::handle_status()
+{
     if (read_status_ok == 0) {
         // reset error count on first good read
         read_status_errors = 0;
@@ -369,7 +493,12 @@ void AP_IOMCU::write_log()
 // @Field: Nerr: Protocol failures on MCU side
 // @Field: Nerr2: Reported number of failures on IOMCU side
 // @Field: NDel: Number of delayed packets received by MCU
-            AP::logger().WriteStreaming("IOMC", "TimeUS,RSErr,Mem,TS,NPkt,Nerr,Nerr2,NDel", "QHHIIIII",
+// @Field: NOut: Number of servo output cycles sent in the last second
+// @Field: RTT: Mean time for a servo output transaction, in microseconds
+// @Field: Lat: Mean servo output latency from the main loop pushing outputs to the IOMCU acknowledging them, in microseconds
+// @Field: LatM: Maximum servo output latency, in microseconds
+            const uint16_t n = MAX(cycle_stats.count, 1U);
+            AP::logger().WriteStreaming("IOMC", "TimeUS,RSErr,Mem,TS,NPkt,Nerr,Nerr2,NDel,NOut,RTT,Lat,LatM", "QHHIIIIIHHHH",
                                AP_HAL::micros64(),
                                read_status_errors,
                                reg_status.freemem,
@@ -377,8 +506,13 @@ void AP_IOMCU::write_log()
                                reg_status.total_pkts,
                                total_errors,
                                reg_status.num_errors,
-                               num_delayed);
+                               num_delayed,
+                               cycle_stats.count,
+                               uint16_t(MIN(cycle_stats.rtt_sum_us / n, 0xFFFFU)),
+                               uint16_t(MIN(cycle_stats.latency_sum_us / n, 0xFFFFU)),
+                               uint16_t(MIN(cycle_stats.latency_max_us, 0xFFFFU)));
         }
+        memset(&cycle_stats, 0, sizeof(cycle_stats));
 #if IOMCU_DEBUG_ENABLE
         static uint32_t last_io_print;
         if (now - last_io_print >= 5000) {
@@ -691,6 +825,7 @@ void AP_IOMCU::cork(void)
 // push output
 void AP_IOMCU::push(void)
 {
+    pwm_out.push_us = AP_HAL::micros();
     trigger_event(IOEVENT_SEND_PWM_OUT);
     corked = false;
 }
@@ -172,9 +172,12 @@ private:
     bool last_safety_off;
 
     void send_servo_out(void);
+    bool write_cycle(uint8_t count, const uint16_t *regs);
     void read_rc_input(void);
+    void handle_rc_input(void);
     void read_servo(void);
     void read_status(void);
+    void handle_status(void);
     void discard_input(void);
     void event_failed(uint32_t event_mask);
     void update_safety_options(void);
@@ -202,8 +205,17 @@ private:
         uint16_t failsafe_pwm[IOMCU_MAX_CHANNELS];
         uint8_t failsafe_pwm_set;
         uint8_t failsafe_pwm_sent;
+        uint32_t push_us;
     } pwm_out;
 
+    // servo output timing since the last log message
+    struct {
+        uint32_t rtt_sum_us;
+        uint32_t latency_sum_us;
+        uint32_t latency_max_us;
+        uint16_t count;
+    } cycle_stats;
+
     // read back pwm values
     struct {
         uint16_t pwm[IOMCU_MAX_CHANNELS];
@@ -576,30 +576,18 @@ bool AP_IOMCU_FW::handle_code_write()
         }
         break;
 
-    case PAGE_DIRECT_PWM: {
-        if (override_active) {
-            // no input when override is active
-            break;
-        }
-        /* copy channel data */
-        uint16_t i = 0, offset = rx_io_packet.offset, num_values = rx_io_packet.count;
-        if (offset + num_values > sizeof(reg_direct_pwm.pwm)/2) {
+    case PAGE_DIRECT_PWM:
+        if (!handle_direct_pwm()) {
             return false;
         }
-        while ((offset < IOMCU_MAX_CHANNELS) && (num_values > 0)) {
-            /* XXX range-check value? */
-            if (rx_io_packet.regs[i] != PWM_IGNORE_THIS_CHANNEL) {
-                reg_direct_pwm.pwm[offset] = rx_io_packet.regs[i];
-            }
+        break;
 
-            offset++;
-            num_values--;
-            i++;
+    case PAGE_CYCLE:
+        if (!handle_direct_pwm()) {
+            return false;
         }
-        fmu_data_received_time = last_ms;
-        chEvtSignalI(thread_ctx, EVENT_MASK(IOEVENT_PWM));
-        break;
-    }
+        fill_cycle_reply();
+        return true;
 
     case PAGE_MIXING: {
         uint16_t offset = rx_io_packet.offset, num_values = rx_io_packet.count;
@@ -649,6 +637,52 @@ bool AP_IOMCU_FW::handle_code_write()
     return true;
 }
 
+/*
+  take PWM values written to PAGE_DIRECT_PWM or PAGE_CYCLE
+ */
+bool AP_IOMCU_FW::handle_direct_pwm(void)
+{
+    if (override_active) {
+        // no input when override is active
+        return true;
+    }
+    /* copy channel data */
+    uint16_t i = 0, offset = rx_io_packet.offset, num_values = rx_io_packet.count;
+    if (offset + num_values > sizeof(reg_direct_pwm.pwm)/2) {
+        return false;
+    }
+    while ((offset < IOMCU_MAX_CHANNELS) && (num_values > 0)) {
+        /* XXX range-check value? */
+        if (rx_io_packet.regs[i] != PWM_IGNORE_THIS_CHANNEL) {
+            reg_direct_pwm.pwm[offset] = rx_io_packet.regs[i];
+        }
+
+        offset++;
+        num_values--;
+        i++;
+    }
+    fmu_data_received_time = last_ms;
+    chEvtSignalI(thread_ctx, EVENT_MASK(IOEVENT_PWM));
+    return true;
+}
+
+/*
+  reply to a PAGE_CYCLE write with the rc_input and status pages, so
+  the FMU gets both in the same transaction as its PWM output
+ */
+void AP_IOMCU_FW::fill_cycle_reply(void)
+{
+    uint8_t *regs = (uint8_t *)tx_io_packet.regs;
+    memcpy(&regs[offsetof(struct page_cycle, rc_input)], &rc_input, sizeof(rc_input));
+    memcpy(&regs[offsetof(struct page_cycle, status)], &reg_status, sizeof(reg_status));
+    tx_io_packet.count = sizeof(struct page_cycle) / sizeof(uint16_t);
+    tx_io_packet.code = CODE_SUCCESS;
+    tx_io_packet.page = PAGE_CYCLE;
+    tx_io_packet.offset = 0;
+    tx_io_packet.crc = 0;
+    tx_io_packet.crc =  crc_crc8((const uint8_t *)&tx_io_packet, tx_io_packet.get_size());
+}
+
 void AP_IOMCU_FW::schedule_reboot(uint32_t time_ms)
 {
     do_reboot = true;
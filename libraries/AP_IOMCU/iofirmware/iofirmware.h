@@ -28,6 +28,8 @@ public:
 
     bool handle_code_write();
     bool handle_code_read();
+    bool handle_direct_pwm();
+    void fill_cycle_reply();
     void schedule_reboot(uint32_t time_ms);
     void safety_update();
     void rcout_mode_update();
@@ -8,6 +8,10 @@
 
 // 22 is enough for the rc_input page in one transfer
 #define PKT_MAX_REGS 22
+
+// the reply to a PAGE_CYCLE write is larger, as it carries both the
+// rc_input and status pages
+#define PKT_MAX_CYCLE_REGS 34
 #define IOMCU_MAX_CHANNELS 16
 
 //#define IOMCU_DEBUG
@@ -18,7 +22,7 @@ struct PACKED IOPacket {
     uint8_t 	crc;
     uint8_t 	page;
     uint8_t 	offset;
-    uint16_t	regs[PKT_MAX_REGS];
+    uint16_t	regs[PKT_MAX_CYCLE_REGS];
 
     // get packet size in bytes
     uint8_t get_size(void) const
@@ -51,6 +55,7 @@ enum iopage {
     PAGE_RCIN = 5,
     PAGE_RAW_ADC = 6,
     PAGE_PWM_INFO = 7,
+    PAGE_CYCLE = 8,
     PAGE_SETUP = 50,
     PAGE_DIRECT_PWM = 54,
     PAGE_FAILSAFE_PWM = 55,
@@ -89,7 +94,7 @@ enum iopage {
 #define PAGE_CONFIG_PROTOCOL_VERSION  0
 #define PAGE_CONFIG_PROTOCOL_VERSION2 1
 #define IOMCU_PROTOCOL_VERSION       4
-#define IOMCU_PROTOCOL_VERSION2     10
+#define IOMCU_PROTOCOL_VERSION2     11
 
 // magic value for rebooting to bootloader
 #define REBOOT_BL_MAGIC 14662
@@ -127,6 +132,19 @@ struct page_rc_input {
     int16_t rssi;
 };
 
+/*
+  reply to a write of PWM values to PAGE_CYCLE, which replaces
+  separate writes of PAGE_DIRECT_PWM and reads of the rc_input and
+  status pages with one transaction per output cycle
+ */
+struct page_cycle {
+    struct page_rc_input rc_input;
+    struct page_reg_status status;
+};
+
+static_assert(sizeof(struct page_cycle) <= PKT_MAX_CYCLE_REGS*2, "page_cycle must fit in one packet");
+static_assert(sizeof(struct page_cycle) % 2 == 0, "page_cycle must be even size");
+
 /*
   data for mixing on FMU failsafe
  */
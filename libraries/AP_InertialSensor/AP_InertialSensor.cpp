@@ -1382,6 +1382,125 @@ bool AP_InertialSensor::get_accel_health_all(void) const
     return (get_accel_count() > 0);
 }
 
+#if AP_INERTIALSENSOR_TIME_ALIGN_ENABLED
+/*
+  linearly interpolate between the last two samples, holding the
+  nearest sample outside them
+ */
+Vector3f AP_InertialSensor::TimeAlignSample::interpolate(uint64_t sample_us) const
+{
+    if (sample_us >= last_us || last_us <= prev_us) {
+        return last;
+    }
+    if (sample_us <= prev_us) {
+        return prev;
+    }
+    const float f = float(sample_us - prev_us) / float(last_us - prev_us);
+    return prev + (last - prev) * f;
+}
+
+/*
+  resample the healthy IMUs onto a common timeline. The common time is
+  the oldest of their latest samples, so every sensor is interpolated
+  rather than extrapolated
+ */
+void AP_InertialSensor::update_time_alignment(void)
+{
+    uint64_t sample_us = UINT64_MAX;
+    for (uint8_t i=0; i<INS_MAX_INSTANCES; i++) {
+        // sensors which have not produced a timed sample are ignored
+        const uint64_t gyro_us = _gyro_align_pub[i].last_us;
+        if (use_gyro(i) && gyro_us != 0 && gyro_us < sample_us) {
+            sample_us = gyro_us;
+        }
+        const uint64_t accel_us = _accel_align_pub[i].last_us;
+        if (get_accel_health(i) && _use[i] && accel_us != 0 && accel_us < sample_us) {
+            sample_us = accel_us;
+        }
+    }
+    if (sample_us == UINT64_MAX) {
+        return;
+    }
+    _aligned_sample_us = sample_us;
+    for (uint8_t i=0; i<INS_MAX_INSTANCES; i++) {
+        _gyro_aligned[i] = _gyro_align_pub[i].interpolate(sample_us);
+        _accel_aligned[i] = _accel_align_pub[i].interpolate(sample_us);
+    }
+}
+
+bool AP_InertialSensor::get_gyro_aligned_average(Vector3f &gyro) const
+{
+    Vector3f sum;
+    uint8_t n = 0;
+    for (uint8_t i=0; i<INS_MAX_INSTANCES; i++) {
+        if (use_gyro(i)) {
+            sum += _gyro_aligned[i];
+            n++;
+        }
+    }
+    if (n == 0) {
+        return false;
+    }
+    gyro = sum / n;
+    return true;
+}
+
+bool AP_InertialSensor::get_accel_aligned_average(Vector3f &accel) const
+{
+    Vector3f sum;
+    uint8_t n = 0;
+    for (uint8_t i=0; i<INS_MAX_INSTANCES; i++) {
+        if (get_accel_health(i) && _use[i]) {
+            sum += _accel_aligned[i];
+            n++;
+        }
+    }
+    if (n == 0) {
+        return false;
+    }
+    accel = sum / n;
+    return true;
+}
+#endif // AP_INERTIALSENSOR_TIME_ALIGN_ENABLED
+
+#if AP_INERTIALSENSOR_RATE_LOOP_ENABLED
+void AP_InertialSensor::enable_rate_loop(void)
+{
+    if (_rate_loop == nullptr) {
+        _rate_loop = new RateLoop;
+    }
+}
+
+void AP_InertialSensor::push_rate_loop_gyro(uint8_t instance, const Vector3f &gyro, float dt, uint64_t sample_us)
+{
+    if (_rate_loop == nullptr || instance != _primary_gyro) {
+        return;
+    }
+    {
+        WITH_SEMAPHORE(_rate_loop->sem);
+        _rate_loop->gyro = gyro;
+        _rate_loop->dt += dt;
+        _rate_loop->sample_us = sample_us;
+    }
+    _rate_loop->new_sample.signal();
+}
+
+bool AP_InertialSensor::get_next_gyro_sample(Vector3f &gyro, float &dt, uint64_t &sample_us, uint32_t timeout_us)
+{
+    if (_rate_loop == nullptr || !_rate_loop->new_sample.wait(timeout_us)) {
+        return false;
+    }
+    WITH_SEMAPHORE(_rate_loop->sem);
+    if (!is_positive(_rate_loop->dt)) {
+        return false;
+    }
+    gyro = _rate_loop->gyro;
+    dt = _rate_loop->dt;
+    sample_us = _rate_loop->sample_us;
+    _rate_loop->dt = 0;
+    return true;
+}
+#endif // AP_INERTIALSENSOR_RATE_LOOP_ENABLED
 
 /*
   calculate the trim_roll and trim_pitch. This is used for redoing the
@@ -1662,7 +1781,9 @@ void AP_InertialSensor::_save_gyro_calibration()
  */
 void AP_InertialSensor::HarmonicNotch::update_params(uint8_t instance, bool converging, float gyro_rate)
 {
-    const float center_freq = calculated_notch_freq_hz[0];
+    const bool scaled = is_positive(freq_scale[instance]) && !is_equal(freq_scale[instance], 1.0f) &&
+        params.tracking_mode() != HarmonicNotchDynamicMode::Fixed;
+    const float center_freq = scaled ? calculated_notch_freq_hz[0] * freq_scale[instance] : calculated_notch_freq_hz[0];
     if (!is_equal(last_bandwidth_hz[instance], params.bandwidth_hz()) ||
         !is_equal(last_attenuation_dB[instance], params.attenuation_dB()) ||
         (params.tracking_mode() == HarmonicNotchDynamicMode::Fixed && !is_equal(last_center_freq_hz[instance], center_freq)) ||
@@ -1675,7 +1796,13 @@ void AP_InertialSensor::HarmonicNotch::update_params(uint8_t instance, bool conv
         last_bandwidth_hz[instance] = params.bandwidth_hz();
         last_attenuation_dB[instance] = params.attenuation_dB();
     } else if (params.tracking_mode() != HarmonicNotchDynamicMode::Fixed) {
-        if (num_calculated_notch_frequencies > 1) {
+        if (num_calculated_notch_frequencies > 1 && scaled) {
+            float freqs[INS_MAX_NOTCHES];
+            for (uint8_t i = 0; i < num_calculated_notch_frequencies; i++) {
+                freqs[i] = calculated_notch_freq_hz[i] * freq_scale[instance];
+            }
+            filter[instance].update(num_calculated_notch_frequencies, freqs);
+        } else if (num_calculated_notch_frequencies > 1) {
             filter[instance].update(num_calculated_notch_frequencies, calculated_notch_freq_hz);
         } else {
             filter[instance].update(center_freq);
@@ -1766,6 +1893,10 @@ void AP_InertialSensor::update(void)
             }
         }
 
+#if AP_INERTIALSENSOR_TIME_ALIGN_ENABLED
+    update_time_alignment();
+#endif
+
     _last_update_usec = AP_HAL::micros();
     
     _have_sample = false;
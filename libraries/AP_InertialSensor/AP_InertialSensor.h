@@ -178,6 +178,30 @@ public:
     bool get_accel_health(uint8_t instance) const { return (instance<_accel_count) ? _accel_healthy[instance] : false; }
     bool get_accel_health(void) const { return get_accel_health(_primary_accel); }
     bool get_accel_health_all(void) const;
+
+#if AP_INERTIALSENSOR_TIME_ALIGN_ENABLED
+    // filtered gyro and accel of each IMU interpolated to a common
+    // sample time, so that IMUs running at different rates and phases
+    // can be compared or averaged directly
+    const Vector3f &get_gyro_aligned(uint8_t i) const { return _gyro_aligned[i]; }
+    const Vector3f &get_accel_aligned(uint8_t i) const { return _accel_aligned[i]; }
+    uint64_t get_aligned_sample_us(void) const { return _aligned_sample_us; }
+
+    // average of the aligned values of the healthy IMUs in use,
+    // returns false if there are none
+    bool get_gyro_aligned_average(Vector3f &gyro) const;
+    bool get_accel_aligned_average(Vector3f &accel) const;
+#endif
+#if AP_INERTIALSENSOR_RATE_LOOP_ENABLED
+    // pass each filtered sample of the primary gyro on to a rate loop
+    // thread as it arrives, rather than once per main loop
+    void enable_rate_loop(void);
+
+    // wait up to timeout_us for new primary gyro samples, giving the
+    // newest one, the time covered since the last call and the time in
+    // microseconds the newest sample was taken
+    bool get_next_gyro_sample(Vector3f &gyro, float &dt, uint64_t &sample_us, uint32_t timeout_us);
+#endif
     uint8_t get_accel_count(void) const { return MIN(INS_MAX_INSTANCES, _accel_count); }
     bool accel_calibrated_ok_all() const;
     bool use_accel(uint8_t instance) const;
@@ -370,6 +394,12 @@ public:
         AP_Int16 samples_per_msg;
         AP_Int8 push_interval_ms;
 
+#if HAL_GCS_ENABLED
+        // live streaming over MAVLink instead of logging
+        AP_Int8 stream_chan;
+        AP_Int16 stream_bandwidth;
+#endif
+
         // end Parameters
 
     private:
@@ -382,6 +412,20 @@ public:
 
         void rotate_to_next_sensor();
         void update_doing_sensor_rate_logging();
+        void finish_batch();
+        float sample_rate_hz() const;
+        uint8_t output_instance() const;
+
+#if HAL_GCS_ENABLED
+        // DATA96 message types used for streaming
+        enum {
+            MAV_DATA96_ISB_HEADER = 44,
+            MAV_DATA96_ISB_DATA = 45,
+        };
+        bool streaming() const { return stream_chan > 0; }
+        void push_data_to_mavlink();
+        uint32_t stream_budget;
+#endif
 
         bool should_log(uint8_t instance, IMU_SENSOR_TYPE type) __RAMFUNC__;
         void push_data_to_log();
@@ -460,6 +504,12 @@ public:
         void update_freq_hz(float scaled_freq);
         void update_frequencies_hz(uint8_t num_freqs, const float scaled_freq[]);
 
+        // scale the notch frequencies on one IMU, for IMUs whose noise
+        // frequency differs from the primary's
+        void set_frequency_scale(uint8_t instance, float scale) {
+            freq_scale[instance] = scale;
+        }
+
         // enable/disable the notch
         void set_inactive(bool _inactive) {
             inactive = _inactive;
@@ -474,6 +524,8 @@ public:
         float last_center_freq_hz[INS_MAX_INSTANCES];
         float last_bandwidth_hz[INS_MAX_INSTANCES];
         float last_attenuation_dB[INS_MAX_INSTANCES];
+        // zero is the same as 1, no scaling
+        float freq_scale[INS_MAX_INSTANCES];
         bool inactive;
     } harmonic_notches[HAL_INS_NUM_HARMONIC_NOTCH_FILTERS];
 
@@ -528,6 +580,44 @@ private:
     LowPassFilter2pVector3f _gyro_filter[INS_MAX_INSTANCES];
     Vector3f _accel_filtered[INS_MAX_INSTANCES];
     Vector3f _gyro_filtered[INS_MAX_INSTANCES];
+#if AP_INERTIALSENSOR_TIME_ALIGN_ENABLED
+    // the last two filtered samples of a sensor and their times
+    struct TimeAlignSample {
+        Vector3f prev;
+        Vector3f last;
+        uint64_t prev_us;
+        uint64_t last_us;
+
+        void push(const Vector3f &v, uint64_t sample_us) {
+            prev = last;
+            prev_us = last_us;
+            last = v;
+            last_us = sample_us;
+        }
+        Vector3f interpolate(uint64_t sample_us) const;
+    };
+    // updated by the backends on each sample, under the backend semaphore
+    TimeAlignSample _gyro_align_sample[INS_MAX_INSTANCES];
+    TimeAlignSample _accel_align_sample[INS_MAX_INSTANCES];
+    // copies taken when the backends publish
+    TimeAlignSample _gyro_align_pub[INS_MAX_INSTANCES];
+    TimeAlignSample _accel_align_pub[INS_MAX_INSTANCES];
+    Vector3f _gyro_aligned[INS_MAX_INSTANCES];
+    Vector3f _accel_aligned[INS_MAX_INSTANCES];
+    uint64_t _aligned_sample_us;
+    void update_time_alignment(void);
+#endif
+#if AP_INERTIALSENSOR_RATE_LOOP_ENABLED
+    struct RateLoop {
+        HAL_Semaphore sem;
+        HAL_BinarySemaphore new_sample;
+        Vector3f gyro;
+        float dt;
+        uint64_t sample_us;
+    } *_rate_loop;
+    // called by the backends with each filtered gyro sample
+    void push_rate_loop_gyro(uint8_t instance, const Vector3f &gyro, float dt, uint64_t sample_us);
+#endif
 #if HAL_WITH_DSP
     // Thread-safe public version of _last_raw_gyro
     Vector3f _gyro_for_fft[INS_MAX_INSTANCES];
@@ -330,6 +330,8 @@ void AP_InertialSensor_BMI088::read_fifo_accel(void)
 
     // use new accel_range depending on sensor type
     const float scale = (1.0/32768.0) * GRAVITY_MSS * accel_range;
+    Vector3f accel[8];
+    uint8_t num_accel = 0;
     const uint8_t *p = &data[0];
     while (fifo_length >= 7) {
         /*
@@ -345,12 +347,9 @@ void AP_InertialSensor_BMI088::read_fifo_accel(void)
                 int16_t(uint16_t(d[0] | (d[1]<<8))),
                 int16_t(uint16_t(d[2] | (d[3]<<8))),
                 int16_t(uint16_t(d[4] | (d[5]<<8)))};
-            Vector3f accel(xyz[0], xyz[1], xyz[2]);
-
-            accel *= scale;
-
-            _rotate_and_correct_accel(accel_instance, accel);
-            _notify_new_accel_raw_sample(accel_instance, accel);
+            if (num_accel < ARRAY_SIZE(accel)) {
+                accel[num_accel++] = Vector3f(xyz[0], xyz[1], xyz[2]);
+            }
             break;
         }
         case 0x40:
@@ -374,6 +373,9 @@ void AP_InertialSensor_BMI088::read_fifo_accel(void)
         fifo_length -= frame_len;
     }
 
+    // rotate, correct and filter the whole block at once
+    _notify_new_accel_raw_samples(accel_instance, accel, num_accel, scale);
+
     if (temperature_counter++ == 100) {
         temperature_counter = 0;
         uint8_t tbuf[2];
@@ -426,12 +428,12 @@ void AP_InertialSensor_BMI088::read_fifo_gyro(void)
     }
 
     // data is 16 bits with 2000dps range
-    for (uint8_t i = 0; i < num_frames; i++) {
-        Vector3f gyro(data[i].x, data[i].y, data[i].z);
-        gyro *= scale;
-
-        _rotate_and_correct_gyro(gyro_instance, gyro);
-        _notify_new_gyro_raw_sample(gyro_instance, gyro);
+    {
+        Vector3f gyro[max_frames];
+        for (uint8_t i = 0; i < num_frames; i++) {
+            gyro[i] = Vector3f(data[i].x, data[i].y, data[i].z);
+        }
+        _notify_new_gyro_raw_samples(gyro_instance, gyro, num_frames, scale);
     }
 
 check_next:
@@ -56,14 +56,14 @@ void AP_InertialSensor_Backend::_set_gyro_oversampling(uint8_t instance, uint8_t
   sensor may vary slightly from the system clock. This slowly adjusts
   the rate to the observed rate
 */
-void AP_InertialSensor_Backend::_update_sensor_rate(uint16_t &count, uint32_t &start_us, float &rate_hz) const
+void AP_InertialSensor_Backend::_update_sensor_rate(uint16_t &count, uint32_t &start_us, float &rate_hz, uint8_t n) const
 {
     uint32_t now = AP_HAL::micros();
     if (start_us == 0) {
-        count = 0;
+        count = n - 1;
         start_us = now;
     } else {
-        count++;
+        count += n;
         if (now - start_us > 1000000UL) {
             float observed_rate_hz = count * 1.0e6f / (now - start_us);
 #if 0
@@ -334,6 +334,12 @@ void AP_InertialSensor_Backend::_notify_new_gyro_raw_sample(uint8_t instance,
 
         // apply gyro filters and sample for FFT
         apply_gyro_filters(instance, gyro);
+#if AP_INERTIALSENSOR_TIME_ALIGN_ENABLED
+        _imu._gyro_align_sample[instance].push(_imu._gyro_filtered[instance], sample_us);
+#endif
+#if AP_INERTIALSENSOR_RATE_LOOP_ENABLED
+        _imu.push_rate_loop_gyro(instance, _imu._gyro_filtered[instance], dt, sample_us);
+#endif
 
         _imu._new_gyro_data[instance] = true;
     }
@@ -352,6 +358,133 @@ void AP_InertialSensor_Backend::_notify_new_gyro_raw_sample(uint8_t instance,
 #endif
 }
 
+/*
+  handle a block of gyro samples read from a FIFO. The samples are
+  raw sensor frame values which are scaled, rotated and corrected in
+  place, so the array is used as scratch space. This is equivalent to
+  calling _rotate_and_correct_gyro() and _notify_new_gyro_raw_sample()
+  for each sample, but the rotations, offsets and temperature
+  correction are folded into one matrix and bias per block and the
+  frontend semaphore is taken once
+ */
+void AP_InertialSensor_Backend::_notify_new_gyro_raw_samples(uint8_t instance, Vector3f *gyro, uint8_t n, float scale)
+{
+    if (n == 0 || ((1U<<instance) & _imu.imu_kill_mask)) {
+        return;
+    }
+
+#if HAL_INS_TEMPERATURE_CAL_ENABLE
+    if (_imu.tcal_learning) {
+        // learning needs each sample in sensor frame
+        for (uint8_t i = 0; i < n; i++) {
+            gyro[i] *= scale;
+            _rotate_and_correct_gyro(instance, gyro[i]);
+            _notify_new_gyro_raw_sample(instance, gyro[i]);
+        }
+        return;
+    }
+#endif
+
+    // gyro = board_rot * (sensor_rot * raw * scale + correction)
+    Matrix3f sensor_rot, rot;
+    sensor_rot.from_rotation(_imu._gyro_orientation[instance]);
+    rot.from_rotation(_imu._board_orientation);
+    Vector3f bias;
+    if (!_imu._calibrating_gyro) {
+#if HAL_INS_TEMPERATURE_CAL_ENABLE
+        // the temperature correction is additive so applying it to zero gives the offset
+        _imu.tcal[instance].correct_gyro(_imu.get_temperature(instance), _imu.caltemp_gyro[instance], bias);
+#endif
+        bias -= _imu._gyro_offset[instance];
+        bias = rot * bias;
+    }
+    rot = rot * sensor_rot * scale;
+    for (uint8_t i = 0; i < n; i++) {
+        gyro[i] = rot * gyro[i] + bias;
+    }
+
+    _update_sensor_rate(_imu._sample_gyro_count[instance], _imu._sample_gyro_start_us[instance],
+                        _imu._gyro_raw_sample_rates[instance], n);
+
+    // don't accept below 40Hz
+    if (_imu._gyro_raw_sample_rates[instance] < 40) {
+        return;
+    }
+
+    // FIFO samples are spaced at the sensor rate, ending now
+    const float dt = 1.0f / _imu._gyro_raw_sample_rates[instance];
+    const uint64_t last_sample_us = _imu._gyro_last_sample_us[instance];
+    const uint64_t now = AP_HAL::micros64();
+    _imu._gyro_last_sample_us[instance] = now;
+    const uint32_t dt_us = dt * 1.0e6f;
+
+#if AP_MODULE_SUPPORTED
+    for (uint8_t i = 0; i < n; i++) {
+        AP_Module::call_hook_gyro_sample(instance, dt, gyro[i]);
+    }
+#endif
+
+    if (hal.opticalflow) {
+        for (uint8_t i = 0; i < n; i++) {
+            hal.opticalflow->push_gyro(gyro[i].x, gyro[i].y, dt);
+        }
+    }
+
+#if AP_INERTIALSENSOR_BATCHSAMPLER_ENABLED
+    const bool post_filter_logging = _imu.batchsampler.doing_post_filter_logging();
+#else
+    const bool post_filter_logging = false;
+#endif
+
+    {
+        WITH_SEMAPHORE(_sem);
+
+        float sample_dt = dt;
+        if (now - last_sample_us > 100000U) {
+            // zero accumulator if sensor was unhealthy for 0.1s
+            _imu._delta_angle_acc[instance].zero();
+            _imu._delta_angle_acc_dt[instance] = 0;
+            sample_dt = 0;
+        }
+
+        for (uint8_t i = 0; i < n; i++) {
+            // delta angle and coning correction as in _notify_new_gyro_raw_sample()
+            const Vector3f delta_angle = (gyro[i] + _imu._last_raw_gyro[instance]) * 0.5f * sample_dt;
+            Vector3f delta_coning = (_imu._delta_angle_acc[instance] +
+                                     _imu._last_delta_angle[instance] * (1.0f / 6.0f));
+            delta_coning = delta_coning % delta_angle;
+            delta_coning *= 0.5f;
+
+            _imu._delta_angle_acc[instance] += delta_angle + delta_coning;
+            _imu._delta_angle_acc_dt[instance] += sample_dt;
+            sample_dt = dt;
+
+            _imu._last_delta_angle[instance] = delta_angle;
+            _imu._last_raw_gyro[instance] = gyro[i];
+
+            // apply gyro filters and sample for FFT
+            apply_gyro_filters(instance, gyro[i]);
+#if AP_INERTIALSENSOR_TIME_ALIGN_ENABLED
+            _imu._gyro_align_sample[instance].push(_imu._gyro_filtered[instance], now - uint32_t(n - 1 - i) * dt_us);
+#endif
+
+            if (post_filter_logging) {
+                gyro[i] = _imu._gyro_filtered[instance];
+            }
+        }
+#if AP_INERTIALSENSOR_RATE_LOOP_ENABLED
+        // the rate loop only needs the newest of the batch
+        _imu.push_rate_loop_gyro(instance, _imu._gyro_filtered[instance], n * dt, now);
+#endif
+
+        _imu._new_gyro_data[instance] = true;
+    }
+
+    for (uint8_t i = 0; i < n; i++) {
+        log_gyro_raw(instance, now - uint32_t(n - 1 - i) * dt_us, gyro[i]);
+    }
+}
+
 /*
   handle a delta-angle sample from the backend. This assumes FIFO
   style sampling and the sample should not be rotated or corrected for
@@ -432,6 +565,12 @@ void AP_InertialSensor_Backend::_notify_new_delta_angle(uint8_t instance, const
 
         // apply gyro filters and sample for FFT
         apply_gyro_filters(instance, gyro);
+#if AP_INERTIALSENSOR_TIME_ALIGN_ENABLED
+        _imu._gyro_align_sample[instance].push(_imu._gyro_filtered[instance], sample_us);
+#endif
+#if AP_INERTIALSENSOR_RATE_LOOP_ENABLED
+        _imu.push_rate_loop_gyro(instance, _imu._gyro_filtered[instance], dt, sample_us);
+#endif
 
         _imu._new_gyro_data[instance] = true;
     }
@@ -565,6 +704,9 @@ void AP_InertialSensor_Backend::_notify_new_accel_raw_sample(uint8_t instance,
         }
 
         _imu.set_accel_peak_hold(instance, _imu._accel_filtered[instance]);
+#if AP_INERTIALSENSOR_TIME_ALIGN_ENABLED
+        _imu._accel_align_sample[instance].push(_imu._accel_filtered[instance], sample_us);
+#endif
 
         _imu._new_accel_data[instance] = true;
     }
@@ -582,6 +724,126 @@ void AP_InertialSensor_Backend::_notify_new_accel_raw_sample(uint8_t instance,
 #endif
 }
 
+/*
+  handle a block of accel samples read from a FIFO. As with
+  _notify_new_gyro_raw_samples() the samples are raw sensor frame values
+  which are converted in place
+ */
+void AP_InertialSensor_Backend::_notify_new_accel_raw_samples(uint8_t instance, Vector3f *accel, uint8_t n, float scale)
+{
+    if (n == 0 || ((1U<<instance) & _imu.imu_kill_mask)) {
+        return;
+    }
+
+#if HAL_INS_TEMPERATURE_CAL_ENABLE
+    if (_imu.tcal_learning) {
+        // learning needs each sample in sensor frame
+        for (uint8_t i = 0; i < n; i++) {
+            accel[i] *= scale;
+            _rotate_and_correct_accel(instance, accel[i]);
+            _notify_new_accel_raw_sample(instance, accel[i]);
+        }
+        return;
+    }
+#endif
+
+    // accel = board_rot * accel_scale * (sensor_rot * raw * scale + correction)
+    Matrix3f sensor_rot, rot;
+    sensor_rot.from_rotation(_imu._accel_orientation[instance]);
+    rot.from_rotation(_imu._board_orientation);
+    Vector3f bias;
+    if (!_imu._calibrating_accel && (_imu._acal == nullptr
+#if HAL_INS_ACCELCAL_ENABLED
+        || !_imu._acal->running()
+#endif
+    )) {
+#if HAL_INS_TEMPERATURE_CAL_ENABLE
+        _imu.tcal[instance].correct_accel(_imu.get_temperature(instance), _imu.caltemp_accel[instance], bias);
+#endif
+        bias -= _imu._accel_offset[instance];
+
+        // scaling is per sensor axis, so scale the rows of the sensor rotation
+        const Vector3f &accel_scale = _imu._accel_scale[instance].get();
+        bias.x *= accel_scale.x;
+        bias.y *= accel_scale.y;
+        bias.z *= accel_scale.z;
+        sensor_rot.a *= accel_scale.x;
+        sensor_rot.b *= accel_scale.y;
+        sensor_rot.c *= accel_scale.z;
+        bias = rot * bias;
+    }
+    rot = rot * sensor_rot * scale;
+    for (uint8_t i = 0; i < n; i++) {
+        accel[i] = rot * accel[i] + bias;
+    }
+
+    _update_sensor_rate(_imu._sample_accel_count[instance], _imu._sample_accel_start_us[instance],
+                        _imu._accel_raw_sample_rates[instance], n);
+
+    // don't accept below 40Hz
+    if (_imu._accel_raw_sample_rates[instance] < 40) {
+        return;
+    }
+
+    // FIFO samples are spaced at the sensor rate, ending now
+    const float dt = 1.0f / _imu._accel_raw_sample_rates[instance];
+    const uint64_t last_sample_us = _imu._accel_last_sample_us[instance];
+    const uint64_t now = AP_HAL::micros64();
+    _imu._accel_last_sample_us[instance] = now;
+    const uint32_t dt_us = dt * 1.0e6f;
+
+    for (uint8_t i = 0; i < n; i++) {
+#if AP_MODULE_SUPPORTED
+        AP_Module::call_hook_accel_sample(instance, dt, accel[i], false);
+#endif
+        _imu.calc_vibration_and_clipping(instance, accel[i], dt);
+    }
+
+#if AP_INERTIALSENSOR_BATCHSAMPLER_ENABLED
+    const bool post_filter_logging = _imu.batchsampler.doing_post_filter_logging();
+#else
+    const bool post_filter_logging = false;
+#endif
+
+    {
+        WITH_SEMAPHORE(_sem);
+
+        float sample_dt = dt;
+        if (now - last_sample_us > 100000U) {
+            // zero accumulator if sensor was unhealthy for 0.1s
+            _imu._delta_velocity_acc[instance].zero();
+            _imu._delta_velocity_acc_dt[instance] = 0;
+            sample_dt = 0;
+        }
+
+        for (uint8_t i = 0; i < n; i++) {
+            _imu._delta_velocity_acc[instance] += accel[i] * sample_dt;
+            _imu._delta_velocity_acc_dt[instance] += sample_dt;
+            sample_dt = dt;
+
+            _imu._accel_filtered[instance] = _imu._accel_filter[instance].apply(accel[i]);
+            if (_imu._accel_filtered[instance].is_nan() || _imu._accel_filtered[instance].is_inf()) {
+                _imu._accel_filter[instance].reset();
+            }
+
+            _imu.set_accel_peak_hold(instance, _imu._accel_filtered[instance]);
+#if AP_INERTIALSENSOR_TIME_ALIGN_ENABLED
+            _imu._accel_align_sample[instance].push(_imu._accel_filtered[instance], now - uint32_t(n - 1 - i) * dt_us);
+#endif
+
+            if (post_filter_logging) {
+                accel[i] = _imu._accel_filtered[instance];
+            }
+        }
+
+        _imu._new_accel_data[instance] = true;
+    }
+
+    for (uint8_t i = 0; i < n; i++) {
+        log_accel_raw(instance, now - uint32_t(n - 1 - i) * dt_us, accel[i]);
+    }
+}
+
 /*
   handle a delta-velocity sample from the backend. This assumes FIFO style sampling and
   the sample should not be rotated or corrected for offsets
@@ -643,6 +905,9 @@ void AP_InertialSensor_Backend::_notify_new_delta_velocity(uint8_t instance, con
         }
 
         _imu.set_accel_peak_hold(instance, _imu._accel_filtered[instance]);
+#if AP_INERTIALSENSOR_TIME_ALIGN_ENABLED
+        _imu._accel_align_sample[instance].push(_imu._accel_filtered[instance], sample_us);
+#endif
 
         _imu._new_accel_data[instance] = true;
     }
@@ -752,6 +1017,9 @@ void AP_InertialSensor_Backend::update_gyro(uint8_t instance) /* front end */
     }
     if (_imu._new_gyro_data[instance]) {
         _publish_gyro(instance, _imu._gyro_filtered[instance]);
+#if AP_INERTIALSENSOR_TIME_ALIGN_ENABLED
+        _imu._gyro_align_pub[instance] = _imu._gyro_align_sample[instance];
+#endif
 #if HAL_WITH_DSP
         // copy the gyro samples from the backend to the frontend window for FFTs sampling at less than IMU rate
         _imu._gyro_for_fft[instance] = _imu._last_gyro_for_fft[instance];
@@ -789,6 +1057,9 @@ void AP_InertialSensor_Backend::update_accel(uint8_t instance) /* front end */
     }
     if (_imu._new_accel_data[instance]) {
         _publish_accel(instance, _imu._accel_filtered[instance]);
+#if AP_INERTIALSENSOR_TIME_ALIGN_ENABLED
+        _imu._accel_align_pub[instance] = _imu._accel_align_sample[instance];
+#endif
         _imu._new_accel_data[instance] = false;
     }
     
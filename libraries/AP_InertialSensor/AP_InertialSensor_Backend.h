@@ -154,6 +154,11 @@ protected:
     // sensors, and should be set to zero for FIFO based sensors
     void _notify_new_gyro_raw_sample(uint8_t instance, const Vector3f &accel, uint64_t sample_us=0) __RAMFUNC__;
 
+    // block interface for FIFO based sensors. The samples are raw
+    // sensor frame values, multiplied by scale then rotated, corrected
+    // and filtered in one pass. The array contents are overwritten
+    void _notify_new_gyro_raw_samples(uint8_t instance, Vector3f *gyro, uint8_t n, float scale) __RAMFUNC__;
+
     // alternative interface using delta-angles. Rotation and correction is handled inside this function
     void _notify_new_delta_angle(uint8_t instance, const Vector3f &dangle);
     
@@ -168,6 +173,9 @@ protected:
     // sensors, and should be set to zero for FIFO based sensors
     void _notify_new_accel_raw_sample(uint8_t instance, const Vector3f &accel, uint64_t sample_us=0, bool fsync_set=false) __RAMFUNC__;
 
+    // block interface for FIFO based sensors, see _notify_new_gyro_raw_samples()
+    void _notify_new_accel_raw_samples(uint8_t instance, Vector3f *accel, uint8_t n, float scale) __RAMFUNC__;
+
     // alternative interface using delta-velocities. Rotation and correction is handled inside this function
     void _notify_new_delta_velocity(uint8_t instance, const Vector3f &dvelocity);
     
@@ -203,8 +211,8 @@ protected:
         _imu._gyro_raw_sampling_multiplier[instance] = mul;
     }
 
-    // update the sensor rate for FIFO sensors
-    void _update_sensor_rate(uint16_t &count, uint32_t &start_us, float &rate_hz) const __RAMFUNC__;
+    // update the sensor rate for FIFO sensors, given n new samples
+    void _update_sensor_rate(uint16_t &count, uint32_t &start_us, float &rate_hz, uint8_t n=1) const __RAMFUNC__;
 
     // return true if the sensors are still converging and sampling rates could change significantly
     bool sensors_converging() const { return AP_HAL::millis() < HAL_INS_CONVERGANCE_MS; }
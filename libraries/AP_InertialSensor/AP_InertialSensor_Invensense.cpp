@@ -82,7 +82,6 @@ AP_InertialSensor_Invensense::AP_InertialSensor_Invensense(AP_InertialSensor &im
                                                            AP_HAL::OwnPtr<AP_HAL::Device> dev,
                                                            enum Rotation rotation)
     : AP_InertialSensor_Backend(imu)
-    , _temp_filter(1000, 1)
     , _rotation(rotation)
     , _dev(std::move(dev))
 {
@@ -181,13 +180,18 @@ void AP_InertialSensor_Invensense::_fifo_reset(bool log_error)
     uint8_t user_ctrl = _last_stat_user_ctrl;
     user_ctrl &= ~(BIT_USER_CTRL_FIFO_RESET | BIT_USER_CTRL_FIFO_EN);
 
+    const uint8_t fifo_en = BIT_XG_FIFO_EN | BIT_YG_FIFO_EN |
+        BIT_ZG_FIFO_EN | BIT_ACCEL_FIFO_EN | BIT_TEMP_FIFO_EN;
+
     _dev->set_speed(AP_HAL::Device::SPEED_LOW);
-    _register_write(MPUREG_FIFO_EN, 0);
-    _register_write(MPUREG_USER_CTRL, user_ctrl);
-    _register_write(MPUREG_USER_CTRL, user_ctrl | BIT_USER_CTRL_FIFO_RESET);
-    _register_write(MPUREG_USER_CTRL, user_ctrl | BIT_USER_CTRL_FIFO_EN);
-    _register_write(MPUREG_FIFO_EN, BIT_XG_FIFO_EN | BIT_YG_FIFO_EN |
-                    BIT_ZG_FIFO_EN | BIT_ACCEL_FIFO_EN | BIT_TEMP_FIFO_EN, true);
+    AP_HAL::Device::TransferBatch<5> batch(*_dev);
+    batch.write_register(MPUREG_FIFO_EN, 0);
+    batch.write_register(MPUREG_USER_CTRL, user_ctrl);
+    batch.write_register(MPUREG_USER_CTRL, user_ctrl | BIT_USER_CTRL_FIFO_RESET);
+    batch.write_register(MPUREG_USER_CTRL, user_ctrl | BIT_USER_CTRL_FIFO_EN);
+    batch.write_register(MPUREG_FIFO_EN, fifo_en);
+    batch.submit();
+    _dev->set_checked_register(MPUREG_FIFO_EN, fifo_en);
     hal.scheduler->delay_microseconds(1);
     _dev->set_speed(AP_HAL::Device::SPEED_HIGH);
     _last_stat_user_ctrl = user_ctrl | BIT_USER_CTRL_FIFO_EN;
@@ -711,8 +715,19 @@ void AP_InertialSensor_Invensense::_read_fifo()
     uint16_t bytes_read;
     uint8_t *rx = _fifo_buffer;
     bool need_reset = false;
+    uint8_t y_ofs = 0;
+    bool have_y_ofs = false;
 
-    if (!_block_read(MPUREG_FIFO_COUNTH, rx, 2)) {
+    if (_mpu_type == Invensense_ICM20602) {
+        // read the Y offset checked below with the FIFO count
+        AP_HAL::Device::TransferBatch<2> batch(*_dev);
+        batch.read_registers(MPUREG_FIFO_COUNTH, rx, 2);
+        batch.read_registers(MPUREG_ACC_OFF_Y_H, &y_ofs, 1);
+        if (!batch.submit()) {
+            goto check_registers;
+        }
+        have_y_ofs = true;
+    } else if (!_block_read(MPUREG_FIFO_COUNTH, rx, 2)) {
         goto check_registers;
     }
 
@@ -794,7 +809,9 @@ check_registers:
     // check next register value for correctness
 
     if (_mpu_type == Invensense_ICM20602) {
-        const uint8_t y_ofs = _register_read(MPUREG_ACC_OFF_Y_H);
+        if (!have_y_ofs) {
+            y_ofs = _register_read(MPUREG_ACC_OFF_Y_H);
+        }
         if (y_ofs != _saved_y_ofs_high) {
             /*
               we check and restore the ICM20602 Y offset high register
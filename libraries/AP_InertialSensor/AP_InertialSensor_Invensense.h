@@ -128,7 +128,7 @@ private:
 
     float _fifo_accel_scale;
     float _fifo_gyro_scale;
-    LowPassFilter2pFloat _temp_filter;
+    LowPassFilter2pConst<float, 1000, 1> _temp_filter;
     uint32_t last_reset_ms;
     uint8_t reset_count;
     uint8_t fast_reset_count;
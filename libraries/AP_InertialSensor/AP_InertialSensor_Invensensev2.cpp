@@ -61,7 +61,6 @@ AP_InertialSensor_Invensensev2::AP_InertialSensor_Invensensev2(AP_InertialSensor
                                                            AP_HAL::OwnPtr<AP_HAL::Device> dev,
                                                            enum Rotation rotation)
     : AP_InertialSensor_Backend(imu)
-    , _temp_filter(1125, 1)
     , _rotation(rotation)
     , _dev(std::move(dev))
 {
@@ -114,7 +114,7 @@ private:
     float _accel_scale;
     float _fifo_accel_scale;
     float _fifo_gyro_scale;
-    LowPassFilter2pFloat _temp_filter;
+    LowPassFilter2pConst<float, 1125, 1> _temp_filter;
 
     enum Rotation _rotation;
 
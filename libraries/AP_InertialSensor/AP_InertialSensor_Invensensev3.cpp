@@ -156,6 +156,8 @@ struct PACKED FIFOData {
 
 #define INV3_SAMPLE_SIZE sizeof(FIFOData)
 #define INV3_FIFO_BUFFER_LEN 8
+// an asynchronous fifo read block has the register byte in front of the samples
+#define INV3_DMA_BLOCK_LEN (1 + INV3_FIFO_BUFFER_LEN * INV3_SAMPLE_SIZE)
 
 AP_InertialSensor_Invensensev3::AP_InertialSensor_Invensensev3(AP_InertialSensor &imu,
                                                                AP_HAL::OwnPtr<AP_HAL::Device> _dev,
@@ -171,6 +173,9 @@ AP_InertialSensor_Invensensev3::~AP_InertialSensor_Invensensev3()
     if (fifo_buffer != nullptr) {
         hal.util->free_type((void*)fifo_buffer, INV3_FIFO_BUFFER_LEN * INV3_SAMPLE_SIZE, AP_HAL::Util::MEM_DMA_SAFE);
     }
+    if (fifo_dma_buffer != nullptr) {
+        hal.util->free_type((void*)fifo_dma_buffer, 2 * INV3_DMA_BLOCK_LEN, AP_HAL::Util::MEM_DMA_SAFE);
+    }
 }
 
 AP_InertialSensor_Backend *AP_InertialSensor_Invensensev3::probe(AP_InertialSensor &imu,
@@ -304,6 +309,10 @@ void AP_InertialSensor_Invensensev3::start()
     if (fifo_buffer == nullptr) {
         AP_HAL::panic("Invensensev3: Unable to allocate FIFO buffer");
     }
+    if (dev->bus_type() == AP_HAL::Device::BUS_TYPE_SPI) {
+        // optional, read_fifo() falls back to blocking reads without it
+        fifo_dma_buffer = (uint8_t *)hal.util->malloc_type(2 * INV3_DMA_BLOCK_LEN, AP_HAL::Util::MEM_DMA_SAFE);
+    }
 
     // start the timer process to read samples, using the fastest rate avilable
     periodic_handle = dev->register_periodic_callback(backend_period_us, FUNCTOR_BIND_MEMBER(&AP_InertialSensor_Invensensev3::read_fifo, void));
@@ -341,37 +350,36 @@ void AP_InertialSensor_Invensensev3::accumulate()
 
 bool AP_InertialSensor_Invensensev3::accumulate_samples(const FIFOData *data, uint8_t n_samples)
 {
-    for (uint8_t i = 0; i < n_samples; i++) {
+    Vector3f accel[INV3_FIFO_BUFFER_LEN];
+    Vector3f gyro[INV3_FIFO_BUFFER_LEN];
+    uint8_t n = 0;
+    bool ret = true;
+
+    for (uint8_t i = 0; i < n_samples && n < INV3_FIFO_BUFFER_LEN; i++) {
         const FIFOData &d = data[i];
 
         // we have a header to confirm we don't have FIFO corruption! no more mucking
         // about with the temperature registers
         if ((d.header & 0xFC) != 0x68) {
             // no or bad data
-            return false;
+            ret = false;
+            break;
         }
 
-        Vector3f accel{float(d.accel[0]), float(d.accel[1]), float(d.accel[2])};
-        Vector3f gyro{float(d.gyro[0]), float(d.gyro[1]), float(d.gyro[2])};
+        accel[n] = Vector3f{float(d.accel[0]), float(d.accel[1]), float(d.accel[2])};
+        gyro[n] = Vector3f{float(d.gyro[0]), float(d.gyro[1]), float(d.gyro[2])};
+        n++;
 
-        accel *= accel_scale;
-        if (inv3_type == Invensensev3_Type::ICM45686) {
-            gyro *= GYRO_SCALE_4000DPS;
-        } else {
-            gyro *= GYRO_SCALE_2000DPS;
-        }
         const float temp = d.temperature * temp_sensitivity + temp_zero;
-
-        // these four calls are about 40us
-        _rotate_and_correct_accel(accel_instance, accel);
-        _rotate_and_correct_gyro(gyro_instance, gyro);
-
-        _notify_new_accel_raw_sample(accel_instance, accel, 0);
-        _notify_new_gyro_raw_sample(gyro_instance, gyro);
-
         temp_filtered = temp_filter.apply(temp);
     }
-    return true;
+
+    // rotate, correct and filter the whole block at once
+    _notify_new_accel_raw_samples(accel_instance, accel, n, accel_scale);
+    _notify_new_gyro_raw_samples(gyro_instance, gyro, n,
+                                 inv3_type == Invensensev3_Type::ICM45686 ? GYRO_SCALE_4000DPS : GYRO_SCALE_2000DPS);
+
+    return ret;
 }
 
 /*
@@ -413,17 +421,52 @@ void AP_InertialSensor_Invensensev3::read_fifo()
     // this means that we rarely run read_fifo() without updating the sensor data
     dev->adjust_periodic_callback(periodic_handle, backend_period_us);
 
-    while (n_samples > 0) {
-        uint8_t n = MIN(n_samples, INV3_FIFO_BUFFER_LEN);
-        if (!block_read(reg_data, (uint8_t*)fifo_buffer, n * INV3_SAMPLE_SIZE)) {
-            goto check_registers;
+    if (fifo_dma_buffer != nullptr &&
+        !fifo_read_start(reg_data, fifo_dma_buffer, MIN(n_samples, INV3_FIFO_BUFFER_LEN))) {
+        // the bus has no asynchronous transfers
+        hal.util->free_type((void*)fifo_dma_buffer, 2 * INV3_DMA_BLOCK_LEN, AP_HAL::Util::MEM_DMA_SAFE);
+        fifo_dma_buffer = nullptr;
+    }
+
+    if (fifo_dma_buffer != nullptr) {
+        // the next block is read by DMA while the current one is processed
+        uint8_t idx = 0;
+        while (n_samples > 0) {
+            const uint8_t n = MIN(n_samples, INV3_FIFO_BUFFER_LEN);
+            if (!dev->transfer_finish()) {
+                goto check_registers;
+            }
+            n_samples -= n;
+            const uint8_t *buf = &fifo_dma_buffer[idx * INV3_DMA_BLOCK_LEN];
+            idx ^= 1;
+            const bool started = n_samples > 0 &&
+                fifo_read_start(reg_data, &fifo_dma_buffer[idx * INV3_DMA_BLOCK_LEN], MIN(n_samples, INV3_FIFO_BUFFER_LEN));
+
+            if (!accumulate_samples((const FIFOData *)&buf[1], n)) {
+                if (started) {
+                    dev->transfer_finish();
+                }
+                need_reset = true;
+                break;
+            }
+            if (!started) {
+                // anything left is read on the next callback
+                break;
+            }
         }
+    } else {
+        while (n_samples > 0) {
+            uint8_t n = MIN(n_samples, INV3_FIFO_BUFFER_LEN);
+            if (!block_read(reg_data, (uint8_t*)fifo_buffer, n * INV3_SAMPLE_SIZE)) {
+                goto check_registers;
+            }
 
-        if (!accumulate_samples(fifo_buffer, n)) {
-            need_reset = true;
-            break;
+            if (!accumulate_samples(fifo_buffer, n)) {
+                need_reset = true;
+                break;
+            }
+            n_samples -= n;
         }
-        n_samples -= n;
     }
 
     if (need_reset) {
@@ -447,6 +490,17 @@ bool AP_InertialSensor_Invensensev3::block_read(uint8_t reg, uint8_t *buf, uint3
     return dev->read_registers(reg, buf, size);
 }
 
+/*
+  start an asynchronous read of n_samples from the FIFO into buf, with
+  the samples following the register byte
+ */
+bool AP_InertialSensor_Invensensev3::fifo_read_start(uint8_t reg, uint8_t *buf, uint8_t n_samples)
+{
+    buf[0] = reg | BIT_READ_FLAG;
+    memset(&buf[1], 0, n_samples * INV3_SAMPLE_SIZE);
+    return dev->transfer_start(buf, buf, 1 + n_samples * INV3_SAMPLE_SIZE);
+}
+
 uint8_t AP_InertialSensor_Invensensev3::register_read(uint8_t reg)
 {
     uint8_t val = 0;
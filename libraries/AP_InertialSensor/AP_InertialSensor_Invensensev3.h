@@ -62,6 +62,7 @@ private:
     void read_fifo();
 
     bool block_read(uint8_t reg, uint8_t *buf, uint32_t size);
+    bool fifo_read_start(uint8_t reg, uint8_t *buf, uint8_t n_samples);
     uint8_t register_read(uint8_t reg);
     void register_write(uint8_t reg, uint8_t val, bool checked=false);
 
@@ -104,6 +105,10 @@ private:
     // buffer for fifo read
     struct FIFOData *fifo_buffer;
 
+    // double buffer for asynchronous fifo reads, nullptr if the bus
+    // does not support them
+    uint8_t *fifo_dma_buffer;
+
     float temp_filtered;
     LowPassFilter2pFloat temp_filter;
 };
@@ -101,7 +101,7 @@ private:
     uint8_t _accel_instance;
     float _temperature;
     uint8_t _temp_counter;
-    LowPassFilter2pFloat _temp_filter;
+    LowPassFilter2pConst<float, 400, 1> _temp_filter;
 
     // gyro whoami
     uint8_t whoami_g;
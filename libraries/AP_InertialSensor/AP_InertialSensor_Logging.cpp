@@ -7,6 +7,19 @@
 void AP_InertialSensor_Backend::Write_ACC(const uint8_t instance, const uint64_t sample_us, const Vector3f &accel) const
 {
         const uint64_t now = AP_HAL::micros64();
+        if (AP::logger().compact(AP_Logger::Compact::RAW_IMU)) {
+            struct log_ACCH pkt {
+                LOG_PACKET_HEADER_INIT(LOG_ACCH_MSG),
+                time_us   : now,
+                instance  : instance,
+                sample_us : sample_us?sample_us:now,
+            };
+            pkt.AccX.set(accel.x);
+            pkt.AccY.set(accel.y);
+            pkt.AccZ.set(accel.z);
+            AP::logger().WriteBlock(&pkt, sizeof(pkt));
+            return;
+        }
         const struct log_ACC pkt {
             LOG_PACKET_HEADER_INIT(LOG_ACC_MSG),
             time_us   : now,
@@ -23,6 +36,19 @@ void AP_InertialSensor_Backend::Write_ACC(const uint8_t instance, const uint64_t
 void AP_InertialSensor_Backend::Write_GYR(const uint8_t instance, const uint64_t sample_us, const Vector3f &gyro) const
 {
         const uint64_t now = AP_HAL::micros64();
+        if (AP::logger().compact(AP_Logger::Compact::RAW_IMU)) {
+            struct log_GYRH pkt {
+                LOG_PACKET_HEADER_INIT(LOG_GYRH_MSG),
+                time_us   : now,
+                instance  : instance,
+                sample_us : sample_us?sample_us:now,
+            };
+            pkt.GyrX.set(gyro.x);
+            pkt.GyrY.set(gyro.y);
+            pkt.GyrZ.set(gyro.z);
+            AP::logger().WriteBlock(&pkt, sizeof(pkt));
+            return;
+        }
         const struct log_GYR pkt{
             LOG_PACKET_HEADER_INIT(LOG_GYR_MSG),
             time_us   : now,
@@ -99,17 +125,12 @@ void AP_InertialSensor::Write_Vibration() const
 // Write information about a series of IMU readings to log:
 bool AP_InertialSensor::BatchSampler::Write_ISBH(const float sample_rate_hz) const
 {
-    uint8_t instance_to_write = instance;
-    if (post_filter && (_doing_pre_post_filter_logging
-            || (_doing_post_filter_logging && _doing_sensor_rate_logging))) {
-        instance_to_write += (type == IMU_SENSOR_TYPE_ACCEL ? _imu._accel_count : _imu._gyro_count);
-    }
     const struct log_ISBH pkt{
         LOG_PACKET_HEADER_INIT(LOG_ISBH_MSG),
         time_us        : AP_HAL::micros64(),
         seqno          : isb_seqnum,
         sensor_type    : (uint8_t)type,
-        instance       : instance_to_write,
+        instance       : output_instance(),
         multiplier     : multiplier,
         sample_count   : (uint16_t)_required_count,
         sample_us      : measurement_started_us,
@@ -37,14 +37,11 @@ bool AP_InertialSensor_SITL::init_sensor(void)
     if (sitl == nullptr) {
         return false;
     }
+    // each sensor gets its own noise, the generator must not start at zero
+    noise_state = (uint32_t(get_random16()) << 16) | get_random16() | 1U;
     return true;
 }
 
-// calculate a noisy noise component
-static float calculate_noise(float noise, float noise_variation) {
-    return noise * (1.0f + noise_variation * rand_float());
-}
-
 float AP_InertialSensor_SITL::get_temperature(void)
 {
 #if HAL_INS_TEMPERATURE_CAL_ENABLE
@@ -68,121 +65,176 @@ float AP_InertialSensor_SITL::get_temperature(void)
 }
 
 /*
-  generate an accelerometer sample
+  a fast random float between -1 and 1 for the sensor noise. This is a
+  xorshift generator private to the sensor, which avoids the lock and
+  division in random() for the dozens of values each sample needs
  */
-void AP_InertialSensor_SITL::generate_accel()
+float AP_InertialSensor_SITL::rand_noise(void)
 {
-    Vector3f accel_accum;
-    uint8_t nsamples = enable_fast_sampling(accel_instance) ? 4 : 1;
-
-    for (uint8_t j = 0; j < nsamples; j++) {
+    noise_state ^= noise_state << 13;
+    noise_state ^= noise_state >> 17;
+    noise_state ^= noise_state << 5;
+    return int32_t(noise_state) * (1.0f / 2147483648.0f);
+}
 
-        Vector3f accel = Vector3f(sitl->state.xAccel,
-                                  sitl->state.yAccel,
-                                  sitl->state.zAccel);
+// calculate a noisy noise component
+float AP_InertialSensor_SITL::calculate_noise(float noise, float noise_variation)
+{
+    return noise * (1.0f + noise_variation * rand_noise());
+}
 
-        const Vector3f &accel_trim = sitl->accel_trim.get();
-        if (!accel_trim.is_zero()) {
-            Matrix3f trim_rotation;
-            trim_rotation.from_euler(accel_trim.x, accel_trim.y, 0);
-            accel = trim_rotation.transposed() * accel;
-        }
+/*
+  add the SIM_VIB_FREQ vibration to one sample and advance the phase
+  of each axis by one sample period
+ */
+void AP_InertialSensor_SITL::add_fixed_vibration(Vector3f &v, Vector3f &phase, float noise, float sample_hz)
+{
+    constexpr float noise_variation = 0.05f;
+    const Vector3f &vibe_freq = sitl->vibe_freq;
+    v.x += sinf(phase.x) * calculate_noise(noise, noise_variation);
+    v.y += sinf(phase.y) * calculate_noise(noise, noise_variation);
+    v.z += sinf(phase.z) * calculate_noise(noise, noise_variation);
+    const float scale = 2 * M_PI / sample_hz;
+    phase.x = wrap_PI(phase.x + vibe_freq.x * scale);
+    phase.y = wrap_PI(phase.y + vibe_freq.y * scale);
+    phase.z = wrap_PI(phase.z + vibe_freq.z * scale);
+}
 
-        // add scaling
-        Vector3f accel_scale = sitl->accel_scale[accel_instance].get();
-        // note that we divide so the SIM_ACC values match the
-        // INS_ACCSCAL values
-        if (!is_zero(accel_scale.x)) {
-            accel.x /= accel_scale.x;
-        }
-        if (!is_zero(accel_scale.y)) {
-            accel.y /= accel_scale.y;
-        }
-        if (!is_zero(accel_scale.z)) {
-            accel.z /= accel_scale.z;
+/*
+  add the rpm-scaled SIM_VIB_MOT_MAX vibration of each motor to one
+  sample and advance the motor phases by one sample period
+ */
+void AP_InertialSensor_SITL::add_motor_vibration(Vector3f &v, float motor_phase[], float noise, float sample_hz)
+{
+    constexpr float noise_variation = 0.05f;
+    // this smears the individual motor peaks somewhat emulating physical motors
+    constexpr float freq_variation = 0.12f;
+    const uint32_t harmonics_mask = uint32_t(sitl->vibe_motor_harmonics);
+    uint32_t mask = sitl->state.motor_mask;
+    uint8_t mbit;
+    while ((mbit = __builtin_ffs(mask)) != 0) {
+        const uint8_t motor = mbit-1;
+        mask &= ~(1U<<motor);
+        const float base_freq = calculate_noise(sitl->state.rpm[motor] / 60.0f, freq_variation);
+        // sin(k*phase) for the k'th harmonic comes from the recurrence
+        // sin((k+1)x) = 2cos(x)sin(kx) - sin((k-1)x), so each motor
+        // needs one sinf and cosf whatever the number of harmonics
+        const float phase = motor_phase[motor];
+        const float two_cos = 2 * cosf(phase);
+        float sin_prev = 0;
+        float sin_k = sinf(phase);
+        for (uint32_t harmonics = harmonics_mask; harmonics != 0; harmonics >>= 1) {
+            if (harmonics & 1U) {
+                v.x += sin_k * calculate_noise(noise, noise_variation);
+                v.y += sin_k * calculate_noise(noise, noise_variation);
+                v.z += sin_k * calculate_noise(noise, noise_variation);
+            }
+            const float sin_next = two_cos * sin_k - sin_prev;
+            sin_prev = sin_k;
+            sin_k = sin_next;
         }
+        motor_phase[motor] = wrap_PI(phase + base_freq * 2 * M_PI / sample_hz);
+    }
+}
 
-        // apply bias
-        const Vector3f &accel_bias = sitl->accel_bias[accel_instance].get();
-        accel += accel_bias;
+/*
+  generate an accelerometer sample. With fast sampling this is a block
+  of sensor rate samples from the same vehicle state, so everything
+  but the noise and vibration is worked out once for the block
+ */
+void AP_InertialSensor_SITL::generate_accel()
+{
+    Vector3f accel_accum;
+    const uint8_t nsamples = enable_fast_sampling(accel_instance) ? 4 : 1;
+    const float sample_hz = accel_sample_hz * nsamples;
+    const float T = get_temperature();
+
+    Vector3f accel_base = Vector3f(sitl->state.xAccel,
+                                   sitl->state.yAccel,
+                                   sitl->state.zAccel);
+
+    const Vector3f &accel_trim = sitl->accel_trim.get();
+    if (!accel_trim.is_zero()) {
+        Matrix3f trim_rotation;
+        trim_rotation.from_euler(accel_trim.x, accel_trim.y, 0);
+        accel_base = trim_rotation.transposed() * accel_base;
+    }
 
-        // minimum noise levels are 2 bits, but averaged over many
-        // samples, giving around 0.01 m/s/s
-        float accel_noise = 0.01f;
-        float noise_variation = 0.05f;
-        // this smears the individual motor peaks somewhat emulating physical motors
-        float freq_variation = 0.12f;
+    // add scaling
+    Vector3f accel_scale = sitl->accel_scale[accel_instance].get();
+    // note that we divide so the SIM_ACC values match the
+    // INS_ACCSCAL values
+    if (!is_zero(accel_scale.x)) {
+        accel_base.x /= accel_scale.x;
+    }
+    if (!is_zero(accel_scale.y)) {
+        accel_base.y /= accel_scale.y;
+    }
+    if (!is_zero(accel_scale.z)) {
+        accel_base.z /= accel_scale.z;
+    }
 
-        // add in sensor noise
-        accel += Vector3f{rand_float(), rand_float(), rand_float()} * accel_noise;
+    // apply bias
+    const Vector3f &accel_bias = sitl->accel_bias[accel_instance].get();
+    accel_base += accel_bias;
+
+    // correct for the acceleration due to the IMU position offset and angular acceleration
+    // correct for the centripetal acceleration
+    // only apply corrections to first accelerometer
+    Vector3f pos_offset = sitl->imu_pos_offset;
+    if (!pos_offset.is_zero()) {
+        // calculate sensed acceleration due to lever arm effect
+        // Note: the % operator has been overloaded to provide a cross product
+        Vector3f angular_accel = Vector3f(radians(sitl->state.angAccel.x), radians(sitl->state.angAccel.y), radians(sitl->state.angAccel.z));
+        Vector3f lever_arm_accel = angular_accel % pos_offset;
+
+        // calculate sensed acceleration due to centripetal acceleration
+        Vector3f angular_rate = Vector3f(radians(sitl->state.rollRate), radians(sitl->state.pitchRate), radians(sitl->state.yawRate));
+        Vector3f centripetal_accel = angular_rate % (angular_rate % pos_offset);
+
+        // apply corrections
+        accel_base += lever_arm_accel + centripetal_accel;
+    }
 
-        bool motors_on = sitl->throttle > sitl->ins_noise_throttle_min;
+    // temperature offset, added after any failure value
+    Vector3f accel_tcal;
+#if HAL_INS_TEMPERATURE_CAL_ENABLE
+    sitl->imu_tcal[gyro_instance].sitl_apply_accel(T, accel_tcal);
+#endif
 
-        // on a real 180mm copter gyro noise varies between 0.8-4 m/s/s for throttle 0.2-0.8
-        // giving a accel noise variation of 5.33 m/s/s over the full throttle range
-        if (motors_on) {
-            // add extra noise when the motors are on
-            accel_noise = sitl->accel_noise[accel_instance];
-        }
+    const bool accel_failed = fabsf(sitl->accel_fail[accel_instance]) > 1.0e-6f;
+
+    // minimum noise levels are 2 bits, but averaged over many
+    // samples, giving around 0.01 m/s/s
+    const float accel_min_noise = 0.01f;
+    const bool motors_on = sitl->throttle > sitl->ins_noise_throttle_min;
+    // on a real 180mm copter gyro noise varies between 0.8-4 m/s/s for throttle 0.2-0.8
+    // giving a accel noise variation of 5.33 m/s/s over the full throttle range
+    // add extra noise when the motors are on
+    const float accel_noise = motors_on ? float(sitl->accel_noise[accel_instance]) : accel_min_noise;
+    // VIB_FREQ is a static vibration applied to each axis
+    const bool vibe_fixed = motors_on && !sitl->vibe_freq.get().is_zero();
+    // VIB_MOT_MAX is a rpm-scaled vibration applied to each axis
+    const bool vibe_motor = motors_on && !is_zero(sitl->vibe_motor);
 
-        // VIB_FREQ is a static vibration applied to each axis
-        const Vector3f &vibe_freq = sitl->vibe_freq;
+    for (uint8_t j = 0; j < nsamples; j++) {
+        Vector3f accel = accel_base;
 
-        if (!vibe_freq.is_zero() && motors_on) {
-            accel.x += sinf(accel_time * 2 * M_PI * vibe_freq.x) * calculate_noise(accel_noise, noise_variation);
-            accel.y += sinf(accel_time * 2 * M_PI * vibe_freq.y) * calculate_noise(accel_noise, noise_variation);
-            accel.z += sinf(accel_time * 2 * M_PI * vibe_freq.z) * calculate_noise(accel_noise, noise_variation);
-            accel_time += 1.0f / (accel_sample_hz * nsamples);
-        }
+        // add in sensor noise
+        accel += Vector3f{rand_noise(), rand_noise(), rand_noise()} * accel_min_noise;
 
-        // VIB_MOT_MAX is a rpm-scaled vibration applied to each axis
-        if (!is_zero(sitl->vibe_motor) && motors_on) {
-            uint32_t mask = sitl->state.motor_mask;
-            uint8_t mbit;
-            while ((mbit = __builtin_ffs(mask)) != 0) {
-                const uint8_t motor = mbit-1;
-                mask &= ~(1U<<motor);
-                uint32_t harmonics = uint32_t(sitl->vibe_motor_harmonics);
-                const float base_freq = calculate_noise(sitl->state.rpm[motor] / 60.0f, freq_variation);
-                while (harmonics != 0) {
-                    const uint8_t bit = __builtin_ffs(harmonics);
-                    harmonics &= ~(1U<<(bit-1U));
-                    const float phase = accel_motor_phase[motor] * float(bit);
-                    accel.x += sinf(phase) * calculate_noise(accel_noise * sitl->vibe_motor_scale, noise_variation);
-                    accel.y += sinf(phase) * calculate_noise(accel_noise * sitl->vibe_motor_scale, noise_variation);
-                    accel.z += sinf(phase) * calculate_noise(accel_noise * sitl->vibe_motor_scale, noise_variation);
-                }
-                const float phase_incr = base_freq * 2 * M_PI / (accel_sample_hz * nsamples);
-                accel_motor_phase[motor] = wrap_PI(accel_motor_phase[motor] + phase_incr);
-            }
+        if (vibe_fixed) {
+            add_fixed_vibration(accel, accel_vibe_phase, accel_noise, sample_hz);
         }
-
-        // correct for the acceleration due to the IMU position offset and angular acceleration
-        // correct for the centripetal acceleration
-        // only apply corrections to first accelerometer
-        Vector3f pos_offset = sitl->imu_pos_offset;
-        if (!pos_offset.is_zero()) {
-            // calculate sensed acceleration due to lever arm effect
-            // Note: the % operator has been overloaded to provide a cross product
-            Vector3f angular_accel = Vector3f(radians(sitl->state.angAccel.x), radians(sitl->state.angAccel.y), radians(sitl->state.angAccel.z));
-            Vector3f lever_arm_accel = angular_accel % pos_offset;
-
-            // calculate sensed acceleration due to centripetal acceleration
-            Vector3f angular_rate = Vector3f(radians(sitl->state.rollRate), radians(sitl->state.pitchRate), radians(sitl->state.yawRate));
-            Vector3f centripetal_accel = angular_rate % (angular_rate % pos_offset);
-
-            // apply corrections
-            accel += lever_arm_accel + centripetal_accel;
+        if (vibe_motor) {
+            add_motor_vibration(accel, accel_motor_phase, accel_noise * sitl->vibe_motor_scale, sample_hz);
         }
 
-        if (fabsf(sitl->accel_fail[accel_instance]) > 1.0e-6f) {
+        if (accel_failed) {
             accel.x = accel.y = accel.z = sitl->accel_fail[accel_instance];
         }
 
-#if HAL_INS_TEMPERATURE_CAL_ENABLE
-        const float T = get_temperature();
-        sitl->imu_tcal[gyro_instance].sitl_apply_accel(T, accel);
-#endif
+        accel += accel_tcal;
 
         _notify_new_accel_sensor_rate_sample(accel_instance, accel);
 
@@ -198,91 +250,74 @@ void AP_InertialSensor_SITL::generate_accel()
     _rotate_and_correct_accel(accel_instance, accel_accum);
     _notify_new_accel_raw_sample(accel_instance, accel_accum, AP_HAL::micros64());
 
-    _publish_temperature(accel_instance, get_temperature());
+    _publish_temperature(accel_instance, T);
 }
 
 /*
-  generate a gyro sample
+  generate a gyro sample, as a block of sensor rate samples with fast
+  sampling in the same way as generate_accel()
  */
 void AP_InertialSensor_SITL::generate_gyro()
 {
     Vector3f gyro_accum;
-    uint8_t nsamples = enable_fast_sampling(gyro_instance) ? 8 : 1;
+    const uint8_t nsamples = enable_fast_sampling(gyro_instance) ? 8 : 1;
+    const float sample_hz = gyro_sample_hz * nsamples;
 
     const float _gyro_drift = gyro_drift();
+    const Vector3f gyro_base {
+        radians(sitl->state.rollRate) + _gyro_drift,
+        radians(sitl->state.pitchRate) + _gyro_drift,
+        radians(sitl->state.yawRate) + _gyro_drift
+    };
+
+    Vector3f gyro_tcal;
+#if HAL_INS_TEMPERATURE_CAL_ENABLE
+    sitl->imu_tcal[gyro_instance].sitl_apply_gyro(get_temperature(), gyro_tcal);
+#endif
+
+    // add in gyro scaling
+    const Vector3f &scale = sitl->gyro_scale[gyro_instance];
+    const Vector3f gyro_scale {
+        1 + scale.x * 0.01f,
+        1 + scale.y * 0.01f,
+        1 + scale.z * 0.01f
+    };
+
+    // minimum gyro noise is less than 1 bit
+    const float gyro_min_noise = ToRad(0.04f);
+    const bool motors_on = sitl->throttle > sitl->ins_noise_throttle_min;
+    // on a real 180mm copter gyro noise varies between 0.2-0.4 rad/s for throttle 0.2-0.8
+    // giving a gyro noise variation of 0.33 rad/s or 20deg/s over the full throttle range
+    // add extra noise when the motors are on
+    const float gyro_noise = motors_on ? ToRad(sitl->gyro_noise[gyro_instance]) * sitl->throttle : gyro_min_noise;
+    // VIB_FREQ is a static vibration applied to each axis
+    const bool vibe_fixed = motors_on && !sitl->vibe_freq.get().is_zero();
+    // VIB_MOT_MAX is a rpm-scaled vibration applied to each axis
+    const bool vibe_motor = motors_on && !is_zero(sitl->vibe_motor);
+    // with no rpm noise add in background noise, if any
+    const bool background_noise = sitl->vibe_freq.get().is_zero() && is_zero(sitl->vibe_motor);
+
     for (uint8_t j = 0; j < nsamples; j++) {
-        float p = radians(sitl->state.rollRate) + _gyro_drift;
-        float q = radians(sitl->state.pitchRate) + _gyro_drift;
-        float r = radians(sitl->state.yawRate) + _gyro_drift;
-
-        // minimum gyro noise is less than 1 bit
-        float gyro_noise = ToRad(0.04f);
-        constexpr float noise_variation = 0.05f;
-        // this smears the individual motor peaks somewhat emulating physical motors
-        constexpr float freq_variation = 0.12f;
-        // add in sensor noise
-        p += gyro_noise * rand_float();
-        q += gyro_noise * rand_float();
-        r += gyro_noise * rand_float();
-
-        bool motors_on = sitl->throttle > sitl->ins_noise_throttle_min;
-        // on a real 180mm copter gyro noise varies between 0.2-0.4 rad/s for throttle 0.2-0.8
-        // giving a gyro noise variation of 0.33 rad/s or 20deg/s over the full throttle range
-        if (motors_on) {
-            // add extra noise when the motors are on
-            gyro_noise = ToRad(sitl->gyro_noise[gyro_instance]) * sitl->throttle;
-        }
+        Vector3f gyro = gyro_base;
 
-        // VIB_FREQ is a static vibration applied to each axis
-        const Vector3f &vibe_freq = sitl->vibe_freq;
+        // add in sensor noise
+        gyro += Vector3f{rand_noise(), rand_noise(), rand_noise()} * gyro_min_noise;
 
-        if (vibe_freq.is_zero() && is_zero(sitl->vibe_motor)) {
-            // no rpm noise, so add in background noise if any
-            p += gyro_noise * rand_float();
-            q += gyro_noise * rand_float();
-            r += gyro_noise * rand_float();
+        if (background_noise) {
+            gyro += Vector3f{rand_noise(), rand_noise(), rand_noise()} * gyro_noise;
         }
-
-        if (!vibe_freq.is_zero() && motors_on) {
-            p += sinf(gyro_time * 2 * M_PI * vibe_freq.x) * calculate_noise(gyro_noise, noise_variation);
-            q += sinf(gyro_time * 2 * M_PI * vibe_freq.y) * calculate_noise(gyro_noise, noise_variation);
-            r += sinf(gyro_time * 2 * M_PI * vibe_freq.z) * calculate_noise(gyro_noise, noise_variation);
-            gyro_time += 1.0f / (gyro_sample_hz * nsamples);
+        if (vibe_fixed) {
+            add_fixed_vibration(gyro, gyro_vibe_phase, gyro_noise, sample_hz);
         }
-
-        // VIB_MOT_MAX is a rpm-scaled vibration applied to each axis
-        if (!is_zero(sitl->vibe_motor) && motors_on) {
-            uint32_t mask = sitl->state.motor_mask;
-            uint8_t mbit;
-            while ((mbit = __builtin_ffs(mask)) != 0) {
-                const uint8_t motor = mbit-1;
-                mask &= ~(1U<<motor);
-                uint32_t harmonics = uint32_t(sitl->vibe_motor_harmonics);
-                const float base_freq = calculate_noise(sitl->state.rpm[motor] / 60.0f, freq_variation);
-                while (harmonics != 0) {
-                    const uint8_t bit = __builtin_ffs(harmonics);
-                    harmonics &= ~(1U<<(bit-1U));
-                    const float phase = gyro_motor_phase[motor] * float(bit);
-                    p += sinf(phase) * calculate_noise(gyro_noise * sitl->vibe_motor_scale, noise_variation);
-                    q += sinf(phase) * calculate_noise(gyro_noise * sitl->vibe_motor_scale, noise_variation);
-                    r += sinf(phase) * calculate_noise(gyro_noise * sitl->vibe_motor_scale, noise_variation);
-                }
-                const float phase_incr = base_freq * 2 * M_PI / (gyro_sample_hz * nsamples);
-                gyro_motor_phase[motor] = wrap_PI(gyro_motor_phase[motor] + phase_incr);
-            }
+        if (vibe_motor) {
+            add_motor_vibration(gyro, gyro_motor_phase, gyro_noise * sitl->vibe_motor_scale, sample_hz);
         }
 
-        Vector3f gyro {p, q, r};
-
-#if HAL_INS_TEMPERATURE_CAL_ENABLE
-        sitl->imu_tcal[gyro_instance].sitl_apply_gyro(get_temperature(), gyro);
-#endif
+        gyro += gyro_tcal;
 
-        // add in gyro scaling
-        const Vector3f &scale = sitl->gyro_scale[gyro_instance];
-        gyro.x *= (1 + scale.x * 0.01f);
-        gyro.y *= (1 + scale.y * 0.01f);
-        gyro.z *= (1 + scale.z * 0.01f);
+        gyro.x *= gyro_scale.x;
+        gyro.y *= gyro_scale.y;
+        gyro.z *= gyro_scale.z;
 
         gyro_accum += gyro;
         _notify_new_gyro_sensor_rate_sample(gyro_instance, gyro);
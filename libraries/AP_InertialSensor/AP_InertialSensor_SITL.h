@@ -30,6 +30,10 @@ private:
     float gyro_drift(void) const;
     void generate_accel();
     void generate_gyro();
+    float rand_noise(void);
+    float calculate_noise(float noise, float noise_variation);
+    void add_fixed_vibration(Vector3f &v, Vector3f &phase, float noise, float sample_hz);
+    void add_motor_vibration(Vector3f &v, float motor_phase[], float noise, float sample_hz);
     float get_temperature(void);
     void update_file();
 #if AP_SIM_INS_FILE_ENABLED
@@ -49,11 +53,12 @@ private:
     uint8_t accel_instance;
     uint64_t next_gyro_sample;
     uint64_t next_accel_sample;
-    float gyro_time;
-    float accel_time;
+    Vector3f gyro_vibe_phase;
+    Vector3f accel_vibe_phase;
     float gyro_motor_phase[32];
     float accel_motor_phase[32];
     uint32_t temp_start_ms;
+    uint32_t noise_state;
 #if AP_SIM_INS_FILE_ENABLED
     int gyro_fd = -1;
     int accel_fd = -1;
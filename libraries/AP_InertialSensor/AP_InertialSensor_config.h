@@ -10,3 +10,17 @@
 #ifndef AP_INERTIALSENSOR_BATCHSAMPLER_ENABLED
 #define AP_INERTIALSENSOR_BATCHSAMPLER_ENABLED (AP_INERTIALSENSOR_ENABLED && HAL_LOGGING_ENABLED)
 #endif
+
+#ifndef AP_INERTIALSENSOR_TIME_ALIGN_ENABLED
+#define AP_INERTIALSENSOR_TIME_ALIGN_ENABLED (AP_INERTIALSENSOR_ENABLED && HAL_MEM_CLASS >= HAL_MEM_CLASS_500)
+#endif
+
+// passing gyro samples to a rate loop thread needs a binary semaphore
+// from the HAL
+#ifndef AP_INERTIALSENSOR_RATE_LOOP_ENABLED
+#ifdef HAL_BinarySemaphore
+#define AP_INERTIALSENSOR_RATE_LOOP_ENABLED AP_INERTIALSENSOR_ENABLED
+#else
+#define AP_INERTIALSENSOR_RATE_LOOP_ENABLED 0
+#endif
+#endif
@@ -42,6 +42,25 @@ const AP_Param::GroupInfo AP_InertialSensor::BatchSampler::var_info[] = {
     // @Increment: 1
     AP_GROUPINFO("BAT_LGCT", 5, AP_InertialSensor::BatchSampler, samples_per_msg,   32),
 
+#if HAL_GCS_ENABLED
+    // @Param: BAT_STRM
+    // @DisplayName: batch sample streaming channel
+    // @Description: Stream batch samples live as DATA96 messages on this MAVLink channel instead of writing them to the log. This is the MAVLink channel number plus one, so 1 is the first MAVLink port. 0 writes to the log as normal
+    // @Range: 0 8
+    // @User: Advanced
+    AP_GROUPINFO("BAT_STRM", 6, AP_InertialSensor::BatchSampler, stream_chan, 0),
+
+    // @Param: BAT_STRM_BW
+    // @DisplayName: batch sample streaming bandwidth
+    // @Description: Maximum bandwidth used for streaming batch samples over MAVLink
+    // @Units: B/s
+    // @Range: 100 20000
+    // @Increment: 100
+    // @User: Advanced
+    AP_GROUPINFO("BAT_STRM_BW", 7, AP_InertialSensor::BatchSampler, stream_bandwidth, 2000),
+#endif
+
+
     AP_GROUPEND
 };
 
@@ -85,6 +104,12 @@ void AP_InertialSensor::BatchSampler::periodic()
     if (_sensor_mask == 0) {
         return;
     }
+#if HAL_GCS_ENABLED
+    if (streaming()) {
+        push_data_to_mavlink();
+        return;
+    }
+#endif
     push_data_to_log();
 }
 
@@ -197,22 +222,7 @@ void AP_InertialSensor::BatchSampler::push_data_to_log()
 
     // possibly send isb header:
     if (!isbh_sent && data_read_offset == 0) {
-        float sample_rate = 0; // avoid warning about uninitialised values
-        switch(type) {
-        case IMU_SENSOR_TYPE_GYRO:
-            sample_rate = _imu._gyro_raw_sample_rates[instance];
-            if (_doing_sensor_rate_logging) {
-                sample_rate *= _imu._gyro_over_sampling[instance];
-            }
-            break;
-        case IMU_SENSOR_TYPE_ACCEL:
-            sample_rate = _imu._accel_raw_sample_rates[instance];
-            if (_doing_sensor_rate_logging) {
-                sample_rate *= _imu._accel_over_sampling[instance];
-            }
-            break;
-        }
-        if (!Write_ISBH(sample_rate)) {
+        if (!Write_ISBH(sample_rate_hz())) {
             // buffer full?
             return;
         }
@@ -227,16 +237,144 @@ void AP_InertialSensor::BatchSampler::push_data_to_log()
     data_read_offset += samples_per_msg;
     last_sent_ms = AP_HAL::millis();
     if (data_read_offset >= _required_count) {
-        // that was the last one.  Clean up:
-        data_read_offset = 0;
-        isb_seqnum++;
-        isbh_sent = false;
-        // rotate to next instance:
-        rotate_to_next_sensor();
-        data_write_offset = 0; // unlocks writing process
+        finish_batch();
+    }
+}
+
+// called when all of a batch has been sent
+void AP_InertialSensor::BatchSampler::finish_batch()
+{
+    data_read_offset = 0;
+    isb_seqnum++;
+    isbh_sent = false;
+    // rotate to next instance:
+    rotate_to_next_sensor();
+    data_write_offset = 0; // unlocks writing process
+}
+
+// sample rate of the batch being collected
+float AP_InertialSensor::BatchSampler::sample_rate_hz() const
+{
+    float sample_rate = 0; // avoid warning about uninitialised values
+    switch(type) {
+    case IMU_SENSOR_TYPE_GYRO:
+        sample_rate = _imu._gyro_raw_sample_rates[instance];
+        if (_doing_sensor_rate_logging) {
+            sample_rate *= _imu._gyro_over_sampling[instance];
+        }
+        break;
+    case IMU_SENSOR_TYPE_ACCEL:
+        sample_rate = _imu._accel_raw_sample_rates[instance];
+        if (_doing_sensor_rate_logging) {
+            sample_rate *= _imu._accel_over_sampling[instance];
+        }
+        break;
     }
+    return sample_rate;
 }
 
+// instance number written for the batch, post-filter data from the
+// same IMU is given an instance number above the IMU count
+uint8_t AP_InertialSensor::BatchSampler::output_instance() const
+{
+    uint8_t instance_to_write = instance;
+    if (post_filter && (_doing_pre_post_filter_logging
+            || (_doing_post_filter_logging && _doing_sensor_rate_logging))) {
+        instance_to_write += (type == IMU_SENSOR_TYPE_ACCEL ? _imu._accel_count : _imu._gyro_count);
+    }
+    return instance_to_write;
+}
+
+#if HAL_GCS_ENABLED
+/*
+  stream the batch over MAVLink as DATA96 messages. A batch starts with
+  a header message, followed by data messages of interleaved x,y,z
+  samples, sent as quickly as the bandwidth limit allows
+ */
+void AP_InertialSensor::BatchSampler::push_data_to_mavlink()
+{
+    if (!initialised) {
+        return;
+    }
+    const mavlink_channel_t chan = mavlink_channel_t(stream_chan - 1);
+    if (gcs().chan(chan) == nullptr) {
+        return;
+    }
+
+    // the budget is in bytes on the link, allowing a short burst
+    const uint32_t now_ms = AP_HAL::millis();
+    const uint16_t packet_size = PAYLOAD_SIZE(chan, DATA96);
+    uint32_t elapsed_ms = now_ms - last_sent_ms;
+    if (elapsed_ms > 1000) {
+        elapsed_ms = 1000;
+    }
+    if (stream_bandwidth > 0) {
+        stream_budget += elapsed_ms * uint32_t(stream_bandwidth.get()) / 1000U;
+    }
+    if (stream_budget > 4U * packet_size) {
+        stream_budget = 4U * packet_size;
+    }
+    last_sent_ms = now_ms;
+
+    while (stream_budget >= packet_size && HAVE_PAYLOAD_SPACE(chan, DATA96)) {
+        uint8_t data[96] {};
+        if (!isbh_sent) {
+            if (data_write_offset == 0) {
+                // wait for the sample time of the first sample
+                return;
+            }
+            const struct PACKED {
+                uint64_t sample_us;
+                float sample_rate_hz;
+                uint16_t isb_seqno;
+                uint16_t sample_count;
+                uint16_t multiplier;
+                uint8_t sensor_type;
+                uint8_t instance;
+            } hdr {
+                measurement_started_us,
+                sample_rate_hz(),
+                isb_seqnum,
+                uint16_t(_required_count),
+                multiplier,
+                uint8_t(type),
+                output_instance(),
+            };
+            static_assert(sizeof(hdr) <= sizeof(data), "header must fit in DATA96");
+            memcpy(data, &hdr, sizeof(hdr));
+            mavlink_msg_data96_send(chan, MAV_DATA96_ISB_HEADER, sizeof(hdr), data);
+            isbh_sent = true;
+        } else {
+            // each data message has the batch and first sample number
+            // followed by up to 15 samples
+            const uint16_t max_samples = (sizeof(data) - 4) / 6;
+            uint16_t count = _required_count - data_read_offset;
+            if (count > max_samples) {
+                count = max_samples;
+            }
+            if (data_write_offset - data_read_offset < count) {
+                // the samples are not in yet
+                return;
+            }
+            memcpy(&data[0], &isb_seqnum, 2);
+            memcpy(&data[2], &data_read_offset, 2);
+            int16_t *xyz = (int16_t *)&data[4];
+            for (uint16_t i=0; i<count; i++) {
+                xyz[i*3+0] = data_x[data_read_offset+i];
+                xyz[i*3+1] = data_y[data_read_offset+i];
+                xyz[i*3+2] = data_z[data_read_offset+i];
+            }
+            mavlink_msg_data96_send(chan, MAV_DATA96_ISB_DATA, 4 + count*6, data);
+            data_read_offset += count;
+            if (data_read_offset >= _required_count) {
+                finish_batch();
+            }
+        }
+        stream_budget -= packet_size;
+    }
+}
+#endif  // HAL_GCS_ENABLED
+
 bool AP_InertialSensor::BatchSampler::should_log(uint8_t _instance, IMU_SENSOR_TYPE _type)
 {
     if (_sensor_mask == 0) {
@@ -254,6 +392,12 @@ bool AP_InertialSensor::BatchSampler::should_log(uint8_t _instance, IMU_SENSOR_T
     if (data_write_offset >= _required_count) {
         return false;
     }
+#if HAL_GCS_ENABLED
+    if (streaming()) {
+        // the samples are not logged so logging need not be active
+        return true;
+    }
+#endif
     AP_Logger *logger = AP_Logger::get_singleton();
     if (logger == nullptr) {
         return false;
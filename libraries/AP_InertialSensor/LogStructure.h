@@ -5,6 +5,8 @@
 #define LOG_IDS_FROM_INERTIALSENSOR \
     LOG_ACC_MSG, \
     LOG_GYR_MSG, \
+    LOG_ACCH_MSG, \
+    LOG_GYRH_MSG, \
     LOG_IMU_MSG, \
     LOG_ISBH_MSG, \
     LOG_ISBD_MSG, \
@@ -42,6 +44,38 @@ struct PACKED log_GYR {
     float GyrX, GyrY, GyrZ;
 };
 
+// @LoggerMessage: ACCH
+// @Description: Compact version of ACC with half precision fields, logged instead of ACC when enabled with LOG_COMPACT
+// @Field: TimeUS: Time since system startup
+// @Field: I: accelerometer sensor instance number
+// @Field: SampleUS: time since system startup this sample was taken
+// @Field: AccX: acceleration along X axis
+// @Field: AccY: acceleration along Y axis
+// @Field: AccZ: acceleration along Z axis
+struct PACKED log_ACCH {
+    LOG_PACKET_HEADER;
+    uint64_t time_us;
+    uint8_t instance;
+    uint64_t sample_us;
+    Float16_t AccX, AccY, AccZ;
+};
+
+// @LoggerMessage: GYRH
+// @Description: Compact version of GYR with half precision fields, logged instead of GYR when enabled with LOG_COMPACT
+// @Field: TimeUS: Time since system startup
+// @Field: I: gyroscope sensor instance number
+// @Field: SampleUS: time since system startup this sample was taken
+// @Field: GyrX: measured rotation rate about X axis
+// @Field: GyrY: measured rotation rate about Y axis
+// @Field: GyrZ: measured rotation rate about Z axis
+struct PACKED log_GYRH {
+    LOG_PACKET_HEADER;
+    uint64_t time_us;
+    uint8_t instance;
+    uint64_t sample_us;
+    Float16_t GyrX, GyrY, GyrZ;
+};
+
 // @LoggerMessage: IMU
 // @Description: Inertial Measurement Unit data
 // @Field: TimeUS: Time since system startup
@@ -116,6 +150,10 @@ struct PACKED log_Vibe {
       "ACC", "QBQfff",        "TimeUS,I,SampleUS,AccX,AccY,AccZ", "s#sooo", "F-F000" , true }, \
     { LOG_GYR_MSG, sizeof(log_GYR), \
       "GYR", "QBQfff",        "TimeUS,I,SampleUS,GyrX,GyrY,GyrZ", "s#sEEE", "F-F000" , true }, \
+    { LOG_ACCH_MSG, sizeof(log_ACCH), \
+      "ACCH", "QBQggg",        "TimeUS,I,SampleUS,AccX,AccY,AccZ", "s#sooo", "F-F000" , true }, \
+    { LOG_GYRH_MSG, sizeof(log_GYRH), \
+      "GYRH", "QBQggg",        "TimeUS,I,SampleUS,GyrX,GyrY,GyrZ", "s#sEEE", "F-F000" , true }, \
     { LOG_IMU_MSG, sizeof(log_IMU), \
       "IMU",  "QBffffffIIfBBHH", "TimeUS,I,GyrX,GyrY,GyrZ,AccX,AccY,AccZ,EG,EA,T,GH,AH,GHz,AHz", "s#EEEooo--O--zz", "F-000000-----00" , true }, \
     { LOG_VIBE_MSG, sizeof(log_Vibe), \
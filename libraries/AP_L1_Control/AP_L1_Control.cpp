@@ -225,8 +225,15 @@ void AP_L1_Control::update_waypoint(const struct Location &prev_WP, const struct
 
     Vector2f _groundspeed_vector = _ahrs.groundspeed_vector();
 
+    // the leg geometry is only recalculated when the waypoints move
+    _leg.set(prev_WP, next_WP);
+
+    // Calculate the NE position of the aircraft relative to WP A and WP B
+    const Vector2f A_air = _leg.from_origin_NE(_current_loc);
+    const Vector2f B_air = A_air - _leg.get_vector_NE();
+
     // update _target_bearing_cd
-    _target_bearing_cd = _current_loc.get_bearing_to(next_WP);
+    _target_bearing_cd = int32_t(wrap_2PI(atan2F(-B_air.y, -B_air.x)) * DEGX100 + 0.5);
 
     //Calculate groundspeed
     float groundSpeed = _groundspeed_vector.length();
@@ -242,22 +249,19 @@ void AP_L1_Control::update_waypoint(const struct Location &prev_WP, const struct
     // 0.3183099 = 1/1/pipi
     _L1_dist = MAX(0.3183099f * _L1_damping * _L1_period * groundSpeed, dist_min);
 
-    // Calculate the NE position of WP B relative to WP A
-    Vector2f AB = prev_WP.get_distance_NE(next_WP);
-    float AB_length = AB.length();
+    // Unit vector from WP A to WP B
+    Vector2f AB = _leg.get_unit_NE();
+    const float AB_length = _leg.get_length();
 
     // Check for AB zero length and track directly to the destination
     // if too small
-    if (AB.length() < 1.0e-6f) {
-        AB = _current_loc.get_distance_NE(next_WP);
+    if (_leg.is_zero_length()) {
+        AB = -B_air;
         if (AB.length() < 1.0e-6f) {
             AB = Vector2f(cosf(get_yaw()), sinf(get_yaw()));
         }
+        AB.normalize();
     }
-    AB.normalize();
-
-    // Calculate the NE position of the aircraft relative to WP A
-    const Vector2f A_air = prev_WP.get_distance_NE(_current_loc);
 
     // calculate distance to target track, for reporting
     _crosstrack_error = A_air % AB;
@@ -273,23 +277,22 @@ void AP_L1_Control::update_waypoint(const struct Location &prev_WP, const struct
         Vector2f A_air_unit = (A_air).normalized(); // Unit vector from WP A to aircraft
         xtrackVel = _groundspeed_vector % (-A_air_unit); // Velocity across line
         ltrackVel = _groundspeed_vector * (-A_air_unit); // Velocity along line
-        Nu = atan2f(xtrackVel,ltrackVel);
-        _nav_bearing = atan2f(-A_air_unit.y , -A_air_unit.x); // bearing (radians) from AC to L1 point
+        Nu = fast_atan2f(xtrackVel,ltrackVel);
+        _nav_bearing = fast_atan2f(-A_air_unit.y , -A_air_unit.x); // bearing (radians) from AC to L1 point
     } else if (alongTrackDist > AB_length + groundSpeed*3) {
         // we have passed point B by 3 seconds. Head towards B
         // Calc Nu to fly To WP B
-        const Vector2f B_air = next_WP.get_distance_NE(_current_loc);
         Vector2f B_air_unit = (B_air).normalized(); // Unit vector from WP B to aircraft
         xtrackVel = _groundspeed_vector % (-B_air_unit); // Velocity across line
         ltrackVel = _groundspeed_vector * (-B_air_unit); // Velocity along line
-        Nu = atan2f(xtrackVel,ltrackVel);
-        _nav_bearing = atan2f(-B_air_unit.y , -B_air_unit.x); // bearing (radians) from AC to L1 point
+        Nu = fast_atan2f(xtrackVel,ltrackVel);
+        _nav_bearing = fast_atan2f(-B_air_unit.y , -B_air_unit.x); // bearing (radians) from AC to L1 point
     } else { //Calc Nu to fly along AB line
 
         //Calculate Nu2 angle (angle of velocity vector relative to line connecting waypoints)
         xtrackVel = _groundspeed_vector % AB; // Velocity cross track
         ltrackVel = _groundspeed_vector * AB; // Velocity along track
-        float Nu2 = atan2f(xtrackVel,ltrackVel);
+        float Nu2 = fast_atan2f(xtrackVel,ltrackVel);
         //Calculate Nu1 angle (Angle to L1 reference point)
         float sine_Nu1 = _crosstrack_error/MAX(_L1_dist, 0.1f);
         //Limit sine of Nu1 to provide a controlled track capture angle of 45 deg
@@ -313,7 +316,8 @@ void AP_L1_Control::update_waypoint(const struct Location &prev_WP, const struct
         Nu1 += _L1_xtrack_i;
 
         Nu = Nu1 + Nu2;
-        _nav_bearing = wrap_PI(atan2f(AB.y, AB.x) + Nu1);   // bearing (radians) from AC to L1 point
+        const float AB_bearing = _leg.is_zero_length() ? fast_atan2f(AB.y, AB.x) : _leg.get_bearing();
+        _nav_bearing = wrap_PI(AB_bearing + Nu1);   // bearing (radians) from AC to L1 point
     }
 
     _prevent_indecision(Nu);
@@ -391,7 +395,7 @@ void AP_L1_Control::update_loiter(const struct Location &center_WP, float radius
     //Calculate Nu to capture center_WP
     float xtrackVelCap = A_air_unit % _groundspeed_vector; // Velocity across line - perpendicular to radial inbound to WP
     float ltrackVelCap = - (_groundspeed_vector * A_air_unit); // Velocity along line - radial inbound to WP
-    float Nu = atan2f(xtrackVelCap,ltrackVelCap);
+    float Nu = fast_atan2f(xtrackVelCap,ltrackVelCap);
 
     _prevent_indecision(Nu);
     _last_Nu = Nu;
@@ -432,12 +436,12 @@ void AP_L1_Control::update_loiter(const struct Location &center_WP, float radius
         _latAccDem = latAccDemCap;
         _WPcircle = false;
         _bearing_error = Nu; // angle between demanded and achieved velocity vector, +ve to left of track
-        _nav_bearing = atan2f(-A_air_unit.y , -A_air_unit.x); // bearing (radians) from AC to L1 point
+        _nav_bearing = fast_atan2f(-A_air_unit.y , -A_air_unit.x); // bearing (radians) from AC to L1 point
     } else {
         _latAccDem = latAccDemCirc;
         _WPcircle = true;
         _bearing_error = 0.0f; // bearing error (radians), +ve to left of track
-        _nav_bearing = atan2f(-A_air_unit.y , -A_air_unit.x); // bearing (radians)from AC to L1 point
+        _nav_bearing = fast_atan2f(-A_air_unit.y , -A_air_unit.x); // bearing (radians)from AC to L1 point
     }
 
     _data_is_stale = false; // status are correctly updated with current waypoint data
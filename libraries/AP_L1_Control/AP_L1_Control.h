@@ -104,6 +104,9 @@ private:
     // target bearing in centi-degrees from last update
     int32_t _target_bearing_cd;
 
+    // geometry of the waypoint leg from the last update_waypoint()
+    LocationLeg _leg;
+
     // L1 tracking loop period (sec)
     AP_Float _L1_period;
     // L1 tracking loop damping ratio
@@ -8,6 +8,8 @@
 #include "AP_Logger_DataFlash.h"
 #include "AP_Logger_W25N01GV.h"
 #include "AP_Logger_MAVLink.h"
+#include "AP_Logger_Stream.h"
+#include "AP_Logger_WriteBuffer.h"
 
 #include <AP_InternalError/AP_InternalError.h>
 #include <GCS_MAVLink/GCS.h>
@@ -43,6 +45,10 @@ extern const AP_HAL::HAL& hal;
 #define HAL_LOGGING_MAV_BUFSIZE  8
 #endif 
 
+#ifndef HAL_LOGGING_STREAM_BUFSIZE
+#define HAL_LOGGING_STREAM_BUFSIZE 32
+#endif
+
 #ifndef HAL_LOGGING_FILE_TIMEOUT
 #define HAL_LOGGING_FILE_TIMEOUT 5
 #endif 
@@ -78,7 +84,7 @@ const AP_Param::GroupInfo AP_Logger::var_info[] = {
     // @Param: _BACKEND_TYPE
     // @DisplayName: AP_Logger Backend Storage type
     // @Description: Bitmap of what Logger backend types to enable. Block-based logging is available on SITL and boards with dataflash chips. Multiple backends can be selected.
-    // @Bitmask: 0:File,1:MAVLink,2:Block
+    // @Bitmask: 0:File,1:MAVLink,2:Block,3:Companion stream
     // @User: Standard
     AP_GROUPINFO("_BACKEND_TYPE",  0, AP_Logger, _params.backend_types,       uint8_t(HAL_LOGGING_BACKENDS_DEFAULT)),
 
@@ -163,6 +169,39 @@ const AP_Param::GroupInfo AP_Logger::var_info[] = {
     // @User: Standard
     AP_GROUPINFO("_BLK_RATEMAX", 10, AP_Logger, _params.blk_ratemax, 0),
 #endif
+
+#if HAL_LOGGER_COMPRESSION_ENABLED
+    // @Param: _FILE_COMPR
+    // @DisplayName: Compress file backend logs
+    // @Description: When set, logs written by the file backend are LZ4 compressed in blocks, reducing the amount of data written to the SD card. Compressed logs must be decompressed with Tools/scripts/decompress_log.py before being used with ground station tools that do not support them. Takes effect when the next log is opened.
+    // @Values: 0:Disabled,1:LZ4
+    // @User: Advanced
+    AP_GROUPINFO("_FILE_COMPR", 11, AP_Logger, _params.file_compress, 0),
+#endif
+
+    // @Param: _FILE_RATEGOV
+    // @DisplayName: Logging rate governor for file backend
+    // @Description: When enabled, streaming log messages are shed by priority when the file backend write buffer backs up because the storage can't keep up. High rate messages such as IMU and RATE are shed first and ATT and EKF messages last, and each change of level is recorded in an LGOV message. When disabled, messages are dropped wherever the buffer happens to be full.
+    // @Values: 0:Disabled,1:Enabled
+    // @User: Advanced
+    AP_GROUPINFO("_FILE_RATEGOV", 12, AP_Logger, _params.file_rate_gov, 1),
+
+#if HAL_LOGGING_STREAM_ENABLED
+    // @Param: _STRM_BUFSIZE
+    // @DisplayName: Companion stream buffer size
+    // @Description: Buffer size in kilobytes for the companion computer stream backend. Log blocks are held in this buffer until the companion acknowledges them, so it bounds the data in flight and how long a link outage can be ridden through. The stream is sent on the serial port with the Logging stream protocol, which may be a high speed UART or a UDP port.
+    // @User: Advanced
+    // @Units: kB
+    // @Range: 8 256
+    AP_GROUPINFO("_STRM_BUFSIZE", 13, AP_Logger, _params.stream_bufsize, HAL_LOGGING_STREAM_BUFSIZE),
+#endif
+
+    // @Param: _COMPACT
+    // @DisplayName: Compact high rate messages
+    // @Description: Log compact variants of the selected high rate messages, which use half precision floats to about halve their size. RATE is replaced by RATH, and GYR and ACC by GYRH and ACCH. Half precision keeps about three significant figures, which is enough for tuning and vibration analysis. Log analysis tools need to understand the 'g' field type to read these messages.
+    // @Bitmask: 0:RATE,1:Raw IMU (GYR and ACC)
+    // @User: Advanced
+    AP_GROUPINFO("_COMPACT", 14, AP_Logger, _params.compact, 0),
     
     AP_GROUPEND
 };
@@ -211,6 +250,9 @@ void AP_Logger::Init(const struct LogStructure *structures, uint8_t num_types)
 #if HAL_LOGGING_MAVLINK_ENABLED
         { Backend_Type::MAVLINK, AP_Logger_MAVLink::probe },
 #endif
+#if HAL_LOGGING_STREAM_ENABLED
+        { Backend_Type::STREAM, AP_Logger_Stream::probe },
+#endif
 };
 
     for (const auto &backend_config : backend_configs) {
@@ -233,6 +275,21 @@ void AP_Logger::Init(const struct LogStructure *structures, uint8_t num_types)
         _next_backend++;
     }
 
+#if HAL_LOGGER_SHARED_BUFFER_ENABLED
+    // with both File and Block backends each message is stored once
+    // in a buffer they share
+    const uint8_t shared_types = uint8_t(Backend_Type::FILESYSTEM) | uint8_t(Backend_Type::BLOCK);
+    if ((_params.backend_types & shared_types) == shared_types) {
+        _shared_writebuf = new AP_Logger_SharedBuffer();
+        if (_shared_writebuf == nullptr) {
+            AP_BoardConfig::allocation_error("logger buffer");
+        }
+        for (uint8_t i=0; i<_next_backend; i++) {
+            backends[i]->share_writebuf(_shared_writebuf, i);
+        }
+    }
+#endif
+
     for (uint8_t i=0; i<_next_backend; i++) {
         backends[i]->Init();
     }
@@ -993,20 +1050,70 @@ void AP_Logger::WriteV(const char *name, const char *labels, const char *units,
         return;
     }
 
+    WriteV(*f, arg_list, is_critical, is_streaming);
+}
+
+void AP_Logger::WriteV(log_write_fmt &f, va_list arg_list, bool is_critical, bool is_streaming)
+{
     for (uint8_t i=0; i<_next_backend; i++) {
-        if (!(f->sent_mask & (1U<<i))) {
-            if (!backends[i]->Write_Emit_FMT(f->msg_type)) {
+        if (!(f.sent_mask & (1U<<i))) {
+            if (!backends[i]->Write_Emit_FMT(f.msg_type)) {
                 continue;
             }
-            f->sent_mask |= (1U<<i);
+            f.sent_mask |= (1U<<i);
         }
         va_list arg_copy;
         va_copy(arg_copy, arg_list);
-        backends[i]->Write(f->msg_type, arg_copy, is_critical, is_streaming);
+        backends[i]->Write(f, arg_copy, is_critical, is_streaming);
         va_end(arg_copy);
     }
 }
 
+void AP_Logger::Write(LogFormatHandle *handle, ...)
+{
+    va_list arg_list;
+
+    va_start(arg_list, handle);
+    WriteV(*handle, arg_list);
+    va_end(arg_list);
+}
+
+void AP_Logger::WriteStreaming(LogFormatHandle *handle, ...)
+{
+    va_list arg_list;
+
+    va_start(arg_list, handle);
+    WriteV(*handle, arg_list, false, true);
+    va_end(arg_list);
+}
+
+void AP_Logger::WriteCritical(LogFormatHandle *handle, ...)
+{
+    va_list arg_list;
+
+    va_start(arg_list, handle);
+    WriteV(*handle, arg_list, true);
+    va_end(arg_list);
+}
+
+void AP_Logger::WriteV(LogFormatHandle &handle, va_list arg_list, bool is_critical, bool is_streaming)
+{
+#if APM_BUILD_TYPE(APM_BUILD_Replay)
+    // message types may be re-used in replay, so look up every time
+    WriteV(handle.name, handle.labels, handle.units, handle.mults, handle.fmt, arg_list, is_critical, is_streaming);
+#else
+    if (handle.f == nullptr) {
+        // formats are never freed, so this stays valid
+        handle.f = msg_fmt_for_name(handle.name, handle.labels, handle.units, handle.mults, handle.fmt);
+        if (handle.f == nullptr) {
+            INTERNAL_ERROR(AP_InternalError::error_t::logger_mapfailure);
+            return;
+        }
+    }
+    WriteV(*handle.f, arg_list, is_critical, is_streaming);
+#endif
+}
+
 /*
   when we are doing replay logging we want to delay start of the EKF
   until after the headers are out so that on replay all parameter
@@ -1321,6 +1428,7 @@ int16_t AP_Logger::Write_calc_msg_len(const char *fmt) const
         case 'd' : len += sizeof(double); break;
         case 'e' : len += sizeof(int32_t); break;
         case 'f' : len += sizeof(float); break;
+        case 'g' : len += sizeof(Float16_t); break;
         case 'h' : len += sizeof(int16_t); break;
         case 'i' : len += sizeof(int32_t); break;
         case 'n' : len += sizeof(char[4]); break;
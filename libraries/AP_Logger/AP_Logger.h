@@ -21,6 +21,7 @@
 #include "LoggerMessageWriter.h"
 
 class AP_Logger_Backend;
+class AP_Logger_SharedBuffer;
 
 // do not do anything here apart from add stuff; maintaining older
 // entries means log analysis is easier
@@ -307,12 +308,22 @@ public:
     // number of blocks that have been dropped
     uint32_t num_dropped(void) const;
 
+    // the structure for a message type, or nullptr if there is none
+    const struct LogStructure *structure_for_msg_type(uint8_t msg_type) const;
+
     // access to public parameters
     void set_force_log_disarmed(bool force_logging) { _force_log_disarmed = force_logging; }
     void set_long_log_persist(bool b) { _force_long_log_persist = b; }
     bool log_while_disarmed(void) const;
     uint8_t log_replay(void) const { return _params.log_replay; }
 
+    // messages with a compact variant, see LOG_COMPACT
+    enum class Compact : uint8_t {
+        RATE    = 1U<<0,
+        RAW_IMU = 1U<<1,
+    };
+    bool compact(Compact msg) const { return (_params.compact & uint8_t(msg)) != 0; }
+
     vehicle_startup_message_Writer _vehicle_messages;
 
     // parameter support
@@ -329,6 +340,10 @@ public:
         AP_Float file_ratemax;
         AP_Float mav_ratemax;
         AP_Float blk_ratemax;
+        AP_Int8 file_compress;
+        AP_Int8 file_rate_gov;
+        AP_Int16 stream_bufsize; // in kilobytes
+        AP_Int8 compact;
     } _params;
 
     const struct LogStructure *structure(uint16_t num) const;
@@ -382,12 +397,38 @@ public:
         const char *mults;
     } *log_write_fmts;
 
+    /*
+      the format of a message written from one place in the code,
+      declared static there with the strings as constants:
+
+        static AP_Logger::LogFormatHandle fmt { "NAME", "TimeUS,Val", "s-", "F-", "Qf" };
+        logger.Write(&fmt, AP_HAL::micros64(), val);
+
+      The message type is found on the first write and kept in the
+      handle, so later writes skip the lookup by name
+     */
+    struct LogFormatHandle {
+        const char *name;
+        const char *labels;
+        const char *units;
+        const char *mults;
+        const char *fmt;
+        struct log_write_fmt *f;
+    };
+    void Write(LogFormatHandle *handle, ...);
+    void WriteStreaming(LogFormatHandle *handle, ...);
+    void WriteCritical(LogFormatHandle *handle, ...);
+
     // return (possibly allocating) a log_write_fmt for a name
     struct log_write_fmt *msg_fmt_for_name(const char *name, const char *labels, const char *units, const char *mults, const char *fmt, const bool direct_comp = false, const bool copy_strings = false);
 
     // output a FMT message for each backend if not already done so
     void Safe_Write_Emit_FMT(log_write_fmt *f);
 
+    // write a message of a known format to each backend
+    void WriteV(log_write_fmt &f, va_list arg_list, bool is_critical=false, bool is_streaming=false);
+    void WriteV(LogFormatHandle &handle, va_list arg_list, bool is_critical=false, bool is_streaming=false);
+
     // get count of number of times we have started logging
     uint8_t get_log_start_count(void) const {
         return _log_start_count;
@@ -412,16 +453,25 @@ protected:
                                bool is_critical);
 
 private:
+#if HAL_LOGGING_STREAM_ENABLED
+    #define LOGGER_MAX_BACKENDS 3
+#else
     #define LOGGER_MAX_BACKENDS 2
+#endif
     uint8_t _next_backend;
     AP_Logger_Backend *backends[LOGGER_MAX_BACKENDS];
     const AP_Int32 &_log_bitmask;
+#if HAL_LOGGER_SHARED_BUFFER_ENABLED
+    // write buffer shared by the File and Block backends
+    AP_Logger_SharedBuffer *_shared_writebuf;
+#endif
 
     enum class Backend_Type : uint8_t {
         NONE       = 0,
         FILESYSTEM = (1<<0),
         MAVLINK    = (1<<1),
         BLOCK      = (1<<2),
+        STREAM     = (1<<3),
     };
 
     /*
@@ -433,8 +483,6 @@ private:
     // return (possibly allocating) a log_write_fmt for a name
     const struct log_write_fmt *log_write_fmt_for_msg_type(uint8_t msg_type) const;
 
-    const struct LogStructure *structure_for_msg_type(uint8_t msg_type) const;
-
     // return a msg_type which is not currently in use (or -1 if none available)
     int16_t find_free_msg_type() const;
 
@@ -556,6 +604,26 @@ private:
     // start page of log data
     uint32_t _log_data_page;
 
+    // further windows of the log requested by the GCS while sending,
+    // sent in order once the current window is complete
+    static const uint8_t LOG_DATA_MAX_WINDOWS = 4;
+    struct log_data_window {
+        uint32_t ofs;
+        uint32_t count;
+    } _log_data_windows[LOG_DATA_MAX_WINDOWS];
+    uint8_t _log_data_num_windows;
+
+    // bytes we may send in a burst on a link without flow control
+    uint32_t _log_send_budget;
+    uint32_t _log_send_budget_ms;
+
+#if HAL_LOGGER_MAVLINK_READ_AHEAD > 0
+    // log data read ahead of the packets being sent
+    uint8_t *_log_read_ahead;
+    uint32_t _log_read_ahead_ofs;
+    uint16_t _log_read_ahead_len;
+#endif
+
     GCS_MAVLINK *_log_sending_link;
     HAL_Semaphore _log_send_sem;
 
@@ -575,6 +643,10 @@ private:
     void handle_log_send_listing(); // handle LISTING state
     void handle_log_sending(); // handle SENDING state
     bool handle_log_send_data(); // send data chunk to client
+    void start_log_data_window(uint32_t ofs, uint32_t count);
+    bool queue_log_data_window(uint32_t ofs, uint32_t count);
+    uint8_t log_send_budget_count();
+    int16_t read_log_download_data(uint32_t ofs, uint16_t len, uint8_t *data);
 
     void get_log_info(uint16_t log_num, uint32_t &size, uint32_t &time_utc);
 
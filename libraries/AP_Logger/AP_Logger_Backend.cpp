@@ -212,23 +212,23 @@ bool AP_Logger_Backend::Write_Emit_FMT(uint8_t msg_type)
 
 bool AP_Logger_Backend::Write(const uint8_t msg_type, va_list arg_list, bool is_critical, bool is_streaming)
 {
-    // stack-allocate a buffer so we can WriteBlock(); this could be
-    // 255 bytes!  If we were willing to lose the WriteBlock
-    // abstraction we could do WriteBytes() here instead?
-    const char *fmt  = nullptr;
-    uint8_t msg_len;
-    AP_Logger::log_write_fmt *f;
+    const AP_Logger::log_write_fmt *f;
     for (f = _front.log_write_fmts; f; f=f->next) {
         if (f->msg_type == msg_type) {
-            fmt = f->fmt;
-            msg_len = f->msg_len;
-            break;
+            return Write(*f, arg_list, is_critical, is_streaming);
         }
     }
-    if (fmt == nullptr) {
-        INTERNAL_ERROR(AP_InternalError::error_t::logger_logwrite_missingfmt);
-        return false;
-    }
+    INTERNAL_ERROR(AP_InternalError::error_t::logger_logwrite_missingfmt);
+    return false;
+}
+
+bool AP_Logger_Backend::Write(const AP_Logger::log_write_fmt &f, va_list arg_list, bool is_critical, bool is_streaming)
+{
+    // stack-allocate a buffer so we can WriteBlock(); this could be
+    // 255 bytes!  If we were willing to lose the WriteBlock
+    // abstraction we could do WriteBytes() here instead?
+    const char *fmt = f.fmt;
+    const uint8_t msg_len = f.msg_len;
     if (bufferspace_available() < msg_len) {
         return false;
     }
@@ -237,8 +237,8 @@ bool AP_Logger_Backend::Write(const uint8_t msg_type, va_list arg_list, bool is_
     uint8_t offset = 0;
     buffer[offset++] = HEAD_BYTE1;
     buffer[offset++] = HEAD_BYTE2;
-    buffer[offset++] = msg_type;
-    for (uint8_t i=0; i<strlen(fmt); i++) {
+    buffer[offset++] = f.msg_type;
+    for (uint8_t i=0; fmt[i] != 0; i++) {
         uint8_t charlen = 0;
         switch(fmt[i]) {
         case 'b': {
@@ -274,6 +274,13 @@ bool AP_Logger_Backend::Write(const uint8_t msg_type, va_list arg_list, bool is_
             offset += sizeof(float);
             break;
         }
+        case 'g': {
+            Float16_t tmp;
+            tmp.set(va_arg(arg_list, double));
+            memcpy(&buffer[offset], &tmp, sizeof(Float16_t));
+            offset += sizeof(Float16_t);
+            break;
+        }
         case 'n':
             charlen = 4;
             break;
@@ -425,6 +432,17 @@ bool AP_Logger_Backend::WritePrioritisedBlock(const void *pBuffer, uint16_t size
     return _WritePrioritisedBlock(pBuffer, size, is_critical);
 }
 
+uint16_t AP_Logger_Backend::WriteCriticalBlocks(const void *pBuffer, uint16_t size, uint16_t count)
+{
+    const uint8_t *buf = (const uint8_t *)pBuffer;
+    for (uint16_t i=0; i<count; i++) {
+        if (!WriteCriticalBlock(&buf[i*size], size)) {
+            return i;
+        }
+    }
+    return count;
+}
+
 bool AP_Logger_Backend::ShouldLog(bool is_critical)
 {
     if (!_front.WritesEnabled()) {
@@ -645,6 +663,22 @@ void AP_Logger_Backend::Write_AP_Logger_Stats_File(const struct df_stats &_stats
     WriteBlock(&pkt, sizeof(pkt));
 }
 
+void AP_Logger_Backend::Write_Rate_Governor(uint8_t fill_pct, uint32_t write_rate)
+{
+    if (rate_limiter == nullptr) {
+        return;
+    }
+    const struct log_LGOV pkt {
+        LOG_PACKET_HEADER_INIT(LOG_RATE_GOV_MSG),
+        time_us         : AP_HAL::micros64(),
+        level           : rate_limiter->governor_level(),
+        fill_pct        : fill_pct,
+        write_rate      : write_rate,
+        shed            : rate_limiter->governor_shed_count(),
+    };
+    WriteCriticalBlock(&pkt, sizeof(pkt));
+}
+
 void AP_Logger_Backend::df_stats_gather(const uint16_t bytes_written, uint32_t space_remaining)
 {
     if (space_remaining < stats.buf_space_min) {
@@ -686,7 +720,7 @@ bool AP_Logger_RateLimiter::should_log_streaming(uint8_t msgid)
     }
     const uint16_t now = AP_HAL::millis16();
     uint16_t delta_ms = now - last_send_ms[msgid];
-    if (delta_ms < 1000.0 / rate_limit_hz.get()) {
+    if (rate_limit_hz > 0 && delta_ms < 1000.0 / rate_limit_hz.get()) {
         // too soon
         return false;
     }
@@ -700,8 +734,8 @@ bool AP_Logger_RateLimiter::should_log_streaming(uint8_t msgid)
  */
 bool AP_Logger_RateLimiter::should_log(uint8_t msgid, bool writev_streaming)
 {
-    if (rate_limit_hz <= 0 && !front._log_pause) {
-        // no rate limiting if not paused and rate is zero(user changed the parameter)
+    if (rate_limit_hz <= 0 && !front._log_pause && gov.level == 0) {
+        // no rate limiting if not paused, rate is zero(user changed the parameter) and the governor is idle
         return true;
     }
     if (last_send_ms[msgid] == 0 && !writev_streaming) {
@@ -729,6 +763,9 @@ bool AP_Logger_RateLimiter::should_log(uint8_t msgid, bool writev_streaming)
 #endif
 
     bool ret = should_log_streaming(msgid);
+    if (ret && gov.level > 0 && governor_shed(msgid)) {
+        ret = false;
+    }
     if (ret) {
         last_return.set(msgid);
     } else {
@@ -736,3 +773,111 @@ bool AP_Logger_RateLimiter::should_log(uint8_t msgid, bool writev_streaming)
     }
     return ret;
 }
+
+// buffer fill levels at which the governor steps its level up and down
+#define LOGGER_RATE_GOV_HIGH_PCT 60
+#define LOGGER_RATE_GOV_FULL_PCT 85
+#define LOGGER_RATE_GOV_LOW_PCT  25
+// level at which each class starts to be shed, and the top level
+#define LOGGER_RATE_GOV_NORMAL_LEVEL 3
+#define LOGGER_RATE_GOV_LAST_LEVEL   5
+#define LOGGER_RATE_GOV_MAX_LEVEL    6
+// minimum time between steps up, and time the buffer must stay
+// below LOGGER_RATE_GOV_LOW_PCT before each step down
+#define LOGGER_RATE_GOV_UP_MS   500
+#define LOGGER_RATE_GOV_DOWN_MS 2000
+
+/*
+  called at 10Hz by the backend. The buffer filling up means the
+  messages are arriving faster than the backend can write them out,
+  so step up while it is above the high threshold and still filling,
+  or nearly full. Step back down once it has drained and stayed low
+ */
+bool AP_Logger_RateLimiter::update_governor(uint8_t fill_pct)
+{
+    const uint32_t now_ms = AP_HAL::millis();
+    const bool filling = fill_pct > gov.last_fill_pct;
+    gov.last_fill_pct = fill_pct;
+
+    if (fill_pct > LOGGER_RATE_GOV_LOW_PCT) {
+        gov.last_busy_ms = now_ms;
+    }
+
+    if (fill_pct >= LOGGER_RATE_GOV_FULL_PCT ||
+        (fill_pct >= LOGGER_RATE_GOV_HIGH_PCT && filling)) {
+        if (gov.level < LOGGER_RATE_GOV_MAX_LEVEL &&
+            now_ms - gov.change_ms >= LOGGER_RATE_GOV_UP_MS) {
+            gov.level++;
+            gov.change_ms = now_ms;
+            return true;
+        }
+    } else if (gov.level > 0 &&
+               now_ms - gov.last_busy_ms >= LOGGER_RATE_GOV_DOWN_MS &&
+               now_ms - gov.change_ms >= LOGGER_RATE_GOV_DOWN_MS) {
+        gov.level--;
+        gov.change_ms = now_ms;
+        return true;
+    }
+    return false;
+}
+
+uint32_t AP_Logger_RateLimiter::governor_shed_count()
+{
+    const uint32_t ret = gov.shed;
+    gov.shed = 0;
+    return ret;
+}
+
+// streaming messages shed first and last by the governor, matched on
+// the start of the message name
+static const char *const governor_shed_first_names[] = {
+    "IMU", "GYR", "ACC", "RATE", "RATH", "PID", "ISB",
+};
+static const char *const governor_shed_last_names[] = {
+    "ATT", "XKF", "NKF", "AHR2", "POS", "GPS", "BAT",
+};
+
+static bool governor_name_match(const char *name, const char *const *names, uint8_t num_names)
+{
+    for (uint8_t i=0; i<num_names; i++) {
+        if (strncmp(name, names[i], strlen(names[i])) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/*
+  decimate a message by a power of two depending on the level and its
+  class
+ */
+bool AP_Logger_RateLimiter::governor_shed(uint8_t msgid)
+{
+    if (!gov.classified.get(msgid)) {
+        gov.classified.set(msgid);
+        const auto *mtype = front.structure_for_msg_type(msgid);
+        if (mtype != nullptr) {
+            if (governor_name_match(mtype->name, governor_shed_first_names, ARRAY_SIZE(governor_shed_first_names))) {
+                gov.shed_first.set(msgid);
+            } else if (governor_name_match(mtype->name, governor_shed_last_names, ARRAY_SIZE(governor_shed_last_names))) {
+                gov.shed_last.set(msgid);
+            }
+        }
+    }
+
+    uint8_t start_level = LOGGER_RATE_GOV_NORMAL_LEVEL;
+    if (gov.shed_first.get(msgid)) {
+        start_level = 1;
+    } else if (gov.shed_last.get(msgid)) {
+        start_level = LOGGER_RATE_GOV_LAST_LEVEL;
+    }
+    if (gov.level < start_level) {
+        return false;
+    }
+    const uint8_t mask = (1U << (gov.level - start_level + 1)) - 1;
+    if ((gov.count[msgid]++ & mask) == 0) {
+        return false;
+    }
+    gov.shed++;
+    return true;
+}
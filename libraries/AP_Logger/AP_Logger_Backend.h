@@ -18,10 +18,41 @@ public:
     bool should_log(uint8_t msgid, bool writev_streaming);
     bool should_log_streaming(uint8_t msgid);
 
+    // update the rate governor from the percentage of the backend
+    // write buffer in use, returning true if its level changed
+    bool update_governor(uint8_t fill_pct);
+    uint8_t governor_level() const { return gov.level; }
+
+    // number of messages shed by the governor since the last call
+    uint32_t governor_shed_count();
+
 private:
     const AP_Logger &front;
     const AP_Float &rate_limit_hz;
 
+    // return true if the governor sheds this instance of a message
+    bool governor_shed(uint8_t msgid);
+
+    /*
+      the governor sheds streaming messages as the write buffer
+      backs up, halving the rate of the messages in a class for each
+      level from the one the class starts at. High rate sensor
+      messages go first and the attitude and EKF messages last
+     */
+    struct {
+        uint8_t level;
+        uint8_t last_fill_pct;
+        uint32_t change_ms;
+        uint32_t last_busy_ms;
+        uint32_t shed;
+        // classification of each msgid, filled in as they are seen
+        Bitmask<256> classified;
+        Bitmask<256> shed_first;
+        Bitmask<256> shed_last;
+        // instances seen of each msgid, for decimation
+        uint8_t count[256];
+    } gov;
+
     // time in ms we last sent this message
     uint16_t last_send_ms[256];
 
@@ -65,6 +96,10 @@ public:
 
     bool WritePrioritisedBlock(const void *pBuffer, uint16_t size, bool is_critical, bool writev_streaming=false);
 
+    // write up to count critical messages of size bytes each from
+    // pBuffer, returning the number written
+    virtual uint16_t WriteCriticalBlocks(const void *pBuffer, uint16_t size, uint16_t count);
+
     // high level interface, indexed by the position in the list of logs
     virtual uint16_t find_last_log() = 0;
     virtual void get_log_boundaries(uint16_t list_entry, uint32_t & start_page, uint32_t & end_page) = 0;
@@ -77,6 +112,11 @@ public:
 
     virtual void Init() = 0;
 
+#if HAL_LOGGER_SHARED_BUFFER_ENABLED
+    // use a write buffer shared with other backends, called before Init()
+    virtual void share_writebuf(AP_Logger_SharedBuffer *shared, uint8_t reader) {}
+#endif
+
     virtual uint32_t bufferspace_available() = 0;
 
     virtual void PrepForArming();
@@ -95,6 +135,9 @@ public:
 
     void Fill_Format(const struct LogStructure *structure, struct log_Format &pkt);
     void Fill_Format_Units(const struct LogStructure *s, struct log_Format_Units &pkt);
+    void Fill_Unit(const struct UnitStructure *s, struct log_Unit &pkt);
+    void Fill_Multiplier(const struct MultiplierStructure *s, struct log_Format_Multiplier &pkt);
+    void Fill_Parameter(const char *name, float value, float default_val, struct log_Parameter &pkt);
 
 #if CONFIG_HAL_BOARD == HAL_BOARD_SITL || CONFIG_HAL_BOARD == HAL_BOARD_LINUX
     // currently only AP_Logger_File support this:
@@ -153,6 +196,7 @@ public:
     // write a log message out to the log of msg_type type, with
     // values contained in arg_list:
     bool Write(uint8_t msg_type, va_list arg_list, bool is_critical=false, bool is_streaming=false);
+    bool Write(const AP_Logger::log_write_fmt &f, va_list arg_list, bool is_critical=false, bool is_streaming=false);
 
     // these methods are used when reporting system status over mavlink
     virtual bool logging_enabled() const;
@@ -256,5 +300,9 @@ private:
     bool have_logged_armed;
 
     void Write_AP_Logger_Stats_File(const struct df_stats &_stats);
+
+protected:
+    // record a change of level of the rate governor
+    void Write_Rate_Governor(uint8_t fill_pct, uint32_t write_rate);
     void validate_WritePrioritisedBlock(const void *pBuffer, uint16_t size);
 };
@@ -17,11 +17,17 @@ const extern AP_HAL::HAL& hal;
 // this if (and only if!) the low level format changes
 #define DF_LOGGING_FORMAT    0x1901201B
 
+// time the IO thread may spend writing pages in one call
+#ifndef HAL_LOGGER_BLOCK_WRITE_BUDGET_US
+#define HAL_LOGGER_BLOCK_WRITE_BUDGET_US 800
+#endif
+
 AP_Logger_Block::AP_Logger_Block(AP_Logger &front, LoggerMessageWriter_DFLogStart *writer) :
     AP_Logger_Backend(front, writer),
     writebuf(0)
 {
     df_stats_clear();
+    sem.set_name("LoggerBlock");
 }
 
 // Init() is called after driver Init(), it is the responsibility of the driver to make sure the 
@@ -82,6 +88,7 @@ uint32_t AP_Logger_Block::bufferspace_available()
 void AP_Logger_Block::StartWrite(uint32_t PageAdr)
 {
     df_PageAdr    = PageAdr;
+    df_ErasedAheadBlock = UINT32_MAX;
 }
 
 void AP_Logger_Block::FinishWrite(void)
@@ -97,6 +104,11 @@ void AP_Logger_Block::FinishWrite(void)
 
     // when starting a new sector, erase it
     if ((df_PageAdr-1) % df_PagePerBlock == 0) {
+        if (get_block(df_PageAdr) == df_ErasedAheadBlock) {
+            // already erased by erase_ahead()
+            df_ErasedAheadBlock = UINT32_MAX;
+            return;
+        }
         // if we have wrapped over an existing log, force the oldest to be recalculated
         if (_cached_oldest_log > 0) {
             uint16_t log_num = StartRead(df_PageAdr);
@@ -110,6 +122,7 @@ void AP_Logger_Block::FinishWrite(void)
             return;
         }
         SectorErase(get_block(df_PageAdr));
+        sector_erase_active = true;
     }
 }
 
@@ -173,7 +186,11 @@ bool AP_Logger_Block::_WritePrioritisedBlock(const void *pBuffer, uint16_t size,
         return false;
     }
 
-    writebuf.write((uint8_t*)pBuffer, size);
+    if (writebuf.write((uint8_t*)pBuffer, size) != size) {
+        _dropped++;
+        write_sem.give();
+        return false;
+    }
     df_stats_gather(size, writebuf.space());
     write_sem.give();
 
@@ -899,19 +916,96 @@ void AP_Logger_Block::io_timer(void)
         log_write_started = false;
 
         // complete writing any previous log, a page at a time to avoid holding the lock for too long
-        if (writebuf.available()) {
+        if (erase_in_progress()) {
+            // come back when the erase has finished
+        } else if (writebuf.available()) {
             write_log_page();
         } else {
             writebuf.clear();
             stop_log_pending = false;
         }
 
-    // write at most one page
-    } else if (writebuf.available() >= df_PageSize - sizeof(struct PageHeader)) {
+    } else if (log_write_started) {
         WITH_SEMAPHORE(sem);
 
+        write_log_pages();
+    }
+}
+
+/*
+  write out the full pages waiting in the ring buffer. Each page is
+  copied out of the ring buffer while the chip programs the one
+  before, and pages are written back to back until the time budget
+  is used up. Rather than wait in the IO thread while a block erases,
+  return and come back on a later call
+ */
+void AP_Logger_Block::write_log_pages()
+{
+    const uint32_t payload = df_PageSize - sizeof(struct PageHeader);
+    const uint32_t start_us = AP_HAL::micros();
+    do {
+        if (erase_in_progress()) {
+            return;
+        }
+        if (writebuf.available() < payload) {
+            // the chip is idle, a good time to get the next erase done
+            erase_ahead();
+            return;
+        }
         write_log_page();
+        if (chip_full) {
+            return;
+        }
+        if (df_PagePerBlock - ((df_PageAdr-1) % df_PagePerBlock) <= df_PagePerBlock / 4U) {
+            // near the end of the block and never idle, erase now
+            // so the erase overlaps the rest of this block
+            erase_ahead();
+        }
+    } while (AP_HAL::micros() - start_us < HAL_LOGGER_BLOCK_WRITE_BUDGET_US);
+}
+
+/*
+  return true while a block erase we started is still running
+ */
+bool AP_Logger_Block::erase_in_progress()
+{
+    if (sector_erase_active && Busy()) {
+        return true;
+    }
+    sector_erase_active = false;
+    return false;
+}
+
+/*
+  erase the block after the one being written, so writes don't stall
+  on the erase when they reach it
+ */
+void AP_Logger_Block::erase_ahead()
+{
+    const uint32_t pages_left = df_PagePerBlock - ((df_PageAdr-1) % df_PagePerBlock);
+    uint32_t next_page = df_PageAdr + pages_left;
+    if (next_page > df_NumPages) {
+        next_page = 1;
+    }
+    const uint32_t next_block = get_block(next_page);
+    if (next_block == df_ErasedAheadBlock || sector_erase_active) {
+        return;
+    }
+    // if this log would reach its own headers, leave it to
+    // FinishWrite() to stop at the block boundary
+    if (df_Write_FilePage + pages_left > df_NumPages - df_PagePerBlock) {
+        return;
+    }
+    // if we are about to wrap over an existing log, force the oldest to be recalculated
+    if (_cached_oldest_log > 0) {
+        uint16_t log_num = StartRead(next_page);
+        if (log_num != 0xFFFF && log_num >= _cached_oldest_log) {
+            _cached_oldest_log = 0;
+        }
     }
+    SectorErase(next_block);
+    sector_erase_active = true;
+    df_ErasedAheadBlock = next_block;
 }
 
 // write out a page of log data
@@ -4,6 +4,7 @@
 #pragma once
 
 #include "AP_Logger_Backend.h"
+#include "AP_Logger_WriteBuffer.h"
 
 #if HAL_LOGGING_BLOCK_ENABLED
 
@@ -14,6 +15,11 @@ public:
     AP_Logger_Block(AP_Logger &front, LoggerMessageWriter_DFLogStart *writer);
 
     virtual void Init(void) override;
+#if HAL_LOGGER_SHARED_BUFFER_ENABLED
+    void share_writebuf(AP_Logger_SharedBuffer *shared, uint8_t reader) override {
+        writebuf.share(shared, reader);
+    }
+#endif
     virtual bool CardInserted(void) const override = 0;
 
     // erase handling
@@ -74,6 +80,8 @@ private:
     virtual void Sector4kErase(uint32_t SectorAdr) = 0;
     virtual void StartErase() = 0;
     virtual bool InErase() = 0;
+    // true while the chip is programming or erasing
+    virtual bool Busy() = 0;
     void         flash_test(void);
 
     struct PACKED PageHeader {
@@ -92,7 +100,7 @@ private:
     HAL_Semaphore sem;
     // semaphore to mediate access to the ring buffer
     HAL_Semaphore write_sem;
-    ByteBuffer writebuf;
+    AP_Logger_WriteBuffer writebuf;
 
     // state variables
     uint16_t df_Read_BufferIdx;
@@ -106,6 +114,11 @@ private:
     uint32_t df_Write_FilePage;
     // page to wipe from in the case of corruption
     uint32_t df_EraseFrom;
+    // block after the write pointer that has already been erased,
+    // or UINT32_MAX
+    uint32_t df_ErasedAheadBlock = UINT32_MAX;
+    // a block erase has been started and may not have finished
+    bool sector_erase_active;
 
     // offset from adding FMT messages to log data
     bool adding_fmt_headers;
@@ -161,6 +174,9 @@ private:
     // callback on IO thread
     bool io_thread_alive() const;
     void write_log_page();
+    void write_log_pages();
+    bool erase_in_progress();
+    void erase_ahead();
 };
 
 #endif  // HAL_LOGGING_BLOCK_ENABLED
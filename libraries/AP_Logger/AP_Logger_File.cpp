@@ -23,6 +23,7 @@
 #include <AP_Vehicle/AP_Vehicle_Type.h>
 
 #include <AP_Math/AP_Math.h>
+#include <AP_Math/crc.h>
 #include <GCS_MAVLink/GCS.h>
 #include <stdio.h>
 
@@ -46,6 +47,7 @@ AP_Logger_File::AP_Logger_File(AP_Logger &front,
     _log_directory(HAL_BOARD_LOG_DIRECTORY)
 {
     df_stats_clear();
+    semaphore.set_name("LoggerFile");
 }
 
 
@@ -87,6 +89,13 @@ void AP_Logger_File::Init()
 
     DEV_PRINTF("AP_Logger_File: buffer size=%u\n", (unsigned)bufsize);
 
+#if HAL_LOGGER_FILE_INDEX_ENABLED
+    _index = new log_index;
+    if (_index == nullptr) {
+        DEV_PRINTF("Out of memory for log index\n");
+    }
+#endif
+
     _initialised = true;
 
     const char* custom_dir = hal.util->get_custom_log_directory();
@@ -154,10 +163,36 @@ void AP_Logger_File::periodic_1Hz()
         }
     }
 
-    if (rate_limiter == nullptr && (_front._params.file_ratemax > 0 || _front._log_pause)) {
-        // setup rate limiting if log rate max > 0Hz or log pause of streaming entries is requested
+    if (rate_limiter == nullptr && (_front._params.file_ratemax > 0 || _front._log_pause || _front._params.file_rate_gov)) {
+        // setup rate limiting if log rate max > 0Hz, log pause of streaming entries is requested or the governor is enabled
         rate_limiter = new AP_Logger_RateLimiter(_front, _front._params.file_ratemax);
     }
+
+    const uint32_t write_offset = _write_offset;
+    _gov_write_rate = write_offset >= _gov_last_write_offset ? write_offset - _gov_last_write_offset : write_offset;
+    _gov_last_write_offset = write_offset;
+}
+
+/*
+  feed the rate governor with the write buffer fill level, so
+  streaming messages are shed by priority when the card can't keep
+  up rather than dropped wherever the buffer happens to be full
+ */
+void AP_Logger_File::periodic_10Hz(const uint32_t now)
+{
+    AP_Logger_Backend::periodic_10Hz(now);
+
+    if (rate_limiter == nullptr || _writebuf.get_size() == 0) {
+        return;
+    }
+    uint8_t fill_pct = 0;
+    if (_front._params.file_rate_gov && logging_started()) {
+        const uint32_t size = _writebuf.get_size();
+        fill_pct = uint64_t(size - _writebuf.space()) * 100U / size;
+    }
+    if (rate_limiter->update_governor(fill_pct)) {
+        Write_Rate_Governor(fill_pct, _gov_write_rate);
+    }
 }
 
 void AP_Logger_File::periodic_fullrate()
@@ -224,6 +259,30 @@ bool AP_Logger_File::dirent_to_log_num(const dirent *de, uint16_t &log_num) cons
     return true;
 }
 
+/*
+  return the older of current_oldest_log and thisnum, taking account
+  of log numbers wrapping after last_log_num
+ */
+static uint16_t older_log(uint16_t current_oldest_log, uint16_t thisnum, uint16_t last_log_num)
+{
+    if (current_oldest_log == 0) {
+        return thisnum;
+    }
+    if (current_oldest_log <= last_log_num) {
+        if (thisnum > last_log_num) {
+            return thisnum;
+        } else if (thisnum < current_oldest_log) {
+            return thisnum;
+        }
+    } else { // current_oldest_log > last_log_num
+        if (thisnum > last_log_num) {
+            if (thisnum < current_oldest_log) {
+                return thisnum;
+            }
+        }
+    }
+    return current_oldest_log;
+}
 
 // find_oldest_log - find oldest log in _log_directory
 // returns 0 if no log was found
@@ -240,6 +299,19 @@ uint16_t AP_Logger_File::find_oldest_log()
 
     uint16_t current_oldest_log = 0; // 0 is invalid
 
+#if HAL_LOGGER_FILE_INDEX_ENABLED
+    if (index_ready()) {
+        WITH_SEMAPHORE(_index_sem);
+        for (uint16_t thisnum=1; thisnum<=MAX_LOG_FILES; thisnum++) {
+            if (index_exists(thisnum)) {
+                current_oldest_log = older_log(current_oldest_log, thisnum, last_log_num);
+            }
+        }
+        _cached_oldest_log = current_oldest_log;
+        return current_oldest_log;
+    }
+#endif
+
     // We could count up to find_last_log(), but if people start
     // relying on the min_avail_space_percent feature we could end up
     // doing a *lot* of asprintf()s and stat()s
@@ -259,23 +331,7 @@ uint16_t AP_Logger_File::find_oldest_log()
             // not a log filename
             continue;
         }
-        if (current_oldest_log == 0) {
-            current_oldest_log = thisnum;
-        } else {
-            if (current_oldest_log <= last_log_num) {
-                if (thisnum > last_log_num) {
-                    current_oldest_log = thisnum;
-                } else if (thisnum < current_oldest_log) {
-                    current_oldest_log = thisnum;
-                }
-            } else { // current_oldest_log > last_log_num
-                if (thisnum > last_log_num) {
-                    if (thisnum < current_oldest_log) {
-                        current_oldest_log = thisnum;
-                    }
-                }
-            }
-        }
+        current_oldest_log = older_log(current_oldest_log, thisnum, last_log_num);
     }
     AP::FS().closedir(d);
     _cached_oldest_log = current_oldest_log;
@@ -340,6 +396,9 @@ void AP_Logger_File::Prep_MinSpace()
                 }
             } else {
                 free(filename_to_remove);
+#if HAL_LOGGER_FILE_INDEX_ENABLED
+                index_remove(log_to_remove);
+#endif
             }
         }
         log_to_remove++;
@@ -500,15 +559,84 @@ bool AP_Logger_File::_WritePrioritisedBlock(const void *pBuffer, uint16_t size,
         return false;
     }
 
-    _writebuf.write((uint8_t*)pBuffer, size);
+    if (_writebuf.write((uint8_t*)pBuffer, size) != size) {
+        _dropped++;
+        return false;
+    }
     df_stats_gather(size, _writebuf.space());
     return true;
 }
 
+/*
+  copy a run of equal sized critical messages into the write buffer
+  in one go, subject to the same space rules as single messages
+ */
+uint16_t AP_Logger_File::WriteCriticalBlocks(const void *pBuffer, uint16_t size, uint16_t count)
+{
+#if APM_BUILD_TYPE(APM_BUILD_Replay)
+    return AP_Logger_Backend::WriteCriticalBlocks(pBuffer, size, count);
+#endif
+
+    if (size == 0 || count == 0 || !ShouldLog(true)) {
+        return 0;
+    }
+    if (StartNewLogOK()) {
+        start_new_log();
+    }
+    if (!WritesOK()) {
+        return 0;
+    }
+
+    WITH_SEMAPHORE(semaphore);
+
+    if (!WriteBlockCheckStartupMessages()) {
+        _dropped++;
+        return 0;
+    }
+
+    const uint32_t space = _writebuf.space();
+    uint32_t allowed = space;
+    if (_writing_startup_messages &&
+        _startup_messagewriter->fmt_done()) {
+        // leave room for other things, as in _WritePrioritisedBlock()
+        const uint32_t now = AP_HAL::millis();
+        const uint32_t reserved = non_messagewriter_message_reserved_space(_writebuf.get_size());
+        if (space > reserved) {
+            allowed = space - reserved;
+        } else if (now - last_messagewrite_message_sent > 100) {
+            allowed = MIN(space, size);
+        } else {
+            return 0;
+        }
+        last_messagewrite_message_sent = now;
+    }
+
+    // df_stats_gather() counts at most 64k at a time
+    const uint16_t n = MIN(uint32_t(count), MIN(allowed, uint32_t(UINT16_MAX)) / size);
+    if (n == 0) {
+        return 0;
+    }
+    if (_writebuf.write((const uint8_t *)pBuffer, n * size) != n * size) {
+        return 0;
+    }
+    df_stats_gather(n * size, _writebuf.space());
+    return n;
+}
+
 /*
   find the highest log number
  */
 uint16_t AP_Logger_File::find_last_log()
+{
+#if HAL_LOGGER_FILE_INDEX_ENABLED
+    if (index_ready()) {
+        return _index->last_log;
+    }
+#endif
+    return read_lastlog();
+}
+
+uint16_t AP_Logger_File::read_lastlog()
 {
     unsigned ret = 0;
     char *fname = _lastlog_file_name();
@@ -540,6 +668,13 @@ uint32_t AP_Logger_File::_get_log_size(const uint16_t log_num)
         }
         write_fd_semaphore.give();
     }
+#if HAL_LOGGER_FILE_INDEX_ENABLED
+    if (index_ready()) {
+        free(fname);
+        WITH_SEMAPHORE(_index_sem);
+        return index_exists(log_num) ? _index->entries[log_num].size : 0;
+    }
+#endif
     struct stat st;
     EXPECT_DELAY_MS(3000);
     if (AP::FS().stat(fname, &st) != 0) {
@@ -569,6 +704,20 @@ uint32_t AP_Logger_File::_get_log_time(const uint16_t log_num)
         }
         write_fd_semaphore.give();
     }
+#if HAL_LOGGER_FILE_INDEX_ENABLED
+    if (index_ready()) {
+        WITH_SEMAPHORE(_index_sem);
+        if (!index_exists(log_num)) {
+            free(fname);
+            return 0;
+        }
+        if (_index->entries[log_num].time_utc != 0) {
+            free(fname);
+            return _index->entries[log_num].time_utc;
+        }
+        // no time was known when the log was closed
+    }
+#endif
     struct stat st;
     EXPECT_DELAY_MS(3000);
     if (AP::FS().stat(fname, &st) != 0) {
@@ -677,6 +826,20 @@ void AP_Logger_File::get_log_info(const uint16_t list_entry, uint32_t &size, uin
  */
 uint16_t AP_Logger_File::get_num_logs()
 {
+#if HAL_LOGGER_FILE_INDEX_ENABLED
+    if (index_ready()) {
+        const uint16_t high = find_last_log();
+        WITH_SEMAPHORE(_index_sem);
+        for (uint16_t thisnum=high+1; thisnum<=MAX_LOG_FILES; thisnum++) {
+            if (index_exists(thisnum)) {
+                // we have wrapped, add in the logs with high numbers
+                return high + (MAX_LOG_FILES - thisnum) + 1;
+            }
+        }
+        return high;
+    }
+#endif
+
     auto *d = AP::FS().opendir(_log_directory);
     if (d == nullptr) {
         return 0;
@@ -717,6 +880,16 @@ void AP_Logger_File::stop_logging(void)
         int fd = _write_fd;
         _write_fd = -1;
         AP::FS().close(fd);
+#if HAL_LOGGER_FILE_INDEX_ENABLED
+        // the file being written is always the last log
+        if (index_ready()) {
+            uint64_t utc_usec;
+            if (!AP::rtc().get_utc_usec(utc_usec)) {
+                utc_usec = 0;
+            }
+            index_set(_index->last_log, _write_offset, utc_usec / 1000000U);
+        }
+#endif
     }
     if (have_sem) {
         write_fd_semaphore.give();
@@ -840,10 +1013,20 @@ void AP_Logger_File::start_new_log(void)
         }
         return;
     }
+#if HAL_LOGGER_FILE_PREALLOC_MB > 0
+    // start the log in a contiguous area so it is written with long
+    // sequential writes, without searching for free clusters as it grows
+    AP::FS().preallocate(_write_fd, HAL_LOGGER_FILE_PREALLOC_MB*1024UL*1024UL);
+#endif
     _last_write_ms = AP_HAL::millis();
     _open_error_ms = 0;
     _write_offset = 0;
     _writebuf.clear();
+#if HAL_LOGGER_COMPRESSION_ENABLED
+    _compressing = _front._params.file_compress != 0 && compression_allocate();
+    _compress.block_len = 0;
+    _compress.block_ofs = 0;
+#endif
     write_fd_semaphore.give();
 
     // now update lastlog.txt with the new log number
@@ -868,6 +1051,14 @@ void AP_Logger_File::start_new_log(void)
         return;
     }
 
+#if HAL_LOGGER_FILE_INDEX_ENABLED
+    if (index_ready()) {
+        WITH_SEMAPHORE(_index_sem);
+        _index->last_log = log_num;
+        index_set(log_num, 0, 0);
+    }
+#endif
+
     return;
 }
 
@@ -917,12 +1108,22 @@ void AP_Logger_File::io_timer(void)
         return;
     }
 
+#if HAL_LOGGER_FILE_INDEX_ENABLED
+    if (_index_dirty) {
+        index_save();
+    }
+#endif
+
     if (_write_fd == -1 || !_initialised || recent_open_error()) {
         return;
     }
 
     uint32_t nbytes = _writebuf.available();
-    if (nbytes == 0) {
+    bool block_pending = false;
+#if HAL_LOGGER_COMPRESSION_ENABLED
+    block_pending = _compressing && _compress.block_ofs < _compress.block_len;
+#endif
+    if (nbytes == 0 && !block_pending) {
         return;
     }
     if (nbytes < _writebuf_chunk && 
@@ -950,16 +1151,37 @@ void AP_Logger_File::io_timer(void)
         nbytes = _writebuf_chunk;
     }
 
-    uint32_t size;
-    const uint8_t *head = _writebuf.readptr(size);
-    nbytes = MIN(nbytes, size);
-
-    // try to align writes on a 512 byte boundary to avoid filesystem reads
-    if ((nbytes + _write_offset) % 512 != 0) {
-        uint32_t ofs = (nbytes + _write_offset) % 512;
-        if (ofs < nbytes) {
-            nbytes -= ofs;
+    ByteBuffer::IoVec vec[2];
+    uint8_t n_vec;
+#if HAL_LOGGER_COMPRESSION_ENABLED
+    if (_compressing) {
+        // finish writing the current block before compressing the
+        // next chunk
+        if (!block_pending) {
+            compress_chunk(nbytes);
+        }
+        vec[0].data = &_compress.block[_compress.block_ofs];
+        vec[0].len = _compress.block_len - _compress.block_ofs;
+        n_vec = 1;
+    } else
+#endif
+    {
+        // try to align writes on a chunk boundary so whole chunks go to
+        // the card as multi-block writes, or failing that on a 512 byte
+        // boundary to avoid filesystem reads
+        const uint32_t chunk_ofs = (nbytes + _write_offset) % _writebuf_chunk;
+        if (chunk_ofs != 0 && chunk_ofs < nbytes) {
+            nbytes -= chunk_ofs;
+        } else if ((nbytes + _write_offset) % 512 != 0) {
+            uint32_t ofs = (nbytes + _write_offset) % 512;
+            if (ofs < nbytes) {
+                nbytes -= ofs;
+            }
         }
+
+        // when the ring wraps both parts are handed to the filesystem in
+        // one vectored write
+        n_vec = _writebuf.peekiovec(vec, nbytes);
     }
 
     last_io_operation = "write";
@@ -970,7 +1192,7 @@ void AP_Logger_File::io_timer(void)
         write_fd_semaphore.give();
         return;
     }
-    ssize_t nwritten = AP::FS().write(_write_fd, head, nbytes);
+    ssize_t nwritten = AP::FS().writev(_write_fd, vec, n_vec);
     last_io_operation = "";
     if (nwritten <= 0) {
         if ((tnow - _last_write_ms)/1000U > unsigned(_front._params.file_timeout)) {
@@ -988,7 +1210,14 @@ void AP_Logger_File::io_timer(void)
         _last_write_failed = false;
         _last_write_ms = tnow;
         _write_offset += nwritten;
-        _writebuf.advance(nwritten);
+#if HAL_LOGGER_COMPRESSION_ENABLED
+        if (_compressing) {
+            _compress.block_ofs += nwritten;
+        } else
+#endif
+        {
+            _writebuf.advance(nwritten);
+        }
         /*
           the best strategy for minimizing corruption on microSD cards
           seems to be to write in 4k chunks and fsync the file on each
@@ -1061,6 +1290,245 @@ bool AP_Logger_File::logging_failed() const
     return false;
 }
 
+#if HAL_LOGGER_FILE_INDEX_ENABLED
+#define LOG_INDEX_MAGIC 0x58444e49 // "INDX"
+#define LOG_INDEX_VERSION 1
+
+/*
+  return path name of the log index file
+  Note: Caller must free.
+ */
+char *AP_Logger_File::_index_file_name(void) const
+{
+    char *buf = nullptr;
+    if (asprintf(&buf, "%s/LOGINDEX.BIN", _log_directory) == -1) {
+        return nullptr;
+    }
+    return buf;
+}
+
+/*
+  return true if the index can be used, loading it or rebuilding it
+  from the log directory on first use
+ */
+bool AP_Logger_File::index_ready()
+{
+    if (_index == nullptr) {
+        return false;
+    }
+    WITH_SEMAPHORE(_index_sem);
+    if (!_index_checked) {
+        _index_checked = true;
+        if (!index_load()) {
+            index_rebuild();
+        }
+    }
+    return true;
+}
+
+/*
+  load the index, returning false if it is missing or inconsistent
+  with LASTLOG.TXT
+ */
+bool AP_Logger_File::index_load()
+{
+    char *fname = _index_file_name();
+    if (fname == nullptr) {
+        return false;
+    }
+    EXPECT_DELAY_MS(3000);
+    FileData *fd = AP::FS().load_file(fname);
+    free(fname);
+    if (fd == nullptr) {
+        return false;
+    }
+    const bool size_ok = fd->length == sizeof(*_index);
+    if (size_ok) {
+        memcpy(_index, fd->data, sizeof(*_index));
+    }
+    delete fd;
+    if (!size_ok ||
+        _index->magic != LOG_INDEX_MAGIC ||
+        _index->version != LOG_INDEX_VERSION) {
+        return false;
+    }
+    const uint32_t crc = _index->crc;
+    _index->crc = 0;
+    if (crc_crc32(0, (const uint8_t *)_index, sizeof(*_index)) != crc) {
+        return false;
+    }
+    _index->crc = crc;
+
+    const uint16_t last_log = read_lastlog();
+    if (_index->last_log != last_log) {
+        return false;
+    }
+    if (last_log == 0) {
+        return true;
+    }
+
+    // the last log may not have been closed cleanly, so take its
+    // size from the filesystem
+    char *log_fname = _log_file_name(last_log);
+    if (log_fname == nullptr) {
+        return false;
+    }
+    struct stat st;
+    EXPECT_DELAY_MS(3000);
+    const bool exists = AP::FS().stat(log_fname, &st) == 0;
+    free(log_fname);
+    if (!exists) {
+        return false;
+    }
+    if (!index_exists(last_log) || _index->entries[last_log].size != uint32_t(st.st_size)) {
+        index_set(last_log, st.st_size, st.st_mtime);
+    }
+    return true;
+}
+
+/*
+  rebuild the index by scanning the log directory
+ */
+void AP_Logger_File::index_rebuild()
+{
+    memset(_index, 0, sizeof(*_index));
+    _index->last_log = read_lastlog();
+    _index_dirty = true;
+
+    EXPECT_DELAY_MS(3000);
+    auto *d = AP::FS().opendir(_log_directory);
+    if (d == nullptr) {
+        return;
+    }
+    for (struct dirent *de=AP::FS().readdir(d); de; de=AP::FS().readdir(d)) {
+        EXPECT_DELAY_MS(3000);
+        uint16_t thisnum;
+        if (!dirent_to_log_num(de, thisnum) || thisnum == 0) {
+            continue;
+        }
+        char *fname = nullptr;
+        if (asprintf(&fname, "%s/%s", _log_directory, de->d_name) == -1) {
+            continue;
+        }
+        struct stat st;
+        if (AP::FS().stat(fname, &st) == 0) {
+            index_set(thisnum, st.st_size, st.st_mtime);
+        }
+        free(fname);
+    }
+    AP::FS().closedir(d);
+}
+
+/*
+  write the index to LOGINDEX.BIN. This is done from the IO thread
+ */
+void AP_Logger_File::index_save()
+{
+    char *fname = _index_file_name();
+    if (fname == nullptr) {
+        return;
+    }
+    WITH_SEMAPHORE(_index_sem);
+    _index->magic = LOG_INDEX_MAGIC;
+    _index->version = LOG_INDEX_VERSION;
+    _index->crc = 0;
+    _index->crc = crc_crc32(0, (const uint8_t *)_index, sizeof(*_index));
+
+    last_io_operation = "index";
+    EXPECT_DELAY_MS(3000);
+    const int fd = AP::FS().open(fname, O_WRONLY|O_CREAT|O_TRUNC);
+    free(fname);
+    if (fd == -1) {
+        last_io_operation = "";
+        return;
+    }
+    const bool ok = AP::FS().write(fd, _index, sizeof(*_index)) == sizeof(*_index);
+    AP::FS().close(fd);
+    last_io_operation = "";
+    if (ok) {
+        _index_dirty = false;
+    }
+}
+
+bool AP_Logger_File::index_exists(uint16_t log_num) const
+{
+    return log_num <= MAX_LOG_FILES && (_index->exists[log_num/8] & (1U<<(log_num%8))) != 0;
+}
+
+void AP_Logger_File::index_set(uint16_t log_num, uint32_t size, uint32_t time_utc)
+{
+    if (log_num == 0 || log_num > MAX_LOG_FILES) {
+        return;
+    }
+    WITH_SEMAPHORE(_index_sem);
+    _index->exists[log_num/8] |= 1U<<(log_num%8);
+    _index->entries[log_num].size = size;
+    _index->entries[log_num].time_utc = time_utc;
+    _index_dirty = true;
+}
+
+void AP_Logger_File::index_remove(uint16_t log_num)
+{
+    if (log_num > MAX_LOG_FILES || !index_ready()) {
+        return;
+    }
+    WITH_SEMAPHORE(_index_sem);
+    _index->exists[log_num/8] &= ~(1U<<(log_num%8));
+    _index_dirty = true;
+}
+#endif // HAL_LOGGER_FILE_INDEX_ENABLED
+
+#if HAL_LOGGER_COMPRESSION_ENABLED
+/*
+  allocate the compression buffers, returning false if out of memory
+ */
+bool AP_Logger_File::compression_allocate(void)
+{
+    if (_compress.block != nullptr) {
+        return true;
+    }
+    _compress.raw = new uint8_t[_writebuf_chunk];
+    _compress.block = new uint8_t[sizeof(log_CompressedBlockHeader) + _writebuf_chunk];
+    _compress.hash_table = new uint16_t[AP_Logger_Compress::HASH_TABLE_SIZE/sizeof(uint16_t)];
+    if (_compress.raw == nullptr || _compress.block == nullptr || _compress.hash_table == nullptr) {
+        delete[] _compress.raw;
+        delete[] _compress.block;
+        delete[] _compress.hash_table;
+        _compress.raw = nullptr;
+        _compress.block = nullptr;
+        _compress.hash_table = nullptr;
+        DEV_PRINTF("Out of memory for log compression\n");
+        return false;
+    }
+    return true;
+}
+
+/*
+  move the next nbytes of the write buffer into a compressed block,
+  storing them uncompressed if they do not get smaller
+ */
+void AP_Logger_File::compress_chunk(uint32_t nbytes)
+{
+    nbytes = _writebuf.peekbytes(_compress.raw, nbytes);
+    _writebuf.advance(nbytes);
+
+    auto &hdr = *(log_CompressedBlockHeader *)_compress.block;
+    uint8_t *data = &_compress.block[sizeof(hdr)];
+    uint32_t data_len = AP_Logger_Compress::compress(_compress.raw, nbytes, data, nbytes-1, _compress.hash_table);
+    if (data_len == 0) {
+        memcpy(data, _compress.raw, nbytes);
+        data_len = nbytes;
+    }
+    hdr.head1 = HEAD_BYTE1;
+    hdr.head2 = HEAD_BYTE2;
+    hdr.msgid = LOG_COMPRESSED_BLOCK_MSG;
+    hdr.raw_len = nbytes;
+    hdr.data_len = data_len;
+    _compress.block_len = sizeof(hdr) + data_len;
+    _compress.block_ofs = 0;
+}
+#endif // HAL_LOGGER_COMPRESSION_ENABLED
+
 /*
   erase another file in async erase operation
  */
@@ -1074,6 +1542,9 @@ void AP_Logger_File::erase_next(void)
 
     AP::FS().unlink(fname);
     free(fname);
+#if HAL_LOGGER_FILE_INDEX_ENABLED
+    index_remove(erase.log_num);
+#endif
 
     erase.log_num++;
     if (erase.log_num <= MAX_LOG_FILES) {
@@ -1087,6 +1558,13 @@ void AP_Logger_File::erase_next(void)
     }
 
     _cached_oldest_log = 0;
+#if HAL_LOGGER_FILE_INDEX_ENABLED
+    if (index_ready()) {
+        WITH_SEMAPHORE(_index_sem);
+        _index->last_log = 0;
+        _index_dirty = true;
+    }
+#endif
 
     erase.log_num = 0;
 }
@@ -8,8 +8,9 @@
 
 #include <AP_Filesystem/AP_Filesystem.h>
 
-#include <AP_HAL/utility/RingBuffer.h>
 #include "AP_Logger_Backend.h"
+#include "AP_Logger_WriteBuffer.h"
+#include "LogCompress.h"
 
 #if HAL_LOGGING_FILESYSTEM_ENABLED
 
@@ -17,6 +18,12 @@
 #define HAL_LOGGER_WRITE_CHUNK_SIZE 4096
 #endif
 
+// size of the contiguous free area a new log is started in, zero to
+// disable. Logs may grow past it
+#ifndef HAL_LOGGER_FILE_PREALLOC_MB
+#define HAL_LOGGER_FILE_PREALLOC_MB 32
+#endif
+
 class AP_Logger_File : public AP_Logger_Backend
 {
 public:
@@ -31,6 +38,11 @@ public:
 
     // initialisation
     void Init() override;
+#if HAL_LOGGER_SHARED_BUFFER_ENABLED
+    void share_writebuf(AP_Logger_SharedBuffer *shared, uint8_t reader) override {
+        _writebuf.share(shared, reader);
+    }
+#endif
     bool CardInserted(void) const override;
 
     // erase handling
@@ -38,6 +50,7 @@ public:
 
     /* Write a block of data at current offset */
     bool _WritePrioritisedBlock(const void *pBuffer, uint16_t size, bool is_critical) override;
+    uint16_t WriteCriticalBlocks(const void *pBuffer, uint16_t size, uint16_t count) override;
     uint32_t bufferspace_available() override;
 
     // high level interface
@@ -53,6 +66,7 @@ public:
     void flush(void) override;
 #endif
     void periodic_1Hz() override;
+    void periodic_10Hz(const uint32_t now) override;
     void periodic_fullrate() override;
 
     // this method is used when reporting system status over mavlink
@@ -83,6 +97,10 @@ private:
     const char *_log_directory;
     bool _last_write_failed;
 
+    // bytes per second written out to the file, for the rate governor
+    uint32_t _gov_write_rate;
+    uint32_t _gov_last_write_offset;
+
     uint32_t _io_timer_heartbeat;
     bool io_thread_alive() const;
     uint8_t io_thread_warning_decimation_counter;
@@ -103,7 +121,7 @@ private:
     bool dirent_to_log_num(const dirent *de, uint16_t &log_num) const;
 
     // write buffer
-    ByteBuffer _writebuf{0};
+    AP_Logger_WriteBuffer _writebuf{0};
     const uint16_t _writebuf_chunk = HAL_LOGGER_WRITE_CHUNK_SIZE;
     uint32_t _last_write_time;
 
@@ -143,6 +161,54 @@ private:
     const char *last_io_operation = "";
 
     bool start_new_log_pending;
+
+    // read the highest log number from LASTLOG.TXT
+    uint16_t read_lastlog();
+
+#if HAL_LOGGER_FILE_INDEX_ENABLED
+    /*
+      persistent index of the size and time of each log, kept in
+      LOGINDEX.BIN, so log listing doesn't need a directory scan and a
+      stat per log. It is rebuilt when it is missing or inconsistent
+      with LASTLOG.TXT
+     */
+    struct PACKED log_index {
+        uint32_t magic;
+        uint16_t version;
+        uint16_t last_log;
+        uint32_t crc;
+        uint8_t exists[(MAX_LOG_FILES+8)/8];
+        struct PACKED {
+            uint32_t size;
+            uint32_t time_utc;
+        } entries[MAX_LOG_FILES+1];
+    } *_index;
+    HAL_Semaphore _index_sem;
+    bool _index_checked;
+    bool _index_dirty;
+    char *_index_file_name() const;
+    bool index_ready();
+    bool index_load();
+    void index_rebuild();
+    void index_save();
+    bool index_exists(uint16_t log_num) const;
+    void index_set(uint16_t log_num, uint32_t size, uint32_t time_utc);
+    void index_remove(uint16_t log_num);
+#endif
+
+#if HAL_LOGGER_COMPRESSION_ENABLED
+    // true if the current log file is written as compressed blocks
+    bool _compressing;
+    struct {
+        uint8_t *raw;           // chunk of the write buffer being compressed
+        uint8_t *block;         // header and data of the block being written
+        uint16_t *hash_table;
+        uint32_t block_len;
+        uint32_t block_ofs;     // bytes of the block already written
+    } _compress;
+    bool compression_allocate(void);
+    void compress_chunk(uint32_t nbytes);
+#endif
 };
 
 #endif // HAL_LOGGING_FILESYSTEM_ENABLED
@@ -26,6 +26,8 @@
 
 extern const AP_HAL::HAL& hal;
 
+static_assert(HAL_LOGGER_MAVLINK_READ_AHEAD <= INT16_MAX, "HAL_LOGGER_MAVLINK_READ_AHEAD too large");
+
 /**
    handle all types of log download requests from the GCS
  */
@@ -113,6 +115,16 @@ void AP_Logger::handle_log_request_data(GCS_MAVLINK &link, const mavlink_message
         // of silently dropping any repeated attempts to start logging
         if (_log_sending_link->get_chan() != link.get_chan()) {
             link.send_text(MAV_SEVERITY_INFO, "Log download in progress");
+            return;
+        }
+        // a GCS may keep several windows of the log outstanding, so
+        // queue requests for the log being sent behind the current one
+        if (transfer_activity == TransferActivity::SENDING) {
+            mavlink_log_request_data_t packet;
+            mavlink_msg_log_request_data_decode(&msg, &packet);
+            if (packet.id == _log_num_data) {
+                queue_log_data_window(packet.ofs, packet.count);
+            }
         }
         return;
     }
@@ -137,17 +149,13 @@ void AP_Logger::handle_log_request_data(GCS_MAVLINK &link, const mavlink_message
 
         uint32_t end;
         get_log_boundaries(packet.id, _log_data_page, end);
+#if HAL_LOGGER_MAVLINK_READ_AHEAD > 0
+        _log_read_ahead_len = 0;
+#endif
     }
 
-    _log_data_offset = packet.ofs;
-    if (_log_data_offset >= _log_data_size) {
-        _log_data_remaining = 0;
-    } else {
-        _log_data_remaining = _log_data_size - _log_data_offset;
-    }
-    if (_log_data_remaining > packet.count) {
-        _log_data_remaining = packet.count;
-    }
+    _log_data_num_windows = 0;
+    start_log_data_window(packet.ofs, packet.count);
 
     transfer_activity = TransferActivity::SENDING;
     _log_sending_link = &link;
@@ -177,6 +185,55 @@ void AP_Logger::handle_log_request_end(GCS_MAVLINK &link, const mavlink_message_
 
     transfer_activity = TransferActivity::IDLE;
     _log_sending_link = nullptr;
+    _log_data_num_windows = 0;
+
+#if HAL_LOGGER_MAVLINK_READ_AHEAD > 0
+    // the GCS has finished downloading, free the read-ahead buffer
+    delete[] _log_read_ahead;
+    _log_read_ahead = nullptr;
+    _log_read_ahead_len = 0;
+#endif
+}
+
+/**
+   set up sending of count bytes of the current log from ofs
+ */
+void AP_Logger::start_log_data_window(uint32_t ofs, uint32_t count)
+{
+    _log_data_offset = ofs;
+    if (_log_data_offset >= _log_data_size) {
+        _log_data_remaining = 0;
+    } else {
+        _log_data_remaining = _log_data_size - _log_data_offset;
+    }
+    if (_log_data_remaining > count) {
+        _log_data_remaining = count;
+    }
+}
+
+/**
+   queue a window of the current log to send once the current window
+   is complete. Returns false if the queue is full
+ */
+bool AP_Logger::queue_log_data_window(uint32_t ofs, uint32_t count)
+{
+    if (ofs >= _log_data_offset && count <= _log_data_remaining &&
+        ofs - _log_data_offset <= _log_data_remaining - count) {
+        // already being sent, e.g. a repeated request for a gap
+        return true;
+    }
+    for (uint8_t i=0; i<_log_data_num_windows; i++) {
+        if (_log_data_windows[i].ofs == ofs && _log_data_windows[i].count == count) {
+            return true;
+        }
+    }
+    if (_log_data_num_windows >= ARRAY_SIZE(_log_data_windows)) {
+        return false;
+    }
+    _log_data_windows[_log_data_num_windows].ofs = ofs;
+    _log_data_windows[_log_data_num_windows].count = count;
+    _log_data_num_windows++;
+    return true;
 }
 
 /**
@@ -214,6 +271,7 @@ void AP_Logger::handle_log_sending()
     const uint8_t num_sends = 40;
 #else
     uint8_t num_sends = 1;
+    bool budgeted = false;
     if (_log_sending_link->is_high_bandwidth() && hal.gpio->usb_connected()) {
         // when on USB we can send a lot more data
         num_sends = 250;
@@ -223,9 +281,13 @@ void AP_Logger::handle_log_sending()
     #else
         num_sends = 10;
     #endif
+    } else {
+        num_sends = log_send_budget_count();
+        budgeted = true;
     }
 #endif
 
+    uint8_t sent = 0;
     for (uint8_t i=0; i<num_sends; i++) {
         if (transfer_activity != TransferActivity::SENDING) {
             // may have completed sending data
@@ -234,7 +296,41 @@ void AP_Logger::handle_log_sending()
         if (!handle_log_send_data()) {
             break;
         }
+        sent++;
+    }
+
+#if CONFIG_HAL_BOARD != HAL_BOARD_SITL
+    if (budgeted) {
+        const uint32_t used = sent * uint32_t(PAYLOAD_SIZE(_log_sending_link->get_chan(), LOG_DATA));
+        _log_send_budget -= MIN(used, _log_send_budget);
+    }
+#else
+    (void)sent;
+#endif
+}
+
+/**
+   number of LOG_DATA packets we may send now on a link without flow
+   control. Without flow control the free buffer space does not tell
+   us how fast the link drains, so we burst up to half of the link
+   bandwidth, leaving the rest for telemetry. At least one packet is
+   sent on each call
+ */
+uint8_t AP_Logger::log_send_budget_count()
+{
+    const uint32_t now_ms = AP_HAL::millis();
+    const uint32_t dt_ms = MIN(now_ms - _log_send_budget_ms, 100U);
+    _log_send_budget_ms = now_ms;
+
+    const AP_HAL::UARTDriver *uart = _log_sending_link->get_uart();
+    if (uart == nullptr) {
+        return 1;
     }
+    const uint32_t pkt_size = PAYLOAD_SIZE(_log_sending_link->get_chan(), LOG_DATA);
+    _log_send_budget += dt_ms * uart->bw_in_kilobytes_per_second() * 1024 / 2000;
+    // don't save up more than a short burst while the link is busy
+    _log_send_budget = MIN(_log_send_budget, 20 * pkt_size);
+    return MAX(_log_send_budget / pkt_size, 1U);
 }
 
 /**
@@ -298,7 +394,7 @@ bool AP_Logger::handle_log_send_data()
         len = MAVLINK_MSG_LOG_DATA_FIELD_DATA_LEN;
     }
 
-    nbytes = get_log_data(_log_num_data, _log_data_page, _log_data_offset, len, packet.data);
+    nbytes = read_log_download_data(_log_data_offset, len, packet.data);
 
     if (nbytes < 0) {
         // report as EOF on error
@@ -321,10 +417,62 @@ bool AP_Logger::handle_log_send_data()
     _log_data_offset += nbytes;
     _log_data_remaining -= nbytes;
     if (nbytes < MAVLINK_MSG_LOG_DATA_FIELD_DATA_LEN || _log_data_remaining == 0) {
-        transfer_activity = TransferActivity::IDLE;
-        _log_sending_link = nullptr;
+        if (_log_data_num_windows > 0) {
+            // move on to the next window the GCS has asked for
+            start_log_data_window(_log_data_windows[0].ofs, _log_data_windows[0].count);
+            _log_data_num_windows--;
+            memmove(&_log_data_windows[0], &_log_data_windows[1], _log_data_num_windows*sizeof(_log_data_windows[0]));
+        } else {
+            transfer_activity = TransferActivity::IDLE;
+            _log_sending_link = nullptr;
+        }
     }
     return true;
 }
 
+/**
+   read log data for download. Reads from the backend are made in
+   large aligned chunks so a storage read is shared by many LOG_DATA
+   packets
+ */
+int16_t AP_Logger::read_log_download_data(uint32_t ofs, uint16_t len, uint8_t *data)
+{
+#if HAL_LOGGER_MAVLINK_READ_AHEAD > 0
+    if (_log_read_ahead == nullptr) {
+        _log_read_ahead = new uint8_t[HAL_LOGGER_MAVLINK_READ_AHEAD];
+        _log_read_ahead_len = 0;
+    }
+    if (_log_read_ahead != nullptr) {
+        uint16_t done = 0;
+        while (done < len) {
+            const uint32_t pos = ofs + done;
+            if (pos < _log_read_ahead_ofs || pos >= _log_read_ahead_ofs + _log_read_ahead_len) {
+                // don't read past the end of the log, the block
+                // backend would wrap into the next one
+                const uint32_t chunk_ofs = pos - (pos % HAL_LOGGER_MAVLINK_READ_AHEAD);
+                if (chunk_ofs >= _log_data_size) {
+                    break;
+                }
+                const uint16_t chunk_len = MIN(_log_data_size - chunk_ofs, uint32_t(HAL_LOGGER_MAVLINK_READ_AHEAD));
+                const int16_t ret = get_log_data(_log_num_data, _log_data_page, chunk_ofs, chunk_len, _log_read_ahead);
+                if (ret <= 0 || pos >= chunk_ofs + ret) {
+                    _log_read_ahead_len = 0;
+                    break;
+                }
+                _log_read_ahead_ofs = chunk_ofs;
+                _log_read_ahead_len = ret;
+            }
+            const uint16_t n = MIN(uint32_t(len - done), _log_read_ahead_ofs + _log_read_ahead_len - pos);
+            memcpy(&data[done], &_log_read_ahead[pos - _log_read_ahead_ofs], n);
+            done += n;
+        }
+        if (done > 0) {
+            return done;
+        }
+        // fall back to reading just this packet
+    }
+#endif
+    return get_log_data(_log_num_data, _log_data_page, ofs, len, data);
+}
+
 #endif
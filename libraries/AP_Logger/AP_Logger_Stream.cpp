@@ -0,0 +1,374 @@
+/*
+   AP_Logger streaming to a companion computer
+*/
+
+#include "AP_Logger_Stream.h"
+
+#if HAL_LOGGING_STREAM_ENABLED
+
+#include <AP_Math/crc.h>
+#include <AP_SerialManager/AP_SerialManager.h>
+#include <GCS_MAVLink/GCS.h>
+
+extern const AP_HAL::HAL& hal;
+
+#define LOGGER_STREAM_MAGIC1 0xAD
+#define LOGGER_STREAM_MAGIC2 0x4C
+
+// a block that has been partly filled for this long is sent anyway
+#define LOGGER_STREAM_FLUSH_MS 100
+// blocks not acknowledged for this long are sent again
+#define LOGGER_STREAM_RESEND_MS 500
+// a block reported missing is not sent again within this time of the
+// last send, as the ack may have crossed the resend
+#define LOGGER_STREAM_NACK_HOLDOFF_MS 50
+// the session ends if the companion is silent for this long
+#define LOGGER_STREAM_TIMEOUT_MS 5000
+// interval of the END frames sent while there is no session
+#define LOGGER_STREAM_IDLE_MS 1000
+
+#define LOGGER_STREAM_BUFSIZE_RX 128
+#define LOGGER_STREAM_BUFSIZE_TX (4 * (LOGGER_STREAM_BLOCK_SIZE + sizeof(struct frame_header) + sizeof(uint32_t)))
+
+void AP_Logger_Stream::Init()
+{
+    _uart = AP::serialmanager().find_serial(AP_SerialManager::SerialProtocol_LogStream, 0);
+    if (_uart == nullptr) {
+        return;
+    }
+
+    _num_blocks = 1024U * uint16_t(_front._params.stream_bufsize) / sizeof(struct block);
+    while (_num_blocks >= 4) {
+        _blocks = (struct block *)calloc(_num_blocks, sizeof(struct block));
+        if (_blocks != nullptr) {
+            break;
+        }
+        _num_blocks /= 2;
+    }
+    if (_blocks == nullptr) {
+        return;
+    }
+
+    _initialised = true;
+}
+
+uint32_t AP_Logger_Stream::bufferspace_available()
+{
+    // one block is always kept free to be filled
+    const uint32_t used = _fill_seq - _ack_seq;
+    return (_num_blocks - 1 - used) * LOGGER_STREAM_BLOCK_SIZE +
+        (LOGGER_STREAM_BLOCK_SIZE - slot(_fill_seq).len);
+}
+
+/*
+  finish the block being filled and start the next one. Must be
+  called with the semaphore held and the next block free
+ */
+void AP_Logger_Stream::close_fill_block(void)
+{
+    _fill_seq++;
+    struct block &b = slot(_fill_seq);
+    b.len = 0;
+    b.acked = false;
+    b.last_sent_ms = 0;
+    _fill_start_ms = AP_HAL::millis();
+}
+
+bool AP_Logger_Stream::_WritePrioritisedBlock(const void *pBuffer, uint16_t size, bool is_critical)
+{
+    if (!semaphore.take_nonblocking()) {
+        _dropped++;
+        return false;
+    }
+
+    if (!_streaming || !WriteBlockCheckStartupMessages()) {
+        semaphore.give();
+        return false;
+    }
+
+    const uint32_t space = bufferspace_available();
+    const uint32_t bufsize = uint32_t(_num_blocks) * LOGGER_STREAM_BLOCK_SIZE;
+    if (_writing_startup_messages &&
+        _startup_messagewriter->fmt_done()) {
+        // leave room for other things while the startup messages
+        // dribble out, they will be sent again
+        if (space < non_messagewriter_message_reserved_space(bufsize)) {
+            semaphore.give();
+            return false;
+        }
+    } else if (!is_critical && space < critical_message_reserved_space(bufsize)) {
+        _dropped++;
+        semaphore.give();
+        return false;
+    }
+    if (space < size) {
+        _dropped++;
+        semaphore.give();
+        return false;
+    }
+
+    const uint8_t *buf = (const uint8_t *)pBuffer;
+    uint16_t copied = 0;
+    while (copied < size) {
+        struct block &b = slot(_fill_seq);
+        const uint16_t n = MIN(uint16_t(size - copied), uint16_t(LOGGER_STREAM_BLOCK_SIZE - b.len));
+        memcpy(&b.data[b.len], &buf[copied], n);
+        b.len += n;
+        copied += n;
+        if (b.len == LOGGER_STREAM_BLOCK_SIZE) {
+            close_fill_block();
+        }
+    }
+    df_stats_gather(size, space - size);
+
+    semaphore.give();
+    return true;
+}
+
+void AP_Logger_Stream::stop_logging()
+{
+    WITH_SEMAPHORE(semaphore);
+    if (_streaming) {
+        _streaming = false;
+        _send_end = true;
+    }
+}
+
+/*
+  the companion asked for a new log, forget anything still held from
+  the last one
+ */
+void AP_Logger_Stream::start_session(void)
+{
+    {
+        WITH_SEMAPHORE(semaphore);
+        _session++;
+        _ack_seq = 0;
+        _send_seq = 0;
+        _fill_seq = 0;
+        _fill_start_ms = AP_HAL::millis();
+        struct block &b = slot(0);
+        b.len = 0;
+        b.acked = false;
+        b.last_sent_ms = 0;
+        _resends = 0;
+        _send_end = false;
+        _streaming = true;
+    }
+    start_new_log_reset_variables();
+    GCS_SEND_TEXT(MAV_SEVERITY_INFO, "Logger: streaming to companion");
+}
+
+void AP_Logger_Stream::io_timer(void)
+{
+    if (!_initialised) {
+        return;
+    }
+    if (!_uart_started) {
+        // the port is owned by this thread, the only one writing to it
+        _uart->begin(AP::serialmanager().find_baudrate(AP_SerialManager::SerialProtocol_LogStream, 0),
+                     LOGGER_STREAM_BUFSIZE_RX, LOGGER_STREAM_BUFSIZE_TX);
+        _uart_started = true;
+    }
+
+    read_incoming();
+
+    const uint32_t now_ms = AP_HAL::millis();
+    if (_streaming && now_ms - _last_rx_ms > LOGGER_STREAM_TIMEOUT_MS) {
+        // the companion has gone away, it must start a new log
+        stop_logging();
+        GCS_SEND_TEXT(MAV_SEVERITY_WARNING, "Logger: companion stream timed out");
+    }
+
+    if (_streaming) {
+        send_blocks();
+        return;
+    }
+
+    // while idle an END frame is sent every second, which tells the
+    // companion where to send START on links such as UDP
+    if (_send_end || now_ms - _last_end_ms > LOGGER_STREAM_IDLE_MS) {
+        if (send_frame(LOGGER_STREAM_TYPE_END, _fill_seq, nullptr, 0)) {
+            if (_send_end) {
+                GCS_SEND_TEXT(MAV_SEVERITY_INFO, "Logger: stream ended, %u resends", unsigned(_resends));
+            }
+            _send_end = false;
+            _last_end_ms = now_ms;
+        }
+    }
+}
+
+/*
+  collect frames from the companion, resynchronising on the magic
+  bytes after garbage
+ */
+void AP_Logger_Stream::read_incoming(void)
+{
+    uint32_t n = _uart->available();
+    while (n--) {
+        const int16_t c = _uart->read();
+        if (c < 0) {
+            break;
+        }
+        _rx_buf[_rx_len++] = c;
+
+        while (_rx_len > 0) {
+            if (_rx_buf[0] != LOGGER_STREAM_MAGIC1 ||
+                (_rx_len > 1 && _rx_buf[1] != LOGGER_STREAM_MAGIC2)) {
+                // not the start of a frame, drop a byte
+                memmove(&_rx_buf[0], &_rx_buf[1], --_rx_len);
+                continue;
+            }
+            if (_rx_len < sizeof(struct frame_header)) {
+                break;
+            }
+            struct frame_header hdr;
+            memcpy(&hdr, _rx_buf, sizeof(hdr));
+            const uint16_t frame_len = sizeof(hdr) + hdr.len + sizeof(uint32_t);
+            if (frame_len > sizeof(_rx_buf)) {
+                memmove(&_rx_buf[0], &_rx_buf[1], --_rx_len);
+                continue;
+            }
+            if (_rx_len < frame_len) {
+                break;
+            }
+            uint32_t crc;
+            memcpy(&crc, &_rx_buf[sizeof(hdr) + hdr.len], sizeof(crc));
+            if (crc != ~crc_crc32(0xFFFFFFFF, _rx_buf, sizeof(hdr) + hdr.len)) {
+                memmove(&_rx_buf[0], &_rx_buf[1], --_rx_len);
+                continue;
+            }
+            handle_frame(hdr, &_rx_buf[sizeof(hdr)]);
+            _rx_len = 0;
+        }
+    }
+}
+
+void AP_Logger_Stream::handle_frame(const struct frame_header &hdr, const uint8_t *payload)
+{
+    switch (hdr.type) {
+    case LOGGER_STREAM_TYPE_START:
+        _last_rx_ms = AP_HAL::millis();
+        start_session();
+        break;
+    case LOGGER_STREAM_TYPE_STOP:
+        if (hdr.session == _session) {
+            stop_logging();
+        }
+        break;
+    case LOGGER_STREAM_TYPE_ACK:
+        if (hdr.session == _session && _streaming) {
+            uint32_t received_mask = 0;
+            memcpy(&received_mask, payload, MIN(hdr.len, sizeof(received_mask)));
+            _last_rx_ms = AP_HAL::millis();
+            handle_ack(hdr.seq, received_mask);
+        }
+        break;
+    default:
+        break;
+    }
+}
+
+/*
+  free the blocks the companion holds, and have blocks reported
+  missing sent again
+ */
+void AP_Logger_Stream::handle_ack(uint32_t next_seq, uint32_t received_mask)
+{
+    if (next_seq - _ack_seq > _send_seq - _ack_seq) {
+        // not a block we have sent
+        return;
+    }
+
+    // writers only ever look at _ack_seq to find free space, so
+    // moving it on needs no lock
+    _ack_seq = next_seq;
+
+    const uint32_t now_ms = AP_HAL::millis();
+    const uint8_t highest = received_mask ? 32 - __builtin_clz(received_mask) : 0;
+    for (uint8_t i=0; i<highest; i++) {
+        const uint32_t seq = next_seq + 1 + i;
+        if (seq >= _send_seq) {
+            break;
+        }
+        struct block &b = slot(seq);
+        if (received_mask & (1U<<i)) {
+            b.acked = true;
+        } else if (!b.acked && now_ms - b.last_sent_ms > LOGGER_STREAM_NACK_HOLDOFF_MS) {
+            // a later block arrived, so this one was lost
+            b.last_sent_ms = 0;
+        }
+    }
+    if (highest > 0 && next_seq < _send_seq) {
+        // the block the companion is waiting for is missing too
+        struct block &b = slot(next_seq);
+        if (now_ms - b.last_sent_ms > LOGGER_STREAM_NACK_HOLDOFF_MS) {
+            b.last_sent_ms = 0;
+        }
+    }
+}
+
+bool AP_Logger_Stream::send_frame(uint8_t type, uint32_t seq, const uint8_t *payload, uint16_t len)
+{
+    const struct frame_header hdr {
+        { LOGGER_STREAM_MAGIC1, LOGGER_STREAM_MAGIC2 },
+        type,
+        _session,
+        seq,
+        len,
+    };
+    if (_uart->txspace() < sizeof(hdr) + len + sizeof(uint32_t)) {
+        return false;
+    }
+    uint32_t crc = crc_crc32(0xFFFFFFFF, (const uint8_t *)&hdr, sizeof(hdr));
+    crc = ~crc_crc32(crc, payload, len);
+    _uart->write((const uint8_t *)&hdr, sizeof(hdr));
+    _uart->write(payload, len);
+    _uart->write((const uint8_t *)&crc, sizeof(crc));
+    return true;
+}
+
+/*
+  send blocks that are lost or timed out, then new blocks, as far as
+  the port has room. The blocks between _ack_seq and _fill_seq are
+  not touched by writers, so they are sent without the lock
+ */
+void AP_Logger_Stream::send_blocks(void)
+{
+    const uint32_t now_ms = AP_HAL::millis();
+
+    for (uint32_t seq=_ack_seq; seq != _send_seq; seq++) {
+        struct block &b = slot(seq);
+        if (b.acked || now_ms - b.last_sent_ms < LOGGER_STREAM_RESEND_MS) {
+            continue;
+        }
+        if (!send_frame(LOGGER_STREAM_TYPE_DATA, seq, b.data, b.len)) {
+            return;
+        }
+        b.last_sent_ms = now_ms;
+        _resends++;
+    }
+
+    uint32_t fill_seq;
+    {
+        WITH_SEMAPHORE(semaphore);
+        if (slot(_fill_seq).len > 0 &&
+            now_ms - _fill_start_ms > LOGGER_STREAM_FLUSH_MS &&
+            _fill_seq - _ack_seq < uint32_t(_num_blocks - 1)) {
+            // don't hold a slowly filling block back
+            close_fill_block();
+        }
+        fill_seq = _fill_seq;
+    }
+
+    while (_send_seq != fill_seq) {
+        struct block &b = slot(_send_seq);
+        if (!send_frame(LOGGER_STREAM_TYPE_DATA, _send_seq, b.data, b.len)) {
+            return;
+        }
+        b.last_sent_ms = now_ms;
+        _send_seq++;
+    }
+}
+
+#endif // HAL_LOGGING_STREAM_ENABLED
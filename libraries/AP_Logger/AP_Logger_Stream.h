@@ -0,0 +1,152 @@
+/*
+   AP_Logger logging - stream variant
+
+   - streams the log to a companion computer over a serial port, which
+     may be a high speed UART or a UDP port on boards with networking
+ */
+#pragma once
+
+#include "AP_Logger_Backend.h"
+
+#if HAL_LOGGING_STREAM_ENABLED
+
+#include <AP_HAL/Semaphores.h>
+
+/*
+  The log is cut into numbered blocks of up to
+  LOGGER_STREAM_BLOCK_SIZE bytes, each sent in a frame:
+
+    uint8_t  magic[2]    0xAD 0x4C
+    uint8_t  type        LOGGER_STREAM_TYPE_*
+    uint8_t  session     incremented each time the companion starts a log
+    uint32_t seq         block number, from zero in each session
+    uint16_t len         payload length
+    uint8_t  payload[len]
+    uint32_t crc         IEEE crc32, as zlib, of the header and payload
+
+  all little endian. The companion starts a session with a START frame
+  and acknowledges blocks with ACK frames carrying the next block it
+  expects in seq and, in a four byte payload, a bitmask of the blocks
+  after that it already holds. Blocks are kept until acknowledged, and
+  sent again when they are reported missing or time out, so a window
+  of up to the buffer size is in flight at once. The vehicle ends a
+  session with an END frame when it stops logging, and repeats END
+  frames while it has no session so the companion can find it.
+ */
+#define LOGGER_STREAM_TYPE_DATA  0x01
+#define LOGGER_STREAM_TYPE_END   0x02
+#define LOGGER_STREAM_TYPE_START 0x81
+#define LOGGER_STREAM_TYPE_ACK   0x82
+#define LOGGER_STREAM_TYPE_STOP  0x83
+
+class AP_Logger_Stream : public AP_Logger_Backend
+{
+public:
+    AP_Logger_Stream(AP_Logger &front, LoggerMessageWriter_DFLogStart *writer) :
+        AP_Logger_Backend(front, writer)
+        {}
+
+    static AP_Logger_Backend  *probe(AP_Logger &front,
+                                     LoggerMessageWriter_DFLogStart *ls) {
+        return new AP_Logger_Stream(front, ls);
+    }
+
+    void Init() override;
+
+    // like the MAVLink backend everything is thrown away until the
+    // companion starts a session
+    bool logging_started() const override { return _initialised; }
+
+    void stop_logging() override;
+
+    bool _WritePrioritisedBlock(const void *pBuffer, uint16_t size,
+                               bool is_critical) override;
+
+    bool CardInserted(void) const override { return true; }
+
+    // erase handling
+    void EraseAll() override {}
+
+    void PrepForArming() override {}
+
+    // the logs are kept by the companion
+    uint16_t find_last_log(void) override { return 0; }
+    void get_log_boundaries(uint16_t log_num, uint32_t & start_page, uint32_t & end_page) override {}
+    void get_log_info(uint16_t log_num, uint32_t &size, uint32_t &time_utc) override {}
+    int16_t get_log_data(uint16_t log_num, uint16_t page, uint32_t offset, uint16_t len, uint8_t *data) override { return 0; }
+    uint16_t get_num_logs(void) override { return 0; }
+
+    void vehicle_was_disarmed() override {}
+
+    void io_timer(void) override;
+
+protected:
+
+    bool WritesOK() const override { return _streaming; }
+
+private:
+
+    struct PACKED frame_header {
+        uint8_t magic[2];
+        uint8_t type;
+        uint8_t session;
+        uint32_t seq;
+        uint16_t len;
+    };
+
+    struct block {
+        uint32_t last_sent_ms;
+        uint16_t len;
+        bool acked;
+        uint8_t data[LOGGER_STREAM_BLOCK_SIZE];
+    };
+
+    AP_HAL::UARTDriver *_uart;
+    bool _uart_started;
+
+    struct block *_blocks;
+    uint16_t _num_blocks;
+
+    // blocks before _ack_seq have been received by the companion,
+    // blocks from _send_seq have never been sent and _fill_seq is the
+    // block being written to
+    uint32_t _ack_seq;
+    uint32_t _send_seq;
+    uint32_t _fill_seq;
+    uint32_t _fill_start_ms;
+
+    uint8_t _session;
+    volatile bool _streaming;
+    bool _send_end;
+    uint32_t _last_end_ms;
+    uint32_t _last_rx_ms;
+    uint32_t _resends;
+
+    // frames from the companion, which have at most four bytes of payload
+    uint8_t _rx_buf[sizeof(struct frame_header) + 4 + sizeof(uint32_t)];
+    uint8_t _rx_len;
+
+    struct block &slot(uint32_t seq) { return _blocks[seq % _num_blocks]; }
+    void close_fill_block(void);
+
+    void start_session(void);
+    void read_incoming(void);
+    void handle_frame(const struct frame_header &hdr, const uint8_t *payload);
+    void handle_ack(uint32_t next_seq, uint32_t received_mask);
+    bool send_frame(uint8_t type, uint32_t seq, const uint8_t *payload, uint16_t len);
+    void send_blocks(void);
+
+    bool logging_enabled() const override { return true; }
+    bool logging_failed() const override { return !_streaming; }
+
+    uint32_t bufferspace_available() override;
+
+    // sessions are started by the companion
+    void start_new_log(void) override {
+        return;
+    }
+
+    HAL_Semaphore semaphore;
+};
+
+#endif // HAL_LOGGING_STREAM_ENABLED
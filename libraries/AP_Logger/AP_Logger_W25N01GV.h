@@ -29,7 +29,7 @@ private:
     bool              InErase() override;
     void              send_command_addr(uint8_t cmd, uint32_t address);
     void              WaitReady();
-    bool              Busy();
+    bool              Busy() override;
     uint8_t           ReadStatusRegBits(uint8_t bits);
     void              WriteStatusReg(uint8_t reg, uint8_t bits);
 
@@ -0,0 +1,328 @@
+#include "AP_Logger_WriteBuffer.h"
+
+#if HAL_LOGGER_SHARED_BUFFER_ENABLED
+
+#include <AP_Math/AP_Math.h>
+
+// expected average message length, sets how many messages the shared
+// buffer can hold
+#define SHARED_BUFFER_BYTES_PER_RECORD 32
+
+// a reader doesn't lose a message it is part way through or has been
+// handed by peekiovec(), unless it has read nothing for this long
+#define SHARED_BUFFER_STALL_MS 1000
+
+/*
+  size the buffer for the largest reader. This is only done while
+  the backends are initialised, before anything is written
+ */
+bool AP_Logger_SharedBuffer::allocate(uint32_t size)
+{
+    if (size <= _size) {
+        return true;
+    }
+    const uint32_t num_records = MAX(size / SHARED_BUFFER_BYTES_PER_RECORD, 16U);
+    uint8_t *data = (uint8_t *)calloc(1, size);
+    struct record *records = (struct record *)calloc(num_records, sizeof(struct record));
+    if (data == nullptr || records == nullptr) {
+        free(data);
+        free(records);
+        return false;
+    }
+    free(_data);
+    free(_records);
+    _data = data;
+    _size = size;
+    _records = records;
+    _num_records = num_records;
+    for (auto &r : _readers) {
+        r.cur = { _head_rec, _head_pos, 0 };
+        r.pending = 0;
+        r.peeked = 0;
+    }
+    return true;
+}
+
+bool AP_Logger_SharedBuffer::attach(uint8_t reader, uint32_t size)
+{
+    if (reader >= MAX_READERS || size == 0) {
+        return false;
+    }
+    WITH_SEMAPHORE(_sem);
+    if (!allocate(size)) {
+        return false;
+    }
+    auto &r = _readers[reader];
+    r.quota = size;
+    r.cur = { _head_rec, _head_pos, 0 };
+    r.pending = 0;
+    r.peeked = 0;
+    return true;
+}
+
+/*
+  space as seen by a reader: its quota less everything written since
+  its cursor, including the messages of other readers it hasn't
+  skipped yet
+ */
+uint32_t AP_Logger_SharedBuffer::space(uint8_t reader) const
+{
+    const auto &r = _readers[reader];
+    const uint32_t lag = _head_pos - r.cur.pos;
+    return r.quota > lag ? r.quota - lag : 0;
+}
+
+/*
+  move a cursor past messages of other readers. The newest message is
+  left alone as the reader may be about to write the same message
+ */
+void AP_Logger_SharedBuffer::skip_foreign(uint8_t reader, struct cursor &cur) const
+{
+    const uint8_t bit = 1U << reader;
+    while (cur.ofs == 0 && _head_rec - cur.rec > 1 && (rec_at(cur.rec).mask & bit) == 0) {
+        cur.pos += rec_at(cur.rec).len;
+        cur.rec++;
+    }
+}
+
+bool AP_Logger_SharedBuffer::newest_matches(const uint8_t *data, uint32_t len) const
+{
+    const uint32_t ofs = (_head_pos - len) % _size;
+    const uint32_t n = MIN(len, _size - ofs);
+    return memcmp(&_data[ofs], data, n) == 0 &&
+        memcmp(_data, &data[n], len - n) == 0;
+}
+
+/*
+  drop the oldest message a reader hasn't consumed, false if it is
+  still using it
+ */
+bool AP_Logger_SharedBuffer::drop_oldest(uint8_t reader)
+{
+    auto &r = _readers[reader];
+    if (r.cur.rec == _head_rec) {
+        return false;
+    }
+    if (r.cur.ofs != 0 || r.peeked != 0) {
+        if (AP_HAL::millis() - r.read_ms < SHARED_BUFFER_STALL_MS) {
+            return false;
+        }
+        r.peek_lost = r.peeked != 0;
+        r.peeked = 0;
+    }
+    const auto &rec = rec_at(r.cur.rec);
+    if (rec.mask & (1U << reader)) {
+        r.pending -= rec.len - r.cur.ofs;
+    }
+    r.cur.pos += rec.len;
+    r.cur.rec++;
+    r.cur.ofs = 0;
+    skip_foreign(reader, r.cur);
+    return true;
+}
+
+/*
+  make room for a new message of len bytes, dropping the oldest
+  messages of the readers furthest behind if needed
+ */
+bool AP_Logger_SharedBuffer::make_room(uint32_t len)
+{
+    if (len > _size) {
+        return false;
+    }
+    while (true) {
+        uint8_t worst = MAX_READERS;
+        for (uint8_t i=0; i<MAX_READERS; i++) {
+            const auto &r = _readers[i];
+            if (r.quota == 0) {
+                continue;
+            }
+            if (_head_pos - r.cur.pos > _size - len ||
+                _head_rec - r.cur.rec >= _num_records) {
+                if (worst == MAX_READERS ||
+                    _head_pos - r.cur.pos > _head_pos - _readers[worst].cur.pos) {
+                    worst = i;
+                }
+            }
+        }
+        if (worst == MAX_READERS) {
+            return true;
+        }
+        if (!drop_oldest(worst)) {
+            return false;
+        }
+    }
+}
+
+uint32_t AP_Logger_SharedBuffer::write(uint8_t reader, const uint8_t *data, uint32_t len)
+{
+    if (len == 0 || len > UINT16_MAX) {
+        return 0;
+    }
+    WITH_SEMAPHORE(_sem);
+
+    auto &r = _readers[reader];
+    const uint8_t bit = 1U << reader;
+
+    // the same message as another reader has just written
+    if (r.cur.rec != _head_rec) {
+        auto &newest = rec_at(_head_rec - 1);
+        if ((newest.mask & bit) == 0 && newest.len == len && newest_matches(data, len)) {
+            newest.mask |= bit;
+            r.pending += len;
+            return len;
+        }
+    }
+
+    if (!make_room(len)) {
+        return 0;
+    }
+
+    const uint32_t ofs = _head_pos % _size;
+    const uint32_t n = MIN(len, _size - ofs);
+    memcpy(&_data[ofs], data, n);
+    memcpy(_data, &data[n], len - n);
+
+    auto &rec = rec_at(_head_rec);
+    rec.len = len;
+    rec.mask = bit;
+    _head_rec++;
+    _head_pos += len;
+    r.pending += len;
+
+    for (uint8_t i=0; i<MAX_READERS; i++) {
+        if (_readers[i].quota != 0) {
+            skip_foreign(i, _readers[i].cur);
+        }
+    }
+    return len;
+}
+
+/*
+  copy out and/or consume up to len bytes of a reader's messages
+  from a cursor
+ */
+uint32_t AP_Logger_SharedBuffer::copy_out(uint8_t reader, struct cursor &cur, uint8_t *data, uint32_t len)
+{
+    const uint8_t bit = 1U << reader;
+    uint32_t done = 0;
+    while (done < len && cur.rec != _head_rec) {
+        const auto &rec = rec_at(cur.rec);
+        if ((rec.mask & bit) == 0) {
+            if (is_newest(cur.rec)) {
+                break;
+            }
+            cur.pos += rec.len;
+            cur.rec++;
+            continue;
+        }
+        const uint32_t n = MIN(len - done, uint32_t(rec.len - cur.ofs));
+        if (data != nullptr) {
+            const uint32_t ofs = (cur.pos + cur.ofs) % _size;
+            const uint32_t n1 = MIN(n, _size - ofs);
+            memcpy(&data[done], &_data[ofs], n1);
+            memcpy(&data[done+n1], _data, n - n1);
+        }
+        done += n;
+        cur.ofs += n;
+        if (cur.ofs == rec.len) {
+            cur.pos += rec.len;
+            cur.rec++;
+            cur.ofs = 0;
+        }
+    }
+    return done;
+}
+
+uint32_t AP_Logger_SharedBuffer::read(uint8_t reader, uint8_t *data, uint32_t len)
+{
+    WITH_SEMAPHORE(_sem);
+    auto &r = _readers[reader];
+    const uint32_t n = copy_out(reader, r.cur, data, len);
+    r.pending -= n;
+    r.peeked = 0;
+    r.read_ms = AP_HAL::millis();
+    return n;
+}
+
+uint32_t AP_Logger_SharedBuffer::peekbytes(uint8_t reader, uint8_t *data, uint32_t len)
+{
+    WITH_SEMAPHORE(_sem);
+    struct cursor cur = _readers[reader].cur;
+    return copy_out(reader, cur, data, len);
+}
+
+/*
+  hand out up to len bytes of the reader's messages without copying
+  them. This stops at the first message of another reader, so may
+  return less than is available
+ */
+uint8_t AP_Logger_SharedBuffer::peekiovec(uint8_t reader, ByteBuffer::IoVec vec[2], uint32_t len)
+{
+    WITH_SEMAPHORE(_sem);
+    auto &r = _readers[reader];
+    const uint8_t bit = 1U << reader;
+
+    skip_foreign(reader, r.cur);
+    struct cursor cur = r.cur;
+    const uint32_t start = cur.pos + cur.ofs;
+    uint32_t n = 0;
+    while (n < len && cur.rec != _head_rec && (rec_at(cur.rec).mask & bit) != 0) {
+        const uint32_t rec_len = rec_at(cur.rec).len - cur.ofs;
+        if (len - n < rec_len) {
+            n = len;
+            break;
+        }
+        n += rec_len;
+        cur.pos += rec_at(cur.rec).len;
+        cur.rec++;
+        cur.ofs = 0;
+    }
+    r.peeked = n;
+    r.read_ms = AP_HAL::millis();
+    r.peek_lost = false;
+    if (n == 0) {
+        return 0;
+    }
+
+    const uint32_t ofs = start % _size;
+    const uint32_t n1 = MIN(n, _size - ofs);
+    vec[0].data = &_data[ofs];
+    vec[0].len = n1;
+    if (n1 == n) {
+        return 1;
+    }
+    vec[1].data = _data;
+    vec[1].len = n - n1;
+    return 2;
+}
+
+bool AP_Logger_SharedBuffer::advance(uint8_t reader, uint32_t n)
+{
+    WITH_SEMAPHORE(_sem);
+    auto &r = _readers[reader];
+    r.peeked = 0;
+    r.read_ms = AP_HAL::millis();
+    if (r.peek_lost) {
+        // what was peeked has already been dropped
+        r.peek_lost = false;
+        return false;
+    }
+    if (n > r.pending) {
+        return false;
+    }
+    r.pending -= copy_out(reader, r.cur, nullptr, n);
+    return true;
+}
+
+void AP_Logger_SharedBuffer::clear(uint8_t reader)
+{
+    WITH_SEMAPHORE(_sem);
+    auto &r = _readers[reader];
+    r.cur = { _head_rec, _head_pos, 0 };
+    r.pending = 0;
+    r.peeked = 0;
+    r.peek_lost = false;
+}
+
+#endif // HAL_LOGGER_SHARED_BUFFER_ENABLED
@@ -0,0 +1,153 @@
+/*
+  write buffers for the byte stream (File and Block) logging backends
+ */
+#pragma once
+
+#include "AP_Logger_config.h"
+
+#include <AP_HAL/AP_HAL.h>
+#include <AP_HAL/Semaphores.h>
+#include <AP_HAL/utility/RingBuffer.h>
+
+#if HAL_LOGGER_SHARED_BUFFER_ENABLED
+
+/*
+  A write buffer shared by several byte stream backends. Each message
+  is stored once, along with a mask of the backends (readers) that
+  accepted it, and each reader consumes its messages at its own pace
+  through its own cursor, skipping those of other readers.
+
+  Backends are called in turn with the same message by AP_Logger, so
+  a message identical to the newest one in the buffer is added to the
+  newest message's mask rather than copied again. This is exact: the
+  reader sees the same bytes at the same point in its stream either
+  way.
+
+  Each reader has a quota, the size its own buffer would have had,
+  and sees space() and get_size() as though the buffer were its own,
+  so the backends keep their own drop policies. A reader that falls so
+  far behind that the buffer fills loses its oldest messages rather
+  than holding up the others.
+ */
+class AP_Logger_SharedBuffer {
+public:
+    static constexpr uint8_t MAX_READERS = 4;
+
+    // add a reader with its own view of size bytes
+    bool attach(uint8_t reader, uint32_t size);
+
+    uint32_t get_size(uint8_t reader) const { return _readers[reader].quota; }
+    uint32_t space(uint8_t reader) const;
+    uint32_t available(uint8_t reader) const { return _readers[reader].pending; }
+
+    uint32_t write(uint8_t reader, const uint8_t *data, uint32_t len);
+    uint32_t read(uint8_t reader, uint8_t *data, uint32_t len);
+    uint32_t peekbytes(uint8_t reader, uint8_t *data, uint32_t len);
+    uint8_t peekiovec(uint8_t reader, ByteBuffer::IoVec vec[2], uint32_t len);
+    bool advance(uint8_t reader, uint32_t n);
+    void clear(uint8_t reader);
+
+private:
+    struct record {
+        uint16_t len;
+        uint8_t mask;
+    };
+
+    // position in the buffer. Counts are absolute and wrap, records
+    // and data are found modulo the array sizes
+    struct cursor {
+        uint32_t rec;   // record number
+        uint32_t pos;   // data offset of the start of the record
+        uint16_t ofs;   // bytes of the record already consumed
+    };
+
+    struct reader_state {
+        uint32_t quota;     // zero if not attached
+        struct cursor cur;
+        uint32_t pending;   // unconsumed bytes of this reader's records
+        uint32_t peeked;    // bytes handed out by peekiovec()
+        uint32_t read_ms;   // when the reader last consumed or peeked
+        bool peek_lost;     // peeked bytes were dropped before advance()
+    } _readers[MAX_READERS];
+
+    uint8_t *_data;
+    uint32_t _size;
+    struct record *_records;
+    uint32_t _num_records;
+
+    uint32_t _head_rec;
+    uint32_t _head_pos;
+
+    HAL_Semaphore _sem;
+
+    struct record &rec_at(uint32_t rec) const { return _records[rec % _num_records]; }
+    bool is_newest(uint32_t rec) const { return _head_rec - rec == 1; }
+    bool allocate(uint32_t size);
+    bool make_room(uint32_t len);
+    bool drop_oldest(uint8_t reader);
+    void skip_foreign(uint8_t reader, struct cursor &cur) const;
+    uint32_t copy_out(uint8_t reader, struct cursor &cur, uint8_t *data, uint32_t len);
+    bool newest_matches(const uint8_t *data, uint32_t len) const;
+};
+
+/*
+  the write buffer of a byte stream backend, which is a ByteBuffer of
+  its own unless it has been given a reader on a shared buffer. This
+  provides the part of the ByteBuffer API the backends use
+ */
+class AP_Logger_WriteBuffer {
+public:
+    AP_Logger_WriteBuffer(uint32_t size) : _own(size), _shared(nullptr), _reader(0) {}
+
+    // use a shared buffer. Must be called before set_size()
+    void share(AP_Logger_SharedBuffer *shared, uint8_t reader) {
+        _shared = shared;
+        _reader = reader;
+    }
+
+    bool set_size(uint32_t size) {
+        return _shared ? _shared->attach(_reader, size) : _own.set_size(size);
+    }
+    uint32_t get_size(void) const {
+        return _shared ? _shared->get_size(_reader) : _own.get_size();
+    }
+    uint32_t space(void) const {
+        return _shared ? _shared->space(_reader) : _own.space();
+    }
+    uint32_t available(void) const {
+        return _shared ? _shared->available(_reader) : _own.available();
+    }
+    uint32_t write(const uint8_t *data, uint32_t len) {
+        return _shared ? _shared->write(_reader, data, len) : _own.write(data, len);
+    }
+    uint32_t read(uint8_t *data, uint32_t len) {
+        return _shared ? _shared->read(_reader, data, len) : _own.read(data, len);
+    }
+    uint32_t peekbytes(uint8_t *data, uint32_t len) {
+        return _shared ? _shared->peekbytes(_reader, data, len) : _own.peekbytes(data, len);
+    }
+    uint8_t peekiovec(ByteBuffer::IoVec vec[2], uint32_t len) {
+        return _shared ? _shared->peekiovec(_reader, vec, len) : _own.peekiovec(vec, len);
+    }
+    bool advance(uint32_t n) {
+        return _shared ? _shared->advance(_reader, n) : _own.advance(n);
+    }
+    void clear(void) {
+        if (_shared) {
+            _shared->clear(_reader);
+        } else {
+            _own.clear();
+        }
+    }
+
+private:
+    ByteBuffer _own;
+    AP_Logger_SharedBuffer *_shared;
+    uint8_t _reader;
+};
+
+#else
+
+typedef ByteBuffer AP_Logger_WriteBuffer;
+
+#endif // HAL_LOGGER_SHARED_BUFFER_ENABLED
@@ -16,6 +16,16 @@
     #define HAL_LOGGING_MAVLINK_ENABLED HAL_LOGGING_ENABLED
 #endif
 
+// stream to a companion computer over a serial port
+#ifndef HAL_LOGGING_STREAM_ENABLED
+    #define HAL_LOGGING_STREAM_ENABLED (HAL_LOGGING_ENABLED && HAL_MEM_CLASS >= HAL_MEM_CLASS_500)
+#endif
+
+// largest log block sent in one frame by the stream backend
+#ifndef LOGGER_STREAM_BLOCK_SIZE
+    #define LOGGER_STREAM_BLOCK_SIZE 1024
+#endif
+
 #ifndef HAL_LOGGING_FILESYSTEM_ENABLED
     #if HAVE_FILESYSTEM_SUPPORT
         #define HAL_LOGGING_FILESYSTEM_ENABLED HAL_LOGGING_ENABLED
@@ -30,6 +40,12 @@
     #define HAL_LOGGING_BLOCK_ENABLED 0
 #endif
 
+// one write buffer shared by the File and Block backends when both
+// are enabled
+#ifndef HAL_LOGGER_SHARED_BUFFER_ENABLED
+#define HAL_LOGGER_SHARED_BUFFER_ENABLED (HAL_LOGGING_FILESYSTEM_ENABLED && HAL_LOGGING_BLOCK_ENABLED)
+#endif
+
 #if HAL_LOGGING_FILESYSTEM_ENABLED
 
 #if !defined (HAL_BOARD_LOG_DIRECTORY)
@@ -46,6 +62,32 @@
 #define HAL_LOGGER_FILE_CONTENTS_ENABLED HAL_LOGGING_FILESYSTEM_ENABLED
 #endif
 
+// persistent index of file backend logs
+#ifndef HAL_LOGGER_FILE_INDEX_ENABLED
+#define HAL_LOGGER_FILE_INDEX_ENABLED (HAL_LOGGING_FILESYSTEM_ENABLED && HAL_MEM_CLASS >= HAL_MEM_CLASS_300)
+#endif
+
+// LZ4 compression of file backend logs
+#ifndef HAL_LOGGER_COMPRESSION_ENABLED
+#define HAL_LOGGER_COMPRESSION_ENABLED (HAL_LOGGING_FILESYSTEM_ENABLED && (BOARD_FLASH_SIZE > 1024))
+#endif
+
+// keep copies of the format and parameter messages written at the
+// start of a log, so later logs can write them out in bulk
+#ifndef HAL_LOGGER_HEADER_CACHE_ENABLED
+#define HAL_LOGGER_HEADER_CACHE_ENABLED (HAL_MEM_CLASS >= HAL_MEM_CLASS_1000)
+#endif
+
+// size of the read-ahead buffer for log download over MAVLink, zero
+// to read each LOG_DATA packet directly from the backend
+#ifndef HAL_LOGGER_MAVLINK_READ_AHEAD
+#if HAL_MEM_CLASS >= HAL_MEM_CLASS_300
+#define HAL_LOGGER_MAVLINK_READ_AHEAD 4096
+#else
+#define HAL_LOGGER_MAVLINK_READ_AHEAD 0
+#endif
+#endif
+
 // range of IDs to allow for new messages during replay. It is very
 // useful to be able to add new messages during a replay, but we need
 // to avoid colliding with existing messages
@@ -0,0 +1,208 @@
+/*
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+/*
+  LZ4 block format compression of log data. This is a small greedy
+  compressor with a single entry hash table, trading some compression
+  ratio for speed and a fixed memory footprint
+ */
+
+#include "LogCompress.h"
+
+#if HAL_LOGGER_COMPRESSION_ENABLED
+
+#include <string.h>
+#include <AP_Math/AP_Math.h>
+
+#define LZ4_MINMATCH 4
+#define LZ4_LASTLITERALS 5  // the last 5 bytes are always literals
+#define LZ4_MFLIMIT 12      // the last match starts at least 12 bytes before the end
+#define LZ4_HASH_LOG 12
+#define LZ4_MAX_OFFSET 65535
+
+static inline uint32_t read32(const uint8_t *p)
+{
+    uint32_t v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+static inline uint32_t hash32(uint32_t v)
+{
+    return (v * 2654435761U) >> (32 - LZ4_HASH_LOG);
+}
+
+/*
+  write a LZ4 length extension. Returns false if it does not fit
+ */
+static bool put_length(uint8_t *dst, uint32_t &op, uint32_t dst_size, uint32_t len)
+{
+    while (len >= 255) {
+        if (op >= dst_size) {
+            return false;
+        }
+        dst[op++] = 255;
+        len -= 255;
+    }
+    if (op >= dst_size) {
+        return false;
+    }
+    dst[op++] = len;
+    return true;
+}
+
+/*
+  write one sequence of literals followed by a match, or just
+  literals for the last sequence when match_len is zero
+ */
+static bool put_sequence(uint8_t *dst, uint32_t &op, uint32_t dst_size,
+                         const uint8_t *literals, uint32_t lit_len,
+                         uint16_t offset, uint32_t match_len)
+{
+    if (op >= dst_size) {
+        return false;
+    }
+    uint8_t &token = dst[op++];
+    token = MIN(lit_len, 15U) << 4;
+    if (lit_len >= 15 && !put_length(dst, op, dst_size, lit_len - 15)) {
+        return false;
+    }
+    if (op + lit_len > dst_size) {
+        return false;
+    }
+    memcpy(&dst[op], literals, lit_len);
+    op += lit_len;
+    if (match_len == 0) {
+        return true;
+    }
+    if (op + 2 > dst_size) {
+        return false;
+    }
+    dst[op++] = offset & 0xFF;
+    dst[op++] = offset >> 8;
+    match_len -= LZ4_MINMATCH;
+    token |= MIN(match_len, 15U);
+    if (match_len >= 15 && !put_length(dst, op, dst_size, match_len - 15)) {
+        return false;
+    }
+    return true;
+}
+
+uint32_t AP_Logger_Compress::compress(const uint8_t *src, uint32_t len, uint8_t *dst, uint32_t dst_size, uint16_t *hash_table)
+{
+    if (len > UINT16_MAX) {
+        return 0;
+    }
+    memset(hash_table, 0, HASH_TABLE_SIZE);
+
+    uint32_t op = 0;
+    uint32_t anchor = 0;
+    if (len > LZ4_MFLIMIT) {
+        const uint32_t match_limit = len - LZ4_LASTLITERALS;
+        const uint32_t ip_limit = len - LZ4_MFLIMIT;
+        uint32_t ip = 0;
+        while (ip < ip_limit) {
+            const uint32_t v = read32(&src[ip]);
+            const uint32_t h = hash32(v);
+            uint32_t ref = hash_table[h];
+            hash_table[h] = ip;
+            if (ref >= ip || ip - ref > LZ4_MAX_OFFSET || read32(&src[ref]) != v) {
+                ip++;
+                continue;
+            }
+            // extend the match backwards over pending literals, then forwards
+            while (ip > anchor && ref > 0 && src[ip-1] == src[ref-1]) {
+                ip--;
+                ref--;
+            }
+            uint32_t match_len = LZ4_MINMATCH;
+            while (ip + match_len < match_limit && src[ip+match_len] == src[ref+match_len]) {
+                match_len++;
+            }
+            if (!put_sequence(dst, op, dst_size, &src[anchor], ip - anchor, ip - ref, match_len)) {
+                return 0;
+            }
+            ip += match_len;
+            anchor = ip;
+        }
+    }
+    if (!put_sequence(dst, op, dst_size, &src[anchor], len - anchor, 0, 0)) {
+        return 0;
+    }
+    return op;
+}
+
+/*
+  read a LZ4 length extension. Returns false on a truncated block
+ */
+static bool get_length(const uint8_t *src, uint32_t &ip, uint32_t len, uint32_t &value)
+{
+    uint8_t b;
+    do {
+        if (ip >= len) {
+            return false;
+        }
+        b = src[ip++];
+        value += b;
+    } while (b == 255);
+    return true;
+}
+
+int32_t AP_Logger_Compress::decompress(const uint8_t *src, uint32_t len, uint8_t *dst, uint32_t dst_size)
+{
+    uint32_t ip = 0;
+    uint32_t op = 0;
+    while (ip < len) {
+        const uint8_t token = src[ip++];
+        uint32_t lit_len = token >> 4;
+        if (lit_len == 15 && !get_length(src, ip, len, lit_len)) {
+            return -1;
+        }
+        if (ip + lit_len > len || op + lit_len > dst_size) {
+            return -1;
+        }
+        memcpy(&dst[op], &src[ip], lit_len);
+        ip += lit_len;
+        op += lit_len;
+        if (ip == len) {
+            // the last sequence has no match
+            break;
+        }
+        if (ip + 2 > len) {
+            return -1;
+        }
+        const uint16_t offset = src[ip] | (src[ip+1] << 8);
+        ip += 2;
+        if (offset == 0 || offset > op) {
+            return -1;
+        }
+        uint32_t match_len = token & 0x0F;
+        if (match_len == 15 && !get_length(src, ip, len, match_len)) {
+            return -1;
+        }
+        match_len += LZ4_MINMATCH;
+        if (op + match_len > dst_size) {
+            return -1;
+        }
+        // byte copy as the match may overlap the output
+        const uint8_t *ref = &dst[op - offset];
+        for (uint32_t i=0; i<match_len; i++) {
+            dst[op+i] = ref[i];
+        }
+        op += match_len;
+    }
+    return op;
+}
+
+#endif  // HAL_LOGGER_COMPRESSION_ENABLED
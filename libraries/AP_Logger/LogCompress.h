@@ -0,0 +1,52 @@
+#pragma once
+
+#include "AP_Logger_config.h"
+
+#if HAL_LOGGER_COMPRESSION_ENABLED
+
+#include <stdint.h>
+#include <AP_Common/AP_Common.h>
+
+/*
+  a compressed log is a sequence of blocks, each holding an
+  independently compressed piece of the uncompressed log stream so a
+  damaged block only loses its own data. The block header starts with
+  the log message header bytes and a message ID that is never used
+  for a real message
+ */
+#define LOG_COMPRESSED_BLOCK_MSG 255
+
+struct PACKED log_CompressedBlockHeader {
+    uint8_t head1;
+    uint8_t head2;
+    uint8_t msgid;
+    uint16_t raw_len;       // length of the uncompressed data
+    uint16_t data_len;      // length of the block data, equal to raw_len if not compressed
+};
+
+class AP_Logger_Compress {
+public:
+    // size of the hash table in bytes needed by compress()
+    static const uint16_t HASH_TABLE_SIZE = (1U<<12) * sizeof(uint16_t);
+
+    // worst case compressed size of len bytes, before falling back to
+    // storing the data uncompressed
+    static uint32_t max_compressed_size(uint32_t len) {
+        return len + len/255 + 16;
+    }
+
+    /*
+      compress len bytes of src into dst in the LZ4 block format. len
+      must be less than 64k. Returns the compressed length, or zero if
+      the data does not fit in dst_size bytes
+     */
+    static uint32_t compress(const uint8_t *src, uint32_t len, uint8_t *dst, uint32_t dst_size, uint16_t *hash_table);
+
+    /*
+      decompress an LZ4 block. Returns the uncompressed length, or -1
+      if the block is corrupt or does not fit in dst_size bytes
+     */
+    static int32_t decompress(const uint8_t *src, uint32_t len, uint8_t *dst, uint32_t dst_size);
+};
+
+#endif  // HAL_LOGGER_COMPRESSION_ENABLED
@@ -62,31 +62,41 @@ bool AP_Logger_Backend::Write_Format(const struct LogStructure *s)
 /*
   write a unit definition
  */
-bool AP_Logger_Backend::Write_Unit(const struct UnitStructure *s)
+void AP_Logger_Backend::Fill_Unit(const struct UnitStructure *s, struct log_Unit &pkt)
 {
-    struct log_Unit pkt{
+    pkt = log_Unit{
         LOG_PACKET_HEADER_INIT(LOG_UNIT_MSG),
         time_us : AP_HAL::micros64(),
         type    : s->ID,
         unit    : { }
     };
     strncpy_noterm(pkt.unit, s->unit, sizeof(pkt.unit));
+}
 
+bool AP_Logger_Backend::Write_Unit(const struct UnitStructure *s)
+{
+    struct log_Unit pkt;
+    Fill_Unit(s, pkt);
     return WriteCriticalBlock(&pkt, sizeof(pkt));
 }
 
 /*
   write a unit-multiplier definition
  */
-bool AP_Logger_Backend::Write_Multiplier(const struct MultiplierStructure *s)
+void AP_Logger_Backend::Fill_Multiplier(const struct MultiplierStructure *s, struct log_Format_Multiplier &pkt)
 {
-    const struct log_Format_Multiplier pkt{
+    pkt = log_Format_Multiplier{
         LOG_PACKET_HEADER_INIT(LOG_MULT_MSG),
         time_us      : AP_HAL::micros64(),
         type         : s->ID,
         multiplier   : s->multiplier,
     };
+}
 
+bool AP_Logger_Backend::Write_Multiplier(const struct MultiplierStructure *s)
+{
+    struct log_Format_Multiplier pkt;
+    Fill_Multiplier(s, pkt);
     return WriteCriticalBlock(&pkt, sizeof(pkt));
 }
 
@@ -103,9 +113,9 @@ bool AP_Logger_Backend::Write_Format_Units(const struct LogStructure *s)
 /*
   write a parameter to the log
  */
-bool AP_Logger_Backend::Write_Parameter(const char *name, float value, float default_val)
+void AP_Logger_Backend::Fill_Parameter(const char *name, float value, float default_val, struct log_Parameter &pkt)
 {
-    struct log_Parameter pkt{
+    pkt = log_Parameter{
         LOG_PACKET_HEADER_INIT(LOG_PARAMETER_MSG),
         time_us : AP_HAL::micros64(),
         name  : {},
@@ -113,6 +123,12 @@ bool AP_Logger_Backend::Write_Parameter(const char *name, float value, float def
         default_value : default_val
     };
     strncpy_noterm(pkt.name, name, sizeof(pkt.name));
+}
+
+bool AP_Logger_Backend::Write_Parameter(const char *name, float value, float default_val)
+{
+    struct log_Parameter pkt;
+    Fill_Parameter(name, value, default_val, pkt);
     return WriteCriticalBlock(&pkt, sizeof(pkt));
 }
 
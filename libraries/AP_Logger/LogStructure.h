@@ -1,6 +1,7 @@
 #pragma once
 
 #include <AP_Common/AP_Common.h>
+#include <AP_Common/float16.h>
 
 // if you add any new types, units or multipliers, please update README.md
 
@@ -14,6 +15,7 @@ Format characters in the format string for binary log messages
   i   : int32_t
   I   : uint32_t
   f   : float
+  g   : float16, see AP_Common/float16.h
   d   : double
   n   : char[4]
   N   : char[16]
@@ -140,6 +142,7 @@ const struct MultiplierStructure log_Multipliers[] = {
 #include <AP_HAL_ChibiOS/LogStructure.h>
 #include <AP_RPM/LogStructure.h>
 #include <AC_Fence/LogStructure.h>
+#include <AP_Scheduler/LogStructure.h>
 
 // structure used to define logging format
 // It is packed on ChibiOS to save flash space; however, this causes problems
@@ -220,6 +223,15 @@ struct PACKED log_DSF {
     uint32_t buf_space_avg;
 };
 
+struct PACKED log_LGOV {
+    LOG_PACKET_HEADER;
+    uint64_t time_us;
+    uint8_t level;
+    uint8_t fill_pct;
+    uint32_t write_rate;
+    uint32_t shed;
+};
+
 struct PACKED log_Event {
     LOG_PACKET_HEADER;
     uint64_t time_us;
@@ -658,6 +670,7 @@ struct PACKED log_STAK {
     uint16_t stack_total;
     uint16_t stack_free;
     char name[16];
+    uint16_t load;
 };
 
 struct PACKED log_File {
@@ -675,6 +688,7 @@ struct PACKED log_Scripting {
     uint32_t run_time;
     int32_t total_mem;
     int32_t run_mem;
+    uint32_t gc_time;
 };
 
 struct PACKED log_MotBatt {
@@ -797,6 +811,14 @@ struct PACKED log_VER {
 // @Field: FMx: Maximum free space in write buffer in last time period
 // @Field: FAv: Average free space in write buffer in last time period
 
+// @LoggerMessage: LGOV
+// @Description: Logging rate governor decisions, written when the governor level changes
+// @Field: TimeUS: Time since system startup
+// @Field: Lvl: Governor level, 0 when no streaming messages are being shed
+// @Field: Fill: Percentage of the write buffer in use
+// @Field: WrR: Rate data was written out of the buffer over the last second
+// @Field: Shed: Number of streaming messages shed since the last level change
+
 // @LoggerMessage: DSTL
 // @Description: Deepstall Landing data
 // @Field: TimeUS: Time since system startup
@@ -1117,6 +1139,7 @@ struct PACKED log_VER {
 // @Field: TimeUS: Time since system startup
 // @Field: SysID: system ID this data is for
 // @Field: RTT: round trip time for this system
+// @Field: Ofs: estimated clock offset of this system, its time less ours
 
 // @LoggerMessage: UNIT
 // @Description: Message mapping from single character to SI unit
@@ -1191,6 +1214,7 @@ struct PACKED log_VER {
 // @Field: Total: total stack
 // @Field: Free: free stack
 // @Field: Name: thread name
+// @Field: Load: share of the CPU used by the thread since it was last logged, zero if not measured
 
 // @LoggerMessage: SCR
 // @Description: Scripting runtime stats
@@ -1199,6 +1223,7 @@ struct PACKED log_VER {
 // @Field: Runtime: run time
 // @Field: Total_mem: total memory usage of all scripts
 // @Field: Run_mem: run memory usage
+// @Field: GC_time: garbage collection time after the run
 
 // @LoggerMessage: MOTB
 // @Description: Motor mixer information
@@ -1296,8 +1321,11 @@ LOG_STRUCTURE_FROM_AHRS \
 LOG_STRUCTURE_FROM_HAL_CHIBIOS \
 LOG_STRUCTURE_FROM_RPM \
 LOG_STRUCTURE_FROM_FENCE \
+LOG_STRUCTURE_FROM_SCHEDULER \
     { LOG_DF_FILE_STATS, sizeof(log_DSF), \
       "DSF", "QIHIIII", "TimeUS,Dp,Blk,Bytes,FMn,FMx,FAv", "s--b---", "F--0---" }, \
+    { LOG_RATE_GOV_MSG, sizeof(log_LGOV), \
+      "LGOV", "QBBII", "TimeUS,Lvl,Fill,WrR,Shed", "s-%--", "F-0--" }, \
     { LOG_RALLY_MSG, sizeof(log_Rally), \
       "RALY", "QBBLLh", "TimeUS,Tot,Seq,Lat,Lng,Alt", "s--DUm", "F--GGB" },  \
     { LOG_MAV_MSG, sizeof(log_MAV),   \
@@ -1324,12 +1352,12 @@ LOG_STRUCTURE_FROM_VISUALODOM \
     { LOG_PSCD_MSG, sizeof(log_PSCD), \
       "PSCD", "Qffffffff", "TimeUS,TPD,PD,DVD,TVD,VD,DAD,TAD,AD", "smmnnnooo", "F00000000" }, \
     { LOG_STAK_MSG, sizeof(log_STAK), \
-      "STAK", "QBBHHN", "TimeUS,Id,Pri,Total,Free,Name", "s#----", "F-----", true }, \
+      "STAK", "QBBHHNH", "TimeUS,Id,Pri,Total,Free,Name,Load", "s#----%", "F-----B", true }, \
     { LOG_FILE_MSG, sizeof(log_File), \
       "FILE",   "NIBZ",       "FileName,Offset,Length,Data", "----", "----" }, \
 LOG_STRUCTURE_FROM_AIS \
     { LOG_SCRIPTING_MSG, sizeof(log_Scripting), \
-      "SCR",   "QNIii", "TimeUS,Name,Runtime,Total_mem,Run_mem", "s-sbb", "F-F--", true }, \
+      "SCR",   "QNIiiI", "TimeUS,Name,Runtime,Total_mem,Run_mem,GC_time", "s-sbbs", "F-F--F", true }, \
     { LOG_VER_MSG, sizeof(log_VER), \
       "VER",   "QBHBBBBIZH", "TimeUS,BT,BST,Maj,Min,Pat,FWT,GH,FWS,APJ", "s---------", "F---------", false }, \
     { LOG_MOTBATT_MSG, sizeof(log_MotBatt), \
@@ -1419,6 +1447,8 @@ enum LogMessages : uint8_t {
     LOG_RCOUT2_MSG,
     LOG_RCOUT3_MSG,
     LOG_IDS_FROM_FENCE,
+    LOG_IDS_FROM_SCHEDULER,
+    LOG_RATE_GOV_MSG,
 
     _LOG_LAST_MSG_
 };
@@ -3,6 +3,8 @@
 #include <AP_Scheduler/AP_Scheduler.h>
 #include <AP_Vehicle/AP_Vehicle_Type.h>
 
+#include <stddef.h>
+
 #define FORCE_VERSION_H_INCLUDE
 #include "ap_version.h"
 #undef FORCE_VERSION_H_INCLUDE
@@ -56,11 +58,28 @@ void LoggerMessageWriter_DFLogStart::reset()
     _next_format_unit_to_send = 0;
     param_default = AP::logger().quiet_nanf();
     ap = AP_Param::first(&token, &type, &param_default);
+
+#if HAL_LOGGER_HEADER_CACHE_ENABLED
+    _cache_section = 0;
+    _cache_next = 0;
+    _recording_header = false;
+    if (_logger_backend != nullptr && _header_cache.valid(*_logger_backend)) {
+        stage = Stage::CACHED_HEADER;
+    } else {
+        // record the header as it is written this time
+        _header_cache.clear();
+        _recording_header = true;
+    }
+#endif
 }
 
 bool LoggerMessageWriter_DFLogStart::out_of_time_for_writing_messages() const
 {
-    if (stage == Stage::FORMATS) {
+    bool writing_formats = (stage == Stage::FORMATS);
+#if HAL_LOGGER_HEADER_CACHE_ENABLED
+    writing_formats |= (stage == Stage::CACHED_HEADER && !_fmt_done);
+#endif
+    if (writing_formats) {
         // write out the FMT messages as fast as we can
 #if HAL_SCHEDULER_ENABLED && !APM_BUILD_TYPE(APM_BUILD_UNKNOWN)
         return AP::scheduler().time_available_usec() == 0;
@@ -96,7 +115,9 @@ void LoggerMessageWriter_DFLogStart::process()
     case Stage::FORMATS:
         // write log formats so the log is self-describing
         while (next_format_to_send < _logger_backend->num_types()) {
-            if (!_logger_backend->Write_Format(_logger_backend->structure(next_format_to_send))) {
+            struct log_Format pkt;
+            _logger_backend->Fill_Format(_logger_backend->structure(next_format_to_send), pkt);
+            if (!write_header_message(LoggerHeaderCache::Section::FORMATS, &pkt, sizeof(pkt))) {
                 return; // call me again!
             }
             next_format_to_send++;
@@ -110,9 +131,20 @@ void LoggerMessageWriter_DFLogStart::process()
 
     case Stage::PARMS: {
         while (ap) {
-            if (!_logger_backend->Write_Parameter(ap, token, type, param_default)) {
+            struct log_Parameter pkt;
+            char name[16];
+            ap->copy_name_token(token, &name[0], sizeof(name), true);
+            _logger_backend->Fill_Parameter(name, ap->cast_to_float(type), param_default, pkt);
+            if (!_logger_backend->WriteCriticalBlock(&pkt, sizeof(pkt))) {
                 return;
             }
+#if HAL_LOGGER_HEADER_CACHE_ENABLED
+            if (_recording_header && !_header_cache.add_parameter(pkt, ap, type)) {
+                // out of memory, carry on without the cache
+                _header_cache.clear();
+                _recording_header = false;
+            }
+#endif
             param_default = AP::logger().quiet_nanf();
             ap = AP_Param::next_scalar(&token, &type, &param_default);
             if (check_process_limit(start_us)) {
@@ -127,7 +159,9 @@ void LoggerMessageWriter_DFLogStart::process()
 
     case Stage::UNITS:
         while (_next_unit_to_send < _logger_backend->num_units()) {
-            if (!_logger_backend->Write_Unit(_logger_backend->unit(_next_unit_to_send))) {
+            struct log_Unit pkt;
+            _logger_backend->Fill_Unit(_logger_backend->unit(_next_unit_to_send), pkt);
+            if (!write_header_message(LoggerHeaderCache::Section::UNITS, &pkt, sizeof(pkt))) {
                 return; // call me again!
             }
             _next_unit_to_send++;
@@ -140,7 +174,9 @@ void LoggerMessageWriter_DFLogStart::process()
 
     case Stage::MULTIPLIERS:
         while (_next_multiplier_to_send < _logger_backend->num_multipliers()) {
-            if (!_logger_backend->Write_Multiplier(_logger_backend->multiplier(_next_multiplier_to_send))) {
+            struct log_Format_Multiplier pkt;
+            _logger_backend->Fill_Multiplier(_logger_backend->multiplier(_next_multiplier_to_send), pkt);
+            if (!write_header_message(LoggerHeaderCache::Section::MULTIPLIERS, &pkt, sizeof(pkt))) {
                 return; // call me again!
             }
             _next_multiplier_to_send++;
@@ -153,7 +189,9 @@ void LoggerMessageWriter_DFLogStart::process()
 
     case Stage::FORMAT_UNITS:
         while (_next_format_unit_to_send < _logger_backend->num_types()) {
-            if (!_logger_backend->Write_Format_Units(_logger_backend->structure(_next_format_unit_to_send))) {
+            struct log_Format_Units pkt;
+            _logger_backend->Fill_Format_Units(_logger_backend->structure(_next_format_unit_to_send), pkt);
+            if (!write_header_message(LoggerHeaderCache::Section::FORMAT_UNITS, &pkt, sizeof(pkt))) {
                 return; // call me again!
             }
             _next_format_unit_to_send++;
@@ -161,8 +199,23 @@ void LoggerMessageWriter_DFLogStart::process()
                 return; // call me again!
             }
         }
+#if HAL_LOGGER_HEADER_CACHE_ENABLED
+        if (_recording_header) {
+            _header_cache.set_complete();
+            _recording_header = false;
+        }
+#endif
+        stage = Stage::RUNNING_SUBWRITERS;
+        FALLTHROUGH;
+
+#if HAL_LOGGER_HEADER_CACHE_ENABLED
+    case Stage::CACHED_HEADER:
+        if (!write_cached_header()) {
+            return; // call me again!
+        }
         stage = Stage::RUNNING_SUBWRITERS;
         FALLTHROUGH;
+#endif
 
     case Stage::RUNNING_SUBWRITERS:
         if (!_writesysinfo.finished()) {
@@ -218,6 +271,152 @@ void LoggerMessageWriter_DFLogStart::process()
     _finished = true;
 }
 
+bool LoggerMessageWriter_DFLogStart::write_header_message(LoggerHeaderCache::Section section, const void *pkt, uint16_t size)
+{
+    if (!_logger_backend->WriteCriticalBlock(pkt, size)) {
+        return false;
+    }
+#if HAL_LOGGER_HEADER_CACHE_ENABLED
+    if (_recording_header && !_header_cache.add(section, pkt, size)) {
+        // out of memory, carry on without the cache
+        _header_cache.clear();
+        _recording_header = false;
+    }
+#endif
+    return true;
+}
+
+#if HAL_LOGGER_HEADER_CACHE_ENABLED
+/*
+  copy the recorded header messages out to the backend in as few
+  writes as the buffer space allows, returning true once they have
+  all been written
+ */
+bool LoggerMessageWriter_DFLogStart::write_cached_header()
+{
+    while (_cache_section < uint8_t(LoggerHeaderCache::Section::NUM_SECTIONS)) {
+        const LoggerHeaderCache::Section section = LoggerHeaderCache::Section(_cache_section);
+        const uint16_t size = _header_cache.size(section);
+        const uint16_t count = _header_cache.count(section);
+        if (_cache_next == 0) {
+            _header_cache.refresh(section);
+        }
+        if (_cache_next < count) {
+            _cache_next += _logger_backend->WriteCriticalBlocks(&_header_cache.data(section)[_cache_next*size],
+                                                                size, count - _cache_next);
+            if (_cache_next < count) {
+                return false;
+            }
+        }
+        if (section == LoggerHeaderCache::Section::FORMATS) {
+            _fmt_done = true;
+        } else if (section == LoggerHeaderCache::Section::PARMS) {
+            _params_done = true;
+        }
+        _cache_section++;
+        _cache_next = 0;
+    }
+    return true;
+}
+
+void LoggerHeaderCache::clear()
+{
+    for (auto &s : _sections) {
+        free(s.data);
+        s.data = nullptr;
+        s.size = 0;
+        s.count = 0;
+        s.space = 0;
+    }
+    free(_params);
+    _params = nullptr;
+    _complete = false;
+}
+
+// make room for one more message in a section
+bool LoggerHeaderCache::grow(Section section, uint16_t size)
+{
+    auto &s = _sections[uint8_t(section)];
+    if (s.count > 0 && s.size != size) {
+        return false;
+    }
+    s.size = size;
+    if (s.count < s.space) {
+        return true;
+    }
+    if (s.space == UINT16_MAX) {
+        return false;
+    }
+    const uint16_t space = MIN(MAX(uint32_t(s.space) * 2, 64U), uint32_t(UINT16_MAX));
+    uint8_t *data = (uint8_t *)hal.util->std_realloc(s.data, uint32_t(space) * size);
+    if (data == nullptr) {
+        return false;
+    }
+    s.data = data;
+    if (section == Section::PARMS) {
+        ParamRef *params = (ParamRef *)hal.util->std_realloc(_params, space * sizeof(ParamRef));
+        if (params == nullptr) {
+            return false;
+        }
+        _params = params;
+    }
+    s.space = space;
+    return true;
+}
+
+bool LoggerHeaderCache::add(Section section, const void *pkt, uint16_t size)
+{
+    auto &s = _sections[uint8_t(section)];
+    if (!grow(section, size)) {
+        return false;
+    }
+    memcpy(&s.data[s.count*size], pkt, size);
+    s.count++;
+    return true;
+}
+
+bool LoggerHeaderCache::add_parameter(const struct log_Parameter &pkt, const AP_Param *ap, enum ap_var_type type)
+{
+    const uint16_t n = count(Section::PARMS);
+    if (!add(Section::PARMS, &pkt, sizeof(pkt))) {
+        return false;
+    }
+    _params[n].ap = ap;
+    _params[n].type = type;
+    return true;
+}
+
+bool LoggerHeaderCache::valid(const AP_Logger_Backend &backend) const
+{
+    return _complete &&
+        count(Section::FORMATS) == backend.num_types() &&
+        count(Section::FORMAT_UNITS) == backend.num_types() &&
+        count(Section::UNITS) == backend.num_units() &&
+        count(Section::MULTIPLIERS) == backend.num_multipliers() &&
+        count(Section::PARMS) == AP_Param::count_parameters();
+}
+
+void LoggerHeaderCache::refresh(Section section)
+{
+    if (section == Section::FORMATS) {
+        // FMT messages carry no timestamp
+        return;
+    }
+    auto &s = _sections[uint8_t(section)];
+    // the other messages all have time_us straight after the header
+    const uint8_t time_ofs = offsetof(struct log_Parameter, time_us);
+    const uint64_t now_us = AP_HAL::micros64();
+    for (uint16_t i=0; i<s.count; i++) {
+        uint8_t *pkt = &s.data[i*s.size];
+        memcpy(&pkt[time_ofs], &now_us, sizeof(now_us));
+        if (section == Section::PARMS) {
+            const float value = _params[i].ap->cast_to_float(_params[i].type);
+            memcpy(&pkt[offsetof(struct log_Parameter, value)], &value, sizeof(value));
+        }
+    }
+}
+#endif // HAL_LOGGER_HEADER_CACHE_ENABLED
+
 #if AP_MISSION_ENABLED
 bool LoggerMessageWriter_DFLogStart::writeentiremission()
 {
@@ -324,6 +523,13 @@ void LoggerMessageWriter_WriteSysInfo::process() {
         if (! _logger_backend->Write_MessageF("Param space used: %u/%u", AP_Param::storage_used(), AP_Param::storage_size())) {
             return; // call me again
         }
+        stage = Stage::PARAM_LOAD_TIME;
+        FALLTHROUGH;
+
+    case Stage::PARAM_LOAD_TIME:
+        if (! _logger_backend->Write_MessageF("Param load: %uus", (unsigned)AP_Param::load_all_time_us())) {
+            return; // call me again
+        }
         stage = Stage::RC_PROTOCOL;
         FALLTHROUGH;
 
@@ -22,6 +22,64 @@ protected:
 };
 
 
+/*
+  copies of the FMT, PARM, UNIT, MULT and FMTU messages written at the
+  start of a log. They are recorded as the first log after boot writes
+  them, so later logs can copy them to the backend in bulk rather than
+  walking the formats and AP_Param again. Parameter values and
+  timestamps are refreshed before each use
+ */
+class LoggerHeaderCache {
+public:
+    // in the order written to the log
+    enum class Section : uint8_t {
+        FORMATS = 0,
+        PARMS,
+        UNITS,
+        MULTIPLIERS,
+        FORMAT_UNITS,
+        NUM_SECTIONS
+    };
+
+    // forget all records and start recording again
+    void clear();
+
+    // append a message to a section, false if out of memory
+    bool add(Section section, const void *pkt, uint16_t size);
+    bool add_parameter(const struct log_Parameter &pkt, const AP_Param *ap, enum ap_var_type type);
+
+    // mark the recording complete
+    void set_complete(void) { _complete = true; }
+
+    // true if the recorded messages still match the backend and the parameters
+    bool valid(const class AP_Logger_Backend &backend) const;
+
+    // update the timestamps, and the values of parameters, of a section
+    void refresh(Section section);
+
+    const uint8_t *data(Section section) const { return _sections[uint8_t(section)].data; }
+    uint16_t count(Section section) const { return _sections[uint8_t(section)].count; }
+    uint16_t size(Section section) const { return _sections[uint8_t(section)].size; }
+
+private:
+    struct {
+        uint8_t *data;
+        uint16_t size;      // size of each message
+        uint16_t count;     // messages recorded
+        uint16_t space;     // messages allocated
+    } _sections[uint8_t(Section::NUM_SECTIONS)];
+
+    // the parameter of each PARM message
+    struct ParamRef {
+        const AP_Param *ap;
+        enum ap_var_type type;
+    } *_params;
+
+    bool _complete;
+
+    bool grow(Section section, uint16_t size);
+};
+
 class LoggerMessageWriter_WriteSysInfo : public LoggerMessageWriter {
 public:
 
@@ -35,6 +93,7 @@ private:
         VER,  // i.e. the "VER" message
         SYSTEM_ID,
         PARAM_SPACE_USED,
+        PARAM_LOAD_TIME,
         RC_PROTOCOL,
         RC_OUTPUT,
     };
@@ -154,11 +213,25 @@ private:
         MULTIPLIERS,
         FORMAT_UNITS,
         PARMS,
+#if HAL_LOGGER_HEADER_CACHE_ENABLED
+        CACHED_HEADER,  // FMT to FMTU copied from _header_cache
+#endif
         VEHICLE_MESSAGES,
         RUNNING_SUBWRITERS, // must be last thing to run as we can redo bits of these
         DONE,
     };
 
+#if HAL_LOGGER_HEADER_CACHE_ENABLED
+    LoggerHeaderCache _header_cache;
+    bool _recording_header;
+    uint8_t _cache_section;
+    uint16_t _cache_next;
+    bool write_cached_header();
+#endif
+
+    // write a header message, recording it in the header cache
+    bool write_header_message(LoggerHeaderCache::Section section, const void *pkt, uint16_t size);
+
     bool _fmt_done;
     bool _params_done;
 
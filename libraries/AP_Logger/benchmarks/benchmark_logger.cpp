@@ -0,0 +1,434 @@
+/*
+  benchmarks of the logging write path
+
+  Usage: benchmark_logger [benchmark options]
+
+  The front end logs to the File backend in a directory on tmpfs, so
+  the numbers are the cost of formatting and buffering each message
+  and not of the storage. s_per_msg is the CPU time per message.
+
+  The offered load benchmarks run in real time, a batch of messages
+  each millisecond, and report the share of messages dropped. On SITL
+  a Block backend on a flash chip simulated in RAM, with a page
+  program time to model slow chips, is run the same way.
+ */
+
+#include <AP_gbenchmark.h>
+
+#include <AP_HAL/AP_HAL.h>
+#include <AP_Logger/AP_Logger.h>
+#include <AP_Logger/AP_Logger_Block.h>
+#include <AP_Scheduler/AP_Scheduler.h>
+#include <GCS_MAVLink/GCS_Dummy.h>
+
+#include <ftw.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <vector>
+
+const AP_HAL::HAL& hal = AP_HAL::get_HAL();
+
+#define LOG_BENCH_MSG 1
+
+// a typical sensor message
+struct PACKED log_Bench {
+    LOG_PACKET_HEADER;
+    uint64_t time_us;
+    float a;
+    float b;
+    float c;
+    int32_t d;
+    uint16_t e;
+};
+
+static const struct LogStructure log_structure[] = {
+    LOG_COMMON_STRUCTURES,
+    { LOG_BENCH_MSG, sizeof(log_Bench),
+      "BNCH", "QfffiH", "TimeUS,A,B,C,D,E", "s-----", "F-----" },
+};
+
+// messages per iteration of the per message benchmarks
+static const uint16_t BATCH = 64;
+
+static AP_Int32 log_bitmask;
+static AP_Logger logger{log_bitmask};
+static AP_Scheduler scheduler;
+
+const AP_Param::GroupInfo GCS_MAVLINK_Parameters::var_info[] = {
+    AP_GROUPEND
+};
+static GCS_Dummy _gcs;
+
+static struct log_Bench bench_pkt(uint16_t i)
+{
+    const struct log_Bench pkt {
+        LOG_PACKET_HEADER_INIT(LOG_BENCH_MSG),
+        time_us : AP_HAL::micros64(),
+        a       : 1.5f * i,
+        b       : -2.5f,
+        c       : 0.125f,
+        d       : -17 * i,
+        e       : i
+    };
+    return pkt;
+}
+
+/*
+  give the IO thread time to write out the batch, so the messages are
+  buffered rather than dropped
+ */
+static void drain(benchmark::State &state)
+{
+    state.PauseTiming();
+    hal.scheduler->delay_microseconds(1000);
+    state.ResumeTiming();
+}
+
+static void set_msg_counters(benchmark::State &state, uint32_t dropped0)
+{
+    state.counters["s_per_msg"] = benchmark::Counter(BATCH, benchmark::Counter::kIsIterationInvariantRate | benchmark::Counter::kInvert);
+    state.counters["bytes_per_s"] = benchmark::Counter(BATCH * sizeof(log_Bench), benchmark::Counter::kIsIterationInvariantRate);
+    state.counters["dropped"] = logger.num_dropped() - dropped0;
+}
+
+/*
+  a message written as a struct
+ */
+static void BM_WriteBlock(benchmark::State &state)
+{
+    const uint32_t dropped0 = logger.num_dropped();
+    for (auto _ : state) {
+        for (uint16_t i=0; i<BATCH; i++) {
+            const struct log_Bench pkt = bench_pkt(i);
+            logger.WriteBlock(&pkt, sizeof(pkt));
+        }
+        drain(state);
+    }
+    set_msg_counters(state, dropped0);
+}
+BENCHMARK(BM_WriteBlock)->Iterations(2000);
+
+static void BM_WriteCriticalBlock(benchmark::State &state)
+{
+    const uint32_t dropped0 = logger.num_dropped();
+    for (auto _ : state) {
+        for (uint16_t i=0; i<BATCH; i++) {
+            const struct log_Bench pkt = bench_pkt(i);
+            logger.WriteCriticalBlock(&pkt, sizeof(pkt));
+        }
+        drain(state);
+    }
+    set_msg_counters(state, dropped0);
+}
+BENCHMARK(BM_WriteCriticalBlock)->Iterations(2000);
+
+/*
+  the same message written through the variadic Write(), which looks
+  up the format by name and packs the arguments
+ */
+static void BM_Write(benchmark::State &state)
+{
+    const uint32_t dropped0 = logger.num_dropped();
+    for (auto _ : state) {
+        for (uint16_t i=0; i<BATCH; i++) {
+            logger.Write("BNCV", "TimeUS,A,B,C,D,E", "QfffiH",
+                         AP_HAL::micros64(), 1.5f * i, -2.5f, 0.125f, int32_t(-17 * i), i);
+        }
+        drain(state);
+    }
+    set_msg_counters(state, dropped0);
+}
+BENCHMARK(BM_Write)->Iterations(2000);
+
+/*
+  Write() with the format kept in a handle at the call site
+ */
+static void BM_WriteHandle(benchmark::State &state)
+{
+    static AP_Logger::LogFormatHandle fmt { "BNCF", "TimeUS,A,B,C,D,E", "s-----", "F-----", "QfffiH" };
+    const uint32_t dropped0 = logger.num_dropped();
+    for (auto _ : state) {
+        for (uint16_t i=0; i<BATCH; i++) {
+            logger.Write(&fmt, AP_HAL::micros64(), 1.5f * i, -2.5f, 0.125f, int32_t(-17 * i), i);
+        }
+        drain(state);
+    }
+    set_msg_counters(state, dropped0);
+}
+BENCHMARK(BM_WriteHandle)->Iterations(2000);
+
+static void BM_WriteStreaming(benchmark::State &state)
+{
+    const uint32_t dropped0 = logger.num_dropped();
+    for (auto _ : state) {
+        for (uint16_t i=0; i<BATCH; i++) {
+            logger.WriteStreaming("BNCS", "TimeUS,A,B,C,D,E", "QfffiH",
+                                  AP_HAL::micros64(), 1.5f * i, -2.5f, 0.125f, int32_t(-17 * i), i);
+        }
+        drain(state);
+    }
+    set_msg_counters(state, dropped0);
+}
+BENCHMARK(BM_WriteStreaming)->Iterations(2000);
+
+/*
+  structure_for_msg_type() for the first and last entries of the
+  table and for a type which isn't in it
+ */
+enum class Lookup {
+    FIRST,
+    LAST,
+    ABSENT,
+};
+
+static void BM_StructureForMsgType(benchmark::State &state, Lookup which)
+{
+    uint8_t msg_type = log_structure[0].msg_type;
+    if (which == Lookup::LAST) {
+        msg_type = log_structure[ARRAY_SIZE(log_structure)-1].msg_type;
+    } else if (which == Lookup::ABSENT) {
+        while (logger.structure_for_msg_type(msg_type) != nullptr) {
+            msg_type++;
+        }
+    }
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(logger.structure_for_msg_type(msg_type));
+    }
+}
+BENCHMARK_CAPTURE(BM_StructureForMsgType, first, Lookup::FIRST);
+BENCHMARK_CAPTURE(BM_StructureForMsgType, last, Lookup::LAST);
+BENCHMARK_CAPTURE(BM_StructureForMsgType, absent, Lookup::ABSENT);
+
+/*
+  offer bytes_per_ms each millisecond of real time, returning the
+  number of messages offered. io() is called after each millisecond's
+  messages
+ */
+template <typename W, typename IO>
+static uint64_t offer_load(benchmark::State &state, uint32_t bytes_per_ms, W write, IO io)
+{
+    const uint16_t n = (bytes_per_ms + sizeof(log_Bench) - 1) / sizeof(log_Bench);
+    uint64_t offered = 0;
+    for (auto _ : state) {
+        const uint32_t start_us = AP_HAL::micros();
+        for (uint16_t i=0; i<n; i++) {
+            const struct log_Bench pkt = bench_pkt(i);
+            write(pkt);
+        }
+        offered += n;
+        io();
+        const uint32_t dt_us = AP_HAL::micros() - start_us;
+        if (dt_us < 1000) {
+            hal.scheduler->delay_microseconds(1000 - dt_us);
+        }
+    }
+    return offered;
+}
+
+static void set_load_counters(benchmark::State &state, uint64_t offered, uint64_t dropped)
+{
+    state.counters["drop_pct"] = offered ? 100.0 * dropped / offered : 0;
+    state.counters["bytes_per_s"] = benchmark::Counter((offered - dropped) * sizeof(log_Bench), benchmark::Counter::kIsRate);
+}
+
+/*
+  the File backend with its IO thread writing to tmpfs
+ */
+static void BM_FileOfferedLoad(benchmark::State &state)
+{
+    const uint32_t dropped0 = logger.num_dropped();
+    const uint64_t offered = offer_load(state, state.range(0), [](const struct log_Bench &pkt) {
+        logger.WriteBlock(&pkt, sizeof(pkt));
+    }, []() {
+        // the logger's own IO thread writes the file
+    });
+    set_load_counters(state, offered, logger.num_dropped() - dropped0);
+}
+BENCHMARK(BM_FileOfferedLoad)->ArgName("bytes_per_ms")->Arg(1000)->Arg(4000)->Arg(8000)
+    ->Iterations(2000)->UseRealTime()->Unit(benchmark::kMicrosecond);
+
+#if HAL_LOGGING_BLOCK_ENABLED
+/*
+  a Block backend on a 16MB flash chip simulated in RAM. Pages take
+  page_program_us to program and 64k blocks 150ms to erase, during
+  which the chip is busy
+ */
+class AP_Logger_RAMBlock : public AP_Logger_Block {
+public:
+    using AP_Logger_Block::AP_Logger_Block;
+
+    void Init(void) override {
+        chip = (uint8_t *)malloc(CHIP_SIZE);
+        if (chip != nullptr) {
+            memset(chip, 0xFF, CHIP_SIZE);
+            df_PageSize = 256;
+            df_PagePerBlock = 256;
+            df_PagePerSector = 16;
+            df_NumPages = CHIP_SIZE / df_PageSize;
+        }
+        AP_Logger_Block::Init();
+    }
+    bool CardInserted(void) const override { return chip != nullptr; }
+
+    uint32_t page_program_us = 0;
+
+private:
+    static const uint32_t CHIP_SIZE = 16*1024*1024;
+    static const uint32_t BLOCK_ERASE_US = 150000;
+
+    uint8_t *chip = nullptr;
+    uint64_t busy_until_us = 0;
+
+    void wait_ready() {
+        while (Busy()) {}
+    }
+    void set_busy(uint32_t us) {
+        busy_until_us = AP_HAL::micros64() + us;
+    }
+
+    void BufferToPage(uint32_t PageAdr) override {
+        wait_ready();
+        memcpy(&chip[(PageAdr-1) * df_PageSize], buffer, df_PageSize);
+        set_busy(page_program_us);
+    }
+    void PageToBuffer(uint32_t PageAdr) override {
+        wait_ready();
+        memcpy(buffer, &chip[(PageAdr-1) * df_PageSize], df_PageSize);
+    }
+    void SectorErase(uint32_t BlockAdr) override {
+        wait_ready();
+        const uint32_t size = df_PagePerBlock * df_PageSize;
+        memset(&chip[BlockAdr * size], 0xFF, size);
+        set_busy(BLOCK_ERASE_US);
+    }
+    void Sector4kErase(uint32_t SectorAdr) override {
+        wait_ready();
+        const uint32_t size = df_PagePerSector * df_PageSize;
+        memset(&chip[SectorAdr * size], 0xFF, size);
+    }
+    // chip erase is immediate, it only happens between runs
+    void StartErase() override {
+        memset(chip, 0xFF, CHIP_SIZE);
+    }
+    bool InErase() override { return Busy(); }
+    bool Busy() override { return AP_HAL::micros64() < busy_until_us; }
+};
+
+static LoggerMessageWriter_DFLogStart ramblock_writer;
+static AP_Logger_RAMBlock *ramblock;
+
+/*
+  erase the chip and start a new log, with the startup messages
+  written out, so that each run starts from the same state
+ */
+static bool ramblock_restart(uint32_t page_program_us)
+{
+    ramblock->page_program_us = page_program_us;
+    ramblock->EraseAll();
+    const uint32_t start_ms = AP_HAL::millis();
+    while (!ramblock->logging_started() || !ramblock->allow_start_ekf()) {
+        if (AP_HAL::millis() - start_ms > 10000) {
+            return false;
+        }
+        ramblock->io_timer();
+        const struct log_Bench pkt = bench_pkt(0);
+        ramblock->WriteBlock(&pkt, sizeof(pkt));
+    }
+    return true;
+}
+
+/*
+  the Block backend with io_timer() called after each millisecond's
+  messages, as the IO thread would. A page program time of zero is
+  the cost of the buffer handling alone
+ */
+static void BM_BlockOfferedLoad(benchmark::State &state)
+{
+    if (!ramblock_restart(state.range(0))) {
+        state.SkipWithError("log did not start");
+        return;
+    }
+    uint64_t dropped = 0;
+    const uint64_t offered = offer_load(state, state.range(1), [&dropped](const struct log_Bench &pkt) {
+        if (!ramblock->WriteBlock(&pkt, sizeof(pkt))) {
+            dropped++;
+        }
+    }, []() {
+        ramblock->io_timer();
+    });
+    set_load_counters(state, offered, dropped);
+}
+BENCHMARK(BM_BlockOfferedLoad)->ArgNames({"program_us", "bytes_per_ms"})
+    ->Args({0, 400})->Args({0, 2000})->Args({400, 400})->Args({700, 400})->Args({700, 2000})
+    ->Iterations(3000)->UseRealTime()->Unit(benchmark::kMicrosecond);
+#endif // HAL_LOGGING_BLOCK_ENABLED
+
+/*
+  remove the tmpfs log directory
+ */
+static int remove_entry(const char *path, const struct stat *st, int flag, struct FTW *ftw)
+{
+    return remove(path);
+}
+
+class LoggerBenchmark : public AP_HAL::HAL::Callbacks {
+public:
+    void setup() override;
+    void loop() override {}
+};
+
+void LoggerBenchmark::setup()
+{
+    uint8_t hal_argc;
+    char * const *hal_argv;
+    hal.util->commandline_arguments(hal_argc, hal_argv);
+
+    // google benchmark removes the options it understands
+    std::vector<char*> args(hal_argv, hal_argv + hal_argc);
+    int argc = hal_argc;
+    benchmark::Initialize(&argc, args.data());
+
+    // log to a directory in RAM
+    char dir[] = "/dev/shm/benchmark_logger.XXXXXX";
+    if (mkdtemp(dir) == nullptr || chdir(dir) != 0) {
+        ::printf("Unable to use %s\n", dir);
+        exit(1);
+    }
+
+    log_bitmask.set((uint32_t)-1);
+    logger._params.backend_types.set(1);  // File
+    logger._params.file_bufsize.set(64);
+    logger.Init(log_structure, ARRAY_SIZE(log_structure));
+
+    // the Block backend waits 2s after boot before writing
+    hal.scheduler->delay(2000);
+
+    logger.PrepForArming();
+    logger.set_vehicle_armed(true);
+    const uint32_t start_ms = AP_HAL::millis();
+    while (!logger.logging_started() || !logger.allow_start_ekf()) {
+        if (AP_HAL::millis() - start_ms > 10000) {
+            ::printf("Log did not start\n");
+            exit(1);
+        }
+        logger.periodic_tasks();
+        hal.scheduler->delay(1);
+    }
+
+#if HAL_LOGGING_BLOCK_ENABLED
+    ramblock = new AP_Logger_RAMBlock(logger, &ramblock_writer);
+    ramblock->Init();
+#endif
+
+    benchmark::RunSpecifiedBenchmarks();
+
+    logger.StopLogging();
+    if (chdir("/") == 0) {
+        nftw(dir, remove_entry, 16, FTW_DEPTH | FTW_PHYS);
+    }
+    exit(0);
+}
+
+static LoggerBenchmark logger_benchmark;
+
+AP_HAL_MAIN_CALLBACKS(&logger_benchmark);
@@ -0,0 +1,86 @@
+#include <AP_gtest.h>
+
+#include <AP_Logger/LogCompress.h>
+#include <AP_Math/AP_Math.h>
+
+const AP_HAL::HAL& hal = AP_HAL::get_HAL();
+
+#if HAL_LOGGER_COMPRESSION_ENABLED
+
+static uint16_t hash_table[AP_Logger_Compress::HASH_TABLE_SIZE/sizeof(uint16_t)];
+
+/*
+  fill buf with something like log data: repeated message headers and
+  timestamps with slowly changing fields
+ */
+static void fill_log_like(uint8_t *buf, uint32_t len)
+{
+    uint32_t t = 12345678;
+    for (uint32_t i=0; i<len; i++) {
+        switch (i % 16) {
+        case 0: buf[i] = 0xA3; break;
+        case 1: buf[i] = 0x95; break;
+        case 2: buf[i] = 70; break;
+        case 3: t += 2500; buf[i] = t & 0xFF; break;
+        case 4: buf[i] = (t >> 8) & 0xFF; break;
+        case 5: buf[i] = (t >> 16) & 0xFF; break;
+        default: buf[i] = (i / 256) ^ (i % 16); break;
+        }
+    }
+}
+
+/*
+  test that data compresses and decompresses to the original for a
+  range of lengths
+ */
+TEST(LogCompressTest, RoundTrip)
+{
+    static uint8_t src[4096], dst[4500], out[4096];
+    fill_log_like(src, sizeof(src));
+    for (uint32_t len : { 0U, 1U, 12U, 13U, 100U, 1000U, 4095U, 4096U }) {
+        const uint32_t n = AP_Logger_Compress::compress(src, len, dst, AP_Logger_Compress::max_compressed_size(len), hash_table);
+        if (len > 0) {
+            EXPECT_GT(n, 0U);
+        }
+        EXPECT_EQ(AP_Logger_Compress::decompress(dst, n, out, sizeof(out)), int32_t(len));
+        EXPECT_EQ(memcmp(src, out, len), 0);
+    }
+    // log-like data should compress well
+    const uint32_t n = AP_Logger_Compress::compress(src, sizeof(src), dst, sizeof(dst), hash_table);
+    EXPECT_LT(n, sizeof(src) / 2);
+}
+
+/*
+  test that random data which does not fit in the output gives zero,
+  so the caller stores it uncompressed
+ */
+TEST(LogCompressTest, Incompressible)
+{
+    static uint8_t src[4096], dst[4096];
+    for (uint32_t i=0; i<sizeof(src); i++) {
+        src[i] = get_random16();
+    }
+    EXPECT_EQ(AP_Logger_Compress::compress(src, sizeof(src), dst, sizeof(src)-1, hash_table), 0U);
+}
+
+/*
+  test that corrupt blocks are rejected without overrunning the output
+ */
+TEST(LogCompressTest, Corrupt)
+{
+    static uint8_t src[4096], dst[4500], out[4096];
+    fill_log_like(src, sizeof(src));
+    const uint32_t n = AP_Logger_Compress::compress(src, sizeof(src), dst, sizeof(dst), hash_table);
+    ASSERT_GT(n, 0U);
+    // truncated output buffer
+    EXPECT_EQ(AP_Logger_Compress::decompress(dst, n, out, sizeof(out)-1), -1);
+    // truncated block
+    EXPECT_NE(AP_Logger_Compress::decompress(dst, n-3, out, sizeof(out)), int32_t(sizeof(src)));
+    // match offset before the start of the output
+    const uint8_t bad[] = { 0x10, 'a', 0x05, 0x00, 0x00 };
+    EXPECT_EQ(AP_Logger_Compress::decompress(bad, sizeof(bad), out, sizeof(out)), -1);
+}
+
+#endif // HAL_LOGGER_COMPRESSION_ENABLED
+
+AP_GTEST_MAIN()
@@ -361,7 +361,7 @@ void AP_MSP_Telem_Backend::process_incoming_data()
 /*
   send an MSP packet
  */
-void AP_MSP_Telem_Backend::msp_send_packet(uint16_t cmd, MSP::msp_version_e msp_version, const void *p, uint16_t size, bool is_request)
+bool AP_MSP_Telem_Backend::msp_send_packet(uint16_t cmd, MSP::msp_version_e msp_version, const void *p, uint16_t size, bool is_request)
 {
     uint8_t out_buf[MSP_PORT_OUTBUF_SIZE];
 
@@ -374,7 +374,7 @@ void AP_MSP_Telem_Backend::msp_send_packet(uint16_t cmd, MSP::msp_version_e msp_
 
     sbuf_write_data(&pkt.buf, p, size);
     sbuf_switch_to_reader(&pkt.buf, &out_buf[0]);
-    msp_serial_encode(&_msp_port, &pkt, msp_version, is_request);
+    return msp_serial_encode(&_msp_port, &pkt, msp_version, is_request) > 0;
 }
 
 /*
@@ -1205,7 +1205,7 @@ void AP_MSP_Telem_Backend::msp_displayport_draw_screen()
     msp_send_packet(MSP_DISPLAYPORT, MSP::MSP_V1, subcmd, sizeof(subcmd), false);
 }
 
-void AP_MSP_Telem_Backend::msp_displayport_write_string(uint8_t col, uint8_t row, bool blink, const char *string)
+bool AP_MSP_Telem_Backend::msp_displayport_write_string(uint8_t col, uint8_t row, bool blink, const char *string)
 {
     const uint8_t len = strnlen(string, OSD_MSP_DISPLAYPORT_MAX_STRING_LENGTH);
 
@@ -1225,7 +1225,7 @@ void AP_MSP_Telem_Backend::msp_displayport_write_string(uint8_t col, uint8_t row
     }
     memcpy(packet.text, string, len);
 
-    msp_send_packet(MSP_DISPLAYPORT, MSP::MSP_V1, &packet, 4 + len, false);
+    return msp_send_packet(MSP_DISPLAYPORT, MSP::MSP_V1, &packet, 4 + len, false);
 }
 
 void AP_MSP_Telem_Backend::msp_displayport_set_options(const uint8_t font_index, const uint8_t screen_resolution)
@@ -88,7 +88,7 @@ public:
     virtual void msp_displayport_release();
     virtual void msp_displayport_clear_screen();
     virtual void msp_displayport_draw_screen();
-    virtual void msp_displayport_write_string(uint8_t col, uint8_t row, bool blink, const char *string);
+    virtual bool msp_displayport_write_string(uint8_t col, uint8_t row, bool blink, const char *string);
     virtual void msp_displayport_set_options(const uint8_t font_index, const uint8_t screen_resolution);
 #endif
 protected:
@@ -174,7 +174,7 @@ protected:
     MSP::MSPCommandResult msp_process_out_command(uint16_t cmd_msp, MSP::sbuf_t *dst);
 
     // MSP send
-    void msp_send_packet(uint16_t cmd, MSP::msp_version_e msp_version, const void *p, uint16_t size, bool is_request);
+    bool msp_send_packet(uint16_t cmd, MSP::msp_version_e msp_version, const void *p, uint16_t size, bool is_request);
 
     // MSP sensor command processing
     void msp_handle_opflow(const MSP::msp_opflow_data_message_t &pkt);
@@ -19,6 +19,7 @@
 #include "spline5.h"
 #include "location.h"
 #include "control.h"
+#include "fast_math.h"
 
 #if HAL_WITH_EKF_DOUBLE
 typedef Vector2<double> Vector2F;
@@ -115,6 +116,10 @@ void mat_mul(const T *A, const T *B, T *C, uint16_t n);
 template <typename T>
 bool mat_inverse(const T *x, T *y, uint16_t dim) WARN_IF_UNUSED;
 
+// fixed dimension matrix inverse, instantiated for N of 3, 4, 6 and 9
+template <typename T, uint16_t N>
+bool mat_inverse(const T *x, T *y) WARN_IF_UNUSED;
+
 // matrix identity
 template <typename T>
 void mat_identity(T *x, uint16_t dim);
@@ -52,6 +52,7 @@ void SCurve::init()
     vel_max = 0.0f;
     time = 0.0f;
     num_segs = SEG_INIT;
+    time_seg = SEG_INIT;
     add_segment(num_segs, 0.0f, SegmentType::CONSTANT_JERK, 0.0f, 0.0f, 0.0f, 0.0f);
     track.zero();
     delta_unit.zero();
@@ -621,6 +622,22 @@ float SCurve::time_turn_out() const
 void SCurve::advance_time(float dt)
 {
     time = MIN(time+dt, time_end());
+    time_seg = get_segment_at_time(time);
+}
+
+// return the index of the segment active at time_now, or num_segs if time_now is past the end of the path
+// segment end times are non-decreasing so the active segment is the first that ends after time_now
+// the search starts from the segment active at the current time so is O(1) as time advances
+uint8_t SCurve::get_segment_at_time(float time_now) const
+{
+    uint8_t pnt = MIN(time_seg, num_segs);
+    while ((pnt > 0) && (time_now < segment[pnt - 1].end_time)) {
+        pnt--;
+    }
+    while ((pnt < num_segs) && (time_now >= segment[pnt].end_time)) {
+        pnt++;
+    }
+    return pnt;
 }
 
 // calculate the jerk, acceleration, velocity and position at the provided time
@@ -636,19 +653,15 @@ void SCurve::get_jerk_accel_vel_pos_at_time(float time_now, float &Jt_out, float
     }
 
     SegmentType Jtype;
-    uint8_t pnt = num_segs;
-    float Jm, tj, T0, A0, V0, P0;
+    float Jm, tj, beta, T0, A0, V0, P0;
 
     // find active segment at time_now
-    for (uint8_t i = 0; i < num_segs; i++) {
-        if (time_now < segment[num_segs - 1 - i].end_time) {
-            pnt = num_segs - 1 - i;
-        }
-    }
+    const uint8_t pnt = get_segment_at_time(time_now);
     if (pnt == 0) {
         Jtype = SegmentType::CONSTANT_JERK;
         Jm = 0.0f;
         tj = 0.0f;
+        beta = 0.0f;
         T0 = segment[pnt].end_time;
         A0 = segment[pnt].end_accel;
         V0 = segment[pnt].end_vel;
@@ -657,6 +670,7 @@ void SCurve::get_jerk_accel_vel_pos_at_time(float time_now, float &Jt_out, float
         Jtype = SegmentType::CONSTANT_JERK;
         Jm = 0.0f;
         tj = 0.0f;
+        beta = 0.0f;
         T0 = segment[pnt - 1].end_time;
         A0 = segment[pnt - 1].end_accel;
         V0 = segment[pnt - 1].end_vel;
@@ -665,6 +679,7 @@ void SCurve::get_jerk_accel_vel_pos_at_time(float time_now, float &Jt_out, float
         Jtype = segment[pnt].seg_type;
         Jm = segment[pnt].jerk_ref;
         tj = segment[pnt].end_time - segment[pnt - 1].end_time;
+        beta = segment[pnt].beta;
         T0 = segment[pnt - 1].end_time;
         A0 = segment[pnt - 1].end_accel;
         V0 = segment[pnt - 1].end_vel;
@@ -676,10 +691,10 @@ void SCurve::get_jerk_accel_vel_pos_at_time(float time_now, float &Jt_out, float
         calc_javp_for_segment_const_jerk(time_now - T0, Jm, A0, V0, P0, Jt_out, At_out, Vt_out, Pt_out);
         break;
     case SegmentType::POSITIVE_JERK:
-        calc_javp_for_segment_incr_jerk(time_now - T0, tj, Jm, A0, V0, P0, Jt_out, At_out, Vt_out, Pt_out);
+        calc_javp_for_segment_incr_jerk(time_now - T0, tj, beta, Jm, A0, V0, P0, Jt_out, At_out, Vt_out, Pt_out);
         break;
     case SegmentType::NEGATIVE_JERK:
-        calc_javp_for_segment_decr_jerk(time_now - T0, tj, Jm, A0, V0, P0, Jt_out, At_out, Vt_out, Pt_out);
+        calc_javp_for_segment_decr_jerk(time_now - T0, tj, beta, Jm, A0, V0, P0, Jt_out, At_out, Vt_out, Pt_out);
         break;
     }
     Pt_out = MAX(0.0f, Pt_out);
@@ -695,9 +710,10 @@ void SCurve::calc_javp_for_segment_const_jerk(float time_now, float J0, float A0
 }
 
 // Calculate the jerk, acceleration, velocity and position at time time_now when running the increasing jerk magnitude time segment based on a raised cosine profile
-void SCurve::calc_javp_for_segment_incr_jerk(float time_now, float tj, float Jm, float A0, float V0, float P0, float &Jt, float &At, float &Vt, float &Pt) const
+// beta is the segment's precomputed raised cosine frequency, pi / tj
+void SCurve::calc_javp_for_segment_incr_jerk(float time_now, float tj, float beta, float Jm, float A0, float V0, float P0, float &Jt, float &At, float &Vt, float &Pt) const
 {
-    if (!is_positive(tj)) {
+    if (!is_positive(tj) || !is_positive(beta)) {
         Jt = 0.0;
         At = A0;
         Vt = V0;
@@ -705,17 +721,23 @@ void SCurve::calc_javp_for_segment_incr_jerk(float time_now, float tj, float Jm,
         return;
     }
     const float Alpha = Jm * 0.5f;
-    const float Beta = M_PI / tj;
-    Jt = Alpha * (1.0f - cosf(Beta * time_now));
-    At = A0 + Alpha * time_now - (Alpha / Beta) * sinf(Beta * time_now);
-    Vt = V0 + A0 * time_now + (Alpha * 0.5f) * (time_now * time_now) + (Alpha / (Beta * Beta)) * cosf(Beta * time_now) - Alpha / (Beta * Beta);
-    Pt = P0 + V0 * time_now + 0.5f * A0 * (time_now * time_now) + (-Alpha / (Beta * Beta)) * time_now + Alpha * (time_now * time_now * time_now) / 6.0f + (Alpha / (Beta * Beta * Beta)) * sinf(Beta * time_now);
+    const float Beta_inv = tj * (1.0f / M_PI);
+    const float Alpha_Beta = Alpha * Beta_inv;
+    const float Alpha_Beta2 = Alpha_Beta * Beta_inv;
+    const float Alpha_Beta3 = Alpha_Beta2 * Beta_inv;
+    const float sin_Bt = sinf(beta * time_now);
+    const float cos_Bt = cosf(beta * time_now);
+    Jt = Alpha * (1.0f - cos_Bt);
+    At = A0 + Alpha * time_now - Alpha_Beta * sin_Bt;
+    Vt = V0 + A0 * time_now + (Alpha * 0.5f) * (time_now * time_now) + Alpha_Beta2 * cos_Bt - Alpha_Beta2;
+    Pt = P0 + V0 * time_now + 0.5f * A0 * (time_now * time_now) - Alpha_Beta2 * time_now + Alpha * (time_now * time_now * time_now) / 6.0f + Alpha_Beta3 * sin_Bt;
 }
 
 // Calculate the jerk, acceleration, velocity and position at time time_now when running the decreasing jerk magnitude time segment based on a raised cosine profile
-void SCurve::calc_javp_for_segment_decr_jerk(float time_now, float tj, float Jm, float A0, float V0, float P0, float &Jt, float &At, float &Vt, float &Pt) const
+// beta is the segment's precomputed raised cosine frequency, pi / tj
+void SCurve::calc_javp_for_segment_decr_jerk(float time_now, float tj, float beta, float Jm, float A0, float V0, float P0, float &Jt, float &At, float &Vt, float &Pt) const
 {
-    if (!is_positive(tj)) {
+    if (!is_positive(tj) || !is_positive(beta)) {
         Jt = 0.0;
         At = A0;
         Vt = V0;
@@ -723,14 +745,20 @@ void SCurve::calc_javp_for_segment_decr_jerk(float time_now, float tj, float Jm,
         return;
     }
     const float Alpha = Jm * 0.5f;
-    const float Beta = M_PI / tj;
+    const float Beta_inv = tj * (1.0f / M_PI);
+    const float Alpha_Beta = Alpha * Beta_inv;
+    const float Alpha_Beta2 = Alpha_Beta * Beta_inv;
+    const float Alpha_Beta3 = Alpha_Beta2 * Beta_inv;
     const float AT = Alpha * tj;
-    const float VT = Alpha * ((tj * tj) * 0.5f - 2.0f / (Beta * Beta));
-    const float PT = Alpha * ((-1.0f / (Beta * Beta)) * tj + (1.0f / 6.0f) * (tj * tj * tj));
-    Jt = Alpha * (1.0f - cosf(Beta * (time_now + tj)));
-    At = (A0 - AT) + Alpha * (time_now + tj) - (Alpha / Beta) * sinf(Beta * (time_now + tj));
-    Vt = (V0 - VT) + (A0 - AT) * time_now + 0.5f * Alpha * (time_now + tj) * (time_now + tj) + (Alpha / (Beta * Beta)) * cosf(Beta * (time_now + tj)) - Alpha / (Beta * Beta);
-    Pt = (P0 - PT) + (V0 - VT) * time_now + 0.5f * (A0 - AT) * (time_now * time_now) + (-Alpha / (Beta * Beta)) * (time_now + tj) + (Alpha / 6.0f) * (time_now + tj) * (time_now + tj) * (time_now + tj) + (Alpha / (Beta * Beta * Beta)) * sinf(Beta * (time_now + tj));
+    const float VT = Alpha * (tj * tj) * 0.5f - 2.0f * Alpha_Beta2;
+    const float PT = -Alpha_Beta2 * tj + (Alpha / 6.0f) * (tj * tj * tj);
+    const float t = time_now + tj;
+    const float sin_Bt = sinf(beta * t);
+    const float cos_Bt = cosf(beta * t);
+    Jt = Alpha * (1.0f - cos_Bt);
+    At = (A0 - AT) + Alpha * t - Alpha_Beta * sin_Bt;
+    Vt = (V0 - VT) + (A0 - AT) * time_now + 0.5f * Alpha * t * t + Alpha_Beta2 * cos_Bt - Alpha_Beta2;
+    Pt = (P0 - PT) + (V0 - VT) * time_now + 0.5f * (A0 - AT) * (time_now * time_now) - Alpha_Beta2 * t + (Alpha / 6.0f) * t * t * t + Alpha_Beta3 * sin_Bt;
 }
 
 // generate the segments for a path of length L
@@ -975,7 +1003,7 @@ void SCurve::add_segment_incr_jerk(uint8_t &index, float tj, float Jm)
     const float A = segment[index - 1].end_accel + AT;
     const float V = segment[index - 1].end_vel + segment[index - 1].end_accel * tj + VT;
     const float P = segment[index - 1].end_pos + segment[index - 1].end_vel * tj + 0.5f * segment[index - 1].end_accel * sq(tj) + PT;
-    add_segment(index, T, SegmentType::POSITIVE_JERK, J, A, V, P);
+    add_segment(index, T, SegmentType::POSITIVE_JERK, J, A, V, P, Beta);
 }
 
 // generate decreasing jerk magnitude time segment based on a raised cosine profile
@@ -1007,13 +1035,15 @@ void SCurve::add_segment_decr_jerk(uint8_t &index, float tj, float Jm)
     const float A = (segment[index - 1].end_accel - AT) + A2T;
     const float V = (segment[index - 1].end_vel - VT) + (segment[index - 1].end_accel - AT) * tj + V2T;
     const float P = (segment[index - 1].end_pos - PT) + (segment[index - 1].end_vel - VT) * tj + 0.5f * (segment[index - 1].end_accel - AT) * sq(tj) + P2T;
-    add_segment(index, T, SegmentType::NEGATIVE_JERK, J, A, V, P);
+    add_segment(index, T, SegmentType::NEGATIVE_JERK, J, A, V, P, Beta);
 }
 
 // add single S-Curve segment
 // populate the information for the segment specified in the path by the index variable.
+// beta is the raised cosine frequency of jerk segments and only depends on the segment duration,
+// so it remains valid when later recalculations shift the segment in time or position
 // the index variable is incremented to reference the next segment in the array
-void SCurve::add_segment(uint8_t &index, float end_time, SegmentType seg_type, float jerk_ref, float end_accel, float end_vel, float end_pos)
+void SCurve::add_segment(uint8_t &index, float end_time, SegmentType seg_type, float jerk_ref, float end_accel, float end_vel, float end_pos, float beta)
 {
     segment[index].end_time = end_time;
     segment[index].seg_type = seg_type;
@@ -1021,6 +1051,7 @@ void SCurve::add_segment(uint8_t &index, float end_time, SegmentType seg_type, f
     segment[index].end_accel = end_accel;
     segment[index].end_vel = end_vel;
     segment[index].end_pos = end_pos;
+    segment[index].beta = beta;
     index++;
 }
 
@@ -141,14 +141,18 @@ private:
     // calculate the jerk, acceleration, velocity and position at time t
     void get_jerk_accel_vel_pos_at_time(float time_now, float &Jt_out, float &At_out, float &Vt_out, float &Pt_out) const;
 
+    // return the index of the segment active at time_now, or num_segs if time_now is past the end of the path
+    // the search starts from the segment active at the current time so is O(1) as time advances
+    uint8_t get_segment_at_time(float time_now) const WARN_IF_UNUSED;
+
     // calculate the jerk, acceleration, velocity and position at time t when running the constant jerk time segment
     void calc_javp_for_segment_const_jerk(float time_now, float J0, float A0, float V0, float P0, float &Jt, float &At, float &Vt, float &Pt) const;
 
     // Calculate the jerk, acceleration, velocity and position at time t when running the increasing jerk magnitude time segment based on a raised cosine profile
-    void calc_javp_for_segment_incr_jerk(float time_now, float tj, float Jm, float A0, float V0, float P0, float &Jt, float &At, float &Vt, float &Pt) const;
+    void calc_javp_for_segment_incr_jerk(float time_now, float tj, float beta, float Jm, float A0, float V0, float P0, float &Jt, float &At, float &Vt, float &Pt) const;
 
     // Calculate the jerk, acceleration, velocity and position at time t when running the decreasing jerk magnitude time segment based on a raised cosine profile
-    void calc_javp_for_segment_decr_jerk(float time_now, float tj, float Jm, float A0, float V0, float P0, float &Jt, float &At, float &Vt, float &Pt) const;
+    void calc_javp_for_segment_decr_jerk(float time_now, float tj, float beta, float Jm, float A0, float V0, float P0, float &Jt, float &At, float &Vt, float &Pt) const;
 
     // generate time segments for straight segment
     void add_segments(float L);
@@ -188,7 +192,7 @@ private:
     };
 
     // add single segment
-    void add_segment(uint8_t &seg_pnt, float end_time, SegmentType seg_type, float jerk_ref, float end_accel, float end_vel, float end_pos);
+    void add_segment(uint8_t &seg_pnt, float end_time, SegmentType seg_type, float jerk_ref, float end_accel, float end_vel, float end_pos, float beta = 0.0f);
 
     // members
     float snap_max;     // maximum snap magnitude
@@ -206,6 +210,7 @@ private:
     const static uint8_t segments_max = 23; // maximum number of time segments
 
     uint8_t num_segs;       // number of time segments being used
+    uint8_t time_seg;       // index of the segment active at time, used as the starting point for segment lookups
     struct {
         float jerk_ref;     // jerk reference value for time segment (the jerk at the beginning, middle or end depending upon the segment type)
         SegmentType seg_type;   // segment type (jerk is constant, increasing or decreasing)
@@ -213,6 +218,7 @@ private:
         float end_accel;    // final acceleration value for segment
         float end_vel;      // final velocity value for segment
         float end_pos;      // final position value for segment
+        float beta;         // raised cosine frequency (pi / segment duration), zero for constant jerk segments
     } segment[segments_max];
 
     Vector3f track;       // total change in position from origin to destination
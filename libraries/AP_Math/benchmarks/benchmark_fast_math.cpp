@@ -0,0 +1,86 @@
+#include <AP_gbenchmark.h>
+
+#include <AP_Math/AP_Math.h>
+
+const AP_HAL::HAL& hal = AP_HAL::get_HAL();
+
+static void BM_SinCosLibm(benchmark::State& state)
+{
+    float x = 0.3f;
+
+    while (state.KeepRunning()) {
+        gbenchmark_escape(&x);
+        float s = sinf(x);
+        float c = cosf(x);
+        gbenchmark_escape(&s);
+        gbenchmark_escape(&c);
+    }
+}
+
+static void BM_SinCosApprox(benchmark::State& state)
+{
+    float x = 0.3f;
+
+    while (state.KeepRunning()) {
+        gbenchmark_escape(&x);
+        float s, c;
+        sincosf_approx(x, s, c);
+        gbenchmark_escape(&s);
+        gbenchmark_escape(&c);
+    }
+}
+
+static void BM_Atan2Libm(benchmark::State& state)
+{
+    float y = 0.3f, x = -0.7f;
+
+    while (state.KeepRunning()) {
+        gbenchmark_escape(&y);
+        gbenchmark_escape(&x);
+        float a = atan2f(y, x);
+        gbenchmark_escape(&a);
+    }
+}
+
+static void BM_Atan2Approx(benchmark::State& state)
+{
+    float y = 0.3f, x = -0.7f;
+
+    while (state.KeepRunning()) {
+        gbenchmark_escape(&y);
+        gbenchmark_escape(&x);
+        float a = atan2f_approx(y, x);
+        gbenchmark_escape(&a);
+    }
+}
+
+static void BM_AcosLibm(benchmark::State& state)
+{
+    float x = 0.9f;
+
+    while (state.KeepRunning()) {
+        gbenchmark_escape(&x);
+        float a = acosf(x);
+        gbenchmark_escape(&a);
+    }
+}
+
+static void BM_AcosApprox(benchmark::State& state)
+{
+    float x = 0.9f;
+
+    while (state.KeepRunning()) {
+        gbenchmark_escape(&x);
+        float a = acosf_approx(x);
+        gbenchmark_escape(&a);
+    }
+}
+
+BENCHMARK(BM_SinCosLibm);
+BENCHMARK(BM_SinCosApprox);
+BENCHMARK(BM_Atan2Libm);
+BENCHMARK(BM_Atan2Approx);
+BENCHMARK(BM_AcosLibm);
+BENCHMARK(BM_AcosApprox);
+
+BENCHMARK_MAIN();
@@ -19,6 +19,76 @@ static void BM_MatrixMultiplication(benchmark::State& state)
     }
 }
 
+static void BM_MatrixVectorMultiplication(benchmark::State& state)
+{
+    Matrix3f m;
+    m.from_euler(radians(10), radians(20), radians(30));
+    Vector3f v(1.0f, 2.0f, 3.0f);
+
+    while (state.KeepRunning()) {
+        Vector3f v2 = m * v;
+        gbenchmark_escape(&v2);
+        gbenchmark_escape(&m);
+    }
+}
+
+static void BM_MatrixMulTranspose(benchmark::State& state)
+{
+    Matrix3f m;
+    m.from_euler(radians(10), radians(20), radians(30));
+    Vector3f v(1.0f, 2.0f, 3.0f);
+
+    while (state.KeepRunning()) {
+        Vector3f v2 = m.mul_transpose(v);
+        gbenchmark_escape(&v2);
+        gbenchmark_escape(&m);
+    }
+}
+
+static void BM_QuaternionEarthToBody(benchmark::State& state)
+{
+    Quaternion q;
+    q.from_euler(radians(10), radians(20), radians(30));
+    Vector3f v(1.0f, 2.0f, 3.0f);
+
+    while (state.KeepRunning()) {
+        Vector3f v2 = v;
+        q.earth_to_body(v2);
+        gbenchmark_escape(&v2);
+        gbenchmark_escape(&q);
+    }
+}
+
+static void BM_QuaternionRotate(benchmark::State& state)
+{
+    Quaternion q;
+    q.from_euler(radians(10), radians(20), radians(30));
+    const Vector3f rot(0.001f, -0.002f, 0.003f);
+
+    while (state.KeepRunning()) {
+        q.rotate(rot);
+        gbenchmark_escape(&q);
+    }
+}
+
+static void BM_QuaternionNormalize(benchmark::State& state)
+{
+    Quaternion q;
+    q.from_euler(radians(10), radians(20), radians(30));
+
+    while (state.KeepRunning()) {
+        Quaternion q2 = q;
+        q2.normalize();
+        gbenchmark_escape(&q2);
+        gbenchmark_escape(&q);
+    }
+}
+
 BENCHMARK(BM_MatrixMultiplication);
+BENCHMARK(BM_MatrixVectorMultiplication);
+BENCHMARK(BM_MatrixMulTranspose);
+BENCHMARK(BM_QuaternionEarthToBody);
+BENCHMARK(BM_QuaternionRotate);
+BENCHMARK(BM_QuaternionNormalize);
 
 BENCHMARK_MAIN();
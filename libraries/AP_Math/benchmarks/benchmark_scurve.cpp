@@ -0,0 +1,54 @@
+#include <AP_gbenchmark.h>
+
+#include <AP_Math/AP_Math.h>
+#include <AP_Math/SCurve.h>
+
+const AP_HAL::HAL& hal = AP_HAL::get_HAL();
+
+static void setup_legs(SCurve &this_leg, SCurve &next_leg)
+{
+    this_leg.calculate_track(Vector3f(0, 0, 0), Vector3f(1000, 0, 0), 500, 250, 150, 100, 50, 1000, 500);
+    next_leg.calculate_track(Vector3f(1000, 0, 0), Vector3f(1000, 1000, -200), 500, 250, 150, 100, 50, 1000, 500);
+}
+
+// a full leg with a fast waypoint turn onto the next leg
+static void BM_SCurveAdvanceTargetAlongTrack(benchmark::State& state)
+{
+    SCurve prev_leg, this_leg, next_leg;
+
+    while (state.KeepRunning()) {
+        state.PauseTiming();
+        prev_leg.init();
+        setup_legs(this_leg, next_leg);
+        Vector3f pos, vel, accel;
+        state.ResumeTiming();
+        bool finished = false;
+        for (uint16_t i=0; i<10000 && !finished; i++) {
+            finished = this_leg.advance_target_along_track(prev_leg, next_leg, 200, 250, true, 0.0025f, pos, vel, accel);
+        }
+        gbenchmark_escape(&pos);
+    }
+}
+
+static void BM_SCurveSetSpeedMax(benchmark::State& state)
+{
+    SCurve prev_leg, this_leg, next_leg;
+
+    while (state.KeepRunning()) {
+        state.PauseTiming();
+        prev_leg.init();
+        setup_legs(this_leg, next_leg);
+        Vector3f pos, vel, accel;
+        for (uint16_t i=0; i<400; i++) {
+            IGNORE_RETURN(this_leg.advance_target_along_track(prev_leg, next_leg, 200, 250, true, 0.0025f, pos, vel, accel));
+        }
+        state.ResumeTiming();
+        this_leg.set_speed_max(300, 250, 150);
+        gbenchmark_escape(&this_leg);
+    }
+}
+
+BENCHMARK(BM_SCurveAdvanceTargetAlongTrack);
+BENCHMARK(BM_SCurveSetSpeedMax);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,137 @@
+#pragma once
+
+/*
+  polynomial approximations of the float trig functions
+
+  The *_approx() functions are always available. They avoid the libm
+  calls, range checks and errno handling, which are a significant part
+  of the cost of the controllers on boards with a single precision FPU.
+  Bounds on the absolute error, measured against the double precision
+  libm functions by test_fast_math, are:
+
+    sinf_approx, cosf_approx, sincosf_approx   1.0e-7 for |x| <= 8192
+    atan2f_approx                              3.0e-7
+    acosf_approx                               4.5e-7 for -1 <= x <= 1
+
+  Outside |x| <= 8192 the sin and cos approximations fall back to
+  libm. acosf_approx() constrains its argument to -1 to 1.
+  atan2f_approx(0, 0) is 0, as is atan2f_approx(0, -0), where libm
+  gives pi.
+
+  Call sites which can accept these bounds use the fast_*() functions,
+  which are the approximations when AP_MATH_FAST_TRIG_ENABLED is set
+  for the build and the libm functions otherwise. sqrtf needs no
+  approximation as it is a single instruction on all supported FPUs.
+ */
+
+#include <math.h>
+#include <stdint.h>
+
+#ifndef AP_MATH_FAST_TRIG_ENABLED
+#define AP_MATH_FAST_TRIG_ENABLED 0
+#endif
+
+// sin and cos of x together, x in radians
+static inline void sincosf_approx(float x, float &s, float &c)
+{
+    if (fabsf(x) > 8192.0f) {
+        // the range reduction loses accuracy beyond this
+        s = sinf(x);
+        c = cosf(x);
+        return;
+    }
+
+    // reduce to -pi/4 to pi/4 in quadrant q, subtracting pi/2 in three
+    // parts so the reduction is exact for the range above
+    const int32_t q = int32_t(x * 0.63661977236758134f + (x >= 0 ? 0.5f : -0.5f));
+    const float qf = float(q);
+    const float r = ((x - qf * 1.5703125f) - qf * 4.837512969970703125e-4f) - qf * 7.54978995489188216e-8f;
+    const float z = r * r;
+
+    // minimax polynomials on -pi/4 to pi/4
+    const float sr = r + r * z * ((-1.9515295891e-4f * z + 8.3321608736e-3f) * z - 1.6666654611e-1f);
+    const float cr = 1.0f - 0.5f * z + z * z * ((2.443315711809948e-5f * z - 1.388731625493765e-3f) * z + 4.166664568298827e-2f);
+
+    // rotate by the quadrant
+    const bool odd = (q & 1) != 0;
+    const float sq = odd ? cr : sr;
+    const float cq = odd ? sr : cr;
+    s = (q & 2) ? -sq : sq;
+    c = ((q + 1) & 2) ? -cq : cq;
+}
+
+static inline float sinf_approx(float x)
+{
+    float s, c;
+    sincosf_approx(x, s, c);
+    return s;
+}
+
+static inline float cosf_approx(float x)
+{
+    float s, c;
+    sincosf_approx(x, s, c);
+    return c;
+}
+
+// atan2 of y and x in radians, -pi to pi
+static inline float atan2f_approx(float y, float x)
+{
+    const float ax = fabsf(x);
+    const float ay = fabsf(y);
+    if (ax == 0 && ay == 0) {
+        return 0;
+    }
+
+    // atan of t in 0 to 1, reduced to -tan(pi/8) to tan(pi/8)
+    const bool swapped = ay > ax;
+    float t = swapped ? ax / ay : ay / ax;
+    float ret = 0;
+    if (t > 0.41421356237309505f) {
+        ret = 0.78539816339744831f;
+        t = (t - 1.0f) / (t + 1.0f);
+    }
+    const float z = t * t;
+    ret += (((8.05374449538e-2f * z - 1.38776856032e-1f) * z + 1.99777106478e-1f) * z - 3.33329491539e-1f) * z * t + t;
+
+    if (swapped) {
+        ret = 1.57079632679489662f - ret;
+    }
+    if (x < 0) {
+        ret = 3.14159265358979324f - ret;
+    }
+    return (y < 0) ? -ret : ret;
+}
+
+// acos of x in radians, x constrained to -1 to 1
+static inline float acosf_approx(float x)
+{
+    const bool negative = x < 0;
+    float ax = fabsf(x);
+    if (ax > 1.0f) {
+        ax = 1.0f;
+    }
+    // Abramowitz and Stegun 4.4.46
+    const float p = ((((((-0.0012624911f * ax + 0.0066700901f) * ax - 0.0170881256f) * ax + 0.0308918810f) * ax
+                       - 0.0501743046f) * ax + 0.0889789874f) * ax - 0.2145988016f) * ax + 1.5707963050f;
+    const float ret = sqrtf(1.0f - ax) * p;
+    return negative ? 3.14159265358979324f - ret : ret;
+}
+
+#if AP_MATH_FAST_TRIG_ENABLED
+static inline void fast_sincosf(float x, float &s, float &c) { sincosf_approx(x, s, c); }
+static inline float fast_sinf(float x) { return sinf_approx(x); }
+static inline float fast_cosf(float x) { return cosf_approx(x); }
+static inline float fast_atan2f(float y, float x) { return atan2f_approx(y, x); }
+static inline float fast_acosf(float x) { return acosf_approx(x); }
+#else
+static inline void fast_sincosf(float x, float &s, float &c)
+{
+    s = sinf(x);
+    c = cosf(x);
+}
+static inline float fast_sinf(float x) { return sinf(x); }
+static inline float fast_cosf(float x) { return cosf(x); }
+static inline float fast_atan2f(float y, float x) { return atan2f(y, x); }
+static inline float fast_acosf(float x) { return acosf(x); }
+#endif
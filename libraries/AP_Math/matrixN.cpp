@@ -5,6 +5,7 @@
 #pragma GCC optimize("O2")
 
 #include "matrixN.h"
+#include "AP_Math.h"
 
 
 // multiply two vectors to give a matrix, in-place
@@ -42,6 +43,13 @@ MatrixN<T,N> &MatrixN<T,N>::operator +=(const MatrixN<T,N> &B)
     return *this;
 }
 
+// calculate the inverse of this matrix
+template <typename T, uint8_t N>
+bool MatrixN<T,N>::inverse(MatrixN<T,N> &inv) const
+{
+    return mat_inverse<T,N>(&v[0][0], &inv.v[0][0]);
+}
+
 // Matrix symmetry routine
 template <typename T, uint8_t N>
 void MatrixN<T,N>::force_symmetry(void)
@@ -58,3 +66,4 @@ template void MatrixN<float,4>::mult(const VectorN<float,4> &A, const VectorN<fl
 template MatrixN<float,4> &MatrixN<float,4>::operator -=(const MatrixN<float,4> &B);
 template MatrixN<float,4> &MatrixN<float,4>::operator +=(const MatrixN<float,4> &B);
 template void MatrixN<float,4>::force_symmetry(void);
+template bool MatrixN<float,4>::inverse(MatrixN<float,4> &inv) const;
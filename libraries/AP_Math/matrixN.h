@@ -43,6 +43,10 @@ public:
     // Matrix symmetry routine
     void force_symmetry(void);
 
+    // calculate the inverse of this matrix without using the heap
+    // returns false if the matrix is singular
+    bool inverse(MatrixN<T,N> &inv) const;
+
 private:
     T v[N][N];
 };
@@ -24,29 +24,8 @@
 #include <fenv.h>
 #endif
 
-/*
- *    Does matrix multiplication of two regular/square matrices
- *
- *    @param     A,           Matrix A
- *    @param     B,           Matrix B
- *    @param     n,           dimemsion of square matrices
- *    @returns                multiplied matrix i.e. A*B
- */
-template<typename T>
-static T* matrix_multiply(const T *A, const T *B, uint16_t n)
-{
-    T* ret = new T[n*n];
-    memset(ret,0.0f,n*n*sizeof(T));
-
-    for(uint16_t i = 0; i < n; i++) {
-        for(uint16_t j = 0; j < n; j++) {
-            for(uint16_t k = 0;k < n; k++) {
-                ret[i*n + j] += A[i*n + k] * B[k*n + j];
-            }
-        }
-    }
-    return ret;
-}
+// largest matrix inverted by mat_inverse() without using the heap
+#define MAT_INVERSE_MAX_STACK_DIM 9
 
 template<typename T>
 static inline void swap(T &a, T &b)
@@ -58,179 +37,155 @@ static inline void swap(T &a, T &b)
 }
 
 /*
- *    calculates pivot matrix such that all the larger elements in the row are on diagonal
+ *    calculates the row permutation such that all the larger elements in the row are on diagonal
  *
  *    @param     A,           input matrix matrix
- *    @param     pivot
+ *    @param     perm,        row of A used for each row of the pivoted matrix
  *    @param     n,           dimenstion of square matrix
- *    @returns                false = matrix is Singular or non positive definite, true = matrix inversion successful
  */
 template<typename T>
-static void mat_pivot(const T* A, T* pivot, uint16_t n)
+static void mat_pivot(const T* A, uint8_t* perm, uint16_t n)
 {
     for(uint16_t i = 0;i<n;i++){
-        for(uint16_t j=0;j<n;j++) {
-            pivot[i*n+j] = static_cast<T>(i==j);
-        }
+        perm[i] = i;
     }
 
     for(uint16_t i = 0;i < n; i++) {
         uint16_t max_j = i;
         for(uint16_t j=i;j<n;j++){
-            if (std::is_same<T, double>::value) {
-                if(fabsF(A[j*n + i]) > fabsF(A[max_j*n + i])) {
-                    max_j = j;
-                }
-            } else {
-                if(fabsF(A[j*n + i]) > fabsF(A[max_j*n + i])) {
-                    max_j = j;
-                }
+            if(fabsF(A[j*n + i]) > fabsF(A[max_j*n + i])) {
+                max_j = j;
             }
         }
 
         if(max_j != i) {
-            for(uint16_t k = 0; k < n; k++) {
-                swap(pivot[i*n + k], pivot[max_j*n + k]);
-            }
+            swap(perm[i], perm[max_j]);
         }
     }
 }
 
 /*
- *    calculates matrix inverse of Lower trangular matrix using forward substitution
+ *    calculates matrix inverse of the unit Lower trangular matrix held
+ *    below the diagonal of LU using forward substitution
  *
- *    @param     L,           lower triangular matrix
+ *    @param     LU,          LU decomposed matrix
  *    @param     out,         Output inverted lower triangular matrix
  *    @param     n,           dimension of matrix
  */
 template<typename T>
-static void mat_forward_sub(const T *L, T *out, uint16_t n)
+static void mat_forward_sub(const T *LU, T *out, uint16_t n)
 {
     // Forward substitution solve LY = I
     for(int i = 0; i < n; i++) {
-        out[i*n + i] = 1/L[i*n + i];
+        out[i*n + i] = 1;
         for (int j = i+1; j < n; j++) {
             for (int k = i; k < j; k++) {
-                out[j*n + i] -= L[j*n + k] * out[k*n + i];
+                out[j*n + i] -= LU[j*n + k] * out[k*n + i];
             }
-            out[j*n + i] /= L[j*n + j];
         }
     }
 }
 
 /*
- *    calculates matrix inverse of Upper trangular matrix using backward substitution
+ *    calculates matrix inverse of the Upper trangular matrix held on
+ *    and above the diagonal of LU using backward substitution
  *
- *    @param     U,           upper triangular matrix
+ *    @param     LU,          LU decomposed matrix
  *    @param     out,         Output inverted upper triangular matrix
  *    @param     n,           dimension of matrix
  */
 template<typename T>
-static void mat_back_sub(const T *U, T *out, uint16_t n)
+static void mat_back_sub(const T *LU, T *out, uint16_t n)
 {
     // Backward Substitution solve UY = I
     for(int i = n-1; i >= 0; i--) {
-        out[i*n + i] = 1/U[i*n + i];
+        out[i*n + i] = 1/LU[i*n + i];
         for (int j = i - 1; j >= 0; j--) {
             for (int k = i; k > j; k--) {
-                out[j*n + i] -= U[j*n + k] * out[k*n + i];
+                out[j*n + i] -= LU[j*n + k] * out[k*n + i];
             }
-            out[j*n + i] /= U[j*n + j];
+            out[j*n + i] /= LU[j*n + j];
         }
     }
 }
 
 /*
  *    Decomposes square matrix into Lower and Upper triangular matrices such that
- *    A*P = L*U, where P is the pivot matrix
+ *    P*A = L*U, where P is the pivot matrix. L has a unit diagonal, so
+ *    both are held in one matrix with L below the diagonal
  *    ref: http://rosettacode.org/wiki/LU_decomposition
- *    @param     U,           upper triangular matrix
- *    @param     out,         Output inverted upper triangular matrix
+ *    @param     A,           input matrix
+ *    @param     LU,          Output decomposed matrix
+ *    @param     perm,        row permutation from mat_pivot
  *    @param     n,           dimension of matrix
  */
 template<typename T>
-static void mat_LU_decompose(const T* A, T* L, T* U, T *P, uint16_t n)
+static void mat_LU_decompose(const T* A, T* LU, const uint8_t *perm, uint16_t n)
 {
-    memset(L,0,n*n*sizeof(T));
-    memset(U,0,n*n*sizeof(T));
-    memset(P,0,n*n*sizeof(T));
-    mat_pivot(A,P,n);
-
-    T *APrime = matrix_multiply(P,A,n);
-    for(uint16_t i = 0; i < n; i++) {
-        L[i*n + i] = 1;
-    }
     for(uint16_t i = 0; i < n; i++) {
         for(uint16_t j = 0; j < n; j++) {
-            if(j <= i) {    
-                U[j*n + i] = APrime[j*n + i];
+            // element of the pivoted matrix
+            const T a = A[perm[j]*n + i];
+            if(j <= i) {
+                LU[j*n + i] = a;
                 for(uint16_t k = 0; k < j; k++) {
-                    U[j*n + i] -= L[j*n + k] * U[k*n + i]; 
+                    LU[j*n + i] -= LU[j*n + k] * LU[k*n + i];
                 }
-            }
-            if(j >= i) {
-                L[j*n + i] = APrime[j*n + i];
+            } else {
+                LU[j*n + i] = a;
                 for(uint16_t k = 0; k < i; k++) {
-                    L[j*n + i] -= L[j*n + k] * U[k*n + i]; 
+                    LU[j*n + i] -= LU[j*n + k] * LU[k*n + i];
                 }
-                L[j*n + i] /= U[i*n + i];
+                LU[j*n + i] /= LU[i*n + i];
             }
         }
     }
-    delete[] APrime;
 }
 
 /*
  *    matrix inverse code for any square matrix using LU decomposition
  *    inv = inv(U)*inv(L)*P, where L and U are triagular matrices and P the pivot matrix
  *    ref: http://www.cl.cam.ac.uk/teaching/1314/NumMethods/supporting/mcmaster-kiruba-ludecomp.pdf
- *    @param     m,           input 4x4 matrix
- *    @param     inv,      Output inverted 4x4 matrix
+ *    @param     A,           input matrix
+ *    @param     inv,         Output inverted matrix, may be the same as A
  *    @param     n,           dimension of square matrix
+ *    @param     work,        working space of 3*n*n elements
+ *    @param     perm,        working space of n elements
  *    @returns                false = matrix is Singular, true = matrix inversion successful
  */
 template<typename T>
-static bool mat_inverseN(const T* A, T* inv, uint16_t n)
+static bool mat_inverseN(const T* A, T* inv, uint16_t n, T *work, uint8_t *perm)
 {
-    T *L, *U, *P;
-    bool ret = true;
-    L = new T[n*n];
-    U = new T[n*n];
-    P = new T[n*n];
-    mat_LU_decompose(A,L,U,P,n);
+    T *LU = &work[0];
+    T *L_inv = &work[n*n];
+    T *U_inv = &work[2*n*n];
 
-    T *L_inv = new T[n*n];
-    T *U_inv = new T[n*n];
+    mat_pivot(A,perm,n);
+    mat_LU_decompose(A,LU,perm,n);
 
     memset(L_inv,0,n*n*sizeof(T));
-    mat_forward_sub(L,L_inv,n);
+    mat_forward_sub(LU,L_inv,n);
 
     memset(U_inv,0,n*n*sizeof(T));
-    mat_back_sub(U,U_inv,n);
-
-    // decomposed matrices no longer required
-    delete[] L;
-    delete[] U;
-
-    T *inv_unpivoted = matrix_multiply(U_inv,L_inv,n);
-    T *inv_pivoted = matrix_multiply(inv_unpivoted, P, n);
+    mat_back_sub(LU,U_inv,n);
 
-    //check sanity of results
+    // inv = inv(U)*inv(L)*P, where multiplying by P moves column k
+    // to column perm[k]. A is no longer used, so this can be
+    // written in place
+    bool ret = true;
     for(uint16_t i = 0; i < n; i++) {
-        for(uint16_t j = 0; j < n; j++) {
-            if(isnan(inv_pivoted[i*n+j]) || isinf(inv_pivoted[i*n+j])){
+        for(uint16_t k = 0; k < n; k++) {
+            T sum = 0;
+            for(uint16_t j = 0; j < n; j++) {
+                sum += U_inv[i*n + j] * L_inv[j*n + k];
+            }
+            //check sanity of results
+            if(isnan(sum) || isinf(sum)) {
                 ret = false;
             }
+            inv[i*n + perm[k]] = sum;
         }
     }
-    memcpy(inv,inv_pivoted,n*n*sizeof(T));
-
-    //free memory
-    delete[] inv_pivoted;
-    delete[] inv_unpivoted;
-    delete[] P;
-    delete[] U_inv;
-    delete[] L_inv;
     return ret;
 }
 
@@ -440,7 +395,48 @@ bool mat_inverse(const T x[], T y[], uint16_t dim)
     switch(dim){
     case 3: return inverse3x3(x,y);
     case 4: return inverse4x4(x,y);
-    default: return mat_inverseN(x,y,dim);
+    default:
+        break;
+    }
+    if (dim <= MAT_INVERSE_MAX_STACK_DIM) {
+        // the working space for the matrix sizes we use is small
+        // enough to keep on the stack
+        T work[3*MAT_INVERSE_MAX_STACK_DIM*MAT_INVERSE_MAX_STACK_DIM];
+        uint8_t perm[MAT_INVERSE_MAX_STACK_DIM];
+        return mat_inverseN(x,y,dim,work,perm);
+    }
+    if (dim > UINT8_MAX) {
+        return false;
+    }
+    T *work = new T[3*dim*dim];
+    uint8_t *perm = new uint8_t[dim];
+    bool ret = false;
+    if (work != nullptr && perm != nullptr) {
+        ret = mat_inverseN(x,y,dim,work,perm);
+    }
+    delete[] work;
+    delete[] perm;
+    return ret;
+}
+
+/*
+ *    fixed dimension matrix inverse code, using no heap memory
+ *
+ *    @param     x,     input NxN matrix
+ *    @param     y,     Output inverted NxN matrix, may be the same as x
+ *    @returns          false = matrix is Singular, true = matrix inversion successful
+ */
+template<typename T, uint16_t N>
+bool mat_inverse(const T x[], T y[])
+{
+    switch(N){
+    case 3: return inverse3x3(x,y);
+    case 4: return inverse4x4(x,y);
+    default: {
+        T work[3*N*N];
+        uint8_t perm[N];
+        return mat_inverseN(x,y,N,work,perm);
+    }
     }
 }
 
@@ -473,3 +469,13 @@ template void mat_identity<float>(float x[], uint16_t dim);
 template bool mat_inverse<double>(const double x[], double y[], uint16_t dim);
 template void mat_mul<double>(const double *A, const double *B, double *C, uint16_t n);
 template void mat_identity<double>(double x[], uint16_t dim);
+
+template bool mat_inverse<float,3>(const float x[], float y[]);
+template bool mat_inverse<float,4>(const float x[], float y[]);
+template bool mat_inverse<float,6>(const float x[], float y[]);
+template bool mat_inverse<float,9>(const float x[], float y[]);
+
+template bool mat_inverse<double,3>(const double x[], double y[]);
+template bool mat_inverse<double,4>(const double x[], double y[]);
+template bool mat_inverse<double,6>(const double x[], double y[]);
+template bool mat_inverse<double,9>(const double x[], double y[]);
@@ -0,0 +1,107 @@
+/*
+ * This file is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This file is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+* This object generates frequency interleaved multi-sine signals for exciting
+* several axes at once.  The frequency band is covered by consecutive harmonics
+* of a common fundamental and harmonic k is assigned to channel k modulo the
+* number of channels.  Over any whole period of the fundamental the channels are
+* therefore orthogonal, so the response of each axis can be separated from the
+* same window of data by correlating against that axis' own components.
+* Schroeder phasing is used within each channel to keep the peak amplitude of
+* the summed components close to the requested magnitude.
+*/
+#include <AP_Math/AP_Math.h>
+#include "multisine.h"
+
+// constructor
+MultiSine::MultiSine() {}
+
+// initializes the multi-sine object
+void MultiSine::init(uint8_t channels, float frequency_min_rads, float frequency_max_rads, float time_fade_in)
+{
+    num_channels = constrain_int16(channels, 1, MULTISINE_MAX_CHANNELS);
+    num_components = MULTISINE_MAX_COMPONENTS;
+    fade_in = time_fade_in;
+
+    // space the harmonics of all channels evenly across the band
+    const uint16_t num_harmonics = num_channels * num_components;
+    w0 = MAX(frequency_max_rads - frequency_min_rads, 0.0f) / (num_harmonics - 1);
+    first_harmonic = 1;
+    if (is_positive(w0)) {
+        first_harmonic = MAX(lrintf(frequency_min_rads / w0), 1);
+    } else {
+        // degenerate band so fall back to the minimum frequency as the fundamental
+        w0 = MAX(frequency_min_rads, 0.1f);
+    }
+    period = M_2PI / w0;
+
+    // equal component amplitudes with the same RMS as a single sine of the requested magnitude
+    component_scale = 1.0f / sqrtf(num_components);
+
+    for (uint8_t j = 0; j < num_components; j++) {
+        const float phase = -M_PI * j * (j + 1) / num_components;
+        phase_sin[j] = sinf(phase);
+        phase_cos[j] = cosf(phase);
+    }
+}
+
+// determine the output of every channel at the specified time and amplitude
+void MultiSine::update(float time, float waveform_magnitude, float *output)
+{
+    float window;
+    if (time <= 0.0f) {
+        window = 0.0f;
+    } else if (time <= fade_in) {
+        window = 0.5f - 0.5f * cosf(M_PI * time / fade_in);
+    } else {
+        window = 1.0f;
+    }
+
+    // wrap time to one period to keep the argument small
+    const float theta = w0 * fmodf(MAX(time, 0.0f), period);
+
+    // step through the harmonics by rotation rather than evaluating sinf and cosf for each one
+    const float step_sin = sinf(theta);
+    const float step_cos = cosf(theta);
+    float k_sin = sinf(first_harmonic * theta);
+    float k_cos = cosf(first_harmonic * theta);
+
+    for (uint8_t c = 0; c < num_channels; c++) {
+        output[c] = 0.0f;
+    }
+    for (uint8_t j = 0; j < num_components; j++) {
+        for (uint8_t c = 0; c < num_channels; c++) {
+            basis_sin[c][j] = k_sin;
+            basis_cos[c][j] = k_cos;
+            output[c] += k_sin * phase_cos[j] + k_cos * phase_sin[j];
+
+            const float next_sin = k_sin * step_cos + k_cos * step_sin;
+            k_cos = k_cos * step_cos - k_sin * step_sin;
+            k_sin = next_sin;
+        }
+    }
+
+    const float scale = window * waveform_magnitude * component_scale;
+    for (uint8_t c = 0; c < num_channels; c++) {
+        output[c] *= scale;
+    }
+}
+
+// accessor for the frequency in rad/s of a channel's component
+float MultiSine::get_frequency_rads(uint8_t channel, uint8_t component) const
+{
+    return w0 * (first_harmonic + component * num_channels + channel);
+}
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <stdint.h>
+
+#define MULTISINE_MAX_CHANNELS      3       // maximum number of simultaneously excited channels
+#define MULTISINE_MAX_COMPONENTS    24      // maximum number of sine components per channel
+
+class MultiSine {
+
+public:
+
+    // constructor
+    MultiSine();
+
+    // initializes the multi-sine object.  The frequency band is split into
+    // harmonics of a common fundamental and the harmonics are interleaved
+    // across the channels so each channel's excitation is orthogonal to every
+    // other channel's over a whole number of periods.
+    void init(uint8_t channels, float frequency_min_rads, float frequency_max_rads, float time_fade_in);
+
+    // determine the output of every channel at the specified time and amplitude.
+    // output must have room for get_num_channels() values
+    void update(float time, float waveform_magnitude, float *output);
+
+    // accessor for the period in seconds over which the channels are orthogonal
+    float get_period() const { return period; }
+
+    // accessor for the number of channels
+    uint8_t get_num_channels() const { return num_channels; }
+
+    // accessor for the number of components in a channel
+    uint8_t get_num_components() const { return num_components; }
+
+    // accessor for the frequency in rad/s of a channel's component
+    float get_frequency_rads(uint8_t channel, uint8_t component) const;
+
+    // sine and cosine of a channel's component evaluated at the time of the last update, without the component phase offset.
+    // used to correlate measured responses against the excitation
+    float get_basis_sin(uint8_t channel, uint8_t component) const { return basis_sin[channel][component]; }
+    float get_basis_cos(uint8_t channel, uint8_t component) const { return basis_cos[channel][component]; }
+
+private:
+    // fundamental frequency in rad/s
+    float w0;
+
+    // period of the fundamental in seconds
+    float period;
+
+    // Amplitude fade in time in seconds
+    float fade_in;
+
+    // harmonic number of the lowest component
+    uint16_t first_harmonic;
+
+    uint8_t num_channels;
+    uint8_t num_components;
+
+    // amplitude of each component relative to the waveform magnitude
+    float component_scale;
+
+    // sine and cosine of the Schroeder phase offset of each component
+    float phase_sin[MULTISINE_MAX_COMPONENTS];
+    float phase_cos[MULTISINE_MAX_COMPONENTS];
+
+    // basis evaluated at the time of the last update
+    float basis_sin[MULTISINE_MAX_CHANNELS][MULTISINE_MAX_COMPONENTS];
+    float basis_cos[MULTISINE_MAX_CHANNELS][MULTISINE_MAX_COMPONENTS];
+
+};
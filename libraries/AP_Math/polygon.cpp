@@ -26,6 +26,63 @@
  */
 
 
+/*
+ *  return true if the edge from Vi to Vj crosses the horizontal line
+ *  through P on the side counted by Polygon_outside()
+ */
+template <typename T>
+static bool Polygon_edge_crossed(const Vector2<T> &P, const Vector2<T> &Vi, const Vector2<T> &Vj)
+{
+    if ((Vi.y > P.y) == (Vj.y > P.y)) {
+        return false;
+    }
+    const T dx1 = P.x - Vi.x;
+    const T dx2 = Vj.x - Vi.x;
+    const T dy1 = P.y - Vi.y;
+    const T dy2 = Vj.y - Vi.y;
+    const int8_t dx1s = (dx1 < 0) ? -1 : 1;
+    const int8_t dx2s = (dx2 < 0) ? -1 : 1;
+    const int8_t dy1s = (dy1 < 0) ? -1 : 1;
+    const int8_t dy2s = (dy2 < 0) ? -1 : 1;
+    const int8_t m1 = dx1s * dy2s;
+    const int8_t m2 = dx2s * dy1s;
+    // we avoid the 64 bit multiplies if we can based on sign checks.
+    if (dy2 < 0) {
+        if (m1 > m2) {
+            return true;
+        } else if (m1 < m2) {
+            return false;
+        } else {
+            if (std::is_floating_point<T>::value) {
+                if ( dx1 * dy2 > dx2 * dy1 ) {
+                    return true;
+                }
+            } else {
+                if ( dx1 * (int64_t)dy2 > dx2 * (int64_t)dy1 ) {
+                    return true;
+                }
+            }
+        }
+    } else {
+        if (m1 < m2) {
+            return true;
+        } else if (m1 > m2) {
+            return false;
+        } else {
+            if (std::is_floating_point<T>::value) {
+                if ( dx1 * dy2 < dx2 * dy1 ) {
+                    return true;
+                }
+            } else {
+                if ( dx1 * (int64_t)dy2 < dx2 * (int64_t)dy1 ) {
+                    return true;
+                }
+            }
+        }
+    }
+    return false;
+}
+
 /*
  *  Polygon_outside(): test for a point in a polygon
  *     Input:   P = a point,
@@ -54,52 +111,8 @@ bool Polygon_outside(const Vector2<T> &P, const Vector2<T> *V, unsigned n)
         if (j >= n) {
             j = 0;
         }
-        if ((V[i].y > P.y) == (V[j].y > P.y)) {
-            continue;
-        }
-        const T dx1 = P.x - V[i].x;
-        const T dx2 = V[j].x - V[i].x;
-        const T dy1 = P.y - V[i].y;
-        const T dy2 = V[j].y - V[i].y;
-        const int8_t dx1s = (dx1 < 0) ? -1 : 1;
-        const int8_t dx2s = (dx2 < 0) ? -1 : 1;
-        const int8_t dy1s = (dy1 < 0) ? -1 : 1;
-        const int8_t dy2s = (dy2 < 0) ? -1 : 1;
-        const int8_t m1 = dx1s * dy2s;
-        const int8_t m2 = dx2s * dy1s;
-        // we avoid the 64 bit multiplies if we can based on sign checks.
-        if (dy2 < 0) {
-            if (m1 > m2) {
-                outside = !outside;
-            } else if (m1 < m2) {
-                continue;
-            } else {
-                if (std::is_floating_point<T>::value) {
-                    if ( dx1 * dy2 > dx2 * dy1 ) {
-                        outside = !outside;
-                    }
-                } else {
-                    if ( dx1 * (int64_t)dy2 > dx2 * (int64_t)dy1 ) {
-                        outside = !outside;
-                    }
-                }
-            }
-        } else {
-            if (m1 < m2) {
-                outside = !outside;
-            } else if (m1 > m2) {
-                continue;
-            } else {
-                if (std::is_floating_point<T>::value) {
-                    if ( dx1 * dy2 < dx2 * dy1 ) {
-                        outside = !outside;
-                    }
-                } else {
-                    if ( dx1 * (int64_t)dy2 < dx2 * (int64_t)dy1 ) {
-                        outside = !outside;
-                    }
-                }
-            }
+        if (Polygon_edge_crossed(P, V[i], V[j])) {
+            outside = !outside;
         }
     }
     return outside;
@@ -125,6 +138,199 @@ template bool Polygon_outside<float>(const Vector2f &P, const Vector2f *V, unsig
 template bool Polygon_complete<float>(const Vector2f *V, unsigned n);
 
 
+// the average number of slabs each edge may overlap before the
+// number of slabs is reduced
+#define POLYGON_INDEX_MAX_EDGE_SLABS 4
+
+// polygons with fewer edges are not worth indexing
+#define POLYGON_INDEX_MIN_EDGES 16
+
+template <typename T>
+uint16_t Polygon_index<T>::slab(T y) const
+{
+    const uint16_t s = uint16_t(float(y - _min.y) * _slabs_per_unit);
+    return MIN(s, uint16_t(_num_slabs-1));
+}
+
+template <typename T>
+bool Polygon_index<T>::init(const Vector2<T> *V, uint16_t n)
+{
+    clear();
+    if (Polygon_complete(V, n)) {
+        n--;
+    }
+    _points = V;
+    _num_edges = n;
+    if (n < POLYGON_INDEX_MIN_EDGES) {
+        // queries test every edge
+        return true;
+    }
+
+    _min = _max = V[0];
+    for (uint16_t i=1; i<n; i++) {
+        _min.x = MIN(_min.x, V[i].x);
+        _min.y = MIN(_min.y, V[i].y);
+        _max.x = MAX(_max.x, V[i].x);
+        _max.y = MAX(_max.y, V[i].y);
+    }
+    if (_max.y <= _min.y) {
+        return true;
+    }
+
+    // start with one slab per edge, halving the number of slabs while
+    // long edges make the index too large
+    uint32_t total;
+    _num_slabs = n;
+    while (true) {
+        _slabs_per_unit = _num_slabs / float(_max.y - _min.y);
+        total = 0;
+        for (uint16_t i=0; i<n; i++) {
+            const uint16_t j = (i+1 < n) ? i+1 : 0;
+            total += abs(int32_t(slab(V[j].y)) - int32_t(slab(V[i].y))) + 1;
+        }
+        if (total <= uint32_t(n) * POLYGON_INDEX_MAX_EDGE_SLABS || _num_slabs == 1) {
+            break;
+        }
+        _num_slabs /= 2;
+    }
+
+    _slab_start = new uint16_t[_num_slabs+1];
+    _slab_edges = new uint16_t[total];
+    if (_slab_start == nullptr || _slab_edges == nullptr) {
+        // queries test every edge
+        delete[] _slab_start;
+        delete[] _slab_edges;
+        _slab_start = nullptr;
+        _slab_edges = nullptr;
+        return false;
+    }
+
+    // count the edges in each slab, then fill the slabs
+    memset(_slab_start, 0, (_num_slabs+1)*sizeof(_slab_start[0]));
+    for (uint16_t i=0; i<n; i++) {
+        const uint16_t j = (i+1 < n) ? i+1 : 0;
+        const uint16_t s1 = MIN(slab(V[i].y), slab(V[j].y));
+        const uint16_t s2 = MAX(slab(V[i].y), slab(V[j].y));
+        for (uint16_t s=s1; s<=s2; s++) {
+            _slab_start[s+1]++;
+        }
+    }
+    for (uint16_t s=0; s<_num_slabs; s++) {
+        _slab_start[s+1] += _slab_start[s];
+    }
+    for (uint16_t i=0; i<n; i++) {
+        const uint16_t j = (i+1 < n) ? i+1 : 0;
+        const uint16_t s1 = MIN(slab(V[i].y), slab(V[j].y));
+        const uint16_t s2 = MAX(slab(V[i].y), slab(V[j].y));
+        for (uint16_t s=s1; s<=s2; s++) {
+            // _slab_start[s] is used as the fill position and restored below
+            _slab_edges[_slab_start[s]++] = i;
+        }
+    }
+    for (uint16_t s=_num_slabs; s>0; s--) {
+        _slab_start[s] = _slab_start[s-1];
+    }
+    _slab_start[0] = 0;
+
+    return true;
+}
+
+template <typename T>
+void Polygon_index<T>::clear()
+{
+    delete[] _slab_start;
+    delete[] _slab_edges;
+    _slab_start = nullptr;
+    _slab_edges = nullptr;
+    _points = nullptr;
+    _num_edges = 0;
+}
+
+template <typename T>
+bool Polygon_index<T>::outside(const Vector2<T> &P) const
+{
+    if (_slab_start == nullptr) {
+        return (_points == nullptr) || Polygon_outside(P, _points, _num_edges);
+    }
+    if (P.x < _min.x || P.x > _max.x || P.y < _min.y || P.y > _max.y) {
+        return true;
+    }
+
+    // only edges overlapping the slab can cross the line through P
+    const uint16_t s = slab(P.y);
+    bool outside = true;
+    for (uint16_t k=_slab_start[s]; k<_slab_start[s+1]; k++) {
+        const uint16_t i = _slab_edges[k];
+        const uint16_t j = (i+1 < _num_edges) ? i+1 : 0;
+        if (Polygon_edge_crossed(P, _points[i], _points[j])) {
+            outside = !outside;
+        }
+    }
+    return outside;
+}
+
+template <typename T>
+float Polygon_index<T>::closest_distance_point(const Vector2<T> &P) const
+{
+    // distances are taken relative to P to keep float precision for
+    // integer points
+    const auto edge_dist_sq = [&](uint16_t i) {
+        const uint16_t j = (i+1 < _num_edges) ? i+1 : 0;
+        const Vector2f v1(_points[i].x - P.x, _points[i].y - P.y);
+        const Vector2f v2(_points[j].x - P.x, _points[j].y - P.y);
+        return Vector2f::closest_distance_between_line_and_point_squared(v1, v2, Vector2f());
+    };
+
+    float closest_sq = FLT_MAX;
+    if (_slab_start == nullptr) {
+        for (uint16_t i=0; i<_num_edges; i++) {
+            closest_sq = MIN(closest_sq, edge_dist_sq(i));
+        }
+        return sqrtf(closest_sq);
+    }
+
+    // search the slabs outwards from P, stopping once the slabs are
+    // further away than the closest edge so far. The closest point of
+    // each edge lies in one of its slabs, so no closer edge is missed
+    const float slab_height = 1.0f / _slabs_per_unit;
+    const float y = float(P.y - _min.y);
+    const uint16_t s0 = (P.y <= _min.y) ? 0 : slab(P.y);
+    for (uint16_t d=0; d<_num_slabs; d++) {
+        bool searched = false;
+        for (uint8_t side=0; side<2; side++) {
+            if (d == 0 && side == 1) {
+                break;
+            }
+            const int32_t s = side == 0 ? int32_t(s0) - d : int32_t(s0) + d;
+            if (s < 0 || s >= _num_slabs) {
+                continue;
+            }
+            // vertical distance from P to the slab, less a margin for
+            // the rounding of the slab boundaries
+            float gap = -0.01f * slab_height;
+            if (s < s0) {
+                gap += y - (s+1) * slab_height;
+            } else if (s > s0) {
+                gap += s * slab_height - y;
+            }
+            if (sq(MAX(gap, 0.0f)) > closest_sq) {
+                continue;
+            }
+            searched = true;
+            for (uint16_t k=_slab_start[s]; k<_slab_start[s+1]; k++) {
+                closest_sq = MIN(closest_sq, edge_dist_sq(_slab_edges[k]));
+            }
+        }
+        if (!searched && d > 0) {
+            break;
+        }
+    }
+    return sqrtf(closest_sq);
+}
+
+template class Polygon_index<int32_t>;
+template class Polygon_index<float>;
+
 /*
   determine if the polygon of N verticies defined by points V is
   intersected by a line from point p1 to point p2
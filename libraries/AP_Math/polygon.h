@@ -44,3 +44,55 @@ float Polygon_closest_distance_line(const Vector2f *V, unsigned N, const Vector2
   closed polygon V, defined by N points
  */
 float Polygon_closest_distance_point(const Vector2f *V, unsigned N, const Vector2f &p);
+
+/*
+  index of the edges of a polygon by horizontal slab, giving the same
+  results as Polygon_outside() and the closest distance to the edges
+  of the closed polygon while only looking at the edges near the query
+  point. The points are
+  not copied so must not change or be freed while the index is in use.
+  Small polygons, and those which can't be allocated an index, are
+  queried by testing every edge.
+ */
+template <typename T>
+class Polygon_index
+{
+public:
+    Polygon_index() {}
+    ~Polygon_index() { clear(); }
+
+    CLASS_NO_COPY(Polygon_index);
+
+    // build the index for the n points V, returns false if the index
+    // could not be allocated
+    bool init(const Vector2<T> *V, uint16_t n);
+
+    // free the index
+    void clear();
+
+    // true if P is outside the polygon
+    bool outside(const Vector2<T> &P) const WARN_IF_UNUSED;
+
+    // return the closest distance from P to an edge of the polygon
+    float closest_distance_point(const Vector2<T> &P) const;
+
+private:
+    // slab containing y, which must be within the bounding box
+    uint16_t slab(T y) const;
+
+    const Vector2<T> *_points = nullptr;
+    uint16_t _num_edges = 0;
+
+    // bounding box of the points
+    Vector2<T> _min;
+    Vector2<T> _max;
+
+    uint16_t _num_slabs = 0;
+    float _slabs_per_unit = 0;
+
+    // the edges overlapping slab s are _slab_edges[_slab_start[s]]
+    // to _slab_edges[_slab_start[s+1]-1], edge i running from point i
+    // to point i+1
+    uint16_t *_slab_start = nullptr;
+    uint16_t *_slab_edges = nullptr;
+};
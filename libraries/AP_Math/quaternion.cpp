@@ -408,12 +408,19 @@ void QuaternionT<T>::rotate(enum Rotation rotation)
 }
 
 // convert a vector from earth to body frame
+// this is the rotation matrix times v, computed without forming the
+// matrix with the same formula as the rotation operator below
 template <typename T>
 void QuaternionT<T>::earth_to_body(Vector3<T> &v) const
 {
-    Matrix3<T> m;
-    rotation_matrix(m);
-    v = m * v;
+    // 2 * (qv x v)
+    const T uvx = 2 * (q3 * v.z - q4 * v.y);
+    const T uvy = 2 * (q4 * v.x - q2 * v.z);
+    const T uvz = 2 * (q2 * v.y - q3 * v.x);
+
+    v.x += q1 * uvx + q3 * uvz - q4 * uvy;
+    v.y += q1 * uvy + q4 * uvx - q2 * uvz;
+    v.z += q1 * uvz + q2 * uvy - q3 * uvx;
 }
 
 // create a quaternion from Euler angles
@@ -459,8 +466,14 @@ void QuaternionT<T>::from_axis_angle(Vector3<T> v)
         q2=q3=q4=0.0f;
         return;
     }
-    v /= theta;
-    from_axis_angle(v,theta);
+    // scale by sin(theta/2)/theta rather than normalising the axis
+    // first, saving two divides
+    const T st2 = sinF(0.5*theta) / theta;
+
+    q1 = cosF(0.5*theta);
+    q2 = v.x * st2;
+    q3 = v.y * st2;
+    q4 = v.z * st2;
 }
 
 // create a quaternion from its axis-angle representation
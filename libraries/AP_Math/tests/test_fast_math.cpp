@@ -0,0 +1,45 @@
+#include <AP_gtest.h>
+
+#include <AP_Math/AP_Math.h>
+
+const AP_HAL::HAL& hal = AP_HAL::get_HAL();
+
+// the bounds documented in fast_math.h
+TEST(FastMathTest, SinCos)
+{
+    for (float x = -8192.0f; x <= 8192.0f; x += 0.0137f) {
+        float s, c;
+        sincosf_approx(x, s, c);
+        EXPECT_NEAR(sin(double(x)), s, 1.0e-7);
+        EXPECT_NEAR(cos(double(x)), c, 1.0e-7);
+    }
+    EXPECT_FLOAT_EQ(0.0f, sinf_approx(0.0f));
+    EXPECT_FLOAT_EQ(1.0f, cosf_approx(0.0f));
+}
+
+TEST(FastMathTest, Atan2)
+{
+    for (float y = -3.0f; y <= 3.0f; y += 0.0113f) {
+        for (float x = -3.0f; x <= 3.0f; x += 0.0131f) {
+            EXPECT_NEAR(atan2(double(y), double(x)), atan2f_approx(y, x), 3.0e-7);
+        }
+    }
+    EXPECT_FLOAT_EQ(0.0f, atan2f_approx(0.0f, 0.0f));
+    EXPECT_FLOAT_EQ(M_PI_2, atan2f_approx(1.0f, 0.0f));
+    EXPECT_FLOAT_EQ(-M_PI_2, atan2f_approx(-1.0f, 0.0f));
+    EXPECT_FLOAT_EQ(M_PI, atan2f_approx(0.0f, -1.0f));
+}
+
+TEST(FastMathTest, Acos)
+{
+    for (float x = -1.0f; x <= 1.0f; x += 0.0001f) {
+        EXPECT_NEAR(acos(double(x)), acosf_approx(x), 4.5e-7);
+    }
+    EXPECT_FLOAT_EQ(0.0f, acosf_approx(1.0f));
+    EXPECT_FLOAT_EQ(M_PI, acosf_approx(-1.0f));
+    // out of range arguments are constrained
+    EXPECT_FLOAT_EQ(0.0f, acosf_approx(1.001f));
+    EXPECT_FLOAT_EQ(M_PI, acosf_approx(-1.001f));
+}
+
+AP_GTEST_MAIN()
@@ -0,0 +1,65 @@
+#include <AP_gtest.h>
+
+#include <AP_Math/AP_Math.h>
+
+const AP_HAL::HAL& hal = AP_HAL::get_HAL();
+
+// fill a diagonally dominant, so invertible, matrix
+static void fill_matrix(float *m, uint16_t n)
+{
+    for (uint16_t i = 0; i < n; i++) {
+        for (uint16_t j = 0; j < n; j++) {
+            m[i*n+j] = (i == j) ? 10.0f + i : float((i*7 + j*3) % 5) - 2.0f;
+        }
+    }
+}
+
+static void expect_identity(const float *m, uint16_t n)
+{
+    for (uint16_t i = 0; i < n; i++) {
+        for (uint16_t j = 0; j < n; j++) {
+            EXPECT_NEAR(m[i*n+j], (i == j) ? 1.0f : 0.0f, 1.0e-5f);
+        }
+    }
+}
+
+TEST(MatrixAlgTest, Inverse9)
+{
+    float m[81], inv[81], fixed_inv[81], prod[81];
+    fill_matrix(m, 9);
+
+    ASSERT_TRUE(mat_inverse(m, inv, 9));
+    mat_mul(m, inv, prod, 9);
+    expect_identity(prod, 9);
+
+    // the fixed dimension inverse gives the same result
+    ASSERT_TRUE((mat_inverse<float, 9>(m, fixed_inv)));
+    EXPECT_EQ(0, memcmp(inv, fixed_inv, sizeof(inv)));
+
+    // in place
+    ASSERT_TRUE((mat_inverse<float, 9>(m, m)));
+    EXPECT_EQ(0, memcmp(inv, m, sizeof(inv)));
+}
+
+TEST(MatrixAlgTest, Inverse6)
+{
+    float m[36], inv[36], prod[36];
+    fill_matrix(m, 6);
+
+    ASSERT_TRUE((mat_inverse<float, 6>(m, inv)));
+    mat_mul(m, inv, prod, 6);
+    expect_identity(prod, 6);
+}
+
+TEST(MatrixAlgTest, Singular)
+{
+    float m[36] {}, inv[36];
+    for (uint8_t i = 0; i < 6; i++) {
+        m[i] = 1.0f;
+        m[6+i] = 2.0f;
+    }
+    EXPECT_FALSE(mat_inverse(m, inv, 6));
+    EXPECT_FALSE((mat_inverse<float, 6>(m, inv)));
+}
+
+AP_GTEST_MAIN()
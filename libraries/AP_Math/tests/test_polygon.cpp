@@ -356,6 +356,61 @@ TEST(Polygon, simple)
     TEST_POLYGON_POINTS(SIMPLE_boundary, SIMPLE_test_points);
 }
 
+// a star shaped polygon of n points, with spikes of varying length
+template <typename T>
+static void make_star(Vector2<T> *V, uint16_t n, float scale)
+{
+    for (uint16_t i=0; i<n; i++) {
+        const float angle = i * M_2PI / n;
+        const float r = scale * ((i % 2) ? 1.0f : 0.4f + 0.05f * (i % 7));
+        V[i] = Vector2<T>(T(r * cosf(angle)), T(r * sinf(angle)));
+    }
+}
+
+TEST(Polygon, index)
+{
+    const uint16_t n = 200;
+    Vector2f V[n];
+    make_star(V, n, 1000.0f);
+    Polygon_index<float> index;
+    ASSERT_TRUE(index.init(V, n));
+
+    for (float x = -1100; x <= 1100; x += 7.3f) {
+        for (float y = -1100; y <= 1100; y += 7.9f) {
+            const Vector2f p{x, y};
+            EXPECT_EQ(Polygon_outside(p, V, n), index.outside(p));
+
+            float closest = FLT_MAX;
+            for (uint16_t i=0; i<n; i++) {
+                closest = MIN(closest, Vector2f::closest_distance_between_line_and_point(V[i], V[(i+1)%n], p));
+            }
+            EXPECT_NEAR(closest, index.closest_distance_point(p), 1.0e-3);
+        }
+    }
+}
+
+TEST(Polygon, index_lla)
+{
+    const uint16_t n = 64;
+    Vector2l V[n+1];
+    make_star(V, n, 1.0e6f);
+    for (uint16_t i=0; i<n; i++) {
+        V[i].x += OBC_boundary[0].x;
+        V[i].y += OBC_boundary[0].y;
+    }
+    // closed polygons give the same result
+    V[n] = V[0];
+    Polygon_index<int32_t> index;
+    ASSERT_TRUE(index.init(V, n+1));
+
+    for (int32_t x = -1100000; x <= 1100000; x += 17321) {
+        for (int32_t y = -1100000; y <= 1100000; y += 19937) {
+            const Vector2l p{OBC_boundary[0].x + x, OBC_boundary[0].y + y};
+            EXPECT_EQ(Polygon_outside(p, V, n+1), index.outside(p));
+        }
+    }
+}
+
 AP_GTEST_MAIN()
 
 
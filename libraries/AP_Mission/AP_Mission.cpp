@@ -8,6 +8,7 @@
 #include <AP_Camera/AP_Camera.h>
 #include <AP_Gripper/AP_Gripper_config.h>
 #include <AP_Vehicle/AP_Vehicle_Type.h>
+#include <AP_HAL/utility/sparse-endian.h>
 
 const AP_Param::GroupInfo AP_Mission::var_info[] = {
 
@@ -30,9 +31,10 @@ const AP_Param::GroupInfo AP_Mission::var_info[] = {
     // @Param: OPTIONS
     // @DisplayName: Mission options bitmask
     // @Description: Bitmask of what options to use in missions.
-    // @Bitmask: 0:Clear Mission on reboot, 1:Use distance to land calc on battery failsafe,2:ContinueAfterLand
-    // @Bitmask{Copter}: 0:Clear Mission on reboot, 2:ContinueAfterLand
-    // @Bitmask{Rover, Sub}: 0:Clear Mission on reboot
+    // @Bitmask: 0:Clear Mission on reboot, 1:Use distance to land calc on battery failsafe,2:ContinueAfterLand,3:Store mission on SD card
+    // @Bitmask{Copter}: 0:Clear Mission on reboot, 2:ContinueAfterLand,3:Store mission on SD card
+    // @Bitmask{Rover, Sub}: 0:Clear Mission on reboot,3:Store mission on SD card
+    // @RebootRequired: True
     // @User: Advanced
     AP_GROUPINFO("OPTIONS",  2, AP_Mission, _options, AP_MISSION_OPTIONS_DEFAULT),
 
@@ -57,6 +59,17 @@ void AP_Mission::init()
     // command list will be cleared if they do not match
     check_eeprom_version();
 
+#if AP_MISSION_FILE_ENABLED
+    if (_options & AP_MISSION_MASK_FILE_STORAGE) {
+        init_file_storage();
+    }
+#endif
+
+    // a mission that was stored on the SD card may not fit in storage
+    if ((unsigned)_cmd_total > num_commands_max()) {
+        _cmd_total.set(num_commands_max());
+    }
+
     // initialize the jump tracking array
     init_jump_tracking();
 
@@ -267,6 +280,12 @@ void AP_Mission::truncate(uint16_t index)
         _cmd_total.set_and_save(index);
         _last_change_time_ms = AP_HAL::millis();
     }
+#if AP_MISSION_CMD_CACHE_ENABLED
+    WITH_SEMAPHORE(_rsem);
+    _cache.next_stop_total = 0;
+    // a new mission may be smaller, so allow another allocation attempt
+    _cache.alloc_failed = false;
+#endif
 }
 
 /// update - ensures the command queues are loaded with the next command and calls main programs command_init and command_verify functions to progress the mission
@@ -440,6 +459,13 @@ bool AP_Mission::get_next_nav_cmd(uint16_t start_index, Mission_Command& cmd)
 {
     // search until the end of the mission command list
     for (uint16_t cmd_index = start_index; cmd_index < (unsigned)_cmd_total; cmd_index++) {
+#if AP_MISSION_CMD_CACHE_ENABLED
+        // skip over any run of do commands
+        cmd_index = next_stop_index(cmd_index);
+        if (cmd_index >= (unsigned)_cmd_total) {
+            break;
+        }
+#endif
         // get next command
         if (!get_next_cmd(cmd_index, cmd, false)) {
             // no more commands so return failure
@@ -707,26 +733,35 @@ bool AP_Mission::read_cmd_from_storage(uint16_t index, Mission_Command& cmd) con
         return false;
     }
 
+#if AP_MISSION_CMD_CACHE_ENABLED
+    const bool cacheable = cache_allocate(index);
+    if (cacheable && (_cache.valid[index/8] & (1U<<(index%8)))) {
+        cmd = _cache.cmds[index];
+        return true;
+    }
+#endif
+
     // ensure all bytes of cmd are zeroed
     cmd = {};
 
-    // Find out proper location in memory by using the start_byte position + the index
     // we can load a command, we don't process it yet
-    // read WP position
-    const uint16_t pos_in_storage = 4 + (index * AP_MISSION_EEPROM_COMMAND_SIZE);
+    uint8_t rec[AP_MISSION_EEPROM_COMMAND_SIZE];
+    if (!read_record(index, rec)) {
+        return false;
+    }
 
     PackedContent packed_content {};
 
-    const uint8_t b1 = _storage.read_byte(pos_in_storage);
+    const uint8_t b1 = rec[0];
     if (b1 == 0 || b1 == 1) {
-        cmd.id = _storage.read_uint16(pos_in_storage+1);
-        cmd.p1 = _storage.read_uint16(pos_in_storage+3);
-        _storage.read_block(packed_content.bytes, pos_in_storage+5, 10);
+        cmd.id = le16toh_ptr(&rec[1]);
+        cmd.p1 = le16toh_ptr(&rec[3]);
+        memcpy(packed_content.bytes, &rec[5], 10);
         format_conversion(b1, cmd, packed_content);
     } else {
         cmd.id = b1;
-        cmd.p1 = _storage.read_uint16(pos_in_storage+1);
-        _storage.read_block(packed_content.bytes, pos_in_storage+3, 12);
+        cmd.p1 = le16toh_ptr(&rec[1]);
+        memcpy(packed_content.bytes, &rec[3], 12);
     }
 
     if (stored_in_location(cmd.id)) {
@@ -762,10 +797,104 @@ bool AP_Mission::read_cmd_from_storage(uint16_t index, Mission_Command& cmd) con
     // set command's index to it's position in eeprom
     cmd.index = index;
 
+#if AP_MISSION_CMD_CACHE_ENABLED
+    if (cacheable) {
+        _cache.cmds[index] = cmd;
+        _cache.valid[index/8] |= (1U<<(index%8));
+    }
+#endif
+
     // return success
     return true;
 }
 
+#if AP_MISSION_CMD_CACHE_ENABLED
+/*
+  make sure the command cache can hold index, growing it to the
+  mission size if needed. Returns false if index can't be cached.
+  Must be called with _rsem held
+ */
+bool AP_Mission::cache_allocate(uint16_t index) const
+{
+    if (index < _cache.size) {
+        return true;
+    }
+    if (index >= AP_MISSION_CMD_CACHE_MAX || _cache.alloc_failed) {
+        return false;
+    }
+
+    // size for the whole mission, rounded up so adding commands
+    // one at a time doesn't reallocate each time
+    uint16_t size = MAX(unsigned(_cmd_total), index+1U);
+    size = MIN((size + 63U) & ~63U, unsigned(AP_MISSION_CMD_CACHE_MAX));
+
+    free(_cache.cmds);
+    free(_cache.valid);
+    free(_cache.next_stop);
+    _cache.cmds = (Mission_Command *)calloc(size, sizeof(Mission_Command));
+    _cache.valid = (uint8_t *)calloc((size+7)/8, 1);
+    _cache.next_stop = (uint16_t *)calloc(size, sizeof(uint16_t));
+    _cache.next_stop_total = 0;
+    if (_cache.cmds == nullptr || _cache.valid == nullptr || _cache.next_stop == nullptr) {
+        free(_cache.cmds);
+        free(_cache.valid);
+        free(_cache.next_stop);
+        _cache.cmds = nullptr;
+        _cache.valid = nullptr;
+        _cache.next_stop = nullptr;
+        _cache.size = 0;
+        _cache.alloc_failed = true;
+        return false;
+    }
+    _cache.size = size;
+    return true;
+}
+
+/*
+  invalidate the cached command at index and the nav command index
+ */
+void AP_Mission::cache_invalidate(uint16_t index)
+{
+    WITH_SEMAPHORE(_rsem);
+    if (index < _cache.size) {
+        _cache.valid[index/8] &= ~(1U<<(index%8));
+    }
+    _cache.next_stop_total = 0;
+}
+
+/*
+  return the index of the first nav or do-jump command at or after
+  index, or _cmd_total if there are none. The table is rebuilt from the
+  cache after the mission changes. If the mission can't be cached index
+  is returned
+ */
+uint16_t AP_Mission::next_stop_index(uint16_t index) const
+{
+    WITH_SEMAPHORE(_rsem);
+
+    const uint16_t total = _cmd_total;
+    if (index >= total || index == 0) {
+        return index;
+    }
+    if (_cache.next_stop_total != total) {
+        if (!cache_allocate(total-1)) {
+            return index;
+        }
+        uint16_t stop = total;
+        for (uint16_t i=total-1; i>0; i--) {
+            Mission_Command tmp;
+            if (!read_cmd_from_storage(i, tmp) || is_nav_cmd(tmp) || tmp.id == MAV_CMD_DO_JUMP) {
+                stop = i;
+            }
+            _cache.next_stop[i] = stop;
+        }
+        _cache.next_stop[0] = 0;
+        _cache.next_stop_total = total;
+    }
+    return _cache.next_stop[index];
+}
+#endif // AP_MISSION_CMD_CACHE_ENABLED
+
 bool AP_Mission::stored_in_location(uint16_t id)
 {
     switch (id) {
@@ -823,14 +952,13 @@ bool AP_Mission::write_cmd_to_storage(uint16_t index, const Mission_Command& cmd
         memcpy(packed.bytes, &cmd.content, 12);
     }
 
-    // calculate where in storage the command should be placed
-    uint16_t pos_in_storage = 4 + (index * AP_MISSION_EEPROM_COMMAND_SIZE);
+    uint8_t rec[AP_MISSION_EEPROM_COMMAND_SIZE];
 
     if (cmd.id < 256) {
         // for commands below 256 we store up to 12 bytes
-        _storage.write_byte(pos_in_storage, cmd.id);
-        _storage.write_uint16(pos_in_storage+1, cmd.p1);
-        _storage.write_block(pos_in_storage+3, packed.bytes, 12);
+        rec[0] = cmd.id;
+        put_le16_ptr(&rec[1], cmd.p1);
+        memcpy(&rec[3], packed.bytes, 12);
     } else {
         // if the command ID is above 256 we store a tag byte followed
         // by the 16 bit command ID. The tag byte is 1 for commands
@@ -841,19 +969,86 @@ bool AP_Mission::write_cmd_to_storage(uint16_t index, const Mission_Command& cmd
         if (cmd.id == MAV_CMD_NAV_SCRIPT_TIME) {
             tag_byte = 1;
         }
-        _storage.write_byte(pos_in_storage, tag_byte);
-        _storage.write_uint16(pos_in_storage+1, cmd.id);
-        _storage.write_uint16(pos_in_storage+3, cmd.p1);
-        _storage.write_block(pos_in_storage+5, packed.bytes, 10);
+        rec[0] = tag_byte;
+        put_le16_ptr(&rec[1], cmd.id);
+        put_le16_ptr(&rec[3], cmd.p1);
+        memcpy(&rec[5], packed.bytes, 10);
     }
 
+    const bool ret = write_record(index, rec);
+
+#if AP_MISSION_CMD_CACHE_ENABLED
+    // the stored command may differ from cmd, so it is decoded again on next read
+    cache_invalidate(index);
+#endif
+
     // remember when the mission last changed
     _last_change_time_ms = AP_HAL::millis();
 
-    // return success
-    return true;
+    return ret;
+}
+
+/*
+  read a stored command record from the SD card file or from
+  StorageManager. The first 4 bytes of storage hold the version
+ */
+bool AP_Mission::read_record(uint16_t index, uint8_t *rec) const
+{
+#if AP_MISSION_FILE_ENABLED
+    if (_file.is_open()) {
+        return _file.read_record(index, rec);
+    }
+#endif
+    const uint16_t pos_in_storage = 4 + (index * AP_MISSION_EEPROM_COMMAND_SIZE);
+    return _storage.read_block(rec, pos_in_storage, AP_MISSION_EEPROM_COMMAND_SIZE);
+}
+
+/*
+  write a stored command record
+ */
+bool AP_Mission::write_record(uint16_t index, const uint8_t *rec)
+{
+#if AP_MISSION_FILE_ENABLED
+    if (_file.is_open()) {
+        return _file.write_record(index, rec);
+    }
+#endif
+    const uint16_t pos_in_storage = 4 + (index * AP_MISSION_EEPROM_COMMAND_SIZE);
+    return _storage.write_block(pos_in_storage, rec, AP_MISSION_EEPROM_COMMAND_SIZE);
 }
 
+#if AP_MISSION_FILE_ENABLED
+/*
+  switch to storing the mission on the SD card. When the file is first
+  created the mission in storage is copied to it
+ */
+void AP_Mission::init_file_storage()
+{
+    WITH_SEMAPHORE(_rsem);
+
+    bool created;
+    if (!_file.open(AP_MISSION_EEPROM_VERSION, AP_MISSION_EEPROM_COMMAND_SIZE, created)) {
+        gcs().send_text(MAV_SEVERITY_WARNING, "Mission: SD card storage unavailable");
+        return;
+    }
+    if (!created) {
+        return;
+    }
+
+    const uint16_t storage_max = (_storage.size() - 4) / AP_MISSION_EEPROM_COMMAND_SIZE;
+    const uint16_t count = MIN(unsigned(_cmd_total), storage_max);
+    for (uint16_t i=0; i<count; i++) {
+        uint8_t rec[AP_MISSION_EEPROM_COMMAND_SIZE];
+        if (!_storage.read_block(rec, 4 + (i * AP_MISSION_EEPROM_COMMAND_SIZE), sizeof(rec)) ||
+            !_file.write_record(i, rec)) {
+            truncate(i);
+            break;
+        }
+    }
+    _file.flush();
+}
+#endif // AP_MISSION_FILE_ENABLED
+
 /// write_home_to_storage - writes the special purpose cmd 0 (home) to storage
 ///     home is taken directly from ahrs
 void AP_Mission::write_home_to_storage()
@@ -2109,6 +2304,11 @@ void AP_Mission::check_eeprom_version()
  */
 uint16_t AP_Mission::num_commands_max(void) const
 {
+#if AP_MISSION_FILE_ENABLED
+    if (_file.is_open()) {
+        return AP_MISSION_FILE_MAX_COMMANDS;
+    }
+#endif
     // -4 to remove space for eeprom version number
     return (_storage.size() - 4) / AP_MISSION_EEPROM_COMMAND_SIZE;
 }
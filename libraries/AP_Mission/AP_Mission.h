@@ -13,6 +13,7 @@
 #pragma once
 
 #include "AP_Mission_config.h"
+#include "AP_Mission_File.h"
 
 #include <GCS_MAVLink/GCS_MAVLink.h>
 #include <AP_Math/AP_Math.h>
@@ -48,6 +49,7 @@
 #define AP_MISSION_MASK_MISSION_CLEAR       (1<<0)  // If set then Clear the mission on boot
 #define AP_MISSION_MASK_DIST_TO_LAND_CALC   (1<<1)  // Allow distance to best landing calculation to be run on failsafe
 #define AP_MISSION_MASK_CONTINUE_AFTER_LAND (1<<2)  // Allow mission to continue after land
+#define AP_MISSION_MASK_FILE_STORAGE        (1<<3)  // Store the mission in a file on the SD card
 
 #define AP_MISSION_MAX_WP_HISTORY           7       // The maximum number of previous wp commands that will be stored from the active missions history
 #define LAST_WP_PASSED (AP_MISSION_MAX_WP_HISTORY-2)
@@ -433,6 +435,15 @@ public:
     /// num_commands_max - returns maximum number of commands that can be stored
     uint16_t num_commands_max() const;
 
+    /// uses_file_storage - returns true if the mission is stored in a file rather than in StorageManager
+    bool uses_file_storage() const {
+#if AP_MISSION_FILE_ENABLED
+        return _file.is_open();
+#else
+        return false;
+#endif
+    }
+
     /// start - resets current commands to point to the beginning of the mission
     ///     To-Do: should we validate the mission first and return true/false?
     void start();
@@ -789,6 +800,33 @@ private:
     // const functions
     static HAL_Semaphore _rsem;
 
+    // read and write a stored command record of AP_MISSION_EEPROM_COMMAND_SIZE bytes
+    bool read_record(uint16_t index, uint8_t *rec) const;
+    bool write_record(uint16_t index, const uint8_t *rec);
+
+#if AP_MISSION_FILE_ENABLED
+    // mission stored on the SD card, used in place of _storage when open
+    mutable AP_Mission_File _file;
+    void init_file_storage();
+#endif
+
+#if AP_MISSION_CMD_CACHE_ENABLED
+    // decoded commands, filled by read_cmd_from_storage() and
+    // invalidated by write_cmd_to_storage(). Protected by _rsem
+    struct cmd_cache {
+        Mission_Command *cmds;      // decoded commands by index
+        uint8_t *valid;             // bitmap of valid entries in cmds
+        uint16_t *next_stop;        // index of the first nav or do-jump command at or after each index
+        uint16_t size;              // number of commands allocated
+        uint16_t next_stop_total;   // _cmd_total that next_stop was built for, zero if not built
+        bool alloc_failed;          // true if allocation failed, cleared when the mission is truncated
+    };
+    mutable struct cmd_cache _cache;
+    bool cache_allocate(uint16_t index) const;
+    void cache_invalidate(uint16_t index);
+    uint16_t next_stop_index(uint16_t index) const;
+#endif
+
     // mission items common to all vehicles:
     bool start_command_do_aux_function(const AP_Mission::Mission_Command& cmd);
     bool start_command_do_gripper(const AP_Mission::Mission_Command& cmd);
@@ -0,0 +1,197 @@
+/// @file    AP_Mission_File.cpp
+/// @brief   Stores mission commands in a file on the SD card
+
+#include "AP_Mission_File.h"
+
+#if AP_MISSION_FILE_ENABLED
+
+#include <AP_Filesystem/AP_Filesystem.h>
+#include <AP_Math/AP_Math.h>
+
+extern const AP_HAL::HAL& hal;
+
+#define MISSION_FILE_PATH HAL_BOARD_STORAGE_DIRECTORY "/mission.bin"
+
+// dirty pages are written back once the mission has not changed for this long
+#define MISSION_FILE_FLUSH_DELAY_MS 500
+
+/*
+  the file holds a uint32_t version followed by the records
+ */
+bool AP_Mission_File::open(uint32_t version, uint8_t _record_size, bool &created)
+{
+    WITH_SEMAPHORE(sem);
+
+    created = false;
+    if (fd != -1) {
+        return true;
+    }
+    if (_record_size == 0 || _record_size > record_size_max) {
+        return false;
+    }
+    record_size = _record_size;
+
+    if (pages == nullptr) {
+        pages = (struct page *)calloc(AP_MISSION_FILE_NUM_PAGES, sizeof(struct page));
+        if (pages == nullptr) {
+            return false;
+        }
+        for (uint8_t i=0; i<AP_MISSION_FILE_NUM_PAGES; i++) {
+            pages[i].num = page_none;
+        }
+    }
+
+    // the directory normally exists already
+    AP::FS().mkdir(HAL_BOARD_STORAGE_DIRECTORY);
+    fd = AP::FS().open(MISSION_FILE_PATH, O_RDWR|O_CREAT);
+    if (fd == -1) {
+        return false;
+    }
+
+    uint32_t file_version = 0;
+    if (AP::FS().read(fd, &file_version, sizeof(file_version)) != sizeof(file_version) ||
+        file_version != version) {
+        // new file, or records in an old format
+        if (AP::FS().lseek(fd, 0, SEEK_SET) != 0 ||
+            AP::FS().write(fd, &version, sizeof(version)) != sizeof(version)) {
+            AP::FS().close(fd);
+            fd = -1;
+            return false;
+        }
+        created = true;
+    }
+
+    if (!io_registered) {
+        hal.scheduler->register_io_process(FUNCTOR_BIND_MEMBER(&AP_Mission_File::io_timer, void));
+        io_registered = true;
+    }
+    return true;
+}
+
+/*
+  read one record of record_size bytes
+ */
+bool AP_Mission_File::read_record(uint16_t index, uint8_t *rec)
+{
+    WITH_SEMAPHORE(sem);
+
+    struct page *p = get_page(index / AP_MISSION_FILE_PAGE_RECORDS);
+    if (p == nullptr) {
+        return false;
+    }
+    memcpy(rec, &p->data[(index % AP_MISSION_FILE_PAGE_RECORDS) * record_size], record_size);
+    return true;
+}
+
+/*
+  write one record of record_size bytes. The record is written to the
+  file by the IO thread
+ */
+bool AP_Mission_File::write_record(uint16_t index, const uint8_t *rec)
+{
+    WITH_SEMAPHORE(sem);
+
+    struct page *p = get_page(index / AP_MISSION_FILE_PAGE_RECORDS);
+    if (p == nullptr) {
+        return false;
+    }
+    memcpy(&p->data[(index % AP_MISSION_FILE_PAGE_RECORDS) * record_size], rec, record_size);
+    p->dirty = true;
+    last_write_ms = AP_HAL::millis();
+    return true;
+}
+
+/*
+  get a cached page, replacing the least recently used page if it is
+  not cached. Returns nullptr on a file error
+ */
+struct AP_Mission_File::page *AP_Mission_File::get_page(uint16_t num)
+{
+    if (fd == -1) {
+        return nullptr;
+    }
+
+    struct page *victim = &pages[0];
+    for (uint8_t i=0; i<AP_MISSION_FILE_NUM_PAGES; i++) {
+        struct page &p = pages[i];
+        if (p.num == num) {
+            p.last_use = ++use_count;
+            return &p;
+        }
+        if (p.last_use < victim->last_use) {
+            victim = &p;
+        }
+    }
+
+    if (victim->dirty && !write_page(*victim)) {
+        return nullptr;
+    }
+
+    // records past the end of the file read as zero
+    victim->num = page_none;
+    memset(victim->data, 0, sizeof(victim->data));
+    const uint32_t ofs = page_offset(num);
+    if (AP::FS().lseek(fd, ofs, SEEK_SET) != int32_t(ofs) ||
+        AP::FS().read(fd, victim->data, AP_MISSION_FILE_PAGE_RECORDS * record_size) < 0) {
+        return nullptr;
+    }
+    victim->num = num;
+    victim->last_use = ++use_count;
+    return victim;
+}
+
+/*
+  write a page back to the file
+ */
+bool AP_Mission_File::write_page(struct page &p)
+{
+    const uint32_t ofs = page_offset(p.num);
+    const int32_t len = AP_MISSION_FILE_PAGE_RECORDS * record_size;
+    if (AP::FS().lseek(fd, ofs, SEEK_SET) != int32_t(ofs) ||
+        AP::FS().write(fd, p.data, len) != len) {
+        return false;
+    }
+    p.dirty = false;
+    return true;
+}
+
+uint32_t AP_Mission_File::page_offset(uint16_t num) const
+{
+    return sizeof(uint32_t) + uint32_t(num) * AP_MISSION_FILE_PAGE_RECORDS * record_size;
+}
+
+/*
+  write any dirty pages back to the file
+ */
+void AP_Mission_File::flush(void)
+{
+    WITH_SEMAPHORE(sem);
+
+    if (fd == -1) {
+        return;
+    }
+    bool written = false;
+    for (uint8_t i=0; i<AP_MISSION_FILE_NUM_PAGES; i++) {
+        if (pages[i].dirty) {
+            write_page(pages[i]);
+            written = true;
+        }
+    }
+    if (written) {
+        AP::FS().fsync(fd);
+    }
+}
+
+/*
+  write back dirty pages once the mission stops changing, so an upload
+  is written as a few page writes
+ */
+void AP_Mission_File::io_timer(void)
+{
+    if (AP_HAL::millis() - last_write_ms < MISSION_FILE_FLUSH_DELAY_MS) {
+        return;
+    }
+    flush();
+}
+
+#endif // AP_MISSION_FILE_ENABLED
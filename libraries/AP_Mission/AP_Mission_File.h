@@ -0,0 +1,85 @@
+/// @file    AP_Mission_File.h
+/// @brief   Stores mission commands in a file on the SD card
+
+/*
+ *   The AP_Mission_File library:
+ *   - stores mission commands as fixed size records in a file, in the same
+ *     format as the StorageManager mission area, allowing far larger
+ *     missions than fit in EEPROM
+ *   - accesses the file through a small cache of pages of records
+ *   - writes dirty pages back to the file from the IO thread
+ */
+#pragma once
+
+#include "AP_Mission_config.h"
+
+#if AP_MISSION_FILE_ENABLED
+
+#include <AP_HAL/AP_HAL.h>
+
+// number of records in each cached page
+#ifndef AP_MISSION_FILE_PAGE_RECORDS
+#define AP_MISSION_FILE_PAGE_RECORDS 32
+#endif
+
+// number of pages cached
+#ifndef AP_MISSION_FILE_NUM_PAGES
+#define AP_MISSION_FILE_NUM_PAGES 4
+#endif
+
+/// @class    AP_Mission_File
+/// @brief    Mission command records stored in a file
+class AP_Mission_File
+{
+public:
+
+    // open the file, creating it if needed. created is set true if the
+    // file did not hold records. Returns false if the file can't be used
+    bool open(uint32_t version, uint8_t record_size, bool &created);
+
+    // true if the file is open
+    bool is_open() const { return fd != -1; }
+
+    // read or write one record
+    bool read_record(uint16_t index, uint8_t *rec);
+    bool write_record(uint16_t index, const uint8_t *rec);
+
+    // write any dirty pages back to the file
+    void flush(void);
+
+private:
+
+    static const uint16_t page_none = UINT16_MAX;
+
+    // maximum record size that fits in a page
+    static const uint8_t record_size_max = 16;
+
+    struct page {
+        uint8_t data[AP_MISSION_FILE_PAGE_RECORDS * record_size_max];
+        uint16_t num;               // page number, page_none if unused
+        uint32_t last_use;          // use_count when the page was last used
+        bool dirty;                 // true if data has not been written to the file
+    };
+
+    // get a page, loading it from the file if needed
+    struct page *get_page(uint16_t num);
+
+    // write a page back to the file
+    bool write_page(struct page &p);
+
+    // file offset of a page
+    uint32_t page_offset(uint16_t num) const;
+
+    // called from the IO thread to write back dirty pages
+    void io_timer(void);
+
+    struct page *pages;
+    int fd = -1;
+    uint8_t record_size;
+    uint32_t use_count;
+    uint32_t last_write_ms;
+    bool io_registered;
+    HAL_Semaphore sem;
+};
+
+#endif // AP_MISSION_FILE_ENABLED
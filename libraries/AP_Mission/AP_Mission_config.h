@@ -3,3 +3,28 @@
 #ifndef AP_MISSION_ENABLED
 #define AP_MISSION_ENABLED 1
 #endif
+
+// cache decoded mission commands in RAM, with an index of the nav and
+// do-jump commands so mission advance skips over runs of do commands
+#ifndef AP_MISSION_CMD_CACHE_ENABLED
+#define AP_MISSION_CMD_CACHE_ENABLED (AP_MISSION_ENABLED && HAL_MEM_CLASS >= HAL_MEM_CLASS_500)
+#endif
+
+// maximum number of commands cached. Commands past this are read from storage
+#ifndef AP_MISSION_CMD_CACHE_MAX
+#define AP_MISSION_CMD_CACHE_MAX 1024
+#endif
+
+// allow missions to be stored in a file on the SD card, see AP_Mission_File
+#ifndef AP_MISSION_FILE_ENABLED
+#if defined(HAL_BOARD_STORAGE_DIRECTORY) && (HAL_OS_POSIX_IO || HAL_OS_FATFS_IO)
+#define AP_MISSION_FILE_ENABLED (AP_MISSION_ENABLED && HAL_MEM_CLASS >= HAL_MEM_CLASS_300)
+#else
+#define AP_MISSION_FILE_ENABLED 0
+#endif
+#endif
+
+// maximum number of commands in a mission stored in a file
+#ifndef AP_MISSION_FILE_MAX_COMMANDS
+#define AP_MISSION_FILE_MAX_COMMANDS 10000
+#endif
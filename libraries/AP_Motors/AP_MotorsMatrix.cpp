@@ -106,6 +106,7 @@ bool AP_MotorsMatrix::set_throttle_factor(int8_t motor_num, float throttle_facto
     }
 
     _throttle_factor[motor_num] = throttle_factor;
+    update_mixer();
     return true;
 }
 
@@ -174,12 +175,16 @@ void AP_MotorsMatrix::output_to_motors()
             break;
     }
 
-    // convert output to PWM and send to each motor
+    // convert output to PWM and send to all motors at once
+    uint16_t pwm[AP_MOTORS_MAX_NUM_MOTORS];
+    uint32_t motor_mask = 0;
     for (i = 0; i < AP_MOTORS_MAX_NUM_MOTORS; i++) {
         if (motor_enabled[i]) {
-            rc_write(i, output_to_pwm(_actuator[i]));
+            pwm[i] = output_to_pwm(_actuator[i]);
+            motor_mask |= 1U<<i;
         }
     }
+    rc_write_motors(pwm, motor_mask);
 }
 
 // get_motor_mask - returns a bitmask of which outputs are being used for motors (1 means being used)
@@ -204,7 +209,6 @@ uint32_t AP_MotorsMatrix::get_motor_mask()
 // includes new scaling stability patch
 void AP_MotorsMatrix::output_armed_stabilizing()
 {
-    uint8_t i;                          // general purpose counter
     float   roll_thrust;                // roll thrust input value, +/- 1.0
     float   pitch_thrust;               // pitch thrust input value, +/- 1.0
     float   yaw_thrust;                 // yaw thrust input value, +/- 1.0
@@ -266,29 +270,32 @@ void AP_MotorsMatrix::output_armed_stabilizing()
 
     // calculate amount of yaw we can fit into the throttle range
     // this is always equal to or less than the requested yaw from the pilot or rate controller
+    // the mixer rows only hold the enabled motors
     float rp_low = 1.0f;    // lowest thrust value
     float rp_high = -1.0f;  // highest thrust value
-    for (i = 0; i < AP_MOTORS_MAX_NUM_MOTORS; i++) {
-        if (motor_enabled[i]) {
-            // calculate the thrust outputs for roll and pitch
-            _thrust_rpyt_out[i] = roll_thrust * _roll_factor[i] + pitch_thrust * _pitch_factor[i];
-            // record lowest roll + pitch command
-            if (_thrust_rpyt_out[i] < rp_low) {
-                rp_low = _thrust_rpyt_out[i];
-            }
-            // record highest roll + pitch command
-            if (_thrust_rpyt_out[i] > rp_high && (!_thrust_boost || i != _motor_lost_index)) {
-                rp_high = _thrust_rpyt_out[i];
-            }
+    for (uint8_t m = 0; m < _mixer_num_motors; m++) {
+        const MixerRow &row = _mixer[m];
+        const uint8_t i = row.motor;
+        // calculate the thrust outputs for roll and pitch
+        const float rp_thrust = roll_thrust * row.roll + pitch_thrust * row.pitch;
+        _thrust_rpyt_out[i] = rp_thrust;
+        // record lowest roll + pitch command
+        if (rp_thrust < rp_low) {
+            rp_low = rp_thrust;
+        }
+        // record highest roll + pitch command
+        const bool motor_lost = _thrust_boost && i == _motor_lost_index;
+        if (rp_thrust > rp_high && !motor_lost) {
+            rp_high = rp_thrust;
+        }
 
-            // Check the maximum yaw control that can be used on this channel
-            // Exclude any lost motors if thrust boost is enabled
-            if (!is_zero(_yaw_factor[i]) && (!_thrust_boost || i != _motor_lost_index)){
-                if (is_positive(yaw_thrust * _yaw_factor[i])) {
-                    yaw_allowed = MIN(yaw_allowed, fabsf(MAX(1.0f - (throttle_thrust_best_rpy + _thrust_rpyt_out[i]), 0.0f)/_yaw_factor[i]));
-                } else {
-                    yaw_allowed = MIN(yaw_allowed, fabsf(MAX(throttle_thrust_best_rpy + _thrust_rpyt_out[i], 0.0f)/_yaw_factor[i]));
-                }
+        // Check the maximum yaw control that can be used on this channel
+        // Exclude any lost motors if thrust boost is enabled
+        if (!is_zero(row.yaw) && !motor_lost) {
+            if (is_positive(yaw_thrust * row.yaw)) {
+                yaw_allowed = MIN(yaw_allowed, MAX(1.0f - (throttle_thrust_best_rpy + rp_thrust), 0.0f) * row.yaw_abs_inv);
+            } else {
+                yaw_allowed = MIN(yaw_allowed, MAX(throttle_thrust_best_rpy + rp_thrust, 0.0f) * row.yaw_abs_inv);
             }
         }
     }
@@ -330,19 +337,20 @@ void AP_MotorsMatrix::output_armed_stabilizing()
     // add yaw control to thrust outputs
     float rpy_low = 1.0f;   // lowest thrust value
     float rpy_high = -1.0f; // highest thrust value
-    for (i = 0; i < AP_MOTORS_MAX_NUM_MOTORS; i++) {
-        if (motor_enabled[i]) {
-            _thrust_rpyt_out[i] = _thrust_rpyt_out[i] + yaw_thrust * _yaw_factor[i];
-
-            // record lowest roll + pitch + yaw command
-            if (_thrust_rpyt_out[i] < rpy_low) {
-                rpy_low = _thrust_rpyt_out[i];
-            }
-            // record highest roll + pitch + yaw command
-            // Exclude any lost motors if thrust boost is enabled
-            if (_thrust_rpyt_out[i] > rpy_high && (!_thrust_boost || i != _motor_lost_index)) {
-                rpy_high = _thrust_rpyt_out[i];
-            }
+    for (uint8_t m = 0; m < _mixer_num_motors; m++) {
+        const MixerRow &row = _mixer[m];
+        const uint8_t i = row.motor;
+        const float rpy_thrust = _thrust_rpyt_out[i] + yaw_thrust * row.yaw;
+        _thrust_rpyt_out[i] = rpy_thrust;
+
+        // record lowest roll + pitch + yaw command
+        if (rpy_thrust < rpy_low) {
+            rpy_low = rpy_thrust;
+        }
+        // record highest roll + pitch + yaw command
+        // Exclude any lost motors if thrust boost is enabled
+        if (rpy_thrust > rpy_high && (!_thrust_boost || i != _motor_lost_index)) {
+            rpy_high = rpy_thrust;
         }
     }
     // Include the lost motor scaled by _thrust_boost_ratio to smoothly transition this motor in and out of the calculation
@@ -389,10 +397,9 @@ void AP_MotorsMatrix::output_armed_stabilizing()
 
     // add scaled roll, pitch, constrained yaw and throttle for each motor
     const float throttle_thrust_best_plus_adj = throttle_thrust_best_rpy + thr_adj;
-    for (i = 0; i < AP_MOTORS_MAX_NUM_MOTORS; i++) {
-        if (motor_enabled[i]) {
-            _thrust_rpyt_out[i] = (throttle_thrust_best_plus_adj * _throttle_factor[i]) + (rpy_scale * _thrust_rpyt_out[i]);
-        }
+    for (uint8_t m = 0; m < _mixer_num_motors; m++) {
+        const MixerRow &row = _mixer[m];
+        _thrust_rpyt_out[row.motor] = (throttle_thrust_best_plus_adj * row.throttle) + (rpy_scale * _thrust_rpyt_out[row.motor]);
     }
 
     // determine throttle thrust for harmonic notch
@@ -521,6 +528,8 @@ void AP_MotorsMatrix::add_motor_raw(int8_t motor_num, float roll_fac, float pitc
 
         // call parent class method
         add_motor_num(motor_num);
+
+        update_mixer();
     }
 }
 
@@ -552,6 +561,8 @@ void AP_MotorsMatrix::remove_motor(int8_t motor_num)
         _pitch_factor[motor_num] = 0.0f;
         _yaw_factor[motor_num] = 0.0f;
         _throttle_factor[motor_num] = 0.0f;
+
+        update_mixer();
     }
 }
 
@@ -1339,6 +1350,26 @@ void AP_MotorsMatrix::normalise_rpy_factors()
             }
         }
     }
+
+    update_mixer();
+}
+
+// rebuild the packed mixer from the enabled motors and their factors
+// output_armed_stabilizing only iterates over these rows, so must be called after the motors or their factors are changed
+void AP_MotorsMatrix::update_mixer()
+{
+    _mixer_num_motors = 0;
+    for (uint8_t i = 0; i < AP_MOTORS_MAX_NUM_MOTORS; i++) {
+        if (motor_enabled[i]) {
+            MixerRow &row = _mixer[_mixer_num_motors++];
+            row.roll = _roll_factor[i];
+            row.pitch = _pitch_factor[i];
+            row.yaw = _yaw_factor[i];
+            row.throttle = _throttle_factor[i];
+            row.yaw_abs_inv = is_zero(_yaw_factor[i]) ? 0.0f : 1.0f / fabsf(_yaw_factor[i]);
+            row.motor = i;
+        }
+    }
 }
 
 
@@ -1363,6 +1394,7 @@ void AP_MotorsMatrix::disable_yaw_torque(void)
     for (uint8_t i = 0; i < AP_MOTORS_MAX_NUM_MOTORS; i++) {
         _yaw_factor[i] = 0;
     }
+    update_mixer();
 }
 
 // singleton instance
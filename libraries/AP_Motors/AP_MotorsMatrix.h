@@ -123,6 +123,10 @@ protected:
     // normalizes the roll, pitch and yaw factors so maximum magnitude is 0.5
     void                normalise_rpy_factors();
 
+    // rebuild the packed mixer from the enabled motors and their factors
+    // must be called after the motors or their factors are changed
+    void                update_mixer();
+
     // call vehicle supplied thrust compensation if set
     void                thrust_compensation(void) override;
 
@@ -141,6 +145,17 @@ protected:
     float               _thrust_rpyt_out[AP_MOTORS_MAX_NUM_MOTORS]; // combined roll, pitch, yaw and throttle outputs to motors in 0~1 range
     uint8_t             _test_order[AP_MOTORS_MAX_NUM_MOTORS];  // order of the motors in the test sequence
 
+    // packed mixer holding only the enabled motors, one contiguous row of factors per motor
+    struct MixerRow {
+        float roll;             // contribution to roll
+        float pitch;            // contribution to pitch
+        float yaw;              // contribution to yaw
+        float throttle;         // contribution to throttle
+        float yaw_abs_inv;      // 1 / |yaw|, zero if the motor has no yaw contribution
+        uint8_t motor;          // motor number
+    } _mixer[AP_MOTORS_MAX_NUM_MOTORS];
+    uint8_t             _mixer_num_motors = 0;  // number of rows in use in _mixer
+
     // motor failure handling
     float               _thrust_rpyt_out_filt[AP_MOTORS_MAX_NUM_MOTORS];    // filtered thrust outputs with 1 second time constant
     uint8_t             _motor_lost_index;  // index number of the lost motor
@@ -114,6 +114,24 @@ void AP_Motors::rc_write(uint8_t chan, uint16_t pwm)
     }
 }
 
+/*
+  write to several motor output channels at once. Motors with the PWM
+  range type go through rc_write(), the rest are written by
+  SRV_Channels in a single pass over their output channels
+ */
+void AP_Motors::rc_write_motors(const uint16_t *pwm, uint32_t motor_mask)
+{
+    const uint32_t range_mask = motor_mask & _motor_pwm_range_mask;
+    if (range_mask != 0) {
+        for (uint8_t i = 0; i < AP_MOTORS_MAX_NUM_MOTORS; i++) {
+            if (range_mask & (1U<<i)) {
+                rc_write(i, pwm[i]);
+            }
+        }
+    }
+    SRV_Channels::set_output_pwm_motors(pwm, motor_mask & ~range_mask);
+}
+
 /*
   write to an output channel for an angle actuator
  */
@@ -268,6 +268,9 @@ public:
     // direct motor write
     virtual void        rc_write(uint8_t chan, uint16_t pwm);
 
+    // direct write of the motors in motor_mask, with pwm[] indexed by motor number
+    void                rc_write_motors(const uint16_t *pwm, uint32_t motor_mask);
+
 #if AP_SCRIPTING_ENABLED
     void set_frame_string(const char * str);
 #endif
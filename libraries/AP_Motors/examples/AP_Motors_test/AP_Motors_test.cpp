@@ -19,6 +19,7 @@ void setup();
 void loop();
 void motor_order_test();
 void stability_test();
+void mixer_benchmark();
 void update_motors();
 
 #define HELI_TEST       0   // set to 1 to test helicopters
@@ -58,7 +59,7 @@ void loop()
     int16_t value;
 
     // display help
-    hal.console->printf("Press 't' to run motor orders test, 's' to run stability patch test.  Be careful the motors will spin!\n");
+    hal.console->printf("Press 't' to run motor orders test, 's' to run stability patch test, 'b' to benchmark the mixer.  Be careful the motors will spin!\n");
 
     // wait for user to enter something
     while( !hal.console->available() ) {
@@ -75,6 +76,9 @@ void loop()
     if (value == 's' || value == 'S') {
         stability_test();
     }
+    if (value == 'b' || value == 'B') {
+        mixer_benchmark();
+    }
 }
 
 // stability_test
@@ -179,6 +183,66 @@ void stability_test()
     hal.console->printf("finished test.\n");
 }
 
+#if HELI_TEST == 0
+// mixer_benchmark - time the matrix mixer for frames with increasing numbers of motors
+void mixer_benchmark()
+{
+    const struct {
+        AP_Motors::motor_frame_class frame_class;
+        const char *name;
+    } frames[] = {
+        { AP_Motors::MOTOR_FRAME_QUAD, "quad" },
+        { AP_Motors::MOTOR_FRAME_HEXA, "hexa" },
+        { AP_Motors::MOTOR_FRAME_OCTA, "octa" },
+        { AP_Motors::MOTOR_FRAME_DODECAHEXA, "dodecahexa" },
+    };
+    const uint16_t num_loops = 10000;
+
+    // arm motors
+    motors.armed(true);
+    motors.set_interlock(true);
+    motors.set_desired_spool_state(AP_Motors::DesiredSpoolState::THROTTLE_UNLIMITED);
+
+    for (const auto &frame : frames) {
+        motors.init(frame.frame_class, AP_Motors::MOTOR_FRAME_TYPE_X);
+        motors.update_throttle_range();
+        motors.set_throttle_avg_max(0.5f);
+
+        // let the spool state reach full throttle before timing
+        motors.set_throttle(0.5f);
+        update_motors();
+
+        const uint32_t start_us = AP_HAL::micros();
+        for (uint16_t i=0; i<num_loops; i++) {
+            // sweep the inputs so that the yaw headroom and saturation paths are exercised
+            const float phase = i * 0.01f;
+            motors.set_roll(0.5f * sinf(phase));
+            motors.set_pitch(0.5f * cosf(phase));
+            motors.set_yaw(0.3f * sinf(phase * 0.3f));
+            motors.set_throttle(0.5f + 0.4f * sinf(phase * 0.1f));
+            motors.output();
+        }
+        const uint32_t elapsed_us = AP_HAL::micros() - start_us;
+        hal.console->printf("%s: %.3f us per output\n", frame.name, (double)(elapsed_us / (float)num_loops));
+    }
+
+    // restore the default frame and disarm motors
+    motors.set_roll(0);
+    motors.set_pitch(0);
+    motors.set_yaw(0);
+    motors.set_throttle(0);
+    motors.armed(false);
+    motors.init(AP_Motors::MOTOR_FRAME_QUAD, AP_Motors::MOTOR_FRAME_TYPE_X);
+
+    hal.console->printf("finished benchmark.\n");
+}
+#else
+void mixer_benchmark()
+{
+    hal.console->printf("mixer benchmark is only supported for matrix frames\n");
+}
+#endif
+
 void update_motors()
 {
     // call update motors 1000 times to get any ramp limiting complete
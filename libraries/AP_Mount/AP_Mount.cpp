@@ -150,11 +150,13 @@ void AP_Mount::update()
 }
 
 // used for gimbals that need to read INS data at full rate
+// also keeps location targets (ROI, home, sysid) up to date between calls to update
 void AP_Mount::update_fast()
 {
     // update each instance
     for (uint8_t instance=0; instance<AP_MOUNT_MAX_INSTANCES; instance++) {
         if (_backends[instance] != nullptr) {
+            _backends[instance]->update_location_target();
             _backends[instance]->update_fast();
         }
     }
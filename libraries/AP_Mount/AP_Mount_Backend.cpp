@@ -6,6 +6,17 @@
 extern const AP_HAL::HAL& hal;
 
 #define AP_MOUNT_UPDATE_DT 0.02     // update rate in seconds.  update() should be called at this rate
+#define AP_MOUNT_LOC_TARGET_RATE_HZ     100     // maximum rate location targets are calculated in the fast loop
+#define AP_MOUNT_LOC_TARGET_TIMEOUT_US  100000  // location targets older than this are recalculated by the backend
+#define AP_MOUNT_SYSID_PREDICT_MAX_S    1.0f    // sysid target positions are not predicted forward further than this
+
+// returns true if two locations are the same point, in the same altitude frame
+static bool same_location(const Location &loc1, const Location &loc2)
+{
+    return loc1.same_latlon_as(loc2) &&
+           loc1.alt == loc2.alt &&
+           loc1.get_alt_frame() == loc2.get_alt_frame();
+}
 
 // get mount's current attitude in euler angles in degrees.  yaw angle is in body-frame
 // returns true on success
@@ -217,6 +228,9 @@ bool AP_Mount_Backend::handle_global_position_int(uint8_t msg_sysid, const mavli
     // global_position_int.alt is *UP*, so is location.
     _target_sysid_location.set_alt_cm(packet.alt*0.1, Location::AltFrame::ABSOLUTE);
     _target_sysid_location_set = true;
+    // global_position_int velocities are NED in cm/s
+    _target_sysid_vel_ned_ms = Vector3f(packet.vx, packet.vy, packet.vz) * 0.01f;
+    _target_sysid_location_ms = AP_HAL::millis();
 
     return true;
 }
@@ -305,6 +319,14 @@ bool AP_Mount_Backend::get_rc_angle_target(MountTarget& angle_rad) const
 // returns true on success, false on failure
 bool AP_Mount_Backend::get_angle_target_to_location(const Location &loc, MountTarget& angle_rad) const
 {
+    // use the target calculated in the fast loop if available
+    if (_loc_target.update_us != 0 &&
+        AP_HAL::micros() - _loc_target.update_us < AP_MOUNT_LOC_TARGET_TIMEOUT_US &&
+        same_location(loc, _loc_target.loc)) {
+        angle_rad = _loc_target.angle_rad;
+        return true;
+    }
+
     // exit immediately if vehicle's location is unavailable
     Location current_loc;
     if (!AP::ahrs().get_location(current_loc)) {
@@ -338,6 +360,107 @@ bool AP_Mount_Backend::get_angle_target_to_location(const Location &loc, MountTa
     return true;
 }
 
+// get the location (and velocity in m/s for sysid targets) the current mode points at
+// returns true on success, false if the mode has no location target or it is not set
+bool AP_Mount_Backend::get_mode_location_target(Location &loc, Vector3f &vel_ned_ms, uint32_t &loc_ms) const
+{
+    vel_ned_ms.zero();
+    loc_ms = AP_HAL::millis();
+
+    switch (get_mode()) {
+    case MAV_MOUNT_MODE_GPS_POINT:
+        if (!_roi_target_set) {
+            return false;
+        }
+        loc = _roi_target;
+        return true;
+
+    case MAV_MOUNT_MODE_HOME_LOCATION:
+        if (!AP::ahrs().home_is_set()) {
+            return false;
+        }
+        loc = AP::ahrs().get_home();
+        return true;
+
+    case MAV_MOUNT_MODE_SYSID_TARGET:
+        if (!_target_sysid_location_set || !_target_sysid) {
+            return false;
+        }
+        loc = _target_sysid_location;
+        vel_ned_ms = _target_sysid_vel_ned_ms;
+        loc_ms = _target_sysid_location_ms;
+        return true;
+
+    default:
+        return false;
+    }
+}
+
+// get angle targets (in radians) to a position relative to the EKF origin moving at vel_ned_ms
+// age_s is how long ago the target was at pos_ned_m
+// both the vehicle and target are predicted forward by the mount's latency
+// returns true on success, false on failure
+bool AP_Mount_Backend::get_angle_target_to_pos_NED(const Vector3f &pos_ned_m, const Vector3f &vel_ned_ms, float age_s, MountTarget& angle_rad) const
+{
+    const AP_AHRS &ahrs = AP::ahrs();
+
+    Vector3f veh_pos_ned_m;
+    if (!ahrs.get_relative_position_NED_origin(veh_pos_ned_m)) {
+        return false;
+    }
+    Vector3f veh_vel_ned_ms;
+    if (!ahrs.get_velocity_NED(veh_vel_ned_ms)) {
+        veh_vel_ned_ms.zero();
+    }
+
+    const float latency_s = constrain_float(_params.latency, 0.0f, 0.5f);
+    const float target_dt = constrain_float(age_s + latency_s, 0.0f, AP_MOUNT_SYSID_PREDICT_MAX_S);
+    const Vector3f diff_ned_m = (pos_ned_m + vel_ned_ms * target_dt) - (veh_pos_ned_m + veh_vel_ned_ms * latency_s);
+
+    // calculate roll, pitch, yaw angles
+    angle_rad.roll = 0;
+    angle_rad.pitch = atan2f(-diff_ned_m.z, diff_ned_m.xy().length());
+    angle_rad.yaw = atan2f(diff_ned_m.y, diff_ned_m.x);
+    angle_rad.yaw_is_ef = true;
+
+    return true;
+}
+
+// update the angle target to the current mode's location (ROI, home or sysid)
+// from the AHRS state. Called from the fast loop, rate limited to AP_MOUNT_LOC_TARGET_RATE_HZ
+void AP_Mount_Backend::update_location_target()
+{
+    const uint32_t now_us = AP_HAL::micros();
+    if (_loc_target.update_us != 0 && now_us - _loc_target.update_us < 1000000UL / AP_MOUNT_LOC_TARGET_RATE_HZ) {
+        return;
+    }
+    _loc_target.update_us = 0;
+
+    Location loc;
+    Vector3f vel_ned_ms;
+    uint32_t loc_ms;
+    if (!get_mode_location_target(loc, vel_ned_ms, loc_ms)) {
+        return;
+    }
+
+    // the offset from the EKF origin is only recalculated when the location changes
+    if (!_loc_target.pos_valid || !same_location(loc, _loc_target.loc)) {
+        _loc_target.loc = loc;
+        Vector3f pos_neu_cm;
+        _loc_target.pos_valid = loc.get_vector_from_origin_NEU(pos_neu_cm);
+        _loc_target.pos_ned_m = Vector3f(pos_neu_cm.x, pos_neu_cm.y, -pos_neu_cm.z) * 0.01f;
+    }
+    if (!_loc_target.pos_valid) {
+        return;
+    }
+
+    const float age_s = (AP_HAL::millis() - loc_ms) * 0.001f;
+    if (get_angle_target_to_pos_NED(_loc_target.pos_ned_m, vel_ned_ms, age_s, _loc_target.angle_rad)) {
+        // never zero so zero can mean invalid
+        _loc_target.update_us = MAX(now_us, 1U);
+    }
+}
+
 // get angle targets (in radians) to ROI location
 // returns true on success, false on failure
 bool AP_Mount_Backend::get_angle_target_to_roi(MountTarget& angle_rad) const
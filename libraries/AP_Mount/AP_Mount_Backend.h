@@ -43,6 +43,10 @@ public:
     // used for gimbals that need to read INS data at full rate
     virtual void update_fast() {}
 
+    // update the angle target to the current mode's location (ROI, home or sysid)
+    // from the AHRS state. Called from the fast loop, rate limited to AP_MOUNT_LOC_TARGET_RATE_HZ
+    void update_location_target();
+
     // return true if healthy
     virtual bool healthy() const { return true; }
 
@@ -163,9 +167,19 @@ protected:
     bool get_rc_angle_target(MountTarget& angle_rad) const WARN_IF_UNUSED;
 
     // get angle targets (in radians) to a Location
+    // uses the target computed by update_location_target if it is recent and for the same location
     // returns true on success, false on failure
     bool get_angle_target_to_location(const Location &loc, MountTarget& angle_rad) const WARN_IF_UNUSED;
 
+    // get the location (and velocity in m/s for sysid targets) the current mode points at
+    // returns true on success, false if the mode has no location target or it is not set
+    bool get_mode_location_target(Location &loc, Vector3f &vel_ned_ms, uint32_t &loc_ms) const WARN_IF_UNUSED;
+
+    // get angle targets (in radians) to a position relative to the EKF origin moving at vel_ned_ms
+    // both the vehicle and target are predicted forward by the mount's latency
+    // returns true on success, false on failure
+    bool get_angle_target_to_pos_NED(const Vector3f &pos_ned_m, const Vector3f &vel_ned_ms, float age_s, MountTarget& angle_rad) const WARN_IF_UNUSED;
+
     // get angle targets (in radians) to ROI location
     // returns true on success, false on failure
     bool get_angle_target_to_roi(MountTarget& angle_rad) const WARN_IF_UNUSED;
@@ -215,6 +229,17 @@ protected:
     uint8_t _target_sysid;          // sysid to track
     Location _target_sysid_location;// sysid target location
     bool _target_sysid_location_set;// true if _target_sysid has been set
+    Vector3f _target_sysid_vel_ned_ms;  // sysid target velocity in m/s
+    uint32_t _target_sysid_location_ms; // system time sysid target location was received
+
+    // location target computed in the fast loop, used by the backend's next update
+    struct {
+        Location loc;               // location the offset below was computed from
+        Vector3f pos_ned_m;         // location as an offset from the EKF origin in meters
+        bool pos_valid;             // true if pos_ned_m matches loc
+        MountTarget angle_rad;      // angle target to loc
+        uint32_t update_us;         // system time angle_rad was calculated, zero if invalid
+    } _loc_target;
 
     uint32_t _last_warning_ms;      // system time of last warning sent to GCS
 };
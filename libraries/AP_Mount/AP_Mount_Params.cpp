@@ -152,6 +152,15 @@ const AP_Param::GroupInfo AP_Mount_Params::var_info[] = {
     // @User: Standard
     AP_GROUPINFO("_LEAD_PTCH", 13, AP_Mount_Params, pitch_stb_lead, 0.0f),
 
+    // @Param: _LATENCY
+    // @DisplayName: Mount target latency
+    // @Description: Time from a target angle being sent until the gimbal reaches it. When pointing at a location (ROI, home or another vehicle) the vehicle's and target's positions are predicted forward by this much so the gimbal does not lag a moving vehicle or target
+    // @Units: s
+    // @Range: 0.0 0.5
+    // @Increment: .01
+    // @User: Advanced
+    AP_GROUPINFO("_LATENCY", 14, AP_Mount_Params, latency, 0.0f),
+
     AP_GROUPEND
 };
 
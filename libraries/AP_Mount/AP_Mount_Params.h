@@ -29,4 +29,5 @@ public:
 
     AP_Float    roll_stb_lead;      // roll lead control gain (only used by servo backend)
     AP_Float    pitch_stb_lead;     // pitch lead control gain (only used by servo backend)
+    AP_Float    latency;            // time in seconds for the gimbal to reach a target, location targets are predicted forward by this
 };
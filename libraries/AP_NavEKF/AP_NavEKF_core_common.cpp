@@ -16,6 +16,16 @@
  */
 #include "AP_NavEKF_core_common.h"
 
+#if !HAL_WITH_EKF_DOUBLE && !MATH_CHECK_INDEXES
+#if defined(__SSE__)
+#include <xmmintrin.h>
+#define EKF_COV_SSE 1
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#define EKF_COV_NEON 1
+#endif
+#endif
+
 NavEKF_core_common::Matrix24 NavEKF_core_common::KH;
 NavEKF_core_common::Matrix24 NavEKF_core_common::KHP;
 NavEKF_core_common::Matrix24 NavEKF_core_common::nextP;
@@ -37,3 +47,74 @@ void NavEKF_core_common::fill_scratch_variables(void)
     fill_nanf(&Kfusion[0], sizeof(Kfusion)/sizeof(ftype));
 #endif
 }
+
+/*
+  covariance correction for a scalar observation with a sparse H. H*P
+  is formed once as a row vector, so the update is rank-1
+ */
+bool NavEKF_core_common::fuseCovariance(Matrix24 &P, uint8_t stateIndexLim, const ftype *H, const uint8_t *Hidx, uint8_t nH, bool checkVariances)
+{
+    ftype HP[24];
+    for (uint8_t j = 0; j <= stateIndexLim; j++) {
+        ftype res = 0;
+        for (uint8_t k = 0; k < nH; k++) {
+            res += H[Hidx[k]] * P[Hidx[k]][j];
+        }
+        HP[j] = res;
+    }
+    return fuseCovarianceHP(P, stateIndexLim, HP, checkVariances);
+}
+
+/*
+  covariance correction for a direct observation of one state, where
+  H*P is that state's row of P
+ */
+bool NavEKF_core_common::fuseCovarianceDirect(Matrix24 &P, uint8_t stateIndexLim, uint8_t obsIndex, bool checkVariances)
+{
+    ftype HP[24];
+    for (uint8_t j = 0; j <= stateIndexLim; j++) {
+        HP[j] = P[obsIndex][j];
+    }
+    return fuseCovarianceHP(P, stateIndexLim, HP, checkVariances);
+}
+
+/*
+  P = P - K*HP. Rows of states with a zero gain are unchanged and are
+  skipped, which covers the inhibited states
+ */
+bool NavEKF_core_common::fuseCovarianceHP(Matrix24 &P, uint8_t stateIndexLim, const ftype *HP, bool checkVariances)
+{
+    if (checkVariances) {
+        // check that we are not going to drive any variances negative
+        for (uint8_t i = 0; i <= stateIndexLim; i++) {
+            if (Kfusion[i] * HP[i] > P[i][i]) {
+                return false;
+            }
+        }
+    }
+
+    const uint8_t n = stateIndexLim + 1;
+    for (uint8_t i = 0; i < n; i++) {
+        const ftype K = Kfusion[i];
+        if (!(fabsF(K) > 0)) {
+            continue;
+        }
+        ftype *row = &P[i][0];
+        uint8_t j = 0;
+#if EKF_COV_SSE
+        const __m128 Kv = _mm_set1_ps(K);
+        for (; j + 4 <= n; j += 4) {
+            const __m128 p = _mm_loadu_ps(&row[j]);
+            _mm_storeu_ps(&row[j], _mm_sub_ps(p, _mm_mul_ps(Kv, _mm_loadu_ps(&HP[j]))));
+        }
+#elif EKF_COV_NEON
+        for (; j + 4 <= n; j += 4) {
+            vst1q_f32(&row[j], vmlsq_n_f32(vld1q_f32(&row[j]), vld1q_f32(&HP[j]), K));
+        }
+#endif
+        for (; j < n; j++) {
+            row[j] -= K * HP[j];
+        }
+    }
+    return true;
+}
@@ -54,6 +54,24 @@ protected:
     static void zero_range(ftype *v, uint8_t n1, uint8_t n2) {
         memset(&v[n1], 0, sizeof(ftype)*(1+(n2-n1)));
     }
+
+    /*
+      covariance correction for the fusion of a scalar observation,
+      P = P - K*(H*P) with K in Kfusion, over states 0 to
+      stateIndexLim. H is only read at the nH state indexes in Hidx,
+      all other elements being zero. If checkVariances is true and any
+      variance would become negative then P is left unchanged and false
+      is returned
+     */
+    static bool fuseCovariance(Matrix24 &P, uint8_t stateIndexLim, const ftype *H, const uint8_t *Hidx, uint8_t nH, bool checkVariances);
+
+    // as fuseCovariance() for a direct observation of state obsIndex
+    static bool fuseCovarianceDirect(Matrix24 &P, uint8_t stateIndexLim, uint8_t obsIndex, bool checkVariances);
+
+private:
+
+    // rank-1 update P = P - K*HP, shared by the fuseCovariance functions
+    static bool fuseCovarianceHP(Matrix24 &P, uint8_t stateIndexLim, const ftype *HP, bool checkVariances);
 };
 
 #if HAL_WITH_EKF_DOUBLE && !defined(__clang__)
@@ -19,10 +19,13 @@ bool ekf_ring_buffer::init(uint8_t _size)
     if (buffer) {
         free(buffer);
     }
-    buffer = calloc(_size, elsize);
+    // the timestamps are stored after the elements, elsize is a
+    // multiple of 4 as elements start with a uint32_t
+    buffer = calloc(_size, elsize + sizeof(uint32_t));
     if (buffer == nullptr) {
         return false;
     }
+    times_ms = (uint32_t *)get_offset(_size);
     size = _size;
     reset();
     return true;
@@ -36,15 +39,6 @@ void *ekf_ring_buffer::get_offset(uint8_t idx) const
     return (void*)(((uint8_t*)buffer)+idx*uint32_t(elsize));
 }
 
-/*
-  get a reference to the timestamp for an index
- */
-uint32_t ekf_ring_buffer::time_ms(uint8_t idx) const
-{
-    EKF_obs_element_t *el = (EKF_obs_element_t *)get_offset(idx);
-    return el->time_ms;
-}
-
 /*
   Search through a ring buffer and return the newest data that is
   older than the time specified by sample_time_ms
@@ -52,25 +46,33 @@ uint32_t ekf_ring_buffer::time_ms(uint8_t idx) const
 */
 bool ekf_ring_buffer::recall(void *element, const uint32_t sample_time_ms)
 {
-    bool ret = false;
+    // scan the timestamps for the last element to be consumed,
+    // only the newest matching element is copied out
+    int16_t found = -1;
+    uint8_t idx = oldest;
     while (count > 0) {
-        const uint32_t toldest = time_ms(oldest);
-        const int32_t dt = sample_time_ms - toldest;
-        const bool matches = dt >= 0 && dt < 100;
-        if (matches) {
-            memcpy(element, get_offset(oldest), elsize);
-            ret = true;
-        }
+        const int32_t dt = sample_time_ms - times_ms[idx];
         if (dt < 0) {
             // the oldest element is younger than we want, stop
             // searching and don't consume this element
             break;
         }
+        if (dt < 100) {
+            found = idx;
+        }
         // discard the sample
         count--;
-        oldest = (oldest+1) % size;
+        idx++;
+        if (idx == size) {
+            idx = 0;
+        }
     }
-    return ret;
+    oldest = idx;
+    if (found < 0) {
+        return false;
+    }
+    memcpy(element, get_offset(found), elsize);
+    return true;
 }
 
 /*
@@ -88,6 +90,7 @@ void ekf_ring_buffer::push(const void *element)
 
     // New data is written at the head
     memcpy(get_offset(head), element, elsize);
+    times_ms[head] = ((const EKF_obs_element_t *)element)->time_ms;
 
     if (count < size) {
         count++;
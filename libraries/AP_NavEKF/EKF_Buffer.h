@@ -43,6 +43,10 @@ private:
     const uint8_t elsize;
     void *buffer;
 
+    // copy of the element timestamps, kept separately so that recall()
+    // can search them without touching the element data
+    uint32_t *times_ms;
+
     // size of allocated buffer in elsize units
     uint8_t size;
 
@@ -52,7 +56,6 @@ private:
     // total number of elements in the buffer
     uint8_t count;
 
-    uint32_t time_ms(uint8_t idx) const;
     void *get_offset(uint8_t idx) const;
 };
 
@@ -0,0 +1,108 @@
+#include <AP_gbenchmark.h>
+
+#include <AP_NavEKF/AP_NavEKF_core_common.h>
+
+const AP_HAL::HAL& hal = AP_HAL::get_HAL();
+
+/*
+  benchmarks of the covariance correction used by the EKF3 scalar
+  fusions, P = P - K*(H*P) over 24 states. The gain changes sign on
+  each call so P stays close to its starting value
+ */
+class CovarianceBench : public NavEKF_core_common {
+public:
+    using NavEKF_core_common::fuseCovariance;
+    using NavEKF_core_common::fuseCovarianceDirect;
+
+    CovarianceBench() {
+        for (uint8_t i = 0; i < 24; i++) {
+            for (uint8_t j = 0; j < 24; j++) {
+                P[i][j] = (i == j) ? 1.0f : 0.01f / (1 + i + j);
+            }
+            H[i] = 0.1f * (i + 1);
+        }
+    }
+
+    void set_gain(ftype k) {
+        for (uint8_t i = 0; i < 24; i++) {
+            Kfusion[i] = k * (i + 1);
+        }
+    }
+
+    // the covariance correction as it was written out in each fusion,
+    // with KH and KHP formed in full
+    void fuse_KHP(const uint8_t *Hidx, uint8_t nH) {
+        for (uint8_t i = 0; i < 24; i++) {
+            for (uint8_t j = 0; j < 24; j++) {
+                KH[i][j] = 0;
+            }
+            for (uint8_t k = 0; k < nH; k++) {
+                KH[i][Hidx[k]] = Kfusion[i] * H[Hidx[k]];
+            }
+        }
+        for (uint8_t j = 0; j < 24; j++) {
+            for (uint8_t i = 0; i < 24; i++) {
+                ftype res = 0;
+                for (uint8_t k = 0; k < nH; k++) {
+                    res += KH[i][Hidx[k]] * P[Hidx[k]][j];
+                }
+                KHP[i][j] = res;
+            }
+        }
+        for (uint8_t i = 0; i < 24; i++) {
+            for (uint8_t j = 0; j < 24; j++) {
+                P[i][j] = P[i][j] - KHP[i][j];
+            }
+        }
+    }
+
+    Matrix24 P;
+    ftype H[24];
+};
+
+static CovarianceBench bench;
+
+// observation indexes of the magnetometer and odometry fusions
+static const uint8_t mag_idx[] {0, 1, 2, 3, 16, 17, 18, 19, 20, 21};
+static const uint8_t vel_idx[] {0, 1, 2, 3, 4, 5, 6};
+
+static void BM_FuseCovariance(benchmark::State& state, const uint8_t *Hidx, uint8_t nH)
+{
+    ftype k = 1.0e-4f;
+    while (state.KeepRunning()) {
+        bench.set_gain(k);
+        bench.fuseCovariance(bench.P, 23, bench.H, Hidx, nH, true);
+        k = -k;
+        gbenchmark_escape(&bench.P);
+    }
+}
+
+static void BM_FuseCovarianceKHP(benchmark::State& state, const uint8_t *Hidx, uint8_t nH)
+{
+    ftype k = 1.0e-4f;
+    while (state.KeepRunning()) {
+        bench.set_gain(k);
+        bench.fuse_KHP(Hidx, nH);
+        k = -k;
+        gbenchmark_escape(&bench.P);
+    }
+}
+
+static void BM_FuseCovarianceDirect(benchmark::State& state)
+{
+    ftype k = 1.0e-4f;
+    while (state.KeepRunning()) {
+        bench.set_gain(k);
+        bench.fuseCovarianceDirect(bench.P, 23, 7, true);
+        k = -k;
+        gbenchmark_escape(&bench.P);
+    }
+}
+
+BENCHMARK_CAPTURE(BM_FuseCovariance, mag, mag_idx, ARRAY_SIZE(mag_idx));
+BENCHMARK_CAPTURE(BM_FuseCovariance, vel, vel_idx, ARRAY_SIZE(vel_idx));
+BENCHMARK_CAPTURE(BM_FuseCovarianceKHP, mag, mag_idx, ARRAY_SIZE(mag_idx));
+BENCHMARK_CAPTURE(BM_FuseCovarianceKHP, vel, vel_idx, ARRAY_SIZE(vel_idx));
+BENCHMARK(BM_FuseCovarianceDirect);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,41 @@
+#include <AP_gbenchmark.h>
+
+#include <AP_NavEKF/EKFGSF_yaw.h>
+
+const AP_HAL::HAL& hal = AP_HAL::get_HAL();
+
+/*
+  benchmark of the EKF-GSF yaw estimator at a 400Hz EKF prediction
+  rate with 10Hz GPS velocity fusion, the argument being the number of
+  estimators, e.g. one per EKF3 lane
+ */
+static const uint16_t rate_hz = 400;
+static const uint8_t fuse_interval = 40;
+
+static void BM_EKFGSF_yaw(benchmark::State& state)
+{
+    const uint8_t num_estimators = state.range(0);
+    EKFGSF_yaw *gsf = new EKFGSF_yaw[num_estimators];
+    const ftype dt = 1.0f / rate_hz;
+
+    uint32_t i = 0;
+    while (state.KeepRunning()) {
+        const ftype t = (i % (rate_hz * 60)) * dt;
+        const Vector3F delAng(0.01f * sinF(t), 0.005f * cosF(0.7f * t), 0.02f * sinF(0.3f * t));
+        const Vector3F delVel(0.02f * sinF(t), 0.02f * cosF(t), -GRAVITY_MSS * dt);
+        const Vector2F vel(5 * cosF(0.05f * t), 5 * sinF(0.05f * t));
+        for (uint8_t e = 0; e < num_estimators; e++) {
+            gsf[e].update(delAng, delVel, dt, dt, true, 0);
+            if (i % fuse_interval == 0) {
+                gsf[e].fuseVelData(vel, 0.3f);
+            }
+        }
+        i++;
+        gbenchmark_escape(gsf);
+    }
+    delete[] gsf;
+}
+
+BENCHMARK(BM_EKFGSF_yaw)->Arg(1)->Arg(3);
+
+BENCHMARK_MAIN();
@@ -119,6 +119,44 @@ TEST(EKF_Buffer, EKF_Buffer)
     EXPECT_FALSE(buf.recall(d2, 103));
 }
 
+TEST(EKF_Buffer, EKF_Buffer_Recall)
+{
+    struct test_data : EKF_obs_element_t {
+        uint32_t data;
+    };
+    EKF_obs_buffer_t<test_data> buf;
+    buf.init(4);
+    struct test_data d, d2;
+
+    // several elements match, the newest is returned
+    for (uint8_t i=0; i<3; i++) {
+        d.time_ms = 100+i;
+        d.data = i;
+        buf.push(d);
+    }
+    EXPECT_TRUE(buf.recall(d2, 110));
+    EXPECT_EQ(d2.data, 2U);
+    EXPECT_EQ(d2.time_ms, uint32_t(102));
+    EXPECT_FALSE(buf.recall(d2, 110));
+
+    // search stops at the first element younger than the sample time,
+    // across the end of the buffer
+    d.time_ms = 120;
+    d.data = 10;
+    buf.push(d);
+    d.time_ms = 130;
+    d.data = 11;
+    buf.push(d);
+    d.time_ms = 121;
+    d.data = 12;
+    buf.push(d);
+    EXPECT_TRUE(buf.recall(d2, 125));
+    EXPECT_EQ(d2.data, 10U);
+    EXPECT_TRUE(buf.recall(d2, 130));
+    EXPECT_EQ(d2.data, 12U);
+    EXPECT_FALSE(buf.recall(d2, 130));
+}
+
 AP_GTEST_MAIN()
 
 #endif // HAL_SITL or HAL_LINUX
@@ -10,6 +10,10 @@
 
 #include <new>
 
+#if EK3_FEATURE_CORE_THREADS
+extern const AP_HAL::HAL& hal;
+#endif
+
 /*
   parameter defaults for different types of vehicle. The
   APM_BUILD_DIRECTORY is taken from the main vehicle directory name
@@ -734,6 +738,24 @@ const AP_Param::GroupInfo NavEKF3::var_info2[] = {
     // @Units: m
     AP_GROUPINFO("GPS_VACC_MAX", 10, NavEKF3, _gpsVAccThreshold, 0.0f),
 
+    // @Param: OPTIONS
+    // @DisplayName: EKF3 options
+    // @Description: EKF3 options. Running the cores on worker threads updates each core after the first on its own thread pinned to a CPU, in parallel with the first core. This is only available on Linux boards. Lane fusion scheduling limits the number of GPS, optical flow, range beacon, airspeed and magnetometer fusion steps done across all cores in each loop, so that cores which would fuse in the same loop are spread over the following loops. It has no effect when the cores run on worker threads.
+    // @Bitmask: 0:RunCoresOnThreads,1:LaneFusionScheduling
+    // @User: Advanced
+    // @RebootRequired: True
+    AP_GROUPINFO("OPTIONS", 11, NavEKF3, _options, 0),
+
+    // @Param: PRED_RATE
+    // @DisplayName: EKF3 prediction rate
+    // @Description: Target rate of the EKF3 state and covariance prediction and of the sensor fusion. IMU data is accumulated between predictions without coning or sculling errors, and the output observer still runs at the main loop rate. Lower rates reduce the CPU load at the cost of navigation accuracy. Set to zero for the maximum rate of 83Hz.
+    // @Range: 0 83
+    // @Increment: 1
+    // @Units: Hz
+    // @User: Advanced
+    // @RebootRequired: True
+    AP_GROUPINFO("PRED_RATE", 12, NavEKF3, _predictRate_hz, 0),
+
     AP_GROUPEND
 };
 
@@ -745,6 +767,19 @@ NavEKF3::NavEKF3()
 
 
 // Initialise the filter
+/*
+  return the target time between state and covariance predictions. The
+  buffers are sized for EKF_TARGET_DT so only lower rates can be selected
+ */
+float NavEKF3::get_predict_dt() const
+{
+    if (_predictRate_hz <= 0) {
+        return EKF_TARGET_DT;
+    }
+    const float rate_hz = MAX(_predictRate_hz.get(), EKF_PREDICT_RATE_MIN_HZ);
+    return MAX(1.0f / rate_hz, EKF_TARGET_DT);
+}
+
 bool NavEKF3::InitialiseFilter(void)
 {
     if (_enable == 0 || _imuMask == 0) {
@@ -764,7 +799,7 @@ bool NavEKF3::InitialiseFilter(void)
     _frameTimeUsec = 1e6 / loop_rate;
 
     // expected number of IMU frames per prediction
-    _framesPerPrediction = uint8_t((EKF_TARGET_DT / (_frameTimeUsec * 1.0e-6) + 0.5));
+    _framesPerPrediction = uint8_t((get_predict_dt() / (_frameTimeUsec * 1.0e-6) + 0.5));
 
 #if !APM_BUILD_TYPE(APM_BUILD_AP_DAL_Standalone)
     // convert parameters if necessary
@@ -818,6 +853,12 @@ bool NavEKF3::InitialiseFilter(void)
         for (uint8_t i = 0; i < num_cores; i++) {
             new (&core[i]) NavEKF3_core(this);
         }
+
+#if EK3_FEATURE_CORE_THREADS
+        if (option_is_set(Option::CORE_THREADS)) {
+            start_core_threads();
+        }
+#endif
     }
 
     // Set up any cores that have been created
@@ -837,6 +878,12 @@ bool NavEKF3::InitialiseFilter(void)
         return false;
     }
 
+    // allow as many expensive fusion steps per frame as there are
+    // core predictions per frame on average, so with the predictions
+    // spread over frames each core can fuse on every prediction
+    const uint8_t frames = MAX(_framesPerPrediction, 1);
+    _fusionSlotsPerFrame = MAX((num_cores + frames - 1) / frames, 1);
+
     // set relative error scores for all cores to 0
     resetCoreErrors();
 
@@ -894,6 +941,114 @@ bool NavEKF3::coreBetterScore(uint8_t new_core, uint8_t current_core) const
   Update Filter States - this should be called whenever new IMU data is available
   Execution speed governed by SCHED_LOOP_RATE
 */
+bool NavEKF3::allow_state_prediction(uint8_t core_index) const
+{
+    // if we have not overrun by more than 3 IMU frames, and we
+    // have already used more than 1/3 of the CPU budget for this
+    // loop then suppress the prediction step. This allows
+    // multiple EKF instances to cooperate on scheduling
+    if (core[core_index].getFramesSincePredict() < (_framesPerPrediction+3) &&
+        AP::dal().ekf_low_time_remaining(AP_DAL::EKFType::EKF3, core_index)) {
+        return false;
+    }
+    return true;
+}
+
+/*
+  return true if a core may do an expensive fusion step this frame
+  under lane fusion scheduling. The decision depends only on the
+  fusion done by the cores earlier in the frame, so it is repeated
+  exactly in replay
+ */
+bool NavEKF3::fusion_slot_available(void) const
+{
+    if (!option_is_set(Option::LANE_SCHEDULING)) {
+        return true;
+    }
+#if EK3_FEATURE_CORE_THREADS
+    if (core_threads != nullptr) {
+        // each core has its own CPU
+        return true;
+    }
+#endif
+    return _fusionSlotsUsed < _fusionSlotsPerFrame;
+}
+
+// record that a core has done an expensive fusion step this frame
+void NavEKF3::use_fusion_slot(void)
+{
+#if EK3_FEATURE_CORE_THREADS
+    if (core_threads != nullptr) {
+        return;
+    }
+#endif
+    if (_fusionSlotsUsed < UINT8_MAX) {
+        _fusionSlotsUsed++;
+    }
+}
+
+#if EK3_FEATURE_CORE_THREADS
+/*
+  start a worker thread for each core after the first. If any thread
+  cannot be started the cores are all updated on the main thread
+ */
+void NavEKF3::start_core_threads(void)
+{
+    if (num_cores < 2) {
+        return;
+    }
+    CoreThread *threads = new CoreThread[num_cores-1];
+    if (threads == nullptr) {
+        GCS_SEND_TEXT(MAV_SEVERITY_WARNING, "EKF3 core threads allocation failed");
+        return;
+    }
+    for (uint8_t i=1; i<num_cores; i++) {
+        // core i runs on CPU i, leaving CPU 0 for the main thread
+        if (!threads[i-1].start(core[i], i)) {
+            // threads which have started stay blocked waiting for a
+            // run() which will never come
+            GCS_SEND_TEXT(MAV_SEVERITY_WARNING, "EKF3 core thread start failed");
+            return;
+        }
+    }
+    core_threads = threads;
+}
+
+bool NavEKF3::CoreThread::start(NavEKF3_core &_core, uint8_t _cpu)
+{
+    core = &_core;
+    cpu = _cpu;
+    return hal.scheduler->thread_create(FUNCTOR_BIND_MEMBER(&NavEKF3::CoreThread::thread_main, void),
+                                        "EKF3",
+                                        16384, AP_HAL::Scheduler::PRIORITY_MAIN, 0);
+}
+
+// fork the update of the core
+void NavEKF3::CoreThread::run(bool _allow_state_prediction)
+{
+    allow_state_prediction = _allow_state_prediction;
+    run_sem.signal();
+}
+
+// join the update of the core
+void NavEKF3::CoreThread::wait(void)
+{
+    done_sem.wait_blocking();
+}
+
+void NavEKF3::CoreThread::thread_main(void)
+{
+    if (!hal.scheduler->set_thread_cpu_affinity(cpu)) {
+        GCS_SEND_TEXT(MAV_SEVERITY_INFO, "EKF3 core thread not pinned to CPU %u", unsigned(cpu));
+    }
+    while (true) {
+        run_sem.wait_blocking();
+        core->UpdateFilter(allow_state_prediction);
+        done_sem.signal();
+    }
+}
+#endif // EK3_FEATURE_CORE_THREADS
+
 void NavEKF3::UpdateFilter(void)
 {
     AP::dal().start_frame(AP_DAL::FrameType::UpdateFilterEKF3);
@@ -904,17 +1059,26 @@ void NavEKF3::UpdateFilter(void)
 
     imuSampleTime_us = AP::dal().micros64();
 
-    for (uint8_t i=0; i<num_cores; i++) {
-        // if we have not overrun by more than 3 IMU frames, and we
-        // have already used more than 1/3 of the CPU budget for this
-        // loop then suppress the prediction step. This allows
-        // multiple EKF instances to cooperate on scheduling
-        bool allow_state_prediction = true;
-        if (core[i].getFramesSincePredict() < (_framesPerPrediction+3) &&
-            AP::dal().ekf_low_time_remaining(AP_DAL::EKFType::EKF3, i)) {
-            allow_state_prediction = false;
+    // start a new frame of fusion scheduling
+    _fusionSlotsUsed = 0;
+
+#if EK3_FEATURE_CORE_THREADS
+    if (core_threads != nullptr) {
+        // fork the update of the other cores, update the first core
+        // on this thread and then wait for the others to complete
+        for (uint8_t i=1; i<num_cores; i++) {
+            core_threads[i-1].run(allow_state_prediction(i));
+        }
+        core[0].UpdateFilter(allow_state_prediction(0));
+        for (uint8_t i=1; i<num_cores; i++) {
+            core_threads[i-1].wait();
+        }
+    } else
+#endif
+    {
+        for (uint8_t i=0; i<num_cores; i++) {
+            core[i].UpdateFilter(allow_state_prediction(i));
         }
-        core[i].UpdateFilter(allow_state_prediction);
     }
 
     // If the current core selected has a bad error score or is unhealthy, switch to a healthy core with the lowest fault score
@@ -2051,3 +2215,30 @@ const EKFGSF_yaw *NavEKF3::get_yawEstimator(void) const
     }
     return nullptr;
 }
+
+#if EK3_FEATURE_KERNEL_TIMING
+// get the execution time of a NavEKF3_core::Kernel summed over all cores
+void NavEKF3::get_kernel_timing(uint8_t kernel, uint64_t &total_ns, uint32_t &count) const
+{
+    total_ns = 0;
+    count = 0;
+    if (!core || kernel >= uint8_t(NavEKF3_core::Kernel::NUM_KERNELS)) {
+        return;
+    }
+    for (uint8_t i=0; i<num_cores; i++) {
+        const auto &timing = core[i].get_kernel_timing(NavEKF3_core::Kernel(kernel));
+        total_ns += timing.total_ns;
+        count += timing.count;
+    }
+}
+
+void NavEKF3::reset_kernel_timing(void)
+{
+    if (!core) {
+        return;
+    }
+    for (uint8_t i=0; i<num_cores; i++) {
+        core[i].reset_kernel_timing();
+    }
+}
+#endif // EK3_FEATURE_KERNEL_TIMING
@@ -24,6 +24,7 @@
 #include <AP_Param/AP_Param.h>
 #include <AP_NavEKF/AP_Nav_Common.h>
 #include <AP_NavEKF/AP_NavEKF_Source.h>
+#include "AP_NavEKF3_feature.h"
 
 class NavEKF3_core;
 class EKFGSF_yaw;
@@ -360,13 +361,62 @@ public:
     // get a yaw estimator instance
     const EKFGSF_yaw *get_yawEstimator(void) const;
 
+#if EK3_FEATURE_KERNEL_TIMING
+    // get the execution time of a NavEKF3_core::Kernel summed over all cores
+    void get_kernel_timing(uint8_t kernel, uint64_t &total_ns, uint32_t &count) const;
+    void reset_kernel_timing(void);
+#endif
+
 private:
     uint8_t num_cores; // number of allocated cores
     uint8_t primary;   // current primary core
     NavEKF3_core *core = nullptr;
 
+#if EK3_FEATURE_CORE_THREADS
+    /*
+      a worker thread running UpdateFilter() for one core. The main
+      thread forks the update with run() and joins with wait()
+     */
+    class CoreThread {
+    public:
+        bool start(NavEKF3_core &_core, uint8_t _cpu);
+        void run(bool _allow_state_prediction);
+        void wait(void);
+
+    private:
+        void thread_main(void);
+
+        NavEKF3_core *core;
+        uint8_t cpu;
+        bool allow_state_prediction;
+        HAL_BinarySemaphore run_sem;
+        HAL_BinarySemaphore done_sem;
+    };
+
+    // worker threads for cores 1 to num_cores-1, core 0 is updated
+    // on the calling thread
+    CoreThread *core_threads;
+    void start_core_threads(void);
+
+    // protects the common origin when cores are updated in parallel
+    HAL_Semaphore origin_sem;
+#endif
+
+    // return false if the prediction step of a core should be
+    // skipped this frame to save CPU time
+    bool allow_state_prediction(uint8_t core_index) const;
+
     uint32_t _frameTimeUsec;        // time per IMU frame
     uint8_t  _framesPerPrediction;  // expected number of IMU frames per prediction
+
+    // lane fusion scheduling. When enabled at most
+    // _fusionSlotsPerFrame expensive fusion steps are done across all
+    // cores in a frame, a core finding no slot free delays its fusion
+    // to its next prediction
+    uint8_t _fusionSlotsPerFrame;   // expensive fusion steps allowed per IMU frame
+    uint8_t _fusionSlotsUsed;       // expensive fusion steps done so far this IMU frame
+    bool fusion_slot_available(void) const;
+    void use_fusion_slot(void);
   
     // values for EK3_LOG_LEVEL
     enum class LogLevel {
@@ -443,6 +493,20 @@ private:
     AP_Int8 _primary_core;          // initial core number
     AP_Enum<LogLevel> _log_level;   // log verbosity level
     AP_Float _gpsVAccThreshold;     // vertical accuracy threshold to use GPS as an altitude source
+    AP_Int32 _options;              // bitmask of Option values
+    AP_Int8 _predictRate_hz;        // target state and covariance prediction rate (Hz), 0 for the maximum rate
+
+    // target time between state and covariance predictions (sec)
+    float get_predict_dt() const;
+
+    // values for EK3_OPTIONS
+    enum class Option : uint32_t {
+        CORE_THREADS = (1U<<0),     // run the cores on worker threads
+        LANE_SCHEDULING = (1U<<1),  // spread expensive fusion steps of the cores over frames
+    };
+    bool option_is_set(Option option) const {
+        return (uint32_t(_options.get()) & uint32_t(option)) != 0;
+    }
 
 // Possible values for _flowUse
 #define FLOW_USE_NONE    0
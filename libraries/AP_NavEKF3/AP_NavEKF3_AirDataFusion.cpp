@@ -19,6 +19,8 @@
 */
 void NavEKF3_core::FuseAirspeed()
 {
+    EK3_KERNEL_TIMER(FuseAirspeed);
+
     // declarations
     ftype vn;
     ftype ve;
@@ -156,56 +158,25 @@ void NavEKF3_core::FuseAirspeed()
             stateStruct.quat.normalize();
 
             // correct the covariance P = (I - K*H)*P
-            // take advantage of the empty columns in KH to reduce the
-            // number of operations
-            for (unsigned i = 0; i<=stateIndexLim; i++) {
-                for (unsigned j = 0; j<=3; j++) {
-                    KH[i][j] = 0.0f;
-                }
-                for (unsigned j = 4; j<=6; j++) {
-                    KH[i][j] = Kfusion[i] * H_TAS[j];
-                }
-                for (unsigned j = 7; j<=21; j++) {
-                    KH[i][j] = 0.0f;
-                }
-                for (unsigned j = 22; j<=23; j++) {
-                    KH[i][j] = Kfusion[i] * H_TAS[j];
-                }
-            }
-            for (unsigned j = 0; j<=stateIndexLim; j++) {
-                for (unsigned i = 0; i<=stateIndexLim; i++) {
-                    ftype res = 0;
-                    res += KH[i][4] * P[4][j];
-                    res += KH[i][5] * P[5][j];
-                    res += KH[i][6] * P[6][j];
-                    res += KH[i][22] * P[22][j];
-                    res += KH[i][23] * P[23][j];
-                    KHP[i][j] = res;
-                }
-            }
-            for (unsigned i = 0; i<=stateIndexLim; i++) {
-                for (unsigned j = 0; j<=stateIndexLim; j++) {
-                    P[i][j] = P[i][j] - KHP[i][j];
-                }
-            }
+            static const uint8_t H_TAS_idx[] {4, 5, 6, 22, 23};
+            fuseCovariance(P, stateIndexLim, &H_TAS[0], H_TAS_idx, ARRAY_SIZE(H_TAS_idx), false);
         }
         // force the covariance matrix to be symmetrical and limit the variances to prevent ill-conditioning.
-        ForceSymmetry();
-        ConstrainVariances();
+        // only the rows and columns of states with a non-zero gain have changed
+        const uint32_t updatedStates = KfusionStates();
+        ForceSymmetry(updatedStates);
+        ConstrainVariances(updatedStates);
     }
 }
 
 // select fusion of true airspeed measurements
 void NavEKF3_core::SelectTasFusion()
 {
-    // Check if the magnetometer has been fused on that time step and the filter is running at faster than 200 Hz
+    // Check if the magnetometer has been fused on that time step and the filter is running at faster than 200 Hz,
+    // or if the cores have used the fusion budget for this frame
     // If so, don't fuse measurements on this time step to reduce frame over-runs
-    // Only allow one time slip to prevent high rate magnetometer data locking out fusion of other measurements
-    if (magFusePerformed && dtIMUavg < 0.005f && !airSpdFusionDelayed) {
-        airSpdFusionDelayed = true;
+    if (delayFusion(airSpdFusionDelayed)) {
         return;
-    } else {
-        airSpdFusionDelayed = false;
     }
 
     // get true airspeed measurement
@@ -213,6 +184,7 @@ void NavEKF3_core::SelectTasFusion()
 
     // if the filter is initialised, wind states are not inhibited and we have data to fuse, then perform TAS fusion
     if (tasDataToFuse && statesInitialised && !inhibitWindStates) {
+        frontend->use_fusion_slot();
         FuseAirspeed();
         prevTasStep_ms = imuSampleTime_ms;
     }
@@ -442,44 +414,15 @@ void NavEKF3_core::FuseSideslip()
         stateStruct.quat.normalize();
 
         // correct the covariance P = (I - K*H)*P
-        // take advantage of the empty columns in KH to reduce the
-        // number of operations
-        for (unsigned i = 0; i<=stateIndexLim; i++) {
-            for (unsigned j = 0; j<=6; j++) {
-                KH[i][j] = Kfusion[i] * H_BETA[j];
-            }
-            for (unsigned j = 7; j<=21; j++) {
-                KH[i][j] = 0.0f;
-            }
-            for (unsigned j = 22; j<=23; j++) {
-                KH[i][j] = Kfusion[i] * H_BETA[j];
-            }
-        }
-        for (unsigned j = 0; j<=stateIndexLim; j++) {
-            for (unsigned i = 0; i<=stateIndexLim; i++) {
-                ftype res = 0;
-                res += KH[i][0] * P[0][j];
-                res += KH[i][1] * P[1][j];
-                res += KH[i][2] * P[2][j];
-                res += KH[i][3] * P[3][j];
-                res += KH[i][4] * P[4][j];
-                res += KH[i][5] * P[5][j];
-                res += KH[i][6] * P[6][j];
-                res += KH[i][22] * P[22][j];
-                res += KH[i][23] * P[23][j];
-                KHP[i][j] = res;
-            }
-        }
-        for (unsigned i = 0; i<=stateIndexLim; i++) {
-            for (unsigned j = 0; j<=stateIndexLim; j++) {
-                P[i][j] = P[i][j] - KHP[i][j];
-            }
-        }
+        static const uint8_t H_BETA_idx[] {0, 1, 2, 3, 4, 5, 6, 22, 23};
+        fuseCovariance(P, stateIndexLim, &H_BETA[0], H_BETA_idx, ARRAY_SIZE(H_BETA_idx), false);
     }
 
     // force the covariance matrix to be symmetrical and limit the variances to prevent ill-conditioning.
-    ForceSymmetry();
-    ConstrainVariances();
+    // only the rows and columns of states with a non-zero gain have changed
+    const uint32_t updatedStates = KfusionStates();
+    ForceSymmetry(updatedStates);
+    ConstrainVariances(updatedStates);
 }
 
 #if EK3_FEATURE_DRAG_FUSION
@@ -717,39 +660,8 @@ void NavEKF3_core::FuseDragForces()
         stateStruct.quat.normalize();
 
         // correct the covariance P = (I - K*H)*P
-        // take advantage of the empty columns in KH to reduce the
-        // number of operations
-        for (unsigned i = 0; i<=stateIndexLim; i++) {
-            for (unsigned j = 0; j<=6; j++) {
-                KH[i][j] = Kfusion[i] * Hfusion[j];
-            }
-            for (unsigned j = 7; j<=21; j++) {
-                KH[i][j] = 0.0f;
-            }
-            for (unsigned j = 22; j<=23; j++) {
-                KH[i][j] = Kfusion[i] * Hfusion[j];
-            }
-        }
-        for (unsigned j = 0; j<=stateIndexLim; j++) {
-            for (unsigned i = 0; i<=stateIndexLim; i++) {
-                ftype res = 0;
-                res += KH[i][0] * P[0][j];
-                res += KH[i][1] * P[1][j];
-                res += KH[i][2] * P[2][j];
-                res += KH[i][3] * P[3][j];
-                res += KH[i][4] * P[4][j];
-                res += KH[i][5] * P[5][j];
-                res += KH[i][6] * P[6][j];
-                res += KH[i][22] * P[22][j];
-                res += KH[i][23] * P[23][j];
-                KHP[i][j] = res;
-            }
-        }
-        for (unsigned i = 0; i<=stateIndexLim; i++) {
-            for (unsigned j = 0; j<=stateIndexLim; j++) {
-                P[i][j] = P[i][j] - KHP[i][j];
-            }
-        }
+        static const uint8_t Hfusion_idx[] {0, 1, 2, 3, 4, 5, 6, 22, 23};
+        fuseCovariance(P, stateIndexLim, &Hfusion[0], Hfusion_idx, ARRAY_SIZE(Hfusion_idx), false);
     }
 
     // record time of successful fusion
@@ -223,7 +223,12 @@ bool NavEKF3_core::getPosNE(Vector2f &posNE) const
     if (PV_AidingMode != AID_NONE) {
         // This is the normal mode of operation where we can use the EKF position states
         // correct for the IMU offset (EKF calculations are at the IMU)
-        posNE = (outputDataNew.position.xy() + posOffsetNED.xy() + public_origin.get_distance_NE_ftype(EKF_origin)).tofloat();
+#if EK3_FEATURE_DOUBLE_POSITION
+        const Vector2ep originOffsetNE = public_origin.get_distance_NE_double(EKF_origin);
+#else
+        const Vector2ep originOffsetNE = public_origin.get_distance_NE_ftype(EKF_origin);
+#endif
+        posNE = (outputDataNew.position.xy() + posOffsetNED.xy().toepostype() + originOffsetNE).tofloat();
         return true;
 
     } else {
@@ -265,11 +270,11 @@ bool NavEKF3_core::getPosD_local(float &posD) const
     // Also correct for changes to the origin height
     if ((frontend->_originHgtMode & (1<<2)) == 0) {
         // Any sensor height drift corrections relative to the WGS-84 reference are applied to the origin.
-        posD = outputDataNew.position.z + posOffsetNED.z;
+        posD = float(outputDataNew.position.z) + posOffsetNED.z;
     } else {
         // The origin height is static and corrections are applied to the local vertical position
         // so that height returned by getLLH() = height returned by getOriginLLH - posD
-        posD = outputDataNew.position.z + posOffsetNED.z + 0.01f * (float)EKF_origin.alt - (float)ekfGpsRefHgt;
+        posD = float(outputDataNew.position.z) + posOffsetNED.z + 0.01f * (float)EKF_origin.alt - (float)ekfGpsRefHgt;
     }
 
     // Return the current height solution status
@@ -295,7 +300,7 @@ bool NavEKF3_core::getPosD(float &posD) const
 // return the estimated height of body frame origin above ground level
 bool NavEKF3_core::getHAGL(float &HAGL) const
 {
-    HAGL = terrainState - outputDataNew.position.z - posOffsetNED.z;
+    HAGL = terrainState - ftype(outputDataNew.position.z) - posOffsetNED.z;
     // If we know the terrain offset and altitude, then we have a valid height above ground estimate
     return !hgtTimeout && gndOffsetValid && healthy();
 }
@@ -316,8 +321,8 @@ bool NavEKF3_core::getLLH(struct Location &loc) const
                 // The EKF is able to provide a position estimate
                 loc.lat = EKF_origin.lat;
                 loc.lng = EKF_origin.lng;
-                loc.offset(outputDataNew.position.x + posOffsetNED.x,
-                           outputDataNew.position.y + posOffsetNED.y);
+                loc.offset(ftype(outputDataNew.position.x) + posOffsetNED.x,
+                           ftype(outputDataNew.position.y) + posOffsetNED.y);
                 return true;
             } else {
                 // We have been be doing inertial dead reckoning for too long so use raw GPS if available
@@ -327,8 +332,8 @@ bool NavEKF3_core::getLLH(struct Location &loc) const
                     // Return the EKF estimate but mark it as invalid
                     loc.lat = EKF_origin.lat;
                     loc.lng = EKF_origin.lng;
-                    loc.offset(outputDataNew.position.x + posOffsetNED.x,
-                               outputDataNew.position.y + posOffsetNED.y);
+                    loc.offset(ftype(outputDataNew.position.x) + posOffsetNED.x,
+                               ftype(outputDataNew.position.y) + posOffsetNED.y);
                     return false;
                 }
             }
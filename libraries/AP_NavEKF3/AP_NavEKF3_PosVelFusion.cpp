@@ -163,13 +163,10 @@ void NavEKF3_core::ResetPositionNE(ftype posN, ftype posE)
 
     // Add the offset to the output observer states
     for (uint8_t i=0; i<imu_buffer_length; i++) {
-        storedOutput[i].position.x += posResetNE.x;
-        storedOutput[i].position.y += posResetNE.y;
+        storedOutput[i].position.xy() += posResetNE.toepostype();
     }
-    outputDataNew.position.x += posResetNE.x;
-    outputDataNew.position.y += posResetNE.y;
-    outputDataDelayed.position.x += posResetNE.x;
-    outputDataDelayed.position.y += posResetNE.y;
+    outputDataNew.position.xy() += posResetNE.toepostype();
+    outputDataDelayed.position.xy() += posResetNE.toepostype();
 
     // store the time of the reset
     lastPosReset_ms = imuSampleTime_ms;
@@ -191,11 +188,11 @@ void NavEKF3_core::ResetPositionD(ftype posD)
     posResetD = stateStruct.position.z - posDOrig;
 
     // Add the offset to the output observer states
-    outputDataNew.position.z += posResetD;
+    outputDataNew.position.z += epostype_t(posResetD);
     vertCompFiltState.pos = outputDataNew.position.z;
-    outputDataDelayed.position.z += posResetD;
+    outputDataDelayed.position.z += epostype_t(posResetD);
     for (uint8_t i=0; i<imu_buffer_length; i++) {
-        storedOutput[i].position.z += posResetD;
+        storedOutput[i].position.z += epostype_t(posResetD);
     }
 
     // store the time of the reset
@@ -420,14 +417,11 @@ void NavEKF3_core::CalculateVelInnovationsAndVariances(const Vector3F &velocity,
 // select fusion of velocity, position and height measurements
 void NavEKF3_core::SelectVelPosFusion()
 {
-    // Check if the magnetometer has been fused on that time step and the filter is running at faster than 200 Hz
+    // Check if the magnetometer has been fused on that time step and the filter is running at faster than 200 Hz,
+    // or if the cores have used the fusion budget for this frame
     // If so, don't fuse measurements on this time step to reduce frame over-runs
-    // Only allow one time slip to prevent high rate magnetometer data preventing fusion of other measurements
-    if (magFusePerformed && dtIMUavg < 0.005f && !posVelFusionDelayed) {
-        posVelFusionDelayed = true;
+    if (delayFusion(posVelFusionDelayed)) {
         return;
-    } else {
-        posVelFusionDelayed = false;
     }
 
 #if EK3_FEATURE_EXTERNAL_NAV
@@ -589,6 +583,9 @@ void NavEKF3_core::SelectVelPosFusion()
 
     // perform fusion
     if (fuseVelData || fusePosData || fuseHgtData) {
+        if (fuseVelData || fusePosData) {
+            frontend->use_fusion_slot();
+        }
         FuseVelPosNED();
         // clear the flags to prevent repeated fusion of the same data
         fuseVelData = false;
@@ -600,6 +597,8 @@ void NavEKF3_core::SelectVelPosFusion()
 // fuse selected position, velocity and height measurements
 void NavEKF3_core::FuseVelPosNED()
 {
+    EK3_KERNEL_TIMER(FuseVelPosNED);
+
     // health is set bad until test passed
     bool velCheckPassed = false; // boolean true if velocity measurements have passed innovation consistency checks
     bool posCheckPassed = false; // boolean true if position measurements have passed innovation consistency check
@@ -979,31 +978,15 @@ void NavEKF3_core::FuseVelPosNED()
                     zero_range(&Kfusion[0], 22, 23);
                 }
 
-                // update the covariance - take advantage of direct observation of a single state at index = stateIndex to reduce computations
-                // this is a numerically optimised implementation of standard equation P = (I - K*H)*P;
-                for (uint8_t i= 0; i<=stateIndexLim; i++) {
-                    for (uint8_t j= 0; j<=stateIndexLim; j++) {
-                        KHP[i][j] = Kfusion[i] * P[stateIndex][j];
-                    }
-                }
-                // Check that we are not going to drive any variances negative and skip the update if so
-                bool healthyFusion = true;
-                for (uint8_t i= 0; i<=stateIndexLim; i++) {
-                    if (KHP[i][i] > P[i][i]) {
-                        healthyFusion = false;
-                    }
-                }
+                // correct the covariance P = (I - K*H)*P for a direct observation of the state at stateIndex,
+                // skipping the update if it would drive any variances negative
+                const bool healthyFusion = fuseCovarianceDirect(P, stateIndexLim, stateIndex, true);
                 if (healthyFusion) {
-                    // update the covariance matrix
-                    for (uint8_t i= 0; i<=stateIndexLim; i++) {
-                        for (uint8_t j= 0; j<=stateIndexLim; j++) {
-                            P[i][j] = P[i][j] - KHP[i][j];
-                        }
-                    }
-
                     // force the covariance matrix to be symmetrical and limit the variances to prevent ill-conditioning.
-                    ForceSymmetry();
-                    ConstrainVariances();
+                    // only the rows and columns of states with a non-zero gain have changed
+                    const uint32_t updatedStates = KfusionStates();
+                    ForceSymmetry(updatedStates);
+                    ConstrainVariances(updatedStates);
 
                     // update states and renormalise the quaternions
                     for (uint8_t i = 0; i<=stateIndexLim; i++) {
@@ -1844,50 +1827,15 @@ void NavEKF3_core::FuseBodyVel()
                 bodyVelFusionActive = true;
                 GCS_SEND_TEXT(MAV_SEVERITY_INFO, "EKF3 IMU%u fusing odometry",(unsigned)imu_index);
             }
-            // correct the covariance P = (I - K*H)*P
-            // take advantage of the empty columns in KH to reduce the
-            // number of operations
-            for (unsigned i = 0; i<=stateIndexLim; i++) {
-                for (unsigned j = 0; j<=6; j++) {
-                    KH[i][j] = Kfusion[i] * H_VEL[j];
-                }
-                for (unsigned j = 7; j<=stateIndexLim; j++) {
-                    KH[i][j] = 0.0f;
-                }
-            }
-            for (unsigned j = 0; j<=stateIndexLim; j++) {
-                for (unsigned i = 0; i<=stateIndexLim; i++) {
-                    ftype res = 0;
-                    res += KH[i][0] * P[0][j];
-                    res += KH[i][1] * P[1][j];
-                    res += KH[i][2] * P[2][j];
-                    res += KH[i][3] * P[3][j];
-                    res += KH[i][4] * P[4][j];
-                    res += KH[i][5] * P[5][j];
-                    res += KH[i][6] * P[6][j];
-                    KHP[i][j] = res;
-                }
-            }
-
-            // Check that we are not going to drive any variances negative and skip the update if so
-            bool healthyFusion = true;
-            for (uint8_t i= 0; i<=stateIndexLim; i++) {
-                if (KHP[i][i] > P[i][i]) {
-                    healthyFusion = false;
-                }
-            }
-
+            // correct the covariance P = (I - K*H)*P, skipping the update if it would drive any variances negative
+            static const uint8_t H_VEL_idx[] {0, 1, 2, 3, 4, 5, 6};
+            const bool healthyFusion = fuseCovariance(P, stateIndexLim, &H_VEL[0], H_VEL_idx, ARRAY_SIZE(H_VEL_idx), true);
             if (healthyFusion) {
-                // update the covariance matrix
-                for (uint8_t i= 0; i<=stateIndexLim; i++) {
-                    for (uint8_t j= 0; j<=stateIndexLim; j++) {
-                        P[i][j] = P[i][j] - KHP[i][j];
-                    }
-                }
-
                 // force the covariance matrix to be symmetrical and limit the variances to prevent ill-conditioning.
-                ForceSymmetry();
-                ConstrainVariances();
+                // only the rows and columns of states with a non-zero gain have changed
+                const uint32_t updatedStates = KfusionStates();
+                ForceSymmetry(updatedStates);
+                ConstrainVariances(updatedStates);
 
                 // correct the state vector
                 for (uint8_t j= 0; j<=stateIndexLim; j++) {
@@ -10,11 +10,21 @@
 // select fusion of range beacon measurements
 void NavEKF3_core::SelectRngBcnFusion()
 {
+    // Check if the cores have used the fusion budget for this frame
+    // If so, don't fuse measurements on this time step to reduce frame over-runs
+    // Only allow one time slip to prevent the other cores locking out fusion of beacon data
+    if (!rngBcnFusionDelayed && !frontend->fusion_slot_available()) {
+        rngBcnFusionDelayed = true;
+        return;
+    }
+    rngBcnFusionDelayed = false;
+
     // read range data from the sensor and check for new data in the buffer
     readRngBcnData();
 
     // Determine if we need to fuse range beacon data on this time step
     if (rngBcnDataToFuse) {
+        frontend->use_fusion_slot();
         if (PV_AidingMode == AID_ABSOLUTE) {
             if ((frontend->sources.getPosXYSource() == AP_NavEKF_Source::SourceXY::BEACON) && rngBcnAlignmentCompleted) {
                 if (!bcnOriginEstInit) {
@@ -209,47 +219,15 @@ void NavEKF3_core::FuseRngBcn()
             // restart the counter
             lastRngBcnPassTime_ms = imuSampleTime_ms;
 
-            // correct the covariance P = (I - K*H)*P
-            // take advantage of the empty columns in KH to reduce the
-            // number of operations
-            for (unsigned i = 0; i<=stateIndexLim; i++) {
-                for (unsigned j = 0; j<=6; j++) {
-                    KH[i][j] = 0.0f;
-                }
-                for (unsigned j = 7; j<=9; j++) {
-                    KH[i][j] = Kfusion[i] * H_BCN[j];
-                }
-                for (unsigned j = 10; j<=23; j++) {
-                    KH[i][j] = 0.0f;
-                }
-            }
-            for (unsigned j = 0; j<=stateIndexLim; j++) {
-                for (unsigned i = 0; i<=stateIndexLim; i++) {
-                    ftype res = 0;
-                    res += KH[i][7] * P[7][j];
-                    res += KH[i][8] * P[8][j];
-                    res += KH[i][9] * P[9][j];
-                    KHP[i][j] = res;
-                }
-            }
-            // Check that we are not going to drive any variances negative and skip the update if so
-            bool healthyFusion = true;
-            for (uint8_t i= 0; i<=stateIndexLim; i++) {
-                if (KHP[i][i] > P[i][i]) {
-                    healthyFusion = false;
-                }
-            }
+            // correct the covariance P = (I - K*H)*P, skipping the update if it would drive any variances negative
+            static const uint8_t H_BCN_idx[] {7, 8, 9};
+            const bool healthyFusion = fuseCovariance(P, stateIndexLim, &H_BCN[0], H_BCN_idx, ARRAY_SIZE(H_BCN_idx), true);
             if (healthyFusion) {
-                // update the covariance matrix
-                for (uint8_t i= 0; i<=stateIndexLim; i++) {
-                    for (uint8_t j= 0; j<=stateIndexLim; j++) {
-                        P[i][j] = P[i][j] - KHP[i][j];
-                    }
-                }
-
                 // force the covariance matrix to be symmetrical and limit the variances to prevent ill-conditioning.
-                ForceSymmetry();
-                ConstrainVariances();
+                // only the rows and columns of states with a non-zero gain have changed
+                const uint32_t updatedStates = KfusionStates();
+                ForceSymmetry(updatedStates);
+                ConstrainVariances(updatedStates);
 
                 // correct the state vector
                 for (uint8_t j= 0; j<=stateIndexLim; j++) {
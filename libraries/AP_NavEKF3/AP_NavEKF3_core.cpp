@@ -31,9 +31,10 @@ bool NavEKF3_core::setup_core(uint8_t _imu_index, uint8_t _core_index)
      */
 
     // Calculate the expected EKF time step
+    dtEkfTarget = frontend->get_predict_dt();
     if (dal.ins().get_loop_rate_hz() > 0) {
         dtEkfAvg = 1.0f / dal.ins().get_loop_rate_hz();
-        dtEkfAvg = MAX(dtEkfAvg,EKF_TARGET_DT);
+        dtEkfAvg = MAX(dtEkfAvg,dtEkfTarget);
     } else {
         return false;
     }
@@ -235,7 +236,7 @@ void NavEKF3_core::InitialiseVariables()
     vertVelVarClipCounter = 0;
     finalInflightYawInit = false;
     dtIMUavg = ins.get_loop_delta_t();
-    dtEkfAvg = EKF_TARGET_DT;
+    dtEkfAvg = dtEkfTarget;
     dt = 0;
     velDotNEDfilt.zero();
     lastKnownPositionNE.zero();
@@ -287,6 +288,9 @@ void NavEKF3_core::InitialiseVariables()
     delAngCorrection.zero();
     velErrintegral.zero();
     posErrintegral.zero();
+#if EK3_FEATURE_DOUBLE_POSITION
+    posIntegrationError.zero();
+#endif
     gpsGoodToAlign = false;
     gpsIsInUse = false;
     motorsArmed = false;
@@ -352,6 +356,7 @@ void NavEKF3_core::InitialiseVariables()
     innovRngBcn = 0.0f;
     memset(&lastTimeRngBcn_ms, 0, sizeof(lastTimeRngBcn_ms));
     rngBcnDataToFuse = false;
+    rngBcnFusionDelayed = false;
     beaconVehiclePosNED.zero();
     beaconVehiclePosErr = 1.0f;
     rngBcnLast3DmeasTime_ms = 0;
@@ -647,6 +652,8 @@ void NavEKF3_core::CovarianceInit()
 // Update Filter States - this should be called whenever new IMU data is available
 void NavEKF3_core::UpdateFilter(bool predict)
 {
+    EK3_KERNEL_TIMER(UpdateFilter);
+
     // Set the flag to indicate to the filter that the front-end has given permission for a new state prediction cycle to be started
     startPredictEnabled = predict;
 
@@ -683,6 +690,9 @@ void NavEKF3_core::UpdateFilter(bool predict)
 
         // Update states using  magnetometer or external yaw sensor data
         SelectMagFusion();
+        if (magFusePerformed) {
+            frontend->use_fusion_slot();
+        }
 
         // Update states using GPS and altimeter data
         SelectVelPosFusion();
@@ -747,6 +757,25 @@ void NavEKF3_core::UpdateFilter(bool predict)
     }
 }
 
+/*
+  return true if a fusion step should be delayed to the next
+  prediction, either because the magnetometer has been fused on this
+  time step and the filter is running faster than 200 Hz, or because
+  the cores have used the lane fusion budget for this frame. Only one
+  time slip is allowed to prevent high rate magnetometer data or other
+  cores locking out fusion of the measurement
+ */
+bool NavEKF3_core::delayFusion(bool &delayed)
+{
+    if (!delayed &&
+        ((magFusePerformed && dtIMUavg < 0.005f) || !frontend->fusion_slot_available())) {
+        delayed = true;
+        return true;
+    }
+    delayed = false;
+    return false;
+}
+
 void NavEKF3_core::correctDeltaAngle(Vector3F &delAng, ftype delAngDT, uint8_t gyro_index)
 {
     delAng -= inactiveBias[gyro_index].gyro_bias * (delAngDT / dtEkfAvg);
@@ -811,7 +840,16 @@ void NavEKF3_core::UpdateStrapdownEquationsNED()
     stateStruct.velocity += delVelNav;
 
     // apply a trapezoidal integration to velocities to calculate position
+#if EK3_FEATURE_DOUBLE_POSITION
+    // far from the origin the increment is a large fraction of the position
+    // resolution, so carry the rounding error over to the next step
+    const Vector3F posDelta = (stateStruct.velocity + lastVelocity) * (imuDataDelayed.delVelDT*0.5f) - posIntegrationError;
+    const Vector3F posNew = stateStruct.position + posDelta;
+    posIntegrationError = (posNew - stateStruct.position) - posDelta;
+    stateStruct.position = posNew;
+#else
     stateStruct.position += (stateStruct.velocity + lastVelocity) * (imuDataDelayed.delVelDT*0.5f);
+#endif
 
     // accumulate the bias delta angle and time since last reset by an OF measurement arrival
     delAngBodyOF += delAngCorrected;
@@ -884,7 +922,7 @@ void NavEKF3_core::calcOutputStates()
     // Coefficients selected to place all three filter poles at omega
     const ftype CompFiltOmega = M_2PI * constrain_ftype(frontend->_hrt_filt_freq, 0.1f, 30.0f);
     ftype omega2 = CompFiltOmega * CompFiltOmega;
-    ftype pos_err = constrain_ftype(outputDataNew.position.z - vertCompFiltState.pos, -1e5, 1e5);
+    ftype pos_err = constrain_ftype(ftype(outputDataNew.position.z) - vertCompFiltState.pos, -1e5, 1e5);
     ftype integ1_input = pos_err * omega2 * CompFiltOmega * imuDataNew.delVelDT;
     vertCompFiltState.acc += integ1_input;
     ftype integ2_input = delVelNav.z + (vertCompFiltState.acc + pos_err * omega2 * 3.0f) * imuDataNew.delVelDT;
@@ -893,7 +931,7 @@ void NavEKF3_core::calcOutputStates()
     vertCompFiltState.pos += integ3_input; 
 
     // apply a trapezoidal integration to velocities to calculate position
-    outputDataNew.position += (outputDataNew.velocity + lastVelocity) * (imuDataNew.delVelDT*0.5f);
+    outputDataNew.position += ((outputDataNew.velocity + lastVelocity) * (imuDataNew.delVelDT*0.5f)).toepostype();
 
     // If the IMU accelerometer is offset from the body frame origin, then calculate corrections
     // that can be added to the EKF velocity and position outputs so that they represent the velocity
@@ -963,7 +1001,7 @@ void NavEKF3_core::calcOutputStates()
 
         // calculate velocity and position tracking errors
         Vector3F velErr = (stateStruct.velocity - outputDataDelayed.velocity);
-        Vector3F posErr = (stateStruct.position - outputDataDelayed.position);
+        Vector3F posErr = (stateStruct.position.toepostype() - outputDataDelayed.position).toftype();
 
         if (badIMUdata) {
             // When IMU accel is bad,  calculate an integral that will be used to drive the difference
@@ -1010,7 +1048,7 @@ void NavEKF3_core::calcOutputStates()
             outputStates.velocity += velCorrection;
 
             // a constant position correction is applied
-            outputStates.position += posCorrection;
+            outputStates.position += posCorrection.toepostype();
 
             // push the updated data to the buffer
             storedOutput[index] = outputStates;
@@ -1031,6 +1069,8 @@ void NavEKF3_core::calcOutputStates()
 */
 void NavEKF3_core::CovariancePrediction(Vector3F *rotVarVecPtr)
 {
+    EK3_KERNEL_TIMER(CovariancePrediction);
+
     ftype daxVar;       // X axis delta angle noise variance rad^2
     ftype dayVar;       // Y axis delta angle noise variance rad^2
     ftype dazVar;       // Z axis delta angle noise variance rad^2
@@ -1192,6 +1232,546 @@ void NavEKF3_core::CovariancePrediction(Vector3F *rotVarVecPtr)
     // calculate the predicted covariance due to inertial sensor error propagation
     // we calculate the lower diagonal and copy to take advantage of symmetry
 
+    if (!quatCovResetOnly && stateIndexLim <= 12) {
+        // The covariances of the inhibited bias states are held at zero by ConstrainVariances(),
+        // which allows kernels specialised for them to skip most of the general kernel. Make sure
+        // the matrix has that shape as the first prediction after initialisation runs before it
+        for (uint8_t i=stateIndexLim+1; i<=15; i++) {
+            for (uint8_t j=0; j<=23; j++) {
+                if (i != j || i <= 12) {
+                    P[i][j] = P[j][i] = 0;
+                }
+            }
+        }
+
+        if (stateIndexLim == 9) {
+            // auto-code from derivation/generated/covariance_10_states_generated.cpp
+            const ftype PS0 = sq(q1);
+            const ftype PS1 = 0.25F*daxVar;
+            const ftype PS2 = sq(q2);
+            const ftype PS3 = 0.25F*dayVar;
+            const ftype PS4 = sq(q3);
+            const ftype PS5 = 0.25F*dazVar;
+            const ftype PS11 = 0.5F*dax - 0.5F*dax_b;
+            const ftype PS12 = 0.5F*day - 0.5F*day_b;
+            const ftype PS13 = 0.5F*daz - 0.5F*daz_b;
+            const ftype PS21 = PS12*P[1][2];
+            const ftype PS22 = -PS13*P[1][3];
+            const ftype PS23 = -PS11*P[1][1] - PS21 + PS22 + P[0][1];
+            const ftype PS24 = -PS11*P[1][2];
+            const ftype PS25 = PS13*P[2][3];
+            const ftype PS26 = -PS12*P[2][2] + PS24 - PS25 + P[0][2];
+            const ftype PS27 = PS11*P[1][3];
+            const ftype PS28 = -PS12*P[2][3];
+            const ftype PS29 = -PS13*P[3][3] - PS27 + PS28 + P[0][3];
+            const ftype PS30 = PS11*P[0][1];
+            const ftype PS31 = PS12*P[0][2];
+            const ftype PS32 = PS13*P[0][3];
+            const ftype PS33 = -PS30 - PS31 - PS32 + P[0][0];
+            const ftype PS35 = q2*q3;
+            const ftype PS36 = q0*q1;
+            const ftype PS37 = q1*q3;
+            const ftype PS38 = q0*q2;
+            const ftype PS39 = q1*q2;
+            const ftype PS40 = q0*q3;
+            const ftype PS41 = 2*PS2;
+            const ftype PS42 = 2*PS4 - 1;
+            const ftype PS43 = PS41 + PS42;
+            const ftype PS45 = PS37 + PS38;
+            const ftype PS48 = dvy - dvy_b;
+            const ftype PS49 = PS48*q0;
+            const ftype PS50 = dvz - dvz_b;
+            const ftype PS51 = PS50*q1;
+            const ftype PS52 = dvx - dvx_b;
+            const ftype PS53 = PS52*q3;
+            const ftype PS54 = PS49 - PS51 + 2*PS53;
+            const ftype PS55 = 2*PS29;
+            const ftype PS56 = -PS39 + PS40;
+            const ftype PS59 = PS48*q2;
+            const ftype PS60 = PS50*q3;
+            const ftype PS61 = PS59 + PS60;
+            const ftype PS62 = 2*PS23;
+            const ftype PS63 = PS50*q2;
+            const ftype PS64 = PS48*q3;
+            const ftype PS65 = -PS64;
+            const ftype PS66 = PS63 + PS65;
+            const ftype PS67 = 2*PS33;
+            const ftype PS68 = PS50*q0;
+            const ftype PS69 = PS48*q1;
+            const ftype PS70 = PS52*q2;
+            const ftype PS71 = PS68 + PS69 - 2*PS70;
+            const ftype PS72 = 2*PS26;
+            const ftype PS73 = -PS11*P[1][4] - PS12*P[2][4] - PS13*P[3][4] + P[0][4];
+            const ftype PS74 = 2*PS0;
+            const ftype PS75 = PS42 + PS74;
+            const ftype PS76 = PS39 + PS40;
+            const ftype PS78 = PS51 - PS53;
+            const ftype PS79 = -PS70;
+            const ftype PS80 = PS68 + 2*PS69 + PS79;
+            const ftype PS81 = -PS35 + PS36;
+            const ftype PS82 = PS52*q1;
+            const ftype PS83 = PS60 + PS82;
+            const ftype PS84 = PS52*q0;
+            const ftype PS85 = PS63 - 2*PS64 + PS84;
+            const ftype PS86 = -PS11*P[1][5] - PS12*P[2][5] - PS13*P[3][5] + P[0][5];
+            const ftype PS87 = PS41 + PS74 - 1;
+            const ftype PS88 = PS35 + PS36;
+            const ftype PS89 = 2*PS63 + PS65 + PS84;
+            const ftype PS90 = -PS37 + PS38;
+            const ftype PS91 = PS59 + PS82;
+            const ftype PS92 = PS69 + PS79;
+            const ftype PS93 = PS49 - 2*PS51 + PS53;
+            const ftype PS94 = -PS11*P[1][6] - PS12*P[2][6] - PS13*P[3][6] + P[0][6];
+            const ftype PS95 = sq(q0);
+            const ftype PS98 = PS13*P[0][2];
+            const ftype PS99 = PS12*P[0][3];
+            const ftype PS100 = PS11*P[0][0] + PS98 - PS99 + P[0][1];
+            const ftype PS101 = PS11*P[0][2];
+            const ftype PS102 = PS101 + PS13*P[2][2] + PS28 + P[1][2];
+            const ftype PS108 = PS11*P[0][3];
+            const ftype PS109 = PS108 - PS12*P[3][3] + PS25 + P[1][3];
+            const ftype PS110 = PS13*P[1][2];
+            const ftype PS111 = PS12*P[1][3];
+            const ftype PS112 = PS110 - PS111 + PS30 + P[1][1];
+            const ftype PS116 = 2*PS109;
+            const ftype PS119 = 2*PS112;
+            const ftype PS120 = 2*PS100;
+            const ftype PS121 = 2*PS102;
+            const ftype PS122 = PS11*P[0][4] - PS12*P[3][4] + PS13*P[2][4] + P[1][4];
+            const ftype PS124 = PS11*P[0][5] - PS12*P[3][5] + PS13*P[2][5] + P[1][5];
+            const ftype PS125 = PS11*P[0][6] - PS12*P[3][6] + PS13*P[2][6] + P[1][6];
+            const ftype PS128 = PS11*P[3][3] + PS22 + PS99 + P[2][3];
+            const ftype PS129 = PS13*P[0][1];
+            const ftype PS130 = PS108 + PS12*P[0][0] - PS129 + P[0][2];
+            const ftype PS134 = PS12*P[0][1];
+            const ftype PS135 = -PS13*P[1][1] + PS134 + PS27 + P[1][2];
+            const ftype PS136 = PS11*P[2][3];
+            const ftype PS137 = -PS110 + PS136 + PS31 + P[2][2];
+            const ftype PS141 = 2*PS128;
+            const ftype PS144 = 2*PS135;
+            const ftype PS145 = 2*PS130;
+            const ftype PS146 = 2*PS137;
+            const ftype PS147 = PS11*P[3][4] + PS12*P[0][4] - PS13*P[1][4] + P[2][4];
+            const ftype PS149 = PS11*P[3][5] + PS12*P[0][5] - PS13*P[1][5] + P[2][5];
+            const ftype PS150 = PS11*P[3][6] + PS12*P[0][6] - PS13*P[1][6] + P[2][6];
+            const ftype PS152 = PS12*P[1][1] + PS129 + PS24 + P[1][3];
+            const ftype PS153 = -PS101 + PS13*P[0][0] + PS134 + P[0][3];
+            const ftype PS156 = -PS11*P[2][2] + PS21 + PS98 + P[2][3];
+            const ftype PS157 = PS111 - PS136 + PS32 + P[3][3];
+            const ftype PS161 = 2*PS157;
+            const ftype PS164 = 2*PS152;
+            const ftype PS165 = 2*PS153;
+            const ftype PS166 = 2*PS156;
+            const ftype PS167 = -PS11*P[2][4] + PS12*P[1][4] + PS13*P[0][4] + P[3][4];
+            const ftype PS169 = -PS11*P[2][5] + PS12*P[1][5] + PS13*P[0][5] + P[3][5];
+            const ftype PS170 = -PS11*P[2][6] + PS12*P[1][6] + PS13*P[0][6] + P[3][6];
+            const ftype PS171 = 2*PS45;
+            const ftype PS172 = 2*PS56;
+            const ftype PS173 = 2*PS61;
+            const ftype PS174 = 2*PS66;
+            const ftype PS175 = 2*PS71;
+            const ftype PS176 = 2*PS54;
+            const ftype PS177 = PS43*P[13][13];
+            const ftype PS178 = -PS171*P[15][15];
+            const ftype PS179 = PS173*P[1][3] + PS174*P[0][3] + PS175*P[2][3] - PS176*P[3][3] + P[3][4];
+            const ftype PS180 = PS172*P[14][14];
+            const ftype PS181 = PS173*P[1][1] + PS174*P[0][1] + PS175*P[1][2] - PS176*P[1][3] + P[1][4];
+            const ftype PS182 = PS173*P[0][1] + PS174*P[0][0] + PS175*P[0][2] - PS176*P[0][3] + P[0][4];
+            const ftype PS183 = PS173*P[1][2] + PS174*P[0][2] + PS175*P[2][2] - PS176*P[2][3] + P[2][4];
+            const ftype PS184 = 4*dvyVar;
+            const ftype PS185 = 4*dvzVar;
+            const ftype PS186 = PS173*P[1][4] + PS174*P[0][4] + PS175*P[2][4] - PS176*P[3][4] + P[4][4];
+            const ftype PS187 = 2*PS177;
+            const ftype PS188 = 2*PS182;
+            const ftype PS189 = 2*PS181;
+            const ftype PS190 = 2*PS81;
+            const ftype PS191 = 2*PS183;
+            const ftype PS192 = 2*PS179;
+            const ftype PS193 = 2*PS76;
+            const ftype PS194 = PS43*dvxVar;
+            const ftype PS195 = PS75*dvyVar;
+            const ftype PS196 = PS173*P[1][5] + PS174*P[0][5] + PS175*P[2][5] - PS176*P[3][5] + P[4][5];
+            const ftype PS197 = 2*PS88;
+            const ftype PS198 = PS87*dvzVar;
+            const ftype PS199 = 2*PS90;
+            const ftype PS200 = PS173*P[1][6] + PS174*P[0][6] + PS175*P[2][6] - PS176*P[3][6] + P[4][6];
+            const ftype PS201 = 2*PS83;
+            const ftype PS202 = 2*PS78;
+            const ftype PS203 = 2*PS85;
+            const ftype PS204 = 2*PS80;
+            const ftype PS205 = PS75*P[14][14];
+            const ftype PS206 = -PS193*P[13][13];
+            const ftype PS207 = PS201*P[0][2] - PS202*P[0][0] + PS203*P[0][3] - PS204*P[0][1] + P[0][5];
+            const ftype PS208 = PS201*P[1][2] - PS202*P[0][1] + PS203*P[1][3] - PS204*P[1][1] + P[1][5];
+            const ftype PS209 = PS190*P[15][15];
+            const ftype PS210 = PS201*P[2][2] - PS202*P[0][2] + PS203*P[2][3] - PS204*P[1][2] + P[2][5];
+            const ftype PS211 = PS201*P[2][3] - PS202*P[0][3] + PS203*P[3][3] - PS204*P[1][3] + P[3][5];
+            const ftype PS212 = 4*dvxVar;
+            const ftype PS213 = PS201*P[2][5] - PS202*P[0][5] + PS203*P[3][5] - PS204*P[1][5] + P[5][5];
+            const ftype PS214 = 2*PS89;
+            const ftype PS215 = 2*PS91;
+            const ftype PS216 = 2*PS92;
+            const ftype PS217 = 2*PS93;
+            const ftype PS218 = PS201*P[2][6] - PS202*P[0][6] + PS203*P[3][6] - PS204*P[1][6] + P[5][6];
+            const ftype PS219 = PS87*P[15][15];
+            const ftype PS220 = -PS197*P[14][14];
+            const ftype PS221 = PS199*P[13][13];
+            const ftype PS222 = -PS214*P[2][6] + PS215*P[3][6] + PS216*P[0][6] + PS217*P[1][6] + P[6][6];
+
+            nextP[0][0] = PS0*PS1 - PS11*PS23 - PS12*PS26 - PS13*PS29 + PS2*PS3 + PS33 + PS4*PS5;
+            nextP[0][1] = -PS1*PS36 + PS11*PS33 - PS12*PS29 + PS13*PS26 + PS23 + PS3*PS35 - PS35*PS5;
+            nextP[1][1] = PS1*PS95 + PS100*PS11 + PS102*PS13 - PS109*PS12 + PS112 + PS2*PS5 + PS3*PS4;
+            nextP[0][2] = -PS1*PS37 + PS11*PS29 + PS12*PS33 - PS13*PS23 + PS26 - PS3*PS38 + PS37*PS5;
+            nextP[1][2] = PS1*PS40 + PS100*PS12 + PS102 + PS109*PS11 - PS112*PS13 - PS3*PS40 - PS39*PS5;
+            nextP[2][2] = PS0*PS5 + PS1*PS4 + PS11*PS128 + PS12*PS130 - PS13*PS135 + PS137 + PS3*PS95;
+            nextP[0][3] = PS1*PS39 - PS11*PS26 + PS12*PS23 + PS13*PS33 + PS29 - PS3*PS39 - PS40*PS5;
+            nextP[1][3] = -PS1*PS38 + PS100*PS13 - PS102*PS11 + PS109 + PS112*PS12 - PS3*PS37 + PS38*PS5;
+            nextP[2][3] = -PS1*PS35 - PS11*PS137 + PS12*PS135 + PS128 + PS13*PS130 + PS3*PS36 - PS36*PS5;
+            nextP[3][3] = PS0*PS3 + PS1*PS2 - PS11*PS156 + PS12*PS152 + PS13*PS153 + PS157 + PS5*PS95;
+            nextP[0][4] = -PS54*PS55 + PS61*PS62 + PS66*PS67 + PS71*PS72 + PS73;
+            nextP[1][4] = -PS116*PS54 + PS119*PS61 + PS120*PS66 + PS121*PS71 + PS122;
+            nextP[2][4] = -PS141*PS54 + PS144*PS61 + PS145*PS66 + PS146*PS71 + PS147;
+            nextP[3][4] = -PS161*PS54 + PS164*PS61 + PS165*PS66 + PS166*PS71 + PS167;
+            nextP[4][4] = -PS171*PS178 + PS172*PS180 + PS173*PS181 + PS174*PS182 + PS175*PS183 - PS176*PS179 + PS177*PS43 + PS184*sq(PS56) + PS185*sq(PS45) + PS186 + sq(PS43)*dvxVar;
+            nextP[0][5] = PS55*PS85 - PS62*PS80 - PS67*PS78 + PS72*PS83 + PS86;
+            nextP[1][5] = PS116*PS85 - PS119*PS80 - PS120*PS78 + PS121*PS83 + PS124;
+            nextP[2][5] = PS141*PS85 - PS144*PS80 - PS145*PS78 + PS146*PS83 + PS149;
+            nextP[3][5] = PS161*PS85 - PS164*PS80 - PS165*PS78 + PS166*PS83 + PS169;
+            nextP[4][5] = PS172*PS195 + PS178*PS190 + PS180*PS75 - PS185*PS45*PS81 - PS187*PS76 - PS188*PS78 - PS189*PS80 + PS191*PS83 + PS192*PS85 - PS193*PS194 + PS196;
+            nextP[5][5] = PS185*sq(PS81) + PS190*PS209 - PS193*PS206 + PS201*PS210 - PS202*PS207 + PS203*PS211 - PS204*PS208 + PS205*PS75 + PS212*sq(PS76) + PS213 + sq(PS75)*dvyVar;
+            nextP[0][6] = PS55*PS91 + PS62*PS93 + PS67*PS92 - PS72*PS89 + PS94;
+            nextP[1][6] = PS116*PS91 + PS119*PS93 + PS120*PS92 - PS121*PS89 + PS125;
+            nextP[2][6] = PS141*PS91 + PS144*PS93 + PS145*PS92 - PS146*PS89 + PS150;
+            nextP[3][6] = PS161*PS91 + PS164*PS93 + PS165*PS92 - PS166*PS89 + PS170;
+            nextP[4][6] = -PS171*PS198 + PS178*PS87 - PS180*PS197 - PS184*PS56*PS88 + PS187*PS90 + PS188*PS92 + PS189*PS93 - PS191*PS89 + PS192*PS91 + PS194*PS199 + PS200;
+            nextP[5][6] = PS190*PS198 - PS195*PS197 - PS197*PS205 + PS199*PS206 + PS207*PS216 + PS208*PS217 + PS209*PS87 - PS210*PS214 + PS211*PS215 - PS212*PS76*PS90 + PS218;
+            nextP[6][6] = PS184*sq(PS88) - PS197*PS220 + PS199*PS221 + PS212*sq(PS90) - PS214*(-PS214*P[2][2] + PS215*P[2][3] + PS216*P[0][2] + PS217*P[1][2] + P[2][6]) + PS215*(-PS214*P[2][3] + PS215*P[3][3] + PS216*P[0][3] + PS217*P[1][3] + P[3][6]) + PS216*(-PS214*P[0][2] + PS215*P[0][3] + PS216*P[0][0] + PS217*P[0][1] + P[0][6]) + PS217*(-PS214*P[1][2] + PS215*P[1][3] + PS216*P[0][1] + PS217*P[1][1] + P[1][6]) + PS219*PS87 + PS222 + sq(PS87)*dvzVar;
+            nextP[0][7] = -PS11*P[1][7] - PS12*P[2][7] - PS13*P[3][7] + PS73*dt + P[0][7];
+            nextP[1][7] = PS11*P[0][7] - PS12*P[3][7] + PS122*dt + PS13*P[2][7] + P[1][7];
+            nextP[2][7] = PS11*P[3][7] + PS12*P[0][7] - PS13*P[1][7] + PS147*dt + P[2][7];
+            nextP[3][7] = -PS11*P[2][7] + PS12*P[1][7] + PS13*P[0][7] + PS167*dt + P[3][7];
+            nextP[4][7] = PS173*P[1][7] + PS174*P[0][7] + PS175*P[2][7] - PS176*P[3][7] + PS186*dt + P[4][7];
+            nextP[5][7] = PS201*P[2][7] - PS202*P[0][7] + PS203*P[3][7] - PS204*P[1][7] + P[5][7] + dt*(PS201*P[2][4] - PS202*P[0][4] + PS203*P[3][4] - PS204*P[1][4] + P[4][5]);
+            nextP[6][7] = -PS214*P[2][7] + PS215*P[3][7] + PS216*P[0][7] + PS217*P[1][7] + P[6][7] + dt*(-PS214*P[2][4] + PS215*P[3][4] + PS216*P[0][4] + PS217*P[1][4] + P[4][6]);
+            nextP[7][7] = P[4][7]*dt + P[7][7] + dt*(P[4][4]*dt + P[4][7]);
+            nextP[0][8] = -PS11*P[1][8] - PS12*P[2][8] - PS13*P[3][8] + PS86*dt + P[0][8];
+            nextP[1][8] = PS11*P[0][8] - PS12*P[3][8] + PS124*dt + PS13*P[2][8] + P[1][8];
+            nextP[2][8] = PS11*P[3][8] + PS12*P[0][8] - PS13*P[1][8] + PS149*dt + P[2][8];
+            nextP[3][8] = -PS11*P[2][8] + PS12*P[1][8] + PS13*P[0][8] + PS169*dt + P[3][8];
+            nextP[4][8] = PS173*P[1][8] + PS174*P[0][8] + PS175*P[2][8] - PS176*P[3][8] + PS196*dt + P[4][8];
+            nextP[5][8] = PS201*P[2][8] - PS202*P[0][8] + PS203*P[3][8] - PS204*P[1][8] + PS213*dt + P[5][8];
+            nextP[6][8] = -PS214*P[2][8] + PS215*P[3][8] + PS216*P[0][8] + PS217*P[1][8] + P[6][8] + dt*(-PS214*P[2][5] + PS215*P[3][5] + PS216*P[0][5] + PS217*P[1][5] + P[5][6]);
+            nextP[7][8] = P[4][8]*dt + P[7][8] + dt*(P[4][5]*dt + P[5][7]);
+            nextP[8][8] = P[5][8]*dt + P[8][8] + dt*(P[5][5]*dt + P[5][8]);
+            nextP[0][9] = -PS11*P[1][9] - PS12*P[2][9] - PS13*P[3][9] + PS94*dt + P[0][9];
+            nextP[1][9] = PS11*P[0][9] - PS12*P[3][9] + PS125*dt + PS13*P[2][9] + P[1][9];
+            nextP[2][9] = PS11*P[3][9] + PS12*P[0][9] - PS13*P[1][9] + PS150*dt + P[2][9];
+            nextP[3][9] = -PS11*P[2][9] + PS12*P[1][9] + PS13*P[0][9] + PS170*dt + P[3][9];
+            nextP[4][9] = PS173*P[1][9] + PS174*P[0][9] + PS175*P[2][9] - PS176*P[3][9] + PS200*dt + P[4][9];
+            nextP[5][9] = PS201*P[2][9] - PS202*P[0][9] + PS203*P[3][9] - PS204*P[1][9] + PS218*dt + P[5][9];
+            nextP[6][9] = -PS214*P[2][9] + PS215*P[3][9] + PS216*P[0][9] + PS217*P[1][9] + PS222*dt + P[6][9];
+            nextP[7][9] = P[4][9]*dt + P[7][9] + dt*(P[4][6]*dt + P[6][7]);
+            nextP[8][9] = P[5][9]*dt + P[8][9] + dt*(P[5][6]*dt + P[6][8]);
+            nextP[9][9] = P[6][9]*dt + P[9][9] + dt*(P[6][6]*dt + P[6][9]);
+        } else {
+            // auto-code from derivation/generated/covariance_13_states_generated.cpp
+            const ftype PS0 = sq(q1);
+            const ftype PS1 = 0.25F*daxVar;
+            const ftype PS2 = sq(q2);
+            const ftype PS3 = 0.25F*dayVar;
+            const ftype PS4 = sq(q3);
+            const ftype PS5 = 0.25F*dazVar;
+            const ftype PS6 = 0.5F*q1;
+            const ftype PS7 = 0.5F*q2;
+            const ftype PS8 = PS7*P[10][11];
+            const ftype PS9 = 0.5F*q3;
+            const ftype PS10 = PS9*P[10][12];
+            const ftype PS11 = 0.5F*dax - 0.5F*dax_b;
+            const ftype PS12 = 0.5F*day - 0.5F*day_b;
+            const ftype PS13 = 0.5F*daz - 0.5F*daz_b;
+            const ftype PS14 = PS10 - PS11*P[1][10] - PS12*P[2][10] - PS13*P[3][10] + PS6*P[10][10] + PS8 + P[0][10];
+            const ftype PS15 = PS6*P[10][11];
+            const ftype PS16 = PS9*P[11][12];
+            const ftype PS17 = -PS11*P[1][11] - PS12*P[2][11] - PS13*P[3][11] + PS15 + PS16 + PS7*P[11][11] + P[0][11];
+            const ftype PS18 = PS6*P[10][12];
+            const ftype PS19 = PS7*P[11][12];
+            const ftype PS20 = -PS11*P[1][12] - PS12*P[2][12] - PS13*P[3][12] + PS18 + PS19 + PS9*P[12][12] + P[0][12];
+            const ftype PS21 = PS12*P[1][2];
+            const ftype PS22 = -PS13*P[1][3];
+            const ftype PS23 = -PS11*P[1][1] - PS21 + PS22 + PS6*P[1][10] + PS7*P[1][11] + PS9*P[1][12] + P[0][1];
+            const ftype PS24 = -PS11*P[1][2];
+            const ftype PS25 = PS13*P[2][3];
+            const ftype PS26 = -PS12*P[2][2] + PS24 - PS25 + PS6*P[2][10] + PS7*P[2][11] + PS9*P[2][12] + P[0][2];
+            const ftype PS27 = PS11*P[1][3];
+            const ftype PS28 = -PS12*P[2][3];
+            const ftype PS29 = -PS13*P[3][3] - PS27 + PS28 + PS6*P[3][10] + PS7*P[3][11] + PS9*P[3][12] + P[0][3];
+            const ftype PS30 = PS11*P[0][1];
+            const ftype PS31 = PS12*P[0][2];
+            const ftype PS32 = PS13*P[0][3];
+            const ftype PS33 = -PS30 - PS31 - PS32 + PS6*P[0][10] + PS7*P[0][11] + PS9*P[0][12] + P[0][0];
+            const ftype PS34 = 0.5F*q0;
+            const ftype PS35 = q2*q3;
+            const ftype PS36 = q0*q1;
+            const ftype PS37 = q1*q3;
+            const ftype PS38 = q0*q2;
+            const ftype PS39 = q1*q2;
+            const ftype PS40 = q0*q3;
+            const ftype PS41 = 2*PS2;
+            const ftype PS42 = 2*PS4 - 1;
+            const ftype PS43 = PS41 + PS42;
+            const ftype PS45 = PS37 + PS38;
+            const ftype PS48 = dvy - dvy_b;
+            const ftype PS49 = PS48*q0;
+            const ftype PS50 = dvz - dvz_b;
+            const ftype PS51 = PS50*q1;
+            const ftype PS52 = dvx - dvx_b;
+            const ftype PS53 = PS52*q3;
+            const ftype PS54 = PS49 - PS51 + 2*PS53;
+            const ftype PS55 = 2*PS29;
+            const ftype PS56 = -PS39 + PS40;
+            const ftype PS59 = PS48*q2;
+            const ftype PS60 = PS50*q3;
+            const ftype PS61 = PS59 + PS60;
+            const ftype PS62 = 2*PS23;
+            const ftype PS63 = PS50*q2;
+            const ftype PS64 = PS48*q3;
+            const ftype PS65 = -PS64;
+            const ftype PS66 = PS63 + PS65;
+            const ftype PS67 = 2*PS33;
+            const ftype PS68 = PS50*q0;
+            const ftype PS69 = PS48*q1;
+            const ftype PS70 = PS52*q2;
+            const ftype PS71 = PS68 + PS69 - 2*PS70;
+            const ftype PS72 = 2*PS26;
+            const ftype PS73 = -PS11*P[1][4] - PS12*P[2][4] - PS13*P[3][4] + PS6*P[4][10] + PS7*P[4][11] + PS9*P[4][12] + P[0][4];
+            const ftype PS74 = 2*PS0;
+            const ftype PS75 = PS42 + PS74;
+            const ftype PS76 = PS39 + PS40;
+            const ftype PS78 = PS51 - PS53;
+            const ftype PS79 = -PS70;
+            const ftype PS80 = PS68 + 2*PS69 + PS79;
+            const ftype PS81 = -PS35 + PS36;
+            const ftype PS82 = PS52*q1;
+            const ftype PS83 = PS60 + PS82;
+            const ftype PS84 = PS52*q0;
+            const ftype PS85 = PS63 - 2*PS64 + PS84;
+            const ftype PS86 = -PS11*P[1][5] - PS12*P[2][5] - PS13*P[3][5] + PS6*P[5][10] + PS7*P[5][11] + PS9*P[5][12] + P[0][5];
+            const ftype PS87 = PS41 + PS74 - 1;
+            const ftype PS88 = PS35 + PS36;
+            const ftype PS89 = 2*PS63 + PS65 + PS84;
+            const ftype PS90 = -PS37 + PS38;
+            const ftype PS91 = PS59 + PS82;
+            const ftype PS92 = PS69 + PS79;
+            const ftype PS93 = PS49 - 2*PS51 + PS53;
+            const ftype PS94 = -PS11*P[1][6] - PS12*P[2][6] - PS13*P[3][6] + PS6*P[6][10] + PS7*P[6][11] + PS9*P[6][12] + P[0][6];
+            const ftype PS95 = sq(q0);
+            const ftype PS96 = -PS34*P[10][11];
+            const ftype PS97 = PS11*P[0][11] - PS12*P[3][11] + PS13*P[2][11] - PS19 + PS9*P[11][11] + PS96 + P[1][11];
+            const ftype PS98 = PS13*P[0][2];
+            const ftype PS99 = PS12*P[0][3];
+            const ftype PS100 = PS11*P[0][0] - PS34*P[0][10] - PS7*P[0][12] + PS9*P[0][11] + PS98 - PS99 + P[0][1];
+            const ftype PS101 = PS11*P[0][2];
+            const ftype PS102 = PS101 + PS13*P[2][2] + PS28 - PS34*P[2][10] - PS7*P[2][12] + PS9*P[2][11] + P[1][2];
+            const ftype PS103 = PS9*P[10][11];
+            const ftype PS104 = PS7*P[10][12];
+            const ftype PS105 = PS103 - PS104 + PS11*P[0][10] - PS12*P[3][10] + PS13*P[2][10] - PS34*P[10][10] + P[1][10];
+            const ftype PS106 = -PS34*P[10][12];
+            const ftype PS107 = PS106 + PS11*P[0][12] - PS12*P[3][12] + PS13*P[2][12] + PS16 - PS7*P[12][12] + P[1][12];
+            const ftype PS108 = PS11*P[0][3];
+            const ftype PS109 = PS108 - PS12*P[3][3] + PS25 - PS34*P[3][10] - PS7*P[3][12] + PS9*P[3][11] + P[1][3];
+            const ftype PS110 = PS13*P[1][2];
+            const ftype PS111 = PS12*P[1][3];
+            const ftype PS112 = PS110 - PS111 + PS30 - PS34*P[1][10] - PS7*P[1][12] + PS9*P[1][11] + P[1][1];
+            const ftype PS116 = 2*PS109;
+            const ftype PS119 = 2*PS112;
+            const ftype PS120 = 2*PS100;
+            const ftype PS121 = 2*PS102;
+            const ftype PS122 = PS11*P[0][4] - PS12*P[3][4] + PS13*P[2][4] - PS34*P[4][10] - PS7*P[4][12] + PS9*P[4][11] + P[1][4];
+            const ftype PS124 = PS11*P[0][5] - PS12*P[3][5] + PS13*P[2][5] - PS34*P[5][10] - PS7*P[5][12] + PS9*P[5][11] + P[1][5];
+            const ftype PS125 = PS11*P[0][6] - PS12*P[3][6] + PS13*P[2][6] - PS34*P[6][10] - PS7*P[6][12] + PS9*P[6][11] + P[1][6];
+            const ftype PS126 = -PS34*P[11][12];
+            const ftype PS127 = -PS10 + PS11*P[3][12] + PS12*P[0][12] + PS126 - PS13*P[1][12] + PS6*P[12][12] + P[2][12];
+            const ftype PS128 = PS11*P[3][3] + PS22 - PS34*P[3][11] + PS6*P[3][12] - PS9*P[3][10] + PS99 + P[2][3];
+            const ftype PS129 = PS13*P[0][1];
+            const ftype PS130 = PS108 + PS12*P[0][0] - PS129 - PS34*P[0][11] + PS6*P[0][12] - PS9*P[0][10] + P[0][2];
+            const ftype PS131 = PS6*P[11][12];
+            const ftype PS132 = -PS103 + PS11*P[3][11] + PS12*P[0][11] - PS13*P[1][11] + PS131 - PS34*P[11][11] + P[2][11];
+            const ftype PS133 = PS11*P[3][10] + PS12*P[0][10] - PS13*P[1][10] + PS18 - PS9*P[10][10] + PS96 + P[2][10];
+            const ftype PS134 = PS12*P[0][1];
+            const ftype PS135 = -PS13*P[1][1] + PS134 + PS27 - PS34*P[1][11] + PS6*P[1][12] - PS9*P[1][10] + P[1][2];
+            const ftype PS136 = PS11*P[2][3];
+            const ftype PS137 = -PS110 + PS136 + PS31 - PS34*P[2][11] + PS6*P[2][12] - PS9*P[2][10] + P[2][2];
+            const ftype PS141 = 2*PS128;
+            const ftype PS144 = 2*PS135;
+            const ftype PS145 = 2*PS130;
+            const ftype PS146 = 2*PS137;
+            const ftype PS147 = PS11*P[3][4] + PS12*P[0][4] - PS13*P[1][4] - PS34*P[4][11] + PS6*P[4][12] - PS9*P[4][10] + P[2][4];
+            const ftype PS149 = PS11*P[3][5] + PS12*P[0][5] - PS13*P[1][5] - PS34*P[5][11] + PS6*P[5][12] - PS9*P[5][10] + P[2][5];
+            const ftype PS150 = PS11*P[3][6] + PS12*P[0][6] - PS13*P[1][6] - PS34*P[6][11] + PS6*P[6][12] - PS9*P[6][10] + P[2][6];
+            const ftype PS151 = PS106 - PS11*P[2][10] + PS12*P[1][10] + PS13*P[0][10] - PS15 + PS7*P[10][10] + P[3][10];
+            const ftype PS152 = PS12*P[1][1] + PS129 + PS24 - PS34*P[1][12] - PS6*P[1][11] + PS7*P[1][10] + P[1][3];
+            const ftype PS153 = -PS101 + PS13*P[0][0] + PS134 - PS34*P[0][12] - PS6*P[0][11] + PS7*P[0][10] + P[0][3];
+            const ftype PS154 = PS104 - PS11*P[2][12] + PS12*P[1][12] + PS13*P[0][12] - PS131 - PS34*P[12][12] + P[3][12];
+            const ftype PS155 = -PS11*P[2][11] + PS12*P[1][11] + PS126 + PS13*P[0][11] - PS6*P[11][11] + PS8 + P[3][11];
+            const ftype PS156 = -PS11*P[2][2] + PS21 - PS34*P[2][12] - PS6*P[2][11] + PS7*P[2][10] + PS98 + P[2][3];
+            const ftype PS157 = PS111 - PS136 + PS32 - PS34*P[3][12] - PS6*P[3][11] + PS7*P[3][10] + P[3][3];
+            const ftype PS161 = 2*PS157;
+            const ftype PS164 = 2*PS152;
+            const ftype PS165 = 2*PS153;
+            const ftype PS166 = 2*PS156;
+            const ftype PS167 = -PS11*P[2][4] + PS12*P[1][4] + PS13*P[0][4] - PS34*P[4][12] - PS6*P[4][11] + PS7*P[4][10] + P[3][4];
+            const ftype PS169 = -PS11*P[2][5] + PS12*P[1][5] + PS13*P[0][5] - PS34*P[5][12] - PS6*P[5][11] + PS7*P[5][10] + P[3][5];
+            const ftype PS170 = -PS11*P[2][6] + PS12*P[1][6] + PS13*P[0][6] - PS34*P[6][12] - PS6*P[6][11] + PS7*P[6][10] + P[3][6];
+            const ftype PS171 = 2*PS45;
+            const ftype PS172 = 2*PS56;
+            const ftype PS173 = 2*PS61;
+            const ftype PS174 = 2*PS66;
+            const ftype PS175 = 2*PS71;
+            const ftype PS176 = 2*PS54;
+            const ftype PS177 = PS43*P[13][13];
+            const ftype PS178 = -PS171*P[15][15];
+            const ftype PS179 = PS173*P[1][3] + PS174*P[0][3] + PS175*P[2][3] - PS176*P[3][3] + P[3][4];
+            const ftype PS180 = PS172*P[14][14];
+            const ftype PS181 = PS173*P[1][1] + PS174*P[0][1] + PS175*P[1][2] - PS176*P[1][3] + P[1][4];
+            const ftype PS182 = PS173*P[0][1] + PS174*P[0][0] + PS175*P[0][2] - PS176*P[0][3] + P[0][4];
+            const ftype PS183 = PS173*P[1][2] + PS174*P[0][2] + PS175*P[2][2] - PS176*P[2][3] + P[2][4];
+            const ftype PS184 = 4*dvyVar;
+            const ftype PS185 = 4*dvzVar;
+            const ftype PS186 = PS173*P[1][4] + PS174*P[0][4] + PS175*P[2][4] - PS176*P[3][4] + P[4][4];
+            const ftype PS187 = 2*PS177;
+            const ftype PS188 = 2*PS182;
+            const ftype PS189 = 2*PS181;
+            const ftype PS190 = 2*PS81;
+            const ftype PS191 = 2*PS183;
+            const ftype PS192 = 2*PS179;
+            const ftype PS193 = 2*PS76;
+            const ftype PS194 = PS43*dvxVar;
+            const ftype PS195 = PS75*dvyVar;
+            const ftype PS196 = PS173*P[1][5] + PS174*P[0][5] + PS175*P[2][5] - PS176*P[3][5] + P[4][5];
+            const ftype PS197 = 2*PS88;
+            const ftype PS198 = PS87*dvzVar;
+            const ftype PS199 = 2*PS90;
+            const ftype PS200 = PS173*P[1][6] + PS174*P[0][6] + PS175*P[2][6] - PS176*P[3][6] + P[4][6];
+            const ftype PS201 = 2*PS83;
+            const ftype PS202 = 2*PS78;
+            const ftype PS203 = 2*PS85;
+            const ftype PS204 = 2*PS80;
+            const ftype PS205 = PS75*P[14][14];
+            const ftype PS206 = -PS193*P[13][13];
+            const ftype PS207 = PS201*P[0][2] - PS202*P[0][0] + PS203*P[0][3] - PS204*P[0][1] + P[0][5];
+            const ftype PS208 = PS201*P[1][2] - PS202*P[0][1] + PS203*P[1][3] - PS204*P[1][1] + P[1][5];
+            const ftype PS209 = PS190*P[15][15];
+            const ftype PS210 = PS201*P[2][2] - PS202*P[0][2] + PS203*P[2][3] - PS204*P[1][2] + P[2][5];
+            const ftype PS211 = PS201*P[2][3] - PS202*P[0][3] + PS203*P[3][3] - PS204*P[1][3] + P[3][5];
+            const ftype PS212 = 4*dvxVar;
+            const ftype PS213 = PS201*P[2][5] - PS202*P[0][5] + PS203*P[3][5] - PS204*P[1][5] + P[5][5];
+            const ftype PS214 = 2*PS89;
+            const ftype PS215 = 2*PS91;
+            const ftype PS216 = 2*PS92;
+            const ftype PS217 = 2*PS93;
+            const ftype PS218 = PS201*P[2][6] - PS202*P[0][6] + PS203*P[3][6] - PS204*P[1][6] + P[5][6];
+            const ftype PS219 = PS87*P[15][15];
+            const ftype PS220 = -PS197*P[14][14];
+            const ftype PS221 = PS199*P[13][13];
+            const ftype PS222 = -PS214*P[2][6] + PS215*P[3][6] + PS216*P[0][6] + PS217*P[1][6] + P[6][6];
+
+            nextP[0][0] = PS0*PS1 - PS11*PS23 - PS12*PS26 - PS13*PS29 + PS14*PS6 + PS17*PS7 + PS2*PS3 + PS20*PS9 + PS33 + PS4*PS5;
+            nextP[0][1] = -PS1*PS36 + PS11*PS33 - PS12*PS29 + PS13*PS26 - PS14*PS34 + PS17*PS9 - PS20*PS7 + PS23 + PS3*PS35 - PS35*PS5;
+            nextP[1][1] = PS1*PS95 + PS100*PS11 + PS102*PS13 - PS105*PS34 - PS107*PS7 - PS109*PS12 + PS112 + PS2*PS5 + PS3*PS4 + PS9*PS97;
+            nextP[0][2] = -PS1*PS37 + PS11*PS29 + PS12*PS33 - PS13*PS23 - PS14*PS9 - PS17*PS34 + PS20*PS6 + PS26 - PS3*PS38 + PS37*PS5;
+            nextP[1][2] = PS1*PS40 + PS100*PS12 + PS102 - PS105*PS9 + PS107*PS6 + PS109*PS11 - PS112*PS13 - PS3*PS40 - PS34*PS97 - PS39*PS5;
+            nextP[2][2] = PS0*PS5 + PS1*PS4 + PS11*PS128 + PS12*PS130 + PS127*PS6 - PS13*PS135 - PS132*PS34 - PS133*PS9 + PS137 + PS3*PS95;
+            nextP[0][3] = PS1*PS39 - PS11*PS26 + PS12*PS23 + PS13*PS33 + PS14*PS7 - PS17*PS6 - PS20*PS34 + PS29 - PS3*PS39 - PS40*PS5;
+            nextP[1][3] = -PS1*PS38 + PS100*PS13 - PS102*PS11 + PS105*PS7 - PS107*PS34 + PS109 + PS112*PS12 - PS3*PS37 + PS38*PS5 - PS6*PS97;
+            nextP[2][3] = -PS1*PS35 - PS11*PS137 + PS12*PS135 - PS127*PS34 + PS128 + PS13*PS130 - PS132*PS6 + PS133*PS7 + PS3*PS36 - PS36*PS5;
+            nextP[3][3] = PS0*PS3 + PS1*PS2 - PS11*PS156 + PS12*PS152 + PS13*PS153 + PS151*PS7 - PS154*PS34 - PS155*PS6 + PS157 + PS5*PS95;
+            nextP[0][4] = -PS54*PS55 + PS61*PS62 + PS66*PS67 + PS71*PS72 + PS73;
+            nextP[1][4] = -PS116*PS54 + PS119*PS61 + PS120*PS66 + PS121*PS71 + PS122;
+            nextP[2][4] = -PS141*PS54 + PS144*PS61 + PS145*PS66 + PS146*PS71 + PS147;
+            nextP[3][4] = -PS161*PS54 + PS164*PS61 + PS165*PS66 + PS166*PS71 + PS167;
+            nextP[4][4] = -PS171*PS178 + PS172*PS180 + PS173*PS181 + PS174*PS182 + PS175*PS183 - PS176*PS179 + PS177*PS43 + PS184*sq(PS56) + PS185*sq(PS45) + PS186 + sq(PS43)*dvxVar;
+            nextP[0][5] = PS55*PS85 - PS62*PS80 - PS67*PS78 + PS72*PS83 + PS86;
+            nextP[1][5] = PS116*PS85 - PS119*PS80 - PS120*PS78 + PS121*PS83 + PS124;
+            nextP[2][5] = PS141*PS85 - PS144*PS80 - PS145*PS78 + PS146*PS83 + PS149;
+            nextP[3][5] = PS161*PS85 - PS164*PS80 - PS165*PS78 + PS166*PS83 + PS169;
+            nextP[4][5] = PS172*PS195 + PS178*PS190 + PS180*PS75 - PS185*PS45*PS81 - PS187*PS76 - PS188*PS78 - PS189*PS80 + PS191*PS83 + PS192*PS85 - PS193*PS194 + PS196;
+            nextP[5][5] = PS185*sq(PS81) + PS190*PS209 - PS193*PS206 + PS201*PS210 - PS202*PS207 + PS203*PS211 - PS204*PS208 + PS205*PS75 + PS212*sq(PS76) + PS213 + sq(PS75)*dvyVar;
+            nextP[0][6] = PS55*PS91 + PS62*PS93 + PS67*PS92 - PS72*PS89 + PS94;
+            nextP[1][6] = PS116*PS91 + PS119*PS93 + PS120*PS92 - PS121*PS89 + PS125;
+            nextP[2][6] = PS141*PS91 + PS144*PS93 + PS145*PS92 - PS146*PS89 + PS150;
+            nextP[3][6] = PS161*PS91 + PS164*PS93 + PS165*PS92 - PS166*PS89 + PS170;
+            nextP[4][6] = -PS171*PS198 + PS178*PS87 - PS180*PS197 - PS184*PS56*PS88 + PS187*PS90 + PS188*PS92 + PS189*PS93 - PS191*PS89 + PS192*PS91 + PS194*PS199 + PS200;
+            nextP[5][6] = PS190*PS198 - PS195*PS197 - PS197*PS205 + PS199*PS206 + PS207*PS216 + PS208*PS217 + PS209*PS87 - PS210*PS214 + PS211*PS215 - PS212*PS76*PS90 + PS218;
+            nextP[6][6] = PS184*sq(PS88) - PS197*PS220 + PS199*PS221 + PS212*sq(PS90) - PS214*(-PS214*P[2][2] + PS215*P[2][3] + PS216*P[0][2] + PS217*P[1][2] + P[2][6]) + PS215*(-PS214*P[2][3] + PS215*P[3][3] + PS216*P[0][3] + PS217*P[1][3] + P[3][6]) + PS216*(-PS214*P[0][2] + PS215*P[0][3] + PS216*P[0][0] + PS217*P[0][1] + P[0][6]) + PS217*(-PS214*P[1][2] + PS215*P[1][3] + PS216*P[0][1] + PS217*P[1][1] + P[1][6]) + PS219*PS87 + PS222 + sq(PS87)*dvzVar;
+            nextP[0][7] = -PS11*P[1][7] - PS12*P[2][7] - PS13*P[3][7] + PS6*P[7][10] + PS7*P[7][11] + PS73*dt + PS9*P[7][12] + P[0][7];
+            nextP[1][7] = PS11*P[0][7] - PS12*P[3][7] + PS122*dt + PS13*P[2][7] - PS34*P[7][10] - PS7*P[7][12] + PS9*P[7][11] + P[1][7];
+            nextP[2][7] = PS11*P[3][7] + PS12*P[0][7] - PS13*P[1][7] + PS147*dt - PS34*P[7][11] + PS6*P[7][12] - PS9*P[7][10] + P[2][7];
+            nextP[3][7] = -PS11*P[2][7] + PS12*P[1][7] + PS13*P[0][7] + PS167*dt - PS34*P[7][12] - PS6*P[7][11] + PS7*P[7][10] + P[3][7];
+            nextP[4][7] = PS173*P[1][7] + PS174*P[0][7] + PS175*P[2][7] - PS176*P[3][7] + PS186*dt + P[4][7];
+            nextP[5][7] = PS201*P[2][7] - PS202*P[0][7] + PS203*P[3][7] - PS204*P[1][7] + P[5][7] + dt*(PS201*P[2][4] - PS202*P[0][4] + PS203*P[3][4] - PS204*P[1][4] + P[4][5]);
+            nextP[6][7] = -PS214*P[2][7] + PS215*P[3][7] + PS216*P[0][7] + PS217*P[1][7] + P[6][7] + dt*(-PS214*P[2][4] + PS215*P[3][4] + PS216*P[0][4] + PS217*P[1][4] + P[4][6]);
+            nextP[7][7] = P[4][7]*dt + P[7][7] + dt*(P[4][4]*dt + P[4][7]);
+            nextP[0][8] = -PS11*P[1][8] - PS12*P[2][8] - PS13*P[3][8] + PS6*P[8][10] + PS7*P[8][11] + PS86*dt + PS9*P[8][12] + P[0][8];
+            nextP[1][8] = PS11*P[0][8] - PS12*P[3][8] + PS124*dt + PS13*P[2][8] - PS34*P[8][10] - PS7*P[8][12] + PS9*P[8][11] + P[1][8];
+            nextP[2][8] = PS11*P[3][8] + PS12*P[0][8] - PS13*P[1][8] + PS149*dt - PS34*P[8][11] + PS6*P[8][12] - PS9*P[8][10] + P[2][8];
+            nextP[3][8] = -PS11*P[2][8] + PS12*P[1][8] + PS13*P[0][8] + PS169*dt - PS34*P[8][12] - PS6*P[8][11] + PS7*P[8][10] + P[3][8];
+            nextP[4][8] = PS173*P[1][8] + PS174*P[0][8] + PS175*P[2][8] - PS176*P[3][8] + PS196*dt + P[4][8];
+            nextP[5][8] = PS201*P[2][8] - PS202*P[0][8] + PS203*P[3][8] - PS204*P[1][8] + PS213*dt + P[5][8];
+            nextP[6][8] = -PS214*P[2][8] + PS215*P[3][8] + PS216*P[0][8] + PS217*P[1][8] + P[6][8] + dt*(-PS214*P[2][5] + PS215*P[3][5] + PS216*P[0][5] + PS217*P[1][5] + P[5][6]);
+            nextP[7][8] = P[4][8]*dt + P[7][8] + dt*(P[4][5]*dt + P[5][7]);
+            nextP[8][8] = P[5][8]*dt + P[8][8] + dt*(P[5][5]*dt + P[5][8]);
+            nextP[0][9] = -PS11*P[1][9] - PS12*P[2][9] - PS13*P[3][9] + PS6*P[9][10] + PS7*P[9][11] + PS9*P[9][12] + PS94*dt + P[0][9];
+            nextP[1][9] = PS11*P[0][9] - PS12*P[3][9] + PS125*dt + PS13*P[2][9] - PS34*P[9][10] - PS7*P[9][12] + PS9*P[9][11] + P[1][9];
+            nextP[2][9] = PS11*P[3][9] + PS12*P[0][9] - PS13*P[1][9] + PS150*dt - PS34*P[9][11] + PS6*P[9][12] - PS9*P[9][10] + P[2][9];
+            nextP[3][9] = -PS11*P[2][9] + PS12*P[1][9] + PS13*P[0][9] + PS170*dt - PS34*P[9][12] - PS6*P[9][11] + PS7*P[9][10] + P[3][9];
+            nextP[4][9] = PS173*P[1][9] + PS174*P[0][9] + PS175*P[2][9] - PS176*P[3][9] + PS200*dt + P[4][9];
+            nextP[5][9] = PS201*P[2][9] - PS202*P[0][9] + PS203*P[3][9] - PS204*P[1][9] + PS218*dt + P[5][9];
+            nextP[6][9] = -PS214*P[2][9] + PS215*P[3][9] + PS216*P[0][9] + PS217*P[1][9] + PS222*dt + P[6][9];
+            nextP[7][9] = P[4][9]*dt + P[7][9] + dt*(P[4][6]*dt + P[6][7]);
+            nextP[8][9] = P[5][9]*dt + P[8][9] + dt*(P[5][6]*dt + P[6][8]);
+            nextP[9][9] = P[6][9]*dt + P[9][9] + dt*(P[6][6]*dt + P[6][9]);
+            nextP[0][10] = PS14;
+            nextP[1][10] = PS105;
+            nextP[2][10] = PS133;
+            nextP[3][10] = PS151;
+            nextP[4][10] = PS173*P[1][10] + PS174*P[0][10] + PS175*P[2][10] - PS176*P[3][10] + P[4][10];
+            nextP[5][10] = PS201*P[2][10] - PS202*P[0][10] + PS203*P[3][10] - PS204*P[1][10] + P[5][10];
+            nextP[6][10] = -PS214*P[2][10] + PS215*P[3][10] + PS216*P[0][10] + PS217*P[1][10] + P[6][10];
+            nextP[7][10] = P[4][10]*dt + P[7][10];
+            nextP[8][10] = P[5][10]*dt + P[8][10];
+            nextP[9][10] = P[6][10]*dt + P[9][10];
+            nextP[10][10] = P[10][10];
+            nextP[0][11] = PS17;
+            nextP[1][11] = PS97;
+            nextP[2][11] = PS132;
+            nextP[3][11] = PS155;
+            nextP[4][11] = PS173*P[1][11] + PS174*P[0][11] + PS175*P[2][11] - PS176*P[3][11] + P[4][11];
+            nextP[5][11] = PS201*P[2][11] - PS202*P[0][11] + PS203*P[3][11] - PS204*P[1][11] + P[5][11];
+            nextP[6][11] = -PS214*P[2][11] + PS215*P[3][11] + PS216*P[0][11] + PS217*P[1][11] + P[6][11];
+            nextP[7][11] = P[4][11]*dt + P[7][11];
+            nextP[8][11] = P[5][11]*dt + P[8][11];
+            nextP[9][11] = P[6][11]*dt + P[9][11];
+            nextP[10][11] = P[10][11];
+            nextP[11][11] = P[11][11];
+            nextP[0][12] = PS20;
+            nextP[1][12] = PS107;
+            nextP[2][12] = PS127;
+            nextP[3][12] = PS154;
+            nextP[4][12] = PS173*P[1][12] + PS174*P[0][12] + PS175*P[2][12] - PS176*P[3][12] + P[4][12];
+            nextP[5][12] = PS201*P[2][12] - PS202*P[0][12] + PS203*P[3][12] - PS204*P[1][12] + P[5][12];
+            nextP[6][12] = -PS214*P[2][12] + PS215*P[3][12] + PS216*P[0][12] + PS217*P[1][12] + P[6][12];
+            nextP[7][12] = P[4][12]*dt + P[7][12];
+            nextP[8][12] = P[5][12]*dt + P[8][12];
+            nextP[9][12] = P[6][12]*dt + P[9][12];
+            nextP[10][12] = P[10][12];
+            nextP[11][12] = P[11][12];
+            nextP[12][12] = P[12][12];
+        }
+
+        CovariancePredictionFinish(processNoiseVariance);
+        return;
+    }
+
     // intermediate calculations
     const ftype PS0 = sq(q1);
     const ftype PS1 = 0.25F*daxVar;
@@ -1746,6 +2326,12 @@ void NavEKF3_core::CovariancePrediction(Vector3F *rotVarVecPtr)
         }
     }
 
+    CovariancePredictionFinish(processNoiseVariance);
+}
+
+// add process noise to the predicted covariance in nextP and copy it to P
+void NavEKF3_core::CovariancePredictionFinish(const Vector14 &processNoiseVariance)
+{
     // add the general state process noise variances
     if (stateIndexLim > 9) {
         for (uint8_t i=10; i<=stateIndexLim; i++) {
@@ -1830,7 +2416,7 @@ void NavEKF3_core::StoreOutputReset()
 {
     outputDataNew.quat = stateStruct.quat;
     outputDataNew.velocity = stateStruct.velocity;
-    outputDataNew.position = stateStruct.position;
+    outputDataNew.position = stateStruct.position.toepostype();
     // write current measurement to entire table
     for (uint8_t i=0; i<imu_buffer_length; i++) {
         storedOutput[i] = outputDataNew;
@@ -1864,12 +2450,17 @@ void NavEKF3_core::StoreQuatRotate(const QuaternionF &deltaQuat)
 }
 
 // force symmetry on the covariance matrix to prevent ill-conditioning
-void NavEKF3_core::ForceSymmetry()
+void NavEKF3_core::ForceSymmetry(uint32_t states)
 {
     for (uint8_t i=1; i<=stateIndexLim; i++)
     {
+        const bool rowUpdated = (states & (1U<<i)) != 0;
         for (uint8_t j=0; j<=i-1; j++)
         {
+            if (!rowUpdated && (states & (1U<<j)) == 0) {
+                // neither term has changed so they are still equal
+                continue;
+            }
             ftype temp = 0.5f*(P[i][j] + P[j][i]);
             P[i][j] = temp;
             P[j][i] = temp;
@@ -1877,15 +2468,40 @@ void NavEKF3_core::ForceSymmetry()
     }
 }
 
+// bitmask of the states with a non-zero gain in the last fusion step
+uint32_t NavEKF3_core::KfusionStates() const
+{
+    uint32_t states = 0;
+    for (uint8_t i=0; i<=stateIndexLim; i++) {
+        if (fabsF(Kfusion[i]) > 0) {
+            states |= 1U<<i;
+        }
+    }
+    return states;
+}
+
 // constrain variances (diagonal terms) in the state covariance matrix to  prevent ill-conditioning
 // if states are inactive, zero the corresponding off-diagonals
-void NavEKF3_core::ConstrainVariances()
+// after a fusion step only the blocks of states which have changed are
+// checked. Covariance prediction constrains all of them every time step
+void NavEKF3_core::ConstrainVariances(uint32_t states)
 {
-    for (uint8_t i=0; i<=3; i++) P[i][i] = constrain_ftype(P[i][i],0.0,1.0); // attitude error
-    for (uint8_t i=4; i<=5; i++) P[i][i] = constrain_ftype(P[i][i], VEL_STATE_MIN_VARIANCE, 1.0e3); // NE velocity
+    // true if any state from first to last has changed
+    const auto updated = [states](uint8_t first, uint8_t last) {
+        return (states & (((1U<<(last+1)) - 1) & ~((1U<<first) - 1))) != 0;
+    };
+
+    if (updated(0, 3)) {
+        for (uint8_t i=0; i<=3; i++) P[i][i] = constrain_ftype(P[i][i],0.0,1.0); // attitude error
+    }
+    if (updated(4, 5)) {
+        for (uint8_t i=4; i<=5; i++) P[i][i] = constrain_ftype(P[i][i], VEL_STATE_MIN_VARIANCE, 1.0e3); // NE velocity
+    }
 
     // if vibration affected use sensor observation variances to set a floor on the state variances
-    if (badIMUdata) {
+    if (!updated(6, 6) && !updated(9, 9)) {
+        // vertical velocity and height variances are unchanged
+    } else if (badIMUdata) {
         P[6][6] = fmaxF(P[6][6], sq(frontend->_gpsVertVelNoise));
         P[9][9] = fmaxF(P[9][9], sq(frontend->_baroAltNoise));
     } else if (P[6][6] < VEL_STATE_MIN_VARIANCE) {
@@ -1913,9 +2529,13 @@ void NavEKF3_core::ConstrainVariances()
         }
     }
 
-    for (uint8_t i=7; i<=9; i++) P[i][i] = constrain_ftype(P[i][i], POS_STATE_MIN_VARIANCE, 1.0e6); // NED position
+    if (updated(7, 9)) {
+        for (uint8_t i=7; i<=9; i++) P[i][i] = constrain_ftype(P[i][i], POS_STATE_MIN_VARIANCE, 1.0e6); // NED position
+    }
 
-    if (!inhibitDelAngBiasStates) {
+    if (!updated(10, 12)) {
+        // delta angle bias variances are unchanged
+    } else if (!inhibitDelAngBiasStates) {
         for (uint8_t i=10; i<=12; i++) P[i][i] = constrain_ftype(P[i][i],0.0f,sq(0.175 * dtEkfAvg));
     } else {
         zeroCols(P,10,12);
@@ -1923,7 +2543,9 @@ void NavEKF3_core::ConstrainVariances()
     }
 
     const ftype minStateVarTarget = 1E-11;
-    if (!inhibitDelVelBiasStates) {
+    if (!updated(13, 15)) {
+        // delta velocity bias variances are unchanged
+    } else if (!inhibitDelVelBiasStates) {
 
         // Find the maximum delta velocity bias state variance and request a covariance reset if any variance is below the safe minimum
         const ftype minSafeStateVar = minStateVarTarget * 0.1f;
@@ -1969,7 +2591,9 @@ void NavEKF3_core::ConstrainVariances()
         }
     }
 
-    if (!inhibitMagStates) {
+    if (!updated(16, 21)) {
+        // magnetic field variances are unchanged
+    } else if (!inhibitMagStates) {
         for (uint8_t i=16; i<=18; i++) P[i][i] = constrain_ftype(P[i][i],0.0f,0.01f); // earth magnetic field
         for (uint8_t i=19; i<=21; i++) P[i][i] = constrain_ftype(P[i][i],0.0f,0.01f); // body magnetic field
     } else {
@@ -1977,7 +2601,9 @@ void NavEKF3_core::ConstrainVariances()
         zeroRows(P,16,21);
     }
 
-    if (!inhibitWindStates) {
+    if (!updated(22, 23)) {
+        // wind variances are unchanged
+    } else if (!inhibitWindStates) {
         for (uint8_t i=22; i<=23; i++) P[i][i] = constrain_ftype(P[i][i],0.0f,WIND_VEL_VARIANCE_MAX);
     } else {
         zeroCols(P,22,23);
@@ -2246,10 +2872,10 @@ void NavEKF3_core::moveEKFOrigin(void)
 
     // now fix all output states
     stateStruct.position.xy() += diffNE;
-    outputDataNew.position.xy() += diffNE;
-    outputDataDelayed.position.xy() += diffNE;
+    outputDataNew.position.xy() += diffNE.toepostype();
+    outputDataDelayed.position.xy() += diffNE.toepostype();
 
     for (unsigned index=0; index < imu_buffer_length; index++) {
-        storedOutput[index].position.xy() += diffNE;
+        storedOutput[index].position.xy() += diffNE.toepostype();
     }
 }
@@ -36,6 +36,10 @@
 
 #include "AP_NavEKF/EKFGSF_yaw.h"
 
+#if EK3_FEATURE_KERNEL_TIMING
+#include <time.h>
+#endif
+
 // GPS pre-flight check bit locations
 #define MASK_GPS_NSATS      (1<<0)
 #define MASK_GPS_HDOP       (1<<1)
@@ -58,6 +62,9 @@
 #define EKF_TARGET_DT_MS 12
 #define EKF_TARGET_DT    0.012f
 
+// lowest EKF prediction rate that can be selected with EK3_PRED_RATE (Hz)
+#define EKF_PREDICT_RATE_MIN_HZ 25
+
 // mag fusion final reset altitude (using NED frame so altitude is negative)
 #define EKF3_MAG_FINAL_RESET_ALT 2.5f
 
@@ -95,6 +102,19 @@
 #define EK3_POSXY_STATE_LIMIT 1.0e6
 #endif
 
+// type of the output observer position, double precision with EK3_FEATURE_DOUBLE_POSITION
+#if EK3_FEATURE_DOUBLE_POSITION
+typedef double epostype_t;
+typedef Vector2d Vector2ep;
+typedef Vector3d Vector3ep;
+#define toepostype todouble
+#else
+typedef ftype epostype_t;
+typedef Vector2F Vector2ep;
+typedef Vector3F Vector3ep;
+#define toepostype toftype
+#endif
+
 // IMU acceleration process noise in m/s/s used when bad vibration affected IMU accel is detected
 #define BAD_IMU_DATA_ACC_P_NSE 5.0f
 
@@ -440,10 +460,59 @@ public:
     // get a yaw estimator instance
     const EKFGSF_yaw *get_yawEstimator(void) const { return yawEstimator; }
 
+#if EK3_FEATURE_KERNEL_TIMING
+    // filter steps whose execution time is accounted for benchmarking
+    enum class Kernel : uint8_t {
+        UpdateFilter = 0,
+        CovariancePrediction,
+        FuseVelPosNED,
+        SelectMagFusion,
+        FuseAirspeed,
+        NUM_KERNELS
+    };
+
+    // accumulated execution time of one kernel
+    struct KernelTiming {
+        uint64_t total_ns;
+        uint32_t count;
+    };
+
+    const KernelTiming &get_kernel_timing(Kernel k) const {
+        return kernel_timing[uint8_t(k)];
+    }
+    void reset_kernel_timing(void) {
+        memset(kernel_timing, 0, sizeof(kernel_timing));
+    }
+#endif
+
 private:
     EKFGSF_yaw *yawEstimator;
     AP_DAL &dal;
 
+#if EK3_FEATURE_KERNEL_TIMING
+    KernelTiming kernel_timing[uint8_t(Kernel::NUM_KERNELS)];
+
+    // adds the time from construction to destruction to a KernelTiming
+    class KernelTimer {
+    public:
+        KernelTimer(KernelTiming &_timing) : timing(_timing) {
+            clock_gettime(CLOCK_MONOTONIC, &start);
+        }
+        ~KernelTimer() {
+            struct timespec end;
+            clock_gettime(CLOCK_MONOTONIC, &end);
+            timing.total_ns += uint64_t(end.tv_sec - start.tv_sec) * 1000000000ULL + (end.tv_nsec - start.tv_nsec);
+            timing.count++;
+        }
+    private:
+        KernelTiming &timing;
+        struct timespec start;
+    };
+#define EK3_KERNEL_TIMER(k) KernelTimer kernel_timer_ ## k{kernel_timing[uint8_t(Kernel::k)]}
+#else
+#define EK3_KERNEL_TIMER(k)
+#endif
+
     // Reference to the global EKF frontend for parameters
     class NavEKF3 *frontend;
     uint8_t imu_index; // preferred IMU index
@@ -524,7 +593,7 @@ private:
     struct output_elements {
         QuaternionF quat;           // quaternion defining rotation from local NED earth frame to body frame
         Vector3F    velocity;       // velocity of body frame origin in local NED earth frame (m/sec)
-        Vector3F    position;       // position of body frame origin in local NED earth frame (m)
+        Vector3ep   position;       // position of body frame origin in local NED earth frame (m)
     };
 
     struct imu_elements {
@@ -664,11 +733,23 @@ private:
     // used to perform a reset of the quaternion state covariances only. Set to null for normal operation.
     void CovariancePrediction(Vector3F *rotVarVecPtr);
 
-    // force symmetry on the state covariance matrix
-    void ForceSymmetry();
+    // add the process noise to the predicted covariance matrix, copy it to the state
+    // covariance matrix and constrain it. Final step of CovariancePrediction()
+    void CovariancePredictionFinish(const Vector14 &processNoiseVariance);
+
+    // force symmetry on the state covariance matrix. states is a bitmask
+    // of the states whose rows and columns have changed since P was last
+    // symmetrical, only terms in those rows and columns are updated
+    void ForceSymmetry(uint32_t states = UINT32_MAX);
+
+    // constrain variances (diagonal terms) in the state covariance matrix.
+    // states is a bitmask of the states whose rows and columns have
+    // changed since the variances were last constrained
+    void ConstrainVariances(uint32_t states = UINT32_MAX);
 
-    // constrain variances (diagonal terms) in the state covariance matrix
-    void ConstrainVariances();
+    // bitmask of the states with a non-zero gain in Kfusion. A fusion
+    // step only changes the covariance rows and columns of these states
+    uint32_t KfusionStates() const;
 
     // constrain states
     void ConstrainStates();
@@ -760,6 +841,9 @@ private:
     void readRngBcnData();
 #endif
 
+    // return true if a fusion step should be delayed to the next prediction to spread the fusion load
+    bool delayFusion(bool &delayed);
+
     // determine when to perform fusion of GPS position and  velocity measurements
     void SelectVelPosFusion();
 
@@ -1025,6 +1109,7 @@ private:
     Vector3F earthRateNED;          // earths angular rate vector in NED (rad/s)
     ftype dtIMUavg;                 // expected time between IMU measurements (sec)
     ftype dtEkfAvg;                 // expected time between EKF updates (sec)
+    ftype dtEkfTarget;              // target time between EKF updates (sec)
     ftype dt;                       // time lapsed since the last covariance prediction (sec)
     ftype hgtRate;                  // state for rate of change of height filter
     bool onGround;                  // true when the flight vehicle is definitely on the ground
@@ -1121,6 +1206,9 @@ private:
     Vector3F delAngCorrection;      // correction applied to delta angles used by output observer to track the EKF
     Vector3F velErrintegral;        // integral of output predictor NED velocity tracking error (m)
     Vector3F posErrintegral;        // integral of output predictor NED position tracking error (m.sec)
+#if EK3_FEATURE_DOUBLE_POSITION
+    Vector3F posIntegrationError;   // rounding error of the position state integration to be compensated on the next step (m)
+#endif
     ftype badImuVelErrIntegral;     // integral of output predictor D velocity tracking error when bad IMU data is detected (m)
     ftype innovYaw;                 // compass yaw angle innovation (rad)
     uint32_t timeTasReceived_ms;    // time last TAS data was received (msec)
@@ -1297,6 +1385,7 @@ private:
     ftype innovRngBcn;                  // range beacon observation innovation (m)
     uint32_t lastTimeRngBcn_ms[4];      // last time we received a range beacon measurement (msec)
     bool rngBcnDataToFuse;              // true when there is new range beacon data to fuse
+    bool rngBcnFusionDelayed;           // true when the range beacon fusion has been delayed
     Vector3F beaconVehiclePosNED;       // NED position estimate from the beacon system (NED)
     ftype beaconVehiclePosErr;          // estimated position error from the beacon system (m)
     uint32_t rngBcnLast3DmeasTime_ms;   // last time the beacon system returned a 3D fix (msec)
@@ -30,3 +30,21 @@
 #ifndef EK3_FEATURE_BEACON_FUSION
 #define EK3_FEATURE_BEACON_FUSION AP_BEACON_ENABLED
 #endif
+
+// per-kernel execution time accounting, used by the Replay EKF3 benchmark
+#ifndef EK3_FEATURE_KERNEL_TIMING
+#define EK3_FEATURE_KERNEL_TIMING APM_BUILD_TYPE(APM_BUILD_Replay) && (CONFIG_HAL_BOARD == HAL_BOARD_SITL || CONFIG_HAL_BOARD == HAL_BOARD_LINUX)
+#endif
+
+// hybrid precision on boards without a double precision EKF. The output
+// observer position is held in double precision and the position states
+// are integrated with compensated summation, so small position increments
+// are not lost to rounding on long distance flights
+#ifndef EK3_FEATURE_DOUBLE_POSITION
+#define EK3_FEATURE_DOUBLE_POSITION 0
+#endif
+
+// running the cores on worker threads, on boards with spare CPU cores
+#ifndef EK3_FEATURE_CORE_THREADS
+#define EK3_FEATURE_CORE_THREADS CONFIG_HAL_BOARD == HAL_BOARD_LINUX && !APM_BUILD_TYPE(APM_BUILD_Replay)
+#endif
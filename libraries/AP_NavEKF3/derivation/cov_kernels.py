@@ -0,0 +1,268 @@
+#!/usr/bin/env python3
+'''
+Generate specialised EKF3 covariance prediction kernels from the general
+kernel written by main.py.
+
+With the delta angle and delta velocity bias states inhibited, the
+covariance rows and columns of those states are held at zero and only
+the states up to stateIndexLim are predicted. Terms known to be zero are
+removed from the general kernel and intermediate terms that are no longer
+used are dropped. Non-zero terms are written out unchanged and in the
+same order, so a specialised kernel gives the same result as the general
+one for a covariance matrix of that shape.
+
+Does not need sympy, so it can be run on the output of main.py or on the
+kernel as pasted into AP_NavEKF3_core.cpp:
+
+  ./cov_kernels.py generated/covariance_generated.cpp
+'''
+
+import re
+from argparse import ArgumentParser
+
+NUM_STATES = 24
+
+# specialised kernels, as the last state predicted and the states whose
+# covariances are zero. The delta velocity bias variances are kept at a
+# small non-zero value while inhibited, so only their covariances are zero
+KERNELS = [
+    # delta angle and delta velocity bias states inhibited
+    (9, [(10, 12, True), (13, 15, False)]),
+    # delta velocity bias states inhibited
+    (12, [(13, 15, False)]),
+]
+
+assign_re = re.compile(r'^\s*(?:const ftype )?(PS\d+|nextP\[\d+\]\[\d+\])\s*=\s*(.*);\s*$')
+token_re = re.compile(r'\s*(P\[\d+\]\[\d+\]|[A-Za-z_]\w*|\d+(?:\.\d*)?(?:[eE][-+]?\d+)?F?|[-+*/(),])')
+
+
+class Expr:
+    '''a parsed expression. Sums and products keep their terms in source order'''
+    def __init__(self, kind, args=None, name=None):
+        self.kind = kind    # 'sum', 'prod', 'neg', 'call', 'atom'
+        self.args = args or []
+        self.name = name
+
+
+def tokenize(text):
+    tokens = []
+    pos = 0
+    text = text.rstrip()
+    while pos < len(text):
+        m = token_re.match(text, pos)
+        if m is None:
+            raise ValueError("bad expression at '%s'" % text[pos:])
+        tokens.append(m.group(1))
+        pos = m.end()
+    return tokens
+
+
+class Parser:
+    def __init__(self, text):
+        self.tokens = tokenize(text)
+        self.pos = 0
+
+    def peek(self):
+        return self.tokens[self.pos] if self.pos < len(self.tokens) else None
+
+    def take(self, expected=None):
+        tok = self.peek()
+        if expected is not None and tok != expected:
+            raise ValueError("expected '%s' got '%s'" % (expected, tok))
+        self.pos += 1
+        return tok
+
+    def parse(self):
+        e = self.sum()
+        if self.peek() is not None:
+            raise ValueError("trailing '%s'" % self.peek())
+        return e
+
+    def sum(self):
+        terms = [self.product()]
+        while self.peek() in ('+', '-'):
+            op = self.take()
+            t = self.product()
+            terms.append(t if op == '+' else Expr('neg', [t]))
+        return terms[0] if len(terms) == 1 else Expr('sum', terms)
+
+    def product(self):
+        if self.peek() == '-':
+            self.take()
+            return Expr('neg', [self.product()])
+        factors = [self.unary()]
+        ops = []
+        while self.peek() in ('*', '/'):
+            ops.append(self.take())
+            factors.append(self.unary())
+        if len(factors) == 1:
+            return factors[0]
+        return Expr('prod', factors, ops)
+
+    def unary(self):
+        tok = self.take()
+        if tok == '(':
+            e = self.sum()
+            self.take(')')
+            return e
+        if self.peek() == '(' and re.match(r'[A-Za-z_]', tok):
+            self.take('(')
+            args = [self.sum()]
+            while self.peek() == ',':
+                self.take()
+                args.append(self.sum())
+            self.take(')')
+            return Expr('call', args, tok)
+        return Expr('atom', name=tok)
+
+
+def is_zero(e):
+    return e.kind == 'atom' and e.name == '0'
+
+
+ZERO = Expr('atom', name='0')
+
+
+def simplify(e, zero_names):
+    '''replace zero atoms and remove terms that are multiplied by zero'''
+    if e.kind == 'atom':
+        return ZERO if e.name in zero_names else e
+    args = [simplify(a, zero_names) for a in e.args]
+    if e.kind == 'sum':
+        args = [a for a in args if not is_zero(a)]
+        if len(args) == 0:
+            return ZERO
+        return args[0] if len(args) == 1 else Expr('sum', args)
+    if e.kind == 'prod':
+        # a zero divisor is never expected, only a zero numerator
+        for a, op in zip(args, [None] + e.name):
+            if is_zero(a) and op != '/':
+                return ZERO
+        return Expr('prod', args, e.name)
+    if e.kind == 'neg':
+        return ZERO if is_zero(args[0]) else Expr('neg', args)
+    if e.kind == 'call':
+        if e.name == 'sq' and is_zero(args[0]):
+            return ZERO
+        return Expr('call', args, e.name)
+    raise ValueError(e.kind)
+
+
+def to_ccode(e, in_product=False):
+    if e.kind == 'atom':
+        return e.name
+    if e.kind == 'call':
+        return e.name + '(' + ', '.join(to_ccode(a) for a in e.args) + ')'
+    if e.kind == 'neg':
+        return '-' + to_ccode(e.args[0], True)
+    if e.kind == 'prod':
+        s = to_ccode(e.args[0], True)
+        for a, op in zip(e.args[1:], e.name):
+            s += op + to_ccode(a, True)
+        return s
+    # sum
+    s = to_ccode(e.args[0])
+    for a in e.args[1:]:
+        if a.kind == 'neg':
+            s += ' - ' + to_ccode(a.args[0], True)
+        else:
+            s += ' + ' + to_ccode(a)
+    return '(' + s + ')' if in_product else s
+
+
+def names_used(e, out):
+    if e.kind == 'atom':
+        out.add(e.name)
+    for a in e.args:
+        names_used(a, out)
+    return out
+
+
+def load_kernel(filename):
+    '''return the list of (name, expression text) assignments in the kernel'''
+    assignments = []
+    for line in open(filename):
+        m = assign_re.match(line)
+        if m is not None:
+            assignments.append((m.group(1), m.group(2)))
+    return assignments
+
+
+def zero_entries(zero_blocks):
+    '''names of the covariance entries that are zero'''
+    zero = set()
+    for (first, last, with_diag) in zero_blocks:
+        for i in range(first, last+1):
+            for j in range(NUM_STATES):
+                if i == j and not with_diag:
+                    continue
+                zero.add('P[%u][%u]' % (i, j))
+                zero.add('P[%u][%u]' % (j, i))
+    return zero
+
+
+def specialise(assignments, last_state, zero_blocks):
+    zero = zero_entries(zero_blocks)
+    out = []
+    for (name, text) in assignments:
+        if name.startswith('nextP'):
+            (i, j) = [int(v) for v in re.findall(r'\d+', name)]
+            if i > last_state or j > last_state:
+                continue
+        e = Parser(text).parse()
+        s = simplify(e, zero)
+        if is_zero(s) and not name.startswith('nextP'):
+            zero.add(name)
+            continue
+        # keep the original text where nothing was removed
+        if names_used(e, set()).isdisjoint(zero):
+            out.append((name, text, e))
+        else:
+            out.append((name, to_ccode(s), s))
+
+    # drop the intermediate terms that are no longer used
+    used = set()
+    for (name, text, e) in reversed(out):
+        if name.startswith('nextP') or name in used:
+            names_used(e, used)
+    return [(name, text) for (name, text, e) in out if name.startswith('nextP') or name in used]
+
+
+def count_ops(assignments):
+    ops = 0
+    for (name, text) in assignments:
+        ops += len(re.findall(r'[-+*/]', text.replace('e-', 'e')))
+    return ops
+
+
+def write_kernel(filename, last_state, zero_blocks, assignments):
+    f = open(filename, 'w')
+    desc = ', '.join('%u to %u' % (first, last) for (first, last, with_diag) in zero_blocks)
+    f.write('// Equations for covariance matrix prediction of states 0 to %u, with zero covariances for states %s, without process noise!\n' % (last_state, desc))
+    for (name, text) in assignments:
+        if name.startswith('PS'):
+            f.write('const ftype %s = %s;\n' % (name, text))
+    f.write('\n\n')
+    for (name, text) in assignments:
+        if name.startswith('nextP'):
+            f.write('%s = %s;\n' % (name, text))
+    f.write('\n\n')
+    f.close()
+
+
+def write_specialised_kernels(kernel_file, outdir):
+    general = load_kernel(kernel_file)
+    print('General kernel: %u operations' % count_ops(general))
+    for (last_state, zero_blocks) in KERNELS:
+        kernel = specialise(general, last_state, zero_blocks)
+        filename = '%s/covariance_%u_states_generated.cpp' % (outdir, last_state+1)
+        write_kernel(filename, last_state, zero_blocks, kernel)
+        print('%u states: %u operations, written to %s' % (last_state+1, count_ops(kernel), filename))
+
+
+if __name__ == '__main__':
+    parser = ArgumentParser(description=__doc__)
+    parser.add_argument('kernel', help='file containing the general covariance prediction kernel')
+    parser.add_argument('--outdir', default='generated', help='directory for the specialised kernels')
+    args = parser.parse_args()
+    write_specialised_kernels(args.kernel, args.outdir)
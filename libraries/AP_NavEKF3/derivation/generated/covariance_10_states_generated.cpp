@@ -0,0 +1,231 @@
+// Equations for covariance matrix prediction of states 0 to 9, with zero covariances for states 10 to 12, 13 to 15, without process noise!
+const ftype PS0 = sq(q1);
+const ftype PS1 = 0.25F*daxVar;
+const ftype PS2 = sq(q2);
+const ftype PS3 = 0.25F*dayVar;
+const ftype PS4 = sq(q3);
+const ftype PS5 = 0.25F*dazVar;
+const ftype PS11 = 0.5F*dax - 0.5F*dax_b;
+const ftype PS12 = 0.5F*day - 0.5F*day_b;
+const ftype PS13 = 0.5F*daz - 0.5F*daz_b;
+const ftype PS21 = PS12*P[1][2];
+const ftype PS22 = -PS13*P[1][3];
+const ftype PS23 = -PS11*P[1][1] - PS21 + PS22 + P[0][1];
+const ftype PS24 = -PS11*P[1][2];
+const ftype PS25 = PS13*P[2][3];
+const ftype PS26 = -PS12*P[2][2] + PS24 - PS25 + P[0][2];
+const ftype PS27 = PS11*P[1][3];
+const ftype PS28 = -PS12*P[2][3];
+const ftype PS29 = -PS13*P[3][3] - PS27 + PS28 + P[0][3];
+const ftype PS30 = PS11*P[0][1];
+const ftype PS31 = PS12*P[0][2];
+const ftype PS32 = PS13*P[0][3];
+const ftype PS33 = -PS30 - PS31 - PS32 + P[0][0];
+const ftype PS35 = q2*q3;
+const ftype PS36 = q0*q1;
+const ftype PS37 = q1*q3;
+const ftype PS38 = q0*q2;
+const ftype PS39 = q1*q2;
+const ftype PS40 = q0*q3;
+const ftype PS41 = 2*PS2;
+const ftype PS42 = 2*PS4 - 1;
+const ftype PS43 = PS41 + PS42;
+const ftype PS45 = PS37 + PS38;
+const ftype PS48 = dvy - dvy_b;
+const ftype PS49 = PS48*q0;
+const ftype PS50 = dvz - dvz_b;
+const ftype PS51 = PS50*q1;
+const ftype PS52 = dvx - dvx_b;
+const ftype PS53 = PS52*q3;
+const ftype PS54 = PS49 - PS51 + 2*PS53;
+const ftype PS55 = 2*PS29;
+const ftype PS56 = -PS39 + PS40;
+const ftype PS59 = PS48*q2;
+const ftype PS60 = PS50*q3;
+const ftype PS61 = PS59 + PS60;
+const ftype PS62 = 2*PS23;
+const ftype PS63 = PS50*q2;
+const ftype PS64 = PS48*q3;
+const ftype PS65 = -PS64;
+const ftype PS66 = PS63 + PS65;
+const ftype PS67 = 2*PS33;
+const ftype PS68 = PS50*q0;
+const ftype PS69 = PS48*q1;
+const ftype PS70 = PS52*q2;
+const ftype PS71 = PS68 + PS69 - 2*PS70;
+const ftype PS72 = 2*PS26;
+const ftype PS73 = -PS11*P[1][4] - PS12*P[2][4] - PS13*P[3][4] + P[0][4];
+const ftype PS74 = 2*PS0;
+const ftype PS75 = PS42 + PS74;
+const ftype PS76 = PS39 + PS40;
+const ftype PS78 = PS51 - PS53;
+const ftype PS79 = -PS70;
+const ftype PS80 = PS68 + 2*PS69 + PS79;
+const ftype PS81 = -PS35 + PS36;
+const ftype PS82 = PS52*q1;
+const ftype PS83 = PS60 + PS82;
+const ftype PS84 = PS52*q0;
+const ftype PS85 = PS63 - 2*PS64 + PS84;
+const ftype PS86 = -PS11*P[1][5] - PS12*P[2][5] - PS13*P[3][5] + P[0][5];
+const ftype PS87 = PS41 + PS74 - 1;
+const ftype PS88 = PS35 + PS36;
+const ftype PS89 = 2*PS63 + PS65 + PS84;
+const ftype PS90 = -PS37 + PS38;
+const ftype PS91 = PS59 + PS82;
+const ftype PS92 = PS69 + PS79;
+const ftype PS93 = PS49 - 2*PS51 + PS53;
+const ftype PS94 = -PS11*P[1][6] - PS12*P[2][6] - PS13*P[3][6] + P[0][6];
+const ftype PS95 = sq(q0);
+const ftype PS98 = PS13*P[0][2];
+const ftype PS99 = PS12*P[0][3];
+const ftype PS100 = PS11*P[0][0] + PS98 - PS99 + P[0][1];
+const ftype PS101 = PS11*P[0][2];
+const ftype PS102 = PS101 + PS13*P[2][2] + PS28 + P[1][2];
+const ftype PS108 = PS11*P[0][3];
+const ftype PS109 = PS108 - PS12*P[3][3] + PS25 + P[1][3];
+const ftype PS110 = PS13*P[1][2];
+const ftype PS111 = PS12*P[1][3];
+const ftype PS112 = PS110 - PS111 + PS30 + P[1][1];
+const ftype PS116 = 2*PS109;
+const ftype PS119 = 2*PS112;
+const ftype PS120 = 2*PS100;
+const ftype PS121 = 2*PS102;
+const ftype PS122 = PS11*P[0][4] - PS12*P[3][4] + PS13*P[2][4] + P[1][4];
+const ftype PS124 = PS11*P[0][5] - PS12*P[3][5] + PS13*P[2][5] + P[1][5];
+const ftype PS125 = PS11*P[0][6] - PS12*P[3][6] + PS13*P[2][6] + P[1][6];
+const ftype PS128 = PS11*P[3][3] + PS22 + PS99 + P[2][3];
+const ftype PS129 = PS13*P[0][1];
+const ftype PS130 = PS108 + PS12*P[0][0] - PS129 + P[0][2];
+const ftype PS134 = PS12*P[0][1];
+const ftype PS135 = -PS13*P[1][1] + PS134 + PS27 + P[1][2];
+const ftype PS136 = PS11*P[2][3];
+const ftype PS137 = -PS110 + PS136 + PS31 + P[2][2];
+const ftype PS141 = 2*PS128;
+const ftype PS144 = 2*PS135;
+const ftype PS145 = 2*PS130;
+const ftype PS146 = 2*PS137;
+const ftype PS147 = PS11*P[3][4] + PS12*P[0][4] - PS13*P[1][4] + P[2][4];
+const ftype PS149 = PS11*P[3][5] + PS12*P[0][5] - PS13*P[1][5] + P[2][5];
+const ftype PS150 = PS11*P[3][6] + PS12*P[0][6] - PS13*P[1][6] + P[2][6];
+const ftype PS152 = PS12*P[1][1] + PS129 + PS24 + P[1][3];
+const ftype PS153 = -PS101 + PS13*P[0][0] + PS134 + P[0][3];
+const ftype PS156 = -PS11*P[2][2] + PS21 + PS98 + P[2][3];
+const ftype PS157 = PS111 - PS136 + PS32 + P[3][3];
+const ftype PS161 = 2*PS157;
+const ftype PS164 = 2*PS152;
+const ftype PS165 = 2*PS153;
+const ftype PS166 = 2*PS156;
+const ftype PS167 = -PS11*P[2][4] + PS12*P[1][4] + PS13*P[0][4] + P[3][4];
+const ftype PS169 = -PS11*P[2][5] + PS12*P[1][5] + PS13*P[0][5] + P[3][5];
+const ftype PS170 = -PS11*P[2][6] + PS12*P[1][6] + PS13*P[0][6] + P[3][6];
+const ftype PS171 = 2*PS45;
+const ftype PS172 = 2*PS56;
+const ftype PS173 = 2*PS61;
+const ftype PS174 = 2*PS66;
+const ftype PS175 = 2*PS71;
+const ftype PS176 = 2*PS54;
+const ftype PS177 = PS43*P[13][13];
+const ftype PS178 = -PS171*P[15][15];
+const ftype PS179 = PS173*P[1][3] + PS174*P[0][3] + PS175*P[2][3] - PS176*P[3][3] + P[3][4];
+const ftype PS180 = PS172*P[14][14];
+const ftype PS181 = PS173*P[1][1] + PS174*P[0][1] + PS175*P[1][2] - PS176*P[1][3] + P[1][4];
+const ftype PS182 = PS173*P[0][1] + PS174*P[0][0] + PS175*P[0][2] - PS176*P[0][3] + P[0][4];
+const ftype PS183 = PS173*P[1][2] + PS174*P[0][2] + PS175*P[2][2] - PS176*P[2][3] + P[2][4];
+const ftype PS184 = 4*dvyVar;
+const ftype PS185 = 4*dvzVar;
+const ftype PS186 = PS173*P[1][4] + PS174*P[0][4] + PS175*P[2][4] - PS176*P[3][4] + P[4][4];
+const ftype PS187 = 2*PS177;
+const ftype PS188 = 2*PS182;
+const ftype PS189 = 2*PS181;
+const ftype PS190 = 2*PS81;
+const ftype PS191 = 2*PS183;
+const ftype PS192 = 2*PS179;
+const ftype PS193 = 2*PS76;
+const ftype PS194 = PS43*dvxVar;
+const ftype PS195 = PS75*dvyVar;
+const ftype PS196 = PS173*P[1][5] + PS174*P[0][5] + PS175*P[2][5] - PS176*P[3][5] + P[4][5];
+const ftype PS197 = 2*PS88;
+const ftype PS198 = PS87*dvzVar;
+const ftype PS199 = 2*PS90;
+const ftype PS200 = PS173*P[1][6] + PS174*P[0][6] + PS175*P[2][6] - PS176*P[3][6] + P[4][6];
+const ftype PS201 = 2*PS83;
+const ftype PS202 = 2*PS78;
+const ftype PS203 = 2*PS85;
+const ftype PS204 = 2*PS80;
+const ftype PS205 = PS75*P[14][14];
+const ftype PS206 = -PS193*P[13][13];
+const ftype PS207 = PS201*P[0][2] - PS202*P[0][0] + PS203*P[0][3] - PS204*P[0][1] + P[0][5];
+const ftype PS208 = PS201*P[1][2] - PS202*P[0][1] + PS203*P[1][3] - PS204*P[1][1] + P[1][5];
+const ftype PS209 = PS190*P[15][15];
+const ftype PS210 = PS201*P[2][2] - PS202*P[0][2] + PS203*P[2][3] - PS204*P[1][2] + P[2][5];
+const ftype PS211 = PS201*P[2][3] - PS202*P[0][3] + PS203*P[3][3] - PS204*P[1][3] + P[3][5];
+const ftype PS212 = 4*dvxVar;
+const ftype PS213 = PS201*P[2][5] - PS202*P[0][5] + PS203*P[3][5] - PS204*P[1][5] + P[5][5];
+const ftype PS214 = 2*PS89;
+const ftype PS215 = 2*PS91;
+const ftype PS216 = 2*PS92;
+const ftype PS217 = 2*PS93;
+const ftype PS218 = PS201*P[2][6] - PS202*P[0][6] + PS203*P[3][6] - PS204*P[1][6] + P[5][6];
+const ftype PS219 = PS87*P[15][15];
+const ftype PS220 = -PS197*P[14][14];
+const ftype PS221 = PS199*P[13][13];
+const ftype PS222 = -PS214*P[2][6] + PS215*P[3][6] + PS216*P[0][6] + PS217*P[1][6] + P[6][6];
+
+
+nextP[0][0] = PS0*PS1 - PS11*PS23 - PS12*PS26 - PS13*PS29 + PS2*PS3 + PS33 + PS4*PS5;
+nextP[0][1] = -PS1*PS36 + PS11*PS33 - PS12*PS29 + PS13*PS26 + PS23 + PS3*PS35 - PS35*PS5;
+nextP[1][1] = PS1*PS95 + PS100*PS11 + PS102*PS13 - PS109*PS12 + PS112 + PS2*PS5 + PS3*PS4;
+nextP[0][2] = -PS1*PS37 + PS11*PS29 + PS12*PS33 - PS13*PS23 + PS26 - PS3*PS38 + PS37*PS5;
+nextP[1][2] = PS1*PS40 + PS100*PS12 + PS102 + PS109*PS11 - PS112*PS13 - PS3*PS40 - PS39*PS5;
+nextP[2][2] = PS0*PS5 + PS1*PS4 + PS11*PS128 + PS12*PS130 - PS13*PS135 + PS137 + PS3*PS95;
+nextP[0][3] = PS1*PS39 - PS11*PS26 + PS12*PS23 + PS13*PS33 + PS29 - PS3*PS39 - PS40*PS5;
+nextP[1][3] = -PS1*PS38 + PS100*PS13 - PS102*PS11 + PS109 + PS112*PS12 - PS3*PS37 + PS38*PS5;
+nextP[2][3] = -PS1*PS35 - PS11*PS137 + PS12*PS135 + PS128 + PS13*PS130 + PS3*PS36 - PS36*PS5;
+nextP[3][3] = PS0*PS3 + PS1*PS2 - PS11*PS156 + PS12*PS152 + PS13*PS153 + PS157 + PS5*PS95;
+nextP[0][4] = -PS54*PS55 + PS61*PS62 + PS66*PS67 + PS71*PS72 + PS73;
+nextP[1][4] = -PS116*PS54 + PS119*PS61 + PS120*PS66 + PS121*PS71 + PS122;
+nextP[2][4] = -PS141*PS54 + PS144*PS61 + PS145*PS66 + PS146*PS71 + PS147;
+nextP[3][4] = -PS161*PS54 + PS164*PS61 + PS165*PS66 + PS166*PS71 + PS167;
+nextP[4][4] = -PS171*PS178 + PS172*PS180 + PS173*PS181 + PS174*PS182 + PS175*PS183 - PS176*PS179 + PS177*PS43 + PS184*sq(PS56) + PS185*sq(PS45) + PS186 + sq(PS43)*dvxVar;
+nextP[0][5] = PS55*PS85 - PS62*PS80 - PS67*PS78 + PS72*PS83 + PS86;
+nextP[1][5] = PS116*PS85 - PS119*PS80 - PS120*PS78 + PS121*PS83 + PS124;
+nextP[2][5] = PS141*PS85 - PS144*PS80 - PS145*PS78 + PS146*PS83 + PS149;
+nextP[3][5] = PS161*PS85 - PS164*PS80 - PS165*PS78 + PS166*PS83 + PS169;
+nextP[4][5] = PS172*PS195 + PS178*PS190 + PS180*PS75 - PS185*PS45*PS81 - PS187*PS76 - PS188*PS78 - PS189*PS80 + PS191*PS83 + PS192*PS85 - PS193*PS194 + PS196;
+nextP[5][5] = PS185*sq(PS81) + PS190*PS209 - PS193*PS206 + PS201*PS210 - PS202*PS207 + PS203*PS211 - PS204*PS208 + PS205*PS75 + PS212*sq(PS76) + PS213 + sq(PS75)*dvyVar;
+nextP[0][6] = PS55*PS91 + PS62*PS93 + PS67*PS92 - PS72*PS89 + PS94;
+nextP[1][6] = PS116*PS91 + PS119*PS93 + PS120*PS92 - PS121*PS89 + PS125;
+nextP[2][6] = PS141*PS91 + PS144*PS93 + PS145*PS92 - PS146*PS89 + PS150;
+nextP[3][6] = PS161*PS91 + PS164*PS93 + PS165*PS92 - PS166*PS89 + PS170;
+nextP[4][6] = -PS171*PS198 + PS178*PS87 - PS180*PS197 - PS184*PS56*PS88 + PS187*PS90 + PS188*PS92 + PS189*PS93 - PS191*PS89 + PS192*PS91 + PS194*PS199 + PS200;
+nextP[5][6] = PS190*PS198 - PS195*PS197 - PS197*PS205 + PS199*PS206 + PS207*PS216 + PS208*PS217 + PS209*PS87 - PS210*PS214 + PS211*PS215 - PS212*PS76*PS90 + PS218;
+nextP[6][6] = PS184*sq(PS88) - PS197*PS220 + PS199*PS221 + PS212*sq(PS90) - PS214*(-PS214*P[2][2] + PS215*P[2][3] + PS216*P[0][2] + PS217*P[1][2] + P[2][6]) + PS215*(-PS214*P[2][3] + PS215*P[3][3] + PS216*P[0][3] + PS217*P[1][3] + P[3][6]) + PS216*(-PS214*P[0][2] + PS215*P[0][3] + PS216*P[0][0] + PS217*P[0][1] + P[0][6]) + PS217*(-PS214*P[1][2] + PS215*P[1][3] + PS216*P[0][1] + PS217*P[1][1] + P[1][6]) + PS219*PS87 + PS222 + sq(PS87)*dvzVar;
+nextP[0][7] = -PS11*P[1][7] - PS12*P[2][7] - PS13*P[3][7] + PS73*dt + P[0][7];
+nextP[1][7] = PS11*P[0][7] - PS12*P[3][7] + PS122*dt + PS13*P[2][7] + P[1][7];
+nextP[2][7] = PS11*P[3][7] + PS12*P[0][7] - PS13*P[1][7] + PS147*dt + P[2][7];
+nextP[3][7] = -PS11*P[2][7] + PS12*P[1][7] + PS13*P[0][7] + PS167*dt + P[3][7];
+nextP[4][7] = PS173*P[1][7] + PS174*P[0][7] + PS175*P[2][7] - PS176*P[3][7] + PS186*dt + P[4][7];
+nextP[5][7] = PS201*P[2][7] - PS202*P[0][7] + PS203*P[3][7] - PS204*P[1][7] + P[5][7] + dt*(PS201*P[2][4] - PS202*P[0][4] + PS203*P[3][4] - PS204*P[1][4] + P[4][5]);
+nextP[6][7] = -PS214*P[2][7] + PS215*P[3][7] + PS216*P[0][7] + PS217*P[1][7] + P[6][7] + dt*(-PS214*P[2][4] + PS215*P[3][4] + PS216*P[0][4] + PS217*P[1][4] + P[4][6]);
+nextP[7][7] = P[4][7]*dt + P[7][7] + dt*(P[4][4]*dt + P[4][7]);
+nextP[0][8] = -PS11*P[1][8] - PS12*P[2][8] - PS13*P[3][8] + PS86*dt + P[0][8];
+nextP[1][8] = PS11*P[0][8] - PS12*P[3][8] + PS124*dt + PS13*P[2][8] + P[1][8];
+nextP[2][8] = PS11*P[3][8] + PS12*P[0][8] - PS13*P[1][8] + PS149*dt + P[2][8];
+nextP[3][8] = -PS11*P[2][8] + PS12*P[1][8] + PS13*P[0][8] + PS169*dt + P[3][8];
+nextP[4][8] = PS173*P[1][8] + PS174*P[0][8] + PS175*P[2][8] - PS176*P[3][8] + PS196*dt + P[4][8];
+nextP[5][8] = PS201*P[2][8] - PS202*P[0][8] + PS203*P[3][8] - PS204*P[1][8] + PS213*dt + P[5][8];
+nextP[6][8] = -PS214*P[2][8] + PS215*P[3][8] + PS216*P[0][8] + PS217*P[1][8] + P[6][8] + dt*(-PS214*P[2][5] + PS215*P[3][5] + PS216*P[0][5] + PS217*P[1][5] + P[5][6]);
+nextP[7][8] = P[4][8]*dt + P[7][8] + dt*(P[4][5]*dt + P[5][7]);
+nextP[8][8] = P[5][8]*dt + P[8][8] + dt*(P[5][5]*dt + P[5][8]);
+nextP[0][9] = -PS11*P[1][9] - PS12*P[2][9] - PS13*P[3][9] + PS94*dt + P[0][9];
+nextP[1][9] = PS11*P[0][9] - PS12*P[3][9] + PS125*dt + PS13*P[2][9] + P[1][9];
+nextP[2][9] = PS11*P[3][9] + PS12*P[0][9] - PS13*P[1][9] + PS150*dt + P[2][9];
+nextP[3][9] = -PS11*P[2][9] + PS12*P[1][9] + PS13*P[0][9] + PS170*dt + P[3][9];
+nextP[4][9] = PS173*P[1][9] + PS174*P[0][9] + PS175*P[2][9] - PS176*P[3][9] + PS200*dt + P[4][9];
+nextP[5][9] = PS201*P[2][9] - PS202*P[0][9] + PS203*P[3][9] - PS204*P[1][9] + PS218*dt + P[5][9];
+nextP[6][9] = -PS214*P[2][9] + PS215*P[3][9] + PS216*P[0][9] + PS217*P[1][9] + PS222*dt + P[6][9];
+nextP[7][9] = P[4][9]*dt + P[7][9] + dt*(P[4][6]*dt + P[6][7]);
+nextP[8][9] = P[5][9]*dt + P[8][9] + dt*(P[5][6]*dt + P[6][8]);
+nextP[9][9] = P[6][9]*dt + P[9][9] + dt*(P[6][6]*dt + P[6][9]);
+
+
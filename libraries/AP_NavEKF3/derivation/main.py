@@ -3,6 +3,7 @@
 # and modified for ArduPilot
 from sympy import *
 from code_gen import *
+from cov_kernels import write_specialised_kernels
 import numpy as np
 
 # q: quaternion describing rotation from frame 1 to frame 2
@@ -670,6 +671,9 @@ def generate_code():
 
     cov_code_generator.close()
 
+    print('Writing specialised covariance propagation to file ...')
+    write_specialised_kernels("./generated/covariance_generated.cpp", "./generated")
+
 
     # derive autocode for other methods
     print('Computing tilt error covariance matrix ...')
@@ -309,6 +309,40 @@ private:
         bool load_attempted;
         const char *str;
     } callsign_data;
+
+    // items that keep the text they last wrote, and write it again
+    // rather than formatting it while their inputs are unchanged
+    enum class CachedItem : uint8_t {
+        ALTITUDE,
+        BAT_VOLT,
+        BATUSED,
+        BAT2USED,
+        SATS,
+        THROTTLE,
+        HEADING,
+        ROLL_ANGLE,
+        PITCH_ANGLE,
+        TEMP,
+        HDOP,
+        GPS_LATITUDE,
+        GPS_LONGITUDE,
+        COUNT
+    };
+    struct ItemCache {
+        uint32_t key;
+        uint32_t drawn_ms;
+        uint8_t x, y;
+        bool hidden;
+        bool valid;
+        char text[16];
+    };
+    // only one screen is drawn at a time, so the screens share a cache
+    static ItemCache item_cache[uint8_t(CachedItem::COUNT)];
+    static const AP_OSD_Screen *item_cache_screen;
+    static ItemCache *item_capture;
+
+    bool draw_cached(CachedItem item, uint8_t x, uint8_t y, uint32_t key, bool blink);
+    void end_cached(void);
 };
 #endif // OSD_ENABLED
 
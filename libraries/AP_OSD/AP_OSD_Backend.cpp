@@ -86,11 +86,38 @@ void AP_OSD_Backend::write(uint8_t x, uint8_t y, bool blink, const char *fmt, ..
     // note: format_string_for_osd() always terminates the string
     IGNORE_RETURN(format_string_for_osd(buff, sizeof(buff), check_option(AP_OSD::OPTION_DECIMAL_PACK), fmt, ap));
     va_end(ap);
+    if (capture_buf != nullptr) {
+        const size_t len = strlen(buff);
+        if (capture_count++ == 0 && len < capture_size) {
+            memcpy(capture_buf, buff, len+1);
+        } else {
+            capture_overflow = true;
+        }
+    }
     // buff is null terminated, this call should be safe without further checks
     write(x, y, buff);
 #endif
 }
 
+void AP_OSD_Backend::begin_capture(char *buf, uint8_t size)
+{
+    capture_buf = buf;
+    capture_size = size;
+    capture_count = 0;
+    capture_overflow = size == 0;
+    if (size > 0) {
+        // a blinking item may write nothing
+        buf[0] = 0;
+    }
+}
+
+bool AP_OSD_Backend::end_capture(void)
+{
+    const bool ret = capture_buf != nullptr && !capture_overflow;
+    capture_buf = nullptr;
+    return ret;
+}
+
 /*
   load a font from sdcard or ROMFS
  */
@@ -51,8 +51,32 @@ public:
     virtual void clear()
     {
         blink_phase = (blink_phase+1)%4;
+        prev_dirty_rows = dirty_rows;
+        dirty_rows = 0;
     };
 
+    // true if text written with blink set is hidden in this frame
+    bool blink_hidden(bool blink) const
+    {
+        return blink && blink_phase < 2;
+    }
+
+    // keep a copy of the text of the next formatted write, so that a
+    // screen item can be written again later without formatting it
+    void begin_capture(char *buf, uint8_t size);
+
+    // stop capturing, false if there was more than one write or the
+    // text did not fit
+    bool end_capture(void);
+
+    // rows written since the last clear and in the frame before it.
+    // Only these rows can differ from what is on screen, so backends
+    // that diff the frame against the screen can skip the others
+    uint32_t get_dirty_rows() const
+    {
+        return dirty_rows | prev_dirty_rows;
+    }
+
     // copy the backend specific symbol set to the OSD lookup table
     virtual void init_symbol_set(uint8_t *symbols, const uint8_t size);
 
@@ -87,6 +111,12 @@ protected:
 
     int8_t blink_phase;
 
+    // to be called by write() for each row it changes
+    void mark_dirty_row(uint8_t y)
+    {
+        dirty_rows |= 1UL << MIN(y, 31U);
+    }
+
     enum vid_format {
         FORMAT_UNKNOWN = 0,
         FORMAT_NTSC = 1,
@@ -289,4 +319,14 @@ protected:
         SYM_SIDEBAR_I,
         SYM_SIDEBAR_J,
     };
+
+private:
+    uint32_t dirty_rows;
+    uint32_t prev_dirty_rows;
+
+    // formatted text capture for begin_capture()
+    char *capture_buf;
+    uint8_t capture_size;
+    uint8_t capture_count;
+    bool capture_overflow;
 };
@@ -351,6 +351,7 @@ void AP_OSD_MAX7456::reinit()
 
     // force redrawing all screen
     memset(shadow_frame, 0xFF, sizeof(shadow_frame));
+    unsent_rows = UINT32_MAX;
 
     initialized = true;
 }
@@ -389,14 +390,23 @@ void AP_OSD_MAX7456::transfer_frame()
         return;
     }
 
+    // rows that nothing was written to in this frame or the last
+    // are the same as on screen
+    const uint32_t rows = get_dirty_rows() | unsent_rows;
+    unsent_rows = 0;
+
     buffer_offset = 0;
     for (uint8_t y=0; y<video_lines; y++) {
+        if ((rows & (1UL << y)) == 0) {
+            continue;
+        }
         for (uint8_t x=0; x<video_columns; x++) {
             if (!is_dirty(x, y)) {
                 continue;
             }
             //ensure space for 1 char and escape sequence
             if (buffer_offset >= spi_buffer_size - 32) {
+                unsent_rows |= 1UL << y;
                 break;
             }
             shadow_frame[y][x] = frame[y][x];
@@ -459,6 +469,7 @@ void AP_OSD_MAX7456::write(uint8_t x, uint8_t y, const char* text)
     if (y >= video_lines_pal || text == nullptr) {
         return;
     }
+    mark_dirty_row(y);
     while ((x < VIDEO_COLUMNS) && (*text != 0)) {
         frame[y][x] = *text;
         ++text;
@@ -81,6 +81,10 @@ private:
     //used to optimize number of characters updated
     uint8_t shadow_frame[video_lines_pal][video_columns];
 
+    //rows that were not fully transferred, or need redrawing
+    //whether they were written or not
+    uint32_t unsent_rows;
+
     uint8_t buffer[spi_buffer_size];
     int buffer_offset;
 
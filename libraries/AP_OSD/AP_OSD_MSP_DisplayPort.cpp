@@ -30,6 +30,15 @@ static const struct AP_Param::defaults_table_struct defaults_table[] = {
     */
 };
 
+// resend the whole screen this often so the display recovers from lost frames
+#ifndef OSD_MSP_DISPLAYPORT_FULL_REFRESH_MS
+#define OSD_MSP_DISPLAYPORT_FULL_REFRESH_MS 2000U
+#endif
+
+// unchanged cells worth resending to join two changed runs, an extra
+// write_string costs 10 bytes of MSP framing
+#define OSD_MSP_DISPLAYPORT_RUN_GAP 8U
+
 extern const AP_HAL::HAL &hal;
 constexpr uint8_t AP_OSD_MSP_DisplayPort::symbols[AP_OSD_NUM_SYMBOLS];
 
@@ -67,11 +76,15 @@ void AP_OSD_MSP_DisplayPort::clear(void)
     if (_osd.get_current_screen() < AP_OSD_NUM_DISPLAY_SCREENS) {
         const uint8_t txt_resolution = _osd.screen[_osd.get_current_screen()].get_txt_resolution();
         const uint8_t font_index = _osd.screen[_osd.get_current_screen()].get_font_index();
-        _displayport->msp_displayport_set_options(font_index, txt_resolution);
+        if (txt_resolution != _txt_resolution || font_index != _font_index) {
+            _txt_resolution = txt_resolution;
+            _font_index = font_index;
+            _full_refresh_pending = true;
+        }
     }
 
-    // clear remote MSP screen
-    _displayport->msp_displayport_clear_screen();
+    // only the local frame is cleared, flush() sends the differences
+    memset(frame, ' ', sizeof(frame));
 
     // toggle flashing @1Hz
     const uint32_t now = AP_HAL::millis();
@@ -83,7 +96,14 @@ void AP_OSD_MSP_DisplayPort::clear(void)
 
 void AP_OSD_MSP_DisplayPort::write(uint8_t x, uint8_t y, const char* text)
 {
-    _displayport->msp_displayport_write_string(x, y, 0, text);
+    if (y >= video_lines || text == nullptr) {
+        return;
+    }
+    while ((x < video_columns) && (*text != 0)) {
+        frame[y][x] = *text;
+        ++text;
+        ++x;
+    }
 }
 
 uint8_t AP_OSD_MSP_DisplayPort::format_string_for_osd(char* buff, uint8_t size, bool decimal_packed, const char *fmt, va_list ap)
@@ -95,8 +115,24 @@ uint8_t AP_OSD_MSP_DisplayPort::format_string_for_osd(char* buff, uint8_t size,
 
 void AP_OSD_MSP_DisplayPort::flush(void)
 {
-    // grab the screen and force a redraw
+    // grab the screen
     _displayport->msp_displayport_grab();
+
+    // periodically start from a blank remote screen so that a display
+    // which missed a frame or was power cycled gets back in step
+    const uint32_t now_ms = AP_HAL::millis();
+    if (_full_refresh_pending || now_ms - _last_full_refresh_ms >= OSD_MSP_DISPLAYPORT_FULL_REFRESH_MS) {
+        if (_txt_resolution >= 0) {
+            _displayport->msp_displayport_set_options(_font_index, _txt_resolution);
+        }
+        _displayport->msp_displayport_clear_screen();
+        memset(shadow_frame, ' ', sizeof(shadow_frame));
+        _last_full_refresh_ms = now_ms;
+        _full_refresh_pending = false;
+    }
+
+    // send the changes and force a redraw
+    transfer_frame();
     _displayport->msp_displayport_draw_screen();
 
     // ok done processing displayport data
@@ -104,6 +140,42 @@ void AP_OSD_MSP_DisplayPort::flush(void)
     _displayport->process_incoming_data();
 }
 
+/*
+  send the runs of cells that differ from what the remote display has
+ */
+void AP_OSD_MSP_DisplayPort::transfer_frame(void)
+{
+    char run[OSD_MSP_DISPLAYPORT_MAX_STRING_LENGTH+1];
+
+    for (uint8_t y=0; y<video_lines; y++) {
+        uint8_t x = 0;
+        while (x < video_columns) {
+            if (frame[y][x] == shadow_frame[y][x]) {
+                x++;
+                continue;
+            }
+            // extend the run over short unchanged gaps, up to the
+            // longest string a single write can carry
+            uint8_t end = x + 1;
+            for (uint8_t i = end; i < video_columns && uint8_t(i - x) < OSD_MSP_DISPLAYPORT_MAX_STRING_LENGTH; i++) {
+                if (frame[y][i] != shadow_frame[y][i]) {
+                    end = i + 1;
+                } else if (i + 1 - end > OSD_MSP_DISPLAYPORT_RUN_GAP) {
+                    break;
+                }
+            }
+            const uint8_t len = end - x;
+            memcpy(run, &frame[y][x], len);
+            run[len] = 0;
+            if (_displayport->msp_displayport_write_string(x, y, false, run)) {
+                // only track what actually went out, dropped runs are retried next frame
+                memcpy(&shadow_frame[y][x], &frame[y][x], len);
+            }
+            x = end;
+        }
+    }
+}
+
 void AP_OSD_MSP_DisplayPort::init_symbol_set(uint8_t *lookup_table, const uint8_t size)
 {
     const AP_MSP *msp = AP::msp();
@@ -34,9 +34,24 @@ protected:
 
 private:
     void setup_defaults(void);
+    void transfer_frame(void);
 
     AP_MSP_Telem_Backend* _displayport;
 
+    // largest text resolution we support, HD 50x18
+    static const uint8_t video_columns = 50;
+    static const uint8_t video_lines = 18;
+
+    // frame being drawn
+    uint8_t frame[video_lines][video_columns];
+    // frame as last sent to the remote display
+    uint8_t shadow_frame[video_lines][video_columns];
+
+    uint32_t _last_full_refresh_ms;
+    bool _full_refresh_pending = true;
+    int8_t _txt_resolution = -1;
+    int8_t _font_index = -1;
+
     // MSP DisplayPort symbols
     static const uint8_t SYM_M = 0x0C;
     static const uint8_t SYM_KM = 0x7D;
@@ -1273,6 +1273,55 @@ float AP_OSD_AbstractScreen::u_scale(enum unit_type unit, float value)
     return value * scale[units][unit] + (offsets[units]?offsets[units][unit]:0);
 }
 
+// cached items are formatted again at least this often, which covers
+// inputs their keys leave out, such as units and options
+#define OSD_ITEM_CACHE_REFRESH_MS 1000
+
+AP_OSD_Screen::ItemCache AP_OSD_Screen::item_cache[uint8_t(AP_OSD_Screen::CachedItem::COUNT)];
+const AP_OSD_Screen *AP_OSD_Screen::item_cache_screen;
+AP_OSD_Screen::ItemCache *AP_OSD_Screen::item_capture;
+
+/*
+  write an item again from the cache if it was last drawn at the same
+  place from the same key, returning true. Otherwise start capturing
+  what the item writes and return false so that it is drawn. The key
+  must change whenever what the item shows does, at the resolution it
+  is shown at
+ */
+bool AP_OSD_Screen::draw_cached(CachedItem item, uint8_t x, uint8_t y, uint32_t key, bool blink)
+{
+    ItemCache &c = item_cache[uint8_t(item)];
+    const bool hidden = backend->blink_hidden(blink);
+    const uint32_t now_ms = AP_HAL::millis();
+    if (c.valid && c.key == key && c.hidden == hidden && c.x == x && c.y == y &&
+        now_ms - c.drawn_ms < OSD_ITEM_CACHE_REFRESH_MS) {
+        if (c.text[0] != 0) {
+            backend->write(x, y, c.text);
+        }
+        return true;
+    }
+    c.valid = false;
+    c.key = key;
+    c.hidden = hidden;
+    c.x = x;
+    c.y = y;
+    c.drawn_ms = now_ms;
+    backend->begin_capture(c.text, sizeof(c.text));
+    item_capture = &c;
+    return false;
+}
+
+/*
+  called after each item is drawn, to keep what a cached item wrote
+ */
+void AP_OSD_Screen::end_cached(void)
+{
+    if (item_capture != nullptr) {
+        item_capture->valid = backend->end_capture();
+        item_capture = nullptr;
+    }
+}
+
 void AP_OSD_Screen::draw_altitude(uint8_t x, uint8_t y)
 {
     float alt;
@@ -1280,21 +1329,32 @@ void AP_OSD_Screen::draw_altitude(uint8_t x, uint8_t y)
     WITH_SEMAPHORE(ahrs.get_semaphore());
     ahrs.get_relative_position_D_home(alt);
     alt = -alt;
-    backend->write(x, y, false, "%4d%c", (int)u_scale(ALTITUDE, alt), u_icon(ALTITUDE));
+    const int alt_shown = u_scale(ALTITUDE, alt);
+    if (draw_cached(CachedItem::ALTITUDE, x, y, alt_shown, false)) {
+        return;
+    }
+    backend->write(x, y, false, "%4d%c", alt_shown, u_icon(ALTITUDE));
 }
 
 void AP_OSD_Screen::draw_bat_volt(uint8_t x, uint8_t y)
 {
     AP_BattMonitor &battery = AP::battery();
     float v = battery.voltage();
+    const bool flash = v < osd->warn_batvolt;
     uint8_t pct;
     if (!battery.capacity_remaining_pct(pct)) {
+        if (draw_cached(CachedItem::BAT_VOLT, x, y, uint16_t(lroundf(v*10)) | 0x10000U, flash)) {
+            return;
+        }
         // Do not show battery percentage
-        backend->write(x,y, v < osd->warn_batvolt, "%2.1f%c", (double)v, SYMBOL(SYM_VOLT));
+        backend->write(x,y, flash, "%2.1f%c", (double)v, SYMBOL(SYM_VOLT));
         return;
     }
     uint8_t p = (100 - pct) / 16.6;
-    backend->write(x,y, v < osd->warn_batvolt, "%c%2.1f%c", SYMBOL(SYM_BATT_FULL) + p, (double)v, SYMBOL(SYM_VOLT));
+    if (draw_cached(CachedItem::BAT_VOLT, x, y, uint16_t(lroundf(v*10)) | (uint32_t(p) << 17), flash)) {
+        return;
+    }
+    backend->write(x,y, flash, "%c%2.1f%c", SYMBOL(SYM_BATT_FULL) + p, (double)v, SYMBOL(SYM_VOLT));
 }
 
 void AP_OSD_Screen::draw_avgcellvolt(uint8_t x, uint8_t y)
@@ -1391,6 +1451,9 @@ void AP_OSD_Screen::draw_sats(uint8_t x, uint8_t y)
     AP_GPS & gps = AP::gps();
     uint8_t nsat = gps.num_sats();
     bool flash = (nsat < osd->warn_nsat) || (gps.status() < AP_GPS::GPS_OK_FIX_3D);
+    if (draw_cached(CachedItem::SATS, x, y, nsat, flash)) {
+        return;
+    }
     backend->write(x, y, flash, "%c%c%2u", SYMBOL(SYM_SAT_L), SYMBOL(SYM_SAT_R), nsat);
 }
 
@@ -1400,6 +1463,9 @@ void AP_OSD_Screen::draw_batused(uint8_t instance, uint8_t x, uint8_t y)
     if (!AP::battery().consumed_mah(mah, instance)) {
         mah = 0;
     }
+    if (draw_cached(instance == 0 ? CachedItem::BATUSED : CachedItem::BAT2USED, x, y, int32_t(mah), false)) {
+        return;
+    }
     if (mah <= 9999) {
         backend->write(x,y, false, "%4d%c", (int)mah, SYMBOL(SYM_MAH));
     } else {
@@ -1595,12 +1661,19 @@ void AP_OSD_Screen::draw_heading(uint8_t x, uint8_t y)
 {
     AP_AHRS &ahrs = AP::ahrs();
     uint16_t yaw = ahrs.yaw_sensor / 100;
+    if (draw_cached(CachedItem::HEADING, x, y, yaw, false)) {
+        return;
+    }
     backend->write(x, y, false, "%3d%c", yaw, SYMBOL(SYM_DEGR));
 }
 
 void AP_OSD_Screen::draw_throttle(uint8_t x, uint8_t y)
 {
-    backend->write(x, y, false, "%3d%c", gcs().get_hud_throttle(), SYMBOL(SYM_PCNT));
+    const int16_t throttle = gcs().get_hud_throttle();
+    if (draw_cached(CachedItem::THROTTLE, x, y, uint16_t(throttle), false)) {
+        return;
+    }
+    backend->write(x, y, false, "%3d%c", throttle, SYMBOL(SYM_PCNT));
 }
 
 #if HAL_OSD_SIDEBAR_ENABLE
@@ -1820,6 +1893,9 @@ void AP_OSD_Screen::draw_gps_latitude(uint8_t x, uint8_t y)
     dec_portion = loc.lat / 10000000L;
     frac_portion = abs_lat - labs(dec_portion)*10000000UL;
 
+    if (draw_cached(CachedItem::GPS_LATITUDE, x, y, loc.lat, false)) {
+        return;
+    }
     backend->write(x, y, false, "%c%4ld.%07ld", SYMBOL(SYM_GPS_LAT), (long)dec_portion,(long)frac_portion);
 }
 
@@ -1833,6 +1909,9 @@ void AP_OSD_Screen::draw_gps_longitude(uint8_t x, uint8_t y)
     dec_portion = loc.lng / 10000000L;
     frac_portion = abs_lon - labs(dec_portion)*10000000UL;
 
+    if (draw_cached(CachedItem::GPS_LONGITUDE, x, y, loc.lng, false)) {
+        return;
+    }
     backend->write(x, y, false, "%c%4ld.%07ld", SYMBOL(SYM_GPS_LONG), (long)dec_portion,(long)frac_portion);
 }
 
@@ -1848,6 +1927,9 @@ void AP_OSD_Screen::draw_roll_angle(uint8_t x, uint8_t y)
     } else {
         r = SYMBOL(SYM_ROLL0);
     }
+    if (draw_cached(CachedItem::ROLL_ANGLE, x, y, roll | (uint32_t(uint8_t(r)) << 16), false)) {
+        return;
+    }
     backend->write(x, y, false, "%c%3d%c", r, roll, SYMBOL(SYM_DEGR));
 }
 
@@ -1863,6 +1945,9 @@ void AP_OSD_Screen::draw_pitch_angle(uint8_t x, uint8_t y)
     } else {
         p = SYMBOL(SYM_PTCH0);
     }
+    if (draw_cached(CachedItem::PITCH_ANGLE, x, y, pitch | (uint32_t(uint8_t(p)) << 16), false)) {
+        return;
+    }
     backend->write(x, y, false, "%c%3d%c", p, pitch, SYMBOL(SYM_DEGR));
 }
 
@@ -1870,14 +1955,22 @@ void AP_OSD_Screen::draw_temp(uint8_t x, uint8_t y)
 {
     AP_Baro &barometer = AP::baro();
     float tmp = barometer.get_temperature();
-    backend->write(x, y, false, "%3d%c", (int)u_scale(TEMPERATURE, tmp), u_icon(TEMPERATURE));
+    const int tmp_shown = u_scale(TEMPERATURE, tmp);
+    if (draw_cached(CachedItem::TEMP, x, y, tmp_shown, false)) {
+        return;
+    }
+    backend->write(x, y, false, "%3d%c", tmp_shown, u_icon(TEMPERATURE));
 }
 
 
 void AP_OSD_Screen::draw_hdop(uint8_t x, uint8_t y)
 {
     AP_GPS & gps = AP::gps();
-    float hdp = gps.get_hdop() * 0.01f;
+    const uint16_t hdop = gps.get_hdop();
+    if (draw_cached(CachedItem::HDOP, x, y, hdop, false)) {
+        return;
+    }
+    float hdp = hdop * 0.01f;
     backend->write(x, y, false, "%c%c%3.2f", SYMBOL(SYM_HDOP_L), SYMBOL(SYM_HDOP_R), (double)hdp);
 }
 
@@ -2169,7 +2262,7 @@ void AP_OSD_Screen::draw_rngf(uint8_t x, uint8_t y)
     }
 }
 
-#define DRAW_SETTING(n) if (n.enabled) draw_ ## n(n.xpos, n.ypos)
+#define DRAW_SETTING(n) if (n.enabled) { draw_ ## n(n.xpos, n.ypos); end_cached(); }
 
 #if HAL_WITH_OSD_BITMAP || HAL_WITH_MSP_DISPLAYPORT
 void AP_OSD_Screen::draw(void)
@@ -2177,6 +2270,12 @@ void AP_OSD_Screen::draw(void)
     if (!enabled || !backend) {
         return;
     }
+    if (item_cache_screen != this) {
+        for (auto &c : item_cache) {
+            c.valid = false;
+        }
+        item_cache_screen = this;
+    }
     //Note: draw order should be optimized.
     //Big and less important items should be drawn first,
     //so they will not overwrite more important ones.
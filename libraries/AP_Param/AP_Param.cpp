@@ -25,6 +25,7 @@
 
 #include <cmath>
 #include <string.h>
+#include <ctype.h>
 
 #include <AP_Common/AP_Common.h>
 #include <AP_HAL/AP_HAL.h>
@@ -42,6 +43,7 @@
 extern const AP_HAL::HAL &hal;
 
 uint16_t AP_Param::sentinal_offset;
+uint32_t AP_Param::_load_all_us;
 
 // singleton instance
 AP_Param *AP_Param::_singleton;
@@ -91,12 +93,47 @@ uint16_t AP_Param::_count_marker;
 uint16_t AP_Param::_count_marker_done;
 HAL_Semaphore AP_Param::_count_sem;
 
+#if AP_PARAM_NAME_INDEX_ENABLED
+uint32_t *AP_Param::_name_index;
+uint16_t AP_Param::_name_index_size;
+uint16_t AP_Param::_name_index_marker;
+bool AP_Param::_name_index_allowed;
+HAL_Semaphore AP_Param::_name_index_sem;
+
+// marker for an empty name index slot. This is never a valid token
+// as the key is above any var_info index
+#define NAME_INDEX_EMPTY UINT32_MAX
+static_assert(sizeof(AP_Param::ParamToken) == sizeof(uint32_t), "ParamToken must fit a name index slot");
+#endif
+
+#if AP_PARAM_SCALAR_TABLE_ENABLED
+AP_Param::ParamToken *AP_Param::_scalar_table;
+uint16_t AP_Param::_scalar_table_count;
+uint16_t AP_Param::_scalar_table_size;
+uint16_t AP_Param::_scalar_table_marker;
+HAL_Semaphore AP_Param::_scalar_table_sem;
+#endif
+
+uint32_t AP_Param::_storage_hash;
+HAL_Semaphore AP_Param::_change_sem;
+
+#if AP_PARAM_CHANGE_HISTORY > 0
+AP_Param::ParamChange AP_Param::_changes[AP_PARAM_CHANGE_HISTORY];
+uint8_t AP_Param::_num_changes;
+uint32_t AP_Param::_generation;
+uint32_t AP_Param::_generation_dropped;
+bool AP_Param::_generation_init;
+#endif
+
 // storage and naming information about all types that can be saved
 const AP_Param::Info *AP_Param::_var_info;
 
 struct AP_Param::param_override *AP_Param::param_overrides = nullptr;
 uint16_t AP_Param::num_param_overrides = 0;
 uint16_t AP_Param::num_read_only = 0;
+AP_Param::defaults_unresolved *AP_Param::defaults_unresolved_list;
+char *AP_Param::defaults_source;
+bool AP_Param::defaults_source_embedded;
 
 ObjectBuffer_TS<AP_Param::param_save> AP_Param::save_queue{30};
 bool AP_Param::registered_save_handler;
@@ -167,6 +204,9 @@ void AP_Param::erase_all(void)
 
     // add a sentinal directly after the header
     write_sentinal(sizeof(struct EEPROM_header));
+
+    WITH_SEMAPHORE(_change_sem);
+    _storage_hash = 0;
 }
 
 /* the 'group_id' of a element of a group is the 18 bit identifier
@@ -485,26 +525,41 @@ const struct AP_Param::Info *AP_Param::find_by_header(struct Param_header phdr,
             // not the right key
             continue;
         }
-        if (type == AP_PARAM_GROUP) {
-            const struct GroupInfo *group_info = get_group_info(info);
-            if (group_info == nullptr) {
-                continue;
-            }
-            return find_by_header_group(phdr, ptr, i, group_info, 0, 0, 0);
+        if (type == AP_PARAM_GROUP && get_group_info(info) == nullptr) {
+            continue;
         }
-        if (type == phdr.type) {
-            // found it
-            ptrdiff_t base;
-            if (!get_base(info, base)) {
-                return nullptr;
-            }
-            *ptr = (void*)base;
-            return &info;
+        if (type != AP_PARAM_GROUP && type != phdr.type) {
+            continue;
         }
+        return find_by_header_vindex(phdr, ptr, i);
     }
     return nullptr;
 }
 
+// find the info structure given a header and the index of the
+// var_info entry with the header's key
+const struct AP_Param::Info *AP_Param::find_by_header_vindex(struct Param_header phdr, void **ptr, uint16_t vindex)
+{
+    const auto &info = var_info(vindex);
+    if (info.type == AP_PARAM_GROUP) {
+        const struct GroupInfo *group_info = get_group_info(info);
+        if (group_info == nullptr) {
+            return nullptr;
+        }
+        return find_by_header_group(phdr, ptr, vindex, group_info, 0, 0, 0);
+    }
+    if (info.type != phdr.type) {
+        return nullptr;
+    }
+    // found it
+    ptrdiff_t base;
+    if (!get_base(info, base)) {
+        return nullptr;
+    }
+    *ptr = (void*)base;
+    return &info;
+}
+
 // find the info structure for a variable in a group
 const struct AP_Param::Info *AP_Param::find_var_info_group(const struct GroupInfo * group_info,
                                                            uint16_t                 vindex,
@@ -683,6 +738,85 @@ uint8_t AP_Param::type_size(enum ap_var_type type)
     return 0;
 }
 
+/*
+  FNV-1a hash of one stored parameter. The storage hash is the sum of
+  these over all stored parameters so it can be updated as each
+  parameter is saved
+ */
+uint32_t AP_Param::storage_entry_hash(const Param_header &phdr, const void *value)
+{
+    uint32_t h = 2166136261U;
+    const uint8_t *b = (const uint8_t *)&phdr;
+    for (uint8_t i=0; i<sizeof(phdr); i++) {
+        h ^= b[i];
+        h *= 16777619U;
+    }
+    b = (const uint8_t *)value;
+    const uint8_t size = type_size((enum ap_var_type)phdr.type);
+    for (uint8_t i=0; i<size; i++) {
+        h ^= b[i];
+        h *= 16777619U;
+    }
+    return h;
+}
+
+void AP_Param::update_storage_hash(uint32_t old_hash, uint32_t new_hash)
+{
+    WITH_SEMAPHORE(_change_sem);
+    _storage_hash += new_hash - old_hash;
+}
+
+#if AP_PARAM_CHANGE_HISTORY > 0
+/*
+  note that a parameter has been saved, keeping the history ordered
+  from oldest to newest with one entry per parameter
+ */
+void AP_Param::record_change(const AP_Param *ap, uint8_t size)
+{
+    WITH_SEMAPHORE(_change_sem);
+    uint8_t i;
+    for (i=0; i<_num_changes; i++) {
+        if (_changes[i].param == ap) {
+            break;
+        }
+    }
+    if (i == _num_changes && _num_changes == AP_PARAM_CHANGE_HISTORY) {
+        // drop the oldest change
+        _generation_dropped = _changes[0].generation;
+        i = 0;
+    }
+    if (i < _num_changes) {
+        memmove(&_changes[i], &_changes[i+1], (_num_changes-(i+1))*sizeof(_changes[0]));
+        _num_changes--;
+    }
+    ParamChange &c = _changes[_num_changes++];
+    c.param = ap;
+    c.size = size;
+    c.generation = ++_generation;
+}
+
+bool AP_Param::changed_since(uint32_t since, ParamChange changes[AP_PARAM_CHANGE_HISTORY],
+                             uint8_t &num_changes, uint32_t &generation, uint32_t &hash)
+{
+    WITH_SEMAPHORE(_change_sem);
+    num_changes = 0;
+    generation = _generation;
+    hash = _storage_hash;
+    // generations wrap, so compare distances back from the current one
+    const uint32_t since_age = _generation - since;
+    if (since_age > _generation - _generation_dropped) {
+        // from another boot, or older than the history
+        return false;
+    }
+    for (uint8_t i=0; i<_num_changes; i++) {
+        if (_generation - _changes[i].generation < since_age) {
+            changes[num_changes++] = _changes[i];
+        }
+    }
+    return true;
+}
+#endif // AP_PARAM_CHANGE_HISTORY
+
 /*
   extract 9 bit key from Param_header
  */
@@ -878,12 +1012,213 @@ AP_Param::find_group(const char *name, uint16_t vindex, ptrdiff_t group_offset,
     return nullptr;
 }
 
+// find a variable in a group from its token
+AP_Param *
+AP_Param::find_by_token_group(const ParamToken &token, const struct GroupInfo *group_info,
+                              ptrdiff_t base, uint32_t group_base, uint8_t group_shift,
+                              ptrdiff_t group_offset, enum ap_var_type *ptype, uint16_t *flags)
+{
+    enum ap_var_type type;
+    for (uint8_t i=0;
+         (type=(enum ap_var_type)group_info[i].type) != AP_PARAM_NONE;
+         i++) {
+        const uint32_t group_element = group_id(group_info, group_base, i, group_shift);
+        if (type == AP_PARAM_GROUP) {
+            const struct GroupInfo *ginfo = get_group_info(group_info[i]);
+            if (ginfo == nullptr) {
+                continue;
+            }
+            ptrdiff_t new_offset = group_offset;
+            if (!adjust_group_offset(token.key, group_info[i], new_offset)) {
+                continue;
+            }
+            AP_Param *ap = find_by_token_group(token, ginfo, base, group_element,
+                                               group_shift + _group_level_shift, new_offset, ptype, flags);
+            if (ap != nullptr) {
+                return ap;
+            }
+        } else if (group_element == token.group_element) {
+            if (flags != nullptr) {
+                *flags = group_info[i].flags;
+            }
+            ptrdiff_t ofs = base + group_info[i].offset + group_offset;
+            if (type == AP_PARAM_VECTOR3F && token.idx != 0) {
+                // an element of the vector, as returned by next()
+                ofs += sizeof(float)*(token.idx - 1u);
+                type = AP_PARAM_FLOAT;
+            }
+            *ptype = type;
+            return (AP_Param *)ofs;
+        }
+    }
+    return nullptr;
+}
+
+// find a variable from a token given by first() and next()
+AP_Param *
+AP_Param::find_by_token(const ParamToken &token, enum ap_var_type *ptype, uint16_t *flags)
+{
+    if (token.key >= _num_vars) {
+        return nullptr;
+    }
+    const auto &info = var_info(token.key);
+    ptrdiff_t base;
+    if (!get_base(info, base)) {
+        return nullptr;
+    }
+    enum ap_var_type type = (enum ap_var_type)info.type;
+    if (type == AP_PARAM_GROUP) {
+        const struct GroupInfo *group_info = get_group_info(info);
+        if (group_info == nullptr) {
+            return nullptr;
+        }
+        return find_by_token_group(token, group_info, base, 0, 0, 0, ptype, flags);
+    }
+    if (type == AP_PARAM_VECTOR3F && token.idx != 0) {
+        base += sizeof(float)*(token.idx - 1u);
+        type = AP_PARAM_FLOAT;
+    }
+    *ptype = type;
+    return (AP_Param *)base;
+}
+
+#if AP_PARAM_NAME_INDEX_ENABLED
+// case insensitive FNV-1a hash of a parameter name
+uint32_t AP_Param::name_hash(const char *name)
+{
+    uint32_t h = 2166136261U;
+    for (uint8_t i=0; i<AP_MAX_NAME_SIZE && name[i]; i++) {
+        h ^= uint8_t(toupper(name[i]));
+        h *= 16777619U;
+    }
+    return h;
+}
+
+/*
+  build the name index if it is missing or out of date. The caller
+  must hold _name_index_sem
+ */
+bool AP_Param::name_index_update(void)
+{
+    if (!_name_index_allowed) {
+        return false;
+    }
+    if (_name_index != nullptr && _name_index_marker == _count_marker) {
+        return true;
+    }
+    const uint16_t marker = _count_marker;
+
+    /*
+      index every scalar, including those in disabled groups, as
+      find() returns those too
+     */
+    AP_Param::ParamToken token {};
+    enum ap_var_type type;
+    uint32_t count = 0;
+    for (AP_Param *ap = first(&token, &type); ap != nullptr; ap = next(&token, &type, false)) {
+        if (type != AP_PARAM_NONE && type <= AP_PARAM_FLOAT) {
+            count++;
+        }
+    }
+
+    // keep the load factor below 2/3 so probe sequences stay short
+    uint32_t size = 64;
+    while (size < count + count/2) {
+        size *= 2;
+    }
+    if (size > UINT16_MAX) {
+        return false;
+    }
+    if (size > _name_index_size) {
+        delete[] _name_index;
+        _name_index = new uint32_t[size];
+        if (_name_index == nullptr) {
+            _name_index_size = 0;
+            return false;
+        }
+        _name_index_size = size;
+    }
+    memset(_name_index, 0xFF, _name_index_size * sizeof(_name_index[0]));
+
+    const uint16_t mask = _name_index_size - 1;
+    for (AP_Param *ap = first(&token, &type); ap != nullptr; ap = next(&token, &type, false)) {
+        if (type == AP_PARAM_NONE || type > AP_PARAM_FLOAT) {
+            continue;
+        }
+        char name[AP_MAX_NAME_SIZE+1];
+        ap->copy_name_token(token, name, sizeof(name), true);
+        name[AP_MAX_NAME_SIZE] = 0;
+        uint16_t i = name_hash(name) & mask;
+        while (_name_index[i] != NAME_INDEX_EMPTY) {
+            i = (i + 1) & mask;
+        }
+        ParamToken t = token;
+        t.last_disabled = 0;
+        memcpy(&_name_index[i], &t, sizeof(t));
+    }
+    _name_index_marker = marker;
+    return true;
+}
+
+/*
+  find a scalar variable by name using the name index. Returns nullptr
+  if it is not in the index, in which case the caller should fall back
+  to a search of the var_info tables
+ */
+AP_Param *AP_Param::find_in_name_index(const char *name, enum ap_var_type *ptype,
+                                       uint16_t *flags, ParamToken *token)
+{
+    WITH_SEMAPHORE(_name_index_sem);
+
+    if (!name_index_update()) {
+        return nullptr;
+    }
+    const uint16_t mask = _name_index_size - 1;
+    for (uint16_t i = name_hash(name) & mask;
+         _name_index[i] != NAME_INDEX_EMPTY;
+         i = (i + 1) & mask) {
+        ParamToken t;
+        memcpy(&t, &_name_index[i], sizeof(t));
+        enum ap_var_type type;
+        uint16_t f = 0;
+        AP_Param *ap = find_by_token(t, &type, &f);
+        if (ap == nullptr) {
+            continue;
+        }
+        // confirm the name, this also catches a pointer group that
+        // has moved since the index was built
+        char buf[AP_MAX_NAME_SIZE+1];
+        ap->copy_name_token(t, buf, sizeof(buf), true);
+        buf[AP_MAX_NAME_SIZE] = 0;
+        if (strcasecmp(name, buf) != 0) {
+            continue;
+        }
+        *ptype = type;
+        if (flags != nullptr) {
+            *flags = f;
+        }
+        if (token != nullptr) {
+            *token = t;
+        }
+        return ap;
+    }
+    return nullptr;
+}
+#endif // AP_PARAM_NAME_INDEX_ENABLED
 
 // Find a variable by name.
 //
 AP_Param *
 AP_Param::find(const char *name, enum ap_var_type *ptype, uint16_t *flags)
 {
+#if AP_PARAM_NAME_INDEX_ENABLED
+    {
+        AP_Param *ap = find_in_name_index(name, ptype, flags, nullptr);
+        if (ap != nullptr) {
+            return ap;
+        }
+    }
+#endif
     for (uint16_t i=0; i<_num_vars; i++) {
         const auto &info = var_info(i);
         uint8_t type = info.type;
@@ -925,11 +1260,24 @@ AP_Param::find(const char *name, enum ap_var_type *ptype, uint16_t *flags)
     return nullptr;
 }
 
-// Find a variable by index. Note that this is quite slow.
+// Find a variable by index. Note that this is quite slow unless the
+// scalar table is up to date.
 //
 AP_Param *
 AP_Param::find_by_index(uint16_t idx, enum ap_var_type *ptype, ParamToken *token)
 {
+#if AP_PARAM_SCALAR_TABLE_ENABLED
+    {
+        ParamToken t;
+        if (scalar_table_token(idx, t)) {
+            AP_Param *ap = find_by_token(t, ptype);
+            if (ap != nullptr) {
+                *token = t;
+                return ap;
+            }
+        }
+    }
+#endif
     AP_Param *ap;
     uint16_t count=0;
     for (ap=AP_Param::first(token, ptype);
@@ -943,6 +1291,14 @@ AP_Param::find_by_index(uint16_t idx, enum ap_var_type *ptype, ParamToken *token
 // by-name equivalent of find_by_index()
 AP_Param* AP_Param::find_by_name(const char* name, enum ap_var_type *ptype, ParamToken *token)
 {
+#if AP_PARAM_NAME_INDEX_ENABLED
+    {
+        AP_Param *ap = find_in_name_index(name, ptype, nullptr, token);
+        if (ap != nullptr) {
+            return ap;
+        }
+    }
+#endif
     AP_Param *ap;
     uint16_t count = 0;
     for (ap = AP_Param::first(token, ptype);
@@ -1150,6 +1506,10 @@ void AP_Param::save_sync(bool force_save, bool send_to_gcs)
         ap = (const AP_Param *)((ptrdiff_t)ap) - (idx*sizeof(float));
     }
 
+#if AP_PARAM_CHANGE_HISTORY > 0
+    record_change(ap, type_size((enum ap_var_type)phdr.type));
+#endif
+
     if (phdr.type == AP_PARAM_INT8 && ginfo != nullptr && (ginfo->flags & AP_PARAM_FLAG_ENABLE)) {
         // clear cached parameter count
         invalidate_count();
@@ -1162,7 +1522,10 @@ void AP_Param::save_sync(bool force_save, bool send_to_gcs)
     uint16_t ofs;
     if (scan(&phdr, &ofs)) {
         // found an existing copy of the variable
+        uint8_t old_value[12];
+        _storage.read_block(old_value, ofs+sizeof(phdr), type_size((enum ap_var_type)phdr.type));
         eeprom_write_check(ap, ofs+sizeof(phdr), type_size((enum ap_var_type)phdr.type));
+        update_storage_hash(storage_entry_hash(phdr, old_value), storage_entry_hash(phdr, ap));
         if (send_to_gcs) {
             send_parameter(name, (enum ap_var_type)phdr.type, idx);
         }
@@ -1209,6 +1572,7 @@ void AP_Param::save_sync(bool force_save, bool send_to_gcs)
     write_sentinal(ofs + sizeof(phdr) + type_size((enum ap_var_type)phdr.type));
     eeprom_write_check(ap, ofs+sizeof(phdr), type_size((enum ap_var_type)phdr.type));
     eeprom_write_check(&phdr, ofs, sizeof(phdr));
+    update_storage_hash(0, storage_entry_hash(phdr, ap));
 
     if (send_to_gcs) {
         send_parameter(name, (enum ap_var_type)phdr.type, idx);
@@ -1254,12 +1618,19 @@ void AP_Param::save(bool force_save)
 void AP_Param::save_io_handler(void)
 {
     struct param_save p;
-    while (save_queue.pop(p)) {
-        p.param->save_sync(p.force_save, true);
+    if (save_queue.pop(p)) {
+        // a calibration or GCS burst arrives as many queued saves,
+        // write them out as one flush
+        StorageManager::begin_batch();
+        do {
+            p.param->save_sync(p.force_save, true);
+        } while (save_queue.pop(p));
+        StorageManager::commit();
     }
     if (hal.scheduler->is_system_initialized()) {
         // pay the cost of parameter counting in the IO thread
         count_parameters();
+        update_scalar_table();
     }
 }
 
@@ -1504,8 +1875,7 @@ void AP_Param::setup_sketch_defaults(void)
 //
 bool AP_Param::load_all()
 {
-    struct Param_header phdr;
-    uint16_t ofs = sizeof(AP_Param::EEPROM_header);
+    const uint32_t start_us = AP_HAL::micros();
 
     reload_defaults_file(false);
 
@@ -1513,29 +1883,87 @@ bool AP_Param::load_all()
         registered_save_handler = true;
         hal.scheduler->register_io_process(FUNCTOR_BIND((&save_dummy), &AP_Param::save_io_handler, void));
     }
-    
+
+    /*
+      map each key to its var_info index, so each stored parameter
+      costs a table lookup rather than a scan of var_info. Keys are 9
+      bits so the table is small, and freed once loading is done
+     */
+    const uint16_t num_keys = 1U<<9;
+    uint16_t *key_vindex = new uint16_t[num_keys];
+    if (key_vindex != nullptr) {
+        memset(key_vindex, 0xFF, num_keys*sizeof(key_vindex[0]));
+        for (uint16_t i=0; i<_num_vars; i++) {
+            const auto &info = var_info(i);
+            if (info.key < num_keys && key_vindex[info.key] == UINT16_MAX) {
+                key_vindex[info.key] = i;
+            }
+        }
+    }
+
+    struct Param_header phdr;
+    uint16_t ofs = sizeof(AP_Param::EEPROM_header);
+    bool found_sentinal = false;
+    uint32_t hash = 0;
+
     while (ofs < _storage.size()) {
         _storage.read_block(&phdr, ofs, sizeof(phdr));
         if (is_sentinal(phdr)) {
             // we've reached the sentinal
             sentinal_offset = ofs;
-            return true;
+            found_sentinal = true;
+            break;
         }
 
         const struct AP_Param::Info *info;
         void *ptr;
 
-        info = find_by_header(phdr, &ptr);
+        if (key_vindex != nullptr) {
+            const uint16_t vindex = key_vindex[get_key(phdr)];
+            info = vindex == UINT16_MAX ? nullptr : find_by_header_vindex(phdr, &ptr, vindex);
+        } else {
+            info = find_by_header(phdr, &ptr);
+        }
+        uint8_t value[12];
+        const uint8_t size = type_size((enum ap_var_type)phdr.type);
+        _storage.read_block(value, ofs+sizeof(phdr), size);
         if (info != nullptr) {
-            _storage.read_block(ptr, ofs+sizeof(phdr), type_size((enum ap_var_type)phdr.type));
+            memcpy(ptr, value, size);
         }
+        hash += storage_entry_hash(phdr, value);
 
-        ofs += type_size((enum ap_var_type)phdr.type) + sizeof(phdr);
+        ofs += size + sizeof(phdr);
     }
 
-    // we didn't find the sentinal
-    Debug("no sentinal in load_all");
-    return false;
+    delete[] key_vindex;
+
+    {
+        WITH_SEMAPHORE(_change_sem);
+        _storage_hash = hash;
+#if AP_PARAM_CHANGE_HISTORY > 0
+        if (!_generation_init) {
+            // a random start makes a generation from an earlier boot
+            // unlikely to be mistaken for one from this boot
+            _generation_init = true;
+            if (!hal.util->get_random_vals((uint8_t *)&_generation, sizeof(_generation))) {
+                _generation = hash ^ AP_HAL::micros();
+            }
+            _generation_dropped = _generation;
+        }
+#endif
+    }
+
+#if AP_PARAM_NAME_INDEX_ENABLED
+    _name_index_allowed = true;
+#endif
+    _load_all_us = AP_HAL::micros() - start_us;
+
+    if (!found_sentinal) {
+        // we didn't find the sentinal
+        Debug("no sentinal in load_all");
+        return false;
+    }
+    return true;
 }
 
 /*
@@ -1837,6 +2265,29 @@ AP_Param *AP_Param::next_scalar(ParamToken *token, enum ap_var_type *ptype, floa
     return ap;
 }
 
+AP_Param *AP_Param::next_scalar_indexed(ParamToken *token, uint16_t idx, enum ap_var_type *ptype)
+{
+#if AP_PARAM_SCALAR_TABLE_ENABLED
+    /*
+      only use the table if the caller is where the table says it
+      is, so a walk started against an older list carries on as
+      next_scalar() would
+     */
+    ParamToken prev, t;
+    if (idx > 0 &&
+        scalar_table_token(idx-1, prev) &&
+        memcmp(&prev, token, sizeof(prev)) == 0 &&
+        scalar_table_token(idx, t)) {
+        AP_Param *ap = find_by_token(t, ptype);
+        if (ap != nullptr) {
+            *token = t;
+            return ap;
+        }
+    }
+#endif
+    return next_scalar(token, ptype);
+}
+
 
 /// cast a variable to a float given its type
 float AP_Param::cast_to_float(enum ap_var_type type) const
@@ -1940,12 +2391,14 @@ void AP_Param::convert_old_parameter(const struct ConversionInfo *info, float sc
 // convert old vehicle parameters to new object parametersv
 void AP_Param::convert_old_parameters(const struct ConversionInfo *conversion_table, uint8_t table_size, uint8_t flags)
 {
+    StorageManager::begin_batch();
     for (uint8_t i=0; i<table_size; i++) {
         convert_old_parameter(&conversion_table[i], 1.0f, flags);
     }
     // we need to flush here to prevent a later set_default_by_name()
     // causing a save to be done on a converted parameter
     flush();
+    StorageManager::commit();
 }
 
 // move all parameters from a class to a new location
@@ -1956,6 +2409,7 @@ void AP_Param::convert_class(uint16_t param_key, void *object_pointer,
 {
     const uint8_t group_shift = is_top_level ? 0 : 6;
 
+    StorageManager::begin_batch();
     for (uint8_t i=0; group_info[i].type != AP_PARAM_NONE; i++) {
         struct ConversionInfo info;
         info.old_key = param_key;
@@ -1991,6 +2445,7 @@ void AP_Param::convert_class(uint16_t param_key, void *object_pointer,
     // we need to flush here to prevent a later set_default_by_name()
     // causing a save to be done on a converted parameter
     flush();
+    StorageManager::commit();
 }
 
 /*
@@ -2137,81 +2592,147 @@ bool AP_Param::parse_param_line(char *line, char **vname, float &value, bool &re
 }
 
 
-#if HAVE_FILESYSTEM_SUPPORT
+/*
+  start parsing a new set of defaults, discarding the old
+ */
+void AP_Param::defaults_parse_start(void)
+{
+    delete[] param_overrides;
+    param_overrides = nullptr;
+    num_param_overrides = 0;
+    num_read_only = 0;
+    while (defaults_unresolved_list != nullptr) {
+        defaults_unresolved *next = defaults_unresolved_list->next;
+        delete defaults_unresolved_list;
+        defaults_unresolved_list = next;
+    }
+    free(defaults_source);
+    defaults_source = nullptr;
+    defaults_source_embedded = false;
+
+#if AP_PARAM_NAME_INDEX_ENABLED
+    // the name index is not used before load_all(), but a large
+    // defaults file is worth building it for
+    _name_index_allowed = true;
+#endif
+}
 
-// increments num_defaults for each default found in filename
-bool AP_Param::count_defaults_in_file(const char *filename, uint16_t &num_defaults)
+void AP_Param::defaults_parse_end(void)
 {
-    // try opening the file both in the posix filesystem and using AP::FS
-    int file_apfs = AP::FS().open(filename, O_RDONLY, true);
-    if (file_apfs == -1) {
-        return false;
-    }
-    char line[100];
+#if AP_PARAM_NAME_INDEX_ENABLED
+    // mark the index out of date, so it is built again once pointer
+    // parameters have been allocated
+    WITH_SEMAPHORE(_name_index_sem);
+    _name_index_marker = _count_marker - 1;
+#endif
+}
 
-    /*
-      work out how many parameter default structures to allocate
-     */
-    while (AP::FS().fgets(line, sizeof(line)-1, file_apfs)) {
-        char *pname;
-        float value;
-        bool read_only;
-        if (!parse_param_line(line, &pname, value, read_only)) {
-            continue;
+/*
+  parse a defaults line onto the end of param_overrides, growing it as
+  needed. capacity is the allocated length of param_overrides
+ */
+void AP_Param::defaults_add_line(char *line, uint16_t &capacity)
+{
+    char *pname;
+    float value;
+    bool read_only;
+    if (!parse_param_line(line, &pname, value, read_only)) {
+        return;
+    }
+    if (num_param_overrides == capacity) {
+        const uint16_t new_capacity = MAX(capacity*2, 32);
+        param_override *new_overrides = new param_override[new_capacity];
+        if (new_overrides == nullptr) {
+            AP_HAL::panic("AP_Param: Failed to allocate overrides");
+        }
+        if (param_overrides != nullptr) {
+            memcpy(new_overrides, param_overrides, num_param_overrides*sizeof(param_overrides[0]));
+        }
+        delete[] param_overrides;
+        param_overrides = new_overrides;
+        capacity = new_capacity;
+    }
+    auto &ov = param_overrides[num_param_overrides];
+    enum ap_var_type var_type = AP_PARAM_NONE;
+    ov.object_ptr = find(pname, &var_type);
+    ov.value = value;
+    ov.read_only = read_only;
+    ov.type = var_type;
+    if (ov.object_ptr == nullptr) {
+        // keep the name to look up again on the next pass
+        defaults_unresolved *u = new defaults_unresolved;
+        if (u == nullptr) {
+            return;
         }
+        u->idx = num_param_overrides;
+        strncpy_noterm(u->name, pname, AP_MAX_NAME_SIZE);
+        u->name[AP_MAX_NAME_SIZE] = 0;
+        u->next = defaults_unresolved_list;
+        defaults_unresolved_list = u;
+    }
+    num_param_overrides++;
+}
+
+/*
+  set the parameters not configured in storage to the parsed defaults,
+  first looking up any names not found before
+ */
+void AP_Param::defaults_apply(bool last_pass)
+{
+    for (defaults_unresolved **u = &defaults_unresolved_list; *u != nullptr; ) {
+        auto &ov = param_overrides[(*u)->idx];
         enum ap_var_type var_type;
-        if (!find(pname, &var_type)) {
+        ov.object_ptr = find((*u)->name, &var_type);
+        if (ov.object_ptr == nullptr) {
+            if (last_pass) {
+#if ENABLE_DEBUG
+                ::printf("Ignored unknown param %s in defaults\n", (*u)->name);
+                hal.console->printf("Ignored unknown param %s in defaults\n", (*u)->name);
+#endif
+            }
+            u = &(*u)->next;
             continue;
         }
-        num_defaults++;
+        ov.type = var_type;
+        defaults_unresolved *found = *u;
+        *u = found->next;
+        delete found;
     }
-    AP::FS().close(file_apfs);
 
-    return true;
+    num_read_only = 0;
+    for (uint16_t i=0; i<num_param_overrides; i++) {
+        const auto &ov = param_overrides[i];
+        if (ov.object_ptr == nullptr) {
+            continue;
+        }
+        if (ov.read_only) {
+            num_read_only++;
+        }
+#if AP_PARAM_MAX_EMBEDDED_PARAM > 0 && AP_PARAM_DEFAULTS_ENABLED
+        if (defaults_source_embedded) {
+            add_default(ov.object_ptr, ov.value, embedded_default_list);
+        }
+#endif
+        if (!ov.object_ptr->configured_in_storage()) {
+            ov.object_ptr->set_float(ov.value, (enum ap_var_type)ov.type);
+        }
+    }
 }
 
-bool AP_Param::read_param_defaults_file(const char *filename, bool last_pass)
+#if HAVE_FILESYSTEM_SUPPORT
+
+// parse the defaults in filename onto the end of param_overrides
+bool AP_Param::read_param_defaults_file(const char *filename, uint16_t &capacity)
 {
     // try opening the file both in the posix filesystem and using AP::FS
     int file_apfs = AP::FS().open(filename, O_RDONLY, true);
     if (file_apfs == -1) {
-        AP_HAL::panic("AP_Param: Failed to re-open defaults file");
         return false;
     }
 
-    uint16_t idx = 0;
     char line[100];
     while (AP::FS().fgets(line, sizeof(line)-1, file_apfs)) {
-        char *pname;
-        float value;
-        bool read_only;
-        if (!parse_param_line(line, &pname, value, read_only)) {
-            continue;
-        }
-        enum ap_var_type var_type;
-        AP_Param *vp = find(pname, &var_type);
-        if (!vp) {
-            if (last_pass) {
-#if ENABLE_DEBUG
-                ::printf("Ignored unknown param %s in defaults file %s\n",
-                         pname, filename);
-                hal.console->printf(
-                         "Ignored unknown param %s in defaults file %s\n",
-                         pname, filename);
-#endif
-            }
-            continue;
-        }
-        param_overrides[idx].object_ptr = vp;
-        param_overrides[idx].value = value;
-        param_overrides[idx].read_only = read_only;
-        if (read_only) {
-            num_read_only++;
-        }
-        idx++;
-        if (!vp->configured_in_storage()) {
-            vp->set_float(value, var_type);
-        }
+        defaults_add_line(line, capacity);
     }
     AP::FS().close(file_apfs);
 
@@ -2227,53 +2748,35 @@ bool AP_Param::load_defaults_file(const char *filename, bool last_pass)
         return false;
     }
 
-    char *mutable_filename = strdup(filename);
-    if (mutable_filename == nullptr) {
-        AP_HAL::panic("AP_Param: Failed to allocate mutable string");
-    }
-
-    uint16_t num_defaults = 0;
-    char *saveptr = nullptr;
-    for (char *pname = strtok_r(mutable_filename, ",", &saveptr);
-         pname != nullptr;
-         pname = strtok_r(nullptr, ",", &saveptr)) {
-        if (!count_defaults_in_file(pname, num_defaults)) {
-            free(mutable_filename);
-            return false;
+    if (defaults_source == nullptr || strcmp(defaults_source, filename) != 0) {
+        char *mutable_filename = strdup(filename);
+        if (mutable_filename == nullptr) {
+            AP_HAL::panic("AP_Param: Failed to allocate mutable string");
         }
-    }
-    free(mutable_filename);
-
-    delete[] param_overrides;
-    num_param_overrides = 0;
-    num_read_only = 0;
-
-    param_overrides = new param_override[num_defaults];
-    if (param_overrides == nullptr) {
-        AP_HAL::panic("AP_Param: Failed to allocate overrides");
-        return false;
-    }
-
-    if (num_defaults == 0) {
-        return true;
-    }
 
-    saveptr = nullptr;
-    mutable_filename = strdup(filename);
-    if (mutable_filename == nullptr) {
-        AP_HAL::panic("AP_Param: Failed to allocate mutable string");
-    }
-    for (char *pname = strtok_r(mutable_filename, ",", &saveptr);
-         pname != nullptr;
-         pname = strtok_r(nullptr, ",", &saveptr)) {
-        if (!read_param_defaults_file(pname, last_pass)) {
-            free(mutable_filename);
+        defaults_parse_start();
+        uint16_t capacity = 0;
+        char *saveptr = nullptr;
+        bool ok = true;
+        for (char *pname = strtok_r(mutable_filename, ",", &saveptr);
+             pname != nullptr && ok;
+             pname = strtok_r(nullptr, ",", &saveptr)) {
+            ok = read_param_defaults_file(pname, capacity);
+        }
+        free(mutable_filename);
+        defaults_parse_end();
+        if (!ok) {
+            // discard the files that were parsed
+            defaults_parse_start();
+            defaults_parse_end();
             return false;
         }
+
+        // if this fails the files are parsed again next time
+        defaults_source = strdup(filename);
     }
-    free(mutable_filename);
 
-    num_param_overrides = num_defaults;
+    defaults_apply(last_pass);
 
     return true;
 }
@@ -2281,53 +2784,6 @@ bool AP_Param::load_defaults_file(const char *filename, bool last_pass)
 #endif // HAVE_FILESYSTEM_SUPPORT
 
 #if AP_PARAM_MAX_EMBEDDED_PARAM > 0
-/*
-  count the number of embedded parameter defaults
- */
-bool AP_Param::count_embedded_param_defaults(uint16_t &count)
-{
-    const volatile char *ptr = param_defaults_data.data;
-    int32_t length = param_defaults_data.length;
-    count = 0;
-    
-    while (length>0) {
-        char line[100];
-        char *pname;
-        float value;
-        bool read_only;
-        uint16_t i;
-        uint16_t n = length;
-        for (i=0;i<n;i++) {
-            if (ptr[i] == '\n') {
-                break;
-            }
-        }
-
-        uint16_t linelen = MIN(i,sizeof(line)-1);
-        memcpy(line, (void *)ptr, linelen);
-        line[linelen] = 0;
-
-        length -= i+1;
-        ptr += i+1;
-        
-        if (line[0] == '#' || line[0] == 0) {
-            continue;
-        }
-
-        if (!parse_param_line(line, &pname, value, read_only)) {
-            continue;
-        }
-
-        enum ap_var_type var_type;
-        if (!find(pname, &var_type)) {
-            continue;
-        }
-
-        count++;
-    }
-    return true;
-}
-
 /*
  * load a default set of parameters from a embedded parameter region
  * @last_pass: if this is the last pass on defaults - unknown parameters are
@@ -2335,82 +2791,40 @@ bool AP_Param::count_embedded_param_defaults(uint16_t &count)
  */
 void AP_Param::load_embedded_param_defaults(bool last_pass)
 {
-    delete[] param_overrides;
-    param_overrides = nullptr;
-    num_param_overrides = 0;
-    num_read_only = 0;
-
-    uint16_t num_defaults = 0;
-    if (!count_embedded_param_defaults(num_defaults)) {
-        return;
-    }
-
-    param_overrides = new param_override[num_defaults];
-    if (param_overrides == nullptr) {
-        AP_HAL::panic("AP_Param: Failed to allocate overrides");
-        return;
-    }
-
-    const volatile char *ptr = param_defaults_data.data;
-    int32_t length = param_defaults_data.length;
-    uint16_t idx = 0;
-    
-    while (idx < num_defaults && length > 0) {
-        char line[100];
-        char *pname;
-        float value;
-        bool read_only;
-        uint16_t i;
-        uint16_t n = length;
-        for (i=0;i<n;i++) {
-            if (ptr[i] == '\n') {
-                break;
+    if (!defaults_source_embedded) {
+        defaults_parse_start();
+
+        const volatile char *ptr = param_defaults_data.data;
+        int32_t length = param_defaults_data.length;
+        uint16_t capacity = 0;
+        while (length > 0) {
+            char line[100];
+            uint16_t i;
+            uint16_t n = length;
+            for (i=0;i<n;i++) {
+                if (ptr[i] == '\n') {
+                    break;
+                }
             }
-        }
 
-        uint16_t linelen = MIN(i,sizeof(line)-1);
-        memcpy(line, (void *)ptr, linelen);
-        line[linelen] = 0;
+            uint16_t linelen = MIN(i,sizeof(line)-1);
+            memcpy(line, (void *)ptr, linelen);
+            line[linelen] = 0;
 
-        length -= i+1;
-        ptr += i+1;
+            length -= i+1;
+            ptr += i+1;
 
-        if (line[0] == '#' || line[0] == 0) {
-            continue;
-        }
-        
-        if (!parse_param_line(line, &pname, value, read_only)) {
-            continue;
-        }
-        enum ap_var_type var_type;
-        AP_Param *vp = find(pname, &var_type);
-        if (!vp) {
-            if (last_pass) {
-#if ENABLE_DEBUG
-                ::printf("Ignored unknown param %s from embedded region (offset=%u)\n",
-                         pname, unsigned(ptr - param_defaults_data.data));
-                hal.console->printf(
-                         "Ignored unknown param %s from embedded region (offset=%u)\n",
-                         pname, unsigned(ptr - param_defaults_data.data));
-#endif
+            if (line[0] == '#' || line[0] == 0) {
+                continue;
             }
-            continue;
-        }
-        param_overrides[idx].object_ptr = vp;
-        param_overrides[idx].value = value;
-        param_overrides[idx].read_only = read_only;
-        if (read_only) {
-            num_read_only++;
-        }
-        idx++;
-#if AP_PARAM_DEFAULTS_ENABLED
-        add_default(vp, value, embedded_default_list);
-#endif
-        if (!vp->configured_in_storage()) {
-            vp->set_float(value, var_type);
+            defaults_add_line(line, capacity);
         }
+
+        defaults_parse_end();
+        defaults_source_embedded = true;
     }
-    num_param_overrides = num_defaults;
+
+    defaults_apply(last_pass);
 }
 #endif // AP_PARAM_MAX_EMBEDDED_PARAM > 0
 
@@ -2500,6 +2914,63 @@ uint16_t AP_Param::count_parameters(void)
     return _parameter_count;
 }
 
+#if AP_PARAM_SCALAR_TABLE_ENABLED
+/*
+  get the token of the scalar at index idx, if the scalar table is up
+  to date. This doesn't wait for the table, so a caller in the main
+  thread isn't held up by a rebuild
+ */
+bool AP_Param::scalar_table_token(uint16_t idx, ParamToken &token)
+{
+    if (!_scalar_table_sem.take_nonblocking()) {
+        return false;
+    }
+    const bool ret = _scalar_table != nullptr &&
+        _scalar_table_marker == _count_marker &&
+        idx < _scalar_table_count;
+    if (ret) {
+        token = _scalar_table[idx];
+    }
+    _scalar_table_sem.give();
+    return ret;
+}
+#endif
+
+void AP_Param::update_scalar_table(void)
+{
+#if AP_PARAM_SCALAR_TABLE_ENABLED
+    if (_scalar_table != nullptr && _scalar_table_marker == _count_marker) {
+        return;
+    }
+    const uint16_t marker = _count_marker;
+    const uint16_t count = count_parameters();
+
+    WITH_SEMAPHORE(_scalar_table_sem);
+    if (count > _scalar_table_size) {
+        delete[] _scalar_table;
+        // leave room for scripts to add a few parameters
+        const uint16_t size = count + 32;
+        _scalar_table = new ParamToken[size];
+        if (_scalar_table == nullptr) {
+            _scalar_table_size = 0;
+            return;
+        }
+        _scalar_table_size = size;
+    }
+    ParamToken token {};
+    uint16_t n = 0;
+    for (AP_Param *ap = first(&token, nullptr);
+         ap != nullptr && n < _scalar_table_size;
+         ap = next_scalar(&token, nullptr)) {
+        _scalar_table[n++] = token;
+    }
+    _scalar_table_count = n;
+    // if the list changed while we walked it we will be stale, and
+    // rebuilt on the next call
+    _scalar_table_marker = marker;
+#endif
+}
+
 /*
   invalidate parameter count cache
  */
@@ -61,6 +61,26 @@
 #endif
 #define AP_PARAM_DYNAMIC_KEY_BASE 300
 
+// hash index for finding parameters by name
+#ifndef AP_PARAM_NAME_INDEX_ENABLED
+#define AP_PARAM_NAME_INDEX_ENABLED (HAL_MEM_CLASS >= HAL_MEM_CLASS_500)
+#endif
+
+// flat table of the tokens of all scalars, for walking and indexing
+// the parameter list without searching var_info
+#ifndef AP_PARAM_SCALAR_TABLE_ENABLED
+#define AP_PARAM_SCALAR_TABLE_ENABLED (HAL_MEM_CLASS >= HAL_MEM_CLASS_500)
+#endif
+
+// number of recently saved parameters remembered for delta downloads
+#ifndef AP_PARAM_CHANGE_HISTORY
+#if HAL_MEM_CLASS >= HAL_MEM_CLASS_500
+#define AP_PARAM_CHANGE_HISTORY 32
+#else
+#define AP_PARAM_CHANGE_HISTORY 8
+#endif
+#endif
+
 /*
   flags for variables in var_info and group tables
  */
@@ -417,6 +437,35 @@ public:
     // returns storage space :
     static uint16_t storage_size() { return _storage.size(); }
 
+    // returns time taken by the last load_all() in microseconds
+    static uint32_t load_all_time_us() { return _load_all_us; }
+
+    // returns a hash of the parameter values held in storage. This
+    // changes whenever a saved parameter changes value
+    static uint32_t storage_hash(void) { return _storage_hash; }
+
+#if AP_PARAM_CHANGE_HISTORY > 0
+    // a recently saved parameter
+    struct ParamChange {
+        const AP_Param *param;
+        uint32_t generation;
+        uint8_t size;
+    };
+
+    // returns the save generation, incremented each time a parameter
+    // is saved. It starts at a random value on each boot
+    static uint32_t generation(void) { return _generation; }
+
+    /*
+      get the parameters saved after generation since, along with the
+      current generation and storage hash. Returns false if changes
+      after that generation are no longer all in the change history,
+      in which case the caller needs the full parameter list
+     */
+    static bool changed_since(uint32_t since, ParamChange changes[AP_PARAM_CHANGE_HISTORY],
+                              uint8_t &num_changes, uint32_t &generation, uint32_t &hash);
+#endif
+
     /// reoad the hal.util defaults file. Called after pointer parameters have been allocated
     ///
     static void reload_defaults_file(bool last_pass);
@@ -498,6 +547,11 @@ public:
     /// as needed
     static AP_Param *       next_scalar(ParamToken *token, enum ap_var_type *ptype, float *default_val = nullptr);
 
+    /// Returns the scalar at index idx, where token is for the scalar
+    /// at idx-1. Equivalent to next_scalar() but a table lookup when
+    /// the scalar table is up to date
+    static AP_Param *       next_scalar_indexed(ParamToken *token, uint16_t idx, enum ap_var_type *ptype);
+
     /// get the size of a type in bytes
     static uint8_t				type_size(enum ap_var_type type);
 
@@ -522,6 +576,10 @@ public:
     // invalidate parameter count
     static void invalidate_count(void);
 
+    // rebuild the scalar table if the parameter list has changed. It
+    // walks the whole tree so should be called from the IO thread
+    static void update_scalar_table(void);
+
     static void set_hide_disabled_groups(bool value) { _hide_disabled_groups = value; }
 
     // set frame type flags. Used to unhide frame specific parameters
@@ -582,6 +640,7 @@ private:
     static_assert(sizeof(struct EEPROM_header) == 4, "Bad EEPROM_header size!");
 
     static uint16_t sentinal_offset;
+    static uint32_t _load_all_us;
 
 /* This header is prepended to a variable stored in EEPROM.
  *  The meaning is as follows:
@@ -672,6 +731,10 @@ private:
     static const struct Info *  find_by_header(
                                     struct Param_header phdr,
                                     void **ptr);
+    static const struct Info *  find_by_header_vindex(
+                                    struct Param_header phdr,
+                                    void **ptr,
+                                    uint16_t vindex);
     void                        add_vector3f_suffix(
                                     char *buffer,
                                     size_t buffer_size,
@@ -682,6 +745,19 @@ private:
                                     ptrdiff_t group_offset,
                                     const struct GroupInfo *group_info,
                                     enum ap_var_type *ptype);
+    static AP_Param *           find_by_token(
+                                    const ParamToken &token,
+                                    enum ap_var_type *ptype,
+                                    uint16_t *flags);
+    static AP_Param *           find_by_token_group(
+                                    const ParamToken &token,
+                                    const struct GroupInfo *group_info,
+                                    ptrdiff_t base,
+                                    uint32_t group_base,
+                                    uint8_t group_shift,
+                                    ptrdiff_t group_offset,
+                                    enum ap_var_type *ptype,
+                                    uint16_t *flags);
     static void                 write_sentinal(uint16_t ofs);
     static uint16_t             get_key(const Param_header &phdr);
     static void                 set_key(Param_header &phdr, uint16_t key);
@@ -713,15 +789,25 @@ private:
     /*
       load a parameter defaults file. This happens as part of load_all()
      */
-    static bool count_defaults_in_file(const char *filename, uint16_t &num_defaults);
-    static bool read_param_defaults_file(const char *filename, bool last_pass);
+    static bool read_param_defaults_file(const char *filename, uint16_t &capacity);
 
     /*
       load defaults from embedded parameters
      */
-    static bool count_embedded_param_defaults(uint16_t &count);
     static void load_embedded_param_defaults(bool last_pass);
 
+    /*
+      defaults are parsed once into param_overrides, keeping the names
+      not found yet (pointer parameters not yet allocated) in
+      defaults_unresolved_list. Loading the same defaults again, as on
+      the last pass, applies param_overrides in one pass with no
+      parsing, looking up only those names
+     */
+    static void defaults_parse_start(void);
+    static void defaults_parse_end(void);
+    static void defaults_add_line(char *line, uint16_t &capacity);
+    static void defaults_apply(bool last_pass);
+
     // return true if the parameter is configured in the defaults file
     bool configured_in_defaults_file(bool &read_only) const;
 
@@ -740,6 +826,58 @@ private:
     static HAL_Semaphore        _count_sem;
     static const struct Info *  _var_info;
 
+#if AP_PARAM_NAME_INDEX_ENABLED
+    /*
+      open addressed hash table of the tokens of all scalar
+      parameters, keyed by name. It is built on the first lookup after
+      load_all() and rebuilt when the parameter count is invalidated
+     */
+    static uint32_t *           _name_index;
+    static uint16_t             _name_index_size;
+    static uint16_t             _name_index_marker;
+    static bool                 _name_index_allowed;
+    static HAL_Semaphore        _name_index_sem;
+    static uint32_t             name_hash(const char *name);
+    static bool                 name_index_update(void);
+    static AP_Param *           find_in_name_index(const char *name, enum ap_var_type *ptype,
+                                                   uint16_t *flags, ParamToken *token);
+#endif
+
+#if AP_PARAM_SCALAR_TABLE_ENABLED
+    /*
+      tokens of all scalars in the order given by first() and
+      next_scalar(), so the parameter list can be walked and indexed
+      without searching var_info. Current while _scalar_table_marker
+      equals _count_marker
+     */
+    static ParamToken *         _scalar_table;
+    static uint16_t             _scalar_table_count;
+    static uint16_t             _scalar_table_size;
+    static uint16_t             _scalar_table_marker;
+    static HAL_Semaphore        _scalar_table_sem;
+    static bool                 scalar_table_token(uint16_t idx, ParamToken &token);
+#endif
+
+    /*
+      hash of the stored parameter values and the history of recent
+      saves, for GCS delta parameter downloads
+     */
+    static uint32_t             _storage_hash;
+    static HAL_Semaphore        _change_sem;
+    static uint32_t             storage_entry_hash(const Param_header &phdr, const void *value);
+    static void                 update_storage_hash(uint32_t old_hash, uint32_t new_hash);
+
+#if AP_PARAM_CHANGE_HISTORY > 0
+    // ring of the most recent saves, one entry per parameter
+    static ParamChange          _changes[AP_PARAM_CHANGE_HISTORY];
+    static uint8_t              _num_changes;
+    static uint32_t             _generation;
+    // generation of the newest change dropped from the ring
+    static uint32_t             _generation_dropped;
+    static bool                 _generation_init;
+    static void                 record_change(const AP_Param *ap, uint8_t size);
+#endif
+
 #if AP_PARAM_DYNAMIC_ENABLED
     // allow for a dynamically allocated var table
     static uint16_t             _num_vars_base;
@@ -759,14 +897,24 @@ private:
       list of overridden values from load_defaults_file()
     */
     struct param_override {
-        const AP_Param *object_ptr;
+        AP_Param *object_ptr;   // nullptr while the name is in defaults_unresolved_list
         float value;
         bool read_only; // param is marked @READONLY
+        uint8_t type;   // ap_var_type of object_ptr
     };
     static struct param_override *param_overrides;
     static uint16_t num_param_overrides;
     static uint16_t num_read_only;
 
+    struct defaults_unresolved {
+        uint16_t idx;   // index into param_overrides
+        char name[AP_MAX_NAME_SIZE+1];
+        defaults_unresolved *next;
+    };
+    static defaults_unresolved *defaults_unresolved_list;
+    static char *defaults_source;           // file list param_overrides was parsed from
+    static bool defaults_source_embedded;   // param_overrides was parsed from the embedded defaults
+
     // values filled into the EEPROM header
     static const uint8_t        k_EEPROM_magic0      = 0x50;
     static const uint8_t        k_EEPROM_magic1      = 0x41; ///< "AP"
@@ -27,17 +27,26 @@ AP_Proximity_Boundary_3D::AP_Proximity_Boundary_3D()
     init();
 }
 
-// initialise the boundary and sector_edge_vector array used for object avoidance
-//   should be called if the sector_middle_deg or _sector_width_deg arrays are changed
+// initialise the boundary and sector edge directions used for object avoidance
 void AP_Proximity_Boundary_3D::init()
 {
     for (uint8_t layer=0; layer < PROXIMITY_NUM_LAYERS; layer++) {
-        const float pitch = ((float)_pitch_middle_deg[layer]);
-        for (uint8_t sector=0; sector < PROXIMITY_NUM_SECTORS; sector++) {
-            const float angle_rad = ((float)_sector_middle_deg[sector]+(PROXIMITY_SECTOR_WIDTH_DEG/2.0f));
-            _sector_edge_vector[layer][sector].offset_bearing(angle_rad, pitch, 100.0f);
-            _boundary_points[layer][sector] = _sector_edge_vector[layer][sector] * PROXIMITY_BOUNDARY_DIST_DEFAULT;
+        const float pitch_rad = radians(get_layer_middle_deg(layer));
+        _layer_pitch_cos[layer] = cosf(pitch_rad);
+        _layer_pitch_sin[layer] = sinf(pitch_rad);
+        for (uint8_t octant=0; octant < PROXIMITY_MAX_DIRECTION; octant++) {
+            _octant_min_sector[layer][octant] = PYRAMID_NONE;
         }
+        _layer_min_sector[layer] = PYRAMID_NONE;
+    }
+    for (uint8_t sector=0; sector < PROXIMITY_NUM_SECTORS; sector++) {
+        const float angle_rad = radians(get_sector_middle_deg(sector) + (PROXIMITY_SECTOR_WIDTH_DEG/2.0f));
+        _edge_yaw_cos[sector] = cosf(angle_rad);
+        _edge_yaw_sin[sector] = sinf(angle_rad);
+    }
+    for (uint16_t i=0; i < PROXIMITY_NUM_FACES; i++) {
+        _face[i] = {};
+        _face[i].boundary_distance = PROXIMITY_BOUNDARY_DIST_DEFAULT;
     }
 }
 
@@ -46,9 +55,9 @@ void AP_Proximity_Boundary_3D::init()
 // yaw is the horizontal body-frame angle (in degrees) to the obstacle (0=directly ahead of the vehicle, 90 is to the right of the vehicle)
 AP_Proximity_Boundary_3D::Face AP_Proximity_Boundary_3D::get_face(float pitch, float yaw) const
 {
-    const uint8_t sector = wrap_360(yaw + (PROXIMITY_SECTOR_WIDTH_DEG * 0.5f)) / 45.0f;
-    const float pitch_limited = constrain_float(pitch, -75.0f, 74.9f);
-    const uint8_t layer = (pitch_limited + 75.0f)/PROXIMITY_PITCH_WIDTH_DEG;
+    const uint8_t sector = MIN(wrap_360(yaw + (PROXIMITY_SECTOR_WIDTH_DEG * 0.5f)) / PROXIMITY_SECTOR_WIDTH_DEG, PROXIMITY_NUM_SECTORS - 1);
+    const float pitch_limited = constrain_float(pitch, -PROXIMITY_PITCH_MAX_DEG, PROXIMITY_PITCH_MAX_DEG);
+    const uint8_t layer = MIN((pitch_limited + PROXIMITY_PITCH_MAX_DEG) / PROXIMITY_PITCH_WIDTH_DEG, PROXIMITY_NUM_LAYERS - 1);
     return Face{layer, sector};
 }
 
@@ -63,36 +72,31 @@ void AP_Proximity_Boundary_3D::set_face_attributes(const Face &face, float pitch
         return;
     }
 
+    FaceState &state = _face[face.index()];
+
     // ignore update if another instance has provided a shorter distance within the last 0.2 seconds
-    if ((prx_instance != _prx_instance[face.layer][face.sector]) && _distance_valid[face.layer][face.sector] && (_filtered_distance[face.layer][face.sector].get() < distance)) {
+    if ((prx_instance != state.prx_instance) && state.valid && (state.filtered_distance < distance)) {
         // check if recent
         const uint32_t now_ms = AP_HAL::millis();
-        if (now_ms - _last_update_ms[face.layer][face.sector] < PROXIMITY_FACE_RESET_MS) {
+        if (now_ms - state.last_update_ms < PROXIMITY_FACE_RESET_MS) {
             return;
         }
     }
 
-    _angle[face.layer][face.sector] = angle;
-    _pitch[face.layer][face.sector] = pitch;
-    _distance[face.layer][face.sector] = distance;
-    _distance_valid[face.layer][face.sector] = true;
-    _prx_instance[face.layer][face.sector] = prx_instance;
+    state.angle = angle;
+    state.pitch = pitch;
+    state.distance = distance;
+    state.valid = true;
+    state.prx_instance = prx_instance;
 
     // apply filter
     set_filtered_distance(face, distance);
 
     // update boundary used for simple avoidance
     update_boundary(face);
-}
 
-// apply a new cutoff_freq to low-pass filter
-void AP_Proximity_Boundary_3D::apply_filter_freq(float cutoff_freq)
-{
-    for (uint8_t layer=0; layer < PROXIMITY_NUM_LAYERS; layer++) {
-        for (uint8_t sector=0; sector < PROXIMITY_NUM_SECTORS; sector++) {
-            _filtered_distance[layer][sector].set_cutoff_frequency(cutoff_freq);
-        }
-    }
+    // update closest object search
+    update_pyramid(face);
 }
 
 // Apply low pass filter on the raw distance
@@ -101,20 +105,25 @@ void AP_Proximity_Boundary_3D::set_filtered_distance(const Face &face, float dis
     if (!face.valid()) {
         return;
     }
-    if (!is_equal(_filtered_distance[face.layer][face.sector].get_cutoff_freq(), _filter_freq)) {
-        // cutoff freq has changed
-        apply_filter_freq(_filter_freq);
-    }
 
+    FaceState &state = _face[face.index()];
     const uint32_t now_ms = AP_HAL::millis();
-    const uint32_t dt = now_ms - _last_update_ms[face.layer][face.sector];
-    if (dt < PROXIMITY_FILT_RESET_TIME) {
-        _filtered_distance[face.layer][face.sector].apply(distance, dt* 0.001f);
+    const uint32_t dt = now_ms - state.last_update_ms;
+    if ((dt < PROXIMITY_FILT_RESET_TIME) && state.filter_initialised) {
+        state.filtered_distance += (distance - state.filtered_distance) * calc_lowpass_alpha_dt(dt * 0.001f, _filter_freq);
     } else {
         // reset filter since last distance was passed a long time back
-        _filtered_distance[face.layer][face.sector].reset(distance);
+        state.filtered_distance = distance;
+        state.filter_initialised = true;
     }
-    _last_update_ms[face.layer][face.sector] = now_ms;
+    state.last_update_ms = now_ms;
+}
+
+// body frame vector (in cm) to the boundary point on the clockwise edge of a face
+Vector3f AP_Proximity_Boundary_3D::get_boundary_point(uint8_t layer, uint8_t sector) const
+{
+    const Vector3f edge_vector{_layer_pitch_cos[layer] * _edge_yaw_cos[sector], _layer_pitch_cos[layer] * _edge_yaw_sin[sector], _layer_pitch_sin[layer]};
+    return edge_vector * 100.0f * _face[Face{layer, sector}.index()].boundary_distance;
 }
 
 // update boundary points used for object avoidance based on a single sector and pitch distance changing
@@ -129,55 +138,107 @@ void AP_Proximity_Boundary_3D::update_boundary(const Face &face)
 
     const uint8_t layer = face.layer;
     const uint8_t sector = face.sector;
+    const FaceState &this_face = _face[face.index()];
 
     // find adjacent sector (clockwise)
     const uint8_t next_sector = get_next_sector(sector);
+    FaceState &next_face = _face[Face{layer, next_sector}.index()];
 
     // boundary point lies on the line between the two sectors at the shorter distance found in the two sectors
     float shortest_distance = PROXIMITY_BOUNDARY_DIST_DEFAULT;
-    if (_distance_valid[layer][sector] && _distance_valid[layer][next_sector]) {
-        shortest_distance = MIN(_filtered_distance[layer][sector].get(), _filtered_distance[layer][next_sector].get());
-    } else if (_distance_valid[layer][sector]) {
-        shortest_distance = _filtered_distance[layer][sector].get();
-    } else if (_distance_valid[layer][next_sector]) {
-        shortest_distance = _filtered_distance[layer][next_sector].get();
+    if (this_face.valid && next_face.valid) {
+        shortest_distance = MIN(this_face.filtered_distance, next_face.filtered_distance);
+    } else if (this_face.valid) {
+        shortest_distance = this_face.filtered_distance;
+    } else if (next_face.valid) {
+        shortest_distance = next_face.filtered_distance;
     }
     if (shortest_distance < PROXIMITY_BOUNDARY_DIST_MIN) {
         shortest_distance = PROXIMITY_BOUNDARY_DIST_MIN;
     }
-    _boundary_points[layer][sector] = _sector_edge_vector[layer][sector] * shortest_distance;
+    _face[face.index()].boundary_distance = shortest_distance;
 
     // if the next sector (clockwise) has an invalid distance, set boundary to create a cup like boundary
-    if (!_distance_valid[layer][next_sector]) {
-        _boundary_points[layer][next_sector] = _sector_edge_vector[layer][next_sector] * shortest_distance;
+    if (!next_face.valid) {
+        next_face.boundary_distance = shortest_distance;
     }
 
     // repeat for edge between sector and previous sector
     const uint8_t prev_sector = get_prev_sector(sector);
+    FaceState &prev_face = _face[Face{layer, prev_sector}.index()];
     shortest_distance = PROXIMITY_BOUNDARY_DIST_DEFAULT;
-    if (_distance_valid[layer][prev_sector] && _distance_valid[layer][sector]) {
-        shortest_distance = MIN(_filtered_distance[layer][prev_sector].get(), _filtered_distance[layer][sector].get());
-    } else if (_distance_valid[layer][prev_sector]) {
-        shortest_distance = _filtered_distance[layer][prev_sector].get();
-    } else if (_distance_valid[layer][sector]) {
-        shortest_distance = _filtered_distance[layer][sector].get();
+    if (prev_face.valid && this_face.valid) {
+        shortest_distance = MIN(prev_face.filtered_distance, this_face.filtered_distance);
+    } else if (prev_face.valid) {
+        shortest_distance = prev_face.filtered_distance;
+    } else if (this_face.valid) {
+        shortest_distance = this_face.filtered_distance;
     }
-    _boundary_points[layer][prev_sector] = _sector_edge_vector[layer][prev_sector] * shortest_distance;
+    prev_face.boundary_distance = shortest_distance;
 
     // if the sector counter-clockwise from the previous sector has an invalid distance, set boundary to create a cup-like boundary
-    const uint8_t prev_sector_ccw = get_prev_sector(prev_sector);
-    if (!_distance_valid[layer][prev_sector_ccw]) {
-        _boundary_points[layer][prev_sector_ccw] = _sector_edge_vector[layer][prev_sector_ccw] * shortest_distance;
+    FaceState &prev_face_ccw = _face[Face{layer, get_prev_sector(prev_sector)}.index()];
+    if (!prev_face_ccw.valid) {
+        prev_face_ccw.boundary_distance = shortest_distance;
+    }
+}
+
+// returns whichever of the two sectors in a layer has the shorter valid distance
+// either sector may be PYRAMID_NONE, the first sector is returned if the distances are equal
+uint8_t AP_Proximity_Boundary_3D::closer_sector(uint8_t layer, uint8_t sector_a, uint8_t sector_b) const
+{
+    if (sector_b == PYRAMID_NONE) {
+        return sector_a;
+    }
+    if (sector_a == PYRAMID_NONE) {
+        return sector_b;
+    }
+    if (_face[Face{layer, sector_b}.index()].distance < _face[Face{layer, sector_a}.index()].distance) {
+        return sector_b;
+    }
+    return sector_a;
+}
+
+// recalculate the min distance pyramid above a face after its distance or validity changed
+// only the face's octant is rescanned, then the 8 octants of the layer
+void AP_Proximity_Boundary_3D::update_pyramid(const Face &face)
+{
+    if (!face.valid()) {
+        return;
+    }
+
+    const uint8_t layer = face.layer;
+    const uint8_t octant = get_octant(face.sector);
+
+    // first sector of the octant, the octant is centred on its direction so may wrap around sector 0
+    uint8_t sector = (octant * SECTORS_PER_OCTANT + PROXIMITY_NUM_SECTORS - SECTORS_PER_OCTANT/2) % PROXIMITY_NUM_SECTORS;
+    uint8_t closest = PYRAMID_NONE;
+    for (uint8_t i=0; i < SECTORS_PER_OCTANT; i++) {
+        if (_face[Face{layer, sector}.index()].valid) {
+            closest = closer_sector(layer, closest, sector);
+        }
+        sector = get_next_sector(sector);
     }
+    _octant_min_sector[layer][octant] = closest;
+
+    closest = PYRAMID_NONE;
+    for (uint8_t i=0; i < PROXIMITY_MAX_DIRECTION; i++) {
+        closest = closer_sector(layer, closest, _octant_min_sector[layer][i]);
+    }
+    _layer_min_sector[layer] = closest;
 }
 
 // reset boundary.  marks all distances as invalid
 void AP_Proximity_Boundary_3D::reset()
 {
+    for (uint16_t i=0; i < PROXIMITY_NUM_FACES; i++) {
+        _face[i].valid = false;
+    }
     for (uint8_t layer=0; layer < PROXIMITY_NUM_LAYERS; layer++) {
-        for (uint8_t sector=0; sector < PROXIMITY_NUM_SECTORS; sector++) {
-            _distance_valid[layer][sector] = false;
+        for (uint8_t octant=0; octant < PROXIMITY_MAX_DIRECTION; octant++) {
+            _octant_min_sector[layer][octant] = PYRAMID_NONE;
         }
+        _layer_min_sector[layer] = PYRAMID_NONE;
     }
 }
 
@@ -190,23 +251,28 @@ void AP_Proximity_Boundary_3D::reset_face(const Face &face, uint8_t prx_instance
         return;
     }
 
+    FaceState &state = _face[face.index()];
+
     // return immediately if face already has no valid distance
-    if (!_distance_valid[face.layer][face.sector]) {
+    if (!state.valid) {
         return;
     }
 
     // ignore reset if another instance provided this face's distance within the last 0.2 seconds
-    if (prx_instance != _prx_instance[face.layer][face.sector]) {
+    if (prx_instance != state.prx_instance) {
         const uint32_t now_ms = AP_HAL::millis();
-        if (now_ms - _last_update_ms[face.layer][face.sector] < 200) {
+        if (now_ms - state.last_update_ms < 200) {
             return;
         }
     }
 
-    _distance_valid[face.layer][face.sector] = false;
+    state.valid = false;
 
     // update simple avoidance boundary
     update_boundary(face);
+
+    // update closest object search
+    update_pyramid(face);
 }
 
 // check if a face has valid distance even if it was updated a long time back
@@ -220,12 +286,19 @@ void AP_Proximity_Boundary_3D::check_face_timeout()
     _last_check_face_timeout_ms = now_ms;
 
     for (uint8_t layer=0; layer < PROXIMITY_NUM_LAYERS; layer++) {
+        if (_layer_min_sector[layer] == PYRAMID_NONE) {
+            // no valid faces on this layer
+            continue;
+        }
         for (uint8_t sector=0; sector < PROXIMITY_NUM_SECTORS; sector++) {
-            if (_distance_valid[layer][sector]) {
-                if ((now_ms - _last_update_ms[layer][sector]) > PROXIMITY_FACE_RESET_MS) {
+            const Face face{layer, sector};
+            FaceState &state = _face[face.index()];
+            if (state.valid) {
+                if ((now_ms - state.last_update_ms) > PROXIMITY_FACE_RESET_MS) {
                     // this face has a valid distance but wasn't updated for a long time, reset it
-                    _distance_valid[layer][sector] = false;
-                    update_boundary(AP_Proximity_Boundary_3D::Face{layer, sector});
+                    state.valid = false;
+                    update_boundary(face);
+                    update_pyramid(face);
                 }
             }
         }
@@ -238,8 +311,9 @@ bool AP_Proximity_Boundary_3D::get_distance(const Face &face, float &distance) c
     if (!face.valid()) {
         return false;
     }
-    if (_distance_valid[face.layer][face.sector]) {
-        distance = _distance[face.layer][face.sector];
+    const FaceState &state = _face[face.index()];
+    if (state.valid) {
+        distance = state.distance;
         return true;
     }
 
@@ -247,9 +321,9 @@ bool AP_Proximity_Boundary_3D::get_distance(const Face &face, float &distance) c
 }
 
 // get the total number of obstacles 
-uint8_t AP_Proximity_Boundary_3D::get_obstacle_count() const
+uint16_t AP_Proximity_Boundary_3D::get_obstacle_count() const
 {
-    return PROXIMITY_NUM_LAYERS * PROXIMITY_NUM_SECTORS;
+    return PROXIMITY_NUM_FACES;
 }
 
 // Converts obstacle_num passed from avoidance library into appropriate face of the boundary
@@ -257,18 +331,27 @@ uint8_t AP_Proximity_Boundary_3D::get_obstacle_count() const
 // "update_boundary" method manipulates two sectors ccw and one sector cw from any valid face.
 // Any boundary that does not fall into these manipulated faces are useless, and will be marked as false
 // The resultant is packed into a Boundary Location object and returned by reference as "face"
-bool AP_Proximity_Boundary_3D::convert_obstacle_num_to_face(uint8_t obstacle_num, Face& face) const
+bool AP_Proximity_Boundary_3D::convert_obstacle_num_to_face(uint16_t obstacle_num, Face& face) const
 {
+    if (obstacle_num >= PROXIMITY_NUM_FACES) {
+        return false;
+    }
+
     // obstacle num is just "flattened layers, and sectors"
     const uint8_t layer = obstacle_num / PROXIMITY_NUM_SECTORS;
     const uint8_t sector = obstacle_num % PROXIMITY_NUM_SECTORS;
     face.sector = sector;
     face.layer = layer;
 
+    // skip layers without any valid distance without checking each sector
+    if (_layer_min_sector[layer] == PYRAMID_NONE) {
+        return false;
+    }
+
     uint8_t valid_sector = sector;
     // check for 3 adjacent sectors
     for (uint8_t i=0; i < 3; i++) {
-        if (_distance_valid[layer][valid_sector]) {
+        if (_face[Face{layer, valid_sector}.index()].valid) {
             // update boundary has manipulated this face
             return true;
         }
@@ -284,7 +367,7 @@ bool AP_Proximity_Boundary_3D::convert_obstacle_num_to_face(uint8_t obstacle_num
 // Then returns the closest point on this line from vehicle, in body-frame. 
 // Used by GPS based Simple Avoidance  
 // False is returned if the obstacle_num provided does not produce a valid obstacle 
-bool AP_Proximity_Boundary_3D::get_obstacle(uint8_t obstacle_num, Vector3f& vec_to_obstacle) const
+bool AP_Proximity_Boundary_3D::get_obstacle(uint16_t obstacle_num, Vector3f& vec_to_obstacle) const
 {
     Face face;
     if (!convert_obstacle_num_to_face(obstacle_num, face)) {
@@ -294,8 +377,8 @@ bool AP_Proximity_Boundary_3D::get_obstacle(uint8_t obstacle_num, Vector3f& vec_
     const uint8_t sector_end = face.sector;
     const uint8_t sector_start = get_next_sector(face.sector);
     
-    const Vector3f start = _boundary_points[face.layer][sector_start];
-    const Vector3f end = _boundary_points[face.layer][sector_end];
+    const Vector3f start = get_boundary_point(face.layer, sector_start);
+    const Vector3f end = get_boundary_point(face.layer, sector_end);
     vec_to_obstacle = Vector3f::point_on_line_closest_to_other_point(start, end, Vector3f{});
     return true;
 }
@@ -308,7 +391,7 @@ bool AP_Proximity_Boundary_3D::get_obstacle(uint8_t obstacle_num, Vector3f& vec_
 // This helps us know if the passed line segment was in the direction of the boundary, or going in a different direction.
 // Used by GPS based Simple Avoidance  - for "brake mode"
 // False is returned if the obstacle_num provided does not produce a valid obstacle
-bool AP_Proximity_Boundary_3D::closest_point_from_segment_to_obstacle(uint8_t obstacle_num, const Vector3f& seg_start, const Vector3f& seg_end, Vector3f& closest_point) const
+bool AP_Proximity_Boundary_3D::closest_point_from_segment_to_obstacle(uint16_t obstacle_num, const Vector3f& seg_start, const Vector3f& seg_end, Vector3f& closest_point) const
 {
     Face face;
     if (!convert_obstacle_num_to_face(obstacle_num, face)) {
@@ -318,8 +401,8 @@ bool AP_Proximity_Boundary_3D::closest_point_from_segment_to_obstacle(uint8_t ob
 
     const uint8_t sector_end = face.sector;
     const uint8_t sector_start = get_next_sector(face.sector);
-    const Vector3f start = _boundary_points[face.layer][sector_start];
-    const Vector3f end = _boundary_points[face.layer][sector_end];
+    const Vector3f start = get_boundary_point(face.layer, sector_start);
+    const Vector3f end = get_boundary_point(face.layer, sector_end);
 
     // closest point between passed line segment and boundary
     Vector3f::segment_to_segment_closest_point(seg_start, seg_end, start, end, closest_point);
@@ -335,30 +418,29 @@ bool AP_Proximity_Boundary_3D::closest_point_from_segment_to_obstacle(uint8_t ob
 //   returns true on success, false if no valid readings
 bool AP_Proximity_Boundary_3D::get_closest_object(float& angle_deg, float &distance) const
 {
-    bool closest_found = false;
-    uint8_t closest_sector = 0;
-    uint8_t closest_layer = 0;
+    const FaceState *closest = nullptr;
 
     // check boundary for shortest distance
     // only check for middle layers and higher
     // lower layers might contain ground, which will give false pre-arm failure
+    // the pyramid holds the closest sector of each layer so the number of sectors does not matter
     for (uint8_t layer=PROXIMITY_MIDDLE_LAYER; layer<PROXIMITY_NUM_LAYERS; layer++) {
-        for (uint8_t sector=0; sector<PROXIMITY_NUM_SECTORS; sector++) {
-            if (_distance_valid[layer][sector]) {
-                if (!closest_found || (_distance[layer][sector] < _distance[closest_layer][closest_sector])) {
-                    closest_layer = layer;
-                    closest_sector = sector;
-                    closest_found = true;
-                }
-            }
+        const uint8_t sector = _layer_min_sector[layer];
+        if (sector == PYRAMID_NONE) {
+            continue;
+        }
+        const FaceState &state = _face[Face{layer, sector}.index()];
+        if ((closest == nullptr) || (state.distance < closest->distance)) {
+            closest = &state;
         }
     }
 
-    if (closest_found) {
-        angle_deg = _angle[closest_layer][closest_sector];
-        distance = _distance[closest_layer][closest_sector];
+    if (closest != nullptr) {
+        angle_deg = closest->angle;
+        distance = closest->distance;
+        return true;
     }
-    return closest_found;
+    return false;
 }
 
 // get number of objects, used for non-GPS avoidance
@@ -371,9 +453,13 @@ uint8_t AP_Proximity_Boundary_3D::get_horizontal_object_count() const
 // returns false if no angle or distance could be returned for some reason
 bool AP_Proximity_Boundary_3D::get_horizontal_object_angle_and_distance(uint8_t object_number, float &angle_deg, float &distance) const
 {
-    if ((object_number < PROXIMITY_NUM_SECTORS) && _distance_valid[PROXIMITY_MIDDLE_LAYER][object_number]) {
-        angle_deg = _angle[PROXIMITY_MIDDLE_LAYER][object_number];
-        distance = _filtered_distance[PROXIMITY_MIDDLE_LAYER][object_number].get();
+    if (object_number >= PROXIMITY_NUM_SECTORS) {
+        return false;
+    }
+    const FaceState &state = _face[Face{PROXIMITY_MIDDLE_LAYER, object_number}.index()];
+    if (state.valid) {
+        angle_deg = state.angle;
+        distance = state.filtered_distance;
         return true;
     }
     return false;
@@ -381,15 +467,17 @@ bool AP_Proximity_Boundary_3D::get_horizontal_object_angle_and_distance(uint8_t
 
 // get an obstacle info for AP_Periph
 // returns false if no angle or distance could be returned for some reason
-bool AP_Proximity_Boundary_3D::get_obstacle_info(uint8_t obstacle_num, float &angle_deg, float &pitch_deg, float &distance) const
+bool AP_Proximity_Boundary_3D::get_obstacle_info(uint16_t obstacle_num, float &angle_deg, float &pitch_deg, float &distance) const
 {
     // obstacle num is just "flattened layers, and sectors"
-    const uint8_t layer = obstacle_num / PROXIMITY_NUM_SECTORS;
-    const uint8_t sector = obstacle_num % PROXIMITY_NUM_SECTORS;
-    if (_distance_valid[layer][sector]) {
-        angle_deg = _angle[layer][sector];
-        pitch_deg = _pitch[layer][sector];
-        distance = _filtered_distance[layer][sector].get();
+    if (obstacle_num >= PROXIMITY_NUM_FACES) {
+        return false;
+    }
+    const FaceState &state = _face[obstacle_num];
+    if (state.valid) {
+        angle_deg = state.angle;
+        pitch_deg = state.pitch;
+        distance = state.filtered_distance;
         return true;
     }
 
@@ -403,30 +491,35 @@ bool AP_Proximity_Boundary_3D::get_filtered_distance(const Face &face, float &di
         return false;
     }
 
-    if (!_distance_valid[face.layer][face.sector]) {
+    const FaceState &state = _face[face.index()];
+    if (!state.valid) {
         // invalid distace
         return false;
     }
 
-    distance = _filtered_distance[face.layer][face.sector].get();
+    distance = state.filtered_distance;
     return true;
 }
 
 // Get raw and filtered distances in 8 directions per layer
+// each direction reports the closest face found in its octant by the min distance pyramid
 bool AP_Proximity_Boundary_3D::get_layer_distances(uint8_t layer_number, float dist_max, Proximity_Distance_Array &prx_dist_array, Proximity_Distance_Array &prx_filt_dist_array) const
 {
-    // cycle through all sectors filling in distances and orientations
+    // cycle through all directions filling in distances and orientations
     // see MAV_SENSOR_ORIENTATION for orientations (0 = forward, 1 = 45 degree clockwise from north, etc)
     bool valid_distances = false;
     prx_dist_array.offset_valid = 0;
     prx_filt_dist_array.offset_valid = 0;
+    if (layer_number >= PROXIMITY_NUM_LAYERS) {
+        return false;
+    }
     for (uint8_t i=0; i<PROXIMITY_MAX_DIRECTION; i++) {
         prx_dist_array.orientation[i] = i;
-        const AP_Proximity_Boundary_3D::Face face(layer_number, i);
-        if (!face.valid()) {
-            return false;
-        }
-        if (get_distance(face, prx_dist_array.distance[i]) && get_filtered_distance(face, prx_filt_dist_array.distance[i])) {
+        const uint8_t sector = _octant_min_sector[layer_number][i];
+        if (sector != PYRAMID_NONE) {
+            const FaceState &state = _face[Face{layer_number, sector}.index()];
+            prx_dist_array.distance[i] = state.distance;
+            prx_filt_dist_array.distance[i] = state.filtered_distance;
             valid_distances = true;
             prx_dist_array.offset_valid |= (1U << i);
             prx_filt_dist_array.offset_valid |= (1U << i);
@@ -442,10 +535,8 @@ bool AP_Proximity_Boundary_3D::get_layer_distances(uint8_t layer_number, float d
 // reset the temporary boundary. This fills in distances with FLT_MAX
 void AP_Proximity_Temp_Boundary::reset()
 {
-    for (uint8_t layer=0; layer < PROXIMITY_NUM_LAYERS; layer++) {
-        for (uint8_t sector=0; sector < PROXIMITY_NUM_SECTORS; sector++) {
-            _distances[layer][sector] = FLT_MAX;
-        }
+    for (uint16_t i=0; i < PROXIMITY_NUM_FACES; i++) {
+        _face[i].distance = FLT_MAX;
     }
 }
 
@@ -453,10 +544,10 @@ void AP_Proximity_Temp_Boundary::reset()
 // pitch and yaw are in degrees, distance is in meters
 void AP_Proximity_Temp_Boundary::add_distance(const AP_Proximity_Boundary_3D::Face &face, float pitch, float yaw, float distance)
 {
-    if (face.valid() && distance < _distances[face.layer][face.sector]) {
-        _distances[face.layer][face.sector] = distance;
-        _angle[face.layer][face.sector] = yaw;
-        _pitch[face.layer][face.sector] = pitch;
+    if (face.valid() && distance < _face[face.index()].distance) {
+        _face[face.index()].distance = distance;
+        _face[face.index()].angle = yaw;
+        _face[face.index()].pitch = pitch;
     }
 }
 
@@ -466,9 +557,10 @@ void AP_Proximity_Temp_Boundary::update_3D_boundary(uint8_t prx_instance, AP_Pro
 {
     for (uint8_t layer=0; layer < PROXIMITY_NUM_LAYERS; layer++) {
         for (uint8_t sector=0; sector < PROXIMITY_NUM_SECTORS; sector++) {
-            if (_distances[layer][sector] < FLT_MAX) {
-                AP_Proximity_Boundary_3D::Face face{layer, sector};
-                boundary.set_face_attributes(face, _pitch[layer][sector], _angle[layer][sector], _distances[layer][sector], prx_instance);
+            const AP_Proximity_Boundary_3D::Face face{layer, sector};
+            const uint16_t i = face.index();
+            if (_face[i].distance < FLT_MAX) {
+                boundary.set_face_attributes(face, _face[i].pitch, _face[i].angle, _face[i].distance, prx_instance);
             }
         }
     }
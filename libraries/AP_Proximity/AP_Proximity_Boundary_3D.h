@@ -19,11 +19,20 @@
 #include <AP_Math/AP_Math.h>
 #include <Filter/LowPassFilter.h>
 
+// boundary resolution may be raised at compile time for high resolution sensors (e.g. 72 sectors by 7 layers)
+// the number of sectors must be an odd multiple of 8 so that each of the 8 directions reported to the
+// ground station is centred on a sector, and the number of layers must be odd so one layer is centred on zero pitch
+#ifndef PROXIMITY_NUM_SECTORS
 #define PROXIMITY_NUM_SECTORS         8       // number of sectors
+#endif
+#ifndef PROXIMITY_NUM_LAYERS
 #define PROXIMITY_NUM_LAYERS          5       // num of layers in a sector
-#define PROXIMITY_MIDDLE_LAYER        2       // middle layer
-#define PROXIMITY_PITCH_WIDTH_DEG     30      // width between each layer in degrees
+#endif
+#define PROXIMITY_MIDDLE_LAYER        (PROXIMITY_NUM_LAYERS/2)          // middle layer
+#define PROXIMITY_PITCH_MAX_DEG       75.0f   // layers cover pitch angles from -75 to +75 degrees
+#define PROXIMITY_PITCH_WIDTH_DEG     (2.0f*PROXIMITY_PITCH_MAX_DEG/PROXIMITY_NUM_LAYERS) // width between each layer in degrees
 #define PROXIMITY_SECTOR_WIDTH_DEG    (360.0f/PROXIMITY_NUM_SECTORS)   // width of sectors in degrees
+#define PROXIMITY_NUM_FACES           (PROXIMITY_NUM_LAYERS*PROXIMITY_NUM_SECTORS) // total number of faces on the boundary
 #define PROXIMITY_BOUNDARY_DIST_MIN   0.6f    // minimum distance for a boundary point.  This ensures the object avoidance code doesn't think we are outside the boundary.
 #define PROXIMITY_BOUNDARY_DIST_DEFAULT 100   // if we have no data for a sector, boundary is placed 100m out
 #define PROXIMITY_FILT_RESET_TIME     1000    // reset filter if last distance was pushed more than this many ms away
@@ -65,8 +74,11 @@ public:
 	    bool operator ==(const Face &other) const { return ((layer == other.layer) && (sector == other.sector)); }
 	    bool operator !=(const Face &other) const { return ((layer != other.layer) || (sector != other.sector)); }
 
-        uint8_t layer;  // vertical "steps" on the 3D Boundary. 0th layer is the bottom most layer, 1st layer is 30 degrees above (in body frame) and so on
-        uint8_t sector; // horizontal "steps" on the 3D Boundary. 0th sector is directly in front of the vehicle. Each sector is 45 degrees wide.
+	    // index of this face in the flattened per face storage
+	    uint16_t index() const { return layer * PROXIMITY_NUM_SECTORS + sector; }
+
+        uint8_t layer;  // vertical "steps" on the 3D Boundary. 0th layer is the bottom most layer, 1st layer is PROXIMITY_PITCH_WIDTH_DEG above (in body frame) and so on
+        uint8_t sector; // horizontal "steps" on the 3D Boundary. 0th sector is directly in front of the vehicle. Each sector is PROXIMITY_SECTOR_WIDTH_DEG wide.
     };
 
     // returns face corresponding to the provided yaw and (optionally) pitch
@@ -103,15 +115,15 @@ public:
     bool get_distance(const Face &face, float &distance) const;
 
     // Get the total number of obstacles
-    uint8_t get_obstacle_count() const;
+    uint16_t get_obstacle_count() const;
 
     // Returns a body frame vector (in cm) to an obstacle
     // False is returned if the obstacle_num provided does not produce a valid obstacle
-    bool get_obstacle(uint8_t obstacle_num, Vector3f& vec_to_boundary) const;
+    bool get_obstacle(uint16_t obstacle_num, Vector3f& vec_to_boundary) const;
 
     // Returns a body frame vector (in cm) nearest to obstacle, in betwen seg_start and seg_end
     // True is returned if the segment intersects a plane formed by considering the "closest point" as normal vector to the plane.
-    bool closest_point_from_segment_to_obstacle(uint8_t obstacle_num, const Vector3f& seg_start, const Vector3f& seg_end, Vector3f& closest_point) const;
+    bool closest_point_from_segment_to_obstacle(uint16_t obstacle_num, const Vector3f& seg_start, const Vector3f& seg_end, Vector3f& closest_point) const;
 
     // get distance and angle to closest object (used for pre-arm check)
     //   returns true on success, false if no valid readings
@@ -122,26 +134,34 @@ public:
     bool get_horizontal_object_angle_and_distance(uint8_t object_number, float& angle_deg, float &distance) const;
 
     // get obstacle info for AP_Periph
-    bool get_obstacle_info(uint8_t obstacle_num, float &angle_deg, float &pitch_deg, float &distance) const;
+    bool get_obstacle_info(uint16_t obstacle_num, float &angle_deg, float &pitch_deg, float &distance) const;
 
     // get number of layers
     uint8_t get_num_layers() const { return PROXIMITY_NUM_LAYERS; }
 
     // get raw and filtered distances in 8 directions per layer.
+    // with more than 8 sectors each direction reports the closest face within the 45 degrees around it
     bool get_layer_distances(uint8_t layer_number, float dist_max, Proximity_Distance_Array &prx_dist_array, Proximity_Distance_Array &prx_filt_dist_array) const;
 
     // pass down filter cut-off freq from params
     void set_filter_freq(float filt_freq) { _filter_freq = filt_freq; }
 
     // sectors
-    static_assert(PROXIMITY_NUM_SECTORS == 8, "PROXIMITY_NUM_SECTOR must be 8");
-    const uint16_t _sector_middle_deg[PROXIMITY_NUM_SECTORS] {0, 45, 90, 135, 180, 225, 270, 315};    // middle angle of each sector
+    static_assert(PROXIMITY_NUM_SECTORS < 255, "PROXIMITY_NUM_SECTORS must fit in a Face");
+    static_assert((PROXIMITY_NUM_SECTORS % PROXIMITY_MAX_DIRECTION == 0) && ((PROXIMITY_NUM_SECTORS / PROXIMITY_MAX_DIRECTION) % 2 == 1), "PROXIMITY_NUM_SECTORS must be an odd multiple of 8");
     // layers
-    static_assert(PROXIMITY_NUM_LAYERS == 5, "PROXIMITY_NUM_LAYERS must be 5");
-    const int16_t _pitch_middle_deg[PROXIMITY_NUM_LAYERS] {-60, -30, 0, 30, 60};
+    static_assert((PROXIMITY_NUM_LAYERS % 2 == 1) && (PROXIMITY_NUM_LAYERS < 255), "PROXIMITY_NUM_LAYERS must be odd");
+
+    // middle yaw angle of a sector and middle pitch angle of a layer in degrees
+    static float get_sector_middle_deg(uint8_t sector) { return sector * PROXIMITY_SECTOR_WIDTH_DEG; }
+    static float get_layer_middle_deg(uint8_t layer) { return (layer + 0.5f) * PROXIMITY_PITCH_WIDTH_DEG - PROXIMITY_PITCH_MAX_DEG; }
 
 private:
 
+    // number of sectors in each of the 8 directions (octants) of the min distance pyramid
+    static const uint8_t SECTORS_PER_OCTANT = PROXIMITY_NUM_SECTORS / PROXIMITY_MAX_DIRECTION;
+    static const uint8_t PYRAMID_NONE = UINT8_MAX;
+
     // initialise the boundary and sector_edge_vector array used for object avoidance
     void init();
 
@@ -151,15 +171,15 @@ private:
     // get the prev sector which is CCW to the passed sector
     uint8_t get_prev_sector(uint8_t sector) const {return ((sector <= 0) ? PROXIMITY_NUM_SECTORS-1 : sector-1); }
 
+    // get the octant (i.e. ground station direction) containing a sector
+    uint8_t get_octant(uint8_t sector) const { return ((sector + SECTORS_PER_OCTANT/2) / SECTORS_PER_OCTANT) % PROXIMITY_MAX_DIRECTION; }
+
     // Converts obstacle_num passed from avoidance library into appropriate face of the boundary
     // Returns false if the face is invalid
     // "update_boundary" method manipulates two sectors ccw and one sector cw from any valid face.
     // Any boundary that does not fall into these manipulated faces are useless, and will be marked as false
     // The resultant is packed into a Boundary Location object and returned by reference as "face"
-    bool convert_obstacle_num_to_face(uint8_t obstacle_num, Face& face) const WARN_IF_UNUSED;
-
-    // Apply a new cutoff_freq to low-pass filter
-    void apply_filter_freq(float cutoff_freq);
+    bool convert_obstacle_num_to_face(uint16_t obstacle_num, Face& face) const WARN_IF_UNUSED;
 
     // Apply low pass filter on the raw distance
     void set_filtered_distance(const Face &face, float distance);
@@ -167,16 +187,39 @@ private:
     // Return filtered distance for the passed in face
     bool get_filtered_distance(const Face &face, float &distance) const;
 
-    Vector3f _sector_edge_vector[PROXIMITY_NUM_LAYERS][PROXIMITY_NUM_SECTORS];
-    Vector3f _boundary_points[PROXIMITY_NUM_LAYERS][PROXIMITY_NUM_SECTORS];
+    // body frame vector (in cm) to the boundary point on the clockwise edge of a face
+    Vector3f get_boundary_point(uint8_t layer, uint8_t sector) const;
+
+    // returns whichever of the two sectors in a layer has the shorter valid distance, either may be PYRAMID_NONE
+    uint8_t closer_sector(uint8_t layer, uint8_t sector_a, uint8_t sector_b) const;
+
+    // recalculate the min distance pyramid above a face after its distance or validity changed
+    void update_pyramid(const Face &face);
+
+    // per face state, stored flat and indexed by Face::index()
+    struct FaceState {
+        float angle;                // yaw angle in degrees to closest object within the face
+        float pitch;                // pitch angle in degrees to the closest object within the face
+        float distance;             // distance to closest object within the face
+        float filtered_distance;    // low pass filtered distance
+        float boundary_distance;    // distance to the boundary point on the clockwise edge of the face
+        uint32_t last_update_ms;    // time when distance was last updated
+        uint8_t prx_instance;       // proximity sensor backend instance that provided the distance
+        bool valid;                 // true if a valid distance has been received
+        bool filter_initialised;    // true once filtered_distance holds a filtered value
+    } _face[PROXIMITY_NUM_FACES];
+
+    // sector edge directions are separable in yaw and pitch so are stored per sector and per layer
+    float _edge_yaw_cos[PROXIMITY_NUM_SECTORS];
+    float _edge_yaw_sin[PROXIMITY_NUM_SECTORS];
+    float _layer_pitch_cos[PROXIMITY_NUM_LAYERS];
+    float _layer_pitch_sin[PROXIMITY_NUM_LAYERS];
+
+    // min distance pyramid, holding the sector with the shortest valid distance (or PYRAMID_NONE) in each octant and each layer
+    // keeps the closest object queries independent of the number of sectors
+    uint8_t _octant_min_sector[PROXIMITY_NUM_LAYERS][PROXIMITY_MAX_DIRECTION];
+    uint8_t _layer_min_sector[PROXIMITY_NUM_LAYERS];
 
-    float _angle[PROXIMITY_NUM_LAYERS][PROXIMITY_NUM_SECTORS];          // yaw angle in degrees to closest object within each sector and layer
-    float _pitch[PROXIMITY_NUM_LAYERS][PROXIMITY_NUM_SECTORS];          // pitch angle in degrees to the closest object within each sector and layer
-    float _distance[PROXIMITY_NUM_LAYERS][PROXIMITY_NUM_SECTORS];       // distance to closest object within each sector and layer
-    bool _distance_valid[PROXIMITY_NUM_LAYERS][PROXIMITY_NUM_SECTORS];  // true if a valid distance received for each sector and layer
-    uint32_t _last_update_ms[PROXIMITY_NUM_LAYERS][PROXIMITY_NUM_SECTORS]; // time when distance was last updated
-    uint8_t _prx_instance[PROXIMITY_NUM_LAYERS][PROXIMITY_NUM_SECTORS]; // proximity sensor backend instance that provided the distance
-    LowPassFilterFloat _filtered_distance[PROXIMITY_NUM_LAYERS][PROXIMITY_NUM_SECTORS]; // low pass filter
     float _filter_freq;                                                 // cutoff freq of low pass filter
     uint32_t _last_check_face_timeout_ms;                               // system time to throttle check_face_timeout method
 };
@@ -204,7 +247,10 @@ public:
 
 private:
 
-    float _distances[PROXIMITY_NUM_LAYERS][PROXIMITY_NUM_SECTORS];      // distance to closest object within each sector and layer. Will start with FLT_MAX, and then be changed to a valid distance if needed
-    float _angle[PROXIMITY_NUM_LAYERS][PROXIMITY_NUM_SECTORS];          // yaw angle in degrees to closest object within each sector and layer
-    float _pitch[PROXIMITY_NUM_LAYERS][PROXIMITY_NUM_SECTORS];          // pitch angle in degrees to the closest object within each sector and layer
+    // closest distance, yaw and pitch within each face, indexed by Face::index(). Distances start at FLT_MAX, and then are changed to a valid distance if needed
+    struct {
+        float distance;
+        float angle;
+        float pitch;
+    } _face[PROXIMITY_NUM_FACES];
 };
@@ -24,10 +24,16 @@ extern const AP_HAL::HAL& hal;
 
 #define PROXIMITY_MAV_TIMEOUT_MS    500 // distance messages must arrive within this many milliseconds
 #define PROXIMITY_TIMESTAMP_MSG_TIMEOUT_MS  50  // obstacles will be transferred from temp boundary to actual boundary if mavlink message does not arrive within this many milliseconds
+#define PROXIMITY_MAV_FRAME_MERGE_DEG       3   // obstacles in a frame closer than this in both pitch and yaw are pushed to the OA database as one
 
 // update the state of the sensor
 void AP_Proximity_MAV::update(void)
 {
+    // use the last OBSTACLE_DISTANCE_3D frame if no more messages are coming
+    if (_frame_pending && (AP_HAL::millis() - _last_update_ms > PROXIMITY_TIMESTAMP_MSG_TIMEOUT_MS)) {
+        frame_complete(_last_update_ms);
+    }
+
     // check for timeout and set health status
     if ((_last_update_ms == 0 || (AP_HAL::millis() - _last_update_ms > PROXIMITY_MAV_TIMEOUT_MS)) &&
         (_last_upward_update_ms == 0 || (AP_HAL::millis() - _last_upward_update_ms > PROXIMITY_MAV_TIMEOUT_MS))) {
@@ -229,20 +235,20 @@ void AP_Proximity_MAV::handle_obstacle_distance_3d_msg(const mavlink_message_t &
         return;
     }
 
-    if ((previous_msg_timestamp != _last_msg_update_timestamp_ms) || (time_diff > PROXIMITY_TIMESTAMP_MSG_TIMEOUT_MS)) {
-        // push data from temp boundary to the main 3-D proximity boundary because a new timestamp has arrived
-        temp_boundary.update_3D_boundary(state.instance, frontend.boundary);
-        // clear temp boundary for new data
-        temp_boundary.reset();
+    const bool new_frame = (previous_msg_timestamp != _last_msg_update_timestamp_ms) || (time_diff > PROXIMITY_TIMESTAMP_MSG_TIMEOUT_MS);
+    if (new_frame && _frame_pending) {
+        // a new timestamp has arrived so the previous frame is complete
+        frame_complete(previous_sys_time);
+    }
+    if (!_frame_pending) {
+        // the vehicle's position and attitude are taken once per frame
+        _frame_database_ready = database_prepare_for_push(_frame_pos, _frame_body_to_ned);
+        _frame_pending = true;
     }
 
     _distance_min = packet.min_distance;
     _distance_max = packet.max_distance;
 
-    Vector3f current_pos;
-    Matrix3f body_to_ned;
-    const bool database_ready = database_prepare_for_push(current_pos, body_to_ned);
-
     const Vector3f obstacle_FRD(packet.x, packet.y, packet.z);
     const float obstacle_distance = obstacle_FRD.length();
     if (obstacle_distance < _distance_min || obstacle_distance > _distance_max || is_zero(obstacle_distance)) {
@@ -264,12 +270,58 @@ void AP_Proximity_MAV::handle_obstacle_distance_3d_msg(const mavlink_message_t &
 
     // allot to correct layer and sector based on calculated pitch and yaw
     const AP_Proximity_Boundary_3D::Face face = frontend.boundary.get_face(pitch, yaw);
-    temp_boundary.add_distance(face, pitch, yaw, obstacle.length());
+    temp_boundary.add_distance(face, pitch, yaw, obstacle_distance);
 
-    if (database_ready) {
-        database_push(yaw, pitch, obstacle.length(),_last_update_ms, current_pos, body_to_ned);
+    if (_frame_database_ready) {
+        frame_add_obstacle(pitch, yaw, obstacle_distance);
     }
     return;
 }
 
+// add an obstacle to the current OBSTACLE_DISTANCE_3D frame. Depth
+// cameras send many obstacles per frame, often close together, so
+// obstacles near one already in the frame are merged into it, keeping
+// the closer. If the frame is full the furthest obstacle is replaced
+void AP_Proximity_MAV::frame_add_obstacle(float pitch, float yaw, float distance)
+{
+    uint8_t furthest = 0;
+    for (uint8_t i = 0; i < _frame_obstacle_count; i++) {
+        frame_obstacle &ob = _frame_obstacles[i];
+        if (fabsf(ob.pitch - pitch) < PROXIMITY_MAV_FRAME_MERGE_DEG &&
+            fabsf(wrap_180(ob.yaw - yaw)) < PROXIMITY_MAV_FRAME_MERGE_DEG) {
+            if (distance < ob.distance) {
+                ob = { pitch, yaw, distance };
+            }
+            return;
+        }
+        if (ob.distance > _frame_obstacles[furthest].distance) {
+            furthest = i;
+        }
+    }
+    if (_frame_obstacle_count < ARRAY_SIZE(_frame_obstacles)) {
+        _frame_obstacles[_frame_obstacle_count++] = { pitch, yaw, distance };
+    } else if (distance < _frame_obstacles[furthest].distance) {
+        _frame_obstacles[furthest] = { pitch, yaw, distance };
+    }
+}
+
+// end the current OBSTACLE_DISTANCE_3D frame, moving the closest
+// obstacle in each face to the 3-D proximity boundary and pushing the
+// frame's obstacles to the OA database, timestamped with the system
+// time of the frame's last message
+void AP_Proximity_MAV::frame_complete(uint32_t timestamp_ms)
+{
+    temp_boundary.update_3D_boundary(state.instance, frontend.boundary);
+    temp_boundary.reset();
+
+    if (_frame_database_ready) {
+        for (uint8_t i = 0; i < _frame_obstacle_count; i++) {
+            const frame_obstacle &ob = _frame_obstacles[i];
+            database_push(ob.yaw, ob.pitch, ob.distance, timestamp_ms, _frame_pos, _frame_body_to_ned);
+        }
+    }
+    _frame_obstacle_count = 0;
+    _frame_pending = false;
+}
+
 #endif // HAL_PROXIMITY_ENABLED
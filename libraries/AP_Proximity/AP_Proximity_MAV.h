@@ -4,6 +4,10 @@
 
 #if HAL_PROXIMITY_ENABLED
 
+#ifndef PROXIMITY_MAV_FRAME_OBSTACLES_MAX
+#define PROXIMITY_MAV_FRAME_OBSTACLES_MAX 32    // maximum OBSTACLE_DISTANCE_3D obstacles pushed to the OA database per frame
+#endif
+
 class AP_Proximity_MAV : public AP_Proximity_Backend
 {
 
@@ -33,8 +37,29 @@ private:
     // handle mavlink OBSTACLE_DISTANCE_3D messages
     void handle_obstacle_distance_3d_msg(const mavlink_message_t &msg);
 
+    // end the current OBSTACLE_DISTANCE_3D frame, updating the boundary and the OA database
+    void frame_complete(uint32_t timestamp_ms);
+
+    // add an obstacle to the current frame's compacted set for the OA database
+    void frame_add_obstacle(float pitch, float yaw, float distance);
+
    AP_Proximity_Temp_Boundary temp_boundary;
 
+    // OBSTACLE_DISTANCE_3D obstacles are gathered for a whole frame (all
+    // messages with the same time_boot_ms) before being used. Obstacles
+    // within PROXIMITY_MAV_FRAME_MERGE_DEG of each other are merged,
+    // keeping the closest
+    struct frame_obstacle {
+        float pitch;
+        float yaw;
+        float distance;
+    } _frame_obstacles[PROXIMITY_MAV_FRAME_OBSTACLES_MAX];
+    uint8_t _frame_obstacle_count;
+    bool _frame_pending;                // temp_boundary or _frame_obstacles hold data not yet used
+    bool _frame_database_ready;         // _frame_pos and _frame_body_to_ned are valid for this frame
+    Vector3f _frame_pos;                // vehicle position at the start of the frame
+    Matrix3f _frame_body_to_ned;        // vehicle attitude at the start of the frame
+
     // horizontal distance support
     uint32_t _last_update_ms;   // system time of last mavlink message received
     uint32_t _last_msg_update_timestamp_ms;   // last stored mavlink message timestamp
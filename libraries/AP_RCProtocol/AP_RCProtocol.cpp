@@ -135,6 +135,7 @@ void AP_RCProtocol::process_pulse(uint32_t width_s0, uint32_t width_s1)
                 }
                 _last_input_ms = now;
                 _detected_with_bytes = false;
+                remember_protocol(_detected_protocol);
                 break;
             }
         }
@@ -199,6 +200,10 @@ bool AP_RCProtocol::process_byte(uint8_t byte, uint32_t baudrate)
             if (!protocol_enabled(rcprotocol_t(i))) {
                 continue;
             }
+            if (protocol_baudrate(rcprotocol_t(i)) != baudrate) {
+                // the backend would discard this byte, skip the calls
+                continue;
+            }
             const uint32_t frame_count = backend[i]->get_rc_frame_count();
             const uint32_t input_count = backend[i]->get_rc_input_count();
             backend[i]->process_byte(byte, baudrate);
@@ -211,6 +216,7 @@ bool AP_RCProtocol::process_byte(uint8_t byte, uint32_t baudrate)
                 _detected_protocol = (enum AP_RCProtocol::rcprotocol_t)i;
                 _last_input_ms = now;
                 _detected_with_bytes = true;
+                remember_protocol(_detected_protocol);
                 for (uint8_t j = 0; j < AP_RCProtocol::NONE; j++) {
                     if (backend[j]) {
                         backend[j]->reset_rc_frame_count();
@@ -452,6 +458,65 @@ void AP_RCProtocol::add_uart(AP_HAL::UARTDriver* uart)
 {
     added.uart = uart;
     added.uart->set_flow_control(AP_HAL::UARTDriver::FLOW_CONTROL_DISABLE);
+
+#if !defined(IOMCU_FW) && !APM_BUILD_TYPE(APM_BUILD_UNKNOWN)
+    // start the search with the serial config the last receiver was
+    // found with, rather than spending a second on each config first
+    const int8_t last = rc().last_protocol();
+    if (last >= 0 && last < AP_RCProtocol::NONE) {
+        const uint32_t baud = protocol_baudrate(rcprotocol_t(last));
+        for (uint8_t i=0; i<ARRAY_SIZE(serial_configs); i++) {
+            if (serial_configs[i].baud == baud) {
+                added.config_num = i;
+                break;
+            }
+        }
+    }
+#endif
+}
+
+/*
+  the serial baudrate each protocol decodes bytes at. This matches the
+  check at the top of each backend's process_byte(), and lets bytes
+  during a search go only to the backends that could be receiving them
+ */
+uint32_t AP_RCProtocol::protocol_baudrate(rcprotocol_t protocol)
+{
+    switch (protocol) {
+    case SBUS:
+    case SBUS_NI:
+        return 100000;
+#if AP_RCPROTOCOL_FASTSBUS_ENABLED
+    case FASTSBUS:
+        return 200000;
+#endif
+    case CRSF:
+        return CRSF_BAUDRATE;
+    case IBUS:
+    case DSM:
+    case SUMD:
+    case SRXL:
+    case SRXL2:
+    case ST24:
+#if AP_RCPROTOCOL_FPORT_ENABLED
+    case FPORT:
+#endif
+#if AP_RCPROTOCOL_FPORT2_ENABLED
+    case FPORT2:
+#endif
+        return 115200;
+    case PPM:
+    case NONE:
+        break;
+    }
+    return 0;
+}
+
+void AP_RCProtocol::remember_protocol(rcprotocol_t protocol)
+{
+#if !defined(IOMCU_FW) && !APM_BUILD_TYPE(APM_BUILD_UNKNOWN)
+    rc().set_last_protocol(int8_t(protocol));
+#endif
 }
 
 // return true if a specific protocol is enabled
@@ -165,6 +165,12 @@ private:
     // return true if a specific protocol is enabled
     bool protocol_enabled(enum rcprotocol_t protocol) const;
 
+    // serial baudrate a protocol is decoded at, 0 if it has no byte decoder
+    static uint32_t protocol_baudrate(enum rcprotocol_t protocol);
+
+    // remember a detected protocol so it is searched for first after a reboot
+    void remember_protocol(enum rcprotocol_t protocol);
+
     enum rcprotocol_t _detected_protocol = NONE;
     uint16_t _disabled_for_pulses;
     bool _detected_with_bytes;
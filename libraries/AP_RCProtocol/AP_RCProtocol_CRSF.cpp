@@ -283,12 +283,32 @@ void AP_RCProtocol_CRSF::update(void)
             start_uart();
             _last_uart_start_time_ms = now;
         }
-        uint32_t n = _uart->available();
-        n = MIN(n, 255U);
-        for (uint8_t i = 0; i < n; i++) {
-            int16_t b = _uart->read();
-            if (b >= 0) {
-                process_byte(AP_HAL::micros(), uint8_t(b));
+        /*
+          at high ELRS packet rates several frames can be waiting, so
+          read them in blocks and give each byte the time it came off
+          the wire rather than the time we got round to it. That keeps
+          frame gap detection and the telemetry slot timing correct
+          however late this is called
+         */
+        uint8_t buf[CRSF_FRAMELEN_MAX];
+        uint32_t remaining = MIN(_uart->available(), 255U);
+        while (remaining > 0) {
+            const ssize_t nread = _uart->read(buf, MIN(remaining, sizeof(buf)));
+            if (nread <= 0) {
+                break;
+            }
+            remaining -= nread;
+            const uint32_t now_us = AP_HAL::micros();
+            const uint32_t baudrate = _uart->get_baud_rate();
+            const uint32_t byte_time_us = baudrate > 0 ? 10000000UL / baudrate : 0;
+            uint32_t timestamp_us = uint32_t(_uart->receive_time_constraint_us(nread));
+            if (timestamp_us == 0 || int32_t(now_us - timestamp_us) < int32_t(byte_time_us * nread)) {
+                // no usable estimate from the HAL
+                timestamp_us = now_us - byte_time_us * nread;
+            }
+            for (ssize_t i = 0; i < nread; i++) {
+                timestamp_us += byte_time_us;
+                process_byte(timestamp_us, buf[i]);
             }
         }
     }
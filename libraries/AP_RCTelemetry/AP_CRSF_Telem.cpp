@@ -45,6 +45,8 @@ extern const AP_HAL::HAL& hal;
 const uint8_t AP_CRSF_Telem::PASSTHROUGH_STATUS_TEXT_FRAME_MAX_SIZE;
 const uint8_t AP_CRSF_Telem::PASSTHROUGH_MULTI_PACKET_FRAME_MAX_SIZE;
 const uint8_t AP_CRSF_Telem::CRSF_RX_DEVICE_PING_MAX_RETRY;
+const uint16_t AP_CRSF_Telem::ELRS_VERY_HIGH_SPEED_TELEM_RATE;
+const uint8_t AP_CRSF_Telem::ELRS_VERY_HIGH_SPEED_PASSTHROUGH_SIZE;
 
 AP_CRSF_Telem *AP_CRSF_Telem::singleton;
 
@@ -148,7 +150,14 @@ void AP_CRSF_Telem::update_custom_telemetry_rates(AP_RCProtocol_CRSF::RFMode rf_
         return;
     }
 
-    if (is_high_speed_telemetry(rf_mode)) {
+    if (is_very_high_speed_telemetry()) {
+        // ELRS at 250Hz and above with a generous telemetry ratio
+        set_scheduler_entry(BATTERY, 500, 500);         // 2Hz
+        set_scheduler_entry(ATTITUDE, 100, 100);        // 10Hz
+        set_scheduler_entry(GPS, 200, 200);             // 5Hz
+        set_scheduler_entry(PASSTHROUGH, 50, 50);       // 20Hz, several packets per frame
+        set_scheduler_entry(STATUS_TEXT, 200, 500);     // 2Hz
+    } else if (is_high_speed_telemetry(rf_mode)) {
         // standard telemetry for high data rates
         set_scheduler_entry(BATTERY, 1000, 1000);       // 1Hz
         set_scheduler_entry(ATTITUDE, 1000, 1000);      // 1Hz
@@ -206,6 +215,7 @@ bool AP_CRSF_Telem::process_rf_mode_changes()
     _telem_bootstrap_msg_pending = false;
 
     const bool is_high_speed = is_high_speed_telemetry(current_rf_mode);
+    const bool is_very_high_speed = is_very_high_speed_telemetry();
     if ((now - _telem_last_report_ms > 5000)) {
         // report an RF mode change or a change in telemetry rate if we haven't done so in the last 5s
         if (!rc().suppress_crsf_message() && (_telem_rf_mode != current_rf_mode || abs(int16_t(_telem_last_avg_rate) - int16_t(_scheduler.avg_packet_rate)) > 25)) {
@@ -213,10 +223,11 @@ bool AP_CRSF_Telem::process_rf_mode_changes()
                 get_protocol_string(), crsf->get_link_rate(_crsf_version.protocol), get_telemetry_rate());
         }
         // tune the scheduler based on telemetry speed high/low transitions
-        if (_telem_is_high_speed != is_high_speed) {
+        if (_telem_is_high_speed != is_high_speed || _telem_is_very_high_speed != is_very_high_speed) {
             update_custom_telemetry_rates(current_rf_mode);
         }
         _telem_is_high_speed = is_high_speed;
+        _telem_is_very_high_speed = is_very_high_speed;
         _telem_rf_mode = current_rf_mode;
         _telem_last_avg_rate = _scheduler.avg_packet_rate;
         if (_telem_last_report_ms == 0) {   // only want to show bootstrap messages once
@@ -282,6 +293,19 @@ bool AP_CRSF_Telem::is_high_speed_telemetry(const AP_RCProtocol_CRSF::RFMode rf_
     return get_telemetry_rate() > 30;
 }
 
+/*
+  ELRS links at 250Hz and above can carry far more telemetry than the
+  high speed rates were tuned for, so schedule frames more often and
+  fill each one with several passthrough packets
+ */
+bool AP_CRSF_Telem::is_very_high_speed_telemetry() const
+{
+    if (_crsf_version.protocol != AP_RCProtocol_CRSF::ProtocolType::PROTOCOL_ELRS) {
+        return false;
+    }
+    return get_telemetry_rate() >= ELRS_VERY_HIGH_SPEED_TELEM_RATE;
+}
+
 uint16_t AP_CRSF_Telem::get_telemetry_rate() const
 {
     if (_crsf_version.protocol != AP_RCProtocol_CRSF::ProtocolType::PROTOCOL_ELRS) {
@@ -434,7 +458,11 @@ void AP_CRSF_Telem::process_packet(uint8_t idx)
             calc_flight_mode();
             break;
         case PASSTHROUGH:
-            if (is_high_speed_telemetry(_telem_rf_mode)) {
+            if (_telem_is_very_high_speed) {
+                // on very fast ELRS links the frame rate is the limit, so
+                // carry a few passthrough packets in every frame
+                get_multi_packet_passthrough_telem_data(ELRS_VERY_HIGH_SPEED_PASSTHROUGH_SIZE);
+            } else if (is_high_speed_telemetry(_telem_rf_mode)) {
                 // on fast links we have 1:1 ratio between
                 // passthrough frames and crossfire frames
                 get_single_packet_passthrough_telem_data();
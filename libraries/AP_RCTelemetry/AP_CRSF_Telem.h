@@ -51,6 +51,9 @@ public:
     static const uint8_t PASSTHROUGH_STATUS_TEXT_FRAME_MAX_SIZE = 50U;
     static const uint8_t PASSTHROUGH_MULTI_PACKET_FRAME_MAX_SIZE = 9U;
     static const uint8_t CRSF_RX_DEVICE_PING_MAX_RETRY = 50U;
+    // ELRS telemetry rate above which several passthrough packets are sent per frame
+    static const uint16_t ELRS_VERY_HIGH_SPEED_TELEM_RATE = 100U;
+    static const uint8_t ELRS_VERY_HIGH_SPEED_PASSTHROUGH_SIZE = 3U;
 
     // Broadcast frame definitions courtesy of TBS
     struct PACKED GPSFrame {   // curious fact, calling this GPS makes sizeof(GPS) return 1!
@@ -294,6 +297,7 @@ private:
     AP_RCProtocol_CRSF::RFMode get_rf_mode() const;
     uint16_t get_telemetry_rate() const;
     bool is_high_speed_telemetry(const AP_RCProtocol_CRSF::RFMode rf_mode) const;
+    bool is_very_high_speed_telemetry() const;
 
     void process_vtx_frame(VTXFrame* vtx);
     void process_vtx_telem_frame(VTXTelemetryFrame* vtx);
@@ -327,6 +331,7 @@ private:
     bool _telem_bootstrap_msg_pending;
 
     bool _telem_is_high_speed;
+    bool _telem_is_very_high_speed;
     bool _telem_pending;
     bool _enable_telemetry;
     // used to limit telemetry when in a failsafe condition
@@ -18,6 +18,7 @@
 
 #include "AP_ROMFS.h"
 #include "tinf.h"
+#include <AP_Math/AP_Math.h>
 #include <AP_Math/crc.h>
 
 #include <AP_Common/AP_Common.h>
@@ -25,6 +26,20 @@
 
 #include <string.h>
 
+// largest block we will decompress, bounds the RAM used to read a file
+#ifndef AP_ROMFS_MAX_BLOCK_SIZE
+#define AP_ROMFS_MAX_BLOCK_SIZE 16384
+#endif
+
+// header of a block compressed file is the magic, size, block_size
+// and num_blocks, followed by num_blocks+1 offsets and num_blocks crcs
+#define AP_ROMFS_BLOCK_HEADER_SIZE 16
+
+static uint32_t get_le32(const uint8_t *p)
+{
+    return p[0] | p[1] << 8 | p[2] << 16 | uint32_t(p[3]) << 24;
+}
+
 #ifdef HAL_HAVE_AP_ROMFS_EMBEDDED_H
 #include <ap_romfs_embedded.h>
 #else
@@ -65,6 +80,24 @@ const uint8_t *AP_ROMFS::find_decompress(const char *name, uint32_t &size)
     size = compressed_size;
     return compressed_data;
 #else
+    block_file bf;
+    if (parse_blocks(compressed_data, compressed_size, bf)) {
+        uint8_t *data = (uint8_t *)malloc(bf.size + 1);
+        if (!data) {
+            return nullptr;
+        }
+        data[bf.size] = 0;
+        // each block's CRC is checked as it is decompressed
+        for (uint32_t i=0; i<bf.num_blocks; i++) {
+            if (decompress_block(bf, i, &data[i*bf.block_size]) < 0) {
+                ::free(data);
+                return nullptr;
+            }
+        }
+        size = bf.size;
+        return data;
+    }
+
     // last 4 bytes of gzip file are length of decompressed data
     const uint8_t *p = &compressed_data[compressed_size-4];
     uint32_t decompressed_size = p[0] | p[1] << 8 | p[2] << 16 | p[3] << 24;
@@ -127,6 +160,111 @@ void AP_ROMFS::free(const uint8_t *data)
 #endif
 }
 
+// find the decompressed size of a file without decompressing it
+bool AP_ROMFS::find_size(const char *name, uint32_t &size)
+{
+    uint32_t compressed_size = 0;
+    uint32_t crc;
+    const uint8_t *compressed_data = find_file(name, compressed_size, crc);
+    if (!compressed_data) {
+        return false;
+    }
+#ifdef HAL_ROMFS_UNCOMPRESSED
+    size = compressed_size;
+#else
+    block_file bf;
+    if (parse_blocks(compressed_data, compressed_size, bf)) {
+        size = bf.size;
+    } else if (compressed_size >= 4) {
+        // last 4 bytes of gzip file are length of decompressed data
+        size = get_le32(&compressed_data[compressed_size-4]);
+    } else {
+        return false;
+    }
+#endif
+    return true;
+}
+
+/*
+  parse the header of a block compressed file, checking the index
+  lies within the data
+*/
+bool AP_ROMFS::parse_blocks(const uint8_t *data, uint32_t data_size, block_file &bf)
+{
+    if (data_size < AP_ROMFS_BLOCK_HEADER_SIZE || memcmp(data, "APZB", 4) != 0) {
+        return false;
+    }
+    bf.data = data;
+    bf.size = get_le32(&data[4]);
+    bf.block_size = get_le32(&data[8]);
+    bf.num_blocks = get_le32(&data[12]);
+    if (bf.block_size == 0 || bf.block_size > AP_ROMFS_MAX_BLOCK_SIZE ||
+        bf.num_blocks != (bf.size + bf.block_size - 1) / bf.block_size ||
+        AP_ROMFS_BLOCK_HEADER_SIZE + 8ULL*bf.num_blocks + 4 > data_size) {
+        return false;
+    }
+    // last offset is the end of the data
+    return get_le32(&data[AP_ROMFS_BLOCK_HEADER_SIZE + 4*bf.num_blocks]) == data_size;
+}
+
+// find a block compressed file. Returns false if the file is not
+// found or is not block compressed
+bool AP_ROMFS::find_blocks(const char *name, block_file &bf)
+{
+#ifdef HAL_ROMFS_UNCOMPRESSED
+    return false;
+#else
+    uint32_t compressed_size = 0;
+    uint32_t crc;
+    const uint8_t *compressed_data = find_file(name, compressed_size, crc);
+    if (!compressed_data) {
+        return false;
+    }
+    return parse_blocks(compressed_data, compressed_size, bf);
+#endif
+}
+
+/*
+  decompress one block of a block compressed file into buf, which
+  must hold block_size bytes. Returns the decompressed length, or -1
+  on error
+*/
+int32_t AP_ROMFS::decompress_block(const block_file &bf, uint32_t block, uint8_t *buf)
+{
+    if (block >= bf.num_blocks) {
+        return -1;
+    }
+    const uint8_t *index = &bf.data[AP_ROMFS_BLOCK_HEADER_SIZE];
+    const uint32_t start = get_le32(&index[4*block]);
+    const uint32_t end = get_le32(&index[4*(block+1)]);
+    const uint32_t crc = get_le32(&index[4*(bf.num_blocks+1) + 4*block]);
+    const uint32_t len = MIN(bf.block_size, bf.size - block*bf.block_size);
+    if (start >= end || end > get_le32(&index[4*bf.num_blocks])) {
+        return -1;
+    }
+
+    TINF_DATA *d = (TINF_DATA *)malloc(sizeof(TINF_DATA));
+    if (!d) {
+        return -1;
+    }
+    uzlib_uncompress_init(d, NULL, 0);
+
+    // blocks are raw deflate streams, with no header
+    d->source = &bf.data[start];
+    d->source_limit = &bf.data[end];
+    d->dest = buf;
+    d->destSize = len;
+
+    const int res = uzlib_uncompress(d);
+
+    ::free(d);
+
+    if (res != TINF_OK || crc32_small(0, buf, len) != crc) {
+        return -1;
+    }
+    return len;
+}
+
 /*
   directory listing interface. Start with ofs=0. Returns pathnames
   that match dirname prefix. Ends with nullptr return when no more
@@ -7,7 +7,7 @@
 
 class AP_ROMFS {
 public:
-    // find a file and de-compress, assumning gzip format. The
+    // find a file and de-compress, gzip or block compressed. The
     // decompressed data will be allocated with malloc(). You must
     // call AP_ROMFS::free() on the return value after use. The next byte after
     // the file data is guaranteed to be null.
@@ -16,6 +16,28 @@ public:
     // free returned data
     static void free(const uint8_t *data);
 
+    // find the decompressed size of a file without decompressing it
+    static bool find_size(const char *name, uint32_t &size);
+
+    /*
+      large files are compressed in independent blocks, so they can be
+      read a block at a time with only one block in RAM
+     */
+    struct block_file {
+        const uint8_t *data;        // embedded data, starting with the block index
+        uint32_t size;              // decompressed size
+        uint32_t block_size;        // decompressed size of all but the last block
+        uint32_t num_blocks;
+    };
+
+    // find a block compressed file. Returns false if the file is
+    // not found or is not block compressed
+    static bool find_blocks(const char *name, block_file &bf);
+
+    // decompress one block into buf, which must hold block_size
+    // bytes. Returns the decompressed length, or -1 on error
+    static int32_t decompress_block(const block_file &bf, uint32_t block, uint8_t *buf);
+
     /*
       directory listing interface. Start with ofs=0. Returns pathnames
       that match dirname prefix. Ends with nullptr return when no more
@@ -27,6 +49,9 @@ private:
     // find an embedded file
     static const uint8_t *find_file(const char *name, uint32_t &size, uint32_t &crc);
 
+    // parse the header of a block compressed file
+    static bool parse_blocks(const uint8_t *data, uint32_t data_size, block_file &bf);
+
     struct embedded_file {
         const char *filename;
         uint32_t size;
@@ -19,6 +19,12 @@ public:
 
     int64_t get_link_offset_usec(void) const { return link_offset_usec; }
 
+    // start again, for a different remote system
+    void reset(void) {
+        initialised = false;
+        min_sample_counter = 0;
+    }
+
 private:
     const uint16_t max_lag_ms;
     const uint16_t convergence_loops;
@@ -51,6 +51,7 @@
 #include "AP_RangeFinder_MSP.h"
 #include "AP_RangeFinder_USD1_CAN.h"
 #include "AP_RangeFinder_Benewake_CAN.h"
+#include "AP_RangeFinder_Fused.h"
 
 #include <AP_BoardConfig/AP_BoardConfig.h>
 #include <AP_Logger/AP_Logger.h>
@@ -228,9 +229,24 @@ void RangeFinder::update(void)
                 state[i].range_valid_count = 0;
                 continue;
             }
+#if AP_RANGEFINDER_FUSED_ENABLED
+            if (drivers[i]->allocated_type() == Type::Fused) {
+                // updated below from this loop's readings
+                continue;
+            }
+#endif
+            drivers[i]->update();
+        }
+    }
+#if AP_RANGEFINDER_FUSED_ENABLED
+    for (uint8_t i=0; i<num_instances; i++) {
+        if (drivers[i] != nullptr &&
+            drivers[i]->allocated_type() == Type::Fused &&
+            (Type)params[i].type.get() != Type::NONE) {
             drivers[i]->update();
         }
     }
+#endif
 #if HAL_LOGGING_ENABLED
     Log_RFND();
 #endif
@@ -519,6 +535,11 @@ void RangeFinder::detect_instance(uint8_t instance, uint8_t& serial_instance)
     case Type::USD1_CAN:
 #if AP_RANGEFINDER_USD1_CAN_ENABLED
         _add_backend(new AP_RangeFinder_USD1_CAN(state[instance], params[instance]), instance);
+#endif
+        break;
+    case Type::Fused:
+#if AP_RANGEFINDER_FUSED_ENABLED
+        _add_backend(new AP_RangeFinder_Fused(state[instance], params[instance]), instance);
 #endif
         break;
     case Type::Benewake_CAN:
@@ -600,9 +621,41 @@ bool RangeFinder::has_orientation(enum Rotation orientation) const
     return (find_instance(orientation) != nullptr);
 }
 
+/*
+  true if a fused instance is combining this instance's readings
+ */
+bool RangeFinder::is_fused_source(uint8_t id) const
+{
+#if AP_RANGEFINDER_FUSED_ENABLED
+    for (uint8_t i=0; i<num_instances; i++) {
+        AP_RangeFinder_Backend *backend = get_backend(i);
+        if (backend != nullptr &&
+            backend->allocated_type() == Type::Fused &&
+            backend->status() == Status::Good &&
+            (static_cast<AP_RangeFinder_Fused*>(backend)->sources() & (1U << id)) != 0) {
+            return true;
+        }
+    }
+#endif
+    return false;
+}
+
 // find first range finder instance with the specified orientation
 AP_RangeFinder_Backend *RangeFinder::find_instance(enum Rotation orientation) const
 {
+#if AP_RANGEFINDER_FUSED_ENABLED
+    // a fused instance with a good reading is preferred over the
+    // sensors it combines
+    for (uint8_t i=0; i<num_instances; i++) {
+        AP_RangeFinder_Backend *backend = get_backend(i);
+        if (backend != nullptr &&
+            backend->allocated_type() == Type::Fused &&
+            backend->orientation() == orientation &&
+            backend->status() == Status::Good) {
+            return backend;
+        }
+    }
+#endif
     // first try for a rangefinder that is in range
     for (uint8_t i=0; i<num_instances; i++) {
         AP_RangeFinder_Backend *backend = get_backend(i);
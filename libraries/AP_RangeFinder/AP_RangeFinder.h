@@ -102,6 +102,7 @@ public:
         USD1_CAN = 33,
         Benewake_CAN = 34,
         TeraRanger_Serial = 35,
+        Fused = 36,
         SIM = 100,
     };
 
@@ -172,6 +173,10 @@ public:
 
     AP_RangeFinder_Backend *get_backend(uint8_t id) const;
 
+    // true if an instance's readings are being combined by a fused
+    // instance, in which case they should not be used on their own
+    bool is_fused_source(uint8_t id) const;
+
     // get rangefinder type for an ID
     Type get_type(uint8_t id) const {
         return id >= RANGEFINDER_MAX_INSTANCES? Type::NONE : Type(params[id].type.get());
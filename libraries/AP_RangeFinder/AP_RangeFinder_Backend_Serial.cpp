@@ -16,6 +16,7 @@
 #include <AP_HAL/AP_HAL.h>
 #include "AP_RangeFinder_Backend_Serial.h"
 #include <AP_SerialManager/AP_SerialManager.h>
+#include <AP_Math/AP_Math.h>
 
 #include <ctype.h>
 
@@ -60,3 +61,103 @@ void AP_RangeFinder_Backend_Serial::update(void)
         set_status(RangeFinder::Status::NoData);
     }
 }
+
+bool AP_RangeFinder_Backend_Serial::frame_checksum_ok(const FrameFormat &format, uint8_t *frame)
+{
+    const uint8_t len = format.frame_len;
+    switch (format.checksum) {
+    case FrameChecksum::SUM8: {
+        uint8_t sum = 0;
+        for (uint8_t i=0; i<len-1; i++) {
+            sum += frame[i];
+        }
+        return sum == frame[len-1];
+    }
+    case FrameChecksum::CRC8:
+        return crc_crc8(frame, len-1) == frame[len-1];
+    case FrameChecksum::CRC16_MODBUS:
+        return calc_crc_modbus(frame, len-2) == (frame[len-2] | (frame[len-1] << 8));
+    }
+    return false;
+}
+
+/*
+  drop the first byte of a bad frame and move up to the next place a
+  frame could start, so a frame that began inside the bad one is not
+  lost
+ */
+void AP_RangeFinder_Backend_Serial::frame_resync(const FrameFormat &format)
+{
+    uint8_t i = 1;
+    for (; i<frame_buf_len; i++) {
+        const uint8_t n = MIN(uint8_t(frame_buf_len - i), format.header_len);
+        if (memcmp(&frame_buf[i], format.header, n) == 0) {
+            break;
+        }
+    }
+    frame_buf_len -= i;
+    memmove(frame_buf, &frame_buf[i], frame_buf_len);
+}
+
+uint32_t AP_RangeFinder_Backend_Serial::parse_frames(const FrameFormat &format, const uint8_t *data, uint32_t len, uint16_t &count)
+{
+    uint32_t used = 0;
+    while (used < len) {
+        if (frame_buf_len < format.header_len) {
+            // look for the header, a byte at a time
+            const uint8_t c = data[used++];
+            if (c == format.header[frame_buf_len]) {
+                frame_buf[frame_buf_len++] = c;
+            } else {
+                frame_buf_len = (c == format.header[0]) ? 1 : 0;
+                frame_buf[0] = c;
+            }
+            continue;
+        }
+        // copy as much of the rest of the frame as we have
+        const uint32_t n = MIN(len - used, uint32_t(format.frame_len - frame_buf_len));
+        memcpy(&frame_buf[frame_buf_len], &data[used], n);
+        frame_buf_len += n;
+        used += n;
+        if (frame_buf_len < format.frame_len) {
+            break;
+        }
+        if (frame_checksum_ok(format, frame_buf)) {
+            handle_frame(frame_buf);
+            count++;
+            frame_buf_len = 0;
+        } else {
+            frame_resync(format);
+        }
+    }
+    return used;
+}
+
+uint16_t AP_RangeFinder_Backend_Serial::read_frames(const FrameFormat &format)
+{
+    if (uart == nullptr || format.frame_len > FRAME_MAX_LEN) {
+        return 0;
+    }
+    uint16_t count = 0;
+    // don't read beyond what was available on entry, so a fast
+    // sensor can't keep us here
+    uint32_t nbytes = uart->available();
+    while (nbytes > 0) {
+        ByteBuffer::IoVec vec[2];
+        if (uart->rx_peek(vec) > 0) {
+            const uint32_t used = parse_frames(format, vec[0].data, MIN(vec[0].len, nbytes), count);
+            uart->rx_consume(used);
+            nbytes -= used;
+        } else {
+            // port can't be read in place, fall back to a byte at a time
+            const int16_t r = uart->read();
+            if (r < 0) {
+                break;
+            }
+            const uint8_t c = r;
+            parse_frames(format, &c, 1, count);
+            nbytes--;
+        }
+    }
+    return count;
+}
@@ -31,4 +31,36 @@ protected:
 
     // maximum time between readings before we change state to NoData:
     virtual uint16_t read_timeout_ms() const { return 200; }
+
+    /*
+      support for sensors sending fixed length binary frames. A
+      backend describes its frames with a FrameFormat and calls
+      read_frames() from get_reading(), which parses the receive
+      buffer in place, syncs on the header, checks the checksum and
+      calls handle_frame() for each good frame
+     */
+    enum class FrameChecksum : uint8_t {
+        SUM8,           // low byte of the sum of the bytes before it
+        CRC8,           // crc_crc8() of the bytes before it
+        CRC16_MODBUS,   // calc_crc_modbus() of the bytes before it, little endian
+    };
+    struct FrameFormat {
+        uint8_t header[2];      // sync bytes, only header_len are used
+        uint8_t header_len;
+        uint8_t frame_len;      // including header and checksum
+        FrameChecksum checksum;
+    };
+    static constexpr uint8_t FRAME_MAX_LEN = 16;
+
+    // returns the number of good frames
+    uint16_t read_frames(const FrameFormat &format);
+    virtual void handle_frame(const uint8_t *frame) {}
+
+private:
+    uint32_t parse_frames(const FrameFormat &format, const uint8_t *data, uint32_t len, uint16_t &count);
+    static bool frame_checksum_ok(const FrameFormat &format, uint8_t *frame);
+    void frame_resync(const FrameFormat &format);
+
+    uint8_t frame_buf[FRAME_MAX_LEN];
+    uint8_t frame_buf_len;
 };
@@ -47,80 +47,48 @@ extern const AP_HAL::HAL& hal;
 // byte 7 (TF02 only)   TIME            Exposure time in two levels 0x03 and 0x06
 // byte 8               Checksum        Checksum byte, sum of bytes 0 to bytes 7
 
+void AP_RangeFinder_Benewake::handle_frame(const uint8_t *frame)
+{
+    // calculate distance
+    uint16_t dist = ((uint16_t)frame[3] << 8) | frame[2];
+    if (dist >= BENEWAKE_DIST_MAX_CM || dist == uint16_t(model_dist_max_cm())) {
+        // this reading is out of range. Note that we
+        // consider getting exactly the model dist max
+        // is out of range. This fixes an issue with
+        // the TF03 which can give exactly 18000 cm
+        // when out of range
+        count_out_of_range++;
+    } else if (!has_signal_byte()) {
+        // no signal byte from TFmini so add distance to sum
+        sum_cm += dist;
+        count++;
+    } else {
+        // TF02 provides signal reliability (good = 7 or 8)
+        if (frame[6] >= 7) {
+            // add distance to sum
+            sum_cm += dist;
+            count++;
+        } else {
+            // this reading is out of range
+            count_out_of_range++;
+        }
+    }
+}
+
 // distance returned in reading_m, signal_ok is set to true if sensor reports a strong signal
 bool AP_RangeFinder_Benewake::get_reading(float &reading_m)
 {
-    if (uart == nullptr) {
-        return false;
-    }
+    static const FrameFormat format {
+        { BENEWAKE_FRAME_HEADER, BENEWAKE_FRAME_HEADER }, 2,
+        BENEWAKE_FRAME_LENGTH, FrameChecksum::SUM8
+    };
 
-    float sum_cm = 0;
-    uint16_t count = 0;
-    uint16_t count_out_of_range = 0;
+    sum_cm = 0;
+    count = 0;
+    count_out_of_range = 0;
 
-    // read any available lines from the lidar
-    int16_t nbytes = uart->available();
-    while (nbytes-- > 0) {
-        int16_t r = uart->read();
-        if (r < 0) {
-            continue;
-        }
-        uint8_t c = (uint8_t)r;
-        // if buffer is empty and this byte is 0x59, add to buffer
-        if (linebuf_len == 0) {
-            if (c == BENEWAKE_FRAME_HEADER) {
-                linebuf[linebuf_len++] = c;
-            }
-        } else if (linebuf_len == 1) {
-            // if buffer has 1 element and this byte is 0x59, add it to buffer
-            // if not clear the buffer
-            if (c == BENEWAKE_FRAME_HEADER) {
-                linebuf[linebuf_len++] = c;
-            } else {
-                linebuf_len = 0;
-            }
-        } else {
-            // add character to buffer
-            linebuf[linebuf_len++] = c;
-            // if buffer now has 9 items try to decode it
-            if (linebuf_len == BENEWAKE_FRAME_LENGTH) {
-                // calculate checksum
-                uint8_t checksum = 0;
-                for (uint8_t i=0; i<BENEWAKE_FRAME_LENGTH-1; i++) {
-                    checksum += linebuf[i];
-                }
-                // if checksum matches extract contents
-                if (checksum == linebuf[BENEWAKE_FRAME_LENGTH-1]) {
-                    // calculate distance
-                    uint16_t dist = ((uint16_t)linebuf[3] << 8) | linebuf[2];
-                    if (dist >= BENEWAKE_DIST_MAX_CM || dist == uint16_t(model_dist_max_cm())) {
-                        // this reading is out of range. Note that we
-                        // consider getting exactly the model dist max
-                        // is out of range. This fixes an issue with
-                        // the TF03 which can give exactly 18000 cm
-                        // when out of range
-                        count_out_of_range++;
-                    } else if (!has_signal_byte()) {
-                        // no signal byte from TFmini so add distance to sum
-                        sum_cm += dist;
-                        count++;
-                    } else {
-                        // TF02 provides signal reliability (good = 7 or 8)
-                        if (linebuf[6] >= 7) {
-                            // add distance to sum
-                            sum_cm += dist;
-                            count++;
-                        } else {
-                            // this reading is out of range
-                            count_out_of_range++;
-                        }
-                    }
-                }
-                // clear buffer
-                linebuf_len = 0;
-            }
-        }
-    }
+    // read any available frames from the lidar
+    read_frames(format);
 
     if (count > 0) {
         // return average distance of readings
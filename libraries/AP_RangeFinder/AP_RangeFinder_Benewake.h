@@ -31,9 +31,12 @@ private:
     // get a reading
     // distance returned in reading_m
     bool get_reading(float &reading_m) override;
+    void handle_frame(const uint8_t *frame) override;
 
-    uint8_t linebuf[10];
-    uint8_t linebuf_len;
+    // readings from the frames of one get_reading() call
+    float sum_cm;
+    uint16_t count;
+    uint16_t count_out_of_range;
 };
 
 #endif  // AP_RANGEFINDER_BENEWAKE_ENABLED
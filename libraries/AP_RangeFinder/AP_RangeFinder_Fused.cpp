@@ -0,0 +1,114 @@
+/*
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "AP_RangeFinder_Fused.h"
+
+#if AP_RANGEFINDER_FUSED_ENABLED
+
+#include <AP_HAL/AP_HAL.h>
+#include <AP_Math/AP_Math.h>
+
+// readings older than this are not used
+#define FUSED_MAX_AGE_MS 200
+
+// readings more than this much older than the newest are not used
+#define FUSED_MAX_SKEW_MS 100
+
+// readings further than this from the median are rejected, in metres
+// and as a proportion of the median, whichever is larger
+#define FUSED_OUTLIER_M 0.2f
+#define FUSED_OUTLIER_RATIO 0.1f
+
+AP_RangeFinder_Fused::AP_RangeFinder_Fused(RangeFinder::RangeFinder_State &_state, AP_RangeFinder_Params &_params) :
+    AP_RangeFinder_Backend(_state, _params)
+{}
+
+void AP_RangeFinder_Fused::update(void)
+{
+    const RangeFinder *rangefinder = AP::rangefinder();
+    const uint32_t now_ms = AP_HAL::millis();
+
+    // unit vector along this instance's beam in body frame
+    Vector3f dir(1, 0, 0);
+    dir.rotate(orientation());
+
+    float dist[RANGEFINDER_MAX_INSTANCES];
+    uint8_t id[RANGEFINDER_MAX_INSTANCES];
+    uint8_t count = 0;
+    uint32_t newest_ms = 0;
+
+    for (uint8_t i=0; i<rangefinder->num_sensors(); i++) {
+        const AP_RangeFinder_Backend *b = rangefinder->get_backend(i);
+        if (b == nullptr || b == this ||
+            b->allocated_type() == RangeFinder::Type::Fused ||
+            b->orientation() != orientation() ||
+            b->status() != RangeFinder::Status::Good ||
+            now_ms - b->last_reading_ms() > FUSED_MAX_AGE_MS) {
+            continue;
+        }
+        // distance this sensor's reading implies at our own position
+        dist[count] = b->distance() + (b->get_pos_offset() - get_pos_offset()) * dir;
+        id[count] = i;
+        newest_ms = MAX(newest_ms, b->last_reading_ms());
+        count++;
+    }
+
+    if (count == 0 || newest_ms == _newest_source_ms) {
+        // nothing new
+        if (now_ms - state.last_reading_ms > FUSED_MAX_AGE_MS) {
+            _sources = 0;
+            set_status(RangeFinder::Status::NoData);
+        }
+        return;
+    }
+    _newest_source_ms = newest_ms;
+
+    // median of the readings, insertion sorted into a copy
+    float sorted[RANGEFINDER_MAX_INSTANCES];
+    for (uint8_t i=0; i<count; i++) {
+        uint8_t j = i;
+        while (j > 0 && sorted[j-1] > dist[i]) {
+            sorted[j] = sorted[j-1];
+            j--;
+        }
+        sorted[j] = dist[i];
+    }
+    const float median = (count & 1) ? sorted[count/2] : 0.5f * (sorted[count/2-1] + sorted[count/2]);
+    const float limit = MAX(FUSED_OUTLIER_M, FUSED_OUTLIER_RATIO * fabsf(median));
+
+    // average the readings that are close enough in time and value
+    float sum = 0;
+    uint8_t used = 0;
+    uint16_t sources = 0;
+    for (uint8_t i=0; i<count; i++) {
+        const AP_RangeFinder_Backend *b = rangefinder->get_backend(id[i]);
+        if (newest_ms - b->last_reading_ms() > FUSED_MAX_SKEW_MS ||
+            fabsf(dist[i] - median) > limit) {
+            continue;
+        }
+        sum += dist[i];
+        used++;
+        sources |= 1U << id[i];
+    }
+    if (used == 0) {
+        return;
+    }
+
+    state.distance_m = sum / used;
+    state.last_reading_ms = newest_ms;
+    _sources = sources;
+    update_status();
+}
+
+#endif  // AP_RANGEFINDER_FUSED_ENABLED
@@ -0,0 +1,52 @@
+/*
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include "AP_RangeFinder_Backend.h"
+
+#ifndef AP_RANGEFINDER_FUSED_ENABLED
+#define AP_RANGEFINDER_FUSED_ENABLED AP_RANGEFINDER_BACKEND_DEFAULT_ENABLED
+#endif
+
+#if AP_RANGEFINDER_FUSED_ENABLED
+
+/*
+  a virtual rangefinder combining the readings of all the other
+  rangefinders with the same orientation. Each reading is moved to
+  this instance's position offset, readings far from the median are
+  dropped and the rest are averaged
+ */
+class AP_RangeFinder_Fused : public AP_RangeFinder_Backend {
+public:
+    AP_RangeFinder_Fused(RangeFinder::RangeFinder_State &_state, AP_RangeFinder_Params &_params);
+
+    // update the state structure, called after all the real sensors
+    void update() override;
+
+    // mask of the instances used by the last fused reading
+    uint16_t sources() const { return _sources; }
+
+protected:
+
+    MAV_DISTANCE_SENSOR _get_mav_distance_sensor_type() const override {
+        return MAV_DISTANCE_SENSOR_UNKNOWN;
+    }
+
+private:
+    uint16_t _sources;
+    uint32_t _newest_source_ms;
+};
+
+#endif  // AP_RANGEFINDER_FUSED_ENABLED
@@ -33,50 +33,26 @@ extern const AP_HAL::HAL& hal;
  */
 #define LANBAO_MAX_RANGE_M 6
 
+void AP_RangeFinder_Lanbao::handle_frame(const uint8_t *frame)
+{
+    sum_range += float((frame[2]<<8) | frame[3]) * 0.001;
+    count++;
+}
+
 // read - return last value measured by sensor
 bool AP_RangeFinder_Lanbao::get_reading(float &reading_m)
 {
-    if (uart == nullptr) {
-        return false;
-    }
+    // format is: [ 0xA5 | 0x5A | distance-MSB-mm | distance-LSB-mm | crc16 ]
+    static const FrameFormat format {
+        { 0xA5, 0x5A }, 2, 6, FrameChecksum::CRC16_MODBUS
+    };
 
-    float sum_range = 0;
-    uint32_t count = 0;
+    sum_range = 0;
+    count = 0;
 
-    // format is: [ 0xA5 | 0x5A | distance-MSB-mm | distance-LSB-mm | crc16 ]
+    // read any available frames from the lidar
+    read_frames(format);
 
-    // read any available lines from the lidar
-    int16_t nbytes = uart->available();
-    while (nbytes-- > 0) {
-        int16_t b = uart->read();
-        if (b == -1) {
-            break;
-        }
-        if (buf_len == 0 && b != 0xA5) {
-            // discard
-            continue;
-        }
-        if (buf_len == 1 && b != 0x5A) {
-            // discard
-            if (b == 0xA5) {
-                buf[0] = b;
-            } else {
-                buf_len = 0;
-            }
-            continue;
-        }
-        buf[buf_len++] = b;
-        if (buf_len == sizeof(buf)) {
-            buf_len = 0;
-            uint16_t crc = (buf[5]<<8) | buf[4];
-            if (crc != calc_crc_modbus(buf, 4)) {
-                // bad CRC, discard
-                continue;
-            }
-            sum_range += float((buf[2]<<8) | buf[3]) * 0.001;
-            count++;
-        }
-    }
     if (count > 0) {
         reading_m = (sum_range / count);
         return reading_m <= LANBAO_MAX_RANGE_M?true:false;
@@ -37,9 +37,11 @@ private:
 
     // get a reading
     bool get_reading(float &reading_m) override;
+    void handle_frame(const uint8_t *frame) override;
 
-    uint8_t buf[6];
-    uint8_t buf_len = 0;
+    // readings from the frames of one get_reading() call
+    float sum_range;
+    uint32_t count;
 };
 
 #endif  // AP_RANGEFINDER_LANBAO_ENABLED
@@ -42,63 +42,39 @@ extern const AP_HAL::HAL& hal;
 // byte 3               STATUS          Status,Strengh,OverTemp
 // byte 4               CRC8            packet CRC
 
+void AP_RangeFinder_TeraRanger_Serial::handle_frame(const uint8_t *frame)
+{
+    // calculate distance
+    uint16_t dist = ((uint16_t)frame[1] << 8) | frame[2];
+    if (dist >= DIST_MAX_CM *10) {
+        // this reading is out of range and a bad read
+        bad_read++;
+    } else {
+        // check if reading is good, no errors, no overtemp, reading is not the special case of 1mm
+        if ((STATUS_MASK & frame[3]) == 0 && (dist != DISTANCE_ERROR)) {
+            // add distance to sum
+            sum_mm += dist;
+            count++;
+        } else {
+            // this reading is bad
+            bad_read++;
+        }
+    }
+}
+
 // distance returned in reading_m, set to true if sensor reports a good reading
 bool AP_RangeFinder_TeraRanger_Serial::get_reading(float &reading_m)
 {
-    if (uart == nullptr) {
-        return false;
-    }
+    static const FrameFormat format {
+        { FRAME_HEADER }, 1, FRAME_LENGTH, FrameChecksum::CRC8
+    };
 
-    float sum_mm = 0;
-    uint16_t count = 0;
-    uint16_t bad_read = 0;
+    sum_mm = 0;
+    count = 0;
+    bad_read = 0;
 
-    // read any available lines from the lidar
-    int16_t nbytes = uart->available();
-    while (nbytes-- > 0) {
-        int16_t r = uart->read();
-        if (r < 0) {
-            continue;
-        }
-        uint8_t c = (uint8_t)r;
-        // if buffer is empty and this byte is 0x57, add to buffer
-        if (linebuf_len == 0) {
-            if (c == FRAME_HEADER) {
-                linebuf[linebuf_len++] = c;
-            }
-        // buffer is not empty, add byte to buffer
-        } else {
-            // add character to buffer
-            linebuf[linebuf_len++] = c;
-            // if buffer now has 5 items try to decode it
-            if (linebuf_len == FRAME_LENGTH) {
-                // calculate CRC8 (tbd)
-                uint8_t crc = 0;
-                crc =crc_crc8(linebuf,FRAME_LENGTH-1);
-                // if crc matches, extract contents
-                if (crc == linebuf[FRAME_LENGTH-1]) {
-                    // calculate distance
-                    uint16_t dist = ((uint16_t)linebuf[1] << 8) | linebuf[2];
-                    if (dist >= DIST_MAX_CM *10) {
-                        // this reading is out of range and a bad read
-                        bad_read++;
-                    } else {
-                        // check if reading is good, no errors, no overtemp, reading is not the special case of 1mm
-                        if ((STATUS_MASK & linebuf[3]) == 0 && (dist != DISTANCE_ERROR)) {
-                            // add distance to sum
-                            sum_mm += dist;
-                            count++;
-                        } else {
-                            // this reading is bad
-                            bad_read++;
-                        }
-                    }
-                }
-                // clear buffer
-                linebuf_len = 0;
-            }
-        }
-    }
+    // read any available frames from the lidar
+    read_frames(format);
 
     if (count > 0) {
         // return average distance of readings since last update
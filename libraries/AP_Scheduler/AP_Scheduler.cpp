@@ -28,18 +28,48 @@
 #include <AP_InternalError/AP_InternalError.h>
 #include <AP_Common/ExpandingString.h>
 #include <AP_HAL/SIMState.h>
+#include <GCS_MAVLink/GCS.h>
 
 #if CONFIG_HAL_BOARD == HAL_BOARD_SITL
 #include <SITL/SITL.h>
 #endif
 #include <stdio.h>
 
+#if CONFIG_HAL_BOARD == HAL_BOARD_SITL
+#include <time.h>
+
+/*
+  CPU time used on the host by the calling thread. In SITL the
+  simulated clock stands still while a task runs, so with the
+  HOST_CPU_TIME option the perf info records this instead
+ */
+static uint64_t host_cpu_time_ns(void)
+{
+    struct timespec ts;
+    if (clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts) != 0) {
+        return 0;
+    }
+    return ts.tv_sec*1000000000ULL + ts.tv_nsec;
+}
+#endif
+
 #if APM_BUILD_COPTER_OR_HELI || APM_BUILD_TYPE(APM_BUILD_ArduSub)
 #define SCHEDULER_DEFAULT_LOOP_RATE 400
 #else
 #define SCHEDULER_DEFAULT_LOOP_RATE  50
 #endif
 
+// maximum load shedding level, at which the shed tasks run at 1/8 of
+// their rate
+#define SCHEDULER_SHED_LEVEL_MAX 3
+// percentage of main loops overrunning in a second which raises the
+// load shedding level
+#define SCHEDULER_SHED_RAISE_PCT 10
+// percentage of main loops overrunning below which the level is
+// lowered, after SCHEDULER_SHED_QUIET_S seconds
+#define SCHEDULER_SHED_LOWER_PCT 2
+#define SCHEDULER_SHED_QUIET_S 5
+
 #define debug(level, fmt, args...)   do { if ((level) <= _debug.get()) { hal.console->printf(fmt, ##args); }} while (0)
 
 extern const AP_HAL::HAL& hal;
@@ -63,10 +93,17 @@ const AP_Param::GroupInfo AP_Scheduler::var_info[] = {
     // @Param: OPTIONS
     // @DisplayName: Scheduling options
     // @Description: This controls optional aspects of the scheduler.
-    // @Bitmask: 0:Enable per-task perf info
+    // @Bitmask: 0:Enable per-task perf info,1:Deadline scheduling,2:Adaptive task time budgets,3:Fast loop trace,4:Load shedding,5:SITL host CPU time perf info
     // @User: Advanced
     AP_GROUPINFO("OPTIONS",  2, AP_Scheduler, _options, 0),
 
+    // @Param: SHED_PRI
+    // @DisplayName: Load shedding task priority
+    // @Description: With the load shedding option enabled, when more than 10% of main loops overrun in a second the tasks with this priority number or higher have their rates halved, down to at most 1/8 of their normal rate. The rates are restored a step at a time once fewer than 2% of loops have overrun for 5 seconds. Fast tasks are never shed.
+    // @Range: 4 255
+    // @User: Advanced
+    AP_GROUPINFO("SHED_PRI",  3, AP_Scheduler, _shed_priority, 100),
+
     AP_GROUPEND
 };
 
@@ -82,6 +119,7 @@ AP_Scheduler::AP_Scheduler()
     _singleton = this;
 
     AP_Param::setup_object_defaults(this, var_info);
+    _rsem.set_name("Scheduler");
 }
 
 /*
@@ -127,6 +165,7 @@ void AP_Scheduler::init(const AP_Scheduler::Task *tasks, uint8_t num_tasks, uint
     if (_options & uint8_t(Options::RECORD_TASK_INFO)) {
         perf_info.allocate_task_info(_num_tasks);
     }
+    update_scheduling_options();
 
     _log_performance_bit = log_performance_bit;
 
@@ -180,37 +219,17 @@ void AP_Scheduler::run(uint32_t time_available)
     uint8_t vehicle_tasks_offset = 0;
     uint8_t common_tasks_offset = 0;
 
+    // with deadline scheduling the non-fast tasks which are due are
+    // collected and run after the fast tasks, earliest deadline first
+    const bool deadline_scheduling = _ready_tasks != nullptr;
+    uint8_t num_ready = 0;
+
     for (uint8_t i=0; i<_num_tasks; i++) {
-        // determine which of the common task / vehicle task to run
-        bool run_vehicle_task = false;
-        if (vehicle_tasks_offset < _num_vehicle_tasks &&
-            common_tasks_offset < _num_common_tasks) {
-            // still have entries on both lists; compare the
-            // priorities.  In case of a tie the vehicle-specific
-            // entry wins.
-            const Task &vehicle_task = _vehicle_tasks[vehicle_tasks_offset];
-            const Task &common_task = _common_tasks[common_tasks_offset];
-            if (vehicle_task.priority <= common_task.priority) {
-                run_vehicle_task = true;
-            }
-        } else if (vehicle_tasks_offset < _num_vehicle_tasks) {
-            // out of common tasks to run
-            run_vehicle_task = true;
-        } else if (common_tasks_offset < _num_common_tasks) {
-            // out of vehicle tasks to run
-            run_vehicle_task = false;
-        } else {
-            // this is an error; the outside loop should have terminated
-            INTERNAL_ERROR(AP_InternalError::error_t::flow_of_control);
+        const Task *taskp = next_task(vehicle_tasks_offset, common_tasks_offset);
+        if (taskp == nullptr) {
             break;
         }
-
-        const AP_Scheduler::Task &task = run_vehicle_task ? _vehicle_tasks[vehicle_tasks_offset] : _common_tasks[common_tasks_offset];
-        if (run_vehicle_task) {
-            vehicle_tasks_offset++;
-        } else {
-            common_tasks_offset++;
-        }
+        const AP_Scheduler::Task &task = *taskp;
 
         if (task.priority > MAX_FAST_TASK_PRIORITIES) {
             const uint16_t dt = _tick_counter - _last_run[i];
@@ -219,6 +238,10 @@ void AP_Scheduler::run(uint32_t time_available)
             if (interval_ticks < 1) {
                 interval_ticks = 1;
             }
+            if (_shed_level > 0 && task.priority >= _shed_priority) {
+                // run lower priority tasks less often while overloaded
+                interval_ticks <<= _shed_level;
+            }
             if (dt < interval_ticks) {
                 // this task is not yet scheduled to run again
                 continue;
@@ -236,7 +259,17 @@ void AP_Scheduler::run(uint32_t time_available)
                 task_not_achieved++;
             }
 
-            if (_task_time_allowed > time_available) {
+            if (deadline_scheduling) {
+                // deadline is last_run + interval, so the slack is
+                // interval - dt ticks
+                ReadyTask &r = _ready_tasks[num_ready++];
+                r.task = &task;
+                r.index = i;
+                r.slack = int16_t(MAX(int32_t(interval_ticks) - int32_t(dt), int32_t(INT16_MIN)));
+                continue;
+            }
+
+            if (task_budget_us(task, i) > time_available) {
                 // not enough time to run this task.  Continue loop -
                 // maybe another task will fit into time remaining
                 continue;
@@ -245,49 +278,11 @@ void AP_Scheduler::run(uint32_t time_available)
             _task_time_allowed = get_loop_period_us();
         }
 
-        // run it
-        _task_time_started = now;
-        hal.util->persistent_data.scheduler_task = i;
-#if CONFIG_HAL_BOARD == HAL_BOARD_SITL
-        fill_nanf_stack();
-#endif
-        task.function();
-        hal.util->persistent_data.scheduler_task = -1;
-
-        // record the tick counter when we ran. This drives
-        // when we next run the event
-        _last_run[i] = _tick_counter;
-
-        // work out how long the event actually took
-        now = AP_HAL::micros();
-        uint32_t time_taken = now - _task_time_started;
-        bool overrun = false;
-        if (time_taken > _task_time_allowed) {
-            overrun = true;
-            // the event overran!
-            debug(3, "Scheduler overrun task[%u-%s] (%u/%u)\n",
-                  (unsigned)i,
-                  task.name,
-                  (unsigned)time_taken,
-                  (unsigned)_task_time_allowed);
-        }
+        run_task(task, i, now, time_available);
+    }
 
-        perf_info.update_task_info(i, time_taken, overrun);
-
-        if (time_taken >= time_available) {
-            /*
-              we are out of time, but we need to keep walking the task
-              table in case there is another fast loop task after this
-              task, plus we need to update the accouting so we can
-              work out if we need to allocate extra time for the loop
-              (lower the loop rate)
-              Just set time_available to zero, which means we will
-              only run fast tasks after this one
-             */
-            time_available = 0;
-        } else {
-            time_available -= time_taken;
-        }
+    if (deadline_scheduling) {
+        run_ready_by_deadline(num_ready, now, time_available);
     }
 
     // update number of spare microseconds
@@ -300,6 +295,141 @@ void AP_Scheduler::run(uint32_t time_available)
     }
 }
 
+/*
+  run a single task. _task_time_allowed must be set before calling
+ */
+void AP_Scheduler::run_task(const Task &task, uint8_t task_index, uint32_t &now, uint32_t &time_available)
+{
+    _task_time_started = now;
+    hal.util->persistent_data.scheduler_task = task_index;
+#if CONFIG_HAL_BOARD == HAL_BOARD_SITL
+    fill_nanf_stack();
+    const bool host_cpu_time = (_options & uint8_t(Options::HOST_CPU_TIME)) != 0;
+    const uint64_t host_start_ns = host_cpu_time ? host_cpu_time_ns() : 0;
+#endif
+#if AP_SCHEDULER_LOOP_TRACE_ENABLED
+    const bool trace_task = task.priority <= MAX_FAST_TASK_PRIORITIES;
+    if (trace_task) {
+        loop_trace.record(AP::LoopTrace::Event::TASK_START, task_index);
+    }
+#endif
+    task.function();
+#if AP_SCHEDULER_LOOP_TRACE_ENABLED
+    if (trace_task) {
+        loop_trace.record(AP::LoopTrace::Event::TASK_END, task_index);
+    }
+#endif
+    hal.util->persistent_data.scheduler_task = -1;
+
+    // record the tick counter when we ran. This drives
+    // when we next run the event
+    _last_run[task_index] = _tick_counter;
+
+    // work out how long the event actually took
+    now = AP_HAL::micros();
+    uint32_t time_taken = now - _task_time_started;
+    bool overrun = false;
+    if (time_taken > _task_time_allowed) {
+        overrun = true;
+        // the event overran!
+        debug(3, "Scheduler overrun task[%u-%s] (%u/%u)\n",
+              (unsigned)task_index,
+              task.name,
+              (unsigned)time_taken,
+              (unsigned)_task_time_allowed);
+    }
+
+    uint32_t perf_time_us = time_taken;
+#if CONFIG_HAL_BOARD == HAL_BOARD_SITL
+    if (host_cpu_time) {
+        perf_time_us = (host_cpu_time_ns() - host_start_ns + 500) / 1000;
+    }
+#endif
+    perf_info.update_task_info(task_index, MIN(perf_time_us, UINT16_MAX), overrun);
+    perf_info.update_task_estimate(task_index, MIN(time_taken, UINT16_MAX));
+
+    if (time_taken >= time_available) {
+        /*
+          we are out of time, but we need to keep walking the task
+          table in case there is another fast loop task after this
+          task, plus we need to update the accouting so we can
+          work out if we need to allocate extra time for the loop
+          (lower the loop rate)
+          Just set time_available to zero, which means we will
+          only run fast tasks after this one
+         */
+        time_available = 0;
+    } else {
+        time_available -= time_taken;
+    }
+}
+
+/*
+  return the time budget for admitting a task. With deadline
+  scheduling or adaptive task budgets this is the measured 95th
+  percentile runtime of the task, capped by the max_time_micros in the
+  task table. Until a task has been measured, or when neither option
+  is enabled, max_time_micros is used
+ */
+uint16_t AP_Scheduler::task_budget_us(const Task &task, uint8_t task_index) const
+{
+    const uint16_t estimate_us = perf_info.get_task_estimate(task_index);
+    if (estimate_us == 0) {
+        return task.max_time_micros;
+    }
+    return MIN(estimate_us, task.max_time_micros);
+}
+
+/*
+  run the due tasks earliest deadline first, admitting each one on
+  its task budget. Tasks which do not fit are left for a later tick,
+  where their deadline will have moved closer
+ */
+void AP_Scheduler::run_ready_by_deadline(uint8_t num_ready, uint32_t &now, uint32_t &time_available)
+{
+    // insertion sort on slack. The list is built in priority order
+    // and the sort is stable, so priority breaks ties
+    for (uint8_t i=1; i<num_ready; i++) {
+        const ReadyTask r = _ready_tasks[i];
+        uint8_t j = i;
+        while (j > 0 && _ready_tasks[j-1].slack > r.slack) {
+            _ready_tasks[j] = _ready_tasks[j-1];
+            j--;
+        }
+        _ready_tasks[j] = r;
+    }
+
+    for (uint8_t i=0; i<num_ready; i++) {
+        const ReadyTask &r = _ready_tasks[i];
+        if (task_budget_us(*r.task, r.index) > time_available) {
+            continue;
+        }
+        _task_time_allowed = r.task->max_time_micros;
+        run_task(*r.task, r.index, now, time_available);
+    }
+}
+
+/*
+  allocate the state needed for deadline scheduling and adaptive task
+  budgets if the options have been enabled, or free it when disabled
+ */
+void AP_Scheduler::update_scheduling_options()
+{
+    const bool deadline = (_options & uint8_t(Options::DEADLINE_SCHEDULING)) != 0;
+    const bool adaptive = (_options & uint8_t(Options::ADAPTIVE_TASK_BUDGETS)) != 0;
+    if ((deadline || adaptive) && !perf_info.has_task_estimates()) {
+        perf_info.allocate_task_estimates(_num_tasks);
+    } else if (!deadline && !adaptive && perf_info.has_task_estimates()) {
+        perf_info.free_task_estimates();
+    }
+    if (deadline && _ready_tasks == nullptr && perf_info.has_task_estimates()) {
+        _ready_tasks = new ReadyTask[_num_tasks];
+    } else if (!deadline && _ready_tasks != nullptr) {
+        delete[] _ready_tasks;
+        _ready_tasks = nullptr;
+    }
+}
+
 /*
   return number of micros until the current task reaches its deadline
  */
@@ -339,12 +469,25 @@ void AP_Scheduler::loop()
     hal.util->persistent_data.scheduler_task = -1;
 
     const uint32_t sample_time_us = AP_HAL::micros();
+#if AP_SCHEDULER_LOOP_TRACE_ENABLED
+    loop_trace.record(AP::LoopTrace::Event::SAMPLE);
+#endif
+#if CONFIG_HAL_BOARD == HAL_BOARD_SITL
+    const bool host_cpu_time = (_options & uint8_t(Options::HOST_CPU_TIME)) != 0;
+    const uint64_t host_start_ns = host_cpu_time ? host_cpu_time_ns() : 0;
+#endif
     
     if (_loop_timer_start_us == 0) {
         _loop_timer_start_us = sample_time_us;
         _last_loop_time_s = get_loop_period_s();
     } else {
         _last_loop_time_s = (sample_time_us - _loop_timer_start_us) * 1.0e-6;
+#if AP_SCHEDULER_LOOP_TRACE_ENABLED
+        // capture the events around a loop overrun
+        if (sample_time_us - _loop_timer_start_us > perf_info.get_overtime_threshold_micros()) {
+            loop_trace.trigger();
+        }
+#endif
     }
 
 #if CONFIG_HAL_BOARD == HAL_BOARD_SITL
@@ -404,10 +547,26 @@ void AP_Scheduler::loop()
     }
 
     // check loop time
+#if CONFIG_HAL_BOARD == HAL_BOARD_SITL
+    if (host_cpu_time) {
+        // CPU time of this loop's tasks and scheduling on the host
+        perf_info.check_loop_time((host_cpu_time_ns() - host_start_ns) / 1000);
+    } else
+#endif
     perf_info.check_loop_time(sample_time_us - _loop_timer_start_us);
+
+    if ((_options & uint8_t(Options::LOAD_SHEDDING)) || _shed_level > 0) {
+        update_load_shedding(sample_time_us - _loop_timer_start_us > perf_info.get_overtime_threshold_micros());
+    }
         
     _loop_timer_start_us = sample_time_us;
 
+#if AP_SCHEDULER_LOOP_TRACE_ENABLED
+    if (loop_trace.frozen()) {
+        loop_trace.update(should_log_performance());
+    }
+#endif
+
 #if AP_SIM_ENABLED && CONFIG_HAL_BOARD != HAL_BOARD_SITL
     hal.simstate->update();
 #endif
@@ -418,9 +577,12 @@ void AP_Scheduler::update_logging()
     if (debug_flags()) {
         perf_info.update_logging();
     }
-    if (_log_performance_bit != (uint32_t)-1 &&
-        AP::logger().should_log(_log_performance_bit)) {
+    if (should_log_performance()) {
         Log_Write_Performance();
+        Log_Write_Task_Percentiles();
+#if AP_HAL_SEMAPHORE_STATS_ENABLED
+        Log_Write_Semaphore_Stats();
+#endif
     }
     perf_info.set_loop_rate(get_loop_rate_hz());
     perf_info.reset();
@@ -430,6 +592,76 @@ void AP_Scheduler::update_logging()
     } else if ((_options & uint8_t(Options::RECORD_TASK_INFO)) && !perf_info.has_task_info()) {
         perf_info.allocate_task_info(_num_tasks);
     }
+#if AP_SCHEDULER_LOOP_TRACE_ENABLED
+    // dynamically update the fast loop trace
+    const bool loop_trace_enabled = (_options & uint8_t(Options::LOOP_TRACE)) != 0;
+    if (!loop_trace_enabled && loop_trace.enabled()) {
+        loop_trace.free();
+    } else if (loop_trace_enabled && !loop_trace.enabled()) {
+        loop_trace.allocate();
+    }
+#endif
+    update_scheduling_options();
+}
+
+/*
+  shed load when the main loop is persistently overrunning by running
+  the tasks at or below SCHED_SHED_PRI at a fraction of their rate,
+  one step at a time, and restore them once the load has been low for
+  a while. The gap between the raise and lower thresholds and the
+  quiet time stop the level chasing jitter
+ */
+void AP_Scheduler::update_load_shedding(bool overran)
+{
+    _shed_loops++;
+    if (overran) {
+        _shed_overruns++;
+    }
+    if (_shed_loops < get_loop_rate_hz()) {
+        return;
+    }
+    const uint8_t overrun_pct = uint32_t(_shed_overruns) * 100 / _shed_loops;
+    _shed_loops = 0;
+    _shed_overruns = 0;
+
+    uint8_t level = _shed_level;
+    if (!(_options & uint8_t(Options::LOAD_SHEDDING))) {
+        // option turned off, restore all task rates
+        level = 0;
+    } else if (overrun_pct > SCHEDULER_SHED_RAISE_PCT) {
+        _shed_quiet_s = 0;
+        if (level < SCHEDULER_SHED_LEVEL_MAX) {
+            level++;
+        }
+    } else if (overrun_pct < SCHEDULER_SHED_LOWER_PCT && level > 0) {
+        if (++_shed_quiet_s >= SCHEDULER_SHED_QUIET_S) {
+            _shed_quiet_s = 0;
+            level--;
+        }
+    } else {
+        _shed_quiet_s = 0;
+    }
+    if (level == _shed_level) {
+        return;
+    }
+    _shed_level = level;
+
+    GCS_SEND_TEXT(level > 0 ? MAV_SEVERITY_WARNING : MAV_SEVERITY_INFO,
+                  "Scheduler: load shedding level %u", unsigned(level));
+    const struct log_LoadShedding pkt {
+        LOG_PACKET_HEADER_INIT(LOG_LOAD_SHEDDING_MSG),
+        time_us     : AP_HAL::micros64(),
+        level       : level,
+        priority    : uint8_t(constrain_int16(_shed_priority, 0, UINT8_MAX)),
+        overrun_pct : overrun_pct,
+    };
+    AP::logger().WriteCriticalBlock(&pkt, sizeof(pkt));
+}
+
+bool AP_Scheduler::should_log_performance() const
+{
+    return _log_performance_bit != (uint32_t)-1 &&
+        AP::logger().should_log(_log_performance_bit);
 }
 
 // Write a performance monitoring packet
@@ -456,11 +688,70 @@ void AP_Scheduler::Log_Write_Performance()
     AP::logger().WriteCriticalBlock(&pkt, sizeof(pkt));
 }
 
+// Write the runtime percentiles of each task that ran since the last reset
+void AP_Scheduler::Log_Write_Task_Percentiles()
+{
+    if (!perf_info.has_task_info()) {
+        return;
+    }
+    const uint64_t now_us = AP_HAL::micros64();
+    uint8_t vehicle_tasks_offset = 0;
+    uint8_t common_tasks_offset = 0;
+    for (uint8_t i = 0; i < _num_tasks; i++) {
+        const Task *task = next_task(vehicle_tasks_offset, common_tasks_offset);
+        const AP::PerfInfo::TaskInfo* ti = perf_info.get_task_info(i);
+        if (task == nullptr || ti == nullptr) {
+            return;
+        }
+        if (ti->tick_count == 0) {
+            continue;
+        }
+        struct log_TaskPercentiles pkt = {
+            LOG_PACKET_HEADER_INIT(LOG_TASK_PERCENTILES_MSG),
+            time_us  : now_us,
+            task_id  : i,
+            name     : {},
+            count    : uint16_t(MIN(ti->tick_count, UINT16_MAX)),
+            p50_us   : ti->percentile_us(0.5),
+            p95_us   : ti->percentile_us(0.95),
+            p99_us   : ti->percentile_us(0.99),
+            p999_us  : ti->percentile_us(0.999),
+            max_us   : ti->max_time_us,
+            total_us : ti->elapsed_time_us,
+        };
+        strncpy_noterm(pkt.name, task->name, sizeof(pkt.name));
+        AP::logger().WriteBlock(&pkt, sizeof(pkt));
+    }
+}
+
+#if AP_HAL_SEMAPHORE_STATS_ENABLED
+// write out contention statistics of named semaphores
+void AP_Scheduler::Log_Write_Semaphore_Stats()
+{
+    const uint64_t now_us = AP_HAL::micros64();
+    for (AP_HAL::Semaphore *sem = AP_HAL::Semaphore::first_named(); sem != nullptr; sem = sem->next_named()) {
+        AP_HAL::Semaphore::Stats stats;
+        sem->get_stats(stats, true);
+        struct log_SemaphoreStats pkt = {
+            LOG_PACKET_HEADER_INIT(LOG_SEMAPHORE_STATS_MSG),
+            time_us      : now_us,
+            name         : {},
+            acquisitions : stats.acquisitions,
+            contended    : stats.contended,
+            max_wait_us  : stats.period_max_wait_us,
+            max_hold_us  : stats.period_max_hold_us,
+        };
+        strncpy_noterm(pkt.name, sem->get_name(), sizeof(pkt.name));
+        AP::logger().WriteBlock(&pkt, sizeof(pkt));
+    }
+}
+#endif
+
 // display task statistics as text buffer for @SYS/tasks.txt
 void AP_Scheduler::task_info(ExpandingString &str)
 {
     // a header to allow for machine parsers to determine format
-    str.printf("TasksV2\n");
+    str.printf("TasksV3\n");
 
     // dynamically enable statistics collection
     if (!(_options & uint8_t(Options::RECORD_TASK_INFO))) {
@@ -486,40 +777,45 @@ void AP_Scheduler::task_info(ExpandingString &str)
 
     for (uint8_t i = 0; i < _num_tasks; i++) {
         const AP::PerfInfo::TaskInfo* ti = perf_info.get_task_info(i);
-        const char *task_name;
-
-        // determine which of the common task / vehicle task to run
-        bool run_vehicle_task = false;
-        if (vehicle_tasks_offset < _num_vehicle_tasks &&
-            common_tasks_offset < _num_common_tasks) {
-            // still have entries on both lists; compare the
-            // priorities.  In case of a tie the vehicle-specific
-            // entry wins.
-            const Task &vehicle_task = _vehicle_tasks[vehicle_tasks_offset];
-            const Task &common_task = _common_tasks[common_tasks_offset];
-            if (vehicle_task.priority <= common_task.priority) {
-                run_vehicle_task = true;
-            }
-        } else if (vehicle_tasks_offset < _num_vehicle_tasks) {
-            // out of common tasks to run
-            run_vehicle_task = true;
-        } else if (common_tasks_offset < _num_common_tasks) {
-            // out of vehicle tasks to run
-            run_vehicle_task = false;
-        } else {
-            // this is an error; the outside loop should have terminated
-            INTERNAL_ERROR(AP_InternalError::error_t::flow_of_control);
+        const Task *task = next_task(vehicle_tasks_offset, common_tasks_offset);
+        if (task == nullptr) {
             return;
         }
+        ti->print(task->name, total_time, str);
+    }
+}
 
-        if (run_vehicle_task) {
-            task_name = _vehicle_tasks[vehicle_tasks_offset++].name;
-        } else {
-            task_name = _common_tasks[common_tasks_offset++].name;
+/*
+  return the next task in priority order from the vehicle and common
+  task lists. In case of a tie the vehicle-specific entry wins.
+ */
+const AP_Scheduler::Task *AP_Scheduler::next_task(uint8_t &vehicle_tasks_offset, uint8_t &common_tasks_offset) const
+{
+    bool run_vehicle_task = false;
+    if (vehicle_tasks_offset < _num_vehicle_tasks &&
+        common_tasks_offset < _num_common_tasks) {
+        // still have entries on both lists; compare the priorities
+        const Task &vehicle_task = _vehicle_tasks[vehicle_tasks_offset];
+        const Task &common_task = _common_tasks[common_tasks_offset];
+        if (vehicle_task.priority <= common_task.priority) {
+            run_vehicle_task = true;
         }
+    } else if (vehicle_tasks_offset < _num_vehicle_tasks) {
+        // out of common tasks to run
+        run_vehicle_task = true;
+    } else if (common_tasks_offset < _num_common_tasks) {
+        // out of vehicle tasks to run
+        run_vehicle_task = false;
+    } else {
+        // this is an error; the caller should have terminated
+        INTERNAL_ERROR(AP_InternalError::error_t::flow_of_control);
+        return nullptr;
+    }
 
-        ti->print(task_name, total_time, str);
+    if (run_vehicle_task) {
+        return &_vehicle_tasks[vehicle_tasks_offset++];
     }
+    return &_common_tasks[common_tasks_offset++];
 }
 
 namespace AP {
@@ -31,6 +31,7 @@
 #include <AP_HAL/Util.h>
 #include <AP_Math/AP_Math.h>
 #include "PerfInfo.h"       // loop perf monitoring
+#include "LoopTrace.h"      // fast loop event trace
 
 #if HAL_MINIMIZE_FEATURES
 #define AP_SCHEDULER_NAME_INITIALIZER(_clazz,_name) .name = #_name,
@@ -95,7 +96,12 @@ public:
     };
 
     enum class Options : uint8_t {
-        RECORD_TASK_INFO = 1 << 0
+        RECORD_TASK_INFO = 1 << 0,
+        DEADLINE_SCHEDULING = 1 << 1,
+        ADAPTIVE_TASK_BUDGETS = 1 << 2,
+        LOOP_TRACE = 1 << 3,
+        LOAD_SHEDDING = 1 << 4,
+        HOST_CPU_TIME = 1 << 5,
     };
 
     enum FastTaskPriorities {
@@ -118,6 +124,14 @@ public:
     // write out PERF message to logger
     void Log_Write_Performance();
 
+    // write out per-task runtime percentiles to logger
+    void Log_Write_Task_Percentiles();
+
+#if AP_HAL_SEMAPHORE_STATS_ENABLED
+    // write out contention statistics of named semaphores to logger
+    void Log_Write_Semaphore_Stats();
+#endif
+
     // call when one tick has passed
     void tick(void);
 
@@ -182,6 +196,12 @@ public:
         return extra_loop_us;
     }
 
+    // get the current load shedding level. Tasks with a priority of
+    // SCHED_SHED_PRI or above run at 1/2^level of their rate
+    uint8_t get_shed_level(void) const {
+        return _shed_level;
+    }
+
     HAL_Semaphore &get_semaphore(void) { return _rsem; }
 
     void task_info(ExpandingString &str);
@@ -191,7 +211,38 @@ public:
     // loop performance monitoring:
     AP::PerfInfo perf_info;
 
+#if AP_SCHEDULER_LOOP_TRACE_ENABLED
+    // fast loop event trace
+    AP::LoopTrace loop_trace;
+#endif
+
 private:
+    // return the next task in priority order from the merged vehicle
+    // and common task lists, advancing the offsets into those lists
+    const Task *next_task(uint8_t &vehicle_tasks_offset, uint8_t &common_tasks_offset) const;
+
+    // run a single task, updating timing statistics and the time
+    // remaining in this loop
+    void run_task(const Task &task, uint8_t task_index, uint32_t &now, uint32_t &time_available);
+
+    // run the tasks collected in _ready_tasks in order of deadline
+    void run_ready_by_deadline(uint8_t num_ready, uint32_t &now, uint32_t &time_available);
+
+    // return the time budget used to decide if a task fits in the
+    // time remaining in this loop
+    uint16_t task_budget_us(const Task &task, uint8_t task_index) const;
+
+    // allocate or free the state needed for deadline scheduling and
+    // adaptive task budgets according to the current options
+    void update_scheduling_options();
+
+    // return true if the PERF log bit is set and we are logging
+    bool should_log_performance() const;
+
+    // count main loop overruns and, once a second, raise or lower the
+    // load shedding level
+    void update_load_shedding(bool overran);
+
     // used to enable scheduler debugging
     AP_Int8 _debug;
 
@@ -203,6 +254,10 @@ private:
 
     // scheduler options
     AP_Int8 _options;
+
+    // lowest priority (highest number) of tasks kept at their full
+    // rate when shedding load
+    AP_Int16 _shed_priority;
     
     // calculated loop period in usec
     uint16_t _loop_period_us;
@@ -228,6 +283,16 @@ private:
     // tick counter at the time we last ran each task
     uint16_t *_last_run;
 
+    // a task that is due to run, used for deadline scheduling
+    struct ReadyTask {
+        const Task *task;
+        // ticks until the deadline of the task; negative when late
+        int16_t slack;
+        uint8_t index;
+    };
+    // tasks due to run in this tick when deadline scheduling
+    ReadyTask *_ready_tasks;
+
     // number of microseconds allowed for the current task
     uint32_t _task_time_allowed;
 
@@ -262,6 +327,13 @@ private:
     // the loop rate in case we are well over budget
     uint32_t extra_loop_us;
 
+    // load shedding state. Loops and overruns are counted over one
+    // second and the level changed by at most one step each second
+    uint8_t _shed_level;
+    uint8_t _shed_quiet_s;      // seconds the load has been low enough to lower the level
+    uint16_t _shed_loops;
+    uint16_t _shed_overruns;
+
 
     // semaphore that is held while not waiting for ins samples
     HAL_Semaphore _rsem;
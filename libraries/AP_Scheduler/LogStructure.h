@@ -0,0 +1,91 @@
+#pragma once
+
+#include <AP_Logger/LogStructure.h>
+
+#define LOG_IDS_FROM_SCHEDULER \
+    LOG_TASK_PERCENTILES_MSG, \
+    LOG_LOOP_TRACE_MSG, \
+    LOG_SEMAPHORE_STATS_MSG, \
+    LOG_LOAD_SHEDDING_MSG
+
+// @LoggerMessage: TSKP
+// @Description: Scheduler per-task runtime percentiles, written once a second when per-task perf info is enabled
+// @Field: TimeUS: Time since system startup
+// @Field: Id: task index in the scheduler task list
+// @Field: Name: task name, truncated
+// @Field: N: number of times the task ran in this period
+// @Field: P50: median task runtime
+// @Field: P95: 95th percentile task runtime
+// @Field: P99: 99th percentile task runtime
+// @Field: P999: 99.9th percentile task runtime
+// @Field: Max: maximum task runtime
+// @Field: Tot: total task runtime in this period
+struct PACKED log_TaskPercentiles {
+    LOG_PACKET_HEADER;
+    uint64_t time_us;
+    uint8_t task_id;
+    char name[16];
+    uint16_t count;
+    uint16_t p50_us;
+    uint16_t p95_us;
+    uint16_t p99_us;
+    uint16_t p999_us;
+    uint16_t max_us;
+    uint32_t total_us;
+};
+
+// @LoggerMessage: LTRC
+// @Description: Scheduler fast loop trace, written after a loop overrun when the loop trace is enabled
+// @Field: TimeUS: Time of the event since system startup
+// @Field: Seq: index of the event in the trace
+// @Field: Ev: event type, 0:IMU sample, 1:fast task start, 2:fast task end, 3:RCOutput push, 4:trigger
+// @Field: Task: scheduler task index for task events
+struct PACKED log_LoopTrace {
+    LOG_PACKET_HEADER;
+    uint64_t time_us;
+    uint16_t seq;
+    uint8_t event;
+    uint8_t task;
+};
+
+// @LoggerMessage: LOCK
+// @Description: Semaphore contention statistics, written once a second for each named semaphore when semaphore statistics are built in
+// @Field: TimeUS: Time since system startup
+// @Field: Name: semaphore name
+// @Field: N: number of times the semaphore has been taken
+// @Field: NC: number of times a take had to wait for the semaphore
+// @Field: MaxW: longest wait to take the semaphore since the last message
+// @Field: MaxH: longest time the semaphore was held since the last message
+struct PACKED log_SemaphoreStats {
+    LOG_PACKET_HEADER;
+    uint64_t time_us;
+    char name[16];
+    uint32_t acquisitions;
+    uint32_t contended;
+    uint32_t max_wait_us;
+    uint32_t max_hold_us;
+};
+
+// @LoggerMessage: SHED
+// @Description: Scheduler load shedding level change
+// @Field: TimeUS: Time since system startup
+// @Field: Lvl: new load shedding level, shed tasks run at 1/2^Lvl of their rate
+// @Field: Pri: lowest task priority number that is shed
+// @Field: OvPct: percentage of main loops that overran in the last second
+struct PACKED log_LoadShedding {
+    LOG_PACKET_HEADER;
+    uint64_t time_us;
+    uint8_t level;
+    uint8_t priority;
+    uint8_t overrun_pct;
+};
+
+#define LOG_STRUCTURE_FROM_SCHEDULER \
+    { LOG_TASK_PERCENTILES_MSG, sizeof(log_TaskPercentiles), \
+      "TSKP", "QBNHHHHHHI", "TimeUS,Id,Name,N,P50,P95,P99,P999,Max,Tot", "s#--ssssss", "F---FFFFFF" }, \
+    { LOG_LOOP_TRACE_MSG, sizeof(log_LoopTrace), \
+      "LTRC", "QHBB", "TimeUS,Seq,Ev,Task", "s---", "F---" }, \
+    { LOG_SEMAPHORE_STATS_MSG, sizeof(log_SemaphoreStats), \
+      "LOCK", "QNIIII", "TimeUS,Name,N,NC,MaxW,MaxH", "s#--ss", "F---FF" }, \
+    { LOG_LOAD_SHEDDING_MSG, sizeof(log_LoadShedding), \
+      "SHED", "QBBB", "TimeUS,Lvl,Pri,OvPct", "s--%", "F---" },
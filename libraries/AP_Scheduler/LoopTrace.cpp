@@ -0,0 +1,123 @@
+#include "AP_Scheduler.h"
+
+#if AP_SCHEDULER_LOOP_TRACE_ENABLED
+
+#include <AP_Logger/AP_Logger.h>
+
+extern const AP_HAL::HAL& hal;
+
+// number of LTRC messages written per loop when logging a frozen trace
+#define LOOP_TRACE_LOG_ENTRIES_PER_LOOP 8
+
+void AP::LoopTrace::allocate()
+{
+    _entries = new Entry[TRACE_LENGTH];
+    if (_entries == nullptr) {
+        DEV_PRINTF("Unable to allocate scheduler LoopTrace\n");
+        return;
+    }
+    rearm();
+}
+
+void AP::LoopTrace::free()
+{
+    delete[] _entries;
+    _entries = nullptr;
+}
+
+// restart recording, discarding the current trace
+void AP::LoopTrace::rearm()
+{
+    _head = 0;
+    _count = 0;
+    _post_trigger = 0;
+    _log_ofs = 0;
+    _dumped = false;
+    _frozen = false;
+}
+
+void AP::LoopTrace::trigger()
+{
+    if (_entries == nullptr || _frozen || _post_trigger > 0) {
+        return;
+    }
+    record(Event::TRIGGER);
+    _trigger_us = AP_HAL::micros();
+    _post_trigger = TRACE_POST_TRIGGER;
+}
+
+void AP::LoopTrace::update(bool log_enabled)
+{
+    if (_entries == nullptr || !_frozen) {
+        return;
+    }
+    if (_dumped) {
+        rearm();
+        return;
+    }
+    if (!log_enabled) {
+        // keep the trace until it is read from @SYS/trace.bin
+        return;
+    }
+    write_log_entries(LOOP_TRACE_LOG_ENTRIES_PER_LOOP);
+    if (_log_ofs >= _count) {
+        rearm();
+    }
+}
+
+/*
+  write the next entries of a frozen trace to the log
+ */
+void AP::LoopTrace::write_log_entries(uint8_t max_entries)
+{
+    // timestamps are extended to 64 bits relative to now
+    const uint64_t now64 = AP_HAL::micros64();
+    const uint32_t now32 = uint32_t(now64);
+    const uint16_t start = (_head - _count) & (TRACE_LENGTH - 1);
+    for (uint8_t i = 0; i < max_entries && _log_ofs < _count; i++) {
+        const Entry &e = _entries[(start + _log_ofs) & (TRACE_LENGTH - 1)];
+        const struct log_LoopTrace pkt {
+            LOG_PACKET_HEADER_INIT(LOG_LOOP_TRACE_MSG),
+            time_us : now64 - (now32 - e.time_us),
+            seq     : _log_ofs,
+            event   : e.event,
+            task    : e.task,
+        };
+        AP::logger().WriteBlock(&pkt, sizeof(pkt));
+        _log_ofs++;
+    }
+}
+
+/*
+  fill str with the contents of @SYS/trace.bin. This is called from
+  the filesystem thread, so the trace may change while a trace that
+  is not frozen is copied
+ */
+void AP::LoopTrace::dump(ExpandingString &str, uint16_t loop_rate_hz)
+{
+    if (_entries == nullptr) {
+        return;
+    }
+    const bool frozen = _frozen;
+    const uint16_t count = _count;
+    const uint16_t start = (_head - count) & (TRACE_LENGTH - 1);
+    const FileHeader hdr {
+        FILE_MAGIC,
+        FILE_VERSION,
+        loop_rate_hz,
+        count,
+        frozen,
+        0,
+        _trigger_us,
+    };
+    str.append((const char *)&hdr, sizeof(hdr));
+    // copy the oldest entries up to the end of the ring, then the rest
+    const uint16_t n1 = MIN(count, uint16_t(TRACE_LENGTH - start));
+    str.append((const char *)&_entries[start], n1 * sizeof(Entry));
+    str.append((const char *)&_entries[0], (count - n1) * sizeof(Entry));
+    if (frozen) {
+        _dumped = true;
+    }
+}
+
+#endif  // AP_SCHEDULER_LOOP_TRACE_ENABLED
@@ -0,0 +1,121 @@
+#pragma once
+
+#include <AP_HAL/AP_HAL_Boards.h>
+#include <AP_HAL/AP_HAL.h>
+#include <AP_Common/ExpandingString.h>
+
+#ifndef AP_SCHEDULER_LOOP_TRACE_ENABLED
+#define AP_SCHEDULER_LOOP_TRACE_ENABLED HAL_SCHEDULER_ENABLED
+#endif
+
+#if AP_SCHEDULER_LOOP_TRACE_ENABLED
+
+namespace AP {
+
+/*
+  a RAM ring of fast loop events with microsecond timestamps, for
+  looking at the loop jitter that the 1Hz PM message averages
+  away. When triggered, for example by a loop overrun, the ring is
+  frozen TRACE_POST_TRIGGER events later so it holds the events
+  either side of the trigger. A frozen trace is written to the log
+  as LTRC messages and can be read from @SYS/trace.bin, after which
+  recording restarts
+ */
+class LoopTrace {
+public:
+    LoopTrace() {}
+
+    /* Do not allow copies */
+    CLASS_NO_COPY(LoopTrace);
+
+    enum class Event : uint8_t {
+        SAMPLE = 0,         // wait_for_sample() returned
+        TASK_START = 1,     // a fast task started
+        TASK_END = 2,       // a fast task ended
+        RCOUT_PUSH = 3,     // outputs were pushed to the RCOutput HAL
+        TRIGGER = 4,        // the trace was triggered
+    };
+
+    struct PACKED Entry {
+        uint32_t time_us;
+        uint8_t event;
+        uint8_t task;       // scheduler task index for task events
+    };
+
+    /*
+      header of @SYS/trace.bin, followed by num_entries Entry
+      structures, oldest first
+     */
+    struct PACKED FileHeader {
+        uint32_t magic;
+        uint16_t version;
+        uint16_t loop_rate_hz;
+        uint16_t num_entries;
+        uint8_t frozen;
+        uint8_t reserved;
+        uint32_t trigger_us;
+    };
+    static const uint32_t FILE_MAGIC = 0x4352544c; // "LTRC"
+    static const uint16_t FILE_VERSION = 1;
+
+    // number of entries in the ring, must be a power of 2
+    static const uint16_t TRACE_LENGTH = 1024;
+    // number of events recorded after a trigger
+    static const uint16_t TRACE_POST_TRIGGER = TRACE_LENGTH / 4;
+
+    void allocate();
+    void free();
+    bool enabled() const { return _entries != nullptr; }
+    bool frozen() const { return _frozen; }
+
+    // record an event. This is called in the fast loop so must be cheap
+    void record(Event event, uint8_t task=0) {
+        if (_entries == nullptr || _frozen) {
+            return;
+        }
+        Entry &e = _entries[_head];
+        e.time_us = AP_HAL::micros();
+        e.event = uint8_t(event);
+        e.task = task;
+        _head = (_head + 1) & (TRACE_LENGTH - 1);
+        if (_count < TRACE_LENGTH) {
+            _count++;
+        }
+        if (_post_trigger > 0 && --_post_trigger == 0) {
+            _frozen = true;
+        }
+    }
+
+    // trigger the trace, ignored if it is already triggered
+    void trigger();
+
+    // called from the main loop to write a frozen trace to the log
+    // a few entries at a time and to restart recording once it has
+    // been written or read
+    void update(bool log_enabled);
+
+    // fill str with the contents of @SYS/trace.bin
+    void dump(ExpandingString &str, uint16_t loop_rate_hz);
+
+private:
+    void write_log_entries(uint8_t max_entries);
+    void rearm();
+
+    Entry *_entries;
+    // index of the next entry to write
+    uint16_t _head;
+    // number of valid entries
+    uint16_t _count;
+    // events to record before freezing, zero if not triggered
+    uint16_t _post_trigger;
+    volatile bool _frozen;
+    // set by dump() so the main loop restarts recording
+    volatile bool _dumped;
+    uint32_t _trigger_us;
+    // number of entries of the frozen trace written to the log
+    uint16_t _log_ofs;
+};
+
+};
+
+#endif  // AP_SCHEDULER_LOOP_TRACE_ENABLED
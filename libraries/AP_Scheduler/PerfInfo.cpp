@@ -52,6 +52,54 @@ void AP::PerfInfo::free_task_info()
     _num_tasks = 0;
 }
 
+// allocate the array of measured task runtime estimates
+void AP::PerfInfo::allocate_task_estimates(uint8_t num_tasks)
+{
+    _task_time_est = new uint32_t[num_tasks];
+    if (_task_time_est == nullptr) {
+        DEV_PRINTF("Unable to allocate scheduler task estimates\n");
+        _num_task_estimates = 0;
+        return;
+    }
+    memset(_task_time_est, 0, num_tasks * sizeof(uint32_t));
+    _num_task_estimates = num_tasks;
+}
+
+void AP::PerfInfo::free_task_estimates()
+{
+    delete[] _task_time_est;
+    _task_time_est = nullptr;
+    _num_task_estimates = 0;
+}
+
+/*
+  update the decaying estimate of the 95th percentile runtime of a
+  task. This is a stochastic quantile estimator: each run above the
+  estimate moves it up by 19 steps for every step it moves down for a
+  run below, so it settles where 5% of runs are longer. The step is
+  proportional to the estimate so convergence speed is independent of
+  how expensive the task is
+ */
+void AP::PerfInfo::update_task_estimate(uint8_t task_index, uint16_t task_time_us)
+{
+    if (_task_time_est == nullptr || task_index >= _num_task_estimates) {
+        return;
+    }
+    uint32_t &est = _task_time_est[task_index];
+    const uint32_t sample = task_time_us * TASK_ESTIMATE_SCALE;
+    if (est == 0) {
+        // first measurement
+        est = sample;
+        return;
+    }
+    const uint32_t step = MAX(est / 16U, 20U);
+    if (sample > est) {
+        est = MIN(est + step * 19U / 20U, sample);
+    } else if (sample < est) {
+        est = MAX(est - step / 20U, MAX(sample, 1U));
+    }
+}
+
 // called after each run of a task to update its statistics based on measurements taken by the scheduler
 void AP::PerfInfo::update_task_info(uint8_t task_index, uint16_t task_time_us, bool overrun)
 {
@@ -67,8 +115,45 @@ void AP::PerfInfo::update_task_info(uint8_t task_index, uint16_t task_time_us, b
     ti.update(task_time_us, overrun);
 }
 
+/*
+  map a task time onto a histogram bucket. Times below 4us get their
+  own bucket, above that each power of two is split into two buckets
+ */
+static uint8_t histogram_bucket(uint16_t time_us)
+{
+    if (time_us < 4) {
+        return time_us;
+    }
+    const uint8_t msb = 31 - __builtin_clz(time_us);
+    const uint8_t sub = (time_us >> (msb-1)) & 1U;
+    return 2*msb + sub;
+}
+
+// lowest time in microseconds held in a histogram bucket
+static uint32_t histogram_bucket_low(uint8_t bucket)
+{
+    if (bucket < 4) {
+        return bucket;
+    }
+    const uint8_t msb = bucket / 2;
+    return uint32_t(2U | (bucket & 1U)) << (msb-1);
+}
+
+// one more than the highest time in microseconds held in a histogram bucket
+static uint32_t histogram_bucket_high(uint8_t bucket)
+{
+    if (bucket < 4) {
+        return bucket + 1;
+    }
+    return histogram_bucket_low(bucket) + (1U << (bucket/2 - 1));
+}
+
 void AP::PerfInfo::TaskInfo::update(uint16_t task_time_us, bool overrun)
 {
+    uint16_t &count = histogram[histogram_bucket(task_time_us)];
+    if (count < UINT16_MAX) {
+        count++;
+    }
     max_time_us = MAX(max_time_us, task_time_us);
     if (min_time_us == 0) {
         min_time_us = task_time_us;
@@ -82,6 +167,37 @@ void AP::PerfInfo::TaskInfo::update(uint16_t task_time_us, bool overrun)
     }
 }
 
+/*
+  estimate a percentile of the task time from the histogram,
+  interpolating linearly within the bucket holding the percentile
+ */
+uint16_t AP::PerfInfo::TaskInfo::percentile_us(float fraction) const
+{
+    uint32_t total = 0;
+    for (uint8_t i=0; i<TASK_HISTOGRAM_BUCKETS; i++) {
+        total += histogram[i];
+    }
+    if (total == 0) {
+        return 0;
+    }
+    const float target = constrain_float(fraction, 0, 1) * total;
+    uint32_t sum = 0;
+    for (uint8_t i=0; i<TASK_HISTOGRAM_BUCKETS; i++) {
+        if (histogram[i] == 0) {
+            continue;
+        }
+        if (sum + histogram[i] >= target) {
+            const uint32_t low = histogram_bucket_low(i);
+            const uint32_t width = histogram_bucket_high(i) - low;
+            const float t = low + width * (target - sum) / histogram[i];
+            // the histogram can never tell us more than the true bounds
+            return constrain_float(t, min_time_us, max_time_us);
+        }
+        sum += histogram[i];
+    }
+    return max_time_us;
+}
+
 void AP::PerfInfo::TaskInfo::print(const char* task_name, uint32_t total_time, ExpandingString& str) const
 {
     uint16_t avg = 0;
@@ -91,13 +207,15 @@ void AP::PerfInfo::TaskInfo::print(const char* task_name, uint32_t total_time, E
         avg = MIN(uint16_t(elapsed_time_us / tick_count), 9999);
     }
 #if HAL_MINIMIZE_FEATURES
-    const char* fmt = "%-16.16s MIN=%4u MAX=%4u AVG=%4u OVR=%3u SLP=%3u, TOT=%4.1f%%\n";
+    const char* fmt = "%-16.16s MIN=%4u MAX=%4u AVG=%4u OVR=%3u SLP=%3u, TOT=%4.1f%% P50=%4u P95=%4u P99=%4u P999=%4u\n";
 #else
-    const char* fmt = "%-32.32s MIN=%4u MAX=%4u AVG=%4u OVR=%3u SLP=%3u, TOT=%4.1f%%\n";
+    const char* fmt = "%-32.32s MIN=%4u MAX=%4u AVG=%4u OVR=%3u SLP=%3u, TOT=%4.1f%% P50=%4u P95=%4u P99=%4u P999=%4u\n";
 #endif
     str.printf(fmt, task_name,
                 unsigned(MIN(min_time_us, 9999)), unsigned(MIN(max_time_us, 9999)), unsigned(avg),
-                unsigned(MIN(overrun_count, 999)), unsigned(MIN(slip_count, 999)), pct);
+                unsigned(MIN(overrun_count, 999)), unsigned(MIN(slip_count, 999)), pct,
+                unsigned(MIN(percentile_us(0.5), 9999)), unsigned(MIN(percentile_us(0.95), 9999)),
+                unsigned(MIN(percentile_us(0.99), 9999)), unsigned(MIN(percentile_us(0.999), 9999)));
 }
 
 // check_loop_time - check latest loop time vs min, max and overtime threshold
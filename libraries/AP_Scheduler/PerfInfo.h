@@ -9,6 +9,12 @@ class PerfInfo {
 public:
     PerfInfo() {}
 
+    // number of log-scale buckets in the per-task runtime
+    // histogram. Buckets 0-3 hold exact times of 0-3us, above that
+    // each octave is split into two buckets, covering the full
+    // uint16_t range
+    static const uint8_t TASK_HISTOGRAM_BUCKETS = 32;
+
     // per-task timing information
     struct TaskInfo {
         uint16_t min_time_us;
@@ -17,9 +23,13 @@ public:
         uint32_t tick_count;
         uint16_t slip_count;
         uint16_t overrun_count;
+        uint16_t histogram[TASK_HISTOGRAM_BUCKETS];
 
         void update(uint16_t task_time_us, bool overrun);
         void print(const char* task_name, uint32_t total_time, ExpandingString& str) const;
+        // return the estimated task time in microseconds below which
+        // the given fraction (0 to 1) of task runs completed
+        uint16_t percentile_us(float fraction) const;
     };
 
     /* Do not allow copies */
@@ -37,6 +47,8 @@ public:
     float    get_filtered_time() const;
     float get_filtered_loop_rate_hz() const;
     void set_loop_rate(uint16_t rate_hz);
+    // loop time above which a loop is counted as long running
+    uint16_t get_overtime_threshold_micros() const { return overtime_threshold_micros; }
 
     void update_logging() const;
 
@@ -54,8 +66,25 @@ public:
     // record that a task slipped
     void task_slipped(uint8_t task_index) {
         if (_task_info && task_index < _num_tasks) {
-            _task_info[task_index].overrun_count++;
+            _task_info[task_index].slip_count++;
+        }
+    }
+
+    // allocate the array of measured task runtime estimates used
+    // for deadline scheduling and adaptive task budgets
+    void allocate_task_estimates(uint8_t num_tasks);
+    void free_task_estimates();
+    // whether or not we have task runtime estimates allocated
+    bool has_task_estimates() const { return _task_time_est != nullptr; }
+    // update the runtime estimate of a task with a new measurement
+    void update_task_estimate(uint8_t task_index, uint16_t task_time_us);
+    // return the estimated 95th percentile runtime of a task in
+    // microseconds, or 0 if the task has not yet been measured
+    uint16_t get_task_estimate(uint8_t task_index) const {
+        if (_task_time_est == nullptr || task_index >= _num_task_estimates) {
+            return 0;
         }
+        return (_task_time_est[task_index] + TASK_ESTIMATE_SCALE - 1) / TASK_ESTIMATE_SCALE;
     }
 
 private:
@@ -73,6 +102,11 @@ private:
     // performance monitoring
     uint8_t _num_tasks;
     TaskInfo* _task_info;
+    // measured task runtime estimates, in units of
+    // 1/TASK_ESTIMATE_SCALE microseconds
+    static const uint32_t TASK_ESTIMATE_SCALE = 16;
+    uint8_t _num_task_estimates;
+    uint32_t* _task_time_est;
 };
 
 };
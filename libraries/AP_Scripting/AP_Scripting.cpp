@@ -78,7 +78,7 @@ const AP_Param::GroupInfo AP_Scripting::var_info[] = {
     // @Param: DEBUG_OPTS
     // @DisplayName: Scripting Debug Level
     // @Description: Debugging options
-    // @Bitmask: 0:No Scripts to run message if all scripts have stopped, 1:Runtime messages for memory usage and execution time, 2:Suppress logging scripts to dataflash, 3:log runtime memory usage and execution time, 4:Disable pre-arm check
+    // @Bitmask: 0:No Scripts to run message if all scripts have stopped, 1:Runtime messages for memory usage and execution time, 2:Suppress logging scripts to dataflash, 3:log runtime memory usage and execution time, 4:Disable pre-arm check, 5:Profile script execution, see @SYS/scripting_profile.txt
     // @User: Advanced
     AP_GROUPINFO("DEBUG_OPTS", 4, AP_Scripting, _debug_options, 0),
 
@@ -126,6 +126,31 @@ const AP_Param::GroupInfo AP_Scripting::var_info[] = {
     // @User: Advanced
     AP_GROUPINFO("DIR_DISABLE", 9, AP_Scripting, _dir_disable, 0),
 
+    // @Param: GC_STEP
+    // @DisplayName: Scripting garbage collection step
+    // @Description: Amount of incremental garbage collection done after each script run. 0 does a full collection after every run, which costs more CPU time as more scripts are loaded
+    // @Units: KB
+    // @Range: 0 64
+    // @User: Advanced
+    AP_GROUPINFO("GC_STEP", 12, AP_Scripting, _gc_step, 4),
+
+    // @Param: GC_FULL_PCT
+    // @DisplayName: Scripting full garbage collection threshold
+    // @Description: Memory usage, as a percentage of SCR_HEAP_SIZE, above which a full garbage collection is done after a script run instead of an incremental step
+    // @Units: %
+    // @Range: 10 100
+    // @User: Advanced
+    AP_GROUPINFO("GC_FULL_PCT", 13, AP_Scripting, _gc_full_pct, 75),
+
+    // @Param: RUN_TIME_MAX
+    // @DisplayName: Scripting maximum run time
+    // @Description: The longest time a script can run for each time it is called before it is considered to have taken an excessive amount of time, in addition to the SCR_VM_I_COUNT limit. Time spent in bindings counts against the script. 0 disables the time limit
+    // @Units: us
+    // @Range: 0 1000000
+    // @Increment: 100
+    // @User: Advanced
+    AP_GROUPINFO("RUN_TIME_MAX", 14, AP_Scripting, _run_time_max, 0),
+
     AP_GROUPEND
 };
 
@@ -223,7 +248,7 @@ void AP_Scripting::thread(void) {
         _restart = false;
         _init_failed = false;
 
-        lua_scripts *lua = new lua_scripts(_script_vm_exec_count, _script_heap_size, _debug_options, terminal);
+        lua_scripts *lua = new lua_scripts(_script_vm_exec_count, _script_heap_size, _debug_options, _gc_step, _gc_full_pct, _run_time_max, terminal);
         if (lua == nullptr || !lua->heap_allocated()) {
             gcs().send_text(MAV_SEVERITY_CRITICAL, "Scripting: %s", "Unable to allocate memory");
             _init_failed = true;
@@ -291,6 +316,7 @@ void AP_Scripting::handle_mission_command(const AP_Mission::Mission_Command& cmd
                                       AP_HAL::millis()};
 
     mission_data->push(cmd);
+    notify_event(Event::MISSION_CMD, cmd_in.p1);
 }
 
 bool AP_Scripting::arming_checks(size_t buflen, char *buffer) const
@@ -321,6 +347,25 @@ bool AP_Scripting::arming_checks(size_t buflen, char *buffer) const
     return true;
 }
 
+/*
+  print the script execution profile. Like @SYS/tasks.txt, the first
+  read turns on collection of the profile
+ */
+void AP_Scripting::profile_info(ExpandingString &str)
+{
+    str.printf("ScriptsV1\n");
+    if ((_debug_options.get() & uint8_t(lua_scripts::DebugLevel::PROFILE)) == 0) {
+        _debug_options.set(_debug_options.get() | uint8_t(lua_scripts::DebugLevel::PROFILE));
+        return;
+    }
+    lua_scripts::profile_info(str);
+}
+
+void AP_Scripting::notify_event(Event event, int32_t id)
+{
+    lua_scripts::notify_event(event, id);
+}
+
 void AP_Scripting::restart_all()
 {
     _restart = true;
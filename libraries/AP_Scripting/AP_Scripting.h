@@ -53,6 +53,21 @@ public:
     
     void restart_all(void);
 
+    // print the script execution profile for @SYS/scripting_profile.txt
+    void profile_info(class ExpandingString &str);
+
+    // events a script can be woken by, see wake_on()
+    enum class Event : uint8_t {
+        MISSION_CMD = 0,  // id is the command's p1
+        AUX_FUNCTION = 1, // id is the RC aux function
+        CAN_FRAME = 2,    // id is the CAN frame id
+        MODE_CHANGE = 3,  // id is the new mode
+        ARMING = 4,       // id is 1 for armed, 0 for disarmed
+    };
+
+    // wake any scripts waiting for an event, may be called from any thread
+    void notify_event(Event event, int32_t id);
+
    // User parameters for inputs into scripts 
    AP_Float _user[6];
 
@@ -103,6 +118,9 @@ private:
     AP_Int32 _script_heap_size;
     AP_Int8 _debug_options;
     AP_Int16 _dir_disable;
+    AP_Int16 _gc_step;
+    AP_Int8 _gc_full_pct;
+    AP_Int32 _run_time_max;
 
     bool _thread_failed; // thread allocation failed
     bool _init_failed;  // true if memory allocation failed
@@ -16,6 +16,7 @@
   Scripting CANSensor class, for easy scripting CAN support
  */
 #include "AP_Scripting_CANSensor.h"
+#include "AP_Scripting.h"
 
 #if HAL_MAX_CAN_PROTOCOL_DRIVERS
 
@@ -28,10 +29,14 @@ bool ScriptingCANSensor::write_frame(AP_HAL::CANFrame &out_frame, const uint32_t
 // handler for incoming frames, add to buffers
 void ScriptingCANSensor::handle_frame(AP_HAL::CANFrame &frame)
 {
-    WITH_SEMAPHORE(sem);
-    if (buffer_list != nullptr) {
+    {
+        WITH_SEMAPHORE(sem);
+        if (buffer_list == nullptr) {
+            return;
+        }
         buffer_list->handle_frame(frame);
     }
+    AP::scripting()->notify_event(AP_Scripting::Event::CAN_FRAME, frame.id_signed());
 }
 
 // add a new buffer to this sensor
@@ -60,10 +65,43 @@ bool ScriptingCANBuffer::read_frame(AP_HAL::CANFrame &frame)
 }
 
 // recursively add frame to buffer
+// read up to max_frames frames with a single take of the semaphore
+uint32_t ScriptingCANBuffer::read_frames(AP_HAL::CANFrame *frames, uint32_t max_frames)
+{
+    WITH_SEMAPHORE(sem);
+    uint32_t count = 0;
+    while (count < max_frames && buffer.pop(frames[count])) {
+        count++;
+    }
+    return count;
+}
+
+bool ScriptingCANBuffer::add_filter(uint32_t mask, uint32_t value)
+{
+    WITH_SEMAPHORE(sem);
+    if (num_filters >= ARRAY_SIZE(filter)) {
+        return false;
+    }
+    filter[num_filters].mask = mask;
+    filter[num_filters].value = value & mask;
+    num_filters++;
+    return true;
+}
+
 void ScriptingCANBuffer::handle_frame(AP_HAL::CANFrame &frame)
 {
     WITH_SEMAPHORE(sem);
-    buffer.push(frame);
+    // filter in the CAN thread, so unwanted frames never use buffer space
+    bool accept = (num_filters == 0);
+    for (uint8_t i = 0; i < num_filters; i++) {
+        if ((frame.id & filter[i].mask) == filter[i].value) {
+            accept = true;
+            break;
+        }
+    }
+    if (accept) {
+        buffer.push(frame);
+    }
     if (next != nullptr) {
         next->handle_frame(frame);
     }
@@ -21,6 +21,11 @@
 #include <AP_CANManager/AP_CANSensor.h>
 
 #if HAL_MAX_CAN_PROTOCOL_DRIVERS
+
+#ifndef SCRIPTING_CAN_MAX_FILTERS
+#define SCRIPTING_CAN_MAX_FILTERS 8
+#endif
+
 class ScriptingCANBuffer;
 class ScriptingCANSensor : public CANSensor {
 public:
@@ -58,6 +63,13 @@ public:
     // read a frame from the buffer
     bool read_frame(AP_HAL::CANFrame &frame);
 
+    // read up to max_frames frames from the buffer, returning the number read
+    uint32_t read_frames(AP_HAL::CANFrame *frames, uint32_t max_frames);
+
+    // only buffer frames where (id & mask) == value for one of the
+    // filters, with no filters all frames are buffered
+    bool add_filter(uint32_t mask, uint32_t value);
+
     // recursively add frame to buffer
     void handle_frame(AP_HAL::CANFrame &frame);
 
@@ -74,6 +86,12 @@ private:
 
     HAL_Semaphore sem;
 
+    struct {
+        uint32_t mask;
+        uint32_t value;
+    } filter[SCRIPTING_CAN_MAX_FILTERS];
+    uint8_t num_filters;
+
 };
 
 #endif // HAL_MAX_CAN_PROTOCOL_DRIVERS
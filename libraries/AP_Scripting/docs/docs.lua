@@ -40,6 +40,12 @@ function micros() end
 ---@return number|nil -- command param 4
 function mission_receive() end
 
+-- wake this script before its next run time when an event arrives, the script can then return a long delay instead of polling
+-- the wakeup lasts as long as the script, calling again with the same event and id has no effect
+---@param event integer -- 0:mission command, 1:RC aux function, 2:scripting CAN frame, 3:mode change, 4:arming or disarming
+---@param id? integer -- mission command param 1, aux function, CAN frame id or mode to wake on, nil or -1 wakes on any
+function wake_on(event, id) end
+
 
 -- data flash logging to SD card
 ---@class logger
@@ -523,6 +529,16 @@ function Vector2f_ud:length() end
 ---@return number
 function Vector2f_ud:angle() end
 
+-- adds vector to this vector in place, without allocating a new vector
+---@param vector Vector2f_ud
+---@return Vector2f_ud -- this vector
+function Vector2f_ud:add_inplace(vector) end
+
+-- subtracts vector from this vector in place, without allocating a new vector
+---@param vector Vector2f_ud
+---@return Vector2f_ud -- this vector
+function Vector2f_ud:sub_inplace(vector) end
+
 -- desc
 ---@class Vector3f_ud
 local Vector3f_ud = {}
@@ -573,6 +589,16 @@ function Vector3f_ud:cross(vector) end
 ---@return number
 function Vector3f_ud:dot(vector) end
 
+-- adds vector to this vector in place, without allocating a new vector
+---@param vector Vector3f_ud
+---@return Vector3f_ud -- this vector
+function Vector3f_ud:add_inplace(vector) end
+
+-- subtracts vector from this vector in place, without allocating a new vector
+---@param vector Vector3f_ud
+---@return Vector3f_ud -- this vector
+function Vector3f_ud:sub_inplace(vector) end
+
 -- desc
 ---@return boolean
 function Vector3f_ud:is_zero() end
@@ -652,6 +678,11 @@ function Quaternion_ud:earth_to_body(vec) end
 ---@return Quaternion_ud
 function Quaternion_ud:inverse() end
 
+-- Multiplies this quaternion by quat in place, without allocating a new quaternion
+---@param quat Quaternion_ud
+---@return Quaternion_ud -- this quaternion
+function Quaternion_ud:mul_inplace(quat) end
+
 -- Integrates angular velocity over small time delta
 ---@param angular_velocity Vector3f_ud
 ---@param time_delta number
@@ -838,6 +869,18 @@ function ScriptingCANBuffer_ud:read_frame() end
 ---@return boolean
 function ScriptingCANBuffer_ud:write_frame(frame, timeout_us) end
 
+-- Only buffer frames where (id & mask) == value, up to 8 filters can be added and a frame is buffered if it matches any of them. With no filters all frames are buffered
+---@param mask uint32_t_ud|integer|number
+---@param value uint32_t_ud|integer|number
+---@return boolean -- false if there is no room for another filter
+function ScriptingCANBuffer_ud:add_filter(mask, value) end
+
+-- Read up to max_frames frames into frames[1] to frames[n] in one call, CANFrame_ud already in the table are reused rather than allocated
+---@param frames table
+---@param max_frames integer
+---@return integer -- number of frames read
+function ScriptingCANBuffer_ud:read_frames(frames, max_frames) end
+
 
 -- desc
 ---@class AP_HAL__AnalogSource_ud
@@ -2201,6 +2244,11 @@ ahrs = {}
 ---@return Quaternion_ud|nil
 function ahrs:get_quaternion() end
 
+-- Fill state with the AHRS estimates from one update, taken under a single lock. Sets healthy, home_is_set, roll, pitch, yaw, gyro, accel, groundspeed_vector and wind, and quaternion, location, velocity_NED and position_NED_origin with matching have_ flags. An estimate that is unavailable keeps its previous value with its flag false. Userdata already in the table are reused rather than allocated
+---@param state table
+---@return table -- state
+function ahrs:get_state(state) end
+
 -- desc
 ---@return integer
 function ahrs:get_posvelyaw_source_set() end
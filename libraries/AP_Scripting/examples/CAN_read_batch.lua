@@ -0,0 +1,26 @@
+-- This script is an example of reading many frames from the CAN bus in each run
+
+local driver = CAN:get_device(25)
+if not driver then
+   gcs:send_text(0,"No scripting CAN interfaces found")
+   return
+end
+
+-- only buffer extended frames with ids 0x100 to 0x10F, other frames are dropped before they reach the buffer
+local CAN_FLAG_EFF = uint32_t(0x80000000)
+driver:add_filter(CAN_FLAG_EFF | 0x1FFFFFF0, CAN_FLAG_EFF | 0x100)
+
+-- the table is kept between runs so the frames in it are reused
+local frames = {}
+local count = 0
+
+function update()
+   local n = driver:read_frames(frames, 25)
+   for i = 1, n do
+      local frame = frames[i]
+      count = count + frame:dlc()
+   end
+   return update, 10
+end
+
+return update()
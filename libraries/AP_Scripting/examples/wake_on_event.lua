@@ -0,0 +1,41 @@
+-- This script sleeps until an event arrives instead of polling for it
+
+local EVENT_MISSION_CMD = 0
+local EVENT_AUX_FUNCTION = 1
+local EVENT_MODE_CHANGE = 3
+local EVENT_ARMING = 4
+
+local SCRIPTING_AUX_FUNC = 300 -- Scripting1
+
+-- wakeups last for the life of the script, so they only need adding once
+wake_on(EVENT_MISSION_CMD)
+wake_on(EVENT_AUX_FUNCTION, SCRIPTING_AUX_FUNC)
+wake_on(EVENT_MODE_CHANGE)
+wake_on(EVENT_ARMING)
+
+local last_mode = vehicle:get_mode()
+local last_aux = rc:get_aux_cached(SCRIPTING_AUX_FUNC)
+
+function update()
+  local time_ms, param1 = mission_receive()
+  if time_ms then
+    gcs:send_text(6, string.format("Mission command %i", param1))
+  end
+
+  local aux = rc:get_aux_cached(SCRIPTING_AUX_FUNC)
+  if aux ~= last_aux then
+    gcs:send_text(6, string.format("Scripting1 switch %s", tostring(aux)))
+    last_aux = aux
+  end
+
+  local mode = vehicle:get_mode()
+  if mode ~= last_mode then
+    gcs:send_text(6, string.format("Mode %i", mode))
+    last_mode = mode
+  end
+
+  -- any of the events above will run the script again before this
+  return update, 60000
+end
+
+return update()
@@ -0,0 +1,36 @@
+/*
+  support for building luac on the build host, to precompile scripts
+  embedded in ROMFS. The lauxlib used on the vehicle has no
+  luaL_newstate(), as the scripting heap is used instead
+ */
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "lua.h"
+#include "lauxlib.h"
+
+static void *l_alloc(void *ud, void *ptr, size_t osize, size_t nsize)
+{
+    (void)ud;
+    (void)osize;
+    if (nsize == 0) {
+        free(ptr);
+        return NULL;
+    }
+    return realloc(ptr, nsize);
+}
+
+static int panic(lua_State *L)
+{
+    fprintf(stderr, "PANIC: unprotected error in call to Lua API (%s)\n", lua_tostring(L, -1));
+    return 0;
+}
+
+LUALIB_API lua_State *luaL_newstate(void)
+{
+    lua_State *L = lua_newstate(l_alloc, NULL);
+    if (L != NULL) {
+        lua_atpanic(L, &panic);
+    }
+    return L;
+}
@@ -1742,6 +1742,27 @@ void emit_singleton_fields() {
   }
 }
 
+// index of the next caller supplied userdata to return a result in, 0 if the method has none
+static int userdata_out_index;
+
+// push a userdata result, reusing a caller supplied container if there is one
+void emit_userdata_push(const struct type *t, const char *value, const char *tab) {
+  if (userdata_out_index == 0) {
+    // userdatas must allocate a new container to return
+    fprintf(source, "%snew_%s(L);\n", tab, t->data.ud.sanatized_name);
+    fprintf(source, "%s*check_%s(L, -1) = %s;\n", tab, t->data.ud.sanatized_name, value);
+    return;
+  }
+  fprintf(source, "%sif (out_args >= %d) {\n", tab, userdata_out_index);
+  fprintf(source, "%s    *check_%s(L, %d) = %s;\n", tab, t->data.ud.sanatized_name, userdata_out_index, value);
+  fprintf(source, "%s    lua_pushvalue(L, %d);\n", tab, userdata_out_index);
+  fprintf(source, "%s} else {\n", tab);
+  fprintf(source, "%s    new_%s(L);\n", tab, t->data.ud.sanatized_name);
+  fprintf(source, "%s    *check_%s(L, -1) = %s;\n", tab, t->data.ud.sanatized_name, value);
+  fprintf(source, "%s}\n", tab);
+  userdata_out_index++;
+}
+
 // emit refences functions for a call, return the number of arduments added
 int emit_references(const struct argument *arg, const char * tab) {
   int arg_index = NULLABLE_ARG_COUNT_BASE + 2;
@@ -1771,11 +1792,12 @@ int emit_references(const struct argument *arg, const char * tab) {
         case TYPE_STRING:
           fprintf(source, "%slua_pushstring(L, data_%d);\n", tab, arg_index);
           break;
-        case TYPE_USERDATA:
-          // userdatas must allocate a new container to return
-          fprintf(source, "%snew_%s(L);\n", tab, arg->type.data.ud.sanatized_name);
-          fprintf(source, "%s*check_%s(L, -1) = data_%d;\n", tab, arg->type.data.ud.sanatized_name, arg_index);
+        case TYPE_USERDATA: {
+          char value[32];
+          snprintf(value, sizeof(value), "data_%d", arg_index);
+          emit_userdata_push(&arg->type, value, tab);
           break;
+        }
         case TYPE_NONE:
           error(ERROR_INTERNAL, "Attempted to emit a nullable or reference  argument of type none");
           break;
@@ -1826,7 +1848,23 @@ void emit_userdata_method(const struct userdata *data, const struct method *meth
     }
     arg = arg->next;
   }
-  fprintf(source, "    binding_argcheck(L, %d);\n", arg_count);
+
+  // userdata results may be written into containers passed after the arguments, to avoid an allocation
+  int out_count = (method->return_type.type == TYPE_USERDATA) ? 1 : 0;
+  arg = method->arguments;
+  while (arg != NULL) {
+    if ((arg->type.flags & (TYPE_FLAGS_NULLABLE | TYPE_FLAGS_REFERNCE)) && (arg->type.type == TYPE_USERDATA)) {
+      out_count++;
+    }
+    arg = arg->next;
+  }
+  if (out_count > 0) {
+    fprintf(source, "    const int out_args = binding_argcheck_out(L, %d, %d);\n", arg_count, out_count);
+    userdata_out_index = arg_count + 1;
+  } else {
+    fprintf(source, "    binding_argcheck(L, %d);\n", arg_count);
+    userdata_out_index = 0;
+  }
 
   switch (data->ud_type) {
     case UD_USERDATA:
@@ -2044,9 +2082,7 @@ void emit_userdata_method(const struct userdata *data, const struct method *meth
       fprintf(source, "    lua_pushstring(L, data);\n");
       break;
     case TYPE_USERDATA:
-      // userdatas must allocate a new container to return
-      fprintf(source, "    new_%s(L);\n", method->return_type.data.ud.sanatized_name);
-      fprintf(source, "    *check_%s(L, -1) = data;\n", method->return_type.data.ud.sanatized_name);
+      emit_userdata_push(&method->return_type, "data", "    ");
       break;
     case TYPE_AP_OBJECT:
       fprintf(source, "    if (data == NULL) {\n");
@@ -2134,6 +2170,16 @@ void emit_operators(struct userdata *data) {
     fprintf(source, "    return 1;\n");
     fprintf(source, "}\n\n");
 
+    // in place version, which stores the result in the first operand rather than allocating
+    fprintf(source, "static int %s_%s_inplace(lua_State *L) {\n", data->sanatized_name, op_name + 2);
+    fprintf(source, "    binding_argcheck(L, 2);\n");
+    fprintf(source, "    %s *ud = check_%s(L, 1);\n", data->name, data->sanatized_name);
+    fprintf(source, "    %s *ud2 = check_%s(L, 2);\n", data->name, data->sanatized_name);
+    fprintf(source, "    *ud = *ud %c *ud2;\n", op_sym);
+    fprintf(source, "    lua_pushvalue(L, 1);\n");
+    fprintf(source, "    return 1;\n");
+    fprintf(source, "}\n\n");
+
   }
 }
 
@@ -2194,6 +2240,14 @@ void emit_index(struct userdata *head) {
       alias = alias->next;
     }
 
+    for (uint32_t i = 1; i < OP_LAST; i = (i << 1)) {
+      const char * op_name = get_name_for_operation((node->operations) & i);
+      if (op_name == NULL) {
+        continue;
+      }
+      fprintf(source, "    {\"%s_inplace\", %s_%s_inplace},\n", op_name + 2, node->sanatized_name, op_name + 2);
+    }
+
     fprintf(source, "};\n\n");
 
     if (node->operations) {
@@ -2391,6 +2445,17 @@ void emit_argcheck_helper(void) {
   fprintf(source, "    return 0;\n");
   fprintf(source, "}\n\n");
 
+  // methods that return userdata accept optional containers for the results after their arguments
+  fprintf(source, "int binding_argcheck_out(lua_State *L, int expected_arg_count, int out_arg_count) {\n");
+  fprintf(source, "    const int args = lua_gettop(L);\n");
+  fprintf(source, "    if (args > expected_arg_count + out_arg_count) {\n");
+  fprintf(source, "        return luaL_argerror(L, args, \"too many arguments\");\n");
+  fprintf(source, "    } else if (args < expected_arg_count) {\n");
+  fprintf(source, "        return luaL_argerror(L, args, \"too few arguments\");\n");
+  fprintf(source, "    }\n");
+  fprintf(source, "    return args;\n");
+  fprintf(source, "}\n\n");
+
   fprintf(source, "lua_Integer get_integer(lua_State *L, int arg_num, lua_Integer min_val, lua_Integer max_val) {\n");
   fprintf(source, "    const lua_Integer lua_int = luaL_checkinteger(L, arg_num);\n");
   fprintf(source, "    luaL_argcheck(L, (lua_int >= min_val) && (lua_int <= max_val), arg_num, \"out of range\");\n");
@@ -2663,6 +2728,18 @@ void emit_docs(struct userdata *node, int is_userdata, int emit_creation) {
       }
       alias = alias->next;
     }
+
+    // in place operators
+    for (uint32_t i = 1; i < OP_LAST; i = (i << 1)) {
+      const char * op_name = get_name_for_operation((node->operations) & i);
+      if (op_name == NULL) {
+        continue;
+      }
+      fprintf(docs, "-- desc\n");
+      fprintf(docs, "---@param param1 %s\n", name);
+      fprintf(docs, "---@return %s\n", name);
+      fprintf(docs, "function %s:%s_inplace(param1) end\n\n", name, op_name + 2);
+    }
     fprintf(docs, "\n");
     free(name);
     node = node->next;
@@ -2863,6 +2940,7 @@ int main(int argc, char **argv) {
   fprintf(header, "void load_generated_bindings(lua_State *L);\n");
   fprintf(header, "void load_generated_sandbox(lua_State *L);\n");
   fprintf(header, "int binding_argcheck(lua_State *L, int expected_arg_count);\n");
+  fprintf(header, "int binding_argcheck_out(lua_State *L, int expected_arg_count, int out_arg_count);\n");
   fprintf(header, "lua_Integer get_integer(lua_State *L, int arg_num, lua_Integer min_val, lua_Integer max_val);\n");
   fprintf(header, "int8_t get_int8_t(lua_State *L, int arg_num);\n");
   fprintf(header, "int16_t get_int16_t(lua_State *L, int arg_num);\n");
@@ -289,7 +289,11 @@ static int load_aux (lua_State *L, int status, int envidx) {
 
 static int luaB_loadfile (lua_State *L) {
   const char *fname = luaL_optstring(L, 1, NULL);
+#if LUA_SUPPORT_LOAD_BINARY
+  const char *mode = "t";  /* scripts can't load unverified bytecode */
+#else
   const char *mode = luaL_optstring(L, 2, NULL);
+#endif
   int env = (!lua_isnone(L, 3) ? 3 : 0);  /* 'env' index or 0 if no 'env' */
   int status = luaL_loadfilex(L, fname, mode);
   return load_aux(L, status, env);
@@ -338,7 +342,11 @@ static int luaB_load (lua_State *L) {
   int status;
   size_t l;
   const char *s = lua_tolstring(L, 1, &l);
+#if LUA_SUPPORT_LOAD_BINARY
+  const char *mode = "t";  /* scripts can't load unverified bytecode */
+#else
   const char *mode = luaL_optstring(L, 3, "bt");
+#endif
   int env = (!lua_isnone(L, 4) ? 4 : 0);  /* 'env' index or 0 if no 'env' */
   if (s != NULL) {  /* loading a string? */
     const char *chunkname = luaL_optstring(L, 2, s);
@@ -19,6 +19,15 @@
 #include "lundump.h"
 
 
+/*
+** size_t of the target the dump is for. A luac on a 64 bit host sets
+** this to a 32 bit type to build bytecode for a 32 bit target
+*/
+#if !defined(LUAC_SIZE_T)
+#define LUAC_SIZE_T size_t
+#endif
+
+
 typedef struct {
   lua_State *L;
   lua_Writer writer;
@@ -74,7 +83,7 @@ static void DumpString (const TString *s, DumpState *D) {
   if (s == NULL)
     DumpByte(0, D);
   else {
-    size_t size = tsslen(s) + 1;  /* include trailing '\0' */
+    LUAC_SIZE_T size = tsslen(s) + 1;  /* include trailing '\0' */
     const char *str = getstr(s);
     if (size < 0xFF)
       DumpByte(cast_int(size), D);
@@ -187,7 +196,7 @@ static void DumpHeader (DumpState *D) {
   DumpByte(LUAC_FORMAT, D);
   DumpLiteral(LUAC_DATA, D);
   DumpByte(sizeof(int), D);
-  DumpByte(sizeof(size_t), D);
+  DumpByte(sizeof(LUAC_SIZE_T), D);
   DumpByte(sizeof(Instruction), D);
   DumpByte(sizeof(lua_Integer), D);
   DumpByte(sizeof(lua_Number), D);
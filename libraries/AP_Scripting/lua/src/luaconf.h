@@ -12,10 +12,12 @@
 #include <stddef.h>
 
 /*
-  don't support binary load() by default
+  support loading precompiled scripts. Binary chunks are only accepted
+  from the script loader, load() from scripts is limited to text as
+  bytecode is not verified
  */
 #ifndef LUA_SUPPORT_LOAD_BINARY
-#define LUA_SUPPORT_LOAD_BINARY 0
+#define LUA_SUPPORT_LOAD_BINARY 1
 #endif
 
 /*
@@ -1,5 +1,6 @@
 #include <AP_Common/AP_Common.h>
 #include <AP_HAL/HAL.h>
+#include <AP_AHRS/AP_AHRS.h>
 #include <AP_Logger/AP_Logger.h>
 #include <AP_Filesystem/AP_Filesystem.h>
 
@@ -9,6 +10,7 @@
 #include <AP_Scripting/lua_generated_bindings.h>
 
 #include <AP_Scripting/AP_Scripting.h>
+#include "lua_scripts.h"
 #include <string.h>
 
 extern "C" {
@@ -65,6 +67,114 @@ int lua_mission_receive(lua_State *L) {
     return 5;
 }
 
+// wake the calling script early when an event arrives
+int lua_wake_on(lua_State *L) {
+    const int args = lua_gettop(L);
+    if (args > 2) {
+        return luaL_argerror(L, args, "too many arguments");
+    } else if (args < 1) {
+        return luaL_argerror(L, args, "too few arguments");
+    }
+
+    const AP_Scripting::Event event = static_cast<AP_Scripting::Event>(get_integer(L, 1, 0, uint8_t(AP_Scripting::Event::ARMING)));
+    const int32_t id = (args > 1) ? get_integer(L, 2, -1, INT32_MAX) : -1;
+
+    if (!lua_scripts::add_wakeup(event, id)) {
+        return luaL_error(L, "unable to add wakeup");
+    }
+    return 0;
+}
+
+/*
+  get the userdata in a field of the table at index tbl, replacing
+  the field with a new one if it holds something else
+ */
+template <typename T>
+static T *state_field(lua_State *L, int tbl, const char *name, const char *tname, int (*new_ud)(lua_State *))
+{
+    lua_getfield(L, tbl, name);
+    T *ud = static_cast<T *>(luaL_testudata(L, -1, tname));
+    lua_pop(L, 1);
+    if (ud == nullptr) {
+        new_ud(L);
+        ud = static_cast<T *>(luaL_checkudata(L, -1, tname));
+        lua_setfield(L, tbl, name);
+    }
+    return ud;
+}
+
+static void state_number(lua_State *L, int tbl, const char *name, lua_Number value)
+{
+    lua_pushnumber(L, value);
+    lua_setfield(L, tbl, name);
+}
+
+static void state_boolean(lua_State *L, int tbl, const char *name, bool value)
+{
+    lua_pushboolean(L, value);
+    lua_setfield(L, tbl, name);
+}
+
+/*
+  fill a table with the AHRS state, all taken under one lock so the
+  values are from the same update. Userdata already in the table are
+  written in place, so a script that keeps its table does not allocate
+ */
+int lua_ahrs_get_state(lua_State *L) {
+    // Allow : and . access
+    const int arg_offset = (luaL_testudata(L, 1, "ahrs") != NULL) ? 1 : 0;
+
+    binding_argcheck(L, 1 + arg_offset);
+    const int tbl = 1 + arg_offset;
+    luaL_checktype(L, tbl, LUA_TTABLE);
+
+    AP_AHRS &ahrs = AP::ahrs();
+    WITH_SEMAPHORE(ahrs.get_semaphore());
+
+    state_boolean(L, tbl, "healthy", ahrs.healthy());
+    state_boolean(L, tbl, "home_is_set", ahrs.home_is_set());
+    state_number(L, tbl, "roll", ahrs.get_roll());
+    state_number(L, tbl, "pitch", ahrs.get_pitch());
+    state_number(L, tbl, "yaw", ahrs.get_yaw());
+
+    *state_field<Vector3f>(L, tbl, "gyro", "Vector3f", new_Vector3f) = ahrs.get_gyro();
+    *state_field<Vector3f>(L, tbl, "accel", "Vector3f", new_Vector3f) = ahrs.get_accel();
+    *state_field<Vector2f>(L, tbl, "groundspeed_vector", "Vector2f", new_Vector2f) = ahrs.groundspeed_vector();
+    *state_field<Vector3f>(L, tbl, "wind", "Vector3f", new_Vector3f) = ahrs.wind_estimate();
+
+    // estimates that may be unavailable keep their last value and
+    // have a flag saying whether it is current
+    Quaternion quat;
+    const bool have_quat = ahrs.get_quaternion(quat);
+    if (have_quat) {
+        *state_field<Quaternion>(L, tbl, "quaternion", "Quaternion", new_Quaternion) = quat;
+    }
+    state_boolean(L, tbl, "have_quaternion", have_quat);
+
+    Location loc;
+    const bool have_loc = ahrs.get_location(loc);
+    if (have_loc) {
+        *state_field<Location>(L, tbl, "location", "Location", new_Location) = loc;
+    }
+    state_boolean(L, tbl, "have_location", have_loc);
+
+    Vector3f vec;
+    const bool have_vel = ahrs.get_velocity_NED(vec);
+    if (have_vel) {
+        *state_field<Vector3f>(L, tbl, "velocity_NED", "Vector3f", new_Vector3f) = vec;
+    }
+    state_boolean(L, tbl, "have_velocity_NED", have_vel);
+
+    const bool have_pos = ahrs.get_relative_position_NED_origin(vec);
+    if (have_pos) {
+        *state_field<Vector3f>(L, tbl, "position_NED_origin", "Vector3f", new_Vector3f) = vec;
+    }
+    state_boolean(L, tbl, "have_position_NED_origin", have_pos);
+
+    lua_pushvalue(L, tbl);
+    return 1;
+}
+
 int AP_Logger_Write(lua_State *L) {
     AP_Logger * AP_logger = AP_Logger::get_singleton();
     if (AP_logger == nullptr) {
@@ -266,6 +376,20 @@ int AP_Logger_Write(lua_State *L) {
                 offset += sizeof(float);
                 break;
             }
+            case 'g': { // float16
+                int isnum;
+                const lua_Number tmp1 = lua_tonumberx(L, arg_index, &isnum);
+                if (!isnum) {
+                    luaM_free(L, buffer);
+                    luaL_argerror(L, arg_index, "argument out of range");
+                    // no return
+                }
+                Float16_t tmp;
+                tmp.set(tmp1);
+                memcpy(&buffer[offset], &tmp, sizeof(Float16_t));
+                offset += sizeof(Float16_t);
+                break;
+            }
             case 'n': { // char[4]
                 charlen = 4;
                 break;
@@ -494,6 +618,44 @@ int lua_get_CAN_device2(lua_State *L) {
 
     return 1;
 }
+
+/*
+  read up to max_frames frames into a table in one call, returning the
+  number read. CANFrame userdata already in the table are reused, so a
+  script that keeps its table does not allocate for each frame
+ */
+int ScriptingCANBuffer_read_frames(lua_State *L) {
+    binding_argcheck(L, 3);
+
+    ScriptingCANBuffer * ud = *check_ScriptingCANBuffer(L, 1);
+    luaL_checktype(L, 2, LUA_TTABLE);
+    const uint32_t max_frames = get_uint32(L, 3, 1, UINT16_MAX);
+
+    AP_HAL::CANFrame frames[8];
+    uint32_t count = 0;
+    while (count < max_frames) {
+        const uint32_t requested = MIN(max_frames - count, ARRAY_SIZE(frames));
+        const uint32_t received = ud->read_frames(frames, requested);
+        for (uint32_t i = 0; i < received; i++) {
+            count++;
+            lua_rawgeti(L, 2, count);
+            AP_HAL::CANFrame *frame = static_cast<AP_HAL::CANFrame *>(luaL_testudata(L, -1, "CANFrame"));
+            lua_pop(L, 1);
+            if (frame == nullptr) {
+                new_AP_HAL__CANFrame(L);
+                frame = check_AP_HAL__CANFrame(L, -1);
+                lua_rawseti(L, 2, count);
+            }
+            *frame = frames[i];
+        }
+        if (received < requested) {
+            break;
+        }
+    }
+
+    lua_pushinteger(L, count);
+    return 1;
+}
 #endif // HAL_MAX_CAN_PROTOCOL_DRIVERS
 
 /*
@@ -5,10 +5,13 @@
 int lua_millis(lua_State *L);
 int lua_micros(lua_State *L);
 int lua_mission_receive(lua_State *L);
+int lua_wake_on(lua_State *L);
+int lua_ahrs_get_state(lua_State *L);
 int AP_Logger_Write(lua_State *L);
 int lua_get_i2c_device(lua_State *L);
 int AP_HAL__I2CDevice_read_registers(lua_State *L);
 int lua_get_CAN_device(lua_State *L);
 int lua_get_CAN_device2(lua_State *L);
+int ScriptingCANBuffer_read_frames(lua_State *L);
 int lua_dirlist(lua_State *L);
 int lua_removefile(lua_State *L);
@@ -17,6 +17,11 @@
 #include <AP_HAL/AP_HAL.h>
 #include "AP_Scripting.h"
 #include <AP_Logger/AP_Logger.h>
+#include <AP_Filesystem/AP_Filesystem_config.h>
+#include <AP_ROMFS/AP_ROMFS.h>
+#ifndef HAL_BUILD_AP_PERIPH
+#include <AP_Vehicle/AP_Vehicle.h>
+#endif
 
 #include <AP_Scripting/lua_generated_bindings.h>
 
@@ -30,20 +35,56 @@ char *lua_scripts::error_msg_buf;
 HAL_Semaphore lua_scripts::error_msg_buf_sem;
 uint8_t lua_scripts::print_error_count;
 uint32_t lua_scripts::last_print_ms;
-
-lua_scripts::lua_scripts(const AP_Int32 &vm_steps, const AP_Int32 &heap_size, const AP_Int8 &debug_options, struct AP_Scripting::terminal_s &_terminal)
+lua_scripts::run_state_t lua_scripts::run_state;
+lua_scripts::profile_data *lua_scripts::profile;
+HAL_Semaphore lua_scripts::profile_sem;
+lua_scripts::wakeup lua_scripts::wakeups[AP_SCRIPTING_MAX_WAKEUPS];
+uint8_t lua_scripts::num_wakeups;
+volatile bool lua_scripts::wake_pending;
+HAL_Semaphore lua_scripts::wakeup_sem;
+
+lua_scripts::lua_scripts(const AP_Int32 &vm_steps, const AP_Int32 &heap_size, const AP_Int8 &debug_options,
+                         const AP_Int16 &gc_step, const AP_Int8 &gc_full_pct, const AP_Int32 &run_time_max,
+                         struct AP_Scripting::terminal_s &_terminal)
     : _vm_steps(vm_steps),
+      _heap_size(heap_size),
       _debug_options(debug_options),
+      _gc_step(gc_step),
+      _gc_full_pct(gc_full_pct),
+      _run_time_max(run_time_max),
      terminal(_terminal)
 {
     _heap.create(heap_size, 4);
+    run_state.profile_idx = 0xFF;
 }
 
 lua_scripts::~lua_scripts() {
+    {
+        // the profile is on the heap, make sure it is not printed after it has gone
+        WITH_SEMAPHORE(profile_sem);
+        profile = nullptr;
+    }
+    {
+        WITH_SEMAPHORE(wakeup_sem);
+        num_wakeups = 0;
+    }
     _heap.destroy();
 }
 
 void lua_scripts::hook(lua_State *L, lua_Debug *ar) {
+    if (!overtime) {
+        const uint32_t now_us = AP_HAL::micros();
+        run_state.steps_left -= run_state.hook_interval;
+        if (run_state.profile_idx != 0xFF) {
+            profile_sample(L, ar, now_us);
+        }
+        if ((run_state.steps_left > 0) &&
+            ((run_state.max_us == 0) || (now_us - run_state.start_us < run_state.max_us))) {
+            // still within the limits for this run
+            return;
+        }
+    }
+
     lua_scripts::overtime = true;
 
     // we need to aggressively bail out as we are over time
@@ -118,12 +159,161 @@ int lua_scripts::atpanic(lua_State *L) {
     return 0;
 }
 
+/*
+  a full collection walks the whole heap shared by all the scripts, so
+  doing one after every run costs more as scripts are added. Instead
+  step the incremental collector by SCR_GC_STEP, and only do a full
+  collection once memory use passes SCR_GC_FULL_PCT of the heap
+ */
+void lua_scripts::collect_garbage(lua_State *L, int total_mem)
+{
+    const int16_t step_kb = _gc_step.get();
+    if (step_kb <= 0 ||
+        int64_t(total_mem) * 100 >= int64_t(_heap_size.get()) * _gc_full_pct.get()) {
+        lua_gc(L, LUA_GCCOLLECT, 0);
+        return;
+    }
+    lua_gc(L, LUA_GCSTEP, step_kb);
+}
+
+bool lua_scripts::profile_enabled(void) const
+{
+    return (_debug_options.get() & uint8_t(DebugLevel::PROFILE)) != 0;
+}
+
+/*
+  add a script to the profile, returning its index or 0xFF if the
+  profile is full. The profile is allocated on first use, so it costs
+  nothing unless the PROFILE debug option is set
+ */
+uint8_t lua_scripts::profile_add_script(const char *filename)
+{
+    if (profile == nullptr) {
+        profile_data *new_profile = (profile_data *)_heap.allocate(sizeof(profile_data));
+        if (new_profile == nullptr) {
+            return 0xFF;
+        }
+        memset(new_profile, 0, sizeof(profile_data));
+        WITH_SEMAPHORE(profile_sem);
+        profile = new_profile;
+    }
+
+    WITH_SEMAPHORE(profile_sem);
+    if (profile->num_scripts >= ARRAY_SIZE(profile->scripts)) {
+        return 0xFF;
+    }
+    profile_script &ps = profile->scripts[profile->num_scripts];
+    const char *name_short = strrchr(filename, '/');
+    strncpy_noterm(ps.name, name_short != nullptr ? name_short+1 : filename, sizeof(ps.name)-1);
+    return profile->num_scripts++;
+}
+
+/*
+  sample the running function from the hook, attributing the
+  instructions and time since the last sample to it
+ */
+void lua_scripts::profile_sample(lua_State *L, lua_Debug *ar, uint32_t now_us)
+{
+    const uint32_t dt_us = now_us - run_state.last_sample_us;
+    run_state.last_sample_us = now_us;
+
+    const uint8_t script = run_state.profile_idx;
+    const uint16_t line = lua_getinfo(L, "Sn", ar) ? MAX(ar->linedefined, 0) : 0;
+
+    WITH_SEMAPHORE(profile_sem);
+    if (profile == nullptr || script >= profile->num_scripts) {
+        return;
+    }
+    profile->scripts[script].instructions += run_state.hook_interval;
+
+    for (uint8_t i = 0; i < profile->num_functions; i++) {
+        profile_function &pf = profile->functions[i];
+        if (pf.script == script && pf.line == line) {
+            pf.samples++;
+            pf.time_us += dt_us;
+            return;
+        }
+    }
+    if (profile->num_functions >= ARRAY_SIZE(profile->functions)) {
+        profile->lost_samples++;
+        return;
+    }
+    profile_function &pf = profile->functions[profile->num_functions++];
+    const char *name = (line == 0) ? "main" : ((ar->name != nullptr) ? ar->name : "?");
+    strncpy_noterm(pf.name, name, sizeof(pf.name)-1);
+    pf.script = script;
+    pf.line = line;
+    pf.samples = 1;
+    pf.time_us = dt_us;
+}
+
+// account for a completed run of a script
+void lua_scripts::profile_run(uint8_t idx, uint32_t run_time_us, bool overrun)
+{
+    WITH_SEMAPHORE(profile_sem);
+    if (profile == nullptr || idx >= profile->num_scripts) {
+        return;
+    }
+    profile_script &ps = profile->scripts[idx];
+    ps.runs++;
+    if (overrun) {
+        ps.overruns++;
+    }
+    ps.run_time_us += run_time_us;
+    ps.max_run_time_us = MAX(ps.max_run_time_us, run_time_us);
+}
+
+/*
+  print the profile, scripts in load order then the functions with the
+  most samples first
+ */
+void lua_scripts::profile_info(ExpandingString &str)
+{
+    WITH_SEMAPHORE(profile_sem);
+    if (profile == nullptr) {
+        return;
+    }
+
+    str.printf("%-20s %8s %8s %10s %8s %10s\n", "Script", "Runs", "Overrun", "Time(ms)", "Max(us)", "KInstr");
+    for (uint8_t i = 0; i < profile->num_scripts; i++) {
+        const profile_script &ps = profile->scripts[i];
+        str.printf("%-20s %8u %8u %10u %8u %10u\n",
+                   ps.name,
+                   unsigned(ps.runs),
+                   unsigned(ps.overruns),
+                   unsigned(ps.run_time_us / 1000U),
+                   unsigned(ps.max_run_time_us),
+                   unsigned(ps.instructions / 1000U));
+    }
+
+    str.printf("\nSampled every %u instructions, %u samples lost\n", unsigned(AP_SCRIPTING_PROFILE_INTERVAL), unsigned(profile->lost_samples));
+    str.printf("%-20s %-16s %6s %8s %10s\n", "Script", "Function", "Line", "Samples", "Time(ms)");
+    bool printed[AP_SCRIPTING_PROFILE_FUNCTIONS] {};
+    for (uint8_t n = 0; n < profile->num_functions; n++) {
+        int16_t best = -1;
+        for (uint8_t i = 0; i < profile->num_functions; i++) {
+            if (!printed[i] && (best < 0 || profile->functions[i].samples > profile->functions[best].samples)) {
+                best = i;
+            }
+        }
+        printed[best] = true;
+        const profile_function &pf = profile->functions[best];
+        str.printf("%-20s %-16s %6u %8u %10u\n",
+                   profile->scripts[pf.script].name,
+                   pf.name,
+                   unsigned(pf.line),
+                   unsigned(pf.samples),
+                   unsigned(pf.time_us / 1000U));
+    }
+}
+
 // helper for print and log of runtime stats
-void lua_scripts::update_stats(const char *name, uint32_t run_time, int total_mem, int run_mem)
+void lua_scripts::update_stats(const char *name, uint32_t run_time, int total_mem, int run_mem, uint32_t gc_time)
 {
     if ((_debug_options.get() & uint8_t(DebugLevel::RUNTIME_MSG)) != 0) {
-        gcs().send_text(MAV_SEVERITY_DEBUG, "Lua: Time: %u Mem: %d + %d",
+        gcs().send_text(MAV_SEVERITY_DEBUG, "Lua: Time: %u GC: %u Mem: %d + %d",
                                             (unsigned int)run_time,
+                                            (unsigned int)gc_time,
                                             (int)total_mem,
                                             (int)run_mem);
     }
@@ -134,7 +324,8 @@ void lua_scripts::update_stats(const char *name, uint32_t run_time, int total_me
             name         : {},
             run_time     : run_time,
             total_mem    : total_mem,
-            run_mem      : run_mem
+            run_mem      : run_mem,
+            gc_time      : gc_time
         };
         const char * name_short = strrchr(name, '/');
         if ((strlen(name) > sizeof(pkt.name)) && (name_short != nullptr)) {
@@ -146,8 +337,88 @@ void lua_scripts::update_stats(const char *name, uint32_t run_time, int total_me
     }
 }
 
+#if AP_FILESYSTEM_ROMFS_ENABLED
+/*
+  lua_load reader for block compressed ROMFS scripts, which hands
+  the parser one decompressed block at a time
+ */
+struct romfs_block_reader {
+    AP_ROMFS::block_file bf;
+    uint8_t *buf;
+    uint32_t next_block;
+    bool failed;
+};
+
+static const char *romfs_block_read(lua_State *L, void *ud, size_t *size)
+{
+    romfs_block_reader &r = *(romfs_block_reader *)ud;
+    *size = 0;
+    if (r.failed || r.next_block >= r.bf.num_blocks) {
+        return nullptr;
+    }
+    const int32_t len = AP_ROMFS::decompress_block(r.bf, r.next_block++, r.buf);
+    if (len <= 0) {
+        r.failed = true;
+        return nullptr;
+    }
+    *size = len;
+    return (const char *)r.buf;
+}
+#endif
+
+/*
+  load a script as a function on the stack. Precompiled scripts
+  (.luac) are loaded as bytecode, which is checked against this VM's
+  version and number format as it is loaded. Scripts in ROMFS are
+  loaded straight from the embedded data, which with an uncompressed
+  ROMFS is read in place from flash, and large compressed scripts are
+  decompressed a block at a time as they are parsed
+ */
+int lua_scripts::load_chunk(lua_State *L, const char *filename)
+{
+    const size_t len = strlen(filename);
+    const char *mode = (len > 5 && strcmp(&filename[len-5], ".luac") == 0) ? "b" : "t";
+#if AP_FILESYSTEM_ROMFS_ENABLED
+    const char *romfs_prefix = "@ROMFS/";
+    const size_t prefix_len = strlen(romfs_prefix);
+    if (strncmp(filename, romfs_prefix, prefix_len) == 0) {
+        romfs_block_reader r {};
+        if (AP_ROMFS::find_blocks(&filename[prefix_len], r.bf)) {
+            r.buf = (uint8_t *)malloc(r.bf.block_size);
+            if (r.buf == nullptr) {
+                lua_pushfstring(L, "cannot open %s", filename);
+                return LUA_ERRMEM;
+            }
+            lua_pushfstring(L, "@%s", filename);
+            int ret = lua_load(L, romfs_block_read, &r, lua_tostring(L, -1), mode);
+            lua_remove(L, -2);
+            free(r.buf);
+            if (ret == LUA_OK && r.failed) {
+                lua_pop(L, 1);
+                lua_pushfstring(L, "cannot read %s", filename);
+                ret = LUA_ERRFILE;
+            }
+            return ret;
+        }
+
+        uint32_t size;
+        const uint8_t *data = AP_ROMFS::find_decompress(&filename[prefix_len], size);
+        if (data == nullptr) {
+            lua_pushfstring(L, "cannot open %s", filename);
+            return LUA_ERRFILE;
+        }
+        lua_pushfstring(L, "@%s", filename);
+        const int ret = luaL_loadbufferx(L, (const char *)data, size, lua_tostring(L, -1), mode);
+        lua_remove(L, -2);
+        AP_ROMFS::free(data);
+        return ret;
+    }
+#endif
+    return luaL_loadfilex(L, filename, mode);
+}
+
 lua_scripts::script_info *lua_scripts::load_script(lua_State *L, char *filename) {
-    if (int error = luaL_loadfile(L, filename)) {
+    if (int error = load_chunk(L, filename)) {
         switch (error) {
             case LUA_ERRSYNTAX:
                 set_and_print_new_error_message(MAV_SEVERITY_CRITICAL, "Error: %s", lua_tostring(L, -1));
@@ -186,9 +457,10 @@ lua_scripts::script_info *lua_scripts::load_script(lua_State *L, char *filename)
     const uint32_t loadEnd = AP_HAL::micros();
     const int endMem = lua_gc(L, LUA_GCCOUNT, 0) * 1024 + lua_gc(L, LUA_GCCOUNTB, 0);
 
-    update_stats(filename, loadEnd-loadStart, endMem, loadMem);
+    update_stats(filename, loadEnd-loadStart, endMem, loadMem, 0);
 
     new_script->name = filename;
+    new_script->profile_idx = 0xFF;
     new_script->lua_ref = luaL_ref(L, LUA_REGISTRYINDEX);   // cache the reference
     new_script->next_run_ms = AP_HAL::millis64() - 1; // force the script to be stale
 
@@ -228,7 +500,7 @@ void lua_scripts::load_all_scripts_in_dir(lua_State *L, const char *dirname) {
         return;
     }
 
-    // load anything that ends in .lua
+    // load anything that ends in .lua, or .luac for precompiled scripts
     for (struct dirent *de=AP::FS().readdir(d); de; de=AP::FS().readdir(d)) {
         uint8_t length = strlen(de->d_name);
         if (length < 5) {
@@ -236,8 +508,9 @@ void lua_scripts::load_all_scripts_in_dir(lua_State *L, const char *dirname) {
             continue;
         }
 
-        if (strncmp(&de->d_name[length-4], ".lua", 4)) {
-            // doesn't end in .lua
+        if (strncmp(&de->d_name[length-4], ".lua", 4) &&
+            (length < 6 || strncmp(&de->d_name[length-5], ".luac", 5))) {
+            // doesn't end in .lua or .luac
             continue;
         }
 
@@ -268,9 +541,18 @@ void lua_scripts::load_all_scripts_in_dir(lua_State *L, const char *dirname) {
 
 void lua_scripts::reset_loop_overtime(lua_State *L) {
     overtime = false;
-    // reset the hook to clear the counter
     const int32_t vm_steps = MAX(_vm_steps, 1000);
-    lua_sethook(L, hook, LUA_MASKCOUNT, vm_steps);
+    run_state.steps_left = vm_steps;
+    run_state.hook_interval = vm_steps;
+    run_state.max_us = MAX(_run_time_max.get(), 0);
+    if ((run_state.max_us > 0) || (run_state.profile_idx != 0xFF)) {
+        // the hook has to run more often than the instruction limit to check the time and sample
+        run_state.hook_interval = MIN(vm_steps, AP_SCRIPTING_PROFILE_INTERVAL);
+    }
+    run_state.start_us = AP_HAL::micros();
+    run_state.last_sample_us = run_state.start_us;
+    // reset the hook to clear the counter
+    lua_sethook(L, hook, LUA_MASKCOUNT, run_state.hook_interval);
 }
 
 void lua_scripts::run_next_script(lua_State *L) {
@@ -286,6 +568,15 @@ void lua_scripts::run_next_script(lua_State *L) {
     script_info *script = scripts;
     scripts = script->next;
 
+    if (!profile_enabled()) {
+        run_state.profile_idx = 0xFF;
+    } else {
+        if (script->profile_idx == 0xFF) {
+            script->profile_idx = profile_add_script(script->name);
+        }
+        run_state.profile_idx = script->profile_idx;
+    }
+
     // reset the hook to clear the counter
     reset_loop_overtime(L);
 
@@ -295,7 +586,15 @@ void lua_scripts::run_next_script(lua_State *L) {
     // pop the function to the top of the stack
     lua_rawgeti(L, LUA_REGISTRYINDEX, script->lua_ref);
 
-    if(lua_pcall(L, 0, LUA_MULTRET, 0)) {
+    run_state.script = script;
+    const int pcall_result = lua_pcall(L, 0, LUA_MULTRET, 0);
+    run_state.script = nullptr;
+    if (run_state.profile_idx != 0xFF) {
+        profile_run(run_state.profile_idx, AP_HAL::micros() - run_state.start_us, overtime);
+        run_state.profile_idx = 0xFF;
+    }
+
+    if (pcall_result) {
         if (overtime) {
             // script has consumed an excessive amount of CPU time
             set_and_print_new_error_message(MAV_SEVERITY_CRITICAL, "%s exceeded time limit", script->name);
@@ -355,6 +654,18 @@ void lua_scripts::remove_script(lua_State *L, script_info *script) {
     }
 
     // ensure that the script isn't in the loaded list for any reason
+    unlink_script(script);
+    remove_wakeups(script);
+
+    if (L != nullptr) {
+        // state could be null if we are force killing all scripts
+        luaL_unref(L, LUA_REGISTRYINDEX, script->lua_ref);
+    }
+    _heap.deallocate(script->name);
+    _heap.deallocate(script);
+}
+
+void lua_scripts::unlink_script(script_info *script) {
     if (scripts == nullptr) {
         // nothing to do, already not in the list
     } else if (scripts == script) {
@@ -367,13 +678,122 @@ void lua_scripts::remove_script(lua_State *L, script_info *script) {
             }
         }
     }
+}
 
-    if (L != nullptr) {
-        // state could be null if we are force killing all scripts
-        luaL_unref(L, LUA_REGISTRYINDEX, script->lua_ref);
+bool lua_scripts::add_wakeup(AP_Scripting::Event event, int32_t id)
+{
+    if (run_state.script == nullptr) {
+        // only a running script can be woken
+        return false;
+    }
+    WITH_SEMAPHORE(wakeup_sem);
+    for (uint8_t i = 0; i < num_wakeups; i++) {
+        const wakeup &w = wakeups[i];
+        if (w.script == run_state.script && w.event == event && w.id == id) {
+            // already waiting for this event
+            return true;
+        }
+    }
+    if (num_wakeups >= ARRAY_SIZE(wakeups)) {
+        return false;
+    }
+    wakeup &w = wakeups[num_wakeups++];
+    w.script = run_state.script;
+    w.event = event;
+    w.id = id;
+    w.pending = false;
+    return true;
+}
+
+void lua_scripts::notify_event(AP_Scripting::Event event, int32_t id)
+{
+    if (num_wakeups == 0) {
+        // nothing waiting, this is called for every CAN frame
+        return;
+    }
+    WITH_SEMAPHORE(wakeup_sem);
+    for (uint8_t i = 0; i < num_wakeups; i++) {
+        wakeup &w = wakeups[i];
+        if (w.event == event && (w.id == -1 || w.id == id)) {
+            w.pending = true;
+            wake_pending = true;
+        }
+    }
+}
+
+void lua_scripts::remove_wakeups(script_info *script)
+{
+    WITH_SEMAPHORE(wakeup_sem);
+    uint8_t n = 0;
+    for (uint8_t i = 0; i < num_wakeups; i++) {
+        if (wakeups[i].script != script) {
+            wakeups[n++] = wakeups[i];
+        }
+    }
+    num_wakeups = n;
+}
+
+void lua_scripts::handle_wakeups(void)
+{
+    if (!wake_pending) {
+        return;
+    }
+    WITH_SEMAPHORE(wakeup_sem);
+    wake_pending = false;
+    const uint64_t now_ms = AP_HAL::millis64();
+    for (uint8_t i = 0; i < num_wakeups; i++) {
+        wakeup &w = wakeups[i];
+        if (!w.pending) {
+            continue;
+        }
+        w.pending = false;
+        if (w.script->next_run_ms > now_ms) {
+            unlink_script(w.script);
+            w.script->next_run_ms = now_ms;
+            reschedule_script(w.script);
+        }
+    }
+}
+
+void lua_scripts::check_vehicle_events(void)
+{
+#ifndef HAL_BUILD_AP_PERIPH
+    const AP_Vehicle *vehicle = AP::vehicle();
+    if (vehicle != nullptr) {
+        const uint8_t mode = vehicle->get_mode();
+        if (mode != last_mode) {
+            last_mode = mode;
+            notify_event(AP_Scripting::Event::MODE_CHANGE, mode);
+        }
+    }
+#endif
+    const bool armed = hal.util->get_soft_armed();
+    if (armed != last_armed) {
+        last_armed = armed;
+        notify_event(AP_Scripting::Event::ARMING, armed ? 1 : 0);
+    }
+}
+
+/*
+  wait for the first script to be due. While any script is waiting on
+  an event this wakes every AP_SCRIPTING_WAKE_POLL_MS to check for
+  them, which is far cheaper than the script polling for itself
+ */
+void lua_scripts::wait_for_next_script(void)
+{
+    while (true) {
+        check_vehicle_events();
+        handle_wakeups();
+        const uint64_t now_ms = AP_HAL::millis64();
+        if (now_ms >= scripts->next_run_ms) {
+            return;
+        }
+        uint64_t delay_ms = scripts->next_run_ms - now_ms;
+        if (num_wakeups > 0) {
+            delay_ms = MIN(delay_ms, uint64_t(AP_SCRIPTING_WAKE_POLL_MS));
+        }
+        hal.scheduler->delay(MIN(delay_ms, uint64_t(UINT16_MAX)));
     }
-    _heap.deallocate(script->name);
-    _heap.deallocate(script);
 }
 
 void lua_scripts::reschedule_script(script_info *script) {
@@ -453,6 +873,12 @@ void lua_scripts::run(void) {
         }
         scripts = nullptr;
         overtime = false;
+        run_state.profile_idx = 0xFF;
+        if (profile != nullptr) {
+            // the scripts will be loaded again, start a new profile
+            WITH_SEMAPHORE(profile_sem);
+            memset(profile, 0, sizeof(profile_data));
+        }
         // end any open REPL sessions
         repl_cleanup();
     }
@@ -496,6 +922,9 @@ void lua_scripts::run(void) {
     succeeded_initial_load = true;
 #endif // __clang_analyzer__
 
+    // take the current mode and arming state, so only changes wake scripts
+    check_vehicle_events();
+
     while (AP_Scripting::get_singleton()->should_run()) {
         // handle terminal data if we have any
         if (terminal.session) {
@@ -521,11 +950,7 @@ void lua_scripts::run(void) {
               }
 #endif // defined(AP_SCRIPTING_CHECKS) && AP_SCRIPTING_CHECKS >= 1
 
-            // compute delay time
-            uint64_t now_ms = AP_HAL::millis64();
-            if (now_ms < scripts->next_run_ms) {
-                hal.scheduler->delay(scripts->next_run_ms - now_ms);
-            }
+            wait_for_next_script();
 
             if ((_debug_options.get() & uint8_t(DebugLevel::RUNTIME_MSG)) != 0) {
                 gcs().send_text(MAV_SEVERITY_DEBUG, "Lua: Running %s", scripts->name);
@@ -549,11 +974,12 @@ void lua_scripts::run(void) {
             hal.scheduler->restore_interrupts(istate);
 #endif
 
-            update_stats(script_name, runEnd - loadEnd, endMem, endMem - startMem);
-
+            // collect garbage after each script, so the heap does not fill up between
+            // the collector's own steps
+            collect_garbage(L, endMem);
+            const uint32_t gcEnd = AP_HAL::micros();
 
-            // garbage collect after each script, this shouldn't matter, but seems to resolve a memory leak
-            lua_gc(L, LUA_GCCOLLECT, 0);
+            update_stats(script_name, runEnd - loadEnd, endMem, endMem - startMem, gcEnd - runEnd);
 
         } else {
             if ((_debug_options.get() & uint8_t(DebugLevel::NO_SCRIPTS_TO_RUN)) != 0) {
@@ -23,6 +23,7 @@
 #include <GCS_MAVLink/GCS_MAVLink.h>
 #include <AP_HAL/Semaphores.h>
 #include <AP_Common/MultiHeap.h>
+#include <AP_Common/ExpandingString.h>
 
 #include "lua/src/lua.hpp"
 
@@ -42,6 +43,28 @@
   #endif //HAL_OS_FATFS_IO
 #endif // SCRIPTING_DIRECTORY
 
+#ifndef AP_SCRIPTING_PROFILE_SCRIPTS
+  #define AP_SCRIPTING_PROFILE_SCRIPTS 16
+#endif
+
+#ifndef AP_SCRIPTING_PROFILE_FUNCTIONS
+  #define AP_SCRIPTING_PROFILE_FUNCTIONS 32
+#endif
+
+// number of VM instructions between profile samples and run time checks
+#ifndef AP_SCRIPTING_PROFILE_INTERVAL
+  #define AP_SCRIPTING_PROFILE_INTERVAL 1000
+#endif
+
+#ifndef AP_SCRIPTING_MAX_WAKEUPS
+  #define AP_SCRIPTING_MAX_WAKEUPS 16
+#endif
+
+// longest time between checks for events while a script is waiting to run
+#ifndef AP_SCRIPTING_WAKE_POLL_MS
+  #define AP_SCRIPTING_WAKE_POLL_MS 5
+#endif
+
 #ifndef REPL_IN
   #define REPL_IN REPL_DIRECTORY "/in"
 #endif // REPL_IN
@@ -53,7 +76,9 @@
 class lua_scripts
 {
 public:
-    lua_scripts(const AP_Int32 &vm_steps, const AP_Int32 &heap_size, const AP_Int8 &debug_options, struct AP_Scripting::terminal_s &_terminal);
+    lua_scripts(const AP_Int32 &vm_steps, const AP_Int32 &heap_size, const AP_Int8 &debug_options,
+                const AP_Int16 &gc_step, const AP_Int8 &gc_full_pct, const AP_Int32 &run_time_max,
+                struct AP_Scripting::terminal_s &_terminal);
 
     ~lua_scripts();
 
@@ -73,8 +98,19 @@ public:
         SUPPRESS_SCRIPT_LOG = 1U << 2,
         LOG_RUNTIME = 1U << 3,
         DISABLE_PRE_ARM = 1U << 4,
+        PROFILE = 1U << 5,
     };
 
+    // print the execution profile for @SYS/scripting_profile.txt
+    static void profile_info(ExpandingString &str);
+
+    // wake the running script when an event with a matching id, or any
+    // id if id is -1, arrives. Returns false if there is no room
+    static bool add_wakeup(AP_Scripting::Event event, int32_t id);
+
+    // wake the scripts waiting for an event, may be called from any thread
+    static void notify_event(AP_Scripting::Event event, int32_t id);
+
 private:
 
     void create_sandbox(lua_State *L);
@@ -85,9 +121,12 @@ private:
        int lua_ref;          // reference to the loaded script object
        uint64_t next_run_ms; // time (in milliseconds) the script should next be run at
        char *name;           // filename for the script // FIXME: This information should be available from Lua
+       uint8_t profile_idx;  // index into the profile scripts, or 0xFF if not profiled
        script_info *next;
     } script_info;
 
+    int load_chunk(lua_State *L, const char *filename);
+
     script_info *load_script(lua_State *L, char *filename);
 
     void reset_loop_overtime(lua_State *L);
@@ -98,6 +137,9 @@ private:
 
     void remove_script(lua_State *L, script_info *script);
 
+    // remove a script from the list of scripts to be run, without freeing it
+    void unlink_script(script_info *script);
+
     // reschedule the script for execution. It is assumed the script is not in the list already
     void reschedule_script(script_info *script);
 
@@ -125,17 +167,94 @@ private:
     static int atpanic(lua_State *L);
     static jmp_buf panic_jmp;
 
+    // state of the script being run, for use in the hook
+    struct run_state_t {
+        int32_t hook_interval;  // VM instructions between hook calls
+        int32_t steps_left;     // VM instructions before the script is overtime
+        uint32_t start_us;
+        uint32_t last_sample_us;
+        uint32_t max_us;        // run time limit, 0 for none
+        uint8_t profile_idx;
+        script_info *script;
+    };
+    static run_state_t run_state;
+
+    // scripts waiting to be woken by events
+    struct wakeup {
+        script_info *script;
+        int32_t id;
+        AP_Scripting::Event event;
+        bool pending;
+    };
+    static wakeup wakeups[AP_SCRIPTING_MAX_WAKEUPS];
+    static uint8_t num_wakeups;
+    static volatile bool wake_pending;
+    static HAL_Semaphore wakeup_sem;
+    uint8_t last_mode;
+    bool last_armed;
+
+    // wait until the first script in the list is due, events can bring a script forward
+    void wait_for_next_script(void);
+    // check for mode and arming changes
+    void check_vehicle_events(void);
+    // move scripts woken by an event to the front of the list
+    void handle_wakeups(void);
+    // forget all the wakeups of a script
+    void remove_wakeups(script_info *script);
+
+    /*
+      execution profile, enabled with the PROFILE debug option. Each
+      hook call samples the running Lua function. Time spent in
+      bindings is counted against the Lua function that called them
+     */
+    struct profile_script {
+        char name[20];
+        uint32_t runs;
+        uint32_t overruns;       // runs stopped for exceeding the instruction count or run time
+        uint32_t max_run_time_us;
+        uint64_t run_time_us;
+        uint64_t instructions;   // counted in hook intervals, so approximate
+    };
+    struct profile_function {
+        char name[16];
+        uint8_t script;          // index into scripts
+        uint16_t line;           // line the function is defined on
+        uint32_t samples;
+        uint64_t time_us;
+    };
+    struct profile_data {
+        profile_script scripts[AP_SCRIPTING_PROFILE_SCRIPTS];
+        profile_function functions[AP_SCRIPTING_PROFILE_FUNCTIONS];
+        uint8_t num_scripts;
+        uint8_t num_functions;
+        uint32_t lost_samples;   // samples of functions that did not fit in the table
+    };
+    static profile_data *profile;
+    static HAL_Semaphore profile_sem;
+
+    bool profile_enabled(void) const;
+    uint8_t profile_add_script(const char *filename);
+    static void profile_sample(lua_State *L, lua_Debug *ar, uint32_t now_us);
+    static void profile_run(uint8_t idx, uint32_t run_time_us, bool overrun);
+
     lua_State *lua_state;
 
     const AP_Int32 & _vm_steps;
+    const AP_Int32 & _heap_size;
     const AP_Int8 & _debug_options;
+    const AP_Int16 & _gc_step;
+    const AP_Int8 & _gc_full_pct;
+    const AP_Int32 & _run_time_max;
 
     static void *alloc(void *ud, void *ptr, size_t osize, size_t nsize);
 
     static MultiHeap _heap;
 
     // helper for print and log of runtime stats
-    void update_stats(const char *name, uint32_t run_time, int total_mem, int run_mem);
+    void update_stats(const char *name, uint32_t run_time, int total_mem, int run_mem, uint32_t gc_time);
+
+    // collect garbage after a script run
+    void collect_garbage(lua_State *L, int total_mem);
 
     // must be static for use in atpanic
     static void print_error(MAV_SEVERITY severity);
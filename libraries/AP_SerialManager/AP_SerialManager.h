@@ -169,6 +169,7 @@ public:
         SerialProtocol_MSP_DisplayPort = 42,
         SerialProtocol_MAVLinkHL = 43,
         SerialProtocol_Tramp = 44,
+        SerialProtocol_LogStream = 45,
         SerialProtocol_NumProtocols                    // must be the last value
     };
 
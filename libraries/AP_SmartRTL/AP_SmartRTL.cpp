@@ -31,7 +31,7 @@ const AP_Param::GroupInfo AP_SmartRTL::var_info[] = {
     // @Param: POINTS
     // @DisplayName: SmartRTL maximum number of points on path
     // @Description: SmartRTL maximum number of points on path. Set to 0 to disable SmartRTL.  100 points consumes about 3k of memory.
-    // @Range: 0 500
+    // @Range: 0 1000
     // @User: Advanced
     // @RebootRequired: True
     AP_GROUPINFO("POINTS", 1, AP_SmartRTL, _points_max, SMARTRTL_POINTS_DEFAULT),
@@ -67,6 +67,17 @@ const AP_Param::GroupInfo AP_SmartRTL::var_info[] = {
 *    2. Simplification uses the Ramer-Douglas-Peucker algorithm. See Wikipedia
 *    for a more complete description.
 *
+*    As points are recorded a streaming simplifier holds back the most recent
+*    point, extending the last segment of the path to each new point for as long
+*    as all the points recorded since the last point on the path stay within
+*    SMARTRTL_SIMPLIFY_EPSILON of it. This keeps straight and gently curving
+*    flight from filling the path, leaving less work for the background
+*    algorithms.
+*
+*    Pruning finds the segments near each new segment through a spatial hash
+*    of the path's segments, so checking all new segments takes roughly linear
+*    rather than quadratic time in the length of the path.
+*
 *    The simplification and pruning algorithms run in the background and do not
 *    alter the path in memory.  Two definitions, SMARTRTL_SIMPLIFY_TIME_US and
 *    SMARTRTL_PRUNING_LOOP_TIME_US are used to limit how long each algorithm will
@@ -115,6 +126,21 @@ void AP_SmartRTL::init()
     _simplify.stack_max = _points_max * SMARTRTL_SIMPLIFY_STACK_LEN_MULT;
     _simplify.stack = (simplify_start_finish_t*)calloc(_simplify.stack_max, sizeof(simplify_start_finish_t));
 
+    // one pruning grid bucket for every two points rounded up to a power of two
+    _prune.grid_buckets = 16;
+    while ((_prune.grid_buckets < _points_max / 2) && (_prune.grid_buckets < SMARTRTL_PRUNING_GRID_BUCKETS_MAX)) {
+        _prune.grid_buckets *= 2;
+    }
+    _prune.grid_head = (uint16_t*)calloc(_prune.grid_buckets, sizeof(uint16_t));
+    _prune.grid_next = (uint16_t*)calloc(_points_max, sizeof(uint16_t));
+    if (_prune.grid_head == nullptr || _prune.grid_next == nullptr) {
+        // pruning falls back to checking every segment
+        free(_prune.grid_head);
+        free(_prune.grid_next);
+        _prune.grid_head = nullptr;
+        _prune.grid_next = nullptr;
+    }
+
     // check if memory allocation failed
     if (_path == nullptr || _prune.loops == nullptr || _simplify.stack == nullptr) {
         log_action(SRTL_DEACTIVATED_INIT_FAILED);
@@ -122,6 +148,9 @@ void AP_SmartRTL::init()
         free(_path);
         free(_prune.loops);
         free(_simplify.stack);
+        free(_prune.grid_head);
+        free(_prune.grid_next);
+        _path = nullptr;
         return;
     }
 
@@ -154,6 +183,9 @@ bool AP_SmartRTL::pop_point(Vector3f& point)
         return false;
     }
 
+    // the most recent position is the first point of the return journey
+    flush_pending_point();
+
     // check we have another point
     if (_path_points_count == 0) {
         _path_sem.give();
@@ -184,6 +216,9 @@ bool AP_SmartRTL::peek_point(Vector3f& point)
         return false;
     }
 
+    // the most recent position is the first point of the return journey
+    flush_pending_point();
+
     // check we have another point
     if (_path_points_count == 0) {
         _path_sem.give();
@@ -213,6 +248,8 @@ void AP_SmartRTL::set_home(bool position_ok, const Vector3f& current_pos)
 
     // clear path
     _path_points_count = 0;
+    _stream.have_pending = false;
+    _stream.window_count = 0;
 
     // reset simplification and pruning.  These functions access members that should normally only
     // be touched by the background thread but it will not be running because active should be false
@@ -289,6 +326,13 @@ bool AP_SmartRTL::request_thorough_cleanup(ThoroughCleanupType clean_type)
 
     // request thorough cleanup
     if (_thorough_clean_request_ms == 0) {
+        // add the most recent position to the path so it is included in the cleanup
+        if (!_path_sem.take_nonblocking()) {
+            return false;
+        }
+        flush_pending_point();
+        _path_sem.give();
+
         _thorough_clean_request_ms = AP_HAL::millis();
         if (clean_type != THOROUGH_CLEAN_DEFAULT) {
             _thorough_clean_type = clean_type;
@@ -324,18 +368,49 @@ bool AP_SmartRTL::add_point(const Vector3f& point)
         return false;
     }
 
-    // check if we have traveled far enough
-    if (_path_points_count > 0) {
-        const Vector3f& last_pos = _path[_path_points_count-1];
+    // check if we have traveled far enough from the most recent point
+    if (_stream.have_pending || (_path_points_count > 0)) {
+        const Vector3f& last_pos = _stream.have_pending ? _stream.pending : _path[_path_points_count-1];
         if (last_pos.distance_squared(point) < sq(_accuracy.get())) {
             _path_sem.give();
             return true;
         }
     }
 
+    // the example sketch checks the background algorithms against fixed paths so does not use streaming simplification
+    if (_example_mode || (_path_points_count == 0)) {
+        const bool ret = append_point(point);
+        _path_sem.give();
+        return ret;
+    }
+
+    if (_stream.have_pending && stream_can_extend(point)) {
+        // extend the last segment to this point, dropping the previous pending point
+        _stream.window[_stream.window_count++] = point;
+        _stream.pending = point;
+        _path_sem.give();
+        return true;
+    }
+
+    // start a new segment from the previous point
+    if (!flush_pending_point()) {
+        _path_sem.give();
+        return false;
+    }
+    _stream.window[0] = point;
+    _stream.window_count = 1;
+    _stream.pending = point;
+    _stream.have_pending = true;
+
+    _path_sem.give();
+    return true;
+}
+
+// append point to path array, the path semaphore must be held
+bool AP_SmartRTL::append_point(const Vector3f& point)
+{
     // check we have space in the path
     if (_path_points_count >= _path_points_max) {
-        _path_sem.give();
         log_action(SRTL_ADD_FAILED_PATH_FULL, point);
         return false;
     }
@@ -343,8 +418,37 @@ bool AP_SmartRTL::add_point(const Vector3f& point)
     // add point to path
     _path[_path_points_count++] = point;
     log_action(SRTL_POINT_ADD, point);
+    return true;
+}
 
-    _path_sem.give();
+// returns true if the streaming simplifier can extend the last segment of the path to point
+// without any recently recorded point being more than SMARTRTL_SIMPLIFY_EPSILON from it, the path semaphore must be held
+bool AP_SmartRTL::stream_can_extend(const Vector3f& point) const
+{
+    if ((_path_points_count == 0) || (_stream.window_count >= SMARTRTL_STREAM_WINDOW_LEN)) {
+        return false;
+    }
+    const Vector3f& start = _path[_path_points_count-1];
+    for (uint8_t i = 0; i < _stream.window_count; i++) {
+        if (_stream.window[i].distance_to_segment(start, point) > SMARTRTL_SIMPLIFY_EPSILON) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// append the point held back by the streaming simplifier to the path, the path semaphore must be held
+// returns false if the path is full
+bool AP_SmartRTL::flush_pending_point()
+{
+    if (!_stream.have_pending) {
+        return true;
+    }
+    if (!append_point(_stream.pending)) {
+        return false;
+    }
+    _stream.have_pending = false;
+    _stream.window_count = 0;
     return true;
 }
 
@@ -560,6 +664,7 @@ void AP_SmartRTL::detect_simplifications()
 *   This method runs for the allotted time, and detects loops in a path. Any detected loops are added to _prune.loops,
 *   this function does not alter the path in memory. It works by comparing the line segment between any two sequential points
 *   to the line segment between any other two sequential points. If they get close enough, anything between them could be pruned.
+*   The segments close to each new segment are found using the pruning grid.
 *
 *   reset_pruning should have been called at least once before this function is called to setup the indexes (_prune.i, etc)
 */
@@ -571,39 +676,151 @@ void AP_SmartRTL::detect_loops()
         return;
     }
 
+    // index the segments the new segments will be compared against
+    if (!_prune.grid_built) {
+        build_pruning_grid();
+    }
+
     // capture start time
     const uint32_t start_time_us = AP_HAL::micros();
 
     // run for defined amount of time
     while (AP_HAL::micros() - start_time_us < SMARTRTL_PRUNING_LOOP_TIME_US) {
 
-        // advance inner loop
-        _prune.j++;
-        if (_prune.j > _prune.i - 2) {
-            // set inner loop back to first point
-            _prune.j = 1;
-            // reduce outer loop
-            _prune.i--;
-            // complete when outer loop has run out of new points to check
-            if (_prune.i < 4 || _prune.i < _prune.path_points_completed) {
+        // complete when we have run out of new points to check.  The last point is always checked
+        if ((_prune.i < _prune.path_points_count - 1) && (_prune.i < 4 || _prune.i < _prune.path_points_completed)) {
+            _prune.complete = true;
+            _prune.path_points_completed = _prune.path_points_count;
+            return;
+        }
+
+        // if there is a loop here, add to loop array
+        uint16_t j;
+        Vector3f midpoint;
+        if (find_loop(_prune.i, j, midpoint)) {
+            if (!add_loop(j, _prune.i-1, midpoint)) {
+                // if the buffer is full, stop trying to prune
                 _prune.complete = true;
                 _prune.path_points_completed = _prune.path_points_count;
                 return;
             }
         }
 
-        // find the closest distance between two line segments and the mid-point
-        dist_point dp = segment_segment_dist(_path[_prune.i], _path[_prune.i-1], _path[_prune.j-1], _path[_prune.j]);
-        if (dp.distance < SMARTRTL_PRUNING_DELTA) {
-            // if there is a loop here, add to loop array
-            if (!add_loop(_prune.j, _prune.i-1, dp.midpoint)) {
-                // if the buffer is full, stop trying to prune
-                _prune.complete = true;
+        // move to the previous segment
+        _prune.i--;
+    }
+}
+
+// rebuild the pruning grid from the segments on the path up to _prune.path_points_count
+void AP_SmartRTL::build_pruning_grid()
+{
+    _prune.grid_built = true;
+    if (_prune.grid_head == nullptr) {
+        return;
+    }
+
+    for (uint16_t b = 0; b < _prune.grid_buckets; b++) {
+        _prune.grid_head[b] = SMARTRTL_PRUNING_GRID_NONE;
+    }
+    _prune.grid_long_head = SMARTRTL_PRUNING_GRID_NONE;
+    _prune.grid_cell_size = MAX(_accuracy.get() * SMARTRTL_PRUNING_GRID_CELL_MULT, 1.0f);
+
+    // segments are added to the bucket of the cell holding their middle, those longer than two cells
+    // are kept in a separate list that is always checked
+    for (uint16_t j = 1; j < _prune.path_points_count; j++) {
+        const Vector3f& p1 = _path[j-1];
+        const Vector3f& p2 = _path[j];
+        uint16_t *head;
+        if (p1.distance_squared(p2) > sq(2.0f * _prune.grid_cell_size)) {
+            head = &_prune.grid_long_head;
+        } else {
+            head = &_prune.grid_head[grid_bucket(grid_coord((p1.x + p2.x) * 0.5f), grid_coord((p1.y + p2.y) * 0.5f))];
+        }
+        _prune.grid_next[j] = *head;
+        *head = j;
+    }
+}
+
+// convert a horizontal position in meters to a pruning grid cell coordinate
+int16_t AP_SmartRTL::grid_coord(float pos) const
+{
+    return (int16_t)constrain_float(floorf(pos / _prune.grid_cell_size), INT16_MIN + 1, INT16_MAX - 1);
+}
+
+// returns the pruning grid bucket holding the segments in a cell
+uint16_t AP_SmartRTL::grid_bucket(int16_t x, int16_t y) const
+{
+    const uint32_t hash = ((uint32_t)(uint16_t)x * 73856093U) ^ ((uint32_t)(uint16_t)y * 19349663U);
+    return hash & (_prune.grid_buckets - 1);
+}
+
+// find the earliest segment that comes within SMARTRTL_PRUNING_DELTA of the segment ending at point i
+// returns true on success and j is set to the end index of that segment
+bool AP_SmartRTL::find_loop(uint16_t i, uint16_t &j, Vector3f &midpoint) const
+{
+    const Vector3f& p1 = _path[i];
+    const Vector3f& p2 = _path[i-1];
+    uint16_t best_j = SMARTRTL_PRUNING_GRID_NONE;
+
+    // segments in the grid are no longer than two cells, so their middle is within this distance of our middle
+    // if they come close enough to be a loop
+    const float search_radius = (p1 - p2).length() * 0.5f + SMARTRTL_PRUNING_DELTA + _prune.grid_cell_size;
+    const float mid_x = (p1.x + p2.x) * 0.5f;
+    const float mid_y = (p1.y + p2.y) * 0.5f;
+    int16_t x_min = 0, x_max = 0, y_min = 0, y_max = 0;
+    bool use_grid = (_prune.grid_head != nullptr);
+    if (use_grid) {
+        x_min = grid_coord(mid_x - search_radius);
+        x_max = grid_coord(mid_x + search_radius);
+        y_min = grid_coord(mid_y - search_radius);
+        y_max = grid_coord(mid_y + search_radius);
+        // check every segment if the search covers more cells than there are segments
+        use_grid = ((int32_t)(x_max - x_min + 1) * (y_max - y_min + 1) <= i);
+    }
+
+    if (!use_grid) {
+        // segments are checked in order so the first match is the earliest
+        for (uint16_t k = 1; k + 1 < i; k++) {
+            const dist_point dp = segment_segment_dist(p1, p2, _path[k-1], _path[k]);
+            if (dp.distance < SMARTRTL_PRUNING_DELTA) {
+                j = k;
+                midpoint = dp.midpoint;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // check the segments in nearby cells and the long segments.  A bucket may be visited more than once
+    // if cells share it, which only repeats checks
+    for (int16_t x = x_min; x <= x_max; x++) {
+        for (int16_t y = y_min; y <= y_max; y++) {
+            for (uint16_t k = _prune.grid_head[grid_bucket(x, y)]; k != SMARTRTL_PRUNING_GRID_NONE; k = _prune.grid_next[k]) {
+                if ((k + 1 < i) && (k < best_j)) {
+                    const dist_point dp = segment_segment_dist(p1, p2, _path[k-1], _path[k]);
+                    if (dp.distance < SMARTRTL_PRUNING_DELTA) {
+                        best_j = k;
+                        midpoint = dp.midpoint;
+                    }
+                }
             }
-            // set inner loop forward to trigger outer loop move to next segment
-            _prune.j = _prune.i;
         }
     }
+    for (uint16_t k = _prune.grid_long_head; k != SMARTRTL_PRUNING_GRID_NONE; k = _prune.grid_next[k]) {
+        if ((k + 1 < i) && (k < best_j)) {
+            const dist_point dp = segment_segment_dist(p1, p2, _path[k-1], _path[k]);
+            if (dp.distance < SMARTRTL_PRUNING_DELTA) {
+                best_j = k;
+                midpoint = dp.midpoint;
+            }
+        }
+    }
+
+    if (best_j == SMARTRTL_PRUNING_GRID_NONE) {
+        return false;
+    }
+    j = best_j;
+    return true;
 }
 
 // restart simplify if new points have been added to path
@@ -647,8 +864,8 @@ void AP_SmartRTL::restart_pruning(uint16_t path_points_count)
 {
     _prune.complete = false;
     _prune.i = (path_points_count > 0) ? path_points_count - 1 : 0;
-    _prune.j = 0;
     _prune.path_points_count = path_points_count;
+    _prune.grid_built = false;
 }
 
 // reset pruning algorithm so that it will re-check all points in the path
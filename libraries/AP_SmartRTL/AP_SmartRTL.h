@@ -7,7 +7,7 @@
 // definitions and macros
 #define SMARTRTL_ACCURACY_DEFAULT        2.0f   // default _ACCURACY parameter value.  Points will be no closer than this distance (in meters) together.
 #define SMARTRTL_POINTS_DEFAULT          300    // default _POINTS parameter value.  High numbers improve path pruning but use more memory and CPU for cleanup. Memory used will be 20bytes * this number.
-#define SMARTRTL_POINTS_MAX              500    // the absolute maximum number of points this library can support.
+#define SMARTRTL_POINTS_MAX              1000   // the absolute maximum number of points this library can support.
 #define SMARTRTL_TIMEOUT                 15000  // the time in milliseconds with no points saved to the path (for whatever reason), before SmartRTL is disabled for the flight
 #define SMARTRTL_CLEANUP_POINT_TRIGGER   50     // simplification will trigger when this many points are added to the path
 #define SMARTRTL_CLEANUP_START_MARGIN    10     // routine cleanup algorithms begin when the path array has only this many empty slots remaining
@@ -20,6 +20,10 @@
 #define SMARTRTL_PRUNING_DELTA (_accuracy * 0.99)   // How many meters apart must two points be, such that we can assume that there is no obstacle between them.  must be smaller than _ACCURACY parameter
 #define SMARTRTL_PRUNING_LOOP_BUFFER_LEN_MULT 0.25f // pruning loop buffer size as compared to maximum number of points
 #define SMARTRTL_PRUNING_LOOP_TIME_US    200    // maximum time (in microseconds) that the loop finding algorithm will run before returning
+#define SMARTRTL_PRUNING_GRID_CELL_MULT  4.0f   // pruning grid cell width as a multiple of the _ACCURACY parameter.  Segments longer than two cells are checked against every new segment
+#define SMARTRTL_PRUNING_GRID_BUCKETS_MAX 512   // maximum number of pruning grid hash buckets
+#define SMARTRTL_PRUNING_GRID_NONE       UINT16_MAX // marks the end of a pruning grid bucket's list of segments
+#define SMARTRTL_STREAM_WINDOW_LEN       16     // maximum number of recent points the streaming simplifier checks before it must add a point to the path
 
 class AP_SmartRTL {
 
@@ -111,6 +115,17 @@ private:
     // add point to end of path
     bool add_point(const Vector3f& point);
 
+    // append point to path array, the path semaphore must be held
+    bool append_point(const Vector3f& point);
+
+    // returns true if the streaming simplifier can extend the last segment of the path to point
+    // without any recently recorded point being more than SMARTRTL_SIMPLIFY_EPSILON from it, the path semaphore must be held
+    bool stream_can_extend(const Vector3f& point) const;
+
+    // append the point held back by the streaming simplifier to the path, the path semaphore must be held
+    // returns false if the path is full
+    bool flush_pending_point();
+
     // routine cleanup attempts to remove 10 points (see SMARTRTL_CLEANUP_POINT_MIN definition) by simplification or loop pruning
     void routine_cleanup(uint16_t path_points_count, uint16_t path_points_complete_limit);
 
@@ -146,6 +161,17 @@ private:
     // reset pruning algorithm so that it will re-check all points in the path
     void reset_pruning();
 
+    // rebuild the pruning grid from the segments on the path up to _prune.path_points_count
+    void build_pruning_grid();
+
+    // pruning grid cell coordinate of a position in meters and the hash bucket of a cell
+    int16_t grid_coord(float pos) const;
+    uint16_t grid_bucket(int16_t x, int16_t y) const;
+
+    // find the earliest segment that comes within SMARTRTL_PRUNING_DELTA of the segment ending at point i
+    // returns true on success and j is set to the end index of that segment
+    bool find_loop(uint16_t i, uint16_t &j, Vector3f &midpoint) const;
+
     // remove all simplify-able points from the path
     void remove_points_by_simplify_bitmask();
 
@@ -198,6 +224,15 @@ private:
     uint16_t _path_points_completed_limit;  // set by main thread to the path_point_count when a point is popped.  used by simplify and prune algorithms to detect path shrinking
     HAL_Semaphore _path_sem;   // semaphore for updating path
 
+    // Streaming simplification
+    // the most recent point is held back from the path while the last segment on the path can be extended to it
+    struct {
+        Vector3f pending;       // most recent point recorded, not yet on the path
+        bool have_pending;      // true if pending holds a point
+        Vector3f window[SMARTRTL_STREAM_WINDOW_LEN];  // points recorded since the last point on the path, ending with pending
+        uint8_t window_count;   // number of elements in the window array
+    } _stream;
+
     // Simplify
     // structure and buffer to hold the "to-do list" for the simplify algorithm.
     typedef struct {
@@ -226,11 +261,19 @@ private:
         bool complete;
         uint16_t path_points_count;  // copy of _path_points_count taken when the prune algorithm started
         uint16_t path_points_completed; // number of points in that path that have already been checked for loops and should be ignored
-        uint16_t i;     // loop search's outer loop index
-        uint16_t j;     // loop search's inner loop index
+        uint16_t i;     // loop search's index of the end of the segment being checked
         prune_loop_t* loops;// the result of the pruning algorithm
         uint16_t loops_max; // maximum number of elements in the _prunable_loops array
         uint16_t loops_count;   // number of elements in the _prunable_loops array
+
+        // spatial hash of the path's segments by the horizontal position of their middle, used to find
+        // segments close to each new segment.  Segments are identified by the index of their end point
+        uint16_t* grid_head;    // first segment in each bucket, nullptr if allocation failed and every segment is checked
+        uint16_t* grid_next;    // next segment in the same bucket (or in the long segment list)
+        uint16_t grid_buckets;  // number of elements in the grid_head array, a power of two
+        uint16_t grid_long_head;// first segment too long to be found through the grid
+        float grid_cell_size;   // width of the grid cells in meters
+        bool grid_built;        // true once the grid holds the segments up to path_points_count
     } _prune;
 
     // returns true if the two loops overlap (used within add_loop to determine which loops to keep or throw away)
@@ -277,16 +277,32 @@ void SoaringController::init_thermalling()
         return;
     }
 
-    // New state vector filter will be reset. Thermal location is placed in front of a/c
-    const float init_xr[4] = {_vario.get_trigger_value(),
-                              INITIAL_THERMAL_RADIUS,
-                              position.x + thermal_distance_ahead * cosf(_ahrs.yaw),
-                              position.y + thermal_distance_ahead * sinf(_ahrs.yaw)};
-
-    const VectorN<float,4> xr{init_xr};
+    // New state vectors, filters will be reset. The first thermal location is placed in front of a/c and
+    // the others fanned out either side of it, so a thermal off to one side doesn't have to be found by
+    // first drifting the estimate across.
+    for (uint8_t i=0; i<SOARING_THERMAL_HYPOTHESES; i++) {
+        const float offset = ((i+1)/2) * (i%2 ? 1 : -1) * radians(HYPOTHESIS_SPREAD_DEG);
+        const float init_xr[4] = {_vario.get_trigger_value(),
+                                  INITIAL_THERMAL_RADIUS,
+                                  position.x + thermal_distance_ahead * cosf(_ahrs.yaw + offset),
+                                  position.y + thermal_distance_ahead * sinf(_ahrs.yaw + offset)};
+
+        const VectorN<float,4> xr{init_xr};
+
+        // Also reset covariance matrix p so filter is not affected by previous data
+        _ekf[i].reset(xr, p, q, r);
+        _ekf_innovation[i] = 0;
+    }
 
-    // Also reset covariance matrix p so filter is not affected by previous data
-    _ekf.reset(xr, p, q, r);
+    // Try a thermal we have been in before if there is one nearby, in place of the outermost guess.
+    Vector2f remembered;
+    if (SOARING_THERMAL_HYPOTHESES > 1 && recall_thermal(Vector2f(position.x, position.y), remembered)) {
+        ExtendedKalmanFilter &ekf = _ekf[SOARING_THERMAL_HYPOTHESES-1];
+        ekf.X[2] = remembered.x;
+        ekf.X[3] = remembered.y;
+    }
+    _best_ekf = 0;
+    _thermalling = true;
 
     _prev_update_time = AP_HAL::micros64();
     _thermal_start_time_us = AP_HAL::micros64();
@@ -294,12 +310,20 @@ void SoaringController::init_thermalling()
 
     _vario.reset_climb_filter(0.0);
 
-    _position_x_filter.reset(_ekf.X[2]);
-    _position_y_filter.reset(_ekf.X[3]);
+    _position_x_filter.reset(best_ekf().X[2]);
+    _position_y_filter.reset(best_ekf().X[3]);
 
     _exit_commanded = false;
 }
 
+void SoaringController::end_thermalling()
+{
+    if (_thermalling) {
+        remember_thermal();
+        _thermalling = false;
+    }
+}
+
 void SoaringController::init_cruising()
 {
     if (_last_update_status >= ActiveStatus::MANUAL_MODE_CHANGE) {
@@ -320,13 +344,29 @@ void SoaringController::update_thermalling()
         return;
     }
 
-    Vector3f wind_drift = _ahrs.wind_estimate()*deltaT*_vario.get_filtered_climb()/_ekf.X[0];
+    const Vector3f wind = _ahrs.wind_estimate();
+    Vector3f wind_drift;
 
-    // update the filter
-    _ekf.update(_vario.reading, current_position.x, current_position.y, wind_drift.x, wind_drift.y);
+    // update the filters, each with the same reading. The innovations are filtered over about one circle.
+    const float alpha = deltaT / (deltaT + MAX(_vario.tau, 1.0f));
+    for (uint8_t i=0; i<SOARING_THERMAL_HYPOTHESES; i++) {
+        ExtendedKalmanFilter &ekf = _ekf[i];
+        Vector3f drift;
+        if (is_positive(ekf.X[0])) {
+            drift = wind*deltaT*_vario.get_filtered_climb()/ekf.X[0];
+        }
+        const float innovation = ekf.update(_vario.reading, current_position.x, current_position.y, drift.x, drift.y);
+        _ekf_innovation[i] += alpha * (innovation - _ekf_innovation[i]);
+        if (i == _best_ekf) {
+            wind_drift = drift;
+        }
+    }
 
-    
-    _thermalability = (_ekf.X[0]*expf(-powf(get_thermalling_radius()/_ekf.X[1], 2))) - _vario.get_exp_thermalling_sink();
+    select_hypothesis();
+
+    const ExtendedKalmanFilter &ekf = best_ekf();
+
+    _thermalability = (ekf.X[0]*expf(-powf(get_thermalling_radius()/ekf.X[1], 2))) - _vario.get_exp_thermalling_sink();
 
     _prev_update_time = AP_HAL::micros64();
 
@@ -334,8 +374,8 @@ void SoaringController::update_thermalling()
     _position_x_filter.set_cutoff_frequency(1/(3*_vario.tau));
     _position_y_filter.set_cutoff_frequency(1/(3*_vario.tau));
 
-    _position_x_filter.apply(_ekf.X[2], deltaT);
-    _position_y_filter.apply(_ekf.X[3], deltaT);
+    _position_x_filter.apply(ekf.X[2], deltaT);
+    _position_y_filter.apply(ekf.X[3], deltaT);
 
     // write log - save the data.
     // @LoggerMessage: SOAR
@@ -354,19 +394,90 @@ void SoaringController::update_thermalling()
     // @Field: dx_w: Wind speed north
     // @Field: dy_w: Wind speed east
     // @Field: th: Estimate of achievable climbrate in thermal
-    AP::logger().WriteStreaming("SOAR", "TimeUS,nettorate,x0,x1,x2,x3,north,east,alt,dx_w,dy_w,th", "Qfffffffffff",
+    // @Field: hyp: Index of the thermal hypothesis being followed
+    AP::logger().WriteStreaming("SOAR", "TimeUS,nettorate,x0,x1,x2,x3,north,east,alt,dx_w,dy_w,th,hyp", "QfffffffffffB",
                                            AP_HAL::micros64(),
                                            (double)_vario.reading,
-                                           (double)_ekf.X[0],
-                                           (double)_ekf.X[1],
-                                           (double)_ekf.X[2],
-                                           (double)_ekf.X[3],
+                                           (double)ekf.X[0],
+                                           (double)ekf.X[1],
+                                           (double)ekf.X[2],
+                                           (double)ekf.X[3],
                                            current_position.x,
                                            current_position.y,
                                            (double)_vario.alt,
                                            (double)wind_drift.x,
                                            (double)wind_drift.y,
-                                           (double)_thermalability);
+                                           (double)_thermalability,
+                                           _best_ekf);
+}
+
+/*
+  follow the hypothesis that best explains the vario readings. The
+  current one is kept unless another fits clearly better, so the
+  loiter target doesn't hop between similar estimates
+ */
+void SoaringController::select_hypothesis(void)
+{
+    uint8_t best = _best_ekf;
+    for (uint8_t i=0; i<SOARING_THERMAL_HYPOTHESES; i++) {
+        if (_ekf_innovation[i] < _ekf_innovation[best]) {
+            best = i;
+        }
+    }
+    if (_ekf_innovation[best] < HYPOTHESIS_SWITCH_RATIO * _ekf_innovation[_best_ekf]) {
+        _best_ekf = best;
+    }
+}
+
+/*
+  store the thermal we are leaving if it was worth being in, over an
+  earlier record of the same thermal or else the oldest one
+ */
+void SoaringController::remember_thermal(void)
+{
+    const ExtendedKalmanFilter &ekf = best_ekf();
+    if (ekf.X[0] < thermal_vspeed) {
+        return;
+    }
+    const Vector2f position(ekf.X[2], ekf.X[3]);
+    const uint32_t now_ms = AP_HAL::millis();
+    uint8_t slot = 0;
+    for (uint8_t i=0; i<SOARING_THERMAL_MEMORY; i++) {
+        const thermal_memory &m = _thermal_memory[i];
+        if (m.time_ms != 0 && (m.position - position).length() < THERMAL_MEMORY_RADIUS) {
+            slot = i;
+            break;
+        }
+        if (now_ms - m.time_ms > now_ms - _thermal_memory[slot].time_ms) {
+            slot = i;
+        }
+    }
+    _thermal_memory[slot].position = position;
+    _thermal_memory[slot].strength = ekf.X[0];
+    _thermal_memory[slot].time_ms = now_ms;
+}
+
+/*
+  find the strongest remembered thermal near a position, allowing for
+  its drift with the wind since it was left
+ */
+bool SoaringController::recall_thermal(const Vector2f &near, Vector2f &position) const
+{
+    const uint32_t now_ms = AP_HAL::millis();
+    const Vector3f wind = AP::ahrs().wind_estimate();
+    float strength = 0;
+    for (const thermal_memory &m : _thermal_memory) {
+        const uint32_t age_ms = now_ms - m.time_ms;
+        if (m.time_ms == 0 || age_ms > THERMAL_MEMORY_TIMEOUT_MS || m.strength <= strength) {
+            continue;
+        }
+        const Vector2f drifted = m.position + Vector2f(wind.x, wind.y) * (age_ms * 0.001f);
+        if ((drifted - near).length() < THERMAL_MEMORY_RADIUS) {
+            position = drifted;
+            strength = m.strength;
+        }
+    }
+    return is_positive(strength);
 }
 
 void SoaringController::update_cruising()
@@ -470,7 +581,7 @@ bool SoaringController::check_drift(Vector2f prev_wp, Vector2f next_wp)
     }
 
     // Check against the estimated thermal.
-    Vector2f position(_ekf.X[2], _ekf.X[3]);
+    Vector2f position(best_ekf().X[2], best_ekf().X[3]);
 
     Vector2f start_pos(_thermal_start_pos.x, _thermal_start_pos.y);
 
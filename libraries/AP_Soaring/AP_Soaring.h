@@ -28,10 +28,47 @@
 #define INITIAL_RADIUS_COVARIANCE 400.0
 #define INITIAL_POSITION_COVARIANCE 400.0
 
+// number of thermal hypotheses tracked in parallel while thermalling
+#ifndef SOARING_THERMAL_HYPOTHESES
+#define SOARING_THERMAL_HYPOTHESES 3
+#endif
+
+// number of past thermals remembered
+#ifndef SOARING_THERMAL_MEMORY
+#define SOARING_THERMAL_MEMORY 4
+#endif
+
+#define HYPOTHESIS_SPREAD_DEG 60.0      // bearing between hypotheses placed ahead
+#define HYPOTHESIS_SWITCH_RATIO 0.7     // innovation ratio needed to change hypothesis
+#define THERMAL_MEMORY_RADIUS 200.0     // distance within which a remembered thermal is the same or worth trying
+#define THERMAL_MEMORY_TIMEOUT_MS 600000
+
 
 class SoaringController {
     Variometer::PolarParams _polarParams;
-    ExtendedKalmanFilter _ekf{};
+
+    // bank of thermal hypotheses, all updated from each vario reading
+    ExtendedKalmanFilter _ekf[SOARING_THERMAL_HYPOTHESES];
+    // filtered normalised innovation of each hypothesis, lower fits better
+    float _ekf_innovation[SOARING_THERMAL_HYPOTHESES];
+    // hypothesis being followed
+    uint8_t _best_ekf;
+
+    const ExtendedKalmanFilter &best_ekf() const { return _ekf[_best_ekf]; }
+
+    // thermals found earlier in the flight, drifted with the wind when recalled
+    struct thermal_memory {
+        Vector2f position;  // NE from home when it was left
+        float strength;
+        uint32_t time_ms;   // zero if unused
+    } _thermal_memory[SOARING_THERMAL_MEMORY];
+
+    bool _thermalling;
+
+    void select_hypothesis(void);
+    void remember_thermal(void);
+    bool recall_thermal(const Vector2f &near, Vector2f &position) const;
+
     class AP_TECS &_tecs;
     Variometer _vario;
     SpeedToFly _speedToFly;
@@ -109,6 +146,7 @@ public:
     bool check_thermal_criteria();
     LoiterStatus check_cruise_criteria(Vector2f prev_wp, Vector2f next_wp);
     void init_thermalling();
+    void end_thermalling();
     void init_cruising();
     void update_thermalling();
     void update_cruising();
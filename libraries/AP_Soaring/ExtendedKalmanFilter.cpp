@@ -29,7 +29,7 @@ void ExtendedKalmanFilter::reset(const VectorN<float,N> &x, const MatrixN<float,
 }
 
 
-void ExtendedKalmanFilter::update(float z, float Px, float Py, float driftX, float driftY)
+float ExtendedKalmanFilter::update(float z, float Px, float Py, float driftX, float driftY)
 {
     MatrixN<float,N> tempM;
     VectorN<float,N> H;
@@ -61,7 +61,8 @@ void ExtendedKalmanFilter::update(float z, float Px, float Py, float driftX, flo
     // LINE 41
     // Calculate the KALMAN GAIN
     // K = P12 * inv(H*P12 + ekf.R);                     %Kalman filter gain
-    K = P12 * 1.0 / (H * P12 + R);
+    const float S = H * P12 + R;
+    K = P12 * 1.0 / S;
 
     // Correct the state estimate using the measurement residual.
     // LINE 44
@@ -79,4 +80,6 @@ void ExtendedKalmanFilter::update(float z, float Px, float Py, float driftX, flo
     P -= tempM;
     
     P.force_symmetry();
+
+    return (z - z1) * (z - z1) / S;
 }
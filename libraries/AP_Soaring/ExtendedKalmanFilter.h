@@ -20,7 +20,8 @@ public:
     MatrixN<float,N> Q;
     float R;
     void reset(const VectorN<float,N> &x, const MatrixN<float,N> &p, const MatrixN<float,N> q, float r);
-    void update(float z, float Px, float Py, float driftX, float driftY);
+    // returns the normalised innovation squared of the measurement
+    float update(float z, float Px, float Py, float driftX, float driftY);
 
 private:
     float measurementpredandjacobian(VectorN<float,N> &A, float Px, float Py);
@@ -714,18 +714,16 @@ void AP_TECS::_update_throttle_with_airspeed(void)
         _throttle_dem = 0.0f;
     } else {
         // Calculate gain scaler from specific energy error to throttle
-        // (_STEdot_max - _STEdot_min) / (_THRmaxf - _THRminf) is the derivative of STEdot wrt throttle measured across the max allowed throttle range.
-        const float K_STE2Thr = 1 / (timeConstant() * (_STEdot_max - _STEdot_min) / (_THRmaxf - _THRminf));
+        // (_THRmaxf - _THRminf) / (_STEdot_max - _STEdot_min) is the derivative of throttle wrt STEdot measured across the max allowed throttle range.
+        const float STEdot_to_thr = (_THRmaxf - _THRminf) / (_STEdot_max - _STEdot_min);
+        const float K_STE2Thr = STEdot_to_thr / timeConstant();
 
         // Calculate feed-forward throttle
         const float nomThr = aparm.throttle_cruise * 0.01f;
-        const Matrix3f &rotMat = _ahrs.get_rotation_body_to_ned();
         // Use the demanded rate of change of total energy as the feed-forward demand, but add
-        // additional component which scales with (1/cos(bank angle) - 1) to compensate for induced
-        // drag increase during turns.
-        const float cosPhi = sqrtf((rotMat.a.y*rotMat.a.y) + (rotMat.b.y*rotMat.b.y));
-        STEdot_dem = STEdot_dem + _rollComp * (1.0f/constrain_float(cosPhi * cosPhi, 0.1f, 1.0f) - 1.0f);
-        const float ff_throttle = nomThr + STEdot_dem / (_STEdot_max - _STEdot_min) * (_THRmaxf - _THRminf);
+        // additional component to compensate for induced drag increase during turns.
+        STEdot_dem = STEdot_dem + _turn_drag_STEdot();
+        const float ff_throttle = nomThr + STEdot_dem * STEdot_to_thr;
 
         // Calculate PD + FF throttle
         float throttle_damp = _thrDamp;
@@ -878,13 +876,21 @@ void AP_TECS::_update_throttle_without_airspeed(int16_t throttle_nudge)
     }
 
     // Calculate additional throttle for turn drag compensation including throttle nudging
+    const float STEdot_dem = _turn_drag_STEdot();
+    _throttle_dem = _throttle_dem + STEdot_dem * (_THRmaxf - _THRminf) / (_STEdot_max - _STEdot_min);
+}
+
+/*
+  the extra rate of change of specific total energy needed to hold
+  speed and height in a turn, which scales with (1/cos(bank angle) - 1)
+  for the induced drag. cos^2 of the bank angle is taken directly
+  from the DCM, without a square root
+ */
+float AP_TECS::_turn_drag_STEdot(void) const
+{
     const Matrix3f &rotMat = _ahrs.get_rotation_body_to_ned();
-    // Use the demanded rate of change of total energy as the feed-forward demand, but add
-    // additional component which scales with (1/cos(bank angle) - 1) to compensate for induced
-    // drag increase during turns.
-    float cosPhi = sqrtf((rotMat.a.y*rotMat.a.y) + (rotMat.b.y*rotMat.b.y));
-    float STEdot_dem = _rollComp * (1.0f/constrain_float(cosPhi * cosPhi, 0.1f, 1.0f) - 1.0f);
-    _throttle_dem = _throttle_dem + STEdot_dem / (_STEdot_max - _STEdot_min) * (_THRmaxf - _THRminf);
+    const float cosPhi_sq = (rotMat.a.y*rotMat.a.y) + (rotMat.b.y*rotMat.b.y);
+    return _rollComp * (1.0f/constrain_float(cosPhi_sq, 0.1f, 1.0f) - 1.0f);
 }
 
 void AP_TECS::_detect_bad_descent(void)
@@ -459,6 +459,9 @@ private:
     // Update Demanded Throttle Non-Airspeed
     void _update_throttle_without_airspeed(int16_t throttle_nudge);
 
+    // extra specific total energy rate for turn drag
+    float _turn_drag_STEdot(void) const;
+
     // get integral gain which is flight_stage dependent
     float _get_i_gain(void);
 
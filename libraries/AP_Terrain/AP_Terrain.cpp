@@ -83,7 +83,8 @@ const AP_Param::GroupInfo AP_Terrain::var_info[] = {
 // constructor
 AP_Terrain::AP_Terrain() :
     disk_io_state(DiskIoIdle),
-    fd(-1)
+    fd(-1),
+    raw_fd(-1)
 {
     AP_Param::setup_object_defaults(this, var_info);
 
@@ -126,9 +127,6 @@ bool AP_Terrain::height_amsl(const Location &loc, float &height, bool corrected)
 
     calculate_grid_info(loc, info);
 
-    // find the grid
-    const struct grid_block &grid = find_grid_cache(info).grid;
-
     /*
       note that we rely on the one square overlap to ensure these
       calculations don't go past the end of the arrays
@@ -136,31 +134,20 @@ bool AP_Terrain::height_amsl(const Location &loc, float &height, bool corrected)
     ASSERT_RANGE(info.idx_x, 0, TERRAIN_GRID_BLOCK_SIZE_X-2);
     ASSERT_RANGE(info.idx_y, 0, TERRAIN_GRID_BLOCK_SIZE_Y-2);
 
+    // find the grid, preferring a memory mapped terrain file
+    const struct grid_block *gridp = nullptr;
+#if AP_TERRAIN_MMAP_ENABLED
+    gridp = find_mmap_block(info);
+#endif
+    if (gridp == nullptr || !check_square_bitmap(*gridp, info)) {
+        gridp = &find_grid_cache(info).grid;
 
-    // check we have all 4 required heights
-    if (!check_bitmap(grid, info.idx_x,   info.idx_y) ||
-        !check_bitmap(grid, info.idx_x,   info.idx_y+1) ||
-        !check_bitmap(grid, info.idx_x+1, info.idx_y) ||
-        !check_bitmap(grid, info.idx_x+1, info.idx_y+1)) {
-        return false;
+        // check we have all 4 required heights
+        if (!check_square_bitmap(*gridp, info)) {
+            return false;
+        }
     }
-
-    // hXY are the heights of the 4 surrounding grid points
-    int16_t h00, h01, h10, h11;
-
-    h00 = grid.height[info.idx_x+0][info.idx_y+0];
-    h01 = grid.height[info.idx_x+0][info.idx_y+1];
-    h10 = grid.height[info.idx_x+1][info.idx_y+0];
-    h11 = grid.height[info.idx_x+1][info.idx_y+1];
-
-    // do a simple dual linear interpolation. We could do something
-    // fancier, but it probably isn't worth it as long as the
-    // grid_spacing is kept small enough
-    float avg1 = (1.0f-info.frac_x) * h00  + info.frac_x * h10;
-    float avg2 = (1.0f-info.frac_x) * h01  + info.frac_x * h11;
-    float avg  = (1.0f-info.frac_y) * avg1 + info.frac_y * avg2;
-
-    height = avg;
+    height = interpolate_height(*gridp, info);
 
     if (loc.lat == ahrs.get_home().lat &&
         loc.lng == ahrs.get_home().lng) {
@@ -178,6 +165,119 @@ bool AP_Terrain::height_amsl(const Location &loc, float &height, bool corrected)
 }
 
 
+/*
+  find the terrain heights for a set of locations, a batch at a time.
+  Within a batch the locations are sorted by grid block, so each block
+  is found once in the memory mapped files or the cache. A block that
+  is not cached gets a cache entry when first looked up, which queues
+  it for loading from disk or the GCS along with the other missing
+  blocks of the batch
+ */
+uint16_t AP_Terrain::heights_amsl(const Location *locs, uint16_t count, float *heights, bool *valid, bool corrected)
+{
+    if (!allocate()) {
+        memset(valid, 0, count * sizeof(valid[0]));
+        return 0;
+    }
+
+    const Location &home = AP::ahrs().get_home();
+
+    // true if a's block sorts before b's block
+    auto block_before = [](const struct grid_info &a, const struct grid_info &b) {
+        return a.grid_lat < b.grid_lat ||
+            (a.grid_lat == b.grid_lat && a.grid_lon < b.grid_lon);
+    };
+    auto same_block = [this](const struct grid_info &a, const struct grid_info &b) {
+        return TERRAIN_LATLON_EQUAL(a.grid_lat, b.grid_lat) &&
+            TERRAIN_LATLON_EQUAL(a.grid_lon, b.grid_lon);
+    };
+
+    for (uint16_t base=0; base<count; base += TERRAIN_HEIGHT_BATCH_MAX) {
+        const uint8_t n = MIN(count - base, TERRAIN_HEIGHT_BATCH_MAX);
+        struct grid_info info[TERRAIN_HEIGHT_BATCH_MAX];
+        uint8_t order[TERRAIN_HEIGHT_BATCH_MAX];
+        uint8_t nsorted = 0;
+
+        for (uint8_t i=0; i<n; i++) {
+            const Location &loc = locs[base+i];
+            if ((loc.lat == home_loc.lat && loc.lng == home_loc.lng) ||
+                (loc.lat == home.lat && loc.lng == home.lng)) {
+                // home has its own cached height, which height_amsl()
+                // keeps up to date
+                valid[base+i] = height_amsl(loc, heights[base+i], corrected);
+                continue;
+            }
+            calculate_grid_info(loc, info[i]);
+            uint8_t j = nsorted++;
+            while (j > 0 && block_before(info[i], info[order[j-1]])) {
+                order[j] = order[j-1];
+                j--;
+            }
+            order[j] = i;
+        }
+
+        for (uint8_t k=0; k<nsorted; ) {
+            const struct grid_info &block_info = info[order[k]];
+            const struct grid_block *mmap_grid = nullptr;
+#if AP_TERRAIN_MMAP_ENABLED
+            mmap_grid = find_mmap_block(block_info);
+#endif
+            const struct grid_block *cache_grid = nullptr;
+            for (; k<nsorted && same_block(info[order[k]], block_info); k++) {
+                const uint8_t i = order[k];
+                ASSERT_RANGE(info[i].idx_x, 0, TERRAIN_GRID_BLOCK_SIZE_X-2);
+                ASSERT_RANGE(info[i].idx_y, 0, TERRAIN_GRID_BLOCK_SIZE_Y-2);
+                // prefer the memory mapped block, as height_amsl() does
+                const struct grid_block *gridp = mmap_grid;
+                if (gridp == nullptr || !check_square_bitmap(*gridp, info[i])) {
+                    if (cache_grid == nullptr) {
+                        cache_grid = &find_grid_cache(block_info).grid;
+                    }
+                    gridp = cache_grid;
+                }
+                valid[base+i] = check_square_bitmap(*gridp, info[i]);
+                if (!valid[base+i]) {
+                    continue;
+                }
+                heights[base+i] = interpolate_height(*gridp, info[i]);
+                if (corrected && have_reference_offset) {
+                    heights[base+i] += reference_offset;
+                }
+            }
+        }
+    }
+
+    uint16_t found = 0;
+    for (uint16_t i=0; i<count; i++) {
+        if (valid[i]) {
+            found++;
+        }
+    }
+    return found;
+}
+
+/*
+  height at a grid_info within a block, which must have the 4 heights
+  around it
+ */
+float AP_Terrain::interpolate_height(const struct grid_block &grid, const struct grid_info &info) const
+{
+    // hXY are the heights of the 4 surrounding grid points
+    int16_t h00, h01, h10, h11;
+
+    h00 = grid.height[info.idx_x+0][info.idx_y+0];
+    h01 = grid.height[info.idx_x+0][info.idx_y+1];
+    h10 = grid.height[info.idx_x+1][info.idx_y+0];
+    h11 = grid.height[info.idx_x+1][info.idx_y+1];
+
+    // do a simple dual linear interpolation. We could do something
+    // fancier, but it probably isn't worth it as long as the
+    // grid_spacing is kept small enough
+    float avg1 = (1.0f-info.frac_x) * h00  + info.frac_x * h10;
+    float avg2 = (1.0f-info.frac_x) * h01  + info.frac_x * h11;
+    return (1.0f-info.frac_y) * avg1 + info.frac_y * avg2;
+}
+
 /* 
    find difference between home terrain height and the terrain
    height at the current location in meters. A positive result
@@ -354,8 +454,11 @@ void AP_Terrain::update(void)
     // update tiles surrounding our current location:
     if (pos_valid) {
         have_surrounding_tiles = update_surrounding_tiles(loc);
+        // and load the tiles we are heading into
+        update_prefetch(loc);
     } else {
         have_surrounding_tiles = false;
+        prefetch_count = 0;
     }
 
     // update capabilities and status
@@ -455,8 +558,13 @@ bool AP_Terrain::allocate(void)
     if (cache != nullptr) {
         return true;
     }
+    packed_block = (union grid_packed_io_block *)calloc(1, sizeof(*packed_block));
     cache = (struct grid_cache *)calloc(TERRAIN_GRID_BLOCK_CACHE_SIZE, sizeof(cache[0]));
-    if (cache == nullptr) {
+    if (cache == nullptr || packed_block == nullptr) {
+        free(cache);
+        free(packed_block);
+        cache = nullptr;
+        packed_block = nullptr;
         gcs().send_text(MAV_SEVERITY_CRITICAL, "Terrain: Allocation failed");
         memory_alloc_failed = true;
         return false;
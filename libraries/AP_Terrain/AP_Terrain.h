@@ -54,10 +54,53 @@
 #define TERRAIN_GRID_BLOCK_SIZE_Y (TERRAIN_GRID_MAVLINK_SIZE*TERRAIN_GRID_BLOCK_MUL_Y)
 
 // number of grid_blocks in the LRU memory cache
+#ifndef TERRAIN_GRID_BLOCK_CACHE_SIZE
 #define TERRAIN_GRID_BLOCK_CACHE_SIZE 12
+#endif
+
+// on boards with plenty of RAM and a local filesystem the terrain
+// files are memory mapped, so lookups anywhere in a mapped file are
+// served directly from the file without going through the LRU cache
+#ifndef AP_TERRAIN_MMAP_ENABLED
+#define AP_TERRAIN_MMAP_ENABLED (CONFIG_HAL_BOARD == HAL_BOARD_SITL || CONFIG_HAL_BOARD == HAL_BOARD_LINUX)
+#endif
+
+// number of one degree terrain files kept mapped at once
+#define TERRAIN_MMAP_MAX_FILES 4
+
+// how often to retry mapping a file that could not be mapped
+#define TERRAIN_MMAP_RETRY_MS 5000
+
+// number of upcoming grid_blocks the prefetcher keeps ranked by ETA.
+// Kept well below TERRAIN_GRID_BLOCK_CACHE_SIZE so prefetching never
+// evicts the blocks around the current location
+#define TERRAIN_PREFETCH_MAX_BLOCKS 4
+
+// how far ahead in seconds the prefetcher looks along the expected path
+#define TERRAIN_PREFETCH_TIME_S 120
+
+// limits on the work done by each prefetch update: path samples taken,
+// mission items read and new blocks loaded from disk or the GCS
+#define TERRAIN_PREFETCH_MAX_SAMPLES 64
+#define TERRAIN_PREFETCH_MAX_MISSION_ITEMS 20
+#define TERRAIN_PREFETCH_LOADS_PER_UPDATE 1
+
+// time between prefetch updates
+#define TERRAIN_PREFETCH_INTERVAL_MS 1000
+
+// number of locations heights_amsl() sorts by grid block and looks up
+// together. Kept below TERRAIN_GRID_BLOCK_CACHE_SIZE so the blocks
+// missing from one batch can all be loaded without evicting each other
+#define TERRAIN_HEIGHT_BATCH_MAX 10
 
-// format of grid on disk
-#define TERRAIN_GRID_FORMAT_VERSION 1
+// format of grid on disk. Version 2 is the compressed tile format of
+// the .DTZ files, version 1 the uncompressed grid_block of the .DAT
+// files, which are still read and hold blocks that don't compress
+#define TERRAIN_GRID_FORMAT_VERSION 2
+#define TERRAIN_GRID_FORMAT_VERSION_RAW 1
+
+// size of a compressed grid block on disk
+#define TERRAIN_GRID_PACKED_SIZE 1024
 
 // we allow for a 2cm discrepancy in the grid corners. This is to
 // account for different rounding in terrain DAT file generators using
@@ -126,6 +169,17 @@ public:
      */
     bool height_amsl(const Location &loc, float &height, bool corrected = true);
 
+    /*
+      find the terrain heights in meters above sea level for a set of
+      locations. The locations are sorted by grid block so each block
+      is looked up once, and every missing block is queued for loading
+      rather than just the first. valid[i] is set if heights[i] is
+      available
+
+      return the number of locations with a height
+     */
+    uint16_t heights_amsl(const Location *locs, uint16_t count, float *heights, bool *valid, bool corrected = true);
+
     /* 
        find difference between home terrain height and the terrain
        height at the current location in meters. A positive result
@@ -243,6 +297,41 @@ private:
         uint8_t buffer[2048];
     };
 
+    /*
+      a grid_block compressed for disk IO. Only the heights of the 4x4
+      grids set in the bitmap are stored, each as the difference from a
+      prediction from its west, south and south west neighbours, Rice
+      coded with a parameter chosen per row
+     */
+    struct PACKED grid_packed_block {
+        uint64_t bitmap;
+        int32_t lat;
+        int32_t lon;
+
+        // crc of the header and the used data, taken with crc=0
+        uint16_t crc;
+        uint16_t version;
+        uint16_t spacing;
+        uint16_t grid_idx_x;
+        uint16_t grid_idx_y;
+        int16_t lon_degrees;
+        int8_t lat_degrees;
+
+        // bytes of data used
+        uint16_t length;
+
+        // coded heights
+        uint8_t data[TERRAIN_GRID_PACKED_SIZE-31];
+    };
+
+    /*
+      grid_packed_block for disk IO, aligned on 1024 byte boundaries
+     */
+    union grid_packed_io_block {
+        struct grid_packed_block block;
+        uint8_t buffer[TERRAIN_GRID_PACKED_SIZE];
+    };
+
     enum GridCacheState {
         GRID_CACHE_INVALID=0,    // when first initialised
         GRID_CACHE_DISKWAIT=1,   // when waiting for disk read
@@ -295,6 +384,9 @@ private:
     // given a location, fill a grid_info structure
     void calculate_grid_info(const Location &loc, struct grid_info &info) const;
 
+    // height at a grid_info by interpolating the 4 heights around it
+    float interpolate_height(const struct grid_block &grid, const struct grid_info &info) const;
+
     /*
       find a grid structure given a grid_info
     */
@@ -312,12 +404,27 @@ private:
     */
     bool check_bitmap(const struct grid_block &grid, uint8_t idx_x, uint8_t idx_y);
 
+    /*
+      check that all 4 heights around a grid_info square are available
+    */
+    bool check_square_bitmap(const struct grid_block &grid, const struct grid_info &info);
+
+    /*
+      find the cache index of a grid_info's block, or -1 if not cached
+    */
+    int16_t find_cache_idx(const struct grid_info &info) const;
+
     /*
       request any missing 4x4 grids from a block
     */
     bool request_missing(mavlink_channel_t chan, struct grid_cache &gcache);
     bool request_missing(mavlink_channel_t chan, const struct grid_info &info);
 
+    /*
+      request missing grids from prefetched blocks, soonest first
+    */
+    bool request_prefetch(mavlink_channel_t chan);
+
     /*
       look for blocks that need to be read/written to disk
      */
@@ -332,15 +439,26 @@ private:
       disk IO functions
      */
     int16_t find_io_idx(enum GridCacheState state);
-    uint16_t get_block_crc(struct grid_block &block);
+    uint16_t get_block_crc(const struct grid_block &block) const;
     void check_disk_read(void);
     void check_disk_write(void);
     void io_timer(void);
     void open_file(void);
-    void seek_offset(void);
-    uint32_t east_blocks(struct grid_block &block) const;
+    bool open_raw_file(bool create);
+    void seek_offset(int &seek_fd, uint32_t block_size);
+    uint32_t east_blocks(int8_t lat_degrees, int16_t lon_degrees) const;
     void write_block(void);
+    bool write_raw_block(void);
     void read_block(void);
+    bool read_packed_block(void);
+    bool read_raw_block(void);
+
+    /*
+      compressed grid block functions
+     */
+    bool pack_block(const struct grid_block &block, struct grid_packed_block &packed) const;
+    bool unpack_block(const struct grid_packed_block &packed, struct grid_block &block) const;
+    uint16_t get_packed_crc(const struct grid_packed_block &packed) const;
 
     // check for missing data in squares surrounding loc:
     bool update_surrounding_tiles(const Location &loc);
@@ -350,6 +468,14 @@ private:
      */
     void update_mission_data(void);
 
+    /*
+      rank and load the blocks along the upcoming path
+     */
+    void update_prefetch(const Location &loc);
+    void prefetch_path(Location &pos, const Location &dest, const struct grid_info &origin,
+                       float speed, float &eta_s, float &remaining_m, uint8_t &samples);
+    void prefetch_add(const Location &loc, const struct grid_info &origin, float eta_s);
+
     /*
       check for missing rally data
      */
@@ -376,6 +502,44 @@ private:
     uint8_t cache_size = 0;
     struct grid_cache *cache = nullptr;
 
+#if AP_TERRAIN_MMAP_ENABLED
+    /*
+      a terrain file mapped read-only into memory. Each block is
+      checked once, then lookups read the mapped heights directly
+     */
+    struct mmap_file {
+        // mapped blocks, nullptr if mapping failed
+        const union grid_io_block *blocks;
+        uint32_t num_blocks;
+
+        // blocks per row of the file at this latitude
+        uint32_t stride;
+
+        // bitmaps of blocks that have been checked, and of checked
+        // blocks that passed, num_blocks bits each
+        uint8_t *checked;
+        uint8_t *valid;
+
+        // last use for LRU, or time of the last failed mapping
+        uint32_t last_access_ms;
+
+        uint16_t spacing;
+        int16_t lon_degrees;
+        int8_t lat_degrees;
+        bool in_use;
+    };
+    struct mmap_file mmap_files[TERRAIN_MMAP_MAX_FILES];
+
+    /*
+      memory mapped terrain file functions
+     */
+    const struct grid_block *find_mmap_block(const struct grid_info &info);
+    struct mmap_file *find_mmap_file(int8_t lat_degrees, int16_t lon_degrees);
+    void map_file(struct mmap_file &mf, int8_t lat_degrees, int16_t lon_degrees);
+    void unmap_file(struct mmap_file &mf);
+    void mmap_block_written(const struct grid_block &block);
+#endif
+
     // a grid_cache block waiting for disk IO
     enum DiskIoState {
         DiskIoIdle      = 0,
@@ -387,13 +551,18 @@ private:
     volatile enum DiskIoState disk_io_state;
     union grid_io_block disk_block;
 
+    // disk_block compressed for IO, allocated with the cache
+    union grid_packed_io_block *packed_block;
+
     // last time we asked for more grids
     uint32_t last_request_time_ms[MAVLINK_COMM_NUM_BUFFERS];
 
     static const uint64_t bitmap_mask = (((uint64_t)1U)<<(TERRAIN_GRID_BLOCK_MUL_X*TERRAIN_GRID_BLOCK_MUL_Y)) - 1;
 
-    // open file handle on degree file
+    // open file handles on the compressed and uncompressed degree
+    // files. raw_fd is -1 if there is no uncompressed file
     int fd;
+    int raw_fd;
 
     // has the timer been setup?
     bool timer_setup;
@@ -445,6 +614,18 @@ private:
     // grid spacing during mission check
     uint16_t last_mission_spacing;
 
+    /*
+      a grid block the vehicle is expected to reach, the prefetch
+      array is kept sorted by ETA
+     */
+    struct prefetch_block {
+        struct grid_info info;
+        float eta_s;
+    };
+    struct prefetch_block prefetch[TERRAIN_PREFETCH_MAX_BLOCKS];
+    uint8_t prefetch_count;
+    uint32_t last_prefetch_ms;
+
     // next rally command to check
     uint16_t next_rally_index;
 
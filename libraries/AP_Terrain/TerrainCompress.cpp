@@ -0,0 +1,332 @@
+/*
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+/*
+  compressed grid blocks for the terrain files
+
+  Heights are coded row by row from south to north, west to east. Each
+  height is predicted from its west, south and south west neighbours
+  as W + S - SW, which is exact on a constant slope, falling back to a
+  single neighbour or the previous height at the edges of the block
+  and of the grids present. The zigzag mapped difference from the
+  prediction is Rice coded, with the Rice parameter chosen per row.
+  A height that would need a long code is escaped and stored raw.
+
+  The coding is lossless. A block that doesn't fit in
+  TERRAIN_GRID_PACKED_SIZE is stored uncompressed by the IO code.
+
+  These functions run in the IO thread.
+ */
+
+#include "AP_Terrain.h"
+
+#if AP_TERRAIN_AVAILABLE
+
+#include <AP_HAL/AP_HAL.h>
+#include <AP_Common/AP_Common.h>
+#include <AP_Math/AP_Math.h>
+
+// bits used to store the Rice parameter of each row
+#define TERRAIN_RICE_K_BITS 4
+#define TERRAIN_RICE_K_MAX  ((1U<<TERRAIN_RICE_K_BITS)-1)
+
+// Rice quotient at which a height is escaped and stored as 16 raw bits
+#define TERRAIN_RICE_ESCAPE 24
+
+/*
+  MSB first bit writer into a fixed size buffer
+ */
+class TerrainBitWriter {
+public:
+    TerrainBitWriter(uint8_t *_buf, uint16_t _len) :
+        buf(_buf),
+        len_bits(uint32_t(_len)*8)
+    {
+        memset(buf, 0, _len);
+    }
+
+    void put(uint32_t value, uint8_t nbits) {
+        while (nbits > 0) {
+            nbits--;
+            put_bit((value >> nbits) & 1U);
+        }
+    }
+
+    void put_bit(bool bit) {
+        if (pos >= len_bits) {
+            overflow = true;
+            return;
+        }
+        if (bit) {
+            buf[pos/8] |= 0x80U >> (pos%8);
+        }
+        pos++;
+    }
+
+    bool overflowed(void) const { return overflow; }
+    uint16_t bytes(void) const { return (pos+7)/8; }
+
+private:
+    uint8_t *buf;
+    uint32_t len_bits;
+    uint32_t pos = 0;
+    bool overflow = false;
+};
+
+/*
+  MSB first bit reader from a fixed size buffer
+ */
+class TerrainBitReader {
+public:
+    TerrainBitReader(const uint8_t *_buf, uint16_t _len) :
+        buf(_buf),
+        len_bits(uint32_t(_len)*8)
+    {}
+
+    uint32_t get(uint8_t nbits) {
+        uint32_t value = 0;
+        while (nbits > 0) {
+            nbits--;
+            value = (value << 1) | uint32_t(get_bit());
+        }
+        return value;
+    }
+
+    bool get_bit(void) {
+        if (pos >= len_bits) {
+            underflow = true;
+            return false;
+        }
+        const bool bit = (buf[pos/8] & (0x80U >> (pos%8))) != 0;
+        pos++;
+        return bit;
+    }
+
+    bool underflowed(void) const { return underflow; }
+
+private:
+    const uint8_t *buf;
+    uint32_t len_bits;
+    uint32_t pos = 0;
+    bool underflow = false;
+};
+
+/*
+  return true if the height at idx_x/idx_y is in a grid set in the bitmap
+ */
+static bool height_present(uint64_t bitmap, uint8_t idx_x, uint8_t idx_y)
+{
+    const uint8_t bitnum = (idx_x / TERRAIN_GRID_MAVLINK_SIZE) * TERRAIN_GRID_BLOCK_MUL_Y + idx_y / TERRAIN_GRID_MAVLINK_SIZE;
+    return (bitmap & (((uint64_t)1U)<<bitnum)) != 0;
+}
+
+/*
+  return true if any height in row idx_x is present
+ */
+static bool row_present(uint64_t bitmap, uint8_t idx_x)
+{
+    const uint8_t shift = (idx_x / TERRAIN_GRID_MAVLINK_SIZE) * TERRAIN_GRID_BLOCK_MUL_Y;
+    return ((bitmap >> shift) & ((1U<<TERRAIN_GRID_BLOCK_MUL_Y)-1)) != 0;
+}
+
+/*
+  predict the height at idx_x/idx_y of a grid_block from the present
+  neighbours already coded. prev is the last height coded
+ */
+template <typename T>
+static int32_t predict_height(const T &block, uint8_t idx_x, uint8_t idx_y, int32_t prev)
+{
+    const uint64_t bitmap = block.bitmap;
+    const bool have_w = idx_y > 0 && height_present(bitmap, idx_x, idx_y-1);
+    const bool have_s = idx_x > 0 && height_present(bitmap, idx_x-1, idx_y);
+    if (have_w && have_s && height_present(bitmap, idx_x-1, idx_y-1)) {
+        return int32_t(block.height[idx_x][idx_y-1]) + block.height[idx_x-1][idx_y] - block.height[idx_x-1][idx_y-1];
+    }
+    if (have_w) {
+        return block.height[idx_x][idx_y-1];
+    }
+    if (have_s) {
+        return block.height[idx_x-1][idx_y];
+    }
+    return prev;
+}
+
+// map a signed difference to an unsigned Rice code value
+static uint32_t zigzag_encode(int32_t v)
+{
+    return (uint32_t(v) << 1) ^ uint32_t(v >> 31);
+}
+
+static int32_t zigzag_decode(uint32_t u)
+{
+    return int32_t(u >> 1) ^ -int32_t(u & 1U);
+}
+
+// bits needed to code u with Rice parameter k
+static uint32_t rice_bits(uint32_t u, uint8_t k)
+{
+    const uint32_t q = u >> k;
+    if (q >= TERRAIN_RICE_ESCAPE) {
+        return TERRAIN_RICE_ESCAPE + 16;
+    }
+    return q + 1 + k;
+}
+
+/*
+  compress a grid_block. Returns false if it doesn't fit in a
+  grid_packed_block
+ */
+bool AP_Terrain::pack_block(const struct grid_block &block, struct grid_packed_block &packed) const
+{
+    static_assert(sizeof(struct grid_packed_block) == TERRAIN_GRID_PACKED_SIZE, "grid_packed_block must be TERRAIN_GRID_PACKED_SIZE");
+
+    packed.bitmap = block.bitmap;
+    packed.lat = block.lat;
+    packed.lon = block.lon;
+    packed.version = TERRAIN_GRID_FORMAT_VERSION;
+    packed.spacing = block.spacing;
+    packed.grid_idx_x = block.grid_idx_x;
+    packed.grid_idx_y = block.grid_idx_y;
+    packed.lon_degrees = block.lon_degrees;
+    packed.lat_degrees = block.lat_degrees;
+
+    TerrainBitWriter writer(packed.data, sizeof(packed.data));
+    int32_t prev = 0;
+
+    for (uint8_t x=0; x<TERRAIN_GRID_BLOCK_SIZE_X; x++) {
+        if (!row_present(block.bitmap, x)) {
+            continue;
+        }
+
+        // code values for the row, then the Rice parameter giving the
+        // shortest row
+        uint32_t code[TERRAIN_GRID_BLOCK_SIZE_Y] {};
+        for (uint8_t y=0; y<TERRAIN_GRID_BLOCK_SIZE_Y; y++) {
+            if (!height_present(block.bitmap, x, y)) {
+                continue;
+            }
+            code[y] = zigzag_encode(block.height[x][y] - predict_height(block, x, y, prev));
+            prev = block.height[x][y];
+        }
+        uint8_t best_k = 0;
+        uint32_t best_bits = UINT32_MAX;
+        for (uint8_t k=0; k<=TERRAIN_RICE_K_MAX; k++) {
+            uint32_t bits = 0;
+            for (uint8_t y=0; y<TERRAIN_GRID_BLOCK_SIZE_Y; y++) {
+                if (height_present(block.bitmap, x, y)) {
+                    bits += rice_bits(code[y], k);
+                }
+            }
+            if (bits < best_bits) {
+                best_bits = bits;
+                best_k = k;
+            }
+        }
+
+        writer.put(best_k, TERRAIN_RICE_K_BITS);
+        for (uint8_t y=0; y<TERRAIN_GRID_BLOCK_SIZE_Y; y++) {
+            if (!height_present(block.bitmap, x, y)) {
+                continue;
+            }
+            const uint32_t q = code[y] >> best_k;
+            if (q >= TERRAIN_RICE_ESCAPE) {
+                writer.put((1U<<TERRAIN_RICE_ESCAPE)-1, TERRAIN_RICE_ESCAPE);
+                writer.put(uint16_t(block.height[x][y]), 16);
+            } else {
+                writer.put((1U<<q)-1, q);
+                writer.put_bit(false);
+                writer.put(code[y], best_k);
+            }
+        }
+        if (writer.overflowed()) {
+            return false;
+        }
+    }
+
+    packed.length = writer.bytes();
+    packed.crc = get_packed_crc(packed);
+    return true;
+}
+
+/*
+  decompress a grid_packed_block. The length and crc must already have
+  been checked. Returns false if the coded heights are invalid
+ */
+bool AP_Terrain::unpack_block(const struct grid_packed_block &packed, struct grid_block &block) const
+{
+    memset(&block, 0, sizeof(block));
+    block.bitmap = packed.bitmap;
+    block.lat = packed.lat;
+    block.lon = packed.lon;
+    block.version = TERRAIN_GRID_FORMAT_VERSION_RAW;
+    block.spacing = packed.spacing;
+    block.grid_idx_x = packed.grid_idx_x;
+    block.grid_idx_y = packed.grid_idx_y;
+    block.lon_degrees = packed.lon_degrees;
+    block.lat_degrees = packed.lat_degrees;
+
+    TerrainBitReader reader(packed.data, packed.length);
+    int32_t prev = 0;
+
+    for (uint8_t x=0; x<TERRAIN_GRID_BLOCK_SIZE_X; x++) {
+        if (!row_present(block.bitmap, x)) {
+            continue;
+        }
+        const uint8_t k = reader.get(TERRAIN_RICE_K_BITS);
+        for (uint8_t y=0; y<TERRAIN_GRID_BLOCK_SIZE_Y; y++) {
+            if (!height_present(block.bitmap, x, y)) {
+                continue;
+            }
+            uint32_t q = 0;
+            while (q < TERRAIN_RICE_ESCAPE && reader.get_bit()) {
+                q++;
+            }
+            int32_t height;
+            if (q == TERRAIN_RICE_ESCAPE) {
+                height = int16_t(reader.get(16));
+            } else {
+                const uint32_t code = (q << k) | reader.get(k);
+                height = predict_height(block, x, y, prev) + zigzag_decode(code);
+                if (height < INT16_MIN || height > INT16_MAX) {
+                    return false;
+                }
+            }
+            if (reader.underflowed()) {
+                return false;
+            }
+            block.height[x][y] = height;
+            prev = height;
+        }
+    }
+
+    block.crc = get_block_crc(block);
+    return true;
+}
+
+/*
+  get CRC for a packed block, taken with crc=0 over the header and the
+  used data
+ */
+uint16_t AP_Terrain::get_packed_crc(const struct grid_packed_block &packed) const
+{
+    const uint8_t *buf = (const uint8_t *)&packed;
+    const uint32_t crc_ofs = offsetof(struct grid_packed_block, crc);
+    const uint32_t end_ofs = offsetof(struct grid_packed_block, data) + MIN(packed.length, sizeof(packed.data));
+    const uint16_t zero = 0;
+    uint16_t ret = crc16_ccitt(buf, crc_ofs, 0);
+    ret = crc16_ccitt((const uint8_t *)&zero, sizeof(zero), ret);
+    return crc16_ccitt(buf + crc_ofs + sizeof(zero), end_ofs - (crc_ofs + sizeof(zero)), ret);
+}
+
+#endif // AP_TERRAIN_AVAILABLE
@@ -84,6 +84,20 @@ bool AP_Terrain::request_missing(mavlink_channel_t chan, const struct grid_info
     return request_missing(chan, gcache);
 }
 
+/*
+  request missing grids from the prefetched blocks, soonest first
+ */
+bool AP_Terrain::request_prefetch(mavlink_channel_t chan)
+{
+    for (uint8_t i=0; i<prefetch_count; i++) {
+        const int16_t cache_idx = find_cache_idx(prefetch[i].info);
+        if (cache_idx != -1 && request_missing(chan, cache[cache_idx])) {
+            return true;
+        }
+    }
+    return false;
+}
+
 /*
   send any pending cache requests
  */
@@ -139,6 +153,11 @@ void AP_Terrain::send_request(mavlink_channel_t chan)
         return;
     }
 
+    // then the blocks we expect to reach next, in order of arrival
+    if (request_prefetch(chan)) {
+        return;
+    }
+
     // check cache blocks that may have been setup by a TERRAIN_CHECK,
     // mission items, rally items, squares surrounding our current
     // location, favourite holiday destination, scripting, height
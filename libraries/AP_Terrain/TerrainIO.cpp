@@ -104,6 +104,10 @@ void AP_Terrain::schedule_disk_io(void)
                 cache[cache_idx].state = GRID_CACHE_VALID;
             }
         }
+#if AP_TERRAIN_MMAP_ENABLED
+        // the mapped copy of this block needs checking again
+        mmap_block_written(disk_block.block);
+#endif
         disk_io_state = DiskIoIdle;
         break;
     }
@@ -131,7 +135,8 @@ All file operations are done by the IO thread.
 
 
 /*
-  open the current degree file
+  open the current degree files. The compressed file is created if
+  needed, the uncompressed file is only opened if it exists
  */
 void AP_Terrain::open_file(void)
 {
@@ -147,7 +152,7 @@ void AP_Terrain::open_file(void)
         if (terrain_dir == nullptr) {
             terrain_dir = HAL_BOARD_TERRAIN_DIRECTORY;
         }
-        if (asprintf(&file_path, "%s/NxxExxx.DAT", terrain_dir) <= 0) {
+        if (asprintf(&file_path, "%s/NxxExxx.DTZ", terrain_dir) <= 0) {
             io_failure = true;
             file_path = nullptr;
             return;
@@ -173,7 +178,7 @@ void AP_Terrain::open_file(void)
     if (lon_tmp > 999U) {
         lon_tmp = 999;
     }
-    hal.util->snprintf(p, 13, "/%c%02u%c%03u.DAT",
+    hal.util->snprintf(p, 13, "/%c%02u%c%03u.DTZ",
              block.lat_degrees<0?'S':'N',
              (unsigned)lat_tmp,
              block.lon_degrees<0?'W':'E',
@@ -212,18 +217,36 @@ void AP_Terrain::open_file(void)
 
     file_lat_degrees = block.lat_degrees;
     file_lon_degrees = block.lon_degrees;
+
+    open_raw_file(false);
+}
+
+/*
+  open the uncompressed degree file for the current degree file,
+  optionally creating it
+ */
+bool AP_Terrain::open_raw_file(bool create)
+{
+    if (raw_fd != -1) {
+        AP::FS().close(raw_fd);
+    }
+    char *ext = &file_path[strlen(file_path)-3];
+    memcpy(ext, "DAT", 3);
+    raw_fd = AP::FS().open(file_path, create ? O_RDWR|O_CREAT : O_RDWR);
+    memcpy(ext, "DTZ", 3);
+    return raw_fd != -1;
 }
 
 /*
   work out how many blocks needed in a stride for a given location
  */
-uint32_t AP_Terrain::east_blocks(struct grid_block &block) const
+uint32_t AP_Terrain::east_blocks(int8_t lat_degrees, int16_t lon_degrees) const
 {
     Location loc1, loc2;
-    loc1.lat = block.lat_degrees*10*1000*1000L;
-    loc1.lng = block.lon_degrees*10*1000*1000L;
-    loc2.lat = block.lat_degrees*10*1000*1000L;
-    loc2.lng = (block.lon_degrees+1)*10*1000*1000L;
+    loc1.lat = lat_degrees*10*1000*1000L;
+    loc1.lng = lon_degrees*10*1000*1000L;
+    loc2.lat = lat_degrees*10*1000*1000L;
+    loc2.lng = (lon_degrees+1)*10*1000*1000L;
 
     // shift another two blocks east to ensure room is available
     loc2.offset(0, 2*grid_spacing*TERRAIN_GRID_BLOCK_SIZE_Y);
@@ -232,39 +255,48 @@ uint32_t AP_Terrain::east_blocks(struct grid_block &block) const
 }
 
 /*
-  seek to the right offset for disk_block
+  seek to the right offset for disk_block in a file of block_size blocks
  */
-void AP_Terrain::seek_offset(void)
+void AP_Terrain::seek_offset(int &seek_fd, uint32_t block_size)
 {
     struct grid_block &block = disk_block.block;
     // work out how many longitude blocks there are at this latitude
-    uint32_t blocknum = east_blocks(block) * block.grid_idx_x + block.grid_idx_y;
-    uint32_t file_offset = blocknum * sizeof(union grid_io_block);
-    if (AP::FS().lseek(fd, file_offset, SEEK_SET) != (off_t)file_offset) {
+    uint32_t blocknum = east_blocks(block.lat_degrees, block.lon_degrees) * block.grid_idx_x + block.grid_idx_y;
+    uint32_t file_offset = blocknum * block_size;
+    if (AP::FS().lseek(seek_fd, file_offset, SEEK_SET) != (off_t)file_offset) {
 #if TERRAIN_DEBUG
         hal.console->printf("Seek %lu failed - %s\n",
                             (unsigned long)file_offset, strerror(errno));
 #endif
-        AP::FS().close(fd);
-        fd = -1;
+        AP::FS().close(seek_fd);
+        seek_fd = -1;
         io_failure = true;
     }
 }
 
 /*
-  write out disk_block
+  write out disk_block. Blocks that don't compress are written to the
+  uncompressed file, with an empty compressed block so the old
+  compressed copy isn't read back in its place
  */
 void AP_Terrain::write_block(void)
 {
-    seek_offset();
+    disk_block.block.crc = get_block_crc(disk_block.block);
+
+    if (!pack_block(disk_block.block, packed_block->block)) {
+        if (!write_raw_block()) {
+            return;
+        }
+        memset(packed_block, 0, sizeof(*packed_block));
+    }
+
+    seek_offset(fd, sizeof(*packed_block));
     if (io_failure) {
         return;
     }
 
-    disk_block.block.crc = get_block_crc(disk_block.block);
-
-    ssize_t ret = AP::FS().write(fd, &disk_block, sizeof(disk_block));
-    if (ret  != sizeof(disk_block)) {
+    ssize_t ret = AP::FS().write(fd, packed_block, sizeof(*packed_block));
+    if (ret  != sizeof(*packed_block)) {
 #if TERRAIN_DEBUG
         hal.console->printf("write failed - %s\n", strerror(errno));
 #endif
@@ -274,10 +306,11 @@ void AP_Terrain::write_block(void)
     } else {
         AP::FS().fsync(fd);
 #if TERRAIN_DEBUG
-        printf("wrote block at %ld %ld ret=%d mask=%07llx\n",
+        printf("wrote block at %ld %ld ret=%d len=%u mask=%07llx\n",
                (long)disk_block.block.lat,
                (long)disk_block.block.lon,
                (int)ret,
+               (unsigned)packed_block->block.length,
                (unsigned long long)disk_block.block.bitmap);
 #endif
     }
@@ -285,36 +318,48 @@ void AP_Terrain::write_block(void)
 }
 
 /*
-  read in disk_block
+  write out disk_block uncompressed
  */
-void AP_Terrain::read_block(void)
+bool AP_Terrain::write_raw_block(void)
 {
-    seek_offset();
+    if (raw_fd == -1 && !open_raw_file(true)) {
+        io_failure = true;
+        return false;
+    }
+    seek_offset(raw_fd, sizeof(disk_block));
     if (io_failure) {
-        return;
+        return false;
     }
+
+    ssize_t ret = AP::FS().write(raw_fd, &disk_block, sizeof(disk_block));
+    if (ret != sizeof(disk_block)) {
+#if TERRAIN_DEBUG
+        hal.console->printf("write failed - %s\n", strerror(errno));
+#endif
+        AP::FS().close(raw_fd);
+        raw_fd = -1;
+        io_failure = true;
+        return false;
+    }
+    AP::FS().fsync(raw_fd);
+    return true;
+}
+
+/*
+  read in disk_block, from the compressed file or else the
+  uncompressed file
+ */
+void AP_Terrain::read_block(void)
+{
     int32_t lat = disk_block.block.lat;
     int32_t lon = disk_block.block.lon;
 
-    ssize_t ret = AP::FS().read(fd, &disk_block, sizeof(disk_block));
-    if (ret != sizeof(disk_block) || 
-        !TERRAIN_LATLON_EQUAL(disk_block.block.lat,lat) ||
-        !TERRAIN_LATLON_EQUAL(disk_block.block.lon,lon) ||
-        disk_block.block.bitmap == 0 ||
-        disk_block.block.spacing != grid_spacing ||
-        disk_block.block.version != TERRAIN_GRID_FORMAT_VERSION ||
-        disk_block.block.crc != get_block_crc(disk_block.block)) {
+    if (!read_packed_block() && !read_raw_block()) {
+        if (io_failure) {
+            return;
+        }
 #if TERRAIN_DEBUG
-        printf("read empty block at %ld %ld ret=%d (%ld %ld %u 0x%08lx) 0x%04x:0x%04x\n",
-               (long)lat,
-               (long)lon,
-               (int)ret,
-               (long)disk_block.block.lat,
-               (long)disk_block.block.lon,
-               (unsigned)disk_block.block.spacing,
-               (unsigned long)disk_block.block.bitmap,
-               (unsigned)disk_block.block.crc,
-               (unsigned)get_block_crc(disk_block.block));
+        printf("read empty block at %ld %ld\n", (long)lat, (long)lon);
 #endif
         // a short read or bad data is not an IO failure, just a
         // missing block on disk
@@ -324,16 +369,72 @@ void AP_Terrain::read_block(void)
         disk_block.block.bitmap = 0;
     } else {
 #if TERRAIN_DEBUG
-        printf("read block at %ld %ld ret=%d mask=%07llx\n",
+        printf("read block at %ld %ld mask=%07llx\n",
                (long)lat,
                (long)lon,
-               (int)ret,
                (unsigned long long)disk_block.block.bitmap);
 #endif
     }
     disk_io_state = DiskIoDoneRead;
 }
 
+/*
+  read disk_block from the compressed file. Returns false if the block
+  is missing or invalid, leaving disk_block unchanged
+ */
+bool AP_Terrain::read_packed_block(void)
+{
+    seek_offset(fd, sizeof(*packed_block));
+    if (io_failure) {
+        return false;
+    }
+
+    const struct grid_block &block = disk_block.block;
+    const struct grid_packed_block &packed = packed_block->block;
+    ssize_t ret = AP::FS().read(fd, packed_block, sizeof(*packed_block));
+    if (ret != sizeof(*packed_block) ||
+        !TERRAIN_LATLON_EQUAL(packed.lat, block.lat) ||
+        !TERRAIN_LATLON_EQUAL(packed.lon, block.lon) ||
+        packed.grid_idx_x != block.grid_idx_x ||
+        packed.grid_idx_y != block.grid_idx_y ||
+        packed.lat_degrees != block.lat_degrees ||
+        packed.lon_degrees != block.lon_degrees ||
+        packed.bitmap == 0 ||
+        packed.spacing != grid_spacing ||
+        packed.version != TERRAIN_GRID_FORMAT_VERSION ||
+        packed.length > sizeof(packed.data) ||
+        packed.crc != get_packed_crc(packed)) {
+        return false;
+    }
+    return unpack_block(packed, disk_block.block);
+}
+
+/*
+  read disk_block from the uncompressed file. Returns false if there
+  is no such file or the block is missing or invalid
+ */
+bool AP_Terrain::read_raw_block(void)
+{
+    if (raw_fd == -1) {
+        return false;
+    }
+    seek_offset(raw_fd, sizeof(disk_block));
+    if (io_failure) {
+        return false;
+    }
+    int32_t lat = disk_block.block.lat;
+    int32_t lon = disk_block.block.lon;
+
+    ssize_t ret = AP::FS().read(raw_fd, &disk_block, sizeof(disk_block));
+    return ret == sizeof(disk_block) &&
+        TERRAIN_LATLON_EQUAL(disk_block.block.lat,lat) &&
+        TERRAIN_LATLON_EQUAL(disk_block.block.lon,lon) &&
+        disk_block.block.bitmap != 0 &&
+        disk_block.block.spacing == grid_spacing &&
+        disk_block.block.version == TERRAIN_GRID_FORMAT_VERSION_RAW &&
+        disk_block.block.crc == get_block_crc(disk_block.block);
+}
+
 /*
   timer called to do disk IO
  */
@@ -61,54 +61,82 @@ void AP_Terrain::update_mission_data(void)
     }
 
     // don't do more than 20 waypoints at a time, to prevent too much
-    // CPU usage
-    for (uint8_t i=0; i<20; i++) {
-        // get next mission command
-        AP_Mission::Mission_Command cmd;
-        if (!mission->read_cmd_from_storage(next_mission_index, cmd)) {
-            // nothing more to do
-            next_mission_index = 0;
-            return;
-        }
+    // CPU usage. The points are looked up a batch at a time, so all of
+    // the missing grid blocks of a batch are requested together
+    uint8_t checked = 0;
+    while (checked < 20) {
+        Location locs[TERRAIN_HEIGHT_BATCH_MAX];
+        uint16_t locs_index[TERRAIN_HEIGHT_BATCH_MAX];
+        uint8_t locs_pos[TERRAIN_HEIGHT_BATCH_MAX];
+        uint8_t n = 0;
+        uint16_t index = next_mission_index;
+        uint8_t pos = next_mission_pos;
+        bool at_end = false;
+
+        while (n < TERRAIN_HEIGHT_BATCH_MAX) {
+            // get next mission command
+            AP_Mission::Mission_Command cmd;
+            if (!mission->read_cmd_from_storage(index, cmd)) {
+                at_end = true;
+                break;
+            }
 
-        // we only want nav waypoint commands. That should be enough to
-        // prefill the terrain data and makes many things much simpler
-        while ((cmd.id != MAV_CMD_NAV_WAYPOINT &&
-                cmd.id != MAV_CMD_NAV_SPLINE_WAYPOINT) ||
-               (cmd.content.location.lat == 0 && cmd.content.location.lng == 0)) {
-            next_mission_index++;
-            if (!mission->read_cmd_from_storage(next_mission_index, cmd)) {
-                // nothing more to do
-                next_mission_index = 0;
-                next_mission_pos = 0;
-                return;
+            // we only want nav waypoint commands. That should be enough to
+            // prefill the terrain data and makes many things much simpler
+            if ((cmd.id != MAV_CMD_NAV_WAYPOINT &&
+                 cmd.id != MAV_CMD_NAV_SPLINE_WAYPOINT) ||
+                (cmd.content.location.lat == 0 && cmd.content.location.lng == 0)) {
+                index++;
+                pos = 0;
+                continue;
             }
-        }
 
-        // we will fetch 5 points around the waypoint. Four at 10 grid
-        // spacings away at 45, 135, 225 and 315 degrees, and the
-        // point itself
-        if (next_mission_pos != 4) {
-            cmd.content.location.offset_bearing(45+90*next_mission_pos, grid_spacing.get() * 10);
+            // we will fetch 5 points around the waypoint. Four at 10 grid
+            // spacings away at 45, 135, 225 and 315 degrees, and the
+            // point itself
+            for (; pos < 5 && n < TERRAIN_HEIGHT_BATCH_MAX; pos++, n++) {
+                locs[n] = cmd.content.location;
+                if (pos != 4) {
+                    locs[n].offset_bearing(45+90*pos, grid_spacing.get() * 10);
+                }
+                locs_index[n] = index;
+                locs_pos[n] = pos;
+            }
+            if (pos == 5) {
+                index++;
+                pos = 0;
+            }
         }
 
-        // we have a mission command to check
-        float height;
-        if (!height_amsl(cmd.content.location, height)) {
-            // if we can't get data for a mission item then return and
-            // check again next time
-            return;
-        }
+        float heights[TERRAIN_HEIGHT_BATCH_MAX];
+        bool valid[TERRAIN_HEIGHT_BATCH_MAX];
+        heights_amsl(locs, n, heights, valid);
 
-        next_mission_pos++;
-        if (next_mission_pos == 5) {
+        for (uint8_t i=0; i<n; i++) {
+            if (!valid[i]) {
+                // if we can't get data for a mission item then return and
+                // check again next time
+                return;
+            }
+            next_mission_index = locs_index[i];
+            next_mission_pos = locs_pos[i] + 1;
+            if (next_mission_pos == 5) {
 #if TERRAIN_DEBUG
-            hal.console->printf("checked waypoint %u\n", (unsigned)next_mission_index);
+                hal.console->printf("checked waypoint %u\n", (unsigned)next_mission_index);
 #endif
 
-            // move to next waypoint
-            next_mission_index++;
+                // move to next waypoint
+                next_mission_index++;
+                next_mission_pos = 0;
+                checked++;
+            }
+        }
+
+        if (at_end) {
+            // nothing more to do
+            next_mission_index = 0;
             next_mission_pos = 0;
+            return;
         }
     }
 #endif  // AP_MISSION_ENABLED
@@ -145,30 +173,45 @@ void AP_Terrain::update_rally_data(void)
     }
 
     while (true) {
-        // get next rally point
-        struct RallyLocation rp;
-        if (!rally->get_rally_point_with_index(next_rally_index, rp)) {
-            // nothing more to do
-            next_rally_index = 0;
-            return;
+        // get the next batch of rally points
+        Location locs[TERRAIN_HEIGHT_BATCH_MAX];
+        uint8_t n = 0;
+        bool at_end = false;
+        while (n < TERRAIN_HEIGHT_BATCH_MAX) {
+            struct RallyLocation rp;
+            if (!rally->get_rally_point_with_index(next_rally_index + n, rp)) {
+                at_end = true;
+                break;
+            }
+            locs[n].lat = rp.lat;
+            locs[n].lng = rp.lng;
+            n++;
         }
 
-        Location loc;
-        loc.lat = rp.lat;
-        loc.lng = rp.lng;
-        float height;
-        if (!height_amsl(loc, height)) {
-            // if we can't get data for a rally item then return and
-            // check again next time
-            return;
-        }
+        float heights[TERRAIN_HEIGHT_BATCH_MAX];
+        bool valid[TERRAIN_HEIGHT_BATCH_MAX];
+        heights_amsl(locs, n, heights, valid);
+
+        for (uint8_t i=0; i<n; i++) {
+            if (!valid[i]) {
+                // if we can't get data for a rally item then return and
+                // check again next time
+                return;
+            }
 
 #if TERRAIN_DEBUG
-        hal.console->printf("checked rally point %u\n", (unsigned)next_rally_index);
+            hal.console->printf("checked rally point %u\n", (unsigned)next_rally_index);
 #endif
 
-        // move to next rally point
-        next_rally_index++;
+            // move to next rally point
+            next_rally_index++;
+        }
+
+        if (at_end) {
+            // nothing more to do
+            next_rally_index = 0;
+            return;
+        }
     }
 }
 #endif
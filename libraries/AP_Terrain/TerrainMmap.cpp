@@ -0,0 +1,243 @@
+/*
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+/*
+  serve terrain lookups from memory mapped terrain files
+
+  On Linux and SITL the one degree terrain files are mapped read-only,
+  so a lookup anywhere in a mapped file is a direct read of the
+  mapped heights. Each block has its header and CRC checked the first
+  time it is used, and again after the IO thread writes it. Blocks
+  that are missing or incomplete on disk fall back to the LRU cache,
+  which still drives disk writes and GCS requests.
+
+  All functions in this file run in the main thread.
+ */
+
+#include "AP_Terrain.h"
+
+#if AP_TERRAIN_AVAILABLE && AP_TERRAIN_MMAP_ENABLED
+
+#include <AP_Filesystem/AP_Filesystem.h>
+#include <AP_HAL/AP_HAL.h>
+#include <AP_Common/AP_Common.h>
+#include <AP_Math/AP_Math.h>
+#include <stdio.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+extern const AP_HAL::HAL& hal;
+
+/*
+  find the mapped block for a grid_info. Returns nullptr if the block
+  is not in a mapped file or is not a valid block for this location
+ */
+const AP_Terrain::grid_block *AP_Terrain::find_mmap_block(const struct grid_info &info)
+{
+    struct mmap_file *mf = find_mmap_file(info.lat_degrees, info.lon_degrees);
+    if (mf == nullptr) {
+        return nullptr;
+    }
+
+    const uint32_t blocknum = mf->stride * info.grid_idx_x + info.grid_idx_y;
+    if (blocknum >= mf->num_blocks) {
+        return nullptr;
+    }
+
+    // the IO thread may be rewriting this block
+    if (disk_io_state == DiskIoWaitWrite &&
+        TERRAIN_LATLON_EQUAL(disk_block.block.lat, info.grid_lat) &&
+        TERRAIN_LATLON_EQUAL(disk_block.block.lon, info.grid_lon)) {
+        return nullptr;
+    }
+
+    const struct grid_block &block = mf->blocks[blocknum].block;
+    const uint8_t mask = 1U << (blocknum % 8);
+    const uint32_t ofs = blocknum / 8;
+    if ((mf->checked[ofs] & mask) == 0) {
+        // same checks as read_block()
+        mf->checked[ofs] |= mask;
+        if (TERRAIN_LATLON_EQUAL(block.lat, info.grid_lat) &&
+            TERRAIN_LATLON_EQUAL(block.lon, info.grid_lon) &&
+            block.bitmap != 0 &&
+            block.spacing == grid_spacing &&
+            block.version == TERRAIN_GRID_FORMAT_VERSION_RAW &&
+            block.crc == get_block_crc(block)) {
+            mf->valid[ofs] |= mask;
+        } else {
+            mf->valid[ofs] &= ~mask;
+        }
+    }
+    if ((mf->valid[ofs] & mask) == 0) {
+        return nullptr;
+    }
+    return &block;
+}
+
+/*
+  find the mapped file for a degree square, mapping it if needed.
+  Returns nullptr if the file can't be mapped
+ */
+struct AP_Terrain::mmap_file *AP_Terrain::find_mmap_file(int8_t lat_degrees, int16_t lon_degrees)
+{
+    const uint32_t now_ms = AP_HAL::millis();
+    struct mmap_file *oldest = &mmap_files[0];
+
+    for (uint8_t i=0; i<TERRAIN_MMAP_MAX_FILES; i++) {
+        struct mmap_file &mf = mmap_files[i];
+        if (!mf.in_use) {
+            if (oldest->in_use) {
+                oldest = &mf;
+            }
+            continue;
+        }
+        if (mf.lat_degrees != lat_degrees || mf.lon_degrees != lon_degrees) {
+            if (oldest->in_use && mf.last_access_ms < oldest->last_access_ms) {
+                oldest = &mf;
+            }
+            continue;
+        }
+        if (mf.blocks == nullptr) {
+            // mapping failed, retry occasionally as the file may
+            // have been created since
+            if (now_ms - mf.last_access_ms < TERRAIN_MMAP_RETRY_MS) {
+                return nullptr;
+            }
+            map_file(mf, lat_degrees, lon_degrees);
+        } else if (mf.spacing != grid_spacing) {
+            // a new grid spacing changes the file layout
+            map_file(mf, lat_degrees, lon_degrees);
+        }
+        if (mf.blocks == nullptr) {
+            return nullptr;
+        }
+        mf.last_access_ms = now_ms;
+        return &mf;
+    }
+
+    // not mapped yet, replace the least recently used file
+    map_file(*oldest, lat_degrees, lon_degrees);
+    if (oldest->blocks == nullptr) {
+        return nullptr;
+    }
+    return oldest;
+}
+
+/*
+  map the file for a degree square. On failure the entry is kept with
+  no blocks so the mapping is not retried on every lookup
+ */
+void AP_Terrain::map_file(struct mmap_file &mf, int8_t lat_degrees, int16_t lon_degrees)
+{
+    unmap_file(mf);
+    mf.in_use = true;
+    mf.lat_degrees = lat_degrees;
+    mf.lon_degrees = lon_degrees;
+    mf.spacing = grid_spacing;
+    mf.last_access_ms = AP_HAL::millis();
+
+    if (grid_spacing <= 0) {
+        return;
+    }
+
+    const char* terrain_dir = hal.util->get_custom_terrain_directory();
+    if (terrain_dir == nullptr) {
+        terrain_dir = HAL_BOARD_TERRAIN_DIRECTORY;
+    }
+    uint32_t lat_tmp = abs((int32_t)lat_degrees);
+    if (lat_tmp > 99U) {
+        lat_tmp = 99U;
+    }
+    uint32_t lon_tmp = abs((int32_t)lon_degrees);
+    if (lon_tmp > 999U) {
+        lon_tmp = 999;
+    }
+    char *path = nullptr;
+    if (asprintf(&path, "%s/%c%02u%c%03u.DAT",
+                 terrain_dir,
+                 lat_degrees<0?'S':'N',
+                 (unsigned)lat_tmp,
+                 lon_degrees<0?'W':'E',
+                 (unsigned)lon_tmp) <= 0) {
+        return;
+    }
+
+    struct stat st;
+    const bool have_stat = (AP::FS().stat(path, &st) == 0);
+    const int fd = have_stat ? AP::FS().open(path, O_RDONLY) : -1;
+    free(path);
+    if (fd == -1) {
+        return;
+    }
+
+    const uint32_t num_blocks = st.st_size / sizeof(union grid_io_block);
+    void *blocks = MAP_FAILED;
+    if (num_blocks > 0) {
+        blocks = mmap(nullptr, num_blocks * sizeof(union grid_io_block), PROT_READ, MAP_SHARED, fd, 0);
+    }
+    // the mapping stays valid after the file is closed
+    AP::FS().close(fd);
+    if (blocks == MAP_FAILED) {
+        return;
+    }
+
+    // one allocation for both the checked and valid bitmaps
+    const uint32_t bitmap_len = (num_blocks + 7) / 8;
+    mf.checked = (uint8_t *)calloc(2, bitmap_len);
+    if (mf.checked == nullptr) {
+        munmap(blocks, num_blocks * sizeof(union grid_io_block));
+        return;
+    }
+    mf.valid = mf.checked + bitmap_len;
+    mf.blocks = (const union grid_io_block *)blocks;
+    mf.num_blocks = num_blocks;
+    mf.stride = east_blocks(lat_degrees, lon_degrees);
+}
+
+/*
+  unmap a file and free its entry
+ */
+void AP_Terrain::unmap_file(struct mmap_file &mf)
+{
+    if (mf.blocks != nullptr) {
+        munmap((void *)mf.blocks, mf.num_blocks * sizeof(union grid_io_block));
+    }
+    free(mf.checked);
+    memset(&mf, 0, sizeof(mf));
+}
+
+/*
+  called when the IO thread has written a block to disk. The mapped
+  copy is checked again on next use, and a file that has grown past
+  its mapping or did not exist is mapped again
+ */
+void AP_Terrain::mmap_block_written(const struct grid_block &block)
+{
+    for (uint8_t i=0; i<TERRAIN_MMAP_MAX_FILES; i++) {
+        struct mmap_file &mf = mmap_files[i];
+        if (!mf.in_use ||
+            mf.lat_degrees != block.lat_degrees ||
+            mf.lon_degrees != block.lon_degrees) {
+            continue;
+        }
+        const uint32_t blocknum = mf.stride * block.grid_idx_x + block.grid_idx_y;
+        if (mf.blocks == nullptr || blocknum >= mf.num_blocks) {
+            unmap_file(mf);
+            continue;
+        }
+        mf.checked[blocknum / 8] &= ~(1U << (blocknum % 8));
+    }
+}
+
+#endif // AP_TERRAIN_AVAILABLE && AP_TERRAIN_MMAP_ENABLED
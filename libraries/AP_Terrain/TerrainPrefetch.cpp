@@ -0,0 +1,202 @@
+/*
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+/*
+  prefetch terrain along the path the vehicle is expected to fly
+
+  The path is the projected velocity vector plus, when a mission is
+  running, the upcoming mission legs. The blocks it crosses within
+  TERRAIN_PREFETCH_TIME_S are ranked by ETA and loaded into the cache
+  ahead of time, so disk reads and GCS requests happen before the
+  vehicle gets there.
+ */
+
+#include "AP_Terrain.h"
+
+#if AP_TERRAIN_AVAILABLE
+
+#include <AP_HAL/AP_HAL.h>
+#include <AP_Common/AP_Common.h>
+#include <AP_Math/AP_Math.h>
+#include <AP_AHRS/AP_AHRS.h>
+#include <AP_Mission/AP_Mission.h>
+
+extern const AP_HAL::HAL& hal;
+
+// below this groundspeed in m/s the velocity vector is not projected
+// and ETAs are calculated at this speed
+#define TERRAIN_PREFETCH_MIN_SPEED 1.0f
+
+/*
+  rank the blocks along the upcoming path by ETA and start loading
+  the soonest ones
+ */
+void AP_Terrain::update_prefetch(const Location &loc)
+{
+    const uint32_t now_ms = AP_HAL::millis();
+    if (now_ms - last_prefetch_ms < TERRAIN_PREFETCH_INTERVAL_MS) {
+        return;
+    }
+    last_prefetch_ms = now_ms;
+    prefetch_count = 0;
+
+    if (!allocate() || grid_spacing <= 0) {
+        return;
+    }
+
+    // the block we are in is already handled by the current location checks
+    struct grid_info origin;
+    calculate_grid_info(loc, origin);
+
+    const Vector2f vel = AP::ahrs().groundspeed_vector();
+    const float speed = MAX(vel.length(), TERRAIN_PREFETCH_MIN_SPEED);
+    uint8_t samples = TERRAIN_PREFETCH_MAX_SAMPLES;
+
+    // along the projected velocity vector
+    if (vel.length() > TERRAIN_PREFETCH_MIN_SPEED) {
+        Location pos = loc;
+        Location dest = loc;
+        dest.offset(vel.x * TERRAIN_PREFETCH_TIME_S, vel.y * TERRAIN_PREFETCH_TIME_S);
+        float eta_s = 0;
+        float remaining_m = speed * TERRAIN_PREFETCH_TIME_S;
+        prefetch_path(pos, dest, origin, speed, eta_s, remaining_m, samples);
+    }
+
+#if AP_MISSION_ENABLED
+    // along the upcoming mission legs
+    const AP_Mission *mission = AP::mission();
+    if (mission != nullptr && mission->state() == AP_Mission::MISSION_RUNNING) {
+        Location pos = loc;
+        float eta_s = 0;
+        float remaining_m = speed * TERRAIN_PREFETCH_TIME_S;
+        uint16_t index = mission->get_current_nav_index();
+        for (uint8_t i=0; i<TERRAIN_PREFETCH_MAX_MISSION_ITEMS && samples > 0 && is_positive(remaining_m); i++, index++) {
+            AP_Mission::Mission_Command cmd;
+            if (!mission->read_cmd_from_storage(index, cmd)) {
+                break;
+            }
+            if (!AP_Mission::is_nav_cmd(cmd) ||
+                (cmd.content.location.lat == 0 && cmd.content.location.lng == 0)) {
+                continue;
+            }
+            prefetch_path(pos, cmd.content.location, origin, speed, eta_s, remaining_m, samples);
+        }
+    }
+#endif
+
+    // touch the ranked blocks soonest first. Blocks already cached have
+    // their LRU time refreshed, and at most
+    // TERRAIN_PREFETCH_LOADS_PER_UPDATE new blocks are added, which
+    // queues a disk read and then GCS requests for any missing grids
+    uint8_t loads = 0;
+    for (uint8_t i=0; i<prefetch_count; i++) {
+        const struct grid_info &info = prefetch[i].info;
+#if AP_TERRAIN_MMAP_ENABLED
+        const struct grid_block *mapped = find_mmap_block(info);
+        if (mapped != nullptr && (mapped->bitmap & bitmap_mask) == bitmap_mask) {
+            // already fully available on disk
+            continue;
+        }
+#endif
+        if (find_cache_idx(info) == -1) {
+            if (loads >= TERRAIN_PREFETCH_LOADS_PER_UPDATE) {
+                continue;
+            }
+            loads++;
+        }
+        find_grid_cache(info);
+    }
+}
+
+/*
+  walk from pos towards dest, adding the blocks passed over. pos,
+  eta_s, remaining_m and samples are updated so consecutive legs can
+  be chained
+ */
+void AP_Terrain::prefetch_path(Location &pos, const Location &dest, const struct grid_info &origin,
+                               float speed, float &eta_s, float &remaining_m, uint8_t &samples)
+{
+    // sample at half the smaller block dimension so no block on the path is skipped
+    const float step_m = 0.5f * grid_spacing * MIN(TERRAIN_GRID_BLOCK_SPACING_X, TERRAIN_GRID_BLOCK_SPACING_Y);
+    const float leg_m = pos.get_distance(dest);
+    const float bearing_deg = degrees(pos.get_bearing(dest));
+
+    float travelled_m = 0;
+    while (samples > 0 && is_positive(remaining_m) && travelled_m < leg_m) {
+        const float step = MIN(MIN(step_m, leg_m - travelled_m), remaining_m);
+        travelled_m += step;
+        remaining_m -= step;
+        eta_s += step / speed;
+        samples--;
+
+        Location sample = pos;
+        sample.offset_bearing(bearing_deg, travelled_m);
+        prefetch_add(sample, origin, eta_s);
+    }
+
+    if (travelled_m >= leg_m) {
+        pos = dest;
+    } else {
+        pos.offset_bearing(bearing_deg, travelled_m);
+    }
+}
+
+/*
+  add the block containing loc to the ranked prefetch list, keeping
+  the soonest TERRAIN_PREFETCH_MAX_BLOCKS blocks sorted by ETA
+ */
+void AP_Terrain::prefetch_add(const Location &loc, const struct grid_info &origin, float eta_s)
+{
+    struct grid_info info;
+    calculate_grid_info(loc, info);
+
+    if (TERRAIN_LATLON_EQUAL(info.grid_lat, origin.grid_lat) &&
+        TERRAIN_LATLON_EQUAL(info.grid_lon, origin.grid_lon)) {
+        return;
+    }
+
+    // find the existing entry for this block, or a slot at the end
+    uint8_t i;
+    for (i=0; i<prefetch_count; i++) {
+        if (TERRAIN_LATLON_EQUAL(prefetch[i].info.grid_lat, info.grid_lat) &&
+            TERRAIN_LATLON_EQUAL(prefetch[i].info.grid_lon, info.grid_lon)) {
+            if (eta_s >= prefetch[i].eta_s) {
+                // already ranked at least as soon
+                return;
+            }
+            break;
+        }
+    }
+    if (i == prefetch_count) {
+        if (prefetch_count < TERRAIN_PREFETCH_MAX_BLOCKS) {
+            prefetch_count++;
+        } else if (eta_s >= prefetch[i-1].eta_s) {
+            // later than everything already ranked
+            return;
+        } else {
+            // replace the latest block
+            i--;
+        }
+    }
+
+    // move later entries down to keep the list sorted by ETA
+    while (i > 0 && prefetch[i-1].eta_s > eta_s) {
+        prefetch[i] = prefetch[i-1];
+        i--;
+    }
+    prefetch[i].info = info;
+    prefetch[i].eta_s = eta_s;
+}
+
+#endif // AP_TERRAIN_AVAILABLE
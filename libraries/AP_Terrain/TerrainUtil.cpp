@@ -51,6 +51,17 @@ bool AP_Terrain::check_bitmap(const struct grid_block &grid, uint8_t idx_x, uint
     return (grid.bitmap & (((uint64_t)1U)<<bitnum)) != 0;
 }
 
+/*
+  check that all 4 heights around a grid_info square are available
+ */
+bool AP_Terrain::check_square_bitmap(const struct grid_block &grid, const struct grid_info &info)
+{
+    return check_bitmap(grid, info.idx_x,   info.idx_y) &&
+           check_bitmap(grid, info.idx_x,   info.idx_y+1) &&
+           check_bitmap(grid, info.idx_x+1, info.idx_y) &&
+           check_bitmap(grid, info.idx_x+1, info.idx_y+1);
+}
+
 /*
   given a location, calculate the 32x28 grid SW corner, plus the
   grid indices
@@ -133,7 +144,7 @@ AP_Terrain::grid_cache &AP_Terrain::find_grid_cache(const struct grid_info &info
     grid.grid.grid_idx_y = info.grid_idx_y;
     grid.grid.lat_degrees = info.lat_degrees;
     grid.grid.lon_degrees = info.lon_degrees;
-    grid.grid.version = TERRAIN_GRID_FORMAT_VERSION;
+    grid.grid.version = TERRAIN_GRID_FORMAT_VERSION_RAW;
     grid.last_access_ms = AP_HAL::millis();
 
     // mark as waiting for disk read
@@ -142,6 +153,21 @@ AP_Terrain::grid_cache &AP_Terrain::find_grid_cache(const struct grid_info &info
     return grid;
 }
 
+/*
+  find the cache index of a grid_info's block, or -1 if not cached
+ */
+int16_t AP_Terrain::find_cache_idx(const struct grid_info &info) const
+{
+    for (uint16_t i=0; i<cache_size; i++) {
+        if (TERRAIN_LATLON_EQUAL(cache[i].grid.lat,info.grid_lat) &&
+            TERRAIN_LATLON_EQUAL(cache[i].grid.lon,info.grid_lon) &&
+            cache[i].grid.spacing == grid_spacing) {
+            return i;
+        }
+    }
+    return -1;
+}
+
 /*
   find cache index of disk_block
  */
@@ -166,15 +192,17 @@ int16_t AP_Terrain::find_io_idx(enum GridCacheState state)
 }
 
 /*
-  get CRC for a block
+  get CRC for a block, taken with crc=0. The block is not modified so
+  this can be used on read-only memory mapped blocks
  */
-uint16_t AP_Terrain::get_block_crc(struct grid_block &block)
+uint16_t AP_Terrain::get_block_crc(const struct grid_block &block) const
 {
-    uint16_t saved_crc = block.crc;
-    block.crc = 0;
-    uint16_t ret = crc16_ccitt((const uint8_t *)&block, sizeof(block), 0);
-    block.crc = saved_crc;
-    return ret;
+    const uint8_t *buf = (const uint8_t *)&block;
+    const uint32_t crc_ofs = offsetof(struct grid_block, crc);
+    const uint16_t zero = 0;
+    uint16_t ret = crc16_ccitt(buf, crc_ofs, 0);
+    ret = crc16_ccitt((const uint8_t *)&zero, sizeof(zero), ret);
+    return crc16_ccitt(buf + crc_ofs + sizeof(zero), sizeof(block) - (crc_ofs + sizeof(zero)), ret);
 }
 
 #endif // AP_TERRAIN_AVAILABLE
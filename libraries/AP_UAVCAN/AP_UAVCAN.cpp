@@ -315,6 +315,7 @@ void AP_UAVCAN::init(uint8_t driver_index, bool enable_filters)
 #if UAVCAN_SUPPORT_CANFD
     if (option_is_set(Options::CANFD_ENABLED)) {
         _node->enableCanFd();
+        _canfd_enabled = true;
     }
 #endif
 
@@ -464,6 +465,18 @@ void AP_UAVCAN::loop(void)
         if (_SRV_armed) {
             bool sent_servos = false;
 
+            /*
+              with CAN FD a RawCommand for up to 20 ESCs and an
+              ArrayCommand for 15 servos each fit in a single frame, so
+              send the ESCs first in every loop instead of alternating
+              with the servos. On CAN 2.0 both are multi-frame
+              transfers, and the servo loop takes the bus instead
+             */
+            const bool send_esc_first = _canfd_enabled && _esc_bm > 0;
+            if (send_esc_first) {
+                SRV_send_esc();
+            }
+
             if (_servo_bm > 0) {
                 // if we have any Servos in bitmask
                 uint32_t now = AP_HAL::native_micros();
@@ -479,7 +492,7 @@ void AP_UAVCAN::loop(void)
             }
 
             // if we have any ESC's in bitmask
-            if (_esc_bm > 0 && !sent_servos) {
+            if (_esc_bm > 0 && !sent_servos && !send_esc_first) {
                 SRV_send_esc();
             }
 
@@ -500,6 +513,7 @@ void AP_UAVCAN::loop(void)
         AP::opendroneid().dronecan_send(this);
 #endif
         logging();
+        check_pool();
     }
 }
 
@@ -1242,6 +1256,20 @@ void AP_UAVCAN::logging(void)
         return;
     }
     last_log_ms = now_ms;
+
+    // pool usage, for sizing CAN_Dn_UC_POOL
+    AP::logger().WriteStreaming("CANP",
+                                "TimeUS,I,Blk,Used,MaxUsed,Fail",
+                                "s#----",
+                                "F-----",
+                                "QBHHHI",
+                                AP_HAL::micros64(),
+                                _driver_index,
+                                _allocator->getBlockCapacity(),
+                                _allocator->get_used(),
+                                _allocator->get_max_used(),
+                                _allocator->get_alloc_failures());
+
     if (HAL_NUM_CAN_IFACES <= _driver_index) {
         // no interface?
         return;
@@ -1279,4 +1307,34 @@ void AP_UAVCAN::logging(void)
 #endif // HAL_LOGGING_ENABLED
 }
 
+/*
+  libuavcan drops a transfer when the pool is empty, which otherwise
+  goes unnoticed until ESC telemetry or sensor data goes missing
+ */
+void AP_UAVCAN::check_pool(void)
+{
+    const uint32_t failures = _allocator->get_alloc_failures();
+    if (failures == _pool_failures_warned) {
+        return;
+    }
+    const uint32_t now_ms = AP_HAL::millis();
+    if (now_ms - _pool_warn_ms < 30000) {
+        return;
+    }
+    _pool_warn_ms = now_ms;
+    GCS_SEND_TEXT(MAV_SEVERITY_WARNING, "DroneCAN%u: pool full, %u dropped, max %u/%u blocks used",
+                  unsigned(_driver_index+1),
+                  unsigned(failures - _pool_failures_warned),
+                  unsigned(_allocator->get_max_used()),
+                  unsigned(_allocator->getBlockCapacity()));
+    _pool_failures_warned = failures;
+}
+
+void AP_UAVCAN::get_pool_stats(ExpandingString &str) const
+{
+    if (_allocator != nullptr) {
+        _allocator->get_stats(str);
+    }
+}
+
 #endif // HAL_NUM_CAN_IFACES
@@ -109,6 +109,9 @@ public:
     static AP_UAVCAN *get_uavcan(uint8_t driver_index);
     bool prearm_check(char* fail_msg, uint8_t fail_msg_len) const;
 
+    // print memory pool statistics for @SYS/canN_stats.txt
+    void get_pool_stats(ExpandingString &str) const;
+
     void init(uint8_t driver_index, bool enable_filters) override;
     bool add_interface(AP_HAL::CANIface* can_iface) override;
 
@@ -249,6 +252,9 @@ private:
 
     // periodic logging
     void logging();
+
+    // warn if transfers have been dropped for lack of pool memory
+    void check_pool(void);
     
     // set parameter on a node
     ParamGetSetIntCb *param_int_cb;
@@ -295,12 +301,17 @@ private:
     uint32_t _fail_send_count;
 
     uint8_t _SRV_armed;
+    bool _canfd_enabled;    // node was started with CAN FD frames
     uint32_t _SRV_last_send_us;
     HAL_Semaphore SRV_sem;
 
     // last log time
     uint32_t last_log_ms;
 
+    // pool allocation failures when the user was last warned
+    uint32_t _pool_failures_warned;
+    uint32_t _pool_warn_ms;
+
     ///// LED /////
     struct led_device {
         uint8_t led_index;
@@ -76,9 +76,8 @@ int16_t CanIface::receive(CanFrame& out_frame, MonotonicTime& out_ts_monotonic,
         return -1;
     }
     AP_HAL::CANFrame frame;
-    uint64_t rx_timestamp;
+    uint64_t rx_timestamp = 0;
     uint16_t flags;
-    out_ts_monotonic = SystemClock::instance().getMonotonic();
     int16_t ret = can_iface_->receive(frame, rx_timestamp, flags);
     if (ret < 0) {
         return ret;
@@ -86,8 +85,17 @@ int16_t CanIface::receive(CanFrame& out_frame, MonotonicTime& out_ts_monotonic,
     out_frame = CanFrame(frame.id, (const uint8_t*)frame.data, AP_HAL::CANFrame::dlcToDataLength(frame.dlc), frame.canfd);
     out_flags = flags;
     if (rx_timestamp != 0) {
+        /*
+          use the time the frame arrived, taken in the RX interrupt,
+          rather than the time it was taken from the queue, so
+          getMonotonicTimestamp() on a received message is the arrival
+          time of its first frame. All HAL backends timestamp with
+          native_micros64(), the same clock as SystemClock
+         */
+        out_ts_monotonic = uavcan::MonotonicTime::fromUSec(rx_timestamp);
         out_ts_utc = uavcan::UtcTime::fromUSec(SystemClock::instance().getAdjustUsec() + rx_timestamp);
     } else {
+        out_ts_monotonic = SystemClock::instance().getMonotonic();
         out_ts_utc = uavcan::UtcTime::fromUSec(0);
     }
     return ret;
@@ -24,6 +24,7 @@
 
 #include "AP_UAVCAN.h"
 #include "AP_UAVCAN_pool.h"
+#include <AP_Common/ExpandingString.h>
 
 AP_PoolAllocator::AP_PoolAllocator(uint16_t _pool_size) :
     num_blocks(_pool_size / UAVCAN_NODE_POOL_BLOCK_SIZE)
@@ -48,6 +49,8 @@ void* AP_PoolAllocator::allocate(std::size_t size)
 {
     WITH_SEMAPHORE(sem);
     if (free_list == nullptr || size > UAVCAN_NODE_POOL_BLOCK_SIZE) {
+        // libuavcan drops the transfer, count it so the pool can be sized
+        alloc_failures++;
         return nullptr;
     }
     Node *ret = free_list;
@@ -85,5 +88,20 @@ void AP_PoolAllocator::deallocate(const void* ptr)
     used--;
 }
 
+void AP_PoolAllocator::get_stats(ExpandingString &str) const
+{
+    str.printf("------- DroneCAN Pool -------\n"
+               "block_size:     %u\n"
+               "blocks:         %u\n"
+               "used:           %u\n"
+               "max_used:       %u\n"
+               "alloc_failures: %lu\n",
+               unsigned(UAVCAN_NODE_POOL_BLOCK_SIZE),
+               unsigned(num_blocks),
+               unsigned(used),
+               unsigned(max_used),
+               (unsigned long)alloc_failures);
+}
+
 #endif // HAL_ENABLE_LIBUAVCAN_DRIVERS
 
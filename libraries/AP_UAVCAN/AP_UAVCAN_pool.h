@@ -43,6 +43,14 @@ public:
         return num_blocks;
     }
 
+    // usage statistics, for sizing CAN_Dn_UC_POOL
+    uint16_t get_used() const { return used; }
+    uint16_t get_max_used() const { return max_used; }
+    uint32_t get_alloc_failures() const { return alloc_failures; }
+
+    // print usage statistics
+    void get_stats(ExpandingString &str) const;
+
 private:
     const uint16_t num_blocks;
 
@@ -57,4 +65,5 @@ private:
 
     uint16_t used;
     uint16_t max_used;
+    uint32_t alloc_failures;    // allocations refused because the pool was empty or the request too big
 };
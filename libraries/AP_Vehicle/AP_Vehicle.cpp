@@ -560,7 +560,7 @@ void AP_Vehicle::update_dynamic_notch(AP_InertialSensor::HarmonicNotch &notch)
             if (notch.params.hasOption(HarmonicNotchFilterParams::Options::DynamicHarmonic)) {
                 float notches[INS_MAX_NOTCHES];
                 // ESC telemetry will return 0 for missing data, but only after 1s
-                const uint8_t num_notches = AP::esc_telem().get_motor_frequencies_hz(INS_MAX_NOTCHES, notches);
+                const uint8_t num_notches = AP::esc_telem().get_time_aligned_motor_frequencies_hz(INS_MAX_NOTCHES, notches);
                 for (uint8_t i = 0; i < num_notches; i++) {
                     if (!is_zero(notches[i])) {
                         notches[i] =  MAX(ref_freq, notches[i]);
@@ -599,6 +599,12 @@ void AP_Vehicle::update_dynamic_notch(AP_InertialSensor::HarmonicNotch &notch)
                     notch.set_inactive(true);
                 }
             }
+            // notches running on the other IMUs follow their own noise frequency
+            if (gyro_fft.analyse_all_imus()) {
+                for (uint8_t i = 0; i < INS_MAX_INSTANCES; i++) {
+                    notch.set_frequency_scale(i, gyro_fft.get_imu_frequency_scale(i));
+                }
+            }
             break;
 #endif
         case HarmonicNotchDynamicMode::Fixed: // static
@@ -76,7 +76,7 @@ const AP_Param::GroupInfo AP_VisualOdom::var_info[] = {
 
     // @Param: _DELAY_MS
     // @DisplayName: Visual odometry sensor delay
-    // @Description: Visual odometry sensor delay relative to inertial measurements
+    // @Description: Visual odometry sensor delay relative to inertial measurements. When the companion answers TIMESYNC requests its timestamps are placed on the autopilot clock directly, and this only needs to cover delay from before the companion timestamps its data
     // @Units: ms
     // @Range: 0 250
     // @User: Advanced
@@ -156,6 +156,9 @@ void AR_WPNav::update(float dt)
     }
     _last_update_ms = AP_HAL::millis();
 
+    // recalculate the leg geometry if the (object avoidance adjusted) origin or destination have moved
+    _leg.set(get_oa_origin(), get_oa_destination());
+
     update_distance_and_bearing_to_destination();
 
     // handle change in max speed
@@ -536,26 +539,16 @@ float AR_WPNav::calc_crosstrack_error(const Location& current_loc) const
         return 0.0f;
     }
 
-    // get object avoidance adjusted origin and destination
-    const Location &orig = get_oa_origin();
-    const Location &dest = get_oa_destination();
-
-    // calculate the NE position of destination relative to origin
-    Vector2f dest_from_origin = orig.get_distance_NE(dest);
+    // calculate the NE position of the vehicle relative to the leg's origin
+    const Vector2f veh_from_origin = _leg.from_origin_NE(current_loc);
 
     // return distance to destination if length of track is very small
-    if (dest_from_origin.length() < 1.0e-6f) {
-        return current_loc.get_distance_NE(dest).length();
+    if (_leg.is_zero_length()) {
+        return (veh_from_origin - _leg.get_vector_NE()).length();
     }
 
-    // convert to a vector indicating direction only
-    dest_from_origin.normalize();
-
-    // calculate the NE position of the vehicle relative to origin
-    const Vector2f veh_from_origin = orig.get_distance_NE(current_loc);
-
     // calculate distance to target track, for reporting
-    return veh_from_origin % dest_from_origin;
+    return _leg.crosstrack(veh_from_origin);
 }
 
 // calculate yaw change at next waypoint in degrees
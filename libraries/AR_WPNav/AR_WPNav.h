@@ -1,6 +1,7 @@
 #pragma once
 
 #include <AP_Common/AP_Common.h>
+#include <AP_Common/Location.h>
 #include <AP_Math/SCurve.h>
 #include <APM_Control/AR_AttitudeControl.h>
 #include <APM_Control/AR_PosControl.h>
@@ -123,7 +124,7 @@ protected:
     // calculate steering and speed to drive along line from origin to destination waypoint
     void update_steering_and_speed(const Location &current_loc, float dt);
 
-    // calculate the crosstrack error (does not rely on L1 controller)
+    // calculate the crosstrack error (does not rely on L1 controller) using the leg set by update()
     float calc_crosstrack_error(const Location& current_loc) const;
 
     // calculate yaw change at next waypoint in degrees
@@ -169,6 +170,7 @@ protected:
     Location _origin;               // origin Location (vehicle will travel from the origin to the destination)
     Location _destination;          // destination Location when in Guided_WP
     bool _orig_and_dest_valid;      // true if the origin and destination have been set
+    LocationLeg _leg;               // geometry of the object avoidance adjusted leg, updated by update()
     bool _reversed;                 // execute the mission by backing up
     enum class NavControllerType {
         NAV_SCURVE = 0,             // scurves used for navigation
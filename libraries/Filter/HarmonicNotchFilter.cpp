@@ -21,6 +21,16 @@
 #include "HarmonicNotchFilter.h"
 #include <GCS_MAVLink/GCS.h>
 
+#if AP_FILTER_NOTCH_BANK_ENABLED
+#if defined(__SSE__)
+#include <xmmintrin.h>
+#define HNF_BANK_SSE 1
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#define HNF_BANK_NEON 1
+#endif
+#endif
+
 #define HNF_MAX_FILTERS HAL_HNF_MAX_FILTERS // must be even for double-notch filters
 #define HNF_MAX_HARMONICS 8
 
@@ -106,6 +116,9 @@ const AP_Param::GroupInfo HarmonicNotchFilterParams::var_info[] = {
 template <class T>
 HarmonicNotchFilter<T>::~HarmonicNotchFilter() {
     delete[] _filters;
+#if AP_FILTER_NOTCH_BANK_ENABLED
+    delete[] _bank_state;
+#endif
     _num_filters = 0;
     _num_enabled_filters = 0;
 }
@@ -152,13 +165,46 @@ void HarmonicNotchFilter<T>::allocate_filters(uint8_t num_notches, uint8_t harmo
 
     if (_num_filters > 0) {
         _filters = new NotchFilter<T>[_num_filters];
-        if (_filters == nullptr) {
+        if (_filters == nullptr || !allocate_bank_state(_num_filters)) {
             GCS_SEND_TEXT(MAV_SEVERITY_ERROR, "Failed to allocate %u bytes for notch filter", (unsigned int)(_num_filters * sizeof(NotchFilter<T>)));
+            delete[] _filters;
+            _filters = nullptr;
             _num_filters = 0;
         }
     }
 }
 
+/*
+  allocate the state for the bank apply. Only the Vector3f
+  specialisation uses a bank
+ */
+template <class T>
+bool HarmonicNotchFilter<T>::allocate_bank_state(uint8_t num_filters)
+{
+    return true;
+}
+
+#if AP_FILTER_NOTCH_BANK_ENABLED
+/*
+  (re)allocate the bank state, preserving the state of existing notches
+ */
+template <>
+bool HarmonicNotchFilter<Vector3f>::allocate_bank_state(uint8_t num_filters)
+{
+    auto bank_state = new BankState[num_filters];
+    if (bank_state == nullptr) {
+        return false;
+    }
+    if (_bank_state != nullptr) {
+        memcpy(bank_state, _bank_state, sizeof(bank_state[0])*MIN(_num_filters, num_filters));
+    }
+    auto old_bank_state = _bank_state;
+    _bank_state = bank_state;
+    delete[] old_bank_state;
+    return true;
+}
+#endif
+
 /*
   expand the number of filters at runtime, allowing for RPM sources such as lua scripts
  */
@@ -179,7 +225,8 @@ void HarmonicNotchFilter<T>::expand_filter_count(uint8_t num_notches)
       AP_InertialSensor_Backend.cpp to make this thread safe
      */
     auto filters = new NotchFilter<T>[num_filters];
-    if (filters == nullptr) {
+    if (filters == nullptr || !allocate_bank_state(num_filters)) {
+        delete[] filters;
         _alloc_has_failed = true;
         return;
     }
@@ -304,6 +351,113 @@ T HarmonicNotchFilter<T>::apply(const T &sample)
     return output;
 }
 
+#if AP_FILTER_NOTCH_BANK_ENABLED
+/*
+  apply a sample to the notches as a bank, filtering all three axes of
+  each notch together. The state of each notch lives in _bank_state
+  rather than in the NotchFilter, which only supplies the coefficients
+  and the initialised / reset flags. The operations are done in the
+  same order as NotchFilter::apply()
+ */
+template <>
+Vector3f HarmonicNotchFilter<Vector3f>::apply(const Vector3f &sample)
+{
+    if (!_initialised) {
+        return sample;
+    }
+
+#if HNF_BANK_SSE
+    __m128 x = _mm_set_ps(0, sample.z, sample.y, sample.x);
+    for (uint8_t i = 0; i < _num_enabled_filters; i++) {
+        NotchFilter<Vector3f> &f = _filters[i];
+        BankState &s = _bank_state[i];
+        if (!f.initialised || f.need_reset) {
+            // pass through the sample, setting all delayed samples to it
+            _mm_storeu_ps(s.x1, x);
+            _mm_storeu_ps(s.x2, x);
+            _mm_storeu_ps(s.y1, x);
+            _mm_storeu_ps(s.y2, x);
+            f.need_reset = false;
+            continue;
+        }
+        const __m128 x1 = _mm_loadu_ps(s.x1);
+        const __m128 y1 = _mm_loadu_ps(s.y1);
+        __m128 acc = _mm_mul_ps(x, _mm_set1_ps(f.b0));
+        acc = _mm_add_ps(acc, _mm_mul_ps(x1, _mm_set1_ps(f.b1)));
+        acc = _mm_add_ps(acc, _mm_mul_ps(_mm_loadu_ps(s.x2), _mm_set1_ps(f.b2)));
+        acc = _mm_sub_ps(acc, _mm_mul_ps(y1, _mm_set1_ps(f.a1)));
+        acc = _mm_sub_ps(acc, _mm_mul_ps(_mm_loadu_ps(s.y2), _mm_set1_ps(f.a2)));
+        const __m128 y = _mm_mul_ps(acc, _mm_set1_ps(f.a0_inv));
+        _mm_storeu_ps(s.x2, x1);
+        _mm_storeu_ps(s.x1, x);
+        _mm_storeu_ps(s.y2, y1);
+        _mm_storeu_ps(s.y1, y);
+        x = y;
+    }
+    float out[4];
+    _mm_storeu_ps(out, x);
+    return Vector3f(out[0], out[1], out[2]);
+#elif HNF_BANK_NEON
+    const float in[4] { sample.x, sample.y, sample.z, 0 };
+    float32x4_t x = vld1q_f32(in);
+    for (uint8_t i = 0; i < _num_enabled_filters; i++) {
+        NotchFilter<Vector3f> &f = _filters[i];
+        BankState &s = _bank_state[i];
+        if (!f.initialised || f.need_reset) {
+            // pass through the sample, setting all delayed samples to it
+            vst1q_f32(s.x1, x);
+            vst1q_f32(s.x2, x);
+            vst1q_f32(s.y1, x);
+            vst1q_f32(s.y2, x);
+            f.need_reset = false;
+            continue;
+        }
+        // separate multiplies and adds rather than vmlaq/vfmaq to
+        // keep the rounding of NotchFilter::apply()
+        const float32x4_t x1 = vld1q_f32(s.x1);
+        const float32x4_t y1 = vld1q_f32(s.y1);
+        float32x4_t acc = vmulq_n_f32(x, f.b0);
+        acc = vaddq_f32(acc, vmulq_n_f32(x1, f.b1));
+        acc = vaddq_f32(acc, vmulq_n_f32(vld1q_f32(s.x2), f.b2));
+        acc = vsubq_f32(acc, vmulq_n_f32(y1, f.a1));
+        acc = vsubq_f32(acc, vmulq_n_f32(vld1q_f32(s.y2), f.a2));
+        const float32x4_t y = vmulq_n_f32(acc, f.a0_inv);
+        vst1q_f32(s.x2, x1);
+        vst1q_f32(s.x1, x);
+        vst1q_f32(s.y2, y1);
+        vst1q_f32(s.y1, y);
+        x = y;
+    }
+    float out[4];
+    vst1q_f32(out, x);
+    return Vector3f(out[0], out[1], out[2]);
+#else
+    float x[3] { sample.x, sample.y, sample.z };
+    for (uint8_t i = 0; i < _num_enabled_filters; i++) {
+        NotchFilter<Vector3f> &f = _filters[i];
+        BankState &s = _bank_state[i];
+        if (!f.initialised || f.need_reset) {
+            // pass through the sample, setting all delayed samples to it
+            for (uint8_t a = 0; a < 3; a++) {
+                s.x1[a] = s.x2[a] = s.y1[a] = s.y2[a] = x[a];
+            }
+            f.need_reset = false;
+            continue;
+        }
+        for (uint8_t a = 0; a < 3; a++) {
+            const float y = (x[a]*f.b0 + s.x1[a]*f.b1 + s.x2[a]*f.b2 - s.y1[a]*f.a1 - s.y2[a]*f.a2) * f.a0_inv;
+            s.x2[a] = s.x1[a];
+            s.x1[a] = x[a];
+            s.y2[a] = s.y1[a];
+            s.y1[a] = y;
+            x[a] = y;
+        }
+    }
+    return Vector3f(x[0], x[1], x[2]);
+#endif
+}
+#endif // AP_FILTER_NOTCH_BANK_ENABLED
+
 /*
   reset all of the underlying filters
  */
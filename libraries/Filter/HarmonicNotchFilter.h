@@ -21,6 +21,18 @@
 
 #define HNF_MAX_HARMONICS 8
 
+/*
+  apply the notches of a HarmonicNotchFilter<Vector3f> as a bank,
+  filtering all three axes of each notch together. This uses SSE or
+  NEON where available and a structure-of-arrays scalar loop
+  otherwise. The arithmetic is done in the same order as
+  NotchFilter::apply() so the output is bit-identical unless the
+  compiler fuses the scalar multiply-adds, as it may on aarch64
+ */
+#ifndef AP_FILTER_NOTCH_BANK_ENABLED
+#define AP_FILTER_NOTCH_BANK_ENABLED 1
+#endif
+
 /*
   a filter that manages a set of notch filters targetted at a fundamental center frequency
   and multiples of that fundamental frequency
@@ -45,8 +57,21 @@ public:
     void reset();
 
 private:
+    // allocate the per-notch state used by the bank apply
+    bool allocate_bank_state(uint8_t num_filters);
+
     // underlying bank of notch filters
     NotchFilter<T>*  _filters;
+#if AP_FILTER_NOTCH_BANK_ENABLED
+    // per-notch filter state for the bank apply, one lane per axis
+    struct BankState {
+        float x1[4];
+        float x2[4];
+        float y1[4];
+        float y2[4];
+    };
+    BankState *_bank_state;
+#endif
     // sample frequency for each filter
     float _sample_freq_hz;
     // base double notch bandwidth for each filter
@@ -136,3 +161,10 @@ private:
 
 typedef HarmonicNotchFilter<Vector3f> HarmonicNotchFilterVector3f;
 
+#if AP_FILTER_NOTCH_BANK_ENABLED
+template <>
+Vector3f HarmonicNotchFilter<Vector3f>::apply(const Vector3f &sample);
+template <>
+bool HarmonicNotchFilter<Vector3f>::allocate_bank_state(uint8_t num_filters);
+#endif
+
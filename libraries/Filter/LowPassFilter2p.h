@@ -89,6 +89,60 @@ LowPassFilter2p<T>::LowPassFilter2p(float sample_freq, float cutoff_freq) {
 }
 */
 
+/// @class  LowPassFilter2pConst
+/// @brief  Second order low pass filter with the sample and cutoff frequencies fixed at compile time
+/// The coefficients are calculated once on construction and apply() has no pass-through branch, so
+/// it can be fully inlined in fixed rate loops. Use LowPassFilter2p when the frequencies come from parameters
+template <class T, uint16_t SAMPLE_FREQ_HZ, uint16_t CUTOFF_FREQ_HZ>
+class LowPassFilter2pConst {
+public:
+    static_assert(CUTOFF_FREQ_HZ > 0, "cutoff frequency must be positive");
+    static_assert(2 * CUTOFF_FREQ_HZ < SAMPLE_FREQ_HZ, "cutoff frequency must be below the Nyquist frequency");
+
+    LowPassFilter2pConst() {
+        const float ohm = tanf(M_PI * CUTOFF_FREQ_HZ / SAMPLE_FREQ_HZ);
+        const float c = 1.0f + 2.0f * cosf(M_PI / 4.0f) * ohm + ohm * ohm;
+        _b0 = ohm * ohm / c;
+        _a1 = 2.0f * (ohm * ohm - 1.0f) / c;
+        _a2 = (1.0f - 2.0f * cosf(M_PI / 4.0f) * ohm + ohm * ohm) / c;
+    }
+
+    CLASS_NO_COPY(LowPassFilter2pConst);
+
+    static constexpr float get_cutoff_freq(void) { return CUTOFF_FREQ_HZ; }
+    static constexpr float get_sample_freq(void) { return SAMPLE_FREQ_HZ; }
+
+    // the Butterworth numerator is b0 * (1, 2, 1) so only b0 is needed
+    T apply(const T &sample) {
+        if (!_initialised) {
+            reset(sample);
+        }
+        const T delay_element_0 = sample - _delay_element_1 * _a1 - _delay_element_2 * _a2;
+        const T output = (delay_element_0 + _delay_element_1 * 2.0f + _delay_element_2) * _b0;
+        _delay_element_2 = _delay_element_1;
+        _delay_element_1 = delay_element_0;
+        return output;
+    }
+
+    void reset(void) {
+        _delay_element_1 = _delay_element_2 = T();
+        _initialised = false;
+    }
+
+    void reset(const T &value) {
+        _delay_element_1 = _delay_element_2 = value * (1.0f / (1 + _a1 + _a2));
+        _initialised = true;
+    }
+
+private:
+    float _a1;
+    float _a2;
+    float _b0;
+    T _delay_element_1 {};
+    T _delay_element_2 {};
+    bool _initialised = false;
+};
+
 typedef LowPassFilter2p<int>      LowPassFilter2pInt;
 typedef LowPassFilter2p<long>     LowPassFilter2pLong;
 typedef LowPassFilter2p<float>    LowPassFilter2pFloat;
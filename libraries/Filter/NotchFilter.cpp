@@ -23,6 +23,10 @@
 const static float NOTCH_MAX_SLEW       = 0.05f;
 const static float NOTCH_MAX_SLEW_LOWER = 1.0f - NOTCH_MAX_SLEW;
 const static float NOTCH_MAX_SLEW_UPPER = 1.0f / NOTCH_MAX_SLEW_LOWER;
+// largest change in omega that is applied as a rotation of the previous coefficients
+const static float NOTCH_MAX_ROTATION   = 0.1f;
+// number of rotations before recalculating exactly to remove accumulated error
+const static uint8_t NOTCH_MAX_INCREMENTAL_UPDATES = 64;
 
 /*
    calculate the attenuation and quality factors of the filter
@@ -72,10 +76,31 @@ void NotchFilter<T>::init_with_A_and_Q(float sample_freq_hz, float center_freq_h
     }
 
     if ((new_center_freq > 0.0) && (new_center_freq < 0.5 * sample_freq_hz) && (Q > 0.0)) {
-        float omega = 2.0 * M_PI * new_center_freq / sample_freq_hz;
-        float alpha = sinf(omega) / (2 * Q);
+        // tracking notches move by small amounts on every update, so rotate the previous
+        // sine and cosine by the change in omega rather than recalculating them
+        const float delta = M_2PI * (new_center_freq - _center_freq_hz) / sample_freq_hz;
+        if (initialised && is_equal(sample_freq_hz, _sample_freq_hz) && fabsf(delta) < NOTCH_MAX_ROTATION
+            && _incremental_updates < NOTCH_MAX_INCREMENTAL_UPDATES) {
+            // truncated Taylor series are accurate to float precision within NOTCH_MAX_ROTATION
+            const float delta_sq = sq(delta);
+            const float sin_delta = delta * (1.0f - delta_sq * (1.0f / 6.0f));
+            const float cos_delta = 1.0f - delta_sq * 0.5f * (1.0f - delta_sq * (1.0f / 12.0f));
+            const float sin_omega = _sin_omega * cos_delta + _cos_omega * sin_delta;
+            const float cos_omega = _cos_omega * cos_delta - _sin_omega * sin_delta;
+            // first order renormalisation to stay on the unit circle
+            const float norm = 1.5f - 0.5f * (sq(sin_omega) + sq(cos_omega));
+            _sin_omega = sin_omega * norm;
+            _cos_omega = cos_omega * norm;
+            _incremental_updates++;
+        } else {
+            float omega = 2.0 * M_PI * new_center_freq / sample_freq_hz;
+            _sin_omega = sinf(omega);
+            _cos_omega = cosf(omega);
+            _incremental_updates = 0;
+        }
+        float alpha = _sin_omega / (2 * Q);
         b0 =  1.0 + alpha*sq(A);
-        b1 = -2.0 * cosf(omega);
+        b1 = -2.0 * _cos_omega;
         b2 =  1.0 - alpha*sq(A);
         a0_inv =  1.0/(1.0 + alpha);
         a1 = b1;
@@ -26,8 +26,14 @@
 #include <AP_Param/AP_Param.h>
 
 
+template <class T>
+class HarmonicNotchFilter;
+
 template <class T>
 class NotchFilter {
+    // the harmonic notch bank apply uses the coefficients directly
+    friend class HarmonicNotchFilter<T>;
+
 public:
     // set parameters
     void init(float sample_freq_hz, float center_freq_hz, float bandwidth_hz, float attenuation_dB);
@@ -43,6 +49,10 @@ private:
     bool initialised, need_reset;
     float b0, b1, b2, a1, a2, a0_inv;
     float _center_freq_hz, _sample_freq_hz;
+    // sine and cosine of the center frequency, rotated on small frequency changes
+    float _sin_omega, _cos_omega;
+    // number of rotations since the last exact calculation
+    uint8_t _incremental_updates;
     T ntchsig, ntchsig1, ntchsig2, signal2, signal1;
 };
 
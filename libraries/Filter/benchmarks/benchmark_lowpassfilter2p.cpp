@@ -0,0 +1,44 @@
+#include <AP_gbenchmark.h>
+
+#include <Filter/LowPassFilter2p.h>
+
+const AP_HAL::HAL& hal = AP_HAL::get_HAL();
+
+/*
+  compare the parameter driven and compile time second order low pass
+  filters on gyro rate samples
+ */
+static const uint16_t rate_hz = 1000;
+
+static Vector3f test_sample(uint32_t i)
+{
+    const float t = (i % rate_hz) / float(rate_hz);
+    return Vector3f(sinf(t * 190 * M_2PI), cosf(t * 380 * M_2PI), sinf(t * 570 * M_2PI));
+}
+
+static void BM_LowPassFilter2p(benchmark::State& state)
+{
+    LowPassFilter2pVector3f filter(rate_hz, 20);
+
+    uint32_t i = 0;
+    while (state.KeepRunning()) {
+        Vector3f v = filter.apply(test_sample(i++));
+        gbenchmark_escape(&v);
+    }
+}
+
+static void BM_LowPassFilter2pConst(benchmark::State& state)
+{
+    LowPassFilter2pConst<Vector3f, rate_hz, 20> filter;
+
+    uint32_t i = 0;
+    while (state.KeepRunning()) {
+        Vector3f v = filter.apply(test_sample(i++));
+        gbenchmark_escape(&v);
+    }
+}
+
+BENCHMARK(BM_LowPassFilter2p);
+BENCHMARK(BM_LowPassFilter2pConst);
+
+BENCHMARK_MAIN();
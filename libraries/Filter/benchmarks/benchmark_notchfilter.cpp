@@ -0,0 +1,67 @@
+#include <AP_gbenchmark.h>
+
+#include <Filter/NotchFilter.h>
+#include <Filter/HarmonicNotchFilter.h>
+
+const AP_HAL::HAL& hal = AP_HAL::get_HAL();
+
+/*
+  benchmarks of the gyro notch filtering at 8kHz with four harmonics
+  of a double notch, the argument being the number of harmonic notch
+  sources, e.g. one per motor
+ */
+static const uint16_t rate_hz = 8000;
+static const uint8_t harmonics = 15;
+static const uint8_t num_harmonics = 4;
+
+static Vector3f test_sample(uint32_t i)
+{
+    const float t = (i % rate_hz) / float(rate_hz);
+    return Vector3f(sinf(t * 190 * M_2PI), cosf(t * 380 * M_2PI), sinf(t * 570 * M_2PI));
+}
+
+// a plain cascade of NotchFilter<Vector3f>, as HarmonicNotchFilter
+// applies them without the bank
+static void BM_NotchFilterCascade(benchmark::State& state)
+{
+    const uint8_t num_filters = state.range(0) * num_harmonics * 2;
+    NotchFilter<Vector3f> *filters = new NotchFilter<Vector3f>[num_filters];
+    for (uint8_t i = 0; i < num_filters; i++) {
+        filters[i].init(rate_hz, 80 * (1 + i/2), 40, 40);
+    }
+
+    uint32_t i = 0;
+    while (state.KeepRunning()) {
+        Vector3f v = test_sample(i++);
+        for (uint8_t f = 0; f < num_filters; f++) {
+            v = filters[f].apply(v);
+        }
+        gbenchmark_escape(&v);
+    }
+    delete[] filters;
+}
+
+static void BM_HarmonicNotchFilter(benchmark::State& state)
+{
+    const uint8_t sources = state.range(0);
+    HarmonicNotchFilter<Vector3f> *filters = new HarmonicNotchFilter<Vector3f>[sources];
+    for (uint8_t s = 0; s < sources; s++) {
+        filters[s].allocate_filters(num_harmonics, harmonics, 2);
+        filters[s].init(rate_hz, 80, 40, 40);
+    }
+
+    uint32_t i = 0;
+    while (state.KeepRunning()) {
+        Vector3f v = test_sample(i++);
+        for (uint8_t s = 0; s < sources; s++) {
+            v = filters[s].apply(v);
+        }
+        gbenchmark_escape(&v);
+    }
+    delete[] filters;
+}
+
+BENCHMARK(BM_NotchFilterCascade)->Arg(1)->Arg(4)->Arg(8);
+BENCHMARK(BM_HarmonicNotchFilter)->Arg(1)->Arg(4)->Arg(8);
+
+BENCHMARK_MAIN();
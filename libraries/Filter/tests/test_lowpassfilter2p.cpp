@@ -0,0 +1,39 @@
+#include <AP_gtest.h>
+
+#include <Filter/LowPassFilter2p.h>
+
+const AP_HAL::HAL& hal = AP_HAL::get_HAL();
+
+/*
+  the compile time filter should match the parameter driven filter
+ */
+TEST(LowPassFilter2pTest, ConstMatchesRuntime)
+{
+    LowPassFilter2pFloat filter(1000, 20);
+    LowPassFilter2pConst<float, 1000, 20> filter_const;
+    EXPECT_FLOAT_EQ(filter.get_cutoff_freq(), filter_const.get_cutoff_freq());
+    EXPECT_FLOAT_EQ(filter.get_sample_freq(), filter_const.get_sample_freq());
+
+    for (uint32_t i=0; i<2000; i++) {
+        const float sample = sinf(i * 0.05f) + 0.3f * cosf(i * 0.7f) + 2.0f;
+        EXPECT_NEAR(filter.apply(sample), filter_const.apply(sample), 1.0e-4);
+    }
+}
+
+/*
+  test a reset to a constant value gives no glitch with a constant input
+ */
+TEST(LowPassFilter2pTest, ConstResetTest)
+{
+    LowPassFilter2pConst<Vector3f, 400, 1> filter;
+    const Vector3f const_sample{25.0f, -3.0f, 0.5f};
+    filter.reset(const_sample);
+    for (uint32_t i=0; i<100; i++) {
+        const Vector3f v = filter.apply(const_sample);
+        EXPECT_NEAR(v.x, const_sample.x, 1.0e-3);
+        EXPECT_NEAR(v.y, const_sample.y, 1.0e-3);
+        EXPECT_NEAR(v.z, const_sample.z, 1.0e-3);
+    }
+}
+
+AP_GTEST_MAIN()
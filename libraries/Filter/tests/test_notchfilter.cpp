@@ -66,6 +66,35 @@ TEST(NotchFilterTest, SineTest)
     EXPECT_LE(err_pct, 1);
 }
 
+/*
+  test that a notch that has tracked to a frequency, rotating its
+  coefficients on each update, matches a notch calculated directly at
+  that frequency
+ */
+TEST(NotchFilterTest, TrackingTest)
+{
+    NotchFilter<float> tracking;
+    NotchFilter<float> exact;
+    const float rate_hz = 1000;
+    const double dt = 1.0 / rate_hz;
+    float A, Q;
+    NotchFilter<float>::calculate_A_and_Q(80, 40, 40, A, Q);
+
+    // fewer steps than force an exact recalculation
+    tracking.init_with_A_and_Q(rate_hz, 80, A, Q);
+    for (uint8_t i=1; i<=50; i++) {
+        tracking.init_with_A_and_Q(rate_hz, 80 + i * 0.8f, A, Q);
+    }
+    exact.init_with_A_and_Q(rate_hz, 120, A, Q);
+
+    tracking.reset();
+    exact.reset();
+    for (uint32_t i=0; i<5000; i++) {
+        const double sample = sin(120 * i * dt * 2 * M_PI) + 0.5 * sin(33 * i * dt * 2 * M_PI);
+        EXPECT_NEAR(tracking.apply(sample), exact.apply(sample), 1.0e-4);
+    }
+}
+
 /*
   test attentuation versus frequency
   This is a way to get a graph of the attenuation and phase lag for a complex filter setup
@@ -156,4 +185,50 @@ TEST(NotchFilterTest, HarmonicNotchTest)
     EXPECT_NEAR(integrals[9].get_lag_degrees(10), 112.23, 0.5);
 }
 
+/*
+  test that a Vector3f harmonic notch gives the same output as a
+  float harmonic notch per axis, including across frequency updates
+  and resets
+ */
+TEST(NotchFilterTest, HarmonicNotchVectorTest)
+{
+    const uint8_t harmonics = 15;
+    const uint8_t num_harmonics = __builtin_popcount(harmonics);
+    const uint16_t rate_hz = 8000;
+    const double dt = 1.0 / rate_hz;
+
+    HarmonicNotchFilter<Vector3f> vfilter {};
+    HarmonicNotchFilter<float> filters[3] {};
+
+    vfilter.allocate_filters(num_harmonics, harmonics, 2);
+    vfilter.init(rate_hz, 80, 40, 40);
+    for (auto &f : filters) {
+        f.allocate_filters(num_harmonics, harmonics, 2);
+        f.init(rate_hz, 80, 40, 40);
+    }
+
+    for (uint32_t s=0; s<20000; s++) {
+        if (s == 5000) {
+            vfilter.update(120);
+            for (auto &f : filters) {
+                f.update(120);
+            }
+        }
+        if (s == 12000) {
+            vfilter.reset();
+            for (auto &f : filters) {
+                f.reset();
+            }
+        }
+        const double t = s * dt;
+        const Vector3f sample(sin(95 * t * 2 * M_PI),
+                              0.5 * sin(240 * t * 2 * M_PI) + 0.2,
+                              cos(17 * t * 2 * M_PI) - 0.3 * sin(370 * t * 2 * M_PI));
+        const Vector3f v = vfilter.apply(sample);
+        EXPECT_FLOAT_EQ(v.x, filters[0].apply(sample.x));
+        EXPECT_FLOAT_EQ(v.y, filters[1].apply(sample.y));
+        EXPECT_FLOAT_EQ(v.z, filters[2].apply(sample.z));
+    }
+}
+
 AP_GTEST_MAIN()
@@ -26,11 +26,25 @@ extern const AP_HAL::HAL& hal;
 assert_storage_size<GCS::statustext_t, 58> _assert_statustext_t_size;
 #endif
 
+/*
+  the sensor flags are gathered from all of the sensor libraries, and
+  are wanted by SYS_STATUS on every link and by the RC telemetry. They
+  are reworked at most every SENSOR_STATUS_FLAGS_MAX_AGE_MS, so the
+  links sent to in one pass of update_send() share the same result
+ */
+#define SENSOR_STATUS_FLAGS_MAX_AGE_MS 50
+
 void GCS::get_sensor_status_flags(uint32_t &present,
                                   uint32_t &enabled,
                                   uint32_t &health)
 {
-    update_sensor_status_flags();
+    const uint32_t now_ms = AP_HAL::millis();
+    if (!sensor_status_flags_valid ||
+        now_ms - sensor_status_flags_update_ms >= SENSOR_STATUS_FLAGS_MAX_AGE_MS) {
+        update_sensor_status_flags();
+        sensor_status_flags_update_ms = now_ms;
+        sensor_status_flags_valid = true;
+    }
 
     present = control_sensors_present;
     enabled = control_sensors_enabled;
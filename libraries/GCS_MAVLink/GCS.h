@@ -119,6 +119,12 @@ public:
 
     // saveable rate of each stream
     AP_Int16        streamRates[GCS_MAVLINK_NUM_STREAM_RATES];
+
+    // scale stream rates to the measured link capacity
+    AP_Int8         adaptive_rates;
+
+    // parse incoming MAVLink in the receive thread
+    AP_Int8         rx_thread;
 };
 
 #if HAL_MAVLINK_INTERVALS_FROM_FILES_ENABLED
@@ -457,6 +463,8 @@ protected:
 
     // saveable rate of each stream
     AP_Int16        *streamRates;
+    AP_Int8         *adaptive_rates;
+    AP_Int8         *rx_thread;
 
     void handle_heartbeat(const mavlink_message_t &msg) const;
 
@@ -554,8 +562,23 @@ protected:
         int64_t sent_ts1;
         uint32_t last_sent_ms;
         const uint16_t interval_ms = 10000;
+        // faster requests while vision data is arriving, to keep the
+        // clock offset below fresh
+        const uint16_t vision_interval_ms = 1000;
     }  _timesync_request;
 
+    // clock offset of the system answering our timesync requests,
+    // used to place its vision timestamps on our clock
+    struct {
+        int64_t offset_us;          // remote clock minus local clock
+        uint32_t last_update_ms;
+        uint8_t sysid;
+        bool valid;
+    } _timesync_offset;
+    void update_timesync_offset(uint8_t sysid, int64_t offset_us, uint64_t round_trip_time_us);
+    // when we last got vision data on this link
+    uint32_t _vision_last_ms;
+
     void handle_statustext(const mavlink_message_t &msg) const;
     void handle_named_value(const mavlink_message_t &msg) const;
 
@@ -661,6 +684,12 @@ protected:
      */
     uint32_t correct_offboard_timestamp_usec_to_ms(uint64_t offboard_usec, uint16_t payload_size);
 
+    /*
+      as above for vision data, using the clock offset from timesync
+      with the sending system when there is one
+     */
+    uint32_t correct_vision_timestamp_usec_to_ms(uint64_t offboard_usec, uint16_t payload_size, uint8_t sysid);
+
     // converts a COMMAND_LONG packet to a COMMAND_INT packet, where
     // the command-long packet is assumed to be in the supplied frame.
     // If location is not present in the command then just omit frame.
@@ -723,6 +752,31 @@ private:
     // last reported radio buffer percent available
     uint8_t          last_txbuf = 100;
 
+    // priority of a streamed message when the link is congested
+    enum class StreamPriority : uint8_t {
+        CRITICAL = 0,   // slowed least
+        NORMAL = 1,
+        LOW = 2,        // slowed most
+    };
+    static StreamPriority stream_priority(ap_message id);
+
+    /*
+      adaptive stream rates, scaling bucket intervals by priority
+      according to the measured link congestion. A scale of
+      adaptive_scale_one sends at the configured rates
+     */
+    static const uint16_t adaptive_scale_one = 16;
+    static const uint16_t adaptive_scale_max = 16*adaptive_scale_one;
+    struct {
+        uint32_t last_update_ms;
+        uint32_t stream_bytes;      // bytes sent from buckets since the last update
+        uint16_t last_out_of_space; // out_of_space_to_send_count at the last update
+        uint16_t max_txspace;
+        uint16_t scale = adaptive_scale_one;
+    } adaptive_streams;
+    void update_adaptive_streams();
+    uint16_t adaptive_interval_scale(StreamPriority priority) const;
+
     // outbound ("deferred message") queue.
 
     // "special" messages such as heartbeat, next_param etc are stored
@@ -750,6 +804,7 @@ private:
         Bitmask<MSG_LAST> ap_message_ids;
         uint16_t interval_ms;
         uint16_t last_sent_ms; // from AP_HAL::millis16()
+        StreamPriority priority; // highest priority of ap_message_ids
     };
     deferred_message_bucket_t deferred_message_bucket[10];
     static const uint8_t no_bucket_to_send = -1;
@@ -760,6 +815,7 @@ private:
     ap_message next_deferred_bucket_message_to_send(uint16_t now16_ms);
     void find_next_bucket_to_send(uint16_t now16_ms);
     void remove_message_from_bucket(int8_t bucket, ap_message id);
+    void update_bucket_priority(deferred_message_bucket_t &bucket);
 
     // bitmask of IDs the code has spontaneously decided it wants to
     // send out.  Examples include HEARTBEAT (gcs_send_heartbeat)
@@ -904,19 +960,41 @@ private:
         Write,
     };
 
+    struct ftp_session {
+        int fd = -1;
+        FTP_FILE_MODE mode; // work around AP_Filesystem not supporting file modes
+        int16_t id = -1;
+        uint8_t sysid;
+        uint8_t compid;
+        bool read_ahead;    // reads may be buffered, false for files that need a fixed read size
+        uint32_t file_ofs;  // offset of fd, to skip seeks for sequential IO
+        uint32_t last_ms;   // last request for this session
+    };
+
     struct ftp_state {
         ObjectBuffer<pending_ftp> *requests;
 
-        // session specific info, currently only support a single session over all links
-        int fd = -1;
-        FTP_FILE_MODE mode; // work around AP_Filesystem not supporting file modes
-        int16_t current_session;
+        // sessions with an open file, shared by all links
+        ftp_session sessions[AP_MAVLINK_FTP_MAX_SESSIONS];
+
+#if AP_MAVLINK_FTP_READ_AHEAD > 0
+        uint8_t *read_ahead;
+        const ftp_session *read_ahead_session;
+        uint32_t read_ahead_ofs;
+        uint16_t read_ahead_len;
+#endif
+
         uint32_t last_send_ms;
         uint8_t need_banner_send_mask;
     };
     static struct ftp_state ftp;
 
     static void ftp_error(struct pending_ftp &response, FTP_ERROR error); // FTP helper method for packing a NAK
+    static ftp_session *ftp_find_session(const pending_ftp &request);
+    static ftp_session *ftp_open_session(const pending_ftp &request, pending_ftp &reply, uint32_t now);
+    static void ftp_close_session(ftp_session &session);
+    static bool ftp_seek(ftp_session &session, uint32_t offset);
+    static ssize_t ftp_read(ftp_session &session, uint32_t offset, uint8_t *data, uint8_t len);
     static int gen_dir_entry(char *dest, size_t space, const char * path, const struct dirent * entry); // FTP helper for emitting a dir response
     static void ftp_list_dir(struct pending_ftp &request, struct pending_ftp &response);
 
@@ -948,7 +1026,8 @@ private:
                                                      const float yaw,
                                                      const float covariance[21],
                                                      const uint8_t reset_counter,
-                                                     const uint16_t payload_size);
+                                                     const uint16_t payload_size,
+                                                     const uint8_t sysid);
     void handle_vision_speed_estimate(const mavlink_message_t &msg);
     void handle_landing_target(const mavlink_message_t &msg);
 
@@ -979,6 +1058,29 @@ private:
         bool active;
     } alternative;
 
+    void update_out_protocol(const mavlink_status_t &status);
+
+#if AP_MAVLINK_RX_THREAD_ENABLED
+    /*
+      with SRx_RXTHREAD set, the GCS receive thread parses the link
+      into these queues and the main loop runs the handlers. Flight
+      control messages go in their own queue, which is drained first
+     */
+    struct rx_packet {
+        mavlink_message_t msg;
+        uint8_t status_flags;
+    };
+    ObjectBuffer<rx_packet> *rx_queue_priority;
+    ObjectBuffer<rx_packet> *rx_queue;
+    // held by whichever thread is parsing the link
+    HAL_Semaphore rx_sem;
+    bool rx_threaded;
+
+    bool rx_thread_parse(void);
+    void rx_queue_handle(uint32_t max_time_us);
+    static bool rx_is_priority(uint32_t msgid);
+#endif
+
     JitterCorrection lag_correction;
     
     // we cache the current location and send it even if the AHRS has
@@ -1035,6 +1137,7 @@ public:
             AP_HAL::panic("GCS must be singleton");
 #endif
         }
+        _statustext_queue.semaphore().set_name("GCSText");
     };
 
     static class GCS *get_singleton() {
@@ -1140,6 +1243,11 @@ public:
     // install an alternative protocol handler
     bool install_alternative_protocol(mavlink_channel_t chan, GCS_MAVLINK::protocol_handler_fn_t handler);
 
+#if AP_MAVLINK_RX_THREAD_ENABLED
+    // start the thread that parses links with SRx_RXTHREAD set
+    bool start_rx_thread(void);
+#endif
+
     // get the VFR_HUD throttle
     int16_t get_hud_throttle(void) const { return num_gcs()>0?chan(0)->vfr_hud_throttle():0; }
 
@@ -1193,6 +1301,8 @@ private:
     }
 
     void update_sensor_status_flags();
+    uint32_t sensor_status_flags_update_ms;
+    bool sensor_status_flags_valid;
 
     // time we last saw traffic from our GCS
     uint32_t _sysid_mygcs_last_seen_time_ms;
@@ -1232,6 +1342,12 @@ private:
     // timer called to implement pass-thru
     void passthru_timer();
 
+#if AP_MAVLINK_RX_THREAD_ENABLED
+    // parse links with SRx_RXTHREAD set
+    void rx_thread(void);
+    bool rx_thread_started;
+#endif
+
     // this contains the index of the GCS_MAVLINK backend we will
     // first call update_send on.  It is incremented each time
     // GCS::update_send is called so we don't starve later links of
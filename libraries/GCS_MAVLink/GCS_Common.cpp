@@ -111,6 +111,8 @@ GCS_MAVLINK::GCS_MAVLINK(GCS_MAVLINK_Parameters &parameters,
     _port = &uart;
 
     streamRates = parameters.streamRates;
+    adaptive_rates = &parameters.adaptive_rates;
+    rx_thread = &parameters.rx_thread;
 }
 
 bool GCS_MAVLINK::init(uint8_t instance)
@@ -183,6 +185,18 @@ bool GCS_MAVLINK::init(uint8_t instance)
         is_high_latency_link = true;
     }
 #endif
+
+#if AP_MAVLINK_RX_THREAD_ENABLED
+    if (rx_thread->get()) {
+        rx_queue_priority = new ObjectBuffer<rx_packet>(AP_MAVLINK_RX_QUEUE_LEN);
+        rx_queue = new ObjectBuffer<rx_packet>(AP_MAVLINK_RX_QUEUE_LEN);
+        if (rx_queue_priority != nullptr && rx_queue_priority->get_size() != 0 &&
+            rx_queue != nullptr && rx_queue->get_size() != 0 &&
+            gcs().start_rx_thread()) {
+            rx_threaded = true;
+        }
+    }
+#endif
     return true;
 }
 
@@ -1033,7 +1047,13 @@ uint16_t GCS_MAVLINK::get_reschedule_interval_ms(const deferred_message_bucket_t
 {
     uint32_t interval_ms = deferred.interval_ms;
 
-    interval_ms += stream_slowdown_ms;
+    if (adaptive_rates->get()) {
+        // this replaces the stream slowdown as it also uses the
+        // radio buffer state
+        interval_ms = interval_ms * adaptive_interval_scale(deferred.priority) / adaptive_scale_one;
+    } else {
+        interval_ms += stream_slowdown_ms;
+    }
 
     // slow most messages down if we're transfering parameters or
     // waypoints:
@@ -1057,6 +1077,142 @@ uint16_t GCS_MAVLINK::get_reschedule_interval_ms(const deferred_message_bucket_t
     return interval_ms;
 }
 
+/*
+  priority of a streamed message. Critical messages are slowed least
+  on a congested link so the GCS keeps a usable picture of the
+  vehicle, while bulky sensor and diagnostic streams are slowed most
+ */
+GCS_MAVLINK::StreamPriority GCS_MAVLINK::stream_priority(ap_message id)
+{
+    switch (id) {
+    case MSG_ATTITUDE:
+    case MSG_ATTITUDE_QUATERNION:
+    case MSG_LOCATION:
+    case MSG_SYS_STATUS:
+    case MSG_EXTENDED_SYS_STATE:
+    case MSG_GPS_RAW:
+    case MSG_VFR_HUD:
+    case MSG_CURRENT_WAYPOINT:
+    case MSG_HOME:
+        return StreamPriority::CRITICAL;
+    case MSG_RAW_IMU:
+    case MSG_SCALED_IMU:
+    case MSG_SCALED_IMU2:
+    case MSG_SCALED_IMU3:
+    case MSG_SCALED_PRESSURE:
+    case MSG_SCALED_PRESSURE2:
+    case MSG_SCALED_PRESSURE3:
+    case MSG_SERVO_OUTPUT_RAW:
+    case MSG_RC_CHANNELS:
+    case MSG_RC_CHANNELS_RAW:
+    case MSG_SYSTEM_TIME:
+    case MSG_MEMINFO:
+    case MSG_HWSTATUS:
+    case MSG_MCU_STATUS:
+    case MSG_SIMSTATE:
+    case MSG_SIM_STATE:
+    case MSG_AHRS:
+    case MSG_AHRS2:
+    case MSG_PID_TUNING:
+    case MSG_VIBRATION:
+    case MSG_ESC_TELEMETRY:
+    case MSG_RPM:
+        return StreamPriority::LOW;
+    default:
+        return StreamPriority::NORMAL;
+    }
+}
+
+// a bucket is scheduled at the priority of its most important message
+void GCS_MAVLINK::update_bucket_priority(deferred_message_bucket_t &bucket)
+{
+    bucket.priority = StreamPriority::LOW;
+    for (uint8_t i=0; i<MSG_LAST; i++) {
+        if (!bucket.ap_message_ids.get(i)) {
+            continue;
+        }
+        const StreamPriority p = stream_priority(ap_message(i));
+        if (p < bucket.priority) {
+            bucket.priority = p;
+        }
+    }
+}
+
+/*
+  bucket interval scale for a priority. Critical messages take a
+  quarter of the slowdown and low priority ones twice as much
+ */
+uint16_t GCS_MAVLINK::adaptive_interval_scale(StreamPriority priority) const
+{
+    const uint16_t extra = adaptive_streams.scale - adaptive_scale_one;
+    switch (priority) {
+    case StreamPriority::CRITICAL:
+        return adaptive_scale_one + extra/4;
+    case StreamPriority::NORMAL:
+        break;
+    case StreamPriority::LOW:
+        return adaptive_scale_one + extra*2;
+    }
+    return adaptive_streams.scale;
+}
+
+/*
+  measure link congestion and adjust the stream interval scale. The
+  link is congested if sends are failing, the transmit buffer is
+  filling, the radio reports its buffer filling, or on links without
+  flow control if the streams use more than their share of the
+  bandwidth. The scale grows quickly while congested and shrinks
+  slowly once there is headroom
+ */
+void GCS_MAVLINK::update_adaptive_streams()
+{
+    auto &a = adaptive_streams;
+    if (!adaptive_rates->get()) {
+        a.scale = adaptive_scale_one;
+        return;
+    }
+    const uint32_t now_ms = AP_HAL::millis();
+    const uint32_t dt_ms = now_ms - a.last_update_ms;
+    if (dt_ms < 250) {
+        return;
+    }
+    a.last_update_ms = now_ms;
+
+    const uint16_t space = txspace();
+    a.max_txspace = MAX(a.max_txspace, space);
+
+    bool congested = out_of_space_to_send_count != a.last_out_of_space ||
+                     space < a.max_txspace/4;
+    bool headroom = space > a.max_txspace/4*3;
+    a.last_out_of_space = out_of_space_to_send_count;
+
+    if (now_ms - last_radio_status.received_ms < 3000) {
+        congested |= last_txbuf < 50;
+        headroom &= last_txbuf > 90;
+    }
+
+    if (!have_flow_control()) {
+        // leave 40% of the link for heartbeats, parameters, mission
+        // items and other replies
+        const uint32_t budget = MIN(dt_ms, 1000U) * _port->bw_in_kilobytes_per_second() * 1024 / 1000 * 6 / 10;
+        congested |= a.stream_bytes > budget;
+        headroom &= a.stream_bytes < budget/4*3;
+    }
+    a.stream_bytes = 0;
+
+    if (congested) {
+        a.scale += a.scale/4 + 1;
+        if (a.scale > adaptive_scale_max) {
+            a.scale = adaptive_scale_max;
+        }
+    } else if (headroom && a.scale > adaptive_scale_one) {
+        a.scale -= MAX(a.scale/32, 1);
+        if (a.scale < adaptive_scale_one) {
+            a.scale = adaptive_scale_one;
+        }
+    }
+}
+
 // typical runtime on fmuv3: 5 microseconds for 3 buckets
 void GCS_MAVLINK::find_next_bucket_to_send(uint16_t now16_ms)
 {
@@ -1231,6 +1387,8 @@ void GCS_MAVLINK::update_send()
         deferred_messages_initialised = true;
     }
 
+    update_adaptive_streams();
+
 #if GCS_DEBUG_SEND_MESSAGE_TIMINGS
     uint32_t retry_deferred_body_start = AP_HAL::micros();
 #endif
@@ -1299,9 +1457,11 @@ void GCS_MAVLINK::update_send()
 
         ap_message next = next_deferred_bucket_message_to_send(start16);
         if (next != no_message_to_send) {
+            const uint16_t space = txspace();
             if (!do_try_send_message(next)) {
                 break;
             }
+            adaptive_streams.stream_bytes += space - MIN(txspace(), space);
             bucket_message_ids_to_send.clear(next);
             if (bucket_message_ids_to_send.count() == 0) {
                 // we sent everything in the bucket.  Reschedule it.
@@ -1349,6 +1509,7 @@ void GCS_MAVLINK::update_send()
 void GCS_MAVLINK::remove_message_from_bucket(int8_t bucket, ap_message id)
 {
     deferred_message_bucket[bucket].ap_message_ids.clear(id);
+    update_bucket_priority(deferred_message_bucket[bucket]);
     if (deferred_message_bucket[bucket].ap_message_ids.count() == 0) {
         // bucket empty.  Free it:
         deferred_message_bucket[bucket].interval_ms = 0;
@@ -1471,6 +1632,7 @@ bool GCS_MAVLINK::set_ap_message_interval(enum ap_message id, uint16_t interval_
     }
 
     deferred_message_bucket[closest_bucket].ap_message_ids.set(id);
+    update_bucket_priority(deferred_message_bucket[closest_bucket]);
 
     if (sending_bucket_id == no_bucket_to_send) {
         sending_bucket_id = closest_bucket;
@@ -1497,27 +1659,33 @@ void GCS_MAVLINK::send_message(enum ap_message id)
     pushed_ap_message_ids.set(id);
 }
 
-void GCS_MAVLINK::packetReceived(const mavlink_status_t &status,
-                                 const mavlink_message_t &msg)
+/*
+  if we receive any MAVLink2 packets on a connection currently sending
+  MAVLink1 then switch to sending MAVLink2. Called by whichever thread
+  is parsing the link, as it changes the channel status
+ */
+void GCS_MAVLINK::update_out_protocol(const mavlink_status_t &status)
 {
-    // we exclude radio packets because we historically used this to
-    // make it possible to use the CLI over the radio
-    if (msg.msgid != MAVLINK_MSG_ID_RADIO && msg.msgid != MAVLINK_MSG_ID_RADIO_STATUS) {
-        mavlink_active |= (1U<<(chan-MAVLINK_COMM_0));
-    }
     const auto mavlink_protocol = uartstate->get_protocol();
     if (!(status.flags & MAVLINK_STATUS_FLAG_IN_MAVLINK1) &&
         (status.flags & MAVLINK_STATUS_FLAG_OUT_MAVLINK1) &&
         (mavlink_protocol == AP_SerialManager::SerialProtocol_MAVLink2 ||
          mavlink_protocol == AP_SerialManager::SerialProtocol_MAVLinkHL)) {
-        // if we receive any MAVLink2 packets on a connection
-        // currently sending MAVLink1 then switch to sending
-        // MAVLink2
         mavlink_status_t *cstatus = mavlink_get_channel_status(chan);
         if (cstatus != nullptr) {
             cstatus->flags &= ~MAVLINK_STATUS_FLAG_OUT_MAVLINK1;
         }
     }
+}
+
+void GCS_MAVLINK::packetReceived(const mavlink_status_t &status,
+                                 const mavlink_message_t &msg)
+{
+    // we exclude radio packets because we historically used this to
+    // make it possible to use the CLI over the radio
+    if (msg.msgid != MAVLINK_MSG_ID_RADIO && msg.msgid != MAVLINK_MSG_ID_RADIO_STATUS) {
+        mavlink_active |= (1U<<(chan-MAVLINK_COMM_0));
+    }
     if (!routing.check_and_forward(chan, msg)) {
         // the routing code has indicated we should not handle this packet locally
         return;
@@ -1543,6 +1711,24 @@ GCS_MAVLINK::update_receive(uint32_t max_time_us)
         return;
     }
 
+#if AP_MAVLINK_RX_THREAD_ENABLED
+    /*
+      the receive thread leaves a link with an alternative protocol
+      handler to be parsed here, as the handler expects the main
+      thread. Take the link from the thread while we parse it
+     */
+    bool parse_here = true;
+    if (rx_threaded) {
+        rx_queue_handle(max_time_us);
+        parse_here = alternative.handler != nullptr;
+        if (parse_here) {
+            rx_sem.take_blocking();
+        }
+    }
+#else
+    const bool parse_here = true;
+#endif
+
     // receive new packets
     mavlink_message_t msg;
     mavlink_status_t status;
@@ -1551,7 +1737,7 @@ GCS_MAVLINK::update_receive(uint32_t max_time_us)
 
     status.packet_rx_drop_count = 0;
 
-    const uint16_t nbytes = _port->available();
+    const uint16_t nbytes = parse_here ? _port->available() : 0;
     for (uint16_t i=0; i<nbytes; i++)
     {
         const uint8_t c = (uint8_t)_port->read();
@@ -1582,6 +1768,7 @@ GCS_MAVLINK::update_receive(uint32_t max_time_us)
 
         // Try to get a new message
         if (mavlink_parse_char(chan, c, &msg, &status)) {
+            update_out_protocol(status);
             hal.util->persistent_data.last_mavlink_msgid = msg.msgid;
             packetReceived(status, msg);
             parsed_packet = true;
@@ -1598,11 +1785,20 @@ GCS_MAVLINK::update_receive(uint32_t max_time_us)
         }
     }
 
+#if AP_MAVLINK_RX_THREAD_ENABLED
+    if (rx_threaded && parse_here) {
+        rx_sem.give();
+    }
+#endif
+
     const uint32_t tnow = AP_HAL::millis();
 
     // send a timesync message every 10 seconds; this is for data
-    // collection purposes
-    if (tnow - _timesync_request.last_sent_ms > _timesync_request.interval_ms && !is_private()) {
+    // collection purposes, and every second while vision data is
+    // arriving to track the clock offset of the companion
+    const uint16_t timesync_interval_ms = (_vision_last_ms != 0 && tnow - _vision_last_ms < 5000) ?
+        _timesync_request.vision_interval_ms : _timesync_request.interval_ms;
+    if (tnow - _timesync_request.last_sent_ms > timesync_interval_ms && !is_private()) {
         if (HAVE_PAYLOAD_SPACE(chan, TIMESYNC)) {
             send_timesync();
             _timesync_request.last_sent_ms = tnow;
@@ -1692,6 +1888,95 @@ GCS_MAVLINK::update_receive(uint32_t max_time_us)
 #endif
 }
 
+#if AP_MAVLINK_RX_THREAD_ENABLED
+/*
+  true for messages that control the vehicle, which are handled ahead
+  of bulk data such as obstacle distances, vision and RTCM
+ */
+bool GCS_MAVLINK::rx_is_priority(uint32_t msgid)
+{
+    switch (msgid) {
+    case MAVLINK_MSG_ID_HEARTBEAT:
+    case MAVLINK_MSG_ID_COMMAND_LONG:
+    case MAVLINK_MSG_ID_COMMAND_INT:
+    case MAVLINK_MSG_ID_SET_MODE:
+    case MAVLINK_MSG_ID_MANUAL_CONTROL:
+    case MAVLINK_MSG_ID_RC_CHANNELS_OVERRIDE:
+    case MAVLINK_MSG_ID_SET_POSITION_TARGET_LOCAL_NED:
+    case MAVLINK_MSG_ID_SET_POSITION_TARGET_GLOBAL_INT:
+    case MAVLINK_MSG_ID_SET_ATTITUDE_TARGET:
+    case MAVLINK_MSG_ID_RADIO_STATUS:
+        return true;
+    }
+    return false;
+}
+
+/*
+  parse the bytes waiting on the link into the receive queues. Called
+  from the GCS receive thread, returns true if there was anything to
+  parse
+ */
+bool GCS_MAVLINK::rx_thread_parse(void)
+{
+    if (locked() || alternative.handler != nullptr) {
+        return false;
+    }
+    WITH_SEMAPHORE(rx_sem);
+
+    mavlink_status_t *cstatus = mavlink_get_channel_status(chan);
+    const uint32_t nbytes = _port->available();
+    rx_packet pkt;
+    mavlink_status_t status;
+    for (uint32_t i=0; i<nbytes; i++) {
+        if (rx_queue_priority->space() == 0 && rx_queue->space() == 0) {
+            // the main loop is behind, leave the rest in the UART
+            break;
+        }
+        if (!mavlink_parse_char(chan, (uint8_t)_port->read(), &pkt.msg, &status)) {
+            continue;
+        }
+        update_out_protocol(status);
+        pkt.status_flags = status.flags;
+        ObjectBuffer<rx_packet> *q = rx_is_priority(pkt.msg.msgid) ? rx_queue_priority : rx_queue;
+        if (!q->push(pkt) && cstatus != nullptr) {
+            cstatus->packet_rx_drop_count++;
+        }
+    }
+    return nbytes > 0;
+}
+
+/*
+  run the handlers for messages parsed by the receive thread. All of
+  the flight control messages are handled, then other messages until
+  max_time_us is used
+ */
+void GCS_MAVLINK::rx_queue_handle(uint32_t max_time_us)
+{
+    const uint32_t tstart_us = AP_HAL::micros();
+    const uint32_t now_ms = AP_HAL::millis();
+    mavlink_status_t status {};
+    rx_packet pkt;
+
+    auto handle = [&]() {
+        status.flags = pkt.status_flags;
+        hal.util->persistent_data.last_mavlink_msgid = pkt.msg.msgid;
+        packetReceived(status, pkt.msg);
+        gcs_alternative_active[chan] = false;
+        alternative.last_mavlink_ms = now_ms;
+        hal.util->persistent_data.last_mavlink_msgid = 0;
+    };
+
+    // bounded by the queue length, so a stream of commands can't
+    // keep us here
+    for (uint8_t i=0; i<AP_MAVLINK_RX_QUEUE_LEN && rx_queue_priority->pop(pkt); i++) {
+        handle();
+    }
+    while (AP_HAL::micros() - tstart_us < max_time_us && rx_queue->pop(pkt)) {
+        handle();
+    }
+}
+#endif // AP_MAVLINK_RX_THREAD_ENABLED
+
 /*
   record stats about this link to logger
 */
@@ -2256,6 +2541,40 @@ void GCS::update_receive(void)
     update_passthru();
 }
 
+#if AP_MAVLINK_RX_THREAD_ENABLED
+/*
+  thread parsing the links with SRx_RXTHREAD set. It runs at UART
+  priority, below the main loop
+ */
+void GCS::rx_thread(void)
+{
+    while (true) {
+        bool busy = false;
+        for (uint8_t i=0; i<num_gcs(); i++) {
+            GCS_MAVLINK *c = chan(i);
+            if (c != nullptr && c->rx_threaded && c->rx_thread_parse()) {
+                busy = true;
+            }
+        }
+        // poll faster while data is arriving
+        hal.scheduler->delay_microseconds(busy ? 250 : 1000);
+    }
+}
+
+bool GCS::start_rx_thread(void)
+{
+    if (rx_thread_started) {
+        return true;
+    }
+    if (!hal.scheduler->thread_create(FUNCTOR_BIND_MEMBER(&GCS::rx_thread, void),
+                                      "MAVRX", 2048, AP_HAL::Scheduler::PRIORITY_UART, 0)) {
+        return false;
+    }
+    rx_thread_started = true;
+    return true;
+}
+#endif
+
 void GCS::send_mission_item_reached_message(uint16_t mission_index)
 {
     for (uint8_t i=0; i<num_gcs(); i++) {
@@ -3117,6 +3436,12 @@ void GCS_MAVLINK::handle_timesync(const mavlink_message_t &msg)
             return;
         }
         const uint64_t round_trip_time_us = (timesync_receive_timestamp_ns() - _timesync_request.sent_ts1)*0.001f;
+
+        // the remote system read its clock into tc1 about half way
+        // through the round trip
+        const int64_t offset_us = int64_t(tsync.tc1 / 1000) -
+            int64_t(_timesync_request.sent_ts1 / 1000 + round_trip_time_us / 2);
+        update_timesync_offset(msg.sysid, offset_us, round_trip_time_us);
 #if 0
         gcs().send_text(MAV_SEVERITY_INFO,
                         "timesync response sysid=%u (latency=%fms)",
@@ -3127,13 +3452,14 @@ void GCS_MAVLINK::handle_timesync(const mavlink_message_t &msg)
         if (logger != nullptr) {
             AP::logger().Write(
                 "TSYN",
-                "TimeUS,SysID,RTT",
-                "s-s",
-                "F-F",
-                "QBQ",
+                "TimeUS,SysID,RTT,Ofs",
+                "s-ss",
+                "F-FF",
+                "QBQq",
                 AP_HAL::micros64(),
                 msg.sysid,
-                round_trip_time_us
+                round_trip_time_us,
+                offset_us
                 );
         }
         return;
@@ -3159,6 +3485,32 @@ void GCS_MAVLINK::handle_timesync(const mavlink_message_t &msg)
         );
 }
 
+/*
+  update the clock offset of a system from a timesync response. Only
+  responses with a short round trip are used, as the offset is only
+  known to within half of it
+ */
+#define TIMESYNC_MAX_RTT_US 20000
+#define TIMESYNC_OFFSET_TIMEOUT_MS 5000
+void GCS_MAVLINK::update_timesync_offset(uint8_t sysid, int64_t offset_us, uint64_t round_trip_time_us)
+{
+    if (round_trip_time_us > TIMESYNC_MAX_RTT_US) {
+        return;
+    }
+    const uint32_t now_ms = AP_HAL::millis();
+    if (!_timesync_offset.valid ||
+        _timesync_offset.sysid != sysid ||
+        now_ms - _timesync_offset.last_update_ms > TIMESYNC_OFFSET_TIMEOUT_MS) {
+        _timesync_offset.offset_us = offset_us;
+        _timesync_offset.sysid = sysid;
+        _timesync_offset.valid = true;
+    } else {
+        // smooth out the round trip jitter
+        _timesync_offset.offset_us += (offset_us - _timesync_offset.offset_us) / 4;
+    }
+    _timesync_offset.last_update_ms = now_ms;
+}
+
 /*
  * broadcast a timesync message.  We may get multiple responses to this request.
  */
@@ -3365,7 +3717,7 @@ void GCS_MAVLINK::handle_vision_position_estimate(const mavlink_message_t &msg)
     mavlink_msg_vision_position_estimate_decode(&msg, &m);
 
     handle_common_vision_position_estimate_data(m.usec, m.x, m.y, m.z, m.roll, m.pitch, m.yaw, m.covariance, m.reset_counter,
-                                                PAYLOAD_SIZE(chan, VISION_POSITION_ESTIMATE));
+                                                PAYLOAD_SIZE(chan, VISION_POSITION_ESTIMATE), msg.sysid);
 }
 
 void GCS_MAVLINK::handle_global_vision_position_estimate(const mavlink_message_t &msg)
@@ -3374,7 +3726,7 @@ void GCS_MAVLINK::handle_global_vision_position_estimate(const mavlink_message_t
     mavlink_msg_global_vision_position_estimate_decode(&msg, &m);
 
     handle_common_vision_position_estimate_data(m.usec, m.x, m.y, m.z, m.roll, m.pitch, m.yaw, m.covariance, m.reset_counter,
-                                                PAYLOAD_SIZE(chan, GLOBAL_VISION_POSITION_ESTIMATE));
+                                                PAYLOAD_SIZE(chan, GLOBAL_VISION_POSITION_ESTIMATE), msg.sysid);
 }
 
 void GCS_MAVLINK::handle_vicon_position_estimate(const mavlink_message_t &msg)
@@ -3384,7 +3736,7 @@ void GCS_MAVLINK::handle_vicon_position_estimate(const mavlink_message_t &msg)
 
     // vicon position estimate does not include reset counter
     handle_common_vision_position_estimate_data(m.usec, m.x, m.y, m.z, m.roll, m.pitch, m.yaw, m.covariance, 0,
-                                                PAYLOAD_SIZE(chan, VICON_POSITION_ESTIMATE));
+                                                PAYLOAD_SIZE(chan, VICON_POSITION_ESTIMATE), msg.sysid);
 }
 
 /*
@@ -3416,7 +3768,7 @@ void GCS_MAVLINK::handle_odometry(const mavlink_message_t &msg)
         angErr = cbrtf(sq(m.pose_covariance[15])+sq(m.pose_covariance[18])+sq(m.pose_covariance[20]));
     }
 
-    const uint32_t timestamp_ms = correct_offboard_timestamp_usec_to_ms(m.time_usec, PAYLOAD_SIZE(chan, ODOMETRY));
+    const uint32_t timestamp_ms = correct_vision_timestamp_usec_to_ms(m.time_usec, PAYLOAD_SIZE(chan, ODOMETRY), msg.sysid);
     visual_odom->handle_vision_position_estimate(m.time_usec, timestamp_ms, m.x, m.y, m.z, q, posErr, angErr, m.reset_counter);
 
     // convert velocity vector from FRD to NED frame
@@ -3437,12 +3789,13 @@ void GCS_MAVLINK::handle_common_vision_position_estimate_data(const uint64_t use
                                                               const float yaw,
                                                               const float covariance[21],
                                                               const uint8_t reset_counter,
-                                                              const uint16_t payload_size)
+                                                              const uint16_t payload_size,
+                                                              const uint8_t sysid)
 {
     float posErr = 0;
     float angErr = 0;
     // correct offboard timestamp to be in local ms since boot
-    uint32_t timestamp_ms = correct_offboard_timestamp_usec_to_ms(usec, payload_size);
+    uint32_t timestamp_ms = correct_vision_timestamp_usec_to_ms(usec, payload_size, sysid);
 
     AP_VisualOdom *visual_odom = AP::visualodom();
     if (visual_odom == nullptr) {
@@ -3463,7 +3816,7 @@ void GCS_MAVLINK::handle_att_pos_mocap(const mavlink_message_t &msg)
     mavlink_msg_att_pos_mocap_decode(&msg, &m);
 
     // correct offboard timestamp to be in local ms since boot
-    uint32_t timestamp_ms = correct_offboard_timestamp_usec_to_ms(m.time_usec, PAYLOAD_SIZE(chan, ATT_POS_MOCAP));
+    uint32_t timestamp_ms = correct_vision_timestamp_usec_to_ms(m.time_usec, PAYLOAD_SIZE(chan, ATT_POS_MOCAP), msg.sysid);
    
     AP_VisualOdom *visual_odom = AP::visualodom();
     if (visual_odom == nullptr) {
@@ -3482,7 +3835,7 @@ void GCS_MAVLINK::handle_vision_speed_estimate(const mavlink_message_t &msg)
     mavlink_vision_speed_estimate_t m;
     mavlink_msg_vision_speed_estimate_decode(&msg, &m);
     const Vector3f vel = {m.x, m.y, m.z};
-    uint32_t timestamp_ms = correct_offboard_timestamp_usec_to_ms(m.usec, PAYLOAD_SIZE(chan, VISION_SPEED_ESTIMATE));
+    uint32_t timestamp_ms = correct_vision_timestamp_usec_to_ms(m.usec, PAYLOAD_SIZE(chan, VISION_SPEED_ESTIMATE), msg.sysid);
     visual_odom->handle_vision_speed_estimate(m.usec, timestamp_ms, vel, m.reset_counter);
 }
 #endif  // HAL_VISUALODOM_ENABLED
@@ -4032,6 +4385,12 @@ void GCS_MAVLINK::send_banner()
         send_text(MAV_SEVERITY_INFO, "%s", sysid);
     }
 
+#if AP_PARAM_CHANGE_HISTORY > 0
+    // lets a GCS with a cached parameter list fetch only the changes
+    send_text(MAV_SEVERITY_INFO, "Param gen %u hash %08x",
+              unsigned(AP_Param::generation()), unsigned(AP_Param::storage_hash()));
+#endif
+
     // send RC output mode info if available
     char banner_msg[50];
     if (hal.rcout->get_output_mode_banner(banner_msg, sizeof(banner_msg))) {
@@ -6068,6 +6427,41 @@ uint32_t GCS_MAVLINK::correct_offboard_timestamp_usec_to_ms(uint64_t offboard_us
     return corrected_us / 1000U;
 }
 
+/*
+  correct a vision timestamp into a local timestamp since boot in
+  milliseconds. When we have a recent timesync offset for the sending
+  system its timestamp is mapped straight onto our clock, which
+  removes the transport lag the jitter correction has to assume. A
+  result that isn't between the arrival time and the maximum lag
+  means the timestamps aren't on the clock timesync reported (for
+  instance because the companion already converted them to our
+  time), and the jitter correction is used instead
+ */
+uint32_t GCS_MAVLINK::correct_vision_timestamp_usec_to_ms(uint64_t offboard_usec, uint16_t payload_size, uint8_t sysid)
+{
+    _vision_last_ms = AP_HAL::millis();
+
+    // keep the jitter correction converged for when timesync is lost
+    const uint32_t jitter_ms = correct_offboard_timestamp_usec_to_ms(offboard_usec, payload_size);
+
+    if (!_timesync_offset.valid ||
+        _timesync_offset.sysid != sysid ||
+        _vision_last_ms - _timesync_offset.last_update_ms > TIMESYNC_OFFSET_TIMEOUT_MS) {
+        return jitter_ms;
+    }
+
+    uint64_t arrival_us = _port->receive_time_constraint_us(payload_size);
+    if (arrival_us == 0) {
+        arrival_us = AP_HAL::micros64();
+    }
+    const int64_t local_us = int64_t(offboard_usec) - _timesync_offset.offset_us;
+    if (local_us > int64_t(arrival_us) ||
+        local_us + 500000 < int64_t(arrival_us)) {
+        return jitter_ms;
+    }
+    return uint64_t(local_us) / 1000U;
+}
+
 /*
   return true if we will accept this packet. Used to implement SYSID_ENFORCE
  */
@@ -43,7 +43,7 @@ bool GCS_MAVLINK::ftp_init(void) {
         return true;
     }
 
-    ftp.requests = new ObjectBuffer<pending_ftp>(5);
+    ftp.requests = new ObjectBuffer<pending_ftp>(AP_MAVLINK_FTP_REQUEST_QUEUE);
     if (ftp.requests == nullptr || ftp.requests->get_size() == 0) {
         goto failed;
     }
@@ -155,6 +155,141 @@ void GCS_MAVLINK::ftp_push_replies(pending_ftp &reply)
     }
 }
 
+/*
+  find the session a request is for, or nullptr if it has no open file
+ */
+GCS_MAVLINK::ftp_session *GCS_MAVLINK::ftp_find_session(const pending_ftp &request)
+{
+    for (auto &session : ftp.sessions) {
+        if (session.fd != -1 && session.id == request.session &&
+            session.sysid == request.sysid && session.compid == request.compid) {
+            return &session;
+        }
+    }
+    return nullptr;
+}
+
+/*
+  allocate a session for a request opening a file. On failure the
+  reply is filled in with the error and nullptr is returned
+ */
+GCS_MAVLINK::ftp_session *GCS_MAVLINK::ftp_open_session(const pending_ftp &request, pending_ftp &reply, uint32_t now)
+{
+    ftp_session *session = ftp_find_session(request);
+    if (session != nullptr) {
+        if (now - session->last_ms > FTP_SESSION_TIMEOUT) {
+            // no activity for 3s, assume client has timed out
+            // receiving open reply, close the file
+            ftp_close_session(*session);
+        } else {
+            // only allow one file to be open per session
+            ftp_error(reply, FTP_ERROR::Fail);
+            return nullptr;
+        }
+    }
+
+    // use a free session, or else replace the longest idle session
+    // if it has timed out
+    ftp_session *idlest = nullptr;
+    for (auto &s : ftp.sessions) {
+        if (s.fd == -1) {
+            return &s;
+        }
+        if (idlest == nullptr || now - s.last_ms > now - idlest->last_ms) {
+            idlest = &s;
+        }
+    }
+    if (idlest != nullptr && now - idlest->last_ms >= FTP_SESSION_TIMEOUT) {
+        ftp_close_session(*idlest);
+        return idlest;
+    }
+    ftp_error(reply, FTP_ERROR::NoSessionsAvailable);
+    return nullptr;
+}
+
+void GCS_MAVLINK::ftp_close_session(ftp_session &session)
+{
+    if (session.fd != -1) {
+        AP::FS().close(session.fd);
+    }
+    session.fd = -1;
+    session.id = -1;
+#if AP_MAVLINK_FTP_READ_AHEAD > 0
+    if (ftp.read_ahead_session == &session) {
+        ftp.read_ahead_session = nullptr;
+    }
+#endif
+}
+
+// seek a session's file, skipping the seek for sequential IO
+bool GCS_MAVLINK::ftp_seek(ftp_session &session, uint32_t offset)
+{
+    if (session.file_ofs == offset) {
+        return true;
+    }
+    if (AP::FS().lseek(session.fd, offset, SEEK_SET) == -1) {
+        session.file_ofs = UINT32_MAX;
+        return false;
+    }
+    session.file_ofs = offset;
+    return true;
+}
+
+/*
+  read file data for a session. Where allowed the file is read in
+  aligned chunks of AP_MAVLINK_FTP_READ_AHEAD bytes, which is much
+  faster than packet sized reads on most filesystems
+ */
+ssize_t GCS_MAVLINK::ftp_read(ftp_session &session, uint32_t offset, uint8_t *data, uint8_t len)
+{
+#if AP_MAVLINK_FTP_READ_AHEAD > 0
+    if (session.read_ahead && ftp.read_ahead == nullptr) {
+        ftp.read_ahead = new uint8_t[AP_MAVLINK_FTP_READ_AHEAD];
+    }
+    if (session.read_ahead && ftp.read_ahead != nullptr) {
+        uint8_t done = 0;
+        while (done < len) {
+            const uint32_t pos = offset + done;
+            if (ftp.read_ahead_session != &session ||
+                pos < ftp.read_ahead_ofs || pos >= ftp.read_ahead_ofs + ftp.read_ahead_len) {
+                const uint32_t chunk_ofs = pos - (pos % AP_MAVLINK_FTP_READ_AHEAD);
+                ftp.read_ahead_session = nullptr;
+                if (!ftp_seek(session, chunk_ofs)) {
+                    return done > 0 ? done : -1;
+                }
+                const ssize_t read_bytes = AP::FS().read(session.fd, ftp.read_ahead, AP_MAVLINK_FTP_READ_AHEAD);
+                if (read_bytes == -1) {
+                    session.file_ofs = UINT32_MAX;
+                    return done > 0 ? done : -1;
+                }
+                session.file_ofs += read_bytes;
+                ftp.read_ahead_session = &session;
+                ftp.read_ahead_ofs = chunk_ofs;
+                ftp.read_ahead_len = read_bytes;
+                if (pos >= chunk_ofs + read_bytes) {
+                    // end of file
+                    break;
+                }
+            }
+            const uint8_t n = MIN(uint32_t(len - done), ftp.read_ahead_ofs + ftp.read_ahead_len - pos);
+            memcpy(&data[done], &ftp.read_ahead[pos - ftp.read_ahead_ofs], n);
+            done += n;
+        }
+        return done;
+    }
+#endif
+    if (!ftp_seek(session, offset)) {
+        return -1;
+    }
+    const ssize_t read_bytes = AP::FS().read(session.fd, data, len);
+    if (read_bytes == -1) {
+        session.file_ofs = UINT32_MAX;
+        return -1;
+    }
+    session.file_ofs += read_bytes;
+    return read_bytes;
+}
+
 void GCS_MAVLINK::ftp_worker(void) {
     pending_ftp request;
     pending_ftp reply = {};
@@ -169,7 +304,7 @@ void GCS_MAVLINK::ftp_worker(void) {
         }
 
         // if it's a rerequest and we still have the last response then send it
-        if ((request.sysid == reply.sysid) && (request.compid = reply.compid) &&
+        if ((request.sysid == reply.sysid) && (request.compid == reply.compid) &&
             (request.session == reply.session) && (request.seq_number + 1 == reply.seq_number)) {
             ftp_push_replies(reply);
             continue;
@@ -191,374 +326,363 @@ void GCS_MAVLINK::ftp_worker(void) {
             continue;
         }
 
-        uint32_t now = AP_HAL::millis();
-
-        // check for session termination
-        if (request.session != ftp.current_session &&
-            (request.opcode == FTP_OP::TerminateSession || request.opcode == FTP_OP::ResetSessions)) {
-            // terminating a different session, just ack
-            reply.opcode = FTP_OP::Ack;
-        } else if (ftp.fd != -1 && request.session != ftp.current_session &&
-                   now - ftp.last_send_ms < FTP_SESSION_TIMEOUT) {
-            // if we have an open file and the session isn't right
-            // then reject. This prevents IO on the wrong file
-            ftp_error(reply, FTP_ERROR::InvalidSession);
-        } else {
-            if (ftp.fd != -1 &&
-                request.session != ftp.current_session &&
-                now - ftp.last_send_ms >= FTP_SESSION_TIMEOUT) {
-                // if a new session appears and the old session has
-                // been idle for more than the timeout then force
-                // close the old session
-                AP::FS().close(ftp.fd);
-                ftp.fd = -1;
-                ftp.current_session = -1;
-            }
-            // dispatch the command as needed
-            switch (request.opcode) {
-                case FTP_OP::None:
-                    reply.opcode = FTP_OP::Ack;
-                    break;
-                case FTP_OP::TerminateSession:
-                case FTP_OP::ResetSessions:
-                    // we already handled this, just listed for completeness
-                    if (ftp.fd != -1) {
-                        AP::FS().close(ftp.fd);
-                        ftp.fd = -1;
-                    }
-                    ftp.current_session = -1;
-                    reply.opcode = FTP_OP::Ack;
-                    break;
-                case FTP_OP::ListDirectory:
-                    ftp_list_dir(request, reply);
-                    break;
-                case FTP_OP::OpenFileRO:
-                    {
-                        // only allow one file to be open per session
-                        if (ftp.fd != -1 && now - ftp.last_send_ms > FTP_SESSION_TIMEOUT) {
-                            // no activity for 3s, assume client has
-                            // timed out receiving open reply, close
-                            // the file
-                            AP::FS().close(ftp.fd);
-                            ftp.fd = -1;
-                            ftp.current_session = -1;
-                        }
-                        if (ftp.fd != -1) {
-                            ftp_error(reply, FTP_ERROR::Fail);
-                            break;
-                        }
+        const uint32_t now = AP_HAL::millis();
 
-                        // sanity check that our the request looks well formed
-                        const size_t file_name_len = strnlen((char *)request.data, sizeof(request.data));
-                        if ((file_name_len != request.size) || (request.size == 0)) {
-                            ftp_error(reply, FTP_ERROR::InvalidDataSize);
-                            break;
-                        }
+        ftp_session *session = nullptr;
+        if (request.opcode != FTP_OP::OpenFileRO &&
+            request.opcode != FTP_OP::OpenFileWO &&
+            request.opcode != FTP_OP::CreateFile) {
+            session = ftp_find_session(request);
+            if (session != nullptr) {
+                session->last_ms = now;
+            }
+        }
 
-                        request.data[sizeof(request.data) - 1] = 0; // ensure the path is null terminated
+        // dispatch the command as needed
+        switch (request.opcode) {
+            case FTP_OP::None:
+                reply.opcode = FTP_OP::Ack;
+                break;
+            case FTP_OP::TerminateSession:
+                if (session != nullptr) {
+                    ftp_close_session(*session);
+                }
+                reply.opcode = FTP_OP::Ack;
+                break;
+            case FTP_OP::ResetSessions:
+                // close every session of the requesting GCS
+                for (auto &s : ftp.sessions) {
+                    if (s.fd != -1 && s.sysid == request.sysid && s.compid == request.compid) {
+                        ftp_close_session(s);
+                    }
+                }
+                reply.opcode = FTP_OP::Ack;
+                break;
+            case FTP_OP::ListDirectory:
+                ftp_list_dir(request, reply);
+                break;
+            case FTP_OP::OpenFileRO:
+                {
+                    // sanity check that our the request looks well formed
+                    const size_t file_name_len = strnlen((char *)request.data, sizeof(request.data));
+                    if ((file_name_len != request.size) || (request.size == 0)) {
+                        ftp_error(reply, FTP_ERROR::InvalidDataSize);
+                        break;
+                    }
 
-                        // get the file size
-                        struct stat st;
-                        if (AP::FS().stat((char *)request.data, &st)) {
-                            ftp_error(reply, FTP_ERROR::FailErrno);
-                            break;
-                        }
-                        const size_t file_size = st.st_size;
+                    request.data[sizeof(request.data) - 1] = 0; // ensure the path is null terminated
 
-                        // actually open the file
-                        ftp.fd = AP::FS().open((char *)request.data, 0);
-                        if (ftp.fd == -1) {
-                            ftp_error(reply, FTP_ERROR::FailErrno);
-                            break;
-                        }
-                        ftp.mode = FTP_FILE_MODE::Read;
-                        ftp.current_session = request.session;
+                    session = ftp_open_session(request, reply, now);
+                    if (session == nullptr) {
+                        break;
+                    }
 
-                        reply.opcode = FTP_OP::Ack;
-                        reply.size = sizeof(uint32_t);
-                        put_le32_ptr(reply.data, (uint32_t)file_size);
+                    // get the file size
+                    struct stat st;
+                    if (AP::FS().stat((char *)request.data, &st)) {
+                        ftp_error(reply, FTP_ERROR::FailErrno);
+                        break;
+                    }
+                    const size_t file_size = st.st_size;
 
-                        // provide compatibility with old protocol banner download
-                        if (strncmp((const char *)request.data, "@PARAM/param.pck", 16) == 0) {
-                            ftp.need_banner_send_mask |= 1U<<reply.chan;
-                        }
+                    // actually open the file
+                    session->fd = AP::FS().open((char *)request.data, 0);
+                    if (session->fd == -1) {
+                        ftp_error(reply, FTP_ERROR::FailErrno);
                         break;
                     }
-                case FTP_OP::ReadFile:
-                    {
-                        // must actually be working on a file
-                        if (ftp.fd == -1) {
-                            ftp_error(reply, FTP_ERROR::FileNotFound);
-                            break;
-                        }
+                    session->mode = FTP_FILE_MODE::Read;
+                    session->id = request.session;
+                    session->sysid = request.sysid;
+                    session->compid = request.compid;
+                    session->file_ofs = 0;
+                    session->last_ms = now;
+                    // virtual files such as @PARAM/param.pck are
+                    // generated for a fixed read size
+                    session->read_ahead = request.data[0] != '@';
 
-                        // must have the file in read mode
-                        if ((ftp.mode != FTP_FILE_MODE::Read)) {
-                            ftp_error(reply, FTP_ERROR::Fail);
-                            break;
-                        }
+                    reply.opcode = FTP_OP::Ack;
+                    reply.size = sizeof(uint32_t);
+                    put_le32_ptr(reply.data, (uint32_t)file_size);
 
-                        // seek to requested offset
-                        if (AP::FS().lseek(ftp.fd, request.offset, SEEK_SET) == -1) {
-                            ftp_error(reply, FTP_ERROR::FailErrno);
-                            break;
-                        }
+                    // provide compatibility with old protocol banner download
+                    if (strncmp((const char *)request.data, "@PARAM/param.pck", 16) == 0) {
+                        ftp.need_banner_send_mask |= 1U<<reply.chan;
+                    }
+                    break;
+                }
+            case FTP_OP::ReadFile:
+                {
+                    // must actually be working on a file
+                    if (session == nullptr) {
+                        ftp_error(reply, FTP_ERROR::FileNotFound);
+                        break;
+                    }
 
-                        // fill the buffer
-                        const ssize_t read_bytes = AP::FS().read(ftp.fd, reply.data, MIN(sizeof(reply.data),request.size));
-                        if (read_bytes == -1) {
-                            ftp_error(reply, FTP_ERROR::FailErrno);
-                            break;
-                        }
-                        if (read_bytes == 0) {
-                            ftp_error(reply, FTP_ERROR::EndOfFile);
-                            break;
-                        }
+                    // must have the file in read mode
+                    if ((session->mode != FTP_FILE_MODE::Read)) {
+                        ftp_error(reply, FTP_ERROR::Fail);
+                        break;
+                    }
 
-                        reply.opcode = FTP_OP::Ack;
-                        reply.offset = request.offset;
-                        reply.size = (uint8_t)read_bytes;
+                    // fill the buffer
+                    const ssize_t read_bytes = ftp_read(*session, request.offset, reply.data, MIN(sizeof(reply.data),request.size));
+                    if (read_bytes == -1) {
+                        ftp_error(reply, FTP_ERROR::FailErrno);
+                        break;
+                    }
+                    if (read_bytes == 0) {
+                        ftp_error(reply, FTP_ERROR::EndOfFile);
                         break;
                     }
-                case FTP_OP::Ack:
-                case FTP_OP::Nack:
-                    // eat these, we just didn't expect them
-                    continue;
+
+                    reply.opcode = FTP_OP::Ack;
+                    reply.offset = request.offset;
+                    reply.size = (uint8_t)read_bytes;
                     break;
-                case FTP_OP::OpenFileWO:
-                case FTP_OP::CreateFile:
-                    {
-                        // only allow one file to be open per session
-                        if (ftp.fd != -1) {
-                            ftp_error(reply, FTP_ERROR::Fail);
-                            break;
-                        }
+                }
+            case FTP_OP::Ack:
+            case FTP_OP::Nack:
+                // eat these, we just didn't expect them
+                continue;
+                break;
+            case FTP_OP::OpenFileWO:
+            case FTP_OP::CreateFile:
+                {
+                    // sanity check that our the request looks well formed
+                    const size_t file_name_len = strnlen((char *)request.data, sizeof(request.data));
+                    if ((file_name_len != request.size) || (request.size == 0)) {
+                        ftp_error(reply, FTP_ERROR::InvalidDataSize);
+                        break;
+                    }
 
-                        // sanity check that our the request looks well formed
-                        const size_t file_name_len = strnlen((char *)request.data, sizeof(request.data));
-                        if ((file_name_len != request.size) || (request.size == 0)) {
-                            ftp_error(reply, FTP_ERROR::InvalidDataSize);
-                            break;
-                        }
+                    request.data[sizeof(request.data) - 1] = 0; // ensure the path is null terminated
 
-                        request.data[sizeof(request.data) - 1] = 0; // ensure the path is null terminated
+                    session = ftp_open_session(request, reply, now);
+                    if (session == nullptr) {
+                        break;
+                    }
 
-                        // actually open the file
-                        ftp.fd = AP::FS().open((char *)request.data,
-                                               (request.opcode == FTP_OP::CreateFile) ? O_WRONLY|O_CREAT|O_TRUNC : O_WRONLY);
-                        if (ftp.fd == -1) {
-                            ftp_error(reply, FTP_ERROR::FailErrno);
-                            break;
-                        }
-                        ftp.mode = FTP_FILE_MODE::Write;
-                        ftp.current_session = request.session;
+                    // actually open the file
+                    session->fd = AP::FS().open((char *)request.data,
+                                                (request.opcode == FTP_OP::CreateFile) ? O_WRONLY|O_CREAT|O_TRUNC : O_WRONLY);
+                    if (session->fd == -1) {
+                        ftp_error(reply, FTP_ERROR::FailErrno);
+                        break;
+                    }
+                    session->mode = FTP_FILE_MODE::Write;
+                    session->id = request.session;
+                    session->sysid = request.sysid;
+                    session->compid = request.compid;
+                    session->file_ofs = 0;
+                    session->last_ms = now;
+                    session->read_ahead = false;
 
-                        reply.opcode = FTP_OP::Ack;
+                    reply.opcode = FTP_OP::Ack;
+                    break;
+                }
+            case FTP_OP::WriteFile:
+                {
+                    // must actually be working on a file
+                    if (session == nullptr) {
+                        ftp_error(reply, FTP_ERROR::FileNotFound);
                         break;
                     }
-                case FTP_OP::WriteFile:
-                    {
-                        // must actually be working on a file
-                        if (ftp.fd == -1) {
-                            ftp_error(reply, FTP_ERROR::FileNotFound);
-                            break;
-                        }
 
-                        // must have the file in write mode
-                        if ((ftp.mode != FTP_FILE_MODE::Write)) {
-                            ftp_error(reply, FTP_ERROR::Fail);
-                            break;
-                        }
+                    // must have the file in write mode
+                    if ((session->mode != FTP_FILE_MODE::Write)) {
+                        ftp_error(reply, FTP_ERROR::Fail);
+                        break;
+                    }
 
-                        // seek to requested offset
-                        if (AP::FS().lseek(ftp.fd, request.offset, SEEK_SET) == -1) {
-                            ftp_error(reply, FTP_ERROR::FailErrno);
-                            break;
-                        }
+                    // seek to requested offset
+                    if (!ftp_seek(*session, request.offset)) {
+                        ftp_error(reply, FTP_ERROR::FailErrno);
+                        break;
+                    }
 
-                        // fill the buffer
-                        const ssize_t write_bytes = AP::FS().write(ftp.fd, request.data, request.size);
-                        if (write_bytes == -1) {
-                            ftp_error(reply, FTP_ERROR::FailErrno);
-                            break;
-                        }
+                    // fill the buffer
+                    const ssize_t write_bytes = AP::FS().write(session->fd, request.data, request.size);
+                    if (write_bytes == -1) {
+                        session->file_ofs = UINT32_MAX;
+                        ftp_error(reply, FTP_ERROR::FailErrno);
+                        break;
+                    }
+                    session->file_ofs += write_bytes;
 
-                        reply.opcode = FTP_OP::Ack;
-                        reply.offset = request.offset;
+                    reply.opcode = FTP_OP::Ack;
+                    reply.offset = request.offset;
+                    break;
+                }
+            case FTP_OP::CreateDirectory:
+                {
+                    // sanity check that our the request looks well formed
+                    const size_t file_name_len = strnlen((char *)request.data, sizeof(request.data));
+                    if ((file_name_len != request.size) || (request.size == 0)) {
+                        ftp_error(reply, FTP_ERROR::InvalidDataSize);
                         break;
                     }
-                case FTP_OP::CreateDirectory:
-                    {
-                        // sanity check that our the request looks well formed
-                        const size_t file_name_len = strnlen((char *)request.data, sizeof(request.data));
-                        if ((file_name_len != request.size) || (request.size == 0)) {
-                            ftp_error(reply, FTP_ERROR::InvalidDataSize);
-                            break;
-                        }
 
-                        request.data[sizeof(request.data) - 1] = 0; // ensure the path is null terminated
+                    request.data[sizeof(request.data) - 1] = 0; // ensure the path is null terminated
 
-                        // actually make the directory
-                        if (AP::FS().mkdir((char *)request.data) == -1) {
-                            ftp_error(reply, FTP_ERROR::FailErrno);
-                            break;
-                        }
+                    // actually make the directory
+                    if (AP::FS().mkdir((char *)request.data) == -1) {
+                        ftp_error(reply, FTP_ERROR::FailErrno);
+                        break;
+                    }
 
-                        reply.opcode = FTP_OP::Ack;
+                    reply.opcode = FTP_OP::Ack;
+                    break;
+                }
+            case FTP_OP::RemoveDirectory:
+            case FTP_OP::RemoveFile:
+                {
+                    // sanity check that our the request looks well formed
+                    const size_t file_name_len = strnlen((char *)request.data, sizeof(request.data));
+                    if ((file_name_len != request.size) || (request.size == 0)) {
+                        ftp_error(reply, FTP_ERROR::InvalidDataSize);
                         break;
                     }
-                case FTP_OP::RemoveDirectory:
-                case FTP_OP::RemoveFile:
-                    {
-                        // sanity check that our the request looks well formed
-                        const size_t file_name_len = strnlen((char *)request.data, sizeof(request.data));
-                        if ((file_name_len != request.size) || (request.size == 0)) {
-                            ftp_error(reply, FTP_ERROR::InvalidDataSize);
-                            break;
-                        }
 
-                        request.data[sizeof(request.data) - 1] = 0; // ensure the path is null terminated
+                    request.data[sizeof(request.data) - 1] = 0; // ensure the path is null terminated
 
-                        // remove the file/dir
-                        if (AP::FS().unlink((char *)request.data) == -1) {
-                            ftp_error(reply, FTP_ERROR::FailErrno);
-                            break;
-                        }
+                    // remove the file/dir
+                    if (AP::FS().unlink((char *)request.data) == -1) {
+                        ftp_error(reply, FTP_ERROR::FailErrno);
+                        break;
+                    }
 
-                        reply.opcode = FTP_OP::Ack;
+                    reply.opcode = FTP_OP::Ack;
+                    break;
+                }
+            case FTP_OP::CalcFileCRC32:
+                {
+                    // sanity check that our the request looks well formed
+                    const size_t file_name_len = strnlen((char *)request.data, sizeof(request.data));
+                    if ((file_name_len != request.size) || (request.size == 0)) {
+                        ftp_error(reply, FTP_ERROR::InvalidDataSize);
                         break;
                     }
-                case FTP_OP::CalcFileCRC32:
-                    {
-                        // sanity check that our the request looks well formed
-                        const size_t file_name_len = strnlen((char *)request.data, sizeof(request.data));
-                        if ((file_name_len != request.size) || (request.size == 0)) {
-                            ftp_error(reply, FTP_ERROR::InvalidDataSize);
-                            break;
-                        }
 
-                        request.data[sizeof(request.data) - 1] = 0; // ensure the path is null terminated
+                    request.data[sizeof(request.data) - 1] = 0; // ensure the path is null terminated
 
-                        // actually open the file
-                        int fd = AP::FS().open((char *)request.data, O_RDONLY);
-                        if (fd == -1) {
+                    // actually open the file
+                    int fd = AP::FS().open((char *)request.data, O_RDONLY);
+                    if (fd == -1) {
+                        ftp_error(reply, FTP_ERROR::FailErrno);
+                        break;
+                    }
+
+                    uint32_t checksum = 0;
+                    ssize_t read_size;
+                    do {
+                        read_size = AP::FS().read(fd, reply.data, sizeof(reply.data));
+                        if (read_size == -1) {
                             ftp_error(reply, FTP_ERROR::FailErrno);
                             break;
                         }
+                        checksum = crc_crc32(checksum, reply.data, MIN((size_t)read_size, sizeof(reply.data)));
+                    } while (read_size > 0);
 
-                        uint32_t checksum = 0;
-                        ssize_t read_size;
-                        do {
-                            read_size = AP::FS().read(fd, reply.data, sizeof(reply.data));
-                            if (read_size == -1) {
-                                ftp_error(reply, FTP_ERROR::FailErrno);
-                                break;
-                            }
-                            checksum = crc_crc32(checksum, reply.data, MIN((size_t)read_size, sizeof(reply.data)));
-                        } while (read_size > 0);
-
-                        AP::FS().close(fd);
-
-                        // reset our scratch area so we don't leak data, and can leverage trimming
-                        memset(reply.data, 0, sizeof(reply.data));
-                        reply.size = sizeof(uint32_t);
-                        put_le32_ptr(reply.data, checksum);
-                        reply.opcode = FTP_OP::Ack;
+                    AP::FS().close(fd);
+
+                    // reset our scratch area so we don't leak data, and can leverage trimming
+                    memset(reply.data, 0, sizeof(reply.data));
+                    reply.size = sizeof(uint32_t);
+                    put_le32_ptr(reply.data, checksum);
+                    reply.opcode = FTP_OP::Ack;
+                    break;
+                }
+case FTP_OP::BurstReadFile:
+                {
+                    const uint16_t max_read = (request.size == 0?sizeof(reply.data):request.size);
+                    // must actually be working on a file
+                    if (session == nullptr) {
+                        ftp_error(reply, FTP_ERROR::FileNotFound);
                         break;
                     }
-                case FTP_OP::BurstReadFile:
-                    {
-                        const uint16_t max_read = (request.size == 0?sizeof(reply.data):request.size);
-                        // must actually be working on a file
-                        if (ftp.fd == -1) {
-                            ftp_error(reply, FTP_ERROR::FileNotFound);
-                            break;
-                        }
 
-                        // must have the file in read mode
-                        if ((ftp.mode != FTP_FILE_MODE::Read)) {
-                            ftp_error(reply, FTP_ERROR::Fail);
-                            break;
+                    // must have the file in read mode
+                    if ((session->mode != FTP_FILE_MODE::Read)) {
+                        ftp_error(reply, FTP_ERROR::Fail);
+                        break;
+                    }
+
+                    /*
+                      calculate a burst delay so that FTP burst
+                      transfer doesn't use more than 1/3 of
+                      available bandwidth on links that don't have
+                      flow control. This reduces the chance of
+                      lost packets a lot, which results in overall
+                      faster transfers
+                     */
+                    uint32_t burst_delay_ms = 0;
+                    if (valid_channel(request.chan)) {
+                        auto *port = mavlink_comm_port[request.chan];
+                        if (port != nullptr && port->get_flow_control() != AP_HAL::UARTDriver::FLOW_CONTROL_ENABLE) {
+                            const uint32_t bw = port->bw_in_kilobytes_per_second();
+                            const uint16_t pkt_size = PAYLOAD_SIZE(request.chan, FILE_TRANSFER_PROTOCOL) - (sizeof(reply.data) - max_read);
+                            burst_delay_ms = 3 * pkt_size / bw;
                         }
+                    }
 
-                        // seek to requested offset
-                        if (AP::FS().lseek(ftp.fd, request.offset, SEEK_SET) == -1) {
+                    // the default window is enough for a full parameter file with max parameters
+                    const uint32_t transfer_size = AP_MAVLINK_FTP_BURST_WINDOW;
+                    for (uint32_t i = 0; (i < transfer_size); i++) {
+                        // fill the buffer
+                        const ssize_t read_bytes = ftp_read(*session, request.offset + i * max_read, reply.data, MIN(sizeof(reply.data), max_read));
+                        if (read_bytes == -1) {
                             ftp_error(reply, FTP_ERROR::FailErrno);
                             break;
                         }
 
-                        /*
-                          calculate a burst delay so that FTP burst
-                          transfer doesn't use more than 1/3 of
-                          available bandwidth on links that don't have
-                          flow control. This reduces the chance of
-                          lost packets a lot, which results in overall
-                          faster transfers
-                         */
-                        uint32_t burst_delay_ms = 0;
-                        if (valid_channel(request.chan)) {
-                            auto *port = mavlink_comm_port[request.chan];
-                            if (port != nullptr && port->get_flow_control() != AP_HAL::UARTDriver::FLOW_CONTROL_ENABLE) {
-                                const uint32_t bw = port->bw_in_kilobytes_per_second();
-                                const uint16_t pkt_size = PAYLOAD_SIZE(request.chan, FILE_TRANSFER_PROTOCOL) - (sizeof(reply.data) - max_read);
-                                burst_delay_ms = 3 * pkt_size / bw;
-                            }
+                        if (read_bytes != sizeof(reply.data)) {
+                            // don't send any old data
+                            memset(reply.data + read_bytes, 0, sizeof(reply.data) - read_bytes);
                         }
 
+                        if (read_bytes == 0) {
+                            ftp_error(reply, FTP_ERROR::EndOfFile);
+                            break;
+                        }
 
-                        // this transfer size is enough for a full parameter file with max parameters
-                        const uint32_t transfer_size = 500;
-                        for (uint32_t i = 0; (i < transfer_size); i++) {
-                            // fill the buffer
-                            const ssize_t read_bytes = AP::FS().read(ftp.fd, reply.data, MIN(sizeof(reply.data), max_read));
-                            if (read_bytes == -1) {
-                                ftp_error(reply, FTP_ERROR::FailErrno);
-                                break;
-                            }
-
-                            if (read_bytes != sizeof(reply.data)) {
-                                // don't send any old data
-                                memset(reply.data + read_bytes, 0, sizeof(reply.data) - read_bytes);
-                            }
-
-                            if (read_bytes == 0) {
-                                ftp_error(reply, FTP_ERROR::EndOfFile);
-                                break;
-                            }
-
-                            reply.opcode = FTP_OP::Ack;
-                            reply.offset = request.offset + i * max_read;
-                            reply.burst_complete = (i == (transfer_size - 1));
-                            reply.size = (uint8_t)read_bytes;
+                        reply.opcode = FTP_OP::Ack;
+                        reply.offset = request.offset + i * max_read;
+                        reply.burst_complete = (i == (transfer_size - 1));
+                        reply.size = (uint8_t)read_bytes;
 
-                            ftp_push_replies(reply);
+                        ftp_push_replies(reply);
 
-                            if (read_bytes < max_read) {
-                                // ensure the NACK which we send next is at the right offset
-                                reply.offset += read_bytes;
-                            }
+                        if (read_bytes < max_read) {
+                            // ensure the NACK which we send next is at the right offset
+                            reply.offset += read_bytes;
+                        }
 
-                            // prep the reply to be used again
-                            reply.seq_number++;
+                        // prep the reply to be used again
+                        reply.seq_number++;
 
-                            hal.scheduler->delay(burst_delay_ms);
-                        }
+                        hal.scheduler->delay(burst_delay_ms);
+                    }
 
-                        if (reply.opcode != FTP_OP::Nack) {
-                            // prevent a duplicate packet send for
-                            // normal replies of burst reads
-                            skip_push_reply = true;
-                        }
-                        break;
+                    if (reply.opcode != FTP_OP::Nack) {
+                        // prevent a duplicate packet send for
+                        // normal replies of burst reads
+                        skip_push_reply = true;
                     }
-                case FTP_OP::TruncateFile:
-                case FTP_OP::Rename:
-                default:
-                    // this was bad data, just nack it
-                    gcs().send_text(MAV_SEVERITY_DEBUG, "Unsupported FTP: %d", static_cast<int>(request.opcode));
-                    ftp_error(reply, FTP_ERROR::Fail);
                     break;
-            }
+                }
+            case FTP_OP::TruncateFile:
+            case FTP_OP::Rename:
+            default:
+                // this was bad data, just nack it
+                gcs().send_text(MAV_SEVERITY_DEBUG, "Unsupported FTP: %d", static_cast<int>(request.opcode));
+                ftp_error(reply, FTP_ERROR::Fail);
+                break;
+        }
+
+        if (session != nullptr && session->fd != -1) {
+            // a long burst must not look like an idle session
+            session->last_ms = AP_HAL::millis();
         }
 
         if (!skip_push_reply) {
@@ -43,6 +43,17 @@ bool gcs_alternative_active[MAVLINK_COMM_NUM_BUFFERS];
 static HAL_Semaphore chan_locks[MAVLINK_COMM_NUM_BUFFERS];
 static bool chan_discard[MAVLINK_COMM_NUM_BUFFERS];
 
+/*
+  transmit buffer space reserved while a channel is locked, so the
+  parts of a message are copied straight into the UART buffer
+ */
+static struct {
+    ByteBuffer::IoVec vec[2];
+    uint8_t num_vec;
+    uint16_t len;
+    uint16_t used;
+} chan_reserve[MAVLINK_COMM_NUM_BUFFERS];
+
 mavlink_system_t mavlink_system = {7,1};
 
 // routing table
@@ -105,6 +116,29 @@ void comm_send_buffer(mavlink_channel_t chan, const uint8_t *buf, uint8_t len)
         // an alternative protocol is active
         return;
     }
+    auto &r = chan_reserve[chan];
+    if (r.num_vec != 0) {
+        if (r.used + len <= r.len) {
+            uint16_t ofs = r.used;
+            for (uint8_t i=0; i<r.num_vec && len > 0; i++) {
+                if (ofs >= r.vec[i].len) {
+                    ofs -= r.vec[i].len;
+                    continue;
+                }
+                const uint16_t n = MIN(uint32_t(len), r.vec[i].len - ofs);
+                memcpy(&r.vec[i].data[ofs], buf, n);
+                r.used += n;
+                buf += n;
+                len -= n;
+                ofs = 0;
+            }
+            return;
+        }
+        // more than the lock size, release what we have and write
+        // the rest normally
+        mavlink_comm_port[chan]->tx_commit(r.used);
+        r.num_vec = 0;
+    }
     const size_t written = mavlink_comm_port[chan]->write(buf, len);
 #if CONFIG_HAL_BOARD == HAL_BOARD_SITL
     if (written < len) {
@@ -119,7 +153,9 @@ void comm_send_buffer(mavlink_channel_t chan, const uint8_t *buf, uint8_t len)
   lock a channel for send
   if there is insufficient space to send size bytes then all bytes
   written to the channel by the mavlink library will be discarded
-  while the lock is held.
+  while the lock is held. Otherwise the space is reserved in the
+  UART transmit buffer if the UART supports it, so the message is
+  written without taking the UART write lock for each part
  */
 void comm_send_lock(mavlink_channel_t chan_m, uint16_t size)
 {
@@ -128,7 +164,12 @@ void comm_send_lock(mavlink_channel_t chan_m, uint16_t size)
     if (mavlink_comm_port[chan]->txspace() < size) {
         chan_discard[chan] = true;
         gcs_out_of_space_to_send(chan_m);
+        return;
     }
+    auto &r = chan_reserve[chan];
+    r.num_vec = mavlink_comm_port[chan]->tx_reserve(r.vec, size);
+    r.len = size;
+    r.used = 0;
 }
 
 /*
@@ -137,6 +178,11 @@ void comm_send_lock(mavlink_channel_t chan_m, uint16_t size)
 void comm_send_unlock(mavlink_channel_t chan_m)
 {
     const uint8_t chan = uint8_t(chan_m);
+    auto &r = chan_reserve[chan];
+    if (r.num_vec != 0) {
+        mavlink_comm_port[chan]->tx_commit(r.used);
+        r.num_vec = 0;
+    }
     chan_discard[chan] = false;
     chan_locks[chan].give();
 }
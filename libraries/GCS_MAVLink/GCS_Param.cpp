@@ -83,8 +83,8 @@ GCS_MAVLINK::queued_param_send()
             _queued_parameter_count,
             _queued_parameter_index);
 
-        _queued_parameter = AP_Param::next_scalar(&_queued_parameter_token, &_queued_parameter_type);
         _queued_parameter_index++;
+        _queued_parameter = AP_Param::next_scalar_indexed(&_queued_parameter_token, _queued_parameter_index, &_queued_parameter_type);
 
         if (AP_HAL::micros() - tstart > 1000) {
             // don't use more than 1ms sending blocks of parameters
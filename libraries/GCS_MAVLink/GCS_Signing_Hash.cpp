@@ -0,0 +1,152 @@
+/*
+  SHA-256 for MAVLink2 signing using the hash peripheral
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "GCS_config.h"
+
+#if AP_MAVLINK_SIGNING_HW_HASH_ENABLED
+
+#include "GCS_MAVLink.h"
+#include <AP_HAL/AP_HAL.h>
+#include <hal.h>
+
+#if !HAL_USE_CRY
+#error "AP_MAVLINK_SIGNING_HW_HASH_ENABLED needs HAL_USE_CRY"
+#endif
+
+extern const AP_HAL::HAL& hal;
+
+// packets are signed and checked from several threads, the
+// peripheral takes one at a time and the others use software
+static HAL_Semaphore hash_sem;
+static bool hash_started;
+
+static const uint32_t sha256_k[64] = {
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+    0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+    0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+    0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+    0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+    0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2,
+};
+
+static inline uint32_t ror32(uint32_t x, uint8_t n)
+{
+    return (x >> n) | (x << (32 - n));
+}
+
+static void sha256_block(uint32_t h[8], const uint8_t *p)
+{
+    uint32_t w[64];
+    for (uint8_t i=0; i<16; i++) {
+        w[i] = (uint32_t(p[4*i]) << 24) | (uint32_t(p[4*i+1]) << 16) | (uint32_t(p[4*i+2]) << 8) | p[4*i+3];
+    }
+    for (uint8_t i=16; i<64; i++) {
+        const uint32_t s0 = ror32(w[i-15], 7) ^ ror32(w[i-15], 18) ^ (w[i-15] >> 3);
+        const uint32_t s1 = ror32(w[i-2], 17) ^ ror32(w[i-2], 19) ^ (w[i-2] >> 10);
+        w[i] = w[i-16] + s0 + w[i-7] + s1;
+    }
+    uint32_t a = h[0], b = h[1], c = h[2], d = h[3], e = h[4], f = h[5], g = h[6], hh = h[7];
+    for (uint8_t i=0; i<64; i++) {
+        const uint32_t t1 = hh + (ror32(e, 6) ^ ror32(e, 11) ^ ror32(e, 25)) + ((e & f) ^ (~e & g)) + sha256_k[i] + w[i];
+        const uint32_t t2 = (ror32(a, 2) ^ ror32(a, 13) ^ ror32(a, 22)) + ((a & b) ^ (a & c) ^ (b & c));
+        hh = g;
+        g = f;
+        f = e;
+        e = d + t1;
+        d = c;
+        c = b;
+        b = a;
+        a = t1 + t2;
+    }
+    h[0] += a; h[1] += b; h[2] += c; h[3] += d;
+    h[4] += e; h[5] += f; h[6] += g; h[7] += hh;
+}
+
+/*
+  software SHA-256, for when the peripheral is busy with another thread
+ */
+static void sha256_soft(const uint8_t *data, uint32_t len, uint8_t out[32])
+{
+    uint32_t h[8] = { 0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a,
+                      0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19 };
+    const uint32_t total = len;
+    while (len >= 64) {
+        sha256_block(h, data);
+        data += 64;
+        len -= 64;
+    }
+    uint8_t last[128] {};
+    memcpy(last, data, len);
+    last[len] = 0x80;
+    const uint8_t nblocks = len < 56 ? 1 : 2;
+    const uint64_t bits = uint64_t(total) * 8;
+    for (uint8_t i=0; i<8; i++) {
+        last[nblocks*64 - 1 - i] = uint8_t(bits >> (8*i));
+    }
+    for (uint8_t i=0; i<nblocks; i++) {
+        sha256_block(h, &last[64*i]);
+    }
+    for (uint8_t i=0; i<8; i++) {
+        out[4*i] = h[i] >> 24;
+        out[4*i+1] = h[i] >> 16;
+        out[4*i+2] = h[i] >> 8;
+        out[4*i+3] = h[i];
+    }
+}
+
+static bool sha256_hw(const uint8_t *data, uint32_t len, uint8_t out[32])
+{
+    if (!hash_sem.take_nonblocking()) {
+        return false;
+    }
+    if (!hash_started) {
+        cryStart(&CRYD1, nullptr);
+        hash_started = true;
+    }
+    SHA256Context ctx;
+    const bool ret = crySHA256Init(&CRYD1, &ctx) == CRY_NOERROR &&
+        crySHA256Update(&CRYD1, &ctx, len, data) == CRY_NOERROR &&
+        crySHA256Final(&CRYD1, &ctx, out) == CRY_NOERROR;
+    hash_sem.give();
+    return ret;
+}
+
+void mavlink_sha256_init(mavlink_sha256_ctx *m)
+{
+    m->len = 0;
+}
+
+void mavlink_sha256_update(mavlink_sha256_ctx *m, const void *v, uint32_t len)
+{
+    len = MIN(len, sizeof(m->buf) - m->len);
+    memcpy(&m->buf[m->len], v, len);
+    m->len += len;
+}
+
+// the signature is the first 48 bits of the hash
+void mavlink_sha256_final_48(mavlink_sha256_ctx *m, uint8_t result[6])
+{
+    uint8_t hash[32];
+    if (!sha256_hw(m->buf, m->len, hash)) {
+        sha256_soft(m->buf, m->len, hash);
+    }
+    memcpy(result, hash, 6);
+}
+
+#endif // AP_MAVLINK_SIGNING_HW_HASH_ENABLED
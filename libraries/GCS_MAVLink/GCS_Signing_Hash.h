@@ -0,0 +1,28 @@
+#pragma once
+
+/*
+  SHA-256 for MAVLink2 signing, replacing the software implementation
+  in the generated MAVLink headers on boards with a hash peripheral.
+  The signed bytes of a packet are gathered by the update calls and
+  hashed in one submission to the peripheral when the signature is
+  taken, falling back to software when the peripheral is busy or
+  fails
+ */
+
+#include "GCS_config.h"
+
+#if AP_MAVLINK_SIGNING_HW_HASH_ENABLED
+
+#define HAVE_MAVLINK_SHA256
+
+typedef struct {
+    uint16_t len;
+    // key, header, payload, crc, link id and timestamp
+    uint8_t buf[32 + MAVLINK_NUM_HEADER_BYTES + MAVLINK_MAX_PAYLOAD_LEN + MAVLINK_NUM_CHECKSUM_BYTES + 7];
+} mavlink_sha256_ctx;
+
+void mavlink_sha256_init(mavlink_sha256_ctx *m);
+void mavlink_sha256_update(mavlink_sha256_ctx *m, const void *v, uint32_t len);
+void mavlink_sha256_final_48(mavlink_sha256_ctx *m, uint8_t result[6]);
+
+#endif // AP_MAVLINK_SIGNING_HW_HASH_ENABLED
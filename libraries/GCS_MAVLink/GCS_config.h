@@ -10,3 +10,52 @@
 #ifndef AP_MAVLINK_BATTERY2_ENABLED
 #define AP_MAVLINK_BATTERY2_ENABLED 1
 #endif
+
+// compute the SHA-256 of MAVLink2 signing with the hash peripheral
+// through the ChibiOS crypto driver. Needs HAL_USE_CRY and an MCU
+// with a HASH unit, such as the STM32F756 or H753
+#ifndef AP_MAVLINK_SIGNING_HW_HASH_ENABLED
+#define AP_MAVLINK_SIGNING_HW_HASH_ENABLED 0
+#endif
+
+// allow links to be parsed in a receive thread (SRx_RXTHREAD),
+// leaving only the message handlers to the main loop
+#ifndef AP_MAVLINK_RX_THREAD_ENABLED
+#define AP_MAVLINK_RX_THREAD_ENABLED (HAL_MEM_CLASS >= HAL_MEM_CLASS_500)
+#endif
+
+// depth of each of the two queues of parsed messages per link. Each
+// entry is a full mavlink_message_t of about 300 bytes
+#ifndef AP_MAVLINK_RX_QUEUE_LEN
+#define AP_MAVLINK_RX_QUEUE_LEN 8
+#endif
+
+// number of MAVFTP sessions that may have a file open at once
+#ifndef AP_MAVLINK_FTP_MAX_SESSIONS
+#define AP_MAVLINK_FTP_MAX_SESSIONS 3
+#endif
+
+// depth of the MAVFTP request queue. A GCS may pipeline up to this
+// many requests, such as WriteFile, without waiting for replies
+#ifndef AP_MAVLINK_FTP_REQUEST_QUEUE
+#if HAL_MEM_CLASS >= HAL_MEM_CLASS_500
+#define AP_MAVLINK_FTP_REQUEST_QUEUE 20
+#else
+#define AP_MAVLINK_FTP_REQUEST_QUEUE 5
+#endif
+#endif
+
+// number of packets sent in reply to one BurstReadFile request
+#ifndef AP_MAVLINK_FTP_BURST_WINDOW
+#define AP_MAVLINK_FTP_BURST_WINDOW 500
+#endif
+
+// size of the buffer burst reads use to read ahead of the packets
+// being sent, 0 to read each packet directly from the filesystem
+#ifndef AP_MAVLINK_FTP_READ_AHEAD
+#if HAL_MEM_CLASS >= HAL_MEM_CLASS_300
+#define AP_MAVLINK_FTP_READ_AHEAD 1024
+#else
+#define AP_MAVLINK_FTP_READ_AHEAD 0
+#endif
+#endif
@@ -144,43 +144,35 @@ bool MAVLink_routing::check_and_forward(mavlink_channel_t in_channel, const mavl
         return true;
     }
 
-    // forward on any channels matching the targets
-    bool forwarded = false;
-    bool sent_to_chan[MAVLINK_COMM_NUM_BUFFERS];
-    memset(sent_to_chan, 0, sizeof(sent_to_chan));
-    for (uint8_t i=0; i<num_routes; i++) {
-
-        // Skip if channel is private and the target system or component IDs do not match
-        if ((GCS_MAVLINK::is_private(routes[i].channel)) &&
-            (target_system != routes[i].sysid ||
-             target_component != routes[i].compid)) {
-            continue;
+    // forward on any channels matching the targets. Private channels
+    // only get messages targeted at a route on them
+    const uint16_t private_mask = GCS_MAVLINK::private_channel_mask();
+    uint16_t chan_mask;
+    if (broadcast_system) {
+        chan_mask = route_chan_mask & ~private_mask;
+    } else {
+        const uint16_t exact_mask = target_component == -1 ? 0 :
+            component_routes.get(component_key(target_system, target_component));
+        if (broadcast_component || !match_system) {
+            chan_mask = (system_routes.get(target_system) & ~private_mask) | (exact_mask & private_mask);
+        } else {
+            chan_mask = exact_mask;
         }
+    }
+    chan_mask &= ~(1U<<(in_channel-MAVLINK_COMM_0));
 
-        if (broadcast_system || (target_system == routes[i].sysid &&
-                                 (broadcast_component || 
-                                  target_component == routes[i].compid ||
-                                  !match_system))) {
-
-            if (in_channel != routes[i].channel && !sent_to_chan[routes[i].channel]) {
-                
-                if (comm_get_txspace(routes[i].channel) >= ((uint16_t)msg.len) +
-                    GCS_MAVLINK::packet_overhead_chan(routes[i].channel)) {
 #if ROUTING_DEBUG
-                    ::printf("fwd msg %u from chan %u on chan %u sysid=%d compid=%d\n",
-                             msg.msgid,
-                             (unsigned)in_channel,
-                             (unsigned)routes[i].channel,
-                             (int)target_system,
-                             (int)target_component);
-#endif
-                    _mavlink_resend_uart(routes[i].channel, &msg);
-                }
-                sent_to_chan[routes[i].channel] = true;
-                forwarded = true;
-            }
-        }
+    if (chan_mask != 0) {
+        ::printf("fwd msg %u from chan %u on chan mask 0x%x sysid=%d compid=%d\n",
+                 msg.msgid,
+                 (unsigned)in_channel,
+                 (unsigned)chan_mask,
+                 (int)target_system,
+                 (int)target_component);
     }
+#endif
+    forward(chan_mask, msg);
+    const bool forwarded = chan_mask != 0;
 
     if ((!forwarded && match_system) ||
         broadcast_system) {
@@ -206,29 +198,23 @@ void MAVLink_routing::send_to_components(uint32_t msgid, const char *pkt, uint8_
 
 void MAVLink_routing::send_to_components(const char *pkt, const mavlink_msg_entry_t *entry, const uint8_t pkt_len)
 {
-    bool sent_to_chan[MAVLINK_COMM_NUM_BUFFERS] {};
+    // channels where our system ID has been seen
+    const uint16_t chan_mask = system_routes.get(mavlink_system.sysid);
 
-    // check learned routes
-    for (uint8_t i=0; i<num_routes; i++) {
-        if (routes[i].sysid != mavlink_system.sysid) {
-            // our system ID hasn't been seen on this link
-            continue;
-        }
-        if (sent_to_chan[routes[i].channel]) {
-            // we've already send it on this link
+    for (uint8_t i=0; i<MAVLINK_COMM_NUM_BUFFERS; i++) {
+        if (!(chan_mask & (1U<<i))) {
             continue;
         }
-        if (comm_get_txspace(routes[i].channel) <
-            ((uint16_t)entry->max_msg_len) + GCS_MAVLINK::packet_overhead_chan(routes[i].channel)) {
+        const mavlink_channel_t channel = (mavlink_channel_t)(MAVLINK_COMM_0 + i);
+        if (comm_get_txspace(channel) <
+            ((uint16_t)entry->max_msg_len) + GCS_MAVLINK::packet_overhead_chan(channel)) {
             // it doesn't fit on this channel
             continue;
         }
 #if ROUTING_DEBUG
-        ::printf("send msg %u on chan %u sysid=%u compid=%u\n",
+        ::printf("send msg %u on chan %u\n",
                  entry->msgid,
-                 (unsigned)routes[i].channel,
-                 (unsigned)routes[i].sysid,
-                 (unsigned)routes[i].compid);
+                 (unsigned)channel);
 #endif
 #if CONFIG_HAL_BOARD == HAL_BOARD_SITL
         if (entry->max_msg_len > pkt_len) {
@@ -236,13 +222,14 @@ void MAVLink_routing::send_to_components(const char *pkt, const mavlink_msg_entr
                           entry->max_msg_len, pkt_len);
         }
 #endif
-        _mav_finalize_message_chan_send(routes[i].channel,
+        // each channel has its own sequence number, so this has to
+        // be packed for each channel
+        _mav_finalize_message_chan_send(channel,
                                         entry->msgid,
                                         pkt,
                                         entry->min_msg_len,
                                         MIN(entry->max_msg_len, pkt_len),
                                         entry->crc_extra);
-        sent_to_chan[routes[i].channel] = true;
     }
 }
 
@@ -287,7 +274,6 @@ bool MAVLink_routing::find_by_mavtype_and_compid(uint8_t mavtype, uint8_t compid
 */
 void MAVLink_routing::learn_route(mavlink_channel_t in_channel, const mavlink_message_t &msg)
 {
-    uint8_t i;
     if (msg.sysid == 0) {
         // don't learn routes to the broadcast system
         return;
@@ -304,17 +290,30 @@ void MAVLink_routing::learn_route(mavlink_channel_t in_channel, const mavlink_me
         // should also process them locally.
         return;
     }
-    for (i=0; i<num_routes; i++) {
-        if (routes[i].sysid == msg.sysid &&
-            routes[i].compid == msg.compid &&
-            routes[i].channel == in_channel) {
-            if (routes[i].mavtype == 0 && msg.msgid == MAVLINK_MSG_ID_HEARTBEAT) {
-                routes[i].mavtype = mavlink_msg_heartbeat_get_type(&msg);
+    const uint16_t key = component_key(msg.sysid, msg.compid);
+    const uint16_t chan_bit = 1U<<(in_channel-MAVLINK_COMM_0);
+    if (component_routes.get(key) & chan_bit) {
+        // a known route. Only a heartbeat can tell us more about it
+        if (msg.msgid != MAVLINK_MSG_ID_HEARTBEAT) {
+            return;
+        }
+        for (uint8_t i=0; i<num_routes; i++) {
+            if (routes[i].sysid == msg.sysid &&
+                routes[i].compid == msg.compid &&
+                routes[i].channel == in_channel) {
+                if (routes[i].mavtype == 0) {
+                    routes[i].mavtype = mavlink_msg_heartbeat_get_type(&msg);
+                }
+                break;
             }
-            break;
         }
+        return;
     }
-    if (i == num_routes && i<MAVLINK_MAX_ROUTES) {
+    const uint8_t i = num_routes;
+    if (i<MAVLINK_MAX_ROUTES) {
+        component_routes.add(key, chan_bit);
+        system_routes.add(msg.sysid, chan_bit);
+        route_chan_mask |= chan_bit;
         routes[i].sysid = msg.sysid;
         routes[i].compid = msg.compid;
         routes[i].channel = in_channel;
@@ -349,32 +348,70 @@ void MAVLink_routing::handle_heartbeat(mavlink_channel_t in_channel, const mavli
     mask &= ~no_route_mask;
     
     // mask out channels that are known sources for this sysid/compid
-    for (uint8_t i=0; i<num_routes; i++) {
-        if (routes[i].sysid == msg.sysid && routes[i].compid == msg.compid) {
-            mask &= ~(1U<<((unsigned)(routes[i].channel-MAVLINK_COMM_0)));
+    mask &= ~component_routes.get(component_key(msg.sysid, msg.compid));
+
+#if ROUTING_DEBUG
+    if (mask != 0) {
+        ::printf("fwd HB from chan %u on chan mask 0x%x from sysid=%u compid=%u\n",
+                 (unsigned)in_channel,
+                 (unsigned)mask,
+                 (unsigned)msg.sysid,
+                 (unsigned)msg.compid);
+    }
+#endif
+    forward(mask, msg);
+}
+
+/*
+  send a message unchanged on each channel in chan_mask that has
+  space for it. The message is serialised once for all the channels
+ */
+void MAVLink_routing::forward(uint16_t chan_mask, const mavlink_message_t &msg)
+{
+    uint8_t buf[MAVLINK_MAX_PACKET_LEN];
+    uint16_t len = 0;
+    for (uint8_t i=0; i<MAVLINK_COMM_NUM_BUFFERS; i++) {
+        if (!(chan_mask & (1U<<i))) {
+            continue;
+        }
+        const mavlink_channel_t channel = (mavlink_channel_t)(MAVLINK_COMM_0 + i);
+        if (len == 0) {
+            len = mavlink_msg_to_send_buffer(buf, &msg);
+        }
+        if (comm_get_txspace(channel) < len) {
+            continue;
+        }
+        comm_send_lock(channel, len);
+        // comm_send_buffer() takes up to 255 bytes at a time
+        for (uint16_t ofs=0; ofs<len; ) {
+            const uint8_t n = MIN(len - ofs, 255);
+            comm_send_buffer(channel, &buf[ofs], n);
+            ofs += n;
         }
+        comm_send_unlock(channel);
     }
+}
 
-    if (mask == 0) {
-        // nothing to send to
-        return;
+uint16_t MAVLink_routing::RouteMasks::get(uint16_t key) const
+{
+    for (uint8_t i=0, s=slot_for(key); i<num_slots; i++, s=(s+1)&(num_slots-1)) {
+        if (slots[s].chan_mask == 0) {
+            return 0;
+        }
+        if (slots[s].key == key) {
+            return slots[s].chan_mask;
+        }
     }
+    return 0;
+}
 
-    // send on the remaining channels
-    for (uint8_t i=0; i<MAVLINK_COMM_NUM_BUFFERS; i++) {
-        if (mask & (1U<<i)) {
-            mavlink_channel_t channel = (mavlink_channel_t)(MAVLINK_COMM_0 + i);
-            if (comm_get_txspace(channel) >= ((uint16_t)msg.len) +
-                GCS_MAVLINK::packet_overhead_chan(channel)) {
-#if ROUTING_DEBUG
-                ::printf("fwd HB from chan %u on chan %u from sysid=%u compid=%u\n",
-                         (unsigned)in_channel,
-                         (unsigned)channel,
-                         (unsigned)msg.sysid,
-                         (unsigned)msg.compid);
-#endif
-                _mavlink_resend_uart(channel, &msg);
-            }
+void MAVLink_routing::RouteMasks::add(uint16_t key, uint16_t chan_mask)
+{
+    for (uint8_t i=0, s=slot_for(key); i<num_slots; i++, s=(s+1)&(num_slots-1)) {
+        if (slots[s].chan_mask == 0 || slots[s].key == key) {
+            slots[s].key = key;
+            slots[s].chan_mask |= chan_mask;
+            return;
         }
     }
 }
@@ -50,8 +50,7 @@ public:
     bool find_by_mavtype_and_compid(uint8_t mavtype, uint8_t compid, uint8_t &sysid, mavlink_channel_t &channel) const;
 
 private:
-    // a simple linear routing table. We don't expect to have a lot of
-    // routes, so a scalable structure isn't worthwhile yet.
+    // the learned routes, one per sysid/compid/channel
     uint8_t num_routes;
     struct route {
         uint8_t sysid;
@@ -59,9 +58,42 @@ private:
         mavlink_channel_t channel;
         uint8_t mavtype;
     } routes[MAVLINK_MAX_ROUTES];
-    
+
+    /*
+      open addressed hash table from a key to the mask of channels it
+      has been seen on, so forwarding doesn't need to search the
+      routes. Routes are never removed, so neither are keys
+     */
+    class RouteMasks {
+    public:
+        uint16_t get(uint16_t key) const;
+        void add(uint16_t key, uint16_t chan_mask);
+    private:
+        // a power of 2 with room for every route
+        static const uint8_t num_slots = 32;
+        struct {
+            uint16_t key;
+            uint16_t chan_mask; // zero for an empty slot
+        } slots[num_slots];
+        static_assert(num_slots == 32 && MAVLINK_MAX_ROUTES < num_slots, "RouteMasks too small");
+        static uint8_t slot_for(uint16_t key) {
+            // top 5 bits of a multiplicative hash
+            return uint16_t(key * 40503U) >> 11;
+        }
+    };
+    RouteMasks component_routes; // keyed by sysid<<8|compid
+    RouteMasks system_routes;    // keyed by sysid
+    uint16_t route_chan_mask;    // channels with any route
+
+    static uint16_t component_key(uint8_t sysid, uint8_t compid) {
+        return uint16_t(sysid)<<8 | compid;
+    }
+
     // a channel mask to block routing as required
     uint8_t no_route_mask;
+
+    // send a message unchanged on each channel in chan_mask
+    void forward(uint16_t chan_mask, const mavlink_message_t &msg);
     
     // learn new routes
     void learn_route(mavlink_channel_t in_channel, const mavlink_message_t &msg);
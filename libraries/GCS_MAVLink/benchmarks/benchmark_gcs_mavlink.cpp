@@ -0,0 +1,347 @@
+/*
+  benchmarks of the MAVLink telemetry send path
+
+  Usage: benchmark_gcs_mavlink [benchmark options]
+
+  One link sends to a UART which throws the bytes away. The vehicle's
+  sensors and AHRS are set up but not running, so the numbers are the
+  cost of gathering and packing each message and of the scheduling
+  around it, with no I/O. msgs_per_s is the rate at which messages are
+  packed, in CPU time.
+ */
+
+#include <AP_gbenchmark.h>
+
+#include <AP_HAL/AP_HAL.h>
+#include <AP_AHRS/AP_AHRS.h>
+#include <AP_Arming/AP_Arming.h>
+#include <AP_BattMonitor/AP_BattMonitor.h>
+#include <AP_Logger/AP_Logger.h>
+#include <AP_Param/AP_Param.h>
+#include <AP_Vehicle/AP_Vehicle.h>
+#include <GCS_MAVLink/GCS.h>
+
+#include <vector>
+
+const AP_HAL::HAL& hal = AP_HAL::get_HAL();
+
+/*
+  a UART which accepts everything, keeping only a count of bytes
+ */
+class DiscardUART : public AP_HAL::UARTDriver {
+public:
+    void begin(uint32_t baud) override {}
+    void begin(uint32_t baud, uint16_t rxSpace, uint16_t txSpace) override {}
+    void end() override {}
+    void flush() override {}
+    bool is_initialized() override { return true; }
+    void set_blocking_writes(bool blocking) override {}
+    bool tx_pending() override { return false; }
+
+    uint32_t available() override { return 0; }
+    uint32_t txspace() override { return 8192; }
+    int16_t read() override { return -1; }
+    bool discard_input() override { return true; }
+
+    size_t write(uint8_t c) override {
+        bytes++;
+        return 1;
+    }
+    size_t write(const uint8_t *buffer, size_t size) override {
+        bytes += size;
+        return size;
+    }
+
+    // don't let the parameter download hold back as it would on a radio
+    enum flow_control get_flow_control(void) override { return FLOW_CONTROL_ENABLE; }
+
+    uint64_t bytes;
+};
+
+/*
+  a link that sends using the common GCS_MAVLINK code
+ */
+class GCS_MAVLINK_Bench : public GCS_MAVLINK
+{
+public:
+
+    using GCS_MAVLINK::GCS_MAVLINK;
+
+    void set_chan(mavlink_channel_t _chan) { chan = _chan; }
+
+    // send a message immediately, as update_send does when it is due
+    bool send(ap_message id) { return try_send_message(id); }
+
+    // start sending the parameter list, as for PARAM_REQUEST_LIST
+    void request_param_list() {
+        mavlink_message_t msg {};
+        handle_param_request_list(msg);
+    }
+    bool sending_params() const { return _queued_parameter != nullptr; }
+
+private:
+
+    uint32_t telem_delay() const override { return 0; }
+    void handleMessage(const mavlink_message_t &msg) override {}
+    bool handle_guided_request(AP_Mission::Mission_Command &cmd) override { return true; }
+
+protected:
+
+    uint8_t sysid_my_gcs() const override { return 1; }
+
+    MAV_MODE base_mode() const override { return (MAV_MODE)MAV_MODE_FLAG_CUSTOM_MODE_ENABLED; }
+    MAV_STATE vehicle_system_status() const override { return MAV_STATE_STANDBY; }
+
+    bool set_home_to_current_location(bool _lock) override { return false; }
+    bool set_home(const Location& loc, bool _lock) override { return false; }
+
+    void send_nav_controller_output() const override {};
+    void send_pid_tuning() override {};
+};
+
+class GCS_Bench : public GCS
+{
+public:
+
+    using GCS::GCS;
+
+    void add_link(GCS_MAVLINK_Bench *link) { _chan[_num_gcs++] = link; }
+
+protected:
+
+    uint8_t sysid_this_mav() const override { return 1; }
+
+    // links are added with add_link()
+    GCS_MAVLINK_Bench *new_gcs_mavlink_backend(GCS_MAVLINK_Parameters &params,
+                                               AP_HAL::UARTDriver &uart) override {
+        return nullptr;
+    }
+
+    // there is no scheduler loop to leave time for
+    uint16_t min_loop_time_remaining_for_message_send_us() const override { return 0; }
+
+private:
+    GCS_MAVLINK_CHAN_METHOD_DEFINITIONS(GCS_MAVLINK_Bench);
+
+    MAV_TYPE frame_type() const override { return MAV_TYPE_QUADROTOR; }
+    uint32_t custom_mode() const override { return 0; }
+};
+
+const AP_Param::GroupInfo GCS_MAVLINK_Parameters::var_info[] = {
+    AP_GROUPEND
+};
+
+class DummyVehicle : public AP_Vehicle {
+public:
+    AP_AHRS ahrs{AP_AHRS::FLAG_ALWAYS_USE_EKF};
+    bool set_mode(const uint8_t new_mode, const ModeReason reason) override { return true; };
+    uint8_t get_mode() const override { return 1; };
+    void get_scheduler_tasks(const AP_Scheduler::Task *&tasks, uint8_t &task_count, uint32_t &log_bit) override {};
+    void init_ardupilot() override {};
+    void load_parameters() override {};
+    void init() {
+        BoardConfig.init();
+        ins.init(100);
+        ahrs.init();
+    }
+};
+
+static DummyVehicle vehicle;
+static AP_BattMonitor battery{0, nullptr, nullptr};
+static AP_Arming arming;
+AP_Int32 logger_bitmask;
+static AP_Logger logger{logger_bitmask};
+static GCS_Bench _gcs;
+
+class Parameters {
+public:
+    enum {
+        k_param_battery = 1,
+    };
+};
+
+// the battery parameters give PARAM_VALUE bursts something to send
+const struct AP_Param::Info var_info[] = {
+    { "BATT", (const void *)&battery, {group_info : AP_BattMonitor::var_info}, 0, Parameters::k_param_battery, AP_PARAM_GROUP },
+    AP_VAREND
+};
+
+static AP_Param param{var_info};
+
+static DiscardUART uart;
+static GCS_MAVLINK_Parameters link_params;
+static GCS_MAVLINK_Bench link{link_params, uart};
+
+// the heaviest of the messages a vehicle streams by default
+static const ap_message heavy_messages[] {
+    MSG_HEARTBEAT,
+    MSG_SYS_STATUS,
+    MSG_POWER_STATUS,
+    MSG_MEMINFO,
+    MSG_ATTITUDE,
+    MSG_LOCATION,
+    MSG_VFR_HUD,
+    MSG_GPS_RAW,
+    MSG_RAW_IMU,
+    MSG_SCALED_PRESSURE,
+    MSG_BATTERY_STATUS,
+};
+
+// mavlink sequence number of the link, to count messages sent
+static uint8_t tx_seq(void)
+{
+    return mavlink_get_channel_status(MAVLINK_COMM_0)->current_tx_seq;
+}
+
+/*
+  cost of gathering and packing one message
+ */
+static void BM_SendMessage(benchmark::State &state, ap_message id)
+{
+    uint64_t sent = 0;
+    const uint64_t bytes0 = uart.bytes;
+    for (auto _ : state) {
+        const uint8_t seq0 = tx_seq();
+        link.send(id);
+        sent += uint8_t(tx_seq() - seq0);
+    }
+    if (sent == 0) {
+        state.SkipWithError("message not sent");
+        return;
+    }
+    state.counters["msgs_per_s"] = benchmark::Counter(sent, benchmark::Counter::kIsRate);
+    state.counters["bytes_per_msg"] = double(uart.bytes - bytes0) / sent;
+}
+
+BENCHMARK_CAPTURE(BM_SendMessage, HEARTBEAT, MSG_HEARTBEAT);
+BENCHMARK_CAPTURE(BM_SendMessage, SYS_STATUS, MSG_SYS_STATUS);
+BENCHMARK_CAPTURE(BM_SendMessage, GLOBAL_POSITION_INT, MSG_LOCATION);
+BENCHMARK_CAPTURE(BM_SendMessage, BATTERY_STATUS, MSG_BATTERY_STATUS);
+BENCHMARK_CAPTURE(BM_SendMessage, ATTITUDE, MSG_ATTITUDE);
+
+/*
+  update_send() with all of the heavy messages pushed for sending, so
+  every call packs a full set
+ */
+static void BM_UpdateSendAll(benchmark::State &state)
+{
+    uint64_t sent = 0;
+    for (auto _ : state) {
+        for (const auto id : heavy_messages) {
+            link.send_message(id);
+        }
+        const uint8_t seq0 = tx_seq();
+        link.update_send();
+        sent += uint8_t(tx_seq() - seq0);
+    }
+    state.counters["msgs_per_s"] = benchmark::Counter(sent, benchmark::Counter::kIsRate);
+    state.counters["msgs_per_call"] = benchmark::Counter(sent, benchmark::Counter::kAvgIterations);
+}
+BENCHMARK(BM_UpdateSendAll);
+
+/*
+  a full PARAM_VALUE download, as queued_param_send() is called from
+  the vehicle loop
+ */
+static void BM_ParamBurst(benchmark::State &state)
+{
+    uint64_t sent = 0;
+    for (auto _ : state) {
+        state.PauseTiming();
+        link.request_param_list();
+        state.ResumeTiming();
+        while (link.sending_params()) {
+            const uint8_t seq0 = tx_seq();
+            link.queued_param_send();
+            sent += uint8_t(tx_seq() - seq0);
+        }
+    }
+    state.counters["msgs_per_s"] = benchmark::Counter(sent, benchmark::Counter::kIsRate);
+    state.counters["params"] = benchmark::Counter(sent, benchmark::Counter::kAvgIterations);
+}
+BENCHMARK(BM_ParamBurst)->Unit(benchmark::kMicrosecond);
+
+/*
+  update_send() called continuously with the heavy messages streaming
+  at typical rates, so most calls find nothing due. Time per call is
+  mostly the deferred message and bucket scheduling
+ */
+static void BM_UpdateSendStreaming(benchmark::State &state)
+{
+    static const struct {
+        uint32_t msg_id;
+        uint16_t rate_hz;
+    } streams[] {
+        { MAVLINK_MSG_ID_HEARTBEAT, 1 },
+        { MAVLINK_MSG_ID_SYS_STATUS, 2 },
+        { MAVLINK_MSG_ID_POWER_STATUS, 2 },
+        { MAVLINK_MSG_ID_MEMINFO, 2 },
+        { MAVLINK_MSG_ID_ATTITUDE, 10 },
+        { MAVLINK_MSG_ID_GLOBAL_POSITION_INT, 5 },
+        { MAVLINK_MSG_ID_VFR_HUD, 5 },
+        { MAVLINK_MSG_ID_GPS_RAW_INT, 2 },
+        { MAVLINK_MSG_ID_RAW_IMU, 10 },
+        { MAVLINK_MSG_ID_SCALED_PRESSURE, 2 },
+        { MAVLINK_MSG_ID_BATTERY_STATUS, 1 },
+    };
+    for (const auto &s : streams) {
+        link.set_message_interval(s.msg_id, 1000000 / s.rate_hz);
+    }
+
+    uint64_t sent = 0;
+    for (auto _ : state) {
+        const uint8_t seq0 = tx_seq();
+        link.update_send();
+        sent += uint8_t(tx_seq() - seq0);
+    }
+    state.counters["msgs_per_call"] = benchmark::Counter(sent, benchmark::Counter::kAvgIterations);
+
+    for (const auto &s : streams) {
+        link.set_message_interval(s.msg_id, -1);
+    }
+}
+BENCHMARK(BM_UpdateSendStreaming)->MinTime(2);
+
+class GCSBenchmark : public AP_HAL::HAL::Callbacks {
+public:
+    void setup() override;
+    void loop() override {}
+};
+
+void GCSBenchmark::setup()
+{
+    uint8_t hal_argc;
+    char * const *hal_argv;
+    hal.util->commandline_arguments(hal_argc, hal_argv);
+
+    // google benchmark removes the options it understands
+    std::vector<char*> args(hal_argv, hal_argv + hal_argc);
+    int argc = hal_argc;
+    benchmark::Initialize(&argc, args.data());
+
+    vehicle.init();
+    if (!AP_Param::setup()) {
+        ::printf("AP_Param::setup failed\n");
+        exit(1);
+    }
+    // an analog monitor, so BATTERY_STATUS has an instance to report
+    AP_Param::set_by_name("BATT_MONITOR", 4);
+    battery.init();
+
+    gcs().init();
+    mavlink_comm_port[MAVLINK_COMM_0] = &uart;
+    link.set_chan(MAVLINK_COMM_0);
+    _gcs.add_link(&link);
+
+    // telemetry is held back for TELEM_DELAY seconds after boot, which
+    // counts as at least one
+    hal.scheduler->delay(1100);
+    link.update_send();
+
+    benchmark::RunSpecifiedBenchmarks();
+    exit(0);
+}
+
+static GCSBenchmark gcs_benchmark;
+
+AP_HAL_MAIN_CALLBACKS(&gcs_benchmark);
@@ -574,6 +574,10 @@ public:
     // get mask of enabled protocols
     uint32_t enabled_protocols() const;
 
+    // last RC protocol detected, kept across reboots
+    int8_t last_protocol() const { return _protocol_last.get(); }
+    void set_last_protocol(int8_t protocol) { _protocol_last.set_and_save_ifchanged(protocol); }
+
     // returns true if we have had a direct detach RC reciever, does not include overrides
     bool has_had_rc_receiver() const { return _has_had_rc_receiver; }
 
@@ -652,6 +656,7 @@ private:
     AP_Int32  _options;
     AP_Int32  _protocols;
     AP_Float _fs_timeout;
+    AP_Int8  _protocol_last;
 
     RC_Channel *flight_mode_channel() const;
 
@@ -28,6 +28,7 @@ extern const AP_HAL::HAL& hal;
 #include <AP_Logger/AP_Logger.h>
 
 #include "RC_Channel.h"
+#include <AP_Scripting/AP_Scripting.h>
 
 /*
   channels group object constructor
@@ -296,6 +297,10 @@ void RC_Channels::set_aux_cached(RC_Channel::aux_func_t aux_fn, RC_Channel::AuxS
         aux_cached.setonoff(aux_idx*2, v&1);
         aux_cached.setonoff(aux_idx*2+1, v>>1);
     }
+    AP_Scripting *scripting = AP::scripting();
+    if (scripting != nullptr) {
+        scripting->notify_event(AP_Scripting::Event::AUX_FUNCTION, aux_idx);
+    }
 }
 #endif // AP_SCRIPTING_ENABLED
 
@@ -107,5 +107,12 @@ const AP_Param::GroupInfo RC_Channels::var_info[] = {
     // @Units: s
     AP_GROUPINFO_FRAME("_FS_TIMEOUT", 35, RC_CHANNELS_SUBCLASS, _fs_timeout, 1.0, AP_PARAM_FRAME_COPTER),
 
+    // @Param: _PROT_LAST
+    // @DisplayName: Last RC protocol detected
+    // @Description: The RC protocol detected most recently, used to search for the same receiver first after a reboot. -1 if none has been detected
+    // @ReadOnly: True
+    // @User: Advanced
+    AP_GROUPINFO_FLAGS("_PROT_LAST", 36, RC_CHANNELS_SUBCLASS, _protocol_last, -1, AP_PARAM_FLAG_HIDDEN),
+
     AP_GROUPEND
 };
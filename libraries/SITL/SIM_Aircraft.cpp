@@ -609,15 +609,34 @@ void Aircraft::update_dynamics(const Vector3f &rot_accel)
 {
     const float delta_time = frame_time_us * 1.0e-6f;
 
+    /*
+      the second order Adams-Bashforth method blends in the
+      accelerations of the previous step, allowing for a change of
+      step size, so it needs no extra force evaluations. It falls
+      back to Euler for the first step and after ground contact
+     */
+    const bool use_ab2 = sitl != nullptr && sitl->integrator == SIM::INTEGRATOR_ADAMS_BASHFORTH2;
+    float k_now = 1, k_last = 0;
+    if (use_ab2 && integrator_history_valid && is_positive(last_delta_time)) {
+        const float ratio = delta_time / last_delta_time;
+        k_now = 1 + 0.5f * ratio;
+        k_last = -0.5f * ratio;
+    }
+
     // update rotational rates in body frame
-    gyro += rot_accel * delta_time;
+    const Vector3f last_gyro = gyro;
+    gyro += (rot_accel * k_now + last_rot_accel * k_last) * delta_time;
 
     gyro.x = constrain_float(gyro.x, -radians(2000.0f), radians(2000.0f));
     gyro.y = constrain_float(gyro.y, -radians(2000.0f), radians(2000.0f));
     gyro.z = constrain_float(gyro.z, -radians(2000.0f), radians(2000.0f));
 
     // update attitude
-    dcm.rotate(gyro * delta_time);
+    if (use_ab2) {
+        dcm.rotate((gyro + last_gyro) * (0.5f * delta_time));
+    } else {
+        dcm.rotate(gyro * delta_time);
+    }
     dcm.normalize();
 
     Vector3f accel_earth = dcm * accel_body;
@@ -634,11 +653,22 @@ void Aircraft::update_dynamics(const Vector3f &rot_accel)
     accel_body = dcm.transposed() * (accel_earth + Vector3f(0.0f, 0.0f, -GRAVITY_MSS));
 
     // new velocity vector
-    velocity_ef += accel_earth * delta_time;
+    const Vector3f last_velocity_ef = velocity_ef;
+    velocity_ef += (accel_earth * k_now + last_accel_earth * k_last) * delta_time;
 
     const bool was_on_ground = on_ground();
     // new position vector
-    position += (velocity_ef * delta_time).todouble();
+    if (use_ab2) {
+        position += ((velocity_ef + last_velocity_ef) * (0.5f * delta_time)).todouble();
+    } else {
+        position += (velocity_ef * delta_time).todouble();
+    }
+
+    last_rot_accel = rot_accel;
+    last_accel_earth = accel_earth;
+    last_delta_time = delta_time;
+    // ground contact overrides the velocities, so start again from there
+    integrator_history_valid = use_ab2 && !was_on_ground && !on_ground();
 
     // velocity relative to air mass, in earth frame
     velocity_air_ef = velocity_ef - wind_ef;
@@ -302,6 +302,12 @@ private:
     uint64_t last_time_us;
     uint32_t frame_counter;
     uint32_t last_ground_contact_ms;
+
+    // accelerations of the previous step for the second order integrator
+    Vector3f last_rot_accel;
+    Vector3f last_accel_earth;
+    float last_delta_time;
+    bool integrator_history_valid;
 #if defined(__CYGWIN__) || defined(__CYGWIN64__)
     const uint32_t min_sleep_time{20000};
 #else
@@ -535,6 +535,15 @@ void Frame::init(const char *frame_str, Battery *_battery)
                                model.mdrag_coef);
     }
 
+    // compute all motors in one pass when none of them tilt
+    if (motor_array == nullptr) {
+        motor_array = new MotorArray;
+        if (motor_array != nullptr && !motor_array->setup(motors, num_motors)) {
+            delete motor_array;
+            motor_array = nullptr;
+        }
+    }
+
     if (is_zero(model.moment_of_inertia.x) || is_zero(model.moment_of_inertia.y) || is_zero(model.moment_of_inertia.z)) {
         // if no inertia provided, assume 50% of mass on ring around center
         model.moment_of_inertia.x = model.mass * 0.25 * sq(model.diagonal_size*0.5);
@@ -580,16 +589,22 @@ void Frame::calculate_forces(const Aircraft &aircraft,
 
     Vector3f vel_air_bf = aircraft.get_dcm().transposed() * aircraft.get_velocity_air_ef();
 
-    float current = 0;
-    for (uint8_t i=0; i<num_motors; i++) {
-        Vector3f mtorque, mthrust;
-        motors[i].calculate_forces(input, motor_offset, mtorque, mthrust, vel_air_bf, gyro, air_density, battery->get_voltage(), use_drag);
-        current += motors[i].get_current();
-        torque += mtorque;
-        thrust += mthrust;
-        // simulate motor rpm
-        if (!is_zero(AP::sitl()->vibe_motor)) {
-            rpm[motor_offset+i] = motors[i].get_command() * AP::sitl()->vibe_motor * 60.0f;
+    if (motor_array != nullptr) {
+        motor_array->calculate_forces(motors, input, motor_offset, torque, thrust, vel_air_bf, gyro, air_density, battery->get_voltage(), use_drag);
+    } else {
+        for (uint8_t i=0; i<num_motors; i++) {
+            Vector3f mtorque, mthrust;
+            motors[i].calculate_forces(input, motor_offset, mtorque, mthrust, vel_air_bf, gyro, air_density, battery->get_voltage(), use_drag);
+            torque += mtorque;
+            thrust += mthrust;
+        }
+    }
+
+    // simulate motor rpm
+    const float vibe_motor = AP::sitl()->vibe_motor;
+    if (!is_zero(vibe_motor)) {
+        for (uint8_t i=0; i<num_motors; i++) {
+            rpm[motor_offset+i] = motors[i].get_command() * vibe_motor * 60.0f;
         }
     }
 
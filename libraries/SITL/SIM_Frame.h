@@ -169,6 +169,9 @@ private:
     Battery *battery;
 #endif
 
+    // batched calculation for frames without tilting motors
+    MotorArray *motor_array = nullptr;
+
     // json parsing helpers
 #if USE_PICOJSON
     void parse_float(picojson::value val, const char* label, float &param);
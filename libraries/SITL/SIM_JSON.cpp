@@ -66,6 +66,9 @@ JSON::JSON(const char *frame_str) :
     if (colon) {
         target_ip = colon+1;
     }
+#if HAL_SIM_PHYSICS_SHM_ENABLED
+    use_shm = strncmp(target_ip, "shm", 3) == 0 && (target_ip[3] == 0 || target_ip[3] == ':');
+#endif
 
     for (uint8_t i=0; i<ARRAY_SIZE(sim_defaults); i++) {
     AP_Param::set_default_by_name(sim_defaults[i].name, sim_defaults[i].value);
@@ -84,6 +87,24 @@ JSON::JSON(const char *frame_str) :
 */
 void JSON::set_interface_ports(const char* address, const int port_in, const int port_out)
 {
+#if HAL_SIM_PHYSICS_SHM_ENABLED
+    if (use_shm) {
+        // default to a name based on the control port so that each
+        // instance gets its own segment
+        char name[32];
+        if (target_ip[3] == ':' && target_ip[4] != 0) {
+            strncpy(name, &target_ip[4], sizeof(name)-1);
+            name[sizeof(name)-1] = 0;
+        } else {
+            snprintf(name, sizeof(name), "ap_json_%u", unsigned(port_out));
+        }
+        if (!shm.create(name)) {
+            AP_HAL::panic("JSON: unable to create shared memory %s", name);
+        }
+        return;
+    }
+#endif
+
     sock.set_blocking(false);
     sock.reuseaddress();
 
@@ -107,6 +128,18 @@ void JSON::output_servos(const struct sitl_input &input)
         pkt.pwm[i] = input.servos[i];
     }
 
+#if HAL_SIM_PHYSICS_SHM_ENABLED
+    if (use_shm) {
+        struct ap_physics_shm_servos servos;
+        servos.frame_count = pkt.frame_count;
+        servos.frame_rate = pkt.frame_rate;
+        servos.num_servos = AP_PHYSICS_SHM_MAX_SERVOS;
+        memcpy(servos.pwm, pkt.pwm, sizeof(servos.pwm));
+        shm.send_servos(servos);
+        return;
+    }
+#endif
+
     size_t send_ret = sock.sendto(&pkt, sizeof(pkt), target_ip, control_port);
     if (send_ret != sizeof(pkt)) {
         if (send_ret <= 0) {
@@ -217,10 +250,11 @@ uint32_t JSON::parse_sensors(const char *json)
 }
 
 /*
-    Receive new sensor data from simulator
+    Receive and parse the next JSON sensor message, returning the
+    fields received or zero if there is no new complete message
     This is a blocking function
 */
-void JSON::recv_fdm(const struct sitl_input &input)
+uint32_t JSON::recv_json(const struct sitl_input &input)
 {
     // Receive sensor packet
     ssize_t ret = sock.recv(&sensor_buffer[sensor_buffer_len], sizeof(sensor_buffer)-sensor_buffer_len, UDP_TIMEOUT_MS);
@@ -245,25 +279,25 @@ void JSON::recv_fdm(const struct sitl_input &input)
 
     const uint8_t *p2 = (const uint8_t *)memrchr(sensor_buffer, 0, sensor_buffer_len);
     if (p2 == nullptr || p2 == sensor_buffer) {
-        return;
+        return 0;
     }
 
     const uint8_t *p1 = (const uint8_t *)memrchr(sensor_buffer, 0, p2 - sensor_buffer);
     if (p1 == nullptr) {
-        return;
+        return 0;
     }
 
     const uint32_t received_bitmask = parse_sensors((const char *)(p1+1));
     if (received_bitmask == 0) {
         // did not receive one of the mandatory fields
         printf("Did not contain all mandatory fields\n");
-        return;
+        return 0;
     }
 
     // Must get either attitude or quaternion fields
     if ((received_bitmask & (EULER_ATT | QUAT_ATT)) == 0) {
         printf("Did not receive attitude or quaternion\n");
-        return;
+        return 0;
     }
 
     if (received_bitmask != last_received_bitmask) {
@@ -287,6 +321,82 @@ void JSON::recv_fdm(const struct sitl_input &input)
     memmove(sensor_buffer, p2, sensor_buffer_len - (p2 - sensor_buffer));
     sensor_buffer_len = sensor_buffer_len - (p2 - sensor_buffer);
 
+    return received_bitmask;
+}
+
+#if HAL_SIM_PHYSICS_SHM_ENABLED
+/*
+    Receive the next binary sensor frame from shared memory, returning
+    the fields received in the same form as the JSON parser
+    This is a blocking function
+*/
+uint32_t JSON::recv_shm(const struct sitl_input &input)
+{
+    struct ap_physics_shm_sensors pkt;
+    uint32_t wait_ms = 0;
+    while (!shm.recv_sensors(pkt, UDP_TIMEOUT_MS)) {
+        wait_ms += UDP_TIMEOUT_MS;
+        // resend servos so a restarted simulator picks up again
+        if (wait_ms > 1000) {
+            wait_ms = 0;
+            printf("No shared memory sensor frame received, resending servos\n");
+            output_servos(input);
+        }
+    }
+
+    uint32_t received_bitmask = TIMESTAMP | GYRO | ACCEL_BODY | POSITION | QUAT_ATT | VELOCITY;
+    state.timestamp_s = pkt.timestamp_s;
+    state.imu.gyro = Vector3f(pkt.gyro[0], pkt.gyro[1], pkt.gyro[2]);
+    state.imu.accel_body = Vector3f(pkt.accel_body[0], pkt.accel_body[1], pkt.accel_body[2]);
+    state.position = Vector3d(pkt.position[0], pkt.position[1], pkt.position[2]);
+    state.quaternion = Quaternion(pkt.quaternion[0], pkt.quaternion[1], pkt.quaternion[2], pkt.quaternion[3]);
+    state.velocity = Vector3f(pkt.velocity[0], pkt.velocity[1], pkt.velocity[2]);
+    for (uint8_t i=0; i<ARRAY_SIZE(state.rng); i++) {
+        if ((pkt.fields & (AP_PHYSICS_SHM_FIELD_RNG_1 << i)) != 0) {
+            state.rng[i] = pkt.rng[i];
+            received_bitmask |= RNG_1 << i;
+        }
+    }
+    if ((pkt.fields & AP_PHYSICS_SHM_FIELD_WIND_DIR) != 0) {
+        state.wind_vane_apparent.direction = pkt.windvane_direction;
+        received_bitmask |= WIND_DIR;
+    }
+    if ((pkt.fields & AP_PHYSICS_SHM_FIELD_WIND_SPD) != 0) {
+        state.wind_vane_apparent.speed = pkt.windvane_speed;
+        received_bitmask |= WIND_SPD;
+    }
+    if ((pkt.fields & AP_PHYSICS_SHM_FIELD_AIRSPEED) != 0) {
+        state.airspeed = pkt.airspeed;
+        received_bitmask |= AIRSPEED;
+    }
+    state.no_time_sync = (pkt.fields & AP_PHYSICS_SHM_FIELD_NO_TIME_SYNC) != 0;
+    if (state.no_time_sync) {
+        received_bitmask |= TIME_SYNC;
+    }
+
+    return received_bitmask;
+}
+#endif
+
+/*
+    Receive new sensor data from simulator
+    This is a blocking function
+*/
+void JSON::recv_fdm(const struct sitl_input &input)
+{
+    uint32_t received_bitmask;
+#if HAL_SIM_PHYSICS_SHM_ENABLED
+    if (use_shm) {
+        received_bitmask = recv_shm(input);
+    } else
+#endif
+    {
+        received_bitmask = recv_json(input);
+    }
+    if (received_bitmask == 0) {
+        return;
+    }
+
     accel_body = state.imu.accel_body;
     gyro = state.imu.gyro;
     velocity_ef = state.velocity;
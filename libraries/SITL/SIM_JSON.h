@@ -24,6 +24,7 @@
 
 #include <AP_HAL/utility/Socket.h>
 #include "SIM_Aircraft.h"
+#include "SIM_PhysicsSHM.h"
 
 namespace SITL {
 
@@ -59,11 +60,19 @@ private:
 
     SocketAPM sock;
 
+#if HAL_SIM_PHYSICS_SHM_ENABLED
+    // binary shared memory transport, selected with -f json:shm[:name]
+    bool use_shm;
+    PhysicsSHM shm;
+    uint32_t recv_shm(const struct sitl_input &input);
+#endif
+
     uint32_t frame_counter;
     double last_timestamp_s;
 
     void output_servos(const struct sitl_input &input);
     void recv_fdm(const struct sitl_input &input);
+    uint32_t recv_json(const struct sitl_input &input);
 
     uint32_t parse_sensors(const char *json);
 
@@ -225,3 +225,123 @@ float Motor::calc_thrust(float command, float air_density, float velocity_in, fl
 #endif
     return ret;
 }
+
+/*
+  copy the constants of a set of motors into arrays. Motors that tilt
+  or have no thrust vector need the general per-motor calculation
+ */
+bool MotorArray::setup(const Motor *motors, uint8_t num_motors)
+{
+    if (num_motors == 0 || num_motors > max_motors) {
+        return false;
+    }
+    for (uint8_t i=0; i<num_motors; i++) {
+        const Motor &m = motors[i];
+        if (m.roll_servo >= 0 || m.pitch_servo >= 0 ||
+            m.thrust_vector.is_zero() ||
+            !is_equal(m.voltage_max, motors[0].voltage_max)) {
+            return false;
+        }
+        pos_x[i] = m.position.x;
+        pos_y[i] = m.position.y;
+        pos_z[i] = m.position.z;
+        tvec_x[i] = m.thrust_vector.x;
+        tvec_y[i] = m.thrust_vector.y;
+        tvec_z[i] = m.thrust_vector.z;
+        tvec_inv_length_sq[i] = 1.0f / m.thrust_vector.length_squared();
+        yaw_k[i] = -0.05f * m.diagonal_size * m.yaw_factor;
+        thrust_k[i] = 0.5f * m.effective_prop_area;
+        outflow_max[i] = m.max_outflow_velocity;
+        expo[i] = m.mot_expo;
+        drag_k[i] = m.momentum_drag_coefficient * sqrtf(m.true_prop_area);
+        power_factor[i] = m.power_factor;
+    }
+    count = num_motors;
+    return true;
+}
+
+void MotorArray::calculate_forces(Motor *motors,
+                                  const struct sitl_input &input,
+                                  uint8_t motor_offset,
+                                  Vector3f &torque,
+                                  Vector3f &thrust,
+                                  const Vector3f &velocity_air_bf,
+                                  const Vector3f &gyro,
+                                  float air_density,
+                                  float voltage,
+                                  bool use_drag)
+{
+    torque.zero();
+    thrust.zero();
+
+    const float voltage_scale = voltage / motors[0].voltage_max;
+    if (voltage_scale < 0.1) {
+        // battery is dead
+        for (uint8_t i=0; i<count; i++) {
+            motors[i].current = 0;
+        }
+        return;
+    }
+
+    // commands with the slew limiter, this keeps its state in each motor
+    const uint64_t now_us = AP_HAL::micros64();
+    for (uint8_t i=0; i<count; i++) {
+        Motor &m = motors[i];
+        float c = m.pwm_to_command(input.servos[motor_offset+m.servo]);
+        if (m.last_calc_us != 0 && m.slew_max > 0) {
+            const float slew_max_change = m.slew_max * (now_us - m.last_calc_us)*1.0e-6;
+            c = constrain_float(c, m.last_command-slew_max_change, m.last_command+slew_max_change);
+        }
+        m.last_calc_us = now_us;
+        m.last_command = c;
+        command[i] = c;
+    }
+
+    const float sqrt_air_density = sqrtf(air_density);
+    const float inv_voltage = 1.0f / MAX(voltage, 0.1);
+    float tx = 0, ty = 0, tz = 0;
+    float qx = 0, qy = 0, qz = 0;
+    for (uint8_t i=0; i<count; i++) {
+        // velocity of motor through air, including rotation about the centre
+        const float mvx = velocity_air_bf.x - (pos_y[i]*gyro.z - pos_z[i]*gyro.y);
+        const float mvy = velocity_air_bf.y - (pos_z[i]*gyro.x - pos_x[i]*gyro.z);
+        const float mvz = velocity_air_bf.z - (pos_x[i]*gyro.y - pos_y[i]*gyro.x);
+
+        // velocity into prop, clipping at zero
+        const float along = (mvx*tvec_x[i] + mvy*tvec_y[i] + mvz*tvec_z[i]) * tvec_inv_length_sq[i];
+        const float velocity_in = MAX(0, -along * tvec_z[i]);
+
+        const float c = command[i];
+        const float velocity_out = voltage_scale * outflow_max[i] * sqrtf((1-expo[i])*c + expo[i]*c*c);
+        const float motor_thrust = thrust_k[i] * air_density * (velocity_out*velocity_out - velocity_in*velocity_in);
+
+        float fx = tvec_x[i] * motor_thrust;
+        float fy = tvec_y[i] * motor_thrust;
+        float fz = tvec_z[i] * motor_thrust;
+
+        // arm torque plus the yaw torque of the rotor
+        const float yaw_torque = yaw_k[i] * c * motor_thrust;
+        qx += pos_y[i]*fz - pos_z[i]*fy + tvec_x[i]*yaw_torque;
+        qy += pos_z[i]*fx - pos_x[i]*fz + tvec_y[i]*yaw_torque;
+        qz += pos_x[i]*fy - pos_y[i]*fx + tvec_z[i]*yaw_torque;
+
+        if (use_drag) {
+            // momentum drag, see Motor::calculate_forces()
+            const float k = drag_k[i] * sqrt_air_density;
+            const float sx = sqrtf(fabsf(fx));
+            const float sy = sqrtf(fabsf(fy));
+            const float sz = sqrtf(fabsf(fz));
+            fx -= k * mvx * (sy + sz);
+            fy -= k * mvy * (sx + sz);
+            fz -= k * mvz * (sx + sy + sz);
+        }
+        tx += fx;
+        ty += fy;
+        tz += fz;
+
+        motors[i].current = power_factor[i] * fabsf(motor_thrust) * inv_voltage;
+    }
+
+    torque = Vector3f(qx, qy, qz);
+    thrust = Vector3f(tx, ty, tz);
+}
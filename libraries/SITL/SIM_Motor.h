@@ -123,6 +123,8 @@ public:
     float calc_thrust(float command, float air_density, float velocity_in, float voltage_scale) const;
 
 private:
+    friend class MotorArray;
+
     float mot_pwm_min;
     float mot_pwm_max;
     float mot_spin_min;
@@ -145,4 +147,49 @@ private:
     Vector3f thrust_vector;
 };
 
+/*
+  the motors of a frame that has no tilting motors, with their
+  constants held as a structure of arrays so that the thrust, torque
+  and drag of all motors are computed together in one pass. Gives the
+  same results as calling Motor::calculate_forces() on each motor
+ */
+class MotorArray {
+public:
+    static const uint8_t max_motors = 12;
+
+    // copy the motor constants, false if the motors can't be batched
+    bool setup(const Motor *motors, uint8_t num_motors);
+
+    // sum of the forces of all motors, also updates the motors' command and current
+    void calculate_forces(Motor *motors,
+                          const struct sitl_input &input,
+                          uint8_t motor_offset,
+                          Vector3f &torque, // Newton meters
+                          Vector3f &thrust, // Z is down, Newtons
+                          const Vector3f &velocity_air_bf,
+                          const Vector3f &gyro, // rad/sec
+                          float air_density,
+                          float voltage,
+                          bool use_drag);
+
+private:
+    uint8_t count;
+
+    float pos_x[max_motors];
+    float pos_y[max_motors];
+    float pos_z[max_motors];
+    float tvec_x[max_motors];
+    float tvec_y[max_motors];
+    float tvec_z[max_motors];
+    float tvec_inv_length_sq[max_motors];
+    float yaw_k[max_motors];            // -0.05 * diagonal_size * yaw_factor
+    float thrust_k[max_motors];         // 0.5 * effective_prop_area
+    float outflow_max[max_motors];
+    float expo[max_motors];
+    float drag_k[max_motors];           // momentum_drag_coefficient * sqrt(true_prop_area)
+    float power_factor[max_motors];
+
+    float command[max_motors];
+};
+
 }
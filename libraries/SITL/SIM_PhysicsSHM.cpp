@@ -0,0 +1,147 @@
+/*
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/*
+  shared memory transport for external physics simulators
+ */
+
+#include "SIM_PhysicsSHM.h"
+
+#if HAL_SIM_PHYSICS_SHM_ENABLED
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <time.h>
+#include <unistd.h>
+#ifdef __linux__
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#endif
+
+using namespace SITL;
+
+// wall clock time, SITL's own clock only moves when the physics does
+static uint64_t monotonic_us(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return uint64_t(ts.tv_sec)*1000000ULL + ts.tv_nsec/1000;
+}
+
+bool PhysicsSHM::create(const char *name)
+{
+    char path[64];
+    snprintf(path, sizeof(path), "/%s", name);
+
+    // remove a segment left over from an earlier run. A simulator
+    // attached to that must re-attach, it can tell a restart from
+    // frame_count going back to zero
+    shm_unlink(path);
+    int fd = shm_open(path, O_RDWR|O_CREAT|O_EXCL, 0600);
+    if (fd == -1 || ftruncate(fd, sizeof(struct ap_physics_shm)) != 0) {
+        ::fprintf(stderr, "PhysicsSHM: create %s failed: %s\n", path, strerror(errno));
+        if (fd != -1) {
+            close(fd);
+        }
+        return false;
+    }
+    void *p = mmap(nullptr, sizeof(struct ap_physics_shm), PROT_READ|PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (p == MAP_FAILED) {
+        ::fprintf(stderr, "PhysicsSHM: mmap failed: %s\n", strerror(errno));
+        return false;
+    }
+
+    struct ap_physics_shm *s = (struct ap_physics_shm *)p;
+    memset(s, 0, sizeof(*s));
+    s->version = AP_PHYSICS_SHM_VERSION;
+    s->ring_size = AP_PHYSICS_SHM_RING_SIZE;
+    s->size = sizeof(*s);
+    __atomic_store_n(&s->magic, AP_PHYSICS_SHM_MAGIC, __ATOMIC_RELEASE);
+
+    shm = s;
+    last_sensor_seq = 0;
+    ::printf("PhysicsSHM: waiting for simulator on %s\n", path);
+    return true;
+}
+
+void PhysicsSHM::send_servos(const struct ap_physics_shm_servos &servos)
+{
+    const uint32_t seq = __atomic_load_n(&shm->servo_seq, __ATOMIC_RELAXED);
+    memcpy((void *)&shm->servo_ring[seq % AP_PHYSICS_SHM_RING_SIZE], &servos, sizeof(servos));
+    __atomic_store_n(&shm->servo_seq, seq+1, __ATOMIC_RELEASE);
+    wake(&shm->servo_seq);
+}
+
+bool PhysicsSHM::recv_sensors(struct ap_physics_shm_sensors &sensors, uint32_t timeout_ms)
+{
+    const uint64_t deadline_us = monotonic_us() + timeout_ms*1000ULL;
+    while (true) {
+        const uint32_t seq = __atomic_load_n(&shm->sensor_seq, __ATOMIC_ACQUIRE);
+        if (seq != last_sensor_seq) {
+            memcpy(&sensors, (const void *)&shm->sensor_ring[(seq-1) % AP_PHYSICS_SHM_RING_SIZE], sizeof(sensors));
+            const uint32_t now_seq = __atomic_load_n(&shm->sensor_seq, __ATOMIC_ACQUIRE);
+            if (now_seq - seq >= AP_PHYSICS_SHM_RING_SIZE-1) {
+                // the simulator may have overwritten the slot while we
+                // copied it, take the newest one instead
+                continue;
+            }
+            last_sensor_seq = seq;
+            return true;
+        }
+        const uint64_t now_us = monotonic_us();
+        if (now_us >= deadline_us ||
+            !wait_change(&shm->sensor_seq, seq, (deadline_us - now_us + 999) / 1000)) {
+            return false;
+        }
+    }
+}
+
+bool PhysicsSHM::wait_change(volatile uint32_t *word, uint32_t value, uint32_t timeout_ms)
+{
+#ifdef __linux__
+    struct timespec ts;
+    ts.tv_sec = timeout_ms / 1000;
+    ts.tv_nsec = (timeout_ms % 1000) * 1000000UL;
+    if (syscall(SYS_futex, (uint32_t *)word, FUTEX_WAIT, value, &ts, nullptr, 0) == -1 &&
+        errno == ETIMEDOUT) {
+        return false;
+    }
+    // woken, interrupted or the value had already changed
+    return true;
+#else
+    const uint64_t deadline_us = monotonic_us() + timeout_ms*1000ULL;
+    while (__atomic_load_n(word, __ATOMIC_ACQUIRE) == value) {
+        if (monotonic_us() >= deadline_us) {
+            return false;
+        }
+        usleep(20);
+    }
+    return true;
+#endif
+}
+
+void PhysicsSHM::wake(volatile uint32_t *word)
+{
+#ifdef __linux__
+    syscall(SYS_futex, (uint32_t *)word, FUTEX_WAKE, INT32_MAX, nullptr, nullptr, 0);
+#else
+    (void)word;
+#endif
+}
+
+#endif  // HAL_SIM_PHYSICS_SHM_ENABLED
@@ -0,0 +1,58 @@
+/*
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/*
+  shared memory transport for external physics simulators, see
+  SIM_PhysicsSHM_Protocol.h for the layout
+ */
+#pragma once
+
+#include <AP_HAL/AP_HAL_Boards.h>
+
+#ifndef HAL_SIM_PHYSICS_SHM_ENABLED
+#define HAL_SIM_PHYSICS_SHM_ENABLED (CONFIG_HAL_BOARD == HAL_BOARD_SITL)
+#endif
+
+#if HAL_SIM_PHYSICS_SHM_ENABLED
+
+#include "SIM_PhysicsSHM_Protocol.h"
+
+namespace SITL {
+
+class PhysicsSHM {
+public:
+    // create the named segment for a simulator to attach to
+    bool create(const char *name);
+
+    bool enabled() const { return shm != nullptr; }
+
+    // publish a servo frame and wake the simulator
+    void send_servos(const struct ap_physics_shm_servos &servos);
+
+    // wait up to timeout_ms of wall clock time for a sensor frame
+    // newer than the last one returned
+    bool recv_sensors(struct ap_physics_shm_sensors &sensors, uint32_t timeout_ms);
+
+private:
+    struct ap_physics_shm *shm;
+    uint32_t last_sensor_seq;
+
+    // wait for *word to no longer hold value, false on timeout
+    static bool wait_change(volatile uint32_t *word, uint32_t value, uint32_t timeout_ms);
+    static void wake(volatile uint32_t *word);
+};
+
+}
+
+#endif  // HAL_SIM_PHYSICS_SHM_ENABLED
@@ -0,0 +1,78 @@
+/*
+  binary shared memory protocol between SITL and an external physics
+  simulator, an alternative to the JSON over UDP interface. This
+  header only depends on stdint.h so that simulator plugins (Gazebo,
+  Webots, AirSim, ...) can include it directly.
+
+  SITL creates the segment with shm_open("/<name>") and fills in the
+  header, writing magic last. The simulator maps the segment, checks
+  magic, version and size, and then the two sides exchange frames
+  through a ring in each direction:
+
+  - SITL writes servo_ring[servo_seq % AP_PHYSICS_SHM_RING_SIZE],
+    increments servo_seq and wakes any futex waiters on it
+  - the simulator steps its physics, writes
+    sensor_ring[sensor_seq % AP_PHYSICS_SHM_RING_SIZE], increments
+    sensor_seq and wakes any futex waiters on it
+
+  For lockstep each side waits for the other's sequence word to
+  change, with FUTEX_WAIT on Linux (not FUTEX_PRIVATE_FLAG, the words
+  are shared between processes) or by polling elsewhere. A reader
+  takes the newest frame, at seq-1, and must discard it if the
+  sequence has advanced by AP_PHYSICS_SHM_RING_SIZE-1 or more while
+  it was being copied, as the writer may then have overwritten it.
+
+  All values are in the host byte order and use the same units and
+  frames as the JSON interface.
+ */
+#pragma once
+
+#include <stdint.h>
+
+#define AP_PHYSICS_SHM_MAGIC 0x48535041 // "APSH"
+#define AP_PHYSICS_SHM_VERSION 1
+#define AP_PHYSICS_SHM_RING_SIZE 4
+#define AP_PHYSICS_SHM_MAX_SERVOS 16
+
+// bits in ap_physics_shm_sensors.fields for the optional values
+#define AP_PHYSICS_SHM_FIELD_RNG_1          (1U<<0) // RNG_2 to RNG_6 follow
+#define AP_PHYSICS_SHM_FIELD_WIND_DIR       (1U<<6)
+#define AP_PHYSICS_SHM_FIELD_WIND_SPD       (1U<<7)
+#define AP_PHYSICS_SHM_FIELD_AIRSPEED       (1U<<8)
+#define AP_PHYSICS_SHM_FIELD_NO_TIME_SYNC   (1U<<9)
+
+// SITL to simulator, equivalent to the JSON servo packet
+struct ap_physics_shm_servos {
+    uint32_t frame_count;
+    uint16_t frame_rate;
+    uint16_t num_servos;
+    uint16_t pwm[AP_PHYSICS_SHM_MAX_SERVOS];
+};
+
+// simulator to SITL, equivalent to the JSON sensor message
+struct ap_physics_shm_sensors {
+    double timestamp_s;             // physics time
+    double position[3];             // NED from origin, m
+    float gyro[3];                  // body frame, rad/s
+    float accel_body[3];            // body frame, m/s/s
+    float quaternion[4];            // attitude, q1 is the scalar part
+    float velocity[3];              // NED, m/s
+    float rng[6];                   // m
+    float windvane_direction;       // rad
+    float windvane_speed;           // m/s
+    float airspeed;                 // m/s
+    uint32_t fields;                // AP_PHYSICS_SHM_FIELD_ bits
+    uint32_t reserved;
+};
+
+struct ap_physics_shm {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t ring_size;
+    uint32_t size;                  // sizeof(struct ap_physics_shm)
+    volatile uint32_t servo_seq;
+    volatile uint32_t sensor_seq;
+    uint32_t reserved;
+    struct ap_physics_shm_servos servo_ring[AP_PHYSICS_SHM_RING_SIZE];
+    struct ap_physics_shm_sensors sensor_ring[AP_PHYSICS_SHM_RING_SIZE];
+};
@@ -354,6 +354,13 @@ const AP_Param::GroupInfo SIM::var_info3[] = {
     // @User: Advanced
     AP_GROUPINFO("UART_LOSS", 42, SIM,  uart_byte_loss_pct, 0),
 
+    // @Param: INTEGRATOR
+    // @DisplayName: Physics integrator
+    // @Description: Integration method for the vehicle dynamics. Second order Adams-Bashforth keeps the same accuracy at a lower SIM_RATE_HZ, which lets simulations run further ahead of real time
+    // @Values: 0:Euler,1:Second order Adams-Bashforth
+    // @User: Advanced
+    AP_GROUPINFO("INTEGRATOR", 43, SIM,  integrator, 0),
+
     AP_SUBGROUPINFO(airspeed[0], "ARSPD_", 50, SIM, SIM::AirspeedParm),
 #if AIRSPEED_MAX_SENSORS > 1
     AP_SUBGROUPINFO(airspeed[1], "ARSPD2_", 51, SIM, SIM::AirspeedParm),
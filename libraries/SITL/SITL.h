@@ -238,6 +238,12 @@ public:
 
     AP_Float uart_byte_loss_pct;
 
+    enum Integrator {
+        INTEGRATOR_EULER = 0,
+        INTEGRATOR_ADAMS_BASHFORTH2 = 1,
+    };
+    AP_Int8 integrator;
+
 #ifdef SFML_JOYSTICK
     AP_Int8 sfml_joystick_id;
     AP_Int8 sfml_joystick_axis[8];
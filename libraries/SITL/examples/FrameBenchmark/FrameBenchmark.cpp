@@ -0,0 +1,150 @@
+#include <AP_HAL/AP_HAL.h>
+
+#include <AP_Motors/AP_Motors.h>
+#include <SITL/SIM_Motor.h>
+#include <SITL/SITL_Input.h>
+
+#include <stdio.h>
+#include <time.h>
+
+/* run with:
+    ./waf configure --board linux
+    ./waf build --targets examples/FrameBenchmark
+    ./build/linux/examples/FrameBenchmark
+
+  times the multicopter motor model computed one motor at a time and
+  as a MotorArray, reporting simulated seconds per wall second at a
+  1200Hz physics rate, and checks the two give the same forces
+*/
+
+void setup();
+void loop();
+
+const AP_HAL::HAL& hal = AP_HAL::get_HAL();
+
+static const float physics_rate_hz = 1200;
+static const uint32_t num_steps = 200000;
+static uint64_t time_us = 1;
+
+static double wall_time_s(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec*1.0e-9;
+}
+
+static void setup_motors(SITL::Motor *motors, uint8_t num_motors)
+{
+    for (uint8_t i=0; i<num_motors; i++) {
+        // parameters of the default SITL quad
+        motors[i].setup_params(1000, 2000, 0.15, 0.95, 0.65, 150,
+                               0.35, 5.5, 12.6, 0.05, 25,
+                               Vector3f{}, Vector3f{}, 0, 0.1, 0.2);
+    }
+}
+
+static void fill_input(struct sitl_input &input, uint32_t step)
+{
+    for (uint8_t i=0; i<16; i++) {
+        input.servos[i] = 1400 + (step*7 + i*37) % 300;
+    }
+}
+
+// run the model for num_steps, returning the wall time taken
+static double run(SITL::Motor *motors, uint8_t num_motors, SITL::MotorArray *array, Vector3f &torque_sum, Vector3f &thrust_sum)
+{
+    struct sitl_input input {};
+    const Vector3f velocity_air_bf{3, -1, 0.5};
+    const Vector3f gyro{0.2, -0.1, 0.3};
+
+    torque_sum.zero();
+    thrust_sum.zero();
+    const double start_s = wall_time_s();
+    for (uint32_t step=0; step<num_steps; step++) {
+        fill_input(input, step);
+        Vector3f torque, thrust;
+        if (array != nullptr) {
+            array->calculate_forces(motors, input, 0, torque, thrust, velocity_air_bf, gyro, 1.2, 12.0, true);
+        } else {
+            for (uint8_t i=0; i<num_motors; i++) {
+                Vector3f mtorque, mthrust;
+                motors[i].calculate_forces(input, 0, mtorque, mthrust, velocity_air_bf, gyro, 1.2, 12.0, true);
+                torque += mtorque;
+                thrust += mthrust;
+            }
+        }
+        torque_sum += torque;
+        thrust_sum += thrust;
+        time_us += 1.0e6 / physics_rate_hz;
+        hal.scheduler->stop_clock(time_us);
+    }
+    return wall_time_s() - start_s;
+}
+
+// motors and copy are two instances of the same frame, so that each
+// run starts from the same slew limiter state
+static void benchmark(const char *name, SITL::Motor *motors, SITL::Motor *copy, uint8_t num_motors)
+{
+    setup_motors(motors, num_motors);
+    setup_motors(copy, num_motors);
+    SITL::MotorArray array;
+    if (!array.setup(motors, num_motors)) {
+        ::printf("%s: motors can't be batched\n", name);
+        return;
+    }
+
+    Vector3f torque1, thrust1, torque2, thrust2;
+    const double per_motor_s = run(motors, num_motors, nullptr, torque1, thrust1);
+    const double array_s = run(copy, num_motors, &array, torque2, thrust2);
+
+    const double sim_s = num_steps / physics_rate_hz;
+    ::printf("%-8s per-motor %8.0f sim s/wall s, array %8.0f sim s/wall s, speedup %.2f, difference torque %.3g thrust %.3g\n",
+             name, sim_s / per_motor_s, sim_s / array_s, per_motor_s / array_s,
+             (torque1 - torque2).length() / MAX(torque1.length(), 1),
+             (thrust1 - thrust2).length() / MAX(thrust1.length(), 1));
+}
+
+#define QUAD_MOTORS {                                        \
+        SITL::Motor(0,  45, AP_MOTORS_MATRIX_YAW_FACTOR_CCW, 1), \
+        SITL::Motor(1, -135, AP_MOTORS_MATRIX_YAW_FACTOR_CCW, 3),\
+        SITL::Motor(2, -45, AP_MOTORS_MATRIX_YAW_FACTOR_CW,  4), \
+        SITL::Motor(3, 135, AP_MOTORS_MATRIX_YAW_FACTOR_CW,  2), \
+    }
+
+#define HEXA_MOTORS {                                        \
+        SITL::Motor(0,   0, AP_MOTORS_MATRIX_YAW_FACTOR_CW,  1), \
+        SITL::Motor(1, 180, AP_MOTORS_MATRIX_YAW_FACTOR_CCW, 4), \
+        SITL::Motor(2,-120, AP_MOTORS_MATRIX_YAW_FACTOR_CW,  5), \
+        SITL::Motor(3,  60, AP_MOTORS_MATRIX_YAW_FACTOR_CCW, 2), \
+        SITL::Motor(4, -60, AP_MOTORS_MATRIX_YAW_FACTOR_CCW, 6), \
+        SITL::Motor(5, 120, AP_MOTORS_MATRIX_YAW_FACTOR_CW,  3), \
+    }
+
+#define OCTA_MOTORS {                                         \
+        SITL::Motor(0,    0, AP_MOTORS_MATRIX_YAW_FACTOR_CW,  1), \
+        SITL::Motor(1,  180, AP_MOTORS_MATRIX_YAW_FACTOR_CW,  5), \
+        SITL::Motor(2,   45, AP_MOTORS_MATRIX_YAW_FACTOR_CCW, 2), \
+        SITL::Motor(3,  135, AP_MOTORS_MATRIX_YAW_FACTOR_CCW, 4), \
+        SITL::Motor(4,  -45, AP_MOTORS_MATRIX_YAW_FACTOR_CCW, 8), \
+        SITL::Motor(5, -135, AP_MOTORS_MATRIX_YAW_FACTOR_CCW, 6), \
+        SITL::Motor(6,  -90, AP_MOTORS_MATRIX_YAW_FACTOR_CW,  7), \
+        SITL::Motor(7,   90, AP_MOTORS_MATRIX_YAW_FACTOR_CW,  3), \
+    }
+
+void setup(void)
+{
+    SITL::Motor quad[] = QUAD_MOTORS, quad_copy[] = QUAD_MOTORS;
+    SITL::Motor hexa[] = HEXA_MOTORS, hexa_copy[] = HEXA_MOTORS;
+    SITL::Motor octa[] = OCTA_MOTORS, octa_copy[] = OCTA_MOTORS;
+
+    benchmark("quad", quad, quad_copy, ARRAY_SIZE(quad));
+    benchmark("hexa", hexa, hexa_copy, ARRAY_SIZE(hexa));
+    benchmark("octa", octa, octa_copy, ARRAY_SIZE(octa));
+}
+
+void loop(void)
+{
+    exit(0);
+}
+
+AP_HAL_MAIN();
@@ -366,6 +366,10 @@ public:
     // set output value for a function channel as a pwm value
     static void set_output_pwm(SRV_Channel::Aux_servo_function_t function, uint16_t value);
 
+    // set and output the pwm of the motors in motor_mask, with pwm[]
+    // indexed by motor number
+    static void set_output_pwm_motors(const uint16_t *pwm, uint32_t motor_mask);
+
     // set output value for a specific function channel as a pwm value
     static void set_output_pwm_chan(uint8_t chan, uint16_t value);
 
@@ -531,6 +535,10 @@ public:
 
     static void push();
 
+    // update the serial and CAN output devices without pushing
+    // hal.rcout, for vehicles that push hal.rcout from another thread
+    static void push_devices();
+
     // disable PWM output to a set of channels given by a mask. This is used by the AP_BLHeli code
     static void set_disabled_channel_mask(uint32_t mask) { disabled_mask = mask; }
     static uint32_t get_disabled_channel_mask() { return disabled_mask; }
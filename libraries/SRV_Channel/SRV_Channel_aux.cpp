@@ -327,6 +327,38 @@ void SRV_Channels::set_output_pwm(SRV_Channel::Aux_servo_function_t function, ui
     }
 }
 
+/*
+  set radio_out for the channels of the motors in motor_mask and write
+  them to hal.rcout, with pwm[] indexed by motor number. The channels
+  come from the function channel masks, which are only rebuilt when
+  the functions change, rather than from searching all channels for
+  each motor as set_output_pwm() does
+ */
+void SRV_Channels::set_output_pwm_motors(const uint16_t *pwm, uint32_t motor_mask)
+{
+    if (!initialised) {
+        update_aux_servo_function();
+    }
+    while (motor_mask != 0) {
+        const uint8_t motor = __builtin_ctz(motor_mask);
+        motor_mask &= motor_mask - 1;
+        const SRV_Channel::Aux_servo_function_t function = get_motor_function(motor);
+        if (!SRV_Channel::is_motor(function)) {
+            continue;
+        }
+        SRV_Channel::servo_mask_t chan_mask = functions[function].channel_mask;
+        while (chan_mask != 0) {
+            const uint8_t chan = __builtin_ctz(chan_mask);
+            chan_mask &= chan_mask - 1;
+            SRV_Channel &c = channels[chan];
+            c.set_output_pwm(pwm[motor]);
+            if (!(disabled_mask & (1U<<chan))) {
+                hal.rcout->write(chan, c.output_pwm);
+            }
+        }
+    }
+}
+
 /*
   set radio_out for all channels matching the given function type
   trim the output assuming a 1500 center on the given value
@@ -509,7 +509,18 @@ void SRV_Channels::cork()
 void SRV_Channels::push()
 {
     hal.rcout->push();
+#if AP_SCHEDULER_LOOP_TRACE_ENABLED
+    AP_Scheduler *scheduler = AP_Scheduler::get_singleton();
+    if (scheduler != nullptr) {
+        scheduler->loop_trace.record(AP::LoopTrace::Event::RCOUT_PUSH);
+    }
+#endif
 
+    push_devices();
+}
+
+void SRV_Channels::push_devices()
+{
 #if AP_VOLZ_ENABLED
     // give volz library a chance to update
     volz_ptr->update();
@@ -108,6 +108,16 @@ void StorageManager::erase(void)
     }
 }
 
+void StorageManager::begin_batch(void)
+{
+    hal.storage->begin_batch();
+}
+
+void StorageManager::commit(void)
+{
+    hal.storage->end_batch();
+}
+
 /*
   constructor for StorageAccess
  */
@@ -64,6 +64,12 @@ public:
     // erase whole of storage
     static void erase(void);
 
+    // group a burst of writes so changed lines are flushed together
+    // rather than one at a time. Each begin_batch() must be matched by
+    // a commit()
+    static void begin_batch(void);
+    static void commit(void);
+
 private:
     struct StorageArea {
         StorageType type;